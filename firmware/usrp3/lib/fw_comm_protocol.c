@@ -89,6 +89,22 @@ bool process_fw_comm_protocol_pkt(
                 UHD_FW_TRACE_FSTR(DEBUG, "fw_comm_protocol::block_peek32(0x%x,%d)",request->addr,response->data_words);
             } break;
 
+            case FW_COMM_CMD_MULTI_OP: {
+                if (request->data_words > FW_COMM_MAX_DATA_WORDS || (request->data_words % 2) != 0) {
+                    response->flags |= FW_COMM_ERR_SIZE_ERROR;
+                    break;
+                }
+                UHD_FW_TRACE_FSTR(DEBUG, "fw_comm_protocol::multi_op(%d)",request->data_words/2);
+                for (uint32_t i = 0; i < request->data_words; i += 2) {
+                    const uint32_t op_addr = request->data[i];
+                    if (op_addr & FW_COMM_MULTI_OP_PEEK32) {
+                        response->data[i+1] = peek_callback(op_addr & ~FW_COMM_MULTI_OP_PEEK32);
+                    } else {
+                        poke_callback(op_addr, request->data[i+1]);
+                    }
+                }
+            } break;
+
             default: {
                 UHD_FW_TRACE(ERROR, "fw_comm_protocol got an invalid command.");
                 response->flags |= FW_COMM_ERR_CMD_ERROR;
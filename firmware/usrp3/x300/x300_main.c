@@ -75,6 +75,65 @@ void handle_udp_prog_framer(
   }
 }
 
+/***********************************************************************
+ * Peek and poke for host packets, the chinch bit selects the PCIe bridge
+ **********************************************************************/
+static void fw_comms_poke32(const uint32_t addr, const uint32_t data)
+{
+    if (addr & 0x00100000) {
+        chinch_poke32(addr & 0x000FFFFF, data);
+    } else {
+        wb_poke32(addr, data);
+    }
+}
+
+static uint32_t fw_comms_peek32(const uint32_t addr)
+{
+    uint32_t data = 0;
+    if (addr & 0x00100000) {
+        chinch_peek32(addr & 0x000FFFFF, &data);
+    } else {
+        data = wb_peek32(addr);
+    }
+    return data;
+}
+
+/***********************************************************************
+ * Handler for multi-op host comms, runs many peeks and pokes per packet
+ **********************************************************************/
+static void handle_udp_fw_comms_multi(
+    const uint8_t ethno,
+    const struct ip_addr *src,
+    const uint16_t src_port, const uint16_t dst_port,
+    const void *buff, const size_t num_bytes
+)
+{
+    static x300_fw_comms_multi_t reply;
+    const x300_fw_comms_t *request = (const x300_fw_comms_t *)buff;
+    size_t reply_size = sizeof(x300_fw_comms_t) + request->addr*sizeof(x300_fw_comms_op_t);
+
+    //check for error and set error flag
+    if (request->addr > X300_FW_COMMS_MAX_OPS || num_bytes < reply_size) {
+        memcpy(&reply.header, buff, sizeof(reply.header));
+        reply.header.flags |= X300_FW_COMMS_FLAGS_ERROR;
+        reply_size = sizeof(reply.header);
+    }
+    //otherwise, run the ops in order
+    else {
+        memcpy(&reply, buff, reply_size);
+        for (uint32_t i = 0; i < request->addr; i++) {
+            x300_fw_comms_op_t *op = &reply.ops[i];
+            if (op->flags & X300_FW_COMMS_FLAGS_PEEK32) op->data = fw_comms_peek32(op->addr);
+            if (op->flags & X300_FW_COMMS_FLAGS_POKE32) fw_comms_poke32(op->addr, op->data);
+        }
+    }
+
+    //send a reply if ack requested
+    if (request->flags & X300_FW_COMMS_FLAGS_ACK) {
+        u3_net_stack_send_udp_pkt(ethno, src, dst_port, src_port, &reply, reply_size);
+    }
+}
+
 /***********************************************************************
  * Handler for peek and poke host packets
  **********************************************************************/
@@ -88,6 +147,9 @@ void handle_udp_fw_comms(
     if (buff == NULL) {
      /* We got here from ICMP_DUR undeliverable packet */
     /* Future space for hooks to tear down streaming radios etc */
+    } else if (num_bytes >= sizeof(x300_fw_comms_t) &&
+        (((const x300_fw_comms_t *)buff)->flags & X300_FW_COMMS_FLAGS_MULTI)) {
+        handle_udp_fw_comms_multi(ethno, src, src_port, dst_port, buff, num_bytes);
     } else {
         const x300_fw_comms_t *request = (const x300_fw_comms_t *)buff;
         x300_fw_comms_t reply; memcpy(&reply, buff, sizeof(reply));
@@ -100,19 +162,11 @@ void handle_udp_fw_comms(
         else {
             if (request->flags & X300_FW_COMMS_FLAGS_PEEK32)
             {
-                if (request->addr & 0x00100000) {
-                    chinch_peek32(request->addr & 0x000FFFFF, &reply.data);
-                } else {
-                    reply.data = wb_peek32(request->addr);
-                }
+                reply.data = fw_comms_peek32(request->addr);
             }
             if (request->flags & X300_FW_COMMS_FLAGS_POKE32)
             {
-                if (request->addr & 0x00100000) {
-                    chinch_poke32(request->addr & 0x000FFFFF, request->data);
-                } else {
-                    wb_poke32(request->addr, request->data);
-                }
+                fw_comms_poke32(request->addr, request->data);
             }
         }
 
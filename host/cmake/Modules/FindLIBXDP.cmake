@@ -0,0 +1,56 @@
+#
+# Copyright 2016 Ettus Research LLC
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# - Find libxdp
+# Find the AF_XDP socket helpers of libxdp (and the libbpf they need)
+# This module defines
+#  LIBXDP_INCLUDE_DIRS, where to find xdp/xsk.h
+#  LIBXDP_LIBRARIES, the libraries needed to use AF_XDP sockets.
+#  LIBXDP_FOUND, If false, do not try to use AF_XDP.
+
+INCLUDE(FindPkgConfig)
+PKG_CHECK_MODULES(PC_LIBXDP "libxdp")
+PKG_CHECK_MODULES(PC_LIBBPF "libbpf")
+
+FIND_PATH(
+    LIBXDP_INCLUDE_DIR
+    NAMES xdp/xsk.h
+    HINTS ${PC_LIBXDP_INCLUDE_DIRS}
+)
+
+FIND_LIBRARY(
+    LIBXDP_LIBRARY
+    NAMES xdp
+    HINTS ${PC_LIBXDP_LIBDIR}
+)
+
+FIND_LIBRARY(
+    LIBBPF_LIBRARY
+    NAMES bpf
+    HINTS ${PC_LIBBPF_LIBDIR}
+)
+
+# handle the QUIETLY and REQUIRED arguments and set LIBXDP_FOUND to TRUE if
+# all listed variables are TRUE
+INCLUDE(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(LIBXDP DEFAULT_MSG LIBXDP_LIBRARY LIBBPF_LIBRARY LIBXDP_INCLUDE_DIR)
+
+IF(LIBXDP_FOUND)
+  SET(LIBXDP_INCLUDE_DIRS ${LIBXDP_INCLUDE_DIR})
+  SET(LIBXDP_LIBRARIES ${LIBXDP_LIBRARY} ${LIBBPF_LIBRARY})
+ENDIF(LIBXDP_FOUND)
+
+MARK_AS_ADVANCED(LIBXDP_LIBRARY LIBBPF_LIBRARY LIBXDP_INCLUDE_DIR)
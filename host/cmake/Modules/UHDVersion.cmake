@@ -29,7 +29,7 @@ FIND_PACKAGE(Git QUIET)
 ########################################################################
 SET(UHD_VERSION_MAJOR 003)
 SET(UHD_VERSION_API   010)
-SET(UHD_VERSION_ABI   002)
+SET(UHD_VERSION_ABI   003)
 SET(UHD_VERSION_PATCH 000)
 SET(UHD_VERSION_DEVEL FALSE)
 
@@ -24,8 +24,12 @@
 #include <boost/thread/thread.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
-//#include <boost/atomic.hpp>
+#include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/foreach.hpp>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <complex>
 #include <cstdlib>
 
@@ -33,22 +37,122 @@ namespace po = boost::program_options;
 
 const double CLOCK_TIMEOUT = 1000;  // 1000mS timeout for external clock locking
 const double INIT_DELAY    = 0.05;  // 50mS initial delay before transmit
-//typedef boost::atomic<bool>   atomic_bool;
-// We'll fake atomic bools for now, for more backward compat.
-// This is just an example, after all.
-typedef bool atomic_bool;
+typedef boost::atomic<bool> atomic_bool;
+typedef boost::atomic<unsigned long long> atomic_counter;
 
 /***********************************************************************
  * Test result variables
  **********************************************************************/
-unsigned long long num_overflows = 0;
-unsigned long long num_underflows = 0;
-unsigned long long num_rx_samps = 0;
-unsigned long long num_tx_samps = 0;
-unsigned long long num_dropped_samps = 0;
-unsigned long long num_seq_errors = 0;
-unsigned long long num_late_commands = 0;
-unsigned long long num_timeouts = 0;
+//! The counters of one streamer, read by the main thread while it runs
+struct stream_stats_t{
+    atomic_counter samps;
+    atomic_counter dropped_samps;
+    atomic_counter overflows;
+    atomic_counter seq_errors;
+    atomic_counter underflows;
+    atomic_counter late_commands;
+    atomic_counter late_packets;
+    atomic_counter timeouts;
+
+    stream_stats_t(void):
+        samps(0), dropped_samps(0), overflows(0), seq_errors(0),
+        underflows(0), late_commands(0), late_packets(0), timeouts(0)
+    {
+        /* NOP */
+    }
+};
+
+//! A copy of the counters of a streamer at one point in time
+struct stats_snapshot_t{
+    double time;
+    unsigned long long samps, dropped_samps, overflows, seq_errors;
+    unsigned long long underflows, late_commands, late_packets, timeouts;
+
+    stats_snapshot_t(void):
+        time(0), samps(0), dropped_samps(0), overflows(0), seq_errors(0),
+        underflows(0), late_commands(0), late_packets(0), timeouts(0)
+    {
+        /* NOP */
+    }
+
+    stats_snapshot_t(const stream_stats_t &stats, const double time_):
+        time(time_),
+        samps(stats.samps.load()),
+        dropped_samps(stats.dropped_samps.load()),
+        overflows(stats.overflows.load()),
+        seq_errors(stats.seq_errors.load()),
+        underflows(stats.underflows.load()),
+        late_commands(stats.late_commands.load()),
+        late_packets(stats.late_packets.load()),
+        timeouts(stats.timeouts.load())
+    {
+        /* NOP */
+    }
+
+    void operator+=(const stats_snapshot_t &other){
+        samps += other.samps;
+        dropped_samps += other.dropped_samps;
+        overflows += other.overflows;
+        seq_errors += other.seq_errors;
+        underflows += other.underflows;
+        late_commands += other.late_commands;
+        late_packets += other.late_packets;
+        timeouts += other.timeouts;
+    }
+
+    std::string to_json(void) const{
+        return str(boost::format(
+            "{\"samps\":%u,\"dropped_samps\":%u,\"overflows\":%u,"
+            "\"seq_errors\":%u,\"underflows\":%u,\"late_commands\":%u,"
+            "\"late_packets\":%u,\"timeouts\":%u}"
+        ) % samps % dropped_samps % overflows % seq_errors
+          % underflows % late_commands % late_packets % timeouts);
+    }
+};
+
+//! One streamer under test and the counters sampled while it runs
+struct stream_info_t{
+    std::string direction;
+    std::vector<size_t> channels;
+    std::vector<size_t> cpus;
+    boost::shared_ptr<stream_stats_t> stats;
+    std::vector<stats_snapshot_t> series;
+};
+
+/***********************************************************************
+ * Helpers
+ **********************************************************************/
+static std::vector<size_t> parse_list(const std::string &list){
+    std::vector<std::string> strings;
+    std::vector<size_t> values;
+    if (list.empty()) return values;
+    boost::split(strings, list, boost::is_any_of("\"',"));
+    BOOST_FOREACH(const std::string &str, strings){
+        values.push_back(boost::lexical_cast<size_t>(str));
+    }
+    return values;
+}
+
+static std::string to_json(const std::vector<size_t> &values){
+    std::ostringstream ss;
+    ss << "[";
+    for (size_t i = 0; i < values.size(); i++){
+        ss << (i == 0 ? "" : ",") << values[i];
+    }
+    ss << "]";
+    return ss.str();
+}
+
+//! Pin the calling thread to the given CPUs, if any
+static void pin_thread(const std::vector<size_t> &cpus){
+    if (cpus.empty()) return;
+    try{
+        uhd::set_thread_affinity(cpus);
+    }
+    catch(const std::exception &e){
+        std::cerr << "Failed to set the CPU affinity: " << e.what() << std::endl;
+    }
+}
 
 /***********************************************************************
  * Benchmark RX Rate
@@ -58,9 +162,12 @@ void benchmark_rx_rate(
         const std::string &rx_cpu,
         uhd::rx_streamer::sptr rx_stream,
         bool random_nsamps,
-        atomic_bool& burst_timer_elapsed
+        atomic_bool& burst_timer_elapsed,
+        stream_stats_t &stats,
+        const std::vector<size_t> &cpus
 ) {
     uhd::set_thread_priority_safe();
+    pin_thread(cpus);
 
     //print pre-test summary
     std::cout << boost::format(
@@ -88,8 +195,7 @@ void benchmark_rx_rate(
 
     bool stop_called = false;
     while (true) {
-        //if (burst_timer_elapsed.load(boost::memory_order_relaxed) and not stop_called) {
-        if (burst_timer_elapsed and not stop_called) {
+        if (burst_timer_elapsed.load(boost::memory_order_relaxed) and not stop_called) {
             rx_stream->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS);
             stop_called = true;
         }
@@ -98,7 +204,7 @@ void benchmark_rx_rate(
             rx_stream->issue_stream_cmd(cmd);
         }
         try {
-            num_rx_samps += rx_stream->recv(buffs, max_samps_per_packet, md, recv_timeout)*rx_stream->get_num_channels();
+            stats.samps += rx_stream->recv(buffs, max_samps_per_packet, md, recv_timeout)*rx_stream->get_num_channels();
             recv_timeout = burst_pkt_time;
         }
         catch (uhd::io_error &e) {
@@ -112,7 +218,7 @@ void benchmark_rx_rate(
         case uhd::rx_metadata_t::ERROR_CODE_NONE:
             if (had_an_overflow){
                 had_an_overflow = false;
-                num_dropped_samps += (md.time_spec - last_time).to_ticks(rate);
+                stats.dropped_samps += (md.time_spec - last_time).to_ticks(rate);
             }
             if ((burst_timer_elapsed or stop_called) and md.end_of_burst)
             {
@@ -126,12 +232,12 @@ void benchmark_rx_rate(
             had_an_overflow = true;
             // check out_of_sequence flag to see if it was a sequence error or overflow
             if (!md.out_of_sequence)
-                num_overflows++;
+                stats.overflows++;
             break;
 
         case uhd::rx_metadata_t::ERROR_CODE_LATE_COMMAND:
             std::cerr << "Receiver error: " << md.strerror() << ", restart streaming..."<< std::endl;
-            num_late_commands++;
+            stats.late_commands++;
             // Radio core will be in the idle state. Issue stream command to restart streaming.
             cmd.time_spec = usrp->get_time_now() + uhd::time_spec_t(0.05);
             cmd.stream_now = (buffs.size() == 1);
@@ -143,7 +249,7 @@ void benchmark_rx_rate(
                 return;
             }
             std::cerr << "Receiver error: " << md.strerror() << ", continuing..." << std::endl;
-            num_timeouts++;
+            stats.timeouts++;
             break;
 
             // Otherwise, it's an error
@@ -163,9 +269,12 @@ void benchmark_tx_rate(
         const std::string &tx_cpu,
         uhd::tx_streamer::sptr tx_stream,
         atomic_bool& burst_timer_elapsed,
+        stream_stats_t &stats,
+        const std::vector<size_t> &cpus,
         bool random_nsamps=false
 ) {
     uhd::set_thread_priority_safe();
+    pin_thread(cpus);
 
     //print pre-test summary
     std::cout << boost::format(
@@ -185,8 +294,7 @@ void benchmark_tx_rate(
 
     if (random_nsamps) {
         std::srand((unsigned int)time(NULL));
-        //while (not burst_timer_elapsed.load(boost::memory_order_relaxed)) {
-        while (not burst_timer_elapsed) {
+        while (not burst_timer_elapsed.load(boost::memory_order_relaxed)) {
             size_t total_num_samps = rand() % max_samps_per_packet;
             size_t num_acc_samps = 0;
             const float timeout = 1;
@@ -194,14 +302,13 @@ void benchmark_tx_rate(
             usrp->set_time_now(uhd::time_spec_t(0.0));
             while(num_acc_samps < total_num_samps){
                 //send a single packet
-                num_tx_samps += tx_stream->send(buffs, max_samps_per_packet, md, timeout)*tx_stream->get_num_channels();
+                stats.samps += tx_stream->send(buffs, max_samps_per_packet, md, timeout)*tx_stream->get_num_channels();
                 num_acc_samps += std::min(total_num_samps-num_acc_samps, tx_stream->get_max_num_samps());
             }
         }
     } else {
-        //while (not burst_timer_elapsed.load(boost::memory_order_relaxed)) {
-        while (not burst_timer_elapsed) {
-            num_tx_samps += tx_stream->send(buffs, max_samps_per_packet, md)*tx_stream->get_num_channels();
+        while (not burst_timer_elapsed.load(boost::memory_order_relaxed)) {
+            stats.samps += tx_stream->send(buffs, max_samps_per_packet, md)*tx_stream->get_num_channels();
             md.has_time_spec = false;
         }
     }
@@ -213,15 +320,15 @@ void benchmark_tx_rate(
 
 void benchmark_tx_rate_async_helper(
         uhd::tx_streamer::sptr tx_stream,
-        atomic_bool& burst_timer_elapsed
+        atomic_bool& burst_timer_elapsed,
+        stream_stats_t &stats
 ) {
     //setup variables and allocate buffer
     uhd::async_metadata_t async_md;
     bool exit_flag = false;
 
     while (true) {
-        //if (burst_timer_elapsed.load(boost::memory_order_relaxed)) {
-        if (burst_timer_elapsed) {
+        if (burst_timer_elapsed.load(boost::memory_order_relaxed)) {
             exit_flag = true;
         }
 
@@ -238,12 +345,16 @@ void benchmark_tx_rate_async_helper(
 
         case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW:
         case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW_IN_PACKET:
-            num_underflows++;
+            stats.underflows++;
             break;
 
         case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR:
         case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR_IN_BURST:
-            num_seq_errors++;
+            stats.seq_errors++;
+            break;
+
+        case uhd::async_metadata_t::EVENT_CODE_TIME_ERROR:
+            stats.late_packets++;
             break;
 
         default:
@@ -269,6 +380,9 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     std::string rx_cpu, tx_cpu;
     std::string mode, ref, pps;
     std::string channel_list, rx_channel_list, tx_channel_list;
+    std::string rx_cpu_list, tx_cpu_list;
+    std::string json_file;
+    double stats_interval;
     bool random_nsamps = false;
     atomic_bool burst_timer_elapsed(false);
 
@@ -276,7 +390,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     po::options_description desc("Allowed options");
     desc.add_options()
         ("help", "help message")
-        ("args", po::value<std::string>(&args)->default_value(""), "single uhd device address args")
+        ("args", po::value<std::string>(&args)->default_value(""), "uhd device address args, use addr0, addr1, ... for several devices")
         ("duration", po::value<double>(&duration)->default_value(10.0), "duration for the test in seconds")
         ("rx_subdev", po::value<std::string>(&rx_subdev), "specify the device subdev for RX")
         ("tx_subdev", po::value<std::string>(&tx_subdev), "specify the device subdev for TX")
@@ -293,6 +407,11 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         ("channels", po::value<std::string>(&channel_list)->default_value("0"), "which channel(s) to use (specify \"0\", \"1\", \"0,1\", etc)")
         ("rx_channels", po::value<std::string>(&rx_channel_list), "which RX channel(s) to use (specify \"0\", \"1\", \"0,1\", etc)")
         ("tx_channels", po::value<std::string>(&tx_channel_list), "which TX channel(s) to use (specify \"0\", \"1\", \"0,1\", etc)")
+        ("multi_streamer", "Create one streamer and thread per channel instead of one streamer for all channels.")
+        ("rx_cpus", po::value<std::string>(&rx_cpu_list), "pin the RX threads to these CPUs, one per thread in turn (specify \"2,3\", etc)")
+        ("tx_cpus", po::value<std::string>(&tx_cpu_list), "pin the TX threads to these CPUs, one per thread in turn (specify \"4,5\", etc)")
+        ("stats_interval", po::value<double>(&stats_interval)->default_value(1.0), "interval of the time series of the counters in seconds")
+        ("json_file", po::value<std::string>(&json_file), "write the results and the time series of the counters to this file as JSON")
     ;
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -397,20 +516,15 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     }
 
     //check that the device has sufficient RX and TX channels available
-    std::vector<std::string> channel_strings;
     std::vector<size_t> rx_channel_nums;
     if (vm.count("rx_rate")) {
         if (!vm.count("rx_channels")) {
             rx_channel_list = channel_list;
         }
-
-        boost::split(channel_strings, rx_channel_list, boost::is_any_of("\"',"));
-        for (size_t ch = 0; ch < channel_strings.size(); ch++) {
-            size_t chan = boost::lexical_cast<int>(channel_strings[ch]);
+        rx_channel_nums = parse_list(rx_channel_list);
+        BOOST_FOREACH(const size_t chan, rx_channel_nums) {
             if (chan >= usrp->get_rx_num_channels()) {
                 throw std::runtime_error("Invalid channel(s) specified.");
-            } else {
-                rx_channel_nums.push_back(boost::lexical_cast<int>(channel_strings[ch]));
             }
         }
     }
@@ -420,17 +534,15 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         if (!vm.count("tx_channels")) {
             tx_channel_list = channel_list;
         }
-
-        boost::split(channel_strings, tx_channel_list, boost::is_any_of("\"',"));
-        for (size_t ch = 0; ch < channel_strings.size(); ch++) {
-            size_t chan = boost::lexical_cast<int>(channel_strings[ch]);
+        tx_channel_nums = parse_list(tx_channel_list);
+        BOOST_FOREACH(const size_t chan, tx_channel_nums) {
             if (chan >= usrp->get_tx_num_channels()) {
                 throw std::runtime_error("Invalid channel(s) specified.");
-            } else {
-                tx_channel_nums.push_back(boost::lexical_cast<int>(channel_strings[ch]));
             }
         }
     }
+    const std::vector<size_t> rx_cpus = parse_list(rx_cpu_list);
+    const std::vector<size_t> tx_cpus = parse_list(tx_cpu_list);
 
     std::cout << boost::format("Setting device timestamp to 0...") << std::endl;
     const bool sync_channels =
@@ -445,40 +557,87 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
        usrp->set_time_unknown_pps(uhd::time_spec_t(0.0));
     }
 
-    //spawn the receive test thread
+    //split the channels into one group per streamer
+    std::vector<std::vector<size_t> > rx_groups, tx_groups;
+    if (vm.count("multi_streamer")) {
+        BOOST_FOREACH(const size_t chan, rx_channel_nums) {
+            rx_groups.push_back(std::vector<size_t>(1, chan));
+        }
+        BOOST_FOREACH(const size_t chan, tx_channel_nums) {
+            tx_groups.push_back(std::vector<size_t>(1, chan));
+        }
+    } else {
+        if (not rx_channel_nums.empty()) rx_groups.push_back(rx_channel_nums);
+        if (not tx_channel_nums.empty()) tx_groups.push_back(tx_channel_nums);
+    }
+    std::vector<stream_info_t> streams;
+
+    //spawn the receive test threads
     if (vm.count("rx_rate")){
         usrp->set_rx_rate(rx_rate);
-        //create a receive streamer
-        uhd::stream_args_t stream_args(rx_cpu, rx_otw);
-        stream_args.channels = rx_channel_nums;
-        uhd::rx_streamer::sptr rx_stream = usrp->get_rx_stream(stream_args);
-        thread_group.create_thread(boost::bind(&benchmark_rx_rate, usrp, rx_cpu, rx_stream, random_nsamps, boost::ref(burst_timer_elapsed)));
+        for (size_t i = 0; i < rx_groups.size(); i++) {
+            stream_info_t info;
+            info.direction = "rx";
+            info.channels = rx_groups[i];
+            if (not rx_cpus.empty()) info.cpus.push_back(rx_cpus[i % rx_cpus.size()]);
+            info.stats.reset(new stream_stats_t());
+            //create a receive streamer
+            uhd::stream_args_t stream_args(rx_cpu, rx_otw);
+            stream_args.channels = info.channels;
+            uhd::rx_streamer::sptr rx_stream = usrp->get_rx_stream(stream_args);
+            thread_group.create_thread(boost::bind(&benchmark_rx_rate, usrp, rx_cpu, rx_stream, random_nsamps,
+                boost::ref(burst_timer_elapsed), boost::ref(*info.stats), info.cpus));
+            streams.push_back(info);
+        }
     }
 
-    //spawn the transmit test thread
+    //spawn the transmit test threads
     if (vm.count("tx_rate")){
         usrp->set_tx_rate(tx_rate);
-        //create a transmit streamer
-        uhd::stream_args_t stream_args(tx_cpu, tx_otw);
-        stream_args.channels = tx_channel_nums;
-        uhd::tx_streamer::sptr tx_stream = usrp->get_tx_stream(stream_args);
-        thread_group.create_thread(boost::bind(&benchmark_tx_rate, usrp, tx_cpu, tx_stream, boost::ref(burst_timer_elapsed), random_nsamps));
-        thread_group.create_thread(boost::bind(&benchmark_tx_rate_async_helper, tx_stream, boost::ref(burst_timer_elapsed)));
+        for (size_t i = 0; i < tx_groups.size(); i++) {
+            stream_info_t info;
+            info.direction = "tx";
+            info.channels = tx_groups[i];
+            if (not tx_cpus.empty()) info.cpus.push_back(tx_cpus[i % tx_cpus.size()]);
+            info.stats.reset(new stream_stats_t());
+            //create a transmit streamer
+            uhd::stream_args_t stream_args(tx_cpu, tx_otw);
+            stream_args.channels = info.channels;
+            uhd::tx_streamer::sptr tx_stream = usrp->get_tx_stream(stream_args);
+            thread_group.create_thread(boost::bind(&benchmark_tx_rate, usrp, tx_cpu, tx_stream,
+                boost::ref(burst_timer_elapsed), boost::ref(*info.stats), info.cpus, random_nsamps));
+            thread_group.create_thread(boost::bind(&benchmark_tx_rate_async_helper, tx_stream,
+                boost::ref(burst_timer_elapsed), boost::ref(*info.stats)));
+            streams.push_back(info);
+        }
     }
 
-    //sleep for the required duration
-    const long secs = long(duration);
-    const long usecs = long((duration - secs)*1e6);
-    boost::this_thread::sleep(boost::posix_time::seconds(secs)
-            + boost::posix_time::microseconds(usecs)
-            + boost::posix_time::milliseconds( (rx_channel_nums.size() <= 1 and tx_channel_nums.size() <= 1) ? 0 : (INIT_DELAY * 1000))
-    );
+    //sample the counters at each interval for the required duration
+    const double total_duration = duration +
+        ((rx_channel_nums.size() <= 1 and tx_channel_nums.size() <= 1) ? 0 : INIT_DELAY);
+    const boost::system_time start_time = boost::get_system_time();
+    const double interval = (stats_interval > 0) ? stats_interval : total_duration;
+    for (size_t n = 1; ; n++) {
+        const double elapsed = std::min(n*interval, total_duration);
+        boost::this_thread::sleep(start_time + boost::posix_time::microseconds(long(elapsed*1e6)));
+        BOOST_FOREACH(stream_info_t &info, streams) {
+            info.series.push_back(stats_snapshot_t(*info.stats, elapsed));
+        }
+        if (elapsed >= total_duration) break;
+    }
 
     //interrupt and join the threads
-    //burst_timer_elapsed.store(true, boost::memory_order_relaxed);
-    burst_timer_elapsed = true;
+    burst_timer_elapsed.store(true, boost::memory_order_relaxed);
     thread_group.join_all();
 
+    //add up the final counters of all streamers
+    stats_snapshot_t rx_totals, tx_totals;
+    BOOST_FOREACH(const stream_info_t &info, streams) {
+        const stats_snapshot_t final_stats(*info.stats, total_duration);
+        if (info.direction == "rx") rx_totals += final_stats;
+        else tx_totals += final_stats;
+    }
+
     //print summary
     std::cout << std::endl << boost::format(
         "Benchmark rate summary:\n"
@@ -489,13 +648,57 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         "  Num sequence errors:     %u\n"
         "  Num underflows detected: %u\n"
         "  Num late commands:       %u\n"
+        "  Num late packets:        %u\n"
         "  Num timeouts:            %u\n"
-    ) % num_rx_samps % num_dropped_samps
-      % num_overflows % num_tx_samps
-      % num_seq_errors % num_underflows
-      % num_late_commands % num_timeouts
+    ) % rx_totals.samps % rx_totals.dropped_samps
+      % rx_totals.overflows % tx_totals.samps
+      % tx_totals.seq_errors % tx_totals.underflows
+      % rx_totals.late_commands % tx_totals.late_packets
+      % rx_totals.timeouts
       << std::endl;
 
+    //write the results as JSON, with the counters of each interval
+    //as the difference to the previous one
+    if (vm.count("json_file")) {
+        std::ofstream json(json_file.c_str());
+        if (not json) {
+            std::cerr << "ERROR: Unable to open " << json_file << std::endl;
+            return EXIT_FAILURE;
+        }
+        json << boost::format("{\"duration\":%f,\"stats_interval\":%f,")
+            % total_duration % interval;
+        if (vm.count("rx_rate")) json << boost::format("\"rx_rate\":%f,") % usrp->get_rx_rate();
+        if (vm.count("tx_rate")) json << boost::format("\"tx_rate\":%f,") % usrp->get_tx_rate();
+        json << "\"rx_totals\":" << rx_totals.to_json() << ",";
+        json << "\"tx_totals\":" << tx_totals.to_json() << ",";
+        json << "\"streamers\":[";
+        for (size_t i = 0; i < streams.size(); i++) {
+            const stream_info_t &info = streams[i];
+            json << (i == 0 ? "" : ",") << boost::format(
+                "{\"direction\":\"%s\",\"channels\":%s,\"cpus\":%s,\"series\":["
+            ) % info.direction % to_json(info.channels) % to_json(info.cpus);
+            stats_snapshot_t last;
+            for (size_t j = 0; j < info.series.size(); j++) {
+                const stats_snapshot_t &snap = info.series[j];
+                stats_snapshot_t delta;
+                delta.samps = snap.samps - last.samps;
+                delta.dropped_samps = snap.dropped_samps - last.dropped_samps;
+                delta.overflows = snap.overflows - last.overflows;
+                delta.seq_errors = snap.seq_errors - last.seq_errors;
+                delta.underflows = snap.underflows - last.underflows;
+                delta.late_commands = snap.late_commands - last.late_commands;
+                delta.late_packets = snap.late_packets - last.late_packets;
+                delta.timeouts = snap.timeouts - last.timeouts;
+                std::string entry = delta.to_json();
+                json << (j == 0 ? "" : ",")
+                     << boost::format("{\"time\":%f,%s") % snap.time % entry.substr(1);
+                last = snap;
+            }
+            json << "]}";
+        }
+        json << "]}" << std::endl;
+    }
+
     //finished
     std::cout << std::endl << "Done!" << std::endl << std::endl;
     return EXIT_SUCCESS;
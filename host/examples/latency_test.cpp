@@ -18,10 +18,12 @@
 #include <uhd/utils/thread_priority.hpp>
 #include <uhd/utils/safe_main.hpp>
 #include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/usrp/latency_probe.hpp>
 #include <boost/program_options.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <iostream>
-#include <complex>
+#include <fstream>
 
 namespace po = boost::program_options;
 
@@ -29,7 +31,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     uhd::set_thread_priority_safe();
 
     //variables to be set by po
-    std::string args;
+    std::string args, json_file;
     size_t nsamps;
     double rate;
     double rtt;
@@ -44,7 +46,9 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         ("nruns",  po::value<size_t>(&nruns)->default_value(1000),   "number of tests to perform")
         ("rtt",    po::value<double>(&rtt)->default_value(0.001),    "delay between receive and transmit (seconds)")
         ("rate",   po::value<double>(&rate)->default_value(100e6/4), "sample rate for receive and transmit (sps)")
-        ("verbose", "specify to enable inner-loop verbose")
+        ("json_file", po::value<std::string>(&json_file), "write the counts and latency histograms to this file as JSON")
+        ("verbose", "specify to print the histograms of all the parts of the turnaround")
+        ("latency-mode", "specify to enable the low latency transport mode (latency_mode=1)")
     ;
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -63,12 +67,20 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         "    arrive too late at the device indicate an error.\n"
         "    The smallest value of rtt that does not indicate an error is an\n"
         "    approximation for the time it takes for a sample packet to\n"
-        "    go to UHD and back to the device."
+        "    go to UHD and back to the device.\n"
+        "    Run the test with and without --latency-mode to compare\n"
+        "    the smallest working rtt of the two transport modes.\n"
+        "    The turnaround is the time from the first sample of a received\n"
+        "    packet at the device until its response was sent by the host."
         << std::endl;
         return EXIT_SUCCESS;
     }
 
     bool verbose = vm.count("verbose") != 0;
+    bool latency_mode = vm.count("latency-mode") != 0;
+    if (latency_mode) {
+        args += (args.empty()? "" : ",") + std::string("latency_mode=1");
+    }
 
     //create a usrp device
     std::cout << std::endl;
@@ -92,127 +104,23 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
             % (usrp->get_rx_rate()/1e6)
         << std::endl;
 
-    //allocate a buffer to use
-    std::vector<std::complex<float> > buffer(nsamps);
-
     //create RX and TX streamers
     uhd::stream_args_t stream_args("fc32"); //complex floats
     uhd::rx_streamer::sptr rx_stream = usrp->get_rx_stream(stream_args);
     uhd::tx_streamer::sptr tx_stream = usrp->get_tx_stream(stream_args);
 
-    //initialize result counts
-    int time_error = 0;
-    int ack = 0;
-    int underflow = 0;
-    int other = 0;
-
-    for(size_t nrun = 0; nrun < nruns; nrun++){
-
-        /***************************************************************
-         * Issue a stream command some time in the near future
-         **************************************************************/
-        uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
-        stream_cmd.num_samps = buffer.size();
-        stream_cmd.stream_now = false;
-        stream_cmd.time_spec = usrp->get_time_now() + uhd::time_spec_t(0.01);
-        rx_stream->issue_stream_cmd(stream_cmd);
-
-        /***************************************************************
-         * Receive the requested packet
-         **************************************************************/
-        uhd::rx_metadata_t rx_md;
-        size_t num_rx_samps = rx_stream->recv(
-            &buffer.front(), buffer.size(), rx_md
-        );
-
-        if (verbose) {
-            std::cout << boost::format(
-                "Run %d: Got packet: %u samples, %u full secs, %f frac secs"
-                )
-                % nrun
-                % num_rx_samps
-                % rx_md.time_spec.get_full_secs()
-                % rx_md.time_spec.get_frac_secs()
-            << std::endl;
-        } else {
-            std::cout << "." << std::flush;
-        }
-
-        /***************************************************************
-         * Transmit a packet with delta time after received packet
-         **************************************************************/
-        uhd::tx_metadata_t tx_md;
-        tx_md.start_of_burst = true;
-        tx_md.end_of_burst = true;
-        tx_md.has_time_spec = true;
-        tx_md.time_spec = rx_md.time_spec + uhd::time_spec_t(rtt);
-        size_t num_tx_samps = tx_stream->send(
-            &buffer.front(), buffer.size(), tx_md
-        );
-        if (verbose) {
-            std::cout
-                << boost::format("Sent %d samples") % num_tx_samps
-                << std::endl;
-        }
-
-        /***************************************************************
-         * Check the async messages for result
-         **************************************************************/
-        uhd::async_metadata_t async_md;
-        if (not tx_stream->recv_async_msg(async_md)){
-            std::cout << boost::format("failed:\n    Async message recv timed out.\n") << std::endl;
-            continue;
-        }
-        switch(async_md.event_code){
-        case uhd::async_metadata_t::EVENT_CODE_TIME_ERROR:
-            time_error++;
-            break;
-
-        case uhd::async_metadata_t::EVENT_CODE_BURST_ACK:
-            ack++;
-            break;
-
-        case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW:
-            underflow++;
-            break;
-
-        default:
-            std::cerr << boost::format(
-                "failed:\n    Got unexpected event code 0x%x.\n"
-            ) % async_md.event_code << std::endl;
-            other++;
-            break;
-        }
-    }
-
-    while (true) {
-        uhd::async_metadata_t async_md;
-        if (not tx_stream->recv_async_msg(async_md)) {
-            break;
-        }
-        switch(async_md.event_code){
-        case uhd::async_metadata_t::EVENT_CODE_TIME_ERROR:
-            time_error++;
-            break;
-
-        case uhd::async_metadata_t::EVENT_CODE_BURST_ACK:
-            ack++;
-            break;
-
-        case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW:
-            underflow++;
-            break;
-
-        default:
-            std::cerr << boost::format(
-                "failed:\n    Got unexpected event code 0x%x.\n"
-            ) % async_md.event_code << std::endl;
-            other++;
-            break;
-        }
-    }
-    if (!verbose) {
-        std::cout << std::endl;
+    //run the measurement, see uhd/usrp/latency_probe.hpp
+    uhd::usrp::latency_config_t config;
+    config.nsamps = nsamps;
+    config.nruns = nruns;
+    config.rtt = rtt;
+    const uhd::usrp::latency_result_t result = uhd::usrp::measure_latency(
+        usrp, rx_stream, tx_stream, config
+    );
+
+    if (vm.count("json_file")){
+        std::ofstream json(json_file.c_str());
+        json << result.to_json() << std::endl;
     }
 
     /***************************************************************
@@ -221,11 +129,25 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     std::cout << "Summary\n"
               << "================\n"
               << "Number of runs:   " << nruns << std::endl
+              << "Transport mode:   " << (latency_mode? "low latency" : "default") << std::endl
               << "RTT value tested: " << (rtt*1e3) << " ms" << std::endl
-              << "ACKs received:    " << ack << "/" << nruns << std::endl
-              << "Underruns:        " << underflow << std::endl
-              << "Late packets:     " << time_error << std::endl
-              << "Other errors:     " << other << std::endl
+              << "ACKs received:    " << result.num_acks << "/" << nruns << std::endl
+              << "Underruns:        " << result.num_underflows << std::endl
+              << "Late packets:     " << result.num_late << std::endl
+              << "Timeouts:         " << result.num_timeouts << std::endl
+              << "Other errors:     " << result.num_other << std::endl
               << std::endl;
+
+    //the turnaround, and with --verbose its parts, in microseconds
+    BOOST_FOREACH(const std::string &name, result.histograms.keys()){
+        if (name != "turnaround" and not verbose) continue;
+        const uhd::histogram_t &hist = result.histograms[name];
+        std::cout << boost::format(
+            "%-14s mean %8.1f us  p50 %8.1f  p90 %8.1f  p99 %8.1f  p99.9 %8.1f  max %8.1f"
+        ) % name % (hist.mean()/1e3)
+          % (hist.percentile(50)/1e3) % (hist.percentile(90)/1e3) % (hist.percentile(99)/1e3)
+          % (hist.percentile(99.9)/1e3) % (hist.max/1e3) << std::endl;
+    }
+    std::cout << std::endl;
     return EXIT_SUCCESS;
 }
@@ -18,13 +18,15 @@
 #include <uhd/types/tune_request.hpp>
 #include <uhd/utils/thread_priority.hpp>
 #include <uhd/utils/safe_main.hpp>
+#include <uhd/utils/sample_recorder.hpp>
 #include <uhd/usrp/multi_usrp.hpp>
 #include <uhd/exception.hpp>
 #include <boost/program_options.hpp>
 #include <boost/format.hpp>
 #include <boost/thread.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <iostream>
-#include <fstream>
 #include <csignal>
 #include <complex>
 
@@ -38,6 +40,7 @@ template<typename samp_type> void recv_to_file(
     const std::string &cpu_format,
     const std::string &wire_format,
     const std::string &file,
+    const std::string &index,
     size_t samps_per_buff,
     unsigned long long num_requested_samples,
     double time_requested = 0.0,
@@ -54,9 +57,20 @@ template<typename samp_type> void recv_to_file(
 
     uhd::rx_metadata_t md;
     std::vector<samp_type> buff(samps_per_buff);
-    std::ofstream outfile;
-    if (not null)
-        outfile.open(file.c_str(), std::ofstream::binary);
+    //the recorder writes to disk from its own threads,
+    //several comma separated files stripe the samples across disks
+    uhd::sample_recorder::sptr recorder;
+    if (not null){
+        std::vector<std::string> files;
+        boost::split(files, file, boost::is_any_of(","));
+        uhd::device_addr_t recorder_args;
+        if (not index.empty()){
+            recorder_args["index"] = index;
+            recorder_args["item_size"] = boost::lexical_cast<std::string>(sizeof(samp_type));
+            recorder_args["samp_rate"] = boost::lexical_cast<std::string>(usrp->get_rx_rate());
+        }
+        recorder = uhd::sample_recorder::make(files, recorder_args);
+    }
     bool overflow_message = true;
 
     //setup streaming
@@ -119,8 +133,8 @@ template<typename samp_type> void recv_to_file(
 
         num_total_samps += num_rx_samps;
 
-        if (outfile.is_open())
-            outfile.write((const char*)&buff.front(), num_rx_samps*sizeof(samp_type));
+        if (recorder)
+            recorder->write(&buff.front(), num_rx_samps*sizeof(samp_type), md);
 
         if (bw_summary) {
             last_update_samps += num_rx_samps;
@@ -144,8 +158,15 @@ template<typename samp_type> void recv_to_file(
     stream_cmd.stream_mode = uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS;
     rx_stream->issue_stream_cmd(stream_cmd);
 
-    if (outfile.is_open())
-        outfile.close();
+    if (recorder){
+        recorder->close();
+        if (recorder->get_num_dropped_bytes() != 0){
+            std::cerr << boost::format(
+                "The write medium could not keep up, %u bytes were not written.\n"
+                "  It must sustain a rate of %fMB/s.\n"
+            ) % recorder->get_num_dropped_bytes() % (usrp->get_rx_rate()*sizeof(samp_type)/1e6);
+        }
+    }
 
     if (stats) {
         std::cout << std::endl;
@@ -209,7 +230,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     uhd::set_thread_priority_safe();
 
     //variables to be set by po
-    std::string args, file, type, ant, subdev, ref, wirefmt;
+    std::string args, file, index, type, ant, subdev, ref, wirefmt;
     size_t total_num_samps, spb;
     double rate, freq, gain, bw, total_time, setup_time;
 
@@ -218,7 +239,8 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     desc.add_options()
         ("help", "help message")
         ("args", po::value<std::string>(&args)->default_value(""), "multi uhd device address args")
-        ("file", po::value<std::string>(&file)->default_value("usrp_samples.dat"), "name of the file to write binary samples to")
+        ("file", po::value<std::string>(&file)->default_value("usrp_samples.dat"), "name of the file to write binary samples to, a comma separated list stripes them across the files")
+        ("index", po::value<std::string>(&index)->default_value(""), "name of an index file to write, maps the samples to their times")
         ("type", po::value<std::string>(&type)->default_value("short"), "sample type: double, float, or short")
         ("nsamps", po::value<size_t>(&total_num_samps)->default_value(0), "total number of samples to receive")
         ("duration", po::value<double>(&total_time)->default_value(0), "total number of seconds to receive")
@@ -329,7 +351,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     }
 
 #define recv_to_file_args(format) \
-    (usrp, format, wirefmt, file, spb, total_num_samps, total_time, bw_summary, stats, null, enable_size_map, continue_on_bad_packet)
+    (usrp, format, wirefmt, file, index, spb, total_num_samps, total_time, bw_summary, stats, null, enable_size_map, continue_on_bad_packet)
     //recv to file
     if (type == "double") recv_to_file<std::complex<double> >recv_to_file_args("fc64");
     else if (type == "float") recv_to_file<std::complex<float> >recv_to_file_args("fc32");
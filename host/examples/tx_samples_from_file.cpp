@@ -18,12 +18,15 @@
 #include <uhd/types/tune_request.hpp>
 #include <uhd/utils/thread_priority.hpp>
 #include <uhd/utils/safe_main.hpp>
+#include <uhd/utils/sample_reader.hpp>
+#include <uhd/utils/sample_source.hpp>
 #include <uhd/usrp/multi_usrp.hpp>
 #include <boost/program_options.hpp>
 #include <boost/format.hpp>
 #include <boost/thread.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <iostream>
-#include <fstream>
 #include <complex>
 #include <csignal>
 
@@ -37,8 +40,32 @@ template<typename samp_type> void send_from_file(
     const std::string &cpu_format,
     const std::string &wire_format,
     const std::string &file,
+    const std::string &index,
+    double seek,
+    bool loop,
+    double start_time,
     size_t samps_per_buff
 ){
+    //several comma separated files are played in turn, or striped with an index
+    std::vector<std::string> files;
+    boost::split(files, file, boost::is_any_of(","));
+
+    //the source reads ahead from its own thread, so disk stalls do not underflow
+    uhd::device_addr_t source_args;
+    if (loop) source_args["loop"] = "1";
+    if (not index.empty()){
+        //a capture of rx_samples_to_file, seek relative to the time of its first sample
+        uhd::sample_reader::sptr reader = uhd::sample_reader::make(files, index);
+        if (reader->get_item_size() != sizeof(samp_type)){
+            throw std::runtime_error("The capture was not recorded with this sample type");
+        }
+        if (reader->get_num_samps() == 0) return;
+        const uint64_t offset = reader->find(reader->get_time(0) + uhd::time_spec_t(seek));
+        std::cout << boost::format("Sending the capture from sample %u...") % offset << std::endl;
+        source_args["offset"] = boost::lexical_cast<std::string>(offset*sizeof(samp_type));
+        source_args["stripe_size"] = boost::lexical_cast<std::string>(reader->get_stripe_size());
+    }
+    uhd::sample_source::sptr source = uhd::sample_source::make(files, source_args);
 
     //create a transmit streamer
     uhd::stream_args_t stream_args(cpu_format, wire_format);
@@ -47,31 +74,36 @@ template<typename samp_type> void send_from_file(
     uhd::tx_metadata_t md;
     md.start_of_burst = false;
     md.end_of_burst = false;
+    if (start_time > 0.0){
+        md.has_time_spec = true;
+        md.time_spec = usrp->get_time_now() + uhd::time_spec_t(start_time);
+    }
     std::vector<samp_type> buff(samps_per_buff);
-    std::ifstream infile(file.c_str(), std::ifstream::binary);
-
-    //loop until the entire file has been read
 
+    //loop until the entire file has been read, a looping source never ends
     while(not md.end_of_burst and not stop_signal_called){
 
-        infile.read((char*)&buff.front(), buff.size()*sizeof(samp_type));
-        size_t num_tx_samps = size_t(infile.gcount()/sizeof(samp_type));
+        const size_t nbytes = source->read(&buff.front(), buff.size()*sizeof(samp_type));
+        size_t num_tx_samps = nbytes/sizeof(samp_type);
 
-        md.end_of_burst = infile.eof();
+        md.end_of_burst = source->eof();
 
         tx_stream->send(&buff.front(), num_tx_samps, md);
+        md.has_time_spec = false;
     }
 
-    infile.close();
+    if (source->get_num_stalls() != 0){
+        std::cerr << boost::format("The disk stalled the transmission %u times") % source->get_num_stalls() << std::endl;
+    }
 }
 
 int UHD_SAFE_MAIN(int argc, char *argv[]){
     uhd::set_thread_priority_safe();
 
     //variables to be set by po
-    std::string args, file, type, ant, subdev, ref, wirefmt;
+    std::string args, file, index, type, ant, subdev, ref, wirefmt;
     size_t spb;
-    double rate, freq, gain, bw, delay, lo_off;
+    double rate, freq, gain, bw, delay, lo_off, seek, start_time;
 
     //setup the program options
     po::options_description desc("Allowed options");
@@ -79,6 +111,9 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         ("help", "help message")
         ("args", po::value<std::string>(&args)->default_value(""), "multi uhd device address args")
         ("file", po::value<std::string>(&file)->default_value("usrp_samples.dat"), "name of the file to read binary samples from")
+        ("index", po::value<std::string>(&index)->default_value(""), "name of the index of a capture, the file is a comma separated list of its files")
+        ("seek", po::value<double>(&seek)->default_value(0.0), "seconds into the capture to start from, needs an index")
+        ("start-time", po::value<double>(&start_time)->default_value(0.0), "seconds from now to start each transmission at, 0 to start right away")
         ("type", po::value<std::string>(&type)->default_value("short"), "sample type: double, float, or short")
         ("spb", po::value<size_t>(&spb)->default_value(10000), "samples per buffer")
         ("rate", po::value<double>(&rate), "rate of outgoing samples")
@@ -187,10 +222,12 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     }
 
     //send from file
+    //without a delay, a repeated file loops in the source with no gap at the wrap
+    const bool loop = repeat and delay == 0.0;
     do{
-        if (type == "double") send_from_file<std::complex<double> >(usrp, "fc64", wirefmt, file, spb);
-        else if (type == "float") send_from_file<std::complex<float> >(usrp, "fc32", wirefmt, file, spb);
-        else if (type == "short") send_from_file<std::complex<short> >(usrp, "sc16", wirefmt, file, spb);
+        if (type == "double") send_from_file<std::complex<double> >(usrp, "fc64", wirefmt, file, index, seek, loop, start_time, spb);
+        else if (type == "float") send_from_file<std::complex<float> >(usrp, "fc32", wirefmt, file, index, seek, loop, start_time, spb);
+        else if (type == "short") send_from_file<std::complex<short> >(usrp, "sc16", wirefmt, file, index, seek, loop, start_time, spb);
         else throw std::runtime_error("Unknown type " + type);
 
         if(repeat and delay != 0.0) boost::this_thread::sleep(boost::posix_time::milliseconds(delay));
@@ -23,7 +23,9 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
 #include <boost/operators.hpp>
+#include <complex>
 #include <string>
+#include <vector>
 
 namespace uhd{ namespace convert{
 
@@ -39,6 +41,20 @@ namespace uhd{ namespace convert{
         //! Set the scale factor (used in floating point conversions)
         virtual void set_scalar(const double) = 0;
 
+        /*!
+         * Set a complex gain and an additive offset for float outputs.
+         * Converters which support this compute out = in*scalar*gain + offset
+         * in the same pass as the conversion. The default implementation
+         * throws unless the gain is 1 and the offset is 0.
+         * \param gain the complex multiplier
+         * \param offset the complex offset, in units of the output
+         * \throws uhd::not_implemented_error if unsupported by the converter
+         */
+        virtual void set_correction(
+            const std::complex<double> &gain,
+            const std::complex<double> &offset
+        );
+
         //! The public conversion method to convert inputs -> outputs
         UHD_INLINE void conv(const input_type &in, const output_type &out, const size_t num){
             if (num != 0) (*this)(in, out, num);
@@ -75,19 +91,36 @@ namespace uhd{ namespace convert{
     //! Implement equality_comparable interface
     UHD_API bool operator==(const id_type &, const id_type &);
 
+    //! Describes one of the converters registered for a conversion ID
+    struct UHD_API converter_info_type{
+        //! The priority the converter was registered with
+        priority_type prio;
+        //! A name unique among the converters of one ID, e.g. "sse2"
+        std::string name;
+        //! The instruction set the converter needs, empty for portable code
+        std::string isa;
+        std::string to_string(void) const;
+    };
+
     /*!
      * Register a converter function.
      *
      * Converters with higher priority are given preference.
+     * Converters which use special instructions should only be registered
+     * when the host CPU supports them.
      *
      * \param id identify the conversion
      * \param fcn makes a new converter
      * \param prio the function priority
+     * \param name the converter name, defaults to a name derived from prio
+     * \param isa the instruction set the converter needs
      */
     UHD_API void register_converter(
         const id_type &id,
         const function_type &fcn,
-        const priority_type prio
+        const priority_type prio,
+        const std::string &name = "",
+        const std::string &isa = ""
     );
 
     /*!
@@ -101,6 +134,32 @@ namespace uhd{ namespace convert{
         const priority_type prio = -1
     );
 
+    /*!
+     * Get a converter factory function by the name of the converter.
+     * This bypasses the priority and allows to compare implementations.
+     * \param id identify the conversion
+     * \param name the converter name, see get_converter_infos()
+     * \return the converter factory function
+     * \throws uhd::key_error if no converter with that name exists
+     */
+    UHD_API function_type get_converter(
+        const id_type &id,
+        const std::string &name
+    );
+
+    /*!
+     * List the converters registered for a conversion ID.
+     * \param id identify the conversion
+     * \return the converter infos, highest priority first
+     */
+    UHD_API std::vector<converter_info_type> get_converter_infos(const id_type &id);
+
+    /*!
+     * List the conversion IDs that have at least one registered converter.
+     * \return the conversion IDs, in no particular order
+     */
+    UHD_API std::vector<id_type> get_converter_ids(void);
+
     /*!
      * Register the size of a particular item.
      * \param format the item format
@@ -21,6 +21,7 @@
 #include <uhd/device.hpp>
 #include <uhd/rfnoc/graph.hpp>
 #include <uhd/rfnoc/block_ctrl_base.hpp>
+#include <boost/function.hpp>
 #include <boost/units/detail/utility.hpp>
 #include <vector>
 
@@ -49,6 +50,44 @@ class UHD_API device3 : public uhd::device {
      */
     void clear();
 
+    //! Changes block settings, see reconfigure_streamers()
+    typedef boost::function<void(void)> reconfigure_fn_t;
+
+    /*! Change the rates of blocks that existing streamers are connected to,
+     * without making new streamers.
+     *
+     * Changing a rate on a block (e.g. the output rate of a DDC or the
+     * input rate of a DUC) does not reach the streamers connected to it.
+     * Instead, call this with a function that changes the blocks:
+     * - the continuous streams of \p rx_streamers are stopped,
+     * - \p reconfigure is called,
+     * - the sample rate, scaling and tick rate of all streamers on this
+     *   device are read back from the graph,
+     * - the stopped streams are restarted.
+     *
+     * The transports, flow control state and buffers of the streamers are
+     * kept. The samples received before the change are still returned by
+     * recv(), followed by the samples at the new rate.
+     *
+     * \code{.cpp}
+     * void set_ddc_rate(ddc_block_ctrl::sptr ddc, const double rate) {
+     *     ddc->set_arg<double>("output_rate", rate);
+     * }
+     * // Assume DEV is a device3::sptr, and rx_stream is fed by ddc
+     * DEV->reconfigure_streamers(
+     *     boost::bind(&set_ddc_rate, ddc, 1e6),
+     *     std::vector<rx_streamer::sptr>(1, rx_stream)
+     * );
+     * \endcode
+     *
+     * \param reconfigure Changes the block settings
+     * \param rx_streamers The RX streamers to stop while the blocks are changed
+     */
+    virtual void reconfigure_streamers(
+        const reconfigure_fn_t &reconfigure,
+        const std::vector<rx_streamer::sptr> &rx_streamers = std::vector<rx_streamer::sptr>()
+    );
+
     /*! \brief Checks if an RFNoC block exists on the device.
      *
      * \param block_id Canonical block name (e.g. "0/FFT_1").
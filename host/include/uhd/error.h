@@ -149,6 +149,46 @@ UHD_API void set_c_global_error_string(const std::string &msg);
     set_c_global_error_string("None"); \
     return UHD_ERROR_NONE;
 
+/*!
+ * Variant of UHD_SAFE_C_SAVE_ERROR() for calls in the streaming path.
+ * On success, it neither takes the global error lock nor writes any
+ * string: the handle's message is only reset to "None" once after a
+ * failed call, which is tracked by the handle's last_error_set flag.
+ * Errors are saved into the handle and the global error string as usual,
+ * but the global string is not reset by a successful call.
+ */
+#define UHD_SAFE_C_SAVE_STREAM_ERROR(h, ...) \
+    try{ __VA_ARGS__ } \
+    catch (const uhd::exception &e) { \
+        set_c_global_error_string(e.what()); \
+        h->last_error = e.what(); \
+        h->last_error_set = true; \
+        return error_from_uhd_exception(&e); \
+    } \
+    catch (const boost::exception &e) { \
+        set_c_global_error_string(boost::diagnostic_information(e)); \
+        h->last_error = boost::diagnostic_information(e); \
+        h->last_error_set = true; \
+        return UHD_ERROR_BOOSTEXCEPT; \
+    } \
+    catch (const std::exception &e) { \
+        set_c_global_error_string(e.what()); \
+        h->last_error = e.what(); \
+        h->last_error_set = true; \
+        return UHD_ERROR_STDEXCEPT; \
+    } \
+    catch (...) { \
+        set_c_global_error_string("Unrecognized exception caught."); \
+        h->last_error = "Unrecognized exception caught."; \
+        h->last_error_set = true; \
+        return UHD_ERROR_UNKNOWN; \
+    } \
+    if (h->last_error_set) { \
+        h->last_error = "None"; \
+        h->last_error_set = false; \
+    } \
+    return UHD_ERROR_NONE;
+
 extern "C" {
 #endif
 
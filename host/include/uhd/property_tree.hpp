@@ -246,6 +246,15 @@ public:
     //! Get access to a property in the tree
     template <typename T> property<T> &access(const fs_path &path);
 
+    /*!
+     * Get a shared handle to a property in the tree.
+     * Look up a property once and keep the handle to access it
+     * repeatedly without going through the path lookup again.
+     * The handle keeps the property alive even if it is removed
+     * from the tree.
+     */
+    template <typename T> boost::shared_ptr<property<T> > access_handle(const fs_path &path) const;
+
 private:
     //! Internal create property with wild-card type
     virtual void _create(const fs_path &path, const boost::shared_ptr<void> &prop) = 0;
@@ -253,6 +262,104 @@ private:
     //! Internal access property with wild-card type
     virtual boost::shared_ptr<void> &_access(const fs_path &path) const = 0;
 
+    //! Internal access to a copy of a property pointer with wild-card type
+    virtual boost::shared_ptr<void> _access_handle(const fs_path &path) const = 0;
+
+};
+
+/*!
+ * A set of property changes, committed together.
+ *
+ * The changes are staged with set() and applied by commit(), in the order
+ * they were staged. The properties are looked up when staging, so a bad
+ * path throws right away. During the commit, properties backed by expert
+ * graphs do not resolve for each change: each graph resolves once, after
+ * all the changes, so each affected expert runs once for the whole set.
+ *
+ * A commit is not atomic: it stops at the first change that throws, and
+ * the changes before it remain applied.
+ */
+class UHD_API property_transaction{
+public:
+    //! Create an empty transaction for the properties of a tree
+    property_transaction(property_tree::sptr tree);
+
+    /*!
+     * Stage a change.
+     * \param path the path of the property, relative to the tree
+     * \param value the new value
+     * \return a reference to this transaction for chaining
+     * \throws uhd::lookup_error if the property does not exist
+     */
+    template <typename T> property_transaction &set(const fs_path &path, const T &value);
+
+    //! Get the number of staged changes
+    size_t size(void) const;
+
+    //! Drop all the staged changes
+    void clear(void);
+
+    /*!
+     * Apply all the staged changes, see the class description.
+     * The staged changes are kept, so a transaction can be committed again.
+     */
+    void commit(void);
+
+private:
+    friend class property_snapshot;
+
+    property_tree::sptr _tree;
+    std::vector<boost::function<void(void)> > _changes;
+};
+
+/*!
+ * The values of a set of properties, to switch back to them later.
+ *
+ * The properties are added with add(), in the order they are restored:
+ * a property which others depend on, like a sample rate, must come
+ * before them. capture() saves their desired and current values.
+ * restore() sets the saved desired value of each property whose desired
+ * or current value differs from the saved one, in order, and leaves the
+ * others alone, so no subscriber or coercer runs for them. The check of
+ * a property is done after the properties before it were restored, so
+ * a property coerced by an earlier one is set again when needed.
+ *
+ * The restore is a property_transaction, so the expert graphs resolve
+ * once for the whole restore, and a command time set around it (see
+ * multi_usrp::commit_transaction()) applies to all the register writes.
+ */
+class UHD_API property_snapshot{
+public:
+    //! Create an empty snapshot for the properties of a tree
+    property_snapshot(property_tree::sptr tree);
+
+    /*!
+     * Add a property to the snapshot, it is not captured yet.
+     * \param path the path of the property, relative to the tree
+     * \return a reference to this snapshot for chaining
+     * \throws uhd::lookup_error if the property does not exist
+     */
+    template <typename T> property_snapshot &add(const fs_path &path);
+
+    //! Get the number of properties in the snapshot
+    size_t size(void) const;
+
+    //! Save the values of the properties, empty properties are skipped
+    void capture(void);
+
+    /*!
+     * Make the transaction which restores the captured values.
+     * The differences are checked when it is committed.
+     */
+    property_transaction make_restore_transaction(void) const;
+
+    //! Restore the captured values now, see the class description
+    void restore(void);
+
+private:
+    property_tree::sptr _tree;
+    std::vector<boost::function<void(void)> > _capturers;
+    std::vector<boost::function<void(void)> > _restorers;
 };
 
 } //namespace uhd
@@ -19,6 +19,7 @@
 #define INCLUDED_UHD_PROPERTY_TREE_IPP
 
 #include <uhd/exception.hpp>
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <vector>
@@ -146,6 +147,41 @@ private:
     boost::scoped_ptr<T>                                _coerced_value;
 };
 
+/***********************************************************************
+ * Implement a captured property of a snapshot
+ **********************************************************************/
+template <typename T> class property_snapshot_entry{
+public:
+    property_snapshot_entry(const boost::shared_ptr<property<T> > &prop): _prop(prop){
+        /* NOP */
+    }
+
+    void capture(void){
+        _desired.reset();
+        _current.reset();
+        //a property which was never set, like a read-only one, is not kept
+        if (_prop->empty()) return;
+        try{
+            _desired.reset(new T(_prop->get_desired()));
+        }
+        catch(const uhd::runtime_error &){
+            return;
+        }
+        _current.reset(new T(_prop->get()));
+    }
+
+    void restore(void){
+        if (_desired.get() == NULL) return;
+        if (_prop->get_desired() == *_desired and _prop->get() == *_current) return;
+        _prop->set(*_desired);
+    }
+
+private:
+    const boost::shared_ptr<property<T> > _prop;
+    boost::scoped_ptr<T> _desired;
+    boost::scoped_ptr<T> _current;
+};
+
 }} //namespace uhd::/*anon*/
 
 /***********************************************************************
@@ -162,6 +198,23 @@ namespace uhd{
         return *boost::static_pointer_cast<property<T> >(this->_access(path));
     }
 
+    template <typename T> boost::shared_ptr<property<T> > property_tree::access_handle(const fs_path &path) const{
+        return boost::static_pointer_cast<property<T> >(this->_access_handle(path));
+    }
+
+    template <typename T> property_transaction &property_transaction::set(const fs_path &path, const T &value){
+        _changes.push_back(boost::bind(&property<T>::set, _tree->access_handle<T>(path), value));
+        return *this;
+    }
+
+    template <typename T> property_snapshot &property_snapshot::add(const fs_path &path){
+        boost::shared_ptr<property_snapshot_entry<T> > entry(
+            new property_snapshot_entry<T>(_tree->access_handle<T>(path)));
+        _capturers.push_back(boost::bind(&property_snapshot_entry<T>::capture, entry));
+        _restorers.push_back(boost::bind(&property_snapshot_entry<T>::restore, entry));
+        return *this;
+    }
+
 } //namespace uhd
 
 #endif /* INCLUDED_UHD_PROPERTY_TREE_IPP */
@@ -191,6 +191,27 @@ public:
      */
     void sr_write(const std::string &reg, const uint32_t data, const size_t port = 0);
 
+    /*! Write a sequence of values to one settings register.
+     *
+     * This is meant for loading filter taps or tables, where every value
+     * goes to the same register. All writes are sent in one batch, and
+     * the call waits for their acknowledgements only once at the end
+     * instead of once per value.
+     *
+     * \param reg The settings register to write to.
+     * \param data The values to write, in this order.
+     * \param port Port on which to write
+     */
+    void sr_write(const uint32_t reg, const std::vector<uint32_t> &data, const size_t port = 0);
+
+    /*! Write a sequence of values to one settings register.
+     *
+     * Like the previous sr_write(), but takes a register name as argument.
+     *
+     * \throw uhd::key_error if \p reg is not a valid register name
+     */
+    void sr_write(const std::string &reg, const std::vector<uint32_t> &data, const size_t port = 0);
+
     /*! Allows reading one register on the settings bus (64-Bit version).
      *
      * \param reg The settings register to be read.
@@ -411,6 +432,9 @@ private:
     //! Helper function to initialize the block args (used by ctor only)
     void _init_block_args();
 
+    //! Look up the address of a named settings register
+    uint32_t _get_sr_addr(const std::string &reg);
+
     /***********************************************************************
      * Private members
      **********************************************************************/
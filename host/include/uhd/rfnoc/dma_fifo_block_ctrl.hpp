@@ -20,6 +20,7 @@
 
 #include <uhd/rfnoc/source_block_ctrl_base.hpp>
 #include <uhd/rfnoc/sink_block_ctrl_base.hpp>
+#include <uhd/stream.hpp>
 
 namespace uhd {
     namespace rfnoc {
@@ -32,6 +33,11 @@ namespace uhd {
  * - The base storage for the FIFO can be device
  *   specific. Usually it will be an off-chip SDRAM
  *   bank.
+ * - In a receive chain, it lets the device absorb host
+ *   stalls of up to the FIFO depth, see get_fill_level().
+ * - On FPGA images with replay enabled, a waveform can
+ *   be uploaded into the FIFO once and then be played
+ *   out of it repeatedly, without any host bandwidth.
  *
  */
 class UHD_RFNOC_API dma_fifo_block_ctrl : public source_block_ctrl_base, public sink_block_ctrl_base
@@ -48,6 +54,59 @@ public:
     //! Returns the depth of the FIFO (in bytes).
     uint32_t get_depth(const size_t chan) const;
 
+    /*! Returns the number of bytes in the FIFO.
+     *
+     * When the FIFO buffers a receive stream, this is how far the
+     * host is behind the device. It is also published in the property
+     * tree, at the block's fill_level/<chan> node.
+     */
+    virtual uint32_t get_fill_level(const size_t chan) = 0;
+
+    //! Returns true if the FPGA image supports replay
+    virtual bool replay_supported(const size_t chan) = 0;
+
+    /*! Upload a waveform into the FIFO for replay.
+     *
+     * The FIFO is cleared, and keeps the burst sent with \p tx_stream
+     * instead of passing it on. The streamer must feed the input port
+     * of this channel, the output port feeds the consumer of the replay.
+     *
+     * \param tx_stream A streamer into the input port of \p chan
+     * \param buff The waveform, in the CPU format of \p tx_stream
+     * \param nsamps The number of samples of the waveform
+     * \param chan The FIFO channel
+     * \throws uhd::not_implemented_error if the FPGA image has no replay
+     * \throws uhd::runtime_error if the waveform did not fit the FIFO
+     */
+    virtual void upload(
+        tx_streamer::sptr tx_stream,
+        const void *buff,
+        const size_t nsamps,
+        const size_t chan
+    ) = 0;
+
+    /*! Play the uploaded waveform out of the FIFO.
+     *
+     * \param num_repeats The number of times to play the waveform, 0 plays it until stop()
+     * \param time_spec The time to start at, time_spec_t(0.0) starts right away
+     * \param chan The FIFO channel
+     * \throws uhd::runtime_error if no waveform was uploaded
+     */
+    virtual void play(
+        const size_t num_repeats,
+        const time_spec_t &time_spec,
+        const size_t chan
+    ) = 0;
+
+    //! Stop the playback, the waveform is kept and can be played again.
+    virtual void stop(const size_t chan) = 0;
+
+    //! Returns true while the waveform is being played
+    virtual bool is_playing(const size_t chan) = 0;
+
+    //! Returns the number of times the waveform was played since play()
+    virtual size_t get_num_played(const size_t chan) = 0;
+
 }; /* class dma_fifo_block_ctrl*/
 
 }} /* namespace uhd::rfnoc */
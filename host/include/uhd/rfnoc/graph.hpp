@@ -20,6 +20,8 @@
 
 #include <boost/noncopyable.hpp>
 #include <uhd/rfnoc/block_id.hpp>
+#include <uhd/rfnoc/host_block_ctrl.hpp>
+#include <uhd/rfnoc/constants.hpp>
 
 namespace uhd { namespace rfnoc {
 
@@ -53,6 +55,31 @@ public:
             const block_id_t &dst_block
     ) = 0;
 
+    /*! Connect a host block downstream of the RFNOC block with block ID \p src_block.
+     *
+     * This only registers the blocks with each other, the data still goes
+     * to the host. An rx streamer on \p src_block and \p src_block_port
+     * then runs the host block on its samples, see host_block_ctrl.
+     */
+    virtual void connect(
+            const block_id_t &src_block,
+            size_t src_block_port,
+            host_block_ctrl::sptr dst_block,
+            size_t dst_block_port = ANY_PORT
+    ) = 0;
+
+    /*! Connect a host block upstream of the RFNOC block with block ID \p dst_block.
+     *
+     * A tx streamer on \p dst_block and \p dst_block_port then runs the
+     * host block on its samples, see host_block_ctrl.
+     */
+    virtual void connect(
+            host_block_ctrl::sptr src_block,
+            size_t src_block_port,
+            const block_id_t &dst_block,
+            size_t dst_block_port
+    ) = 0;
+
     virtual std::string get_name() const = 0;
 };
 
@@ -0,0 +1,103 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_HOST_BLOCK_CTRL_HPP
+#define INCLUDED_LIBUHD_HOST_BLOCK_CTRL_HPP
+
+#include <uhd/rfnoc/source_node_ctrl.hpp>
+#include <uhd/rfnoc/sink_node_ctrl.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+
+namespace uhd {
+    namespace rfnoc {
+
+/*! \brief Base class for software blocks that run on the host.
+ *
+ * A host block sits in the graph between a hardware block and a streamer:
+ * connect it downstream of a block's output with graph::connect(), then
+ * create an rx streamer on that block and port. For transmit, connect it
+ * upstream of a block's input and create a tx streamer on that block.
+ * Input port N of a host block always goes with its output port N.
+ *
+ * The streamer calls work() with the samples of every packet while they
+ * are still in the transport buffer, right before converting them to the
+ * user's buffer (rx) or right after converting them from it (tx). The
+ * samples are processed in place, there is no copy. work() runs on the
+ * converter thread of the channel, so use the convert_threads and
+ * convert_cpus stream args to run it on a pinned worker, and on the
+ * thread calling recv() or send() otherwise.
+ *
+ * The samples are in the transport format, which is given to
+ * set_item_format() when a streamer is set up, e.g. "sc16_item32_le" for
+ * sc16 samples in little endian 32 bit words.
+ *
+ * Host blocks are not rate, scalar or tick nodes, so they do not change
+ * the sample rate or scaling seen by the streamer. A host block may be
+ * used by one streamer per port at a time.
+ */
+class UHD_RFNOC_API host_block_ctrl;
+class host_block_ctrl : public source_node_ctrl, public sink_node_ctrl
+{
+public:
+    typedef boost::shared_ptr<host_block_ctrl> sptr;
+
+    virtual ~host_block_ctrl() {}
+
+    /*! Process the samples of one packet in place.
+     *
+     * \param buff The samples, in the item format of \p port
+     * \param nsamps The number of samples in \p buff
+     * \param port The port the samples pass through
+     */
+    virtual void work(void *buff, const size_t nsamps, const size_t port) = 0;
+
+    /*! Set the item format of the samples of a port.
+     *
+     * This is called by the streamer setup before any call to work() on
+     * this port. Overrides should throw a uhd::value_error on formats
+     * they cannot process, and call this to store the format.
+     */
+    virtual void set_item_format(const std::string &format, const size_t port);
+
+    //! Get the item format of a port, empty if no streamer was set up
+    std::string get_item_format(const size_t port) const;
+
+    //! Forwards the command to the upstream block on this port
+    void issue_stream_cmd(const uhd::stream_cmd_t &stream_cmd, const size_t chan=0);
+
+    std::string unique_id() const { return _name; }
+
+protected:
+    /*!
+     * \param name A unique name for this block, used in messages
+     */
+    host_block_ctrl(const std::string &name);
+
+private:
+    const std::string _name;
+
+    mutable boost::mutex _format_mutex;
+    std::map<size_t, std::string> _item_formats;
+
+}; /* class host_block_ctrl */
+
+}} /* namespace uhd::rfnoc */
+
+#endif /* INCLUDED_LIBUHD_HOST_BLOCK_CTRL_HPP */
+// vim: sw=4 et:
@@ -21,6 +21,7 @@
 #include <uhd/types/device_addr.hpp>
 #include <uhd/rfnoc/constants.hpp>
 #include <uhd/utils/log.hpp>
+#include <uhd/utils/atomic.hpp>
 #include <stdint.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/utility.hpp>
@@ -28,6 +29,8 @@
 #include <boost/function.hpp>
 #include <map>
 #include <set>
+#include <string>
+#include <vector>
 
 namespace uhd {
     namespace rfnoc {
@@ -117,6 +120,9 @@ public:
      * Returns blocks that are of type T.
      *
      * Search only goes downstream.
+     *
+     * The results are cached until the next change of any connection or
+     * streamer activity in any graph (see _topology_changed()).
      */
     template <typename T>
     UHD_INLINE std::vector< boost::shared_ptr<T> > find_downstream_node(bool active_only = false)
@@ -229,6 +235,16 @@ protected:
             size_t port
     );
 
+    /*! Invalidates the cached search results of all nodes.
+     *
+     * Connecting and disconnecting nodes calls this. Child classes must
+     * call it when they change _rx_streamer_active or _tx_streamer_active.
+     */
+    static void _topology_changed();
+
+    //! Returns a counter that changes with every call to _topology_changed()
+    static uint32_t _get_topology_version();
+
 private:
     /*! Implements the search algorithm for find_downstream_node() and
      * find_upstream_node().
@@ -241,6 +257,18 @@ private:
     template <typename T, bool downstream>
     std::vector< boost::shared_ptr<T> > _find_child_node(bool active_only = false);
 
+    //! A search result of _find_child_node()
+    struct find_cache_entry_t
+    {
+        uint32_t topology_version;
+        std::vector< wptr > nodes;
+    };
+
+    /*! Stores the search results of _find_child_node(), by node type,
+     * direction and active_only.
+     */
+    std::map< std::string, find_cache_entry_t > _find_cache;
+
     /*! Implements the search algorithm for find_downstream_unique_property() and
      * find_upstream_unique_property().
      *
@@ -23,6 +23,7 @@
 #include <uhd/exception.hpp>
 #include <uhd/utils/msg.hpp>
 #include <boost/shared_ptr.hpp>
+#include <typeinfo>
 #include <vector>
 
 namespace uhd {
@@ -32,6 +33,28 @@ namespace uhd {
     std::vector< boost::shared_ptr<T> > node_ctrl_base::_find_child_node(bool active_only)
     {
         typedef boost::shared_ptr<T> T_sptr;
+
+        // Try the cache first, it is valid if nothing changed and all
+        // the nodes still exist:
+        const uint32_t topology_version = _get_topology_version();
+        const std::string cache_key = std::string(typeid(T).name())
+            + (downstream ? "/downstream" : "/upstream")
+            + (active_only ? "/active" : "");
+        std::map< std::string, find_cache_entry_t >::const_iterator cached = _find_cache.find(cache_key);
+        if (cached != _find_cache.end() and cached->second.topology_version == topology_version) {
+            std::vector< T_sptr > results;
+            BOOST_FOREACH(const wptr &node, cached->second.nodes) {
+                T_sptr node_sptr = boost::dynamic_pointer_cast<T>(node.lock());
+                if (not node_sptr) {
+                    break;
+                }
+                results.push_back(node_sptr);
+            }
+            if (results.size() == cached->second.nodes.size()) {
+                return results;
+            }
+        }
+
         static const size_t MAX_ITER = 20;
         size_t iters = 0;
         // List of return values:
@@ -86,6 +109,9 @@ namespace uhd {
         }
 
         std::vector< T_sptr > results(results_s.begin(), results_s.end());
+        find_cache_entry_t &entry = _find_cache[cache_key];
+        entry.topology_version = topology_version;
+        entry.nodes.assign(results.begin(), results.end());
         return results;
     }
 
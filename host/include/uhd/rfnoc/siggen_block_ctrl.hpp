@@ -0,0 +1,115 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_RFNOC_SIGGEN_BLOCK_HPP
+#define INCLUDED_LIBUHD_RFNOC_SIGGEN_BLOCK_HPP
+
+#include <uhd/rfnoc/source_block_ctrl_base.hpp>
+#include <uhd/rfnoc/sink_block_ctrl_base.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <complex>
+
+namespace uhd {
+    namespace rfnoc {
+
+/*! \brief Block controller for a signal generator block.
+ *
+ * The signal generator makes test and calibration signals in the FPGA,
+ * so they take no host bandwidth or CPU:
+ * - a constant I and Q
+ * - a tone, at a frequency relative to the rate its output is consumed at
+ * - noise
+ * - a chirp, as steps of the tone frequency queued as timed commands
+ *
+ * The output is switched on and off with set_enable(), which can be
+ * timed. The amplitudes are relative to full scale.
+ */
+class UHD_RFNOC_API siggen_block_ctrl : public source_block_ctrl_base, public sink_block_ctrl_base
+{
+public:
+    UHD_RFNOC_BLOCK_OBJECT(siggen_block_ctrl)
+
+    //! The most frequency steps of a chirp, to fit the command queue of the block
+    static const size_t MAX_CHIRP_STEPS = 16;
+
+    //! Output a constant, I and Q each from -1.0 to 1.0
+    virtual void set_constant(const std::complex<double> &value, const size_t chan = 0) = 0;
+
+    /*! Output a tone.
+     *
+     * \param freq The frequency in Hz, from -samp_rate/2 to samp_rate/2
+     * \param samp_rate The rate the output is consumed at, e.g. the input rate of a DUC
+     * \param amplitude The amplitude from 0.0 to 1.0
+     * \param chan The output port
+     * \throws uhd::value_error if the frequency or amplitude is out of range
+     */
+    virtual void set_tone(
+        const double freq,
+        const double samp_rate,
+        const double amplitude,
+        const size_t chan = 0
+    ) = 0;
+
+    //! Output noise, with an amplitude from 0.0 to 1.0
+    virtual void set_noise(const double amplitude, const size_t chan = 0) = 0;
+
+    /*! Output a tone that steps from one frequency to another.
+     *
+     * The tone starts at \p start_freq, and each step is a timed command,
+     * the last one at \p stop_freq at \p time_spec + \p duration.
+     *
+     * \param start_freq The first frequency in Hz
+     * \param stop_freq The last frequency in Hz
+     * \param samp_rate The rate the output is consumed at
+     * \param duration The time from the first to the last step in seconds
+     * \param amplitude The amplitude from 0.0 to 1.0
+     * \param time_spec The time of the first step, must be set
+     * \param num_steps The number of steps after the first, up to MAX_CHIRP_STEPS
+     * \param chan The output port
+     * \throws uhd::value_error on a bad frequency, time or number of steps
+     */
+    virtual void set_chirp(
+        const double start_freq,
+        const double stop_freq,
+        const double samp_rate,
+        const double duration,
+        const double amplitude,
+        const time_spec_t &time_spec,
+        const size_t num_steps = MAX_CHIRP_STEPS,
+        const size_t chan = 0
+    ) = 0;
+
+    /*! Switch the output on or off.
+     *
+     * \param enable True to output the signal
+     * \param time_spec The time to switch at, time_spec_t(0.0) switches right away
+     * \param chan The output port
+     */
+    virtual void set_enable(
+        const bool enable,
+        const time_spec_t &time_spec = time_spec_t(0.0),
+        const size_t chan = 0
+    ) = 0;
+
+    //! Returns true if the output was switched on last
+    virtual bool get_enable(const size_t chan = 0) = 0;
+
+}; /* class siggen_block_ctrl*/
+
+}} /* namespace uhd::rfnoc */
+
+#endif /* INCLUDED_LIBUHD_RFNOC_SIGGEN_BLOCK_HPP */
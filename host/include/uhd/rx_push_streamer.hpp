@@ -0,0 +1,112 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_RX_PUSH_STREAMER_HPP
+#define INCLUDED_UHD_RX_PUSH_STREAMER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/metadata.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <vector>
+
+namespace uhd{
+
+/*!
+ * Runs the receive loop of an RX streamer on an internal thread.
+ *
+ * The thread receives converted, time-aligned blocks of samples into a
+ * fixed pool of buffers and passes each block to a user handler. The
+ * handler runs on the internal thread and may keep the block, e.g. to
+ * hand it off to a worker thread. The buffers of a block go back to the
+ * pool when the last reference to it is dropped. When the handler holds
+ * every block of the pool, the thread waits for one to come back, and
+ * the device will overflow if that takes too long.
+ *
+ * The streamer is still controlled through issue_stream_cmd() on the
+ * RX streamer. Timeouts without samples are not passed to the handler,
+ * every other block is, including overflows and other errors.
+ *
+ * \code{.cpp}
+ * uhd::rx_push_streamer::sptr pump = uhd::rx_push_streamer::make(
+ *     rx_stream, stream_args, &handle_block, uhd::device_addr_t("block_size=10000")
+ * );
+ * rx_stream->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+ * \endcode
+ */
+class UHD_API rx_push_streamer : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<rx_push_streamer> sptr;
+
+    //! A block of received samples
+    struct block_t{
+        //! One buffer per channel, holding block_size samples of the CPU format
+        std::vector<void *> buffs;
+        //! The number of samples per channel in the buffers
+        size_t nsamps;
+        //! The metadata of the first sample
+        rx_metadata_t metadata;
+    };
+
+    //! Holds a block out of the pool while a copy exists
+    typedef boost::shared_ptr<const block_t> block_sptr;
+
+    //! The user handler, called on the internal thread
+    typedef boost::function<void(const block_sptr &)> handler_type;
+
+    /*!
+     * Make a new push streamer and start its thread.
+     *
+     * The push args are:
+     * - block_size: samples per channel and block, defaults to the max samples per packet.
+     *   A block of several packets gathers them in one call on the RX streamer.
+     * - queue_depth: the number of blocks in the pool, defaults to 8
+     * - priority: the thread priority, see uhd::set_thread_priority(), unchanged by default
+     * - cpus: space separated list of CPUs to pin the thread to
+     *
+     * \param rx_stream the streamer to receive from
+     * \param stream_args the args the streamer was made with, for the CPU format
+     * \param handler the handler to call with each block
+     * \param push_args the push args, see above
+     * \return a new push streamer, destroying it stops the thread
+     * \throws uhd::value_error on invalid push args
+     */
+    static sptr make(
+        rx_streamer::sptr rx_stream,
+        const stream_args_t &stream_args,
+        const handler_type &handler,
+        const device_addr_t &push_args = device_addr_t()
+    );
+
+    virtual ~rx_push_streamer(void) = 0;
+
+    //! Get the number of samples per channel in a full block
+    virtual size_t get_block_size(void) const = 0;
+
+    //! Get the number of blocks in the pool
+    virtual size_t get_queue_depth(void) const = 0;
+
+    //! Get the number of times the thread waited for a block to come back
+    virtual size_t get_num_stalls(void) const = 0;
+};
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_RX_PUSH_STREAMER_HPP */
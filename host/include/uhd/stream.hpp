@@ -21,9 +21,12 @@
 #include <uhd/config.hpp>
 #include <uhd/types/metadata.hpp>
 #include <uhd/types/device_addr.hpp>
+#include <uhd/types/histogram.hpp>
 #include <uhd/types/stream_cmd.hpp>
 #include <uhd/types/ref_vector.hpp>
+#include <uhd/transport/zero_copy.hpp>
 #include <boost/utility.hpp>
+#include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 #include <vector>
 #include <string>
@@ -70,6 +73,7 @@ struct UHD_API stream_args_t{
      * Conversions for the following CPU formats have been implemented:
      *  - fc64 - complex<double>
      *  - fc32 - complex<float>
+     *  - fc16 - complex<half>, IEEE 754 half precision, held as uint16_t
      *  - sc16 - complex<int16_t>
      *  - sc8 - complex<int8_t>
      *
@@ -128,14 +132,85 @@ struct UHD_API stream_args_t{
      * Users should specify this option to request smaller than default
      * packets, probably with the intention of reducing packet latency.
      *
+     * - profile: "throughput" (default) or "latency". Device3 streamers
+     * use this to pick the packet size and flow control window, unless
+     * spp or the window are given explicitly. With "latency", packets
+     * hold about 50 us of samples and at most about 1 ms of packets are
+     * in flight. The chosen values can be read from the property tree at
+     * /mboards/<N>/rx_streamers/<ID>/params (or tx_streamers).
+     *
      * - noclear: Used by tx_dsp_core_200 and rx_dsp_core_200
      *
+     * - convert_threads: the number of threads used to convert samples
+     * of multi-channel streamers. The thread calling recv() or send()
+     * converts its share of the channels, additional helper threads
+     * convert the rest. Defaults to 1 (no helper threads).
+     *
+     * - convert_cpus: space separated list of CPUs the converter helper
+     * threads are pinned to, e.g. "2 3 4". Only used with convert_threads
+     * or chan_threads.
+     *
+     * - chan_threads: TX only. Set to 1 to convert and commit the packet
+     * of each channel on its own worker thread, pinned to the CPUs of
+     * convert_cpus in turn. send() gets the buffers of all channels
+     * first, so the channels always send the same packets, and returns
+     * once every worker committed its packet. This replaces convert_threads.
+     *
+     * - chan_spin_us: the time the workers of chan_threads and the thread
+     * calling send() spin before they sleep (defaults to 100).
+     *
+     * - mboard_threads: RX only. Set to 1 to drain the transports of each
+     * motherboard on a thread of its own, into a ring per channel.
+     * recv() then only aligns and converts the buffers of the rings, so
+     * a slow link no longer stalls the channels of the other boards.
+     *
+     * - mboard_cpus: space separated list of CPUs the receive threads of
+     * mboard_threads are pinned to, one per motherboard in turn.
+     *
+     * - mboard_ring: the number of buffers in the ring of each channel
+     * of mboard_threads. Defaults to the frames of the channel's transport.
+     *
+     * - converter: name of the sample converter to use instead of the
+     * fastest one the host supports, e.g. "generic", "sse2" or "avx2".
+     * See uhd::convert::get_converter_infos() for the available names.
+     * Converters named with a "_nt" suffix (e.g. "avx2_nt") write the
+     * RX samples with streaming stores, which bypass the CPU cache.
+     *
+     * - nt_threshold: RX buffers of more than this many bytes per channel
+     * are converted with the streaming store converter, if there is one
+     * for the format. Defaults to 8 MiB, 0 disables this.
+     * It has no effect with the converter or correction stream args.
+     *
+     * - correction_gain, correction_offset: a complex gain and offset the
+     * RX converter applies to the float samples while converting them,
+     * out = in*gain + offset. The value is the real part, optionally
+     * followed by a space and the imaginary part, e.g. "0.98 0.01".
+     * Append the channel index (e.g. correction_gain1) to set a value
+     * for one channel of the streamer only. Only the sc16 to fc32
+     * conversion supports corrections.
+     *
+     * - warm_start: set to 1 to get the streamer ready for its first
+     * packet before get_rx_stream() or get_tx_stream() returns. The
+     * converters run once on a zeroed packet, and the memory of the
+     * process, including the transport buffers, is faulted in and locked
+     * into RAM. A status message reports when the streamer is ready.
+     *
+     * - warm_start_lock: the memory a warm start locks: "current" the
+     * pages mapped now (default), "all" also the pages mapped later, like
+     * buffers the application allocates afterwards, or "none".
+     * Locking needs a large enough memlock limit (ulimit -l).
+     *
      * The following are not implemented, but are listed for conceptual purposes:
      * - function: magnitude or phase/magnitude
      * - units: numeric units like counts or dBm
      *
      * Other options are device-specific:
      * - port, addr: Alternative receiver streamer destination.
+     * - reuse_xport: Set to 1 to have Generation-3 devices keep the
+     * transports of destroyed streamers, and hand them to a new streamer
+     * on the same block port with the same transport args, which skips
+     * making a new transport. The packets still arriving on a reused
+     * transport are dropped first. Defaults to 0.
      */
     device_addr_t args;
 
@@ -223,6 +298,93 @@ public:
         const bool one_packet = false
     ) = 0;
 
+    /*!
+     * A packet received with recv_borrowed().
+     * The packet holds the transport buffers until release() is called or
+     * it is destroyed, the pointers in buffs are invalid afterwards.
+     */
+    struct borrowed_packet_t{
+        //! Samples in the over-the-wire format, one pointer per transport channel
+        std::vector<const void *> buffs;
+
+        //! The transport buffers behind buffs
+        std::vector<transport::managed_recv_buffer::sptr> xport_buffs;
+
+        //! Give the buffers back to the transport
+        void release(void){
+            buffs.clear();
+            xport_buffs.clear();
+        }
+    };
+
+    /*!
+     * Receive a packet without copying or converting its samples.
+     *
+     * The packet points into the memory of the transport, e.g. for writing
+     * it to disk or handing it to a DMA engine. The samples are in the
+     * over-the-wire format and byte order of the transport (see
+     * \ref page_transport), the cpu format of the stream args does not apply.
+     * The remainder of a packet partially received with recv() is returned
+     * as a fragment. The metadata is filled like with recv().
+     *
+     * Every packet held occupies a frame of the transport, so release the
+     * packets quickly and hold no more than a few at once.
+     * Like recv(), this call is *not* thread-safe.
+     *
+     * \param packet filled with the packet, any packet it held is released
+     * \param metadata data to fill describing the packet
+     * \param timeout the timeout in seconds to wait for a packet
+     * \return the number of items per buffer or 0 on error
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual size_t recv_borrowed(
+        borrowed_packet_t &packet,
+        rx_metadata_t &metadata,
+        const double timeout = 0.1
+    );
+
+    //! The metadata of a packet received with recv_packets()
+    struct packet_metadata_t{
+        //! The offset in samples of the packet in each buffer
+        size_t offset;
+
+        //! The number of samples of the packet in each buffer
+        size_t nsamps;
+
+        //! The metadata of the packet, the time spec is of its first sample
+        rx_metadata_t metadata;
+    };
+
+    /*!
+     * Receive buffers like recv(), and describe each packet in them.
+     *
+     * The buffers are filled across packets like recv() does without
+     * one_packet, and an entry is appended to packets for every packet,
+     * or fragment of a packet, copied into the buffers: the time spec,
+     * burst and fragment flags are that of the packet, not the buffer.
+     * So a large buffer keeps the timing of every packet, without a
+     * recv() call per packet.
+     *
+     * An error or end of burst ends the call like with recv(). When the
+     * call returns 0, packets holds one entry with the error metadata.
+     * Clearing packets keeps its memory, so reusing the vector does not
+     * allocate once it holds enough entries.
+     * Like recv(), this call is *not* thread-safe.
+     *
+     * \param buffs a vector of writable memory to fill with samples
+     * \param nsamps_per_buff the size of each buffer in number of samples
+     * \param packets cleared, then filled with the metadata of each packet
+     * \param timeout the timeout in seconds to wait for a packet
+     * \return the number of samples received or 0 on error
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual size_t recv_packets(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        std::vector<packet_metadata_t> &packets,
+        const double timeout = 0.1
+    );
+
     /*!
      * Issue a stream command to the usrp device.
      * This tells the usrp to send samples into the host.
@@ -235,6 +397,63 @@ public:
      * \param stream_cmd the stream command to issue
      */
     virtual void issue_stream_cmd(const stream_cmd_t &stream_cmd) = 0;
+
+    /*!
+     * Enable or disable recording the histograms of this streamer.
+     * Recording is off by default, and enabling it clears the histograms.
+     * Like recv(), this call is *not* thread-safe.
+     * \param enb true to record the histograms
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual void set_histograms_enabled(const bool enb);
+
+    /*!
+     * Get the histograms recorded by this streamer:
+     * - sample_rate: samples per second, of each call since the last one returned
+     * - packets_per_call: packets per channel handled by each call
+     * - xport_wait: ns spent waiting for each packet from the transport
+     * - convert: ns spent converting each packet, for all channels
+     * - packet_age: ns between the device time of each packet and the
+     *   host time it was taken from the transport, relative to the
+     *   packet that took the least time, because the clocks differ
+     *
+     * The histograms can be read while receiving; use uhd::to_json()
+     * to export them.
+     * \return the histograms by name
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual histograms_t get_histograms(void) const;
+
+    //! An averaged power spectrum of a channel, see get_psd()
+    struct psd_t{
+        //! The power of each bin in dBFS, a full scale tone reads 0 dB
+        std::vector<float> bins;
+
+        //! The time of the first sample averaged, if has_time_spec
+        time_spec_t time_spec;
+        bool has_time_spec;
+
+        //! The number of spectra in the average
+        size_t num_averages;
+    };
+
+    /*!
+     * Get the latest averaged power spectrum of a channel.
+     *
+     * The psd_size stream arg enables the spectrum monitor, see
+     * \ref stream_psd. The spectra are taken from the samples returned
+     * by recv(), and averaged on a thread of the streamer, so recv()
+     * only copies them. A spectrum is returned once: the call waits for
+     * the next one when the latest was already returned.
+     * Unlike recv(), this call is thread-safe.
+     *
+     * \param psd filled with the spectrum
+     * \param chan the channel of the streamer
+     * \param timeout the timeout in seconds to wait for a new spectrum
+     * \return true when psd was filled, false on a timeout
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual bool get_psd(psd_t &psd, const size_t chan = 0, const double timeout = 0.1);
 };
 
 /*!
@@ -285,6 +504,40 @@ public:
         const double timeout = 0.1
     ) = 0;
 
+    /*!
+     * Get the payloads of the next packet to fill in place.
+     *
+     * The buffers point into the frames of the transport, one per
+     * transport channel, with the header for the metadata already in place.
+     * Write the samples in the over-the-wire format and byte order of the
+     * transport, then call send_borrowed() to send them. This saves the
+     * conversion copy of send(). Fragmentation does not apply, a packet
+     * holds at most the returned number of samples.
+     *
+     * Buffers which were not sent are reused by the next call to
+     * get_borrowed_buffs() or send(), so they are never lost.
+     * Like send(), this call is *not* thread-safe.
+     *
+     * \param buffs filled with the writable payload memory
+     * \param metadata data describing the packet's contents
+     * \param timeout the timeout in seconds to wait on the transport
+     * \return the capacity in samples per buffer, 0 on timeout
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual size_t get_borrowed_buffs(
+        std::vector<void *> &buffs,
+        const tx_metadata_t &metadata,
+        const double timeout = 0.1
+    );
+
+    /*!
+     * Send the buffers of the last call to get_borrowed_buffs().
+     * \param nsamps_per_buff the number of samples written, per buffer
+     * \return the number of samples sent
+     * \throws uhd::runtime_error if no buffers are borrowed
+     */
+    virtual size_t send_borrowed(const size_t nsamps_per_buff);
+
     /*!
      * Receive and asynchronous message from this TX stream.
      * \param async_metadata the metadata to be filled in
@@ -294,6 +547,100 @@ public:
     virtual bool recv_async_msg(
         async_metadata_t &async_metadata, double timeout = 0.1
     ) = 0;
+
+    //! Typedef for a callback of async messages
+    typedef boost::function<void(const async_metadata_t &)> async_msg_callback_t;
+
+    /*!
+     * Handle the asynchronous messages of this TX stream in a callback.
+     * The callback is called in the thread which receives the messages from
+     * the device, instead of queuing them for recv_async_msg(). It should
+     * return quickly and must not call into the streamer.
+     * \param callback the callback, an empty callback queues the messages again
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual void set_async_msg_callback(const async_msg_callback_t &callback);
+
+    /*!
+     * Get the number of bursts sent by this streamer.
+     * A burst is counted when its end_of_burst packet is sent, so the
+     * number of the last burst is one less.
+     * \return the number of end of burst packets sent
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual size_t get_num_bursts_sent(void) const;
+
+    /*!
+     * Wait for the device to acknowledge the end of a burst.
+     *
+     * The wait is woken by the thread which receives the async messages
+     * from the device, without going through the queue of recv_async_msg().
+     * The burst ack messages are still queued for recv_async_msg().
+     *
+     * \param burst the number of the burst, counted from 0
+     * \param timeout the timeout in seconds to wait for the acks
+     * \return true when every channel acknowledged the burst, false for timeout
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual bool wait_for_burst_ack(const size_t burst, const double timeout = 0.1);
+
+    /*!
+     * Enable or disable recording the histograms of this streamer.
+     * See rx_streamer::set_histograms_enabled().
+     * \param enb true to record the histograms
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual void set_histograms_enabled(const bool enb);
+
+    /*!
+     * Get the histograms recorded by this streamer, like
+     * rx_streamer::get_histograms() but without packet_age.
+     * \return the histograms by name
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual histograms_t get_histograms(void) const;
+
+    /*!
+     * The state of the device buffer of a channel, from the flow control
+     * credits of the streamer. A packet holds at most get_max_num_samps()
+     * samples, so the sample counts assume full packets.
+     */
+    struct buffer_status_t{
+        size_t capacity_pkts;   //!< the packets the device buffer takes
+        size_t buffered_pkts;   //!< the packets sent and not yet consumed
+        size_t capacity_samps;  //!< the capacity in samples
+        size_t buffered_samps;  //!< the buffered samples
+        size_t free_samps;      //!< the samples that can be sent without waiting
+    };
+
+    /*!
+     * Get the state of the device buffer of a channel.
+     * This can be called while another thread sends.
+     * \param chan the channel index
+     * \return the buffered packets and samples, and the free space
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual buffer_status_t get_buffer_status(const size_t chan = 0) const;
+
+    /*!
+     * Start a burst at a time with the samples the device buffer takes.
+     * This sends as many samples as there is free space on all channels,
+     * with start_of_burst and time_spec set, so that the device starts
+     * the burst at the given time with a full buffer. Send the rest of
+     * the burst with send() without a time_spec.
+     * \param buffs the buffers of the first samples of the burst
+     * \param nsamps_per_buff the number of samples in each buffer
+     * \param time_spec the time of the first sample on the device
+     * \param timeout the timeout in seconds
+     * \return the number of samples sent, at most the free space
+     * \throws uhd::not_implemented_error if the streamer does not support it
+     */
+    virtual size_t prefill(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const time_spec_t &time_spec,
+        const double timeout = 0.1
+    );
 };
 
 } //namespace uhd
@@ -0,0 +1,90 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_STREAM_POLLER_HPP
+#define INCLUDED_UHD_STREAM_POLLER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <vector>
+
+namespace uhd{
+
+/*!
+ * Waits on many streamers at once, so one thread can serve them all.
+ *
+ * The poller blocks until any of its RX streamers has a packet ready on
+ * every channel, or any of its TX streamers has an async message ready.
+ * Then recv() or recv_async_msg() on a ready streamer returns without
+ * waiting. The poller takes the packet or message it checked out of the
+ * transport, and the streamer keeps it for the next call.
+ *
+ * RX streamers on network transports are waited on with a single
+ * poll() on their sockets. Other streamers are checked in short rounds
+ * instead, so the wait may return up to a millisecond late for them.
+ *
+ * The poller and the streamers it checks must be used from one thread.
+ *
+ * \code{.cpp}
+ * uhd::stream_poller::sptr poller = uhd::stream_poller::make();
+ * BOOST_FOREACH(uhd::rx_streamer::sptr rx_stream, rx_streams) poller->add(rx_stream);
+ * std::vector<size_t> ready;
+ * while (running) {
+ *     poller->wait(ready, 0.1);
+ *     BOOST_FOREACH(size_t i, ready) rx_streams[i]->recv(buffs, nsamps, md, 0.0, true);
+ * }
+ * \endcode
+ */
+class UHD_API stream_poller : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<stream_poller> sptr;
+
+    //! Make a new poller without streamers
+    static sptr make(void);
+
+    virtual ~stream_poller(void) = 0;
+
+    /*!
+     * Add an RX streamer to wait for its packets.
+     * \param rx_stream the streamer
+     * \return the index of the streamer in the poller
+     * \throws uhd::not_implemented_error when the streamer cannot be polled
+     */
+    virtual size_t add(rx_streamer::sptr rx_stream) = 0;
+
+    /*!
+     * Add a TX streamer to wait for its async messages.
+     * \param tx_stream the streamer
+     * \return the index of the streamer in the poller
+     * \throws uhd::not_implemented_error when the streamer cannot be polled
+     */
+    virtual size_t add(tx_streamer::sptr tx_stream) = 0;
+
+    /*!
+     * Wait until at least one streamer is ready.
+     * \param ready set to the indexes of the ready streamers
+     * \param timeout the timeout in seconds
+     * \return the number of ready streamers, 0 on timeout
+     */
+    virtual size_t wait(std::vector<size_t> &ready, const double timeout) = 0;
+};
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_STREAM_POLLER_HPP */
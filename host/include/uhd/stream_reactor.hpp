@@ -0,0 +1,191 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_STREAM_REACTOR_HPP
+#define INCLUDED_UHD_STREAM_REACTOR_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/metadata.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/future.hpp>
+#include <boost/utility.hpp>
+#include <vector>
+
+namespace uhd{
+
+/*!
+ * Runs the receive, send and async message calls of many streamers as
+ * asynchronous operations, without a thread per streamer or per call.
+ *
+ * Each async call queues an operation on a streamer and returns a future
+ * for its result. The operations are carried out by run(), called from
+ * the event loop of the application: it waits until a streamer can make
+ * progress, like uhd::stream_poller, then moves the operations along
+ * without blocking and fulfills the futures of the completed ones.
+ * The operations of a streamer complete in the order they were queued.
+ *
+ * An operation fills or sends its buffers over as many rounds as needed,
+ * so the buffers must stay valid until its future is ready. It completes
+ * with the samples handled so far when its timeout expires.
+ *
+ * Operations can be queued from any thread, but run() must always be
+ * called from the same thread, and the streamers must not be used
+ * directly while the reactor has operations queued on them.
+ *
+ * \code{.cpp}
+ * uhd::stream_reactor::sptr reactor = uhd::stream_reactor::make();
+ * const size_t rx = reactor->add(rx_stream, stream_args);
+ * boost::shared_future<uhd::stream_reactor::recv_result_t> result =
+ *     reactor->async_recv(rx, &buff.front(), buff.size());
+ * while (not result.is_ready()) reactor->run(0.1);
+ * \endcode
+ */
+class UHD_API stream_reactor : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<stream_reactor> sptr;
+
+    //! The result of async_recv()
+    struct recv_result_t{
+        //! The number of samples received in each buffer
+        size_t nsamps;
+
+        /*!
+         * The metadata of the first sample, like recv() would return it.
+         * end_of_burst is set when the burst ended in these buffers.
+         */
+        rx_metadata_t metadata;
+    };
+
+    //! The result of async_recv_async_msg()
+    struct async_msg_result_t{
+        //! False when the timeout expired before a message came
+        bool valid;
+
+        //! The message, when valid
+        async_metadata_t metadata;
+    };
+
+    //! Make a new reactor without streamers
+    static sptr make(void);
+
+    virtual ~stream_reactor(void) = 0;
+
+    /*!
+     * Add an RX streamer to run receive operations on.
+     * \param rx_stream the streamer
+     * \param stream_args the args the streamer was made with, for the CPU format
+     * \return the index of the streamer in the reactor
+     */
+    virtual size_t add(rx_streamer::sptr rx_stream, const stream_args_t &stream_args) = 0;
+
+    /*!
+     * Add a TX streamer to run send and async message operations on.
+     * \param tx_stream the streamer
+     * \param stream_args the args the streamer was made with, for the CPU format
+     * \return the index of the streamer in the reactor
+     */
+    virtual size_t add(tx_streamer::sptr tx_stream, const stream_args_t &stream_args) = 0;
+
+    /*!
+     * Queue a receive, see rx_streamer::recv().
+     *
+     * Without one_packet, the operation gathers packets until the buffers
+     * are full, the burst ends or an error comes. An error after the
+     * first samples completes the operation with those samples, and is
+     * the result of the next receive operation on the streamer.
+     *
+     * \param index the index of an RX streamer
+     * \param buffs a vector of writable memory to fill with samples
+     * \param nsamps_per_buff the size of each buffer in number of samples
+     * \param timeout the timeout in seconds, from now
+     * \param one_packet complete the operation after a single packet
+     * \return a future for the result, error codes are in its metadata
+     * \throws uhd::index_error if index is not an RX streamer
+     */
+    virtual boost::shared_future<recv_result_t> async_recv(
+        const size_t index,
+        const rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const double timeout = 1.0,
+        const bool one_packet = false
+    ) = 0;
+
+    /*!
+     * Queue a send, see tx_streamer::send().
+     *
+     * The samples may go out over several rounds. Only the first packet
+     * gets the start of burst flag and the time spec of the metadata,
+     * and only the last one gets the end of burst flag.
+     *
+     * \param index the index of a TX streamer
+     * \param buffs a vector of read-only memory containing samples
+     * \param nsamps_per_buff the number of samples to send, per buffer
+     * \param metadata data describing the buffer's contents
+     * \param timeout the timeout in seconds, from now
+     * \return a future for the number of samples sent
+     * \throws uhd::index_error if index is not a TX streamer
+     */
+    virtual boost::shared_future<size_t> async_send(
+        const size_t index,
+        const tx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const tx_metadata_t &metadata,
+        const double timeout = 1.0
+    ) = 0;
+
+    /*!
+     * Queue a receive of an async message, see tx_streamer::recv_async_msg().
+     * \param index the index of a TX streamer
+     * \param timeout the timeout in seconds, from now
+     * \return a future for the message
+     * \throws uhd::index_error if index is not a TX streamer
+     */
+    virtual boost::shared_future<async_msg_result_t> async_recv_async_msg(
+        const size_t index,
+        const double timeout = 1.0
+    ) = 0;
+
+    /*!
+     * Carry out the queued operations until at least one completes.
+     * Returns right away when no operation is queued. Operations queued
+     * from another thread during the wait are taken up when it ends.
+     * \param timeout the timeout in seconds
+     * \return the number of completed operations, 0 on timeout
+     */
+    virtual size_t run(const double timeout) = 0;
+
+    /*!
+     * Carry out the queued operations without waiting.
+     * \return the number of completed operations
+     */
+    virtual size_t poll(void) = 0;
+
+    /*!
+     * Get the descriptors to wait on for the queued operations, so the
+     * reactor can be driven from an external event loop: call poll()
+     * when any of them becomes readable.
+     * \param fds the descriptors are appended to this vector
+     * \return false when some operations cannot be waited on with
+     *         descriptors; poll() should then be called every millisecond
+     */
+    virtual bool get_fds(std::vector<int> &fds) = 0;
+};
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_STREAM_REACTOR_HPP */
@@ -19,8 +19,11 @@
 #define INCLUDED_UHD_TRANSPORT_BUFFER_POOL_HPP
 
 #include <uhd/config.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <boost/utility.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <string>
 
 namespace uhd{ namespace transport{
 
@@ -33,19 +36,57 @@ namespace uhd{ namespace transport{
         typedef boost::shared_ptr<buffer_pool> sptr;
         typedef void * ptr_type;
 
+        /*!
+         * A pluggable allocator for the memory of buffer pools.
+         * It either allocates the memory itself, or registers the memory
+         * which the pool allocated, e.g. with cudaHostRegister(), so that
+         * a GPU can DMA the frames of a transport directly.
+         * The functions are called once per pool with the whole block.
+         */
+        struct allocator_type{
+            //! Allocate the bytes, or empty to let the pool allocate them
+            boost::function<void *(const size_t)> alloc;
+            //! Free memory of alloc(), required with alloc
+            boost::function<void(void *, const size_t)> free;
+            //! Register the memory with a device once allocated, or empty
+            boost::function<void(void *, const size_t)> register_mem;
+            //! Undo register_mem() before the memory is freed, or empty
+            boost::function<void(void *, const size_t)> unregister_mem;
+        };
+
         virtual ~buffer_pool(void) = 0;
 
+        /*!
+         * Register an allocator for the buff_allocator hint of make().
+         * An allocator registered again under the same name replaces the
+         * old one for the pools made from then on.
+         * \param name the name of the allocator, e.g. "cuda"
+         * \param allocator the allocator functions
+         */
+        static void register_allocator(const std::string &name, const allocator_type &allocator);
+
         /*!
          * Make a new buffer pool.
          * \param num_buffs the number of buffers to allocate
          * \param buff_size the size of each buffer in bytes
          * \param alignment the alignment boundary in bytes
+         * \param hints options for the memory of the buffers:
+         *  - buff_hugepages: back the buffers with huge pages, "2M" or "1G"
+         *  - buff_numa_node: allocate the memory on this NUMA node
+         *  - buff_lock: set to 1 to lock the memory into RAM
+         *  - buff_allocator: the name of a registered allocator, see
+         *    register_allocator(). The other options do not apply to
+         *    memory from the allocator's alloc().
+         *  With any option, the memory is pre-faulted at creation.
+         *  The options take effect on Linux only. If huge pages are
+         *  not available, normal pages are used with a warning.
          * \return a new buffer pool buff_size X num_buffs
          */
         static sptr make(
             const size_t num_buffs,
             const size_t buff_size,
-            const size_t alignment = 16
+            const size_t alignment = 16,
+            const device_addr_t &hints = device_addr_t()
         );
 
         //! Get a pointer to the buffer start at the specified index
@@ -31,6 +31,8 @@ namespace uhd{ namespace transport{
         std::string inet;
         std::string mask;
         std::string bcast;
+        //! The name of the interface, if the system provides it
+        std::string name;
     };
 
     /*!
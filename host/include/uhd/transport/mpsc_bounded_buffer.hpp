@@ -0,0 +1,197 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_TRANSPORT_MPSC_BOUNDED_BUFFER_HPP
+#define INCLUDED_UHD_TRANSPORT_MPSC_BOUNDED_BUFFER_HPP
+
+#include <uhd/config.hpp>
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
+
+namespace uhd{ namespace transport{
+
+    /*!
+     * A bounded buffer for any number of producer threads and exactly one
+     * consumer thread.
+     *
+     * Pushing is lock-free and never waits: a full buffer drops the new
+     * element, since a producer cannot pop the oldest one without racing
+     * the consumer. Popping is lock-free as well, the mutex and condition
+     * variable are only used when the consumer has to wait, and a push
+     * only touches them when the consumer is waiting.
+     *
+     * Several threads may pop as long as they are serialized among
+     * themselves, e.g. by holding a common lock.
+     */
+    template <typename elem_type> class mpsc_bounded_buffer : boost::noncopyable{
+    public:
+
+        /*!
+         * Create a new multiple producer/single consumer bounded buffer.
+         * \param capacity the bounded buffer capacity, rounded up to a power of two
+         */
+        mpsc_bounded_buffer(size_t capacity):
+            _mask(round_up(capacity) - 1),
+            _cells(new cell_type[_mask + 1]),
+            _push_index(0), _pop_index(0), _pop_waiting(false)
+        {
+            for (size_t i = 0; i <= _mask; i++){
+                _cells[i].seq.store(i, boost::memory_order_relaxed);
+            }
+        }
+
+        /*!
+         * Push a new element into the bounded buffer immediately.
+         * The element will not be pushed when the buffer is full.
+         * This may be called from any number of threads at once.
+         * \param elem the new element to push
+         * \return false when the buffer is full
+         */
+        UHD_INLINE bool push_with_haste(const elem_type &elem){
+            //claim a cell: it is free when its sequence equals the index
+            size_t index = _push_index.load(boost::memory_order_relaxed);
+            cell_type *cell;
+            for (;;){
+                cell = &_cells[index & _mask];
+                const size_t seq = cell->seq.load(boost::memory_order_acquire);
+                const ptrdiff_t diff = ptrdiff_t(seq) - ptrdiff_t(index);
+                if (diff == 0){
+                    if (_push_index.compare_exchange_weak(index, index+1, boost::memory_order_relaxed)) break;
+                }
+                else if (diff < 0) return false; //full
+                else index = _push_index.load(boost::memory_order_relaxed);
+            }
+            cell->elem = elem;
+            cell->seq.store(index+1, boost::memory_order_release);
+            this->notify();
+            return true;
+        }
+
+        /*!
+         * Pop an element from the bounded buffer immediately.
+         * The element will not be popped when the buffer is empty.
+         * \param elem the element reference pop to
+         * \return false when the buffer is empty
+         */
+        UHD_INLINE bool pop_with_haste(elem_type &elem){
+            cell_type &cell = _cells[_pop_index & _mask];
+            if (cell.seq.load(boost::memory_order_acquire) != _pop_index+1) return false;
+            elem = cell.elem;
+            cell.elem = elem_type(); //release references held by the element
+            cell.seq.store(_pop_index + _mask + 1, boost::memory_order_release);
+            _pop_index++;
+            return true;
+        }
+
+        /*!
+         * Pop an element from the bounded_buffer.
+         * Wait until the bounded_buffer becomes non-empty.
+         * \param elem the element reference pop to
+         */
+        UHD_INLINE void pop_with_wait(elem_type &elem){
+            if (this->pop_with_haste(elem)) return;
+            this->wait(-1.0);
+            this->pop_with_haste(elem);
+        }
+
+        /*!
+         * Pop an element from the bounded_buffer.
+         * Wait until the bounded_buffer becomes non-empty or timeout.
+         * \param elem the element reference pop to
+         * \param timeout the timeout in seconds
+         * \return false when the operation times out
+         */
+        UHD_INLINE bool pop_with_timed_wait(elem_type &elem, double timeout){
+            if (this->pop_with_haste(elem)) return true;
+            if (not this->wait(timeout)) return false;
+            return this->pop_with_haste(elem);
+        }
+
+    private:
+        //a cell is free for the push of index i when seq == i,
+        //and holds the element of that push when seq == i+1
+        struct cell_type{
+            boost::atomic<size_t> seq;
+            elem_type elem;
+        };
+
+        const size_t _mask;
+        boost::scoped_array<cell_type> _cells;
+
+        //shared by the producers, keep it away from the consumer's cache line
+        boost::atomic<size_t> _push_index;
+        char _pad0[64];
+        //only used by the consumer
+        size_t _pop_index;
+        char _pad1[64];
+
+        //slow path for the waiting consumer
+        boost::atomic<bool> _pop_waiting;
+        boost::mutex _pop_mutex;
+        boost::condition_variable _pop_cond;
+
+        static size_t round_up(const size_t capacity){
+            size_t size = 2;
+            while (size < capacity) size <<= 1;
+            return size;
+        }
+
+        //only valid on the consumer side
+        bool not_empty(void) const{
+            return _cells[_pop_index & _mask].seq.load(boost::memory_order_acquire) == _pop_index+1;
+        }
+
+        /*!
+         * Wake up the consumer if it is blocked.
+         * The fence orders the push before reading the flag,
+         * it pairs with the fence in wait(), so either the consumer sees
+         * the element or this sees the consumer's flag.
+         */
+        UHD_INLINE void notify(void){
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            if (not _pop_waiting.load(boost::memory_order_relaxed)) return;
+            boost::mutex::scoped_lock lock(_pop_mutex);
+            _pop_cond.notify_one();
+        }
+
+        /*!
+         * Block until the buffer is non-empty.
+         * \param timeout the timeout in seconds, negative waits forever
+         * \return true when the buffer is non-empty, false on timeout
+         */
+        bool wait(const double timeout){
+            const boost::system_time exit_time = boost::get_system_time() +
+                boost::posix_time::microseconds(long(timeout*1e6));
+            boost::mutex::scoped_lock lock(_pop_mutex);
+            _pop_waiting.store(true, boost::memory_order_relaxed);
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            while (not this->not_empty()){
+                if (timeout < 0) _pop_cond.wait(lock);
+                else if (not _pop_cond.timed_wait(lock, exit_time)) break;
+            }
+            _pop_waiting.store(false, boost::memory_order_relaxed);
+            return this->not_empty();
+        }
+    };
+
+}} //namespace
+
+#endif /* INCLUDED_UHD_TRANSPORT_MPSC_BOUNDED_BUFFER_HPP */
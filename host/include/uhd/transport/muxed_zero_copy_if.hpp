@@ -19,6 +19,7 @@
 #define INCLUDED_LIBUHD_TRANSPORT_MUXED_ZERO_COPY_IF_HPP
 
 #include <uhd/transport/zero_copy.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <uhd/config.hpp>
 #include <boost/function.hpp>
 #include <boost/noncopyable.hpp>
@@ -63,8 +64,39 @@ public:
     //! Get number of frames dropped due to unregistered streams
     virtual size_t get_num_dropped_frames() const = 0;
 
-    //! Make a new demuxer from a transport and parameters
-    static sptr make(zero_copy_if::sptr base_xport, stream_classifier_fn classify_fn, size_t max_streams);
+    /*!
+     * Make a new demuxer from a transport and parameters
+     *
+     * The following hints are used:
+     * - mux_recv_timeout: when greater than 0, the worker thread blocks on
+     *   the base transport with this timeout (in seconds) instead of
+     *   polling it and sleeping. Shutting down may take up to this long.
+     * - mux_cpus: space separated list of CPUs the worker thread is pinned to
+     * - mux_role: the thread role of the worker thread, see uhd::setup_thread()
+     *   (defaults to "muxed_demux")
+     * - mux_push_timeout: how long the worker thread waits for a stream
+     *   which does not read its frames, before the frame is dropped
+     *   (in seconds, defaults to 0.1)
+     * - mux_release_in_order: set to 1 to hand the frames of the base
+     *   transport to the streams without copying them, for base transports
+     *   which release their frames in receive order (e.g. NI-RIO). The
+     *   frames are then released in that order. By default every frame is
+     *   copied and released right away.
+     * - mux_max_pinned: with mux_release_in_order, the number of base
+     *   frames held before the oldest queued ones are copied out
+     *   (defaults to half the frames of the base transport)
+     *
+     * \param base_xport the transport to demux
+     * \param classify_fn the function returning the stream number of a frame
+     * \param max_streams the maximum number of virtual streams
+     * \param hints optional parameters for the worker thread
+     */
+    static sptr make(
+        zero_copy_if::sptr base_xport,
+        stream_classifier_fn classify_fn,
+        size_t max_streams,
+        const device_addr_t &hints = device_addr_t()
+    );
 };
 
 }} //namespace uhd::transport
@@ -24,9 +24,24 @@
 #include <boost/thread/condition_variable.hpp>
 #include "rpc_common.hpp"
 #include <uhd/utils/log.hpp>
+#include <deque>
 
 namespace uhd { namespace usrprio_rpc {
 
+//One function call of a batch, see rpc_client::call_batch()
+struct func_call_t {
+    func_call_t(
+        func_id_t func_id_,
+        const func_args_writer_t& in_args_,
+        func_args_reader_t& out_args_
+    ) : func_id(func_id_), in_args(&in_args_), out_args(&out_args_) {}
+
+    func_id_t                   func_id;
+    const func_args_writer_t*   in_args;
+    func_args_reader_t*         out_args;
+};
+typedef std::vector<func_call_t> func_call_vtr;
+
 class rpc_client : private boost::noncopyable
 {
 public:
@@ -46,6 +61,13 @@ public:
         func_args_reader_t &out_args,
         boost::posix_time::milliseconds timeout);
 
+    //Pipelined calls: all the requests are sent in one write, then the
+    //responses are read in order, each with the timeout of one call.
+    //The batch stops at the first error.
+    const boost::system::error_code& call_batch(
+        func_call_vtr& calls,
+        boost::posix_time::milliseconds timeout);
+
     inline const boost::system::error_code& status() const {
         return _exec_err;
     }
@@ -62,6 +84,7 @@ private:
     void _handle_response_hdr(const boost::system::error_code& err, size_t transferred, size_t expected);
     void _handle_response_data(const boost::system::error_code& err, size_t transferred, size_t expected);
     void _wait_for_next_response_header();
+    void _complete_response();
 
     inline void _stop_io_service() {
         if (_io_service_thread.get()) {
@@ -83,6 +106,10 @@ private:
     //In-out function args
     func_xport_buf_t                    _request;
     func_xport_buf_t                    _response;
+    //Headers of the requests which were not answered yet, oldest first
+    std::deque<func_args_header_t>      _pending;
+    //Responses which were not picked up yet, oldest first
+    std::deque<func_xport_buf_t>        _responses;
     //Synchronization
     boost::mutex                        _mutex;
     boost::condition_variable           _exec_gate;
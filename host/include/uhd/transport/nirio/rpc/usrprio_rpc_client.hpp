@@ -48,6 +48,9 @@ public:
         NIUSRPRIO_CLOSE_SESSION_ARGS);
     nirio_status niusrprio_reset_device(
         NIUSRPRIO_RESET_SESSION_ARGS);
+    //Both calls in one batch, so that closing costs one round trip
+    nirio_status niusrprio_reset_and_close_session(
+        NIUSRPRIO_CLOSE_SESSION_ARGS);
     nirio_status niusrprio_download_bitstream_to_fpga(
         NIUSRPRIO_DOWNLOAD_BITSTREAM_TO_FPGA_ARGS);
     nirio_status niusrprio_get_interface_path(
@@ -0,0 +1,117 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_TRANSPORT_SHARED_FRAME_POOL_HPP
+#define INCLUDED_UHD_TRANSPORT_SHARED_FRAME_POOL_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/utility.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace uhd{ namespace transport{
+
+    /*!
+     * A pool of frames which several transports draw from.
+     *
+     * The frames are carved from one slab of memory at creation. A
+     * transport takes a frame only while it holds a buffer and gives it
+     * back on release, so the memory scales with the frames in flight
+     * rather than with the number of transports. Each transport is a
+     * client of the pool with a quota: the frames it can hold at once.
+     * Recently freed frames are handed out first, as they are likely
+     * to still be in the cache.
+     */
+    class UHD_API shared_frame_pool : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<shared_frame_pool> sptr;
+
+        //! A user of the pool, with its own quota
+        class UHD_API client : boost::noncopyable{
+        public:
+            typedef boost::shared_ptr<client> sptr;
+
+            virtual ~client(void) = 0;
+
+            /*!
+             * Take a frame from the pool.
+             * \param timeout the time to wait for a frame in seconds
+             * \return a frame, or NULL if the pool or the quota is exhausted
+             */
+            virtual void *alloc(const double timeout) = 0;
+
+            //! Give a frame taken by alloc() back to the pool
+            virtual void free(void *frame) = 0;
+
+            //! Get the number of frames this client holds
+            virtual size_t get_num_held(void) const = 0;
+
+            //! Get the number of frames this client may hold at once
+            virtual size_t get_quota(void) const = 0;
+        };
+
+        virtual ~shared_frame_pool(void) = 0;
+
+        /*!
+         * Make a new frame pool.
+         * \param num_frames the number of frames in the pool
+         * \param frame_size the size of each frame in bytes
+         * \param hints options for the memory, see buffer_pool::make()
+         * \return a new frame pool
+         */
+        static sptr make(
+            const size_t num_frames,
+            const size_t frame_size,
+            const device_addr_t &hints = device_addr_t()
+        );
+
+        /*!
+         * Get the process wide pool for a frame size.
+         * The first call for a frame size makes the pool, and the
+         * following ones return it for as long as it is in use.
+         * \param num_frames the number of frames of a new pool
+         * \param frame_size the size of each frame in bytes
+         * \param hints options for the memory of a new pool
+         * \return the shared frame pool
+         */
+        static sptr get_shared(
+            const size_t num_frames,
+            const size_t frame_size,
+            const device_addr_t &hints = device_addr_t()
+        );
+
+        /*!
+         * Make a client of this pool.
+         * The client keeps the pool alive.
+         * \param quota the number of frames the client may hold at once
+         * \return a new client
+         */
+        virtual client::sptr make_client(const size_t quota) = 0;
+
+        //! Get the size of each frame in bytes
+        virtual size_t get_frame_size(void) const = 0;
+
+        //! Get the number of frames in this pool
+        virtual size_t get_num_frames(void) const = 0;
+
+        //! Get the number of frames no client holds
+        virtual size_t get_num_free(void) const = 0;
+    };
+
+}} //namespace
+
+#endif /* INCLUDED_UHD_TRANSPORT_SHARED_FRAME_POOL_HPP */
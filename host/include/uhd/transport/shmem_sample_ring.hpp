@@ -0,0 +1,166 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_TRANSPORT_SHMEM_SAMPLE_RING_HPP
+#define INCLUDED_UHD_TRANSPORT_SHMEM_SAMPLE_RING_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/metadata.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * Publishes the samples of an RX streamer into a shared memory ring.
+ *
+ * An internal thread receives blocks of converted samples straight into
+ * the slots of a named shared memory ring, together with their metadata.
+ * Any number of processes can read the ring with a shmem_sample_subscriber.
+ * The publisher never waits on its subscribers: it overwrites the oldest
+ * block, and a subscriber that falls a whole ring behind sees an overflow.
+ * Each subscriber reads the blocks in place, so it costs no extra copy.
+ *
+ * \code{.cpp}
+ * uhd::transport::shmem_sample_publisher::sptr pub = uhd::transport::shmem_sample_publisher::make(
+ *     rx_stream, stream_args, uhd::device_addr_t("name=uhd_rx0,block_size=10000,num_blocks=128")
+ * );
+ * rx_stream->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+ * \endcode
+ */
+class UHD_API shmem_sample_publisher : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<shmem_sample_publisher> sptr;
+
+    /*!
+     * Make a new publisher, create its ring and start its thread.
+     * A stale ring of the same name is replaced.
+     *
+     * The publish args are:
+     * - name: the name of the shared memory object, required
+     * - block_size: samples per channel and block, defaults to the max samples per packet
+     * - num_blocks: the number of blocks in the ring, defaults to 64
+     * - priority: the thread priority, see uhd::set_thread_priority(), unchanged by default
+     * - cpus: space separated list of CPUs to pin the thread to
+     *
+     * \param rx_stream the streamer to receive from
+     * \param stream_args the args the streamer was made with, for the CPU format
+     * \param publish_args the publish args, see above
+     * \return a new publisher, destroying it stops the thread and removes the ring's name
+     * \throws uhd::value_error on invalid publish args
+     * \throws uhd::io_error when the ring cannot be created
+     */
+    static sptr make(
+        rx_streamer::sptr rx_stream,
+        const stream_args_t &stream_args,
+        const device_addr_t &publish_args
+    );
+
+    virtual ~shmem_sample_publisher(void) = 0;
+
+    //! Get the name of the shared memory object
+    virtual std::string get_name(void) const = 0;
+
+    //! Get the number of blocks published so far
+    virtual uint64_t get_num_blocks(void) const = 0;
+};
+
+/*!
+ * Reads the blocks of a shmem_sample_publisher from another process.
+ *
+ * Each subscriber has its own read cursor, which starts at the newest
+ * block. The buffers of a block point into the ring, so the publisher
+ * may overwrite them while they are read: check is_valid() after using
+ * the samples of a block to know whether they were intact.
+ */
+class UHD_API shmem_sample_subscriber : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<shmem_sample_subscriber> sptr;
+
+    //! A block of samples in the ring
+    struct block_t{
+        //! One buffer per channel, holding nsamps samples of the CPU format
+        std::vector<const void *> buffs;
+        //! The number of samples per channel in the buffers
+        size_t nsamps;
+        //! The metadata of the first sample
+        rx_metadata_t metadata;
+        //! The index of the block since the publisher started
+        uint64_t index;
+    };
+
+    /*!
+     * Open the ring of a running publisher.
+     * \param name the name the publisher was made with
+     * \return a new subscriber
+     * \throws uhd::io_error when there is no such ring
+     * \throws uhd::value_error when the ring has an unknown layout
+     */
+    static sptr make(const std::string &name);
+
+    virtual ~shmem_sample_subscriber(void) = 0;
+
+    //! Get the number of channels in a block
+    virtual size_t get_num_channels(void) const = 0;
+
+    //! Get the CPU format of the samples, like fc32
+    virtual std::string get_cpu_format(void) const = 0;
+
+    //! Get the number of samples per channel in a full block
+    virtual size_t get_block_size(void) const = 0;
+
+    //! Get the number of blocks in the ring
+    virtual size_t get_num_blocks(void) const = 0;
+
+    /*!
+     * Get the next block, waiting for the publisher if there is none yet.
+     *
+     * When the cursor has fallen behind the ring, it moves to the newest
+     * block, and the call returns a block with no samples and the error
+     * code ERROR_CODE_OVERFLOW.
+     *
+     * \param block the block to fill in, its buffers point into the ring
+     * \param timeout the timeout in seconds to wait for a block
+     * \return false on timeout
+     */
+    virtual bool get_block(block_t &block, const double timeout = 0.1) = 0;
+
+    /*!
+     * Check that a block has not been overwritten since get_block().
+     * \param block a block filled in by get_block()
+     * \return true when the samples read from the block were intact
+     */
+    virtual bool is_valid(const block_t &block) const = 0;
+
+    //! Is the publisher gone? The blocks already in the ring stay readable.
+    virtual bool is_closed(void) const = 0;
+
+    //! Get the number of overflows returned by get_block()
+    virtual uint64_t get_num_overflows(void) const = 0;
+
+    //! Get the number of blocks skipped by those overflows
+    virtual uint64_t get_num_dropped_blocks(void) const = 0;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_UHD_TRANSPORT_SHMEM_SAMPLE_RING_HPP */
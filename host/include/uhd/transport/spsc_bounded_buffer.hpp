@@ -0,0 +1,218 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_TRANSPORT_SPSC_BOUNDED_BUFFER_HPP
+#define INCLUDED_UHD_TRANSPORT_SPSC_BOUNDED_BUFFER_HPP
+
+#include <uhd/config.hpp>
+#include <boost/atomic.hpp>
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <vector>
+
+namespace uhd{ namespace transport{
+
+    /*!
+     * A bounded buffer for exactly one producer and one consumer thread.
+     *
+     * Same interface as bounded_buffer (except push_with_pop_on_full(),
+     * which would make the producer pop), but push and pop are lock-free.
+     * The mutex and condition variables are only used when a thread has to
+     * wait: the waiting thread first spins on the buffer for spin_count
+     * checks, then it blocks until the other side notifies it.
+     *
+     * Several threads may push or pop as long as they are serialized
+     * among themselves, e.g. by holding a common lock.
+     */
+    template <typename elem_type> class spsc_bounded_buffer : boost::noncopyable{
+    public:
+
+        /*!
+         * Create a new single producer/single consumer bounded buffer.
+         * \param capacity the bounded buffer capacity
+         * \param spin_count the number of checks before a wait blocks
+         */
+        spsc_bounded_buffer(size_t capacity, size_t spin_count = 1000):
+            _buffer(capacity+1), _spin_count(spin_count),
+            _head(0), _tail(0), _push_waiting(false), _pop_waiting(false)
+        {
+            /* NOP */
+        }
+
+        /*!
+         * Push a new element into the bounded buffer immediately.
+         * The element will not be pushed when the buffer is full.
+         * \param elem the element reference pop to
+         * \return false when the buffer is full
+         */
+        UHD_INLINE bool push_with_haste(const elem_type &elem){
+            const size_t head = _head.load(boost::memory_order_relaxed);
+            const size_t next = this->next(head);
+            if (next == _tail.load(boost::memory_order_acquire)) return false;
+            _buffer[head] = elem;
+            _head.store(next, boost::memory_order_release);
+            this->notify(_pop_waiting, _pop_mutex, _pop_cond);
+            return true;
+        }
+
+        /*!
+         * Push a new element into the bounded_buffer.
+         * Wait until the bounded_buffer becomes non-full.
+         * \param elem the new element to push
+         */
+        UHD_INLINE void push_with_wait(const elem_type &elem){
+            if (this->push_with_haste(elem)) return;
+            this->wait(&spsc_bounded_buffer::not_full, _push_waiting, _push_mutex, _push_cond, -1.0);
+            this->push_with_haste(elem);
+        }
+
+        /*!
+         * Push a new element into the bounded_buffer.
+         * Wait until the bounded_buffer becomes non-full or timeout.
+         * \param elem the new element to push
+         * \param timeout the timeout in seconds
+         * \return false when the operation times out
+         */
+        UHD_INLINE bool push_with_timed_wait(const elem_type &elem, double timeout){
+            if (this->push_with_haste(elem)) return true;
+            if (not this->wait(&spsc_bounded_buffer::not_full, _push_waiting, _push_mutex, _push_cond, timeout)) return false;
+            return this->push_with_haste(elem);
+        }
+
+        /*!
+         * Pop an element from the bounded buffer immediately.
+         * The element will not be popped when the buffer is empty.
+         * \param elem the element reference pop to
+         * \return false when the buffer is empty
+         */
+        UHD_INLINE bool pop_with_haste(elem_type &elem){
+            const size_t tail = _tail.load(boost::memory_order_relaxed);
+            if (tail == _head.load(boost::memory_order_acquire)) return false;
+            elem = _buffer[tail];
+            _buffer[tail] = elem_type(); //release references held by the element
+            _tail.store(this->next(tail), boost::memory_order_release);
+            this->notify(_push_waiting, _push_mutex, _push_cond);
+            return true;
+        }
+
+        /*!
+         * Pop an element from the bounded_buffer.
+         * Wait until the bounded_buffer becomes non-empty.
+         * \param elem the element reference pop to
+         */
+        UHD_INLINE void pop_with_wait(elem_type &elem){
+            if (this->pop_with_haste(elem)) return;
+            this->wait(&spsc_bounded_buffer::not_empty, _pop_waiting, _pop_mutex, _pop_cond, -1.0);
+            this->pop_with_haste(elem);
+        }
+
+        /*!
+         * Pop an element from the bounded_buffer.
+         * Wait until the bounded_buffer becomes non-empty or timeout.
+         * \param elem the element reference pop to
+         * \param timeout the timeout in seconds
+         * \return false when the operation times out
+         */
+        UHD_INLINE bool pop_with_timed_wait(elem_type &elem, double timeout){
+            if (this->pop_with_haste(elem)) return true;
+            if (not this->wait(&spsc_bounded_buffer::not_empty, _pop_waiting, _pop_mutex, _pop_cond, timeout)) return false;
+            return this->pop_with_haste(elem);
+        }
+
+    private:
+        typedef bool (spsc_bounded_buffer::*cond_type)(void) const;
+
+        //one slot always stays empty to tell a full from an empty buffer
+        std::vector<elem_type> _buffer;
+        const size_t _spin_count;
+
+        //written by the producer, keep it away from the consumer's cache line
+        boost::atomic<size_t> _head;
+        char _pad0[64];
+        //written by the consumer
+        boost::atomic<size_t> _tail;
+        char _pad1[64];
+
+        //slow path for waiting threads
+        boost::atomic<bool> _push_waiting, _pop_waiting;
+        boost::mutex _push_mutex, _pop_mutex;
+        boost::condition_variable _push_cond, _pop_cond;
+
+        UHD_INLINE size_t next(const size_t index) const{
+            return (index+1 == _buffer.size())? 0 : index+1;
+        }
+
+        //only valid on the producer side
+        bool not_full(void) const{
+            return this->next(_head.load(boost::memory_order_relaxed)) != _tail.load(boost::memory_order_acquire);
+        }
+
+        //only valid on the consumer side
+        bool not_empty(void) const{
+            return _tail.load(boost::memory_order_relaxed) != _head.load(boost::memory_order_acquire);
+        }
+
+        /*!
+         * Wake up the other side if it is blocked.
+         * The fence orders the index update before reading the flag,
+         * it pairs with the fence in wait(), so either the waiter sees
+         * the update or this sees the waiter's flag.
+         */
+        UHD_INLINE void notify(
+            boost::atomic<bool> &waiting, boost::mutex &mutex, boost::condition_variable &cond
+        ){
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            if (not waiting.load(boost::memory_order_relaxed)) return;
+            boost::mutex::scoped_lock lock(mutex);
+            cond.notify_one();
+        }
+
+        /*!
+         * Spin, then block until the condition holds.
+         * The caller does the push or pop after returning, so the
+         * locks of the two sides are never held at the same time.
+         * \param timeout the timeout in seconds, negative waits forever
+         * \return true when the condition holds, false on timeout
+         */
+        bool wait(
+            const cond_type ready, boost::atomic<bool> &waiting,
+            boost::mutex &mutex, boost::condition_variable &cond,
+            const double timeout
+        ){
+            for (size_t i = 0; i < _spin_count; i++){
+                if ((this->*ready)()) return true;
+            }
+
+            const boost::system_time exit_time = boost::get_system_time() +
+                boost::posix_time::microseconds(long(timeout*1e6));
+            boost::mutex::scoped_lock lock(mutex);
+            waiting.store(true, boost::memory_order_relaxed);
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            while (not (this->*ready)()){
+                if (timeout < 0) cond.wait(lock);
+                else if (not cond.timed_wait(lock, exit_time)) break;
+            }
+            waiting.store(false, boost::memory_order_relaxed);
+            return (this->*ready)();
+        }
+    };
+
+}} //namespace
+
+#endif /* INCLUDED_UHD_TRANSPORT_SPSC_BOUNDED_BUFFER_HPP */
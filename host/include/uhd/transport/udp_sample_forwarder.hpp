@@ -0,0 +1,122 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_TRANSPORT_UDP_SAMPLE_FORWARDER_HPP
+#define INCLUDED_UHD_TRANSPORT_UDP_SAMPLE_FORWARDER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <stdint.h>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * Forwards the samples of an RX streamer to UDP destinations.
+ *
+ * The samples are received by an uhd::rx_push_streamer and handed to a
+ * send thread, so the receive thread never waits on the network. When
+ * the send thread falls behind by more than queue_depth blocks, the
+ * new blocks are dropped and counted. The send thread splits each block
+ * into datagrams per channel and sends them in batches with sendmmsg(),
+ * and with UDP segmentation offload (UDP_SEGMENT) when it is enabled
+ * and available. Other platforms send one datagram per call.
+ *
+ * Each datagram starts with a header_t unless the header is disabled.
+ *
+ * \code{.cpp}
+ * uhd::transport::udp_sample_forwarder::sptr fwd = uhd::transport::udp_sample_forwarder::make(
+ *     rx_stream, stream_args, uhd::device_addr_t("dests=10.0.0.2:5000 10.0.0.3:5000,fanout=round_robin")
+ * );
+ * rx_stream->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+ * \endcode
+ */
+class UHD_API udp_sample_forwarder : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<udp_sample_forwarder> sptr;
+
+    /*!
+     * The header of a datagram, all fields in network byte order.
+     * A block without samples, like an overflow, is sent as a header
+     * with nsamps 0 to every destination.
+     */
+    struct header_t{
+        uint32_t sequence;      //!< counts the datagrams of each destination
+        uint16_t channel;       //!< the channel of the samples
+        uint16_t flags;         //!< the FLAG_* bits and the error code in bits 8 to 15
+        uint32_t nsamps;        //!< the samples following the header
+        uint32_t sample_offset; //!< the index of the first sample in the received block
+        int64_t time_ns;        //!< the time of the first sample of the received block
+    };
+
+    static const uint16_t FLAG_HAS_TIME_SPEC    = 1 << 0;
+    static const uint16_t FLAG_START_OF_BURST   = 1 << 1;
+    static const uint16_t FLAG_END_OF_BURST     = 1 << 2;
+    static const uint16_t FLAG_MORE_FRAGMENTS   = 1 << 3;
+
+    /*!
+     * Make a new forwarder and start its threads.
+     *
+     * The forward args are:
+     * - dests: space separated list of host:port destinations, required
+     * - fanout: how the samples are spread over the destinations:
+     *   copy sends everything to each destination (default),
+     *   round_robin sends each block to the next destination,
+     *   channel sends channel n to destination n modulo the destinations
+     * - header: 0 to send the raw samples without a header_t (default 1)
+     * - payload_size: the most sample bytes per datagram, defaults to fill
+     *   a 1500 byte MTU with the header
+     * - batch: the most datagrams per sendmmsg() call, defaults to 32
+     * - gso: 1 to let the kernel segment the datagrams of a destination
+     *   (Linux 4.18 and newer, default 0)
+     * - queue_depth: the blocks between the threads, defaults to 16
+     * - send_cpus: space separated list of CPUs to pin the send thread to
+     * - send_buff_size: the socket send buffer size in bytes
+     * - every push arg of uhd::rx_push_streamer, like block_size and cpus
+     *
+     * \param rx_stream the streamer to receive from
+     * \param stream_args the args the streamer was made with, for the CPU format
+     * \param forward_args the forward args, see above
+     * \return a new forwarder, destroying it stops the threads
+     * \throws uhd::value_error on invalid forward args
+     */
+    static sptr make(
+        rx_streamer::sptr rx_stream,
+        const stream_args_t &stream_args,
+        const device_addr_t &forward_args
+    );
+
+    virtual ~udp_sample_forwarder(void) = 0;
+
+    //! Get the number of datagrams sent
+    virtual uint64_t get_num_datagrams(void) const = 0;
+
+    //! Get the number of sample bytes sent, counted once per destination
+    virtual uint64_t get_num_bytes(void) const = 0;
+
+    //! Get the number of blocks dropped because the send thread fell behind
+    virtual uint64_t get_num_dropped_blocks(void) const = 0;
+
+    //! Get the number of datagrams the socket failed to send
+    virtual uint64_t get_num_send_errors(void) const = 0;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_UHD_TRANSPORT_UDP_SAMPLE_FORWARDER_HPP */
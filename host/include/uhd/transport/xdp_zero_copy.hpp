@@ -0,0 +1,79 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_TRANSPORT_XDP_ZERO_COPY_HPP
+#define INCLUDED_UHD_TRANSPORT_XDP_ZERO_COPY_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/transport/zero_copy.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * A zero copy UDP transport that bypasses the kernel network stack
+ * with an AF_XDP socket (Linux only, requires libxdp).
+ *
+ * The socket is bound to one receive queue of a network interface.
+ * Received frames are handed out straight from the shared UMEM area,
+ * and send buffers are UMEM frames that are queued to the NIC on commit.
+ * The transport builds the Ethernet, IPv4 and UDP headers itself.
+ *
+ * Every packet arriving on the bound queue goes to the socket, and the
+ * transport drops the ones that do not belong to its UDP flow.
+ * Steer the transport's flow to a dedicated queue (see the xdp_port and
+ * xdp_queue hints and the transport application notes).
+ */
+class UHD_API xdp_zero_copy : public virtual zero_copy_if{
+public:
+    typedef boost::shared_ptr<xdp_zero_copy> sptr;
+
+    /*!
+     * Make a new AF_XDP zero copy transport:
+     * This transport is for sending and receiving
+     * between this host and a single endpoint.
+     *
+     * The following hints are used:
+     * - xdp_iface: the network interface to bind to (required)
+     * - xdp_queue: the first receive queue to use (default 0).
+     *   Each transport on the interface takes the next free queue.
+     * - xdp_port: the local UDP port for the first queue (default 50000).
+     *   The transport on queue xdp_queue+n uses port xdp_port+n.
+     * - xdp_dst_mac: the MAC address of the endpoint, when it cannot
+     *   be found in the kernel's ARP cache
+     * - xdp_copy: set to use the copy mode even if the driver
+     *   supports zero copy
+     * - recv_frame_size, num_recv_frames, send_frame_size, num_send_frames
+     *
+     * \param addr a string representing the destination address
+     * \param port a string representing the destination port
+     * \param default_buff_args default values for frame sizes and num frames
+     * \param hints parameters to pass to the underlying transport
+     * \throw uhd::not_implemented_error when built without AF_XDP support
+     */
+    static sptr make(
+        const std::string &addr,
+        const std::string &port,
+        const zero_copy_xport_params &default_buff_args,
+        const device_addr_t &hints
+    );
+};
+
+}} //namespace
+
+#endif /* INCLUDED_UHD_TRANSPORT_XDP_ZERO_COPY_HPP */
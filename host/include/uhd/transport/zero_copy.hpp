@@ -19,10 +19,14 @@
 #define INCLUDED_UHD_TRANSPORT_ZERO_COPY_HPP
 
 #include <uhd/config.hpp>
+#include <uhd/types/dict.hpp>
+#include <uhd/types/time_spec.hpp>
 #include <boost/utility.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/detail/atomic_count.hpp>
+#include <stdint.h>
+#include <string>
 
 namespace uhd{ namespace transport{
 
@@ -122,6 +126,24 @@ namespace uhd{ namespace transport{
     class UHD_API managed_recv_buffer : public managed_buffer{
     public:
         typedef boost::intrusive_ptr<managed_recv_buffer> sptr;
+
+        managed_recv_buffer(void):_has_recv_time(false){}
+
+        /*!
+         * Get the time the host received the buffer.
+         * Only transports with receive timestamping enabled set it,
+         * e.g. the UDP transport with the udp_timestamp hint.
+         * \param time the receive time to fill
+         * \return true when the buffer has a receive time
+         */
+        UHD_INLINE bool get_recv_time(time_spec_t &time) const{
+            if (_has_recv_time) time = _recv_time;
+            return _has_recv_time;
+        }
+
+    protected:
+        bool _has_recv_time;
+        time_spec_t _recv_time;
     };
 
     /*!
@@ -144,6 +166,55 @@ namespace uhd{ namespace transport{
         size_t num_send_frames;
     };
 
+    /*!
+     * Counters of a transport object since its creation.
+     * Each transport counts what it can observe, the rest stays 0.
+     */
+    struct zero_copy_stats_t {
+        zero_copy_stats_t(void):
+            recv_packets(0), recv_bytes(0), recv_timeouts(0), recv_queue_hwm(0),
+            recv_stalls(0), recv_elastic_hwm(0),
+            send_packets(0), send_bytes(0), send_timeouts(0), send_fc_stalls(0)
+        {}
+
+        //! Buffers handed out by get_recv_buff() and get_recv_buffs()
+        uint64_t recv_packets;
+        //! Bytes in the received buffers
+        uint64_t recv_bytes;
+        //! Receive calls which timed out
+        uint64_t recv_timeouts;
+        //! The most received frames seen waiting in the transport at once
+        uint64_t recv_queue_hwm;
+        //! Times a receive offload thread found its queue full, see zero_copy_recv_offload
+        uint64_t recv_stalls;
+        //! The most frames waiting in the elastic ring of a receive offload at once
+        uint64_t recv_elastic_hwm;
+        //! Buffers committed for sending
+        uint64_t send_packets;
+        //! Bytes in the committed send buffers
+        uint64_t send_bytes;
+        //! Send calls which timed out waiting for a free buffer
+        uint64_t send_timeouts;
+        //! Sends which had to wait for flow control credit
+        uint64_t send_fc_stalls;
+
+        //! The counters by name, e.g. for publishing in the property tree
+        uhd::dict<std::string, uint64_t> to_dict(void) const{
+            uhd::dict<std::string, uint64_t> stats;
+            stats["recv_packets"] = recv_packets;
+            stats["recv_bytes"] = recv_bytes;
+            stats["recv_timeouts"] = recv_timeouts;
+            stats["recv_queue_hwm"] = recv_queue_hwm;
+            stats["recv_stalls"] = recv_stalls;
+            stats["recv_elastic_hwm"] = recv_elastic_hwm;
+            stats["send_packets"] = send_packets;
+            stats["send_bytes"] = send_bytes;
+            stats["send_timeouts"] = send_timeouts;
+            stats["send_fc_stalls"] = send_fc_stalls;
+            return stats;
+        }
+    };
+
     /*!
      * A zero-copy interface for transport objects.
      * Provides a way to get send and receive buffers
@@ -165,6 +236,31 @@ namespace uhd{ namespace transport{
          */
         virtual managed_recv_buffer::sptr get_recv_buff(double timeout = 0.1) = 0;
 
+        /*!
+         * Get up to num_buffs new receive buffers from this transport object.
+         * Only the first buffer waits for the timeout, the call returns
+         * as soon as no more buffers are immediately available.
+         * Transports override this when they can fill several
+         * buffers at once, e.g. with a single system call.
+         * \param buffs an array of at least num_buffs buffers to fill
+         * \param num_buffs the maximum number of buffers to get
+         * \param timeout the timeout to get the first buffer in seconds
+         * \return the number of buffers filled, 0 on timeout/error
+         */
+        virtual size_t get_recv_buffs(
+            managed_recv_buffer::sptr *buffs,
+            const size_t num_buffs,
+            const double timeout = 0.1
+        ){
+            size_t num_got = 0;
+            while (num_got < num_buffs){
+                buffs[num_got] = get_recv_buff((num_got == 0)? timeout : 0.0);
+                if (not buffs[num_got]) break;
+                num_got++;
+            }
+            return num_got;
+        }
+
         /*!
          * Get the number of receive frames:
          * The number of simultaneous receive buffers in use.
@@ -179,6 +275,16 @@ namespace uhd{ namespace transport{
          */
         virtual size_t get_recv_frame_size(void) const = 0;
 
+        /*!
+         * Get a file descriptor to wait on for receive buffers.
+         * It becomes readable when get_recv_buff() would not block,
+         * e.g. to wait on several transports with one poll() call.
+         * \return the descriptor, or -1 when the transport has none
+         */
+        virtual int get_recv_fd(void) const{
+            return -1;
+        }
+
         /*!
          * Get a new send buffer from this transport object.
          * \param timeout the timeout to get the buffer in seconds
@@ -186,6 +292,28 @@ namespace uhd{ namespace transport{
          */
         virtual managed_send_buffer::sptr get_send_buff(double timeout = 0.1) = 0;
 
+        /*!
+         * Get up to num_buffs new send buffers from this transport object.
+         * Only the first buffer waits for the timeout, see get_recv_buffs().
+         * \param buffs an array of at least num_buffs buffers to fill
+         * \param num_buffs the maximum number of buffers to get
+         * \param timeout the timeout to get the first buffer in seconds
+         * \return the number of buffers filled, 0 on timeout/error
+         */
+        virtual size_t get_send_buffs(
+            managed_send_buffer::sptr *buffs,
+            const size_t num_buffs,
+            const double timeout = 0.1
+        ){
+            size_t num_got = 0;
+            while (num_got < num_buffs){
+                buffs[num_got] = get_send_buff((num_got == 0)? timeout : 0.0);
+                if (not buffs[num_got]) break;
+                num_got++;
+            }
+            return num_got;
+        }
+
         /*!
          * Get the number of send frames:
          * The number of simultaneous send buffers in use.
@@ -200,6 +328,16 @@ namespace uhd{ namespace transport{
          */
         virtual size_t get_send_frame_size(void) const = 0;
 
+        /*!
+         * Get the counters of this transport object.
+         * The counters are read without locking, so they
+         * are not necessarily consistent with each other.
+         * \return the counters, all 0 if the transport does not count
+         */
+        virtual zero_copy_stats_t get_stats(void) const{
+            return zero_copy_stats_t();
+        }
+
     };
 
 }} //namespace
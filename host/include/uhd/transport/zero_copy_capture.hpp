@@ -0,0 +1,92 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_TRANSPORT_ZERO_COPY_CAPTURE_HPP
+#define INCLUDED_UHD_TRANSPORT_ZERO_COPY_CAPTURE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/transport/zero_copy.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * A transport that records every received frame of another transport
+ * into a memory-mapped capture file, along with its receive time.
+ * Sends are passed through. The file can be fed back into the receive
+ * path without hardware using zero_copy_replay.
+ */
+class UHD_API zero_copy_capture : public virtual zero_copy_if {
+public:
+    typedef boost::shared_ptr<zero_copy_capture> sptr;
+
+    /*!
+     * Make a new capture transport.
+     * The file is created with the maximum size up front and truncated to
+     * the recorded frames when the transport is destroyed. Frames beyond the
+     * maximum size are not recorded.
+     *
+     * The hints are optional:
+     * - capture_size: the maximum size of the capture file in bytes
+     *
+     * \param transport the transport to record
+     * \param path the capture file, an existing file is overwritten
+     * \param hints optional parameters for the capture
+     * \throws uhd::os_error if the file cannot be created
+     */
+    static sptr make(zero_copy_if::sptr transport,
+                     const std::string &path,
+                     const device_addr_t &hints = device_addr_t());
+
+    //! Get the number of frames recorded so far
+    virtual size_t get_num_captured_frames(void) const = 0;
+};
+
+/*!
+ * A transport that receives the frames of a capture file written by
+ * zero_copy_capture. The frames are handed out in place from the mapped
+ * file, sent frames are dropped.
+ */
+class UHD_API zero_copy_replay : public virtual zero_copy_if {
+public:
+    typedef boost::shared_ptr<zero_copy_replay> sptr;
+
+    /*!
+     * Make a new replay transport.
+     *
+     * The hints are optional:
+     * - replay_rate: scale of the recorded rate, 2.0 replays twice as fast
+     *   and 0 replays as fast as possible (defaults to 1.0)
+     * - replay_loops: the number of passes over the file, after which
+     *   receives time out, 0 loops forever (defaults to 1)
+     * - num_recv_frames: the number of frames which may be held at once
+     * - num_send_frames: the number of send frames
+     *
+     * \param path the capture file
+     * \param hints optional parameters for the replay
+     * \throws uhd::os_error if the file cannot be opened
+     * \throws uhd::value_error if the file is not a capture file
+     */
+    static sptr make(const std::string &path,
+                     const device_addr_t &hints = device_addr_t());
+};
+
+}} //namespace
+
+#endif /* INCLUDED_UHD_TRANSPORT_ZERO_COPY_CAPTURE_HPP */
@@ -20,6 +20,7 @@
 
 #include <uhd/config.hpp>
 #include <uhd/transport/zero_copy.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <boost/shared_ptr.hpp>
 
 namespace uhd{ namespace transport{
@@ -38,11 +39,28 @@ public:
      * used in cases where the main thread needs to be relieved of the burden
      * of the underlying transport receive calls.
      *
+     * The hints are optional:
+     * - recv_offload_batch: the number of frames the thread takes
+     *   from the transport per call (defaults to 1)
+     * - recv_offload_cpus: a space separated list of CPUs to pin the thread to
+     * - recv_elastic_bytes: the size of an elastic ring between the thread
+     *   and get_recv_buff(). The thread copies each frame into the ring and
+     *   releases the transport's frame right away, so an application which
+     *   stalls for a while does not overflow the device as long as it keeps
+     *   up on average. The ring uses the buff_ memory hints of buffer_pool,
+     *   with 2M huge pages by default. Off by default.
+     *
+     * The thread counts the times it found its queue full in
+     * zero_copy_stats_t::recv_stalls, and the fill level of the ring
+     * in zero_copy_stats_t::recv_elastic_hwm.
+     *
      * \param transport a shared pointer to the transport interface
      * \param timeout a general timeout for pushing and pulling on the bounded buffer
+     * \param hints optional parameters for the receive thread
      */
     static sptr make(zero_copy_if::sptr transport,
-                     const double timeout);
+                     const double timeout,
+                     const device_addr_t &hints = device_addr_t());
 };
 
 }} //namespace
@@ -19,13 +19,70 @@
 #define INCLUDED_UHD_TYPES_DICT_HPP
 
 #include <uhd/config.hpp>
+#include <boost/unordered_map.hpp>
 #include <vector>
 #include <list>
+#include <string>
 
 namespace uhd{
 
+    namespace dict_detail{
+
+        /*!
+         * Can a dict lookup use a hash index for this key type?
+         * Other key types only need operator== and are found by a scan.
+         */
+        template <typename Key> struct is_hashable{
+            static const bool value = false;
+        };
+        template <> struct is_hashable<std::string>{ static const bool value = true; };
+        template <> struct is_hashable<char>{ static const bool value = true; };
+        template <> struct is_hashable<signed char>{ static const bool value = true; };
+        template <> struct is_hashable<unsigned char>{ static const bool value = true; };
+        template <> struct is_hashable<short>{ static const bool value = true; };
+        template <> struct is_hashable<unsigned short>{ static const bool value = true; };
+        template <> struct is_hashable<int>{ static const bool value = true; };
+        template <> struct is_hashable<unsigned int>{ static const bool value = true; };
+        template <> struct is_hashable<long>{ static const bool value = true; };
+        template <> struct is_hashable<unsigned long>{ static const bool value = true; };
+
+        //! The index of a dict without a hashable key: always a miss
+        template <typename Key, typename Iter, bool = is_hashable<Key>::value>
+        struct index_t{
+            static const bool enabled = false;
+            void insert(const Key &, const Iter &){}
+            void erase(const Key &){}
+            void clear(void){}
+            std::size_t size(void) const{ return 0; }
+            bool find(const Key &, Iter &) const{ return false; }
+        };
+
+        //! The index of a dict with a hashable key: key to list position
+        template <typename Key, typename Iter>
+        struct index_t<Key, Iter, true>{
+            static const bool enabled = true;
+            void insert(const Key &key, const Iter &it){ _map.insert(std::make_pair(key, it)); }
+            void erase(const Key &key){ _map.erase(key); }
+            void clear(void){ _map.clear(); }
+            std::size_t size(void) const{ return _map.size(); }
+            bool find(const Key &key, Iter &it) const{
+                typename boost::unordered_map<Key, Iter>::const_iterator found = _map.find(key);
+                if (found == _map.end()) return false;
+                it = found->second;
+                return true;
+            }
+        private:
+            boost::unordered_map<Key, Iter> _map;
+        };
+
+    } //namespace dict_detail
+
     /*!
      * A templated dictionary class with a python-like interface.
+     *
+     * The items are kept in insertion order. Dicts with string or
+     * integer keys also keep a hash index, so their lookups do not
+     * scan the items; other key types only need operator==.
      */
     template <typename Key, typename Val> class dict{
     public:
@@ -43,6 +100,19 @@ namespace uhd{
         template <typename InputIterator>
         dict(InputIterator first, InputIterator last);
 
+        /*!
+         * Copy constructor: the copy gets its own index.
+         * \param other the dict to copy
+         */
+        dict(const dict<Key, Val> &other);
+
+        /*!
+         * Assignment: this dict gets its own index.
+         * \param other the dict to copy
+         * \return a reference to this dict
+         */
+        dict<Key, Val> &operator=(const dict<Key, Val> &other);
+
         /*!
          * Get the number of elements in this dict.
          * \return the number of elements
@@ -136,7 +206,15 @@ namespace uhd{
 
     private:
         typedef std::pair<Key, Val> pair_t;
+        typedef typename std::list<pair_t>::iterator iterator_t;
+        typedef typename std::list<pair_t>::const_iterator const_iterator_t;
+
+        iterator_t find(const Key &key);
+        const_iterator_t find(const Key &key) const;
+        void rebuild_index(void);
+
         std::list<pair_t> _map; //private container
+        dict_detail::index_t<Key, iterator_t> _index; //lookup by key
     };
 
 } //namespace uhd
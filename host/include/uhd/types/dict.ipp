@@ -50,7 +50,57 @@ namespace uhd{
     dict<Key, Val>::dict(InputIterator first, InputIterator last):
         _map(first, last)
     {
-        /* NOP */
+        this->rebuild_index();
+    }
+
+    template <typename Key, typename Val>
+    dict<Key, Val>::dict(const dict<Key, Val> &other):
+        _map(other._map)
+    {
+        this->rebuild_index();
+    }
+
+    template <typename Key, typename Val>
+    dict<Key, Val> &dict<Key, Val>::operator=(const dict<Key, Val> &other){
+        if (this != &other){
+            _map = other._map;
+            this->rebuild_index();
+        }
+        return *this;
+    }
+
+    template <typename Key, typename Val>
+    void dict<Key, Val>::rebuild_index(void){
+        if (not _index.enabled) return;
+        _index.clear();
+        //with repeated keys, the first item wins, as with a scan
+        for (iterator_t it = _map.begin(); it != _map.end(); it++){
+            _index.insert(it->first, it);
+        }
+    }
+
+    template <typename Key, typename Val>
+    typename dict<Key, Val>::iterator_t dict<Key, Val>::find(const Key &key){
+        iterator_t it;
+        if (_index.enabled) return _index.find(key, it)? it : _map.end();
+        for (it = _map.begin(); it != _map.end(); it++){
+            if (it->first == key) break;
+        }
+        return it;
+    }
+
+    template <typename Key, typename Val>
+    typename dict<Key, Val>::const_iterator_t dict<Key, Val>::find(const Key &key) const{
+        if (_index.enabled){
+            iterator_t it;
+            if (_index.find(key, it)) return it;
+            return _map.end();
+        }
+        const_iterator_t it;
+        for (it = _map.begin(); it != _map.end(); it++){
+            if (it->first == key) break;
+        }
+        return it;
     }
 
     template <typename Key, typename Val>
@@ -61,6 +111,7 @@ namespace uhd{
     template <typename Key, typename Val>
     std::vector<Key> dict<Key, Val>::keys(void) const{
         std::vector<Key> keys;
+        keys.reserve(_map.size());
         BOOST_FOREACH(const pair_t &p, _map){
             keys.push_back(p.first);
         }
@@ -70,6 +121,7 @@ namespace uhd{
     template <typename Key, typename Val>
     std::vector<Val> dict<Key, Val>::vals(void) const{
         std::vector<Val> vals;
+        vals.reserve(_map.size());
         BOOST_FOREACH(const pair_t &p, _map){
             vals.push_back(p.second);
         }
@@ -78,26 +130,20 @@ namespace uhd{
 
     template <typename Key, typename Val>
     bool dict<Key, Val>::has_key(const Key &key) const{
-        BOOST_FOREACH(const pair_t &p, _map){
-            if (p.first == key) return true;
-        }
-        return false;
+        return this->find(key) != _map.end();
     }
 
     template <typename Key, typename Val>
     const Val &dict<Key, Val>::get(const Key &key, const Val &other) const{
-        BOOST_FOREACH(const pair_t &p, _map){
-            if (p.first == key) return p.second;
-        }
-        return other;
+        const const_iterator_t it = this->find(key);
+        return (it == _map.end())? other : it->second;
     }
 
     template <typename Key, typename Val>
     const Val &dict<Key, Val>::get(const Key &key) const{
-        BOOST_FOREACH(const pair_t &p, _map){
-            if (p.first == key) return p.second;
-        }
-        throw key_not_found<Key, Val>(key);
+        const const_iterator_t it = this->find(key);
+        if (it == _map.end()) throw key_not_found<Key, Val>(key);
+        return it->second;
     }
 
     template <typename Key, typename Val>
@@ -107,32 +153,29 @@ namespace uhd{
 
     template <typename Key, typename Val>
     const Val &dict<Key, Val>::operator[](const Key &key) const{
-        BOOST_FOREACH(const pair_t &p, _map){
-            if (p.first == key) return p.second;
-        }
-        throw key_not_found<Key, Val>(key);
+        return this->get(key);
     }
 
     template <typename Key, typename Val>
     Val &dict<Key, Val>::operator[](const Key &key){
-        BOOST_FOREACH(pair_t &p, _map){
-            if (p.first == key) return p.second;
-        }
+        const iterator_t it = this->find(key);
+        if (it != _map.end()) return it->second;
         _map.push_back(std::make_pair(key, Val()));
+        _index.insert(key, --_map.end());
         return _map.back().second;
     }
 
     template <typename Key, typename Val>
     Val dict<Key, Val>::pop(const Key &key){
-        typename std::list<pair_t>::iterator it;
-        for (it = _map.begin(); it != _map.end(); it++){
-            if (it->first == key){
-                Val val = it->second;
-                _map.erase(it);
-                return val;
-            }
-        }
-        throw key_not_found<Key, Val>(key);
+        const iterator_t it = this->find(key);
+        if (it == _map.end()) throw key_not_found<Key, Val>(key);
+        Val val = it->second;
+        const bool repeated = _index.enabled and _index.size() != _map.size();
+        _index.erase(key);
+        _map.erase(it);
+        //a repeated key from the iterator constructor is found again
+        if (repeated) this->rebuild_index();
+        return val;
     }
 
     template <typename Key, typename Val>
@@ -0,0 +1,95 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_TYPES_HISTOGRAM_HPP
+#define INCLUDED_UHD_TYPES_HISTOGRAM_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/dict.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace uhd{
+
+    /*!
+     * A snapshot of a histogram of unsigned values.
+     *
+     * Like in HDR histograms, the buckets are logarithmic: values
+     * below 16 have a bucket each, and above that, each power of two is
+     * split into 16 linear buckets, so a value is known to about 6%.
+     * Values of 2^48 and above are counted in the last bucket.
+     */
+    struct UHD_API histogram_t{
+        //! The number of sub-buckets per power of two
+        static const size_t SUB_BUCKETS = 16;
+
+        //! The total number of buckets
+        static const size_t NUM_BUCKETS = SUB_BUCKETS*45;
+
+        //! Create an empty histogram
+        histogram_t(void);
+
+        //! The unit of the values, like "ns" or "packets"
+        std::string unit;
+
+        //! The number of values recorded
+        uint64_t count;
+
+        //! The smallest and largest values, 0 while empty
+        uint64_t min, max;
+
+        //! The sum of all values
+        uint64_t sum;
+
+        //! The count per bucket, see bucket_index()
+        std::vector<uint64_t> buckets;
+
+        //! Get the bucket a value is counted in
+        static size_t bucket_index(const uint64_t value);
+
+        //! Get the smallest value counted in a bucket
+        static uint64_t bucket_lower_bound(const size_t index);
+
+        //! Get the mean of the values, 0 while empty
+        double mean(void) const;
+
+        /*!
+         * Get a percentile of the values.
+         * The result is the lower bound of the bucket holding the percentile.
+         * \param pct the percentile, between 0 and 100
+         * \return the value, or 0 while empty
+         */
+        uint64_t percentile(const double pct) const;
+
+        /*!
+         * Get the histogram as a JSON object, with the unit, count,
+         * min, max, mean, the 50/90/99/99.9 percentiles and the non-empty
+         * buckets as pairs of lower bound and count.
+         */
+        std::string to_json(void) const;
+    };
+
+    //! Histograms by name, like the histograms of a streamer
+    typedef uhd::dict<std::string, histogram_t> histograms_t;
+
+    //! Get histograms as a JSON object with one member per histogram
+    UHD_API std::string to_json(const histograms_t &histograms);
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_TYPES_HISTOGRAM_HPP */
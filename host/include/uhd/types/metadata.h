@@ -157,6 +157,12 @@ UHD_API uhd_error uhd_rx_metadata_out_of_sequence(
     bool *result_out
 );
 
+//! Number of samples lost right before this buffer, after an overflow
+UHD_API uhd_error uhd_rx_metadata_num_dropped_samps(
+    uhd_rx_metadata_handle h,
+    size_t *num_dropped_samps_out
+);
+
 //! Return a pretty-print representation of this metadata.
 /*!
  * NOTE: This function will overwrite any string in the given buffer
@@ -49,6 +49,9 @@ namespace uhd{
             end_of_burst = false;
             error_code = ERROR_CODE_NONE;
             out_of_sequence = false;
+            has_host_time_spec = false;
+            host_time_spec = time_spec_t(0.0);
+            num_dropped_samps = 0;
         }
 
         //! Has time specification?
@@ -119,6 +122,26 @@ namespace uhd{
         //! Out of sequence.  The transport has either dropped a packet or received data out of order.
         bool out_of_sequence;
 
+        //! Has host receive time specification?
+        bool has_host_time_spec;
+
+        /*!
+         * The time the host received the first packet, if the transport
+         * timestamps received packets (see the udp_timestamp transport hint).
+         * Software timestamps use the system clock, hardware timestamps
+         * the clock of the network interface.
+         */
+        time_spec_t host_time_spec;
+
+        /*!
+         * The number of samples lost right before this buffer, per channel.
+         * The first successful receive after an overflow or a sequence error
+         * reports the distance between its time_spec and the end of the last
+         * buffer received before the error, so the gap can be zero-filled.
+         * It is zero otherwise, and when the packets carry no time.
+         */
+        size_t num_dropped_samps;
+
         /*!
          * Convert a rx_metadata_t into a pretty print string.
          *
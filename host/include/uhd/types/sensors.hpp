@@ -19,6 +19,7 @@
 #define INCLUDED_UHD_TYPES_SENSORS_HPP
 
 #include <uhd/config.hpp>
+#include <uhd/types/time_spec.hpp>
 #include <string>
 
 namespace uhd{
@@ -141,6 +142,55 @@ namespace uhd{
         sensor_value_t& operator=(const sensor_value_t& value);
     };
 
+    /*!
+     * A typed sensor reading, as returned by a sensor snapshot.
+     * The sensor value string is converted once when the reading is taken:
+     * boolean sensors read 1.0 or 0.0 as a real number, integer and real
+     * sensors read their value, and string sensors only keep the raw value.
+     */
+    struct UHD_API sensor_reading_t{
+
+        /*!
+         * Create a reading from a sensor value.
+         * \param key the key the sensor was read from
+         * \param value the sensor value
+         * \param timestamp the host system time of the read
+         */
+        sensor_reading_t(
+            const std::string &key,
+            const sensor_value_t &value,
+            const time_spec_t &timestamp
+        );
+
+        /*!
+         * Create an invalid reading for a sensor that could not be read.
+         * \param key the key the sensor was read from
+         * \param timestamp the host system time of the read
+         */
+        sensor_reading_t(
+            const std::string &key,
+            const time_spec_t &timestamp
+        );
+
+        //! The key the sensor was read from
+        std::string key;
+
+        //! The sensor value as read from the device
+        sensor_value_t value;
+
+        //! False if the sensor could not be read or converted
+        bool valid;
+
+        //! The value as a boolean (non-zero numbers are true)
+        bool bool_value;
+
+        //! The value as a real number (0.0 for string sensors)
+        double real_value;
+
+        //! The host system time when the sensor was read
+        time_spec_t timestamp;
+    };
+
 } //namespace uhd
 
 #endif /* INCLUDED_UHD_TYPES_SENSORS_HPP */
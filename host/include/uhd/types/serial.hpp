@@ -186,6 +186,22 @@ namespace uhd{
             uint32_t data,
             size_t num_bits
         );
+
+        /*!
+        * Write many words to the same slave on the SPI bus.
+        * Implementations can queue all the writes and wait only once
+        * at the end. The default implementation calls write_spi().
+        * \param which_slave the slave device number
+        * \param config spi config args
+        * \param data the words to write, in order
+        * \param num_bits how many bits in each word
+        */
+        virtual void write_spi_batch(
+            int which_slave,
+            const spi_config_t &config,
+            const std::vector<uint32_t> &data,
+            size_t num_bits
+        );
     };
 
     /*!
@@ -98,6 +98,14 @@ namespace uhd{
          * Default is fractional N on boards that support fractional N tuning.
          * Fractional N provides greater tuning accuracy at the expense of spurs.
          * Possible options for this key: "integer" or "fractional".
+         *
+         * - dsp_retune_window: With the automatic RF and DSP policies, when the
+         * target frequency is within this many Hz of the currently tuned RF
+         * frequency, only the DSP frequency is changed. The RF frontend is not
+         * retuned, so the hop is a single CORDIC register write and there is
+         * no settling time. The value "auto" uses the widest window that keeps
+         * the requested band within the frontend filter bandwidth.
+         * By default, the RF frontend is always retuned.
          */
         device_addr_t args;
 
@@ -22,6 +22,7 @@
 #include <uhd/types/time_spec.hpp>
 #include <stdint.h>
 #include <boost/shared_ptr.hpp>
+#include <vector>
 
 namespace uhd
 {
@@ -32,6 +33,20 @@ public:
     typedef boost::shared_ptr<wb_iface> sptr;
     typedef uint32_t wb_addr_type;
 
+    //! One register access of a batch, see transact()
+    struct transaction_t
+    {
+        enum op_type { POKE32, PEEK32, PEEK64 };
+        op_type op;
+        wb_addr_type addr;
+        //! The data to write, or the readback value after transact()
+        uint64_t data;
+
+        transaction_t(const op_type op_ = POKE32, const wb_addr_type addr_ = 0, const uint64_t data_ = 0):
+            op(op_), addr(addr_), data(data_) {}
+    };
+    typedef std::vector<transaction_t> transactions_type;
+
     virtual ~wb_iface(void);
 
     /*!
@@ -75,6 +90,16 @@ public:
      * \return the 16bit data
      */
     virtual uint16_t peek16(const wb_addr_type addr);
+
+    /*!
+     * Perform a batch of register accesses in order.
+     * Implementations send the whole batch before waiting for the
+     * acknowledgements, so the batch costs about one round trip
+     * instead of one per readback.
+     * The default implementation calls poke32(), peek32() and peek64().
+     * \param transactions the accesses, the readback values are stored in data
+     */
+    virtual void transact(transactions_type &transactions);
 };
 
 class UHD_API timed_wb_iface : public wb_iface
@@ -0,0 +1,121 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_USRP_ACQUISITION_SCHEDULER_HPP
+#define INCLUDED_UHD_USRP_ACQUISITION_SCHEDULER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+namespace uhd{ namespace usrp{
+
+    //! A finite acquisition of nsamps samples, starting at a device time
+    struct UHD_API acquisition_t{
+        acquisition_t(const time_spec_t &start = time_spec_t(0.0), const size_t nsamps = 0);
+
+        time_spec_t start;
+        size_t nsamps;
+    };
+
+    /*!
+     * Receive a list of timed finite acquisitions with one RX streamer.
+     *
+     * The scheduler turns the acquisitions into stream commands: each
+     * acquisition is split into commands the device can take, and an
+     * acquisition which starts right where the previous one ends is
+     * chained to it with STREAM_MODE_NUM_SAMPS_AND_MORE, so there is no
+     * gap between them on the device. Other acquisitions get a timed
+     * command. Only a few commands are given to the device at a time;
+     * the next ones are issued from recv() as the samples come in.
+     *
+     * recv() never returns the samples of two acquisitions at once. In the
+     * metadata, start_of_burst marks the first samples of an acquisition
+     * and end_of_burst its last ones. After an error, such as an overflow
+     * or a late command, recv() returns 0 samples with the error and with
+     * end_of_burst set: the streaming is stopped, the current acquisition
+     * is dropped, and the scheduler restarts with the next acquisition
+     * that can still be started in time.
+     *
+     * Acquisitions should be scheduled before the previous ones end, as
+     * only the acquisitions which are known when a command is issued can
+     * be chained. schedule() and recv() must be called from one thread.
+     *
+     * The args are:
+     * - max_cmd_samps: the samples of a command, 0x0fffffff by default
+     * - cmd_depth: the commands given to the device ahead, 4 by default
+     * - resync_lead: the time between an error and the next acquisition
+     *   that can still be started, 0.1 seconds by default
+     */
+    class UHD_API acquisition_scheduler : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<acquisition_scheduler> sptr;
+
+        virtual ~acquisition_scheduler(void) = 0;
+
+        /*!
+         * Make a scheduler for an RX streamer.
+         * \param rx_stream the RX streamer, which must not be streaming
+         * \param rate the sample rate of the streamer
+         * \param args the settings
+         */
+        static sptr make(
+            rx_streamer::sptr rx_stream,
+            const double rate,
+            const device_addr_t &args = device_addr_t()
+        );
+
+        /*!
+         * Add acquisitions after the ones already scheduled.
+         * The acquisitions must be in time order and not overlap.
+         * \throws uhd::value_error for empty or overlapping acquisitions
+         */
+        virtual void schedule(const std::vector<acquisition_t> &acqs) = 0;
+
+        /*!
+         * Receive the samples of the current acquisition.
+         * See uhd::rx_streamer::recv() for the arguments.
+         * The timeout must include the wait for the start of an acquisition.
+         * \return the number of samples, 0 without a pending acquisition
+         */
+        virtual size_t recv(
+            const rx_streamer::buffs_type &buffs,
+            const size_t nsamps_per_buff,
+            rx_metadata_t &metadata,
+            const double timeout = 0.1
+        ) = 0;
+
+        //! Get the index, in scheduling order, of the acquisition of the last recv()
+        virtual size_t get_acquisition_index(void) const = 0;
+
+        //! Get the number of acquisitions which were not fully received yet
+        virtual size_t get_num_pending(void) const = 0;
+
+        //! Get the number of acquisitions dropped after errors
+        virtual size_t get_num_dropped(void) const = 0;
+
+        //! Stop the streaming and drop all pending acquisitions
+        virtual void stop(void) = 0;
+    };
+
+}} //namespace uhd::usrp
+
+#endif /* INCLUDED_UHD_USRP_ACQUISITION_SCHEDULER_HPP */
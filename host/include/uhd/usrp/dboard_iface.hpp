@@ -216,6 +216,23 @@ public:
         size_t num_bits
     ) = 0;
 
+    /*!
+     * Write many words to SPI bus peripheral.
+     * Implementations can queue all the writes and wait only once
+     * at the end. The default implementation calls write_spi().
+     *
+     * \param unit which unit, rx or tx
+     * \param config configuration settings
+     * \param data the words to write MSB first, in order
+     * \param num_bits the number of bits in each word
+     */
+    virtual void write_spi_batch(
+        unit_t unit,
+        const spi_config_t &config,
+        const std::vector<uint32_t> &data,
+        size_t num_bits
+    );
+
     /*!
      * Read and write data to SPI bus peripheral.
      *
@@ -20,6 +20,7 @@
 
 #include <uhd/config.hpp>
 #include <uhd/property_tree.hpp>
+#include <uhd/types/direction.hpp>
 #include <uhd/usrp/dboard_base.hpp>
 #include <uhd/usrp/dboard_id.hpp>
 #include <boost/utility.hpp>
@@ -143,6 +144,15 @@ public:
      */
     virtual void initialize_dboards() = 0;
 
+    /*!
+     * Run the deferred post constructor initialization needed by one frontend.
+     * This allows a frontend to be brought up on first use. Calling this for
+     * a frontend that is already initialized does nothing.
+     * \param dir the direction of the frontend (RX_DIRECTION or TX_DIRECTION)
+     * \param fe_name the name of the frontend (subdev)
+     */
+    virtual void initialize_frontend(const uhd::direction_t dir, const std::string &fe_name) = 0;
+
     /*!
      * Returns a vector of RX frontend (subdev) names
      * \return a vector of names
@@ -0,0 +1,121 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_USRP_LATENCY_PROBE_HPP
+#define INCLUDED_UHD_USRP_LATENCY_PROBE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/histogram.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <boost/function.hpp>
+#include <complex>
+#include <string>
+
+namespace uhd{ namespace usrp{
+
+    /*!
+     * The settings of a latency measurement, see measure_latency().
+     */
+    struct UHD_API latency_config_t{
+        latency_config_t(void);
+
+        //! The number of samples of each RX and TX burst
+        size_t nsamps;
+
+        //! The number of bursts to measure
+        size_t nruns;
+
+        //! The device time between the RX burst and its TX response in seconds
+        double rtt;
+
+        //! How far ahead the RX bursts are requested in seconds
+        double rx_lead;
+
+        /*!
+         * The application work on each received burst, which is sent back.
+         * The samples are fc32. When empty, the burst is sent back as it is.
+         */
+        boost::function<void(std::vector<std::complex<float> > &)> work;
+    };
+
+    /*!
+     * The result of a latency measurement.
+     *
+     * The histograms, all in ns, are:
+     * - turnaround: from the first sample of the RX burst at the device
+     *   to the return of send() for its response, using the host and
+     *   device times compared at the start
+     * - receive: the part of the turnaround until recv() returned
+     * - application: the part between recv() and send(), with the work
+     * - send: the part in send()
+     * - rx_xport_wait, rx_convert, tx_xport_wait, tx_convert: the time
+     *   the streamers spent on the transport and converting, from the
+     *   histograms of the streamers, if they support them
+     */
+    struct UHD_API latency_result_t{
+        latency_result_t(void);
+
+        size_t num_runs;
+        size_t num_acks;        //!< responses that were sent in time
+        size_t num_late;        //!< responses that arrived too late
+        size_t num_underflows;
+        size_t num_timeouts;    //!< bursts that were not received or acknowledged
+        size_t num_other;       //!< other async events
+        histograms_t histograms;
+
+        //! Get the result as a JSON object
+        std::string to_json(void) const;
+    };
+
+    //! Get the device time, for measure_latency()
+    typedef boost::function<time_spec_t(void)> time_source_t;
+
+    /*!
+     * Measure the RX to TX turnaround with timestamped bursts.
+     *
+     * Each run requests an RX burst of nsamps at a time in the future,
+     * receives it, runs the work on it and sends it back as a TX burst
+     * timed rtt after the RX burst. The async messages of the TX streamer
+     * tell whether the response was in time.
+     * The streamers must stream fc32, on a single channel each.
+     *
+     * \param rx_stream the RX streamer
+     * \param tx_stream the TX streamer
+     * \param get_time_now the time of the device of the streamers
+     * \param config the settings
+     * \return the counts and histograms
+     */
+    UHD_API latency_result_t measure_latency(
+        rx_streamer::sptr rx_stream,
+        tx_streamer::sptr tx_stream,
+        const time_source_t &get_time_now,
+        const latency_config_t &config = latency_config_t()
+    );
+
+    //! Measure the latency with the time of the first motherboard
+    UHD_API latency_result_t measure_latency(
+        multi_usrp::sptr usrp,
+        rx_streamer::sptr rx_stream,
+        tx_streamer::sptr tx_stream,
+        const latency_config_t &config = latency_config_t()
+    );
+
+}} //namespace uhd::usrp
+
+#endif /* INCLUDED_UHD_USRP_LATENCY_PROBE_HPP */
@@ -32,6 +32,7 @@
 #define UHD_USRP_MULTI_USRP_REGISTER_API
 #define UHD_USRP_MULTI_USRP_FILTER_API
 #define UHD_USRP_MULTI_USRP_LO_CONFIG_API
+#define UHD_USRP_MULTI_USRP_SIGGEN_API
 
 #include <uhd/config.hpp>
 #include <uhd/device.hpp>
@@ -50,8 +51,26 @@
 #include <string>
 #include <vector>
 
+namespace uhd{ namespace rfnoc{
+    class siggen_block_ctrl;
+}}
+
 namespace uhd{ namespace usrp{
 
+//! The time synchronization status of one motherboard
+struct time_sync_status_t{
+    time_sync_status_t(void): mboard(0), pps_detected(false), aligned(false){}
+
+    //! The motherboard index 0 to M-1
+    size_t mboard;
+    //! Did the motherboard see the PPS edge at which the time was set?
+    bool pps_detected;
+    //! Did the motherboard latch the requested time at that edge?
+    bool aligned;
+    //! The time of the last PPS, read back after the edge
+    time_spec_t last_pps;
+};
+
 /*!
  * The Multi-USRP device class:
  *
@@ -138,6 +157,18 @@ public:
     //! Convenience method to get a TX streamer. See also uhd::device::get_rx_stream().
     virtual tx_streamer::sptr get_tx_stream(const stream_args_t &args) = 0;
 
+    /*!
+     * Get the signal generator that feeds a TX channel.
+     * Generation-3 devices made with the tx_siggen device arg connect
+     * the SigGen block of each radio to its first TX channel, instead
+     * of the host, so test signals take no host bandwidth.
+     * Such a channel cannot be streamed to.
+     * \param chan the channel index 0 to N-1
+     * \return the controller of the signal generator
+     * \throws uhd::not_implemented_error if no signal generator feeds the channel
+     */
+    virtual boost::shared_ptr<uhd::rfnoc::siggen_block_ctrl> get_tx_siggen(size_t chan = 0) = 0;
+
     /*!
      * Returns identifying information about this USRP's configuration.
      * Returns motherboard ID, name, and serial.
@@ -191,6 +222,30 @@ public:
      */
     virtual double get_master_clock_rate(size_t mboard = 0) = 0;
 
+    /*!
+     * Enable or disable the cached getters.
+     *
+     * With the cache enabled, get_master_clock_rate(), get_rx_rate(),
+     * get_tx_rate(), get_rx_freq(), get_tx_freq(), get_rx_gain() and
+     * get_tx_gain() read the device once and then return the value from
+     * memory. A cached value is dropped, and read again by the next call,
+     * when a property it depends on is set, through this object or through
+     * the property tree, and when an expert graph resolves.
+     *
+     * Changes which bypass the property tree, like register writes, are
+     * not seen: call clear_getter_cache() to read back the device.
+     * The cache is disabled by default.
+     *
+     * \param enable true to enable the cache
+     */
+    virtual void set_getter_cache(bool enable) = 0;
+
+    /*!
+     * Drop the cached values, so the next getter calls read the device.
+     * Does nothing when the cache is disabled.
+     */
+    virtual void clear_getter_cache(void) = 0;
+
     /*!
      * Get a printable summary for this USRP configuration.
      * \return a printable string
@@ -211,6 +266,15 @@ public:
      */
     virtual time_spec_t get_time_now(size_t mboard = 0) = 0;
 
+    /*!
+     * Get the current time from a read of the usrp time registers.
+     * Unlike get_time_now(), this never returns a host-side estimate,
+     * on devices where time estimation is enabled.
+     * \param mboard which motherboard to query
+     * \return a timespec representing current usrp time
+     */
+    virtual time_spec_t get_time_now_exact(size_t mboard = 0) = 0;
+
     /*!
      * Get the time when the last pps pulse occurred.
      * \param mboard which motherboard to query
@@ -254,6 +318,8 @@ public:
      *
      * This is a 2-step process, and will take at most 2 seconds to complete.
      * Upon completion, the times will be synchronized to the time provided.
+     * A warning is printed for each board that could not be synchronized,
+     * see sync_time_unknown_pps() for the details.
      *
      * - Step1: wait for the last pps time to transition to catch the edge
      * - Step2: set the time at the next pps (synchronous for all boards)
@@ -262,6 +328,22 @@ public:
      */
     virtual void set_time_unknown_pps(const time_spec_t &time_spec) = 0;
 
+    /*!
+     * Synchronize the times across all motherboards and report the result.
+     *
+     * This is the process of set_time_unknown_pps(), with all motherboards
+     * programmed and verified concurrently. The times are programmed
+     * right after a PPS edge of board 0; when this takes more than half a
+     * PPS period, the process starts over at the next edge, so the time
+     * is never set close to an edge. After the next edge, each board
+     * reads back its last PPS time, which must be the requested time.
+     *
+     * \param time_spec the time to latch at the next pps after catching the edge
+     * \return the status of each motherboard, in motherboard order
+     * \throws uhd::runtime_error if board 0 gets no PPS signal
+     */
+    virtual std::vector<time_sync_status_t> sync_time_unknown_pps(const time_spec_t &time_spec) = 0;
+
     /*!
      * Are the times across all motherboards in this configuration synchronized?
      * Checks that all time registers are approximately close but not exact,
@@ -289,6 +371,22 @@ public:
      */
     virtual void clear_command_time(size_t mboard = ALL_MBOARDS) = 0;
 
+    /*!
+     * Commit a set of property changes as one operation.
+     * The changes are committed with property_transaction::commit(),
+     * so expert-based frontends resolve once for all of them.
+     * With a command time, it is set before the commit and cleared
+     * afterwards, so all the resulting register writes are timed.
+     * \param transaction the staged changes
+     * \param cmd_time the command time, or 0 to commit right away
+     * \param mboard the motherboard to time, or all of them
+     */
+    virtual void commit_transaction(
+        property_transaction &transaction,
+        const time_spec_t &cmd_time = time_spec_t(0.0),
+        size_t mboard = ALL_MBOARDS
+    ) = 0;
+
     /*!
      * Issue a stream command to the usrp device.
      * This tells the usrp to send samples into the host.
@@ -303,6 +401,18 @@ public:
      */
     virtual void issue_stream_cmd(const stream_cmd_t &stream_cmd, size_t chan = ALL_CHANS) = 0;
 
+    /*!
+     * Issue a stream command to several RX channels at once.
+     * The motherboards are commanded concurrently, see set_rx_freq()
+     * for the channel lists. Use a time spec in the stream command
+     * for the channels to start together.
+     * \param stream_cmd the stream command to issue
+     * \param chans the channel indexes
+     */
+    virtual void issue_stream_cmd(
+        const stream_cmd_t &stream_cmd, const std::vector<size_t> &chans
+    ) = 0;
+
     /*!
      * Set the clock configuration for the usrp device.
      * DEPRECATED in favor of set time and clock source calls.
@@ -400,6 +510,19 @@ public:
      */
     virtual std::vector<std::string> get_mboard_sensor_names(size_t mboard = 0) = 0;
 
+    /*!
+     * Read a set of motherboard sensors in one call.
+     * Each sensor is read once and converted into a typed, timestamped
+     * reading. A sensor that fails to read yields an invalid reading
+     * instead of aborting the snapshot.
+     * \param names the sensor names, or an empty list for all sensors
+     * \param mboard the motherboard index 0 to M-1
+     * \return the readings, in the order of the names
+     */
+    virtual std::vector<sensor_reading_t> get_mboard_sensor_snapshot(
+        const std::vector<std::string> &names = std::vector<std::string>(), size_t mboard = 0
+    ) = 0;
+
     /*!
      * Perform write on the user configuration register bus. These only exist if
      * the user has implemented custom setting registers in the device FPGA.
@@ -443,6 +566,21 @@ public:
      */
     virtual std::string get_rx_subdev_name(size_t chan = 0) = 0;
 
+    /*!
+     * Make a transaction for the properties of an RX frontend.
+     * The paths are relative to the frontend, such as freq/value,
+     * gains/<name>/value, bandwidth/value and antenna/value. Commit it
+     * with commit_transaction() to change them together:
+     * <pre>
+     * property_transaction t = usrp->make_rx_fe_transaction(chan);
+     * t.set<double>("freq/value", lo_freq).set<std::string>("antenna/value", "RX1");
+     * usrp->commit_transaction(t, cmd_time);
+     * </pre>
+     * \param chan the channel index 0 to N-1
+     * \return an empty transaction
+     */
+    virtual property_transaction make_rx_fe_transaction(size_t chan = 0) = 0;
+
     /*!
      * Set the RX sample rate.
      * \param rate the rate in Sps
@@ -450,6 +588,17 @@ public:
      */
     virtual void set_rx_rate(double rate, size_t chan = ALL_CHANS) = 0;
 
+    /*!
+     * Set the RX sample rate of several channels at once.
+     * The motherboards are set concurrently, see set_rx_freq().
+     * \param rates a rate in Sps for each channel, or one for all of them
+     * \param chans the channel indexes
+     * \throws uhd::value_error if the number of rates does not fit
+     */
+    virtual void set_rx_rate(
+        const std::vector<double> &rates, const std::vector<size_t> &chans
+    ) = 0;
+
     /*!
      * Gets the RX sample rate.
      * \param chan the channel index 0 to N-1
@@ -474,6 +623,56 @@ public:
         const tune_request_t &tune_request, size_t chan = 0
     ) = 0;
 
+    /*!
+     * Set the RX center frequency of several channels at once.
+     *
+     * The channels are grouped by motherboard, and the motherboards are
+     * tuned concurrently, each in its own thread. The channels of one
+     * motherboard are tuned in the given order.
+     *
+     * With a command time, it is set once on each motherboard before its
+     * channels are tuned and cleared afterwards, so that all the register
+     * writes of a retune take effect at that time.
+     *
+     * \param tune_requests a request for each channel, or one for all of them
+     * \param chans the channel indexes
+     * \param cmd_time the command time, or 0 to tune right away
+     * \return a tune result for each channel
+     * \throws uhd::value_error if the number of requests does not fit
+     */
+    virtual std::vector<tune_result_t> set_rx_freq(
+        const std::vector<tune_request_t> &tune_requests,
+        const std::vector<size_t> &chans,
+        const time_spec_t &cmd_time = time_spec_t(0.0)
+    ) = 0;
+
+    /*!
+     * Precompute a table of RX tune requests for fast frequency hopping.
+     * Each tune request is resolved once, through the same process as
+     * set_rx_freq(), and the coerced RF and DSP frequencies are stored.
+     * The channel is returned to its current tuning afterwards.
+     * Setting a new table replaces the previous one for this channel.
+     * \param tune_requests a list of tune request instructions
+     * \param chan the channel index 0 to N-1
+     * \return the tune results the hops will produce, in table order
+     */
+    virtual std::vector<tune_result_t> set_rx_hop_table(
+        const std::vector<tune_request_t> &tune_requests, size_t chan = 0
+    ) = 0;
+
+    /*!
+     * Hop to an entry of the precomputed RX hop table.
+     * Only the precomputed frequencies are written: the RF frontend is
+     * only retuned when its frequency differs from the entry's, and the
+     * DSP is set directly. Use set_command_time() to time the hop.
+     * \param hop_index the index into the table set by set_rx_hop_table()
+     * \param chan the channel index 0 to N-1
+     * \return the tune result of the entry
+     * \throws uhd::key_error if no hop table is set for this channel
+     * \throws uhd::index_error if the index is out of range
+     */
+    virtual tune_result_t set_rx_freq_hop(size_t hop_index, size_t chan = 0) = 0;
+
     /*!
      * Get the RX center frequency.
      * \param chan the channel index 0 to N-1
@@ -592,6 +791,22 @@ public:
      */
     virtual void set_rx_gain(double gain, const std::string &name, size_t chan = 0) = 0;
 
+    /*!
+     * Set the RX gain of several channels at once.
+     * The motherboards are set concurrently, see set_rx_freq().
+     * \param gains a gain in dB for each channel, or one for all of them
+     * \param chans the channel indexes
+     * \param name the name of the gain element, empty for the overall gain
+     * \param cmd_time the command time, or 0 to set the gains right away
+     * \throws uhd::value_error if the number of gains does not fit
+     */
+    virtual void set_rx_gain(
+        const std::vector<double> &gains,
+        const std::vector<size_t> &chans,
+        const std::string &name = ALL_GAINS,
+        const time_spec_t &cmd_time = time_spec_t(0.0)
+    ) = 0;
+
     //! A convenience wrapper for setting overall RX gain
     void set_rx_gain(double gain, size_t chan = 0){
         return this->set_rx_gain(gain, ALL_GAINS, chan);
@@ -739,6 +954,17 @@ public:
      */
     virtual std::vector<std::string> get_rx_sensor_names(size_t chan = 0) = 0;
 
+    /*!
+     * Read a set of RX frontend sensors in one call.
+     * See get_mboard_sensor_snapshot() for the snapshot semantics.
+     * \param names the sensor names, or an empty list for all sensors
+     * \param chan the channel index 0 to N-1
+     * \return the readings, in the order of the names
+     */
+    virtual std::vector<sensor_reading_t> get_rx_sensor_snapshot(
+        const std::vector<std::string> &names = std::vector<std::string>(), size_t chan = 0
+    ) = 0;
+
     /*!
      * Enable/disable the automatic RX DC offset correction.
      * The automatic correction subtracts out the long-run average.
@@ -844,6 +1070,33 @@ public:
         const tune_request_t &tune_request, size_t chan = 0
     ) = 0;
 
+    /*!
+     * Precompute a table of TX tune requests for fast frequency hopping.
+     * Each tune request is resolved once, through the same process as
+     * set_tx_freq(), and the coerced RF and DSP frequencies are stored.
+     * The channel is returned to its current tuning afterwards.
+     * Setting a new table replaces the previous one for this channel.
+     * \param tune_requests a list of tune request instructions
+     * \param chan the channel index 0 to N-1
+     * \return the tune results the hops will produce, in table order
+     */
+    virtual std::vector<tune_result_t> set_tx_hop_table(
+        const std::vector<tune_request_t> &tune_requests, size_t chan = 0
+    ) = 0;
+
+    /*!
+     * Hop to an entry of the precomputed TX hop table.
+     * Only the precomputed frequencies are written: the RF frontend is
+     * only retuned when its frequency differs from the entry's, and the
+     * DSP is set directly. Use set_command_time() to time the hop.
+     * \param hop_index the index into the table set by set_tx_hop_table()
+     * \param chan the channel index 0 to N-1
+     * \return the tune result of the entry
+     * \throws uhd::key_error if no hop table is set for this channel
+     * \throws uhd::index_error if the index is out of range
+     */
+    virtual tune_result_t set_tx_freq_hop(size_t hop_index, size_t chan = 0) = 0;
+
     /*!
      * Get the TX center frequency.
      * \param chan the channel index 0 to N-1
@@ -1009,6 +1262,17 @@ public:
      */
     virtual std::vector<std::string> get_tx_sensor_names(size_t chan = 0) = 0;
 
+    /*!
+     * Read a set of TX frontend sensors in one call.
+     * See get_mboard_sensor_snapshot() for the snapshot semantics.
+     * \param names the sensor names, or an empty list for all sensors
+     * \param chan the channel index 0 to N-1
+     * \return the readings, in the order of the names
+     */
+    virtual std::vector<sensor_reading_t> get_tx_sensor_snapshot(
+        const std::vector<std::string> &names = std::vector<std::string>(), size_t chan = 0
+    ) = 0;
+
     /*!
      * Set a constant TX DC offset value.
      * The value is complex to control both I and Q.
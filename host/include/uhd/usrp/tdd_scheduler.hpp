@@ -0,0 +1,184 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_USRP_TDD_SCHEDULER_HPP
+#define INCLUDED_UHD_USRP_TDD_SCHEDULER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <string>
+
+namespace uhd{ namespace usrp{
+
+    /*!
+     * The frame of a TDD schedule, in samples at the rate of the streamers:
+     * an RX window, a guard, a TX window and a guard before the next frame.
+     */
+    struct UHD_API tdd_frame_t{
+        tdd_frame_t(
+            const size_t rx_samps = 0,
+            const size_t rx_tx_guard = 0,
+            const size_t tx_samps = 0,
+            const size_t tx_rx_guard = 0
+        );
+
+        size_t rx_samps;
+        size_t rx_tx_guard;
+        size_t tx_samps;
+        size_t tx_rx_guard;
+
+        //! Get the length of the frame in samples
+        size_t get_length(void) const;
+    };
+
+    //! The GPIO pin states of a TDD schedule, driven by the ATR of the radio
+    struct UHD_API tdd_atr_t{
+        tdd_atr_t(void);
+
+        uint32_t idle;
+        uint32_t rx;
+        uint32_t tx;
+        uint32_t full_duplex;
+        //! The pins driven by the ATR, others are left as they are
+        uint32_t mask;
+    };
+
+    /*!
+     * Run a TDD frame schedule with an RX and a TX streamer.
+     *
+     * The RX window of every frame is a timed finite acquisition, given to
+     * an acquisition_scheduler frame_depth frames ahead, so the commands of
+     * the next frames are queued on the device while the current frame is
+     * received. The TX window of a frame is one timed burst, which send()
+     * starts at the first sample of the window. recv() and send() do the
+     * only work of a frame on the host; no register is written between
+     * frames, so the turnaround is limited by the guards, which should
+     * cover the settling of the front end.
+     *
+     * The pins of a GPIO bank can follow the windows with set_atr(): the
+     * ATR of the radio switches them between the RX, TX and idle states,
+     * in the FPGA, as the windows start and end.
+     *
+     * recv() returns the samples of one RX window at a time, with
+     * start_of_burst and end_of_burst set at its ends, like the
+     * acquisition_scheduler, and get_rx_frame() tells which frame they
+     * belong to. After an error, the frames which cannot be started in time
+     * are dropped and the schedule goes on with the next one.
+     *
+     * recv() and send() may be called from two threads, each from one.
+     *
+     * The args are:
+     * - frame_depth: the frames scheduled ahead, 4 by default
+     * - and the args of uhd::usrp::acquisition_scheduler
+     */
+    class UHD_API tdd_scheduler : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<tdd_scheduler> sptr;
+
+        virtual ~tdd_scheduler(void) = 0;
+
+        /*!
+         * Make a scheduler for the streamers.
+         * \param rx_stream the RX streamer, which must not be streaming, or NULL
+         *        without RX windows
+         * \param tx_stream the TX streamer, or NULL without TX windows
+         * \param rate the sample rate of the streamers
+         * \param frame the frame schedule
+         * \param start the device time of the first frame
+         * \param args the settings
+         * \throws uhd::value_error for an empty frame or a missing streamer
+         */
+        static sptr make(
+            rx_streamer::sptr rx_stream,
+            tx_streamer::sptr tx_stream,
+            const double rate,
+            const tdd_frame_t &frame,
+            const time_spec_t &start,
+            const device_addr_t &args = device_addr_t()
+        );
+
+        /*!
+         * Drive the pins of a GPIO bank from the ATR of the radio.
+         * The ATR registers are written once, then the pins switch with the
+         * state of the radio, with no host writes per frame.
+         * \param usrp the device
+         * \param bank the GPIO bank, such as "FP0"
+         * \param atr the pin states
+         * \param mboard the motherboard
+         */
+        static void set_atr(
+            multi_usrp::sptr usrp,
+            const std::string &bank,
+            const tdd_atr_t &atr,
+            const size_t mboard = 0
+        );
+
+        //! Get the device time of the first sample of a frame
+        virtual time_spec_t get_frame_time(const size_t frame) const = 0;
+
+        //! Get the device time of the first sample of the TX window of a frame
+        virtual time_spec_t get_tx_time(const size_t frame) const = 0;
+
+        /*!
+         * Receive the samples of the current RX window.
+         * See uhd::rx_streamer::recv() for the arguments.
+         * The timeout must include the wait for the start of the window.
+         * \return the number of samples
+         */
+        virtual size_t recv(
+            const rx_streamer::buffs_type &buffs,
+            const size_t nsamps_per_buff,
+            rx_metadata_t &metadata,
+            const double timeout = 0.1
+        ) = 0;
+
+        //! Get the frame of the samples of the last recv()
+        virtual size_t get_rx_frame(void) const = 0;
+
+        //! Get the number of RX windows dropped after errors
+        virtual size_t get_num_dropped(void) const = 0;
+
+        /*!
+         * Send a burst in the TX window of a frame.
+         * The burst starts with the window and ends after nsamps samples.
+         * \param buffs the samples, one buffer per channel
+         * \param nsamps the samples of the burst, at most the TX window
+         * \param frame the frame
+         * \param timeout the timeout in seconds
+         * \return the number of samples sent
+         * \throws uhd::value_error when the burst is longer than the window
+         */
+        virtual size_t send(
+            const tx_streamer::buffs_type &buffs,
+            const size_t nsamps,
+            const size_t frame,
+            const double timeout = 0.1
+        ) = 0;
+
+        //! Stop the RX windows for good and drop the scheduled ones
+        virtual void stop(void) = 0;
+    };
+
+}} //namespace uhd::usrp
+
+#endif /* INCLUDED_UHD_USRP_TDD_SCHEDULER_HPP */
@@ -187,6 +187,11 @@ UHD_API uhd_error uhd_rx_streamer_issue_stream_cmd(
  * NOTE: This will overwrite the string currently in error_out before
  * using it to return its error.
  *
+ * Streamer calls keep their error per handle and do not lock or write
+ * any string when they succeed, so they can be made from several threads
+ * at once. They only update the string returned by uhd_get_last_error()
+ * when they fail.
+ *
  * \param h RX streamer handle
  * \param error_out string buffer in which to place error
  * \param strbuffer_len buffer size
@@ -267,6 +272,11 @@ UHD_API uhd_error uhd_tx_streamer_recv_async_msg(
  * NOTE: This will overwrite the string currently in error_out before
  * using it to return its error.
  *
+ * Streamer calls keep their error per handle and do not lock or write
+ * any string when they succeed, so they can be made from several threads
+ * at once. They only update the string returned by uhd_get_last_error()
+ * when they fail.
+ *
  * \param h TX streamer handle
  * \param error_out string buffer in which to place error
  * \param strbuffer_len buffer size
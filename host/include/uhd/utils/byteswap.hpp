@@ -20,11 +20,13 @@
 
 #include <uhd/config.hpp>
 #include <stdint.h>
+#include <cstddef>
 
 /*! \file byteswap.hpp
  *
  * Provide fast byteswaping routines for 16, 32, and 64 bit integers,
  * by using the system's native routines/intrinsics when available.
+ * The array versions use SSE2 or NEON when the compiler targets them.
  */
 namespace uhd{
 
@@ -37,6 +39,15 @@ namespace uhd{
     //! perform a byteswap on a 64 bit integer
     uint64_t byteswap(uint64_t);
 
+    //! perform a byteswap on an array of 16 bit integers, in and out may be the same
+    void byteswap(const uint16_t *in, uint16_t *out, const size_t num);
+
+    //! perform a byteswap on an array of 32 bit integers, in and out may be the same
+    void byteswap(const uint32_t *in, uint32_t *out, const size_t num);
+
+    //! perform a byteswap on an array of 64 bit integers, in and out may be the same
+    void byteswap(const uint64_t *in, uint64_t *out, const size_t num);
+
     //! network to host: short, long, or long-long
     template<typename T> T ntohx(T);
 
@@ -55,6 +66,26 @@ namespace uhd{
     // of typical network endianness).
     template<typename T> T htowx(T);
 
+    //! network to host for an array, in and out may be the same
+    void ntohx(const uint16_t *in, uint16_t *out, const size_t num);
+    void ntohx(const uint32_t *in, uint32_t *out, const size_t num);
+    void ntohx(const uint64_t *in, uint64_t *out, const size_t num);
+
+    //! host to network for an array, in and out may be the same
+    void htonx(const uint16_t *in, uint16_t *out, const size_t num);
+    void htonx(const uint32_t *in, uint32_t *out, const size_t num);
+    void htonx(const uint64_t *in, uint64_t *out, const size_t num);
+
+    //! worknet to host for an array, in and out may be the same
+    void wtohx(const uint16_t *in, uint16_t *out, const size_t num);
+    void wtohx(const uint32_t *in, uint32_t *out, const size_t num);
+    void wtohx(const uint64_t *in, uint64_t *out, const size_t num);
+
+    //! host to worknet for an array, in and out may be the same
+    void htowx(const uint16_t *in, uint16_t *out, const size_t num);
+    void htowx(const uint32_t *in, uint32_t *out, const size_t num);
+    void htowx(const uint64_t *in, uint64_t *out, const size_t num);
+
 } //namespace uhd
 
 #include <uhd/utils/byteswap.ipp>
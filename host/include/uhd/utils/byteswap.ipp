@@ -96,6 +96,97 @@
 
 #endif
 
+/***********************************************************************
+ * Bulk byteswap of arrays, 16 bytes at a time with SIMD:
+ * SSE2 swaps the bytes of each 16 bit word and then reorders the words,
+ * NEON has a byte reversal for every element size.
+ **********************************************************************/
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define UHD_BYTESWAP_WITH_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define UHD_BYTESWAP_WITH_NEON
+#endif
+
+#include <cstring>
+
+namespace uhd{ namespace byteswap_impl{
+
+#if defined(UHD_BYTESWAP_WITH_SSE2)
+    typedef __m128i vec_type;
+
+    UHD_INLINE vec_type load(const void *p){
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    }
+
+    UHD_INLINE void store(void *p, const vec_type v){
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+    }
+
+    UHD_INLINE vec_type swap(const vec_type v, uint16_t){
+        return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    }
+
+    UHD_INLINE vec_type swap(const vec_type v, uint32_t){
+        const vec_type s = swap(v, uint16_t());
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    UHD_INLINE vec_type swap(const vec_type v, uint64_t){
+        const vec_type s = swap(v, uint16_t());
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+    }
+#elif defined(UHD_BYTESWAP_WITH_NEON)
+    typedef uint8x16_t vec_type;
+
+    UHD_INLINE vec_type load(const void *p){
+        return vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+    }
+
+    UHD_INLINE void store(void *p, const vec_type v){
+        vst1q_u8(reinterpret_cast<uint8_t *>(p), v);
+    }
+
+    UHD_INLINE vec_type swap(const vec_type v, uint16_t){return vrev16q_u8(v);}
+    UHD_INLINE vec_type swap(const vec_type v, uint32_t){return vrev32q_u8(v);}
+    UHD_INLINE vec_type swap(const vec_type v, uint64_t){return vrev64q_u8(v);}
+#endif
+
+    template <typename T> UHD_INLINE void byteswap_array(const T *in, T *out, const size_t num){
+        size_t i = 0;
+#if defined(UHD_BYTESWAP_WITH_SSE2) || defined(UHD_BYTESWAP_WITH_NEON)
+        //every vector is loaded before it is stored, so in place works
+        const size_t num_per_vec = sizeof(vec_type)/sizeof(T);
+        for (; i + num_per_vec <= num; i += num_per_vec){
+            store(out+i, swap(load(in+i), T()));
+        }
+#endif
+        for (; i < num; i++) out[i] = uhd::byteswap(in[i]);
+    }
+
+    //! Copy an array without a byteswap, for the native byte order
+    template <typename T> UHD_INLINE void copy_array(const T *in, T *out, const size_t num){
+        if (in != out) std::memmove(out, in, num*sizeof(T));
+    }
+
+}} //namespace uhd::byteswap_impl
+
+#undef UHD_BYTESWAP_WITH_SSE2
+#undef UHD_BYTESWAP_WITH_NEON
+
+UHD_INLINE void uhd::byteswap(const uint16_t *in, uint16_t *out, const size_t num){
+    uhd::byteswap_impl::byteswap_array(in, out, num);
+}
+
+UHD_INLINE void uhd::byteswap(const uint32_t *in, uint32_t *out, const size_t num){
+    uhd::byteswap_impl::byteswap_array(in, out, num);
+}
+
+UHD_INLINE void uhd::byteswap(const uint64_t *in, uint64_t *out, const size_t num){
+    uhd::byteswap_impl::byteswap_array(in, out, num);
+}
+
 /***********************************************************************
  * Define the templated network to/from host conversions
  **********************************************************************/
@@ -135,6 +226,32 @@ template<typename T> UHD_INLINE T htowx(T num){
     #endif
 }
 
+/***********************************************************************
+ * Define the network to/from host conversions of arrays, as overloads
+ * so that uhd::ntohx<T> and friends still name a single function
+ **********************************************************************/
+#ifdef BOOST_BIG_ENDIAN
+    #define UHD_NETWORK_ARRAY uhd::byteswap_impl::copy_array
+    #define UHD_WORKNET_ARRAY uhd::byteswap
+#else
+    #define UHD_NETWORK_ARRAY uhd::byteswap
+    #define UHD_WORKNET_ARRAY uhd::byteswap_impl::copy_array
+#endif
+
+#define UHD_DEFINE_ARRAY_CONVERSIONS(T) \
+    UHD_INLINE void ntohx(const T *in, T *out, const size_t num){UHD_NETWORK_ARRAY(in, out, num);} \
+    UHD_INLINE void htonx(const T *in, T *out, const size_t num){UHD_NETWORK_ARRAY(in, out, num);} \
+    UHD_INLINE void wtohx(const T *in, T *out, const size_t num){UHD_WORKNET_ARRAY(in, out, num);} \
+    UHD_INLINE void htowx(const T *in, T *out, const size_t num){UHD_WORKNET_ARRAY(in, out, num);}
+
+UHD_DEFINE_ARRAY_CONVERSIONS(uint16_t)
+UHD_DEFINE_ARRAY_CONVERSIONS(uint32_t)
+UHD_DEFINE_ARRAY_CONVERSIONS(uint64_t)
+
+#undef UHD_DEFINE_ARRAY_CONVERSIONS
+#undef UHD_NETWORK_ARRAY
+#undef UHD_WORKNET_ARRAY
+
 } /* namespace uhd */
 
 #endif /* INCLUDED_UHD_UTILS_BYTESWAP_IPP */
@@ -65,6 +65,9 @@ public:
      * For an empty name, set the overall gain value for this group.
      * The power will be distributed across individual gain elements.
      * The semantics of how to do this are determined by the priority.
+     * The distribution of each step of the overall range is computed
+     * once per change of the element ranges, and only the elements whose
+     * value changes are set.
      * \param gain the gain to set for the element or across the group
      * \param name name of the gain element (optional)
      */
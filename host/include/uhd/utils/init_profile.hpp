@@ -0,0 +1,114 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_UTILS_INIT_PROFILE_HPP
+#define INCLUDED_UHD_UTILS_INIT_PROFILE_HPP
+
+#include <uhd/config.hpp>
+#include <boost/chrono.hpp>
+#include <boost/utility.hpp>
+#include <string>
+#include <vector>
+
+/*! \file init_profile.hpp
+ * Timing of the phases of the device initialization.
+ *
+ * uhd::device::make() times its discovery and make phases, and the
+ * device implementations time the phases within, like the FPGA load,
+ * the EEPROM reads, the clocking or the RFNoC enumeration, per
+ * motherboard. The phases of the last device::make() are kept until the
+ * next one, and their breakdown is written to the log when it returns.
+ *
+ * The phase names are paths: "mboard/clocking" is a part of "mboard".
+ * A phase which ran several times, like one per block, is reported once
+ * with its total time.
+ */
+
+namespace uhd{ namespace init_profile{
+
+    //! The motherboard of the phases which are not specific to one
+    static const size_t ALL_MBOARDS = size_t(~0);
+
+    //! A timed phase
+    struct UHD_API phase_t{
+        //! The name, a path with the parent phases first
+        std::string name;
+
+        //! The motherboard index, or ALL_MBOARDS
+        size_t mboard;
+
+        //! The start in seconds, from the start of the profile
+        double start;
+
+        //! The duration in seconds
+        double duration;
+
+        //! The number of times it ran, see get_breakdown()
+        size_t count;
+    };
+
+    /*!
+     * Discard the phases and start timing new ones.
+     * Called by device::make(), phases outside of it are not recorded.
+     */
+    UHD_API void start(void);
+
+    //! Stop recording phases, keeping the recorded ones
+    UHD_API void stop(void);
+
+    //! Are phases being recorded?
+    UHD_API bool is_enabled(void);
+
+    //! Get the phases recorded since start(), in the order they started
+    UHD_API std::vector<phase_t> get_phases(void);
+
+    /*!
+     * Get the phase breakdown of one motherboard: the phases of the same
+     * name are merged, with their total duration and earliest start.
+     * \param mboard the motherboard index, or ALL_MBOARDS
+     * \return the phases in the order they first started
+     */
+    UHD_API std::vector<phase_t> get_breakdown(const size_t mboard);
+
+    //! Format the breakdown of every motherboard as a table
+    UHD_API std::string to_pp_string(void);
+
+    /*!
+     * Times a phase from its construction to its destruction.
+     * A sequence of phases in one scope is timed with next().
+     */
+    class UHD_API scoped_phase : boost::noncopyable{
+    public:
+        scoped_phase(const std::string &name, const size_t mboard = ALL_MBOARDS);
+
+        ~scoped_phase(void);
+
+        //! End this phase and start the next one in its place
+        void next(const std::string &name);
+
+    private:
+        void end(void);
+
+        std::string _name;
+        const size_t _mboard;
+        bool _active;
+        boost::chrono::steady_clock::time_point _start;
+    };
+
+}} //namespace uhd::init_profile
+
+#endif /* INCLUDED_UHD_UTILS_INIT_PROFILE_HPP */
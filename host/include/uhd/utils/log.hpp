@@ -31,7 +31,14 @@
  *
  * The logger enables UHD library code to easily log events into a file.
  * Log entries are time-stamped and stored with file, line, and function.
- * Each call to the UHD_LOG macros is synchronous and thread-safe.
+ * Each call to the UHD_LOG macros is thread-safe.
+ *
+ * By default, log entries are written asynchronously: the calling thread
+ * only formats the message and queues it into a lock-free queue of its
+ * own, and a background thread adds the headers and writes the file.
+ * Entries are dropped (and counted in the log) rather than blocking when
+ * a queue is full. Set the environment variable UHD_LOG_ASYNC=0 to write
+ * each entry synchronously from the calling thread instead.
  *
  * The log file can be found in the path <temp-directory>/uhd.log,
  * where <temp-directory> is the user or system's temporary directory.
@@ -50,13 +57,25 @@
  *   - Example pre-processor define: -DUHD_LOG_LEVEL=regularly
  *   - Example environment variable: export UHD_LOG_LEVEL=3
  *   - Example environment variable: export UHD_LOG_LEVEL=regularly
+ *
+ * Log statements below the integer pre-processor define UHD_LOG_MIN_LEVEL
+ * are compiled out of the code that includes this header. Statements
+ * below the run time log level cost one level check, without building
+ * the log entry.
  */
 
+#ifndef UHD_LOG_MIN_LEVEL
+#define UHD_LOG_MIN_LEVEL 1
+#endif
+
 /*!
  * A UHD logger macro with configurable verbosity.
  * Usage: UHD_LOGV(very_rarely) << "the log message" << std::endl;
  */
 #define UHD_LOGV(verbosity) \
+    for (bool _uhd_log_it = (uhd::_log::verbosity >= UHD_LOG_MIN_LEVEL) and \
+            uhd::_log::is_enabled(uhd::_log::verbosity); \
+        _uhd_log_it; _uhd_log_it = false) \
     uhd::_log::log(uhd::_log::verbosity, __FILE__, __LINE__, BOOST_CURRENT_FUNCTION)
 
 /*!
@@ -79,6 +98,9 @@ namespace uhd{ namespace _log{
         never       = 6
     };
 
+    //! Check the run time log level (called by UHD_LOG macros)
+    UHD_API bool is_enabled(const verbosity_t verbosity);
+
     //! Internal logging object (called by UHD_LOG macros)
     class UHD_API log {
     public:
@@ -108,9 +130,13 @@ namespace uhd{ namespace _log{
         INSERTION_OVERLOAD(std::ios& (*val)(std::ios&))
         INSERTION_OVERLOAD(std::ios_base& (*val)(std::ios_base&))
 
+        //! The log entry handed to the writer (opaque, see log.cpp)
+        struct record_type;
+
     private:
         std::ostringstream _ss;
         bool _log_it;
+        record_type *_record;
     };
 
 }} //namespace uhd::_log
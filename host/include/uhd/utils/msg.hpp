@@ -64,6 +64,16 @@ namespace uhd{ namespace msg{
      */
     UHD_API void register_handler(const handler_t &handler);
 
+    /*!
+     * Report a fast-path event, such as 'O' for an overflow.
+     * This is safe to call from the streaming threads: it only counts the
+     * event without taking a lock. A background thread prints the counted
+     * events as fastpath messages every report period: a single event as
+     * its character, several as a summary line like "O x 37 in last 100ms".
+     * \param event the character of the event
+     */
+    UHD_API void fastpath_event(const char event);
+
     //! Internal message object (called by UHD_MSG macro)
     class UHD_API _msg{
     public:
@@ -0,0 +1,103 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_UTILS_SAMPLE_READER_HPP
+#define INCLUDED_UHD_UTILS_SAMPLE_READER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace uhd{
+
+    /*!
+     * Reads back a capture of the sample recorder by its index.
+     *
+     * The files are memory mapped, so seeking is free and only the samples
+     * that are read are paged in. Sample offsets count over all files, in
+     * the order the samples were recorded in.
+     *
+     * find() seeks to a time with a binary search over the index entries.
+     * A time that falls into a discontinuity is clamped to the first sample
+     * after it.
+     */
+    class UHD_API sample_reader : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<sample_reader> sptr;
+
+        /*!
+         * Make a new reader for a capture.
+         * \param paths the files of the capture, in the order they were recorded with
+         * \param index_path the index file of the capture
+         * \return a new reader
+         * \throws uhd::io_error when a file cannot be opened
+         * \throws uhd::value_error when the index does not match the files
+         */
+        static sptr make(
+            const std::vector<std::string> &paths,
+            const std::string &index_path
+        );
+
+        virtual ~sample_reader(void) = 0;
+
+        //! Get the number of bytes per sample
+        virtual size_t get_item_size(void) const = 0;
+
+        //! Get the sample rate of the capture
+        virtual double get_samp_rate(void) const = 0;
+
+        //! Get the bytes per file before the capture goes on in the next
+        virtual size_t get_stripe_size(void) const = 0;
+
+        //! Get the number of samples in the capture
+        virtual uint64_t get_num_samps(void) const = 0;
+
+        /*!
+         * Get the time of a sample.
+         * \param samp_offset the offset of the sample in the capture
+         * \return the time of the sample
+         * \throws uhd::index_error when the offset is past the end
+         */
+        virtual time_spec_t get_time(const uint64_t samp_offset) const = 0;
+
+        /*!
+         * Find the first sample at or after a time.
+         * \param time the time to seek to
+         * \return the offset of the sample, get_num_samps() past the end
+         */
+        virtual uint64_t find(const time_spec_t &time) const = 0;
+
+        //! Get the offsets of the samples that follow lost samples
+        virtual std::vector<uint64_t> get_discontinuities(void) const = 0;
+
+        /*!
+         * Copy samples out of the capture.
+         * \param buff the buffer to copy into
+         * \param samp_offset the offset of the first sample
+         * \param nsamps the maximum number of samples to copy
+         * \return the number of samples copied, short at the end
+         */
+        virtual size_t read(void *buff, const uint64_t samp_offset, const size_t nsamps) const = 0;
+    };
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_SAMPLE_READER_HPP */
@@ -0,0 +1,119 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_UTILS_SAMPLE_RECORDER_HPP
+#define INCLUDED_UHD_UTILS_SAMPLE_RECORDER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/metadata.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace uhd{
+
+    /*!
+     * Records a stream of samples to disk without blocking the receive thread.
+     *
+     * write() copies the samples into a ring of page-aligned buffers and
+     * returns. Full buffers are written by an I/O thread per file, with
+     * O_DIRECT where the platform and file system support it, so the page
+     * cache does not fill up with samples.
+     *
+     * With several files, the buffers are striped across them: buffer k
+     * goes to file k % num_files, so the files can live on different disks
+     * that are written in parallel. Reading back interleaves one buffer of
+     * each file in turn. With a single file, it holds the samples in order.
+     *
+     * A write that finds no free buffer is dropped whole and counted, as are
+     * the buffers lost to a failed disk write.
+     *
+     * With an index file, the recorder also writes a sidecar index that maps
+     * the sample offsets to their times, at a fixed stride and after every
+     * discontinuity, see uhd::sample_reader.
+     */
+    class UHD_API sample_recorder : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<sample_recorder> sptr;
+
+        /*!
+         * Make a new recorder, the files are created or truncated.
+         *
+         * The args are:
+         * - buff_size: bytes per buffer, a multiple of 4096, defaults to 4 MiB
+         * - num_buffs: buffers in the ring, defaults to 32
+         * - direct_io: 0 to write through the page cache, defaults to 1
+         * - index: the path of the index file, none by default
+         * - item_size: bytes per sample, required with an index
+         * - samp_rate: samples per second, required with an index
+         * - index_stride: bytes between index entries, defaults to buff_size
+         *
+         * \param paths the files to stripe the samples across
+         * \param args the recorder args, see above
+         * \return a new recorder
+         * \throws uhd::value_error on invalid args
+         * \throws uhd::io_error when a file cannot be opened
+         */
+        static sptr make(
+            const std::vector<std::string> &paths,
+            const device_addr_t &args = device_addr_t()
+        );
+
+        //! Closes the recorder if close() was not called, errors are logged
+        virtual ~sample_recorder(void) = 0;
+
+        /*!
+         * Copy samples into the ring.
+         * This does not wait on the disks, a full ring drops the samples.
+         * \param buff the samples
+         * \param nbytes the number of bytes to copy
+         * \return false when the samples were dropped
+         */
+        virtual bool write(const void *buff, const size_t nbytes) = 0;
+
+        /*!
+         * Copy samples into the ring and index them by their metadata.
+         * The time spec of the metadata is the time of the first sample.
+         * An error without samples, e.g. an overflow, marks the next
+         * samples as a discontinuity, as does a gap in the time specs.
+         * Without an index file, this is the same as write(buff, nbytes).
+         * \param buff the samples
+         * \param nbytes the number of bytes to copy
+         * \param metadata the metadata the samples were received with
+         * \return false when the samples were dropped
+         */
+        virtual bool write(const void *buff, const size_t nbytes, const rx_metadata_t &metadata) = 0;
+
+        /*!
+         * Write out the partial buffer, wait for the disks and close the files.
+         * \throws uhd::io_error when a disk write failed
+         */
+        virtual void close(void) = 0;
+
+        //! Get the number of bytes written to the files so far
+        virtual uint64_t get_num_written_bytes(void) const = 0;
+
+        //! Get the number of bytes dropped by a full ring or failed writes
+        virtual uint64_t get_num_dropped_bytes(void) const = 0;
+    };
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_SAMPLE_RECORDER_HPP */
@@ -0,0 +1,94 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_UTILS_SAMPLE_SOURCE_HPP
+#define INCLUDED_UHD_UTILS_SAMPLE_SOURCE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace uhd{
+
+    /*!
+     * Plays samples from disk without blocking the send thread.
+     *
+     * A read-ahead thread fills a ring of buffers from the files, so a
+     * disk stall is absorbed by the ring instead of underflowing the
+     * transmitter. make() waits until the ring is full before it returns.
+     *
+     * The files are played one after another, or with a stripe size, in
+     * the striped layout of the sample recorder. A looping source wraps to
+     * the first byte of the files at the end, in the same ring, so there is
+     * no gap at the wrap point.
+     */
+    class UHD_API sample_source : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<sample_source> sptr;
+
+        /*!
+         * Make a new source and fill its ring.
+         *
+         * The args are:
+         * - buff_size: bytes per buffer, defaults to 1 MiB
+         * - num_buffs: buffers in the ring, defaults to 16
+         * - stripe_size: the buff_size of a striped capture, 0 to play the files in turn
+         * - offset: the byte of the files to start at, defaults to 0
+         * - loop: 1 to wrap to the first byte at the end, defaults to 0
+         *
+         * \param paths the files to play
+         * \param args the source args, see above
+         * \return a new source
+         * \throws uhd::value_error on invalid args
+         * \throws uhd::io_error when a file cannot be opened
+         */
+        static sptr make(
+            const std::vector<std::string> &paths,
+            const device_addr_t &args = device_addr_t()
+        );
+
+        virtual ~sample_source(void) = 0;
+
+        /*!
+         * Copy samples out of the ring.
+         * This only waits when the ring is empty, then the wait is counted
+         * as a stall. It returns short when the ring runs dry.
+         * \param buff the buffer to copy into
+         * \param nbytes the maximum number of bytes to copy
+         * \param timeout the timeout in seconds to wait on an empty ring
+         * \return the number of bytes copied
+         * \throws uhd::io_error when a disk read failed
+         */
+        virtual size_t read(void *buff, const size_t nbytes, const double timeout = 0.1) = 0;
+
+        //! True when every byte of a source that does not loop was read
+        virtual bool eof(void) const = 0;
+
+        //! Get the number of bytes of the files
+        virtual uint64_t get_num_bytes(void) const = 0;
+
+        //! Get the number of reads that found the ring empty
+        virtual size_t get_num_stalls(void) const = 0;
+    };
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_SAMPLE_SOURCE_HPP */
@@ -118,6 +118,16 @@ public:
     virtual bool is_readable() = 0;
     virtual bool is_writable() = 0;
 
+    /*!
+     * Queue the write that flush() would do into a batch of register
+     * transactions for iface, and mark the soft-copy clean.
+     * \return false if the register cannot be written in a batch on
+     *         iface, in which case flush() must be used instead
+     */
+    virtual bool append_flush(wb_iface& /*iface*/, wb_iface::transactions_type& /*transactions*/) {
+        return false;
+    }
+
     /*!
      * Cast the soft_register generic reference to a more specific type
      */
@@ -227,6 +237,23 @@ public:
         }
     }
 
+    /*!
+     * Queue the contents of the soft-copy into a batch of transactions.
+     * Only 32-bit registers initialized with iface can be batched.
+     */
+    UHD_INLINE bool append_flush(wb_iface& iface, wb_iface::transactions_type& transactions)
+    {
+        if (not writable or _iface != &iface or get_bitwidth() != 32) {
+            return false;
+        }
+        if (_flush_mode == ALWAYS_FLUSH || _soft_copy.is_dirty()) {
+            transactions.push_back(wb_iface::transaction_t(
+                wb_iface::transaction_t::POKE32, _wr_addr, static_cast<uint32_t>(_soft_copy)));
+            _soft_copy.mark_clean();
+        }
+        return true;
+    }
+
     /*!
      * Read the contents of the register from hardware and update the soft copy.
      */
@@ -345,6 +372,12 @@ public:
         soft_register_t<reg_data_t, readable, writable>::flush();
     }
 
+    UHD_INLINE bool append_flush(wb_iface& iface, wb_iface::transactions_type& transactions)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        return soft_register_t<reg_data_t, readable, writable>::append_flush(iface, transactions);
+    }
+
     UHD_INLINE void refresh()
     {
         boost::lock_guard<boost::mutex> lock(_mutex);
@@ -451,6 +484,29 @@ public:
     virtual const std::string& get_name() const = 0;
 };
 
+/*!
+ * A handle to a register of a regmap or a regmap database.
+ * The path is looked up and the register type is checked once, when the
+ * handle is made, so accesses through the handle skip the string lookup.
+ * A handle must not outlive the regmap that owns the register.
+ * For example:
+ *   soft_reg_handle_t<soft_reg32_wo_t> reg(db, "radio0/spi_regmap/spi_control_reg");
+ *   reg->write(field, value);
+ */
+template <typename soft_reg_t>
+class soft_reg_handle_t {
+public:
+    soft_reg_handle_t(const soft_regmap_accessor_t& accessor, const std::string& path) :
+        _reg(&soft_register_base::cast<soft_reg_t>(accessor.lookup(path)))
+    {}
+
+    UHD_INLINE soft_reg_t& operator*() const { return *_reg; }
+    UHD_INLINE soft_reg_t* operator->() const { return _reg; }
+
+private:
+    soft_reg_t* _reg;
+};
+
 /*!
  * A regmap is a collection of registers that share the same
  * bus (control iface). A regmap must have an identifier.
@@ -463,7 +519,7 @@ public:
  */
 class UHD_API soft_regmap_t : public soft_regmap_accessor_t, public boost::noncopyable {
 public:
-    soft_regmap_t(const std::string& name) : _name(name) {}
+    soft_regmap_t(const std::string& name) : _name(name), _iface(NULL) {}
     virtual ~soft_regmap_t() {};
 
     /*!
@@ -479,6 +535,7 @@ public:
      */
     void initialize(wb_iface& iface, bool sync = false) {
         boost::lock_guard<boost::mutex> lock(_mutex);
+        _iface = &iface;
         BOOST_FOREACH(soft_register_base* reg, _reglist) {
             reg->initialize(iface, sync);
         }
@@ -496,6 +553,43 @@ public:
         }
     }
 
+    /*!
+     * Flush all registers to hardware in one batch of register
+     * transactions (see wb_iface::transact()), so the writes of the
+     * dirty registers cost about one round trip instead of one each.
+     * Registers which cannot be batched are flushed one at a time,
+     * in order with the batched ones.
+     * If the map was initialized with a timed_wb_iface, the batch
+     * can be timed: see flush_all(const time_spec_t&).
+     * A failed batch leaves the registers of the batch marked clean.
+     */
+    void flush_all() {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _flush_all();
+    }
+
+    /*!
+     * Flush all registers to hardware in one batch timed at time.
+     * The command time of the bus is restored afterwards.
+     * \throws uhd::not_implemented_error if the bus is not a timed_wb_iface
+     */
+    void flush_all(const time_spec_t& time) {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        timed_wb_iface* timed_iface = dynamic_cast<timed_wb_iface*>(_iface);
+        if (not timed_iface) {
+            throw uhd::not_implemented_error("soft_regmap_t::flush_all: the bus of " + _name + " has no command time");
+        }
+        const time_spec_t prev_time = timed_iface->get_time();
+        timed_iface->set_time(time);
+        try {
+            _flush_all();
+        } catch (...) {
+            timed_iface->set_time(prev_time);
+            throw;
+        }
+        timed_iface->set_time(prev_time);
+    }
+
     /*!
      * Refresh all register soft-copies from hardware.
      * The order of reading is the same as the order in
@@ -557,9 +651,31 @@ private:
     typedef boost::unordered_map<std::string, soft_register_base*> regmap_t;
     typedef std::list<soft_register_base*>                         reglist_t;
 
+    void _flush_all() {
+        if (not _iface) {
+            throw uhd::not_implemented_error("soft_regmap_t::flush_all: " + _name + " is uninitialized");
+        }
+        _transactions.clear();
+        BOOST_FOREACH(soft_register_base* reg, _reglist) {
+            if (not reg->append_flush(*_iface, _transactions)) {
+                //Keep the order of the writes around the unbatched register
+                if (not _transactions.empty()) {
+                    _iface->transact(_transactions);
+                    _transactions.clear();
+                }
+                reg->flush();
+            }
+        }
+        if (not _transactions.empty()) {
+            _iface->transact(_transactions);
+        }
+    }
+
     const std::string   _name;
     regmap_t            _regmap;    //For lookups
     reglist_t           _reglist;   //To maintain order
+    wb_iface*           _iface;     //The bus of the last initialize()
+    wb_iface::transactions_type _transactions; //Reused by flush_all()
     boost::mutex        _mutex;
 };
 
@@ -22,6 +22,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
 #include <boost/utility.hpp>
+#include <string>
 
 namespace uhd{
 
@@ -40,11 +41,49 @@ namespace uhd{
          *  - The blocking call is interruptible.
          *  - The task polls the interrupt condition.
          *
+         * The thread of the task is set up for the given role,
+         * see uhd::setup_thread().
+         *
          * \param task_fcn the task callback function
+         * \param role the thread role of the task
          * \return a new task object
          */
-        static sptr make(const task_fcn_type &task_fcn);
+        static sptr make(const task_fcn_type &task_fcn, const std::string &role = "task");
+
+    };
+
+    /*!
+     * A task that runs on a pool of threads shared by all pooled tasks.
+     *
+     * Unlike uhd::task, a pooled task does not own a thread, so it suits
+     * background work that is mostly idle, like re-claiming a device.
+     * Its function is called again right away while it returns true, and
+     * after its period once it returns false, or as soon as the task is
+     * notified. The function must only do short, bounded work and must
+     * not block or sleep, since it holds a thread of the pool meanwhile.
+     * Latency-critical work should keep a dedicated uhd::task.
+     *
+     * The pool starts with the first pooled task. Its number of threads
+     * can be set with the environment variable UHD_TASK_POOL_THREADS.
+     */
+    class UHD_API pooled_task : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<pooled_task> sptr;
+        typedef boost::function<bool(void)> task_fcn_type;
+
+        virtual ~pooled_task(void) = 0;
+
+        /*!
+         * Create a new task on the shared task pool.
+         * Destroying the task waits for a running call to return.
+         * \param task_fcn the task callback function, returns true when it did work
+         * \param period the time in seconds between calls while the task is idle
+         * \return a new pooled task object
+         */
+        static sptr make(const task_fcn_type &task_fcn, const double period);
 
+        //! Call the task function again as soon as a pool thread is free
+        virtual void notify(void) = 0;
     };
 } //namespace uhd
 
@@ -19,6 +19,10 @@
 #define INCLUDED_UHD_UTILS_THREAD_PRIORITY_HPP
 
 #include <uhd/config.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/function.hpp>
+#include <string>
+#include <vector>
 
 namespace uhd{
 
@@ -53,6 +57,129 @@ namespace uhd{
         bool realtime = true
     );
 
+    /*!
+     * Set the CPU affinity of the current thread.
+     *
+     * The thread is only allowed to run on the given CPUs.
+     * An empty list leaves the affinity unchanged.
+     * On Windows hosts with processor groups, the indexes count through
+     * the groups in order, and all CPUs must be in the same group.
+     *
+     * \param cpu_affinity_list a list of CPU indexes
+     * \throw exception on set affinity failure
+     */
+    UHD_API void set_thread_affinity(
+        const std::vector<size_t> &cpu_affinity_list
+    );
+
+    /*!
+     * Register the current thread with the Windows multimedia class
+     * scheduler (MMCSS), which boosts it ahead of normal threads
+     * without needing the realtime priority class for the process.
+     * The registration lasts until the thread exits.
+     * An empty task name leaves the thread unchanged.
+     *
+     * \param task the MMCSS task name, like "Pro Audio" or "Capture"
+     * \param priority a value between -1 and 1 for the priority within the task
+     * \throw exception on failure, or where MMCSS is not available
+     */
+    UHD_API void set_thread_mmcss(
+        const std::string &task,
+        float priority = default_thread_priority
+    );
+
+    /*!
+     * Set the name of the current thread, as shown by tools like top and perf.
+     * Names longer than the system limit (15 characters on Linux) are cut.
+     * This call does nothing where the system does not support it.
+     * \param name the new thread name
+     */
+    UHD_API void set_thread_name(const std::string &name);
+
+    //! Scheduling classes for a thread configuration
+    enum thread_sched_t{
+        //! Leave the scheduling class and priority unchanged
+        THREAD_SCHED_INHERIT,
+        //! Normal time sharing scheduling
+        THREAD_SCHED_OTHER,
+        //! Realtime round robin scheduling
+        THREAD_SCHED_RR,
+        //! Realtime first in, first out scheduling
+        THREAD_SCHED_FIFO
+    };
+
+    /*!
+     * Placement and scheduling of one role of internal UHD threads.
+     *
+     * Each thread UHD starts has a role, for example "muxed_demux",
+     * "recv_offload", "libusb_event", "task_pool" or the name of a task.
+     * The thread applies the configuration of its role when it starts,
+     * and is named "uhd_" followed by the role.
+     */
+    struct UHD_API thread_config_t{
+        thread_config_t(void);
+
+        //! The CPUs the thread may run on, empty to leave it unchanged
+        std::vector<size_t> cpus;
+
+        //! The scheduling class
+        thread_sched_t sched;
+
+        //! The priority within the class, see set_thread_priority()
+        float priority;
+
+        //! The MMCSS task to register with (Windows), empty for none
+        std::string mmcss_task;
+    };
+
+    /*!
+     * Set the configuration for a role of internal threads.
+     * Only threads started after this call are affected.
+     * \param role the thread role
+     * \param config the configuration for this role
+     */
+    UHD_API void set_thread_config(const std::string &role, const thread_config_t &config);
+
+    /*!
+     * Set the configuration of thread roles from device arguments.
+     * For each role, the keys are:
+     *  - thread_<role>_cpus: the CPUs, separated by colons, like "2:3"
+     *  - thread_<role>_sched: "other", "rr" or "fifo"
+     *  - thread_<role>_prio: the priority, see set_thread_priority()
+     *  - thread_<role>_mmcss: the MMCSS task, see set_thread_mmcss()
+     *
+     * The arguments given to uhd::device::make() are applied this way.
+     * \param args the device arguments
+     * \throw uhd::value_error on an invalid value
+     */
+    UHD_API void set_thread_config(const device_addr_t &args);
+
+    /*!
+     * Get the configuration for a role of internal threads.
+     * \param role the thread role
+     * \return the configuration, the default one when none was set
+     */
+    UHD_API thread_config_t get_thread_config(const std::string &role);
+
+    //! Called when an internal thread starts, with the role of the thread
+    typedef boost::function<void(const std::string &role)> thread_start_hook_t;
+
+    /*!
+     * Set a function to be called in each internal thread when it starts,
+     * after its configuration was applied. Applications can use it
+     * for placement policies that a thread_config_t can't express.
+     * \param hook the function to call, an empty function to remove it
+     */
+    UHD_API void set_thread_start_hook(const thread_start_hook_t &hook);
+
+    /*!
+     * Apply the name, configuration and start hook for a role to the
+     * current thread. Every thread started by UHD calls this first.
+     * Failures are reported as warnings and never thrown.
+     * \param role the thread role
+     */
+    UHD_API void setup_thread(const std::string &role);
+
 } //namespace uhd
 
 #endif /* INCLUDED_UHD_UTILS_THREAD_PRIORITY_HPP */
@@ -0,0 +1,133 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_UTILS_TRACE_HPP
+#define INCLUDED_UHD_UTILS_TRACE_HPP
+
+#include <uhd/config.hpp>
+#include <boost/utility.hpp>
+#include <stdint.h>
+#include <string>
+
+/*! \file trace.hpp
+ * Tracepoints in the streaming and control hot paths.
+ *
+ * The tracepoints are always compiled in. While tracing is disabled,
+ * each one costs a single check. While it is enabled, events are
+ * time-stamped into a ring buffer of the calling thread, without locking,
+ * and the oldest events are overwritten when a ring is full.
+ *
+ * The rings can be written as a Chrome trace (JSON), which can be opened
+ * in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Setting the environment variable UHD_TRACE_FILE to a path enables
+ * tracing when the library is loaded, and writes the trace to that path
+ * when the process exits.
+ */
+
+namespace uhd{ namespace trace{
+
+    //! The tracepoints
+    enum point_t{
+        POINT_RECV_BUFF_GET = 0,
+        POINT_RECV_BUFF_RELEASE,
+        POINT_SEND_BUFF_GET,
+        POINT_SEND_BUFF_COMMIT,
+        POINT_HDR_UNPACK,
+        POINT_RECV_ALIGN,
+        POINT_RECV_CONVERT,
+        POINT_SEND_CONVERT,
+        POINT_FC_SEND,
+        POINT_FC_RECV,
+        POINT_TIMED_CMD,
+        NUM_POINTS
+    };
+
+    //! The kinds of trace events, the values match the Chrome trace phases
+    enum phase_t{
+        PHASE_BEGIN = 'B',
+        PHASE_END = 'E',
+        PHASE_INSTANT = 'i'
+    };
+
+    //! Is tracing enabled?
+    UHD_API bool is_enabled(void);
+
+    //! Enable or disable tracing for all threads
+    UHD_API void set_enabled(const bool enb);
+
+    /*!
+     * Record an event into the ring of the calling thread.
+     * Use the UHD_TRACE macros, which skip this call while disabled.
+     * \param point the tracepoint
+     * \param phase the kind of event
+     * \param arg a value to show with the event, like a channel or count
+     */
+    UHD_API void record(const point_t point, const phase_t phase, const uint64_t arg = 0);
+
+    //! Discard all recorded events
+    UHD_API void clear(void);
+
+    /*!
+     * Write the recorded events of all threads as a Chrome trace.
+     * Threads that are still tracing may tear a few of their events,
+     * so disable tracing or stop streaming first.
+     * \param path the path of the JSON file
+     * \throw uhd::io_error when the file can't be written
+     */
+    UHD_API void write_chrome_trace(const std::string &path);
+
+    //! Records a begin event on construction and the end event on destruction
+    class scoped_event : boost::noncopyable{
+    public:
+        scoped_event(const point_t point, const uint64_t arg):
+            _point(point), _arg(arg), _active(is_enabled())
+        {
+            if (_active) record(_point, PHASE_BEGIN, _arg);
+        }
+
+        ~scoped_event(void){
+            if (_active) record(_point, PHASE_END, _arg);
+        }
+
+    private:
+        const point_t _point;
+        const uint64_t _arg;
+        const bool _active;
+    };
+
+}} //namespace uhd::trace
+
+#define _UHD_TRACE_CONCAT2(a, b) a##b
+#define _UHD_TRACE_CONCAT(a, b) _UHD_TRACE_CONCAT2(a, b)
+
+/*!
+ * Trace the duration of the enclosing scope.
+ * Usage: UHD_TRACE_SCOPE(POINT_RECV_CONVERT, channel);
+ */
+#define UHD_TRACE_SCOPE(point, arg) \
+    uhd::trace::scoped_event _UHD_TRACE_CONCAT(_uhd_trace_scope_, __LINE__)(uhd::trace::point, arg)
+
+/*!
+ * Trace a single point in time.
+ * Usage: UHD_TRACE_INSTANT(POINT_FC_SEND, packet_count);
+ */
+#define UHD_TRACE_INSTANT(point, arg) \
+    if (not uhd::trace::is_enabled()) {} else \
+    uhd::trace::record(uhd::trace::point, uhd::trace::PHASE_INSTANT, arg)
+
+#endif /* INCLUDED_UHD_UTILS_TRACE_HPP */
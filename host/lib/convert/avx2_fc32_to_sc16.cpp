@@ -0,0 +1,68 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_avx_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+
+using namespace uhd::convert;
+
+template <xtox_t to_wire>
+static UHD_TARGET_AVX2 void avx2_fc32_to_item32_sc16(
+    const fc32_t *input, item32_t *output, const size_t nsamps,
+    const double scale_factor, const __m128i ctrl128
+){
+    const __m256 scalar = _mm256_set1_ps(float(scale_factor));
+    const __m256i ctrl = _mm256_broadcastsi128_si256(ctrl128);
+
+    size_t i = 0;
+    for (; i+7 < nsamps; i+=8){
+        /* load from input */
+        __m256 tmplo = _mm256_loadu_ps(reinterpret_cast<const float *>(input+i+0));
+        __m256 tmphi = _mm256_loadu_ps(reinterpret_cast<const float *>(input+i+4));
+
+        /* convert and scale */
+        __m256i tmpilo = _mm256_cvtps_epi32(_mm256_mul_ps(tmplo, scalar));
+        __m256i tmpihi = _mm256_cvtps_epi32(_mm256_mul_ps(tmphi, scalar));
+
+        /* pack (works per 128-bit lane, so restore the order) + put I/Q into wire order */
+        __m256i tmpi = _mm256_packs_epi32(tmpilo, tmpihi);
+        tmpi = _mm256_permute4x64_epi64(tmpi, _MM_SHUFFLE(3, 1, 2, 0));
+        tmpi = _mm256_shuffle_epi8(tmpi, ctrl);
+
+        /* store to output */
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output+i), tmpi);
+    }
+
+    // convert any remaining samples
+    xx_to_item32_sc16<to_wire>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+DECLARE_CONVERTER_IF(fc32, 1, sc16_item32_le, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    avx2_fc32_to_item32_sc16<uhd::htowx>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_nswap_ctrl()
+    );
+}
+
+DECLARE_CONVERTER_IF(fc32, 1, sc16_item32_be, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    avx2_fc32_to_item32_sc16<uhd::htonx>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_bswap_ctrl()
+    );
+}
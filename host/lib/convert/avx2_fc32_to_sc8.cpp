@@ -0,0 +1,76 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_avx_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+
+using namespace uhd::convert;
+
+template <xtox_t to_wire>
+static UHD_TARGET_AVX2 void avx2_fc32_to_item32_sc8(
+    const fc32_t *input, item32_t *output, const size_t nsamps,
+    const double scale_factor, const bool wire_le
+){
+    const __m256 scalar = _mm256_set1_ps(float(scale_factor));
+    const __m256i ctrl = _mm256_broadcastsi128_si256(sc8_item32_nswap_ctrl());
+    const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    size_t i = 0;
+    for (; i+15 < nsamps; i+=16){
+        /* load from input */
+        __m256 tmp0 = _mm256_loadu_ps(reinterpret_cast<const float *>(input+i+0));
+        __m256 tmp1 = _mm256_loadu_ps(reinterpret_cast<const float *>(input+i+4));
+        __m256 tmp2 = _mm256_loadu_ps(reinterpret_cast<const float *>(input+i+8));
+        __m256 tmp3 = _mm256_loadu_ps(reinterpret_cast<const float *>(input+i+12));
+
+        /* convert and scale */
+        __m256i tmpi0 = _mm256_cvtps_epi32(_mm256_mul_ps(tmp0, scalar));
+        __m256i tmpi1 = _mm256_cvtps_epi32(_mm256_mul_ps(tmp1, scalar));
+        __m256i tmpi2 = _mm256_cvtps_epi32(_mm256_mul_ps(tmp2, scalar));
+        __m256i tmpi3 = _mm256_cvtps_epi32(_mm256_mul_ps(tmp3, scalar));
+
+        /* pack (works per 128-bit lane, so restore the order) + put I/Q into wire order */
+        __m256i tmpi = _mm256_packs_epi16(
+            _mm256_packs_epi32(tmpi0, tmpi1),
+            _mm256_packs_epi32(tmpi2, tmpi3)
+        );
+        tmpi = _mm256_permutevar8x32_epi32(tmpi, perm);
+        if (wire_le) tmpi = _mm256_shuffle_epi8(tmpi, ctrl);
+
+        /* store to output */
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output+i/2), tmpi);
+    }
+
+    //convert remainder
+    xx_to_item32_sc8<to_wire>(input+i, output+i/2, nsamps-i, scale_factor);
+}
+
+DECLARE_CONVERTER_IF(fc32, 1, sc8_item32_le, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    avx2_fc32_to_item32_sc8<uhd::htowx>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor, true
+    );
+}
+
+DECLARE_CONVERTER_IF(fc32, 1, sc8_item32_be, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    avx2_fc32_to_item32_sc8<uhd::htonx>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor, false
+    );
+}
@@ -0,0 +1,115 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_sc12.hpp"
+#include <immintrin.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Load 8 samples as 12 bit numbers in the lower bits of 16-bit lanes
+ **********************************************************************/
+static UHD_INLINE UHD_TARGET_AVX2 __m256i avx2_sc12_load(
+    const std::complex<float> *input, const __m256 scalar
+){
+    //convert, scale, truncate and mask like the generic converter
+    const __m256i mask = _mm256_set1_epi32(0xfff);
+    const __m256 lo = _mm256_loadu_ps(reinterpret_cast<const float *>(input+0));
+    const __m256 hi = _mm256_loadu_ps(reinterpret_cast<const float *>(input+4));
+    const __m256i lo_i = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_mul_ps(lo, scalar)), mask);
+    const __m256i hi_i = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_mul_ps(hi, scalar)), mask);
+    //pack works per 128-bit lane, so restore the order
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo_i, hi_i), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+static UHD_INLINE UHD_TARGET_AVX2 __m256i avx2_sc12_load(
+    const std::complex<int16_t> *input, const __m256
+){
+    //keep the upper 12 bits
+    return _mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(input)), 4);
+}
+
+template <typename type, towire32_type towire>
+struct convert_star_1_to_sc12_item32_1_avx2 : public convert_star_1_to_sc12_item32_1<type, towire>
+{
+    convert_star_1_to_sc12_item32_1_avx2(const bool wire_le)
+    {
+        sc12_pack_shuffle_ctrls(wire_le, _ctrl_a, _ctrl_b);
+    }
+
+    UHD_TARGET_AVX2 size_t convert_blocks(const std::complex<type> *input, item32_sc12_3x *output, const size_t nblocks)
+    {
+        const __m256i ctrl_a = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(_ctrl_a)));
+        const __m256i ctrl_b = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(_ctrl_b)));
+        const __m256i mult = _mm256_set_epi16(1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16); //I << 4
+        const __m256 scalar = _mm256_set1_ps(float(this->_scalar));
+
+        //one block per lane, the stores write 4 bytes into the next block
+        size_t b = 0;
+        for (; b+2 < nblocks; b+=2)
+        {
+            __m256i v = _mm256_mullo_epi16(avx2_sc12_load(input+4*b, scalar), mult);
+            v = _mm256_or_si256(_mm256_shuffle_epi8(v, ctrl_a), _mm256_shuffle_epi8(v, ctrl_b));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output+b+0), _mm256_castsi256_si128(v));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output+b+1), _mm256_extracti128_si256(v, 1));
+        }
+        return b;
+    }
+
+    uint8_t _ctrl_a[16], _ctrl_b[16];
+};
+
+static converter::sptr make_convert_fc32_1_to_sc12_item32_le_1_avx2(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_avx2<float, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_fc32_1_to_sc12_item32_be_1_avx2(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_avx2<float, uhd::ntohx>(false));
+}
+
+static converter::sptr make_convert_sc16_1_to_sc12_item32_le_1_avx2(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_avx2<int16_t, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc16_1_to_sc12_item32_be_1_avx2(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_avx2<int16_t, uhd::ntohx>(false));
+}
+
+UHD_STATIC_BLOCK(register_convert_pack_sc12_avx2)
+{
+    if (not cpu_has_avx2()) return;
+
+    uhd::convert::id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    id.input_format = "fc32";
+    id.output_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_fc32_1_to_sc12_item32_le_1_avx2, PRIORITY_SIMD_AVX2, "avx2", "avx2");
+    id.output_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_fc32_1_to_sc12_item32_be_1_avx2, PRIORITY_SIMD_AVX2, "avx2", "avx2");
+
+    id.input_format = "sc16";
+    id.output_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc16_1_to_sc12_item32_le_1_avx2, PRIORITY_SIMD_AVX2, "avx2", "avx2");
+    id.output_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc16_1_to_sc12_item32_be_1_avx2, PRIORITY_SIMD_AVX2, "avx2", "avx2");
+}
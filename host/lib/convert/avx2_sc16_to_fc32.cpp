@@ -0,0 +1,128 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_avx_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+
+using namespace uhd::convert;
+
+template <xtox_t to_host>
+static UHD_TARGET_AVX2 void avx2_item32_sc16_to_fc32(
+    const item32_t *input, fc32_t *output, const size_t nsamps,
+    const double scale_factor, const __m128i ctrl128
+){
+    const __m256 scalar = _mm256_set1_ps(float(scale_factor));
+    const __m256i ctrl = _mm256_broadcastsi128_si256(ctrl128);
+
+    // unaligned access is as fast as aligned access on aligned data with AVX,
+    // so there is no need to dispatch on alignment like the SSE2 converters
+    size_t i = 0;
+    for (; i+7 < nsamps; i+=8){
+        /* load from input + put I/Q into host order */
+        __m256i tmpi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input+i));
+        tmpi = _mm256_shuffle_epi8(tmpi, ctrl);
+
+        /* sign extend, convert and scale */
+        __m256i tmpilo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(tmpi));
+        __m256i tmpihi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(tmpi, 1));
+        __m256 tmplo = _mm256_mul_ps(_mm256_cvtepi32_ps(tmpilo), scalar);
+        __m256 tmphi = _mm256_mul_ps(_mm256_cvtepi32_ps(tmpihi), scalar);
+
+        /* store to output */
+        _mm256_storeu_ps(reinterpret_cast<float *>(output+i+0), tmplo);
+        _mm256_storeu_ps(reinterpret_cast<float *>(output+i+4), tmphi);
+    }
+
+    // convert any remaining samples
+    item32_sc16_to_xx<to_host>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+//! Same as above with a complex gain and offset, see the SSE2 version
+template <xtox_t to_host>
+static UHD_TARGET_AVX2 void avx2_item32_sc16_to_fc32_corrected(
+    const item32_t *input, fc32_t *output, const size_t nsamps,
+    const double scale_factor, const std::complex<double> &gain,
+    const std::complex<double> &offset, const __m128i ctrl128
+){
+    const float gain_re = float(gain.real()*scale_factor);
+    const float gain_im = float(gain.imag()*scale_factor);
+    const float offset_re = float(offset.real());
+    const float offset_im = float(offset.imag());
+    const __m256 gainre = _mm256_set1_ps(gain_re);
+    const __m256 gainim = _mm256_set_ps(gain_im, -gain_im, gain_im, -gain_im, gain_im, -gain_im, gain_im, -gain_im);
+    const __m256 offs = _mm256_set_ps(
+        offset_im, offset_re, offset_im, offset_re,
+        offset_im, offset_re, offset_im, offset_re
+    );
+    const __m256i ctrl = _mm256_broadcastsi128_si256(ctrl128);
+
+    size_t i = 0;
+    for (; i+7 < nsamps; i+=8){
+        /* load from input + put I/Q into host order */
+        __m256i tmpi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input+i));
+        tmpi = _mm256_shuffle_epi8(tmpi, ctrl);
+
+        /* sign extend and convert */
+        __m256 tmplo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(tmpi)));
+        __m256 tmphi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(tmpi, 1)));
+
+        /* complex multiply and offset */
+        tmplo = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tmplo, gainre), offs),
+            _mm256_mul_ps(_mm256_permute_ps(tmplo, _MM_SHUFFLE(2, 3, 0, 1)), gainim));
+        tmphi = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tmphi, gainre), offs),
+            _mm256_mul_ps(_mm256_permute_ps(tmphi, _MM_SHUFFLE(2, 3, 0, 1)), gainim));
+
+        /* store to output */
+        _mm256_storeu_ps(reinterpret_cast<float *>(output+i+0), tmplo);
+        _mm256_storeu_ps(reinterpret_cast<float *>(output+i+4), tmphi);
+    }
+
+    // convert any remaining samples
+    item32_sc16_to_fc32_corrected<to_host>(input+i, output+i, nsamps-i, scale_factor, gain, offset);
+}
+
+DECLARE_CORRECTING_CONVERTER_IF(sc16_item32_le, 1, fc32, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    if (has_correction()){
+        avx2_item32_sc16_to_fc32_corrected<uhd::htowx>(
+            reinterpret_cast<const item32_t *>(inputs[0]),
+            reinterpret_cast<fc32_t *>(outputs[0]),
+            nsamps, scale_factor, gain, offset, sc16_item32_nswap_ctrl()
+        );
+        return;
+    }
+    avx2_item32_sc16_to_fc32<uhd::htowx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc32_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_nswap_ctrl()
+    );
+}
+
+DECLARE_CORRECTING_CONVERTER_IF(sc16_item32_be, 1, fc32, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    if (has_correction()){
+        avx2_item32_sc16_to_fc32_corrected<uhd::htonx>(
+            reinterpret_cast<const item32_t *>(inputs[0]),
+            reinterpret_cast<fc32_t *>(outputs[0]),
+            nsamps, scale_factor, gain, offset, sc16_item32_bswap_ctrl()
+        );
+        return;
+    }
+    avx2_item32_sc16_to_fc32<uhd::htonx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc32_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_bswap_ctrl()
+    );
+}
@@ -0,0 +1,64 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_avx_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+
+using namespace uhd::convert;
+
+template <xtox_t to_host>
+static UHD_TARGET_AVX2 void avx2_item32_sc16_to_fc64(
+    const item32_t *input, fc64_t *output, const size_t nsamps,
+    const double scale_factor, const __m128i ctrl
+){
+    const __m256d scalar = _mm256_set1_pd(scale_factor);
+
+    size_t i = 0;
+    for (; i+3 < nsamps; i+=4){
+        /* load from input + put I/Q into host order */
+        __m128i tmpi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i));
+        tmpi = _mm_shuffle_epi8(tmpi, ctrl);
+
+        /* sign extend, convert and scale */
+        __m256i tmpi32 = _mm256_cvtepi16_epi32(tmpi);
+        __m256d tmplo = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(tmpi32)), scalar);
+        __m256d tmphi = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(tmpi32, 1)), scalar);
+
+        /* store to output */
+        _mm256_storeu_pd(reinterpret_cast<double *>(output+i+0), tmplo);
+        _mm256_storeu_pd(reinterpret_cast<double *>(output+i+2), tmphi);
+    }
+
+    //convert remainder
+    item32_sc16_to_xx<to_host>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+DECLARE_CONVERTER_IF(sc16_item32_le, 1, fc64, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    avx2_item32_sc16_to_fc64<uhd::htowx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc64_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_nswap_ctrl()
+    );
+}
+
+DECLARE_CONVERTER_IF(sc16_item32_be, 1, fc64, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    avx2_item32_sc16_to_fc64<uhd::htonx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc64_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_bswap_ctrl()
+    );
+}
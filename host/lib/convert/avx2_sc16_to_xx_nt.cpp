@@ -0,0 +1,117 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_avx_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <algorithm>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * The AVX2 RX converters with streaming stores, see the SSE2 versions.
+ **********************************************************************/
+template <xtox_t to_host>
+static UHD_TARGET_AVX2 void avx2_item32_sc16_to_fc32_nt(
+    const item32_t *input, fc32_t *output, const size_t nsamps,
+    const double scale_factor, const __m128i ctrl128
+){
+    const __m256 scalar = _mm256_set1_ps(float(scale_factor));
+    const __m256i ctrl = _mm256_broadcastsi128_si256(ctrl128);
+
+    size_t i = 0;
+    if ((size_t(output) & 0x7) != 0) i = nsamps;
+    else i = std::min<size_t>(((32 - (size_t(output) & 0x1f)) & 0x1f)/8, nsamps);
+    item32_sc16_to_xx<to_host>(input, output, i, scale_factor);
+
+    for (; i+7 < nsamps; i+=8){
+        /* load from input + put I/Q into host order */
+        __m256i tmpi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input+i));
+        tmpi = _mm256_shuffle_epi8(tmpi, ctrl);
+
+        /* sign extend, convert and scale */
+        __m256i tmpilo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(tmpi));
+        __m256i tmpihi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(tmpi, 1));
+        __m256 tmplo = _mm256_mul_ps(_mm256_cvtepi32_ps(tmpilo), scalar);
+        __m256 tmphi = _mm256_mul_ps(_mm256_cvtepi32_ps(tmpihi), scalar);
+
+        /* stream to output */
+        _mm256_stream_ps(reinterpret_cast<float *>(output+i+0), tmplo);
+        _mm256_stream_ps(reinterpret_cast<float *>(output+i+4), tmphi);
+    }
+    _mm_sfence();
+
+    // convert any remaining samples
+    item32_sc16_to_xx<to_host>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+template <xtox_t to_host>
+static UHD_TARGET_AVX2 void avx2_item32_sc16_to_sc16_nt(
+    const item32_t *input, sc16_t *output, const size_t nsamps,
+    const __m128i ctrl128
+){
+    const __m256i ctrl = _mm256_broadcastsi128_si256(ctrl128);
+
+    size_t i = 0;
+    if ((size_t(output) & 0x3) != 0) i = nsamps;
+    else i = std::min<size_t>(((32 - (size_t(output) & 0x1f)) & 0x1f)/4, nsamps);
+    item32_sc16_to_xx<to_host>(input, output, i, 1.0);
+
+    for (; i+7 < nsamps; i+=8){
+        /* load from input + put I/Q into host order */
+        __m256i tmpi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input+i));
+        tmpi = _mm256_shuffle_epi8(tmpi, ctrl);
+
+        /* stream to output */
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(output+i), tmpi);
+    }
+    _mm_sfence();
+
+    // convert any remaining samples
+    item32_sc16_to_xx<to_host>(input+i, output+i, nsamps-i, 1.0);
+}
+
+DECLARE_CONVERTER_IF(sc16_item32_le, 1, fc32, 1, PRIORITY_SIMD_AVX2_NT, cpu_has_avx2()){
+    avx2_item32_sc16_to_fc32_nt<uhd::wtohx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc32_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_nswap_ctrl()
+    );
+}
+
+DECLARE_CONVERTER_IF(sc16_item32_be, 1, fc32, 1, PRIORITY_SIMD_AVX2_NT, cpu_has_avx2()){
+    avx2_item32_sc16_to_fc32_nt<uhd::ntohx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc32_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_bswap_ctrl()
+    );
+}
+
+DECLARE_CONVERTER_IF(sc16_item32_le, 1, sc16, 1, PRIORITY_SIMD_AVX2_NT, cpu_has_avx2()){
+    avx2_item32_sc16_to_sc16_nt<uhd::wtohx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<sc16_t *>(outputs[0]),
+        nsamps, sc16_item32_nswap_ctrl()
+    );
+}
+
+DECLARE_CONVERTER_IF(sc16_item32_be, 1, sc16, 1, PRIORITY_SIMD_AVX2_NT, cpu_has_avx2()){
+    avx2_item32_sc16_to_sc16_nt<uhd::ntohx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<sc16_t *>(outputs[0]),
+        nsamps, sc16_item32_bswap_ctrl()
+    );
+}
@@ -0,0 +1,75 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_avx_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+
+using namespace uhd::convert;
+
+template <xtox_t to_host>
+static UHD_TARGET_AVX2 void avx2_item32_sc8_to_fc64(
+    const void *in, fc64_t *output, const size_t nsamps,
+    const double scale_factor, const bool wire_le
+){
+    const item32_t *input = reinterpret_cast<const item32_t *>(size_t(in) & ~0x3);
+    const __m256d scalar = _mm256_set1_pd(scale_factor);
+    const __m128i ctrl = sc8_item32_nswap_ctrl();
+
+    size_t num_samps = nsamps;
+    if ((size_t(in) & 0x3) != 0){
+        item32_sc8_to_xx<to_host>(input++, output++, 1, scale_factor);
+        num_samps--;
+    }
+
+    size_t i = 0;
+    for (; i+7 < num_samps; i+=8){
+        /* load from input + put I/Q into host order */
+        __m128i tmpi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i/2));
+        if (wire_le) tmpi = _mm_shuffle_epi8(tmpi, ctrl);
+
+        /* sign extend, convert and scale */
+        const __m256i tmpilo = _mm256_cvtepi8_epi32(tmpi);
+        const __m256i tmpihi = _mm256_cvtepi8_epi32(_mm_srli_si128(tmpi, 8));
+        __m256d tmp0 = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(tmpilo)), scalar);
+        __m256d tmp1 = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(tmpilo, 1)), scalar);
+        __m256d tmp2 = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(tmpihi)), scalar);
+        __m256d tmp3 = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(tmpihi, 1)), scalar);
+
+        /* store to output */
+        _mm256_storeu_pd(reinterpret_cast<double *>(output+i+0), tmp0);
+        _mm256_storeu_pd(reinterpret_cast<double *>(output+i+2), tmp1);
+        _mm256_storeu_pd(reinterpret_cast<double *>(output+i+4), tmp2);
+        _mm256_storeu_pd(reinterpret_cast<double *>(output+i+6), tmp3);
+    }
+
+    //convert remainder
+    item32_sc8_to_xx<to_host>(input+i/2, output+i, num_samps-i, scale_factor);
+}
+
+DECLARE_CONVERTER_IF(sc8_item32_le, 1, fc64, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    avx2_item32_sc8_to_fc64<uhd::wtohx>(
+        inputs[0], reinterpret_cast<fc64_t *>(outputs[0]),
+        nsamps, scale_factor, true
+    );
+}
+
+DECLARE_CONVERTER_IF(sc8_item32_be, 1, fc64, 1, PRIORITY_SIMD_AVX2, cpu_has_avx2()){
+    avx2_item32_sc8_to_fc64<uhd::ntohx>(
+        inputs[0], reinterpret_cast<fc64_t *>(outputs[0]),
+        nsamps, scale_factor, false
+    );
+}
@@ -0,0 +1,113 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_sc12.hpp"
+#include <immintrin.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Store two 3 line blocks worth of unpacked 16-bit lanes
+ **********************************************************************/
+static UHD_INLINE UHD_TARGET_AVX2 void avx2_sc12_store(
+    const __m256i v, std::complex<float> *output, const __m256 scalar
+){
+    //sign extend into 32 bits, convert and scale
+    const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v));
+    const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1));
+    _mm256_storeu_ps(reinterpret_cast<float *>(output+0), _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scalar));
+    _mm256_storeu_ps(reinterpret_cast<float *>(output+4), _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scalar));
+}
+
+static UHD_INLINE UHD_TARGET_AVX2 void avx2_sc12_store(
+    const __m256i v, std::complex<int16_t> *output, const __m256
+){
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output), v);
+}
+
+template <typename type, tohost32_type tohost>
+struct convert_sc12_item32_1_to_star_1_avx2 : public convert_sc12_item32_1_to_star_1<type, tohost>
+{
+    convert_sc12_item32_1_to_star_1_avx2(const bool wire_le)
+    {
+        sc12_unpack_shuffle_ctrl(wire_le, _ctrl);
+    }
+
+    UHD_TARGET_AVX2 size_t convert_blocks(const item32_sc12_3x *input, std::complex<type> *output, const size_t nblocks)
+    {
+        const __m256i ctrl = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(_ctrl)));
+        const __m256i mult = _mm256_set_epi16(16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1); //Q << 4
+        const __m256i mask = _mm256_set1_epi16(short(0xfff0));
+        const __m256 scalar = _mm256_set1_ps(float(this->_scalar));
+
+        //one block per lane, the loads read 4 bytes into the next block
+        size_t b = 0;
+        for (; b+2 < nblocks; b+=2)
+        {
+            __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+b+0))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+b+1)), 1);
+            v = _mm256_shuffle_epi8(v, ctrl);
+            v = _mm256_and_si256(_mm256_mullo_epi16(v, mult), mask);
+            avx2_sc12_store(v, output+4*b, scalar);
+        }
+        return b;
+    }
+
+    uint8_t _ctrl[16];
+};
+
+static converter::sptr make_convert_sc12_item32_le_1_to_fc32_1_avx2(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_avx2<float, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc12_item32_be_1_to_fc32_1_avx2(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_avx2<float, uhd::ntohx>(false));
+}
+
+static converter::sptr make_convert_sc12_item32_le_1_to_sc16_1_avx2(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_avx2<int16_t, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc12_item32_be_1_to_sc16_1_avx2(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_avx2<int16_t, uhd::ntohx>(false));
+}
+
+UHD_STATIC_BLOCK(register_convert_unpack_sc12_avx2)
+{
+    if (not cpu_has_avx2()) return;
+
+    uhd::convert::id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    id.output_format = "fc32";
+    id.input_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_le_1_to_fc32_1_avx2, PRIORITY_SIMD_AVX2, "avx2", "avx2");
+    id.input_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_be_1_to_fc32_1_avx2, PRIORITY_SIMD_AVX2, "avx2", "avx2");
+
+    id.output_format = "sc16";
+    id.input_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_le_1_to_sc16_1_avx2, PRIORITY_SIMD_AVX2, "avx2", "avx2");
+    id.input_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_be_1_to_sc16_1_avx2, PRIORITY_SIMD_AVX2, "avx2", "avx2");
+}
@@ -0,0 +1,69 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_avx_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+
+using namespace uhd::convert;
+
+UHD_AVX512_KERNELS_BEGIN
+
+template <xtox_t to_host>
+static UHD_TARGET_AVX512 void avx512_item32_sc16_to_fc64(
+    const item32_t *input, fc64_t *output, const size_t nsamps,
+    const double scale_factor, const __m128i ctrl128
+){
+    const __m512d scalar = _mm512_set1_pd(scale_factor);
+    const __m256i ctrl = _mm256_broadcastsi128_si256(ctrl128);
+
+    size_t i = 0;
+    for (; i+7 < nsamps; i+=8){
+        /* load from input + put I/Q into host order */
+        __m256i tmpi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input+i));
+        tmpi = _mm256_shuffle_epi8(tmpi, ctrl);
+
+        /* sign extend, convert and scale */
+        __m512i tmpi32 = _mm512_cvtepi16_epi32(tmpi);
+        __m512d tmplo = _mm512_mul_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(tmpi32)), scalar);
+        __m512d tmphi = _mm512_mul_pd(_mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(tmpi32, 1)), scalar);
+
+        /* store to output */
+        _mm512_storeu_pd(reinterpret_cast<double *>(output+i+0), tmplo);
+        _mm512_storeu_pd(reinterpret_cast<double *>(output+i+4), tmphi);
+    }
+
+    //convert remainder
+    item32_sc16_to_xx<to_host>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+UHD_AVX512_KERNELS_END
+
+DECLARE_CONVERTER_IF(sc16_item32_le, 1, fc64, 1, PRIORITY_SIMD_AVX512, cpu_has_avx512()){
+    avx512_item32_sc16_to_fc64<uhd::htowx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc64_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_nswap_ctrl()
+    );
+}
+
+DECLARE_CONVERTER_IF(sc16_item32_be, 1, fc64, 1, PRIORITY_SIMD_AVX512, cpu_has_avx512()){
+    avx512_item32_sc16_to_fc64<uhd::htonx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc64_t *>(outputs[0]),
+        nsamps, scale_factor, sc16_item32_bswap_ctrl()
+    );
+}
@@ -0,0 +1,52 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_CONVERT_AVX_COMMON_HPP
+#define INCLUDED_LIBUHD_CONVERT_AVX_COMMON_HPP
+
+#include "convert_common.hpp"
+#include <immintrin.h>
+
+/***********************************************************************
+ * Byte shuffle controls between item32 sc16 and host sc16 order.
+ *
+ * Both are their own inverse, so they work for either direction:
+ * - nswap: swap the 16-bit halves of each item32 (little endian wire)
+ * - bswap: byteswap each 16-bit word (big endian wire)
+ *
+ * The controls only cover one 128-bit lane, because that is what
+ * pshufb operates on; broadcast them for the 256 and 512-bit versions.
+ **********************************************************************/
+static UHD_INLINE __m128i sc16_item32_nswap_ctrl(void){
+    return _mm_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+}
+
+static UHD_INLINE __m128i sc16_item32_bswap_ctrl(void){
+    return _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+}
+
+/***********************************************************************
+ * Byte shuffle control between item32 sc8 and host sc8 order.
+ *
+ * A big endian item32 already holds the two samples in host order,
+ * so only the little endian wire needs to reverse each item32.
+ **********************************************************************/
+static UHD_INLINE __m128i sc8_item32_nswap_ctrl(void){
+    return _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+}
+
+#endif /* INCLUDED_LIBUHD_CONVERT_AVX_COMMON_HPP */
@@ -0,0 +1,42 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+
+/***********************************************************************
+ * The helpers of the declare macros, which the SIMD sources share with
+ * the other converters. Keep this file free of any ISA flags.
+ **********************************************************************/
+void correcting_converter::set_correction(
+    const std::complex<double> &g, const std::complex<double> &o
+){
+    gain = g;
+    offset = o;
+}
+
+void register_declared_converter(
+    const char *input_format, const size_t num_inputs,
+    const char *output_format, const size_t num_outputs,
+    const uhd::convert::function_type &fcn, const int prio
+){
+    uhd::convert::id_type id;
+    id.input_format = input_format;
+    id.num_inputs = num_inputs;
+    id.output_format = output_format;
+    id.num_outputs = num_outputs;
+    uhd::convert::register_converter(id, fcn, prio, prio_to_name(prio), prio_to_isa(prio));
+}
@@ -22,26 +22,29 @@
 #include <uhd/utils/static.hpp>
 #include <stdint.h>
 #include <complex>
+#include <string>
 
-#define _DECLARE_CONVERTER(name, in_form, num_in, out_form, num_out, prio) \
-    struct name : public uhd::convert::converter{ \
+#define _DECLARE_CONVERTER_BASE_IF(name, base, in_form, num_in, out_form, num_out, prio, cond) \
+    struct name : public base{ \
         static sptr make(void){return sptr(new name());} \
         double scale_factor; \
         void set_scalar(const double s){scale_factor = s;} \
         void operator()(const input_type&, const output_type&, const size_t); \
     }; \
     UHD_STATIC_BLOCK(__register_##name##_##prio){ \
-        uhd::convert::id_type id; \
-        id.input_format = #in_form; \
-        id.num_inputs = num_in; \
-        id.output_format = #out_form; \
-        id.num_outputs = num_out; \
-        uhd::convert::register_converter(id, &name::make, prio); \
+        if (not (cond)) return; \
+        register_declared_converter(#in_form, num_in, #out_form, num_out, &name::make, prio); \
     } \
     void name::operator()( \
         const input_type &inputs, const output_type &outputs, const size_t nsamps \
     )
 
+#define _DECLARE_CONVERTER_IF(name, in_form, num_in, out_form, num_out, prio, cond) \
+    _DECLARE_CONVERTER_BASE_IF(name, uhd::convert::converter, in_form, num_in, out_form, num_out, prio, cond)
+
+#define _DECLARE_CONVERTER(name, in_form, num_in, out_form, num_out, prio) \
+    _DECLARE_CONVERTER_IF(name, in_form, num_in, out_form, num_out, prio, true)
+
 /*! Convenience macro to declare a single-function converter
  *
  * Most converters consist of a single for loop, and can make use of
@@ -58,13 +61,48 @@
 #define DECLARE_CONVERTER(in_form, num_in, out_form, num_out, prio) \
     _DECLARE_CONVERTER(__convert_##in_form##_##num_in##_##out_form##_##num_out##_##prio, in_form, num_in, out_form, num_out, prio)
 
+/*! Declare a converter which is only registered when a condition holds
+ *
+ * Same as DECLARE_CONVERTER(), but the converter is only registered when
+ * `cond` evaluates to true at load time. This is used by the SIMD converters
+ * which are compiled for instruction sets the host CPU might not have
+ * (e.g. AVX2). The condition should be a runtime CPU check from below.
+ */
+#define DECLARE_CONVERTER_IF(in_form, num_in, out_form, num_out, prio, cond) \
+    _DECLARE_CONVERTER_IF(__convert_##in_form##_##num_in##_##out_form##_##num_out##_##prio, in_form, num_in, out_form, num_out, prio, cond)
+
+/*!
+ * Base of the converters which fuse a complex gain and offset into the
+ * conversion, see uhd::convert::converter::set_correction().
+ */
+struct correcting_converter : public uhd::convert::converter{
+    correcting_converter(void): gain(1.0), offset(0.0) {}
+    std::complex<double> gain, offset;
+    void set_correction(const std::complex<double> &g, const std::complex<double> &o);
+    //! True when the conversion has to apply gain and offset
+    bool has_correction(void) const{
+        return gain != 1.0 or offset != 0.0;
+    }
+};
+
+/*! Declare a converter which supports gain and offset correction
+ *
+ * Same as DECLARE_CONVERTER_IF(), but the function block additionally
+ * has access to `gain`, `offset` and `has_correction()`.
+ */
+#define DECLARE_CORRECTING_CONVERTER_IF(in_form, num_in, out_form, num_out, prio, cond) \
+    _DECLARE_CONVERTER_BASE_IF(__convert_##in_form##_##num_in##_##out_form##_##num_out##_##prio, correcting_converter, in_form, num_in, out_form, num_out, prio, cond)
+
+#define DECLARE_CORRECTING_CONVERTER(in_form, num_in, out_form, num_out, prio) \
+    DECLARE_CORRECTING_CONVERTER_IF(in_form, num_in, out_form, num_out, prio, true)
+
 /***********************************************************************
  * Setup priorities
  **********************************************************************/
 static const int PRIORITY_GENERAL = 0;
 static const int PRIORITY_EMPTY = -1;
 
-#ifdef __ARM_NEON__
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
 static const int PRIORITY_SIMD = 2;
 static const int PRIORITY_TABLE = 1; //tables require large cache, so they are slower on arm
 #else
@@ -73,6 +111,108 @@ static const int PRIORITY_SIMD = 3;
 static const int PRIORITY_TABLE = 1;
 #endif
 
+//wider SIMD kernels beat the SSE2 ones, but are only registered if the CPU has them
+static const int PRIORITY_SIMD_AVX2 = PRIORITY_SIMD + 1;
+static const int PRIORITY_SIMD_AVX512 = PRIORITY_SIMD + 2;
+
+//converters with streaming (non-temporal) stores bypass the cache,
+//they have negative priorities so they are only used when asked for
+static const int PRIORITY_SIMD_AVX2_NT = -2;
+static const int PRIORITY_SIMD_NT = -3;
+
+/*!
+ * The instruction set needed by the converters of a SIMD priority.
+ * The declare macros also use this as the converter name, so they can
+ * be selected by name, see uhd::convert::get_converter_infos().
+ */
+static UHD_INLINE std::string prio_to_isa(const int prio){
+    if (prio == PRIORITY_SIMD_AVX512) return "avx512";
+    if (prio == PRIORITY_SIMD_AVX2 or prio == PRIORITY_SIMD_AVX2_NT) return "avx2";
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+    if (prio == PRIORITY_SIMD) return "neon";
+#else
+    if (prio == PRIORITY_SIMD or prio == PRIORITY_SIMD_NT) return "sse2";
+#endif
+    return ""; //general purpose converters have default names
+}
+
+/*!
+ * The name of the converters of a priority, see prio_to_isa().
+ * The streaming store converters get a "_nt" suffix.
+ */
+static UHD_INLINE std::string prio_to_name(const int prio){
+    if (prio == PRIORITY_SIMD_AVX2_NT or prio == PRIORITY_SIMD_NT){
+        return prio_to_isa(prio) + "_nt";
+    }
+    return prio_to_isa(prio);
+}
+
+/*!
+ * Register a converter made by the declare macros above.
+ * It is defined out of line, see convert_common.cpp.
+ */
+void register_declared_converter(
+    const char *input_format, const size_t num_inputs,
+    const char *output_format, const size_t num_outputs,
+    const uhd::convert::function_type &fcn, const int prio
+);
+
+/***********************************************************************
+ * Instruction sets of the SIMD kernels
+ *
+ * The SIMD sources are compiled for the baseline instruction set, and
+ * only their kernels are compiled for the wider one with these function
+ * attributes. The inline functions a SIMD source shares with the other
+ * converters (e.g. set_correction() or the std::complex operators) are
+ * then emitted as baseline code, whichever copy the linker keeps.
+ * Kernels called from a baseline function must not be UHD_INLINE.
+ * MSVC does not need a flag for the intrinsics of wider instruction sets.
+ **********************************************************************/
+#if defined(__GNUC__) || defined(__clang__)
+    #define UHD_CONVERT_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define UHD_CONVERT_TARGET(isa)
+#endif
+#define UHD_TARGET_SSSE3 UHD_CONVERT_TARGET("ssse3")
+#define UHD_TARGET_AVX2 UHD_CONVERT_TARGET("avx2")
+#define UHD_TARGET_AVX512 UHD_CONVERT_TARGET("avx512f,avx512bw")
+#define UHD_TARGET_F16C UHD_CONVERT_TARGET("avx2,f16c")
+
+/*!
+ * Wrap the AVX-512 kernels: the intrinsics in the headers of GCC 12 pass
+ * _mm512_undefined_*() values for their unused inputs, and it warns about
+ * them once they are inlined. Nothing in the kernels is uninitialized.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+    #define UHD_AVX512_KERNELS_BEGIN \
+        _Pragma("GCC diagnostic push") \
+        _Pragma("GCC diagnostic ignored \"-Wuninitialized\"") \
+        _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+    #define UHD_AVX512_KERNELS_END _Pragma("GCC diagnostic pop")
+#else
+    #define UHD_AVX512_KERNELS_BEGIN
+    #define UHD_AVX512_KERNELS_END
+#endif
+
+/***********************************************************************
+ * Runtime CPU feature checks
+ **********************************************************************/
+namespace uhd{ namespace convert{
+
+    //! True when the host CPU supports SSSE3
+    bool cpu_has_ssse3(void);
+
+    //! True when the host CPU and OS support AVX2
+    bool cpu_has_avx2(void);
+
+    //! True when the host CPU and OS support AVX-512 F and BW
+    bool cpu_has_avx512(void);
+
+    //! True when the host CPU supports F16C, check AVX2 for the OS support
+    bool cpu_has_f16c(void);
+
+}} //namespace uhd::convert
+
 /***********************************************************************
  * Typedefs
  **********************************************************************/
@@ -157,6 +297,69 @@ UHD_INLINE void item32_sc16_to_xx(
     }
 }
 
+/***********************************************************************
+ * Convert between interleaved items32 sc16 and planar xx buffers
+ *  - item j belongs to buffer j%width, sample j/width
+ *  - start is the first sample, so SIMD code can convert the tail
+ **********************************************************************/
+template <xtox_t to_host, size_t width, typename T>
+UHD_INLINE void item32_sc16_to_xx_planar(
+    const item32_t *input,
+    std::complex<T> *const *outputs,
+    const size_t start,
+    const size_t nsamps,
+    const double scale_factor
+){
+    for (size_t i = start, j = start*width; i < nsamps; i++){
+        for (size_t w = 0; w < width; w++){
+            outputs[w][i] = item32_sc16_x1_to_xx<T>(to_host(input[j++]), scale_factor);
+        }
+    }
+}
+
+template <xtox_t to_wire, size_t width, typename T>
+UHD_INLINE void xx_planar_to_item32_sc16(
+    const std::complex<T> *const *inputs,
+    item32_t *output,
+    const size_t start,
+    const size_t nsamps,
+    const double scale_factor
+){
+    for (size_t i = start, j = start*width; i < nsamps; i++){
+        for (size_t w = 0; w < width; w++){
+            output[j++] = to_wire(xx_to_item32_sc16_x1(inputs[w][i], scale_factor));
+        }
+    }
+}
+
+/***********************************************************************
+ * Convert items32 sc16 buffer to fc32 with gain and offset correction
+ **********************************************************************/
+template <xtox_t to_host>
+UHD_INLINE void item32_sc16_to_fc32_corrected(
+    const item32_t *input,
+    fc32_t *output,
+    const size_t nsamps,
+    const double scale_factor,
+    const std::complex<double> &gain,
+    const std::complex<double> &offset
+){
+    //written out, std::complex multiplication checks for NaN and inf
+    const float gain_re = float(gain.real()*scale_factor);
+    const float gain_im = float(gain.imag()*scale_factor);
+    const float offset_re = float(offset.real());
+    const float offset_im = float(offset.imag());
+    for (size_t i = 0; i < nsamps; i++){
+        const item32_t item_i = to_host(input[i]);
+        const float re = int16_t(item_i >> 16);
+        const float im = int16_t(item_i >> 0);
+        output[i] = fc32_t(
+            re*gain_re - im*gain_im + offset_re,
+            re*gain_im + im*gain_re + offset_im
+        );
+    }
+}
+
 /***********************************************************************
  * Convert xx to items32 sc8 buffer
  **********************************************************************/
@@ -0,0 +1,101 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define HAVE_MSVC_CPUID
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define HAVE_BUILTIN_CPU_SUPPORTS
+#endif
+
+/***********************************************************************
+ * These checks are called from the static blocks which register the
+ * SIMD converters, so this file must be compiled without any ISA flags.
+ **********************************************************************/
+#ifdef HAVE_MSVC_CPUID
+static bool cpu_check_xcr0(const unsigned long long mask){
+    int regs[4];
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    if (not osxsave) return false;
+    return (_xgetbv(0) & mask) == mask;
+}
+
+static bool cpu_check_leaf7_ebx(const int bits){
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & bits) == bits;
+}
+#endif
+
+bool uhd::convert::cpu_has_ssse3(void){
+#if defined(HAVE_BUILTIN_CPU_SUPPORTS)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#elif defined(HAVE_MSVC_CPUID)
+    //SSSE3 is bit 9 of leaf 1 ECX
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 9)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool uhd::convert::cpu_has_avx2(void){
+#if defined(HAVE_BUILTIN_CPU_SUPPORTS)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(HAVE_MSVC_CPUID)
+    //XMM and YMM state enabled by the OS, AVX2 is bit 5 of leaf 7
+    return cpu_check_xcr0(0x6) and cpu_check_leaf7_ebx(1 << 5);
+#else
+    return false;
+#endif
+}
+
+bool uhd::convert::cpu_has_avx512(void){
+#if defined(HAVE_BUILTIN_CPU_SUPPORTS)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512bw");
+#elif defined(HAVE_MSVC_CPUID)
+    //opmask and ZMM state enabled by the OS, AVX-512 F is bit 16 and BW is bit 30
+    return cpu_check_xcr0(0xe6) and cpu_check_leaf7_ebx((1 << 16) | (1 << 30));
+#else
+    return false;
+#endif
+}
+
+bool uhd::convert::cpu_has_f16c(void){
+    //F16C is bit 29 of leaf 1 ECX, older compilers do not know it by name
+#if defined(HAVE_BUILTIN_CPU_SUPPORTS)
+    unsigned int eax, ebx, ecx, edx;
+    if (not __get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    return (ecx & (1 << 29)) != 0;
+#elif defined(HAVE_MSVC_CPUID)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 29)) != 0;
+#else
+    return false;
+#endif
+}
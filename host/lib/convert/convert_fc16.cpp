@@ -0,0 +1,79 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_fc16.hpp"
+#include <uhd/utils/byteswap.hpp>
+
+using namespace uhd::convert;
+
+/* Create fc16<->sc16(otw) */
+#define DECLARE_ITEM32_SC16_FC16_CONVERTER(xe, htoxx, xxtoh) \
+    DECLARE_CONVERTER(fc16, 1, sc16_item32_ ## xe, 1, PRIORITY_GENERAL){ \
+        const f16_t *input = reinterpret_cast<const f16_t *>(inputs[0]); \
+        item32_t *output = reinterpret_cast<item32_t *>(outputs[0]); \
+        fc16_to_item32_sc16<htoxx>(input, output, nsamps, scale_factor); \
+    } \
+    DECLARE_CONVERTER(sc16_item32_ ## xe, 1, fc16, 1, PRIORITY_GENERAL){ \
+        const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]); \
+        f16_t *output = reinterpret_cast<f16_t *>(outputs[0]); \
+        item32_sc16_to_fc16<xxtoh>(input, output, nsamps, scale_factor); \
+    }
+DECLARE_ITEM32_SC16_FC16_CONVERTER(be, uhd::htonx, uhd::ntohx)
+DECLARE_ITEM32_SC16_FC16_CONVERTER(le, uhd::htowx, uhd::wtohx)
+
+/* Create fc16<->sc12,sc8(otw) through the fc32 converters */
+#define DECLARE_VIA_FC32_CONVERTER(wire_type, xe) \
+    static converter::sptr make_convert_fc16_1_to_ ## wire_type ## _item32_ ## xe ## _1(void){ \
+        id_type id; \
+        id.input_format = "fc32"; \
+        id.num_inputs = 1; \
+        id.output_format = #wire_type "_item32_" #xe; \
+        id.num_outputs = 1; \
+        return converter::sptr(new convert_fc16_via_fc32(id, get_bytes_per_item(#wire_type))); \
+    } \
+    static converter::sptr make_convert_ ## wire_type ## _item32_ ## xe ## _1_to_fc16_1(void){ \
+        id_type id; \
+        id.input_format = #wire_type "_item32_" #xe; \
+        id.num_inputs = 1; \
+        id.output_format = "fc32"; \
+        id.num_outputs = 1; \
+        return converter::sptr(new convert_fc16_via_fc32(id, get_bytes_per_item(#wire_type))); \
+    }
+DECLARE_VIA_FC32_CONVERTER(sc12, le)
+DECLARE_VIA_FC32_CONVERTER(sc12, be)
+DECLARE_VIA_FC32_CONVERTER(sc8, le)
+DECLARE_VIA_FC32_CONVERTER(sc8, be)
+
+#define REGISTER_VIA_FC32_CONVERTER(wire_type, xe) \
+    id.input_format = "fc16"; \
+    id.output_format = #wire_type "_item32_" #xe; \
+    register_converter(id, &make_convert_fc16_1_to_ ## wire_type ## _item32_ ## xe ## _1, PRIORITY_GENERAL); \
+    std::swap(id.input_format, id.output_format); \
+    register_converter(id, &make_convert_ ## wire_type ## _item32_ ## xe ## _1_to_fc16_1, PRIORITY_GENERAL);
+
+UHD_STATIC_BLOCK(register_convert_fc16)
+{
+    register_bytes_per_item("fc16", 2*sizeof(f16_t));
+
+    id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+    REGISTER_VIA_FC32_CONVERTER(sc12, le)
+    REGISTER_VIA_FC32_CONVERTER(sc12, be)
+    REGISTER_VIA_FC32_CONVERTER(sc8, le)
+    REGISTER_VIA_FC32_CONVERTER(sc8, be)
+}
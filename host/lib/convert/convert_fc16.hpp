@@ -0,0 +1,212 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_CONVERT_FC16_HPP
+#define INCLUDED_LIBUHD_CONVERT_FC16_HPP
+
+#include "convert_common.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+/***********************************************************************
+ * Shared implementation of the fc16 converters.
+ *
+ * An fc16 sample is a pair of IEEE 754 half precision floats, I then Q,
+ * held as their 16 bit patterns in host order.
+ *
+ * The sc16 converters convert directly. The sc12 and sc8 converters
+ * convert blocks of samples through the best fc32 converter, so they
+ * share its wire handling. The SIMD converters derive from them and
+ * override the half conversion.
+ *
+ * Everything is in an anonymous namespace on purpose, for the same
+ * reason as in convert_sc12.hpp.
+ **********************************************************************/
+namespace {
+
+typedef uint16_t f16_t;
+
+/*
+ * Convert a float to a half, rounding to nearest even like F16C and NEON.
+ * Out of range values become infinity.
+ */
+UHD_INLINE f16_t f32_to_f16(const float num)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &num, sizeof(bits));
+    const f16_t sign = f16_t((bits >> 16) & 0x8000);
+    const uint32_t abs_bits = bits & 0x7fffffff;
+
+    //infinity and nan, keep nans quiet
+    if (abs_bits >= 0x7f800000) return sign | 0x7c00 | ((abs_bits > 0x7f800000)? 0x200 : 0);
+
+    //at least 65520 rounds to infinity
+    if (abs_bits >= 0x477ff000) return sign | 0x7c00;
+
+    //below the smallest normal half
+    if (abs_bits < 0x38800000){
+        if (abs_bits < 0x33000000) return sign;
+        const uint32_t mant = (abs_bits & 0x7fffff) | 0x800000;
+        const uint32_t shift = 126 - (abs_bits >> 23);
+        const uint32_t rem = mant & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        uint32_t half = mant >> shift;
+        if (rem > halfway or (rem == halfway and (half & 1))) half++;
+        return sign | f16_t(half);
+    }
+
+    //rebias the exponent, a carry out of the mantissa is correct
+    const uint32_t rounded = abs_bits + 0xfff + ((abs_bits >> 13) & 1);
+    return sign | f16_t((rounded - 0x38000000) >> 13);
+}
+
+//! Convert a half to a float, this is exact
+UHD_INLINE float f16_to_f32(const f16_t half)
+{
+    const uint32_t sign = uint32_t(half & 0x8000) << 16;
+    const uint32_t exp = (half >> 10) & 0x1f;
+    const uint32_t mant = half & 0x3ff;
+
+    uint32_t bits;
+    if (exp == 0x1f) bits = sign | 0x7f800000 | (mant << 13);
+    else if (exp != 0) bits = sign | ((exp + 112) << 23) | (mant << 13);
+    else{
+        const float num = float(mant)*(1.0f/(1 << 24));
+        return sign? -num : num;
+    }
+
+    float num;
+    std::memcpy(&num, &bits, sizeof(num));
+    return num;
+}
+
+/***********************************************************************
+ * Convert between fc16 and items32 sc16 buffers
+ *  - fc16 buffers hold 2 halves per sample
+ **********************************************************************/
+template <xtox_t to_wire>
+UHD_INLINE void fc16_to_item32_sc16(
+    const f16_t *input,
+    item32_t *output,
+    const size_t nsamps,
+    const double scale_factor
+){
+    for (size_t i = 0; i < nsamps; i++){
+        const fc32_t num(f16_to_f32(input[2*i+0]), f16_to_f32(input[2*i+1]));
+        output[i] = to_wire(xx_to_item32_sc16_x1(num, scale_factor));
+    }
+}
+
+template <xtox_t to_host>
+UHD_INLINE void item32_sc16_to_fc16(
+    const item32_t *input,
+    f16_t *output,
+    const size_t nsamps,
+    const double scale_factor
+){
+    for (size_t i = 0; i < nsamps; i++){
+        const fc32_t num = item32_sc16_x1_to_xx<float>(to_host(input[i]), scale_factor);
+        output[2*i+0] = f32_to_f16(num.real());
+        output[2*i+1] = f32_to_f16(num.imag());
+    }
+}
+
+/***********************************************************************
+ * Convert between fc16 and another wire format through fc32
+ **********************************************************************/
+class convert_fc16_via_fc32 : public uhd::convert::converter
+{
+public:
+    /*!
+     * \param fc32_id the fc32 conversion, it has fc32 where this has fc16
+     * \param bytes_per_wire_samp the wire bytes per sample
+     */
+    convert_fc16_via_fc32(const uhd::convert::id_type &fc32_id, const size_t bytes_per_wire_samp):
+        _convert(uhd::convert::get_converter(fc32_id)()),
+        _from_fc16(fc32_id.input_format == "fc32"),
+        _bytes_per_wire_samp(bytes_per_wire_samp),
+        _buff(BLOCK_SIZE)
+    {
+        //NOP
+    }
+
+    virtual ~convert_fc16_via_fc32(void)
+    {
+        //NOP
+    }
+
+    void set_scalar(const double scalar)
+    {
+        _convert->set_scalar(scalar);
+    }
+
+    //! Convert halves to floats, this is overridden by the SIMD converters
+    virtual void f16_to_f32_block(const f16_t *input, float *output, const size_t n)
+    {
+        for (size_t i = 0; i < n; i++) output[i] = f16_to_f32(input[i]);
+    }
+
+    //! Convert floats to halves, this is overridden by the SIMD converters
+    virtual void f32_to_f16_block(const float *input, f16_t *output, const size_t n)
+    {
+        for (size_t i = 0; i < n; i++) output[i] = f32_to_f16(input[i]);
+    }
+
+    void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps)
+    {
+        //the sc12 wire converters rewrite whole lines at the block edges,
+        //so the first block ends where the wire buffer is 32 bit aligned
+        //and every block after it starts on a whole 3 line block
+        const size_t wire_addr = size_t(_from_fc16? outputs[0] : inputs[0]);
+        size_t head = 0;
+        while (head < 4 and ((wire_addr + head*_bytes_per_wire_samp) & 0x3)) head++;
+        head = std::min(head, nsamps);
+        if (head != 0) convert_block(inputs, outputs, 0, head);
+
+        for (size_t i = head; i < nsamps; i += BLOCK_SIZE){
+            convert_block(inputs, outputs, i, (nsamps - i < BLOCK_SIZE)? nsamps - i : BLOCK_SIZE);
+        }
+    }
+
+private:
+    static const size_t BLOCK_SIZE = 256;
+
+    void convert_block(const input_type &inputs, const output_type &outputs, const size_t i, const size_t n)
+    {
+        float *buff = reinterpret_cast<float *>(&_buff.front());
+        if (_from_fc16){
+            f16_to_f32_block(reinterpret_cast<const f16_t *>(inputs[0]) + 2*i, buff, 2*n);
+            char *output = reinterpret_cast<char *>(outputs[0]) + i*_bytes_per_wire_samp;
+            _convert->conv(input_type(buff), output_type(output), n);
+        }
+        else{
+            const char *input = reinterpret_cast<const char *>(inputs[0]) + i*_bytes_per_wire_samp;
+            _convert->conv(input_type(input), output_type(buff), n);
+            f32_to_f16_block(buff, reinterpret_cast<f16_t *>(outputs[0]) + 2*i, 2*n);
+        }
+    }
+
+    uhd::convert::converter::sptr _convert;
+    const bool _from_fc16;
+    const size_t _bytes_per_wire_samp;
+    std::vector<fc32_t> _buff;
+};
+
+} //namespace
+
+#endif /* INCLUDED_LIBUHD_CONVERT_FC16_HPP */
@@ -15,6 +15,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include "../utils/load_modules.hpp"
 #include <uhd/convert.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/static.hpp>
@@ -24,6 +25,7 @@
 #include <boost/format.hpp>
 #include <boost/foreach.hpp>
 #include <complex>
+#include <algorithm>
 
 using namespace uhd;
 
@@ -31,6 +33,15 @@ convert::converter::~converter(void){
     /* NOP */
 }
 
+void convert::converter::set_correction(
+    const std::complex<double> &gain, const std::complex<double> &offset
+){
+    if (gain == 1.0 and offset == 0.0) return;
+    throw uhd::not_implemented_error(
+        "This converter does not support gain and offset correction"
+    );
+}
+
 bool convert::operator==(const convert::id_type &lhs, const convert::id_type &rhs){
     return true
         and (lhs.input_format  == rhs.input_format)
@@ -64,10 +75,22 @@ std::string convert::id_type::to_string(void) const{
     );
 }
 
+std::string convert::converter_info_type::to_string(void) const{
+    return str(boost::format("%s (prio %d%s)")
+        % this->name
+        % this->prio
+        % (this->isa.empty()? "" : ", needs " + this->isa)
+    );
+}
+
 /***********************************************************************
  * Setup the table registry
  **********************************************************************/
-typedef uhd::dict<convert::id_type, uhd::dict<convert::priority_type, convert::function_type> > fcn_table_type;
+struct fcn_table_entry_type{
+    convert::function_type fcn;
+    convert::converter_info_type info;
+};
+typedef uhd::dict<convert::id_type, uhd::dict<convert::priority_type, fcn_table_entry_type> > fcn_table_type;
 UHD_SINGLETON_FCN(fcn_table_type, get_table);
 
 /***********************************************************************
@@ -76,13 +99,26 @@ UHD_SINGLETON_FCN(fcn_table_type, get_table);
 void uhd::convert::register_converter(
     const id_type &id,
     const function_type &fcn,
-    const priority_type prio
+    const priority_type prio,
+    const std::string &name,
+    const std::string &isa
 ){
-    get_table()[id][prio] = fcn;
+    fcn_table_entry_type entry;
+    entry.fcn = fcn;
+    entry.info.prio = prio;
+    entry.info.isa = isa;
+    entry.info.name = name;
+    if (name.empty()) switch(prio){
+        case 0: entry.info.name = "generic"; break;
+        case 1: entry.info.name = "table"; break;
+        default: entry.info.name = str(boost::format("prio%d") % prio);
+    }
+    get_table()[id][prio] = entry;
 
     //----------------------------------------------------------------//
     UHD_LOGV(always) << "register_converter: " << id.to_pp_string() << std::endl
         << "    prio: " << prio << std::endl
+        << "    name: " << entry.info.name << std::endl
         << std::endl
     ;
     //----------------------------------------------------------------//
@@ -95,6 +131,7 @@ convert::function_type convert::get_converter(
     const id_type &id,
     const priority_type prio
 ){
+    uhd::load_modules();
     if (not get_table().has_key(id)) throw uhd::key_error(
         "Cannot find a conversion routine for " + id.to_pp_string());
 
@@ -108,7 +145,7 @@ convert::function_type convert::get_converter(
                 << std::endl
             ;
             //----------------------------------------------------------------//
-            return get_table()[id][prio];
+            return get_table()[id][prio].fcn;
         }
         best_prio = std::max(best_prio, prio_i);
     }
@@ -125,7 +162,57 @@ convert::function_type convert::get_converter(
     //----------------------------------------------------------------//
 
     //otherwise, return best prio
-    return get_table()[id][best_prio];
+    return get_table()[id][best_prio].fcn;
+}
+
+convert::function_type convert::get_converter(
+    const id_type &id,
+    const std::string &name
+){
+    uhd::load_modules();
+    if (not get_table().has_key(id)) throw uhd::key_error(
+        "Cannot find a conversion routine for " + id.to_pp_string());
+
+    BOOST_FOREACH(const fcn_table_entry_type &entry, get_table()[id].vals()){
+        if (entry.info.name != name) continue;
+        //----------------------------------------------------------------//
+        UHD_LOGV(always) << "get_converter: For converter ID: " << id.to_pp_string() << std::endl
+            << "Using converter: " << entry.info.to_string() << std::endl
+            << std::endl
+        ;
+        //----------------------------------------------------------------//
+        return entry.fcn;
+    }
+
+    std::string names;
+    BOOST_FOREACH(const converter_info_type &info, get_converter_infos(id)){
+        names += " " + info.name;
+    }
+    throw uhd::key_error(str(boost::format(
+        "Cannot find a conversion routine named \"%s\" for %s"
+        "Available converters:%s"
+    ) % name % id.to_pp_string() % names));
+}
+
+static bool converter_info_prio_gt(
+    const convert::converter_info_type &lhs, const convert::converter_info_type &rhs
+){
+    return lhs.prio > rhs.prio;
+}
+
+std::vector<convert::converter_info_type> convert::get_converter_infos(const id_type &id){
+    uhd::load_modules();
+    std::vector<converter_info_type> infos;
+    if (not get_table().has_key(id)) return infos;
+    BOOST_FOREACH(const fcn_table_entry_type &entry, get_table()[id].vals()){
+        infos.push_back(entry.info);
+    }
+    std::sort(infos.begin(), infos.end(), &converter_info_prio_gt);
+    return infos;
+}
+
+std::vector<convert::id_type> convert::get_converter_ids(void){
+    return get_table().keys();
 }
 
 /***********************************************************************
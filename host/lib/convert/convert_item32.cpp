@@ -40,8 +40,43 @@
 
 /* Create sc16<->sc16,sc8(otw) */
 DECLARE_ITEM32_CONVERTER(sc16)
-/* Create fc32<->sc16,sc8(otw) */
-DECLARE_ITEM32_CONVERTER(fc32)
+/* Create fc32<->sc8(otw) */
+_DECLARE_ITEM32_CONVERTER(fc32, sc8)
+/* Create fc32<->sc16(otw), receive applies the gain and offset correction */
+#define DECLARE_ITEM32_SC16_FC32_CONVERTER(xe, htoxx, xxtoh) \
+    DECLARE_CONVERTER(fc32, 1, sc16_item32_ ## xe, 1, PRIORITY_GENERAL){ \
+        const fc32_t *input = reinterpret_cast<const fc32_t *>(inputs[0]); \
+        item32_t *output = reinterpret_cast<item32_t *>(outputs[0]); \
+        xx_to_item32_sc16<htoxx>(input, output, nsamps, scale_factor); \
+    } \
+    DECLARE_CORRECTING_CONVERTER(sc16_item32_ ## xe, 1, fc32, 1, PRIORITY_GENERAL){ \
+        const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]); \
+        fc32_t *output = reinterpret_cast<fc32_t *>(outputs[0]); \
+        if (has_correction()) item32_sc16_to_fc32_corrected<xxtoh>( \
+            input, output, nsamps, scale_factor, gain, offset); \
+        else item32_sc16_to_xx<xxtoh>(input, output, nsamps, scale_factor); \
+    }
+DECLARE_ITEM32_SC16_FC32_CONVERTER(be, uhd::htonx, uhd::ntohx)
+DECLARE_ITEM32_SC16_FC32_CONVERTER(le, uhd::htowx, uhd::wtohx)
 /* Create fc64<->sc16,sc8(otw) */
 DECLARE_ITEM32_CONVERTER(fc64)
 _DECLARE_ITEM32_CONVERTER(sc8, sc8)
+
+/* Create fc32(planar)<->sc16(otw) for 2 and 4 interleaved channels */
+#define DECLARE_ITEM32_SC16_PLANAR_CONVERTER(width, xe, htoxx, xxtoh) \
+    DECLARE_CONVERTER(fc32, width, sc16_item32_ ## xe, 1, PRIORITY_GENERAL){ \
+        const fc32_t *input[width]; \
+        for (size_t w = 0; w < width; w++) input[w] = reinterpret_cast<const fc32_t *>(inputs[w]); \
+        item32_t *output = reinterpret_cast<item32_t *>(outputs[0]); \
+        xx_planar_to_item32_sc16<htoxx, width>(input, output, 0, nsamps, scale_factor); \
+    } \
+    DECLARE_CONVERTER(sc16_item32_ ## xe, 1, fc32, width, PRIORITY_GENERAL){ \
+        const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]); \
+        fc32_t *output[width]; \
+        for (size_t w = 0; w < width; w++) output[w] = reinterpret_cast<fc32_t *>(outputs[w]); \
+        item32_sc16_to_xx_planar<xxtoh, width>(input, output, 0, nsamps, scale_factor); \
+    }
+DECLARE_ITEM32_SC16_PLANAR_CONVERTER(2, be, uhd::htonx, uhd::ntohx)
+DECLARE_ITEM32_SC16_PLANAR_CONVERTER(2, le, uhd::htowx, uhd::wtohx)
+DECLARE_ITEM32_SC16_PLANAR_CONVERTER(4, be, uhd::htonx, uhd::ntohx)
+DECLARE_ITEM32_SC16_PLANAR_CONVERTER(4, le, uhd::htowx, uhd::wtohx)
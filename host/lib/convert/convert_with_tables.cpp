@@ -18,6 +18,10 @@
 #include "convert_common.hpp"
 #include <uhd/utils/byteswap.hpp>
 #include <boost/math/special_functions/round.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <map>
 #include <vector>
 
 using namespace uhd::convert;
@@ -26,6 +30,37 @@ static const size_t sc16_table_len = size_t(1 << 16);
 
 typedef uint16_t (*tohost16_type)(uint16_t);
 
+/***********************************************************************
+ * Table sharing
+ *  - A table only depends on the converter type and the scalar,
+ *    so all converters of a type with the same scalar share one table.
+ *  - The cache only holds weak references, so a table is freed
+ *    together with the last converter using it.
+ **********************************************************************/
+static boost::mutex table_cache_mutex;
+
+template <typename converter_type>
+static boost::shared_ptr<const typename converter_type::table_type> get_shared_table(
+    const double scalar
+){
+    typedef boost::shared_ptr<const typename converter_type::table_type> table_sptr;
+    typedef std::map<double, boost::weak_ptr<const typename converter_type::table_type> > cache_type;
+    boost::mutex::scoped_lock lock(table_cache_mutex);
+    static cache_type cache; //one per converter type, constructed under the lock
+
+    table_sptr table = cache[scalar].lock();
+    if (table) return table;
+
+    //drop the entries of tables which are no longer used
+    for (typename cache_type::iterator it = cache.begin(); it != cache.end();){
+        if (it->second.expired() and it->first != scalar) cache.erase(it++);
+        else ++it;
+    }
+    table = converter_type::make_table(scalar);
+    cache[scalar] = table;
+    return table;
+}
+
 /***********************************************************************
  * Implementation for sc16 to sc8 lookup table
  *  - Lookup the real and imaginary parts individually
@@ -33,13 +68,24 @@ typedef uint16_t (*tohost16_type)(uint16_t);
 template <bool swap>
 class convert_sc16_1_to_sc8_item32_1 : public converter{
 public:
-    convert_sc16_1_to_sc8_item32_1(void): _table(sc16_table_len){}
+    typedef std::vector<uint8_t> table_type;
 
-    void set_scalar(const double scalar){
+    convert_sc16_1_to_sc8_item32_1(void){
+        this->set_scalar(1.0);
+    }
+
+    static boost::shared_ptr<const table_type> make_table(const double scalar){
+        boost::shared_ptr<table_type> table(new table_type(sc16_table_len));
         for (size_t i = 0; i < sc16_table_len; i++){
             const int16_t val = uint16_t(i);
-            _table[i] = int8_t(boost::math::iround(val * scalar / 32767.));
+            (*table)[i] = int8_t(boost::math::iround(val * scalar / 32767.));
         }
+        return table;
+    }
+
+    void set_scalar(const double scalar){
+        _table_sptr = get_shared_table<convert_sc16_1_to_sc8_item32_1>(scalar);
+        _table = &_table_sptr->front();
     }
 
     void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps){
@@ -72,7 +118,8 @@ public:
     }
 
 private:
-    std::vector<uint8_t> _table;
+    boost::shared_ptr<const table_type> _table_sptr;
+    const uint8_t *_table;
 };
 
 /***********************************************************************
@@ -82,13 +129,24 @@ private:
 template <typename type, tohost16_type tohost, size_t re_shift, size_t im_shift>
 class convert_sc16_item32_1_to_fcxx_1 : public converter{
 public:
-    convert_sc16_item32_1_to_fcxx_1(void): _table(sc16_table_len){}
+    typedef std::vector<type> table_type;
 
-    void set_scalar(const double scalar){
+    convert_sc16_item32_1_to_fcxx_1(void){
+        this->set_scalar(1.0);
+    }
+
+    static boost::shared_ptr<const table_type> make_table(const double scalar){
+        boost::shared_ptr<table_type> table(new table_type(sc16_table_len));
         for (size_t i = 0; i < sc16_table_len; i++){
             const uint16_t val = tohost(uint16_t(i & 0xffff));
-            _table[i] = type(int16_t(val)*scalar);
+            (*table)[i] = type(int16_t(val)*scalar);
         }
+        return table;
+    }
+
+    void set_scalar(const double scalar){
+        _table_sptr = get_shared_table<convert_sc16_item32_1_to_fcxx_1>(scalar);
+        _table = &_table_sptr->front();
     }
 
     void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps){
@@ -105,7 +163,8 @@ public:
     }
 
 private:
-    std::vector<type> _table;
+    boost::shared_ptr<const table_type> _table_sptr;
+    const type *_table;
 };
 
 /***********************************************************************
@@ -115,7 +174,11 @@ private:
 template <typename type, tohost16_type tohost, size_t lo_shift, size_t hi_shift>
 class convert_sc8_item32_1_to_fcxx_1 : public converter{
 public:
-    convert_sc8_item32_1_to_fcxx_1(void): _table(sc16_table_len){}
+    typedef std::vector<std::complex<type> > table_type;
+
+    convert_sc8_item32_1_to_fcxx_1(void){
+        this->set_scalar(1.0);
+    }
 
     //special case for sc16 type, 32767 undoes float normalization
     static type conv(const int8_t &num, const double scalar){
@@ -125,13 +188,20 @@ public:
         return type(num*scalar);
     }
 
-    void set_scalar(const double scalar){
+    static boost::shared_ptr<const table_type> make_table(const double scalar){
+        boost::shared_ptr<table_type> table(new table_type(sc16_table_len));
         for (size_t i = 0; i < sc16_table_len; i++){
             const uint16_t val = tohost(uint16_t(i & 0xffff));
             const type real = conv(int8_t(val >> 8), scalar);
             const type imag = conv(int8_t(val >> 0), scalar);
-            _table[i] = std::complex<type>(real, imag);
+            (*table)[i] = std::complex<type>(real, imag);
         }
+        return table;
+    }
+
+    void set_scalar(const double scalar){
+        _table_sptr = get_shared_table<convert_sc8_item32_1_to_fcxx_1>(scalar);
+        _table = &_table_sptr->front();
     }
 
     void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps){
@@ -160,7 +230,8 @@ public:
     }
 
 private:
-    std::vector<std::complex<type> > _table;
+    boost::shared_ptr<const table_type> _table_sptr;
+    const std::complex<type> *_table;
 };
 
 /***********************************************************************
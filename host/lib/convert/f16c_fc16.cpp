@@ -0,0 +1,213 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_fc16.hpp"
+#include "convert_avx_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * The half conversions need F16C, the sc16 shuffles need AVX2.
+ * Every CPU with AVX2 has F16C, but both are checked anyway.
+ **********************************************************************/
+template <xtox_t to_wire>
+struct convert_fc16_1_to_item32_sc16_1_f16c : public converter
+{
+    convert_fc16_1_to_item32_sc16_1_f16c(const bool wire_le):
+        _wire_le(wire_le), _scale_factor(0.0)
+    {
+        //NOP
+    }
+
+    void set_scalar(const double scalar)
+    {
+        _scale_factor = scalar;
+    }
+
+    UHD_TARGET_F16C void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps)
+    {
+        const f16_t *input = reinterpret_cast<const f16_t *>(inputs[0]);
+        item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
+        const __m256 scalar = _mm256_set1_ps(float(_scale_factor));
+        const __m256i ctrl = _mm256_broadcastsi128_si256(
+            _wire_le? sc16_item32_nswap_ctrl() : sc16_item32_bswap_ctrl());
+
+        size_t i = 0;
+        for (; i+7 < nsamps; i+=8){
+            /* load from input + widen to floats */
+            __m256 tmplo = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input+2*i+0)));
+            __m256 tmphi = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input+2*i+8)));
+
+            /* convert and scale */
+            __m256i tmpilo = _mm256_cvtps_epi32(_mm256_mul_ps(tmplo, scalar));
+            __m256i tmpihi = _mm256_cvtps_epi32(_mm256_mul_ps(tmphi, scalar));
+
+            /* pack (works per 128-bit lane, so restore the order) + put I/Q into wire order */
+            __m256i tmpi = _mm256_packs_epi32(tmpilo, tmpihi);
+            tmpi = _mm256_permute4x64_epi64(tmpi, _MM_SHUFFLE(3, 1, 2, 0));
+            tmpi = _mm256_shuffle_epi8(tmpi, ctrl);
+
+            /* store to output */
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(output+i), tmpi);
+        }
+
+        // convert any remaining samples
+        fc16_to_item32_sc16<to_wire>(input+2*i, output+i, nsamps-i, _scale_factor);
+    }
+
+    const bool _wire_le;
+    double _scale_factor;
+};
+
+template <xtox_t to_host>
+struct convert_item32_sc16_1_to_fc16_1_f16c : public converter
+{
+    convert_item32_sc16_1_to_fc16_1_f16c(const bool wire_le):
+        _wire_le(wire_le), _scale_factor(0.0)
+    {
+        //NOP
+    }
+
+    void set_scalar(const double scalar)
+    {
+        _scale_factor = scalar;
+    }
+
+    UHD_TARGET_F16C void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps)
+    {
+        const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
+        f16_t *output = reinterpret_cast<f16_t *>(outputs[0]);
+        const __m256 scalar = _mm256_set1_ps(float(_scale_factor));
+        const __m256i ctrl = _mm256_broadcastsi128_si256(
+            _wire_le? sc16_item32_nswap_ctrl() : sc16_item32_bswap_ctrl());
+
+        size_t i = 0;
+        for (; i+7 < nsamps; i+=8){
+            /* load from input + put I/Q into host order */
+            __m256i tmpi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input+i));
+            tmpi = _mm256_shuffle_epi8(tmpi, ctrl);
+
+            /* sign extend, convert and scale */
+            __m256i tmpilo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(tmpi));
+            __m256i tmpihi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(tmpi, 1));
+            __m256 tmplo = _mm256_mul_ps(_mm256_cvtepi32_ps(tmpilo), scalar);
+            __m256 tmphi = _mm256_mul_ps(_mm256_cvtepi32_ps(tmpihi), scalar);
+
+            /* narrow to halves + store to output */
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output+2*i+0), _mm256_cvtps_ph(tmplo, _MM_FROUND_TO_NEAREST_INT));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output+2*i+8), _mm256_cvtps_ph(tmphi, _MM_FROUND_TO_NEAREST_INT));
+        }
+
+        // convert any remaining samples
+        item32_sc16_to_fc16<to_host>(input+i, output+2*i, nsamps-i, _scale_factor);
+    }
+
+    const bool _wire_le;
+    double _scale_factor;
+};
+
+struct convert_fc16_via_fc32_f16c : public convert_fc16_via_fc32
+{
+    convert_fc16_via_fc32_f16c(const id_type &fc32_id, const size_t bytes_per_wire_samp):
+        convert_fc16_via_fc32(fc32_id, bytes_per_wire_samp)
+    {
+        //NOP
+    }
+
+    UHD_TARGET_F16C void f16_to_f32_block(const f16_t *input, float *output, const size_t n)
+    {
+        size_t i = 0;
+        for (; i+7 < n; i+=8){
+            _mm256_storeu_ps(output+i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i))));
+        }
+        convert_fc16_via_fc32::f16_to_f32_block(input+i, output+i, n-i);
+    }
+
+    UHD_TARGET_F16C void f32_to_f16_block(const float *input, f16_t *output, const size_t n)
+    {
+        size_t i = 0;
+        for (; i+7 < n; i+=8){
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output+i), _mm256_cvtps_ph(_mm256_loadu_ps(input+i), _MM_FROUND_TO_NEAREST_INT));
+        }
+        convert_fc16_via_fc32::f32_to_f16_block(input+i, output+i, n-i);
+    }
+};
+
+static converter::sptr make_convert_fc16_1_to_sc16_item32_le_1_f16c(void)
+{
+    return converter::sptr(new convert_fc16_1_to_item32_sc16_1_f16c<uhd::htowx>(true));
+}
+
+static converter::sptr make_convert_fc16_1_to_sc16_item32_be_1_f16c(void)
+{
+    return converter::sptr(new convert_fc16_1_to_item32_sc16_1_f16c<uhd::htonx>(false));
+}
+
+static converter::sptr make_convert_sc16_item32_le_1_to_fc16_1_f16c(void)
+{
+    return converter::sptr(new convert_item32_sc16_1_to_fc16_1_f16c<uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc16_item32_be_1_to_fc16_1_f16c(void)
+{
+    return converter::sptr(new convert_item32_sc16_1_to_fc16_1_f16c<uhd::ntohx>(false));
+}
+
+#define DECLARE_VIA_FC32_CONVERTER_F16C(wire_type, xe) \
+    static converter::sptr make_convert_fc16_1_to_ ## wire_type ## _item32_ ## xe ## _1_f16c(void){ \
+        id_type id; \
+        id.input_format = "fc32"; \
+        id.num_inputs = 1; \
+        id.output_format = #wire_type "_item32_" #xe; \
+        id.num_outputs = 1; \
+        return converter::sptr(new convert_fc16_via_fc32_f16c(id, get_bytes_per_item(#wire_type))); \
+    } \
+    static converter::sptr make_convert_ ## wire_type ## _item32_ ## xe ## _1_to_fc16_1_f16c(void){ \
+        id_type id; \
+        id.input_format = #wire_type "_item32_" #xe; \
+        id.num_inputs = 1; \
+        id.output_format = "fc32"; \
+        id.num_outputs = 1; \
+        return converter::sptr(new convert_fc16_via_fc32_f16c(id, get_bytes_per_item(#wire_type))); \
+    }
+DECLARE_VIA_FC32_CONVERTER_F16C(sc12, le)
+DECLARE_VIA_FC32_CONVERTER_F16C(sc12, be)
+DECLARE_VIA_FC32_CONVERTER_F16C(sc8, le)
+DECLARE_VIA_FC32_CONVERTER_F16C(sc8, be)
+
+#define REGISTER_CONVERTER_F16C(wire_type, xe) \
+    id.input_format = "fc16"; \
+    id.output_format = #wire_type "_item32_" #xe; \
+    register_converter(id, &make_convert_fc16_1_to_ ## wire_type ## _item32_ ## xe ## _1_f16c, PRIORITY_SIMD_AVX2, "f16c", "f16c"); \
+    std::swap(id.input_format, id.output_format); \
+    register_converter(id, &make_convert_ ## wire_type ## _item32_ ## xe ## _1_to_fc16_1_f16c, PRIORITY_SIMD_AVX2, "f16c", "f16c");
+
+UHD_STATIC_BLOCK(register_convert_fc16_f16c)
+{
+    if (not (cpu_has_avx2() and cpu_has_f16c())) return;
+
+    id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+    REGISTER_CONVERTER_F16C(sc16, le)
+    REGISTER_CONVERTER_F16C(sc16, be)
+    REGISTER_CONVERTER_F16C(sc12, le)
+    REGISTER_CONVERTER_F16C(sc12, be)
+    REGISTER_CONVERTER_F16C(sc8, le)
+    REGISTER_CONVERTER_F16C(sc8, be)
+}
@@ -46,9 +46,7 @@ DECLARE_CONVERTER({in_type}, 1, {out_type}, 1, PRIORITY_GENERAL) {{
     const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
     item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
 
-    for (size_t i = 0; i < nsamps; i++) {{
-        output[i] = {to_wire_or_host}(input[i]);
-    }}
+    {to_wire_or_host}(input, output, nsamps);
 }}
 """
 
@@ -59,9 +57,7 @@ DECLARE_CONVERTER({in_type}, 1, {out_type}, 1, PRIORITY_GENERAL) {{
     item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
 
     // An item64 is two item32_t's
-    for (size_t i = 0; i < nsamps * 2; i++) {{
-        output[i] = {to_wire_or_host}(input[i]);
-    }}
+    {to_wire_or_host}(input, output, nsamps * 2);
 }}
 """
 
@@ -73,9 +69,7 @@ DECLARE_CONVERTER({us8}, 1, {us8}_item32_{end}, 1, PRIORITY_GENERAL) {{
 
     // 1) Copy all the 4-byte tuples
     size_t n_words = nsamps / 4;
-    for (size_t i = 0; i < n_words; i++) {{
-        output[i] = {to_wire}(input[i]);
-    }}
+    {to_wire}(input, output, n_words);
     // 2) If nsamps was not a multiple of 4, copy the rest by hand
     size_t bytes_left = nsamps % 4;
     if (bytes_left) {{
@@ -94,9 +88,7 @@ DECLARE_CONVERTER({us8}_item32_{end}, 1, {us8}, 1, PRIORITY_GENERAL) {{
 
     // 1) Copy all the 4-byte tuples
     size_t n_words = nsamps / 4;
-    for (size_t i = 0; i < n_words; i++) {{
-        output[i] = {to_host}(input[i]);
-    }}
+    {to_host}(input, output, n_words);
     // 2) If nsamps was not a multiple of 4, copy the rest by hand
     size_t bytes_left = nsamps % 4;
     if (bytes_left) {{
@@ -117,9 +109,7 @@ DECLARE_CONVERTER(s16, 1, s16_item32_{end}, 1, PRIORITY_GENERAL) {{
 
     // 1) Copy all the 4-byte tuples
     size_t n_words = nsamps / 2;
-    for (size_t i = 0; i < n_words; i++) {{
-        output[i] = {to_wire}(input[i]);
-    }}
+    {to_wire}(input, output, n_words);
     // 2) If nsamps was not a multiple of 2, copy the last one by hand
     if (nsamps % 2) {{
         item32_t tmp = item32_t(*reinterpret_cast<const s16_t *>(&input[n_words]));
@@ -133,9 +123,7 @@ DECLARE_CONVERTER(s16_item32_{end}, 1, s16, 1, PRIORITY_GENERAL) {{
 
     // 1) Copy all the 4-byte tuples
     size_t n_words = nsamps / 2;
-    for (size_t i = 0; i < n_words; i++) {{
-        output[i] = {to_host}(input[i]);
-    }}
+    {to_host}(input, output, n_words);
     // 2) If nsamps was not a multiple of 2, copy the last one by hand
     if (nsamps % 2) {{
         item32_t tmp = {to_host}(input[n_words]);
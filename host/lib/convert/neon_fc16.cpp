@@ -0,0 +1,183 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_fc16.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <arm_neon.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Put I/Q of 4 items32 sc16 into host order on a little endian host,
+ * the swaps are their own inverse, so they work for either direction
+ **********************************************************************/
+template <bool wire_le>
+static UHD_INLINE int16x8_t neon_sc16_item32_swap(const int16x8_t v){
+    if (wire_le) return vrev32q_s16(v);
+    return vreinterpretq_s16_u8(vrev16q_u8(vreinterpretq_u8_s16(v)));
+}
+
+template <xtox_t to_wire, bool wire_le>
+static UHD_INLINE void neon_fc16_to_item32_sc16(
+    const f16_t *input, item32_t *output, const size_t nsamps, const double scale_factor
+){
+    const float32x4_t scalar = vdupq_n_f32(float(scale_factor));
+
+    size_t i = 0;
+    for (; i+3 < nsamps; i+=4){
+        /* load from input + widen to floats */
+        const float32x4_t lo = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(input+2*i+0)));
+        const float32x4_t hi = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(input+2*i+4)));
+
+        /* scale, convert and saturate */
+        const int16x4_t lo16 = vqmovn_s32(vcvtq_s32_f32(vmulq_f32(lo, scalar)));
+        const int16x4_t hi16 = vqmovn_s32(vcvtq_s32_f32(vmulq_f32(hi, scalar)));
+
+        /* put I/Q into wire order + store to output */
+        const int16x8_t out = neon_sc16_item32_swap<wire_le>(vcombine_s16(lo16, hi16));
+        vst1q_s16(reinterpret_cast<int16_t *>(output+i), out);
+    }
+
+    // convert any remaining samples
+    fc16_to_item32_sc16<to_wire>(input+2*i, output+i, nsamps-i, scale_factor);
+}
+
+template <xtox_t to_host, bool wire_le>
+static UHD_INLINE void neon_item32_sc16_to_fc16(
+    const item32_t *input, f16_t *output, const size_t nsamps, const double scale_factor
+){
+    const float32x4_t scalar = vdupq_n_f32(float(scale_factor));
+
+    size_t i = 0;
+    for (; i+3 < nsamps; i+=4){
+        /* load from input + put I/Q into host order */
+        const int16x8_t in = neon_sc16_item32_swap<wire_le>(vld1q_s16(reinterpret_cast<const int16_t *>(input+i)));
+
+        /* sign extend, convert and scale */
+        const float32x4_t lo = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(in))), scalar);
+        const float32x4_t hi = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), scalar);
+
+        /* narrow to halves + store to output */
+        vst1_u16(output+2*i+0, vreinterpret_u16_f16(vcvt_f16_f32(lo)));
+        vst1_u16(output+2*i+4, vreinterpret_u16_f16(vcvt_f16_f32(hi)));
+    }
+
+    // convert any remaining samples
+    item32_sc16_to_fc16<to_host>(input+i, output+2*i, nsamps-i, scale_factor);
+}
+
+DECLARE_CONVERTER(fc16, 1, sc16_item32_le, 1, PRIORITY_SIMD){
+    neon_fc16_to_item32_sc16<uhd::htowx, true>(
+        reinterpret_cast<const f16_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(fc16, 1, sc16_item32_be, 1, PRIORITY_SIMD){
+    neon_fc16_to_item32_sc16<uhd::htonx, false>(
+        reinterpret_cast<const f16_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc16_item32_le, 1, fc16, 1, PRIORITY_SIMD){
+    neon_item32_sc16_to_fc16<uhd::wtohx, true>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<f16_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc16_item32_be, 1, fc16, 1, PRIORITY_SIMD){
+    neon_item32_sc16_to_fc16<uhd::ntohx, false>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<f16_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+/***********************************************************************
+ * Convert to and from sc12 and sc8 through fc32
+ **********************************************************************/
+struct convert_fc16_via_fc32_neon : public convert_fc16_via_fc32
+{
+    convert_fc16_via_fc32_neon(const id_type &fc32_id, const size_t bytes_per_wire_samp):
+        convert_fc16_via_fc32(fc32_id, bytes_per_wire_samp)
+    {
+        //NOP
+    }
+
+    void f16_to_f32_block(const f16_t *input, float *output, const size_t n)
+    {
+        size_t i = 0;
+        for (; i+3 < n; i+=4){
+            vst1q_f32(output+i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(input+i))));
+        }
+        convert_fc16_via_fc32::f16_to_f32_block(input+i, output+i, n-i);
+    }
+
+    void f32_to_f16_block(const float *input, f16_t *output, const size_t n)
+    {
+        size_t i = 0;
+        for (; i+3 < n; i+=4){
+            vst1_u16(output+i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(input+i))));
+        }
+        convert_fc16_via_fc32::f32_to_f16_block(input+i, output+i, n-i);
+    }
+};
+
+#define DECLARE_VIA_FC32_CONVERTER_NEON(wire_type, xe) \
+    static converter::sptr make_convert_fc16_1_to_ ## wire_type ## _item32_ ## xe ## _1_neon(void){ \
+        id_type id; \
+        id.input_format = "fc32"; \
+        id.num_inputs = 1; \
+        id.output_format = #wire_type "_item32_" #xe; \
+        id.num_outputs = 1; \
+        return converter::sptr(new convert_fc16_via_fc32_neon(id, get_bytes_per_item(#wire_type))); \
+    } \
+    static converter::sptr make_convert_ ## wire_type ## _item32_ ## xe ## _1_to_fc16_1_neon(void){ \
+        id_type id; \
+        id.input_format = #wire_type "_item32_" #xe; \
+        id.num_inputs = 1; \
+        id.output_format = "fc32"; \
+        id.num_outputs = 1; \
+        return converter::sptr(new convert_fc16_via_fc32_neon(id, get_bytes_per_item(#wire_type))); \
+    }
+DECLARE_VIA_FC32_CONVERTER_NEON(sc12, le)
+DECLARE_VIA_FC32_CONVERTER_NEON(sc12, be)
+DECLARE_VIA_FC32_CONVERTER_NEON(sc8, le)
+DECLARE_VIA_FC32_CONVERTER_NEON(sc8, be)
+
+#define REGISTER_VIA_FC32_CONVERTER_NEON(wire_type, xe) \
+    id.input_format = "fc16"; \
+    id.output_format = #wire_type "_item32_" #xe; \
+    register_converter(id, &make_convert_fc16_1_to_ ## wire_type ## _item32_ ## xe ## _1_neon, PRIORITY_SIMD, "neon", "neon"); \
+    std::swap(id.input_format, id.output_format); \
+    register_converter(id, &make_convert_ ## wire_type ## _item32_ ## xe ## _1_to_fc16_1_neon, PRIORITY_SIMD, "neon", "neon");
+
+UHD_STATIC_BLOCK(register_convert_fc16_neon)
+{
+    id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+    REGISTER_VIA_FC32_CONVERTER_NEON(sc12, le)
+    REGISTER_VIA_FC32_CONVERTER_NEON(sc12, be)
+    REGISTER_VIA_FC32_CONVERTER_NEON(sc8, le)
+    REGISTER_VIA_FC32_CONVERTER_NEON(sc8, be)
+}
@@ -0,0 +1,126 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_sc12.hpp"
+#include <arm_neon.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Shuffle the bytes of a vector, the out of range control bytes are zero
+ **********************************************************************/
+static UHD_INLINE uint8x16_t neon_sc12_shuffle(const uint8x16_t v, const uint8x16_t ctrl){
+#if defined(__aarch64__)
+    return vqtbl1q_u8(v, ctrl);
+#else
+    uint8x8x2_t table;
+    table.val[0] = vget_low_u8(v);
+    table.val[1] = vget_high_u8(v);
+    return vcombine_u8(vtbl2_u8(table, vget_low_u8(ctrl)), vtbl2_u8(table, vget_high_u8(ctrl)));
+#endif
+}
+
+/***********************************************************************
+ * Load 4 samples as 12 bit numbers in the lower bits of 16-bit lanes
+ **********************************************************************/
+static UHD_INLINE uint16x8_t neon_sc12_load(
+    const std::complex<float> *input, const float32x4_t scalar
+){
+    //convert, scale, truncate and mask like the generic converter
+    const int32x4_t mask = vdupq_n_s32(0xfff);
+    const float32x4_t lo = vld1q_f32(reinterpret_cast<const float *>(input+0));
+    const float32x4_t hi = vld1q_f32(reinterpret_cast<const float *>(input+2));
+    const int32x4_t lo_i = vandq_s32(vcvtq_s32_f32(vmulq_f32(lo, scalar)), mask);
+    const int32x4_t hi_i = vandq_s32(vcvtq_s32_f32(vmulq_f32(hi, scalar)), mask);
+    return vreinterpretq_u16_s16(vcombine_s16(vmovn_s32(lo_i), vmovn_s32(hi_i)));
+}
+
+static UHD_INLINE uint16x8_t neon_sc12_load(
+    const std::complex<int16_t> *input, const float32x4_t
+){
+    //keep the upper 12 bits
+    return vshrq_n_u16(vld1q_u16(reinterpret_cast<const uint16_t *>(input)), 4);
+}
+
+template <typename type, towire32_type towire>
+struct convert_star_1_to_sc12_item32_1_neon : public convert_star_1_to_sc12_item32_1<type, towire>
+{
+    convert_star_1_to_sc12_item32_1_neon(const bool wire_le)
+    {
+        sc12_pack_shuffle_ctrls(wire_le, _ctrl_a, _ctrl_b);
+    }
+
+    size_t convert_blocks(const std::complex<type> *input, item32_sc12_3x *output, const size_t nblocks)
+    {
+        static const uint16_t mult_lanes[8] = {16, 1, 16, 1, 16, 1, 16, 1}; //I << 4
+        const uint8x16_t ctrl_a = vld1q_u8(_ctrl_a);
+        const uint8x16_t ctrl_b = vld1q_u8(_ctrl_b);
+        const uint16x8_t mult = vld1q_u16(mult_lanes);
+        const float32x4_t scalar = vdupq_n_f32(float(this->_scalar));
+
+        //the store writes 4 bytes into the next block, so leave the last one to the generic code
+        size_t b = 0;
+        for (; b+1 < nblocks; b++)
+        {
+            const uint8x16_t v = vreinterpretq_u8_u16(vmulq_u16(neon_sc12_load(input+4*b, scalar), mult));
+            const uint8x16_t out = vorrq_u8(neon_sc12_shuffle(v, ctrl_a), neon_sc12_shuffle(v, ctrl_b));
+            vst1q_u8(reinterpret_cast<uint8_t *>(output+b), out);
+        }
+        return b;
+    }
+
+    uint8_t _ctrl_a[16], _ctrl_b[16];
+};
+
+static converter::sptr make_convert_fc32_1_to_sc12_item32_le_1_neon(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_neon<float, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_fc32_1_to_sc12_item32_be_1_neon(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_neon<float, uhd::ntohx>(false));
+}
+
+static converter::sptr make_convert_sc16_1_to_sc12_item32_le_1_neon(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_neon<int16_t, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc16_1_to_sc12_item32_be_1_neon(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_neon<int16_t, uhd::ntohx>(false));
+}
+
+UHD_STATIC_BLOCK(register_convert_pack_sc12_neon)
+{
+    uhd::convert::id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    id.input_format = "fc32";
+    id.output_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_fc32_1_to_sc12_item32_le_1_neon, PRIORITY_SIMD, "neon", "neon");
+    id.output_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_fc32_1_to_sc12_item32_be_1_neon, PRIORITY_SIMD, "neon", "neon");
+
+    id.input_format = "sc16";
+    id.output_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc16_1_to_sc12_item32_le_1_neon, PRIORITY_SIMD, "neon", "neon");
+    id.output_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc16_1_to_sc12_item32_be_1_neon, PRIORITY_SIMD, "neon", "neon");
+}
@@ -0,0 +1,256 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <arm_neon.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Put I/Q of 4 items32 sc16 into host order on a little endian host,
+ * the swaps are their own inverse, so they work for either direction
+ **********************************************************************/
+template <bool wire_le>
+static UHD_INLINE int16x8_t neon_sc16_item32_swap(const int16x8_t v){
+    if (wire_le) return vrev32q_s16(v);
+    return vreinterpretq_s16_u8(vrev16q_u8(vreinterpretq_u8_s16(v)));
+}
+
+/***********************************************************************
+ * fc32 to and from sc16 items32, truncated like the generic converters
+ **********************************************************************/
+template <xtox_t to_wire, bool wire_le>
+static UHD_INLINE void neon_fc32_to_item32_sc16(
+    const fc32_t *input, item32_t *output, const size_t nsamps, const double scale_factor
+){
+    const float32x4_t scalar = vdupq_n_f32(float(scale_factor));
+
+    size_t i = 0;
+    for (; i+3 < nsamps; i+=4){
+        /* load from input */
+        const float32x4_t lo = vld1q_f32(reinterpret_cast<const float *>(input+i+0));
+        const float32x4_t hi = vld1q_f32(reinterpret_cast<const float *>(input+i+2));
+
+        /* scale, convert and saturate */
+        const int16x4_t lo16 = vqmovn_s32(vcvtq_s32_f32(vmulq_f32(lo, scalar)));
+        const int16x4_t hi16 = vqmovn_s32(vcvtq_s32_f32(vmulq_f32(hi, scalar)));
+
+        /* put I/Q into wire order + store to output */
+        const int16x8_t out = neon_sc16_item32_swap<wire_le>(vcombine_s16(lo16, hi16));
+        vst1q_s16(reinterpret_cast<int16_t *>(output+i), out);
+    }
+
+    // convert any remaining samples
+    xx_to_item32_sc16<to_wire>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+template <xtox_t to_host, bool wire_le>
+static UHD_INLINE void neon_item32_sc16_to_fc32(
+    const item32_t *input, fc32_t *output, const size_t nsamps, const double scale_factor
+){
+    const float32x4_t scalar = vdupq_n_f32(float(scale_factor));
+
+    size_t i = 0;
+    for (; i+3 < nsamps; i+=4){
+        /* load from input + put I/Q into host order */
+        const int16x8_t in = neon_sc16_item32_swap<wire_le>(vld1q_s16(reinterpret_cast<const int16_t *>(input+i)));
+
+        /* sign extend, convert and scale */
+        const float32x4_t lo = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(in))), scalar);
+        const float32x4_t hi = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), scalar);
+
+        /* store to output */
+        vst1q_f32(reinterpret_cast<float *>(output+i+0), lo);
+        vst1q_f32(reinterpret_cast<float *>(output+i+2), hi);
+    }
+
+    // convert any remaining samples
+    item32_sc16_to_xx<to_host>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+/***********************************************************************
+ * sc16 to and from sc16 items32, a swap of 16-bit lanes
+ **********************************************************************/
+template <bool wire_le>
+static UHD_INLINE size_t neon_sc16_swap(const void *input, void *output, const size_t nsamps){
+    const int16_t *in = reinterpret_cast<const int16_t *>(input);
+    int16_t *out = reinterpret_cast<int16_t *>(output);
+
+    size_t i = 0;
+    for (; i+3 < nsamps; i+=4){
+        vst1q_s16(out+2*i, neon_sc16_item32_swap<wire_le>(vld1q_s16(in+2*i)));
+    }
+    return i;
+}
+
+/***********************************************************************
+ * fc64 to and from sc16 items32, AArch64 has double lanes
+ **********************************************************************/
+#if defined(__aarch64__)
+template <xtox_t to_wire, bool wire_le>
+static UHD_INLINE void neon_fc64_to_item32_sc16(
+    const fc64_t *input, item32_t *output, const size_t nsamps, const double scale_factor
+){
+    const float64x2_t scalar = vdupq_n_f64(scale_factor);
+
+    size_t i = 0;
+    for (; i+3 < nsamps; i+=4){
+        /* load from input, scale and convert */
+        const double *in = reinterpret_cast<const double *>(input+i);
+        const int32x2_t s0 = vmovn_s64(vcvtq_s64_f64(vmulq_f64(vld1q_f64(in+0), scalar)));
+        const int32x2_t s1 = vmovn_s64(vcvtq_s64_f64(vmulq_f64(vld1q_f64(in+2), scalar)));
+        const int32x2_t s2 = vmovn_s64(vcvtq_s64_f64(vmulq_f64(vld1q_f64(in+4), scalar)));
+        const int32x2_t s3 = vmovn_s64(vcvtq_s64_f64(vmulq_f64(vld1q_f64(in+6), scalar)));
+
+        /* saturate, put I/Q into wire order + store to output */
+        const int16x4_t lo16 = vqmovn_s32(vcombine_s32(s0, s1));
+        const int16x4_t hi16 = vqmovn_s32(vcombine_s32(s2, s3));
+        const int16x8_t out = neon_sc16_item32_swap<wire_le>(vcombine_s16(lo16, hi16));
+        vst1q_s16(reinterpret_cast<int16_t *>(output+i), out);
+    }
+
+    // convert any remaining samples
+    xx_to_item32_sc16<to_wire>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+template <xtox_t to_host, bool wire_le>
+static UHD_INLINE void neon_item32_sc16_to_fc64(
+    const item32_t *input, fc64_t *output, const size_t nsamps, const double scale_factor
+){
+    //the generic converter scales in single precision
+    const float32x4_t scalar = vdupq_n_f32(float(scale_factor));
+
+    size_t i = 0;
+    for (; i+3 < nsamps; i+=4){
+        /* load from input + put I/Q into host order */
+        const int16x8_t in = neon_sc16_item32_swap<wire_le>(vld1q_s16(reinterpret_cast<const int16_t *>(input+i)));
+
+        /* sign extend, convert and scale */
+        const float32x4_t lo = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(in))), scalar);
+        const float32x4_t hi = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), scalar);
+
+        /* widen to doubles + store to output */
+        double *out = reinterpret_cast<double *>(output+i);
+        vst1q_f64(out+0, vcvt_f64_f32(vget_low_f32(lo)));
+        vst1q_f64(out+2, vcvt_f64_f32(vget_high_f32(lo)));
+        vst1q_f64(out+4, vcvt_f64_f32(vget_low_f32(hi)));
+        vst1q_f64(out+6, vcvt_f64_f32(vget_high_f32(hi)));
+    }
+
+    // convert any remaining samples
+    item32_sc16_to_xx<to_host>(input+i, output+i, nsamps-i, scale_factor);
+}
+#endif /* __aarch64__ */
+
+/***********************************************************************
+ * The big endian wire formats, the little endian ones for fc32 and sc16
+ * have the assembly converters of convert_with_neon.cpp on 32-bit ARM
+ **********************************************************************/
+DECLARE_CONVERTER(fc32, 1, sc16_item32_be, 1, PRIORITY_SIMD){
+    neon_fc32_to_item32_sc16<uhd::htonx, false>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc16_item32_be, 1, fc32, 1, PRIORITY_SIMD){
+    neon_item32_sc16_to_fc32<uhd::ntohx, false>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc16, 1, sc16_item32_be, 1, PRIORITY_SIMD){
+    const sc16_t *input = reinterpret_cast<const sc16_t *>(inputs[0]);
+    item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
+    const size_t i = neon_sc16_swap<false>(input, output, nsamps);
+    xx_to_item32_sc16<uhd::htonx>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+DECLARE_CONVERTER(sc16_item32_be, 1, sc16, 1, PRIORITY_SIMD){
+    const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
+    sc16_t *output = reinterpret_cast<sc16_t *>(outputs[0]);
+    const size_t i = neon_sc16_swap<false>(input, output, nsamps);
+    item32_sc16_to_xx<uhd::ntohx>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+#if defined(__aarch64__)
+DECLARE_CONVERTER(fc32, 1, sc16_item32_le, 1, PRIORITY_SIMD){
+    neon_fc32_to_item32_sc16<uhd::htowx, true>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc16_item32_le, 1, fc32, 1, PRIORITY_SIMD){
+    neon_item32_sc16_to_fc32<uhd::wtohx, true>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc16, 1, sc16_item32_le, 1, PRIORITY_SIMD){
+    const sc16_t *input = reinterpret_cast<const sc16_t *>(inputs[0]);
+    item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
+    const size_t i = neon_sc16_swap<true>(input, output, nsamps);
+    xx_to_item32_sc16<uhd::htowx>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+DECLARE_CONVERTER(sc16_item32_le, 1, sc16, 1, PRIORITY_SIMD){
+    const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
+    sc16_t *output = reinterpret_cast<sc16_t *>(outputs[0]);
+    const size_t i = neon_sc16_swap<true>(input, output, nsamps);
+    item32_sc16_to_xx<uhd::wtohx>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+DECLARE_CONVERTER(fc64, 1, sc16_item32_le, 1, PRIORITY_SIMD){
+    neon_fc64_to_item32_sc16<uhd::htowx, true>(
+        reinterpret_cast<const fc64_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(fc64, 1, sc16_item32_be, 1, PRIORITY_SIMD){
+    neon_fc64_to_item32_sc16<uhd::htonx, false>(
+        reinterpret_cast<const fc64_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc16_item32_le, 1, fc64, 1, PRIORITY_SIMD){
+    neon_item32_sc16_to_fc64<uhd::wtohx, true>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc64_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc16_item32_be, 1, fc64, 1, PRIORITY_SIMD){
+    neon_item32_sc16_to_fc64<uhd::ntohx, false>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc64_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+#endif /* __aarch64__ */
@@ -0,0 +1,127 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <arm_neon.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Put I/Q of 8 samples in items32 sc8 into host order: the big endian
+ * items are I/Q interleaved bytes, the little endian ones have the bytes
+ * of each item reversed, the swap is its own inverse
+ **********************************************************************/
+template <bool wire_le>
+static UHD_INLINE int8x16_t neon_sc8_item32_swap(const int8x16_t v){
+    if (wire_le) return vrev32q_s8(v);
+    return v;
+}
+
+template <xtox_t to_wire, bool wire_le>
+static UHD_INLINE void neon_fc32_to_item32_sc8(
+    const fc32_t *input, item32_t *output, const size_t nsamps, const double scale_factor
+){
+    const float32x4_t scalar = vdupq_n_f32(float(scale_factor));
+
+    size_t i = 0;
+    for (; i+7 < nsamps; i+=8){
+        /* load from input, scale and convert */
+        const float *in = reinterpret_cast<const float *>(input+i);
+        const int32x4_t s0 = vcvtq_s32_f32(vmulq_f32(vld1q_f32(in+0), scalar));
+        const int32x4_t s1 = vcvtq_s32_f32(vmulq_f32(vld1q_f32(in+4), scalar));
+        const int32x4_t s2 = vcvtq_s32_f32(vmulq_f32(vld1q_f32(in+8), scalar));
+        const int32x4_t s3 = vcvtq_s32_f32(vmulq_f32(vld1q_f32(in+12), scalar));
+
+        /* saturate to bytes */
+        const int8x8_t lo = vqmovn_s16(vcombine_s16(vqmovn_s32(s0), vqmovn_s32(s1)));
+        const int8x8_t hi = vqmovn_s16(vcombine_s16(vqmovn_s32(s2), vqmovn_s32(s3)));
+
+        /* put I/Q into wire order + store to output */
+        vst1q_s8(reinterpret_cast<int8_t *>(output+i/2), neon_sc8_item32_swap<wire_le>(vcombine_s8(lo, hi)));
+    }
+
+    // convert any remaining samples
+    xx_to_item32_sc8<to_wire>(input+i, output+i/2, nsamps-i, scale_factor);
+}
+
+template <xtox_t to_host, bool wire_le>
+static UHD_INLINE void neon_item32_sc8_to_fc32(
+    const void *input0, fc32_t *output, const size_t nsamps, const double scale_factor
+){
+    const item32_t *input = reinterpret_cast<const item32_t *>(size_t(input0) & ~0x3);
+    const float32x4_t scalar = vdupq_n_f32(float(scale_factor));
+    fc32_t dummy;
+    size_t num_samps = nsamps;
+
+    //an unaligned start is the second sample of an item
+    if ((size_t(input0) & 0x3) != 0){
+        item32_sc8_x1_to_xx(to_host(*input++), dummy, *output++, scale_factor);
+        num_samps--;
+    }
+
+    size_t i = 0, j = 0;
+    for (; j+7 < num_samps; j+=8, i+=4){
+        /* load from input + put I/Q into host order */
+        const int8x16_t in = neon_sc8_item32_swap<wire_le>(vld1q_s8(reinterpret_cast<const int8_t *>(input+i)));
+
+        /* sign extend, convert and scale */
+        const int16x8_t lo = vmovl_s8(vget_low_s8(in));
+        const int16x8_t hi = vmovl_s8(vget_high_s8(in));
+        float *out = reinterpret_cast<float *>(output+j);
+        vst1q_f32(out+0, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(lo))), scalar));
+        vst1q_f32(out+4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(lo))), scalar));
+        vst1q_f32(out+8, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(hi))), scalar));
+        vst1q_f32(out+12, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(hi))), scalar));
+    }
+
+    //convert remainder
+    for (; j+1 < num_samps; j+=2, i++){
+        item32_sc8_x1_to_xx(to_host(input[i]), output[j], output[j+1], scale_factor);
+    }
+    if (j != num_samps){
+        item32_sc8_x1_to_xx(to_host(input[i]), output[j], dummy, scale_factor);
+    }
+}
+
+DECLARE_CONVERTER(fc32, 1, sc8_item32_be, 1, PRIORITY_SIMD){
+    neon_fc32_to_item32_sc8<uhd::htonx, false>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(fc32, 1, sc8_item32_le, 1, PRIORITY_SIMD){
+    neon_fc32_to_item32_sc8<uhd::htowx, true>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc8_item32_be, 1, fc32, 1, PRIORITY_SIMD){
+    neon_item32_sc8_to_fc32<uhd::ntohx, false>(
+        inputs[0], reinterpret_cast<fc32_t *>(outputs[0]), nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc8_item32_le, 1, fc32, 1, PRIORITY_SIMD){
+    neon_item32_sc8_to_fc32<uhd::wtohx, true>(
+        inputs[0], reinterpret_cast<fc32_t *>(outputs[0]), nsamps, scale_factor
+    );
+}
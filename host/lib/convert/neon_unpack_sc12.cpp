@@ -0,0 +1,123 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_sc12.hpp"
+#include <arm_neon.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Shuffle the bytes of a vector, the out of range control bytes are zero
+ **********************************************************************/
+static UHD_INLINE uint8x16_t neon_sc12_shuffle(const uint8x16_t v, const uint8x16_t ctrl){
+#if defined(__aarch64__)
+    return vqtbl1q_u8(v, ctrl);
+#else
+    uint8x8x2_t table;
+    table.val[0] = vget_low_u8(v);
+    table.val[1] = vget_high_u8(v);
+    return vcombine_u8(vtbl2_u8(table, vget_low_u8(ctrl)), vtbl2_u8(table, vget_high_u8(ctrl)));
+#endif
+}
+
+/***********************************************************************
+ * Store one 3 line block worth of unpacked 16-bit lanes
+ **********************************************************************/
+static UHD_INLINE void neon_sc12_store(
+    const int16x8_t v, std::complex<float> *output, const float32x4_t scalar
+){
+    //sign extend into 32 bits, convert and scale
+    const int32x4_t lo = vmovl_s16(vget_low_s16(v));
+    const int32x4_t hi = vmovl_s16(vget_high_s16(v));
+    vst1q_f32(reinterpret_cast<float *>(output+0), vmulq_f32(vcvtq_f32_s32(lo), scalar));
+    vst1q_f32(reinterpret_cast<float *>(output+2), vmulq_f32(vcvtq_f32_s32(hi), scalar));
+}
+
+static UHD_INLINE void neon_sc12_store(
+    const int16x8_t v, std::complex<int16_t> *output, const float32x4_t
+){
+    vst1q_s16(reinterpret_cast<int16_t *>(output), v);
+}
+
+template <typename type, tohost32_type tohost>
+struct convert_sc12_item32_1_to_star_1_neon : public convert_sc12_item32_1_to_star_1<type, tohost>
+{
+    convert_sc12_item32_1_to_star_1_neon(const bool wire_le)
+    {
+        sc12_unpack_shuffle_ctrl(wire_le, _ctrl);
+    }
+
+    size_t convert_blocks(const item32_sc12_3x *input, std::complex<type> *output, const size_t nblocks)
+    {
+        static const uint16_t mult_lanes[8] = {1, 16, 1, 16, 1, 16, 1, 16}; //Q << 4
+        const uint8x16_t ctrl = vld1q_u8(_ctrl);
+        const uint16x8_t mult = vld1q_u16(mult_lanes);
+        const uint16x8_t mask = vdupq_n_u16(0xfff0);
+        const float32x4_t scalar = vdupq_n_f32(float(this->_scalar));
+
+        //the load reads 4 bytes into the next block, so leave the last one to the generic code
+        size_t b = 0;
+        for (; b+1 < nblocks; b++)
+        {
+            const uint8x16_t v = neon_sc12_shuffle(vld1q_u8(reinterpret_cast<const uint8_t *>(input+b)), ctrl);
+            const uint16x8_t u = vandq_u16(vmulq_u16(vreinterpretq_u16_u8(v), mult), mask);
+            neon_sc12_store(vreinterpretq_s16_u16(u), output+4*b, scalar);
+        }
+        return b;
+    }
+
+    uint8_t _ctrl[16];
+};
+
+static converter::sptr make_convert_sc12_item32_le_1_to_fc32_1_neon(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_neon<float, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc12_item32_be_1_to_fc32_1_neon(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_neon<float, uhd::ntohx>(false));
+}
+
+static converter::sptr make_convert_sc12_item32_le_1_to_sc16_1_neon(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_neon<int16_t, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc12_item32_be_1_to_sc16_1_neon(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_neon<int16_t, uhd::ntohx>(false));
+}
+
+UHD_STATIC_BLOCK(register_convert_unpack_sc12_neon)
+{
+    uhd::convert::id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    id.output_format = "fc32";
+    id.input_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_le_1_to_fc32_1_neon, PRIORITY_SIMD, "neon", "neon");
+    id.input_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_be_1_to_fc32_1_neon, PRIORITY_SIMD, "neon", "neon");
+
+    id.output_format = "sc16";
+    id.input_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_le_1_to_sc16_1_neon, PRIORITY_SIMD, "neon", "neon");
+    id.input_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_be_1_to_sc16_1_neon, PRIORITY_SIMD, "neon", "neon");
+}
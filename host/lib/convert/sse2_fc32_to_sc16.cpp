@@ -119,3 +119,67 @@ DECLARE_CONVERTER(fc32, 1, sc16_item32_be, 1, PRIORITY_SIMD){
     // convert any remaining samples
     xx_to_item32_sc16<uhd::htonx>(input+i, output+i, nsamps-i, scale_factor);
 }
+
+/***********************************************************************
+ * Interleave 2 or 4 planar fc32 buffers into items32
+ **********************************************************************/
+template <bool bswap>
+static UHD_INLINE void sse2_fc32_4x_to_item32_sc16(
+    const __m128 &lo, const __m128 &hi, const __m128 &scalar, item32_t *output
+){
+    /* convert and scale */
+    __m128i tmpilo = _mm_cvtps_epi32(_mm_mul_ps(lo, scalar));
+    __m128i tmpihi = _mm_cvtps_epi32(_mm_mul_ps(hi, scalar));
+
+    /* pack + put I/Q into wire order */
+    __m128i tmpi = _mm_packs_epi32(tmpilo, tmpihi);
+    if (bswap){
+        tmpi = _mm_or_si128(_mm_srli_epi16(tmpi, 8), _mm_slli_epi16(tmpi, 8));
+    }
+    else{
+        tmpi = _mm_shufflelo_epi16(tmpi, _MM_SHUFFLE(2, 3, 0, 1));
+        tmpi = _mm_shufflehi_epi16(tmpi, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    /* store to output */
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output), tmpi);
+}
+
+template <xtox_t to_wire, bool bswap, size_t width>
+static UHD_INLINE void sse2_fc32_planar_to_item32_sc16(
+    const fc32_t *const *inputs, item32_t *output,
+    const size_t nsamps, const double scale_factor
+){
+    const __m128 scalar = _mm_set_ps1(float(scale_factor));
+
+    size_t i = 0;
+    for (; width == 2 and i+1 < nsamps; i+=2){
+        const __m128 tmp0 = _mm_loadu_ps(reinterpret_cast<const float *>(inputs[0]+i)); //[a0 a1]
+        const __m128 tmp1 = _mm_loadu_ps(reinterpret_cast<const float *>(inputs[1]+i)); //[b0 b1]
+        sse2_fc32_4x_to_item32_sc16<bswap>(_mm_movelh_ps(tmp0, tmp1), _mm_movehl_ps(tmp1, tmp0), scalar, output+i*2);
+    }
+    for (; width == 4 and i+1 < nsamps; i+=2){
+        const __m128 tmp0 = _mm_loadu_ps(reinterpret_cast<const float *>(inputs[0]+i));
+        const __m128 tmp1 = _mm_loadu_ps(reinterpret_cast<const float *>(inputs[1]+i));
+        const __m128 tmp2 = _mm_loadu_ps(reinterpret_cast<const float *>(inputs[2]+i));
+        const __m128 tmp3 = _mm_loadu_ps(reinterpret_cast<const float *>(inputs[3]+i));
+        sse2_fc32_4x_to_item32_sc16<bswap>(_mm_movelh_ps(tmp0, tmp1), _mm_movelh_ps(tmp2, tmp3), scalar, output+i*4+0);
+        sse2_fc32_4x_to_item32_sc16<bswap>(_mm_movehl_ps(tmp1, tmp0), _mm_movehl_ps(tmp3, tmp2), scalar, output+i*4+4);
+    }
+
+    // convert any remaining samples
+    xx_planar_to_item32_sc16<to_wire, width>(inputs, output, i, nsamps, scale_factor);
+}
+
+#define DECLARE_SSE2_FC32_PLANAR_TO_SC16(width, xe, to_wire, bswap) \
+    DECLARE_CONVERTER(fc32, width, sc16_item32_ ## xe, 1, PRIORITY_SIMD){ \
+        const fc32_t *input[width]; \
+        for (size_t w = 0; w < width; w++) input[w] = reinterpret_cast<const fc32_t *>(inputs[w]); \
+        sse2_fc32_planar_to_item32_sc16<to_wire, bswap, width>( \
+            input, reinterpret_cast<item32_t *>(outputs[0]), nsamps, scale_factor); \
+    }
+
+DECLARE_SSE2_FC32_PLANAR_TO_SC16(2, le, uhd::htowx, false)
+DECLARE_SSE2_FC32_PLANAR_TO_SC16(2, be, uhd::htonx, true)
+DECLARE_SSE2_FC32_PLANAR_TO_SC16(4, le, uhd::htowx, false)
+DECLARE_SSE2_FC32_PLANAR_TO_SC16(4, be, uhd::htonx, true)
@@ -21,10 +21,71 @@
 
 using namespace uhd::convert;
 
-DECLARE_CONVERTER(sc16_item32_le, 1, fc32, 1, PRIORITY_SIMD){
+//! swap the 16-bit halves of each item32 (little endian wire)
+static UHD_INLINE __m128i sse2_item32_nswap(const __m128i v){
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+//! byteswap each 16-bit word (big endian wire)
+static UHD_INLINE __m128i sse2_item32_bswap(const __m128i v){
+    return _mm_or_si128(_mm_srli_epi16(v, 8), _mm_slli_epi16(v, 8));
+}
+
+/***********************************************************************
+ * Conversion with a complex gain and offset:
+ * out.re = in.re*gain.re - in.im*gain.im + offset.re
+ * out.im = in.re*gain.im + in.im*gain.re + offset.im
+ * The gain is multiplied with the samples and the I/Q swapped samples.
+ **********************************************************************/
+template <xtox_t to_host, bool bswap>
+static UHD_INLINE void sse2_item32_sc16_to_fc32_corrected(
+    const item32_t *input, fc32_t *output, const size_t nsamps,
+    const double scale_factor, const std::complex<double> &gain,
+    const std::complex<double> &offset
+){
+    const float gain_re = float(gain.real()*scale_factor)/(1 << 16);
+    const float gain_im = float(gain.imag()*scale_factor)/(1 << 16);
+    const __m128 gainre = _mm_set_ps1(gain_re);
+    const __m128 gainim = _mm_set_ps(gain_im, -gain_im, gain_im, -gain_im);
+    const __m128 offs = _mm_set_ps(
+        float(offset.imag()), float(offset.real()),
+        float(offset.imag()), float(offset.real())
+    );
+    const __m128i zeroi = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i+3 < nsamps; i+=4){
+        /* load from input + put I/Q into host order */
+        __m128i tmpi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i));
+        tmpi = bswap? sse2_item32_bswap(tmpi) : sse2_item32_nswap(tmpi);
+        __m128 tmplo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(zeroi, tmpi)); /* value in upper 16 bits */
+        __m128 tmphi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(zeroi, tmpi));
+
+        /* complex multiply and offset */
+        tmplo = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tmplo, gainre), offs),
+            _mm_mul_ps(_mm_shuffle_ps(tmplo, tmplo, _MM_SHUFFLE(2, 3, 0, 1)), gainim));
+        tmphi = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tmphi, gainre), offs),
+            _mm_mul_ps(_mm_shuffle_ps(tmphi, tmphi, _MM_SHUFFLE(2, 3, 0, 1)), gainim));
+
+        /* store to output */
+        _mm_storeu_ps(reinterpret_cast<float *>(output+i+0), tmplo);
+        _mm_storeu_ps(reinterpret_cast<float *>(output+i+2), tmphi);
+    }
+
+    // convert any remaining samples
+    item32_sc16_to_fc32_corrected<to_host>(input+i, output+i, nsamps-i, scale_factor, gain, offset);
+}
+
+DECLARE_CORRECTING_CONVERTER(sc16_item32_le, 1, fc32, 1, PRIORITY_SIMD){
     const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
     fc32_t *output = reinterpret_cast<fc32_t *>(outputs[0]);
 
+    if (has_correction()){
+        sse2_item32_sc16_to_fc32_corrected<uhd::htowx, false>(
+            input, output, nsamps, scale_factor, gain, offset);
+        return;
+    }
+
     const __m128 scalar = _mm_set_ps1(float(scale_factor)/(1 << 16));
     const __m128i zeroi = _mm_setzero_si128();
 
@@ -73,10 +134,16 @@ DECLARE_CONVERTER(sc16_item32_le, 1, fc32, 1, PRIORITY_SIMD){
     item32_sc16_to_xx<uhd::htowx>(input+i, output+i, nsamps-i, scale_factor);
 }
 
-DECLARE_CONVERTER(sc16_item32_be, 1, fc32, 1, PRIORITY_SIMD){
+DECLARE_CORRECTING_CONVERTER(sc16_item32_be, 1, fc32, 1, PRIORITY_SIMD){
     const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
     fc32_t *output = reinterpret_cast<fc32_t *>(outputs[0]);
 
+    if (has_correction()){
+        sse2_item32_sc16_to_fc32_corrected<uhd::htonx, true>(
+            input, output, nsamps, scale_factor, gain, offset);
+        return;
+    }
+
     const __m128 scalar = _mm_set_ps1(float(scale_factor)/(1 << 16));
     const __m128i zeroi = _mm_setzero_si128();
 
@@ -123,3 +190,62 @@ DECLARE_CONVERTER(sc16_item32_be, 1, fc32, 1, PRIORITY_SIMD){
     // convert any remaining samples
     item32_sc16_to_xx<uhd::htonx>(input+i, output+i, nsamps-i, scale_factor);
 }
+
+/***********************************************************************
+ * De-interleave 2 or 4 channels of items32 into planar fc32 buffers
+ **********************************************************************/
+template <bool bswap>
+static UHD_INLINE void sse2_item32_sc16_4x_to_fc32(
+    const item32_t *input, const __m128 &scalar, __m128 &lo, __m128 &hi
+){
+    const __m128i zeroi = _mm_setzero_si128();
+
+    /* load from input + put I/Q into host order */
+    __m128i tmpi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input));
+    tmpi = bswap? sse2_item32_bswap(tmpi) : sse2_item32_nswap(tmpi);
+
+    /* convert and scale, value in upper 16 bits */
+    lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(zeroi, tmpi)), scalar);
+    hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(zeroi, tmpi)), scalar);
+}
+
+template <xtox_t to_host, bool bswap, size_t width>
+static UHD_INLINE void sse2_item32_sc16_to_fc32_planar(
+    const item32_t *input, fc32_t *const *outputs,
+    const size_t nsamps, const double scale_factor
+){
+    const __m128 scalar = _mm_set_ps1(float(scale_factor)/(1 << 16));
+
+    size_t i = 0;
+    for (; width == 2 and i+1 < nsamps; i+=2){
+        __m128 tmp0, tmp1; //[a0 b0] [a1 b1]
+        sse2_item32_sc16_4x_to_fc32<bswap>(input+i*2, scalar, tmp0, tmp1);
+        _mm_storeu_ps(reinterpret_cast<float *>(outputs[0]+i), _mm_movelh_ps(tmp0, tmp1));
+        _mm_storeu_ps(reinterpret_cast<float *>(outputs[1]+i), _mm_movehl_ps(tmp1, tmp0));
+    }
+    for (; width == 4 and i+1 < nsamps; i+=2){
+        __m128 tmp0, tmp1, tmp2, tmp3; //[a0 b0] [c0 d0] [a1 b1] [c1 d1]
+        sse2_item32_sc16_4x_to_fc32<bswap>(input+i*4+0, scalar, tmp0, tmp1);
+        sse2_item32_sc16_4x_to_fc32<bswap>(input+i*4+4, scalar, tmp2, tmp3);
+        _mm_storeu_ps(reinterpret_cast<float *>(outputs[0]+i), _mm_movelh_ps(tmp0, tmp2));
+        _mm_storeu_ps(reinterpret_cast<float *>(outputs[1]+i), _mm_movehl_ps(tmp2, tmp0));
+        _mm_storeu_ps(reinterpret_cast<float *>(outputs[2]+i), _mm_movelh_ps(tmp1, tmp3));
+        _mm_storeu_ps(reinterpret_cast<float *>(outputs[3]+i), _mm_movehl_ps(tmp3, tmp1));
+    }
+
+    // convert any remaining samples
+    item32_sc16_to_xx_planar<to_host, width>(input, outputs, i, nsamps, scale_factor);
+}
+
+#define DECLARE_SSE2_SC16_TO_FC32_PLANAR(width, xe, to_host, bswap) \
+    DECLARE_CONVERTER(sc16_item32_ ## xe, 1, fc32, width, PRIORITY_SIMD){ \
+        fc32_t *output[width]; \
+        for (size_t w = 0; w < width; w++) output[w] = reinterpret_cast<fc32_t *>(outputs[w]); \
+        sse2_item32_sc16_to_fc32_planar<to_host, bswap, width>( \
+            reinterpret_cast<const item32_t *>(inputs[0]), output, nsamps, scale_factor); \
+    }
+
+DECLARE_SSE2_SC16_TO_FC32_PLANAR(2, le, uhd::htowx, false)
+DECLARE_SSE2_SC16_TO_FC32_PLANAR(2, be, uhd::htonx, true)
+DECLARE_SSE2_SC16_TO_FC32_PLANAR(4, le, uhd::htowx, false)
+DECLARE_SSE2_SC16_TO_FC32_PLANAR(4, be, uhd::htonx, true)
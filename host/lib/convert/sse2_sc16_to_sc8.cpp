@@ -0,0 +1,118 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <emmintrin.h>
+#include <algorithm>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Replaces the sc16 to sc8 lookup table of convert_with_tables.cpp,
+ * the 64K entry table does not fit into L1 and is built per instance.
+ * The scaling matches the table: round(num*scalar/32767) with halves
+ * rounded away from zero, except that the results are saturated instead
+ * of wrapped around.
+ **********************************************************************/
+static UHD_INLINE item32_t sc16_x1_to_sc8(const int16_t num, const double scale_factor){
+    const int val = boost::math::iround(num*scale_factor/32767.);
+    return uint8_t(int8_t(std::max(-128, std::min(127, val))));
+}
+
+//! same item layout as xx_to_item32_sc8_x1()
+static UHD_INLINE item32_t sc16_x2_to_item32_sc8(
+    const sc16_t &in0, const sc16_t &in1, const double scale_factor
+){
+    return
+        (sc16_x1_to_sc8(in1.real(), scale_factor) << 8) |
+        (sc16_x1_to_sc8(in1.imag(), scale_factor) << 0) |
+        (sc16_x1_to_sc8(in0.real(), scale_factor) << 24) |
+        (sc16_x1_to_sc8(in0.imag(), scale_factor) << 16)
+    ;
+}
+
+//! round like boost::math::iround(): add 0.5 with the sign of the value and truncate
+static UHD_INLINE __m128i sse2_round_4x(const __m128 &in){
+    const __m128 half = _mm_or_ps(_mm_and_ps(in, _mm_set_ps1(-0.0f)), _mm_set_ps1(0.5f));
+    return _mm_cvttps_epi32(_mm_add_ps(in, half));
+}
+
+template <const int shuf>
+static UHD_INLINE __m128i sse2_scale_sc16_4x(const __m128i &in, const __m128 &scalar){
+    const __m128i zeroi = _mm_setzero_si128();
+
+    /* sign extend, convert and scale */
+    const __m128i tmpilo = _mm_srai_epi32(_mm_unpacklo_epi16(zeroi, in), 16);
+    const __m128i tmpihi = _mm_srai_epi32(_mm_unpackhi_epi16(zeroi, in), 16);
+    __m128i tmpi0 = sse2_round_4x(_mm_mul_ps(_mm_cvtepi32_ps(tmpilo), scalar));
+    __m128i tmpi1 = sse2_round_4x(_mm_mul_ps(_mm_cvtepi32_ps(tmpihi), scalar));
+
+    /* put I/Q into wire order */
+    tmpi0 = _mm_shuffle_epi32(tmpi0, shuf);
+    tmpi1 = _mm_shuffle_epi32(tmpi1, shuf);
+    return _mm_packs_epi32(tmpi0, tmpi1);
+}
+
+template <const int shuf, xtox_t to_wire>
+static UHD_INLINE void sse2_sc16_to_item32_sc8(
+    const sc16_t *input, item32_t *output, const size_t nsamps, const double scale_factor
+){
+    const __m128 scalar = _mm_set_ps1(float(scale_factor/32767.));
+
+    size_t i = 0;
+    for (size_t j = 0; i+7 < nsamps; i+=8, j+=4){
+        /* load from input */
+        const __m128i tmp0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i+0));
+        const __m128i tmp1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i+4));
+
+        /* convert */
+        const __m128i tmpi = _mm_packs_epi16(
+            sse2_scale_sc16_4x<shuf>(tmp0, scalar),
+            sse2_scale_sc16_4x<shuf>(tmp1, scalar)
+        );
+
+        /* store to output */
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output+j), tmpi);
+    }
+
+    //convert remainder
+    const size_t num_pairs = (nsamps-i)/2;
+    for (size_t k = 0; k < num_pairs; k++, i+=2){
+        output[i/2] = to_wire(sc16_x2_to_item32_sc8(input[i], input[i+1], scale_factor));
+    }
+    if (i != nsamps){
+        output[i/2] = to_wire(sc16_x2_to_item32_sc8(input[i], sc16_t(0), scale_factor));
+    }
+}
+
+DECLARE_CONVERTER(sc16, 1, sc8_item32_be, 1, PRIORITY_SIMD){
+    sse2_sc16_to_item32_sc8<_MM_SHUFFLE(3, 2, 1, 0), uhd::htonx>(
+        reinterpret_cast<const sc16_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc16, 1, sc8_item32_le, 1, PRIORITY_SIMD){
+    sse2_sc16_to_item32_sc8<_MM_SHUFFLE(0, 1, 2, 3), uhd::htowx>(
+        reinterpret_cast<const sc16_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]),
+        nsamps, scale_factor
+    );
+}
@@ -0,0 +1,131 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <algorithm>
+#include <emmintrin.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * The RX converters with streaming stores.
+ *
+ * Streaming stores write to memory without pulling the output into the
+ * cache, which keeps the working set of the application cached when
+ * recv() fills buffers larger than the last level cache.
+ * The stores need an aligned output, so the first samples are converted
+ * with the generic code. An output which can never be aligned is
+ * converted with the generic code entirely.
+ **********************************************************************/
+
+//! Put the 16 bit I/Q of 4 items into host order
+static UHD_INLINE __m128i sse2_item32_sc16_to_host(const __m128i in, const bool wire_le){
+    //little endian items hold Q first, swap 16-bit pairs
+    if (wire_le) return _mm_shufflehi_epi16(_mm_shufflelo_epi16(in, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    //big endian items hold I first, byteswap 16 bit words
+    return _mm_or_si128(_mm_srli_epi16(in, 8), _mm_slli_epi16(in, 8));
+}
+
+template <xtox_t to_host>
+static UHD_INLINE void sse2_item32_sc16_to_fc32_nt(
+    const item32_t *input, fc32_t *output, const size_t nsamps,
+    const double scale_factor, const bool wire_le
+){
+    const __m128 scalar = _mm_set_ps1(float(scale_factor));
+    const __m128i zeroi = _mm_setzero_si128();
+
+    size_t i = 0;
+    if ((size_t(output) & 0x7) != 0) i = nsamps;
+    else if ((size_t(output) & 0xf) != 0) i = std::min<size_t>(1, nsamps);
+    item32_sc16_to_xx<to_host>(input, output, i, scale_factor);
+
+    for (; i+3 < nsamps; i+=4){
+        /* load from input + put I/Q into host order */
+        __m128i tmpi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i));
+        tmpi = sse2_item32_sc16_to_host(tmpi, wire_le);
+
+        /* sign extend, convert and scale */
+        __m128i tmpilo = _mm_srai_epi32(_mm_unpacklo_epi16(zeroi, tmpi), 16);
+        __m128i tmpihi = _mm_srai_epi32(_mm_unpackhi_epi16(zeroi, tmpi), 16);
+        __m128 tmplo = _mm_mul_ps(_mm_cvtepi32_ps(tmpilo), scalar);
+        __m128 tmphi = _mm_mul_ps(_mm_cvtepi32_ps(tmpihi), scalar);
+
+        /* stream to output */
+        _mm_stream_ps(reinterpret_cast<float *>(output+i+0), tmplo);
+        _mm_stream_ps(reinterpret_cast<float *>(output+i+2), tmphi);
+    }
+    _mm_sfence();
+
+    // convert any remaining samples
+    item32_sc16_to_xx<to_host>(input+i, output+i, nsamps-i, scale_factor);
+}
+
+template <xtox_t to_host>
+static UHD_INLINE void sse2_item32_sc16_to_sc16_nt(
+    const item32_t *input, sc16_t *output, const size_t nsamps, const bool wire_le
+){
+    size_t i = 0;
+    if ((size_t(output) & 0x3) != 0) i = nsamps;
+    else i = std::min<size_t>(((16 - (size_t(output) & 0xf)) & 0xf)/4, nsamps);
+    item32_sc16_to_xx<to_host>(input, output, i, 1.0);
+
+    for (; i+3 < nsamps; i+=4){
+        /* load from input + put I/Q into host order */
+        __m128i tmpi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i));
+        tmpi = sse2_item32_sc16_to_host(tmpi, wire_le);
+
+        /* stream to output */
+        _mm_stream_si128(reinterpret_cast<__m128i *>(output+i), tmpi);
+    }
+    _mm_sfence();
+
+    // convert any remaining samples
+    item32_sc16_to_xx<to_host>(input+i, output+i, nsamps-i, 1.0);
+}
+
+DECLARE_CONVERTER(sc16_item32_le, 1, fc32, 1, PRIORITY_SIMD_NT){
+    sse2_item32_sc16_to_fc32_nt<uhd::wtohx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc32_t *>(outputs[0]),
+        nsamps, scale_factor, true
+    );
+}
+
+DECLARE_CONVERTER(sc16_item32_be, 1, fc32, 1, PRIORITY_SIMD_NT){
+    sse2_item32_sc16_to_fc32_nt<uhd::ntohx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<fc32_t *>(outputs[0]),
+        nsamps, scale_factor, false
+    );
+}
+
+DECLARE_CONVERTER(sc16_item32_le, 1, sc16, 1, PRIORITY_SIMD_NT){
+    sse2_item32_sc16_to_sc16_nt<uhd::wtohx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<sc16_t *>(outputs[0]),
+        nsamps, true
+    );
+}
+
+DECLARE_CONVERTER(sc16_item32_be, 1, sc16, 1, PRIORITY_SIMD_NT){
+    sse2_item32_sc16_to_sc16_nt<uhd::ntohx>(
+        reinterpret_cast<const item32_t *>(inputs[0]),
+        reinterpret_cast<sc16_t *>(outputs[0]),
+        nsamps, false
+    );
+}
@@ -0,0 +1,107 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <emmintrin.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Replaces the sc8 to sc16 lookup table of convert_with_tables.cpp,
+ * the 64K entry table does not fit into L1 and is built per instance.
+ * The scaling matches the table: round(num*scalar*32767).
+ **********************************************************************/
+static UHD_INLINE int16_t sc8_x1_to_sc16(const item32_t num, const double scale_factor){
+    return int16_t(boost::math::iround(int8_t(num)*scale_factor*32767));
+}
+
+//! same item layout as item32_sc8_x1_to_xx()
+static UHD_INLINE void item32_sc8_to_sc16_x2(
+    const item32_t item, sc16_t &out0, sc16_t &out1, const double scale_factor
+){
+    out1 = sc16_t(sc8_x1_to_sc16(item >> 8, scale_factor), sc8_x1_to_sc16(item >> 0, scale_factor));
+    out0 = sc16_t(sc8_x1_to_sc16(item >> 24, scale_factor), sc8_x1_to_sc16(item >> 16, scale_factor));
+}
+
+template <const int shuf>
+static UHD_INLINE __m128i sse2_scale_sc8_2x(const __m128i &in, const __m128 &scalar){
+    const __m128i zeroi = _mm_setzero_si128();
+
+    /* sign extend the bytes (value in upper 8 bits of in), convert and scale */
+    const __m128i tmpilo = _mm_srai_epi32(_mm_unpacklo_epi16(zeroi, in), 24);
+    const __m128i tmpihi = _mm_srai_epi32(_mm_unpackhi_epi16(zeroi, in), 24);
+    __m128i tmpi0 = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(tmpilo), scalar));
+    __m128i tmpi1 = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(tmpihi), scalar));
+
+    /* put I/Q into host order */
+    tmpi0 = _mm_shuffle_epi32(tmpi0, shuf);
+    tmpi1 = _mm_shuffle_epi32(tmpi1, shuf);
+    return _mm_packs_epi32(tmpi0, tmpi1);
+}
+
+template <const int shuf, xtox_t to_host>
+static UHD_INLINE void sse2_item32_sc8_to_sc16(
+    const void *input0, sc16_t *output, const size_t nsamps, const double scale_factor
+){
+    const item32_t *input = reinterpret_cast<const item32_t *>(size_t(input0) & ~0x3);
+    const __m128i zeroi = _mm_setzero_si128();
+    const __m128 scalar = _mm_set_ps1(float(scale_factor*32767));
+    sc16_t dummy;
+    size_t num_samps = nsamps;
+
+    //an unaligned start is the second sample of an item
+    if ((size_t(input0) & 0x3) != 0){
+        item32_sc8_to_sc16_x2(to_host(*input++), dummy, *output++, scale_factor);
+        num_samps--;
+    }
+
+    size_t i = 0, j = 0;
+    for (; j+7 < num_samps; j+=8, i+=4){
+        /* load from input */
+        const __m128i tmpi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i));
+
+        /* convert */
+        const __m128i tmp0 = sse2_scale_sc8_2x<shuf>(_mm_unpacklo_epi8(zeroi, tmpi), scalar);
+        const __m128i tmp1 = sse2_scale_sc8_2x<shuf>(_mm_unpackhi_epi8(zeroi, tmpi), scalar);
+
+        /* store to output */
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output+j+0), tmp0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output+j+4), tmp1);
+    }
+
+    //convert remainder
+    for (; j+1 < num_samps; j+=2, i++){
+        item32_sc8_to_sc16_x2(to_host(input[i]), output[j], output[j+1], scale_factor);
+    }
+    if (j != num_samps){
+        item32_sc8_to_sc16_x2(to_host(input[i]), output[j], dummy, scale_factor);
+    }
+}
+
+DECLARE_CONVERTER(sc8_item32_be, 1, sc16, 1, PRIORITY_SIMD){
+    sse2_item32_sc8_to_sc16<_MM_SHUFFLE(3, 2, 1, 0), uhd::ntohx>(
+        inputs[0], reinterpret_cast<sc16_t *>(outputs[0]), nsamps, scale_factor
+    );
+}
+
+DECLARE_CONVERTER(sc8_item32_le, 1, sc16, 1, PRIORITY_SIMD){
+    sse2_item32_sc8_to_sc16<_MM_SHUFFLE(0, 1, 2, 3), uhd::wtohx>(
+        inputs[0], reinterpret_cast<sc16_t *>(outputs[0]), nsamps, scale_factor
+    );
+}
@@ -0,0 +1,113 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_sc12.hpp"
+#include <tmmintrin.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Load 4 samples as 12 bit numbers in the lower bits of 16-bit lanes
+ **********************************************************************/
+static UHD_INLINE UHD_TARGET_SSSE3 __m128i ssse3_sc12_load(
+    const std::complex<float> *input, const __m128 scalar
+){
+    //convert, scale, truncate and mask like the generic converter
+    const __m128i mask = _mm_set1_epi32(0xfff);
+    const __m128 lo = _mm_loadu_ps(reinterpret_cast<const float *>(input+0));
+    const __m128 hi = _mm_loadu_ps(reinterpret_cast<const float *>(input+2));
+    const __m128i lo_i = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(lo, scalar)), mask);
+    const __m128i hi_i = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(hi, scalar)), mask);
+    return _mm_packs_epi32(lo_i, hi_i);
+}
+
+static UHD_INLINE UHD_TARGET_SSSE3 __m128i ssse3_sc12_load(
+    const std::complex<int16_t> *input, const __m128
+){
+    //keep the upper 12 bits
+    return _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input)), 4);
+}
+
+template <typename type, towire32_type towire>
+struct convert_star_1_to_sc12_item32_1_ssse3 : public convert_star_1_to_sc12_item32_1<type, towire>
+{
+    convert_star_1_to_sc12_item32_1_ssse3(const bool wire_le)
+    {
+        sc12_pack_shuffle_ctrls(wire_le, _ctrl_a, _ctrl_b);
+    }
+
+    UHD_TARGET_SSSE3 size_t convert_blocks(const std::complex<type> *input, item32_sc12_3x *output, const size_t nblocks)
+    {
+        const __m128i ctrl_a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_ctrl_a));
+        const __m128i ctrl_b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_ctrl_b));
+        const __m128i mult = _mm_set_epi16(1, 16, 1, 16, 1, 16, 1, 16); //I << 4
+        const __m128 scalar = _mm_set1_ps(float(this->_scalar));
+
+        //the store writes 4 bytes into the next block, so leave the last one to the generic code
+        size_t b = 0;
+        for (; b+1 < nblocks; b++)
+        {
+            __m128i v = _mm_mullo_epi16(ssse3_sc12_load(input+4*b, scalar), mult);
+            v = _mm_or_si128(_mm_shuffle_epi8(v, ctrl_a), _mm_shuffle_epi8(v, ctrl_b));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output+b), v);
+        }
+        return b;
+    }
+
+    uint8_t _ctrl_a[16], _ctrl_b[16];
+};
+
+static converter::sptr make_convert_fc32_1_to_sc12_item32_le_1_ssse3(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_ssse3<float, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_fc32_1_to_sc12_item32_be_1_ssse3(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_ssse3<float, uhd::ntohx>(false));
+}
+
+static converter::sptr make_convert_sc16_1_to_sc12_item32_le_1_ssse3(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_ssse3<int16_t, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc16_1_to_sc12_item32_be_1_ssse3(void)
+{
+    return converter::sptr(new convert_star_1_to_sc12_item32_1_ssse3<int16_t, uhd::ntohx>(false));
+}
+
+UHD_STATIC_BLOCK(register_convert_pack_sc12_ssse3)
+{
+    if (not cpu_has_ssse3()) return;
+
+    uhd::convert::id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    id.input_format = "fc32";
+    id.output_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_fc32_1_to_sc12_item32_le_1_ssse3, PRIORITY_SIMD, "ssse3", "ssse3");
+    id.output_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_fc32_1_to_sc12_item32_be_1_ssse3, PRIORITY_SIMD, "ssse3", "ssse3");
+
+    id.input_format = "sc16";
+    id.output_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc16_1_to_sc12_item32_le_1_ssse3, PRIORITY_SIMD, "ssse3", "ssse3");
+    id.output_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc16_1_to_sc12_item32_be_1_ssse3, PRIORITY_SIMD, "ssse3", "ssse3");
+}
@@ -0,0 +1,112 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_sc12.hpp"
+#include <tmmintrin.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Store one 3 line block worth of unpacked 16-bit lanes
+ **********************************************************************/
+static UHD_INLINE UHD_TARGET_SSSE3 void ssse3_sc12_store(
+    const __m128i v, std::complex<float> *output, const __m128 scalar
+){
+    //sign extend into 32 bits, convert and scale
+    const __m128i zeroi = _mm_setzero_si128();
+    const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(zeroi, v), 16);
+    const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(zeroi, v), 16);
+    _mm_storeu_ps(reinterpret_cast<float *>(output+0), _mm_mul_ps(_mm_cvtepi32_ps(lo), scalar));
+    _mm_storeu_ps(reinterpret_cast<float *>(output+2), _mm_mul_ps(_mm_cvtepi32_ps(hi), scalar));
+}
+
+static UHD_INLINE UHD_TARGET_SSSE3 void ssse3_sc12_store(
+    const __m128i v, std::complex<int16_t> *output, const __m128
+){
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output), v);
+}
+
+template <typename type, tohost32_type tohost>
+struct convert_sc12_item32_1_to_star_1_ssse3 : public convert_sc12_item32_1_to_star_1<type, tohost>
+{
+    convert_sc12_item32_1_to_star_1_ssse3(const bool wire_le)
+    {
+        sc12_unpack_shuffle_ctrl(wire_le, _ctrl);
+    }
+
+    UHD_TARGET_SSSE3 size_t convert_blocks(const item32_sc12_3x *input, std::complex<type> *output, const size_t nblocks)
+    {
+        const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_ctrl));
+        const __m128i mult = _mm_set_epi16(16, 1, 16, 1, 16, 1, 16, 1); //Q << 4
+        const __m128i mask = _mm_set1_epi16(short(0xfff0));
+        const __m128 scalar = _mm_set1_ps(float(this->_scalar));
+
+        //the load reads 4 bytes into the next block, so leave the last one to the generic code
+        size_t b = 0;
+        for (; b+1 < nblocks; b++)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+b));
+            v = _mm_shuffle_epi8(v, ctrl);
+            v = _mm_and_si128(_mm_mullo_epi16(v, mult), mask);
+            ssse3_sc12_store(v, output+4*b, scalar);
+        }
+        return b;
+    }
+
+    uint8_t _ctrl[16];
+};
+
+static converter::sptr make_convert_sc12_item32_le_1_to_fc32_1_ssse3(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_ssse3<float, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc12_item32_be_1_to_fc32_1_ssse3(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_ssse3<float, uhd::ntohx>(false));
+}
+
+static converter::sptr make_convert_sc12_item32_le_1_to_sc16_1_ssse3(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_ssse3<int16_t, uhd::wtohx>(true));
+}
+
+static converter::sptr make_convert_sc12_item32_be_1_to_sc16_1_ssse3(void)
+{
+    return converter::sptr(new convert_sc12_item32_1_to_star_1_ssse3<int16_t, uhd::ntohx>(false));
+}
+
+UHD_STATIC_BLOCK(register_convert_unpack_sc12_ssse3)
+{
+    if (not cpu_has_ssse3()) return;
+
+    uhd::convert::id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    id.output_format = "fc32";
+    id.input_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_le_1_to_fc32_1_ssse3, PRIORITY_SIMD, "ssse3", "ssse3");
+    id.input_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_be_1_to_fc32_1_ssse3, PRIORITY_SIMD, "ssse3", "ssse3");
+
+    id.output_format = "sc16";
+    id.input_format = "sc12_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_le_1_to_sc16_1_ssse3, PRIORITY_SIMD, "ssse3", "ssse3");
+    id.input_format = "sc12_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc12_item32_be_1_to_sc16_1_ssse3, PRIORITY_SIMD, "ssse3", "ssse3");
+}
@@ -15,6 +15,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include "utils/load_modules.hpp"
 #include <uhd/device.hpp>
 #include <uhd/types/dict.hpp>
 #include <uhd/exception.hpp>
@@ -22,12 +23,26 @@
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/algorithm.hpp>
+#include <uhd/utils/init_profile.hpp>
+#include <uhd/utils/safe_call.hpp>
+#include <uhd/utils/thread_priority.hpp>
 #include <boost/foreach.hpp>
+#include <boost/bind.hpp>
 #include <boost/format.hpp>
 #include <boost/weak_ptr.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
 
 using namespace uhd;
 
@@ -85,50 +100,240 @@ device::~device(void){
 /***********************************************************************
  * Discover
  **********************************************************************/
+//! The results of the finders that run at the same time
+struct find_results_t
+{
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    std::vector<device_addrs_t> addrs;
+    size_t num_pending;
+};
+
+//! The thread of one finder, the results outlive the caller on a timeout
+static void run_finder(
+    boost::shared_ptr<find_results_t> results,
+    const size_t index,
+    const device::find_t find,
+    const device_addr_t hint
+){
+    device_addrs_t addrs;
+    try {
+        addrs = find(hint);
+    }
+    catch (const std::exception &e) {
+        UHD_MSG(error) << "Device discovery error: " << e.what() << std::endl;
+    }
+    boost::mutex::scoped_lock lock(results->mutex);
+    results->addrs[index] = addrs;
+    if (--results->num_pending == 0) results->cond.notify_all();
+}
+
+/*!
+ * Run the finders of all registered devices matching the filter at the
+ * same time, so the time of a discovery is that of the slowest finder.
+ * If the hint has a "find_timeout" (in seconds), the finders that did not
+ * return by then are left running and their devices are not reported.
+ * \return the discovered addresses, indexed like get_dev_fcn_regs()
+ */
+static std::vector<device_addrs_t> find_all_devices(
+    const device_addr_t &hint,
+    device::device_filter_t filter
+){
+    //modules register their devices when they are loaded
+    uhd::load_modules();
+
+    const std::vector<dev_fcn_reg_t> &regs = get_dev_fcn_regs();
+    const double timeout = hint.cast<double>("find_timeout", 0.0);
+    boost::shared_ptr<find_results_t> results = boost::make_shared<find_results_t>();
+    results->addrs.resize(regs.size());
+    results->num_pending = 0;
+
+    boost::mutex::scoped_lock lock(results->mutex);
+    for (size_t i = 0; i < regs.size(); i++) {
+        if (filter != device::ANY and regs[i].get<2>() != filter) continue;
+        boost::thread(boost::bind(&run_finder, results, i, regs[i].get<0>(), hint)).detach();
+        results->num_pending++;
+    }
+
+    const boost::system_time exit_time = boost::get_system_time() +
+        boost::posix_time::microseconds(long(timeout*1e6));
+    while (results->num_pending > 0) {
+        if (timeout <= 0.0) {
+            results->cond.wait(lock);
+        } else if (not results->cond.timed_wait(lock, exit_time)) {
+            UHD_MSG(warning) << boost::format(
+                "Device discovery timed out after %f seconds, %u finders did not return"
+            ) % timeout % results->num_pending << std::endl;
+            break;
+        }
+    }
+    return results->addrs;
+}
+
 device_addrs_t device::find(const device_addr_t &hint, device_filter_t filter){
     boost::mutex::scoped_lock lock(_device_mutex);
 
     device_addrs_t device_addrs;
 
-    BOOST_FOREACH(const dev_fcn_reg_t &fcn, get_dev_fcn_regs()) {
-        try {
-            if (filter == ANY or fcn.get<2>() == filter) {
-                device_addrs_t discovered_addrs = fcn.get<0>()(hint);
-                device_addrs.insert(
-                    device_addrs.begin(),
-                    discovered_addrs.begin(),
-                    discovered_addrs.end()
-                );
-            }
+    BOOST_FOREACH(const device_addrs_t &discovered_addrs, find_all_devices(hint, filter)) {
+        device_addrs.insert(
+            device_addrs.begin(),
+            discovered_addrs.begin(),
+            discovered_addrs.end()
+        );
+    }
+
+    return device_addrs;
+}
+
+/***********************************************************************
+ * Discovery cache
+ **********************************************************************/
+//! The default lifetime of a cache file entry in seconds
+static const double DEFAULT_FIND_CACHE_TTL = 3600.0;
+
+//! An entry of the cache file: expiry time (seconds since the epoch) and address
+typedef std::pair<double, device_addr_t> find_cache_entry_t;
+typedef std::map<std::string, find_cache_entry_t> find_cache_file_t;
+
+//! The cache of this process, it holds its entries for the process lifetime
+typedef uhd::dict<std::string, device_addr_t> find_cache_t;
+UHD_SINGLETON_FCN(find_cache_t, get_find_cache)
+
+//! The cache key of a hint: the sorted hint without the discovery options
+static std::string get_find_cache_key(const device_addr_t &hint, const size_t which){
+    device_addr_t key_addr;
+    BOOST_FOREACH(const std::string &key, uhd::sorted(hint.keys())){
+        if (key.find("find_") == 0) continue;
+        key_addr[key] = hint[key];
+    }
+    return str(boost::format("%s;which=%u") % key_addr.to_string() % which);
+}
+
+//! Read the cache file, skipping expired entries. A missing file is empty.
+static find_cache_file_t read_find_cache_file(const std::string &path){
+    find_cache_file_t entries;
+    std::ifstream file(path.c_str());
+    const double now = double(std::time(NULL));
+    std::string line;
+    while (std::getline(file, line)){
+        //each line is: expiry time, key, address, separated by tabs
+        std::vector<std::string> fields;
+        boost::split(fields, line, boost::is_any_of("\t"));
+        if (fields.size() != 3) continue;
+        try{
+            const double expiry = boost::lexical_cast<double>(fields[0]);
+            if (expiry < now) continue;
+            entries[fields[1]] = find_cache_entry_t(expiry, device_addr_t(fields[2]));
         }
-        catch (const std::exception &e) {
-            UHD_MSG(error) << "Device discovery error: " << e.what() << std::endl;
+        catch(const boost::bad_lexical_cast &){
+            continue;
         }
     }
+    return entries;
+}
 
-    return device_addrs;
+static void write_find_cache_file(const std::string &path, const find_cache_file_t &entries){
+    std::ofstream file(path.c_str(), std::ios::trunc);
+    BOOST_FOREACH(const find_cache_file_t::value_type &entry, entries){
+        file << str(boost::format("%.0f\t%s\t%s")
+            % entry.second.first % entry.first % entry.second.second.to_string()
+        ) << std::endl;
+    }
+    if (not file){
+        UHD_MSG(warning) << "Could not write the device discovery cache " << path << std::endl;
+    }
+}
+
+static bool find_cache_lookup(const std::string &key, const std::string &path, device_addr_t &dev_addr){
+    if (get_find_cache().has_key(key)){
+        dev_addr = get_find_cache()[key];
+        return true;
+    }
+    if (path.empty()) return false;
+    const find_cache_file_t entries = read_find_cache_file(path);
+    find_cache_file_t::const_iterator it = entries.find(key);
+    if (it == entries.end()) return false;
+    dev_addr = it->second.second;
+    get_find_cache()[key] = dev_addr;
+    return true;
+}
+
+static void find_cache_store(const std::string &key, const std::string &path, const double ttl, const device_addr_t &dev_addr){
+    get_find_cache()[key] = dev_addr;
+    if (path.empty()) return;
+    find_cache_file_t entries = read_find_cache_file(path);
+    entries[key] = find_cache_entry_t(double(std::time(NULL)) + ttl, dev_addr);
+    write_find_cache_file(path, entries);
+}
+
+static void find_cache_invalidate(const std::string &key, const std::string &path){
+    if (get_find_cache().has_key(key)) get_find_cache().pop(key);
+    if (path.empty()) return;
+    find_cache_file_t entries = read_find_cache_file(path);
+    if (entries.erase(key)) write_find_cache_file(path, entries);
 }
 
 /***********************************************************************
  * Make
  **********************************************************************/
+/*!
+ * Profiles the phases of a device::make() call. The breakdown is logged
+ * when the call returns, and printed to std error with UHD_PROFILE_STARTUP.
+ */
+struct init_profile_session{
+    init_profile_session(void){
+        init_profile::start();
+    }
+
+    ~init_profile_session(void){
+        UHD_SAFE_CALL(
+            init_profile::stop();
+            const std::string report = init_profile::to_pp_string();
+            UHD_LOG << report;
+            if (std::getenv("UHD_PROFILE_STARTUP") != NULL) std::cerr << report << std::flush;
+        )
+    }
+};
+
 device::sptr device::make(const device_addr_t &hint, device_filter_t filter, size_t which){
     boost::mutex::scoped_lock lock(_device_mutex);
+    init_profile_session profile;
+    init_profile::scoped_phase phase("discovery");
+
+    //the device threads are set up from the thread_* arguments
+    uhd::set_thread_config(hint);
 
     typedef boost::tuple<device_addr_t, make_t> dev_addr_make_t;
     std::vector<dev_addr_make_t> dev_addr_makers;
 
-    BOOST_FOREACH(const dev_fcn_reg_t &fcn, get_dev_fcn_regs()){
-        try{
-            if(filter == ANY or fcn.get<2>() == filter){
-                BOOST_FOREACH(device_addr_t dev_addr, fcn.get<0>()(hint)){
-                    //append the discovered address and its factory function
-                    dev_addr_makers.push_back(dev_addr_make_t(dev_addr, fcn.get<1>()));
-                }
-            }
+    //the discovery cache is opt-in, in this process or also in a file
+    const std::string cache_path = hint.get("find_cache_file", "");
+    const bool use_cache = hint.cast<int>("find_cache", 0) != 0 or not cache_path.empty();
+    const std::string cache_key = use_cache ? get_find_cache_key(hint, which) : "";
+
+    //a cached address is probed directly instead of discovering all devices
+    device_addr_t cached_addr;
+    if (use_cache and find_cache_lookup(cache_key, cache_path, cached_addr)){
+        const std::vector<device_addrs_t> probed_addrs = find_all_devices(cached_addr, filter);
+        for (size_t i = 0; i < probed_addrs.size() and dev_addr_makers.empty(); i++){
+            if (probed_addrs[i].empty()) continue;
+            dev_addr_makers.push_back(dev_addr_make_t(probed_addrs[i].front(), get_dev_fcn_regs()[i].get<1>()));
         }
-        catch(const std::exception &e){
-            UHD_MSG(error) << "Device discovery error: " << e.what() << std::endl;
+        if (dev_addr_makers.empty()){
+            UHD_LOG << "Cached device did not answer: " << cached_addr.to_string() << std::endl;
+            find_cache_invalidate(cache_key, cache_path);
+        }
+        else which = 0;
+    }
+
+    if (dev_addr_makers.empty()){
+        const std::vector<device_addrs_t> discovered_addrs = find_all_devices(hint, filter);
+        for (size_t i = 0; i < discovered_addrs.size(); i++){
+            BOOST_FOREACH(const device_addr_t &dev_addr, discovered_addrs[i]){
+                //append the discovered address and its factory function
+                dev_addr_makers.push_back(dev_addr_make_t(dev_addr, get_dev_fcn_regs()[i].get<1>()));
+            }
         }
     }
 
@@ -149,6 +354,7 @@ device::sptr device::make(const device_addr_t &hint, device_filter_t filter, siz
     //create a unique hash for the device address
     device_addr_t dev_addr; make_t maker;
     boost::tie(dev_addr, maker) = dev_addr_makers.at(which);
+    const device_addr_t found_addr = dev_addr;
     size_t dev_hash = hash_device_addr(dev_addr);
     UHD_LOG << boost::format("Device hash: %u") % dev_hash << std::endl;
 
@@ -167,7 +373,19 @@ device::sptr device::make(const device_addr_t &hint, device_filter_t filter, siz
     }
     else {
         //create and register a new device
-        device::sptr dev = maker(dev_addr);
+        phase.next("make");
+        device::sptr dev;
+        try{
+            dev = maker(dev_addr);
+        }
+        catch(...){
+            if (use_cache) find_cache_invalidate(cache_key, cache_path);
+            throw;
+        }
+        if (use_cache){
+            find_cache_store(cache_key, cache_path,
+                hint.cast<double>("find_cache_ttl", DEFAULT_FIND_CACHE_TTL), found_addr);
+        }
         hash_to_device[dev_hash] = dev;
         return dev;
     }
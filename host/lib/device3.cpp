@@ -66,6 +66,14 @@ std::vector<rfnoc::block_id_t> device3::find_blocks(const std::string &block_id_
     return block_ids;
 }
 
+void device3::reconfigure_streamers(
+    const reconfigure_fn_t &reconfigure,
+    const std::vector<rx_streamer::sptr> &
+) {
+    // Without streamers there is nothing to update
+    reconfigure();
+}
+
 void device3::clear()
 {
     BOOST_FOREACH(const block_ctrl_base::sptr &block, _rfnoc_block_ctrl) {
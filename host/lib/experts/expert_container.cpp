@@ -18,6 +18,8 @@
 #include "expert_container.hpp"
 #include <uhd/exception.hpp>
 #include <uhd/utils/msg.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <boost/atomic.hpp>
 #include <boost/format.hpp>
 #include <boost/foreach.hpp>
 #include <boost/function.hpp>
@@ -30,6 +32,7 @@
 #include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/adjacency_list.hpp>
+#include <algorithm>
 
 #ifdef UHD_EXPERT_LOGGING
 #define EX_LOG(depth, str) _log(depth, str)
@@ -51,10 +54,145 @@ typedef boost::adjacency_list<
 
 typedef std::map<std::string, expert_graph_t::vertex_descriptor> vertex_map_t;
 typedef std::list<expert_graph_t::vertex_descriptor>             node_queue_t;
+typedef std::vector<expert_graph_t::vertex_descriptor>           node_vector_t;
+typedef std::map<expert_graph_t::vertex_descriptor, node_vector_t> plan_map_t;
+
+/***********************************************************************
+ * The deferred resolves of the resolve batches of a thread
+ **********************************************************************/
+class expert_container_impl;
+
+struct resolve_batch_state_t
+{
+    resolve_batch_state_t(): depth(0) {}
+
+    typedef std::vector<std::pair<expert_container_impl*, std::vector<std::string> > > pending_type;
+    size_t          depth;      //Number of open batches
+    pending_type    pending;    //The written nodes, per container in the order of the first write
+};
+
+static resolve_batch_state_t& get_batch_state(void)
+{
+    static boost::thread_specific_ptr<resolve_batch_state_t> state;
+    if (state.get() == NULL) state.reset(new resolve_batch_state_t());
+    return *state;
+}
+
+//! The number of resolves which ran a worker, see get_resolve_count()
+static boost::atomic<size_t>& get_resolve_counter(void)
+{
+    static boost::atomic<size_t> counter(0);
+    return counter;
+}
 
 typedef boost::graph_traits<expert_graph_t>::edge_iterator       edge_iter;
 typedef boost::graph_traits<expert_graph_t>::vertex_iterator     vertex_iter;
 
+/*!
+ * A small pool of threads to resolve independent workers concurrently.
+ * The calling thread takes part in the work, so a pool of N threads
+ * starts N-1 helper threads.
+ */
+class resolver_pool : boost::noncopyable
+{
+public:
+    resolver_pool(const size_t num_threads):
+        _next(0), _pending(0), _generation(0), _stop(false)
+    {
+        for (size_t i = 1/*skip caller*/; i < num_threads; i++) {
+            _threads.create_thread(boost::bind(&resolver_pool::_thread_loop, this));
+        }
+    }
+
+    ~resolver_pool()
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _work_cond.notify_all();
+        _threads.join_all();
+    }
+
+    //! Resolve all the workers and rethrow the first error one of them threw
+    void run(const std::vector<dag_vertex_t*>& workers)
+    {
+        if (workers.empty()) return;
+        {
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            _jobs = workers;
+            _next = 0;
+            _pending = workers.size();
+            _error.reset();
+            _generation++;
+        }
+        _work_cond.notify_all();
+        _work();
+
+        boost::unique_lock<boost::mutex> lock(_mutex);
+        while (_pending > 0) _done_cond.wait(lock);
+        if (_error) {
+            boost::shared_ptr<uhd::exception> error = _error;
+            _error.reset();
+            error->dynamic_throw();
+        }
+    }
+
+private:
+    void _thread_loop()
+    {
+        uhd::setup_thread("expert");
+        size_t generation = 0;
+        while (true) {
+            {
+                boost::unique_lock<boost::mutex> lock(_mutex);
+                while (not _stop and _generation == generation) _work_cond.wait(lock);
+                if (_stop) return;
+                generation = _generation;
+            }
+            _work();
+        }
+    }
+
+    void _work()
+    {
+        while (true) {
+            dag_vertex_t* worker = NULL;
+            {
+                boost::lock_guard<boost::mutex> lock(_mutex);
+                if (_next >= _jobs.size()) return;
+                worker = _jobs[_next++];
+            }
+
+            boost::shared_ptr<uhd::exception> error;
+            try {
+                worker->resolve();
+            } catch (const uhd::exception& ex) {
+                error.reset(ex.dynamic_clone());
+            } catch (const std::exception& ex) {
+                error.reset(new uhd::runtime_error(ex.what()));
+            } catch (...) {
+                error.reset(new uhd::runtime_error("Unknown error resolving " + worker->get_name()));
+            }
+
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            if (error and not _error) _error = error;
+            if (--_pending == 0) _done_cond.notify_all();
+        }
+    }
+
+    boost::thread_group                 _threads;
+    boost::mutex                        _mutex;
+    boost::condition_variable           _work_cond;
+    boost::condition_variable           _done_cond;
+    std::vector<dag_vertex_t*>          _jobs;
+    size_t                              _next;
+    size_t                              _pending;
+    size_t                              _generation;
+    bool                                _stop;
+    boost::shared_ptr<uhd::exception>   _error;
+};
+
 class expert_container_impl : public expert_container
 {
 private:    //Visitor class for cycle detection algorithm
@@ -72,13 +210,17 @@ private:    //Visitor class for cycle detection algorithm
     };
 
 public:
-    expert_container_impl(const std::string& name):
-        _name(name)
+    expert_container_impl(const std::string& name, const size_t num_resolver_threads):
+        _name(name), _topology_valid(false)
     {
+        if (num_resolver_threads > 1) {
+            _resolver_pool.reset(new resolver_pool(num_resolver_threads));
+        }
     }
 
     ~expert_container_impl()
     {
+        _take_deferred();
         clear();
     }
 
@@ -89,31 +231,57 @@ public:
 
     void resolve_all(bool force = false)
     {
+        //Everything dirty is resolved below, deferred writes included
+        _take_deferred();
         boost::lock_guard<boost::recursive_mutex> resolve_lock(_resolve_mutex);
         boost::lock_guard<boost::mutex> lock(_mutex);
         EX_LOG(0, str(boost::format("resolve_all(%s)") % (force?"force":"")));
         // Do a full resolve of the graph
-        _resolve_helper("", "", force);
+        _update_topology();
+        _resolve_helper(_sorted_nodes, force);
     }
 
-    void resolve_from(const std::string&)
+    void resolve_from(const std::string& node_name)
     {
+        if (_defer(node_name)) return;
         boost::lock_guard<boost::recursive_mutex> resolve_lock(_resolve_mutex);
         boost::lock_guard<boost::mutex> lock(_mutex);
-        EX_LOG(0, "resolve_from (overridden to resolve_all)");
-        // Do a full resolve of the graph
-        // Not optimizing the traversal using node_name to reduce experts complexity
-        _resolve_helper("", "", false);
+        EX_LOG(0, str(boost::format("resolve_from(%s)") % node_name));
+        // Resolve everything downstream of the node and the dependencies
+        // of those nodes so that none of them consume stale data
+        _resolve_helper(_get_resolve_plan(node_name, true), false);
     }
 
-    void resolve_to(const std::string&)
+    void resolve_to(const std::string& node_name)
     {
+        //A read must not see the state from before the deferred writes
+        const std::vector<std::string> deferred = _take_deferred();
+        if (not deferred.empty()) resolve_from_nodes(deferred);
         boost::lock_guard<boost::recursive_mutex> resolve_lock(_resolve_mutex);
         boost::lock_guard<boost::mutex> lock(_mutex);
-        EX_LOG(0, "resolve_to (overridden to resolve_all)");
-        // Do a full resolve of the graph
-        // Not optimizing the traversal using node_name to reduce experts complexity
-        _resolve_helper("", "", false);
+        EX_LOG(0, str(boost::format("resolve_to(%s)") % node_name));
+        // Resolve the node and everything it depends on
+        _resolve_helper(_get_resolve_plan(node_name, false), false);
+    }
+
+    void resolve_from_nodes(const std::vector<std::string>& node_names)
+    {
+        boost::lock_guard<boost::recursive_mutex> resolve_lock(_resolve_mutex);
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        EX_LOG(0, str(boost::format("resolve_from_nodes(%d nodes)") % node_names.size()));
+        //Resolve the union of the plans of all the nodes, in one pass
+        _update_topology();
+        std::vector<bool> marked(boost::num_vertices(_expert_dag), false);
+        BOOST_FOREACH(const std::string& node_name, node_names) {
+            BOOST_FOREACH(expert_graph_t::vertex_descriptor v, _get_resolve_plan(node_name, true)) {
+                marked[v] = true;
+            }
+        }
+        node_vector_t nodes;
+        BOOST_FOREACH(expert_graph_t::vertex_descriptor v, _sorted_nodes) {
+            if (marked[v]) nodes.push_back(v);
+        }
+        _resolve_helper(nodes, false);
     }
 
     dag_vertex_t& retrieve(const std::string& name) const
@@ -292,6 +460,7 @@ protected:
 
         //Sanity check the data node and ensure that it is not already in this graph
         EX_LOG(0, str(boost::format("add_data_node(%s)") % data_node->get_name()));
+        _topology_valid = false;
         if (data_node->get_class() == CLASS_WORKER) {
             throw uhd::runtime_error("Supplied node " + data_node->get_name() + " is not a data/property node.");
             // Throw leaves data_node undeleted
@@ -333,6 +502,7 @@ protected:
 
         //Sanity check the data node and ensure that it is not already in this graph
         EX_LOG(0, str(boost::format("add_worker(%s)") % worker->get_name()));
+        _topology_valid = false;
         if (worker->get_class() != CLASS_WORKER) {
             throw uhd::runtime_error("Supplied node " + worker->get_name() + " is not a worker node.");
         }
@@ -381,6 +551,7 @@ protected:
     {
         boost::lock_guard<boost::mutex> lock(_mutex);
         EX_LOG(0, "clear()");
+        _topology_valid = false;
 
         // Iterate through the vertices and release their node storage
         typedef boost::graph_traits<expert_graph_t>::vertex_iterator vertex_iter;
@@ -410,8 +581,11 @@ protected:
     }
 
 private:
-    void _resolve_helper(std::string start, std::string stop, bool force)
+    void _update_topology()
     {
+        //The topological order and the resolve plans are cached until the graph changes
+        if (_topology_valid) return;
+
         //Sort the graph topologically. This ensures that for all dependencies, the dependant
         //is always after all of its dependencies.
         node_queue_t sorted_nodes;
@@ -430,44 +604,166 @@ private:
                                          "The following back-edges were found:" + edges);
             }
         }
-        if (sorted_nodes.empty()) return;
+        _sorted_nodes.assign(sorted_nodes.begin(), sorted_nodes.end());
 
-        //Determine the start and stop node. If one is not explicitly specified then
-        //resolve everything
-        expert_graph_t::vertex_descriptor start_vertex = sorted_nodes.front();
-        expert_graph_t::vertex_descriptor stop_vertex = sorted_nodes.back();
-        if (not start.empty()) start_vertex = _lookup_vertex(start);
-        if (not stop.empty()) stop_vertex = _lookup_vertex(stop);
+        //Build the adjacency in both directions to walk the graph up and down
+        _out_nodes.assign(boost::num_vertices(_expert_dag), node_vector_t());
+        _in_nodes.assign(boost::num_vertices(_expert_dag), node_vector_t());
+        for (std::pair<edge_iter, edge_iter> ei = boost::edges(_expert_dag);
+             ei.first != ei.second;
+             ++ei.first
+        ) {
+            expert_graph_t::vertex_descriptor src = boost::source(*(ei.first), _expert_dag);
+            expert_graph_t::vertex_descriptor dst = boost::target(*(ei.first), _expert_dag);
+            _out_nodes[src].push_back(dst);
+            _in_nodes[dst].push_back(src);
+        }
+
+        //The level of a node is the length of the longest path to it. Nodes
+        //of the same level never depend on each other. Ordering by level is
+        //still a topological order and lets the resolver pool run one level
+        //at a time.
+        _levels.assign(boost::num_vertices(_expert_dag), 0);
+        BOOST_FOREACH(expert_graph_t::vertex_descriptor v, _sorted_nodes) {
+            BOOST_FOREACH(expert_graph_t::vertex_descriptor u, _in_nodes[v]) {
+                _levels[v] = std::max(_levels[v], _levels[u] + 1);
+            }
+        }
+        if (_resolver_pool) {
+            std::stable_sort(_sorted_nodes.begin(), _sorted_nodes.end(),
+                boost::bind(&expert_container_impl::_level_lt, this, _1, _2));
+        }
+
+        _from_plans.clear();
+        _to_plans.clear();
+        _topology_valid = true;
+    }
+
+    const node_vector_t& _get_resolve_plan(const std::string& node_name, bool downstream)
+    {
+        _update_topology();
+        expert_graph_t::vertex_descriptor vertex = _lookup_vertex(node_name);
+        plan_map_t& plans = downstream ? _from_plans : _to_plans;
+        plan_map_t::const_iterator plan = plans.find(vertex);
+        if (plan != plans.end()) return (*plan).second;
+
+        //Mark the nodes reachable from the specified node. Going downstream
+        //also pulls in the dependencies of every node that was reached.
+        std::vector<bool> marked(boost::num_vertices(_expert_dag), false);
+        marked[vertex] = true;
+        if (downstream) _mark_reachable(_out_nodes, marked);
+        _mark_reachable(_in_nodes, marked);
+
+        //Filter the cached topological order to get a sorted plan
+        node_vector_t& nodes = plans[vertex];
+        BOOST_FOREACH(expert_graph_t::vertex_descriptor v, _sorted_nodes) {
+            if (marked[v]) nodes.push_back(v);
+        }
+        EX_LOG(1, str(boost::format("cached resolve plan with %d of %d nodes") %
+                        nodes.size() % _sorted_nodes.size()));
+        return nodes;
+    }
+
+    static void _mark_reachable(const std::vector<node_vector_t>& adjacency, std::vector<bool>& marked)
+    {
+        node_vector_t pending;
+        for (size_t v = 0; v < marked.size(); v++) {
+            if (marked[v]) pending.push_back(v);
+        }
+        while (not pending.empty()) {
+            expert_graph_t::vertex_descriptor v = pending.back();
+            pending.pop_back();
+            BOOST_FOREACH(expert_graph_t::vertex_descriptor next, adjacency[v]) {
+                if (not marked[next]) {
+                    marked[next] = true;
+                    pending.push_back(next);
+                }
+            }
+        }
+    }
+
+    //! Record a write to resolve at the end of the batch, if a batch is open
+    bool _defer(const std::string& node_name)
+    {
+        resolve_batch_state_t& state = get_batch_state();
+        if (state.depth == 0) return false;
+        BOOST_FOREACH(resolve_batch_state_t::pending_type::value_type& entry, state.pending) {
+            if (entry.first != this) continue;
+            if (std::find(entry.second.begin(), entry.second.end(), node_name) == entry.second.end()) {
+                entry.second.push_back(node_name);
+            }
+            return true;
+        }
+        state.pending.push_back(std::make_pair(this, std::vector<std::string>(1, node_name)));
+        return true;
+    }
+
+    //! Remove the deferred writes of this container from the batch, and return them
+    std::vector<std::string> _take_deferred()
+    {
+        std::vector<std::string> node_names;
+        resolve_batch_state_t::pending_type& pending = get_batch_state().pending;
+        for (resolve_batch_state_t::pending_type::iterator it = pending.begin(); it != pending.end(); ++it) {
+            if (it->first != this) continue;
+            node_names.swap(it->second);
+            pending.erase(it);
+            break;
+        }
+        return node_names;
+    }
+
+    bool _level_lt(expert_graph_t::vertex_descriptor a, expert_graph_t::vertex_descriptor b) const
+    {
+        return _levels[a] < _levels[b];
+    }
 
-        //First Pass: Resolve all nodes if they are dirty, in a topological order
+    void _resolve_helper(const node_vector_t& sorted_nodes, bool force)
+    {
+        //First Pass: Resolve all nodes if they are dirty, in a topological order.
+        //With a resolver pool, the dirty workers of each level are collected and
+        //resolved concurrently before moving on to the next level.
         std::list<dag_vertex_t*> resolved_workers;
-        bool start_node_encountered = false;
-        for (node_queue_t::iterator node_iter = sorted_nodes.begin();
+        std::vector<dag_vertex_t*> level_workers;
+        for (node_vector_t::const_iterator node_iter = sorted_nodes.begin();
              node_iter != sorted_nodes.end();
              ++node_iter
         ) {
-            //Determine if we are at or beyond the starting node
-            if (*node_iter == start_vertex) start_node_encountered = true;
-
-            //Only resolve if the starting node has passed
-            if (start_node_encountered) {
-                dag_vertex_t& node = _get_vertex(*node_iter);
-                std::string node_val;
-                if (force or node.is_dirty()) {
+            dag_vertex_t& node = _get_vertex(*node_iter);
+            if (force or node.is_dirty()) {
+                if (_resolver_pool and node.get_class() == CLASS_WORKER) {
+                    level_workers.push_back(&node);
+                    EX_LOG(1, str(boost::format("scheduled node %s (level %d)") %
+                                    node.get_name() % _levels[*node_iter]));
+                } else {
                     node.resolve();
                     if (node.get_class() == CLASS_WORKER) {
                         resolved_workers.push_back(&node);
                     }
                     EX_LOG(1, str(boost::format("resolved node %s (%s) [%s]") %
                                     node.get_name() % (node.is_dirty()?"dirty":"clean") % node.to_string()));
-                } else {
-                    EX_LOG(1, str(boost::format("skipped node %s (%s) [%s]") %
-                                    node.get_name() % (node.is_dirty()?"dirty":"clean") % node.to_string()));
                 }
+            } else {
+                EX_LOG(1, str(boost::format("skipped node %s (%s) [%s]") %
+                                node.get_name() % (node.is_dirty()?"dirty":"clean") % node.to_string()));
             }
 
-            //Determine if we are beyond the stop node
-            if (*node_iter == stop_vertex) break;
+            //Resolve the collected workers at the end of each level
+            node_vector_t::const_iterator next_iter = node_iter + 1;
+            if (not level_workers.empty() and
+                (next_iter == sorted_nodes.end() or _levels[*next_iter] != _levels[*node_iter])
+            ) {
+                _resolver_pool->run(level_workers);
+                BOOST_FOREACH(dag_vertex_t* worker, level_workers) {
+                    EX_LOG(1, str(boost::format("resolved node %s (%s) [%s]") %
+                                    worker->get_name() % (worker->is_dirty()?"dirty":"clean") % worker->to_string()));
+                }
+                resolved_workers.insert(resolved_workers.end(), level_workers.begin(), level_workers.end());
+                level_workers.clear();
+            }
+        }
+
+        if (not resolved_workers.empty()) {
+            get_resolve_counter()++;
         }
 
         //Second Pass: Mark all the workers clean. The policy is that a worker will mark all of
@@ -522,13 +818,65 @@ private:
     expert_graph_t          _expert_dag;        //The primary graph data structure as an adjacency list
     vertex_map_t            _worker_map;        //A map from vertex name to vertex descriptor for workers
     vertex_map_t            _datanode_map;      //A map from vertex name to vertex descriptor for data nodes
+    bool                    _topology_valid;    //Set when the cached graph state below matches the graph
+    node_vector_t           _sorted_nodes;      //All vertices in topological order
+    std::vector<node_vector_t> _out_nodes;      //Per-vertex list of the vertices it feeds
+    std::vector<node_vector_t> _in_nodes;       //Per-vertex list of the vertices it depends on
+    std::vector<size_t>     _levels;            //Per-vertex length of the longest path to it
+    plan_map_t              _from_plans;        //Sorted vertices visited by resolve_from, per vertex
+    plan_map_t              _to_plans;          //Sorted vertices visited by resolve_to, per vertex
     boost::mutex            _mutex;
     boost::recursive_mutex  _resolve_mutex;
+    boost::scoped_ptr<resolver_pool> _resolver_pool;
 };
 
-expert_container::sptr expert_container::make(const std::string& name)
+expert_container::sptr expert_container::make(const std::string& name, const size_t num_resolver_threads)
 {
-    return boost::make_shared<expert_container_impl>(name);
+    return boost::make_shared<expert_container_impl>(name, num_resolver_threads);
+}
+
+size_t expert_container::get_resolve_count()
+{
+    return get_resolve_counter();
+}
+
+/***********************************************************************
+ * Resolve batch
+ **********************************************************************/
+resolve_batch::resolve_batch():
+    _open(true)
+{
+    get_batch_state().depth++;
+}
+
+resolve_batch::~resolve_batch()
+{
+    try {
+        commit();
+    } catch (const std::exception& e) {
+        UHD_MSG(error) << "resolve_batch: " << e.what() << std::endl;
+    }
+}
+
+void resolve_batch::commit()
+{
+    if (not _open) return;
+    _open = false;
+    resolve_batch_state_t& state = get_batch_state();
+    if (--state.depth != 0) return;
+
+    //Writes from the resolves below are not deferred anymore
+    resolve_batch_state_t::pending_type pending;
+    pending.swap(state.pending);
+    boost::shared_ptr<uhd::exception> error;
+    BOOST_FOREACH(resolve_batch_state_t::pending_type::value_type& entry, pending) {
+        try {
+            entry.first->resolve_from_nodes(entry.second);
+        } catch (const uhd::exception& e) {
+            if (not error) error.reset(e.dynamic_clone());
+        }
+    }
+    if (error) error->dynamic_throw();
 }
 
 }}
@@ -44,6 +44,13 @@ namespace uhd { namespace experts {
          */
         virtual const std::string& get_name() const = 0;
 
+        /*!
+         * Returns the number of resolves, of any container, which ran a
+         * worker. Caches of values published by the experts compare it
+         * to know whether a value may have changed since it was read.
+         */
+        static size_t get_resolve_count();
+
         /*!
          * Resolves all the nodes in this expert graph.
          *
@@ -152,8 +159,10 @@ namespace uhd { namespace experts {
          * specified name.
          *
          * \param name Name of the container
+         * \param num_resolver_threads Number of threads that resolve
+         *        independent workers concurrently (1 resolves serially)
          */
-        static sptr make(const std::string& name);
+        static sptr make(const std::string& name, const size_t num_resolver_threads = 1);
 
         /*!
          * Returns a reference to the resolver mutex.
@@ -197,6 +206,39 @@ namespace uhd { namespace experts {
         virtual void clear() = 0;
     };
 
+    /*!
+     * A scope that defers the resolves triggered by writes to data nodes.
+     *
+     * While a batch is open on a thread, a write from that thread that
+     * would resolve a container (AUTO_RESOLVE_ON_WRITE) is only recorded.
+     * When the outermost batch of the thread is committed, each container
+     * that was written resolves once, from all the nodes that were written,
+     * so each affected worker runs once for the whole batch.
+     *
+     * A read that resolves a container (AUTO_RESOLVE_ON_READ) first
+     * resolves the deferred writes of that container, so reads inside a
+     * batch never see stale values. Batches nest; only the outermost one
+     * resolves.
+     */
+    class UHD_API resolve_batch : private boost::noncopyable {
+    public:
+        //! Open a batch on the calling thread
+        resolve_batch();
+
+        //! Commit the batch if it was not committed, errors are logged
+        ~resolve_batch();
+
+        /*!
+         * Close the batch and, for the outermost batch, resolve the
+         * deferred writes. Does nothing when called again.
+         * \throws the first error of the resolves, after all containers resolved
+         */
+        void commit();
+
+    private:
+        bool _open;
+    };
+
 }}
 
 #endif /* INCLUDED_UHD_EXPERTS_EXPERT_CONTAINER_HPP */
@@ -46,9 +46,14 @@ namespace uhd { namespace experts {
          * specified name.
          *
          * \param name Name of the container
+         * \param num_resolver_threads Number of threads that resolve
+         *        independent workers concurrently. Workers of the same
+         *        depth in the graph do not depend on each other and can
+         *        overlap their bus I/O. The default of 1 resolves serially.
          */
         static expert_container::sptr create_container(
-            const std::string& name
+            const std::string& name,
+            const size_t num_resolver_threads = 1
         );
 
         /*!
@@ -15,6 +15,8 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include "utils/load_modules.hpp"
+
 #include <iostream>
 #include <map>
 #include <utility>
@@ -59,6 +61,9 @@ void uhd::image_loader::register_image_loader(const std::string &device_type,
  */
 bool uhd::image_loader::load(const uhd::image_loader::image_loader_args_t &image_loader_args){
 
+    //modules register their image loaders when they are loaded
+    uhd::load_modules();
+
     // If "type=foo" given in args, see if we have an image loader for that
     if(image_loader_args.args.has_key("type")){
         std::string type = image_loader_args.args.get("type");
@@ -80,6 +85,7 @@ bool uhd::image_loader::load(const uhd::image_loader::image_loader_args_t &image
  * Get recovery instructions for particular device
  */
 std::string uhd::image_loader::get_recovery_instructions(const std::string &device_type){
+    uhd::load_modules();
     if(get_recovery_strings().count(device_type) == 0){
         return "A firmware or FPGA loading process was interrupted by the user. This can leave your device in a non-working state.";
     }
@@ -16,9 +16,12 @@
 //
 
 #include <uhd/property_tree.hpp>
+#include "experts/expert_container.hpp"
 #include <uhd/types/dict.hpp>
 #include <boost/foreach.hpp>
-#include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/unordered_map.hpp>
 #include <boost/make_shared.hpp>
 #include <iostream>
 
@@ -85,7 +88,6 @@ public:
 
     sptr subtree(const fs_path &path_) const{
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
 
         property_tree_impl *subtree = new property_tree_impl(path);
         subtree->_guts = this->_guts; //copy the guts sptr
@@ -94,51 +96,54 @@ public:
 
     void remove(const fs_path &path_){
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = path_key(path);
+        boost::unique_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *parent = NULL;
-        node_type *node = &_guts->root;
-        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) throw_path_not_found(path);
-            parent = node;
-            node = &(*node)[name];
+        if (_guts->index.count(key) == 0) throw_path_not_found(path);
+        if (key.empty()) throw uhd::runtime_error("Cannot uproot");
+
+        //drop the node and everything below it from the index
+        const std::string prefix = key + "/";
+        for (node_index_type::iterator it = _guts->index.begin(); it != _guts->index.end();){
+            if (it->first == key or it->first.compare(0, prefix.size(), prefix) == 0){
+                it = _guts->index.erase(it);
+            }
+            else ++it;
         }
-        if (parent == NULL) throw uhd::runtime_error("Cannot uproot");
-        parent->pop(fs_path(path.leaf()));
+
+        const size_t pos = key.rfind("/");
+        node_type *parent = _guts->index[(pos == std::string::npos)? "" : key.substr(0, pos)];
+        parent->pop((pos == std::string::npos)? key : key.substr(pos+1));
     }
 
     bool exists(const fs_path &path_) const{
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = path_key(path);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *node = &_guts->root;
-        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) return false;
-            node = &(*node)[name];
-        }
-        return true;
+        return _guts->index.count(key) != 0;
     }
 
     std::vector<std::string> list(const fs_path &path_) const{
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
-
-        node_type *node = &_guts->root;
-        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) throw_path_not_found(path);
-            node = &(*node)[name];
-        }
+        const std::string key = path_key(path);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        return node->keys();
+        return lookup(path, key)->keys();
     }
 
     void _create(const fs_path &path_, const boost::shared_ptr<void> &prop){
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        boost::unique_lock<boost::shared_mutex> lock(_guts->mutex);
 
         node_type *node = &_guts->root;
+        std::string key;
         BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) (*node)[name] = node_type();
+            key += (key.empty()? "" : "/") + name;
+            if (not node->has_key(name)){
+                (*node)[name] = node_type();
+                _guts->index[key] = &(*node)[name];
+            }
             node = &(*node)[name];
         }
         if (node->prop.get() != NULL) throw uhd::runtime_error("Cannot create! Property already exists at: " + path);
@@ -147,15 +152,18 @@ public:
 
     boost::shared_ptr<void> &_access(const fs_path &path_) const{
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = path_key(path);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *node = &_guts->root;
-        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) throw_path_not_found(path);
-            node = &(*node)[name];
-        }
-        if (node->prop.get() == NULL) throw uhd::runtime_error("Cannot access! Property uninitialized at: " + path);
-        return node->prop;
+        return lookup_prop(path, key);
+    }
+
+    boost::shared_ptr<void> _access_handle(const fs_path &path_) const{
+        const fs_path path = _root / path_;
+        const std::string key = path_key(path);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
+
+        return lookup_prop(path, key); //copied while the lock is held
     }
 
 private:
@@ -163,17 +171,48 @@ private:
         throw uhd::lookup_error("Path not found in tree: " + path);
     }
 
+    //! The index key of a path: its elements joined without empty elements
+    static std::string path_key(const fs_path &path){
+        std::string key;
+        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
+            if (not key.empty()) key += "/";
+            key += name;
+        }
+        return key;
+    }
+
     //basic structural node element
     struct node_type : uhd::dict<std::string, node_type>{
         boost::shared_ptr<void> prop;
     };
 
+    //map of full path keys to nodes, the dict keeps nodes in place
+    typedef boost::unordered_map<std::string, node_type *> node_index_type;
+
     //tree guts which may be referenced in a subtree
     struct tree_guts_type{
+        tree_guts_type(void){
+            index[""] = &root;
+        }
         node_type root;
-        boost::mutex mutex;
+        node_index_type index;
+        boost::shared_mutex mutex; //shared for lookups, exclusive for changes
     };
 
+    //! Find an indexed node, call with the guts mutex held
+    node_type *lookup(const fs_path &path, const std::string &key) const{
+        node_index_type::const_iterator it = _guts->index.find(key);
+        if (it == _guts->index.end()) throw_path_not_found(path);
+        return it->second;
+    }
+
+    //! Find the property of an indexed node, call with the guts mutex held
+    boost::shared_ptr<void> &lookup_prop(const fs_path &path, const std::string &key) const{
+        node_type *node = lookup(path, key);
+        if (node->prop.get() == NULL) throw uhd::runtime_error("Cannot access! Property uninitialized at: " + path);
+        return node->prop;
+    }
+
     //members, the tree and root prefix
     boost::shared_ptr<tree_guts_type> _guts;
     const fs_path _root;
@@ -189,3 +228,57 @@ property_tree::~property_tree(void){
 uhd::property_tree::sptr uhd::property_tree::make(void){
     return sptr(new property_tree_impl());
 }
+
+/***********************************************************************
+ * Property transaction
+ **********************************************************************/
+property_transaction::property_transaction(property_tree::sptr tree):
+    _tree(tree)
+{
+    /* NOP */
+}
+
+size_t property_transaction::size(void) const{
+    return _changes.size();
+}
+
+void property_transaction::clear(void){
+    _changes.clear();
+}
+
+void property_transaction::commit(void){
+    uhd::experts::resolve_batch batch;
+    BOOST_FOREACH(const boost::function<void(void)> &change, _changes){
+        change();
+    }
+    batch.commit();
+}
+
+/***********************************************************************
+ * Property snapshot
+ **********************************************************************/
+property_snapshot::property_snapshot(property_tree::sptr tree):
+    _tree(tree)
+{
+    /* NOP */
+}
+
+size_t property_snapshot::size(void) const{
+    return _restorers.size();
+}
+
+void property_snapshot::capture(void){
+    BOOST_FOREACH(const boost::function<void(void)> &capturer, _capturers){
+        capturer();
+    }
+}
+
+property_transaction property_snapshot::make_restore_transaction(void) const{
+    property_transaction transaction(_tree);
+    transaction._changes = _restorers;
+    return transaction;
+}
+
+void property_snapshot::restore(void){
+    this->make_restore_transaction().commit();
+}
@@ -241,23 +241,53 @@ void block_ctrl_base::sr_write(const uint32_t reg, const uint32_t data, const si
 
 void block_ctrl_base::sr_write(const std::string &reg, const uint32_t data, const size_t port)
 {
-    uint32_t reg_addr = 255;
-    if (DEFAULT_NAMED_SR.has_key(reg)) {
-        reg_addr = DEFAULT_NAMED_SR[reg];
-    } else {
-        if (not _tree->exists(_root_path / "registers" / "sr" / reg)) {
-            throw uhd::key_error(str(
-                    boost::format("Unknown settings register name: %s")
-                    % reg
-            ));
-        }
-        reg_addr = uint32_t(_tree->access<size_t>(_root_path / "registers" / "sr" / reg).get());
-    }
+    const uint32_t reg_addr = _get_sr_addr(reg);
     UHD_BLOCK_LOG() << "  ";
     UHD_RFNOC_BLOCK_TRACE() << boost::format("sr_write(%s, %08X) ==> ") % reg % data << std::endl;
     return sr_write(reg_addr, data, port);
 }
 
+void block_ctrl_base::sr_write(const uint32_t reg, const std::vector<uint32_t> &data, const size_t port)
+{
+    if (not _ctrl_ifaces.count(port)) {
+        throw uhd::key_error(str(boost::format("[%s] sr_write(): No such port: %d") % get_block_id().get() % port));
+    }
+    wb_iface::transactions_type transactions;
+    transactions.reserve(data.size() + 1);
+    BOOST_FOREACH(const uint32_t value, data) {
+        transactions.push_back(wb_iface::transaction_t(wb_iface::transaction_t::POKE32, _sr_to_addr(reg), value));
+    }
+    // The readback is acked after all writes, so the batch ends once they were executed
+    transactions.push_back(wb_iface::transaction_t(wb_iface::transaction_t::PEEK64, _sr_to_addr64(SR_READBACK_REG_ID)));
+    try {
+        _ctrl_ifaces[port]->transact(transactions);
+    }
+    catch(const std::exception &ex) {
+        throw uhd::io_error(str(boost::format("[%s] sr_write() failed: %s") % get_block_id().get() % ex.what()));
+    }
+}
+
+void block_ctrl_base::sr_write(const std::string &reg, const std::vector<uint32_t> &data, const size_t port)
+{
+    const uint32_t reg_addr = _get_sr_addr(reg);
+    UHD_RFNOC_BLOCK_TRACE() << boost::format("sr_write(%s, %d values) ==> ") % reg % data.size() << std::endl;
+    return sr_write(reg_addr, data, port);
+}
+
+uint32_t block_ctrl_base::_get_sr_addr(const std::string &reg)
+{
+    if (DEFAULT_NAMED_SR.has_key(reg)) {
+        return DEFAULT_NAMED_SR[reg];
+    }
+    if (not _tree->exists(_root_path / "registers" / "sr" / reg)) {
+        throw uhd::key_error(str(
+                boost::format("Unknown settings register name: %s")
+                % reg
+        ));
+    }
+    return uint32_t(_tree->access<size_t>(_root_path / "registers" / "sr" / reg).get());
+}
+
 uint64_t block_ctrl_base::sr_read64(const settingsbus_reg_t reg, const size_t port)
 {
     if (not _ctrl_ifaces.count(port)) {
@@ -18,8 +18,11 @@
 #include <uhd/exception.hpp>
 #include <uhd/rfnoc/constants.hpp>
 #include <uhd/rfnoc/blockdef.hpp>
+#include <uhd/utils/init_profile.hpp>
+#include <uhd/utils/log.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/paths.hpp>
+#include <uhd/utils/static.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/foreach.hpp>
 #include <boost/format.hpp>
@@ -28,7 +31,12 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
 #include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <map>
 
 using namespace uhd;
 using namespace uhd::rfnoc;
@@ -38,6 +46,7 @@ namespace pt = boost::property_tree;
 static const fs::path XML_BLOCKS_SUBDIR("blocks");
 static const fs::path XML_COMPONENTS_SUBDIR("components");
 static const fs::path XML_EXTENSION(".xml");
+static const fs::path XML_INDEX_FILE("rfnoc_blockdef_index.txt");
 
 
 /****************************************************************************
@@ -212,22 +221,27 @@ public:
         return (rhs.find(lhs) == 0);
     }
 
-    //! Open the file at filename and see if it's a block definition for the given NoC ID
-    static bool has_noc_id(uint64_t noc_id, const fs::path &filename)
+    //! Open the file at filename and read the NoC IDs it is a block definition for
+    //
+    // Returns false, and no IDs, if the file is not a valid block definition.
+    static bool read_noc_ids(const fs::path &filename, std::vector<std::string> &ids)
     {
         pt::ptree propt;
         try {
             read_xml(filename.string(), propt);
             BOOST_FOREACH(pt::ptree::value_type &v, propt.get_child("nocblock.ids")) {
-                if (v.first == "id" and match_noc_id(v.second.data(), noc_id)) {
-                    return true;
+                if (v.first == "id") {
+                    // Throws if this is not a valid NoC ID
+                    match_noc_id(v.second.data(), 0);
+                    ids.push_back(v.second.data());
                 }
             }
         } catch (std::exception &e) {
-            UHD_MSG(warning) << "has_noc_id(): caught exception " << e.what() << std::endl;
+            UHD_MSG(warning) << "read_noc_ids(): caught exception " << e.what() << std::endl;
+            ids.clear();
             return false;
         }
-        return false;
+        return true;
     }
 
     blockdef_xml_impl(const fs::path &filename, uint64_t noc_id, xml_repr_t type=DESCRIBES_BLOCK) :
@@ -413,45 +427,195 @@ private:
 
 };
 
-blockdef::sptr blockdef::make_from_noc_id(uint64_t noc_id)
+/****************************************************************************
+ * NoC ID index
+ ****************************************************************************/
+/*! Maps NoC IDs to block definition files.
+ *
+ * Every file is only parsed for its NoC IDs when it is new or has changed,
+ * which is checked with its modification time on every lookup. The IDs are
+ * also stored in an index file, so the files don't get parsed again by the
+ * next process. The block definitions are shared by all blocks of a NoC ID.
+ */
+class blockdef_index
 {
-    std::vector<fs::path> paths = blockdef_xml_impl::get_xml_paths();
-    std::vector<fs::path> valid;
-
-    // Check if any of the paths exist
-    BOOST_FOREACH(const fs::path &base_path, paths) {
-        fs::path this_path = base_path / XML_BLOCKS_SUBDIR;
-        if (fs::exists(this_path) and fs::is_directory(this_path)) {
-            valid.push_back(this_path);
+public:
+    blockdef_index(void) : _index_loaded(false)
+    {
+        // NOP
+    }
+
+    blockdef::sptr find(uint64_t noc_id)
+    {
+        uhd::init_profile::scoped_phase phase("make/blockdefs");
+        boost::mutex::scoped_lock lock(_mutex);
+        update();
+
+        if (_blockdefs.count(noc_id)) {
+            return _blockdefs[noc_id];
+        }
+        BOOST_FOREACH(const std::string &filename, _order) {
+            BOOST_FOREACH(const std::string &id, _files[filename].ids) {
+                if (blockdef_xml_impl::match_noc_id(id, noc_id)) {
+                    blockdef::sptr def(new blockdef_xml_impl(filename, noc_id));
+                    _blockdefs[noc_id] = def;
+                    return def;
+                }
+            }
+        }
+        return blockdef::sptr();
+    }
+
+private:
+    //! A block definition file, and the NoC IDs it lists
+    struct file_info_t
+    {
+        std::time_t mtime;
+        std::vector<std::string> ids;
+    };
+
+    //! Returns the directories with block definitions, in search order
+    static std::vector<fs::path> get_block_paths(void)
+    {
+        std::vector<fs::path> valid;
+
+        // Check if any of the paths exist
+        BOOST_FOREACH(const fs::path &base_path, blockdef_xml_impl::get_xml_paths()) {
+            fs::path this_path = base_path / XML_BLOCKS_SUBDIR;
+            if (fs::exists(this_path) and fs::is_directory(this_path)) {
+                valid.push_back(this_path);
+            }
+        }
+
+        if (valid.empty())
+        {
+            throw uhd::assertion_error(
+                "Failed to find a valid XML path for RFNoC blocks.\n"
+                "Try setting the enviroment variable UHD_RFNOC_DIR "
+                "to the correct location"
+            );
         }
+        return valid;
+    }
+
+    static fs::path get_index_path(void)
+    {
+        return fs::path(uhd::get_app_path()) / ".uhd" / "cache" / XML_INDEX_FILE;
     }
 
-    if (valid.empty())
+    //! Rescans the block directories and parses new or changed files
+    void update(void)
     {
-        throw uhd::assertion_error(
-            "Failed to find a valid XML path for RFNoC blocks.\n"
-            "Try setting the enviroment variable UHD_RFNOC_DIR "
-            "to the correct location"
-        );
+        if (not _index_loaded) {
+            load_index();
+            _index_loaded = true;
+        }
+
+        bool changed = false;
+        std::vector<std::string> order;
+        std::map<std::string, file_info_t> files;
+        BOOST_FOREACH(const fs::path &path, get_block_paths()) {
+            // Iterate over all .xml files, in a fixed order
+            std::vector<fs::path> filenames;
+            fs::directory_iterator end_itr;
+            for (fs::directory_iterator i(path); i != end_itr; ++i) {
+                if (not fs::exists(*i) or fs::is_directory(*i) or fs::is_empty(*i)) {
+                    continue;
+                }
+                if (i->path().filename().extension() != XML_EXTENSION) {
+                    continue;
+                }
+                filenames.push_back(i->path());
+            }
+            std::sort(filenames.begin(), filenames.end());
+
+            BOOST_FOREACH(const fs::path &filename, filenames) {
+                const std::string key = filename.string();
+                if (files.count(key)) {
+                    continue;
+                }
+                file_info_t info;
+                info.mtime = fs::last_write_time(filename);
+                if (_files.count(key) and _files[key].mtime == info.mtime) {
+                    info.ids = _files[key].ids;
+                } else {
+                    blockdef_xml_impl::read_noc_ids(filename, info.ids);
+                    changed = true;
+                }
+                files[key] = info;
+                order.push_back(key);
+            }
+        }
+
+        if (changed or order != _order) {
+            _order = order;
+            _files = files;
+            _blockdefs.clear();
+            save_index();
+        }
     }
 
-    // Iterate over all paths
-    BOOST_FOREACH(const fs::path &path, valid) {
-        // Iterate over all .xml files
-        fs::directory_iterator end_itr;
-        for (fs::directory_iterator i(path); i != end_itr; ++i) {
-            if (not fs::exists(*i) or fs::is_directory(*i) or fs::is_empty(*i)) {
+    //! Reads the index file, a line per file: mtime, comma separated IDs, filename
+    void load_index(void)
+    {
+        std::ifstream index(get_index_path().string().c_str());
+        std::string line;
+        while (std::getline(index, line)) {
+            std::vector<std::string> fields;
+            boost::split(fields, line, boost::is_any_of("\t"));
+            if (fields.size() != 3) {
                 continue;
             }
-            if (i->path().filename().extension() != XML_EXTENSION) {
+            try {
+                file_info_t info;
+                info.mtime = boost::lexical_cast<std::time_t>(fields[0]);
+                if (not fields[1].empty()) {
+                    boost::split(info.ids, fields[1], boost::is_any_of(","));
+                }
+                _files[fields[2]] = info;
+            } catch (const boost::bad_lexical_cast &) {
                 continue;
             }
-            if (blockdef_xml_impl::has_noc_id(noc_id, i->path())) {
-                return blockdef::sptr(new blockdef_xml_impl(i->path(), noc_id));
+        }
+    }
+
+    //! Writes the index file, it's only a cache so failing is not an error
+    void save_index(void)
+    {
+        const fs::path index_path = get_index_path();
+        const fs::path tmp_path = index_path.string() + ".tmp";
+        try {
+            fs::create_directories(index_path.parent_path());
+            {
+                std::ofstream index(tmp_path.string().c_str());
+                BOOST_FOREACH(const std::string &filename, _order) {
+                    index << _files[filename].mtime << "\t"
+                          << boost::join(_files[filename].ids, ",") << "\t"
+                          << filename << std::endl;
+                }
+                if (not index) {
+                    throw uhd::io_error("Failed to write " + tmp_path.string());
+                }
             }
+            fs::rename(tmp_path, index_path);
+        } catch (const std::exception &e) {
+            UHD_LOG << "blockdef_index: not saving " << index_path.string() << ": " << e.what() << std::endl;
         }
     }
 
-    return blockdef::sptr();
+    boost::mutex _mutex;
+    bool _index_loaded;
+    //! The files, in search order
+    std::vector<std::string> _order;
+    std::map<std::string, file_info_t> _files;
+    //! The block definitions found so far
+    std::map<uint64_t, blockdef::sptr> _blockdefs;
+};
+
+UHD_SINGLETON_FCN(blockdef_index, get_blockdef_index)
+
+blockdef::sptr blockdef::make_from_noc_id(uint64_t noc_id)
+{
+    return get_blockdef_index().find(noc_id);
 }
 // vim: sw=4 et:
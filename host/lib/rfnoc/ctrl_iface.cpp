@@ -21,14 +21,19 @@
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/utils/safe_call.hpp>
-#include <uhd/transport/bounded_buffer.hpp>
+#include <uhd/utils/trace.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
 #include <uhd/types/sid.hpp>
 #include <uhd/transport/chdr.hpp>
 #include <uhd/rfnoc/constants.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/format.hpp>
 #include <boost/bind.hpp>
+#include <algorithm>
+#include <deque>
 #include <queue>
 
 using namespace uhd;
@@ -73,6 +78,7 @@ public:
 
     ~ctrl_iface_impl(void)
     {
+        _sched_task.reset(); //stop feeding scheduled commands
         _timeout = ACK_TIMEOUT; //reset timeout to something small
         UHD_SAFE_CALL(
             this->peek32(0);//dummy peek with the purpose of ack'ing all packets
@@ -87,6 +93,9 @@ public:
     {
         boost::mutex::scoped_lock lock(_mutex);
         this->send_pkt(addr/4, data);
+        //Collect the acks that already arrived once half the window is used,
+        //so that pokes rarely have to wait for a full window
+        if (_outstanding_seqs.size() >= _resp_queue_size/2) this->poll_acks();
         this->wait_for_ack(false);
     }
 
@@ -107,6 +116,75 @@ public:
         return this->wait_for_ack(true);
     }
 
+    void flush(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        //let the scheduler send the remaining scheduled commands first
+        while (not _scheduled.empty()) _sched_cond.wait(lock);
+        uint64_t value;
+        while (not _outstanding_seqs.empty()) {
+            this->recv_ack(_timeout, value);
+        }
+    }
+
+    /*******************************************************************
+     * Batched transactions:
+     * Send all commands, waiting only when the window is full,
+     * and collect the readback values from the acks in order.
+     ******************************************************************/
+    void transact(transactions_type &transactions)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        //the acks of the commands sent before the batch come first
+        size_t num_skip = _outstanding_seqs.size();
+        size_t num_acked = 0;
+        size_t num_to_ack = 0; //up to and including the last readback
+        for (size_t i = 0; i < transactions.size(); i++) {
+            const transaction_t &t = transactions[i];
+            if (t.op == transaction_t::POKE32) {
+                this->send_pkt(t.addr/4, uint32_t(t.data));
+            } else {
+                this->send_pkt(_rb_address, t.addr/8);
+                num_to_ack = i + 1;
+            }
+            while (_outstanding_seqs.size() >= _resp_queue_size) {
+                this->recv_batch_ack(transactions, num_skip, num_acked);
+            }
+        }
+        while (num_acked < num_to_ack) {
+            this->recv_batch_ack(transactions, num_skip, num_acked);
+        }
+    }
+
+    /*******************************************************************
+     * Host-side command scheduler:
+     * A task feeds the scheduled commands into the command queue of the
+     * block while the acks of executed commands show room in it.
+     ******************************************************************/
+    void schedule_commands(const timed_commands_type &commands)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _timeout = MASSIVE_TIMEOUT; //acks of timed commands can take long
+        _scheduled.insert(_scheduled.end(), commands.begin(), commands.end());
+        if (not _sched_task) {
+            _sched_task = task::make(boost::bind(&ctrl_iface_impl::scheduler_task, this), "ctrl_sched");
+        }
+        _sched_cond.notify_all();
+    }
+
+    size_t get_cmd_queue_depth(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        this->poll_acks();
+        return _outstanding_seqs.size();
+    }
+
+    size_t get_num_scheduled_commands(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return _scheduled.size();
+    }
+
     /*******************************************************************
      * Update methods for time
      ******************************************************************/
@@ -140,7 +218,7 @@ private:
     /*******************************************************************
      * Primary control and interaction private methods
      ******************************************************************/
-    inline void send_pkt(const uint32_t addr, const uint32_t data = 0)
+    inline void send_pkt(const uint32_t addr, const uint32_t data = 0, const uhd::time_spec_t *cmd_time = NULL)
     {
         managed_send_buffer::sptr buff = _ctrl_xport->get_send_buff(0.0);
         if (not buff) {
@@ -155,15 +233,18 @@ private:
         packet_info.num_payload_words32 = 2;
         packet_info.num_payload_bytes = packet_info.num_payload_words32*sizeof(uint32_t);
         packet_info.packet_count = _seq_out;
-        packet_info.tsf = _time.to_ticks(_tick_rate);
+        packet_info.tsf = (cmd_time? *cmd_time : _time).to_ticks(_tick_rate);
         packet_info.sob = false;
         packet_info.eob = false;
         packet_info.sid = _sid;
         packet_info.has_sid = true;
         packet_info.has_cid = false;
         packet_info.has_tsi = false;
-        packet_info.has_tsf = _use_time;
+        packet_info.has_tsf = cmd_time or _use_time;
         packet_info.has_tlr = false;
+        if (packet_info.has_tsf) {
+            UHD_TRACE_INSTANT(POINT_TIMED_CMD, packet_info.tsf);
+        }
 
         //load header
         if (_bige) vrt::if_hdr_pack_be(pkt, packet_info);
@@ -180,130 +261,203 @@ private:
         _seq_out++;//inc seq for next call
     }
 
+    /*!
+     * Wait for acks until the window of outstanding commands has room.
+     * For a readback, wait for all acks and return the readback value.
+     */
     UHD_INLINE uint64_t wait_for_ack(const bool readback)
     {
+        uint64_t value = 0;
         while (readback or (_outstanding_seqs.size() >= _resp_queue_size))
         {
-            //get seq to ack from outstanding packets list
-            UHD_ASSERT_THROW(not _outstanding_seqs.empty());
-            const size_t seq_to_ack = _outstanding_seqs.front();
-            _outstanding_seqs.pop();
-
-            //parse the packet
-            vrt::if_packet_info_t packet_info;
-            resp_buff_type resp_buff;
-            memset(&resp_buff, 0x00, sizeof(resp_buff));
-            uint32_t const *pkt = NULL;
-            managed_recv_buffer::sptr buff;
-
-            //get buffer from response endpoint - or die in timeout
-            if (_resp_xport)
-            {
-                buff = _resp_xport->get_recv_buff(_timeout);
-                try
-                {
-                    UHD_ASSERT_THROW(bool(buff));
-                    UHD_ASSERT_THROW(buff->size() > 0);
-                }
-                catch(const std::exception &ex)
-                {
-                    throw uhd::io_error(str(boost::format("Block ctrl (%s) no response packet - %s") % _name % ex.what()));
-                }
-                pkt = buff->cast<const uint32_t *>();
-                packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
-            }
+            this->recv_ack(_timeout, value);
+            if (readback and _outstanding_seqs.empty()) return value;
+        }
+        return 0;
+    }
 
-            //get buffer from response endpoint - or die in timeout
-            else
-            {
-                /*
-                 * Couldn't get message with haste.
-                 * Now check both possible queues for messages.
-                 * Messages should come in on _resp_queue,
-                 * but could end up in dump_queue.
-                 * If we don't get a message --> Die in timeout.
-                 */
-                double accum_timeout = 0.0;
-                const double short_timeout = 0.005; // == 5ms
-                while(not ((_resp_queue.pop_with_haste(resp_buff))
-                        || (check_dump_queue(resp_buff))
-                        || (_resp_queue.pop_with_timed_wait(resp_buff, short_timeout))
-                        )){
-                    /*
-                     * If a message couldn't be received within a given timeout
-                     * --> throw AssertionError!
-                     */
-                    accum_timeout += short_timeout;
-                    UHD_ASSERT_THROW(accum_timeout < _timeout);
-                }
-
-                pkt = resp_buff.data;
-                packet_info.num_packet_words32 = sizeof(resp_buff)/sizeof(uint32_t);
+    //! Collect the acks that already arrived, without waiting
+    UHD_INLINE void poll_acks(void)
+    {
+        uint64_t value;
+        while (not _outstanding_seqs.empty() and this->recv_ack(0.0, value)) {}
+    }
+
+    //! The loop body of the scheduler task
+    void scheduler_task(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_scheduled.empty()) {
+            _sched_cond.wait(lock);
+            return;
+        }
+
+        //leave room in the window for commands that bypass the scheduler
+        const size_t max_outstanding = std::max<size_t>(_resp_queue_size, 2) - 1;
+        try {
+            this->poll_acks();
+            while (not _scheduled.empty() and _outstanding_seqs.size() < max_outstanding) {
+                const timed_command_t &cmd = _scheduled.front();
+                this->send_pkt(cmd.addr/4, cmd.data, &cmd.time);
+                _scheduled.pop_front();
             }
+        } catch (const std::exception &ex) {
+            UHD_MSG(error) << boost::format(
+                "[%s] Block ctrl dropped %u scheduled commands: %s"
+            ) % _name % _scheduled.size() % ex.what() << std::endl;
+            _scheduled.clear();
+        }
+
+        if (_scheduled.empty()) _sched_cond.notify_all();
+        else _sched_cond.timed_wait(lock, boost::posix_time::milliseconds(1));
+    }
+
+    UHD_INLINE void recv_batch_ack(transactions_type &transactions, size_t &num_skip, size_t &num_acked)
+    {
+        uint64_t value;
+        this->recv_ack(_timeout, value);
+        if (num_skip > 0) {
+            num_skip--;
+            return;
+        }
+        transaction_t &t = transactions[num_acked++];
+        if (t.op == transaction_t::PEEK64) t.data = value;
+        if (t.op == transaction_t::PEEK32) t.data = ((t.addr/4) & 0x1)? (value >> 32) : (value & 0xffffffff);
+    }
+
+    /*!
+     * Receive and check the ack of the oldest outstanding command.
+     * A timeout of 0 returns false when no ack has arrived yet,
+     * any other timeout throws when it expires.
+     */
+    bool recv_ack(const double timeout, uint64_t &value)
+    {
+        UHD_ASSERT_THROW(not _outstanding_seqs.empty());
 
-            //parse the buffer
+        //parse the packet
+        vrt::if_packet_info_t packet_info;
+        resp_buff_type resp_buff;
+        memset(&resp_buff, 0x00, sizeof(resp_buff));
+        uint32_t const *pkt = NULL;
+        managed_recv_buffer::sptr buff;
+
+        //get buffer from response endpoint - or die in timeout
+        if (_resp_xport)
+        {
+            buff = _resp_xport->get_recv_buff(timeout);
+            if (not buff and timeout == 0.0) return false;
             try
             {
-                packet_info.link_type = _link_type;
-                if (_bige) vrt::chdr::if_hdr_unpack_be(pkt, packet_info);
-                else vrt::chdr::if_hdr_unpack_le(pkt, packet_info);
+                UHD_ASSERT_THROW(bool(buff));
+                UHD_ASSERT_THROW(buff->size() > 0);
             }
             catch(const std::exception &ex)
             {
-                UHD_MSG(error) << "[" << _name << "] Block ctrl bad VITA packet: " << ex.what() << std::endl;
-                if (buff){
-                    UHD_MSG(status) << boost::format("%08X") % pkt[0] << std::endl;
-                    UHD_MSG(status) << boost::format("%08X") % pkt[1] << std::endl;
-                    UHD_MSG(status) << boost::format("%08X") % pkt[2] << std::endl;
-                    UHD_MSG(status) << boost::format("%08X") % pkt[3] << std::endl;
-                }
-                else{
-                    UHD_MSG(status) << "buff is NULL" << std::endl;
-                }
+                throw uhd::io_error(str(boost::format("Block ctrl (%s) no response packet - %s") % _name % ex.what()));
             }
+            pkt = buff->cast<const uint32_t *>();
+            packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
+        }
 
-            //check the buffer
-            try
-            {
-                UHD_ASSERT_THROW(packet_info.has_sid);
-                if (packet_info.sid != uint32_t((_sid >> 16) | (_sid << 16))) {
-                    throw uhd::io_error(
-                        str(
-                            boost::format("Expected SID: %s  Received SID: %s")
-                            % uhd::sid_t(_sid).reversed().to_pp_string_hex()
-                            % uhd::sid_t(packet_info.sid).to_pp_string_hex()
-                        )
-                    );
-                }
-
-                if (packet_info.packet_count != (seq_to_ack & 0xfff)) {
-                    throw uhd::io_error(
-                        str(
-                            boost::format("Expected packet index: %d  Received index: %d")
-                            % packet_info.packet_count
-                            % (seq_to_ack & 0xfff)
-                        )
-                    );
-                }
-
-                UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
-                //UHD_ASSERT_THROW(packet_info.packet_type == _packet_type);
+        //get buffer from response endpoint - or die in timeout
+        else if (timeout == 0.0)
+        {
+            if (not (_resp_queue.pop_with_haste(resp_buff) or check_dump_queue(resp_buff))) {
+                return false;
             }
-            catch(const std::exception &ex)
-            {
-                throw uhd::io_error(str(boost::format("Block ctrl (%s) packet parse error - %s") % _name % ex.what()));
+            pkt = resp_buff.data;
+            packet_info.num_packet_words32 = sizeof(resp_buff)/sizeof(uint32_t);
+        }
+        else
+        {
+            /*
+             * Couldn't get message with haste.
+             * Now check both possible queues for messages.
+             * Messages should come in on _resp_queue,
+             * but could end up in dump_queue.
+             * If we don't get a message --> Die in timeout.
+             */
+            double accum_timeout = 0.0;
+            const double short_timeout = 0.005; // == 5ms
+            while(not ((_resp_queue.pop_with_haste(resp_buff))
+                    || (check_dump_queue(resp_buff))
+                    || (_resp_queue.pop_with_timed_wait(resp_buff, short_timeout))
+                    )){
+                /*
+                 * If a message couldn't be received within a given timeout
+                 * --> throw AssertionError!
+                 */
+                accum_timeout += short_timeout;
+                UHD_ASSERT_THROW(accum_timeout < timeout);
             }
 
-            //return the readback value
-            if (readback and _outstanding_seqs.empty())
-            {
-                const uint64_t hi = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+0]) : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
-                const uint64_t lo = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+1]) : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
-                return ((hi << 32) | lo);
+            pkt = resp_buff.data;
+            packet_info.num_packet_words32 = sizeof(resp_buff)/sizeof(uint32_t);
+        }
+
+        //get seq to ack from outstanding packets list
+        const size_t seq_to_ack = _outstanding_seqs.front();
+        _outstanding_seqs.pop();
+
+        //parse the buffer
+        try
+        {
+            packet_info.link_type = _link_type;
+            if (_bige) vrt::chdr::if_hdr_unpack_be(pkt, packet_info);
+            else vrt::chdr::if_hdr_unpack_le(pkt, packet_info);
+        }
+        catch(const std::exception &ex)
+        {
+            UHD_MSG(error) << "[" << _name << "] Block ctrl bad VITA packet: " << ex.what() << std::endl;
+            if (buff){
+                UHD_MSG(status) << boost::format("%08X") % pkt[0] << std::endl;
+                UHD_MSG(status) << boost::format("%08X") % pkt[1] << std::endl;
+                UHD_MSG(status) << boost::format("%08X") % pkt[2] << std::endl;
+                UHD_MSG(status) << boost::format("%08X") % pkt[3] << std::endl;
+            }
+            else{
+                UHD_MSG(status) << "buff is NULL" << std::endl;
             }
         }
 
-        return 0;
+        //check the buffer
+        try
+        {
+            UHD_ASSERT_THROW(packet_info.has_sid);
+            if (packet_info.sid != uint32_t((_sid >> 16) | (_sid << 16))) {
+                throw uhd::io_error(
+                    str(
+                        boost::format("Expected SID: %s  Received SID: %s")
+                        % uhd::sid_t(_sid).reversed().to_pp_string_hex()
+                        % uhd::sid_t(packet_info.sid).to_pp_string_hex()
+                    )
+                );
+            }
+
+            if (packet_info.packet_count != (seq_to_ack & 0xfff)) {
+                throw uhd::io_error(
+                    str(
+                        boost::format("Expected packet index: %d  Received index: %d")
+                        % packet_info.packet_count
+                        % (seq_to_ack & 0xfff)
+                    )
+                );
+            }
+
+            UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
+            //UHD_ASSERT_THROW(packet_info.packet_type == _packet_type);
+        }
+        catch(const std::exception &ex)
+        {
+            throw uhd::io_error(str(boost::format("Block ctrl (%s) packet parse error - %s") % _name % ex.what()));
+        }
+
+        //return the readback value
+        const uint64_t hi = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+0]) : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
+        const uint64_t lo = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+1]) : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
+        value = ((hi << 32) | lo);
+
+        return true;
     }
 
     /*
@@ -357,10 +511,14 @@ private:
     double _tick_rate;
     double _timeout;
     std::queue<size_t> _outstanding_seqs;
-    bounded_buffer<resp_buff_type> _resp_queue;
+    spsc_bounded_buffer<resp_buff_type> _resp_queue; //one pushing task, popped under _mutex
     const size_t _resp_queue_size;
 
     const size_t _rb_address;
+
+    std::deque<timed_command_t> _scheduled;
+    boost::condition_variable _sched_cond;
+    task::sptr _sched_task;
 };
 
 ctrl_iface::sptr ctrl_iface::make(
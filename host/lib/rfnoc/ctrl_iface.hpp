@@ -25,6 +25,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/utility.hpp>
 #include <string>
+#include <vector>
 
 namespace uhd { namespace rfnoc {
 
@@ -61,6 +62,50 @@ public:
 
     //! Set the tick rate (converting time into ticks)
     virtual void set_tick_rate(const double rate) = 0;
+
+    /*!
+     * Wait until all outstanding commands were acknowledged.
+     *
+     * Pokes only wait for acks when the window of outstanding commands
+     * is full, peeks wait for all of them. Call this to make sure that
+     * a sequence of pokes was executed without reading anything back.
+     */
+    virtual void flush(void) = 0;
+
+    //! A register write that executes at a given time
+    struct timed_command_t
+    {
+        timed_command_t(
+            const uhd::time_spec_t &time_ = uhd::time_spec_t(0.0),
+            const wb_addr_type addr_ = 0,
+            const uint32_t data_ = 0
+        ): time(time_), addr(addr_), data(data_) {}
+        uhd::time_spec_t time;
+        wb_addr_type addr;
+        uint32_t data;
+    };
+    typedef std::vector<timed_command_t> timed_commands_type;
+
+    /*!
+     * Schedule a list of timed register writes.
+     *
+     * The commands are held on the host and fed into the command
+     * queue of the block whenever the acks of executed commands show
+     * that there is room for them, so the list may be much longer
+     * than the queue. Times should be in increasing order since the
+     * block executes its commands in order.
+     *
+     * This call returns right away. flush() waits until all scheduled
+     * commands were executed. Commands issued through the other calls
+     * queue up behind the scheduled commands sent so far.
+     */
+    virtual void schedule_commands(const timed_commands_type &commands) = 0;
+
+    //! Get the number of commands sent to the block and not acknowledged yet
+    virtual size_t get_cmd_queue_depth(void) = 0;
+
+    //! Get the number of scheduled commands still held on the host
+    virtual size_t get_num_scheduled_commands(void) = 0;
 };
 
 }} /* namespace uhd::rfnoc */
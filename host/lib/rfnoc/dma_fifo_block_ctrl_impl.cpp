@@ -23,6 +23,7 @@
 #include <uhd/types/wb_iface.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 using namespace uhd;
 using namespace uhd::rfnoc;
@@ -30,6 +31,9 @@ using namespace uhd::rfnoc;
 //TODO (Ashish): This should come from the framework
 static const double BUS_CLK_RATE = 166.67e6;
 
+//! The time in seconds to wait for an upload to be written to the DRAM
+static const double UPLOAD_TIMEOUT = 1.0;
+
 class dma_fifo_block_ctrl_impl : public dma_fifo_block_ctrl
 {
 public:
@@ -62,6 +66,7 @@ public:
             static const uint32_t USER_RB_BASE = 0;     //Don't care
             _perifs[i].base_addr = DEFAULT_SIZE*i;
             _perifs[i].depth = DEFAULT_SIZE;
+            _perifs[i].replay_size = 0;
             _perifs[i].core = dma_fifo_core_3000::make(_perifs[i].ctrl, USER_SR_BASE, USER_RB_BASE);
             _perifs[i].core->resize(_perifs[i].base_addr, _perifs[i].depth);
             UHD_MSG(status) << boost::format("[DMA FIFO] Running BIST for FIFO %d... ") % i;
@@ -88,6 +93,9 @@ public:
                 .add_coerced_subscriber(boost::bind(&dma_fifo_block_ctrl_impl::resize, this, boost::ref(_perifs[i].base_addr), _1, i))
                 .set(_perifs[i].depth)
             ;
+            _tree->create<uint32_t>(_root_path / "fill_level" / i)
+                .set_publisher(boost::bind(&dma_fifo_block_ctrl_impl::get_fill_level, this, i))
+            ;
         }
     }
 
@@ -95,6 +103,7 @@ public:
         boost::lock_guard<boost::mutex> lock(_config_mutex);
         _perifs[chan].base_addr = base_addr;
         _perifs[chan].depth = depth;
+        _perifs[chan].replay_size = 0;
         _perifs[chan].core->resize(base_addr, depth);
     }
 
@@ -106,6 +115,103 @@ public:
         return _perifs[chan].depth;
     }
 
+    uint32_t get_fill_level(const size_t chan) {
+        return _perifs[chan].core->get_bytes_occupied();
+    }
+
+    bool replay_supported(const size_t chan) {
+        return _perifs[chan].core->replay_supported();
+    }
+
+    void upload(
+        tx_streamer::sptr tx_stream,
+        const void *buff,
+        const size_t nsamps,
+        const size_t chan
+    ) {
+        boost::lock_guard<boost::mutex> lock(_config_mutex);
+        fifo_perifs_t &perifs = _perifs[chan];
+        perifs.replay_size = 0;
+        perifs.core->record();
+
+        tx_metadata_t md;
+        md.start_of_burst = true;
+        md.end_of_burst = true;
+        if (tx_stream->send(buff, nsamps, md, UPLOAD_TIMEOUT) != nsamps) {
+            throw uhd::runtime_error("[DMA FIFO] Timeout while uploading the waveform");
+        }
+
+        //The burst is in the DRAM once the fill level stops growing
+        uint32_t size = 0;
+        const boost::system_time exit_time = boost::get_system_time() +
+            boost::posix_time::microseconds(long(UPLOAD_TIMEOUT*1e6));
+        do {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+            const uint32_t new_size = perifs.core->get_bytes_occupied();
+            if (new_size != 0 and new_size == size) break;
+            size = new_size;
+        } while (boost::get_system_time() < exit_time);
+
+        if (size == 0) {
+            throw uhd::runtime_error("[DMA FIFO] The waveform did not reach the FIFO");
+        }
+        if (size >= perifs.depth) {
+            throw uhd::runtime_error(str(boost::format(
+                "[DMA FIFO] The waveform does not fit the %d byte FIFO") % perifs.depth));
+        }
+        perifs.replay_size = size;
+    }
+
+    void play(
+        const size_t num_repeats,
+        const time_spec_t &time_spec,
+        const size_t chan
+    ) {
+        boost::lock_guard<boost::mutex> lock(_config_mutex);
+        fifo_perifs_t &perifs = _perifs[chan];
+        if (perifs.replay_size == 0) {
+            throw uhd::runtime_error("[DMA FIFO] No waveform was uploaded to play");
+        }
+        //The write that starts the playback is a timed command
+        if (time_spec != time_spec_t(0.0)) {
+            set_command_time(time_spec, chan);
+        }
+        perifs.core->play(perifs.replay_size, uint32_t(num_repeats));
+        if (time_spec != time_spec_t(0.0)) {
+            clear_command_time(chan);
+        }
+    }
+
+    void stop(const size_t chan) {
+        boost::lock_guard<boost::mutex> lock(_config_mutex);
+        _perifs[chan].core->stop_play();
+    }
+
+    bool is_playing(const size_t chan) {
+        return _perifs[chan].core->is_playing();
+    }
+
+    size_t get_num_played(const size_t chan) {
+        return _perifs[chan].core->get_num_played();
+    }
+
+    //! Every port is a separate FIFO, so only the block feeding \p chan gets the command
+    void issue_stream_cmd(
+            const uhd::stream_cmd_t &stream_cmd,
+            const size_t chan
+    ) {
+        UHD_RFNOC_BLOCK_TRACE() << "dma_fifo_block_ctrl::issue_stream_cmd() " << chan << std::endl;
+        if (list_upstream_nodes().count(chan) == 0) {
+            UHD_MSG(status) << "No upstream blocks." << std::endl;
+            return;
+        }
+        source_node_ctrl::sptr this_upstream_block_ctrl =
+                boost::dynamic_pointer_cast<source_node_ctrl>(list_upstream_nodes().at(chan).lock());
+        if (this_upstream_block_ctrl) {
+            this_upstream_block_ctrl->issue_stream_cmd(stream_cmd, get_upstream_port(chan));
+        }
+    }
+
 private:
     struct fifo_perifs_t
     {
@@ -113,6 +219,8 @@ private:
         dma_fifo_core_3000::sptr core;
         uint32_t                 base_addr;
         uint32_t                 depth;
+        //! bytes of the uploaded waveform, 0 if there is none
+        uint32_t                 replay_size;
     };
     std::vector<fifo_perifs_t> _perifs;
 
@@ -22,15 +22,79 @@
 
 using namespace uhd::rfnoc;
 
+/****************************************************************************
+ * Helpers
+ ***************************************************************************/
+/*! Draw the edge between two nodes, i.e. register them with each other.
+ *
+ * On return, \p src_port and \p dst_port hold the actual port numbers.
+ * Throws if a port is taken, or is not the requested one.
+ */
+static void connect_nodes(
+        source_node_ctrl::sptr src,
+        size_t &src_port,
+        sink_node_ctrl::sptr dst,
+        size_t &dst_port
+) {
+    size_t actual_src_port = src->connect_downstream(
+            boost::dynamic_pointer_cast<uhd::rfnoc::node_ctrl_base>(dst),
+            src_port
+    );
+    if (src_port == uhd::rfnoc::ANY_PORT) {
+        src_port = actual_src_port;
+    } else if (src_port != actual_src_port) {
+        throw uhd::runtime_error(str(
+            boost::format("Can't connect to port %d on block %s.")
+            % src_port % src->unique_id()
+        ));
+    }
+    size_t actual_dst_port = dst->connect_upstream(
+            boost::dynamic_pointer_cast<uhd::rfnoc::node_ctrl_base>(src),
+            dst_port
+    );
+    if (dst_port == uhd::rfnoc::ANY_PORT) {
+        dst_port = actual_dst_port;
+    } else if (dst_port != actual_dst_port) {
+        throw uhd::runtime_error(str(
+            boost::format("Can't connect to port %d on block %s.")
+            % dst_port % dst->unique_id()
+        ));
+    }
+    src->set_downstream_port(actual_src_port, actual_dst_port);
+    dst->set_upstream_port(actual_dst_port, actual_src_port);
+}
+
+static bool port_in_use(const node_ctrl_base::node_map_t &nodes, const size_t port)
+{
+    return nodes.count(port) and not nodes.at(port).expired();
+}
+
+//! Resolve ANY_PORT on a host block to the first port that is free on both sides
+static size_t find_free_host_port(host_block_ctrl::sptr host_block, const size_t port)
+{
+    if (port != ANY_PORT) {
+        return port;
+    }
+    const node_ctrl_base::node_map_t upstream_nodes = host_block->list_upstream_nodes();
+    const node_ctrl_base::node_map_t downstream_nodes = host_block->list_downstream_nodes();
+    size_t free_port = 0;
+    while (port_in_use(upstream_nodes, free_port) or port_in_use(downstream_nodes, free_port)) {
+        free_port++;
+    }
+    return free_port;
+}
+
 /****************************************************************************
  * Structors
  ***************************************************************************/
 graph_impl::graph_impl(
             const std::string &name,
-            boost::weak_ptr<uhd::device3> device_ptr
+            boost::weak_ptr<uhd::device3> device_ptr,
+            route_fn_t route_fn
             //async_msg_handler::sptr msg_handler
 ) : _name(name)
   , _device_ptr(device_ptr)
+  , _route_fn(route_fn)
 {
 
 }
@@ -57,32 +121,9 @@ void graph_impl::connect(
     /********************************************************************
      * 1. Draw the edges (logically connect the nodes)
      ********************************************************************/
-    size_t actual_src_block_port = src->connect_downstream(
-            boost::dynamic_pointer_cast<uhd::rfnoc::node_ctrl_base>(dst),
-            src_block_port
-    );
-    if (src_block_port == uhd::rfnoc::ANY_PORT) {
-        src_block_port = actual_src_block_port;
-    } else if (src_block_port != actual_src_block_port) {
-        throw uhd::runtime_error(str(
-            boost::format("Can't connect to port %d on block %s.")
-            % src_block_port % src->unique_id()
-        ));
-    }
-    size_t actual_dst_block_port = dst->connect_upstream(
-            boost::dynamic_pointer_cast<uhd::rfnoc::node_ctrl_base>(src),
-            dst_block_port
-    );
-    if (dst_block_port == uhd::rfnoc::ANY_PORT) {
-        dst_block_port = actual_dst_block_port;
-    } else if (dst_block_port != actual_dst_block_port) {
-        throw uhd::runtime_error(str(
-            boost::format("Can't connect to port %d on block %s.")
-            % dst_block_port % dst->unique_id()
-        ));
-    }
-    src->set_downstream_port(actual_src_block_port, actual_dst_block_port);
-    dst->set_upstream_port(actual_dst_block_port, actual_src_block_port);
+    connect_nodes(src, src_block_port, dst, dst_block_port);
+    const size_t actual_src_block_port = src_block_port;
+    const size_t actual_dst_block_port = dst_block_port;
     // At this point, ports are locked and no one else can simply connect
     // into them.
     //UHD_MSG(status)
@@ -112,6 +153,19 @@ void graph_impl::connect(
     sid_t sid = dst->get_address(dst_block_port);
     sid.set_src(src->get_address(src_block_port));
 
+    // Blocks on different motherboards talk to each other directly over the
+    // network, so the devices need to know where to send the packets (and
+    // the flow control responses going the other way).
+    if (src->get_block_id().get_device_no() != dst->get_block_id().get_device_no()) {
+        if (not _route_fn) {
+            throw uhd::not_implemented_error(str(
+                boost::format("Can't connect block %s to %s: This device can't stream between motherboards.")
+                % src->get_block_id().get() % dst->get_block_id().get()
+            ));
+        }
+        _route_fn(sid);
+    }
+
     // Set SID on source block
     src->set_destination(sid.get(), src_block_port);
 
@@ -162,3 +216,36 @@ void graph_impl::connect(
     connect(src_block, ANY_PORT, dst_block, ANY_PORT);
 }
 
+void graph_impl::connect(
+        const block_id_t &src_block,
+        size_t src_block_port,
+        host_block_ctrl::sptr dst_block,
+        size_t dst_block_port
+) {
+    device3::sptr device_ptr = _device_ptr.lock();
+    if (not device_ptr) {
+        throw uhd::runtime_error("Invalid device");
+    }
+    UHD_ASSERT_THROW(bool(dst_block));
+
+    uhd::rfnoc::source_block_ctrl_base::sptr src = device_ptr->get_block_ctrl<rfnoc::source_block_ctrl_base>(src_block);
+    dst_block_port = find_free_host_port(dst_block, dst_block_port);
+    connect_nodes(src, src_block_port, dst_block, dst_block_port);
+}
+
+void graph_impl::connect(
+        host_block_ctrl::sptr src_block,
+        size_t src_block_port,
+        const block_id_t &dst_block,
+        size_t dst_block_port
+) {
+    device3::sptr device_ptr = _device_ptr.lock();
+    if (not device_ptr) {
+        throw uhd::runtime_error("Invalid device");
+    }
+    UHD_ASSERT_THROW(bool(src_block));
+
+    uhd::rfnoc::sink_block_ctrl_base::sptr dst = device_ptr->get_block_ctrl<rfnoc::sink_block_ctrl_base>(dst_block);
+    src_block_port = find_free_host_port(src_block, src_block_port);
+    connect_nodes(src_block, src_block_port, dst, dst_block_port);
+}
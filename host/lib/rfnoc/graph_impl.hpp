@@ -20,20 +20,32 @@
 
 #include <uhd/rfnoc/graph.hpp>
 #include <uhd/device3.hpp>
+#include <uhd/types/sid.hpp>
+#include <boost/function.hpp>
 
 namespace uhd { namespace rfnoc {
 
 class graph_impl : public graph
 {
 public:
+    /*! Programs the routing between two motherboards for a stream.
+     *
+     * Gets called with the SID of a stream whose source and destination block
+     * are on different motherboards.
+     */
+    typedef boost::function<void(const uhd::sid_t &)> route_fn_t;
+
     /*!
      * \param name An optional name to describe this graph
      * \param device_ptr Weak pointer to the originating device3
+     * \param route_fn Sets up streams between motherboards. If empty, blocks
+     *                 can only be connected within one motherboard.
      * \param msg_handler Pointer to the async message handler
      */
     graph_impl(
             const std::string &name,
-            boost::weak_ptr<uhd::device3> device_ptr
+            boost::weak_ptr<uhd::device3> device_ptr,
+            route_fn_t route_fn = route_fn_t()
             //async_msg_handler::sptr msg_handler
     );
     virtual ~graph_impl() {};
@@ -54,6 +66,20 @@ public:
             const block_id_t &dst_block
     );
 
+    void connect(
+            const block_id_t &src_block,
+            size_t src_block_port,
+            host_block_ctrl::sptr dst_block,
+            size_t dst_block_port = ANY_PORT
+    );
+
+    void connect(
+            host_block_ctrl::sptr src_block,
+            size_t src_block_port,
+            const block_id_t &dst_block,
+            size_t dst_block_port
+    );
+
     /************************************************************************
      * Utilities
      ***********************************************************************/
@@ -68,6 +94,9 @@ private:
     //! Reference to the generating device object
     const boost::weak_ptr<uhd::device3> _device_ptr;
 
+    //! Routes streams between motherboards
+    const route_fn_t _route_fn;
+
 };
 
 }} /* namespace uhd::rfnoc */
@@ -0,0 +1,62 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/rfnoc/host_block_ctrl.hpp>
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+
+using namespace uhd::rfnoc;
+
+host_block_ctrl::host_block_ctrl(const std::string &name) :
+    _name(name)
+{
+    /* nop */
+}
+
+void host_block_ctrl::set_item_format(const std::string &format, const size_t port)
+{
+    boost::mutex::scoped_lock lock(_format_mutex);
+    _item_formats[port] = format;
+}
+
+std::string host_block_ctrl::get_item_format(const size_t port) const
+{
+    boost::mutex::scoped_lock lock(_format_mutex);
+    std::map<size_t, std::string>::const_iterator it = _item_formats.find(port);
+    return (it == _item_formats.end()) ? "" : it->second;
+}
+
+void host_block_ctrl::issue_stream_cmd(const uhd::stream_cmd_t &stream_cmd, const size_t chan)
+{
+    UHD_RFNOC_BLOCK_TRACE() << "host_block_ctrl::issue_stream_cmd() " << chan << std::endl;
+    if (not list_upstream_nodes().count(chan)) {
+        throw uhd::runtime_error(str(
+            boost::format("[%s] Can't issue stream command, input port %d is not connected.")
+            % unique_id() % chan
+        ));
+    }
+    source_node_ctrl::sptr upstream_node =
+        boost::dynamic_pointer_cast<source_node_ctrl>(list_upstream_nodes().at(chan).lock());
+    if (not upstream_node) {
+        throw uhd::runtime_error(str(
+            boost::format("[%s] Can't issue stream command, the block on input port %d is gone.")
+            % unique_id() % chan
+        ));
+    }
+    upstream_node->issue_stream_cmd(stream_cmd, get_upstream_port(chan));
+}
+// vim: sw=4 et:
@@ -20,6 +20,8 @@
 #include <uhd/property_tree.hpp>
 #include <uhd/rfnoc/radio_ctrl.hpp>
 #include <uhd/rfnoc/ddc_block_ctrl.hpp>
+#include <uhd/rfnoc/siggen_block_ctrl.hpp>
+#include <uhd/rfnoc/dma_fifo_block_ctrl.hpp>
 #include <uhd/rfnoc/graph.hpp>
 #include <uhd/usrp/subdev_spec.hpp>
 #include <uhd/stream.hpp>
@@ -31,7 +33,9 @@
 #include <uhd/transport/chdr.hpp>
 #include <uhd/usrp/multi_usrp.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/bind.hpp>
 #include <boost/assign.hpp>
+#include <algorithm>
 
 #define UHD_LEGACY_LOG() UHD_LOGV(never)
 
@@ -48,6 +52,7 @@ static const std::string DFIFO_BLOCK_NAME = "DmaFIFO";
 static const std::string SFIFO_BLOCK_NAME = "FIFO";
 static const std::string DDC_BLOCK_NAME = "DDC";
 static const std::string DUC_BLOCK_NAME = "DUC";
+static const std::string SIGGEN_BLOCK_NAME = "SigGen";
 static const size_t MAX_BYTES_PER_HEADER =
         uhd::transport::vrt::chdr::max_if_hdr_words64 * sizeof(uint64_t);
 static const size_t BYTES_PER_SAMPLE = 4; // We currently only support sc16
@@ -97,6 +102,27 @@ size_t calc_num_tx_chans_per_radio(
     );
 }
 
+size_t calc_num_rx_chans_per_radio(
+    const uhd::property_tree::sptr &tree,
+    const size_t num_radios_per_board,
+    const bool has_ddcs,
+    const bool has_rx_dram
+) {
+    size_t num_chans = num_ports(tree, RADIO_BLOCK_NAME, "out");
+    if (has_ddcs) {
+        num_chans = std::min(num_chans, num_ports(tree, DDC_BLOCK_NAME, "out"));
+    }
+
+    if (not has_rx_dram) {
+        return num_chans;
+    }
+
+    const size_t num_dmafifo_ports_per_radio = num_ports(tree, DFIFO_BLOCK_NAME, "in") / num_radios_per_board;
+    UHD_ASSERT_THROW(num_dmafifo_ports_per_radio);
+
+    return std::min(num_chans, num_dmafifo_ports_per_radio);
+}
+
 double lambda_const_double(const double d)
 {
     return d;
@@ -131,28 +157,38 @@ public:
         _tree(device->get_tree()),
         _has_ducs(not args.has_key("skip_duc") and not device->find_blocks(DUC_BLOCK_NAME).empty()),
         _has_ddcs(not args.has_key("skip_ddc") and not device->find_blocks(DDC_BLOCK_NAME).empty()),
-        _has_dmafifo(not args.has_key("skip_dram") and not device->find_blocks(DFIFO_BLOCK_NAME).empty()),
+        _has_dmafifo(not args.has_key("skip_dram") and not args.has_key("rx_dram") and not device->find_blocks(DFIFO_BLOCK_NAME).empty()),
+        _has_rx_dram(args.has_key("rx_dram") and not device->find_blocks(DFIFO_BLOCK_NAME).empty()),
         _has_sramfifo(not args.has_key("skip_sram") and not device->find_blocks(SFIFO_BLOCK_NAME).empty()),
+        _has_siggens(args.has_key("tx_siggen") and not device->find_blocks(SIGGEN_BLOCK_NAME).empty()),
         _num_mboards(_tree->list("/mboards").size()),
         _num_radios_per_board(device->find_blocks<radio_ctrl>("0/Radio").size()), // These might throw, maybe we catch that and provide a nicer error message.
         _num_tx_chans_per_radio(
             calc_num_tx_chans_per_radio(_tree, _num_radios_per_board, _has_ducs, not device->find_blocks(DFIFO_BLOCK_NAME).empty())
         ),
-        _num_rx_chans_per_radio(_has_ddcs ?
-                std::min(num_ports(_tree, RADIO_BLOCK_NAME, "out"), num_ports(_tree, DDC_BLOCK_NAME, "out"))
-                : num_ports(_tree, RADIO_BLOCK_NAME, "out")),
+        _num_rx_chans_per_radio(
+            calc_num_rx_chans_per_radio(_tree, _num_radios_per_board, _has_ddcs, _has_rx_dram)
+        ),
         _rx_spp(get_block_ctrl<radio_ctrl>(0, RADIO_BLOCK_NAME, 0)->get_arg<int>("spp")),
         _tx_spp(_rx_spp),
         _rx_channel_map(_num_mboards, std::vector<radio_port_pair_t>(_num_radios_per_board)),
-        _tx_channel_map(_num_mboards, std::vector<radio_port_pair_t>(_num_radios_per_board))
+        _tx_channel_map(_num_mboards, std::vector<radio_port_pair_t>(_num_radios_per_board)),
+        _rx_chan_handles(_num_mboards),
+        _tx_chan_handles(_num_mboards),
+        _rx_subdev_specs(_num_mboards),
+        _tx_subdev_specs(_num_mboards)
     {
         _device->clear();
         check_available_periphs(); // Throws if invalid configuration.
+        resolve_blocks();
         setup_prop_tree();
         if (_tree->exists("/mboards/0/mtu/send")) {
             _tx_spp = (_tree->access<size_t>("/mboards/0/mtu/send").get() - MAX_BYTES_PER_HEADER) / BYTES_PER_SAMPLE;
         }
         connect_blocks();
+        if (_has_rx_dram and args.has_key("rx_dram_depth")) {
+            resize_rx_dram(args.cast<uint32_t>("rx_dram_depth", 0));
+        }
         if (args.has_key("skip_ddc")) {
             UHD_LEGACY_LOG() << "[legacy_compat] Skipping DDCs by user request." << std::endl;
         } else if (not _has_ddcs) {
@@ -168,12 +204,20 @@ public:
         if (args.has_key("skip_dram")) {
             UHD_LEGACY_LOG() << "[legacy_compat] Skipping DRAM by user request." << std::endl;
         }
+        if (_has_rx_dram) {
+            UHD_LEGACY_LOG() << "[legacy_compat] Buffering the Rx channels in DRAM by user request." << std::endl;
+        } else if (args.has_key("rx_dram")) {
+            UHD_MSG(warning) << "[legacy_compat] No DRAM FIFO detected. The Rx channels are not buffered on the device." << std::endl;
+        }
         if (args.has_key("skip_sram")) {
             UHD_LEGACY_LOG() << "[legacy_compat] Skipping SRAM by user request." << std::endl;
         }
         if (not _has_dmafifo and not _has_sramfifo) {
             UHD_MSG(warning) << "[legacy_compat] No FIFO detected. Higher transmit rates may encounter errors." << std::endl;
         }
+        if (args.has_key("tx_siggen") and not _has_siggens) {
+            UHD_MSG(warning) << "[legacy_compat] No signal generators detected, the TX channels are all streamed." << std::endl;
+        }
 
         for (size_t mboard = 0; mboard < _num_mboards; mboard++) {
             for (size_t radio = 0; radio < _num_radios_per_board; radio++) {
@@ -183,6 +227,8 @@ public:
 
             const double tick_rate = _tree->access<double>(mb_root(mboard) / "tick_rate").get();
             update_tick_rate_on_blocks(tick_rate, mboard);
+            update_chan_handles(mboard, uhd::RX_DIRECTION);
+            update_chan_handles(mboard, uhd::TX_DIRECTION);
         }
     }
 
@@ -203,15 +249,7 @@ public:
 
     uhd::fs_path rx_dsp_root(const size_t mboard_idx, const size_t chan)
     {
-        // The DSP index is the same as the radio index
-        size_t dsp_index = _rx_channel_map[mboard_idx][chan].radio_index;
-        size_t port_index = _rx_channel_map[mboard_idx][chan].port_index;
-
-        if (not _has_ddcs) {
-            return mb_root(mboard_idx) / "rx_dsps" / dsp_index / port_index;
-        }
-
-        return rx_dsp_root(mboard_idx, dsp_index, port_index);
+        return _rx_chan_handles[mboard_idx][chan].dsp_root;
     }
 
     inline uhd::fs_path tx_dsp_root(const size_t mboard_idx, const size_t dsp_index, const size_t port_index)
@@ -223,35 +261,30 @@ public:
 
     uhd::fs_path tx_dsp_root(const size_t mboard_idx, const size_t chan)
     {
-        // The DSP index is the same as the radio index
-        size_t dsp_index = _tx_channel_map[mboard_idx][chan].radio_index;
-        size_t port_index = _tx_channel_map[mboard_idx][chan].port_index;
+        return _tx_chan_handles[mboard_idx][chan].dsp_root;
+    }
 
-        if (not _has_ducs) {
-            return mb_root(mboard_idx) / "tx_dsps" / dsp_index / port_index;
+    siggen_block_ctrl::sptr get_tx_siggen(const size_t mboard_idx, const size_t chan)
+    {
+        const radio_port_pair_t &radio_port = _tx_channel_map.at(mboard_idx).at(chan);
+        siggen_block_ctrl::sptr siggen = get_siggen(mboard_idx, radio_port);
+        if (not siggen) {
+            throw uhd::not_implemented_error(str(
+                boost::format("[legacy_compat] TX channel %d of motherboard %d is not fed by a signal generator, see the tx_siggen device arg")
+                % chan % mboard_idx
+            ));
         }
-
-        return tx_dsp_root(mboard_idx, dsp_index, port_index);
+        return siggen;
     }
 
     uhd::fs_path rx_fe_root(const size_t mboard_idx, const size_t chan)
     {
-        size_t radio_index = _rx_channel_map[mboard_idx][chan].radio_index;
-        size_t port_index = _rx_channel_map[mboard_idx][chan].port_index;
-        return uhd::fs_path(str(
-                boost::format("/mboards/%d/xbar/%s_%d/rx_fe_corrections/%d/")
-                % mboard_idx % RADIO_BLOCK_NAME % radio_index % port_index
-        ));
+        return _rx_chan_handles[mboard_idx][chan].fe_root;
     }
 
     uhd::fs_path tx_fe_root(const size_t mboard_idx, const size_t chan)
     {
-        size_t radio_index = _tx_channel_map[mboard_idx][chan].radio_index;
-        size_t port_index = _tx_channel_map[mboard_idx][chan].port_index;
-        return uhd::fs_path(str(
-                boost::format("/mboards/%d/xbar/%s_%d/tx_fe_corrections/%d/")
-                % mboard_idx % RADIO_BLOCK_NAME % radio_index % port_index
-        ));
+        return _tx_chan_handles[mboard_idx][chan].fe_root;
     }
 
     void issue_stream_cmd(const stream_cmd_t &stream_cmd, size_t mboard, size_t chan)
@@ -260,10 +293,18 @@ public:
         const size_t &radio_index = _rx_channel_map[mboard][chan].radio_index;
         const size_t &port_index  = _rx_channel_map[mboard][chan].port_index;
         if (_has_ddcs) {
-            get_block_ctrl<ddc_block_ctrl>(mboard, DDC_BLOCK_NAME, radio_index)->issue_stream_cmd(stream_cmd, port_index);
+            _ddc_ctrls[mboard][radio_index]->issue_stream_cmd(stream_cmd, port_index);
         } else {
-            get_block_ctrl<radio_ctrl>(mboard, RADIO_BLOCK_NAME, radio_index)->issue_stream_cmd(stream_cmd, port_index);
+            _radio_ctrls[mboard][radio_index]->issue_stream_cmd(stream_cmd, port_index);
+        }
+    }
+
+    void set_command_time(const uhd::time_spec_t &time_spec, const size_t mboard)
+    {
+        if (not _time_cmd_props.at(mboard)) {
+            throw uhd::not_implemented_error("timed command feature not implemented on this hardware");
         }
+        _time_cmd_props[mboard]->set(time_spec);
     }
 
     //! Sets block_id<N> and block_port<N> in the streamer args, otherwise forwards the call
@@ -310,7 +351,7 @@ public:
             const size_t chan,
             uhd::direction_t dir
     ) {
-        radio_ctrl::sptr radio_sptr = get_block_ctrl<radio_ctrl>(mboard_idx, RADIO_BLOCK_NAME, radio_idx);
+        radio_ctrl::sptr radio_sptr = _radio_ctrls[mboard_idx][radio_idx];
         const double samp_rate = (dir == uhd::TX_DIRECTION) ?
             radio_sptr->get_input_samp_rate(chan) :
             radio_sptr->get_output_samp_rate(chan)
@@ -331,15 +372,19 @@ public:
             return;
         }
 
-        // Set DDC values:
+        // Collect the DDCs to change and the streamers running through them:
+        std::vector<chan_handles_t> handles;
+        std::vector<uhd::rx_streamer::sptr> streamers;
         if (chan == uhd::usrp::multi_usrp::ALL_CHANS) {
             for (size_t mboard_idx = 0; mboard_idx < _rx_channel_map.size(); mboard_idx++) {
-                for (size_t chan_idx = 0; chan_idx < _rx_channel_map[mboard_idx].size(); chan_idx++) {
-                    const size_t dsp_index  = _rx_channel_map[mboard_idx][chan_idx].radio_index;
-                    const size_t port_index = _rx_channel_map[mboard_idx][chan_idx].port_index;
-                    _tree->access<double>(rx_dsp_root(mboard_idx, dsp_index, port_index) / "rate/value")
-                        .set(rate)
-                    ;
+                for (size_t chan_idx = 0; chan_idx < _rx_chan_handles[mboard_idx].size(); chan_idx++) {
+                    handles.push_back(_rx_chan_handles[mboard_idx][chan_idx]);
+                }
+            }
+            BOOST_FOREACH(const rx_stream_map_type::value_type &chan_streamer_pair, _rx_stream_cache) {
+                uhd::rx_streamer::sptr str_ptr = chan_streamer_pair.second.lock();
+                if (str_ptr and std::find(streamers.begin(), streamers.end(), str_ptr) == streamers.end()) {
+                    streamers.push_back(str_ptr);
                 }
             }
         } else {
@@ -347,6 +392,7 @@ public:
             if (_rx_stream_cache.count(chan)) {
                 uhd::rx_streamer::sptr str_ptr = _rx_stream_cache[chan].lock();
                 if (str_ptr) {
+                    streamers.push_back(str_ptr);
                     BOOST_FOREACH(const rx_stream_map_type::value_type &chan_streamer_pair, _rx_stream_cache) {
                         if (chan_streamer_pair.second.lock() == str_ptr) {
                             chans_to_change.insert(chan_streamer_pair.first);
@@ -357,15 +403,14 @@ public:
             BOOST_FOREACH(const size_t this_chan, chans_to_change) {
                 size_t mboard, mb_chan;
                 chan_to_mcp<uhd::RX_DIRECTION>(this_chan, _rx_channel_map, mboard, mb_chan);
-                const size_t dsp_index  = _rx_channel_map[mboard][mb_chan].radio_index;
-                const size_t port_index = _rx_channel_map[mboard][mb_chan].port_index;
-                _tree->access<double>(rx_dsp_root(mboard, dsp_index, port_index) / "rate/value")
-                    .set(rate)
-                ;
+                handles.push_back(_rx_chan_handles[mboard][mb_chan]);
             }
         }
-        // Update streamers:
-        boost::dynamic_pointer_cast<uhd::usrp::device3_impl>(_device)->update_rx_streamers(rate);
+        // Set DDC values with the streams stopped, and update the streamers in place:
+        _device->reconfigure_streamers(
+            boost::bind(&legacy_compat_impl::set_dsp_rates, this, boost::cref(handles), rate),
+            streamers
+        );
     }
 
     void set_tx_rate(const double rate, const size_t chan)
@@ -374,15 +419,12 @@ public:
             return;
         }
 
-        // Set DUC values:
+        // Collect the DUCs to change:
+        std::vector<chan_handles_t> handles;
         if (chan == uhd::usrp::multi_usrp::ALL_CHANS) {
             for (size_t mboard_idx = 0; mboard_idx < _tx_channel_map.size(); mboard_idx++) {
-                for (size_t chan_idx = 0; chan_idx < _tx_channel_map[mboard_idx].size(); chan_idx++) {
-                    const size_t dsp_index = _tx_channel_map[mboard_idx][chan_idx].radio_index;
-                    const size_t port_index  = _tx_channel_map[mboard_idx][chan_idx].port_index;
-                    _tree->access<double>(tx_dsp_root(mboard_idx, dsp_index, port_index) / "rate/value")
-                        .set(rate)
-                    ;
+                for (size_t chan_idx = 0; chan_idx < _tx_chan_handles[mboard_idx].size(); chan_idx++) {
+                    handles.push_back(_tx_chan_handles[mboard_idx][chan_idx]);
                 }
             }
         } else {
@@ -400,15 +442,13 @@ public:
             BOOST_FOREACH(const size_t this_chan, chans_to_change) {
                 size_t mboard, mb_chan;
                 chan_to_mcp<uhd::TX_DIRECTION>(this_chan, _tx_channel_map, mboard, mb_chan);
-                const size_t dsp_index  = _tx_channel_map[mboard][mb_chan].radio_index;
-                const size_t port_index = _tx_channel_map[mboard][mb_chan].port_index;
-                _tree->access<double>(tx_dsp_root(mboard, dsp_index, port_index) / "rate/value")
-                    .set(rate)
-                ;
+                handles.push_back(_tx_chan_handles[mboard][mb_chan]);
             }
         }
-        // Update streamers:
-        boost::dynamic_pointer_cast<uhd::usrp::device3_impl>(_device)->update_tx_streamers(rate);
+        // Set DUC values and update the streamers in place (there is no TX stream to stop):
+        _device->reconfigure_streamers(
+            boost::bind(&legacy_compat_impl::set_dsp_rates, this, boost::cref(handles), rate)
+        );
     }
 
 private: // types
@@ -422,6 +462,18 @@ private: // types
     // ports and correct order anyway.
     typedef std::vector< std::vector<radio_port_pair_t> > chan_map_t;
 
+    //! Everything the API calls need for one channel, so they don't have
+    // to build property paths or look up blocks on every call. Resolved
+    // whenever the channel mapping changes.
+    struct chan_handles_t {
+        uhd::fs_path dsp_root;
+        uhd::fs_path fe_root;
+        //! The DSP rate property, NULL if there is none (no DDC/DUC)
+        boost::shared_ptr< uhd::property<double> > dsp_rate;
+    };
+    //! Map: _rx_chan_handles[mboard_idx][chan_idx] => handles, same layout as chan_map_t
+    typedef std::vector< std::vector<chan_handles_t> > chan_handles_map_t;
+
 private: // methods
     /************************************************************************
      * Private helpers
@@ -443,6 +495,22 @@ private: // methods
         return _device->get_block_ctrl<block_type>(block_id);
     }
 
+    inline void set_dsp_rate(const chan_handles_t &chan_handles, const double rate)
+    {
+        if (chan_handles.dsp_rate) {
+            chan_handles.dsp_rate->set(rate);
+        } else {
+            _tree->access<double>(chan_handles.dsp_root / "rate/value").set(rate);
+        }
+    }
+
+    void set_dsp_rates(const std::vector<chan_handles_t> &handles, const double rate)
+    {
+        BOOST_FOREACH(const chan_handles_t &chan_handles, handles) {
+            set_dsp_rate(chan_handles, rate);
+        }
+    }
+
     template <uhd::direction_t dir>
     inline void chan_to_mcp(
         const size_t chan, const chan_map_t &chan_map,
@@ -470,9 +538,12 @@ private: // methods
     ) {
         // If the user provides spp, that value is always applied. If it's
         // different from what we thought it was, we need to update the blocks.
-        // If it's not provided, we provide our own spp value.
+        // If it's not provided, we provide our own spp value, unless a
+        // profile was requested. Then the streamer picks it.
         const size_t args_spp = args.args.cast<size_t>("spp", 0);
-        if (dir == uhd::RX_DIRECTION) {
+        if (args.args.has_key("profile") and not args.args.has_key("spp")) {
+            // Nothing to do here
+        } else if (dir == uhd::RX_DIRECTION) {
             size_t target_spp = _rx_spp;
             if (args.args.has_key("spp") and args_spp != _rx_spp) {
                 target_spp = args_spp;
@@ -480,14 +551,14 @@ private: // methods
             } else {
                 for (size_t mboard = 0; mboard < _num_mboards; mboard++) {
                     for (size_t radio = 0; radio < _num_radios_per_board; radio++) {
-                        const size_t this_spp = get_block_ctrl<radio_ctrl>(mboard, RADIO_BLOCK_NAME, radio)->get_arg<int>("spp");
+                        const size_t this_spp = _radio_ctrls[mboard][radio]->get_arg<int>("spp");
                         target_spp = std::min(this_spp, target_spp);
                     }
                 }
             }
             for (size_t mboard = 0; mboard < _num_mboards; mboard++) {
                 for (size_t radio = 0; radio < _num_radios_per_board; radio++) {
-                    get_block_ctrl<radio_ctrl>(mboard, RADIO_BLOCK_NAME, radio)->set_arg<int>("spp", target_spp);
+                    _radio_ctrls[mboard][radio]->set_arg<int>("spp", target_spp);
                 }
             }
             _rx_spp = target_spp;
@@ -512,6 +583,12 @@ private: // methods
             // Map that mboard and channel to a block:
             const size_t radio_index = chan_map[mboard_idx][this_mboard_chan_idx].radio_index;
             size_t port_index = chan_map[mboard_idx][this_mboard_chan_idx].port_index;
+            if (dir == uhd::TX_DIRECTION and get_siggen(mboard_idx, chan_map[mboard_idx][this_mboard_chan_idx])) {
+                throw uhd::runtime_error(str(
+                    boost::format("[legacy_compat] TX channel %d is fed by a signal generator and cannot be streamed to")
+                    % stream_arg_chan_idx
+                ));
+            }
             const std::string block_name = _get_streamer_block_id_and_port<dir>(mboard_idx, radio_index, port_index);
             args.args[str(boost::format("block_id%d") % stream_arg_chan_idx)] = block_name;
             args.args[str(boost::format("block_port%d") % stream_arg_chan_idx)] = str(boost::format("%d") % port_index);
@@ -521,6 +598,15 @@ private: // methods
         }
     }
 
+    //! The signal generator feeding a TX radio port, NULL if the host feeds it
+    siggen_block_ctrl::sptr get_siggen(const size_t mboard_idx, const radio_port_pair_t &radio_port)
+    {
+        if (radio_port.port_index != 0) {
+            return siggen_block_ctrl::sptr();
+        }
+        return _siggen_ctrls.at(mboard_idx).at(radio_port.radio_index);
+    }
+
     template <uhd::direction_t dir>
     std::string _get_streamer_block_id_and_port(
             const size_t mboard_idx,
@@ -541,7 +627,10 @@ private: // methods
                 }
             }
         } else {
-            if (_has_ddcs) {
+            if (_has_rx_dram) {
+                port_index = get_rx_dram_port(radio_index, port_index);
+                return block_id_t(mboard_idx, DFIFO_BLOCK_NAME, 0).to_string();
+            } else if (_has_ddcs) {
                 return block_id_t(mboard_idx, DDC_BLOCK_NAME, radio_index).to_string();
             } else {
                 return block_id_t(mboard_idx, RADIO_BLOCK_NAME, radio_index).to_string();
@@ -583,7 +672,7 @@ private: // methods
                 if (not _device->has_block(radio_block_id)
                     or (_has_ducs and not _device->has_block(duc_block_id))
                     or (_has_ddcs and not _device->has_block(ddc_block_id))
-                    or (_has_dmafifo and not _device->has_block(fifo_block_id))
+                    or ((_has_dmafifo or _has_rx_dram) and not _device->has_block(fifo_block_id))
                 ) {
                     throw uhd::runtime_error("For legacy APIs, all devices require the same number of radios, DDCs and DUCs.");
                 }
@@ -599,6 +688,76 @@ private: // methods
         }
     }
 
+    /*! Look up the block controls and the properties used on every API call
+     */
+    void resolve_blocks()
+    {
+        _radio_ctrls.resize(_num_mboards);
+        _ddc_ctrls.resize(_num_mboards);
+        _siggen_ctrls.resize(_num_mboards);
+        _time_cmd_props.resize(_num_mboards);
+        for (size_t mboard = 0; mboard < _num_mboards; mboard++) {
+            for (size_t radio = 0; radio < _num_radios_per_board; radio++) {
+                _radio_ctrls[mboard].push_back(get_block_ctrl<radio_ctrl>(mboard, RADIO_BLOCK_NAME, radio));
+                if (_has_ddcs) {
+                    _ddc_ctrls[mboard].push_back(get_block_ctrl<ddc_block_ctrl>(mboard, DDC_BLOCK_NAME, radio));
+                }
+                // Radios without a signal generator of their own stay streamed
+                const block_id_t siggen_id(mboard, SIGGEN_BLOCK_NAME, radio);
+                _siggen_ctrls[mboard].push_back(_has_siggens and _device->has_block(siggen_id) ?
+                    _device->get_block_ctrl<siggen_block_ctrl>(siggen_id) : siggen_block_ctrl::sptr());
+            }
+            if (_tree->exists(mb_root(mboard) / "time/cmd")) {
+                _time_cmd_props[mboard] = _tree->access_handle<uhd::time_spec_t>(mb_root(mboard) / "time/cmd");
+            }
+        }
+    }
+
+    /*! Resolve the channel handles and the subdev spec of one mboard from
+     *  its channel mapping.
+     */
+    void update_chan_handles(const size_t mboard, const uhd::direction_t dir)
+    {
+        const chan_map_t &chan_map = (dir == uhd::TX_DIRECTION) ? _tx_channel_map : _rx_channel_map;
+        const bool has_dsps = (dir == uhd::TX_DIRECTION) ? _has_ducs : _has_ddcs;
+        std::vector<chan_handles_t> handles(chan_map[mboard].size());
+        subdev_spec_t subdev_spec;
+        for (size_t chan_idx = 0; chan_idx < chan_map[mboard].size(); chan_idx++) {
+            // The DSP index is the same as the radio index
+            const size_t radio_index = chan_map[mboard][chan_idx].radio_index;
+            const size_t port_index = chan_map[mboard][chan_idx].port_index;
+            chan_handles_t &chan_handles = handles[chan_idx];
+            if (dir == uhd::TX_DIRECTION) {
+                chan_handles.dsp_root = has_dsps ?
+                    tx_dsp_root(mboard, radio_index, port_index) :
+                    mb_root(mboard) / "tx_dsps" / radio_index / port_index;
+            } else {
+                chan_handles.dsp_root = has_dsps ?
+                    rx_dsp_root(mboard, radio_index, port_index) :
+                    mb_root(mboard) / "rx_dsps" / radio_index / port_index;
+            }
+            chan_handles.fe_root = uhd::fs_path(str(
+                    boost::format("/mboards/%d/xbar/%s_%d/%s_fe_corrections/%d/")
+                    % mboard % RADIO_BLOCK_NAME % radio_index
+                    % ((dir == uhd::TX_DIRECTION) ? "tx" : "rx") % port_index
+            ));
+            if (has_dsps and _tree->exists(chan_handles.dsp_root / "rate/value")) {
+                chan_handles.dsp_rate = _tree->access_handle<double>(chan_handles.dsp_root / "rate/value");
+            }
+            subdev_spec.push_back(subdev_spec_pair_t(
+                    get_slot_name(radio_index),
+                    _radio_ctrls[mboard][radio_index]->get_dboard_fe_from_chan(port_index, dir)
+            ));
+        }
+        if (dir == uhd::TX_DIRECTION) {
+            _tx_chan_handles[mboard] = handles;
+            _tx_subdev_specs[mboard] = subdev_spec;
+        } else {
+            _rx_chan_handles[mboard] = handles;
+            _rx_subdev_specs[mboard] = subdev_spec;
+        }
+    }
+
     /*! Initialize properties in property tree to match legacy mode
      */
     void setup_prop_tree()
@@ -637,7 +796,7 @@ private: // methods
                             .set_publisher(
                                 boost::bind(
                                     &radio_ctrl::get_output_samp_rate,
-                                    get_block_ctrl<radio_ctrl>(mboard_idx, RADIO_BLOCK_NAME, radio_idx),
+                                    _radio_ctrls[mboard_idx][radio_idx],
                                     chan
                                 )
                             )
@@ -670,7 +829,7 @@ private: // methods
                             .set_publisher(
                                 boost::bind(
                                     &radio_ctrl::get_output_samp_rate,
-                                    get_block_ctrl<radio_ctrl>(mboard_idx, RADIO_BLOCK_NAME, radio_idx),
+                                    _radio_ctrls[mboard_idx][radio_idx],
                                     chan
                                 )
                             )
@@ -727,6 +886,9 @@ private: // methods
      *
      * Radio => DDC => [Host]
      *
+     * or, with the rx_dram device arg, Radio => DDC => DMA FIFO => [Host],
+     * where every Rx channel gets a port of the DMA FIFO to itself.
+     *
      * Streamers are *not* generated here.
      */
     void connect_blocks()
@@ -738,6 +900,15 @@ private: // methods
             for (size_t radio = 0; radio < _num_radios_per_board; radio++) {
                 // Tx Channels
                 for (size_t chan = 0; chan < _num_tx_chans_per_radio; chan++) {
+                    if (get_siggen(mboard, radio_port_pair_t(radio, chan))) {
+                        // The signal generator feeds port 0, instead of the host
+                        _graph->connect(
+                            block_id_t(mboard, SIGGEN_BLOCK_NAME, radio), 0,
+                            block_id_t(mboard, _has_ducs ? DUC_BLOCK_NAME : RADIO_BLOCK_NAME, radio), chan,
+                            tx_bpp
+                        );
+                        continue;
+                    }
                     if (_has_ducs) {
                         _graph->connect(
                             block_id_t(mboard, DUC_BLOCK_NAME,   radio), chan,
@@ -785,6 +956,38 @@ private: // methods
                             rx_bpp
                         );
                     }
+                    if (_has_rx_dram) {
+                        _graph->connect(
+                            block_id_t(mboard, _has_ddcs ? DDC_BLOCK_NAME : RADIO_BLOCK_NAME, radio), chan,
+                            block_id_t(mboard, DFIFO_BLOCK_NAME, 0), get_rx_dram_port(radio, chan),
+                            rx_bpp
+                        );
+                    }
+                }
+            }
+        }
+    }
+
+    //! The DMA FIFO port which buffers an Rx channel
+    size_t get_rx_dram_port(const size_t radio, const size_t chan)
+    {
+        return radio * _num_rx_chans_per_radio + chan;
+    }
+
+    /*! Give every Rx channel \p depth bytes of DRAM, one after the other.
+     *
+     * The depth is how long the device can wait for the host before it
+     * overflows, e.g. 256 MiB hold 335 ms of sc16 samples at 200 Msps.
+     */
+    void resize_rx_dram(const uint32_t depth)
+    {
+        for (size_t mboard = 0; mboard < _num_mboards; mboard++) {
+            dma_fifo_block_ctrl::sptr fifo =
+                get_block_ctrl<dma_fifo_block_ctrl>(mboard, DFIFO_BLOCK_NAME, 0);
+            for (size_t radio = 0; radio < _num_radios_per_board; radio++) {
+                for (size_t chan = 0; chan < _num_rx_chans_per_radio; chan++) {
+                    const size_t port = get_rx_dram_port(radio, chan);
+                    fifo->resize(uint32_t(port * depth), depth, port);
                 }
             }
         }
@@ -807,7 +1010,7 @@ private: // methods
         std::vector<radio_port_pair_t> new_mapping(spec.size());
         for (size_t i = 0; i < spec.size(); i++) {
             const size_t new_radio_index = get_radio_index(spec[i].db_name);
-            radio_ctrl::sptr radio = get_block_ctrl<radio_ctrl>(mboard, "Radio", new_radio_index);
+            radio_ctrl::sptr radio = _radio_ctrls[mboard].at(new_radio_index);
             size_t new_port_index = radio->get_chan_from_dboard_fe(spec[i].sd_name, dir);
             if (new_port_index >= radio->get_input_ports().size()) {
                 new_port_index = radio->get_input_ports().at(0);
@@ -816,38 +1019,30 @@ private: // methods
             new_mapping[i] = new_radio_port_pair;
         }
         chan_map[mboard] = new_mapping;
+        update_chan_handles(mboard, dir);
     }
 
+    //! This is queried to find the frontend of every multi_usrp call, so it
+    // returns the spec that was resolved along with the channel mapping.
     subdev_spec_t get_subdev_spec(const size_t mboard, const uhd::direction_t dir)
     {
         UHD_ASSERT_THROW(mboard < _num_mboards);
-        subdev_spec_t subdev_spec;
-        chan_map_t &chan_map = (dir == uhd::TX_DIRECTION) ? _tx_channel_map : _rx_channel_map;
-        for (size_t chan_idx = 0; chan_idx < chan_map[mboard].size(); chan_idx++) {
-            const size_t radio_index = chan_map[mboard][chan_idx].radio_index;
-            const size_t port_index = chan_map[mboard][chan_idx].port_index;
-            const std::string new_db_name = get_slot_name(radio_index);
-            const std::string new_sd_name =
-                get_block_ctrl<radio_ctrl>(mboard, "Radio", radio_index)->get_dboard_fe_from_chan(port_index, dir);
-            subdev_spec_pair_t new_pair(new_db_name, new_sd_name);
-            subdev_spec.push_back(new_pair);
-        }
-
-        return subdev_spec;
+        return (dir == uhd::TX_DIRECTION) ? _tx_subdev_specs[mboard] : _rx_subdev_specs[mboard];
     }
 
     void update_tick_rate_on_blocks(const double tick_rate, const size_t mboard_idx)
     {
-        block_id_t radio_block_id(mboard_idx, RADIO_BLOCK_NAME);
         block_id_t duc_block_id(mboard_idx, DUC_BLOCK_NAME);
         block_id_t ddc_block_id(mboard_idx, DDC_BLOCK_NAME);
 
         for (size_t radio = 0; radio < _num_radios_per_board; radio++) {
-            radio_block_id.set_block_count(radio);
             duc_block_id.set_block_count(radio);
             ddc_block_id.set_block_count(radio);
-            radio_ctrl::sptr radio_sptr = _device->get_block_ctrl<radio_ctrl>(radio_block_id);
+            radio_ctrl::sptr radio_sptr = _radio_ctrls[mboard_idx][radio];
             radio_sptr->set_rate(tick_rate);
+            if (_siggen_ctrls[mboard_idx][radio]) {
+                _siggen_ctrls[mboard_idx][radio]->set_command_tick_rate(tick_rate);
+            }
             for (size_t chan = 0; chan < _num_rx_chans_per_radio and _has_ddcs; chan++) {
                 const double radio_output_rate = radio_sptr->get_output_samp_rate(chan);
                 _device->get_block_ctrl(ddc_block_id)->set_arg<double>("input_rate", radio_output_rate, chan);
@@ -866,7 +1061,10 @@ private: // attributes
     const bool _has_ducs;
     const bool _has_ddcs;
     const bool _has_dmafifo;
+    //! The DMA FIFO buffers the Rx channels instead of the Tx ones
+    const bool _has_rx_dram;
     const bool _has_sramfifo;
+    const bool _has_siggens;
     const size_t _num_mboards;
     const size_t _num_radios_per_board;
     const size_t _num_tx_chans_per_radio;
@@ -876,6 +1074,18 @@ private: // attributes
 
     chan_map_t _rx_channel_map;
     chan_map_t _tx_channel_map;
+    chan_handles_map_t _rx_chan_handles;
+    chan_handles_map_t _tx_chan_handles;
+    std::vector<subdev_spec_t> _rx_subdev_specs;
+    std::vector<subdev_spec_t> _tx_subdev_specs;
+
+    //! Block controls, indexed [mboard_idx][radio_idx] (the DDCs match the radios)
+    std::vector< std::vector<radio_ctrl::sptr> > _radio_ctrls;
+    std::vector< std::vector<ddc_block_ctrl::sptr> > _ddc_ctrls;
+    //! The signal generators feeding port 0 of each radio, NULL where there is none
+    std::vector< std::vector<siggen_block_ctrl::sptr> > _siggen_ctrls;
+    //! The time/cmd property of every mboard, NULL if it has none
+    std::vector< boost::shared_ptr< uhd::property<uhd::time_spec_t> > > _time_cmd_props;
 
     //! Stores a weak pointer for every streamer that's generated through this API.
     // Key is the channel number (same format as e.g. the set_rx_rate() call).
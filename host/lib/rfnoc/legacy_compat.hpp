@@ -19,7 +19,9 @@
 #define INCLUDED_RFNOC_LEGACY_COMPAT_HPP
 
 #include <uhd/device3.hpp>
+#include <uhd/rfnoc/siggen_block_ctrl.hpp>
 #include <uhd/stream.hpp>
+#include <uhd/types/time_spec.hpp>
 
 namespace uhd { namespace rfnoc {
 
@@ -34,12 +36,16 @@ namespace uhd { namespace rfnoc {
 
         virtual uhd::fs_path tx_dsp_root(const size_t mboard_idx, const size_t chan) = 0;
 
+        virtual siggen_block_ctrl::sptr get_tx_siggen(const size_t mboard_idx, const size_t chan) = 0;
+
         virtual uhd::fs_path rx_fe_root(const size_t mboard_idx, const size_t chan) = 0;
 
         virtual uhd::fs_path tx_fe_root(const size_t mboard_idx, const size_t chan) = 0;
 
         virtual void issue_stream_cmd(const uhd::stream_cmd_t &stream_cmd, size_t mboard, size_t chan) = 0;
 
+        virtual void set_command_time(const uhd::time_spec_t &time_spec, const size_t mboard) = 0;
+
         virtual uhd::rx_streamer::sptr get_rx_stream(const uhd::stream_args_t &args) = 0;
 
         virtual uhd::tx_streamer::sptr get_tx_stream(const uhd::stream_args_t &args) = 0;
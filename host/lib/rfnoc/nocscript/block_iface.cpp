@@ -44,6 +44,17 @@ block_iface::block_iface(block_ctrl_base *block_ptr)
         expression::TYPE_BOOL,
         sr_write_args
     );
+    // SR_WRITE() with a vector writes all values to the register in one batch
+    expression_function::argtype_list_type sr_write_vector_args = boost::assign::list_of
+        (expression::TYPE_STRING)
+        (expression::TYPE_INT_VECTOR)
+    ;
+    ft->register_function(
+        "SR_WRITE",
+        boost::bind(&block_iface::_nocscript__sr_write_vector, this, _1),
+        expression::TYPE_BOOL,
+        sr_write_vector_args
+    );
 
     // Add read access to arguments ($foo)
     expression_function::argtype_list_type arg_set_args_wo_port = boost::assign::list_of
@@ -117,8 +128,10 @@ void block_iface::run_and_check(const std::string &code, const std::string &erro
     boost::mutex::scoped_lock local_interpreter_lock(_lil_mutex);
 
     UHD_NOCSCRIPT_LOG() << "[NocScript] Executing and asserting code: " << code << std::endl;
-    expression::sptr e = _parser->create_expr_tree(code);
-    expression_literal result = e->eval();
+    if (not _expr_cache.count(code)) {
+        _expr_cache[code] = _parser->create_expr_tree(code);
+    }
+    expression_literal result = _expr_cache[code]->eval();
     if (not result.to_bool()) {
         if (error_message.empty()) {
             throw uhd::runtime_error(str(
@@ -155,6 +168,25 @@ expression_literal block_iface::_nocscript__sr_write(expression_container::expr_
     return expression_literal(result);
 }
 
+expression_literal block_iface::_nocscript__sr_write_vector(expression_container::expr_list_type args)
+{
+    const std::string reg_name = args[0]->eval().get_string();
+    const std::vector<int> int_vals = args[1]->eval().get_int_vector();
+    const std::vector<uint32_t> reg_vals(int_vals.begin(), int_vals.end());
+    bool result = true;
+    try {
+        UHD_NOCSCRIPT_LOG() << "[NocScript] Executing SR_WRITE() with " << reg_vals.size() << " values" << std::endl;
+        _block_ptr->sr_write(reg_name, reg_vals);
+    } catch (const uhd::exception &e) {
+        UHD_MSG(error) << boost::format("[NocScript] Error while executing SR_WRITE(%s, <%u values>):\n%s")
+                          % reg_name % reg_vals.size() % e.what()
+                       << std::endl;
+        result = false;
+    }
+
+    return expression_literal(result);
+}
+
 expression::type_t block_iface::_nocscript__arg_get_type(const std::string &varname)
 {
     const std::string var_type = _block_ptr->get_arg_type(varname);
@@ -42,6 +42,8 @@ class block_iface {
       block_iface(uhd::rfnoc::block_ctrl_base* block_ptr);
 
     /*! Execute \p code and make sure it returns 'true'.
+     *
+     * Every piece of code is only parsed on its first execution.
      *
      * \param code Must be a valid NocScript expression that returns a boolean value.
      *             If it returns false, this is interpreted as failure.
@@ -58,6 +60,9 @@ class block_iface {
     //! Wrapper for block_ctrl_base::sr_write, so we can call it from within NocScript
     expression_literal _nocscript__sr_write(expression_container::expr_list_type);
 
+    //! Wrapper for the batched block_ctrl_base::sr_write, e.g. for loading taps
+    expression_literal _nocscript__sr_write_vector(expression_container::expr_list_type);
+
     //! Argument type getter that can be used within NocScript
     expression::type_t _nocscript__arg_get_type(const std::string &argname);
 
@@ -84,6 +89,9 @@ class block_iface {
     //! Pointer to the parser object
     parser::sptr _parser;
 
+    //! The expression trees of all the code executed so far
+    std::map<std::string, expression::sptr> _expr_cache;
+
     //! Container for scoped variables
     std::map<std::string, expression_literal> _vars;
 };
@@ -282,6 +282,16 @@ bool expression_container::empty() const
     return _sub_exprs.empty();
 }
 
+bool expression_container::is_constant() const
+{
+    BOOST_FOREACH(const expression::sptr &sub_expr, _sub_exprs) {
+        if (not sub_expr->is_constant()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void expression_container::set_combiner_safe(const combiner_type c)
 {
     if (_combiner == COMBINE_NOTSET) {
@@ -338,6 +348,7 @@ expression_function::expression_function(
     const function_table::sptr func_table
 ) : _name(name)
   , _func_table(func_table)
+  , _function_resolved(false)
 {
     _combiner = COMBINE_ALL;
     if (not _func_table->function_exists(_name)) {
@@ -352,6 +363,7 @@ void expression_function::add(expression::sptr new_expr)
 {
     expression_container::add(new_expr);
     _arg_types.push_back(new_expr->infer_type());
+    _function_resolved = false;
 }
 
 expression::type_t expression_function::infer_type() const
@@ -361,9 +373,21 @@ expression::type_t expression_function::infer_type() const
 
 expression_literal expression_function::eval()
 {
+    if (not _function_resolved) {
+        _function = _func_table->get_function(_name, _arg_types);
+        _function_resolved = true;
+    }
+    if (_function) {
+        return _function(_sub_exprs);
+    }
     return _func_table->eval(_name, _arg_types, _sub_exprs);
 }
 
+bool expression_function::is_constant() const
+{
+    return _func_table->is_pure(_name, _arg_types) and expression_container::is_constant();
+}
+
 
 std::string expression_function::repr() const
 {
@@ -55,6 +55,12 @@ class expression
 
     //! Evaluate current expression and return its return value
     virtual expression_literal eval() = 0;
+
+    /*! Returns true if eval() always returns the same value.
+     *
+     * Constant expressions are replaced by their value when parsing.
+     */
+    virtual bool is_constant() const { return false; };
 };
 
 /*! Literal (constant) expression class
@@ -102,6 +108,11 @@ class expression_literal : public expression
         return *this; // TODO make sure this is copy
     }
 
+    bool is_constant() const
+    {
+        return true;
+    }
+
     /*! A 'type cast' to bool. Cast rules are similar to most
      * scripting languages:
      * - Integers and doubles are false if zero, true otherwise
@@ -254,6 +265,9 @@ class expression_container : public expression
      */
     virtual expression_literal eval();
 
+    //! A container is constant if all its sub-expressions are
+    virtual bool is_constant() const;
+
   protected:
     //! Store all the sub-expressions, in order
     expr_list_type _sub_exprs;
@@ -314,9 +328,15 @@ class expression_function : public expression_container
     expression::type_t infer_type() const;
 
     /*! Evaluate all arguments, then the function itself.
+     *
+     * The function object is looked up in the function table on the
+     * first call only.
      */
     expression_literal eval();
 
+    //! A function call is constant if the function is pure and all arguments are constant
+    bool is_constant() const;
+
     //! String representation
     std::string repr() const;
 
@@ -324,6 +344,9 @@ class expression_function : public expression_container
     std::string _name;
     const boost::shared_ptr<function_table> _func_table;
     std::vector<expression::type_t> _arg_types;
+    //! The function object, once it's been looked up
+    boost::function<expression_literal(expr_list_type&)> _function;
+    bool _function_resolved;
 };
 
 
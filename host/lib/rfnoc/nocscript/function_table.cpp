@@ -30,10 +30,11 @@ class function_table_impl : public function_table
     struct function_info {
         expression::type_t return_type;
         function_ptr function;
+        bool pure;
 
-        function_info(): return_type(expression::TYPE_INT)  {};
-        function_info(const expression::type_t return_type_, const function_ptr &function_)
-            : return_type(return_type_), function(function_)
+        function_info(): return_type(expression::TYPE_INT), pure(false)  {};
+        function_info(const expression::type_t return_type_, const function_ptr &function_, const bool pure_)
+            : return_type(return_type_), function(function_), pure(pure_)
         {};
     };
     // Should be an unordered_map... sigh, we'll get to C++11 someday.
@@ -98,9 +99,31 @@ class function_table_impl : public function_table
             const std::string &name,
             const function_table::function_ptr &ptr,
             const expression::type_t return_type,
-            const expression_function::argtype_list_type &sig
+            const expression_function::argtype_list_type &sig,
+            const bool pure
     ) {
-        _table[name][sig] = function_info(return_type, ptr);
+        _table[name][sig] = function_info(return_type, ptr, pure);
+    }
+
+    bool is_pure(
+            const std::string &name,
+            const expression_function::argtype_list_type &arg_types
+    ) const {
+        return function_exists(name, arg_types)
+            and _table.find(name)->second.find(arg_types)->second.pure;
+    }
+
+    function_ptr get_function(
+            const std::string &name,
+            const expression_function::argtype_list_type &arg_types
+    ) const {
+        if (not function_exists(name, arg_types)) {
+            throw uhd::syntax_error(str(
+                        boost::format("Cannot eval() function %s, not a known signature")
+                        % expression_function::to_string(name, arg_types)
+            ));
+        }
+        return _table.find(name)->second.find(arg_types)->second.function;
     }
 
   private:
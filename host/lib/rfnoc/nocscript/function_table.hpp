@@ -78,13 +78,39 @@ class function_table
      * \param ptr Function object
      * \param return_type The function's return value
      * \param sig The function signature (list of argument types)
+     * \param pure True if the function has no side effects, and its value
+     *             only depends on its arguments. Calls with constant arguments
+     *             are then evaluated by the parser.
      */
     virtual void register_function(
             const std::string &name,
             const function_ptr &ptr,
             const expression::type_t return_type,
-            const expression_function::argtype_list_type &sig
+            const expression_function::argtype_list_type &sig,
+            const bool pure = false
     ) = 0;
+
+    /*! Check if a function with a given name and list of argument types is pure
+     *
+     * See register_function() for what a pure function is.
+     */
+    virtual bool is_pure(
+            const std::string &,
+            const expression_function::argtype_list_type &
+    ) const { return false; };
+
+    /*! Get the function object of a function with given name and argument type list
+     *
+     * Function expressions look up their function object once, instead of
+     * calling eval() every time.
+     *
+     * \returns The function object, or an empty function object if the
+     *          function table doesn't provide direct access.
+     */
+    virtual function_ptr get_function(
+            const std::string &,
+            const expression_function::argtype_list_type &
+    ) const { return function_ptr(); };
 };
 
 }}} /* namespace uhd::rfnoc::nocscript */
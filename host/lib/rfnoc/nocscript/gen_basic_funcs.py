@@ -255,6 +255,10 @@ BOOL SLEEP(DOUBLE)
     ${RETURN}(true);
 }
 """
+# Functions with side effects. All other functions are pure, so calls with
+# constant arguments get evaluated by the parser.
+IMPURE_FUNCTIONS = ('SLEEP',)
+
 # End of interesting part. The rest will take this and turn into a C++
 # header file.
 #############################################################################
@@ -327,7 +331,8 @@ REGISTER_COMMANDS_TEMPLATE = """
             "${name}",
             boost::bind(&${func_name}, _1),
             expression::TYPE_${retval},
-            ${func_name}_args
+            ${func_name}_args,
+            ${'false' if name in IMPURE_FUNCTIONS else 'true'}
     );"""
 
 DOXY_TEMPLATE = """/*! \page page_nocscript_funcs NocScript Function Reference
@@ -430,6 +435,7 @@ def write_function_header(output_filename):
         )
         registry_commands += parse_tmpl(
                 REGISTER_COMMANDS_TEMPLATE,
+                IMPURE_FUNCTIONS=IMPURE_FUNCTIONS,
                 **func
         )
     # Step 2: Write the registry process
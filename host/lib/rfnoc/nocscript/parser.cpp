@@ -136,6 +136,26 @@ class parser_impl : public parser
         static const int VALID_EXPRESSION   = 0x8 + 0x02;
         static const int VALID_OPERATOR      = 0x10;
 
+        //! Replaces a constant expression by its value, so it's only
+        // evaluated once.
+        static expression::sptr fold(expression::sptr e)
+        {
+            if (not e->is_constant()) {
+                return e;
+            }
+            try {
+                expression_literal::sptr value = boost::make_shared<expression_literal>(e->eval());
+                // AND and OR containers are boolean, but evaluate to the
+                // value of their last sub-expression, so those stay:
+                if (value->infer_type() == e->infer_type()) {
+                    return value;
+                }
+            } catch (const std::exception &) {
+                // Leave it to the evaluation to fail, it might never happen
+            }
+            return e;
+        }
+
         // !This function operator gets called for each of the matched tokens.
         template <typename Token>
         bool operator()(Token const& t, grammar_props &P, int &next_valid_state) const
@@ -236,13 +256,13 @@ class parser_impl : public parser
                 expression_container::sptr c = P.expr_stack.top();
                 P.expr_stack.pop();
                 if (not c->empty()) {
-                    P.expr_stack.top()->add(c);
+                    P.expr_stack.top()->add(fold(c));
                 }
                 // At the end of (), either a function or container is complete,
                 // so pop that and add it to its top container:
                 expression_container::sptr c2 = P.expr_stack.top();
                 P.expr_stack.pop();
-                P.expr_stack.top()->add(c2);
+                P.expr_stack.top()->add(fold(c2));
                 next_valid_state = VALID_OPERATOR | VALID_COMMA | VALID_PARENS_CLOSE;
             }
                 break;
@@ -263,7 +283,7 @@ class parser_impl : public parser
                 // the current container:
                 expression_container::sptr c = P.expr_stack.top();
                 P.expr_stack.pop();
-                P.expr_stack.top()->add(c);
+                P.expr_stack.top()->add(fold(c));
                 // It also means another expression is following, so create another
                 // empty container for that:
                 P.expr_stack.push(expression_container::make());
@@ -21,6 +21,19 @@
 
 using namespace uhd::rfnoc;
 
+//! Changes whenever a connection or streamer activity of any node changes
+static uhd::atomic_uint32_t topology_version;
+
+void node_ctrl_base::_topology_changed()
+{
+    topology_version.inc();
+}
+
+uint32_t node_ctrl_base::_get_topology_version()
+{
+    return topology_version.read();
+}
+
 std::string node_ctrl_base::unique_id() const
 {
     // Most instantiations will override this, so we don't need anything
@@ -34,6 +47,7 @@ void node_ctrl_base::clear()
     // Reset connections:
     _upstream_nodes.clear();
     _downstream_nodes.clear();
+    _topology_changed();
 }
 
 void node_ctrl_base::_register_downstream_node(
@@ -126,6 +140,7 @@ void node_ctrl_base::disconnect()
     _downstream_ports.clear();
     _upstream_nodes.clear();
     _upstream_ports.clear();
+    _topology_changed();
 }
 
 void node_ctrl_base::disconnect_output_port(const size_t output_port)
@@ -136,6 +151,7 @@ void node_ctrl_base::disconnect_output_port(const size_t output_port)
     }
     _downstream_nodes.erase(output_port);
     _downstream_ports.erase(output_port);
+    _topology_changed();
 }
 
 void node_ctrl_base::disconnect_input_port(const size_t input_port)
@@ -146,5 +162,6 @@ void node_ctrl_base::disconnect_input_port(const size_t input_port)
     }
     _upstream_nodes.erase(input_port);
     _upstream_ports.erase(input_port);
+    _topology_changed();
 }
 
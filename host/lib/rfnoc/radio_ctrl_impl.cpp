@@ -305,6 +305,7 @@ void radio_ctrl_impl::set_rx_streamer(bool active, const size_t port)
         ));
     }
     _rx_streamer_active[port] = active;
+    _topology_changed();
     if (not check_radio_config()) {
         throw std::runtime_error(str(
             boost::format("[%s]: Invalid radio configuration.")
@@ -323,6 +324,7 @@ void radio_ctrl_impl::set_tx_streamer(bool active, const size_t port)
         ));
     }
     _tx_streamer_active[port] = active;
+    _topology_changed();
     if (not check_radio_config()) {
         throw std::runtime_error(str(
             boost::format("[%s]: Invalid radio configuration.")
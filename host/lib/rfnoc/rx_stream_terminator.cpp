@@ -27,10 +27,14 @@ using namespace uhd::rfnoc;
 
 size_t rx_stream_terminator::_count = 0;
 
+//! Time in seconds for the stop and restart commands to reach the radios
+static const double OVERFLOW_RESUME_DELAY = 0.01;
+
 rx_stream_terminator::rx_stream_terminator() :
     _term_index(_count),
     _samp_rate(rate_node_ctrl::RATE_UNDEFINED),
-    _tick_rate(tick_node_ctrl::RATE_UNDEFINED)
+    _tick_rate(tick_node_ctrl::RATE_UNDEFINED),
+    _overflow_recovery(OVERFLOW_RECOVERY_RESTART)
 {
     _count++;
 }
@@ -60,6 +64,7 @@ void rx_stream_terminator::set_rx_streamer(bool active, const size_t)
         }
         _rx_streamer_active[upstream_node.first] = active;
     }
+    _topology_changed();
 }
 
 void rx_stream_terminator::handle_overrun(boost::weak_ptr<uhd::rx_streamer> streamer, const size_t)
@@ -109,12 +114,30 @@ void rx_stream_terminator::handle_overrun(boost::weak_ptr<uhd::rx_streamer> stre
         }
     }
     //flush transports
-    my_streamer->flush_all(0.001); // TODO flushing will probably have to go away.
+    if (_overflow_recovery == OVERFLOW_RECOVERY_RESUME) {
+        my_streamer->flush_all(0.0);
+    } else {
+        my_streamer->flush_all(0.001); // TODO flushing will probably have to go away.
+    }
     //restart streaming on all channels
     if (in_continuous_streaming_mode) {
         stream_cmd_t stream_cmd(stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
         stream_cmd.stream_now = false;
-        stream_cmd.time_spec = upstream_radio_nodes[0]->get_time_now() + time_spec_t(0.05);
+        const time_spec_t now = upstream_radio_nodes[0]->get_time_now();
+        const double samp_rate = get_output_samp_rate();
+        time_spec_t next_time;
+        if (_overflow_recovery == OVERFLOW_RECOVERY_RESUME and samp_rate > 0
+                and my_streamer->get_next_time_spec(next_time)) {
+            // Restart on a whole number of packets after the last
+            // received sample, so the gap is num_dropped_samps
+            // and the packet boundaries stay where they were.
+            const long long spp = my_streamer->get_max_num_samps();
+            const long long delay = (now + time_spec_t(OVERFLOW_RESUME_DELAY) - next_time).to_ticks(samp_rate);
+            const long long num_pkts = (delay <= 0) ? 1 : (delay + spp - 1) / spp;
+            stream_cmd.time_spec = next_time + time_spec_t::from_ticks(num_pkts*spp, samp_rate);
+        } else {
+            stream_cmd.time_spec = now + time_spec_t(0.05);
+        }
 
         BOOST_FOREACH(const boost::shared_ptr<uhd::rfnoc::radio_ctrl_impl> &node, upstream_radio_nodes) {
             BOOST_FOREACH(const size_t port, node->get_active_rx_ports()) {
@@ -124,6 +147,61 @@ void rx_stream_terminator::handle_overrun(boost::weak_ptr<uhd::rx_streamer> stre
     }
 }
 
+bool rx_stream_terminator::stop_streaming()
+{
+    std::vector<boost::shared_ptr<uhd::rfnoc::radio_ctrl_impl> > upstream_radio_nodes =
+        find_upstream_node<uhd::rfnoc::radio_ctrl_impl>();
+
+    size_t num_channels = 0;
+    BOOST_FOREACH(const boost::shared_ptr<uhd::rfnoc::radio_ctrl_impl> &node, upstream_radio_nodes) {
+        BOOST_FOREACH(const size_t port, node->get_active_rx_ports()) {
+            // Finite bursts end on their own, those are left alone
+            if (not node->in_continuous_streaming_mode(port)) {
+                return false;
+            }
+            num_channels++;
+        }
+    }
+    if (num_channels == 0) {
+        return false;
+    }
+
+    UHD_RFNOC_BLOCK_TRACE() << "rx_stream_terminator::stop_streaming()" << std::endl;
+    BOOST_FOREACH(const boost::shared_ptr<uhd::rfnoc::radio_ctrl_impl> &node, upstream_radio_nodes) {
+        BOOST_FOREACH(const size_t port, node->get_active_rx_ports()) {
+            node->rx_ctrl_clear_cmds(port);
+            node->issue_stream_cmd(stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS, port);
+        }
+    }
+    return true;
+}
+
+void rx_stream_terminator::restart_streaming()
+{
+    std::vector<boost::shared_ptr<uhd::rfnoc::radio_ctrl_impl> > upstream_radio_nodes =
+        find_upstream_node<uhd::rfnoc::radio_ctrl_impl>();
+    if (upstream_radio_nodes.empty()) {
+        return;
+    }
+
+    UHD_RFNOC_BLOCK_TRACE() << "rx_stream_terminator::restart_streaming()" << std::endl;
+    size_t num_channels = 0;
+    BOOST_FOREACH(const boost::shared_ptr<uhd::rfnoc::radio_ctrl_impl> &node, upstream_radio_nodes) {
+        num_channels += node->get_active_rx_ports().size();
+    }
+    // Several channels restart on the same time, like after an overrun
+    stream_cmd_t stream_cmd(stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+    stream_cmd.stream_now = (num_channels == 1);
+    if (not stream_cmd.stream_now) {
+        stream_cmd.time_spec = upstream_radio_nodes[0]->get_time_now() + time_spec_t(0.05);
+    }
+    BOOST_FOREACH(const boost::shared_ptr<uhd::rfnoc::radio_ctrl_impl> &node, upstream_radio_nodes) {
+        BOOST_FOREACH(const size_t port, node->get_active_rx_ports()) {
+            node->issue_stream_cmd(stream_cmd, port);
+        }
+    }
+}
+
 rx_stream_terminator::~rx_stream_terminator()
 {
     UHD_RFNOC_BLOCK_TRACE() << "rx_stream_terminator::~rx_stream_terminator() " << std::endl;
@@ -43,6 +43,14 @@ class rx_stream_terminator :
 public:
     UHD_RFNOC_BLOCK_OBJECT(rx_stream_terminator)
 
+    //! How a MIMO streamer restarts the radios after an overrun
+    enum overflow_recovery_t {
+        //! Stop, flush with a timeout and restart after a safe delay
+        OVERFLOW_RECOVERY_RESTART,
+        //! Stop, drop what is queued and restart on the packet grid as soon as possible
+        OVERFLOW_RECOVERY_RESUME
+    };
+
     static sptr make()
     {
         return sptr(new rx_stream_terminator);
@@ -65,6 +73,17 @@ public:
 
     void handle_overrun(boost::weak_ptr<uhd::rx_streamer>, const size_t);
 
+    void set_overflow_recovery(const overflow_recovery_t recovery) { _overflow_recovery = recovery; };
+
+    /*! Stop the continuous streams of the upstream radios, so the blocks
+     * between them and this terminator can be reprogrammed.
+     * \return true when all radios were streaming continuously and were stopped
+     */
+    bool stop_streaming();
+
+    //! Restart the streams stopped by stop_streaming(), aligned when there are several
+    void restart_streaming();
+
 protected:
     rx_stream_terminator();
 
@@ -78,6 +97,8 @@ private:
     double _samp_rate;
     double _tick_rate;
 
+    overflow_recovery_t _overflow_recovery;
+
 }; /* class rx_stream_terminator */
 
 }} /* namespace uhd::rfnoc */
@@ -0,0 +1,157 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/rfnoc/siggen_block_ctrl.hpp>
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cmath>
+
+using namespace uhd;
+using namespace uhd::rfnoc;
+
+class siggen_block_ctrl_impl : public siggen_block_ctrl
+{
+public:
+    UHD_RFNOC_BLOCK_CONSTRUCTOR(siggen_block_ctrl)
+    {
+        /* NOP */
+    }
+
+    void set_constant(const std::complex<double> &value, const size_t chan)
+    {
+        if (std::abs(value.real()) > 1.0 or std::abs(value.imag()) > 1.0) {
+            throw uhd::value_error("[SigGen] The constant must be from -1.0 to 1.0");
+        }
+        boost::lock_guard<boost::mutex> lock(_config_mutex);
+        set_arg<double>("gain", 1.0, chan);
+        set_arg<double>("amplitude_i", value.real(), chan);
+        set_arg<double>("amplitude_q", value.imag(), chan);
+        set_arg<std::string>("waveform", "CONSTANT", chan);
+    }
+
+    void set_tone(
+        const double freq,
+        const double samp_rate,
+        const double amplitude,
+        const size_t chan
+    ) {
+        boost::lock_guard<boost::mutex> lock(_config_mutex);
+        _set_tone(freq, samp_rate, amplitude, chan);
+    }
+
+    void set_noise(const double amplitude, const size_t chan)
+    {
+        check_amplitude(amplitude);
+        boost::lock_guard<boost::mutex> lock(_config_mutex);
+        set_arg<double>("gain", amplitude, chan);
+        set_arg<std::string>("waveform", "NOISE", chan);
+    }
+
+    void set_chirp(
+        const double start_freq,
+        const double stop_freq,
+        const double samp_rate,
+        const double duration,
+        const double amplitude,
+        const time_spec_t &time_spec,
+        const size_t num_steps,
+        const size_t chan
+    ) {
+        if (num_steps == 0 or num_steps > MAX_CHIRP_STEPS) {
+            throw uhd::value_error(str(boost::format(
+                "[SigGen] A chirp takes 1 to %d steps") % size_t(MAX_CHIRP_STEPS)));
+        }
+        if (time_spec == time_spec_t(0.0) or duration <= 0.0) {
+            throw uhd::value_error("[SigGen] A chirp needs a start time and a duration");
+        }
+        //check the last step before anything is written
+        get_freq_word(stop_freq, samp_rate);
+
+        boost::lock_guard<boost::mutex> lock(_config_mutex);
+        _set_tone(start_freq, samp_rate, amplitude, chan);
+        for (size_t i = 1; i <= num_steps; i++) {
+            const double freq = start_freq + (stop_freq - start_freq)*i/num_steps;
+            set_command_time(time_spec + time_spec_t(duration*i/num_steps), chan);
+            sr_write("FREQ", get_freq_word(freq, samp_rate), chan);
+        }
+        clear_command_time(chan);
+    }
+
+    void set_enable(
+        const bool enable,
+        const time_spec_t &time_spec,
+        const size_t chan
+    ) {
+        boost::lock_guard<boost::mutex> lock(_config_mutex);
+        if (time_spec != time_spec_t(0.0)) {
+            set_command_time(time_spec, chan);
+        }
+        set_arg<int>("enable", enable ? 1 : 0, chan);
+        if (time_spec != time_spec_t(0.0)) {
+            clear_command_time(chan);
+        }
+    }
+
+    bool get_enable(const size_t chan)
+    {
+        return get_arg<int>("enable", chan) != 0;
+    }
+
+private:
+    static void check_amplitude(const double amplitude)
+    {
+        if (amplitude < 0.0 or amplitude > 1.0) {
+            throw uhd::value_error("[SigGen] The amplitude must be from 0.0 to 1.0");
+        }
+    }
+
+    //! The frequency of the block is the phase step per sample, in units of pi
+    static double get_norm_freq(const double freq, const double samp_rate)
+    {
+        const double norm_freq = (samp_rate > 0.0) ? 2*freq/samp_rate : 2.0;
+        if (std::abs(norm_freq) > 1.0) {
+            throw uhd::value_error(str(boost::format(
+                "[SigGen] The frequency %f MHz is outside of +-%f MHz") % (freq/1e6) % (samp_rate/2e6)));
+        }
+        return norm_freq;
+    }
+
+    //! The FREQ register value, as the frequency arg of the block writes it
+    static uint32_t get_freq_word(const double freq, const double samp_rate)
+    {
+        return uint32_t(int32_t(boost::math::iround(-8192.0*get_norm_freq(freq, samp_rate))));
+    }
+
+    void _set_tone(
+        const double freq,
+        const double samp_rate,
+        const double amplitude,
+        const size_t chan
+    ) {
+        check_amplitude(amplitude);
+        const double norm_freq = get_norm_freq(freq, samp_rate);
+        set_arg<double>("gain", amplitude, chan);
+        set_arg<double>("frequency", norm_freq, chan);
+        set_arg<std::string>("waveform", "SINE_WAVE", chan);
+    }
+
+    boost::mutex _config_mutex;
+};
+
+UHD_RFNOC_BLOCK_REGISTER(siggen_block_ctrl, "SigGen");
@@ -63,6 +63,7 @@ void source_node_ctrl::set_rx_streamer(bool active, const size_t port)
     }
 
     _rx_streamer_active[port] = active;
+    _topology_changed();
 }
 
 size_t source_node_ctrl::_request_output_port(
@@ -92,5 +93,6 @@ void source_node_ctrl::_register_downstream_node(
     // Alles klar, Herr Kommissar :)
 
     _downstream_nodes[port] = boost::weak_ptr<node_ctrl_base>(downstream_node);
+    _topology_changed();
 }
 
@@ -56,6 +56,7 @@ void tx_stream_terminator::set_tx_streamer(bool active, const size_t /* port */)
         }
         _tx_streamer_active[downstream_node.first] = active;
     }
+    _topology_changed();
 
 }
 
@@ -0,0 +1,183 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/rx_push_streamer.hpp>
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/transport/bounded_buffer.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+using namespace uhd;
+
+//! The timeout in seconds of one round of the thread, bounds the shutdown time
+static const double PUSH_TIMEOUT = 0.1;
+
+static const size_t DEFAULT_QUEUE_DEPTH = 8;
+
+rx_push_streamer::~rx_push_streamer(void){
+    /* NOP */
+}
+
+/***********************************************************************
+ * The pool of blocks, outlives the push streamer while blocks are held
+ **********************************************************************/
+class rx_push_block_pool : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<rx_push_block_pool> sptr;
+    typedef rx_push_streamer::block_t block_t;
+
+    rx_push_block_pool(const size_t num_blocks, const size_t num_chans, const size_t block_bytes):
+        _blocks(num_blocks),
+        _mems(num_blocks*num_chans, std::vector<char>(block_bytes)),
+        free_blocks(num_blocks)
+    {
+        for (size_t i = 0; i < num_blocks; i++){
+            for (size_t ch = 0; ch < num_chans; ch++){
+                _blocks[i].buffs.push_back(&_mems[i*num_chans + ch].front());
+            }
+            _blocks[i].nsamps = 0;
+            free_blocks.push_with_haste(&_blocks[i]);
+        }
+    }
+
+    //! The deleter of a block_sptr
+    static void release(sptr pool, const block_t *block){
+        pool->free_blocks.push_with_haste(const_cast<block_t *>(block));
+    }
+
+private:
+    std::vector<block_t> _blocks;
+    std::vector<std::vector<char> > _mems;
+
+public:
+    transport::bounded_buffer<block_t *> free_blocks;
+};
+
+/***********************************************************************
+ * The push streamer implementation
+ **********************************************************************/
+class rx_push_streamer_impl : public rx_push_streamer{
+public:
+    rx_push_streamer_impl(
+        rx_streamer::sptr rx_stream,
+        const stream_args_t &stream_args,
+        const handler_type &handler,
+        const device_addr_t &push_args
+    ):
+        _rx_stream(rx_stream),
+        _handler(handler),
+        _block_size(push_args.cast<size_t>("block_size", rx_stream->get_max_num_samps())),
+        _queue_depth(push_args.cast<size_t>("queue_depth", DEFAULT_QUEUE_DEPTH)),
+        _has_priority(push_args.has_key("priority")),
+        _priority(push_args.cast<float>("priority", default_thread_priority)),
+        _block(NULL),
+        _thread_setup_done(false),
+        _num_stalls(0)
+    {
+        if (_block_size == 0) throw uhd::value_error("rx_push_streamer: block_size must be positive");
+        if (_queue_depth == 0) throw uhd::value_error("rx_push_streamer: queue_depth must be positive");
+        if (push_args.has_key("cpus")){
+            std::vector<std::string> toks;
+            const std::string cpu_list = boost::algorithm::trim_copy(push_args["cpus"]);
+            boost::split(toks, cpu_list, boost::is_any_of(" "), boost::token_compress_on);
+            BOOST_FOREACH(const std::string &tok, toks){
+                if (not tok.empty()) _cpus.push_back(boost::lexical_cast<size_t>(tok));
+            }
+        }
+
+        _pool = rx_push_block_pool::sptr(new rx_push_block_pool(
+            _queue_depth, _rx_stream->get_num_channels(),
+            _block_size*convert::get_bytes_per_item(stream_args.cpu_format)
+        ));
+        _task = task::make(boost::bind(&rx_push_streamer_impl::push_one_block, this), "rx_push");
+    }
+
+    ~rx_push_streamer_impl(void){
+        _task.reset();
+        if (_block != NULL) rx_push_block_pool::release(_pool, _block);
+    }
+
+    size_t get_block_size(void) const{
+        return _block_size;
+    }
+
+    size_t get_queue_depth(void) const{
+        return _queue_depth;
+    }
+
+    size_t get_num_stalls(void) const{
+        return _num_stalls.load(boost::memory_order_relaxed);
+    }
+
+private:
+    /*!
+     * One round of the task:
+     * Take a free block, fill it from the streamer and hand it to the
+     * handler. A timeout without samples keeps the block for the next round.
+     */
+    void push_one_block(void){
+        if (not _thread_setup_done){
+            if (_has_priority) set_thread_priority_safe(_priority);
+            set_thread_affinity(_cpus);
+            _thread_setup_done = true;
+        }
+
+        if (_block == NULL and not _pool->free_blocks.pop_with_haste(_block)){
+            _num_stalls++;
+            if (not _pool->free_blocks.pop_with_timed_wait(_block, PUSH_TIMEOUT)) return;
+        }
+
+        rx_metadata_t &metadata = _block->metadata;
+        _block->nsamps = _rx_stream->recv(_block->buffs, _block_size, metadata, PUSH_TIMEOUT);
+        if (_block->nsamps == 0 and metadata.error_code == rx_metadata_t::ERROR_CODE_TIMEOUT) return;
+
+        const block_sptr block(_block, boost::bind(&rx_push_block_pool::release, _pool, _1));
+        _block = NULL;
+        _handler(block);
+    }
+
+    rx_streamer::sptr _rx_stream;
+    const handler_type _handler;
+    const size_t _block_size;
+    const size_t _queue_depth;
+    const bool _has_priority;
+    const float _priority;
+    std::vector<size_t> _cpus;
+    rx_push_block_pool::sptr _pool;
+
+    //only used by the task
+    block_t *_block;
+    bool _thread_setup_done;
+
+    boost::atomic<size_t> _num_stalls;
+    task::sptr _task;
+};
+
+rx_push_streamer::sptr rx_push_streamer::make(
+    rx_streamer::sptr rx_stream,
+    const stream_args_t &stream_args,
+    const handler_type &handler,
+    const device_addr_t &push_args
+){
+    return sptr(new rx_push_streamer_impl(rx_stream, stream_args, handler, push_args));
+}
@@ -16,6 +16,8 @@
 //
 
 #include <uhd/stream.hpp>
+#include <uhd/exception.hpp>
+#include <algorithm>
 
 using namespace uhd;
 
@@ -24,7 +26,93 @@ rx_streamer::~rx_streamer(void)
     //empty
 }
 
+size_t rx_streamer::recv_borrowed(
+    borrowed_packet_t &, rx_metadata_t &, const double
+){
+    throw uhd::not_implemented_error("This streamer does not support recv_borrowed()");
+}
+
+size_t rx_streamer::recv_packets(
+    const buffs_type &, const size_t, std::vector<packet_metadata_t> &, const double
+){
+    throw uhd::not_implemented_error("This streamer does not support recv_packets()");
+}
+
+void rx_streamer::set_histograms_enabled(const bool)
+{
+    throw uhd::not_implemented_error("This streamer does not support histograms");
+}
+
+histograms_t rx_streamer::get_histograms(void) const
+{
+    throw uhd::not_implemented_error("This streamer does not support histograms");
+}
+
+bool rx_streamer::get_psd(psd_t &, const size_t, const double)
+{
+    throw uhd::not_implemented_error("This streamer does not support get_psd()");
+}
+
 tx_streamer::~tx_streamer(void)
 {
     //empty
 }
+
+size_t tx_streamer::get_borrowed_buffs(
+    std::vector<void *> &, const tx_metadata_t &, const double
+){
+    throw uhd::not_implemented_error("This streamer does not support get_borrowed_buffs()");
+}
+
+size_t tx_streamer::send_borrowed(const size_t)
+{
+    throw uhd::not_implemented_error("This streamer does not support send_borrowed()");
+}
+
+void tx_streamer::set_async_msg_callback(const async_msg_callback_t &)
+{
+    throw uhd::not_implemented_error("This streamer does not support set_async_msg_callback()");
+}
+
+size_t tx_streamer::get_num_bursts_sent(void) const
+{
+    throw uhd::not_implemented_error("This streamer does not support get_num_bursts_sent()");
+}
+
+bool tx_streamer::wait_for_burst_ack(const size_t, const double)
+{
+    throw uhd::not_implemented_error("This streamer does not support wait_for_burst_ack()");
+}
+
+void tx_streamer::set_histograms_enabled(const bool)
+{
+    throw uhd::not_implemented_error("This streamer does not support histograms");
+}
+
+histograms_t tx_streamer::get_histograms(void) const
+{
+    throw uhd::not_implemented_error("This streamer does not support histograms");
+}
+
+tx_streamer::buffer_status_t tx_streamer::get_buffer_status(const size_t) const
+{
+    throw uhd::not_implemented_error("This streamer does not support get_buffer_status()");
+}
+
+size_t tx_streamer::prefill(
+    const buffs_type &buffs,
+    const size_t nsamps_per_buff,
+    const time_spec_t &time_spec,
+    const double timeout
+){
+    size_t nsamps = nsamps_per_buff;
+    for (size_t chan = 0; chan < this->get_num_channels(); chan++){
+        nsamps = std::min(nsamps, this->get_buffer_status(chan).free_samps);
+    }
+
+    tx_metadata_t metadata;
+    metadata.start_of_burst = true;
+    metadata.has_time_spec = true;
+    metadata.time_spec = time_spec;
+    return this->send(buffs, nsamps, metadata, timeout);
+}
@@ -0,0 +1,113 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "transport/super_recv_packet_handler.hpp"
+#include "transport/super_send_packet_handler.hpp"
+#include "transport/udp_common.hpp"
+#include <uhd/stream_poller.hpp>
+#include <uhd/exception.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <algorithm>
+#include <utility>
+
+using namespace uhd;
+using namespace uhd::transport;
+
+//! The round in seconds for streamers without a descriptor to wait on
+static const double POLL_ROUND_TIMEOUT = 0.001;
+
+stream_poller::~stream_poller(void){
+    /* NOP */
+}
+
+class stream_poller_impl : public stream_poller{
+public:
+    stream_poller_impl(void):
+        _size(0)
+    {
+        /* NOP */
+    }
+
+    size_t add(rx_streamer::sptr rx_stream){
+        boost::shared_ptr<sph::recv_packet_streamer> streamer =
+            boost::dynamic_pointer_cast<sph::recv_packet_streamer>(rx_stream);
+        if (not streamer){
+            throw uhd::not_implemented_error("This rx streamer cannot be added to a stream_poller");
+        }
+        _rx_streamers.push_back(std::make_pair(_size, streamer));
+        return _size++;
+    }
+
+    size_t add(tx_streamer::sptr tx_stream){
+        boost::shared_ptr<sph::send_packet_streamer> streamer =
+            boost::dynamic_pointer_cast<sph::send_packet_streamer>(tx_stream);
+        if (not streamer){
+            throw uhd::not_implemented_error("This tx streamer cannot be added to a stream_poller");
+        }
+        _tx_streamers.push_back(std::make_pair(_size, streamer));
+        return _size++;
+    }
+
+    size_t wait(std::vector<size_t> &ready, const double timeout){
+        const boost::system_time exit_time = boost::get_system_time() +
+            boost::posix_time::microseconds(long(timeout*1e6));
+        while (true){
+            ready.clear();
+            _fds.clear();
+            //tx streamers have no descriptor to wait on
+            bool all_fds = _tx_streamers.empty();
+            for (size_t i = 0; i < _rx_streamers.size(); i++){
+                if (_rx_streamers[i].second->is_packet_ready()){
+                    ready.push_back(_rx_streamers[i].first);
+                }
+                else if (not _rx_streamers[i].second->get_recv_fds(_fds)){
+                    all_fds = false;
+                }
+            }
+            for (size_t i = 0; i < _tx_streamers.size(); i++){
+                if (_tx_streamers[i].second->is_async_msg_ready()){
+                    ready.push_back(_tx_streamers[i].first);
+                }
+            }
+            if (not ready.empty()){
+                std::sort(ready.begin(), ready.end());
+                return ready.size();
+            }
+
+            const double remaining = double((exit_time - boost::get_system_time()).total_microseconds())/1e6;
+            if (remaining <= 0.0) return 0;
+            const double round_timeout = all_fds? remaining : std::min(remaining, POLL_ROUND_TIMEOUT);
+            if (_fds.empty()){
+                boost::this_thread::sleep(boost::posix_time::microseconds(long(round_timeout*1e6)));
+            }
+            else{
+                wait_for_recv_ready(_fds, round_timeout);
+            }
+        }
+    }
+
+private:
+    size_t _size;
+    std::vector<std::pair<size_t, boost::shared_ptr<sph::recv_packet_streamer> > > _rx_streamers;
+    std::vector<std::pair<size_t, boost::shared_ptr<sph::send_packet_streamer> > > _tx_streamers;
+    std::vector<int> _fds;
+};
+
+stream_poller::sptr stream_poller::make(void){
+    return sptr(new stream_poller_impl());
+}
@@ -0,0 +1,415 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "transport/super_recv_packet_handler.hpp"
+#include "transport/super_send_packet_handler.hpp"
+#include "transport/udp_common.hpp"
+#include <uhd/stream_reactor.hpp>
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+using namespace uhd;
+using namespace uhd::transport;
+
+//! The round in seconds for operations without a descriptor to wait on
+static const double REACTOR_ROUND_TIMEOUT = 0.001;
+
+stream_reactor::~stream_reactor(void){
+    /* NOP */
+}
+
+static boost::system_time deadline_from_now(const double timeout){
+    return boost::get_system_time() + boost::posix_time::microseconds(long(timeout*1e6));
+}
+
+/***********************************************************************
+ * The queued operations
+ **********************************************************************/
+struct reactor_recv_op{
+    boost::shared_ptr<boost::promise<stream_reactor::recv_result_t> > promise;
+    std::vector<char *> buffs;
+    size_t nsamps_per_buff;
+    bool one_packet;
+    boost::system_time deadline;
+    stream_reactor::recv_result_t result;
+};
+
+struct reactor_send_op{
+    boost::shared_ptr<boost::promise<size_t> > promise;
+    std::vector<const char *> buffs;
+    size_t nsamps_per_buff;
+    tx_metadata_t metadata; //for the samples not sent yet
+    boost::system_time deadline;
+    size_t nsamps_sent;
+};
+
+struct reactor_msg_op{
+    boost::shared_ptr<boost::promise<stream_reactor::async_msg_result_t> > promise;
+    boost::system_time deadline;
+};
+
+struct reactor_rx_entry{
+    rx_streamer::sptr stream;
+    boost::shared_ptr<sph::recv_packet_streamer> sph; //null for other streamers
+    size_t bytes_per_item;
+    std::deque<reactor_recv_op> ops;
+    bool has_queued_metadata;
+    rx_metadata_t queued_metadata; //an error for the next operation
+};
+
+struct reactor_tx_entry{
+    tx_streamer::sptr stream;
+    size_t bytes_per_item;
+    std::deque<reactor_send_op> sends;
+    std::deque<reactor_msg_op> msgs;
+};
+
+/***********************************************************************
+ * The reactor implementation
+ **********************************************************************/
+class stream_reactor_impl : public stream_reactor{
+public:
+    size_t add(rx_streamer::sptr rx_stream, const stream_args_t &stream_args){
+        boost::mutex::scoped_lock lock(_mutex);
+        reactor_rx_entry entry;
+        entry.stream = rx_stream;
+        entry.sph = boost::dynamic_pointer_cast<sph::recv_packet_streamer>(rx_stream);
+        entry.bytes_per_item = convert::get_bytes_per_item(stream_args.cpu_format);
+        entry.has_queued_metadata = false;
+        _rx_entries.push_back(entry);
+        _indexes.push_back(std::make_pair(true, _rx_entries.size() - 1));
+        return _indexes.size() - 1;
+    }
+
+    size_t add(tx_streamer::sptr tx_stream, const stream_args_t &stream_args){
+        boost::mutex::scoped_lock lock(_mutex);
+        reactor_tx_entry entry;
+        entry.stream = tx_stream;
+        entry.bytes_per_item = convert::get_bytes_per_item(stream_args.cpu_format);
+        _tx_entries.push_back(entry);
+        _indexes.push_back(std::make_pair(false, _tx_entries.size() - 1));
+        return _indexes.size() - 1;
+    }
+
+    boost::shared_future<recv_result_t> async_recv(
+        const size_t index,
+        const rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const double timeout,
+        const bool one_packet
+    ){
+        reactor_recv_op op;
+        op.promise = boost::make_shared<boost::promise<recv_result_t> >();
+        for (size_t i = 0; i < buffs.size(); i++){
+            op.buffs.push_back(reinterpret_cast<char *>(buffs[i]));
+        }
+        op.nsamps_per_buff = nsamps_per_buff;
+        op.one_packet = one_packet;
+        op.deadline = deadline_from_now(timeout);
+        op.result.nsamps = 0;
+        boost::shared_future<recv_result_t> future(op.promise->get_future());
+
+        boost::mutex::scoped_lock lock(_mutex);
+        get_rx_entry(index).ops.push_back(op);
+        return future;
+    }
+
+    boost::shared_future<size_t> async_send(
+        const size_t index,
+        const tx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const tx_metadata_t &metadata,
+        const double timeout
+    ){
+        reactor_send_op op;
+        op.promise = boost::make_shared<boost::promise<size_t> >();
+        for (size_t i = 0; i < buffs.size(); i++){
+            op.buffs.push_back(reinterpret_cast<const char *>(buffs[i]));
+        }
+        op.nsamps_per_buff = nsamps_per_buff;
+        op.metadata = metadata;
+        op.deadline = deadline_from_now(timeout);
+        op.nsamps_sent = 0;
+        boost::shared_future<size_t> future(op.promise->get_future());
+
+        boost::mutex::scoped_lock lock(_mutex);
+        get_tx_entry(index).sends.push_back(op);
+        return future;
+    }
+
+    boost::shared_future<async_msg_result_t> async_recv_async_msg(
+        const size_t index,
+        const double timeout
+    ){
+        reactor_msg_op op;
+        op.promise = boost::make_shared<boost::promise<async_msg_result_t> >();
+        op.deadline = deadline_from_now(timeout);
+        boost::shared_future<async_msg_result_t> future(op.promise->get_future());
+
+        boost::mutex::scoped_lock lock(_mutex);
+        get_tx_entry(index).msgs.push_back(op);
+        return future;
+    }
+
+    size_t run(const double timeout){
+        const boost::system_time exit_time = deadline_from_now(timeout);
+        while (true){
+            boost::system_time next_deadline = exit_time;
+            bool all_fds = true;
+            {
+                boost::mutex::scoped_lock lock(_mutex);
+                const size_t num_done = progress_all();
+                if (num_done != 0) return num_done;
+
+                _fds.clear();
+                bool pending = false;
+                for (size_t i = 0; i < _rx_entries.size(); i++){
+                    const reactor_rx_entry &entry = _rx_entries[i];
+                    if (entry.ops.empty()) continue;
+                    pending = true;
+                    next_deadline = std::min(next_deadline, entry.ops.front().deadline);
+                    if (not entry.sph or not entry.sph->get_recv_fds(_fds)) all_fds = false;
+                }
+                for (size_t i = 0; i < _tx_entries.size(); i++){
+                    const reactor_tx_entry &entry = _tx_entries[i];
+                    if (not entry.sends.empty()){
+                        next_deadline = std::min(next_deadline, entry.sends.front().deadline);
+                    }
+                    if (not entry.msgs.empty()){
+                        next_deadline = std::min(next_deadline, entry.msgs.front().deadline);
+                    }
+                    //tx streamers have no descriptor to wait on
+                    if (not entry.sends.empty() or not entry.msgs.empty()){
+                        pending = true;
+                        all_fds = false;
+                    }
+                }
+                if (not pending) return 0;
+            }
+
+            const boost::system_time now = boost::get_system_time();
+            if (now >= exit_time) return 0;
+            //an expired operation completes in the next round
+            const double remaining = std::max(0.0, double((next_deadline - now).total_microseconds())/1e6);
+            const double round_timeout = all_fds? remaining : std::min(remaining, REACTOR_ROUND_TIMEOUT);
+            if (_fds.empty()){
+                boost::this_thread::sleep(boost::posix_time::microseconds(long(round_timeout*1e6)));
+            }
+            else{
+                wait_for_recv_ready(_fds, round_timeout);
+            }
+        }
+    }
+
+    size_t poll(void){
+        boost::mutex::scoped_lock lock(_mutex);
+        return progress_all();
+    }
+
+    bool get_fds(std::vector<int> &fds){
+        boost::mutex::scoped_lock lock(_mutex);
+        bool all_fds = true;
+        for (size_t i = 0; i < _rx_entries.size(); i++){
+            const reactor_rx_entry &entry = _rx_entries[i];
+            if (entry.ops.empty()) continue;
+            if (not entry.sph or not entry.sph->get_recv_fds(fds)) all_fds = false;
+        }
+        for (size_t i = 0; i < _tx_entries.size(); i++){
+            const reactor_tx_entry &entry = _tx_entries[i];
+            if (not entry.sends.empty() or not entry.msgs.empty()) all_fds = false;
+        }
+        return all_fds;
+    }
+
+private:
+    reactor_rx_entry &get_rx_entry(const size_t index){
+        if (index >= _indexes.size() or not _indexes[index].first){
+            throw uhd::index_error("stream_reactor: index is not an rx streamer");
+        }
+        return _rx_entries[_indexes[index].second];
+    }
+
+    reactor_tx_entry &get_tx_entry(const size_t index){
+        if (index >= _indexes.size() or _indexes[index].first){
+            throw uhd::index_error("stream_reactor: index is not a tx streamer");
+        }
+        return _tx_entries[_indexes[index].second];
+    }
+
+    //! Move every streamer along, call with the mutex held
+    size_t progress_all(void){
+        const boost::system_time now = boost::get_system_time();
+        size_t num_done = 0;
+        for (size_t i = 0; i < _rx_entries.size(); i++){
+            num_done += progress_recv(_rx_entries[i], now);
+        }
+        for (size_t i = 0; i < _tx_entries.size(); i++){
+            num_done += progress_send(_tx_entries[i], now);
+            num_done += progress_msgs(_tx_entries[i], now);
+        }
+        return num_done;
+    }
+
+    /*!
+     * Receive the packets which are ready into the receive operations.
+     * Packets are received one at a time, so the end of a burst is seen.
+     */
+    size_t progress_recv(reactor_rx_entry &entry, const boost::system_time &now){
+        size_t num_done = 0;
+        while (not entry.ops.empty()){
+            reactor_recv_op &op = entry.ops.front();
+            recv_result_t &result = op.result;
+            bool done = false;
+
+            if (entry.has_queued_metadata){
+                entry.has_queued_metadata = false;
+                result.metadata = entry.queued_metadata;
+                done = true;
+            }
+
+            while (not done and (not entry.sph or entry.sph->is_packet_ready())){
+                _recv_buffs.clear();
+                for (size_t i = 0; i < op.buffs.size(); i++){
+                    _recv_buffs.push_back(op.buffs[i] + result.nsamps*entry.bytes_per_item);
+                }
+                rx_metadata_t metadata;
+                size_t nsamps = 0;
+                try{
+                    nsamps = entry.stream->recv(
+                        _recv_buffs, op.nsamps_per_buff - result.nsamps, metadata, 0.0, true
+                    );
+                }
+                catch(...){
+                    op.promise->set_exception(boost::current_exception());
+                    entry.ops.pop_front();
+                    return num_done + 1;
+                }
+                if (nsamps == 0 and metadata.error_code == rx_metadata_t::ERROR_CODE_TIMEOUT) break;
+
+                if (metadata.error_code != rx_metadata_t::ERROR_CODE_NONE and result.nsamps != 0){
+                    entry.has_queued_metadata = true;
+                    entry.queued_metadata = metadata;
+                    done = true;
+                    break;
+                }
+                if (result.nsamps == 0) result.metadata = metadata;
+                result.metadata.end_of_burst = metadata.end_of_burst;
+                result.nsamps += nsamps;
+
+                done = op.one_packet or metadata.end_of_burst or
+                    metadata.error_code != rx_metadata_t::ERROR_CODE_NONE or
+                    result.nsamps == op.nsamps_per_buff;
+            }
+
+            if (not done and now >= op.deadline){
+                if (result.nsamps == 0){
+                    result.metadata.reset();
+                    result.metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+                }
+                done = true;
+            }
+            if (not done) break;
+
+            op.promise->set_value(result);
+            entry.ops.pop_front();
+            num_done++;
+        }
+        return num_done;
+    }
+
+    /*!
+     * Send what the transport takes without waiting.
+     * After the first packets, the remainder continues the burst.
+     */
+    size_t progress_send(reactor_tx_entry &entry, const boost::system_time &now){
+        size_t num_done = 0;
+        while (not entry.sends.empty()){
+            reactor_send_op &op = entry.sends.front();
+            _send_buffs.clear();
+            for (size_t i = 0; i < op.buffs.size(); i++){
+                _send_buffs.push_back(op.buffs[i] + op.nsamps_sent*entry.bytes_per_item);
+            }
+            const size_t nsamps_todo = op.nsamps_per_buff - op.nsamps_sent;
+            size_t nsamps = 0;
+            try{
+                nsamps = entry.stream->send(_send_buffs, nsamps_todo, op.metadata, 0.0);
+            }
+            catch(...){
+                op.promise->set_exception(boost::current_exception());
+                entry.sends.pop_front();
+                return num_done + 1;
+            }
+            if (nsamps != 0){
+                op.metadata.start_of_burst = false;
+                op.metadata.has_time_spec = false;
+                op.nsamps_sent += nsamps;
+            }
+
+            //a send without samples only carries the metadata, it is done after one call
+            const bool done = nsamps == nsamps_todo or now >= op.deadline;
+            if (not done) break;
+
+            op.promise->set_value(op.nsamps_sent);
+            entry.sends.pop_front();
+            num_done++;
+        }
+        return num_done;
+    }
+
+    size_t progress_msgs(reactor_tx_entry &entry, const boost::system_time &now){
+        size_t num_done = 0;
+        while (not entry.msgs.empty()){
+            reactor_msg_op &op = entry.msgs.front();
+            async_msg_result_t result;
+            try{
+                result.valid = entry.stream->recv_async_msg(result.metadata, 0.0);
+            }
+            catch(...){
+                op.promise->set_exception(boost::current_exception());
+                entry.msgs.pop_front();
+                return num_done + 1;
+            }
+            if (not result.valid and now < op.deadline) break;
+
+            op.promise->set_value(result);
+            entry.msgs.pop_front();
+            num_done++;
+        }
+        return num_done;
+    }
+
+    boost::mutex _mutex;
+    std::vector<std::pair<bool, size_t> > _indexes; //rx or tx, and the entry
+    std::deque<reactor_rx_entry> _rx_entries;
+    std::deque<reactor_tx_entry> _tx_entries;
+
+    //only used by the thread calling run() and poll()
+    std::vector<int> _fds;
+    std::vector<void *> _recv_buffs;
+    std::vector<const void *> _send_buffs;
+};
+
+stream_reactor::sptr stream_reactor::make(void){
+    return sptr(new stream_reactor_impl());
+}
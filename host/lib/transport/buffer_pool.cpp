@@ -17,9 +17,38 @@
 
 #include <uhd/transport/buffer_pool.hpp>
 #include <uhd/transport/zero_copy.hpp>
-#include <boost/shared_array.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/static.hpp>
+#include <boost/checked_delete.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cstring>
+#include <cerrno>
+#include <map>
 #include <vector>
 
+#ifdef HAVE_MMAP_HUGETLB
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+#endif /* HAVE_MMAP_HUGETLB */
+
 using namespace uhd::transport;
 
 #ifdef UHD_TXRX_DEBUG_PRINTS
@@ -40,6 +69,148 @@ buffer_pool::~buffer_pool(void){
     /* NOP */
 }
 
+/***********************************************************************
+ * Memory allocation
+ **********************************************************************/
+typedef boost::shared_ptr<char> mem_type;
+
+static size_t get_hugepage_size(const std::string &size){
+    if (size.empty() or size == "0") return 0;
+    if (size == "2M") return size_t(2) << 20;
+    if (size == "1G") return size_t(1) << 30;
+    throw uhd::value_error("buff_hugepages must be 2M or 1G, not " + size);
+}
+
+#ifdef HAVE_MMAP_HUGETLB
+static void unmap_mem(char *mem, const size_t len){
+    munmap(mem, len);
+}
+
+/*!
+ * Map anonymous memory, optionally backed by huge pages, prefer the
+ * given NUMA node for it and fault in all of its pages.
+ */
+static mem_type map_mem(
+    const size_t len, const size_t page_size, const int numa_node, const bool lock
+){
+    size_t map_len = len;
+    void *mem = MAP_FAILED;
+    if (page_size != 0){
+        map_len = pad_to_boundary(len, page_size);
+        const int huge_flags = MAP_HUGETLB | ((page_size == (size_t(1) << 30))? MAP_HUGE_1GB : MAP_HUGE_2MB);
+        mem = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | huge_flags, -1, 0);
+        if (mem == MAP_FAILED){
+            UHD_MSG(warning) << boost::format(
+                "Unable to map %u bytes of %u kB huge pages for a buffer pool: %s\n"
+                "Falling back to normal pages. Reserve huge pages in /proc/sys/vm/nr_hugepages\n"
+                "or /sys/kernel/mm/hugepages to use them.\n"
+            ) % map_len % (page_size/1024) % std::strerror(errno);
+            map_len = len;
+        }
+    }
+    if (mem == MAP_FAILED){
+        mem = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (mem == MAP_FAILED){
+        throw uhd::os_error(str(boost::format(
+            "Unable to map %u bytes for a buffer pool: %s") % map_len % std::strerror(errno)
+        ));
+    }
+    mem_type ret(static_cast<char *>(mem), boost::bind(&unmap_mem, _1, map_len));
+
+    //the policy must be set before the pages are faulted in
+    if (numa_node >= 0){
+        const size_t bits = sizeof(unsigned long)*8;
+        std::vector<unsigned long> node_mask(size_t(numa_node)/bits + 1, 0);
+        node_mask[size_t(numa_node)/bits] |= 1UL << (size_t(numa_node) % bits);
+        if (syscall(SYS_mbind, mem, map_len, MPOL_PREFERRED, &node_mask.front(), node_mask.size()*bits + 1, 0) != 0){
+            UHD_MSG(warning) << boost::format(
+                "Unable to place a buffer pool on NUMA node %d: %s\n"
+            ) % numa_node % std::strerror(errno);
+        }
+    }
+
+    std::memset(mem, 0, map_len); //pre-fault all pages
+
+    if (lock and mlock(mem, map_len) != 0){
+        UHD_MSG(warning) << boost::format(
+            "Unable to lock %u bytes of a buffer pool into RAM: %s\n"
+            "Consider raising the memlock limit (ulimit -l).\n"
+        ) % map_len % std::strerror(errno);
+    }
+    return ret;
+}
+#endif /* HAVE_MMAP_HUGETLB */
+
+static mem_type alloc_default_mem(const size_t len, const uhd::device_addr_t &hints){
+    const size_t page_size = get_hugepage_size(hints.get("buff_hugepages", ""));
+    const int numa_node = hints.cast<int>("buff_numa_node", -1);
+    const bool lock = hints.cast<int>("buff_lock", 0) != 0;
+    if (page_size != 0 or numa_node >= 0 or lock){
+#ifdef HAVE_MMAP_HUGETLB
+        return map_mem(len, page_size, numa_node, lock);
+#else
+        UHD_MSG(warning) << "Buffer pool memory options are not supported on this platform." << std::endl;
+#endif /* HAVE_MMAP_HUGETLB */
+    }
+    return mem_type(new char[len], boost::checked_array_deleter<char>());
+}
+
+/***********************************************************************
+ * Pluggable allocators
+ **********************************************************************/
+typedef std::map<std::string, buffer_pool::allocator_type> allocator_table_type;
+UHD_SINGLETON_FCN(allocator_table_type, get_allocator_table);
+UHD_SINGLETON_FCN(boost::mutex, get_allocator_mutex);
+
+void buffer_pool::register_allocator(const std::string &name, const allocator_type &allocator){
+    if (allocator.alloc and not allocator.free){
+        throw uhd::value_error("The buffer pool allocator " + name + " has alloc but no free");
+    }
+    boost::mutex::scoped_lock lock(get_allocator_mutex());
+    get_allocator_table()[name] = allocator;
+}
+
+static buffer_pool::allocator_type get_allocator(const std::string &name){
+    boost::mutex::scoped_lock lock(get_allocator_mutex());
+    const allocator_table_type::const_iterator it = get_allocator_table().find(name);
+    if (it == get_allocator_table().end()){
+        throw uhd::key_error("No buffer pool allocator registered as " + name);
+    }
+    return it->second;
+}
+
+static void free_allocator_mem(const buffer_pool::allocator_type &allocator, char *mem, const size_t len){
+    allocator.free(mem, len);
+}
+
+//the bound reference keeps the memory until it is unregistered
+static void unregister_allocator_mem(
+    const buffer_pool::allocator_type &allocator, mem_type, char *mem, const size_t len
+){
+    if (allocator.unregister_mem) allocator.unregister_mem(mem, len);
+}
+
+static mem_type alloc_mem(const size_t len, const uhd::device_addr_t &hints){
+    if (not hints.has_key("buff_allocator")) return alloc_default_mem(len, hints);
+    const std::string name = hints["buff_allocator"];
+    const buffer_pool::allocator_type allocator = get_allocator(name);
+
+    mem_type mem;
+    if (allocator.alloc){
+        char *ptr = static_cast<char *>(allocator.alloc(len));
+        if (ptr == NULL) throw uhd::os_error(str(boost::format(
+            "The buffer pool allocator %s failed to allocate %u bytes") % name % len
+        ));
+        mem = mem_type(ptr, boost::bind(&free_allocator_mem, allocator, _1, len));
+    }
+    else mem = alloc_default_mem(len, hints);
+
+    if (not allocator.register_mem) return mem;
+    allocator.register_mem(mem.get(), len);
+    return mem_type(mem.get(), boost::bind(&unregister_allocator_mem, allocator, mem, _1, len));
+}
+
 /***********************************************************************
  * Buffer pool implementation
  **********************************************************************/
@@ -47,7 +218,7 @@ class buffer_pool_impl : public buffer_pool{
 public:
     buffer_pool_impl(
         const std::vector<ptr_type> &ptrs,
-        boost::shared_array<char> mem
+        mem_type mem
     ): _ptrs(ptrs), _mem(mem){
         /* NOP */
     }
@@ -62,7 +233,7 @@ public:
 
 private:
     std::vector<ptr_type> _ptrs;
-    boost::shared_array<char> _mem;
+    mem_type _mem;
 };
 
 /***********************************************************************
@@ -71,13 +242,14 @@ private:
 buffer_pool::sptr buffer_pool::make(
     const size_t num_buffs,
     const size_t buff_size,
-    const size_t alignment
+    const size_t alignment,
+    const device_addr_t &hints
 ){
     //1) pad the buffer size to be a multiple of alignment
     //2) pad the overall memory size for room after alignment
     //3) allocate the memory in one block of sufficient size
     const size_t padded_buff_size = pad_to_boundary(buff_size, alignment);
-    boost::shared_array<char> mem(new char[padded_buff_size*num_buffs + alignment-1]);
+    mem_type mem = alloc_mem(padded_buff_size*num_buffs + alignment-1, hints);
 
     //Fill a vector with boundary-aligned points in the memory
     const size_t mem_start = pad_to_boundary(size_t(mem.get()), alignment);
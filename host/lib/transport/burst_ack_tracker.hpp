@@ -0,0 +1,82 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_BURST_ACK_TRACKER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_BURST_ACK_TRACKER_HPP
+
+#include <uhd/config.hpp>
+#include <boost/utility.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * Counts the burst acks of each channel of a TX streamer.
+ * The thread receiving the async messages notifies every ack,
+ * which wakes the waits of tx_streamer::wait_for_burst_ack().
+ */
+class burst_ack_tracker : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<burst_ack_tracker> sptr;
+
+    burst_ack_tracker(const size_t num_chans): _acks(num_chans, 0){}
+
+    //! Count a burst ack from the device on a channel
+    void notify_ack(const size_t chan){
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            if (chan >= _acks.size()) return;
+            _acks[chan]++;
+        }
+        _cond.notify_all();
+    }
+
+    /*!
+     * Wait until every channel acknowledged a burst.
+     * \param burst the number of the burst, counted from 0
+     * \param timeout the timeout in seconds
+     * \return false for timeout
+     */
+    bool wait(const size_t burst, const double timeout){
+        boost::mutex::scoped_lock lock(_mutex);
+        if (this->num_acked() > burst) return true;
+        const boost::system_time exit_time = boost::get_system_time() +
+            boost::posix_time::microseconds(long(timeout*1e6));
+        while (this->num_acked() <= burst){
+            if (not _cond.timed_wait(lock, exit_time)) return this->num_acked() > burst;
+        }
+        return true;
+    }
+
+private:
+    size_t num_acked(void) const{
+        return _acks.empty()? 0 : *std::min_element(_acks.begin(), _acks.end());
+    }
+
+    std::vector<size_t> _acks;
+    boost::mutex _mutex;
+    boost::condition_variable _cond;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_BURST_ACK_TRACKER_HPP */
@@ -0,0 +1,197 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_CHAN_WORKER_POOL_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_CHAN_WORKER_POOL_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <vector>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * A pinned worker thread per channel, which runs a job for its channel.
+ *
+ * run() hands the next job to all workers at once and returns when all
+ * of them are done, so the caller sees the channels complete together.
+ * The handoff is a generation counter: the workers and the caller spin
+ * on it for spin_timeout before they sleep on a condition, so back to
+ * back packets never go through the scheduler. An exception of a job
+ * is thrown from run() once all workers are done.
+ */
+class chan_worker_pool : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<chan_worker_pool> sptr;
+    typedef boost::function<void(const size_t)> job_type;
+
+    /*!
+     * Start the workers.
+     * \param num_chans the number of channels, one worker each
+     * \param job the job, called with the channel index
+     * \param cpus the CPUs to pin the workers to, round-robin, or empty
+     * \param spin_timeout the time to spin before sleeping in seconds
+     * \param role the name of the threads
+     */
+    chan_worker_pool(
+        const size_t num_chans,
+        const job_type &job,
+        const std::vector<size_t> &cpus,
+        const double spin_timeout,
+        const std::string &role
+    ):
+        _job(job),
+        _spin_time(boost::posix_time::microseconds(long(spin_timeout*1e6))),
+        _states(num_chans),
+        _generation(0), _num_pending(0), _num_sleeping(0), _caller_sleeping(false)
+    {
+        for (size_t i = 0; i < num_chans; i++){
+            _states[i].pinned = cpus.empty();
+            if (not cpus.empty()) _states[i].cpus = std::vector<size_t>(1, cpus[i % cpus.size()]);
+        }
+        for (size_t i = 0; i < num_chans; i++){
+            _workers.push_back(task::make(boost::bind(&chan_worker_pool::worker_task, this, i), role));
+        }
+    }
+
+    ~chan_worker_pool(void){
+        //interrupt and join the workers before their state goes away
+        _workers.clear();
+    }
+
+    //! Get the number of workers
+    size_t size(void) const{
+        return _states.size();
+    }
+
+    //! Run the job on every channel, and wait until all are done
+    void run(void){
+        _num_pending.store(_states.size());
+        _generation.fetch_add(1);
+        if (_num_sleeping.load() != 0){
+            boost::mutex::scoped_lock lock(_mutex);
+            lock.unlock(); //a sleeping worker is in wait() now
+            _wake_cond.notify_all();
+        }
+
+        const boost::system_time spin_end = boost::get_system_time() + _spin_time;
+        while (_num_pending.load() != 0 and boost::get_system_time() < spin_end){
+            boost::this_thread::yield();
+        }
+        if (_num_pending.load() != 0){
+            boost::mutex::scoped_lock lock(_mutex);
+            _caller_sleeping.store(true);
+            while (_num_pending.load() != 0) _done_cond.wait(lock);
+            _caller_sleeping.store(false);
+        }
+
+        if (_error){
+            boost::shared_ptr<uhd::exception> error;
+            error.swap(_error);
+            error->dynamic_throw();
+        }
+    }
+
+private:
+    struct worker_state_type{
+        worker_state_type(void): pinned(true), generation(0){}
+        std::vector<size_t> cpus;
+        bool pinned;
+        size_t generation;
+    };
+
+    //! The loop body of a worker: wait for a generation, run the job
+    void worker_task(const size_t index){
+        worker_state_type &state = _states[index];
+        if (not state.pinned){
+            state.pinned = true;
+            try{
+                uhd::set_thread_affinity(state.cpus);
+            }catch(const std::exception &e){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to pin the worker of channel %u to CPU %u.\n%s\n"
+                ) % index % state.cpus.front() % e.what();
+            }
+        }
+
+        const boost::system_time spin_end = boost::get_system_time() + _spin_time;
+        while (_generation.load() == state.generation and boost::get_system_time() < spin_end){
+            boost::this_thread::interruption_point();
+            boost::this_thread::yield();
+        }
+        if (_generation.load() == state.generation){
+            boost::mutex::scoped_lock lock(_mutex);
+            _num_sleeping.fetch_add(1);
+            while (_generation.load() == state.generation) _wake_cond.wait(lock);
+            _num_sleeping.fetch_sub(1);
+        }
+        state.generation = _generation.load();
+
+        try{
+            _job(index);
+        }catch(const uhd::exception &e){
+            this->set_error(e.dynamic_clone());
+        }catch(const std::exception &e){
+            this->set_error(new uhd::runtime_error(e.what()));
+        }
+
+        if (_num_pending.fetch_sub(1) == 1 and _caller_sleeping.load()){
+            boost::mutex::scoped_lock lock(_mutex);
+            lock.unlock(); //the caller is in wait() now
+            _done_cond.notify_one();
+        }
+    }
+
+    //! Keep the first error of a run for the caller
+    void set_error(uhd::exception *error){
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_error) delete error;
+        else _error.reset(error);
+    }
+
+    const job_type _job;
+    const boost::posix_time::time_duration _spin_time;
+    std::vector<worker_state_type> _states;
+
+    boost::atomic<size_t> _generation;
+    boost::atomic<size_t> _num_pending;
+    boost::atomic<size_t> _num_sleeping;
+    boost::atomic<bool> _caller_sleeping;
+    boost::mutex _mutex;
+    boost::condition_variable _wake_cond, _done_cond;
+    boost::shared_ptr<uhd::exception> _error;
+
+    //last, so the workers are joined first
+    std::vector<task::sptr> _workers;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_CHAN_WORKER_POOL_HPP */
@@ -0,0 +1,197 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_CHDR_CODEC_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_CHDR_CODEC_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/transport/vrt_if_packet.hpp>
+#include <uhd/types/endianness.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <cstring>
+
+namespace uhd{ namespace transport{ namespace vrt{ namespace chdr{
+
+    static const uint32_t HDR_FLAG_TSF = (1 << 29);
+    static const uint32_t HDR_FLAG_EOB = (1 << 28);
+    static const uint32_t HDR_FLAG_ERROR = (1 << 28);
+
+    //! Conversion between host and wire order of the header words
+    template <uhd::endianness_t endianness> struct wire_order;
+
+    template <> struct wire_order<uhd::ENDIANNESS_BIG>{
+        static UHD_INLINE uint32_t to_host(const uint32_t word){ return uhd::ntohx(word); }
+        static UHD_INLINE uint32_t to_wire(const uint32_t word){ return uhd::htonx(word); }
+    };
+
+    template <> struct wire_order<uhd::ENDIANNESS_LITTLE>{
+        static UHD_INLINE uint32_t to_host(const uint32_t word){ return uhd::wtohx(word); }
+        static UHD_INLINE uint32_t to_wire(const uint32_t word){ return uhd::htowx(word); }
+    };
+
+    /*!
+     * The CHDR header packer and unpacker for a transport endianness.
+     *
+     * These are the implementations behind if_hdr_pack_be() and friends,
+     * with the same contract (see chdr.hpp). The packet handlers call them
+     * directly so the compiler can inline them into the per packet code.
+     */
+    template <uhd::endianness_t endianness>
+    struct codec{
+        typedef wire_order<endianness> order;
+
+        static UHD_INLINE void pack(
+            uint32_t *packet_buff,
+            if_packet_info_t &if_packet_info
+        ){
+            // Set fields in if_packet_info
+            if_packet_info.num_header_words32 = 2 + (if_packet_info.has_tsf ? 2 : 0);
+            if_packet_info.num_packet_words32 =
+                    if_packet_info.num_header_words32 +
+                    if_packet_info.num_payload_words32;
+
+            uint16_t pkt_length =
+                if_packet_info.num_payload_bytes + (4 * if_packet_info.num_header_words32);
+            uint32_t chdr = 0
+                // 2 Bits: Packet type
+                | (if_packet_info.packet_type << 30)
+                // 1 Bit: Has time
+                | (if_packet_info.has_tsf ? HDR_FLAG_TSF : 0)
+                // 1 Bit: EOB or Error
+                | ((if_packet_info.eob or if_packet_info.error) ? HDR_FLAG_EOB : 0)
+                // 12 Bits: Sequence number
+                | ((if_packet_info.packet_count & 0xFFF) << 16)
+                // 16 Bits: Total packet length
+                | pkt_length;
+
+            // Write header, SID and time
+            packet_buff[0] = order::to_wire(chdr);
+            packet_buff[1] = order::to_wire(if_packet_info.sid);
+            if (if_packet_info.has_tsf) {
+                packet_buff[2] = order::to_wire(uint32_t(if_packet_info.tsf >> 32));
+                packet_buff[3] = order::to_wire(uint32_t(if_packet_info.tsf >> 0));
+            }
+        }
+
+        static UHD_INLINE void unpack(
+            const uint32_t *packet_buff,
+            if_packet_info_t &if_packet_info
+        ){
+            const uint32_t chdr = order::to_host(packet_buff[0]);
+
+            // Set constant members
+            if_packet_info.link_type = if_packet_info_t::LINK_TYPE_CHDR;
+            if_packet_info.has_cid = false;
+            if_packet_info.has_sid = true;
+            if_packet_info.has_tsi = false;
+            if_packet_info.has_tlr = false;
+            if_packet_info.sob = false;
+
+            // Set configurable members
+            if_packet_info.has_tsf = (chdr & HDR_FLAG_TSF) > 0;
+            if_packet_info.packet_type = if_packet_info_t::packet_type_t((chdr >> 30) & 0x3);
+            if_packet_info.eob = (if_packet_info.packet_type == if_packet_info_t::PACKET_TYPE_DATA)
+                                 && ((chdr & HDR_FLAG_EOB) > 0);
+            if_packet_info.error = (if_packet_info.packet_type == if_packet_info_t::PACKET_TYPE_RESP)
+                                 && ((chdr & HDR_FLAG_ERROR) > 0);
+            if_packet_info.packet_count = (chdr >> 16) & 0xFFF;
+
+            // Set packet length variables
+            if_packet_info.num_header_words32 = if_packet_info.has_tsf ? 4 : 2;
+            const size_t pkt_size_bytes = (chdr & 0xFFFF);
+            const size_t pkt_size_word32 = (pkt_size_bytes + 3) / 4;
+            // Check lengths match:
+            if (pkt_size_word32 < if_packet_info.num_header_words32) {
+                throw uhd::value_error("Bad CHDR or invalid packet length");
+            }
+            if (if_packet_info.num_packet_words32 < pkt_size_word32) {
+                throw uhd::value_error("Bad CHDR or packet fragment");
+            }
+            if_packet_info.num_payload_bytes = pkt_size_bytes - (4 * if_packet_info.num_header_words32);
+            if_packet_info.num_payload_words32 = pkt_size_word32 - if_packet_info.num_header_words32;
+
+            // Read SID and time
+            if_packet_info.sid = order::to_host(packet_buff[1]);
+            if (if_packet_info.has_tsf) {
+                if_packet_info.tsf = 0
+                    | uint64_t(order::to_host(packet_buff[2])) << 32
+                    | order::to_host(packet_buff[3]);
+            }
+        }
+    };
+
+    /*!
+     * A prebuilt CHDR header for the packets of one stream channel.
+     *
+     * The packet type and SID of a streamer never change, so they are
+     * put into wire order once. Packing a packet only patches the flags,
+     * sequence number, length and time into the template and writes the
+     * header with one store. The result is the same as codec::pack()
+     * with the packet type and SID of the template.
+     */
+    class header_template{
+    public:
+        header_template(void):
+            _hdr(0), _sid(0)
+        {
+            /* NOP */
+        }
+
+        //! Set the constant fields, the SID is in host order
+        template <uhd::endianness_t endianness>
+        void set(const if_packet_info_t::packet_type_t packet_type, const uint32_t sid){
+            _hdr = uint32_t(packet_type) << 30;
+            _sid = wire_order<endianness>::to_wire(sid);
+        }
+
+        /*!
+         * Pack the header of a packet, only the time, EOB/error, packet
+         * count and payload length fields of the info are used.
+         * Never writes past the header, the payload may already be there.
+         */
+        template <uhd::endianness_t endianness>
+        UHD_INLINE void pack(uint32_t *packet_buff, if_packet_info_t &if_packet_info) const{
+            if_packet_info.num_header_words32 = if_packet_info.has_tsf ? 4 : 2;
+            if_packet_info.num_packet_words32 =
+                    if_packet_info.num_header_words32 +
+                    if_packet_info.num_payload_words32;
+
+            const uint32_t chdr = _hdr
+                | (if_packet_info.has_tsf ? HDR_FLAG_TSF : 0)
+                | ((if_packet_info.eob or if_packet_info.error) ? HDR_FLAG_EOB : 0)
+                | ((if_packet_info.packet_count & 0xFFF) << 16)
+                | uint16_t(if_packet_info.num_payload_bytes + (4 * if_packet_info.num_header_words32));
+
+            const uint32_t words[4] = {
+                wire_order<endianness>::to_wire(chdr), _sid,
+                wire_order<endianness>::to_wire(uint32_t(if_packet_info.tsf >> 32)),
+                wire_order<endianness>::to_wire(uint32_t(if_packet_info.tsf >> 0))
+            };
+            //constant sizes, so each copy is a single (vector) store
+            if (if_packet_info.has_tsf) std::memcpy(packet_buff, words, 4*sizeof(uint32_t));
+            else std::memcpy(packet_buff, words, 2*sizeof(uint32_t));
+        }
+
+    private:
+        uint32_t _hdr; //host order
+        uint32_t _sid; //wire order
+    };
+
+}}}} //namespace uhd::transport::vrt::chdr
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_CHDR_CODEC_HPP */
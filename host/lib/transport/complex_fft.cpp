@@ -0,0 +1,79 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "complex_fft.hpp"
+#include <uhd/exception.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace uhd;
+using namespace uhd::transport;
+
+static const double PI = 3.14159265358979323846;
+
+complex_fft::complex_fft(const size_t size, const bool forward){
+    if (size == 0) throw uhd::value_error("complex_fft: the size must be positive");
+    const double sign = forward? -1.0 : 1.0;
+    _twiddles.resize(size);
+    for (size_t n = 0; n < size; n++){
+        _twiddles[n] = std::complex<float>(
+            float(std::cos(2*PI*n/size)), float(sign*std::sin(2*PI*n/size))
+        );
+    }
+    if ((size & (size - 1)) == 0){
+        size_t num_bits = 0;
+        while ((size_t(1) << num_bits) < size) num_bits++;
+        _bit_reverse.resize(size);
+        for (size_t n = 0; n < size; n++){
+            size_t r = 0;
+            for (size_t b = 0; b < num_bits; b++) r |= ((n >> b) & 1) << (num_bits - 1 - b);
+            _bit_reverse[n] = r;
+        }
+    }
+    else _scratch.resize(size);
+}
+
+void complex_fft::transform(std::complex<float> *x){
+    const size_t m = _twiddles.size();
+
+    //a plain DFT: point k is the sum of input p times the root k*p
+    if (_bit_reverse.empty()){
+        std::copy(x, x + m, _scratch.begin());
+        for (size_t k = 0; k < m; k++){
+            std::complex<float> acc(0.0f, 0.0f);
+            for (size_t p = 0, n = 0; p < m; p++, n = (n + k) % m) acc += _scratch[p]*_twiddles[n];
+            x[k] = acc;
+        }
+        return;
+    }
+
+    //the same with radix 2 butterflies on the bit reversed inputs
+    for (size_t n = 0; n < m; n++){
+        if (n < _bit_reverse[n]) std::swap(x[n], x[_bit_reverse[n]]);
+    }
+    for (size_t len = 2; len <= m; len <<= 1){
+        const size_t half = len/2, step = m/len;
+        for (size_t i = 0; i < m; i += len){
+            for (size_t j = 0; j < half; j++){
+                const std::complex<float> a = x[i + j];
+                const std::complex<float> b = x[i + j + half]*_twiddles[j*step];
+                x[i + j] = a + b;
+                x[i + j + half] = a - b;
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_COMPLEX_FFT_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_COMPLEX_FFT_HPP
+
+#include <uhd/config.hpp>
+#include <complex>
+#include <vector>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * An in place FFT of complex floats, for the host side DSP stages.
+ *
+ * Radix 2 for a power of two size, a plain DFT otherwise. The forward
+ * transform uses e^(-j*2*pi*k*n/N), the reverse one e^(+j*2*pi*k*n/N).
+ * Neither is scaled.
+ */
+class UHD_API complex_fft{
+public:
+    /*!
+     * Make a transform.
+     * \param size the number of points, at least 1
+     * \param forward true for the forward, false for the reverse transform
+     */
+    complex_fft(const size_t size, const bool forward);
+
+    size_t size(void) const{
+        return _twiddles.size();
+    }
+
+    //! Transform size() points in place
+    void transform(std::complex<float> *x);
+
+private:
+    //! the roots of unity e^(-+j*2*pi*n/N)
+    std::vector<std::complex<float> > _twiddles;
+    //! the bit reversed indexes for the radix 2 FFT, empty for the DFT
+    std::vector<size_t> _bit_reverse;
+    //! a copy of the inputs for the DFT
+    std::vector<std::complex<float> > _scratch;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_COMPLEX_FFT_HPP */
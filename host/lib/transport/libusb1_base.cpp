@@ -20,10 +20,12 @@
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/tasks.hpp>
+#include <uhd/utils/thread_priority.hpp>
 #include <uhd/types/dict.hpp>
 #include <uhd/types/serial.hpp>
 #include <boost/weak_ptr.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/atomic.hpp>
 #include <boost/foreach.hpp>
 #include <boost/bind.hpp>
 #include <cstdlib>
@@ -41,10 +43,12 @@ libusb::session::~session(void) {
 
 class libusb_session_impl : public libusb::session{
 public:
-    libusb_session_impl(void){
+    libusb_session_impl(void):
+        _event_priority(0.0), _event_params_changed(false)
+    {
         UHD_ASSERT_THROW(libusb_init(&_context) == 0);
         libusb_set_debug(_context, debug_level);
-        task_handler = task::make(boost::bind(&libusb_session_impl::libusb_event_handler_task, this, _context));
+        task_handler = task::make(boost::bind(&libusb_session_impl::libusb_event_handler_task, this, _context), "libusb_event");
     }
 
     virtual ~libusb_session_impl(void);
@@ -53,10 +57,35 @@ public:
         return _context;
     }
 
+    void set_event_thread_params(const std::vector<size_t> &cpus, const float priority){
+        boost::mutex::scoped_lock lock(_event_params_mutex);
+        if (not cpus.empty()) _event_cpus = cpus;
+        if (priority > 0.0) _event_priority = priority;
+        _event_params_changed = true;
+    }
+
 private:
     libusb_context *_context;
     task::sptr task_handler;
 
+    //event thread settings, applied by the thread itself
+    boost::mutex _event_params_mutex;
+    std::vector<size_t> _event_cpus;
+    float _event_priority;
+    boost::atomic<bool> _event_params_changed;
+
+    void apply_event_thread_params(void)
+    {
+        boost::mutex::scoped_lock lock(_event_params_mutex);
+        _event_params_changed = false;
+        try {
+            uhd::set_thread_affinity(_event_cpus);
+        } catch (const std::exception &e) {
+            UHD_MSG(warning) << "Unable to pin the libusb event thread.\n" << e.what() << std::endl;
+        }
+        if (_event_priority > 0.0) uhd::set_thread_priority_safe(_event_priority, true);
+    }
+
     /*
      * Task to handle libusb events.  There should only be one thread per libusb_context handling events.
      * Using more than one thread can result in excessive CPU usage in kernel space (presumably from locking/waiting).
@@ -65,6 +94,8 @@ private:
      */
     UHD_INLINE void libusb_event_handler_task(libusb_context *context)
     {
+        if (_event_params_changed) apply_event_thread_params();
+
         timeval tv;
         tv.tv_sec = 0;
         tv.tv_usec = 100000;
@@ -88,8 +119,12 @@ libusb_session_impl::~libusb_session_impl(void){
     libusb_exit(_context);
 }
 
+//the finders of several devices may get the session at the same time
+static boost::mutex global_session_mutex;
+
 libusb::session::sptr libusb::session::get_global_session(void){
     static boost::weak_ptr<session> global_session;
+    boost::mutex::scoped_lock lock(global_session_mutex);
 
     //not expired -> get existing session
     if (not global_session.expired()) return global_session.lock();
@@ -23,6 +23,7 @@
 #include <boost/shared_ptr.hpp>
 #include <uhd/transport/usb_device_handle.hpp>
 #include <libusb.h>
+#include <vector>
 
 //! Define LIBUSB_CALL when its missing (non-windows)
 #ifndef LIBUSB_CALL
@@ -83,6 +84,16 @@ namespace libusb {
 
         //! get the underlying libusb context pointer
         virtual libusb_context *get_context(void) const = 0;
+
+        /*!
+         * Pin the event handling thread and raise its priority.
+         * The thread applies the new settings on its next iteration.
+         * \param cpus the CPUs to run on, empty to leave the affinity unchanged
+         * \param priority a realtime priority in (0, 1], 0 to leave it unchanged
+         */
+        virtual void set_event_thread_params(
+            const std::vector<size_t> &cpus, const float priority
+        ) = 0;
     };
 
     /*!
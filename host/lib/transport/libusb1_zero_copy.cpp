@@ -16,6 +16,7 @@
 //
 
 #include "libusb1_base.hpp"
+#include "xport_stats.hpp"
 #include <uhd/transport/usb_zero_copy.hpp>
 #include <uhd/transport/buffer_pool.hpp>
 #include <uhd/transport/bounded_buffer.hpp>
@@ -27,9 +28,12 @@
 #include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/circular_buffer.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition_variable.hpp>
 #include <list>
+#include <cmath>
 
 #ifdef UHD_TXRX_DEBUG_PRINTS
 #include <vector>
@@ -42,6 +46,8 @@ using namespace uhd::transport;
 
 static const size_t DEFAULT_NUM_XFERS = 16;     //num xfers
 static const size_t DEFAULT_XFER_SIZE = 32*512; //bytes
+static const size_t MAX_NUM_XFERS = 128;        //num xfers when sized automatically
+static const double XFER_BUFF_TIME = 5e-3;      //seconds of data in flight when sized automatically
 
 //! type for sharing the release queue with managed buffers
 class libusb_zero_copy_mb;
@@ -56,6 +62,7 @@ struct lut_result_t
     lut_result_t(void)
     {
         completed = 0;
+        waiting = 0;
         status = LIBUSB_TRANSFER_COMPLETED;
         actual_length = 0;
 #ifdef UHD_TXRX_DEBUG_PRINTS
@@ -64,6 +71,7 @@ struct lut_result_t
 #endif
     }
     int completed;
+    int waiting; //a thread blocks in wait_for_completion()
     libusb_transfer_status status;
     int actual_length;
     boost::mutex mut;
@@ -105,7 +113,10 @@ static void LIBUSB_CALL libusb_async_cb(libusb_transfer *lut)
     r->status = lut->status;
     r->actual_length = lut->actual_length;
     r->completed = 1;
-    r->usb_transfer_complete.notify_one();  // wake up thread waiting in wait_for_completion() member function below
+    // Only wake up a thread waiting in wait_for_completion() member function below.
+    // Transfers completing while nobody waits are picked up without a notify,
+    // so a single wakeup covers all transfers that finished in the meantime.
+    if (r->waiting) r->usb_transfer_complete.notify_one();
 #ifdef UHD_TXRX_DEBUG_PRINTS
     long end_time = boost::get_system_time().time_of_day().total_microseconds();
     libusb1_zerocopy_dbg_print_err( (boost::format("libusb_async_cb,%s,%i,%i,%i,%ld,%ld") % (r->is_recv ? "rx":"tx") % r->buff_num % r->actual_length % r->status % end_time % r->start_time).str() );
@@ -171,13 +182,15 @@ public:
     UHD_INLINE bool wait_for_completion(const double timeout)
     {
         boost::unique_lock<boost::mutex> lock(result.mut);
-        if (!result.completed) {
+        if (!result.completed and timeout != 0.0) {
+            result.waiting = 1;
             if (timeout < 0.0) {
                 result.usb_transfer_complete.wait(lock);
             } else {
                 const boost::system_time timeout_time = boost::get_system_time() + boost::posix_time::microseconds(long(timeout*1000000));
                 result.usb_transfer_complete.timed_wait(lock, timeout_time, lut_result_completed(result));
             }
+            result.waiting = 0;
         }
         return (result.completed > 0);
     }
@@ -204,16 +217,19 @@ public:
     libusb_zero_copy_single(
         libusb::device_handle::sptr handle,
         const int interface, const unsigned char endpoint,
-        const size_t num_frames, const size_t frame_size
+        const size_t num_frames, const size_t frame_size,
+        zero_copy_stats_counters &stats
     ):
         _handle(handle),
         _num_frames(num_frames),
         _frame_size(frame_size),
         _buffer_pool(buffer_pool::make(_num_frames, _frame_size)),
         _enqueued(_num_frames), _released(_num_frames),
-        _status(STATUS_RUNNING)
+        _status(STATUS_RUNNING),
+        _is_recv((endpoint & 0x80) != 0),
+        _stats(stats)
     {
-        const bool is_recv = (endpoint & 0x80) != 0;
+        const bool is_recv = _is_recv;
         const std::string name = str(boost::format("%s%d") % ((is_recv)? "rx" : "tx") % int(endpoint & 0x7f));
         _handle->claim_interface(interface);
 
@@ -320,6 +336,39 @@ public:
         return buff;
     }
 
+    template <typename buffer_type>
+    UHD_INLINE size_t get_buffs(typename buffer_type::sptr *buffs, const size_t num_buffs, double timeout)
+    {
+        if (_status == STATUS_ERROR)
+            return 0;
+
+        // Serialize access to buffers
+        boost::mutex::scoped_lock get_buff_lock(_get_buff_mutex);
+
+        // Only the first transfer waits, then take the completed ones in order
+        boost::mutex::scoped_lock queue_lock(_queue_mutex);
+        size_t num_got = 0;
+        while (num_got < num_buffs)
+        {
+            if (_enqueued.empty() and num_got == 0)
+            {
+                _buff_ready_cond.timed_wait(queue_lock, boost::posix_time::microseconds(long(timeout*1e6)));
+            }
+            if (_enqueued.empty()) break;
+            libusb_zero_copy_mb *front = _enqueued.front();
+
+            queue_lock.unlock();
+            buffs[num_got] = front->get_new<buffer_type>((num_got == 0)? timeout : 0.0);
+            queue_lock.lock();
+
+            if (not buffs[num_got]) break;
+            _enqueued.pop_front();
+            num_got++;
+        }
+        this->submit_what_we_can();
+        return num_got;
+    }
+
     UHD_INLINE size_t get_num_frames(void) const { return _num_frames; }
     UHD_INLINE size_t get_frame_size(void) const { return _frame_size; }
 
@@ -340,8 +389,13 @@ private:
 
     enum {STATUS_RUNNING, STATUS_ERROR} _status;
 
+    //! Send buffers are committed when they come back to the queue
+    const bool _is_recv;
+    zero_copy_stats_counters &_stats;
+
     void enqueue_buffer(libusb_zero_copy_mb *mb)
     {
+        if (not _is_recv) _stats.count_send(mb->size());
         boost::mutex::scoped_lock l(_queue_mutex);
         _released.push_back(mb);
         this->submit_what_we_can();
@@ -371,6 +425,23 @@ private:
     std::list<libusb_transfer *> _all_luts;
 };
 
+/***********************************************************************
+ * Transfer count selection:
+ * An explicit num_<dir>_frames wins. Otherwise, when the expected
+ * <dir>_bandwidth (bytes/s) is known, keep XFER_BUFF_TIME worth of
+ * data in flight, so busy hosts can catch up without overflows.
+ **********************************************************************/
+static size_t get_num_xfers(
+    const device_addr_t &hints, const std::string &dir, const size_t frame_size
+){
+    const std::string num_key = "num_" + dir + "_frames";
+    if (hints.has_key(num_key)) return size_t(hints.cast<double>(num_key, DEFAULT_NUM_XFERS));
+    const double bandwidth = hints.cast<double>(dir + "_bandwidth", 0.0);
+    if (bandwidth <= 0.0 or frame_size == 0) return DEFAULT_NUM_XFERS;
+    const size_t num_xfers = size_t(std::ceil(bandwidth*XFER_BUFF_TIME/frame_size));
+    return std::min(std::max(num_xfers, DEFAULT_NUM_XFERS), MAX_NUM_XFERS);
+}
+
 /***********************************************************************
  * USB zero_copy device class
  **********************************************************************/
@@ -384,14 +455,27 @@ struct libusb_zero_copy_impl : usb_zero_copy
         const unsigned char send_endpoint,
         const device_addr_t &hints
     ){
+        //the event thread is shared by all transports of the process
+        if (hints.has_key("usb_event_cpus") or hints.has_key("usb_event_prio")) {
+            std::vector<size_t> cpus;
+            std::vector<std::string> toks;
+            const std::string cpu_list = boost::algorithm::trim_copy(hints.get("usb_event_cpus", ""));
+            boost::split(toks, cpu_list, boost::is_any_of(" "), boost::token_compress_on);
+            BOOST_FOREACH(const std::string &tok, toks) {
+                if (not tok.empty()) cpus.push_back(boost::lexical_cast<size_t>(tok));
+            }
+            libusb::session::get_global_session()->set_event_thread_params(
+                cpus, hints.cast<float>("usb_event_prio", 0.0));
+        }
+
+        const size_t recv_frame_size = size_t(hints.cast<double>("recv_frame_size", DEFAULT_XFER_SIZE));
+        const size_t send_frame_size = size_t(hints.cast<double>("send_frame_size", DEFAULT_XFER_SIZE));
         _recv_impl.reset(new libusb_zero_copy_single(
             handle, recv_interface, (recv_endpoint & 0x7f) | 0x80,
-            size_t(hints.cast<double>("num_recv_frames", DEFAULT_NUM_XFERS)),
-            size_t(hints.cast<double>("recv_frame_size", DEFAULT_XFER_SIZE))));
+            get_num_xfers(hints, "recv", recv_frame_size), recv_frame_size, _stats));
         _send_impl.reset(new libusb_zero_copy_single(
             handle, send_interface, (send_endpoint & 0x7f) | 0x00,
-            size_t(hints.cast<double>("num_send_frames", DEFAULT_NUM_XFERS)),
-            size_t(hints.cast<double>("send_frame_size", DEFAULT_XFER_SIZE))));
+            get_num_xfers(hints, "send", send_frame_size), send_frame_size, _stats));
     }
 
     virtual ~libusb_zero_copy_impl(void);
@@ -399,21 +483,46 @@ struct libusb_zero_copy_impl : usb_zero_copy
     managed_recv_buffer::sptr get_recv_buff(double timeout)
     {
         boost::mutex::scoped_lock l(_recv_mutex);
-        return _recv_impl->get_buff<managed_recv_buffer>(timeout);
+        managed_recv_buffer::sptr buff = _recv_impl->get_buff<managed_recv_buffer>(timeout);
+        _stats.count_recv(buff);
+        return buff;
+    }
+
+    size_t get_recv_buffs(managed_recv_buffer::sptr *buffs, const size_t num_buffs, const double timeout)
+    {
+        boost::mutex::scoped_lock l(_recv_mutex);
+        const size_t num_got = _recv_impl->get_buffs<managed_recv_buffer>(buffs, num_buffs, timeout);
+        for (size_t i = 0; i < num_got; i++) _stats.count_recv(buffs[i]);
+        if (num_got == 0) _stats.recv_timeouts.add();
+        _stats.recv_queue_hwm.update_max(num_got);
+        return num_got;
     }
 
     managed_send_buffer::sptr get_send_buff(double timeout)
     {
         boost::mutex::scoped_lock l(_send_mutex);
-        return _send_impl->get_buff<managed_send_buffer>(timeout);
+        managed_send_buffer::sptr buff = _send_impl->get_buff<managed_send_buffer>(timeout);
+        if (not buff) _stats.send_timeouts.add();
+        return buff;
     }
 
+    size_t get_send_buffs(managed_send_buffer::sptr *buffs, const size_t num_buffs, const double timeout)
+    {
+        boost::mutex::scoped_lock l(_send_mutex);
+        const size_t num_got = _send_impl->get_buffs<managed_send_buffer>(buffs, num_buffs, timeout);
+        if (num_got == 0) _stats.send_timeouts.add();
+        return num_got;
+    }
+
+    zero_copy_stats_t get_stats(void) const { return _stats.get(); }
+
     size_t get_num_recv_frames(void) const { return _recv_impl->get_num_frames(); }
     size_t get_num_send_frames(void) const { return _send_impl->get_num_frames(); }
 
     size_t get_recv_frame_size(void) const { return _recv_impl->get_frame_size(); }
     size_t get_send_frame_size(void) const { return _send_impl->get_frame_size(); }
 
+    zero_copy_stats_counters _stats;
     boost::shared_ptr<libusb_zero_copy_single> _recv_impl, _send_impl;
     boost::mutex _recv_mutex, _send_mutex;
 };
@@ -0,0 +1,177 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_MBOARD_RECV_THREAD_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_MBOARD_RECV_THREAD_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/transport/zero_copy.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <vector>
+
+namespace uhd{ namespace transport{
+
+//! The time to wait on one of several transports when all were empty
+static const double MBOARD_RECV_WAIT_MULTI = 100e-6;
+
+//! The time to wait on a single transport, or for a full ring
+static const double MBOARD_RECV_WAIT_SINGLE = 0.1;
+
+/*!
+ * A receive thread for the transports of one motherboard.
+ *
+ * The thread drains the transport of every channel of the motherboard
+ * into a ring per channel, so the thread calling recv() only pops the
+ * rings. A slow link then only stalls the thread of its own board.
+ *
+ * The thread never drops a buffer: when the ring of a channel is full,
+ * its buffers wait in the thread until the ring has room, and the
+ * transport backs up behind them like it does with no thread.
+ */
+class mboard_recv_thread : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<mboard_recv_thread> sptr;
+    typedef spsc_bounded_buffer<managed_recv_buffer::sptr> ring_type;
+    typedef boost::function<size_t(managed_recv_buffer::sptr *, const size_t, const double)> get_buffs_type;
+
+    /*!
+     * Start the thread.
+     * \param get_buffs the getter of the transport of each channel
+     * \param ring_sizes the number of buffers in the ring of each channel
+     * \param batch_size the number of buffers to take per transport call
+     * \param cpus the CPUs to pin the thread to, or empty
+     * \param mboard the motherboard number, for the messages
+     */
+    mboard_recv_thread(
+        const std::vector<get_buffs_type> &get_buffs,
+        const std::vector<size_t> &ring_sizes,
+        const size_t batch_size,
+        const std::vector<size_t> &cpus,
+        const size_t mboard
+    ):
+        _cpus(cpus), _pinned(cpus.empty()), _mboard(mboard), _next_wait(0)
+    {
+        for (size_t i = 0; i < get_buffs.size(); i++){
+            _chans.push_back(boost::shared_ptr<chan_type>(new chan_type(
+                get_buffs[i], ring_sizes.at(i), std::max<size_t>(1, batch_size)
+            )));
+        }
+        _task = task::make(boost::bind(&mboard_recv_thread::recv_task, this), "rx_mboard");
+    }
+
+    ~mboard_recv_thread(void){
+        //join the thread before the rings go away
+        _task.reset();
+    }
+
+    //! Get the ring of a channel, only one thread may pop it
+    ring_type &get_ring(const size_t index){
+        return _chans.at(index)->ring;
+    }
+
+private:
+    struct chan_type{
+        chan_type(const get_buffs_type &get_buffs_, const size_t ring_size, const size_t batch_size):
+            get_buffs(get_buffs_), ring(ring_size), batch(batch_size), batch_index(0), batch_size(0)
+        {}
+        get_buffs_type get_buffs;
+        ring_type ring;
+        std::vector<managed_recv_buffer::sptr> batch;
+        size_t batch_index, batch_size;
+    };
+
+    //! Move the buffers of a channel's batch into its ring
+    static bool push_batch(chan_type &chan){
+        while (chan.batch_index < chan.batch_size){
+            if (not chan.ring.push_with_haste(chan.batch[chan.batch_index])) return false;
+            chan.batch[chan.batch_index++].reset();
+        }
+        return true;
+    }
+
+    //! Fill the batch of a channel from its transport and push it
+    static size_t fill_batch(chan_type &chan, const double timeout){
+        chan.batch_index = 0;
+        chan.batch_size = chan.get_buffs(&chan.batch.front(), chan.batch.size(), timeout);
+        const size_t num_got = chan.batch_size;
+        push_batch(chan);
+        return num_got;
+    }
+
+    //! One pass over the channels, the task loop body
+    void recv_task(void){
+        if (not _pinned){
+            _pinned = true;
+            try{
+                uhd::set_thread_affinity(_cpus);
+            }catch(const std::exception &e){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to pin the receive thread of motherboard %u to CPU %u.\n%s\n"
+                ) % _mboard % _cpus.front() % e.what();
+            }
+        }
+
+        //take what is ready on every transport without waiting
+        size_t num_got = 0;
+        bool all_full = true;
+        for (size_t i = 0; i < _chans.size(); i++){
+            chan_type &chan = *_chans[i];
+            if (not push_batch(chan)) continue;
+            all_full = false;
+            num_got += fill_batch(chan, 0.0);
+        }
+        if (num_got != 0) return;
+
+        //all rings full: wait for the caller to pop one
+        if (all_full){
+            chan_type &chan = *_chans[_next_wait++ % _chans.size()];
+            if (chan.ring.push_with_timed_wait(chan.batch[chan.batch_index], MBOARD_RECV_WAIT_SINGLE)){
+                chan.batch[chan.batch_index++].reset();
+            }
+            return;
+        }
+
+        //else wait on the transports in turn, briefly with several of them
+        for (size_t n = 0; n < _chans.size(); n++){
+            chan_type &chan = *_chans[_next_wait++ % _chans.size()];
+            if (chan.batch_index < chan.batch_size) continue;
+            fill_batch(chan, (_chans.size() == 1)? MBOARD_RECV_WAIT_SINGLE : MBOARD_RECV_WAIT_MULTI);
+            return;
+        }
+    }
+
+    std::vector<boost::shared_ptr<chan_type> > _chans;
+    const std::vector<size_t> _cpus;
+    bool _pinned;
+    const size_t _mboard;
+    size_t _next_wait;
+
+    //last, so the thread is joined first
+    task::sptr _task;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_MBOARD_RECV_THREAD_HPP */
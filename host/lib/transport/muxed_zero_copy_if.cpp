@@ -16,18 +16,31 @@
 //
 
 #include <uhd/transport/muxed_zero_copy_if.hpp>
-#include <uhd/transport/bounded_buffer.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/utils/safe_call.hpp>
+#include <uhd/utils/atomic.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread.hpp>
 #include <boost/thread/locks.hpp>
+#include <algorithm>
+#include <cstring>
+#include <deque>
 #include <map>
 
 using namespace uhd;
 using namespace uhd::transport;
 
+//! Time the demux thread waits for a stream to make room for a frame (seconds)
+static const double DEFAULT_PUSH_TIMEOUT = 0.1;
+
 class muxed_zero_copy_if_impl : public muxed_zero_copy_if,
                                 public boost::enable_shared_from_this<muxed_zero_copy_if_impl>
 {
@@ -37,11 +50,27 @@ public:
     muxed_zero_copy_if_impl(
         zero_copy_if::sptr base_xport,
         stream_classifier_fn classify_fn,
-        size_t max_streams
+        size_t max_streams,
+        const device_addr_t &hints
     ):
         _base_xport(base_xport), _classify(classify_fn),
-        _max_num_streams(max_streams), _num_dropped_frames(0)
+        _max_num_streams(max_streams), _num_dropped_frames(0),
+        _recv_timeout(hints.cast<double>("mux_recv_timeout", 0.0)),
+        _push_timeout(hints.cast<double>("mux_push_timeout", DEFAULT_PUSH_TIMEOUT)),
+        _role(hints.get("mux_role", "muxed_demux")),
+        _release_in_order(hints.cast<int>("mux_release_in_order", 0) != 0),
+        _max_pinned(hints.cast<size_t>("mux_max_pinned", base_xport->get_num_recv_frames()/2)),
+        _pending_head_seq(0)
     {
+        if (hints.has_key("mux_cpus")) {
+            std::vector<std::string> toks;
+            const std::string cpu_list = boost::algorithm::trim_copy(hints["mux_cpus"]);
+            boost::split(toks, cpu_list, boost::is_any_of(" "), boost::token_compress_on);
+            BOOST_FOREACH(const std::string &tok, toks) {
+                if (not tok.empty()) _cpus.push_back(boost::lexical_cast<size_t>(tok));
+            }
+        }
+
         //Create the receive thread to poll the underlying transport
         //and classify packets into queues
         _recv_thread = boost::thread(
@@ -56,7 +85,8 @@ public:
             //Wait for loop to finish
             //No timeout on join. The recv loop is guaranteed
             //to terminate in a reasonable amount of time because
-            //there are no timed blocks on the underlying.
+            //the only timed block on the underlying is bounded
+            //by the receive timeout.
             _recv_thread.join();
             //Flush base transport
             while (_base_xport->get_recv_buff(0.0001)) /*NOP*/;
@@ -77,7 +107,7 @@ public:
         // Only allocate a portion of the base transport's frames to each stream
         // to prevent all streams from attempting to use all the frames.
         stream_impl::sptr stream = boost::make_shared<stream_impl>(
-            this->shared_from_this(), stream_num,
+            this->shared_from_this(), stream_num, _release_in_order,
             _base_xport->get_num_send_frames() / _max_num_streams,
             _base_xport->get_num_recv_frames() / _max_num_streams);
         _streams[stream_num] = stream;
@@ -97,28 +127,74 @@ public:
 
 private:
     /*
-     * @class stream_mrb is used to copy the data and release the original
-     * managed receive buffer back to the base transport.
+     * @class stream_mrb hands a frame of the base transport to a stream.
+     * By default the frame is copied into the stream_mrb, and the base
+     * buffer is released right away. With in order release, the base
+     * buffer itself is handed out, and released through the pending queue
+     * (see _pending) once this buffer and all earlier ones are released.
+     * A queued buffer which holds back too many frames is copied out.
      */
     class stream_mrb : public managed_recv_buffer
     {
     public:
-        stream_mrb(size_t size) : _buff(new char[size]) {}
+        enum state_t {STATE_FREE, STATE_QUEUED, STATE_TAKEN, STATE_COPYING};
+
+        stream_mrb(muxed_zero_copy_if_impl *muxed_xport, const size_t size) :
+            _muxed_xport(muxed_xport), _copy(size), _seq(0), _pinned(false) {}
 
-        ~stream_mrb() {
-            delete[] _buff;
+        void release() {
+            this->take();
+            if (_pinned) _muxed_xport->_release_pending(_seq);
+            _pinned = false;
+            _state.write(STATE_FREE);
+            _claimer.release();
+        }
+
+        UHD_INLINE bool claim(const double timeout) {
+            return _claimer.claim_with_wait(timeout);
+        }
+
+        //! Mark the buffer as read by the stream, so it is not copied out
+        UHD_INLINE void take() {
+            while (_state.cas(STATE_TAKEN, STATE_QUEUED) == STATE_COPYING) {
+                boost::this_thread::yield();
+            }
         }
 
-        void release() {}
+        /*!
+         * Copy the base buffer of a queued buffer into this buffer.
+         * Called with the pending queue locked.
+         * \return false when the stream is already reading the buffer
+         */
+        bool copy_out() {
+            if (_state.cas(STATE_COPYING, STATE_QUEUED) != STATE_QUEUED) return false;
+            std::memcpy(&_copy.front(), _buffer, _length);
+            _buffer = &_copy.front();
+            _pinned = false;
+            _state.write(STATE_QUEUED);
+            return true;
+        }
 
-        UHD_INLINE sptr get_new(char *buff, size_t len)
+        UHD_INLINE sptr get_new(managed_recv_buffer::sptr &buff, const bool pinned, const uint64_t seq)
         {
-            memcpy(_buff, buff, len);
-            return make(this, _buff, len);
+            _seq = seq;
+            _pinned = pinned;
+            void *mem = buff->cast<void*>();
+            if (not pinned) {
+                std::memcpy(&_copy.front(), mem, buff->size());
+                mem = &_copy.front();
+            }
+            _state.write(STATE_QUEUED);
+            return make(this, mem, buff->size());
         }
 
     private:
-        char *_buff;
+        muxed_zero_copy_if_impl *_muxed_xport;
+        std::vector<char> _copy;
+        uint64_t _seq;
+        bool _pinned;
+        atomic_uint32_t _state;
+        simple_claimer _claimer;
     };
 
     class stream_impl : public zero_copy_if
@@ -130,20 +206,24 @@ private:
         stream_impl(
             muxed_zero_copy_if_impl::sptr muxed_xport,
             const uint32_t stream_num,
+            const bool release_in_order,
             const size_t num_send_frames,
             const size_t num_recv_frames
             ) :
             _stream_num(stream_num), _muxed_xport(muxed_xport),
+            _release_in_order(release_in_order),
             _num_send_frames(num_send_frames),
             _send_frame_size(_muxed_xport->base_xport()->get_send_frame_size()),
             _num_recv_frames(num_recv_frames),
             _recv_frame_size(_muxed_xport->base_xport()->get_recv_frame_size()),
             _buff_queue(num_recv_frames),
-            _buffers(num_recv_frames),
+            _buffers(num_recv_frames + 1),
             _buffer_index(0)
         {
-            for (size_t i = 0; i < num_recv_frames; i++) {
-                _buffers[i] = boost::make_shared<stream_mrb>(_recv_frame_size);
+            //One more buffer than the queue holds, so that the
+            //caller can hold a buffer while the queue is full
+            for (size_t i = 0; i < _buffers.size(); i++) {
+                _buffers[i] = boost::make_shared<stream_mrb>(_muxed_xport.get(), _recv_frame_size);
             }
         }
 
@@ -170,15 +250,39 @@ private:
         managed_recv_buffer::sptr get_recv_buff(double timeout) {
             managed_recv_buffer::sptr buff;
             if (_buff_queue.pop_with_timed_wait(buff, timeout)) {
+                static_cast<stream_mrb *>(buff.get())->take();
                 return buff;
             } else {
                 return managed_recv_buffer::sptr();
             }
         }
 
-        void push_recv_buff(managed_recv_buffer::sptr buff) {
-            _buff_queue.push_with_wait(_buffers.at(_buffer_index++)->get_new(buff->cast<char*>(), buff->size()));
-            _buffer_index %= _buffers.size();
+        size_t get_recv_buffs(managed_recv_buffer::sptr *buffs, const size_t num_buffs, const double timeout) {
+            //only the first buffer waits, the others are taken if already queued
+            if (num_buffs == 0 or not _buff_queue.pop_with_timed_wait(buffs[0], timeout)) return 0;
+            size_t num_got = 1;
+            while (num_got < num_buffs and _buff_queue.pop_with_haste(buffs[num_got])) num_got++;
+            for (size_t i = 0; i < num_got; i++) {
+                static_cast<stream_mrb *>(buffs[i].get())->take();
+            }
+            return num_got;
+        }
+
+        /*!
+         * Queue a frame of the base transport for this stream.
+         * \return false when the stream did not make room within the timeout
+         */
+        bool push_recv_buff(managed_recv_buffer::sptr &buff, const double timeout) {
+            stream_mrb &mrb = *_buffers.at(_buffer_index);
+            //Wait for the caller to release the buffer from the last round
+            if (not mrb.claim(timeout)) {
+                if (_release_in_order) _muxed_xport->_push_pending(buff, NULL);
+                return false;
+            }
+            _buffer_index = (_buffer_index + 1) % _buffers.size();
+            const uint64_t seq = _release_in_order? _muxed_xport->_push_pending(buff, &mrb) : 0;
+            //The buffer is released again if the queue stays full
+            return _buff_queue.push_with_timed_wait(mrb.get_new(buff, _release_in_order, seq), timeout);
         }
 
         size_t get_num_send_frames(void) const {
@@ -194,30 +298,93 @@ private:
             return _muxed_xport->base_xport()->get_send_buff(timeout);
         }
 
+        size_t get_send_buffs(managed_send_buffer::sptr *buffs, const size_t num_buffs, const double timeout)
+        {
+            return _muxed_xport->base_xport()->get_send_buffs(buffs, num_buffs, timeout);
+        }
+
     private:
         const uint32_t                              _stream_num;
         muxed_zero_copy_if_impl::sptr               _muxed_xport;
+        const bool                                  _release_in_order;
         const size_t                                _num_send_frames;
         const size_t                                _send_frame_size;
         const size_t                                _num_recv_frames;
         const size_t                                _recv_frame_size;
-        bounded_buffer<managed_recv_buffer::sptr>   _buff_queue;
+        spsc_bounded_buffer<managed_recv_buffer::sptr>   _buff_queue;
         std::vector< boost::shared_ptr<stream_mrb> >    _buffers;
         size_t                                      _buffer_index;
     };
 
     inline zero_copy_if::sptr& base_xport() { return _base_xport; }
 
+    /*
+     * Some base transports (e.g. the NI-RIO DMA FIFOs) release their
+     * frames strictly in the order they were received, regardless of
+     * which buffer is released. With mux_release_in_order, every base
+     * buffer is queued here and only released once all buffers received
+     * before it are done. A stream which does not read its buffers would
+     * hold back every later frame, so once more than _max_pinned frames
+     * are held, the oldest ones are copied out of the base transport.
+     */
+    struct pending_buff_t {
+        managed_recv_buffer::sptr buff;
+        stream_mrb *mrb;
+        bool done;
+    };
+
+    uint64_t _push_pending(managed_recv_buffer::sptr &buff, stream_mrb *mrb)
+    {
+        boost::lock_guard<boost::mutex> lock(_pending_mutex);
+        pending_buff_t pending;
+        pending.buff = buff;
+        pending.mrb = mrb;
+        pending.done = (mrb == NULL);
+        _pending.push_back(pending);
+        const uint64_t seq = _pending_head_seq + _pending.size() - 1;
+        _pop_done_pending();
+        //A buffer which its stream is reading is released by the stream
+        while (_pending.size() > _max_pinned and _pending.front().mrb->copy_out()) {
+            _pending.front().done = true;
+            _pop_done_pending();
+        }
+        return seq;
+    }
+
+    void _release_pending(const uint64_t seq)
+    {
+        boost::lock_guard<boost::mutex> lock(_pending_mutex);
+        _pending.at(size_t(seq - _pending_head_seq)).done = true;
+        _pop_done_pending();
+    }
+
+    UHD_INLINE void _pop_done_pending()
+    {
+        while (not _pending.empty() and _pending.front().done) {
+            _pending.pop_front(); //releases the base buffer
+            _pending_head_seq++;
+        }
+    }
+
     void _update_queues()
     {
         //Run forever:
         // - Pull packets from the base transport
         // - Classify them
         // - Push them to the appropriate receive queue
+        uhd::setup_thread(_role);
+        try {
+            uhd::set_thread_affinity(_cpus);
+        } catch (const std::exception &e) {
+            UHD_MSG(warning) << boost::format(
+                "Unable to pin the muxed transport thread to CPU %u.\n%s\n"
+            ) % _cpus.front() % e.what();
+        }
         while (true) {
             {   //Uninterruptable block of code
                 boost::this_thread::disable_interruption interrupt_disabler;
-                if (not _process_next_buffer()) {
+                //In the blocking mode the base transport already waited
+                if (not _process_next_buffer() and _recv_timeout <= 0.0) {
                     //Be a good citizen and yield if no packet is processed
                     static const size_t MIN_DUR = 1;
                     boost::this_thread::sleep_for(boost::chrono::nanoseconds(MIN_DUR));
@@ -234,7 +401,8 @@ private:
 
                     //****************************************************************
                     //NOTE: This behavior makes this transport a poor choice for
-                    //      low latency communication.
+                    //      low latency communication. Set mux_recv_timeout to
+                    //      block on the base transport instead.
                     //****************************************************************
                 }
             }
@@ -245,7 +413,7 @@ private:
 
     bool _process_next_buffer()
     {
-        managed_recv_buffer::sptr buff = _base_xport->get_recv_buff(0.0);
+        managed_recv_buffer::sptr buff = _base_xport->get_recv_buff(std::max(_recv_timeout, 0.0));
         if (buff) {
             stream_impl::sptr stream;
             try {
@@ -264,9 +432,15 @@ private:
             }
             //Once a bounded buffer is acquired, we can rely on its
             //thread safety to serialize with the consumer.
-            if (stream.get()) {
-                stream->push_recv_buff(buff);
-            } else {
+            if (not stream.get()) {
+                if (_release_in_order) _push_pending(buff, NULL);
+                boost::lock_guard<boost::mutex> lock(_mutex);
+                _num_dropped_frames++;
+            }
+            //A stream which does not read its frames drops them after
+            //the push timeout, instead of stalling the other streams
+            else if (not stream->push_recv_buff(buff,
+                boost::this_thread::interruption_requested()? 0.0 : _push_timeout)) {
                 boost::lock_guard<boost::mutex> lock(_mutex);
                 _num_dropped_frames++;
             }
@@ -287,14 +461,25 @@ private:
     stream_map_t            _streams;
     const size_t            _max_num_streams;
     size_t                  _num_dropped_frames;
+    const double            _recv_timeout;
+    const double            _push_timeout;
+    const std::string       _role;
+    const bool              _release_in_order;
+    const size_t            _max_pinned;
+    std::vector<size_t>     _cpus;
     boost::thread           _recv_thread;
     boost::mutex            _mutex;
+    //base buffers not yet released, in receive order
+    std::deque<pending_buff_t>  _pending;
+    uint64_t                _pending_head_seq;
+    boost::mutex            _pending_mutex;
 };
 
 muxed_zero_copy_if::sptr muxed_zero_copy_if::make(
     zero_copy_if::sptr base_xport,
     muxed_zero_copy_if::stream_classifier_fn classify_fn,
-    size_t max_streams
+    size_t max_streams,
+    const device_addr_t &hints
 ) {
-    return boost::make_shared<muxed_zero_copy_if_impl>(base_xport, classify_fn, max_streams);
+    return boost::make_shared<muxed_zero_copy_if_impl>(base_xport, classify_fn, max_streams, hints);
 }
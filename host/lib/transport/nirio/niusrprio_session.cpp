@@ -35,8 +35,12 @@ niusrprio_session::niusrprio_session(const std::string& resource_name, const std
     _resource_manager(),
     _rpc_client("localhost", rpc_port_name)
 {
-   _riok_proxy = create_kernel_proxy(resource_name,rpc_port_name);
-   _resource_manager.set_proxy(_riok_proxy);
+    //The session's own RPC connection gets the interface path, open() reuses it
+    nirio_status status = _rpc_client.get_ctor_status();
+    nirio_status_chain(_rpc_client.niusrprio_get_interface_path(_resource_name, _interface_path), status);
+    if (nirio_status_fatal(status)) _interface_path.clear();
+    _riok_proxy = niriok_proxy::make_and_open(_interface_path);
+    _resource_manager.set_proxy(_riok_proxy);
 }
 
 niusrprio_session::~niusrprio_session()
@@ -67,7 +71,9 @@ nirio_status niusrprio_session::open(
     //Make sure that the RPC client connected to the server properly
     nirio_status_chain(_rpc_client.get_ctor_status(), status);
     //Get a handle to the kernel driver
-    nirio_status_chain(_rpc_client.niusrprio_get_interface_path(_resource_name, _interface_path), status);
+    if (_interface_path.empty()) {
+        nirio_status_chain(_rpc_client.niusrprio_get_interface_path(_resource_name, _interface_path), status);
+    }
     nirio_status_chain(_riok_proxy->open(_interface_path), status);
 
     if (nirio_status_not_fatal(status)) {
@@ -106,8 +112,11 @@ void niusrprio_session::close(bool skip_reset)
 
     if (_session_open) {
         nirio_status status = NiRio_Status_Success;
-        if (!skip_reset) reset();
-        nirio_status_chain(_rpc_client.niusrprio_close_session(_resource_name), status);
+        if (skip_reset) {
+            nirio_status_chain(_rpc_client.niusrprio_close_session(_resource_name), status);
+        } else {
+            nirio_status_chain(_rpc_client.niusrprio_reset_and_close_session(_resource_name), status);
+        }
         _session_open = false;
     }
 }
@@ -108,50 +108,72 @@ const boost::system::error_code& rpc_client::call(
     boost::posix_time::milliseconds timeout
 )
 {
-    boost::mutex::scoped_lock lock(_mutex);
+    func_call_vtr calls(1, func_call_t(func_id, in_args, out_args));
+    return call_batch(calls, timeout);
+}
 
-    if (_io_service_thread.get()) {
-        _request.header.func_id = func_id;
-        in_args.store(_request.data);
-        _request.header.func_args_size = _request.data.size();
+const boost::system::error_code& rpc_client::call_batch(
+    func_call_vtr& calls,
+    boost::posix_time::milliseconds timeout
+)
+{
+    boost::mutex::scoped_lock lock(_mutex);
 
+    if (_io_service_thread.get() && !calls.empty()) {
         _exec_err.clear();
+        //Responses to calls which timed out are not for this batch
+        _pending.clear();
+        _responses.clear();
+
+        //Serialize all function call headers and args into one request
+        std::vector<char> requests;
+        for (size_t i = 0; i < calls.size(); i++) {
+            _request.header.func_id = calls[i].func_id;
+            calls[i].in_args->store(_request.data);
+            _request.header.func_args_size = _request.data.size();
+            const char* header = reinterpret_cast<const char*>(&_request.header);
+            requests.insert(requests.end(), header, header + sizeof(_request.header));
+            requests.insert(requests.end(), _request.data.begin(), _request.data.end());
+            _pending.push_back(_request.header);
+        }
 
-        //Send function call header and args
+        //Send function call headers and args
         bool status = true;
         try {
             CHAIN_BLOCKING_XFER(
-                boost::asio::write(_socket, boost::asio::buffer(&_request.header, sizeof(_request.header))),
-                sizeof(_request.header), status);
-            if (not _request.data.empty())
-            {
-                CHAIN_BLOCKING_XFER(
-                    boost::asio::write(_socket, boost::asio::buffer(&(*_request.data.begin()), _request.data.size())),
-                    _request.data.size(), status);
-            }
+                boost::asio::write(_socket, boost::asio::buffer(&(*requests.begin()), requests.size())),
+                requests.size(), status);
         } catch (boost::exception&) {
             status = false;
         }
 
-        //Wait for response using condition variable
         if (status) {
-            if (!_exec_gate.timed_wait(lock, timeout)) {
-                UHD_LOG << "rpc_client function timed out." << std::endl;
-                _exec_err.assign(boost::asio::error::timed_out, boost::asio::error::get_system_category());
+            for (size_t i = 0; i < calls.size() && !_exec_err; i++) {
+                //Wait for the response using condition variable
+                const boost::system_time exit_time = boost::get_system_time() + timeout;
+                while (_responses.empty() && !_exec_err) {
+                    if (!_exec_gate.timed_wait(lock, exit_time)) {
+                        UHD_LOG << "rpc_client function timed out." << std::endl;
+                        _exec_err.assign(boost::asio::error::timed_out, boost::asio::error::get_system_category());
+                    }
+                }
+                if (_exec_err) break;
+
+                //Verify that we are talking to the correct endpoint
+                if (_request.header.client_id != _responses.front().header.client_id) {
+                    UHD_LOG << "rpc_client confused about who its talking to." << std::endl;
+                    _exec_err.assign(boost::asio::error::operation_aborted, boost::asio::error::get_system_category());
+                    break;
+                }
+
+                calls[i].out_args->load(_responses.front().data);
+                _responses.pop_front();
             }
         } else {
             UHD_LOG << "rpc_client connection dropped." << std::endl;
             _exec_err.assign(boost::asio::error::connection_aborted, boost::asio::error::get_system_category());
             _stop_io_service();
         }
-
-        //Verify that we are talking to the correct endpoint
-        if ((_request.header.client_id != _response.header.client_id) && !_exec_err) {
-            UHD_LOG << "rpc_client confused about who its talking to." << std::endl;
-            _exec_err.assign(boost::asio::error::operation_aborted, boost::asio::error::get_system_category());
-        }
-
-        if (!_exec_err) out_args.load(_response.data);
     }
 
     return _exec_err;
@@ -160,10 +182,11 @@ const boost::system::error_code& rpc_client::call(
 void rpc_client::_handle_response_hdr(const boost::system::error_code& err, size_t transferred, size_t expected)
 {
     boost::mutex::scoped_lock lock(_mutex);
-    _exec_err = err;
-    if (!_exec_err && (transferred == expected)) {
+    if (err) _exec_err = err;
+    if (!err && (transferred == expected)) {
         //Response header received. Verify that it is expected
-        if (func_args_header_t::match_function(_request.header, _response.header)) {
+        if (!_pending.empty() && func_args_header_t::match_function(_pending.front(), _response.header)) {
+            _pending.pop_front();
             if (_response.header.func_args_size)
             {
                 _response.data.resize(_response.header.func_args_size);
@@ -176,7 +199,8 @@ void rpc_client::_handle_response_hdr(const boost::system::error_code& err, size
                         boost::asio::placeholders::bytes_transferred,
                         _response.data.size()));
             } else {
-                _handle_response_data(err, 0, 0);
+                _response.data.clear();
+                _complete_response();
             }
         } else {
             //Unexpected response. Ignore it.
@@ -193,11 +217,23 @@ void rpc_client::_handle_response_hdr(const boost::system::error_code& err, size
 void rpc_client::_handle_response_data(const boost::system::error_code& err, size_t transferred, size_t expected)
 {
     boost::mutex::scoped_lock lock(_mutex);
-    _exec_err = err;
-    if (transferred != expected) {
+    if (err) {
+        _exec_err = err;
+    } else if (transferred != expected) {
         _exec_err.assign(boost::asio::error::operation_aborted, boost::asio::error::get_system_category());
     }
 
+    if (_exec_err) {
+        _exec_gate.notify_all();
+        _wait_for_next_response_header();
+    } else {
+        _complete_response();
+    }
+}
+
+void rpc_client::_complete_response() {
+    //_mutex must be locked when this call is made
+    _responses.push_back(_response);
     _exec_gate.notify_all();
 
     _wait_for_next_response_header();
@@ -136,6 +136,37 @@ nirio_status usrprio_rpc_client::niusrprio_reset_device(NIUSRPRIO_RESET_SESSION_
     return status;
 }
 
+nirio_status usrprio_rpc_client::niusrprio_reset_and_close_session(NIUSRPRIO_CLOSE_SESSION_ARGS)
+/*
+#define NIUSRPRIO_CLOSE_SESSION_ARGS    \
+    const std::string& resource
+*/
+{
+    usrprio_rpc::func_args_writer_t reset_in_args, close_in_args;
+    usrprio_rpc::func_args_reader_t reset_out_args, close_out_args;
+    nirio_status status = NiRio_Status_Success;
+
+    reset_in_args << resource;
+    close_in_args << resource;
+
+    func_call_vtr calls;
+    calls.push_back(func_call_t(NIUSRPRIO_RESET_SESSION, reset_in_args, reset_out_args));
+    calls.push_back(func_call_t(NIUSRPRIO_CLOSE_SESSION, close_in_args, close_out_args));
+    status = _boost_error_to_nirio_status(
+        _rpc_client.call_batch(calls, _timeout));
+
+    if (nirio_status_not_fatal(status)) {
+        nirio_status reset_status = NiRio_Status_Success;
+        nirio_status close_status = NiRio_Status_Success;
+        reset_out_args >> reset_status;
+        close_out_args >> close_status;
+        nirio_status_chain(reset_status, status);
+        nirio_status_chain(close_status, status);
+    }
+
+    return status;
+}
+
 nirio_status usrprio_rpc_client::niusrprio_get_interface_path(NIUSRPRIO_GET_INTERFACE_PATH_ARGS)
 /*
 #define NIUSRPRIO_GET_INTERFACE_PATH_ARGS   \
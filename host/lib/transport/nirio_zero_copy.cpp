@@ -31,6 +31,7 @@
 #include <algorithm>    // std::max
 //@TODO: Move the register defs required by the class to a common location
 #include "../usrp/x300/x300_regs.hpp"
+#include "xport_stats.hpp"
 
 #if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
 #include <windows.h>
@@ -55,11 +56,43 @@ using namespace uhd::niusrprio;
 
 typedef uint64_t fifo_data_t;
 
+/***********************************************************************
+ * Acquire one frame from a DMA FIFO:
+ * The driver's FIFO wait blocks until the DMA engine signals that the
+ * elements are available. With a poll budget, spin on non-blocking
+ * acquires first, which avoids the wakeup latency for short waits.
+ **********************************************************************/
+static UHD_INLINE nirio_status acquire_frame(
+    nirio_fifo<fifo_data_t>& fifo,
+    fifo_data_t*& buffer,
+    const size_t num_elems,
+    double timeout,
+    const double poll_timeout,
+    size_t& elems_acquired,
+    size_t& elems_remaining
+){
+    if (poll_timeout > 0.0 and timeout > 0.0) {
+        const boost::system_time start_time = boost::get_system_time();
+        const double poll_budget = std::min(poll_timeout, timeout);
+        double elapsed = 0.0;
+        do {
+            const nirio_status status = fifo.acquire(
+                buffer, num_elems, 0, elems_acquired, elems_remaining);
+            if (status != NiRio_Status_FifoTimeout) return status;
+            elapsed = (boost::get_system_time() - start_time).total_microseconds()/1e6;
+        } while (elapsed < poll_budget);
+        timeout = std::max(timeout - elapsed, 0.0);
+    }
+    return fifo.acquire(
+        buffer, num_elems, static_cast<uint32_t>(timeout*1000),
+        elems_acquired, elems_remaining);
+}
+
 class nirio_zero_copy_mrb : public managed_recv_buffer
 {
 public:
-    nirio_zero_copy_mrb(nirio_fifo<fifo_data_t>& fifo, const size_t frame_size):
-        _fifo(fifo), _frame_size(frame_size) { }
+    nirio_zero_copy_mrb(nirio_fifo<fifo_data_t>& fifo, const size_t frame_size, const double poll_timeout):
+        _fifo(fifo), _frame_size(frame_size), _poll_timeout(poll_timeout), _elems_remaining(0) { }
 
     void release(void)
     {
@@ -68,13 +101,10 @@ public:
 
     UHD_INLINE sptr get_new(const double timeout, size_t &index)
     {
-        nirio_status status = 0;
         size_t elems_acquired = 0;
-        size_t elems_remaining = 0;
-        nirio_status_chain(_fifo.acquire(
-            _typed_buffer, _frame_size / sizeof(fifo_data_t),
-            static_cast<uint32_t>(timeout*1000),
-            elems_acquired, elems_remaining), status);
+        const nirio_status status = acquire_frame(
+            _fifo, _typed_buffer, _frame_size / sizeof(fifo_data_t),
+            timeout, _poll_timeout, elems_acquired, _elems_remaining);
         _length = elems_acquired * sizeof(fifo_data_t);
         _buffer = static_cast<void*>(_typed_buffer);
 
@@ -89,32 +119,53 @@ public:
         }
     }
 
+    //! Hand out a frame of a block acquired by the transport
+    UHD_INLINE sptr get_acquired(fifo_data_t* elems, size_t &index)
+    {
+        _typed_buffer = elems;
+        _buffer = static_cast<void*>(_typed_buffer);
+        index++;        //Advances the caller's buffer
+        return make(this, _buffer, _frame_size);
+    }
+
+    UHD_INLINE size_t get_frame_size(void) const
+    {
+        return _frame_size;
+    }
+
+    //! The number of FIFO elements left to acquire after get_new()
+    UHD_INLINE size_t get_elems_remaining(void) const
+    {
+        return _elems_remaining;
+    }
+
 private:
     nirio_fifo<fifo_data_t>&    _fifo;
     fifo_data_t*                _typed_buffer;
     const size_t                _frame_size;
+    const double                _poll_timeout;
+    size_t                      _elems_remaining;
 };
 
 class nirio_zero_copy_msb : public managed_send_buffer
 {
 public:
-    nirio_zero_copy_msb(nirio_fifo<fifo_data_t>& fifo, const size_t frame_size):
-        _fifo(fifo), _frame_size(frame_size) { }
+    nirio_zero_copy_msb(nirio_fifo<fifo_data_t>& fifo, const size_t frame_size, const double poll_timeout,
+        zero_copy_stats_counters& stats):
+        _fifo(fifo), _frame_size(frame_size), _poll_timeout(poll_timeout), _elems_remaining(0), _stats(stats) { }
 
     void release(void)
     {
+        _stats.count_send(size());
         _fifo.release(_frame_size / sizeof(fifo_data_t));
     }
 
     UHD_INLINE sptr get_new(const double timeout, size_t &index)
     {
-        nirio_status status = 0;
         size_t elems_acquired = 0;
-        size_t elems_remaining = 0;
-        nirio_status_chain(_fifo.acquire(
-            _typed_buffer, _frame_size / sizeof(fifo_data_t),
-            static_cast<uint32_t>(timeout*1000),
-            elems_acquired, elems_remaining), status);
+        const nirio_status status = acquire_frame(
+            _fifo, _typed_buffer, _frame_size / sizeof(fifo_data_t),
+            timeout, _poll_timeout, elems_acquired, _elems_remaining);
         _length = elems_acquired * sizeof(fifo_data_t);
         _buffer = static_cast<void*>(_typed_buffer);
 
@@ -129,10 +180,33 @@ public:
         }
     }
 
+    //! Hand out a frame of a block acquired by the transport
+    UHD_INLINE sptr get_acquired(fifo_data_t* elems, size_t &index)
+    {
+        _typed_buffer = elems;
+        _buffer = static_cast<void*>(_typed_buffer);
+        index++;        //Advances the caller's buffer
+        return make(this, _buffer, _frame_size);
+    }
+
+    UHD_INLINE size_t get_frame_size(void) const
+    {
+        return _frame_size;
+    }
+
+    //! The number of FIFO elements left to acquire after get_new()
+    UHD_INLINE size_t get_elems_remaining(void) const
+    {
+        return _elems_remaining;
+    }
+
 private:
     nirio_fifo<fifo_data_t>&    _fifo;
     fifo_data_t*                _typed_buffer;
     const size_t                _frame_size;
+    const double                _poll_timeout;
+    size_t                      _elems_remaining;
+    zero_copy_stats_counters&   _stats;
 };
 
 class nirio_zero_copy_impl : public nirio_zero_copy {
@@ -142,7 +216,9 @@ public:
     nirio_zero_copy_impl(
         uhd::niusrprio::niusrprio_session::sptr fpga_session,
         uint32_t instance,
-        const zero_copy_xport_params& xport_params
+        const zero_copy_xport_params& xport_params,
+        const double recv_poll_timeout,
+        const double send_poll_timeout
     ):
         _fpga_session(fpga_session),
         _fifo_instance(instance),
@@ -219,13 +295,13 @@ public:
                 //allocate re-usable managed receive buffers
                 for (size_t i = 0; i < get_num_recv_frames(); i++){
                     _mrb_pool.push_back(boost::shared_ptr<nirio_zero_copy_mrb>(new nirio_zero_copy_mrb(
-                        *_recv_fifo, get_recv_frame_size())));
+                        *_recv_fifo, get_recv_frame_size(), recv_poll_timeout)));
                 }
 
                 //allocate re-usable managed send buffers
                 for (size_t i = 0; i < get_num_send_frames(); i++){
                     _msb_pool.push_back(boost::shared_ptr<nirio_zero_copy_msb>(new nirio_zero_copy_msb(
-                        *_send_fifo, get_send_frame_size())));
+                        *_send_fifo, get_send_frame_size(), send_poll_timeout, _stats)));
                 }
             }
         } else {
@@ -258,7 +334,24 @@ public:
     managed_recv_buffer::sptr get_recv_buff(double timeout)
     {
         if (_next_recv_buff_index == _xport_params.num_recv_frames) _next_recv_buff_index = 0;
-        return _mrb_pool[_next_recv_buff_index]->get_new(timeout, _next_recv_buff_index);
+        nirio_zero_copy_mrb& mrb = *_mrb_pool[_next_recv_buff_index];
+        managed_recv_buffer::sptr buff = mrb.get_new(timeout, _next_recv_buff_index);
+        _stats.count_recv(buff);
+        if (buff) {
+            _stats.recv_queue_hwm.update_max(1 + mrb.get_elems_remaining()*sizeof(fifo_data_t)/mrb.get_frame_size());
+        }
+        return buff;
+    }
+
+    size_t get_recv_buffs(managed_recv_buffer::sptr *buffs, const size_t num_buffs, const double timeout)
+    {
+        size_t frames_waiting = 0;
+        const size_t num_got = _get_buffs(*_recv_fifo, _mrb_pool, _next_recv_buff_index,
+            _xport_params.num_recv_frames, buffs, num_buffs, timeout, &frames_waiting);
+        for (size_t i = 0; i < num_got; i++) _stats.count_recv(buffs[i]);
+        if (num_got == 0) _stats.recv_timeouts.add();
+        _stats.recv_queue_hwm.update_max(frames_waiting);
+        return num_got;
     }
 
     size_t get_num_recv_frames(void) const {return _xport_params.num_recv_frames;}
@@ -271,14 +364,71 @@ public:
     managed_send_buffer::sptr get_send_buff(double timeout)
     {
         if (_next_send_buff_index == _xport_params.num_send_frames) _next_send_buff_index = 0;
-        return _msb_pool[_next_send_buff_index]->get_new(timeout, _next_send_buff_index);
+        managed_send_buffer::sptr buff = _msb_pool[_next_send_buff_index]->get_new(timeout, _next_send_buff_index);
+        if (not buff) _stats.send_timeouts.add();
+        return buff;
+    }
+
+    size_t get_send_buffs(managed_send_buffer::sptr *buffs, const size_t num_buffs, const double timeout)
+    {
+        const size_t num_got = _get_buffs(*_send_fifo, _msb_pool, _next_send_buff_index,
+            _xport_params.num_send_frames, buffs, num_buffs, timeout);
+        if (num_got == 0) _stats.send_timeouts.add();
+        return num_got;
     }
 
     size_t get_num_send_frames(void) const {return _xport_params.num_send_frames;}
     size_t get_send_frame_size(void) const {return _xport_params.send_frame_size;}
 
+    zero_copy_stats_t get_stats(void) const {return _stats.get();}
+
 private:
 
+    /*******************************************************************
+     * Multi-buffer implementation:
+     * Wait for the first frame like the single buffer call.
+     * Then acquire the frames that are already available in the FIFO
+     * as one block, and split the block into managed buffers.
+     * frames_waiting, if given, is set to the number of frames
+     * that were available when the first frame was acquired.
+     ******************************************************************/
+    template <typename buff_sptr, typename buff_type>
+    UHD_INLINE size_t _get_buffs(
+        nirio_fifo<fifo_data_t>& fifo,
+        std::vector<boost::shared_ptr<buff_type> >& pool,
+        size_t& next_index,
+        const size_t num_frames,
+        buff_sptr *buffs,
+        const size_t num_buffs,
+        const double timeout,
+        size_t *frames_waiting = NULL
+    ){
+        if (num_buffs == 0) return 0;
+        if (next_index == num_frames) next_index = 0;
+        const size_t first_index = next_index;
+        buffs[0] = pool[first_index]->get_new(timeout, next_index);
+        if (not buffs[0]) return 0;
+
+        const size_t frame_elems = pool[first_index]->get_frame_size() / sizeof(fifo_data_t);
+        size_t num_got = 1;
+        size_t elems_remaining = pool[first_index]->get_elems_remaining();
+        if (frames_waiting) *frames_waiting = 1 + elems_remaining / frame_elems;
+        while (num_got < num_buffs and elems_remaining >= frame_elems) {
+            fifo_data_t* elems = NULL;
+            size_t elems_acquired = 0;
+            const size_t num_block_frames = std::min(num_buffs - num_got, elems_remaining / frame_elems);
+            const nirio_status status = fifo.acquire(
+                elems, num_block_frames * frame_elems, 0, elems_acquired, elems_remaining);
+            if (nirio_status_fatal(status) or elems_acquired < frame_elems) break;
+            for (size_t i = 0; i < elems_acquired / frame_elems; i++) {
+                if (next_index == num_frames) next_index = 0;
+                buffs[num_got++] = pool[next_index]->get_acquired(elems + i*frame_elems, next_index);
+            }
+        }
+        return num_got;
+    }
+
+
     UHD_INLINE niriok_proxy::sptr _proxy() { return _fpga_session->get_kernel_proxy(); }
 
     UHD_INLINE void _flush_rx_buff()
@@ -348,6 +498,9 @@ private:
         }
     }
 
+    //counters, referenced by the send buffers
+    zero_copy_stats_counters _stats;
+
     //memory management -> buffers and fifos
     niusrprio::niusrprio_session::sptr _fpga_session;
     uint32_t _fifo_instance;
@@ -460,6 +613,13 @@ nirio_zero_copy::sptr nirio_zero_copy::make(
         throw uhd::value_error((boost::format("num_send_frames * send_frame_size must be an even multiple of %d") % page_size).str());
     }
 
-    return nirio_zero_copy::sptr(new nirio_zero_copy_impl(fpga_session, instance, xport_params));
+    //Busy-poll budgets before blocking in the driver's FIFO wait
+    const double recv_poll_timeout = hints.cast<double>("recv_poll_us", 0.0)/1e6;
+    const double send_poll_timeout = hints.cast<double>("send_poll_us", 0.0)/1e6;
+    if (recv_poll_timeout < 0.0 or send_poll_timeout < 0.0)
+        throw uhd::value_error("recv_poll_us and send_poll_us must not be negative");
+
+    return nirio_zero_copy::sptr(new nirio_zero_copy_impl(
+        fpga_session, instance, xport_params, recv_poll_timeout, send_poll_timeout));
 }
 
@@ -0,0 +1,87 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_PACKET_FRAMING_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_PACKET_FRAMING_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <stdint.h>
+#include <cstring>
+#include <string>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * Packet framing:
+ * A transport which batches or carves frames looks at the first header
+ * word of a packet for its length and whether it ends a burst.
+ * CHDR has the length in bytes, VRT in words32.
+ */
+enum packet_framing_t{
+    PACKET_FRAMING_NONE,
+    PACKET_FRAMING_CHDR,
+    PACKET_FRAMING_VRT
+};
+
+struct packet_framing_params_t{
+    packet_framing_params_t(void): type(PACKET_FRAMING_NONE), little_endian(false){}
+    packet_framing_t type;
+    bool little_endian;
+};
+
+/*!
+ * Parse the value of a framing hint.
+ * \param key the name of the hint, for the error message
+ * \param framing none, chdr_be, chdr_le, vrt_be or vrt_le
+ * \throw uhd::value_error for any other value
+ */
+static inline packet_framing_params_t get_packet_framing_params(
+    const std::string &key, const std::string &framing
+){
+    packet_framing_params_t params;
+    if (framing == "" or framing == "none") return params;
+    if (framing == "chdr_be" or framing == "chdr_le") params.type = PACKET_FRAMING_CHDR;
+    else if (framing == "vrt_be" or framing == "vrt_le") params.type = PACKET_FRAMING_VRT;
+    else throw uhd::value_error(key + " must be none, chdr_be, chdr_le, vrt_be or vrt_le, not " + framing);
+    params.little_endian = (framing.substr(framing.size()-2) == "le");
+    return params;
+}
+
+//! Get the first header word of the packet at mem, which may be unaligned
+static UHD_INLINE uint32_t get_header_word(const packet_framing_params_t &params, const void *mem){
+    uint32_t word;
+    std::memcpy(&word, mem, sizeof(word));
+    return params.little_endian? uhd::wtohx(word) : uhd::ntohx(word);
+}
+
+//! Get the length in bytes of a packet from its first header word
+static UHD_INLINE size_t get_packet_len(const packet_framing_params_t &params, const uint32_t word){
+    if (params.type == PACKET_FRAMING_CHDR) return word & 0xffff;
+    return (word & 0xffff)*sizeof(uint32_t);
+}
+
+//! Is the packet a data packet without end of burst, which can wait for others?
+static UHD_INLINE bool is_mid_burst_data(const packet_framing_params_t &params, const uint32_t word){
+    if (params.type == PACKET_FRAMING_CHDR) return (word >> 30) == 0 and not (word & (1 << 28));
+    return (word >> 28) < 4 and not (word & (1 << 24));
+}
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_PACKET_FRAMING_HPP */
@@ -0,0 +1,146 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "pfb_channelizer.hpp"
+#include <uhd/exception.hpp>
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CHANNELIZER_USE_SSE2
+#endif
+
+using namespace uhd;
+using namespace uhd::transport;
+
+static const double PI = 3.14159265358979323846;
+
+pfb_channelizer::pfb_channelizer(const size_t num_chans, const size_t taps_per_branch):
+    _num_chans(num_chans), _taps_per_branch(taps_per_branch),
+    _slot(0), _branch(0), _work(num_chans), _fft(num_chans, false)
+{
+    if (_num_chans < 2 or _taps_per_branch == 0){
+        throw uhd::value_error("pfb_channelizer: needs two channels or more and one tap per branch or more");
+    }
+
+    //the prototype filter, cut off at the channel edges
+    const size_t num_taps = _num_chans*_taps_per_branch;
+    const double cutoff = 0.5/_num_chans;
+    const double center = (num_taps - 1)/2.0;
+    std::vector<double> proto(num_taps);
+    double sum = 0.0;
+    for (size_t n = 0; n < num_taps; n++){
+        const double t = n - center;
+        const double sinc = (t == 0.0)? 2*cutoff : std::sin(2*PI*cutoff*t)/(PI*t);
+        const double phase = 2*PI*n/(num_taps - 1);
+        const double window = 0.42 - 0.5*std::cos(phase) + 0.08*std::cos(2*phase);
+        proto[n] = sinc*window;
+        sum += proto[n];
+    }
+
+    //branch p filters the inputs n*M - p with the taps p + t*M
+    _taps.resize(2*num_taps);
+    for (size_t p = 0; p < _num_chans; p++){
+        float *branch = &_taps[2*p*_taps_per_branch];
+        for (size_t t = 0; t < _taps_per_branch; t++){
+            const float tap = float(proto[p + t*_num_chans]/sum);
+            branch[2*t + 0] = tap;
+            branch[2*t + 1] = tap;
+        }
+    }
+
+    this->reset();
+}
+
+double pfb_channelizer::get_delay(void) const{
+    return (_num_chans*_taps_per_branch - 1)/2.0;
+}
+
+size_t pfb_channelizer::get_num_outputs(const size_t num_inputs) const{
+    //the next output is due after _branch + 1 inputs, then every M inputs
+    if (num_inputs <= _branch) return 0;
+    return (num_inputs - _branch - 1)/_num_chans + 1;
+}
+
+size_t pfb_channelizer::get_num_inputs(const size_t num_outputs) const{
+    if (num_outputs == 0) return 0;
+    return _branch + 1 + (num_outputs - 1)*_num_chans;
+}
+
+/*!
+ * The dot product of a branch with its delay line.
+ * The taps are doubled up, so that both are a plain array of floats.
+ */
+static UHD_INLINE std::complex<float> dot_product(
+    const float *taps, const float *in, const size_t num_floats
+){
+    size_t i = 0;
+    float re = 0.0f, im = 0.0f;
+#ifdef CHANNELIZER_USE_SSE2
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    for (; i + 8 <= num_floats; i += 8){
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(taps + i + 0), _mm_loadu_ps(in + i + 0)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(taps + i + 4), _mm_loadu_ps(in + i + 4)));
+    }
+    //lanes are I, Q, I, Q
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    re = lanes[0] + lanes[2];
+    im = lanes[1] + lanes[3];
+#endif
+    for (; i < num_floats; i += 2){
+        re += taps[i + 0]*in[i + 0];
+        im += taps[i + 1]*in[i + 1];
+    }
+    return std::complex<float>(re, im);
+}
+
+size_t pfb_channelizer::process(
+    const std::complex<float> *in, const size_t num_inputs, std::complex<float> * const *outs
+){
+    const size_t taps = _taps_per_branch;
+    size_t num_outputs = 0;
+    for (size_t i = 0; i < num_inputs; i++){
+        //the input goes into the slot of the next output, and its copy
+        float *line = &_lines[4*_branch*taps];
+        line[2*_slot + 0] = line[2*(_slot + taps) + 0] = in[i].real();
+        line[2*_slot + 1] = line[2*(_slot + taps) + 1] = in[i].imag();
+        if (_branch != 0){
+            _branch--;
+            continue;
+        }
+
+        //every branch has its input: filter them, then transform
+        for (size_t p = 0; p < _num_chans; p++){
+            _work[p] = dot_product(&_taps[2*p*taps], &_lines[4*p*taps + 2*_slot], 2*taps);
+        }
+        _fft.transform(&_work.front());
+        for (size_t k = 0; k < _num_chans; k++) outs[k][num_outputs] = _work[k];
+        num_outputs++;
+
+        //the oldest slot becomes the newest of the next output
+        _slot = (_slot + taps - 1) % taps;
+        _branch = _num_chans - 1;
+    }
+    return num_outputs;
+}
+
+void pfb_channelizer::reset(void){
+    _lines.assign(4*_num_chans*_taps_per_branch, 0.0f);
+    _slot = 0;
+    _branch = 0;
+}
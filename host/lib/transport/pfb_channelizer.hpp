@@ -0,0 +1,102 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_PFB_CHANNELIZER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_PFB_CHANNELIZER_HPP
+
+#include "complex_fft.hpp"
+#include <uhd/config.hpp>
+#include <boost/utility.hpp>
+#include <complex>
+#include <vector>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * A critically sampled polyphase filter bank channelizer for complex
+ * float samples.
+ *
+ * Splits the input band into M channels of 1/M of its width, each
+ * decimated by M. Channel k is centered at k/M of the input rate, the
+ * channels above M/2 are the negative frequencies. The inputs go round
+ * the M branches of a lowpass prototype filter, and each output is the
+ * transform of the branch outputs, one FFT per M inputs. The prototype
+ * is a Blackman windowed sinc with its cutoff at the channel edges and
+ * a gain of one.
+ *
+ * The FFT is complex_fft, radix 2 for a power of two M and a plain DFT
+ * otherwise. The channelizer keeps its history between calls, so a
+ * stream can be processed in blocks of any size.
+ */
+class UHD_API pfb_channelizer : boost::noncopyable{
+public:
+    /*!
+     * Make a channelizer.
+     * \param num_chans the number of channels M, at least 2
+     * \param taps_per_branch the length of each filter branch
+     */
+    pfb_channelizer(const size_t num_chans, const size_t taps_per_branch);
+
+    size_t get_num_chans(void) const{
+        return _num_chans;
+    }
+
+    //! Get the length of each filter branch
+    size_t get_taps_per_branch(void) const{
+        return _taps_per_branch;
+    }
+
+    //! Get the delay of the filter in input samples
+    double get_delay(void) const;
+
+    //! Get the number of outputs per channel the next num_inputs inputs produce
+    size_t get_num_outputs(const size_t num_inputs) const;
+
+    //! Get the number of inputs the next num_outputs outputs per channel need
+    size_t get_num_inputs(const size_t num_outputs) const;
+
+    /*!
+     * Channelize a block of inputs.
+     * \param in the inputs
+     * \param num_inputs the number of inputs, all are consumed
+     * \param outs the outputs of each channel, room for get_num_outputs(num_inputs)
+     * \return the number of outputs per channel
+     */
+    size_t process(const std::complex<float> *in, const size_t num_inputs, std::complex<float> * const *outs);
+
+    //! Clear the history, the next input starts a new stream
+    void reset(void);
+
+private:
+    const size_t _num_chans, _taps_per_branch;
+    //! per branch: the taps from the newest input on, each twice for the I and Q of an input
+    std::vector<float> _taps;
+    //! per branch: the last inputs as I and Q, twice in a row, so any window is contiguous
+    std::vector<float> _lines;
+    //! the slot of the next output in the delay lines
+    size_t _slot;
+    //! the branch of the next input, the output is due after branch 0
+    size_t _branch;
+    //! the branch outputs, transformed into the channel outputs
+    std::vector<std::complex<float> > _work;
+    //! the transform of the branch outputs into the channel outputs
+    complex_fft _fft;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_PFB_CHANNELIZER_HPP */
@@ -0,0 +1,81 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "power_detector.hpp"
+#include <uhd/exception.hpp>
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <complex>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define POWER_DETECTOR_USE_SSE2
+#endif
+
+using namespace uhd;
+using namespace uhd::transport;
+
+/***********************************************************************
+ * The scans per format
+ **********************************************************************/
+template <typename samp_type>
+static size_t find_generic(const void *buff, const size_t begin, const size_t end, const double threshold){
+    const samp_type *in = reinterpret_cast<const samp_type *>(buff);
+    for (size_t i = begin; i < end; i++){
+        const double re = double(in[i].real()), im = double(in[i].imag());
+        if (re*re + im*im > threshold) return i;
+    }
+    return end;
+}
+
+static size_t find_fc32(const void *buff, const size_t begin, const size_t end, const double threshold){
+    size_t i = begin;
+    #ifdef POWER_DETECTOR_USE_SSE2
+    const float *x = reinterpret_cast<const float *>(buff);
+    const __m128 thresh = _mm_set1_ps(float(threshold));
+    //four samples per round: square I and Q, pair them up, compare
+    for (; i + 4 <= end; i += 4){
+        const __m128 a = _mm_loadu_ps(x + 2*i);
+        const __m128 b = _mm_loadu_ps(x + 2*i + 4);
+        const __m128 aa = _mm_mul_ps(a, a), bb = _mm_mul_ps(b, b);
+        const __m128 power = _mm_add_ps(
+            _mm_shuffle_ps(aa, bb, _MM_SHUFFLE(2, 0, 2, 0)),
+            _mm_shuffle_ps(aa, bb, _MM_SHUFFLE(3, 1, 3, 1))
+        );
+        if (_mm_movemask_ps(_mm_cmpgt_ps(power, thresh)) != 0) break;
+    }
+    #endif
+    return find_generic<std::complex<float> >(buff, i, end, threshold);
+}
+
+/***********************************************************************
+ * The detector
+ **********************************************************************/
+power_detector::power_detector(const std::string &cpu_format, const double level){
+    double full_scale = 1.0;
+    if      (cpu_format == "fc32") _find = &find_fc32;
+    else if (cpu_format == "fc64") _find = &find_generic<std::complex<double> >;
+    else if (cpu_format == "sc16"){
+        _find = &find_generic<std::complex<boost::int16_t> >;
+        full_scale = 32767.0;
+    }
+    else if (cpu_format == "sc8"){
+        _find = &find_generic<std::complex<boost::int8_t> >;
+        full_scale = 127.0;
+    }
+    else throw uhd::value_error("power_detector: needs the fc32, fc64, sc16 or sc8 format, not " + cpu_format);
+    _threshold = std::pow(10.0, level/10)*full_scale*full_scale;
+}
@@ -0,0 +1,63 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_POWER_DETECTOR_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_POWER_DETECTOR_HPP
+
+#include <uhd/config.hpp>
+#include <string>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * Find the samples with a power above a threshold, in a CPU format.
+ *
+ * The power of a sample is its squared magnitude relative to full scale,
+ * so a full scale sample reads 0 dBFS. The fc32 samples are scanned four
+ * at a time with SSE2 where it is available.
+ */
+class UHD_API power_detector{
+public:
+    /*!
+     * Make a detector.
+     * \param cpu_format the format of the samples: fc32, fc64, sc16 or sc8
+     * \param level the threshold in dBFS
+     * \throws uhd::value_error on another format
+     */
+    power_detector(const std::string &cpu_format, const double level);
+
+    /*!
+     * Find the first sample above the threshold.
+     * \param buff the samples
+     * \param begin the index of the first sample to look at
+     * \param end the index after the last sample to look at
+     * \return the index of the sample, or end if there is none
+     */
+    size_t find(const void *buff, const size_t begin, const size_t end) const{
+        return _find(buff, begin, end, _threshold);
+    }
+
+private:
+    typedef size_t (*find_type)(const void *, const size_t, const size_t, const double);
+    find_type _find;
+    //! the threshold in squared units of the format
+    double _threshold;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_POWER_DETECTOR_HPP */
@@ -0,0 +1,104 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "psd_estimator.hpp"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PSD_USE_SSE2
+#endif
+
+using namespace uhd;
+using namespace uhd::transport;
+
+static const double PI = 3.14159265358979323846;
+
+//! The power of an empty bin, so the log stays finite
+static const float PSD_MIN_POWER = 1e-20f;
+
+/***********************************************************************
+ * Add the power of each complex sample to a sum per sample
+ **********************************************************************/
+static void add_power(const std::complex<float> *in, float *acc, const size_t n){
+    const float *x = reinterpret_cast<const float *>(in);
+    size_t i = 0;
+    #ifdef PSD_USE_SSE2
+    //four samples per round: square I and Q, then pair them up
+    for (; i + 4 <= n; i += 4){
+        const __m128 a = _mm_loadu_ps(x + 2*i);
+        const __m128 b = _mm_loadu_ps(x + 2*i + 4);
+        const __m128 aa = _mm_mul_ps(a, a), bb = _mm_mul_ps(b, b);
+        const __m128 ii = _mm_shuffle_ps(aa, bb, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 qq = _mm_shuffle_ps(aa, bb, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_add_ps(ii, qq)));
+    }
+    #endif
+    for (; i < n; i++) acc[i] += x[2*i]*x[2*i] + x[2*i + 1]*x[2*i + 1];
+}
+
+/***********************************************************************
+ * The estimator
+ **********************************************************************/
+psd_estimator::psd_estimator(const size_t size, const bool transformed):
+    _transformed(transformed), _fft(size, true), _full_scale(1.0f),
+    _work(size), _acc(size, 0.0f), _num_frames(0)
+{
+    if (_transformed) return;
+
+    //the periodic Hann window, a full scale tone sums to the window sum
+    _window.resize(size);
+    double sum = 0.0;
+    for (size_t n = 0; n < size; n++){
+        _window[n] = float(0.5 - 0.5*std::cos(2*PI*n/size));
+        sum += _window[n];
+    }
+    if (size == 1){
+        _window[0] = 1.0f;
+        sum = 1.0;
+    }
+    _full_scale = float(sum*sum);
+}
+
+void psd_estimator::add_frame(const std::complex<float> *frame){
+    if (_transformed){
+        add_power(frame, &_acc.front(), _acc.size());
+    }
+    else{
+        for (size_t n = 0; n < _work.size(); n++) _work[n] = frame[n]*_window[n];
+        _fft.transform(&_work.front());
+        add_power(&_work.front(), &_acc.front(), _acc.size());
+    }
+    _num_frames++;
+}
+
+void psd_estimator::get_average(std::vector<float> &bins) const{
+    const size_t size = _acc.size();
+    bins.resize(size);
+    const double scale = 1.0/(std::max<size_t>(_num_frames, 1)*double(_full_scale));
+    //swap the halves of a transform so DC is in the middle
+    const size_t shift = _transformed? 0 : size - size/2;
+    for (size_t i = 0; i < size; i++){
+        const double power = _acc[(i + shift) % size]*scale;
+        bins[i] = float(10*std::log10(std::max<double>(power, PSD_MIN_POWER)));
+    }
+}
+
+void psd_estimator::reset(void){
+    std::fill(_acc.begin(), _acc.end(), 0.0f);
+    _num_frames = 0;
+}
@@ -0,0 +1,79 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_PSD_ESTIMATOR_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_PSD_ESTIMATOR_HPP
+
+#include "complex_fft.hpp"
+#include <uhd/config.hpp>
+#include <complex>
+#include <vector>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * An averaged power spectrum of frames of complex samples.
+ *
+ * Each frame is multiplied by a Hann window, transformed, and its power
+ * per bin is added up. The average is scaled so a full scale tone on a
+ * bin reads 0 dBFS, and DC is at bin size/2.
+ *
+ * For frames which already are spectra, e.g. from an FFT block in the
+ * FPGA, the window and the transform are skipped: the power of each bin
+ * is averaged as it comes, in its order, 0 dBFS being a magnitude of 1.
+ */
+class UHD_API psd_estimator{
+public:
+    /*!
+     * Make an estimator.
+     * \param size the number of samples per frame and bins, at least 1
+     * \param transformed true when the frames already are spectra
+     */
+    psd_estimator(const size_t size, const bool transformed);
+
+    size_t size(void) const{
+        return _acc.size();
+    }
+
+    //! Add a frame of size() samples into the average
+    void add_frame(const std::complex<float> *frame);
+
+    //! Get the number of frames in the average
+    size_t get_num_frames(void) const{
+        return _num_frames;
+    }
+
+    //! Get the average power of each bin in dBFS, resized to size()
+    void get_average(std::vector<float> &bins) const;
+
+    //! Clear the average
+    void reset(void);
+
+private:
+    const bool _transformed;
+    complex_fft _fft;
+    std::vector<float> _window;
+    //! the power of a full scale tone in the sum of one frame
+    float _full_scale;
+    std::vector<std::complex<float> > _work;
+    std::vector<float> _acc;
+    size_t _num_frames;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_PSD_ESTIMATOR_HPP */
@@ -0,0 +1,187 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "rational_resampler.hpp"
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RESAMPLER_USE_SSE2
+#endif
+
+using namespace uhd;
+using namespace uhd::transport;
+
+//! The fraction of the lower Nyquist band the filter passes
+static const double PASSBAND_FRACTION = 0.9;
+
+//! The relative precision to match a rate ratio with
+static const double RATIO_PRECISION = 1e-12;
+
+static const double PI = 3.14159265358979323846;
+
+double rational_resampler::get_factors(
+    const double in_rate, const double out_rate, const size_t max_factor,
+    size_t &interp, size_t &decim
+){
+    if (not (in_rate > 0.0) or not (out_rate > 0.0) or not boost::math::isfinite(out_rate/in_rate)){
+        throw uhd::value_error("rational_resampler: the rates must be positive");
+    }
+    //the best convergent of the continued fraction of the ratio within the limit
+    const double ratio = out_rate/in_rate;
+    double h0 = 0, h1 = 1, k0 = 1, k1 = 0;
+    double x = ratio;
+    interp = decim = 0;
+    for (size_t i = 0; i < 64; i++){
+        const double a = std::floor(x);
+        const double h2 = a*h1 + h0, k2 = a*k1 + k0;
+        if (h2 > max_factor or k2 > max_factor) break;
+        interp = size_t(h2);
+        decim = size_t(k2);
+        if (std::abs(h2/k2 - ratio) <= RATIO_PRECISION*ratio) break;
+        const double frac = x - a;
+        if (frac <= 0.0) break;
+        x = 1.0/frac;
+        h0 = h1; h1 = h2;
+        k0 = k1; k1 = k2;
+    }
+    if (interp == 0 or decim == 0){
+        throw uhd::value_error(str(boost::format(
+            "rational_resampler: cannot resample from %f to %f Sps with factors up to %u")
+            % in_rate % out_rate % max_factor
+        ));
+    }
+    return in_rate*interp/decim;
+}
+
+rational_resampler::rational_resampler(
+    const size_t interp, const size_t decim, const size_t taps_per_phase
+):
+    _interp(interp), _decim(decim), _taps_per_phase(taps_per_phase),
+    _pos(0), _phase(0)
+{
+    if (_interp == 0 or _decim == 0 or _taps_per_phase == 0){
+        throw uhd::value_error("rational_resampler: the factors and the taps per phase must be positive");
+    }
+
+    //the prototype filter runs at the interpolated rate
+    const size_t num_taps = _taps_per_phase*_interp;
+    const double cutoff = PASSBAND_FRACTION*0.5/std::max(_interp, _decim);
+    const double center = (num_taps - 1)/2.0;
+    std::vector<double> proto(num_taps);
+    double sum = 0.0;
+    for (size_t n = 0; n < num_taps; n++){
+        const double t = n - center;
+        const double sinc = (t == 0.0)? 2*cutoff : std::sin(2*PI*cutoff*t)/(PI*t);
+        const double phase = (num_taps == 1)? 0.0 : 2*PI*n/(num_taps - 1);
+        const double window = 0.42 - 0.5*std::cos(phase) + 0.08*std::cos(2*phase);
+        proto[n] = sinc*window;
+        sum += proto[n];
+    }
+
+    //a gain of L makes up for the zeros of the interpolation
+    _taps.resize(2*num_taps);
+    for (size_t p = 0; p < _interp; p++){
+        float *branch = &_taps[2*p*_taps_per_phase];
+        for (size_t k = 0; k < _taps_per_phase; k++){
+            const float tap = float(proto[p + k*_interp]*_interp/sum);
+            branch[2*(_taps_per_phase - 1 - k) + 0] = tap;
+            branch[2*(_taps_per_phase - 1 - k) + 1] = tap;
+        }
+    }
+    this->reset();
+}
+
+double rational_resampler::get_delay(void) const{
+    return (_taps_per_phase*_interp - 1)/(2.0*_interp);
+}
+
+size_t rational_resampler::get_num_outputs(const size_t num_inputs) const{
+    if (num_inputs <= _pos) return 0;
+    //outputs n while _pos + (_phase + n*M)/L < num_inputs
+    const size_t limit = (num_inputs - _pos)*_interp - _phase;
+    return (limit + _decim - 1)/_decim;
+}
+
+size_t rational_resampler::get_num_inputs(const size_t num_outputs) const{
+    if (num_outputs == 0) return 0;
+    return _pos + (_phase + (num_outputs - 1)*_decim)/_interp + 1;
+}
+
+/*!
+ * The dot product of a branch with the inputs.
+ * The taps are doubled up, so that both are a plain array of floats.
+ */
+static UHD_INLINE std::complex<float> dot_product(
+    const float *taps, const float *in, const size_t num_floats
+){
+    size_t i = 0;
+    float re = 0.0f, im = 0.0f;
+#ifdef RESAMPLER_USE_SSE2
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    for (; i + 8 <= num_floats; i += 8){
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(taps + i + 0), _mm_loadu_ps(in + i + 0)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(taps + i + 4), _mm_loadu_ps(in + i + 4)));
+    }
+    //lanes are I, Q, I, Q
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    re = lanes[0] + lanes[2];
+    im = lanes[1] + lanes[3];
+#endif
+    for (; i < num_floats; i += 2){
+        re += taps[i + 0]*in[i + 0];
+        im += taps[i + 1]*in[i + 1];
+    }
+    return std::complex<float>(re, im);
+}
+
+size_t rational_resampler::process(
+    const std::complex<float> *in, const size_t num_inputs, std::complex<float> *out
+){
+    if (num_inputs == 0) return 0;
+    const size_t history = _taps_per_phase - 1;
+    _work.resize(history + num_inputs);
+    std::copy(in, in + num_inputs, _work.begin() + history);
+
+    //output n is the branch of its phase over the inputs up to its position
+    const float *work = reinterpret_cast<const float *>(&_work.front());
+    size_t num_outputs = 0;
+    while (_pos < num_inputs){
+        out[num_outputs++] = dot_product(
+            &_taps[2*_phase*_taps_per_phase], work + 2*_pos, 2*_taps_per_phase
+        );
+        _phase += _decim;
+        _pos += _phase/_interp;
+        _phase %= _interp;
+    }
+    _pos -= num_inputs;
+
+    //keep the last inputs for the next block
+    std::copy(_work.end() - history, _work.end(), _work.begin());
+    _work.resize(history);
+    return num_outputs;
+}
+
+void rational_resampler::reset(void){
+    _work.assign(_taps_per_phase - 1, std::complex<float>(0.0f, 0.0f));
+    _pos = 0;
+    _phase = 0;
+}
@@ -0,0 +1,111 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_RATIONAL_RESAMPLER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_RATIONAL_RESAMPLER_HPP
+
+#include <uhd/config.hpp>
+#include <boost/utility.hpp>
+#include <complex>
+#include <vector>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * A polyphase rational resampler for complex float samples.
+ *
+ * Interpolates by L and decimates by M in one pass: each output sample
+ * is the dot product of one of L filter branches with the last inputs.
+ * The prototype filter is a Blackman windowed sinc that passes 90% of
+ * the lower of the two Nyquist bands.
+ *
+ * The resampler keeps its history between calls, so a stream can be
+ * processed in blocks of any size.
+ */
+class UHD_API rational_resampler : boost::noncopyable{
+public:
+    /*!
+     * Find the resampling factors for a rate change.
+     * \param in_rate the input rate
+     * \param out_rate the requested output rate
+     * \param max_factor the largest L and M to use
+     * \param interp the interpolation L
+     * \param decim the decimation M
+     * \return the output rate of the factors, the closest one to out_rate
+     */
+    static double get_factors(
+        const double in_rate, const double out_rate, const size_t max_factor,
+        size_t &interp, size_t &decim
+    );
+
+    /*!
+     * Make a resampler.
+     * \param interp the interpolation L
+     * \param decim the decimation M
+     * \param taps_per_phase the length of each filter branch
+     */
+    rational_resampler(const size_t interp, const size_t decim, const size_t taps_per_phase);
+
+    size_t get_interp(void) const{
+        return _interp;
+    }
+
+    size_t get_decim(void) const{
+        return _decim;
+    }
+
+    //! Get the delay of the filter in input samples
+    double get_delay(void) const;
+
+    //! Get the number of outputs the next num_inputs inputs produce
+    size_t get_num_outputs(const size_t num_inputs) const;
+
+    //! Get the number of inputs the next num_outputs outputs need
+    size_t get_num_inputs(const size_t num_outputs) const;
+
+    //! Get the length of each filter branch
+    size_t get_taps_per_phase(void) const{
+        return _taps_per_phase;
+    }
+
+    /*!
+     * Resample a block of inputs.
+     * \param in the inputs
+     * \param num_inputs the number of inputs, all are consumed
+     * \param out the outputs, room for get_num_outputs(num_inputs)
+     * \return the number of outputs
+     */
+    size_t process(const std::complex<float> *in, const size_t num_inputs, std::complex<float> *out);
+
+    //! Clear the history, the next input starts a new stream
+    void reset(void);
+
+private:
+    const size_t _interp, _decim, _taps_per_phase;
+    //! per branch: the taps in reverse order, each twice for the I and Q of an input
+    std::vector<float> _taps;
+    //! the last taps_per_phase-1 inputs, followed by the current block
+    std::vector<std::complex<float> > _work;
+    //! the input of the next output, relative to the next block
+    size_t _pos;
+    //! the branch of the next output
+    size_t _phase;
+};
+
+}} //namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_RATIONAL_RESAMPLER_HPP */
@@ -0,0 +1,184 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/transport/shared_frame_pool.hpp>
+#include <uhd/transport/buffer_pool.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/log.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/format.hpp>
+#include <map>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::transport;
+
+shared_frame_pool::~shared_frame_pool(void){
+    /* NOP */
+}
+
+shared_frame_pool::client::~client(void){
+    /* NOP */
+}
+
+/***********************************************************************
+ * Frame pool implementation
+ **********************************************************************/
+class shared_frame_pool_impl :
+    public shared_frame_pool,
+    public boost::enable_shared_from_this<shared_frame_pool_impl>
+{
+public:
+    shared_frame_pool_impl(const size_t num_frames, const size_t frame_size, const device_addr_t &hints):
+        _slab(buffer_pool::make(num_frames, frame_size, 16, hints)),
+        _frame_size(frame_size)
+    {
+        //the free list is a stack, the last freed frame is the next one out
+        _free.reserve(num_frames);
+        for (size_t i = num_frames; i > 0; i--) _free.push_back(_slab->at(i-1));
+    }
+
+    client::sptr make_client(const size_t quota);
+
+    size_t get_frame_size(void) const{
+        return _frame_size;
+    }
+
+    size_t get_num_frames(void) const{
+        return _slab->size();
+    }
+
+    size_t get_num_free(void) const{
+        boost::mutex::scoped_lock lock(_mutex);
+        return _free.size();
+    }
+
+    void *alloc(size_t &num_held, const size_t quota, const double timeout){
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_free.empty() or num_held >= quota){
+            if (timeout <= 0.0) return NULL;
+            const boost::system_time exit_time = boost::get_system_time() +
+                boost::posix_time::microseconds(long(timeout*1e6));
+            while (_free.empty() or num_held >= quota){
+                if (not _cond.timed_wait(lock, exit_time)) return NULL;
+            }
+        }
+        void *frame = _free.back();
+        _free.pop_back();
+        num_held++;
+        return frame;
+    }
+
+    void free(size_t &num_held, void *frame){
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            _free.push_back(frame);
+            num_held--;
+        }
+        _cond.notify_all();
+    }
+
+    size_t get_num_held(const size_t &num_held) const{
+        boost::mutex::scoped_lock lock(_mutex);
+        return num_held;
+    }
+
+private:
+    buffer_pool::sptr _slab;
+    const size_t _frame_size;
+    std::vector<void *> _free;
+    mutable boost::mutex _mutex;
+    boost::condition_variable _cond;
+};
+
+/***********************************************************************
+ * Client implementation
+ **********************************************************************/
+class shared_frame_pool_client_impl : public shared_frame_pool::client{
+public:
+    shared_frame_pool_client_impl(boost::shared_ptr<shared_frame_pool_impl> pool, const size_t quota):
+        _pool(pool), _quota(quota), _num_held(0)
+    {
+        /* NOP */
+    }
+
+    ~shared_frame_pool_client_impl(void){
+        if (_num_held != 0) UHD_LOG << boost::format(
+            "shared_frame_pool: client released with %u frames held") % _num_held << std::endl;
+    }
+
+    void *alloc(const double timeout){
+        return _pool->alloc(_num_held, _quota, timeout);
+    }
+
+    void free(void *frame){
+        _pool->free(_num_held, frame);
+    }
+
+    size_t get_num_held(void) const{
+        return _pool->get_num_held(_num_held);
+    }
+
+    size_t get_quota(void) const{
+        return _quota;
+    }
+
+private:
+    boost::shared_ptr<shared_frame_pool_impl> _pool;
+    const size_t _quota;
+    size_t _num_held; //guarded by the mutex of the pool
+};
+
+shared_frame_pool::client::sptr shared_frame_pool_impl::make_client(const size_t quota){
+    if (quota == 0) throw uhd::value_error("shared_frame_pool: the quota of a client must be positive");
+    return client::sptr(new shared_frame_pool_client_impl(shared_from_this(), quota));
+}
+
+/***********************************************************************
+ * The factory functions
+ **********************************************************************/
+shared_frame_pool::sptr shared_frame_pool::make(
+    const size_t num_frames,
+    const size_t frame_size,
+    const device_addr_t &hints
+){
+    if (num_frames == 0 or frame_size == 0) throw uhd::value_error(
+        "shared_frame_pool: the number and size of the frames must be positive");
+    return sptr(new shared_frame_pool_impl(num_frames, frame_size, hints));
+}
+
+shared_frame_pool::sptr shared_frame_pool::get_shared(
+    const size_t num_frames,
+    const size_t frame_size,
+    const device_addr_t &hints
+){
+    static boost::mutex mutex;
+    static std::map<size_t, boost::weak_ptr<shared_frame_pool> > pools;
+    boost::mutex::scoped_lock lock(mutex);
+
+    sptr pool = pools[frame_size].lock();
+    if (pool) return pool;
+    pool = make(num_frames, frame_size, hints);
+    pools[frame_size] = pool;
+    UHD_LOG << boost::format(
+        "shared_frame_pool: made a pool of %u frames of %u bytes") % num_frames % frame_size << std::endl;
+    return pool;
+}
@@ -0,0 +1,439 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/transport/shmem_sample_ring.hpp>
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstring>
+#include <new>
+
+using namespace uhd;
+using namespace uhd::transport;
+namespace ip = boost::interprocess;
+
+//! The timeout in seconds of one round of the publisher thread, bounds the shutdown time
+static const double PUBLISH_TIMEOUT = 0.1;
+
+//! How long a subscriber sleeps between looks at the ring
+static const long SUBSCRIBE_POLL_US = 50;
+
+static const size_t DEFAULT_NUM_BLOCKS = 64;
+
+static const uint32_t SHMEM_RING_MAGIC = 0x55524e47; //"URNG"
+static const uint32_t SHMEM_RING_VERSION = 1;
+
+//! The parts of the ring are cache line aligned
+static const size_t SHMEM_RING_ALIGN = 64;
+
+static size_t align_up(const size_t n){
+    return (n + SHMEM_RING_ALIGN - 1) & ~(SHMEM_RING_ALIGN - 1);
+}
+
+shmem_sample_publisher::~shmem_sample_publisher(void){
+    /* NOP */
+}
+
+shmem_sample_subscriber::~shmem_sample_subscriber(void){
+    /* NOP */
+}
+
+/***********************************************************************
+ * The layout of the ring: the header, the slots, then the samples
+ **********************************************************************/
+namespace{
+
+    struct ring_header_t{
+        boost::atomic<uint32_t> magic; //written last, when the ring is ready
+        uint32_t version;
+        uint32_t num_chans;
+        uint32_t bytes_per_item;
+        uint64_t block_size;
+        uint64_t num_blocks;
+        uint64_t chan_bytes; //bytes between the channels of a block
+        char cpu_format[32];
+        boost::atomic<uint64_t> num_published;
+        boost::atomic<uint32_t> closed;
+    };
+
+    static const uint32_t SLOT_HAS_TIME_SPEC      = 1 << 0;
+    static const uint32_t SLOT_MORE_FRAGMENTS     = 1 << 1;
+    static const uint32_t SLOT_START_OF_BURST     = 1 << 2;
+    static const uint32_t SLOT_END_OF_BURST       = 1 << 3;
+    static const uint32_t SLOT_OUT_OF_SEQUENCE    = 1 << 4;
+    static const uint32_t SLOT_HAS_HOST_TIME_SPEC = 1 << 5;
+
+    /*!
+     * The metadata of a block, guarded by a sequence lock:
+     * the publisher sets seq to 2n+1 while it writes block n into the slot
+     * and to 2n+2 when the block is complete.
+     */
+    struct ring_slot_t{
+        boost::atomic<uint64_t> seq;
+        uint64_t nsamps;
+        int64_t full_secs;
+        double frac_secs;
+        int64_t host_full_secs;
+        double host_frac_secs;
+        uint64_t fragment_offset;
+        uint64_t num_dropped_samps;
+        uint32_t error_code;
+        uint32_t flags;
+    };
+
+    struct ring_layout_t{
+        ring_layout_t(const size_t num_chans, const size_t chan_bytes, const size_t num_blocks){
+            slots_offset = align_up(sizeof(ring_header_t));
+            data_offset = align_up(slots_offset + num_blocks*sizeof(ring_slot_t));
+            total_size = data_offset + num_blocks*num_chans*chan_bytes;
+        }
+        size_t slots_offset;
+        size_t data_offset;
+        size_t total_size;
+    };
+
+} //namespace anonymous
+
+/***********************************************************************
+ * The publisher implementation
+ **********************************************************************/
+class shmem_sample_publisher_impl : public shmem_sample_publisher{
+public:
+    shmem_sample_publisher_impl(
+        rx_streamer::sptr rx_stream,
+        const stream_args_t &stream_args,
+        const device_addr_t &publish_args
+    ):
+        _rx_stream(rx_stream),
+        _name(publish_args.get("name", "")),
+        _num_chans(rx_stream->get_num_channels()),
+        _block_size(publish_args.cast<size_t>("block_size", rx_stream->get_max_num_samps())),
+        _num_blocks(publish_args.cast<size_t>("num_blocks", DEFAULT_NUM_BLOCKS)),
+        _has_priority(publish_args.has_key("priority")),
+        _priority(publish_args.cast<float>("priority", default_thread_priority)),
+        _slot_open(false),
+        _thread_setup_done(false)
+    {
+        if (_name.empty()) throw uhd::value_error("shmem_sample_publisher: name is required");
+        if (_block_size == 0) throw uhd::value_error("shmem_sample_publisher: block_size must be positive");
+        if (_num_blocks < 2) throw uhd::value_error("shmem_sample_publisher: num_blocks must be at least 2");
+        if (stream_args.cpu_format.size() >= sizeof(((ring_header_t *)NULL)->cpu_format)){
+            throw uhd::value_error("shmem_sample_publisher: unsupported CPU format " + stream_args.cpu_format);
+        }
+        if (not boost::atomic<uint64_t>().is_lock_free()){
+            throw uhd::not_implemented_error("shmem_sample_publisher: 64-bit atomics are not lock free on this platform");
+        }
+        if (publish_args.has_key("cpus")){
+            std::vector<std::string> toks;
+            const std::string cpu_list = boost::algorithm::trim_copy(publish_args["cpus"]);
+            boost::split(toks, cpu_list, boost::is_any_of(" "), boost::token_compress_on);
+            BOOST_FOREACH(const std::string &tok, toks){
+                if (not tok.empty()) _cpus.push_back(boost::lexical_cast<size_t>(tok));
+            }
+        }
+
+        const size_t bytes_per_item = convert::get_bytes_per_item(stream_args.cpu_format);
+        const size_t chan_bytes = align_up(_block_size*bytes_per_item);
+        const ring_layout_t layout(_num_chans, chan_bytes, _num_blocks);
+        try{
+            ip::shared_memory_object::remove(_name.c_str());
+            ip::shared_memory_object shm(ip::create_only, _name.c_str(), ip::read_write);
+            shm.truncate(ip::offset_t(layout.total_size));
+            _region = ip::mapped_region(shm, ip::read_write);
+        }
+        catch(const ip::interprocess_exception &ex){
+            throw uhd::io_error(str(boost::format("shmem_sample_publisher: cannot create %s: %s") % _name % ex.what()));
+        }
+
+        char *mem = static_cast<char *>(_region.get_address());
+        _header = new (mem) ring_header_t();
+        _header->version = SHMEM_RING_VERSION;
+        _header->num_chans = uint32_t(_num_chans);
+        _header->bytes_per_item = uint32_t(bytes_per_item);
+        _header->block_size = _block_size;
+        _header->num_blocks = _num_blocks;
+        _header->chan_bytes = chan_bytes;
+        std::memset(_header->cpu_format, 0, sizeof(_header->cpu_format));
+        std::strcpy(_header->cpu_format, stream_args.cpu_format.c_str());
+        _header->num_published.store(0, boost::memory_order_relaxed);
+        _header->closed.store(0, boost::memory_order_relaxed);
+
+        _slots = reinterpret_cast<ring_slot_t *>(mem + layout.slots_offset);
+        for (size_t i = 0; i < _num_blocks; i++){
+            new (&_slots[i]) ring_slot_t();
+            _slots[i].seq.store(0, boost::memory_order_relaxed);
+        }
+        _buffs.resize(_num_chans);
+        _data = mem + layout.data_offset;
+        _chan_bytes = chan_bytes;
+        _header->magic.store(SHMEM_RING_MAGIC, boost::memory_order_release);
+
+        _task = task::make(boost::bind(&shmem_sample_publisher_impl::publish_one_block, this), "shmem_publish");
+    }
+
+    ~shmem_sample_publisher_impl(void){
+        _task.reset();
+        _header->closed.store(1, boost::memory_order_release);
+        ip::shared_memory_object::remove(_name.c_str());
+    }
+
+    std::string get_name(void) const{
+        return _name;
+    }
+
+    uint64_t get_num_blocks(void) const{
+        return _header->num_published.load(boost::memory_order_relaxed);
+    }
+
+private:
+    /*!
+     * One round of the task:
+     * Receive the next block straight into its slot and publish it.
+     * A timeout without samples keeps the slot for the next round.
+     */
+    void publish_one_block(void){
+        if (not _thread_setup_done){
+            if (_has_priority) set_thread_priority_safe(_priority);
+            set_thread_affinity(_cpus);
+            _thread_setup_done = true;
+        }
+
+        const uint64_t n = _header->num_published.load(boost::memory_order_relaxed);
+        const size_t index = size_t(n % _num_blocks);
+        ring_slot_t &slot = _slots[index];
+        if (not _slot_open){
+            slot.seq.store(2*n + 1, boost::memory_order_relaxed);
+            boost::atomic_thread_fence(boost::memory_order_release);
+            _slot_open = true;
+        }
+
+        for (size_t ch = 0; ch < _num_chans; ch++){
+            _buffs[ch] = _data + (index*_num_chans + ch)*_chan_bytes;
+        }
+        rx_metadata_t md;
+        const size_t nsamps = _rx_stream->recv(_buffs, _block_size, md, PUBLISH_TIMEOUT);
+        if (nsamps == 0 and md.error_code == rx_metadata_t::ERROR_CODE_TIMEOUT) return;
+
+        slot.nsamps = nsamps;
+        slot.full_secs = int64_t(md.time_spec.get_full_secs());
+        slot.frac_secs = md.time_spec.get_frac_secs();
+        slot.host_full_secs = int64_t(md.host_time_spec.get_full_secs());
+        slot.host_frac_secs = md.host_time_spec.get_frac_secs();
+        slot.fragment_offset = md.fragment_offset;
+        slot.num_dropped_samps = md.num_dropped_samps;
+        slot.error_code = uint32_t(md.error_code);
+        slot.flags = (md.has_time_spec? SLOT_HAS_TIME_SPEC : 0)
+            | (md.more_fragments? SLOT_MORE_FRAGMENTS : 0)
+            | (md.start_of_burst? SLOT_START_OF_BURST : 0)
+            | (md.end_of_burst? SLOT_END_OF_BURST : 0)
+            | (md.out_of_sequence? SLOT_OUT_OF_SEQUENCE : 0)
+            | (md.has_host_time_spec? SLOT_HAS_HOST_TIME_SPEC : 0);
+        slot.seq.store(2*n + 2, boost::memory_order_release);
+        _header->num_published.store(n + 1, boost::memory_order_release);
+        _slot_open = false;
+    }
+
+    rx_streamer::sptr _rx_stream;
+    const std::string _name;
+    const size_t _num_chans;
+    const size_t _block_size;
+    const size_t _num_blocks;
+    const bool _has_priority;
+    const float _priority;
+    std::vector<size_t> _cpus;
+
+    ip::mapped_region _region;
+    ring_header_t *_header;
+    ring_slot_t *_slots;
+    char *_data;
+    size_t _chan_bytes;
+
+    //only used by the task
+    std::vector<void *> _buffs;
+    bool _slot_open;
+    bool _thread_setup_done;
+
+    task::sptr _task;
+};
+
+shmem_sample_publisher::sptr shmem_sample_publisher::make(
+    rx_streamer::sptr rx_stream,
+    const stream_args_t &stream_args,
+    const device_addr_t &publish_args
+){
+    return sptr(new shmem_sample_publisher_impl(rx_stream, stream_args, publish_args));
+}
+
+/***********************************************************************
+ * The subscriber implementation
+ **********************************************************************/
+class shmem_sample_subscriber_impl : public shmem_sample_subscriber{
+public:
+    shmem_sample_subscriber_impl(const std::string &name):
+        _num_overflows(0), _num_dropped_blocks(0)
+    {
+        try{
+            ip::shared_memory_object shm(ip::open_only, name.c_str(), ip::read_write);
+            _region = ip::mapped_region(shm, ip::read_write);
+        }
+        catch(const ip::interprocess_exception &ex){
+            throw uhd::io_error(str(boost::format("shmem_sample_subscriber: cannot open %s: %s") % name % ex.what()));
+        }
+
+        char *mem = static_cast<char *>(_region.get_address());
+        if (_region.get_size() < sizeof(ring_header_t)){
+            throw uhd::value_error("shmem_sample_subscriber: not a sample ring " + name);
+        }
+        _header = reinterpret_cast<ring_header_t *>(mem);
+        if (_header->magic.load(boost::memory_order_acquire) != SHMEM_RING_MAGIC){
+            throw uhd::value_error("shmem_sample_subscriber: not a sample ring " + name);
+        }
+        if (_header->version != SHMEM_RING_VERSION){
+            throw uhd::value_error(str(boost::format("shmem_sample_subscriber: ring version %u, expected %u")
+                % _header->version % SHMEM_RING_VERSION));
+        }
+        _num_chans = _header->num_chans;
+        _num_blocks = size_t(_header->num_blocks);
+        _chan_bytes = size_t(_header->chan_bytes);
+        const ring_layout_t layout(_num_chans, _chan_bytes, _num_blocks);
+        if (_region.get_size() < layout.total_size){
+            throw uhd::value_error("shmem_sample_subscriber: truncated sample ring " + name);
+        }
+        _slots = reinterpret_cast<const ring_slot_t *>(mem + layout.slots_offset);
+        _data = mem + layout.data_offset;
+        _cursor = _header->num_published.load(boost::memory_order_acquire);
+    }
+
+    size_t get_num_channels(void) const{
+        return _num_chans;
+    }
+
+    std::string get_cpu_format(void) const{
+        return std::string(_header->cpu_format);
+    }
+
+    size_t get_block_size(void) const{
+        return size_t(_header->block_size);
+    }
+
+    size_t get_num_blocks(void) const{
+        return _num_blocks;
+    }
+
+    bool get_block(block_t &block, const double timeout){
+        const boost::system_time exit_time = boost::get_system_time() +
+            boost::posix_time::microseconds(long(timeout*1e6));
+        uint64_t published = _header->num_published.load(boost::memory_order_acquire);
+        while (published == _cursor){
+            if (_header->closed.load(boost::memory_order_acquire) != 0) return false;
+            if (boost::get_system_time() >= exit_time) return false;
+            boost::this_thread::sleep(boost::posix_time::microseconds(SUBSCRIBE_POLL_US));
+            published = _header->num_published.load(boost::memory_order_acquire);
+        }
+
+        //the slot of the cursor is gone once the publisher has wrapped around to it
+        if (published - _cursor >= _num_blocks) return overflow(block, published);
+
+        const size_t index = size_t(_cursor % _num_blocks);
+        const ring_slot_t &slot = _slots[index];
+        const uint64_t seq = slot.seq.load(boost::memory_order_acquire);
+        if (seq != 2*_cursor + 2) return overflow(block, published);
+
+        rx_metadata_t &md = block.metadata;
+        md.reset();
+        block.nsamps = size_t(slot.nsamps);
+        md.time_spec = time_spec_t(time_t(slot.full_secs), slot.frac_secs);
+        md.host_time_spec = time_spec_t(time_t(slot.host_full_secs), slot.host_frac_secs);
+        md.fragment_offset = size_t(slot.fragment_offset);
+        md.num_dropped_samps = size_t(slot.num_dropped_samps);
+        md.error_code = rx_metadata_t::error_code_t(slot.error_code);
+        const uint32_t flags = slot.flags;
+        md.has_time_spec = (flags & SLOT_HAS_TIME_SPEC) != 0;
+        md.more_fragments = (flags & SLOT_MORE_FRAGMENTS) != 0;
+        md.start_of_burst = (flags & SLOT_START_OF_BURST) != 0;
+        md.end_of_burst = (flags & SLOT_END_OF_BURST) != 0;
+        md.out_of_sequence = (flags & SLOT_OUT_OF_SEQUENCE) != 0;
+        md.has_host_time_spec = (flags & SLOT_HAS_HOST_TIME_SPEC) != 0;
+        boost::atomic_thread_fence(boost::memory_order_acquire);
+        if (slot.seq.load(boost::memory_order_relaxed) != seq) return overflow(block, published);
+
+        block.buffs.resize(_num_chans);
+        for (size_t ch = 0; ch < _num_chans; ch++){
+            block.buffs[ch] = _data + (index*_num_chans + ch)*_chan_bytes;
+        }
+        block.index = _cursor++;
+        return true;
+    }
+
+    bool is_valid(const block_t &block) const{
+        boost::atomic_thread_fence(boost::memory_order_acquire);
+        const size_t index = size_t(block.index % _num_blocks);
+        return _slots[index].seq.load(boost::memory_order_relaxed) == 2*block.index + 2;
+    }
+
+    bool is_closed(void) const{
+        return _header->closed.load(boost::memory_order_acquire) != 0;
+    }
+
+    uint64_t get_num_overflows(void) const{
+        return _num_overflows;
+    }
+
+    uint64_t get_num_dropped_blocks(void) const{
+        return _num_dropped_blocks;
+    }
+
+private:
+    //! Move the cursor to the newest block and report the skipped blocks
+    bool overflow(block_t &block, const uint64_t published){
+        _num_overflows++;
+        _num_dropped_blocks += published - _cursor;
+        block.buffs.assign(_num_chans, NULL);
+        block.nsamps = 0;
+        block.metadata.reset();
+        block.metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
+        block.index = _cursor;
+        _cursor = published;
+        return true;
+    }
+
+    ip::mapped_region _region;
+    ring_header_t *_header;
+    const ring_slot_t *_slots;
+    const char *_data;
+    size_t _num_chans;
+    size_t _num_blocks;
+    size_t _chan_bytes;
+
+    uint64_t _cursor;
+    uint64_t _num_overflows;
+    uint64_t _num_dropped_blocks;
+};
+
+shmem_sample_subscriber::sptr shmem_sample_subscriber::make(const std::string &name){
+    return sptr(new shmem_sample_subscriber_impl(name));
+}
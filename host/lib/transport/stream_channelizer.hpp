@@ -0,0 +1,181 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_STREAM_CHANNELIZER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_STREAM_CHANNELIZER_HPP
+
+#include "pfb_channelizer.hpp"
+#include <uhd/config.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+namespace uhd{ namespace transport{ namespace sph{
+
+/*!
+ * The host side channelizer stage of a receive streamer.
+ *
+ * The stream args select it:
+ * - channelize: the number of channels M to split each device channel
+ *   into, needs the fc32 CPU format
+ * - channelizer_taps: the taps per filter branch, defaults to 16
+ *
+ * Every device channel becomes M channels at 1/M of the sample rate,
+ * see pfb_channelizer. recv() takes M buffers per device channel, the
+ * channels of device channel i at buffers i*M to i*M + M-1.
+ *
+ * The wideband samples are converted in blocks of at most
+ * MAX_INPUTS_PER_CALL, which stay in the cache until the filter bank
+ * reads them, so they never go out to memory.
+ * The time specs are corrected for the filter delay.
+ */
+class stream_channelizer{
+public:
+    static const size_t DEFAULT_TAPS_PER_BRANCH = 16;
+    static const size_t MAX_INPUTS_PER_CALL = 16384;
+
+    //! Make a disabled channelizer stage
+    stream_channelizer(void):
+        _num_bands(0), _taps_per_branch(DEFAULT_TAPS_PER_BRANCH),
+        _samp_rate(0.0), _num_chans(0), _time_valid(false), _num_outputs(0)
+    {
+        /* NOP */
+    }
+
+    //! Configure from the stream args, throws on a CPU format other than fc32
+    void set_args(const uhd::device_addr_t &args, const std::string &cpu_format){
+        _num_bands = args.cast<size_t>("channelize", 0);
+        _taps_per_branch = args.cast<size_t>("channelizer_taps", size_t(DEFAULT_TAPS_PER_BRANCH));
+        if (_num_bands > 1 and cpu_format != "fc32"){
+            throw uhd::value_error("The channelize stream arg needs the fc32 CPU format, not " + cpu_format);
+        }
+        this->update();
+    }
+
+    //! Set the sample rate of the device side
+    void set_samp_rate(const double rate){
+        _samp_rate = rate;
+        _time_valid = false;
+    }
+
+    //! Set the number of device channels
+    void set_num_chans(const size_t num_chans){
+        _num_chans = num_chans;
+        this->update();
+    }
+
+    //! True when the device channels are split
+    UHD_INLINE bool enabled(void) const{
+        return not _channelizers.empty();
+    }
+
+    //! Get the number of host channels per device channel, 1 when disabled
+    UHD_INLINE size_t get_num_bands(void) const{
+        return this->enabled()? _num_bands : 1;
+    }
+
+    //! Get the number of inputs to receive for the outputs of one call
+    UHD_INLINE size_t get_num_inputs(const size_t num_outputs) const{
+        return std::min(_channelizers.front()->get_num_inputs(num_outputs),
+            std::max<size_t>(size_t(MAX_INPUTS_PER_CALL), _num_bands));
+    }
+
+    //! Get buffers of complex floats for each device channel, to receive into
+    const std::vector<void *> &get_buffs(const size_t nsamps){
+        for (size_t i = 0; i < _buffs.size(); i++){
+            if (_buffs[i].size() < nsamps) _buffs[i].resize(nsamps);
+            _buff_ptrs[i] = &_buffs[i].front();
+        }
+        return _buff_ptrs;
+    }
+
+    /*!
+     * Channelize the inputs of a device channel into the user buffers.
+     * \return the number of outputs per host channel
+     */
+    size_t process(
+        const size_t chan, const std::complex<float> *in, const size_t num_inputs,
+        const uhd::rx_streamer::buffs_type &buffs
+    ){
+        for (size_t k = 0; k < _num_bands; k++){
+            _out_ptrs[k] = reinterpret_cast<std::complex<float> *>(buffs[chan*_num_bands + k]);
+        }
+        return _channelizers[chan]->process(in, num_inputs, &_out_ptrs.front());
+    }
+
+    //! Start a new stream, the next samples are not related to the last
+    void reset(void){
+        for (size_t i = 0; i < _channelizers.size(); i++) _channelizers[i]->reset();
+        _time_valid = false;
+    }
+
+    //! Set the time of the first input since reset()
+    void set_time(const time_spec_t &input_time){
+        _time = input_time - time_spec_t(_channelizers.front()->get_delay()/_samp_rate);
+        _time_valid = true;
+        _num_outputs = 0;
+    }
+
+    UHD_INLINE bool has_time(void) const{
+        return _time_valid;
+    }
+
+    //! Get the time of the next output
+    UHD_INLINE time_spec_t get_time(void) const{
+        return _time + time_spec_t::from_ticks((long long)(_num_outputs), _samp_rate/_num_bands);
+    }
+
+    UHD_INLINE void add_outputs(const size_t num_outputs){
+        _num_outputs += num_outputs;
+    }
+
+private:
+    void update(void){
+        _channelizers.clear();
+        if (_num_bands <= 1 or _num_chans == 0) return;
+        for (size_t i = 0; i < _num_chans; i++){
+            _channelizers.push_back(boost::shared_ptr<pfb_channelizer>(
+                new pfb_channelizer(_num_bands, _taps_per_branch)
+            ));
+        }
+        _buffs.resize(_num_chans);
+        _buff_ptrs.resize(_num_chans);
+        _out_ptrs.resize(_num_bands);
+        _time_valid = false;
+    }
+
+    size_t _num_bands;
+    size_t _taps_per_branch;
+    double _samp_rate;
+    size_t _num_chans;
+    std::vector<boost::shared_ptr<pfb_channelizer> > _channelizers;
+    std::vector<std::vector<std::complex<float> > > _buffs;
+    std::vector<void *> _buff_ptrs;
+    std::vector<std::complex<float> *> _out_ptrs;
+    bool _time_valid;
+    time_spec_t _time;
+    uint64_t _num_outputs;
+};
+
+}}} //namespace uhd::transport::sph
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_STREAM_CHANNELIZER_HPP */
@@ -0,0 +1,54 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_STREAM_CPUS_ARG_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_STREAM_CPUS_ARG_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/foreach.hpp>
+#include <string>
+#include <vector>
+
+namespace uhd{ namespace transport{ namespace sph{
+
+/*!
+ * Get a space separated list of CPUs from the stream args,
+ * like the convert_cpus of the packet handlers.
+ * \param args the stream args
+ * \param key the key of the list
+ * \return the CPUs, empty when the key is not set
+ */
+UHD_INLINE std::vector<size_t> get_cpus_arg(
+    const uhd::device_addr_t &args, const std::string &key
+){
+    std::vector<size_t> cpus;
+    if (not args.has_key(key)) return cpus;
+    std::vector<std::string> toks;
+    const std::string cpu_list = boost::algorithm::trim_copy(args[key]);
+    boost::split(toks, cpu_list, boost::is_any_of(" "), boost::token_compress_on);
+    BOOST_FOREACH(const std::string &tok, toks){
+        if (not tok.empty()) cpus.push_back(boost::lexical_cast<size_t>(tok));
+    }
+    return cpus;
+}
+
+}}} //namespace uhd::transport::sph
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_STREAM_CPUS_ARG_HPP */
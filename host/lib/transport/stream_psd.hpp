@@ -0,0 +1,346 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_STREAM_PSD_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_STREAM_PSD_HPP
+
+#include "psd_estimator.hpp"
+#include <uhd/config.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+namespace uhd{ namespace transport{ namespace sph{
+
+/*!
+ * The spectrum monitor stage of a receive streamer.
+ *
+ * The stream args select it:
+ * - psd_size: the number of bins, enables the stage
+ * - psd_rate: the spectra per second, defaults to 10
+ * - psd_averages: the frames averaged per spectrum, defaults to 16
+ * - psd_input: "samples" (default), or "fft" when the samples already
+ *   are spectra of psd_size bins, e.g. from an FFT block in the FPGA
+ *
+ * capture() takes frames of psd_averages times psd_size samples once per
+ * spectrum from the buffers recv() returns, and copies them into a job
+ * for the worker thread, which averages them with a psd_estimator per
+ * channel. When the worker falls behind, frames are dropped instead of
+ * stalling recv(). Frames start on multiples of psd_size samples since
+ * the start of the stream, so they line up with the packets of an FFT
+ * block.
+ */
+class stream_psd : boost::noncopyable{
+public:
+    static const size_t DEFAULT_AVERAGES = 16;
+    static const size_t NUM_JOBS = 4;
+
+    //! Make a disabled spectrum monitor stage
+    stream_psd(void):
+        _size(0), _num_averages(DEFAULT_AVERAGES), _update_rate(10.0),
+        _transformed(false), _copy(NULL), _num_chans(0), _rate(0.0),
+        _free(NUM_JOBS), _filled(NUM_JOBS), _job(NULL), _fill(0), _skip(0),
+        _period_skip(0), _frames_left(DEFAULT_AVERAGES), _period(0),
+        _acc_period(0), _acc_has_time(false)
+    {
+        /* NOP */
+    }
+
+    ~stream_psd(void){
+        this->stop();
+    }
+
+    //! Configure from the stream args, throws on an unsupported CPU format
+    void set_args(const uhd::device_addr_t &args, const std::string &cpu_format){
+        this->stop();
+        _size = args.cast<size_t>("psd_size", 0);
+        _num_averages = std::max<size_t>(1, args.cast<size_t>("psd_averages", size_t(DEFAULT_AVERAGES)));
+        _update_rate = args.cast<double>("psd_rate", 10.0);
+        const std::string input = args.get("psd_input", "samples");
+        if (input != "samples" and input != "fft"){
+            throw uhd::value_error("The psd_input stream arg must be samples or fft, not " + input);
+        }
+        _transformed = (input == "fft");
+        if (_size == 0) return;
+        if (_update_rate <= 0.0){
+            throw uhd::value_error("The psd_rate stream arg must be positive");
+        }
+        if      (cpu_format == "fc32") _copy = &copy_samps<std::complex<float> >;
+        else if (cpu_format == "fc64") _copy = &copy_samps<std::complex<double> >;
+        else if (cpu_format == "sc16") _copy = &copy_samps<std::complex<boost::int16_t> >;
+        else if (cpu_format == "sc8")  _copy = &copy_samps<std::complex<boost::int8_t> >;
+        else throw uhd::value_error("The psd_size stream arg needs the fc32, fc64, sc16 or sc8 CPU format, not " + cpu_format);
+        this->update();
+    }
+
+    //! Set the number of host channels
+    void set_num_chans(const size_t num_chans){
+        if (num_chans == _num_chans) return;
+        this->stop();
+        _num_chans = num_chans;
+        this->update();
+    }
+
+    //! Set the rate of the host side samples
+    void set_rate(const double rate){
+        _rate = rate;
+        const double period = (rate > 0.0 and _size != 0)? rate/_update_rate : 0.0;
+        const double frames = period/std::max<size_t>(_size, 1);
+        //whole frames only, so the frames stay aligned to the stream
+        _period_skip = (frames > _num_averages)? size_t(frames - _num_averages)*_size : 0;
+    }
+
+    UHD_INLINE bool enabled(void) const{
+        return bool(_worker);
+    }
+
+    //! Drop the partial frame, the next samples are not related to the last
+    void reset(void){
+        //a held job is refilled from its start
+        _fill = 0;
+        _skip = 0;
+        _frames_left = _num_averages;
+        _period++;
+    }
+
+    /*!
+     * Take the frames due from the samples of a recv() call.
+     * \param buffs the user buffers, one per host channel
+     * \param nsamps the number of samples per buffer
+     * \param md the metadata of the call
+     */
+    void capture(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps,
+        const uhd::rx_metadata_t &md
+    ){
+        if (md.start_of_burst or (md.error_code != rx_metadata_t::ERROR_CODE_NONE and
+            md.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT)) this->reset();
+
+        size_t offset = 0;
+        while (offset < nsamps){
+            //between the frames of two spectra
+            if (_skip != 0){
+                const size_t n = std::min(_skip, nsamps - offset);
+                _skip -= n;
+                offset += n;
+                continue;
+            }
+
+            //start a frame, or drop it when the worker holds all jobs
+            if (_fill == 0){
+                if (_job == NULL and not _free.pop_with_haste(_job)){
+                    _skip = _size;
+                    this->end_frame();
+                    continue;
+                }
+                _job->period = _period;
+                _job->last = (_frames_left == 1);
+                _job->has_time = md.has_time_spec and _rate > 0.0;
+                _job->time = md.time_spec + time_spec_t::from_ticks((long long)(offset), _rate > 0.0? _rate : 1.0);
+            }
+
+            const size_t n = std::min(_size - _fill, nsamps - offset);
+            for (size_t ch = 0; ch < _num_chans; ch++){
+                _copy(buffs[ch], offset, n, &_job->frames[ch][_fill]);
+            }
+            _fill += n;
+            offset += n;
+
+            if (_fill == _size){
+                _filled.push_with_haste(_job); //there is room for every job
+                _job = NULL;
+                _fill = 0;
+                this->end_frame();
+            }
+        }
+
+        if (md.end_of_burst) this->reset();
+    }
+
+    //! Get the latest spectrum of a channel, see rx_streamer::get_psd()
+    bool get_psd(uhd::rx_streamer::psd_t &psd, const size_t chan, const double timeout){
+        if (not this->enabled()){
+            throw uhd::runtime_error("get_psd() needs the psd_size stream arg");
+        }
+        if (chan >= _num_chans){
+            throw uhd::index_error(str(boost::format("get_psd(): no channel %u") % chan));
+        }
+        const boost::system_time exit_time = boost::get_system_time() +
+            boost::posix_time::microseconds(long(timeout*1e6));
+        boost::mutex::scoped_lock lock(_mutex);
+        while (not _fresh[chan]){
+            if (not _fresh_cond.timed_wait(lock, exit_time)) return false;
+        }
+        _fresh[chan] = false;
+        psd = _results[chan];
+        return true;
+    }
+
+private:
+    struct job_type{
+        std::vector<std::vector<std::complex<float> > > frames;
+        boost::uint64_t period;
+        bool last;
+        bool has_time;
+        time_spec_t time;
+    };
+
+    typedef void (*copy_type)(const void *, const size_t, const size_t, std::complex<float> *);
+
+    //! Copy samples of a CPU format into complex floats of full scale 1
+    template <typename samp_type>
+    static void copy_samps(const void *buff, const size_t offset, const size_t n, std::complex<float> *out){
+        const samp_type *in = reinterpret_cast<const samp_type *>(buff) + offset;
+        const float scale = 1.0f/full_scale(samp_type());
+        for (size_t i = 0; i < n; i++){
+            out[i] = std::complex<float>(float(in[i].real())*scale, float(in[i].imag())*scale);
+        }
+    }
+    static float full_scale(const std::complex<float> &){return 1.0f;}
+    static float full_scale(const std::complex<double> &){return 1.0f;}
+    static float full_scale(const std::complex<boost::int16_t> &){return 32767.0f;}
+    static float full_scale(const std::complex<boost::int8_t> &){return 127.0f;}
+
+    //! Count a frame, taken or dropped, and skip to the next spectrum after the last
+    void end_frame(void){
+        if (--_frames_left != 0) return;
+        _frames_left = _num_averages;
+        _skip += _period_skip;
+        _period++;
+    }
+
+    void stop(void){
+        _worker.reset();
+    }
+
+    //! Build the jobs and estimators and start the worker
+    void update(void){
+        this->stop();
+        job_type *stale = NULL;
+        while (_free.pop_with_haste(stale)){}
+        while (_filled.pop_with_haste(stale)){}
+        _jobs.clear();
+        _estimators.clear();
+        _job = NULL;
+        this->reset();
+        if (_size == 0 or _num_chans == 0) return;
+
+        for (size_t i = 0; i < NUM_JOBS; i++){
+            boost::shared_ptr<job_type> job(new job_type());
+            job->frames.resize(_num_chans, std::vector<std::complex<float> >(_size));
+            _jobs.push_back(job);
+            _free.push_with_haste(job.get());
+        }
+        for (size_t ch = 0; ch < _num_chans; ch++){
+            _estimators.push_back(boost::shared_ptr<psd_estimator>(new psd_estimator(_size, _transformed)));
+        }
+        _results.assign(_num_chans, uhd::rx_streamer::psd_t());
+        _fresh.assign(_num_chans, false);
+        _acc_period = _period;
+        this->set_rate(_rate);
+        _worker = task::make(boost::bind(&stream_psd::worker_task, this), "rx_psd");
+    }
+
+    //! The loop body of the worker: average the frames of a job
+    void worker_task(void){
+        job_type *job = NULL;
+        if (not _filled.pop_with_timed_wait(job, 0.1)) return;
+
+        //frames of a new spectrum: publish what is left of the last one
+        if (job->period != _acc_period) this->publish();
+        _acc_period = job->period;
+        if (_estimators.front()->get_num_frames() == 0){
+            _acc_has_time = job->has_time;
+            _acc_time = job->time;
+        }
+        for (size_t ch = 0; ch < _num_chans; ch++){
+            _estimators[ch]->add_frame(&job->frames[ch].front());
+        }
+        if (job->last) this->publish();
+        _free.push_with_haste(job);
+    }
+
+    //! Hand the averages to get_psd() and start new ones
+    void publish(void){
+        if (_estimators.front()->get_num_frames() == 0) return;
+        boost::mutex::scoped_lock lock(_mutex);
+        for (size_t ch = 0; ch < _num_chans; ch++){
+            uhd::rx_streamer::psd_t &psd = _results[ch];
+            _estimators[ch]->get_average(psd.bins);
+            psd.time_spec = _acc_time;
+            psd.has_time_spec = _acc_has_time;
+            psd.num_averages = _estimators[ch]->get_num_frames();
+            _estimators[ch]->reset();
+            _fresh[ch] = true;
+        }
+        lock.unlock();
+        _fresh_cond.notify_all();
+    }
+
+    //config
+    size_t _size;
+    size_t _num_averages;
+    double _update_rate;
+    bool _transformed;
+    copy_type _copy;
+    size_t _num_chans;
+    double _rate;
+
+    //the jobs, passed between recv() and the worker
+    std::vector<boost::shared_ptr<job_type> > _jobs;
+    spsc_bounded_buffer<job_type *> _free, _filled;
+
+    //the state of recv()
+    job_type *_job;
+    size_t _fill, _skip, _period_skip, _frames_left;
+    boost::uint64_t _period;
+
+    //the state of the worker
+    std::vector<boost::shared_ptr<psd_estimator> > _estimators;
+    boost::uint64_t _acc_period;
+    bool _acc_has_time;
+    time_spec_t _acc_time;
+
+    //the spectra for get_psd()
+    boost::mutex _mutex;
+    boost::condition_variable _fresh_cond;
+    std::vector<uhd::rx_streamer::psd_t> _results;
+    std::vector<bool> _fresh;
+
+    //last, so the worker is joined first
+    task::sptr _worker;
+};
+
+}}} //namespace uhd::transport::sph
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_STREAM_PSD_HPP */
@@ -0,0 +1,191 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_STREAM_RESAMPLER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_STREAM_RESAMPLER_HPP
+
+#include "rational_resampler.hpp"
+#include <uhd/config.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/utils/msg.hpp>
+#include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
+#include <complex>
+#include <cmath>
+#include <vector>
+
+namespace uhd{ namespace transport{ namespace sph{
+
+/*!
+ * The host side resampling stage of a streamer.
+ *
+ * The stream args select it:
+ * - host_rate: the sample rate of the host side, needs the fc32 CPU format
+ * - resampler_taps: the taps per filter branch, defaults to 32
+ *
+ * One resampler per channel runs on the converted samples, from the
+ * device rate to the host rate for receive and back for transmit. The
+ * host rate is coerced to the closest one with factors up to 1024.
+ * The time specs on the host side are corrected for the filter delay.
+ */
+class stream_resampler{
+public:
+    static const size_t DEFAULT_TAPS_PER_PHASE = 32;
+    static const size_t MAX_FACTOR = 1024;
+
+    /*!
+     * Make a disabled resampling stage.
+     * \param to_host true to resample from the device rate to the host rate
+     */
+    stream_resampler(const bool to_host):
+        _to_host(to_host), _host_rate(0.0), _taps_per_phase(DEFAULT_TAPS_PER_PHASE),
+        _samp_rate(0.0), _actual_host_rate(0.0), _num_chans(0),
+        _time_valid(false), _num_outputs(0)
+    {
+        /* NOP */
+    }
+
+    //! Configure from the stream args, throws on a CPU format other than fc32
+    void set_args(const uhd::device_addr_t &args, const std::string &cpu_format){
+        _host_rate = args.cast<double>("host_rate", 0.0);
+        _taps_per_phase = args.cast<size_t>("resampler_taps", size_t(DEFAULT_TAPS_PER_PHASE));
+        if (_host_rate > 0.0 and cpu_format != "fc32"){
+            throw uhd::value_error("The host_rate stream arg needs the fc32 CPU format, not " + cpu_format);
+        }
+        this->update();
+    }
+
+    //! Set the sample rate of the device side
+    void set_samp_rate(const double rate){
+        _samp_rate = rate;
+        this->update();
+    }
+
+    //! Set the number of channels
+    void set_num_chans(const size_t num_chans){
+        _num_chans = num_chans;
+        this->update();
+    }
+
+    //! True when the host and device rates differ
+    UHD_INLINE bool enabled(void) const{
+        return not _resamplers.empty();
+    }
+
+    //! Get the rate on the host side, the coerced host_rate when enabled
+    UHD_INLINE double get_host_rate(void) const{
+        return this->enabled()? _actual_host_rate : _samp_rate;
+    }
+
+    //! Get the resampler of a channel
+    UHD_INLINE rational_resampler &operator[](const size_t chan){
+        return *_resamplers[chan];
+    }
+
+    //! Get buffers of complex floats for each channel, to resample from or into
+    const std::vector<void *> &get_buffs(const size_t nsamps){
+        for (size_t i = 0; i < _buffs.size(); i++){
+            if (_buffs[i].size() < nsamps) _buffs[i].resize(nsamps);
+            _buff_ptrs[i] = &_buffs[i].front();
+        }
+        return _buff_ptrs;
+    }
+
+    //! Get the number of outputs that flush() produces
+    UHD_INLINE size_t get_num_flush_outputs(void) const{
+        return _resamplers.front()->get_num_outputs(_resamplers.front()->get_taps_per_phase());
+    }
+
+    //! Push the history of a channel out of its filter, at the end of a burst
+    size_t flush(const size_t chan, std::complex<float> *out){
+        const size_t num_zeros = _resamplers[chan]->get_taps_per_phase();
+        _zeros.resize(num_zeros);
+        return _resamplers[chan]->process(&_zeros.front(), num_zeros, out);
+    }
+
+    //! Start a new stream, the next samples are not related to the last
+    void reset(void){
+        for (size_t i = 0; i < _resamplers.size(); i++) _resamplers[i]->reset();
+        _time_valid = false;
+    }
+
+    //! Set the time of the first input since reset()
+    void set_time(const time_spec_t &input_time){
+        const double input_rate = _to_host? _samp_rate : _actual_host_rate;
+        _time = input_time - time_spec_t(_resamplers.front()->get_delay()/input_rate);
+        _time_valid = true;
+        _num_outputs = 0;
+    }
+
+    UHD_INLINE bool has_time(void) const{
+        return _time_valid;
+    }
+
+    //! Get the time of the next output
+    UHD_INLINE time_spec_t get_time(void) const{
+        const double output_rate = _to_host? _actual_host_rate : _samp_rate;
+        return _time + time_spec_t::from_ticks((long long)(_num_outputs), output_rate);
+    }
+
+    UHD_INLINE void add_outputs(const size_t num_outputs){
+        _num_outputs += num_outputs;
+    }
+
+private:
+    void update(void){
+        _resamplers.clear();
+        if (_host_rate <= 0.0 or _samp_rate <= 0.0 or _num_chans == 0) return;
+
+        size_t interp, decim;
+        _actual_host_rate = rational_resampler::get_factors(_samp_rate, _host_rate, MAX_FACTOR, interp, decim);
+        if (interp == decim) return;
+        if (std::abs(_actual_host_rate - _host_rate) > 1e-6*_host_rate){
+            UHD_MSG(warning) << boost::format(
+                "The host rate of %f Msps was coerced to %f Msps"
+            ) % (_host_rate/1e6) % (_actual_host_rate/1e6) << std::endl;
+        }
+        for (size_t i = 0; i < _num_chans; i++){
+            _resamplers.push_back(boost::shared_ptr<rational_resampler>(_to_host?
+                new rational_resampler(interp, decim, _taps_per_phase) :
+                new rational_resampler(decim, interp, _taps_per_phase)
+            ));
+        }
+        _buffs.resize(_num_chans);
+        _buff_ptrs.resize(_num_chans);
+        _time_valid = false;
+    }
+
+    const bool _to_host;
+    double _host_rate;
+    size_t _taps_per_phase;
+    double _samp_rate;
+    double _actual_host_rate;
+    size_t _num_chans;
+    std::vector<boost::shared_ptr<rational_resampler> > _resamplers;
+    std::vector<std::vector<std::complex<float> > > _buffs;
+    std::vector<void *> _buff_ptrs;
+    std::vector<std::complex<float> > _zeros;
+    bool _time_valid;
+    time_spec_t _time;
+    uint64_t _num_outputs;
+};
+
+}}} //namespace uhd::transport::sph
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_STREAM_RESAMPLER_HPP */
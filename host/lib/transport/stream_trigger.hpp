@@ -0,0 +1,275 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_STREAM_TRIGGER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_STREAM_TRIGGER_HPP
+
+#include "power_detector.hpp"
+#include <uhd/config.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/convert.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace uhd{ namespace transport{ namespace sph{
+
+/*!
+ * The power triggered capture stage of a receive streamer.
+ *
+ * The stream args select it:
+ * - trigger_level: the threshold in dBFS of a sample on any channel,
+ *   enables the stage
+ * - trigger_pre: the samples before the first one above the threshold
+ *   that are part of a burst, defaults to 256
+ * - trigger_post: the samples below the threshold that end a burst,
+ *   defaults to 256
+ *
+ * recv() then only returns the bursts: the samples are received in
+ * blocks of at most MAX_SAMPS_PER_BLOCK into the buffers of the stage,
+ * scanned while they are in the cache, and only the samples of a burst
+ * are copied to the user buffers. A burst starts with start_of_burst
+ * and the time of its first sample, pre-roll included, and ends with
+ * end_of_burst. Between bursts, only the pre-roll history is kept.
+ */
+class stream_trigger{
+public:
+    static const size_t DEFAULT_ROLL = 256;
+    static const size_t MAX_SAMPS_PER_BLOCK = 16384;
+
+    //! Make a disabled trigger stage
+    stream_trigger(void):
+        _pre(DEFAULT_ROLL), _post(DEFAULT_ROLL), _bytes_per_samp(0),
+        _num_chans(0), _rate(0.0)
+    {
+        this->reset();
+    }
+
+    //! Configure from the stream args, throws on an unsupported CPU format
+    void set_args(const uhd::device_addr_t &args, const std::string &cpu_format){
+        _detector.reset();
+        _pre = args.cast<size_t>("trigger_pre", size_t(DEFAULT_ROLL));
+        _post = args.cast<size_t>("trigger_post", size_t(DEFAULT_ROLL));
+        if (args.has_key("trigger_level")){
+            _detector.reset(new power_detector(cpu_format, args.cast<double>("trigger_level", 0.0)));
+            _bytes_per_samp = uhd::convert::get_bytes_per_item(cpu_format);
+        }
+        this->update();
+    }
+
+    //! Set the number of host channels
+    void set_num_chans(const size_t num_chans){
+        _num_chans = num_chans;
+        this->update();
+    }
+
+    //! Set the rate of the host side samples
+    void set_rate(const double rate){
+        _rate = rate;
+    }
+
+    UHD_INLINE bool enabled(void) const{
+        return bool(_detector) and _num_chans != 0;
+    }
+
+    //! End any burst and forget the history, the next samples are not related to the last
+    void reset(void){
+        _open = false;
+        _started = false;
+        _post_left = 0;
+        _hist_len = 0;
+        _hist_out = 0;
+        _pos = 0;
+        _block_len = 0;
+        _block_eob = false;
+        _time_valid = false;
+    }
+
+    //! Get buffers for the next block, of up to nsamps samples
+    const std::vector<void *> &get_buffs(const size_t nsamps){
+        const size_t num_bytes = this->get_block_size(nsamps)*_bytes_per_samp;
+        for (size_t ch = 0; ch < _num_chans; ch++){
+            if (_blocks[ch].size() < num_bytes) _blocks[ch].resize(num_bytes);
+            _block_ptrs[ch] = &_blocks[ch].front();
+        }
+        return _block_ptrs;
+    }
+
+    //! Get the samples to receive into the next block
+    UHD_INLINE size_t get_block_size(const size_t nsamps) const{
+        return std::max<size_t>(1, std::min<size_t>(nsamps, size_t(MAX_SAMPS_PER_BLOCK)));
+    }
+
+    //! Take the block received into the buffers of get_buffs()
+    void load(const size_t nsamps, const uhd::rx_metadata_t &md){
+        _pos = 0;
+        _block_len = nsamps;
+        _block_eob = md.end_of_burst;
+        _time_valid = md.has_time_spec and _rate > 0.0;
+        _block_time = md.time_spec;
+    }
+
+    /*!
+     * Copy the samples of a burst from the block to the user buffers.
+     * \param buffs the user buffers, one per host channel
+     * \param nsamps the size of the user buffers in samples
+     * \param offset the samples already in the user buffers for this call
+     * \param md the metadata of the call, filled when offset is 0
+     * \return the samples in the user buffers, offset included
+     */
+    size_t deliver(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps,
+        size_t offset,
+        uhd::rx_metadata_t &md
+    ){
+        if (not _open){
+            //look for the start of a burst, the samples scanned become history
+            size_t start = _block_len;
+            for (size_t ch = 0; ch < _num_chans; ch++){
+                start = _detector->find(_block_ptrs[ch], _pos, start);
+            }
+            this->push_history(_pos, start);
+            _pos = start;
+            if (_pos == _block_len){
+                //the samples after a burst of the device are not related
+                if (_block_eob) _hist_len = 0;
+                return offset;
+            }
+            _open = true;
+            _started = false;
+            _post_left = _post;
+            _hist_out = 0;
+        }
+
+        if (offset == 0){
+            md.reset();
+            md.start_of_burst = not _started;
+            md.has_time_spec = _time_valid;
+            md.time_spec = this->get_time(_pos) - time_spec_t::from_ticks(
+                (long long)(_hist_len - _hist_out), _time_valid? _rate : 1.0);
+        }
+
+        //the pre-roll first
+        const size_t num_hist = std::min(_hist_len - _hist_out, nsamps - offset);
+        for (size_t ch = 0; ch < _num_chans and num_hist != 0; ch++){
+            std::memcpy(static_cast<char *>(buffs[ch]) + offset*_bytes_per_samp,
+                &_history[ch][_hist_out*_bytes_per_samp], num_hist*_bytes_per_samp);
+        }
+        _hist_out += num_hist;
+        offset += num_hist;
+
+        //then the block until the burst ends or the buffers are full
+        const size_t limit = std::min(_block_len, _pos + (nsamps - offset));
+        size_t end = _pos;
+        bool closed = false;
+        while (end < limit){
+            size_t next = limit;
+            for (size_t ch = 0; ch < _num_chans; ch++){
+                next = _detector->find(_block_ptrs[ch], end, next);
+            }
+            if (next - end > _post_left){
+                end += _post_left;
+                closed = true;
+                break;
+            }
+            _post_left -= next - end;
+            if (next == limit){
+                end = limit;
+                break;
+            }
+            end = next + 1;
+            _post_left = _post;
+        }
+        for (size_t ch = 0; ch < _num_chans and end != _pos; ch++){
+            std::memcpy(static_cast<char *>(buffs[ch]) + offset*_bytes_per_samp,
+                &_blocks[ch][_pos*_bytes_per_samp], (end - _pos)*_bytes_per_samp);
+        }
+        offset += end - _pos;
+        _pos = end;
+        _started = true;
+
+        //a burst of the device ends the burst too
+        if (_pos == _block_len and _block_eob) closed = true;
+        if (closed){
+            md.end_of_burst = true;
+            this->end_burst();
+        }
+        return offset;
+    }
+
+private:
+    //! Get the time of a sample of the block
+    time_spec_t get_time(const size_t index) const{
+        return _block_time + time_spec_t::from_ticks((long long)(index), _time_valid? _rate : 1.0);
+    }
+
+    //! Keep the last pre-roll samples of the block samples from begin to end
+    void push_history(const size_t begin, const size_t end){
+        if (_pre == 0 or begin == end) return;
+        const size_t n = std::min(end - begin, _pre);
+        const size_t keep = std::min(_hist_len, _pre - n);
+        for (size_t ch = 0; ch < _num_chans; ch++){
+            char *hist = &_history[ch].front();
+            std::memmove(hist, hist + (_hist_len - keep)*_bytes_per_samp, keep*_bytes_per_samp);
+            std::memcpy(hist + keep*_bytes_per_samp,
+                &_blocks[ch][(end - n)*_bytes_per_samp], n*_bytes_per_samp);
+        }
+        _hist_len = keep + n;
+    }
+
+    void end_burst(void){
+        _open = false;
+        _hist_len = 0;
+        _hist_out = 0;
+    }
+
+    void update(void){
+        _blocks.resize(_num_chans);
+        _block_ptrs.resize(_num_chans);
+        _history.assign(_num_chans, std::vector<char>(std::max<size_t>(_pre, 1)*std::max<size_t>(_bytes_per_samp, 1)));
+        this->reset();
+    }
+
+    size_t _pre, _post;
+    boost::shared_ptr<power_detector> _detector;
+    size_t _bytes_per_samp;
+    size_t _num_chans;
+    double _rate;
+
+    //the block received last, and the next sample to scan
+    std::vector<std::vector<char> > _blocks;
+    std::vector<void *> _block_ptrs;
+    size_t _pos, _block_len;
+    bool _block_eob, _time_valid;
+    time_spec_t _block_time;
+
+    //the pre-roll, and the state of the burst
+    std::vector<std::vector<char> > _history;
+    size_t _hist_len, _hist_out;
+    bool _open, _started;
+    size_t _post_left;
+};
+
+}}} //namespace uhd::transport::sph
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_STREAM_TRIGGER_HPP */
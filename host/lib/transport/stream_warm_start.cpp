@@ -0,0 +1,72 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "stream_warm_start.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/utils/msg.hpp>
+#include <boost/format.hpp>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+
+#ifdef HAVE_MLOCKALL
+#include <sys/mman.h>
+#endif /* HAVE_MLOCKALL */
+
+void uhd::transport::sph::warm_up_converter(
+    uhd::convert::converter::sptr converter,
+    const size_t num_inputs, const size_t bytes_per_input_item,
+    const size_t num_outputs, const size_t bytes_per_output_item,
+    const size_t nsamps
+){
+    if (not converter or nsamps == 0) return;
+    std::vector<std::vector<char> > in_mems(num_inputs, std::vector<char>(nsamps*bytes_per_input_item));
+    std::vector<std::vector<char> > out_mems(num_outputs, std::vector<char>(nsamps*bytes_per_output_item));
+    std::vector<const void *> inputs;
+    std::vector<void *> outputs;
+    for (size_t i = 0; i < num_inputs; i++) inputs.push_back(&in_mems[i].front());
+    for (size_t i = 0; i < num_outputs; i++) outputs.push_back(&out_mems[i].front());
+    converter->conv(inputs, outputs, nsamps);
+}
+
+#ifdef HAVE_MLOCKALL
+bool uhd::transport::sph::lock_stream_memory(const std::string &mode){
+    int flags = 0;
+    if (mode == "none") return true;
+    else if (mode == "current") flags = MCL_CURRENT;
+    else if (mode == "all") flags = MCL_CURRENT | MCL_FUTURE;
+    else throw uhd::value_error("warm_start_lock must be current, all or none, not " + mode);
+
+    if (mlockall(flags) != 0){
+        UHD_MSG(warning) << boost::format(
+            "Unable to lock the streaming memory into RAM: %s\n"
+            "Consider raising the memlock limit (ulimit -l).\n"
+        ) % std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+#else
+bool uhd::transport::sph::lock_stream_memory(const std::string &mode){
+    if (mode == "none") return true;
+    if (mode != "current" and mode != "all"){
+        throw uhd::value_error("warm_start_lock must be current, all or none, not " + mode);
+    }
+    UHD_MSG(warning) << "Locking the streaming memory is not supported on this platform." << std::endl;
+    return false;
+}
+#endif /* HAVE_MLOCKALL */
@@ -0,0 +1,57 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_STREAM_WARM_START_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_STREAM_WARM_START_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/convert.hpp>
+#include <string>
+
+namespace uhd{ namespace transport{ namespace sph{
+
+/*!
+ * Run a converter once over a zeroed packet, so its code and tables
+ * are faulted in and cached before the first real packet.
+ * \param converter the converter to run
+ * \param num_inputs the number of input buffers
+ * \param bytes_per_input_item the size of an input sample
+ * \param num_outputs the number of output buffers
+ * \param bytes_per_output_item the size of an output sample
+ * \param nsamps the number of samples, a full packet
+ */
+UHD_API void warm_up_converter(
+    uhd::convert::converter::sptr converter,
+    const size_t num_inputs, const size_t bytes_per_input_item,
+    const size_t num_outputs, const size_t bytes_per_output_item,
+    const size_t nsamps
+);
+
+/*!
+ * Lock the memory of the process into RAM for a warm started streamer.
+ * This also faults in every page that is mapped but not touched yet,
+ * like the buffers of the transports.
+ * \param mode current locks the pages mapped now, all also the pages
+ *             mapped later (like the application's buffers), none skips it
+ * \return false when the memory could not be locked, after a warning
+ * \throws uhd::value_error on an unknown mode
+ */
+UHD_API bool lock_stream_memory(const std::string &mode);
+
+}}} //namespace uhd::transport::sph
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_STREAM_WARM_START_HPP */
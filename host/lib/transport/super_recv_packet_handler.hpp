@@ -19,15 +19,29 @@
 #define INCLUDED_LIBUHD_TRANSPORT_SUPER_RECV_PACKET_HANDLER_HPP
 
 #include "../rfnoc/rx_stream_terminator.hpp"
+#include "stream_resampler.hpp"
+#include "stream_channelizer.hpp"
+#include "stream_psd.hpp"
+#include "stream_trigger.hpp"
+#include "xport_stats.hpp"
+#include "stream_warm_start.hpp"
+#include "stream_cpus_arg.hpp"
+#include "chdr_codec.hpp"
+#include "mboard_recv_thread.hpp"
 #include <uhd/config.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/stream.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/tasks.hpp>
+#include <uhd/utils/atomic.hpp>
 #include <uhd/utils/byteswap.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <uhd/utils/trace.hpp>
 #include <uhd/types/metadata.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
+#include <uhd/transport/chdr.hpp>
 #include <uhd/transport/zero_copy.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/foreach.hpp>
@@ -35,7 +49,11 @@
 #include <boost/format.hpp>
 #include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <iostream>
+#include <complex>
+#include <map>
 #include <vector>
 
 // Included for debugging
@@ -59,6 +77,24 @@ UHD_INLINE uint32_t get_context_code(
 typedef boost::function<void(void)> handle_overflow_type;
 static inline void handle_overflow_nop(void){}
 
+/*!
+ * The flow control of a receive channel.
+ * Devices implement this instead of passing a functor to have the
+ * handler call their flow control without the functor indirection.
+ */
+class recv_flowctrl_if{
+public:
+    typedef boost::shared_ptr<recv_flowctrl_if> sptr;
+
+    virtual ~recv_flowctrl_if(void){}
+
+    /*!
+     * Tell the source which packets were consumed.
+     * \param last_seq the sequence number of the last consumed packet
+     */
+    virtual void handle_flowctrl(const size_t last_seq) = 0;
+};
+
 /***********************************************************************
  * Super receive packet handler
  *
@@ -69,8 +105,11 @@ static inline void handle_overflow_nop(void){}
 class recv_packet_handler{
 public:
     typedef boost::function<managed_recv_buffer::sptr(double)> get_buff_type;
+    typedef boost::function<size_t(managed_recv_buffer::sptr *, const size_t, const double)> get_buffs_type;
     typedef boost::function<void(const size_t)> handle_flowctrl_type;
     typedef boost::function<void(const stream_cmd_t&)> issue_stream_cmd_type;
+    typedef boost::function<void(void *, const size_t)> host_work_type;
+    typedef boost::function<void(const time_spec_t &)> time_observer_type;
     typedef void(*vrt_unpacker_type)(const uint32_t *, vrt::if_packet_info_t &);
     //typedef boost::function<void(const uint32_t *, vrt::if_packet_info_t &)> vrt_unpacker_type;
 
@@ -79,8 +118,20 @@ public:
      * \param size the number of transport channels
      */
     recv_packet_handler(const size_t size = 1):
+        _hdr_codec(HDR_CODEC_FUNC),
         _queue_error_for_next_call(false),
-        _buffers_infos_index(0)
+        _next_time_valid(false),
+        _count_dropped_samps(false),
+        _nt_threshold(0),
+        _use_nt(false),
+        _fixed_spp(0),
+        _has_host_work(false),
+        _hist_enabled(false),
+        _hist_last_call_ns(0),
+        _hist_age_baseline_ns(0),
+        _hist_age_valid(false),
+        _buffers_infos_index(0),
+        _resampler(true)
     {
         #ifdef  ERROR_INJECT_DROPPED_PACKETS
         recvd_packets = 0;
@@ -91,13 +142,20 @@ public:
     }
 
     ~recv_packet_handler(void){
-        /* NOP */
+        this->stop_converter_threads();
+        this->stop_mboard_threads();
     }
 
     //! Resize the number of transport channels
     void resize(const size_t size){
         if (this->size() == size) return;
         _props.resize(size);
+        //channels added after set_converter() share the first converter
+        if (not _converters.empty()) _converters.resize(size, _converters.front());
+        if (not _nt_converters.empty()) _nt_converters.resize(size, _nt_converters.front());
+        _resampler.set_num_chans(size);
+        _channelizer.set_num_chans(size);
+        this->update_psd();
         //re-initialize all buffers infos by re-creating the vector
         _buffers_infos = std::vector<buffers_info_type>(4, buffers_info_type(size));
     }
@@ -110,9 +168,26 @@ public:
     //! Setup the vrt unpacker function and offset
     void set_vrt_unpacker(const vrt_unpacker_type &vrt_unpacker, const size_t header_offset_words32 = 0){
         _vrt_unpacker = vrt_unpacker;
+        _hdr_codec = HDR_CODEC_FUNC;
         _header_offset_words32 = header_offset_words32;
     }
 
+    /*!
+     * Setup the inlined CHDR unpacker for the transport endianness.
+     * Same as set_vrt_unpacker() with vrt::chdr::if_hdr_unpack_be/le,
+     * without the function call per packet.
+     */
+    void set_chdr_unpacker(const uhd::endianness_t endianness, const size_t header_offset_words32 = 0){
+        if (endianness == ENDIANNESS_BIG){
+            set_vrt_unpacker(&vrt::chdr::if_hdr_unpack_be, header_offset_words32);
+            _hdr_codec = HDR_CODEC_CHDR_BE;
+        }
+        else{
+            set_vrt_unpacker(&vrt::chdr::if_hdr_unpack_le, header_offset_words32);
+            _hdr_codec = HDR_CODEC_CHDR_LE;
+        }
+    }
+
     ////////////////// RFNOC ///////////////////////////
     //! Set the stream ID for a specific channel (or no SID)
     void set_xport_chan_sid(const size_t xport_chan, const bool has_sid, const uint32_t sid = 0){
@@ -120,6 +195,15 @@ public:
         _props.at(xport_chan).sid = sid;
     }
 
+    /*!
+     * Set the motherboard of a channel, see set_mboard_threads().
+     * \param xport_chan which transport channel
+     * \param mboard the motherboard number, 0 by default
+     */
+    void set_xport_chan_mboard(const size_t xport_chan, const size_t mboard){
+        _props.at(xport_chan).mboard = mboard;
+    }
+
     //! Get the stream ID for a specific channel (or zero if no SID)
     uint32_t get_xport_chan_sid(const size_t xport_chan) const {
         if (_props.at(xport_chan).has_sid) {
@@ -157,6 +241,14 @@ public:
     //! Set the rate of samples per second
     void set_samp_rate(const double rate){
         _samp_rate = rate;
+        _resampler.set_samp_rate(rate);
+        _channelizer.set_samp_rate(rate);
+        this->update_psd();
+    }
+
+    //! Get the number of buffers recv() takes, see stream_channelizer
+    size_t get_num_host_chans(void) const{
+        return this->size()*_channelizer.get_num_bands();
     }
 
     /*!
@@ -168,7 +260,102 @@ public:
         if (flush){
             while (get_buff(0.0)) {};
         }
+        _props.at(xport_chan).xport.reset();
         _props.at(xport_chan).get_buff = get_buff;
+        _props.at(xport_chan).reset_buff_batch();
+    }
+
+    /*!
+     * Set the transport of a channel.
+     * The handler calls get_recv_buff() and get_recv_buffs() of the
+     * transport directly, in place of the getter functions. With a
+     * batch size above one, the buffers are taken as in
+     * set_xport_chan_get_buffs().
+     * \param xport_chan which transport channel
+     * \param xport the transport, the handler holds a reference
+     * \param batch_size the maximum number of buffers per call
+     * \param flush true to drop the buffers already in the transport
+     */
+    void set_xport_chan(const size_t xport_chan, zero_copy_if::sptr xport, const size_t batch_size = 1, const bool flush = false){
+        if (flush){
+            while (xport->get_recv_buff(0.0)) {};
+        }
+        xport_chan_props_type &props = _props.at(xport_chan);
+        props.reset_buff_batch();
+        props.get_buff = get_buff_type();
+        props.get_buffs = get_buffs_type();
+        props.xport = xport;
+        props.buff_batch.resize((batch_size > 1)? batch_size : 0);
+    }
+
+    /*!
+     * Set the function to get several managed buffers at once.
+     * The handler then takes up to batch_size buffers per transport call,
+     * and hands them out in order before calling the transport again.
+     * \param xport_chan which transport channel
+     * \param get_buffs the getter function
+     * \param batch_size the maximum number of buffers per call
+     */
+    void set_xport_chan_get_buffs(const size_t xport_chan, const get_buffs_type &get_buffs, const size_t batch_size){
+        xport_chan_props_type &props = _props.at(xport_chan);
+        props.reset_buff_batch();
+        props.xport.reset();
+        props.get_buffs = (batch_size > 1)? get_buffs : get_buffs_type();
+        props.buff_batch.resize((batch_size > 1)? batch_size : 0);
+    }
+
+    /*!
+     * Get the time of the sample after the last received buffers.
+     * \param time_spec set to the time when it is known
+     * \return false when the last buffers carried no time
+     */
+    bool get_next_time_spec(time_spec_t &time_spec) const
+    {
+        if (_next_time_valid) time_spec = _next_time_spec;
+        return _next_time_valid;
+    }
+
+    /*!
+     * Check without blocking whether the next recv() can return
+     * without waiting on the transports, e.g. every channel has a
+     * packet ready. A packet taken from a transport for this check is
+     * kept for the next recv(). Call it from the thread calling recv().
+     * \return true when recv() would not wait
+     */
+    bool is_packet_ready(void)
+    {
+        if (_queue_error_for_next_call) return true;
+        if (get_curr_buffer_info().data_bytes_to_copy != 0) return true;
+        //channels which are done in the progress saved by an error
+        const buffers_info_type &next_info = get_next_buffer_info();
+        for (size_t i = 0; i < _props.size(); i++)
+        {
+            if (not next_info.indexes_todo.test(i)) continue;
+            if (not peek_next_buff(i)) return false;
+        }
+        return true;
+    }
+
+    /*!
+     * Get the descriptors to wait on for the channels without a packet.
+     * \param fds the descriptors are appended to it
+     * \return false when a channel has no descriptor to wait on
+     */
+    bool get_recv_fds(std::vector<int> &fds) const
+    {
+        bool all_fds = true;
+        for (size_t i = 0; i < _props.size(); i++)
+        {
+            if (_props[i].peek_buff) continue;
+            if (_props[i].ring){
+                all_fds = false; //the descriptor belongs to the receive thread
+                continue;
+            }
+            const int fd = _props[i].xport? _props[i].xport->get_recv_fd() : -1;
+            if (fd < 0) all_fds = false;
+            else fds.push_back(fd);
+        }
+        return all_fds;
     }
 
     /*!
@@ -181,6 +368,32 @@ public:
         return;
     }
 
+    //! Get the counters of this streamer, see stream_stats_t
+    stream_stats_t get_stats(void) const
+    {
+        return _stats.get();
+    }
+
+    /*!
+     * Enable or disable recording the histograms of this streamer.
+     * Enabling clears the histograms. Call it while not receiving.
+     */
+    void set_histograms_enabled(const bool enb)
+    {
+        if (enb and not _hist_enabled) {
+            _hist.reset();
+            _hist_last_call_ns = 0;
+            _hist_age_valid = false;
+        }
+        _hist_enabled = enb;
+    }
+
+    //! Get the histograms of this streamer, see stream_histograms
+    uhd::histograms_t get_histograms(void) const
+    {
+        return _hist.get(true);
+    }
+
     /*!
      * Set the function to handle flow control
      * \param xport_chan which transport channel
@@ -188,19 +401,287 @@ public:
      */
     void set_xport_handle_flowctrl(const size_t xport_chan, const handle_flowctrl_type &handle_flowctrl, const size_t update_window, const bool do_init = false)
     {
+        _props.at(xport_chan).flowctrl.reset();
         _props.at(xport_chan).handle_flowctrl = handle_flowctrl;
+        _props.at(xport_chan).has_flowctrl = bool(handle_flowctrl);
         //we need the window size to be within the 0xfff (max 12 bit seq)
         _props.at(xport_chan).fc_update_window = std::min<size_t>(update_window, 0xfff);
         if (do_init) handle_flowctrl(0);
     }
 
-    //! Set the conversion routine for all channels
-    void set_converter(const uhd::convert::id_type &id){
+    /*!
+     * Set the flow control of a channel.
+     * Like set_xport_handle_flowctrl(), but the handler calls the
+     * flow control object directly.
+     * \param xport_chan which transport channel
+     * \param flowctrl the flow control, the handler holds a reference
+     * \param update_window the number of packets between calls
+     * \param do_init true to acknowledge sequence number 0 right away
+     */
+    void set_xport_flowctrl(const size_t xport_chan, recv_flowctrl_if::sptr flowctrl, const size_t update_window, const bool do_init = false)
+    {
+        _props.at(xport_chan).handle_flowctrl = handle_flowctrl_type();
+        _props.at(xport_chan).flowctrl = flowctrl;
+        _props.at(xport_chan).has_flowctrl = bool(flowctrl);
+        //we need the window size to be within the 0xfff (max 12 bit seq)
+        _props.at(xport_chan).fc_update_window = std::min<size_t>(update_window, 0xfff);
+        if (do_init) flowctrl->handle_flowctrl(0);
+    }
+
+    /*!
+     * Set the conversion routine for all channels.
+     * The fastest converter is used unless the stream args
+     * select one by name with the "converter" key.
+     *
+     * The stream args may also set a complex gain and offset, which
+     * the converter applies in the same pass (see get_correction_arg()):
+     * - correction_gain, correction_gain<N>: multiplier, defaults to 1
+     * - correction_offset, correction_offset<N>: offset, defaults to 0
+     *
+     * The host_rate stream arg resamples the converted samples to another
+     * rate, see stream_resampler. The channelize stream arg splits each
+     * channel into narrow channels instead, see stream_channelizer.
+     * The psd_size stream arg averages spectra of the host side samples,
+     * see stream_psd, and the trigger_level stream arg only returns the
+     * bursts of samples above it, see stream_trigger.
+     *
+     * A recv() into buffers of more than nt_threshold bytes per channel
+     * (stream arg, default DEFAULT_NT_THRESHOLD, 0 disables this) uses the
+     * streaming store ("_nt") converter when one exists, so the samples do
+     * not evict the application's working set from the cache.
+     * This is skipped when the converter is selected by name, when a
+     * channel has a correction or when resampling.
+     *
+     * \param id the conversion ID
+     * \param args the stream args
+     */
+    void set_converter(
+        const uhd::convert::id_type &id,
+        const uhd::device_addr_t &args = uhd::device_addr_t()
+    ){
         _num_outputs = id.num_outputs;
-        _converter = uhd::convert::get_converter(id)();
+        const uhd::convert::function_type make_converter = args.has_key("converter")?
+            uhd::convert::get_converter(id, args["converter"]) :
+            uhd::convert::get_converter(id);
+        //channels without a correction share one converter
+        _converters.assign(this->size(), make_converter());
+        bool has_correction = false;
+        for (size_t i = 0; i < this->size(); i++){
+            const std::complex<double> gain = get_correction_arg(args, "correction_gain", i, 1.0);
+            const std::complex<double> offset = get_correction_arg(args, "correction_offset", i, 0.0);
+            if (gain == 1.0 and offset == 0.0) continue;
+            _converters[i] = make_converter();
+            _converters[i]->set_correction(gain, offset);
+            has_correction = true;
+        }
+        //the streaming store converter for large buffers, if there is one
+        _nt_threshold = args.cast<size_t>("nt_threshold", size_t(DEFAULT_NT_THRESHOLD));
+        _nt_converters.clear();
+        const std::string nt_name = get_nt_converter_name(id);
+        if (_nt_threshold != 0 and not nt_name.empty()
+            and not args.has_key("converter") and not has_correction
+        ){
+            _nt_converters.assign(this->size(), uhd::convert::get_converter(id, nt_name)());
+        }
         this->set_scale_factor(1/32767.); //update after setting converter
         _bytes_per_otw_item = uhd::convert::get_bytes_per_item(id.input_format);
         _bytes_per_cpu_item = uhd::convert::get_bytes_per_item(id.output_format);
+        if (args.has_key("host_rate") and _num_outputs != 1){
+            throw uhd::value_error("The host_rate stream arg needs one output per channel");
+        }
+        _resampler.set_args(args, id.output_format);
+        _channelizer.set_args(args, id.output_format);
+        if (_channelizer.enabled() and _num_outputs != 1){
+            throw uhd::value_error("The channelize stream arg needs one output per channel");
+        }
+        if (_channelizer.enabled() and args.has_key("host_rate")){
+            throw uhd::value_error("The channelize and host_rate stream args cannot be combined");
+        }
+        if (args.has_key("psd_size") and _num_outputs != 1){
+            throw uhd::value_error("The psd_size stream arg needs one output per channel");
+        }
+        if (args.has_key("trigger_level") and _num_outputs != 1){
+            throw uhd::value_error("The trigger_level stream arg needs one output per channel");
+        }
+        _psd.set_args(args, id.output_format);
+        _trigger.set_args(args, id.output_format);
+        this->update_psd();
+    }
+
+    /*!
+     * Spread the per-channel conversion across multiple threads.
+     *
+     * The calling thread of recv() always converts its share of the
+     * channels; num_threads-1 helper threads convert the rest. Channels
+     * are assigned to threads round-robin. A value of 0 or 1 disables
+     * the helper threads and converts all channels on the caller's thread.
+     *
+     * \param num_threads the total number of converting threads
+     * \param cpus optional list of CPUs to pin the helper threads to
+     */
+    void set_converter_threads(
+        const size_t num_threads,
+        const std::vector<size_t> &cpus = std::vector<size_t>()
+    ){
+        this->stop_converter_threads();
+        const size_t num_helpers = std::min(num_threads, this->size());
+        if (num_helpers <= 1) return;
+
+        _task_barrier_entry = boost::make_shared<reusable_barrier>(num_helpers);
+        _task_barrier_exit = boost::make_shared<reusable_barrier>(num_helpers);
+        _converter_thread_states.resize(num_helpers);
+        for (size_t i = 1/*skip 0*/; i < num_helpers; i++){
+            converter_thread_state_type &state = _converter_thread_states[i];
+            state.pinned = cpus.empty();
+            if (not cpus.empty()){
+                state.cpus = std::vector<size_t>(1, cpus[(i-1) % cpus.size()]);
+            }
+        }
+        for (size_t i = 1/*skip 0*/; i < num_helpers; i++){
+            _converter_tasks.push_back(task::make(boost::bind(
+                &recv_packet_handler::converter_thread_task, this, i
+            ), "rx_convert"));
+        }
+    }
+
+    /*!
+     * Drain the transports of each motherboard on a thread of its own.
+     *
+     * The channels are grouped by set_xport_chan_mboard(). The thread of
+     * a group takes the buffers of its transports into a ring per
+     * channel, and recv() only pops the rings, aligns and converts. A
+     * slow link then stalls its own board and not the transport calls
+     * of all the others. Flow control and overflows are still handled
+     * on the thread calling recv(). Call it after the transports of all
+     * channels are set.
+     *
+     * \param cpus optional list of CPUs to pin the threads to, one each
+     * \param ring_size the buffers per channel ring, 0 for the number
+     *        of frames of the channel's transport
+     */
+    void set_mboard_threads(
+        const std::vector<size_t> &cpus = std::vector<size_t>(),
+        const size_t ring_size = 0
+    ){
+        this->stop_mboard_threads();
+        std::map<size_t, std::vector<size_t> > mboard_chans;
+        for (size_t i = 0; i < this->size(); i++){
+            mboard_chans[_props[i].mboard].push_back(i);
+        }
+
+        typedef std::map<size_t, std::vector<size_t> >::value_type mboard_chans_type;
+        BOOST_FOREACH(const mboard_chans_type &mboard, mboard_chans){
+            std::vector<mboard_recv_thread::get_buffs_type> get_buffs;
+            std::vector<size_t> ring_sizes;
+            size_t batch_size = 1;
+            BOOST_FOREACH(const size_t index, mboard.second){
+                xport_chan_props_type &props = _props[index];
+                props.reset_buff_batch();
+                get_buffs.push_back(this->get_xport_chan_get_buffs(index));
+                ring_sizes.push_back((ring_size != 0)? ring_size :
+                    (props.xport? props.xport->get_num_recv_frames() : size_t(DEFAULT_MBOARD_RING_SIZE)));
+                batch_size = std::max(batch_size, props.buff_batch.size());
+            }
+            const std::vector<size_t> thread_cpus = cpus.empty()? cpus :
+                std::vector<size_t>(1, cpus[_mboard_threads.size() % cpus.size()]);
+            _mboard_threads.push_back(boost::make_shared<mboard_recv_thread>(
+                get_buffs, ring_sizes, batch_size, thread_cpus, mboard.first
+            ));
+            for (size_t i = 0; i < mboard.second.size(); i++){
+                _props[mboard.second[i]].ring = &_mboard_threads.back()->get_ring(i);
+            }
+        }
+    }
+
+    /*!
+     * Configure the converter and receive threads from stream args.
+     * - convert_threads: the total number of converting threads
+     * - convert_cpus: space separated list of CPUs for the helper threads
+     * - mboard_threads: 1 for a receive thread per motherboard,
+     *   see set_mboard_threads()
+     * - mboard_cpus: space separated list of CPUs for the receive threads
+     * - mboard_ring: the buffers per channel between the two
+     */
+    void set_converter_threads(const uhd::device_addr_t &args){
+        if (args.cast<int>("mboard_threads", 0) != 0){
+            this->set_mboard_threads(sph::get_cpus_arg(args, "mboard_cpus"), args.cast<size_t>("mboard_ring", 0));
+        }
+        if (not args.has_key("convert_threads")) return;
+        this->set_converter_threads(args.cast<size_t>("convert_threads", 1), sph::get_cpus_arg(args, "convert_cpus"));
+    }
+
+    //! Run every converter once over a zeroed packet of nsamps samples
+    void warm_up_converters(const size_t nsamps){
+        for (size_t i = 0; i < _converters.size(); i++){
+            sph::warm_up_converter(_converters[i],
+                1, _num_outputs*_bytes_per_otw_item, _num_outputs, _bytes_per_cpu_item, nsamps);
+        }
+        for (size_t i = 0; i < _nt_converters.size(); i++){
+            sph::warm_up_converter(_nt_converters[i],
+                1, _num_outputs*_bytes_per_otw_item, _num_outputs, _bytes_per_cpu_item, nsamps);
+        }
+    }
+
+    /*!
+     * Warm start the streamer if the stream args ask for it:
+     * run the converters once on a zeroed packet, then lock the memory
+     * of the process into RAM, see sph::lock_stream_memory().
+     * - warm_start: 1 to warm start
+     * - warm_start_lock: current (default), all or none
+     * \param args the stream args
+     * \param nsamps the samples in a full packet
+     */
+    void warm_start(const uhd::device_addr_t &args, const size_t nsamps){
+        if (args.cast<int>("warm_start", 0) == 0) return;
+        const int64_t start_ns = stats_time_now_ns();
+        this->warm_up_converters(nsamps);
+        sph::lock_stream_memory(args.get("warm_start_lock", "current"));
+        UHD_MSG(status) << boost::format("RX streamer ready after a %.1f ms warm start")
+            % ((stats_time_now_ns() - start_ns)/1e6) << std::endl;
+    }
+
+    /*!
+     * Get a complex correction value for a channel from the stream args.
+     * The key with the channel number appended overrides the plain key.
+     * The value is the real part, optionally followed by a space and
+     * the imaginary part, e.g. "0.98 0.01".
+     */
+    static std::complex<double> get_correction_arg(
+        const uhd::device_addr_t &args, const std::string &key,
+        const size_t chan, const double default_value
+    ){
+        const std::string chan_key = key + boost::lexical_cast<std::string>(chan);
+        const std::string value = boost::algorithm::trim_copy(
+            args.has_key(chan_key)? args[chan_key] : args.get(key, "")
+        );
+        if (value.empty()) return default_value;
+        std::vector<std::string> toks;
+        boost::split(toks, value, boost::is_any_of(" "), boost::token_compress_on);
+        if (toks.size() > 2) throw uhd::value_error(str(boost::format(
+            "Invalid stream arg %s=%s, expected \"<real> [<imag>]\"") % key % value
+        ));
+        return std::complex<double>(
+            boost::lexical_cast<double>(toks[0]),
+            (toks.size() == 2)? boost::lexical_cast<double>(toks[1]) : 0.0
+        );
+    }
+
+    //! The default nt_threshold stream arg, larger than most last level caches
+    static const size_t DEFAULT_NT_THRESHOLD = 8*1024*1024;
+
+    //! The ring size of a receive thread for a channel without a transport
+    static const size_t DEFAULT_MBOARD_RING_SIZE = 32;
+
+    /*!
+     * Get the name of the best streaming store converter for an ID.
+     * These converters are named with a "_nt" suffix.
+     * \return the converter name, or empty if there is none
+     */
+    static std::string get_nt_converter_name(const uhd::convert::id_type &id){
+        BOOST_FOREACH(const uhd::convert::converter_info_type &info, uhd::convert::get_converter_infos(id)){
+            if (boost::algorithm::ends_with(info.name, "_nt")) return info.name;
+        }
+        return "";
     }
 
     //! Set the transport channel's overflow handler
@@ -210,7 +691,12 @@ public:
 
     //! Set the scale factor used in float conversion
     void set_scale_factor(const double scale_factor){
-        _converter->set_scalar(scale_factor);
+        BOOST_FOREACH(const uhd::convert::converter::sptr &converter, _converters){
+            converter->set_scalar(scale_factor);
+        }
+        BOOST_FOREACH(const uhd::convert::converter::sptr &converter, _nt_converters){
+            converter->set_scalar(scale_factor);
+        }
     }
 
     //! Set the callback to issue stream commands
@@ -219,6 +705,43 @@ public:
         _props.at(xport_chan).issue_stream_cmd = issue_stream_cmd;
     }
 
+    /*!
+     * Set the processing of a host block for a channel.
+     * It runs in place on the samples of every packet, in the otw format,
+     * right before the conversion, see rfnoc::host_block_ctrl.
+     */
+    void set_host_work(const size_t xport_chan, const host_work_type &host_work)
+    {
+        _props.at(xport_chan).host_work = host_work;
+        _has_host_work = false;
+        for (size_t i = 0; i < _props.size(); i++){
+            if (_props[i].host_work) _has_host_work = true;
+        }
+    }
+
+    /*!
+     * Set the samples per packet of a stream whose data packets are all
+     * of the same size, except at the end of a burst.
+     * When a recv() call asks for a multiple of it, whole packets are
+     * converted in a straight-line loop without the fragment bookkeeping.
+     * Packets of another size and errors still take the general path.
+     * \param spp the samples per full packet, 0 to turn this off
+     */
+    void set_fixed_spp(const size_t spp)
+    {
+        _fixed_spp = spp;
+    }
+
+    /*!
+     * Set a callback that observes the device time.
+     * It is called with the time at the end of every received packet,
+     * which the device has already passed when the packet arrives.
+     */
+    void set_time_observer(const time_observer_type &time_observer)
+    {
+        _time_observer = time_observer;
+    }
+
     //! Overload call to issue stream commands
     void issue_stream_cmd(const stream_cmd_t &stream_cmd)
     {
@@ -246,6 +769,115 @@ public:
         uhd::rx_metadata_t &metadata,
         const double timeout,
         const bool one_packet
+    ){
+        if (not _hist_enabled and not _psd.enabled()){
+            return recv_dispatch(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+        }
+        const uint64_t packets = _stats.packets.get();
+        const size_t nsamps = recv_dispatch(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+        if (_hist_enabled) record_call_histograms(nsamps, _stats.packets.get() - packets);
+        if (_psd.enabled()) _psd.capture(buffs, nsamps, metadata);
+        return nsamps;
+    }
+
+    //! Get the latest spectrum of a channel, see stream_psd
+    bool get_psd(uhd::rx_streamer::psd_t &psd, const size_t chan, const double timeout){
+        return _psd.get_psd(psd, chan, timeout);
+    }
+
+
+    /*******************************************************************
+     * Receive resampled:
+     * Receive the inputs the outputs need into the buffers of the
+     * resampler, then resample each channel into the user buffers,
+     * while the converted samples are still in the cache.
+     ******************************************************************/
+    size_t recv_resampled(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
+    ){
+        const size_t num_inputs = _resampler[0].get_num_inputs(nsamps_per_buff);
+        const std::vector<void *> &in_buffs = _resampler.get_buffs(num_inputs);
+        const size_t num_recvd = recv_converted(
+            uhd::rx_streamer::buffs_type(in_buffs), num_inputs, metadata, timeout, one_packet
+        );
+
+        //the samples after an error or at a new burst do not continue the last ones
+        if (metadata.error_code != rx_metadata_t::ERROR_CODE_NONE and
+            metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) _resampler.reset();
+        if (metadata.start_of_burst) _resampler.reset();
+        if (num_recvd == 0) return 0;
+
+        if (not _resampler.has_time() and metadata.has_time_spec){
+            _resampler.set_time(metadata.time_spec);
+        }
+        size_t num_outputs = 0;
+        for (size_t i = 0; i < this->size(); i++){
+            num_outputs = _resampler[i].process(
+                reinterpret_cast<const std::complex<float> *>(in_buffs[i]), num_recvd,
+                reinterpret_cast<std::complex<float> *>(buffs[i])
+            );
+        }
+        if (_resampler.has_time()) metadata.time_spec = _resampler.get_time();
+        _resampler.add_outputs(num_outputs);
+        if (metadata.end_of_burst) _resampler.reset();
+        return num_outputs;
+    }
+
+    /*******************************************************************
+     * Receive channelized:
+     * Receive a block of inputs into the buffers of the channelizer,
+     * small enough to stay in the cache, then split each channel into
+     * the user buffers of its narrow channels.
+     ******************************************************************/
+    size_t recv_channelized(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
+    ){
+        const size_t num_inputs = _channelizer.get_num_inputs(nsamps_per_buff);
+        const std::vector<void *> &in_buffs = _channelizer.get_buffs(num_inputs);
+        const size_t num_recvd = recv_converted(
+            uhd::rx_streamer::buffs_type(in_buffs), num_inputs, metadata, timeout, one_packet
+        );
+
+        //the samples after an error or at a new burst do not continue the last ones
+        if (metadata.error_code != rx_metadata_t::ERROR_CODE_NONE and
+            metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) _channelizer.reset();
+        if (metadata.start_of_burst) _channelizer.reset();
+        if (num_recvd == 0) return 0;
+
+        if (not _channelizer.has_time() and metadata.has_time_spec){
+            _channelizer.set_time(metadata.time_spec);
+        }
+        size_t num_outputs = 0;
+        for (size_t i = 0; i < this->size(); i++){
+            num_outputs = _channelizer.process(
+                i, reinterpret_cast<const std::complex<float> *>(in_buffs[i]), num_recvd, buffs
+            );
+        }
+        if (_channelizer.has_time()) metadata.time_spec = _channelizer.get_time();
+        _channelizer.add_outputs(num_outputs);
+        if (metadata.end_of_burst) _channelizer.reset();
+        return num_outputs;
+    }
+
+    /*******************************************************************
+     * Receive converted:
+     * Receive at the device rate, straight into the user buffers.
+     ******************************************************************/
+    UHD_INLINE size_t recv_converted(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet,
+        std::vector<uhd::rx_streamer::packet_metadata_t> *packets = NULL
     ){
         //handle metadata queued from a previous receive
         if (_queue_error_for_next_call){
@@ -256,9 +888,20 @@ public:
             if (_queue_metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) return 0;
         }
 
+        //whole packets into a multiple of them take the fixed spp path
+        if (packets == NULL and is_fixed_spp_call(nsamps_per_buff)){
+            switch (this->size()){
+            case 1: return recv_fixed_spp<1>(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+            case 2: return recv_fixed_spp<2>(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+            case 4: return recv_fixed_spp<4>(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+            default: return recv_fixed_spp<0>(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+            }
+        }
+
         size_t accum_num_samps = recv_one_packet(
             buffs, nsamps_per_buff, metadata, timeout
         );
+        if (packets) add_packet_metadata(*packets, 0, accum_num_samps, metadata);
 
         if (one_packet or metadata.end_of_burst){
 #ifdef UHD_TXRX_DEBUG_PRINTS
@@ -285,6 +928,7 @@ public:
                 break;
             }
 
+            if (packets) add_packet_metadata(*packets, accum_num_samps, num_samps, _queue_metadata);
             accum_num_samps += num_samps;
 
             //return immediately if end of burst
@@ -298,25 +942,268 @@ public:
         return accum_num_samps;
     }
 
+    /*******************************************************************
+     * Receive packets:
+     * Receive converted, and keep the metadata of every packet.
+     * See rx_streamer::recv_packets().
+     ******************************************************************/
+    size_t recv_packets(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        std::vector<uhd::rx_streamer::packet_metadata_t> &packets,
+        const double timeout
+    ){
+        packets.clear();
+        if (_resampler.enabled()){
+            throw uhd::not_implemented_error("recv_packets() cannot resample, remove the host_rate stream arg");
+        }
+        if (_channelizer.enabled()){
+            throw uhd::not_implemented_error("recv_packets() cannot channelize, remove the channelize stream arg");
+        }
+        if (_trigger.enabled()){
+            throw uhd::not_implemented_error("recv_packets() cannot trigger, remove the trigger_level stream arg");
+        }
+
+        //the metadata queued from a previous receive is returned as a packet
+        if (_queue_error_for_next_call and _queue_metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT){
+            _queue_error_for_next_call = false;
+            add_packet_metadata(packets, 0, 0, _queue_metadata);
+            return 0;
+        }
+
+        const uint64_t num_packets = _stats.packets.get();
+        _use_nt = not _nt_converters.empty() and nsamps_per_buff*_bytes_per_cpu_item > _nt_threshold;
+        uhd::rx_metadata_t metadata;
+        const size_t nsamps = recv_converted(buffs, nsamps_per_buff, metadata, timeout, false, &packets);
+        if (_hist_enabled) record_call_histograms(nsamps, _stats.packets.get() - num_packets);
+        if (_psd.enabled()) _psd.capture(buffs, nsamps, metadata);
+        return nsamps;
+    }
+
+    /*******************************************************************
+     * Receive triggered:
+     * Receive blocks into the buffers of the trigger stage, and copy
+     * only the bursts above its threshold to the user buffers.
+     * The quiet samples are dropped until the timeout expires.
+     ******************************************************************/
+    size_t recv_triggered(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
+    ){
+        const time_spec_t exit_time = time_spec_t::get_system_time() + time_spec_t(timeout);
+        size_t accum_num_samps = 0;
+        metadata.reset();
+        for (bool received = false; true; received = true){
+            accum_num_samps = _trigger.deliver(buffs, nsamps_per_buff, accum_num_samps, metadata);
+            if (accum_num_samps == nsamps_per_buff or metadata.end_of_burst) return accum_num_samps;
+            if (accum_num_samps != 0 and one_packet) return accum_num_samps;
+
+            //the next block, with what is left of the timeout
+            const double time_left = std::max(0.0, (exit_time - time_spec_t::get_system_time()).get_real_secs());
+            if (received and time_left == 0.0){
+                if (accum_num_samps != 0) return accum_num_samps;
+                metadata.reset();
+                metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+                return 0;
+            }
+            const size_t block_size = _trigger.get_block_size(nsamps_per_buff - accum_num_samps);
+            rx_metadata_t block_md;
+            const size_t num_samps = recv_staged(
+                _trigger.get_buffs(block_size), block_size, block_md, time_left, one_packet
+            );
+
+            if (block_md.error_code != rx_metadata_t::ERROR_CODE_NONE){
+                if (block_md.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) _trigger.reset();
+                if (accum_num_samps == 0){
+                    metadata = block_md;
+                    return 0;
+                }
+                //end the burst here, and report the error on the next call
+                if (block_md.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT){
+                    metadata.end_of_burst = true;
+                    _queue_error_for_next_call = true;
+                    _queue_metadata = block_md;
+                }
+                return accum_num_samps;
+            }
+            _trigger.load(num_samps, block_md);
+        }
+    }
+
+    /*******************************************************************
+     * Receive borrowed:
+     * Hand out the aligned buffers instead of converting them.
+     * See rx_streamer::recv_borrowed().
+     ******************************************************************/
+    size_t recv_borrowed(
+        uhd::rx_streamer::borrowed_packet_t &packet,
+        uhd::rx_metadata_t &metadata,
+        const double timeout
+    ){
+        packet.release();
+        if (_resampler.enabled()){
+            throw uhd::not_implemented_error("recv_borrowed() cannot resample, remove the host_rate stream arg");
+        }
+        if (_channelizer.enabled()){
+            throw uhd::not_implemented_error("recv_borrowed() cannot channelize, remove the channelize stream arg");
+        }
+        if (_trigger.enabled()){
+            throw uhd::not_implemented_error("recv_borrowed() cannot trigger, remove the trigger_level stream arg");
+        }
+
+        //handle metadata queued from a previous receive
+        if (_queue_error_for_next_call){
+            _queue_error_for_next_call = false;
+            metadata = _queue_metadata;
+            if (_queue_metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) return 0;
+        }
+
+        //get the next buffers unless recv() left a remainder
+        if (get_curr_buffer_info().data_bytes_to_copy == 0)
+        {
+            get_aligned_buffs(timeout);
+        }
+
+        buffers_info_type &info = get_curr_buffer_info();
+        metadata = info.metadata;
+        metadata.time_spec += time_spec_t::from_ticks(info.fragment_offset_in_samps, _samp_rate);
+        metadata.more_fragments = false;
+        metadata.fragment_offset = info.fragment_offset_in_samps;
+        if (info.data_bytes_to_copy == 0) return 0;
+
+        //the packet takes over the buffers of all channels
+        const size_t nitems = info.data_bytes_to_copy/_bytes_per_otw_item;
+        for (size_t i = 0; i < this->size(); i++){
+            if (_props[i].host_work){
+                _props[i].host_work(const_cast<char *>(info[i].copy_buff), nitems);
+            }
+            packet.buffs.push_back(info[i].copy_buff);
+            packet.xport_buffs.push_back(info[i].buff);
+            info[i].buff.reset();
+        }
+        info.fragment_offset_in_samps += nitems/_num_outputs;
+        info.data_bytes_to_copy = 0;
+        return nitems;
+    }
+
 private:
+    UHD_INLINE size_t recv_dispatch(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
+    ){
+        if (_trigger.enabled()){
+            return recv_triggered(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+        }
+        return recv_staged(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+    }
+
+    UHD_INLINE size_t recv_staged(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
+    ){
+        if (_resampler.enabled()){
+            _use_nt = false;
+            return recv_resampled(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+        }
+        if (_channelizer.enabled()){
+            _use_nt = false;
+            return recv_channelized(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+        }
+        _use_nt = not _nt_converters.empty() and nsamps_per_buff*_bytes_per_cpu_item > _nt_threshold;
+        return recv_converted(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+    }
+
+    //! Append the metadata of a packet copied into the buffers of recv_packets()
+    static UHD_INLINE void add_packet_metadata(
+        std::vector<uhd::rx_streamer::packet_metadata_t> &packets,
+        const size_t offset,
+        const size_t nsamps,
+        const uhd::rx_metadata_t &metadata
+    ){
+        packets.push_back(uhd::rx_streamer::packet_metadata_t());
+        packets.back().offset = offset;
+        packets.back().nsamps = nsamps;
+        packets.back().metadata = metadata;
+    }
+
+    //! Record the rate and packets of a call, from the end of the last call
+    void record_call_histograms(const size_t nsamps, const uint64_t num_packets){
+        const int64_t now = stats_time_now_ns();
+        if (nsamps != 0 and _hist_last_call_ns != 0 and now > _hist_last_call_ns){
+            _hist.sample_rate.record(uint64_t(nsamps*1e9/(now - _hist_last_call_ns)));
+        }
+        _hist.packets_per_call.record(num_packets/this->size());
+        _hist_last_call_ns = now;
+    }
+
+    /*!
+     * Record the age of a packet at the host time of arrival.
+     * The host and device clocks are not related, so the age is relative
+     * to the youngest packet: the histogram shows how much longer than
+     * the fastest one the packets took to arrive.
+     */
+    void record_packet_age(const uint64_t tsf, const int64_t arrival_ns){
+        const int64_t diff = arrival_ns - int64_t(time_spec_t::from_ticks(tsf, _tick_rate).to_ticks(1e9));
+        if (not _hist_age_valid or diff < _hist_age_baseline_ns){
+            _hist_age_baseline_ns = diff;
+            _hist_age_valid = true;
+        }
+        _hist.packet_age.record(uint64_t(diff - _hist_age_baseline_ns));
+    }
+
     vrt_unpacker_type _vrt_unpacker;
+    enum {HDR_CODEC_FUNC, HDR_CODEC_CHDR_BE, HDR_CODEC_CHDR_LE} _hdr_codec;
     size_t _header_offset_words32;
     double _tick_rate, _samp_rate;
     bool _queue_error_for_next_call;
+    //the end of the last received buffers, to count the samples lost in an overflow
+    time_spec_t _next_time_spec;
+    bool _next_time_valid;
+    bool _count_dropped_samps;
     size_t _alignment_failure_threshold;
+    time_observer_type _time_observer;
     rx_metadata_t _queue_metadata;
     struct xport_chan_props_type{
         xport_chan_props_type(void):
+            buff_batch_index(0),
+            buff_batch_size(0),
             packet_count(0),
             handle_overflow(&handle_overflow_nop),
-            fc_update_window(0)
+            has_flowctrl(false),
+            fc_update_window(0),
+            mboard(0),
+            ring(NULL)
         {}
+        void reset_buff_batch(void){
+            for (size_t i = 0; i < buff_batch.size(); i++) buff_batch[i].reset();
+            buff_batch_index = buff_batch_size = 0;
+            peek_buff.reset();
+        }
+        zero_copy_if::sptr xport;
         get_buff_type get_buff;
+        get_buffs_type get_buffs;
+        std::vector<managed_recv_buffer::sptr> buff_batch;
+        size_t buff_batch_index, buff_batch_size;
+        managed_recv_buffer::sptr peek_buff; //taken by is_packet_ready()
         issue_stream_cmd_type issue_stream_cmd;
+        host_work_type host_work;
         size_t packet_count;
         handle_overflow_type handle_overflow;
+        recv_flowctrl_if::sptr flowctrl;
         handle_flowctrl_type handle_flowctrl;
+        bool has_flowctrl;
         size_t fc_update_window;
+        size_t mboard; //groups the channels of set_mboard_threads()
+        mboard_recv_thread::ring_type *ring; //filled by a receive thread, or NULL
 	/////// RFNOC ///////////
         bool has_sid;
         uint32_t sid;
@@ -326,7 +1213,18 @@ private:
     size_t _num_outputs;
     size_t _bytes_per_otw_item; //used in conversion
     size_t _bytes_per_cpu_item; //used in conversion
-    uhd::convert::converter::sptr _converter; //used in conversion
+    std::vector<uhd::convert::converter::sptr> _converters; //used in conversion, per channel
+    std::vector<uhd::convert::converter::sptr> _nt_converters; //streaming stores, per channel or empty
+    size_t _nt_threshold; //bytes per channel buffer above which _nt_converters are used
+    bool _use_nt; //the current recv() uses _nt_converters
+    size_t _fixed_spp; //the samples of every full packet, 0 for no fixed spp path
+    bool _has_host_work; //a channel has a host block
+    stream_stats_counters _stats;
+    bool _hist_enabled;
+    stream_histograms _hist;
+    int64_t _hist_last_call_ns; //end of the last recv() call
+    int64_t _hist_age_baseline_ns; //smallest arrival minus device time seen
+    bool _hist_age_valid;
 
     //! information stored for a received buffer
     struct per_buffer_info_type{
@@ -334,21 +1232,86 @@ private:
         {
             buff.reset();
             vrt_hdr = NULL;
-            time = time_spec_t(0.0);
+            ifpi.has_tsf = false;
+            ifpi.tsf = 0;
             copy_buff = NULL;
         }
         managed_recv_buffer::sptr buff;
         const uint32_t *vrt_hdr;
-        vrt::if_packet_info_t ifpi;
-        time_spec_t time;
+        vrt::if_packet_info_t ifpi; //ifpi.tsf holds the raw time in ticks
         const char *copy_buff;
     };
 
+    /*!
+     * The set of channel indexes which are still to be aligned.
+     * Up to 64 channels are kept in a single word, so the alignment loop
+     * finds the next index with one bit scan. Wider handlers fall back
+     * to a dynamic_bitset.
+     */
+    class index_set_type{
+    public:
+        index_set_type(const size_t size):
+            _wide(size > 64),
+            _all_mask((size >= 64)? ~uint64_t(0) : ((uint64_t(1) << size) - 1)),
+            _mask(_all_mask),
+            _bits(_wide? size : 0, true)
+        {/* NOP */}
+
+        //! Add all indexes to the set
+        UHD_INLINE void set(void){
+            if (_wide) _bits.set();
+            else _mask = _all_mask;
+        }
+
+        //! Remove an index from the set
+        UHD_INLINE void reset(const size_t index){
+            if (_wide) _bits.reset(index);
+            else _mask &= ~(uint64_t(1) << index);
+        }
+
+        //! Is the index in the set?
+        UHD_INLINE bool test(const size_t index) const{
+            return _wide? _bits.test(index) : ((_mask >> index) & 1);
+        }
+
+        //! Is there an index left in the set?
+        UHD_INLINE bool any(void) const{
+            return _wide? _bits.any() : (_mask != 0);
+        }
+
+        //! Get the lowest index in the set, the set must not be empty
+        UHD_INLINE size_t find_first(void) const{
+            if (_wide) return _bits.find_first();
+            #if defined(__GNUC__)
+            return size_t(__builtin_ctzll(_mask));
+            #else
+            size_t index = 0;
+            while (not ((_mask >> index) & 1)) index++;
+            return index;
+            #endif
+        }
+
+        //! Exchange with another set, without copying the wide bits
+        UHD_INLINE void swap(index_set_type &other){
+            std::swap(_wide, other._wide);
+            std::swap(_all_mask, other._all_mask);
+            std::swap(_mask, other._mask);
+            _bits.swap(other._bits);
+        }
+
+    private:
+        bool _wide;
+        uint64_t _all_mask;
+        uint64_t _mask;
+        boost::dynamic_bitset<> _bits;
+    };
+
     //!information stored for a set of aligned buffers
     struct buffers_info_type : std::vector<per_buffer_info_type> {
         buffers_info_type(const size_t size):
             std::vector<per_buffer_info_type>(size),
-            indexes_todo(size, true),
+            indexes_todo(size),
+            alignment_ticks(0),
             alignment_time_valid(false),
             data_bytes_to_copy(0),
             fragment_offset_in_samps(0)
@@ -356,7 +1319,7 @@ private:
         void reset()
         {
             indexes_todo.set();
-            alignment_time = time_spec_t(0.0);
+            alignment_ticks = 0;
             alignment_time_valid = false;
             data_bytes_to_copy = 0;
             fragment_offset_in_samps = 0;
@@ -364,8 +1327,19 @@ private:
             for (size_t i = 0; i < size(); i++)
                 at(i).reset();
         }
-        boost::dynamic_bitset<> indexes_todo; //used in alignment logic
-        time_spec_t alignment_time; //used in alignment logic
+        //! Exchange with another info, std::swap would copy the vectors without move support
+        void swap(buffers_info_type &other)
+        {
+            std::vector<per_buffer_info_type>::swap(other);
+            indexes_todo.swap(other.indexes_todo);
+            std::swap(alignment_ticks, other.alignment_ticks);
+            std::swap(alignment_time_valid, other.alignment_time_valid);
+            std::swap(data_bytes_to_copy, other.data_bytes_to_copy);
+            std::swap(fragment_offset_in_samps, other.fragment_offset_in_samps);
+            std::swap(metadata, other.metadata);
+        }
+        index_set_type indexes_todo; //used in alignment logic
+        uint64_t alignment_ticks; //used in alignment logic, compared as raw ticks
         bool alignment_time_valid; //used in alignment logic
         size_t data_bytes_to_copy; //keeps track of state
         size_t fragment_offset_in_samps; //keeps track of state
@@ -380,6 +1354,28 @@ private:
     buffers_info_type &get_next_buffer_info(void){return _buffers_infos[(_buffers_infos_index + 1)%4];}
     void increment_buffer_info(void){_buffers_infos_index = (_buffers_infos_index + 1)%4;}
 
+    //! the host side resampling, enabled by the host_rate stream arg
+    stream_resampler _resampler;
+
+    //! the host side channelizer, enabled by the channelize stream arg
+    stream_channelizer _channelizer;
+
+    //! the spectrum monitor, enabled by the psd_size stream arg
+    stream_psd _psd;
+
+    //! the triggered capture, enabled by the trigger_level stream arg
+    stream_trigger _trigger;
+
+    //! Follow the host channels and rate after the resampler or channelizer
+    void update_psd(void){
+        const double host_rate = _channelizer.enabled()?
+            _samp_rate/_channelizer.get_num_bands() : _resampler.get_host_rate();
+        _psd.set_num_chans(this->get_num_host_chans());
+        _psd.set_rate(host_rate);
+        _trigger.set_num_chans(this->get_num_host_chans());
+        _trigger.set_rate(host_rate);
+    }
+
     //! possible return options for the packet receiver
     enum packet_type{
         PACKET_IF_DATA,
@@ -395,6 +1391,62 @@ private:
 
     uhd::rfnoc::rx_stream_terminator::sptr _terminator;
 
+    //! Send a flow control ack to the device for the given packet count
+    UHD_INLINE void send_flowctrl(const size_t index, const size_t packet_count){
+        UHD_TRACE_INSTANT(POINT_FC_SEND, packet_count);
+        xport_chan_props_type &props = _props[index];
+        if (props.flowctrl) props.flowctrl->handle_flowctrl(packet_count);
+        else props.handle_flowctrl(packet_count);
+        _stats.fc_acks.add();
+    }
+
+    /*******************************************************************
+     * Get a single buffer from the transport:
+     * Use a peeked buffer, then the batch of buffers from the last
+     * transport call first.
+     * Prefer the transport over the getter functions when it is set.
+     ******************************************************************/
+    UHD_INLINE managed_recv_buffer::sptr get_next_buff(const size_t index, const double timeout){
+        xport_chan_props_type &props = _props[index];
+        if (props.peek_buff){
+            managed_recv_buffer::sptr buff;
+            buff.swap(props.peek_buff);
+            return buff;
+        }
+        if (props.ring){
+            managed_recv_buffer::sptr buff;
+            props.ring->pop_with_timed_wait(buff, timeout);
+            return buff;
+        }
+        zero_copy_if *xport = props.xport.get();
+        if (props.buff_batch.empty()){
+            return xport? xport->get_recv_buff(timeout) : props.get_buff(timeout);
+        }
+        if (props.buff_batch_index == props.buff_batch_size){
+            props.buff_batch_index = 0;
+            props.buff_batch_size = xport?
+                xport->get_recv_buffs(&props.buff_batch.front(), props.buff_batch.size(), timeout) :
+                props.get_buffs(&props.buff_batch.front(), props.buff_batch.size(), timeout);
+            if (props.buff_batch_size == 0) return managed_recv_buffer::sptr();
+            _stats.queue_hwm.update_max(props.buff_batch_size);
+        }
+        managed_recv_buffer::sptr buff;
+        buff.swap(props.buff_batch[props.buff_batch_index++]);
+        return buff;
+    }
+
+    /*******************************************************************
+     * Peek at a single buffer from the transport:
+     * Make sure the next get_next_buff() on the index will not wait.
+     ******************************************************************/
+    UHD_INLINE bool peek_next_buff(const size_t index){
+        xport_chan_props_type &props = _props[index];
+        if (props.peek_buff) return true;
+        if (props.buff_batch_index < props.buff_batch_size) return true;
+        props.peek_buff = get_next_buff(index, 0.0);
+        return bool(props.peek_buff);
+    }
+
     /*******************************************************************
      * Get and process a single packet from the transport:
      * Receive a single packet at the given index.
@@ -409,7 +1461,17 @@ private:
     ){
         //get a single packet from the transport layer
         managed_recv_buffer::sptr &buff = curr_buffer_info.buff;
-        buff = _props[index].get_buff(timeout);
+        int64_t arrival_ns = 0;
+        {
+            UHD_TRACE_SCOPE(POINT_RECV_BUFF_GET, index);
+            if (_hist_enabled){
+                const int64_t wait_start_ns = stats_time_now_ns();
+                buff = get_next_buff(index, timeout);
+                arrival_ns = stats_time_now_ns();
+                _hist.xport_wait.record(uint64_t(arrival_ns - wait_start_ns));
+            }
+            else buff = get_next_buff(index, timeout);
+        }
         if (buff.get() == NULL) return PACKET_TIMEOUT_ERROR;
 
         #ifdef  ERROR_INJECT_DROPPED_PACKETS
@@ -417,7 +1479,7 @@ private:
         {
             recvd_packets = 0;
             buff.reset();
-            buff = _props[index].get_buff(timeout);
+            buff = get_next_buff(index, timeout);
             if (buff.get() == NULL) return PACKET_TIMEOUT_ERROR;
         }
         #endif
@@ -432,16 +1494,23 @@ private:
         per_buffer_info_type &info = curr_buffer_info;
         info.ifpi.num_packet_words32 = num_packet_words32 - _header_offset_words32;
         info.vrt_hdr = buff->cast<const uint32_t *>() + _header_offset_words32;
-        _vrt_unpacker(info.vrt_hdr, info.ifpi);
-        info.time = time_spec_t::from_ticks(info.ifpi.tsf, _tick_rate); //assumes has_tsf is true
+        {
+            UHD_TRACE_SCOPE(POINT_HDR_UNPACK, index);
+            switch (_hdr_codec){
+            case HDR_CODEC_CHDR_BE: vrt::chdr::codec<ENDIANNESS_BIG>::unpack(info.vrt_hdr, info.ifpi); break;
+            case HDR_CODEC_CHDR_LE: vrt::chdr::codec<ENDIANNESS_LITTLE>::unpack(info.vrt_hdr, info.ifpi); break;
+            default: _vrt_unpacker(info.vrt_hdr, info.ifpi);
+            }
+        }
+        if (_hist_enabled and info.ifpi.has_tsf) record_packet_age(info.ifpi.tsf, arrival_ns);
         info.copy_buff = reinterpret_cast<const char *>(info.vrt_hdr + info.ifpi.num_header_words32);
 
         //handle flow control
-        if (_props[index].handle_flowctrl)
+        if (_props[index].has_flowctrl)
         {
             if ((info.ifpi.packet_count % _props[index].fc_update_window) == 0)
             {
-                _props[index].handle_flowctrl(info.ifpi.packet_count);
+                send_flowctrl(index, info.ifpi.packet_count);
             }
         }
 
@@ -454,6 +1523,8 @@ private:
         if (info.ifpi.packet_type != vrt::if_packet_info_t::PACKET_TYPE_DATA){
             return PACKET_INLINE_MESSAGE;
         }
+        _stats.packets.add();
+        _stats.bytes.add(info.ifpi.num_payload_bytes);
 
         //2) check for sequence errors
         #ifndef SRPH_DONT_CHECK_SEQUENCE
@@ -462,18 +1533,18 @@ private:
         _props[index].packet_count = (info.ifpi.packet_count + 1) & seq_mask;
         if (expected_packet_count != info.ifpi.packet_count){
             //UHD_MSG(status) << "expected: " << expected_packet_count << " got: " << info.ifpi.packet_count << std::endl;
-            if (_props[index].handle_flowctrl) {
+            if (_props[index].has_flowctrl) {
                 // Always update flow control in this case, because we don't
                 // know which packet was dropped and what state the upstream
                 // flow control is in.
-                _props[index].handle_flowctrl(info.ifpi.packet_count);
+                send_flowctrl(index, info.ifpi.packet_count);
             }
             return PACKET_SEQUENCE_ERROR;
         }
         #endif
 
         //3) check for out of order timestamps
-        if (info.ifpi.has_tsf and prev_buffer_info.time > info.time){
+        if (info.ifpi.has_tsf and prev_buffer_info.ifpi.tsf > info.ifpi.tsf){
             return PACKET_TIMESTAMP_ERROR;
         }
 
@@ -519,9 +1590,9 @@ private:
         //if alignment time was not valid or if the sequence id is newer:
         //  use this index's time as the alignment time
         //  reset the indexes list and remove this index
-        if (not info.alignment_time_valid or info[index].time > info.alignment_time){
+        if (not info.alignment_time_valid or info[index].ifpi.tsf > info.alignment_ticks){
             info.alignment_time_valid = true;
-            info.alignment_time = info[index].time;
+            info.alignment_ticks = info[index].ifpi.tsf;
             info.indexes_todo.set();
             info.indexes_todo.reset(index);
             info.data_bytes_to_copy = info[index].ifpi.num_payload_bytes;
@@ -529,13 +1600,13 @@ private:
 
         //if the sequence id matches:
         //  remove this index from the list and continue
-        else if (info[index].time == info.alignment_time){
+        else if (info[index].ifpi.tsf == info.alignment_ticks){
             info.indexes_todo.reset(index);
         }
 
         //if the sequence id is older:
         //  continue with the same index to try again
-        //else if (info[index].time < info.alignment_time)...
+        //else if (info[index].ifpi.tsf < info.alignment_ticks)...
     }
 
     /*******************************************************************
@@ -545,6 +1616,7 @@ private:
      * The logic will throw out older packets until it finds a match.
      ******************************************************************/
     UHD_INLINE void get_aligned_buffs(double timeout){
+        UHD_TRACE_SCOPE(POINT_RECV_ALIGN, this->size());
 
         get_prev_buffer_info().reset(); // no longer need the previous info - reset it for future use
 
@@ -577,7 +1649,7 @@ private:
                 UHD_MSG(error) << boost::format(
                     "The receive packet handler caught a value exception.\n%s"
                 ) % e.what() << std::endl;
-                std::swap(curr_info, next_info); //save progress from curr -> next
+                curr_info.swap(next_info); //save progress from curr -> next
                 curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_BAD_PACKET;
                 return;
             }
@@ -592,51 +1664,59 @@ private:
                 //we can receive a packet that comes before the previous packet in time.
                 //This could cause the alignment logic to discard future received packets.
                 //Therefore, when this occurs, we reset the info to restart from scratch.
-                if (curr_info.alignment_time_valid and curr_info.alignment_time != curr_info[index].time){
+                if (curr_info.alignment_time_valid and curr_info.alignment_ticks != curr_info[index].ifpi.tsf){
                     curr_info.alignment_time_valid = false;
                 }
                 alignment_check(index, curr_info);
                 break;
 
             case PACKET_INLINE_MESSAGE:
-                std::swap(curr_info, next_info); //save progress from curr -> next
+                curr_info.swap(next_info); //save progress from curr -> next
                 curr_info.metadata.has_time_spec = next_info[index].ifpi.has_tsf;
-                curr_info.metadata.time_spec = next_info[index].time;
+                curr_info.metadata.time_spec = time_spec_t::from_ticks(next_info[index].ifpi.tsf, _tick_rate);
                 curr_info.metadata.error_code = rx_metadata_t::error_code_t(get_context_code(next_info[index].vrt_hdr, next_info[index].ifpi));
                 if (curr_info.metadata.error_code == rx_metadata_t::ERROR_CODE_OVERFLOW){
+                    _count_dropped_samps = true;
                     // Not sending flow control would cause timeouts due to source flow control locking up.
                     // Send first as the overrun handler may flush the receive buffers which could contain
                     // packets with sequence numbers after this packet's sequence number!
-                    if(_props[index].handle_flowctrl) {
-                        _props[index].handle_flowctrl(next_info[index].ifpi.packet_count);
+                    if(_props[index].has_flowctrl) {
+                        send_flowctrl(index, next_info[index].ifpi.packet_count);
                     }
+                    _stats.overflows.add();
 
                     rx_metadata_t metadata = curr_info.metadata;
                     _props[index].handle_overflow();
                     curr_info.metadata = metadata;
-                    UHD_MSG(fastpath) << "O";
+                    uhd::msg::fastpath_event('O');
+                }
+                else if (curr_info.metadata.error_code == rx_metadata_t::ERROR_CODE_LATE_COMMAND){
+                    _stats.late_commands.add();
                 }
                 curr_info[index].buff.reset();
                 curr_info[index].copy_buff = NULL;
                 return;
 
             case PACKET_TIMEOUT_ERROR:
-                std::swap(curr_info, next_info); //save progress from curr -> next
-                if(_props[index].handle_flowctrl) {
-                    _props[index].handle_flowctrl(next_info[index].ifpi.packet_count);
+                curr_info.swap(next_info); //save progress from curr -> next
+                if(_props[index].has_flowctrl) {
+                    send_flowctrl(index, next_info[index].ifpi.packet_count);
                 }
+                _stats.timeouts.add();
                 curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
                 return;
 
             case PACKET_SEQUENCE_ERROR:
                 alignment_check(index, curr_info);
-                std::swap(curr_info, next_info); //save progress from curr -> next
+                curr_info.swap(next_info); //save progress from curr -> next
                 curr_info.metadata.has_time_spec = prev_info.metadata.has_time_spec;
                 curr_info.metadata.time_spec = prev_info.metadata.time_spec + time_spec_t::from_ticks(
                     prev_info[index].ifpi.num_payload_words32*sizeof(uint32_t)/_bytes_per_otw_item, _samp_rate);
                 curr_info.metadata.out_of_sequence = true;
                 curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
-                UHD_MSG(fastpath) << "D";
+                _count_dropped_samps = true;
+                _stats.sequence_errors.add();
+                uhd::msg::fastpath_event('D');
                 return;
 
             }
@@ -648,7 +1728,7 @@ private:
                     "%u received packets were processed by the handler.\n"
                     "However, a timestamp match could not be determined.\n"
                 ) % iterations << std::endl;
-                std::swap(curr_info, next_info); //save progress from curr -> next
+                curr_info.swap(next_info); //save progress from curr -> next
                 curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_ALIGNMENT;
                 _props[index].handle_overflow();
                 return;
@@ -658,13 +1738,26 @@ private:
 
         //set the metadata from the buffer information at index zero
         curr_info.metadata.has_time_spec = curr_info[0].ifpi.has_tsf;
-        curr_info.metadata.time_spec = curr_info[0].time;
+        curr_info.metadata.time_spec = time_spec_t::from_ticks(curr_info[0].ifpi.tsf, _tick_rate);
         curr_info.metadata.more_fragments = false;
         curr_info.metadata.fragment_offset = 0;
         curr_info.metadata.start_of_burst = curr_info[0].ifpi.sob;
         curr_info.metadata.end_of_burst = curr_info[0].ifpi.eob;
         curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_NONE;
-
+        curr_info.metadata.has_host_time_spec = curr_info[0].buff and
+            curr_info[0].buff->get_recv_time(curr_info.metadata.host_time_spec);
+
+        //after an error: count the samples between the last buffers and these
+        curr_info.metadata.num_dropped_samps = 0;
+        if (_count_dropped_samps and _next_time_valid and curr_info.metadata.has_time_spec){
+            const long long gap = (curr_info.metadata.time_spec - _next_time_spec).to_ticks(_samp_rate);
+            if (gap > 0) curr_info.metadata.num_dropped_samps = size_t(gap);
+        }
+        _count_dropped_samps = false;
+        _next_time_valid = curr_info.metadata.has_time_spec;
+        _next_time_spec = curr_info.metadata.time_spec + time_spec_t::from_ticks(
+            curr_info.data_bytes_to_copy/_bytes_per_otw_item, _samp_rate);
+        if (_time_observer and _next_time_valid) _time_observer(_next_time_spec);
     }
 
     /*******************************************************************
@@ -686,7 +1779,20 @@ private:
             //perform receive with alignment logic
             get_aligned_buffs(timeout);
         }
+        return convert_curr_packet(buffs, nsamps_per_buff, metadata, buffer_offset_bytes);
+    }
 
+    /*******************************************************************
+     * Convert the current packet:
+     * Copy what fits of the current buffers into the user buffers,
+     * and keep track of the fragments left for the next call.
+     ******************************************************************/
+    UHD_INLINE size_t convert_curr_packet(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const size_t buffer_offset_bytes
+    ){
         buffers_info_type &info = get_curr_buffer_info();
         metadata = info.metadata;
 
@@ -706,9 +1812,17 @@ private:
         _convert_bytes_to_copy = bytes_to_copy;
 
         //perform N channels of conversion
-        for (size_t i = 0; i < this->size(); i++) {
-            convert_to_out_buff(i);
+        const int64_t convert_start_ns = _hist_enabled? stats_time_now_ns() : 0;
+        if (_converter_tasks.empty()) {
+            for (size_t i = 0; i < this->size(); i++) {
+                convert_to_out_buff(i);
+            }
+        } else {
+            _task_barrier_entry->wait();
+            convert_thread_share(0);
+            _task_barrier_exit->wait();
         }
+        if (_hist_enabled) _hist.convert.record(uint64_t(stats_time_now_ns() - convert_start_ns));
 
         //update the copy buffer's availability
         info.data_bytes_to_copy -= bytes_to_copy;
@@ -721,6 +1835,77 @@ private:
         return nsamps_to_copy_per_io_buff;
     }
 
+    //! Can this call take the fixed spp path, see set_fixed_spp()
+    UHD_INLINE bool is_fixed_spp_call(const size_t nsamps_per_buff){
+        return _fixed_spp != 0 and nsamps_per_buff != 0 and nsamps_per_buff % _fixed_spp == 0
+            and _num_outputs == 1 and _converter_tasks.empty()
+            and not _has_host_work and not _hist_enabled
+            and get_curr_buffer_info().data_bytes_to_copy == 0;
+    }
+
+    /*******************************************************************
+     * Receive with a fixed spp:
+     * Each full packet is converted whole into the user buffers, for a
+     * compile time number of channels (0 for any). A packet of another
+     * size, an error, or a packet that does not fit anymore is the
+     * exceptional case and goes through convert_curr_packet().
+     * The metadata is returned like recv_converted() does.
+     ******************************************************************/
+    template <size_t num_chans>
+    size_t recv_fixed_spp(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
+    ){
+        const size_t nchans = (num_chans == 0)? this->size() : num_chans;
+        const size_t spp = _fixed_spp;
+        const size_t packet_bytes = spp*_bytes_per_otw_item;
+        const std::vector<uhd::convert::converter::sptr> &converters = _use_nt? _nt_converters : _converters;
+
+        uhd::rx_metadata_t *md = &metadata;
+        size_t accum_num_samps = 0;
+        while (true){
+            get_aligned_buffs(timeout);
+            buffers_info_type &info = get_curr_buffer_info();
+
+            size_t num_samps;
+            if (info.data_bytes_to_copy == packet_bytes and nsamps_per_buff - accum_num_samps >= spp){
+                *md = info.metadata;
+                md->more_fragments = false;
+                md->fragment_offset = 0;
+                const size_t buffer_offset_bytes = accum_num_samps*_bytes_per_cpu_item;
+                for (size_t i = 0; i < nchans; i++){
+                    UHD_TRACE_SCOPE(POINT_RECV_CONVERT, i);
+                    void *out = reinterpret_cast<char *>(buffs[i]) + buffer_offset_bytes;
+                    converters[i]->conv(info[i].copy_buff, out, spp);
+                    UHD_TRACE_INSTANT(POINT_RECV_BUFF_RELEASE, i);
+                    info[i].buff.reset();
+                }
+                info.data_bytes_to_copy = 0;
+                info.fragment_offset_in_samps = spp;
+                num_samps = spp;
+            }
+            else{
+                num_samps = convert_curr_packet(
+                    buffs, nsamps_per_buff - accum_num_samps, *md, accum_num_samps*_bytes_per_cpu_item
+                );
+            }
+
+            //an error after the first packet is stored for the next call
+            if (md != &metadata and md->error_code != rx_metadata_t::ERROR_CODE_NONE){
+                _queue_error_for_next_call = true;
+                break;
+            }
+            accum_num_samps += num_samps;
+            if (one_packet or md->end_of_burst or md->error_code != rx_metadata_t::ERROR_CODE_NONE) break;
+            if (accum_num_samps >= nsamps_per_buff) break;
+            md = &_queue_metadata;
+        }
+        return accum_num_samps;
+    }
+
     /*! Run the conversion from the internal buffers to the user's output
      *  buffer.
      *
@@ -730,6 +1915,8 @@ private:
      */
     inline void convert_to_out_buff(const size_t index)
     {
+        UHD_TRACE_SCOPE(POINT_RECV_CONVERT, index);
+
         //shortcut references to local data structures
         buffers_info_type &buff_info = get_curr_buffer_info();
         per_buffer_info_type &info = buff_info[index];
@@ -743,24 +1930,108 @@ private:
         }
         const ref_vector<void *> out_buffs(io_buffs, _num_outputs);
 
+        //run the host block on the samples in the transport buffer,
+        //the frames of all transports are writable memory
+        if (_props[index].host_work){
+            _props[index].host_work(const_cast<char *>(info.copy_buff), _convert_bytes_to_copy/_bytes_per_otw_item);
+        }
+
         //perform the conversion operation
-        _converter->conv(info.copy_buff, out_buffs, _convert_nsamps);
+        (_use_nt? _nt_converters : _converters)[index]->conv(info.copy_buff, out_buffs, _convert_nsamps);
 
         //advance the pointer for the source buffer
         info.copy_buff += _convert_bytes_to_copy;
 
         //release the buffer if fully consumed
         if (buff_info.data_bytes_to_copy == _convert_bytes_to_copy){
+            UHD_TRACE_INSTANT(POINT_RECV_BUFF_RELEASE, index);
             info.buff.reset(); //effectively a release
         }
     }
 
+    //! Convert all channels assigned to the given converter thread
+    UHD_INLINE void convert_thread_share(const size_t thread_index)
+    {
+        const size_t num_threads = _converter_thread_states.size();
+        for (size_t i = thread_index; i < this->size(); i += num_threads) {
+            convert_to_out_buff(i);
+        }
+    }
+
+    //! The loop body of a helper converter thread
+    void converter_thread_task(const size_t thread_index)
+    {
+        converter_thread_state_type &state = _converter_thread_states[thread_index];
+        if (not state.pinned){
+            state.pinned = true;
+            try{
+                uhd::set_thread_affinity(state.cpus);
+            }catch(const std::exception &e){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to pin converter thread %u to CPU %u.\n%s\n"
+                ) % thread_index % state.cpus.front() % e.what();
+            }
+        }
+        _task_barrier_entry->wait();
+        convert_thread_share(thread_index);
+        _task_barrier_exit->wait();
+    }
+
+    //! Get a getter for the buffers of a channel's transport
+    get_buffs_type get_xport_chan_get_buffs(const size_t index){
+        const xport_chan_props_type &props = _props[index];
+        if (props.xport) return boost::bind(&zero_copy_if::get_recv_buffs, props.xport, _1, _2, _3);
+        if (props.get_buffs) return props.get_buffs;
+        return boost::bind(&recv_packet_handler::get_one_buff, props.get_buff, _1, _2, _3);
+    }
+
+    //! Get the buffers of a channel with a single buffer getter
+    static size_t get_one_buff(
+        const get_buff_type &get_buff, managed_recv_buffer::sptr *buffs,
+        const size_t num_buffs, const double timeout
+    ){
+        if (num_buffs == 0) return 0;
+        buffs[0] = get_buff(timeout);
+        return buffs[0]? 1 : 0;
+    }
+
+    //! Stop and join the receive threads, the rings are lost
+    void stop_mboard_threads(void)
+    {
+        for (size_t i = 0; i < _props.size(); i++) _props[i].ring = NULL;
+        _mboard_threads.clear();
+    }
+
+    //! Stop and join all helper converter threads
+    void stop_converter_threads(void)
+    {
+        if (_task_barrier_entry) _task_barrier_entry->interrupt();
+        if (_task_barrier_exit) _task_barrier_exit->interrupt();
+        _converter_tasks.clear();
+        _converter_thread_states.clear();
+        _task_barrier_entry.reset();
+        _task_barrier_exit.reset();
+    }
+
     //! Shared variables for the worker threads
     size_t _convert_nsamps;
     const rx_streamer::buffs_type *_convert_buffs;
     size_t _convert_buffer_offset_bytes;
     size_t _convert_bytes_to_copy;
 
+    //! Per-thread state, only touched by the owning helper thread
+    struct converter_thread_state_type{
+        converter_thread_state_type(void): pinned(true) {}
+        std::vector<size_t> cpus;
+        bool pinned;
+    };
+    std::vector<converter_thread_state_type> _converter_thread_states;
+    std::vector<task::sptr> _converter_tasks;
+    boost::shared_ptr<reusable_barrier> _task_barrier_entry, _task_barrier_exit;
+
+    //! The receive threads of set_mboard_threads(), one per motherboard
+    std::vector<mboard_recv_thread::sptr> _mboard_threads;
+
     /*
      * This last section is only for debugging purposes.
      * It causes a lot of prints to stderr which can be piped to a file.
@@ -829,13 +2100,19 @@ public:
     }
 
     size_t get_num_channels(void) const{
-        return this->size();
+        return this->get_num_host_chans();
     }
 
     size_t get_max_num_samps(void) const{
         return _max_num_samps;
     }
 
+    //! Apply the converter thread and warm start stream args, see the handler
+    void apply_stream_args(const uhd::device_addr_t &args){
+        recv_packet_handler::set_converter_threads(args);
+        recv_packet_handler::warm_start(args, _max_num_samps);
+    }
+
     size_t recv(
         const rx_streamer::buffs_type &buffs,
         const size_t nsamps_per_buff,
@@ -846,11 +2123,43 @@ public:
         return recv_packet_handler::recv(buffs, nsamps_per_buff, metadata, timeout, one_packet);
     }
 
+    size_t recv_borrowed(
+        borrowed_packet_t &packet,
+        uhd::rx_metadata_t &metadata,
+        const double timeout
+    ){
+        return recv_packet_handler::recv_borrowed(packet, metadata, timeout);
+    }
+
+    size_t recv_packets(
+        const rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        std::vector<packet_metadata_t> &packets,
+        const double timeout
+    ){
+        return recv_packet_handler::recv_packets(buffs, nsamps_per_buff, packets, timeout);
+    }
+
     void issue_stream_cmd(const stream_cmd_t &stream_cmd)
     {
         return recv_packet_handler::issue_stream_cmd(stream_cmd);
     }
 
+    void set_histograms_enabled(const bool enb)
+    {
+        recv_packet_handler::set_histograms_enabled(enb);
+    }
+
+    histograms_t get_histograms(void) const
+    {
+        return recv_packet_handler::get_histograms();
+    }
+
+    bool get_psd(psd_t &psd, const size_t chan, const double timeout)
+    {
+        return recv_packet_handler::get_psd(psd, chan, timeout);
+    }
+
 private:
     size_t _max_num_samps;
 };
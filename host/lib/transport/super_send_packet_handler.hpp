@@ -19,20 +19,37 @@
 #define INCLUDED_LIBUHD_TRANSPORT_SUPER_SEND_PACKET_HANDLER_HPP
 
 #include "../rfnoc/tx_stream_terminator.hpp"
+#include "stream_resampler.hpp"
+#include "xport_stats.hpp"
+#include "burst_ack_tracker.hpp"
+#include "chan_worker_pool.hpp"
+#include "stream_warm_start.hpp"
+#include "stream_cpus_arg.hpp"
+#include "chdr_codec.hpp"
 #include <uhd/config.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/stream.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/tasks.hpp>
+#include <uhd/utils/atomic.hpp>
 #include <uhd/utils/byteswap.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <uhd/utils/trace.hpp>
 #include <uhd/types/metadata.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
+#include <uhd/transport/chdr.hpp>
 #include <uhd/transport/zero_copy.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/thread_time.hpp>
 #include <boost/foreach.hpp>
 #include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <iostream>
 #include <vector>
 
@@ -49,6 +66,9 @@ namespace uhd {
 namespace transport {
 namespace sph {
 
+//! The default chan_spin_us stream arg, about the time of a few packets
+static const double DEFAULT_CHAN_SPIN_TIMEOUT = 100e-6;
+
 /***********************************************************************
  * Super send packet handler
  *
@@ -60,6 +80,9 @@ class send_packet_handler{
 public:
     typedef boost::function<managed_send_buffer::sptr(double)> get_buff_type;
     typedef boost::function<bool(uhd::async_metadata_t &, const double)> async_receiver_type;
+    typedef boost::function<void(const tx_streamer::async_msg_callback_t &)> async_msg_callback_setter_type;
+    typedef boost::function<void(void *, const size_t)> host_work_type;
+    typedef boost::function<size_t(void)> fc_credits_type;
     typedef void(*vrt_packer_type)(uint32_t *, vrt::if_packet_info_t &);
     //typedef boost::function<void(uint32_t *, vrt::if_packet_info_t &)> vrt_packer_type;
 
@@ -68,14 +91,15 @@ public:
      * \param size the number of transport channels
      */
     send_packet_handler(const size_t size = 1):
-        _next_packet_seq(0), _cached_metadata(false)
+        _hdr_codec(HDR_CODEC_FUNC), _next_packet_seq(0), _num_bursts_sent(0), _has_async_peek(false), _cached_metadata(false), _borrowed(false),
+        _hist_enabled(false), _hist_last_call_ns(0), _resampler(false)
     {
         this->set_enable_trailer(true);
         this->resize(size);
     }
 
     ~send_packet_handler(void){
-        /* NOP */
+        this->stop_converter_threads();
     }
 
     //! Resize the number of transport channels
@@ -84,6 +108,7 @@ public:
         _props.resize(size);
         static const uint64_t zero = 0;
         _zero_buffs.resize(size, &zero);
+        _resampler.set_num_chans(size);
     }
 
     //! Get the channel width of this handler
@@ -94,13 +119,32 @@ public:
     //! Setup the vrt packer function and offset
     void set_vrt_packer(const vrt_packer_type &vrt_packer, const size_t header_offset_words32 = 0){
         _vrt_packer = vrt_packer;
+        _hdr_codec = HDR_CODEC_FUNC;
         _header_offset_words32 = header_offset_words32;
     }
 
+    /*!
+     * Setup the inlined CHDR packer for the transport endianness.
+     * Same as set_vrt_packer() with vrt::chdr::if_hdr_pack_be/le,
+     * without the function call per packet.
+     */
+    void set_chdr_packer(const uhd::endianness_t endianness, const size_t header_offset_words32 = 0){
+        if (endianness == ENDIANNESS_BIG){
+            set_vrt_packer(&vrt::chdr::if_hdr_pack_be, header_offset_words32);
+            _hdr_codec = HDR_CODEC_CHDR_BE;
+        }
+        else{
+            set_vrt_packer(&vrt::chdr::if_hdr_pack_le, header_offset_words32);
+            _hdr_codec = HDR_CODEC_CHDR_LE;
+        }
+        for (size_t i = 0; i < this->size(); i++) update_hdr_template(i);
+    }
+
     //! Set the stream ID for a specific channel (or no SID)
     void set_xport_chan_sid(const size_t xport_chan, const bool has_sid, const uint32_t sid = 0){
         _props.at(xport_chan).has_sid = has_sid;
         _props.at(xport_chan).sid = sid;
+        update_hdr_template(xport_chan);
     }
 
     ///////// RFNOC ///////////////////
@@ -137,6 +181,7 @@ public:
     //! Set the rate of samples per second
     void set_samp_rate(const double rate){
         _samp_rate = rate;
+        _resampler.set_samp_rate(rate);
     }
 
     /*!
@@ -145,16 +190,182 @@ public:
      * \param get_buff the getter function
      */
     void set_xport_chan_get_buff(const size_t xport_chan, const get_buff_type &get_buff){
+        _props.at(xport_chan).xport.reset();
         _props.at(xport_chan).get_buff = get_buff;
     }
 
-    //! Set the conversion routine for all channels
-    void set_converter(const uhd::convert::id_type &id){
+    /*!
+     * Set the transport of a channel.
+     * The handler calls get_send_buff() of the transport directly,
+     * in place of the getter function.
+     * \param xport_chan which transport channel
+     * \param xport the transport, the handler holds a reference
+     */
+    void set_xport_chan(const size_t xport_chan, zero_copy_if::sptr xport){
+        _props.at(xport_chan).get_buff = get_buff_type();
+        _props.at(xport_chan).xport = xport;
+    }
+
+    /*!
+     * Set the flow control state of a channel, for get_buffer_status().
+     * \param xport_chan which transport channel
+     * \param get_credits returns the packets which can be sent now
+     * \param window the flow control window in packets
+     */
+    void set_xport_chan_fc_credits(const size_t xport_chan, const fc_credits_type &get_credits, const size_t window){
+        _props.at(xport_chan).get_fc_credits = get_credits;
+        _props.at(xport_chan).fc_window = window;
+    }
+
+    //! Get the state of the device buffer of a channel, see tx_streamer
+    uhd::tx_streamer::buffer_status_t get_buffer_status(const size_t xport_chan) const{
+        const xport_chan_props_type &props = _props.at(xport_chan);
+        if (not props.get_fc_credits) {
+            throw uhd::not_implemented_error("This streamer does not support get_buffer_status()");
+        }
+        const size_t credits = std::min(props.get_fc_credits(), props.fc_window);
+        uhd::tx_streamer::buffer_status_t status;
+        status.capacity_pkts = props.fc_window;
+        status.buffered_pkts = props.fc_window - credits;
+        status.capacity_samps = status.capacity_pkts*_max_samples_per_packet;
+        status.buffered_samps = status.buffered_pkts*_max_samples_per_packet;
+        status.free_samps = credits*_max_samples_per_packet;
+        return status;
+    }
+
+    /*!
+     * Set the processing of a host block for a channel.
+     * It runs in place on the samples of every packet, in the otw format,
+     * right after the conversion, see rfnoc::host_block_ctrl.
+     */
+    void set_host_work(const size_t xport_chan, const host_work_type &host_work){
+        _props.at(xport_chan).host_work = host_work;
+    }
+
+    /*!
+     * Set the conversion routine for all channels.
+     * The fastest converter is used unless the stream args
+     * select one by name with the "converter" key.
+     * The host_rate stream arg resamples the samples to the device rate
+     * before the conversion, see stream_resampler.
+     * \param id the conversion ID
+     * \param args the stream args
+     */
+    void set_converter(
+        const uhd::convert::id_type &id,
+        const uhd::device_addr_t &args = uhd::device_addr_t()
+    ){
         _num_inputs = id.num_inputs;
-        _converter = uhd::convert::get_converter(id)();
+        _converter = args.has_key("converter")?
+            uhd::convert::get_converter(id, args["converter"])() :
+            uhd::convert::get_converter(id)();
         this->set_scale_factor(32767.); //update after setting converter
         _bytes_per_otw_item = uhd::convert::get_bytes_per_item(id.output_format);
         _bytes_per_cpu_item = uhd::convert::get_bytes_per_item(id.input_format);
+        if (args.has_key("host_rate") and _num_inputs != 1){
+            throw uhd::value_error("The host_rate stream arg needs one input per channel");
+        }
+        _resampler.set_args(args, id.input_format);
+    }
+
+    /*!
+     * Spread the per-channel conversion across multiple threads.
+     *
+     * The calling thread of send() always converts its share of the
+     * channels; num_threads-1 helper threads convert the rest. Channels
+     * are assigned to threads round-robin. A value of 0 or 1 disables
+     * the helper threads and converts all channels on the caller's thread.
+     *
+     * \param num_threads the total number of converting threads
+     * \param cpus optional list of CPUs to pin the helper threads to
+     */
+    void set_converter_threads(
+        const size_t num_threads,
+        const std::vector<size_t> &cpus = std::vector<size_t>()
+    ){
+        this->stop_converter_threads();
+        const size_t num_helpers = std::min(num_threads, this->size());
+        if (num_helpers <= 1) return;
+
+        _task_barrier_entry = boost::make_shared<reusable_barrier>(num_helpers);
+        _task_barrier_exit = boost::make_shared<reusable_barrier>(num_helpers);
+        _converter_thread_states.resize(num_helpers);
+        for (size_t i = 1/*skip 0*/; i < num_helpers; i++){
+            converter_thread_state_type &state = _converter_thread_states[i];
+            state.pinned = cpus.empty();
+            if (not cpus.empty()){
+                state.cpus = std::vector<size_t>(1, cpus[(i-1) % cpus.size()]);
+            }
+        }
+        for (size_t i = 1/*skip 0*/; i < num_helpers; i++){
+            _converter_tasks.push_back(task::make(boost::bind(
+                &send_packet_handler::converter_thread_task, this, i
+            ), "tx_convert"));
+        }
+    }
+
+    /*!
+     * Convert and commit the packet of each channel on its own worker.
+     *
+     * The calling thread of send() gets the buffers of all channels,
+     * then waits until every worker has converted and committed its
+     * channel, so no channel commits a packet which another one does
+     * not send. This replaces the helper threads of set_converter_threads().
+     *
+     * \param cpus optional list of CPUs to pin the workers to
+     * \param spin_timeout the time the threads spin before they sleep
+     */
+    void set_chan_threads(
+        const std::vector<size_t> &cpus = std::vector<size_t>(),
+        const double spin_timeout = DEFAULT_CHAN_SPIN_TIMEOUT
+    ){
+        this->stop_converter_threads();
+        if (this->size() <= 1) return;
+        _chan_workers = boost::make_shared<chan_worker_pool>(this->size(), boost::bind(
+            &send_packet_handler::convert_to_in_buff, this, _1
+        ), cpus, spin_timeout, "tx_chan");
+    }
+
+    /*!
+     * Configure the converter threads from stream args.
+     * - convert_threads: the total number of converting threads
+     * - convert_cpus: space separated list of CPUs for the helper threads
+     * - chan_threads: 1 for a worker per channel, see set_chan_threads()
+     * - chan_spin_us: the time the workers spin before they sleep
+     */
+    void set_converter_threads(const uhd::device_addr_t &args){
+        const bool chan_threads = args.cast<int>("chan_threads", 0) != 0;
+        if (not args.has_key("convert_threads") and not chan_threads) return;
+        const std::vector<size_t> cpus = sph::get_cpus_arg(args, "convert_cpus");
+        if (chan_threads){
+            this->set_chan_threads(cpus, args.cast<double>("chan_spin_us", DEFAULT_CHAN_SPIN_TIMEOUT*1e6)/1e6);
+            return;
+        }
+        this->set_converter_threads(args.cast<size_t>("convert_threads", 1), cpus);
+    }
+
+    //! Run the converter once over a zeroed packet of nsamps samples
+    void warm_up_converters(const size_t nsamps){
+        sph::warm_up_converter(_converter,
+            _num_inputs, _bytes_per_cpu_item, 1, _num_inputs*_bytes_per_otw_item, nsamps);
+    }
+
+    /*!
+     * Warm start the streamer if the stream args ask for it:
+     * run the converters once on a zeroed packet, then lock the memory
+     * of the process into RAM, see sph::lock_stream_memory().
+     * - warm_start: 1 to warm start
+     * - warm_start_lock: current (default), all or none
+     * \param args the stream args
+     * \param nsamps the samples in a full packet
+     */
+    void warm_start(const uhd::device_addr_t &args, const size_t nsamps){
+        if (args.cast<int>("warm_start", 0) == 0) return;
+        const int64_t start_ns = stats_time_now_ns();
+        this->warm_up_converters(nsamps);
+        sph::lock_stream_memory(args.get("warm_start_lock", "current"));
+        UHD_MSG(status) << boost::format("TX streamer ready after a %.1f ms warm start")
+            % ((stats_time_now_ns() - start_ns)/1e6) << std::endl;
     }
 
     /*!
@@ -177,15 +388,169 @@ public:
         _async_receiver = async_receiver;
     }
 
+    //! Set the function which installs a callback for async messages
+    void set_async_msg_callback_setter(const async_msg_callback_setter_type &setter)
+    {
+        _async_msg_callback_setter = setter;
+    }
+
+    //! Set the counter of the burst acks, which the async message receiver updates
+    void set_burst_ack_tracker(burst_ack_tracker::sptr burst_acks)
+    {
+        _burst_acks = burst_acks;
+    }
+
+    size_t get_num_bursts_sent(void) const
+    {
+        if (not _burst_acks) {
+            throw uhd::not_implemented_error("This streamer does not support get_num_bursts_sent()");
+        }
+        return _num_bursts_sent;
+    }
+
+    bool wait_for_burst_ack(const size_t burst, const double timeout)
+    {
+        if (not _burst_acks) {
+            throw uhd::not_implemented_error("This streamer does not support wait_for_burst_ack()");
+        }
+        return _burst_acks->wait(burst, timeout);
+    }
+
+    //! Install a callback for async messages, see tx_streamer
+    void set_async_msg_callback(const tx_streamer::async_msg_callback_t &callback)
+    {
+        if (not _async_msg_callback_setter) {
+            throw uhd::not_implemented_error("This streamer does not support set_async_msg_callback()");
+        }
+        _async_msg_callback_setter(callback);
+    }
+
     //! Overload call to get async metadata
     bool recv_async_msg(
         uhd::async_metadata_t &async_metadata, double timeout = 0.1
     ){
+        if (_has_async_peek){
+            _has_async_peek = false;
+            async_metadata = _async_peek;
+            return true;
+        }
         if (_async_receiver) return _async_receiver(async_metadata, timeout);
         boost::this_thread::sleep(boost::posix_time::microseconds(long(timeout*1e6)));
         return false;
     }
 
+    /*!
+     * Check without blocking whether an async message is ready.
+     * A message taken for this check is kept for the next recv_async_msg().
+     * Call it from the thread calling recv_async_msg().
+     * \return true when recv_async_msg() would not wait
+     */
+    bool is_async_msg_ready(void)
+    {
+        if (not _has_async_peek and _async_receiver){
+            _has_async_peek = _async_receiver(_async_peek, 0.0);
+        }
+        return _has_async_peek;
+    }
+
+    /*******************************************************************
+     * Borrowed send:
+     * Hand out the payloads of the next frames, with the header for the
+     * given metadata already in place. See tx_streamer::get_borrowed_buffs().
+     ******************************************************************/
+    size_t get_borrowed_buffs(
+        std::vector<void *> &buffs,
+        const uhd::tx_metadata_t &metadata,
+        const double timeout
+    ){
+        buffs.clear();
+        _borrowed = false;
+        if (_resampler.enabled()){
+            throw uhd::not_implemented_error("get_borrowed_buffs() cannot resample, remove the host_rate stream arg");
+        }
+
+        //a packet of the maximum size, shortened in send_borrowed()
+        vrt::if_packet_info_t &if_packet_info = _borrowed_packet_info;
+        get_if_packet_info(metadata, _max_samples_per_packet, if_packet_info);
+        if_packet_info.num_payload_bytes = _max_samples_per_packet*_num_inputs*_bytes_per_otw_item;
+        if_packet_info.num_payload_words32 = (if_packet_info.num_payload_bytes + 3/*round up*/)/sizeof(uint32_t);
+        if_packet_info.packet_count = _next_packet_seq;
+
+        //get a buffer for each channel or timeout
+        BOOST_FOREACH(xport_chan_props_type &props, _props){
+            if (not props.buff) props.buff = get_buff(props, timeout);
+            if (not props.buff){
+                _stats.timeouts.add();
+                return 0; //timeout
+            }
+        }
+
+        //the header length depends on the metadata, pack it to find the payload
+        for (size_t i = 0; i < this->size(); i++){
+            uint32_t *otw_mem = _props[i].buff->cast<uint32_t *>() + _header_offset_words32;
+            pack_header(otw_mem, if_packet_info, i);
+            buffs.push_back(otw_mem + if_packet_info.num_header_words32);
+        }
+        _borrowed = true;
+        return _max_samples_per_packet;
+    }
+
+    size_t send_borrowed(const size_t nsamps_per_buff)
+    {
+        if (not _borrowed) throw uhd::runtime_error(
+            "send_borrowed() was called without buffers from get_borrowed_buffs()");
+        _borrowed = false;
+
+        const size_t nsamps = std::min(nsamps_per_buff, _max_samples_per_packet);
+        vrt::if_packet_info_t if_packet_info = _borrowed_packet_info;
+        if_packet_info.num_payload_bytes = nsamps*_num_inputs*_bytes_per_otw_item;
+        if_packet_info.num_payload_words32 = (if_packet_info.num_payload_bytes + 3/*round up*/)/sizeof(uint32_t);
+
+        //stamp the final lengths and commit the filled payloads
+        for (size_t i = 0; i < this->size(); i++){
+            managed_send_buffer::sptr &buff = _props[i].buff;
+            uint32_t *otw_mem = buff->cast<uint32_t *>() + _header_offset_words32;
+            pack_header(otw_mem, if_packet_info, i);
+            if (_props[i].host_work){
+                _props[i].host_work(otw_mem + if_packet_info.num_header_words32, nsamps*_num_inputs);
+            }
+            const size_t num_vita_words32 = _header_offset_words32+if_packet_info.num_packet_words32;
+            UHD_TRACE_INSTANT(POINT_SEND_BUFF_COMMIT, i);
+            buff->commit(num_vita_words32*sizeof(uint32_t));
+            buff.reset(); //effectively a release
+            _stats.packets.add();
+            _stats.bytes.add(if_packet_info.num_payload_bytes);
+        }
+        _next_packet_seq++;
+        if (if_packet_info.eob) _num_bursts_sent++;
+        return nsamps;
+    }
+
+    //! Get the counters of this streamer, see stream_stats_t
+    stream_stats_t get_stats(void) const
+    {
+        return _stats.get();
+    }
+
+    /*!
+     * Enable or disable recording the histograms of this streamer.
+     * Enabling clears the histograms. Call it while not sending.
+     */
+    void set_histograms_enabled(const bool enb)
+    {
+        if (enb and not _hist_enabled) {
+            _hist.reset();
+            _hist_last_call_ns = 0;
+        }
+        _hist_enabled = enb;
+    }
+
+    //! Get the histograms of this streamer, see stream_histograms
+    uhd::histograms_t get_histograms(void) const
+    {
+        return _hist.get(false);
+    }
+
     /*******************************************************************
      * Send:
      * The entry point for the fast-path send calls.
@@ -197,35 +562,77 @@ public:
         const uhd::tx_metadata_t &metadata,
         const double timeout
     ){
-        //translate the metadata to vrt if packet info
-        vrt::if_packet_info_t if_packet_info;
-        if_packet_info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
-        //if_packet_info.has_sid = false; //set per channel
-        if_packet_info.has_cid = false;
-        if_packet_info.has_tlr = _has_tlr;
-        if_packet_info.has_tsi = false;
-        if_packet_info.has_tsf = metadata.has_time_spec;
-        if_packet_info.tsf     = metadata.time_spec.to_ticks(_tick_rate);
-        if_packet_info.sob     = metadata.start_of_burst;
-        if_packet_info.eob     = metadata.end_of_burst;
+        if (not _hist_enabled){
+            return send_dispatch(buffs, nsamps_per_buff, metadata, timeout);
+        }
+        const uint64_t packets = _stats.packets.get();
+        const size_t nsamps = send_dispatch(buffs, nsamps_per_buff, metadata, timeout);
+        record_call_histograms(nsamps, _stats.packets.get() - packets);
+        return nsamps;
+    }
 
-        /*
-         * Metadata is cached when we get a send requesting a start of burst with no samples.
-         * It is applied here on the next call to send() that actually has samples to send.
-         */
-        if (_cached_metadata && nsamps_per_buff != 0)
-        {
-            // If the new metada has a time_spec, do not use the cached time_spec.
-            if (!metadata.has_time_spec)
-            {
-                if_packet_info.has_tsf = _metadata_cache.has_time_spec;
-                if_packet_info.tsf     = _metadata_cache.time_spec.to_ticks(_tick_rate);
-            }
-            if_packet_info.sob     = _metadata_cache.start_of_burst;
-            if_packet_info.eob     = _metadata_cache.end_of_burst;
-            _cached_metadata = false;
+    /*******************************************************************
+     * Send resampled:
+     * Resample each channel into the buffers of the resampler, then
+     * convert them while they are still in the cache. The end of a
+     * burst also sends the tail of the filters.
+     ******************************************************************/
+    size_t send_resampled(
+        const uhd::tx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const uhd::tx_metadata_t &metadata,
+        const double timeout
+    ){
+        if (metadata.start_of_burst) _resampler.reset();
+        if (metadata.has_time_spec) _resampler.set_time(metadata.time_spec);
+
+        const size_t max_outputs = _resampler[0].get_num_outputs(nsamps_per_buff) +
+            (metadata.end_of_burst? _resampler.get_num_flush_outputs() : 0);
+        const std::vector<void *> &out_buffs = _resampler.get_buffs(max_outputs);
+        size_t num_outputs = 0;
+        for (size_t i = 0; i < this->size(); i++){
+            std::complex<float> *out = reinterpret_cast<std::complex<float> *>(out_buffs[i]);
+            num_outputs = _resampler[i].process(
+                reinterpret_cast<const std::complex<float> *>(buffs[i]), nsamps_per_buff, out
+            );
+            if (metadata.end_of_burst) num_outputs += _resampler.flush(i, out + num_outputs);
+        }
+        //an empty send would pad the burst with a sample
+        if (num_outputs == 0 and not metadata.start_of_burst and not metadata.end_of_burst){
+            return nsamps_per_buff;
         }
 
+        uhd::tx_metadata_t out_metadata = metadata;
+        out_metadata.has_time_spec = metadata.has_time_spec and _resampler.has_time();
+        if (out_metadata.has_time_spec) out_metadata.time_spec = _resampler.get_time();
+        const size_t num_sent = send_converted(
+            uhd::tx_streamer::buffs_type(out_buffs), num_outputs, out_metadata, timeout
+        );
+        _resampler.add_outputs(num_sent);
+        if (metadata.end_of_burst) _resampler.reset();
+
+        //the inputs are in the filters, a timeout loses the outputs not sent
+        if (num_sent == num_outputs) return nsamps_per_buff;
+        return size_t(uint64_t(num_sent)*nsamps_per_buff/num_outputs);
+    }
+
+    /*******************************************************************
+     * Send converted:
+     * Convert the user buffers into packets at the device rate.
+     ******************************************************************/
+    UHD_INLINE size_t send_converted(
+        const uhd::tx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const uhd::tx_metadata_t &metadata,
+        const double timeout
+    ){
+        //the buffers are converted into, borrowed headers are rewritten
+        _borrowed = false;
+
+        //translate the metadata to vrt if packet info
+        vrt::if_packet_info_t if_packet_info;
+        get_if_packet_info(metadata, nsamps_per_buff, if_packet_info);
+
         if (nsamps_per_buff <= _max_samples_per_packet){
 
             //TODO remove this code when sample counts of zero are supported by hardware
@@ -295,17 +702,64 @@ public:
 
 private:
 
+    UHD_INLINE size_t send_dispatch(
+        const uhd::tx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const uhd::tx_metadata_t &metadata,
+        const double timeout
+    ){
+        if (_resampler.enabled()){
+            return send_resampled(buffs, nsamps_per_buff, metadata, timeout);
+        }
+        return send_converted(buffs, nsamps_per_buff, metadata, timeout);
+    }
+
+    //! Record the rate and packets of a call, from the end of the last call
+    void record_call_histograms(const size_t nsamps, const uint64_t num_packets){
+        const int64_t now = stats_time_now_ns();
+        if (nsamps != 0 and _hist_last_call_ns != 0 and now > _hist_last_call_ns){
+            _hist.sample_rate.record(uint64_t(nsamps*1e9/(now - _hist_last_call_ns)));
+        }
+        _hist.packets_per_call.record(num_packets/this->size());
+        _hist_last_call_ns = now;
+    }
+
     vrt_packer_type _vrt_packer;
+    enum {HDR_CODEC_FUNC, HDR_CODEC_CHDR_BE, HDR_CODEC_CHDR_LE} _hdr_codec;
     size_t _header_offset_words32;
     double _tick_rate, _samp_rate;
     struct xport_chan_props_type{
-        xport_chan_props_type(void):has_sid(false),sid(0){}
+        xport_chan_props_type(void):fc_window(0),has_sid(false),sid(0){}
+        zero_copy_if::sptr xport;
         get_buff_type get_buff;
+        host_work_type host_work;
+        fc_credits_type get_fc_credits;
+        size_t fc_window;
         bool has_sid;
         uint32_t sid;
+        vrt::chdr::header_template hdr_template; //for the CHDR codecs
         managed_send_buffer::sptr buff;
     };
     std::vector<xport_chan_props_type> _props;
+
+    //! Rebuild the header template of a channel after its SID or codec changed
+    void update_hdr_template(const size_t xport_chan){
+        xport_chan_props_type &props = _props.at(xport_chan);
+        if (_hdr_codec == HDR_CODEC_CHDR_BE){
+            props.hdr_template.set<ENDIANNESS_BIG>(vrt::if_packet_info_t::PACKET_TYPE_DATA, props.sid);
+        }
+        if (_hdr_codec == HDR_CODEC_CHDR_LE){
+            props.hdr_template.set<ENDIANNESS_LITTLE>(vrt::if_packet_info_t::PACKET_TYPE_DATA, props.sid);
+        }
+    }
+
+    //! Get a buffer from the transport, or from the getter function without one
+    static UHD_INLINE managed_send_buffer::sptr get_buff(xport_chan_props_type &props, const double timeout){
+        UHD_TRACE_SCOPE(POINT_SEND_BUFF_GET, props.sid);
+        zero_copy_if *xport = props.xport.get();
+        return xport? xport->get_send_buff(timeout) : props.get_buff(timeout);
+    }
+
     size_t _num_inputs;
     size_t _bytes_per_otw_item; //used in conversion
     size_t _bytes_per_cpu_item; //used in conversion
@@ -313,10 +767,24 @@ private:
     size_t _max_samples_per_packet;
     std::vector<const void *> _zero_buffs;
     size_t _next_packet_seq;
+    size_t _num_bursts_sent;
+    burst_ack_tracker::sptr _burst_acks;
     bool _has_tlr;
     async_receiver_type _async_receiver;
+    async_msg_callback_setter_type _async_msg_callback_setter;
+    bool _has_async_peek;
+    uhd::async_metadata_t _async_peek;
     bool _cached_metadata;
     uhd::tx_metadata_t _metadata_cache;
+    bool _borrowed;
+    vrt::if_packet_info_t _borrowed_packet_info;
+    stream_stats_counters _stats;
+    bool _hist_enabled;
+    stream_histograms _hist;
+    int64_t _hist_last_call_ns; //end of the last send() call
+
+    //! the host side resampling, enabled by the host_rate stream arg
+    stream_resampler _resampler;
 
     uhd::rfnoc::tx_stream_terminator::sptr _terminator;
 
@@ -368,6 +836,58 @@ private:
     /*******************************************************************
      * Send a single packet:
      ******************************************************************/
+    /*!
+     * Translate the metadata into the packet info of the next packet.
+     * Metadata is cached when we get a send requesting a start of burst with no samples.
+     * It is applied here on the next call to send() that actually has samples to send.
+     */
+    UHD_INLINE void get_if_packet_info(
+        const uhd::tx_metadata_t &metadata,
+        const size_t nsamps_per_buff,
+        vrt::if_packet_info_t &if_packet_info
+    ){
+        if_packet_info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+        //if_packet_info.has_sid = false; //set per channel
+        if_packet_info.has_cid = false;
+        if_packet_info.has_tlr = _has_tlr;
+        if_packet_info.has_tsi = false;
+        if_packet_info.has_tsf = metadata.has_time_spec;
+        if_packet_info.tsf     = metadata.time_spec.to_ticks(_tick_rate);
+        if_packet_info.sob     = metadata.start_of_burst;
+        if_packet_info.eob     = metadata.end_of_burst;
+
+        if (_cached_metadata && nsamps_per_buff != 0)
+        {
+            // If the new metada has a time_spec, do not use the cached time_spec.
+            if (!metadata.has_time_spec)
+            {
+                if_packet_info.has_tsf = _metadata_cache.has_time_spec;
+                if_packet_info.tsf     = _metadata_cache.time_spec.to_ticks(_tick_rate);
+            }
+            if_packet_info.sob     = _metadata_cache.start_of_burst;
+            if_packet_info.eob     = _metadata_cache.end_of_burst;
+            _cached_metadata = false;
+        }
+    }
+
+    /*!
+     * Pack the header of a channel with the configured packer.
+     * The CHDR codecs patch the channel's prebuilt header template,
+     * other packers get the SID of the channel in the packet info.
+     */
+    UHD_INLINE void pack_header(uint32_t *otw_mem, vrt::if_packet_info_t &if_packet_info, const size_t index)
+    {
+        const xport_chan_props_type &props = _props[index];
+        switch (_hdr_codec){
+        case HDR_CODEC_CHDR_BE: props.hdr_template.pack<ENDIANNESS_BIG>(otw_mem, if_packet_info); break;
+        case HDR_CODEC_CHDR_LE: props.hdr_template.pack<ENDIANNESS_LITTLE>(otw_mem, if_packet_info); break;
+        default:
+            if_packet_info.has_sid = props.has_sid;
+            if_packet_info.sid = props.sid;
+            _vrt_packer(otw_mem, if_packet_info);
+        }
+    }
+
     UHD_INLINE size_t send_one_packet(
         const uhd::tx_streamer::buffs_type &buffs,
         const size_t nsamps_per_buff,
@@ -382,10 +902,16 @@ private:
         if_packet_info.packet_count = _next_packet_seq;
 
         //get a buffer for each channel or timeout
+        const int64_t wait_start_ns = _hist_enabled? stats_time_now_ns() : 0;
         BOOST_FOREACH(xport_chan_props_type &props, _props){
-            if (not props.buff) props.buff = props.get_buff(timeout);
-            if (not props.buff) return 0; //timeout
+            if (not props.buff) props.buff = get_buff(props, timeout);
+            if (not props.buff){
+                _stats.timeouts.add();
+                return 0; //timeout
+            }
         }
+        const int64_t convert_start_ns = _hist_enabled? stats_time_now_ns() : 0;
+        if (_hist_enabled) _hist.xport_wait.record(uint64_t(convert_start_ns - wait_start_ns));
 
         //setup the data to share with converter threads
         _convert_nsamps = nsamps_per_buff;
@@ -394,11 +920,21 @@ private:
         _convert_if_packet_info = &if_packet_info;
 
         //perform N channels of conversion
-        for (size_t i = 0; i < this->size(); i++) {
-            convert_to_in_buff(i);
+        if (_chan_workers) {
+            _chan_workers->run();
+        } else if (_converter_tasks.empty()) {
+            for (size_t i = 0; i < this->size(); i++) {
+                convert_to_in_buff(i);
+            }
+        } else {
+            _task_barrier_entry->wait();
+            convert_thread_share(0);
+            _task_barrier_exit->wait();
         }
+        if (_hist_enabled) _hist.convert.record(uint64_t(stats_time_now_ns() - convert_start_ns));
 
         _next_packet_seq++; //increment sequence after commits
+        if (if_packet_info.eob) _num_bursts_sent++;
         return nsamps_per_buff;
     }
 
@@ -411,6 +947,8 @@ private:
      */
     UHD_INLINE void convert_to_in_buff(const size_t index)
     {
+        UHD_TRACE_SCOPE(POINT_SEND_CONVERT, index);
+
         //shortcut references to local data structures
         managed_send_buffer::sptr &buff = _props[index].buff;
         vrt::if_packet_info_t if_packet_info = *_convert_if_packet_info;
@@ -426,18 +964,60 @@ private:
 
         //pack metadata into a vrt header
         uint32_t *otw_mem = buff->cast<uint32_t *>() + _header_offset_words32;
-        if_packet_info.has_sid = _props[index].has_sid;
-        if_packet_info.sid = _props[index].sid;
-        _vrt_packer(otw_mem, if_packet_info);
+        pack_header(otw_mem, if_packet_info, index);
         otw_mem += if_packet_info.num_header_words32;
 
         //perform the conversion operation
         _converter->conv(in_buffs, otw_mem, _convert_nsamps);
+        if (_props[index].host_work) _props[index].host_work(otw_mem, _convert_nsamps*_num_inputs);
 
         //commit the samples to the zero-copy interface
         const size_t num_vita_words32 = _header_offset_words32+if_packet_info.num_packet_words32;
+        UHD_TRACE_INSTANT(POINT_SEND_BUFF_COMMIT, index);
         buff->commit(num_vita_words32*sizeof(uint32_t));
         buff.reset(); //effectively a release
+        _stats.packets.add();
+        _stats.bytes.add(if_packet_info.num_payload_bytes);
+    }
+
+    //! Convert all channels assigned to the given converter thread
+    UHD_INLINE void convert_thread_share(const size_t thread_index)
+    {
+        const size_t num_threads = _converter_thread_states.size();
+        for (size_t i = thread_index; i < this->size(); i += num_threads) {
+            convert_to_in_buff(i);
+        }
+    }
+
+    //! The loop body of a helper converter thread
+    void converter_thread_task(const size_t thread_index)
+    {
+        converter_thread_state_type &state = _converter_thread_states[thread_index];
+        if (not state.pinned){
+            state.pinned = true;
+            try{
+                uhd::set_thread_affinity(state.cpus);
+            }catch(const std::exception &e){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to pin converter thread %u to CPU %u.\n%s\n"
+                ) % thread_index % state.cpus.front() % e.what();
+            }
+        }
+        _task_barrier_entry->wait();
+        convert_thread_share(thread_index);
+        _task_barrier_exit->wait();
+    }
+
+    //! Stop and join all helper converter threads
+    void stop_converter_threads(void)
+    {
+        _chan_workers.reset();
+        if (_task_barrier_entry) _task_barrier_entry->interrupt();
+        if (_task_barrier_exit) _task_barrier_exit->interrupt();
+        _converter_tasks.clear();
+        _converter_thread_states.clear();
+        _task_barrier_entry.reset();
+        _task_barrier_exit.reset();
     }
 
     //! Shared variables for the worker threads
@@ -446,6 +1026,19 @@ private:
     size_t _convert_buffer_offset_bytes;
     vrt::if_packet_info_t *_convert_if_packet_info;
 
+    //! Per-thread state, only touched by the owning helper thread
+    struct converter_thread_state_type{
+        converter_thread_state_type(void): pinned(true) {}
+        std::vector<size_t> cpus;
+        bool pinned;
+    };
+    std::vector<converter_thread_state_type> _converter_thread_states;
+    std::vector<task::sptr> _converter_tasks;
+    boost::shared_ptr<reusable_barrier> _task_barrier_entry, _task_barrier_exit;
+
+    //! The workers of set_chan_threads(), instead of the helper threads
+    chan_worker_pool::sptr _chan_workers;
+
 };
 
 class send_packet_streamer : public send_packet_handler, public tx_streamer{
@@ -463,6 +1056,12 @@ public:
         return _max_num_samps;
     }
 
+    //! Apply the converter thread and warm start stream args, see the handler
+    void apply_stream_args(const uhd::device_addr_t &args){
+        send_packet_handler::set_converter_threads(args);
+        send_packet_handler::warm_start(args, _max_num_samps);
+    }
+
     size_t send(
         const tx_streamer::buffs_type &buffs,
         const size_t nsamps_per_buff,
@@ -472,12 +1071,55 @@ public:
         return send_packet_handler::send(buffs, nsamps_per_buff, metadata, timeout);
     }
 
+    size_t get_borrowed_buffs(
+        std::vector<void *> &buffs,
+        const uhd::tx_metadata_t &metadata,
+        const double timeout
+    ){
+        return send_packet_handler::get_borrowed_buffs(buffs, metadata, timeout);
+    }
+
+    size_t send_borrowed(const size_t nsamps_per_buff)
+    {
+        return send_packet_handler::send_borrowed(nsamps_per_buff);
+    }
+
     bool recv_async_msg(
         uhd::async_metadata_t &async_metadata, double timeout = 0.1
     ){
         return send_packet_handler::recv_async_msg(async_metadata, timeout);
     }
 
+    void set_async_msg_callback(const async_msg_callback_t &callback)
+    {
+        send_packet_handler::set_async_msg_callback(callback);
+    }
+
+    size_t get_num_bursts_sent(void) const
+    {
+        return send_packet_handler::get_num_bursts_sent();
+    }
+
+    bool wait_for_burst_ack(const size_t burst, const double timeout)
+    {
+        return send_packet_handler::wait_for_burst_ack(burst, timeout);
+    }
+
+    void set_histograms_enabled(const bool enb)
+    {
+        send_packet_handler::set_histograms_enabled(enb);
+    }
+
+    histograms_t get_histograms(void) const
+    {
+        return send_packet_handler::get_histograms();
+    }
+
+    buffer_status_t get_buffer_status(const size_t chan) const
+    {
+        return send_packet_handler::get_buffer_status(chan);
+    }
+
 private:
     size_t _max_num_samps;
 };
@@ -16,22 +16,98 @@
 //
 
 #include "udp_common.hpp"
+#include "packet_framing.hpp"
 #include <uhd/transport/tcp_zero_copy.hpp>
 #include <uhd/transport/buffer_pool.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/atomic.hpp>
+#include <uhd/utils/safe_call.hpp>
+#include <uhd/exception.hpp>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/thread/thread.hpp> //sleep
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
 #include <vector>
 
+#ifndef UHD_PLATFORM_WIN32
+#include <sys/uio.h> //writev
+#include <netinet/tcp.h> //TCP_NOTSENT_LOWAT
+#endif
+
 using namespace uhd;
 using namespace uhd::transport;
 namespace asio = boost::asio;
 
 static const size_t DEFAULT_NUM_FRAMES = 32;
 static const size_t DEFAULT_FRAME_SIZE = 2048;
+static const size_t DEFAULT_RECV_CHUNK_SIZE = 256*1024;
+
+/***********************************************************************
+ * Framed reader:
+ * Reads the socket in large chunks into a ring and carves the packets
+ * out of it by the length in their first header word, see the tcp_framing
+ * hint. A partial packet at the end is moved to the start of the
+ * ring before the next read.
+ **********************************************************************/
+class tcp_framed_reader{
+public:
+    tcp_framed_reader(int sock_fd, const packet_framing_params_t &params, const size_t chunk_size):
+        _sock_fd(sock_fd), _params(params), _ring(chunk_size), _head(0), _tail(0) { /*NOP*/ }
+
+    /*!
+     * Copy the next packet into a frame.
+     * \return the length of the packet, 0 for timeout
+     */
+    size_t next_packet(void *frame, const size_t frame_size, const double timeout){
+        while (true){
+            const size_t avail = _tail - _head;
+            size_t len = 0;
+            if (avail >= sizeof(uint32_t)){
+                len = get_packet_len(_params, get_header_word(_params, &_ring[_head]));
+                if (len < sizeof(uint32_t) or len > frame_size or len > _ring.size()) throw uhd::io_error(str(
+                    boost::format("tcp framing lost: a packet of %u bytes for frames of %u bytes") % len % frame_size));
+                if (avail >= len){
+                    std::memcpy(frame, &_ring[_head], len);
+                    _head += len;
+                    return len;
+                }
+            }
+            if (_head + std::max(len, sizeof(uint32_t)) > _ring.size()){
+                std::memmove(&_ring.front(), &_ring[_head], avail);
+                _head = 0;
+                _tail = avail;
+            }
+            if (not this->read_some(timeout)) return 0;
+        }
+    }
+
+private:
+    bool read_some(const double timeout){
+        char *mem = &_ring[_tail];
+        const size_t space = _ring.size() - _tail;
+        ssize_t ret = -1;
+        #ifdef MSG_DONTWAIT //try a non-blocking recv() if supported
+        ret = ::recv(_sock_fd, mem, space, MSG_DONTWAIT);
+        #endif
+        if (ret < 0){
+            if (not wait_for_recv_ready(_sock_fd, timeout)) return false;
+            ret = ::recv(_sock_fd, mem, space, 0);
+        }
+        if (ret == 0) throw uhd::io_error("tcp socket closed");
+        if (ret < 0) throw uhd::io_error(str(boost::format("recv error on tcp socket: %s") % strerror(errno)));
+        _tail += size_t(ret);
+        return true;
+    }
+
+    const int _sock_fd;
+    const packet_framing_params_t _params;
+    std::vector<char> _ring;
+    size_t _head, _tail;
+};
 
 /***********************************************************************
  * Reusable managed receiver buffer:
@@ -67,6 +143,18 @@ public:
         return sptr(); //null for timeout
     }
 
+    //! Take the next packet of the framed reader instead of a read
+    UHD_INLINE sptr get_carved(tcp_framed_reader &reader, const double timeout, size_t &index){
+        if (not _claimer.claim_with_wait(timeout)) return sptr();
+        const size_t len = reader.next_packet(_mem, _frame_size, timeout);
+        if (len == 0){
+            _claimer.release(); //undo claim
+            return sptr(); //null for timeout
+        }
+        index++; //advances the caller's buffer
+        return make(this, _mem, len);
+    }
+
 private:
     void *_mem;
     int _sock_fd;
@@ -79,12 +167,26 @@ private:
  * Reusable managed send buffer:
  *  - commit performs the send operation
  **********************************************************************/
+class tcp_send_queue;
+
 class tcp_zero_copy_asio_msb : public managed_send_buffer{
 public:
-    tcp_zero_copy_asio_msb(void *mem, int sock_fd, const size_t frame_size):
-        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size) { /*NOP*/ }
+    tcp_zero_copy_asio_msb(void *mem, int sock_fd, const size_t frame_size, tcp_send_queue *send_queue = NULL):
+        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size), _send_queue(send_queue) { /*NOP*/ }
 
-    void release(void){
+    void release(void);
+
+    //! Called by the send queue once the frame went out
+    UHD_INLINE void sent(void){
+        _claimer.release();
+    }
+
+    UHD_INLINE const void *get_mem(void) const{
+        return _mem;
+    }
+
+    //! Send the frame at its full size, so that the reads stay aligned to frames
+    void release_padded(void){
         //Retry logic because send may fail with ENOBUFS.
         //This is known to occur at least on some OSX systems.
         //But it should be safe to always check for the error.
@@ -113,9 +215,102 @@ private:
     void *_mem;
     int _sock_fd;
     size_t _frame_size;
+    tcp_send_queue *_send_queue;
     simple_claimer _claimer;
 };
 
+/***********************************************************************
+ * Send queue of the framed mode:
+ * Committed frames are queued and go out together with writev() once
+ * the batch is full. A packet which ends a burst or is not a data packet
+ * flushes the queue, so it is never held back.
+ **********************************************************************/
+class tcp_send_queue{
+public:
+    tcp_send_queue(int sock_fd, const packet_framing_params_t &params, const size_t batch):
+        _sock_fd(sock_fd), _params(params), _batch(batch)
+    {
+        _msbs.reserve(_batch);
+        _lens.reserve(_batch);
+    }
+
+    void push(tcp_zero_copy_asio_msb *msb){
+        _msbs.push_back(msb);
+        _lens.push_back(msb->size());
+        const uint32_t word = get_header_word(_params, msb->get_mem());
+        if (_msbs.size() >= _batch or not is_mid_burst_data(_params, word)) this->flush();
+    }
+
+    //! Is the frame waiting in the queue?
+    bool holds(const tcp_zero_copy_asio_msb *msb) const{
+        return std::find(_msbs.begin(), _msbs.end(), msb) != _msbs.end();
+    }
+
+    void flush(void){
+        if (_msbs.empty()) return;
+        #ifdef UHD_PLATFORM_WIN32
+        for (size_t i = 0; i < _msbs.size(); i++) this->send_all(_msbs[i]->get_mem(), _lens[i]);
+        #else
+        _iovs.resize(_msbs.size());
+        for (size_t i = 0; i < _msbs.size(); i++){
+            _iovs[i].iov_base = const_cast<void *>(_msbs[i]->get_mem());
+            _iovs[i].iov_len = _lens[i];
+        }
+        //a stream socket may take part of the frames, send the rest after them
+        iovec *iov = &_iovs.front();
+        size_t num_iovs = _iovs.size();
+        while (num_iovs != 0){
+            const ssize_t ret = ::writev(_sock_fd, iov, int(std::min<size_t>(num_iovs, IOV_MAX)));
+            if (ret < 0){
+                if (errno == ENOBUFS or errno == EAGAIN or errno == EINTR){
+                    boost::this_thread::sleep(boost::posix_time::microseconds(1));
+                    continue; //try to send again
+                }
+                throw uhd::io_error(str(boost::format("send error on tcp socket: %s") % strerror(errno)));
+            }
+            size_t num_bytes = size_t(ret);
+            while (num_iovs != 0 and num_bytes >= iov->iov_len){
+                num_bytes -= iov->iov_len;
+                iov++;
+                num_iovs--;
+            }
+            if (num_iovs != 0){
+                iov->iov_base = static_cast<char *>(iov->iov_base) + num_bytes;
+                iov->iov_len -= num_bytes;
+            }
+        }
+        #endif
+        for (size_t i = 0; i < _msbs.size(); i++) _msbs[i]->sent();
+        _msbs.clear();
+        _lens.clear();
+    }
+
+private:
+    #ifdef UHD_PLATFORM_WIN32
+    void send_all(const void *mem, const size_t len){
+        size_t num_sent = 0;
+        while (num_sent < len){
+            const int ret = ::send(_sock_fd, static_cast<const char *>(mem) + num_sent, int(len - num_sent), 0);
+            if (ret < 0) throw uhd::io_error("send error on tcp socket");
+            num_sent += size_t(ret);
+        }
+    }
+    #else
+    std::vector<iovec> _iovs;
+    #endif
+
+    const int _sock_fd;
+    const packet_framing_params_t _params;
+    const size_t _batch;
+    std::vector<tcp_zero_copy_asio_msb *> _msbs;
+    std::vector<size_t> _lens;
+};
+
+void tcp_zero_copy_asio_msb::release(void){
+    if (_send_queue != NULL) _send_queue->push(this);
+    else this->release_padded();
+}
+
 tcp_zero_copy::~tcp_zero_copy(void){
     /* NOP */
 }
@@ -142,7 +337,8 @@ public:
         _num_send_frames(size_t(hints.cast<double>("num_send_frames", DEFAULT_NUM_FRAMES))),
         _recv_buffer_pool(buffer_pool::make(_num_recv_frames, _recv_frame_size)),
         _send_buffer_pool(buffer_pool::make(_num_send_frames, _send_frame_size)),
-        _next_recv_buff_index(0), _next_send_buff_index(0)
+        _next_recv_buff_index(0), _next_send_buff_index(0),
+        _framing(get_packet_framing_params("tcp_framing", hints.get("tcp_framing", "none")))
     {
         UHD_LOG << boost::format("Creating tcp transport for %s %s") % addr % port << std::endl;
 
@@ -151,14 +347,21 @@ public:
         asio::ip::tcp::resolver::query query(asio::ip::tcp::v4(), addr, port);
         asio::ip::tcp::endpoint receiver_endpoint = *resolver.resolve(query);
 
-        //create, open, and connect the socket
+        //create, open, and connect the socket,
+        //the buffer sizes must be set before the connect to scale the window
         _socket.reset(new asio::ip::tcp::socket(_io_service));
-        _socket->connect(receiver_endpoint);
+        _socket->open(asio::ip::tcp::v4());
         _sock_fd = _socket->native();
+        this->set_socket_options(hints);
+        _socket->connect(receiver_endpoint);
 
-        //packets go out ASAP
-        asio::ip::tcp::no_delay option(true);
-        _socket->set_option(option);
+        //the framed mode reads chunks and sends batches of frames
+        if (_framing.type != PACKET_FRAMING_NONE){
+            _reader.reset(new tcp_framed_reader(_sock_fd, _framing,
+                std::max(size_t(hints.cast<double>("tcp_recv_chunk", DEFAULT_RECV_CHUNK_SIZE)), 2*_recv_frame_size)));
+            _send_queue.reset(new tcp_send_queue(_sock_fd, _framing,
+                std::max<size_t>(1, std::min(size_t(hints.cast<double>("tcp_send_batch", 16)), _num_send_frames))));
+        }
 
         //allocate re-usable managed receive buffers
         for (size_t i = 0; i < get_num_recv_frames(); i++){
@@ -170,17 +373,50 @@ public:
         //allocate re-usable managed send buffers
         for (size_t i = 0; i < get_num_send_frames(); i++){
             _msb_pool.push_back(boost::make_shared<tcp_zero_copy_asio_msb>(
-                _send_buffer_pool->at(i), _sock_fd, get_send_frame_size()
+                _send_buffer_pool->at(i), _sock_fd, get_send_frame_size(), _send_queue.get()
             ));
         }
     }
 
+    ~tcp_zero_copy_asio_impl(void){
+        if (_send_queue) UHD_SAFE_CALL(_send_queue->flush();)
+    }
+
+    void set_socket_options(const device_addr_t &hints){
+        //packets go out ASAP by default
+        _socket->set_option(asio::ip::tcp::no_delay(hints.cast<int>("tcp_nodelay", 1) != 0));
+
+        if (hints.has_key("recv_buff_size")){
+            _socket->set_option(asio::socket_base::receive_buffer_size(
+                int(hints.cast<double>("recv_buff_size", 0))));
+        }
+        if (hints.has_key("send_buff_size")){
+            _socket->set_option(asio::socket_base::send_buffer_size(
+                int(hints.cast<double>("send_buff_size", 0))));
+        }
+
+        //limit the unsent bytes in the kernel, Linux only takes TCP_NOTSENT_LOWAT
+        if (hints.has_key("tcp_send_lowat")){
+            const int lowat = int(hints.cast<double>("tcp_send_lowat", 0));
+            #if defined(TCP_NOTSENT_LOWAT)
+            const int ret = ::setsockopt(_sock_fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &lowat, sizeof(lowat));
+            #elif defined(SO_SNDLOWAT)
+            const int ret = ::setsockopt(_sock_fd, SOL_SOCKET, SO_SNDLOWAT, (const char *)&lowat, sizeof(lowat));
+            #else
+            const int ret = -1;
+            #endif
+            if (ret != 0) UHD_MSG(warning) << boost::format(
+                "Unable to set the send low-water mark of the tcp socket to %d bytes.") % lowat << std::endl;
+        }
+    }
+
     /*******************************************************************
      * Receive implementation:
      * Block on the managed buffer's get call and advance the index.
      ******************************************************************/
     managed_recv_buffer::sptr get_recv_buff(double timeout){
         if (_next_recv_buff_index == _num_recv_frames) _next_recv_buff_index = 0;
+        if (_reader) return _mrb_pool[_next_recv_buff_index]->get_carved(*_reader, timeout, _next_recv_buff_index);
         return _mrb_pool[_next_recv_buff_index]->get_new(timeout, _next_recv_buff_index);
     }
 
@@ -193,6 +429,8 @@ public:
      ******************************************************************/
     managed_send_buffer::sptr get_send_buff(double timeout){
         if (_next_send_buff_index == _num_send_frames) _next_send_buff_index = 0;
+        //a frame still waiting in the send queue goes out now
+        if (_send_queue and _send_queue->holds(_msb_pool[_next_send_buff_index].get())) _send_queue->flush();
         return _msb_pool[_next_send_buff_index]->get_new(timeout, _next_send_buff_index);
     }
 
@@ -212,6 +450,11 @@ private:
     asio::io_service        _io_service;
     boost::shared_ptr<asio::ip::tcp::socket> _socket;
     int                     _sock_fd;
+
+    //framed mode -> chunked reads and batched sends
+    const packet_framing_params_t _framing;
+    boost::scoped_ptr<tcp_framed_reader> _reader;
+    boost::scoped_ptr<tcp_send_queue> _send_queue;
 };
 
 /***********************************************************************
@@ -20,6 +20,8 @@
 
 #include <uhd/config.hpp>
 #include <boost/asio.hpp>
+#include <cmath>
+#include <vector>
 
 namespace uhd{ namespace transport{
 
@@ -70,6 +72,46 @@ namespace uhd{ namespace transport{
 #endif
     }
 
+    /*!
+     * Wait for any of the sockets to become ready for a receive operation.
+     * \param sock_fds the open socket file descriptors, not empty
+     * \param timeout the timeout duration in seconds
+     * \return true when a socket is ready for receive
+     */
+    UHD_INLINE bool wait_for_recv_ready(const std::vector<int> &sock_fds, double timeout){
+#ifdef UHD_PLATFORM_WIN32
+        timeval tv;
+        tv.tv_sec = int(timeout);
+        tv.tv_usec = int(timeout*1000000)%1000000;
+
+        fd_set rset;
+        FD_ZERO(&rset);
+        int max_fd = 0;
+        for (size_t i = 0; i < sock_fds.size(); i++){
+            FD_SET(sock_fds[i], &rset);
+            if (sock_fds[i] > max_fd) max_fd = sock_fds[i];
+        }
+
+        #ifndef TEMP_FAILURE_RETRY
+            #define TEMP_FAILURE_RETRY(x) (x)
+        #endif
+
+        return TEMP_FAILURE_RETRY(::select(max_fd+1, &rset, NULL, NULL, &tv)) > 0;
+#else
+        //round up, so short waits do not turn into a busy loop
+        int total_timeout = int(std::ceil(timeout*1000));
+
+        std::vector<pollfd> pfds_read(sock_fds.size());
+        for (size_t i = 0; i < sock_fds.size(); i++){
+            pfds_read[i].fd = sock_fds[i];
+            pfds_read[i].events = POLLIN;
+            pfds_read[i].revents = 0;
+        }
+
+        return ::poll(&pfds_read.front(), nfds_t(pfds_read.size()), total_timeout) > 0;
+#endif
+    }
+
 }} //namespace uhd::transport
 
 #endif /* INCLUDED_LIBUHD_TRANSPORT_VRT_PACKET_HANDLER_HPP */
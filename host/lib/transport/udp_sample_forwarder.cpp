@@ -0,0 +1,415 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/transport/udp_sample_forwarder.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
+#include <uhd/transport/udp_simple.hpp>
+#include <uhd/rx_push_streamer.hpp>
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/asio.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/static_assert.hpp>
+#include <cstring>
+#include <vector>
+#ifdef HAVE_SENDMMSG
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <cerrno>
+#endif /*HAVE_SENDMMSG*/
+
+using namespace uhd;
+using namespace uhd::transport;
+namespace asio = boost::asio;
+
+//! The timeout in seconds of one round of the send thread, bounds the shutdown time
+static const double SEND_TIMEOUT = 0.1;
+
+static const size_t DEFAULT_QUEUE_DEPTH = 16;
+static const size_t DEFAULT_BATCH = 32;
+
+//! A segmented send stays below the 64 KiB limit of an IP datagram
+static const size_t MAX_GSO_BYTES = 65000;
+
+//! UDP_MAX_SEGMENTS of the kernel
+static const size_t MAX_GSO_SEGMENTS = 64;
+
+BOOST_STATIC_ASSERT(sizeof(udp_sample_forwarder::header_t) == 24);
+
+udp_sample_forwarder::~udp_sample_forwarder(void){
+    /* NOP */
+}
+
+static std::vector<size_t> parse_cpus(const std::string &list){
+    std::vector<std::string> toks;
+    const std::string cpu_list = boost::algorithm::trim_copy(list);
+    boost::split(toks, cpu_list, boost::is_any_of(" "), boost::token_compress_on);
+    std::vector<size_t> cpus;
+    BOOST_FOREACH(const std::string &tok, toks){
+        if (not tok.empty()) cpus.push_back(boost::lexical_cast<size_t>(tok));
+    }
+    return cpus;
+}
+
+/***********************************************************************
+ * The forwarder implementation
+ **********************************************************************/
+class udp_sample_forwarder_impl : public udp_sample_forwarder{
+public:
+    udp_sample_forwarder_impl(
+        rx_streamer::sptr rx_stream,
+        const stream_args_t &stream_args,
+        const device_addr_t &forward_args
+    ):
+        _num_chans(rx_stream->get_num_channels()),
+        _bytes_per_item(convert::get_bytes_per_item(stream_args.cpu_format)),
+        _use_header(forward_args.cast<int>("header", 1) != 0),
+        _batch(forward_args.cast<size_t>("batch", DEFAULT_BATCH)),
+        _gso(forward_args.cast<int>("gso", 0) != 0),
+        _queue_depth(forward_args.cast<size_t>("queue_depth", DEFAULT_QUEUE_DEPTH)),
+        _socket(_io_service),
+        _queue(_queue_depth),
+        _next_dest(0),
+        _thread_setup_done(false),
+        _num_datagrams(0), _num_bytes(0), _num_dropped_blocks(0), _num_send_errors(0)
+    {
+        const size_t header_size = _use_header? sizeof(header_t) : 0;
+        const size_t payload_size = forward_args.cast<size_t>("payload_size", udp_simple::mtu - header_size);
+        _payload_samps = payload_size/_bytes_per_item;
+        if (_payload_samps == 0) throw uhd::value_error("udp_sample_forwarder: payload_size must hold a sample");
+        if (_batch == 0) throw uhd::value_error("udp_sample_forwarder: batch must be positive");
+        if (_queue_depth == 0) throw uhd::value_error("udp_sample_forwarder: queue_depth must be positive");
+
+        const std::string fanout = forward_args.get("fanout", "copy");
+        if (fanout == "copy") _fanout = FANOUT_COPY;
+        else if (fanout == "round_robin") _fanout = FANOUT_ROUND_ROBIN;
+        else if (fanout == "channel") _fanout = FANOUT_CHANNEL;
+        else throw uhd::value_error("udp_sample_forwarder: unknown fanout " + fanout);
+
+        //resolve the destinations
+        std::vector<std::string> toks;
+        const std::string dest_list = boost::algorithm::trim_copy(forward_args.get("dests", ""));
+        boost::split(toks, dest_list, boost::is_any_of(" "), boost::token_compress_on);
+        asio::ip::udp::resolver resolver(_io_service);
+        BOOST_FOREACH(const std::string &tok, toks){
+            if (tok.empty()) continue;
+            const size_t colon = tok.rfind(':');
+            if (colon == std::string::npos) throw uhd::value_error("udp_sample_forwarder: destination without port " + tok);
+            asio::ip::udp::resolver::query query(asio::ip::udp::v4(), tok.substr(0, colon), tok.substr(colon + 1));
+            _dests.push_back(*resolver.resolve(query));
+        }
+        if (_dests.empty()) throw uhd::value_error("udp_sample_forwarder: no destinations in dests");
+        _sequences.resize(_dests.size(), 0);
+
+        _socket.open(asio::ip::udp::v4());
+        if (forward_args.has_key("send_buff_size")){
+            _socket.set_option(asio::socket_base::send_buffer_size(
+                int(forward_args.cast<double>("send_buff_size", 0.0))));
+        }
+        if (forward_args.has_key("send_cpus")) _send_cpus = parse_cpus(forward_args["send_cpus"]);
+
+        #ifndef UDP_SEGMENT
+        if (_gso){
+            UHD_MSG(warning) << "udp_sample_forwarder: UDP segmentation offload is not available, gso=1 is ignored" << std::endl;
+            _gso = false;
+        }
+        #endif /*UDP_SEGMENT*/
+
+        //the pool of the push streamer also holds the block being received and the one being sent
+        device_addr_t push_args = forward_args;
+        push_args["queue_depth"] = boost::lexical_cast<std::string>(_queue_depth + 2);
+        _task = task::make(boost::bind(&udp_sample_forwarder_impl::send_one_block, this), "udp_forward");
+        _push = rx_push_streamer::make(rx_stream, stream_args,
+            boost::bind(&udp_sample_forwarder_impl::handle_block, this, _1), push_args);
+    }
+
+    ~udp_sample_forwarder_impl(void){
+        _push.reset(); //stop receiving before the sender goes away
+        _task.reset();
+    }
+
+    uint64_t get_num_datagrams(void) const{
+        return _num_datagrams.load(boost::memory_order_relaxed);
+    }
+
+    uint64_t get_num_bytes(void) const{
+        return _num_bytes.load(boost::memory_order_relaxed);
+    }
+
+    uint64_t get_num_dropped_blocks(void) const{
+        return _num_dropped_blocks.load(boost::memory_order_relaxed);
+    }
+
+    uint64_t get_num_send_errors(void) const{
+        return _num_send_errors.load(boost::memory_order_relaxed);
+    }
+
+private:
+    enum fanout_t {FANOUT_COPY, FANOUT_ROUND_ROBIN, FANOUT_CHANNEL};
+
+    struct datagram_t{
+        size_t dest;
+        header_t header;
+        const char *payload;
+        size_t payload_len;
+    };
+
+    //! Called on the receive thread, must not wait
+    void handle_block(const rx_push_streamer::block_sptr &block){
+        if (not _queue.push_with_haste(block)) _num_dropped_blocks++;
+    }
+
+    //! One round of the send task
+    void send_one_block(void){
+        if (not _thread_setup_done){
+            set_thread_affinity(_send_cpus);
+            _thread_setup_done = true;
+        }
+        rx_push_streamer::block_sptr block;
+        if (not _queue.pop_with_timed_wait(block, SEND_TIMEOUT)) return;
+        make_datagrams(*block);
+        send_datagrams();
+    }
+
+    bool goes_to(const size_t chan, const size_t dest, const size_t block_dest) const{
+        switch (_fanout){
+        case FANOUT_ROUND_ROBIN: return dest == block_dest;
+        case FANOUT_CHANNEL: return dest == chan % _dests.size();
+        default: return true;
+        }
+    }
+
+    void add_datagram(
+        const size_t dest, const size_t chan, const uint16_t flags, const size_t nsamps,
+        const size_t offset, const int64_t time_ns, const char *payload
+    ){
+        datagram_t dg;
+        dg.dest = dest;
+        dg.header.sequence = uhd::htonx<uint32_t>(_sequences[dest]++);
+        dg.header.channel = uhd::htonx<uint16_t>(uint16_t(chan));
+        dg.header.flags = uhd::htonx<uint16_t>(flags);
+        dg.header.nsamps = uhd::htonx<uint32_t>(uint32_t(nsamps));
+        dg.header.sample_offset = uhd::htonx<uint32_t>(uint32_t(offset));
+        dg.header.time_ns = int64_t(uhd::htonx<uint64_t>(uint64_t(time_ns)));
+        dg.payload = payload;
+        dg.payload_len = nsamps*_bytes_per_item;
+        _datagrams.push_back(dg);
+    }
+
+    /*!
+     * Split a block into datagrams, grouped by destination so the
+     * datagrams of a destination can be sent as one segmented send.
+     */
+    void make_datagrams(const rx_push_streamer::block_t &block){
+        _datagrams.clear();
+        const rx_metadata_t &md = block.metadata;
+        const uint16_t flags = uint16_t((uint16_t(md.error_code) & 0xff) << 8)
+            | (md.has_time_spec? FLAG_HAS_TIME_SPEC : 0)
+            | (md.start_of_burst? FLAG_START_OF_BURST : 0)
+            | (md.more_fragments? FLAG_MORE_FRAGMENTS : 0);
+        const int64_t time_ns = md.has_time_spec? md.time_spec.to_ticks(1e9) : 0;
+        const uint16_t eob = md.end_of_burst? FLAG_END_OF_BURST : 0;
+
+        //errors without samples are reported to every destination
+        if (block.nsamps == 0){
+            if (not _use_header) return;
+            for (size_t dest = 0; dest < _dests.size(); dest++){
+                add_datagram(dest, 0, flags | eob, 0, 0, time_ns, NULL);
+            }
+            return;
+        }
+
+        const size_t block_dest = _next_dest;
+        _next_dest = (_next_dest + 1) % _dests.size();
+        for (size_t dest = 0; dest < _dests.size(); dest++){
+            for (size_t chan = 0; chan < _num_chans; chan++){
+                if (not goes_to(chan, dest, block_dest)) continue;
+                const char *samps = reinterpret_cast<const char *>(block.buffs[chan]);
+                for (size_t offset = 0; offset < block.nsamps; offset += _payload_samps){
+                    const size_t nsamps = std::min(_payload_samps, block.nsamps - offset);
+                    const bool last = offset + nsamps == block.nsamps;
+                    add_datagram(dest, chan, flags | (last? eob : 0), nsamps, offset, time_ns,
+                        samps + offset*_bytes_per_item);
+                }
+            }
+        }
+    }
+
+    size_t datagram_size(const datagram_t &dg) const{
+        return (_use_header? sizeof(header_t) : 0) + dg.payload_len;
+    }
+
+    void count_sent(const size_t num_datagrams, const uint64_t num_bytes){
+        _num_datagrams.fetch_add(num_datagrams, boost::memory_order_relaxed);
+        _num_bytes.fetch_add(num_bytes, boost::memory_order_relaxed);
+    }
+
+#ifdef HAVE_SENDMMSG
+    union cmsg_buff_t{
+        cmsghdr align;
+        char buff[CMSG_SPACE(sizeof(uint16_t))];
+    };
+
+    /*!
+     * Send the datagrams of a block with batched sendmmsg() calls.
+     * With gso, the consecutive datagrams of a destination go in one
+     * message that the kernel cuts into segments of the first datagram's
+     * size, so only the last one of a message may be shorter.
+     */
+    void send_datagrams(void){
+        const size_t num = _datagrams.size();
+        if (num == 0) return;
+        _iovs.resize(2*num);
+        _msgs.resize(num);
+        _msg_segments.resize(num);
+        _msg_bytes.resize(num);
+        _cmsgs.resize(num);
+        std::memset(&_msgs.front(), 0, num*sizeof(mmsghdr));
+
+        size_t num_msgs = 0, num_iovs = 0;
+        for (size_t i = 0; i < num; num_msgs++){
+            mmsghdr &msg = _msgs[num_msgs];
+            asio::ip::udp::endpoint &dest = _dests[_datagrams[i].dest];
+            msg.msg_hdr.msg_name = dest.data();
+            msg.msg_hdr.msg_namelen = dest.size();
+            const size_t first_iov = num_iovs;
+            msg.msg_hdr.msg_iov = &_iovs[first_iov];
+
+            const size_t segment_size = datagram_size(_datagrams[i]);
+            size_t segments = 0, bytes = 0;
+            do{
+                const datagram_t &dg = _datagrams[i];
+                if (_use_header){
+                    _iovs[num_iovs].iov_base = const_cast<header_t *>(&dg.header);
+                    _iovs[num_iovs++].iov_len = sizeof(header_t);
+                }
+                if (dg.payload_len != 0){
+                    _iovs[num_iovs].iov_base = const_cast<char *>(dg.payload);
+                    _iovs[num_iovs++].iov_len = dg.payload_len;
+                }
+                bytes += datagram_size(dg);
+                segments++;
+                i++;
+            } while (_gso and i < num
+                and _datagrams[i].dest == _datagrams[i-1].dest
+                and datagram_size(_datagrams[i-1]) == segment_size
+                and datagram_size(_datagrams[i]) <= segment_size
+                and segments < MAX_GSO_SEGMENTS
+                and bytes + datagram_size(_datagrams[i]) <= MAX_GSO_BYTES);
+            msg.msg_hdr.msg_iovlen = num_iovs - first_iov;
+            _msg_segments[num_msgs] = segments;
+            _msg_bytes[num_msgs] = bytes;
+
+            #ifdef UDP_SEGMENT
+            if (segments > 1){
+                msg.msg_hdr.msg_control = _cmsgs[num_msgs].buff;
+                msg.msg_hdr.msg_controllen = sizeof(_cmsgs[num_msgs].buff);
+                cmsghdr *cm = CMSG_FIRSTHDR(&msg.msg_hdr);
+                cm->cmsg_level = SOL_UDP;
+                cm->cmsg_type = UDP_SEGMENT;
+                cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                const uint16_t gso_size = uint16_t(segment_size);
+                std::memcpy(CMSG_DATA(cm), &gso_size, sizeof(gso_size));
+            }
+            #endif /*UDP_SEGMENT*/
+        }
+
+        const int fd = _socket.native_handle();
+        size_t num_sent = 0;
+        while (num_sent < num_msgs){
+            const int ret = ::sendmmsg(fd, &_msgs[num_sent], unsigned(std::min(_batch, num_msgs - num_sent)), 0);
+            if (ret < 0 and errno == EINTR) continue;
+            if (ret <= 0){
+                //skip the message that failed, the next one may go through
+                _num_send_errors.fetch_add(_msg_segments[num_sent], boost::memory_order_relaxed);
+                num_sent++;
+                continue;
+            }
+            for (size_t m = num_sent; m < num_sent + size_t(ret); m++){
+                count_sent(_msg_segments[m], _msg_bytes[m] - (_use_header? _msg_segments[m]*sizeof(header_t) : 0));
+            }
+            num_sent += size_t(ret);
+        }
+    }
+
+    std::vector<iovec> _iovs;
+    std::vector<mmsghdr> _msgs;
+    std::vector<size_t> _msg_segments;
+    std::vector<size_t> _msg_bytes;
+    std::vector<cmsg_buff_t> _cmsgs;
+#else
+    //! Send the datagrams of a block one by one
+    void send_datagrams(void){
+        BOOST_FOREACH(const datagram_t &dg, _datagrams){
+            std::vector<asio::const_buffer> buffs;
+            if (_use_header) buffs.push_back(asio::buffer(&dg.header, sizeof(header_t)));
+            if (dg.payload_len != 0) buffs.push_back(asio::buffer(dg.payload, dg.payload_len));
+            boost::system::error_code ec;
+            _socket.send_to(buffs, _dests[dg.dest], 0, ec);
+            if (ec) _num_send_errors++;
+            else count_sent(1, dg.payload_len);
+        }
+    }
+#endif /*HAVE_SENDMMSG*/
+
+    const size_t _num_chans;
+    const size_t _bytes_per_item;
+    const bool _use_header;
+    const size_t _batch;
+    bool _gso;
+    const size_t _queue_depth;
+    size_t _payload_samps;
+    fanout_t _fanout;
+    std::vector<size_t> _send_cpus;
+
+    asio::io_service _io_service;
+    asio::ip::udp::socket _socket;
+    std::vector<asio::ip::udp::endpoint> _dests;
+
+    spsc_bounded_buffer<rx_push_streamer::block_sptr> _queue;
+
+    //only used by the send task
+    std::vector<uint32_t> _sequences;
+    std::vector<datagram_t> _datagrams;
+    size_t _next_dest;
+    bool _thread_setup_done;
+
+    boost::atomic<uint64_t> _num_datagrams;
+    boost::atomic<uint64_t> _num_bytes;
+    boost::atomic<uint64_t> _num_dropped_blocks;
+    boost::atomic<uint64_t> _num_send_errors;
+
+    task::sptr _task;
+    rx_push_streamer::sptr _push;
+};
+
+udp_sample_forwarder::sptr udp_sample_forwarder::make(
+    rx_streamer::sptr rx_stream,
+    const stream_args_t &stream_args,
+    const device_addr_t &forward_args
+){
+    return sptr(new udp_sample_forwarder_impl(rx_stream, stream_args, forward_args));
+}
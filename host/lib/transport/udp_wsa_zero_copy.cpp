@@ -21,8 +21,14 @@
 #include <uhd/transport/buffer_pool.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/log.hpp>
+#include <uhd/types/time_spec.hpp>
 #include <boost/format.hpp>
+#include <boost/thread/mutex.hpp>
 #include <vector>
+#include <mmsystem.h> //timeBeginPeriod
+#ifdef HAVE_WINSOCK_RIO
+#include <mswsock.h> //registered IO
+#endif /*HAVE_WINSOCK_RIO*/
 
 using namespace uhd;
 using namespace uhd::transport;
@@ -72,6 +78,110 @@ struct uhd_wsa_control{
     }
 };
 
+/***********************************************************************
+ * Common socket handling of the WSA and RIO transports:
+ *  - open the socket, resize its buffers and connect it
+ *  - read back the actual socket buffer sizes
+ *  - raise the system timer resolution for the waits when asked to
+ **********************************************************************/
+class udp_zero_copy_win_base : public udp_zero_copy{
+public:
+    typedef boost::shared_ptr<udp_zero_copy_win_base> sptr;
+
+    udp_zero_copy_win_base(void): _sock_fd(INVALID_SOCKET), _timer_period(0){
+        static uhd_wsa_control uhd_wsa; //makes wsa start happen via lazy initialization
+    }
+
+    virtual ~udp_zero_copy_win_base(void){
+        if (_sock_fd != INVALID_SOCKET) closesocket(_sock_fd);
+        if (_timer_period != 0) timeEndPeriod(_timer_period);
+    }
+
+    //! Read back the socket's buffer space reserved for receives
+    size_t get_recv_buff_size(void) {
+        int recv_buff_size = 0;
+        int opt_len = sizeof(recv_buff_size);
+        getsockopt(
+                _sock_fd,
+                SOL_SOCKET,
+                SO_RCVBUF,
+                (char *)&recv_buff_size,
+                (int *)&opt_len
+        );
+
+        return (size_t) recv_buff_size;
+    }
+
+    //! Read back the socket's buffer space reserved for sends
+    size_t get_send_buff_size(void) {
+        int send_buff_size = 0;
+        int opt_len = sizeof(send_buff_size);
+        getsockopt(
+                _sock_fd,
+                SOL_SOCKET,
+                SO_SNDBUF,
+                (char *)&send_buff_size,
+                (int *)&opt_len
+        );
+
+        return (size_t) send_buff_size;
+    }
+
+protected:
+    //! Create the socket with the WSA flags, resize its buffers and connect it
+    void open_socket(
+        const std::string &addr,
+        const std::string &port,
+        const device_addr_t &hints,
+        const DWORD flags
+    ){
+        //resolve the address
+        asio::io_service io_service;
+        asio::ip::udp::resolver resolver(io_service);
+        asio::ip::udp::resolver::query query(asio::ip::udp::v4(), addr, port);
+        asio::ip::udp::endpoint receiver_endpoint = *resolver.resolve(query);
+
+        //create the socket
+        _sock_fd = WSASocket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, 0, flags);
+        if (_sock_fd == INVALID_SOCKET){
+            const DWORD error = WSAGetLastError();
+            throw uhd::os_error(str(boost::format("WSASocket() failed with error %d") % error));
+        }
+
+        //resize the socket buffers
+        const int recv_buff_size = int(hints.cast<double>("recv_buff_size", 0.0));
+        const int send_buff_size = int(hints.cast<double>("send_buff_size", 0.0));
+        if (recv_buff_size > 0) setsockopt(_sock_fd, SOL_SOCKET, SO_RCVBUF, (const char *)&recv_buff_size, sizeof(recv_buff_size));
+        if (send_buff_size > 0) setsockopt(_sock_fd, SOL_SOCKET, SO_SNDBUF, (const char *)&send_buff_size, sizeof(send_buff_size));
+
+        //The waits for the frames wake up on the system timer tick, 15.6 ms by default.
+        //The period is raised for the lifetime of the transport, it is system wide.
+        const UINT timer_period = UINT(hints.cast<double>("udp_timer_period", 0.0));
+        if (timer_period != 0){
+            if (timeBeginPeriod(timer_period) == TIMERR_NOERROR) _timer_period = timer_period;
+            else UHD_MSG(warning) << boost::format(
+                "Unable to set the system timer resolution to %u ms.\n"
+            ) % timer_period;
+        }
+
+        //connect the socket so we can send/recv
+        const asio::ip::udp::endpoint::data_type &servaddr = *receiver_endpoint.data();
+        if (WSAConnect(_sock_fd, (const struct sockaddr *)&servaddr, sizeof(servaddr), NULL, NULL, NULL, NULL) != 0){
+            const DWORD error = WSAGetLastError();
+            closesocket(_sock_fd);
+            _sock_fd = INVALID_SOCKET;
+            throw uhd::os_error(str(boost::format("WSAConnect() failed with error %d") % error));
+        }
+    }
+
+    //socket guts
+    SOCKET                  _sock_fd;
+
+private:
+    //the timer period set with timeBeginPeriod, 0 when unchanged
+    UINT                    _timer_period;
+};
+
 /***********************************************************************
  * Reusable managed receiver buffer:
  *  - Initialize with memory and a release callback.
@@ -175,7 +285,7 @@ private:
  *   This has better performance than the overlapped IO.
  *   For send, use overlapped IO to submit async sends.
  **********************************************************************/
-class udp_zero_copy_wsa_impl : public udp_zero_copy{
+class udp_zero_copy_wsa_impl : public udp_zero_copy_win_base{
 public:
     typedef boost::shared_ptr<udp_zero_copy_wsa_impl> sptr;
 
@@ -198,40 +308,10 @@ public:
         #endif /*CHECK_REG_SEND_THRESH*/
 
         UHD_MSG(status) << boost::format("Creating WSA UDP transport for %s:%s") % addr % port << std::endl;
-        static uhd_wsa_control uhd_wsa; //makes wsa start happen via lazy initialization
 
         UHD_ASSERT_THROW(_num_send_frames <= WSA_MAXIMUM_WAIT_EVENTS);
 
-        //resolve the address
-        asio::io_service io_service;
-        asio::ip::udp::resolver resolver(io_service);
-        asio::ip::udp::resolver::query query(asio::ip::udp::v4(), addr, port);
-        asio::ip::udp::endpoint receiver_endpoint = *resolver.resolve(query);
-
-        //create the socket
-        _sock_fd = WSASocket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, 0, WSA_FLAG_OVERLAPPED);
-        if (_sock_fd == INVALID_SOCKET){
-            const DWORD error = WSAGetLastError();
-            throw uhd::os_error(str(boost::format("WSASocket() failed with error %d") % error));
-        }
-
-        //set the socket non-blocking for recv
-        //u_long mode = 1;
-        //ioctlsocket(_sock_fd, FIONBIO, &mode);
-
-        //resize the socket buffers
-        const int recv_buff_size = int(hints.cast<double>("recv_buff_size", 0.0));
-        const int send_buff_size = int(hints.cast<double>("send_buff_size", 0.0));
-        if (recv_buff_size > 0) setsockopt(_sock_fd, SOL_SOCKET, SO_RCVBUF, (const char *)&recv_buff_size, sizeof(recv_buff_size));
-        if (send_buff_size > 0) setsockopt(_sock_fd, SOL_SOCKET, SO_SNDBUF, (const char *)&send_buff_size, sizeof(send_buff_size));
-
-        //connect the socket so we can send/recv
-        const asio::ip::udp::endpoint::data_type &servaddr = *receiver_endpoint.data();
-        if (WSAConnect(_sock_fd, (const struct sockaddr *)&servaddr, sizeof(servaddr), NULL, NULL, NULL, NULL) != 0){
-            const DWORD error = WSAGetLastError();
-            closesocket(_sock_fd);
-            throw uhd::os_error(str(boost::format("WSAConnect() failed with error %d") % error));
-        }
+        this->open_socket(addr, port, hints, WSA_FLAG_OVERLAPPED);
 
         //allocate re-usable managed receive buffers
         for (size_t i = 0; i < get_num_recv_frames(); i++){
@@ -248,10 +328,6 @@ public:
         }
     }
 
-    ~udp_zero_copy_wsa_impl(void){
-        closesocket(_sock_fd);
-    }
-
     /*******************************************************************
      * Receive implementation:
      * Block on the managed buffer's get call and advance the index.
@@ -276,49 +352,349 @@ public:
     size_t get_num_send_frames(void) const {return _num_send_frames;}
     size_t get_send_frame_size(void) const {return _send_frame_size;}
 
-    //! Read back the socket's buffer space reserved for receives
-    size_t get_recv_buff_size(void) {
-        int recv_buff_size = 0;
-        int opt_len = sizeof(recv_buff_size);
-        getsockopt(
-                _sock_fd,
-                SOL_SOCKET,
-                SO_RCVBUF,
-                (char *)&recv_buff_size,
-                (int *)&opt_len
-        );
+private:
+    //memory management -> buffers and fifos
+    const size_t _recv_frame_size, _num_recv_frames;
+    const size_t _send_frame_size, _num_send_frames;
+    buffer_pool::sptr _recv_buffer_pool, _send_buffer_pool;
+    std::vector<boost::shared_ptr<udp_zero_copy_asio_msb> > _msb_pool;
+    std::vector<boost::shared_ptr<udp_zero_copy_asio_mrb> > _mrb_pool;
+    size_t _next_recv_buff_index, _next_send_buff_index;
+};
 
-        return (size_t) recv_buff_size;
+#ifdef HAVE_WINSOCK_RIO
+/***********************************************************************
+ * Registered IO (Windows 8 and newer):
+ *  - the buffer pools are registered with the kernel once
+ *  - receives and sends are posted to a request queue
+ *  - finished requests are reaped from completion queues,
+ *    the socket only signals an event when a caller has to wait
+ **********************************************************************/
+static bool load_rio_functions(SOCKET sock_fd, RIO_EXTENSION_FUNCTION_TABLE &rio){
+    GUID rio_guid = WSAID_MULTIPLE_RIO;
+    DWORD bytes = 0;
+    ZeroMemory(&rio, sizeof(rio));
+    rio.cbSize = sizeof(rio);
+    return WSAIoctl(
+        sock_fd, SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER,
+        &rio_guid, sizeof(rio_guid), &rio, sizeof(rio), &bytes, NULL, NULL
+    ) == 0;
+}
+
+//! True when the OS supports registered IO, checked once per process
+static bool is_rio_supported(void){
+    static bool checked = false, supported = false;
+    if (checked) return supported;
+    static uhd_wsa_control uhd_wsa;
+    const SOCKET sock_fd = WSASocket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, 0, WSA_FLAG_REGISTERED_IO);
+    if (sock_fd != INVALID_SOCKET){
+        RIO_EXTENSION_FUNCTION_TABLE rio;
+        supported = load_rio_functions(sock_fd, rio);
+        closesocket(sock_fd);
     }
+    checked = true;
+    return supported;
+}
 
-    //! Read back the socket's buffer space reserved for sends
-    size_t get_send_buff_size(void) {
-        int send_buff_size = 0;
-        int opt_len = sizeof(send_buff_size);
-        getsockopt(
-                _sock_fd,
-                SOL_SOCKET,
-                SO_SNDBUF,
-                (char *)&send_buff_size,
-                (int *)&opt_len
-        );
+class udp_zero_copy_rio_impl;
 
-        return (size_t) send_buff_size;
+/***********************************************************************
+ * Registered IO managed buffers:
+ *  - the receive buffer posts its frame again on release
+ *  - the send buffer posts its frame for sending on release
+ **********************************************************************/
+class udp_zero_copy_rio_mrb : public managed_recv_buffer{
+public:
+    udp_zero_copy_rio_mrb(udp_zero_copy_rio_impl *xport, void *mem, const size_t index):
+        _xport(xport), _mem(mem), _index(index){ /*NOP*/ }
+
+    void release(void);
+
+    UHD_INLINE sptr get_new(const size_t len){
+        return make(this, _mem, len);
+    }
+
+private:
+    udp_zero_copy_rio_impl *_xport;
+    void *_mem;
+    const size_t _index;
+};
+
+class udp_zero_copy_rio_msb : public managed_send_buffer{
+public:
+    udp_zero_copy_rio_msb(udp_zero_copy_rio_impl *xport, void *mem, const size_t index, const size_t frame_size):
+        _xport(xport), _mem(mem), _index(index), _frame_size(frame_size){ /*NOP*/ }
+
+    void release(void);
+
+    UHD_INLINE sptr get_new(void){
+        return make(this, _mem, _frame_size);
     }
 
 private:
+    udp_zero_copy_rio_impl *_xport;
+    void *_mem;
+    const size_t _index;
+    const size_t _frame_size;
+};
+
+/***********************************************************************
+ * Zero Copy UDP implementation with registered IO:
+ *
+ *   The request queue is not thread safe, so posting is serialized.
+ *   Each completion queue is only reaped by its own direction.
+ **********************************************************************/
+class udp_zero_copy_rio_impl : public udp_zero_copy_win_base{
+public:
+    typedef boost::shared_ptr<udp_zero_copy_rio_impl> sptr;
+
+    udp_zero_copy_rio_impl(
+        const std::string &addr,
+        const std::string &port,
+        zero_copy_xport_params& xport_params,
+        const device_addr_t &hints
+    ):
+        _recv_frame_size(xport_params.recv_frame_size),
+        _num_recv_frames(xport_params.num_recv_frames),
+        _send_frame_size(xport_params.send_frame_size),
+        _num_send_frames(xport_params.num_send_frames),
+        _recv_buffer_pool(buffer_pool::make(xport_params.num_recv_frames, xport_params.recv_frame_size)),
+        _send_buffer_pool(buffer_pool::make(xport_params.num_send_frames, xport_params.send_frame_size)),
+        _recv_buff_id(RIO_INVALID_BUFFERID), _send_buff_id(RIO_INVALID_BUFFERID),
+        _recv_cq(RIO_INVALID_CQ), _send_cq(RIO_INVALID_CQ), _rq(RIO_INVALID_RQ),
+        _recv_event(WSA_INVALID_EVENT), _send_event(WSA_INVALID_EVENT),
+        _recv_results(xport_params.num_recv_frames), _num_recv_results(0), _next_recv_result(0),
+        _send_results(xport_params.num_send_frames)
+    {
+        #ifdef CHECK_REG_SEND_THRESH
+        check_registry_for_fast_send_threshold(this->get_send_frame_size());
+        #endif /*CHECK_REG_SEND_THRESH*/
+
+        UHD_MSG(status) << boost::format("Creating RIO UDP transport for %s:%s") % addr % port << std::endl;
+
+        this->open_socket(addr, port, hints, WSA_FLAG_REGISTERED_IO);
+        if (not load_rio_functions(_sock_fd, _rio)){
+            throw uhd::os_error(str(boost::format(
+                "Loading the registered IO functions failed with error %d") % WSAGetLastError()
+            ));
+        }
+
+        try{
+            //register the buffer pools, the frames are at fixed offsets
+            _recv_buff_id = register_pool(_recv_buffer_pool, _num_recv_frames, _recv_frame_size);
+            _send_buff_id = register_pool(_send_buffer_pool, _num_send_frames, _send_frame_size);
+
+            //completion queues signal their event when notified
+            _recv_event = WSACreateEvent();
+            _send_event = WSACreateEvent();
+            if (_recv_event == WSA_INVALID_EVENT or _send_event == WSA_INVALID_EVENT){
+                throw uhd::os_error(str(boost::format("WSACreateEvent() failed with error %d") % WSAGetLastError()));
+            }
+            _recv_cq = create_cq(_num_recv_frames, _recv_event);
+            _send_cq = create_cq(_num_send_frames, _send_event);
+
+            _rq = _rio.RIOCreateRequestQueue(
+                _sock_fd, ULONG(_num_recv_frames), 1, ULONG(_num_send_frames), 1, _recv_cq, _send_cq, NULL
+            );
+            if (_rq == RIO_INVALID_RQ){
+                throw uhd::os_error(str(boost::format("RIOCreateRequestQueue() failed with error %d") % WSAGetLastError()));
+            }
+
+            //allocate re-usable managed buffers, all receives are posted up front
+            for (size_t i = 0; i < _num_recv_frames; i++){
+                _mrb_pool.push_back(boost::shared_ptr<udp_zero_copy_rio_mrb>(
+                    new udp_zero_copy_rio_mrb(this, _recv_buffer_pool->at(i), i)
+                ));
+                post_recv(i);
+            }
+            for (size_t i = 0; i < _num_send_frames; i++){
+                _msb_pool.push_back(boost::shared_ptr<udp_zero_copy_rio_msb>(
+                    new udp_zero_copy_rio_msb(this, _send_buffer_pool->at(i), i, _send_frame_size)
+                ));
+                _free_sends.push_back(i);
+            }
+        }
+        catch(...){
+            cleanup();
+            throw;
+        }
+    }
+
+    ~udp_zero_copy_rio_impl(void){
+        //the request queue goes away with the socket
+        closesocket(_sock_fd);
+        _sock_fd = INVALID_SOCKET;
+        cleanup();
+    }
+
+    /*******************************************************************
+     * Receive implementation:
+     * Hand out completed receives in order of completion, only arm the
+     * completion event and wait when none are left.
+     ******************************************************************/
+    managed_recv_buffer::sptr get_recv_buff(double timeout){
+        if (_next_recv_result == _num_recv_results){
+            _next_recv_result = 0;
+            if (not reap(_recv_cq, _recv_event, _recv_results, _num_recv_results, timeout)){
+                return managed_recv_buffer::sptr();
+            }
+        }
+        const RIORESULT &result = _recv_results[_next_recv_result++];
+        const size_t index = size_t(result.RequestContext);
+        if (result.Status != 0){
+            post_recv(index); //the frame is reused right away
+            return managed_recv_buffer::sptr();
+        }
+        return _mrb_pool[index]->get_new(result.BytesTransferred);
+    }
+
+    size_t get_num_recv_frames(void) const {return _num_recv_frames;}
+    size_t get_recv_frame_size(void) const {return _recv_frame_size;}
+
+    /*******************************************************************
+     * Send implementation:
+     * Take a free frame, reap finished sends when there is none.
+     ******************************************************************/
+    managed_send_buffer::sptr get_send_buff(double timeout){
+        if (_free_sends.empty()){
+            size_t num_results = 0;
+            if (not reap(_send_cq, _send_event, _send_results, num_results, timeout)){
+                return managed_send_buffer::sptr();
+            }
+            for (size_t i = 0; i < num_results; i++){
+                _free_sends.push_back(size_t(_send_results[i].RequestContext));
+            }
+        }
+        const size_t index = _free_sends.back();
+        _free_sends.pop_back();
+        return _msb_pool[index]->get_new();
+    }
+
+    size_t get_num_send_frames(void) const {return _num_send_frames;}
+    size_t get_send_frame_size(void) const {return _send_frame_size;}
+
+    //! Post the receive frame at the index
+    void post_recv(const size_t index){
+        RIO_BUF buf;
+        buf.BufferId = _recv_buff_id;
+        buf.Offset = ULONG(index*get_pool_stride(_recv_buffer_pool, _num_recv_frames));
+        buf.Length = ULONG(_recv_frame_size);
+        boost::mutex::scoped_lock lock(_rq_mutex);
+        if (not _rio.RIOReceive(_rq, &buf, 1, 0, reinterpret_cast<PVOID>(index))){
+            UHD_MSG(error) << boost::format("RIOReceive() failed with error %d") % WSAGetLastError() << std::endl;
+        }
+    }
+
+    //! Post the send frame at the index with the given length
+    void post_send(const size_t index, const size_t len){
+        RIO_BUF buf;
+        buf.BufferId = _send_buff_id;
+        buf.Offset = ULONG(index*get_pool_stride(_send_buffer_pool, _num_send_frames));
+        buf.Length = ULONG(len);
+        boost::mutex::scoped_lock lock(_rq_mutex);
+        if (not _rio.RIOSend(_rq, &buf, 1, 0, reinterpret_cast<PVOID>(index))){
+            UHD_MSG(error) << boost::format("RIOSend() failed with error %d") % WSAGetLastError() << std::endl;
+        }
+    }
+
+private:
+    //! The distance between two frames of a pool
+    static size_t get_pool_stride(buffer_pool::sptr pool, const size_t num_frames){
+        if (num_frames < 2) return 0;
+        return size_t(pool->at(1)) - size_t(pool->at(0));
+    }
+
+    RIO_BUFFERID register_pool(buffer_pool::sptr pool, const size_t num_frames, const size_t frame_size){
+        const size_t len = get_pool_stride(pool, num_frames)*(num_frames-1) + frame_size;
+        const RIO_BUFFERID id = _rio.RIORegisterBuffer(reinterpret_cast<PCHAR>(pool->at(0)), DWORD(len));
+        if (id == RIO_INVALID_BUFFERID){
+            throw uhd::os_error(str(boost::format("RIORegisterBuffer() failed with error %d") % WSAGetLastError()));
+        }
+        return id;
+    }
+
+    RIO_CQ create_cq(const size_t size, WSAEVENT event){
+        RIO_NOTIFICATION_COMPLETION completion;
+        ZeroMemory(&completion, sizeof(completion));
+        completion.Type = RIO_EVENT_COMPLETION;
+        completion.Event.EventHandle = event;
+        completion.Event.NotifyReset = TRUE;
+        const RIO_CQ cq = _rio.RIOCreateCompletionQueue(DWORD(size), &completion);
+        if (cq == RIO_INVALID_CQ){
+            throw uhd::os_error(str(boost::format("RIOCreateCompletionQueue() failed with error %d") % WSAGetLastError()));
+        }
+        return cq;
+    }
+
+    /*!
+     * Dequeue the finished requests of a completion queue.
+     * Arms the notification and waits for the event when none finished yet.
+     * \return true when at least one request finished
+     */
+    bool reap(
+        RIO_CQ cq, WSAEVENT event, std::vector<RIORESULT> &results,
+        size_t &num_results, const double timeout
+    ){
+        ULONG num = _rio.RIODequeueCompletion(cq, &results.front(), ULONG(results.size()));
+        const time_spec_t exit_time = time_spec_t::get_system_time() + time_spec_t(timeout);
+        while (num == 0){
+            const double time_left = (exit_time - time_spec_t::get_system_time()).get_real_secs();
+            if (time_left <= 0.0) break;
+            const INT notify = _rio.RIONotify(cq);
+            if (notify != ERROR_SUCCESS and notify != WSAEALREADY) break;
+            //a request may have finished before the notification was armed
+            num = _rio.RIODequeueCompletion(cq, &results.front(), ULONG(results.size()));
+            if (num != 0) break;
+            if (WSAWaitForMultipleEvents(
+                1, &event, true, DWORD(time_left*1000), true
+            ) != WSA_WAIT_EVENT_0) break;
+            num = _rio.RIODequeueCompletion(cq, &results.front(), ULONG(results.size()));
+        }
+        if (num == RIO_CORRUPT_CQ) throw uhd::os_error("RIODequeueCompletion() reported a corrupt completion queue");
+        num_results = num;
+        return num != 0;
+    }
+
+    void cleanup(void){
+        if (_recv_cq != RIO_INVALID_CQ) _rio.RIOCloseCompletionQueue(_recv_cq);
+        if (_send_cq != RIO_INVALID_CQ) _rio.RIOCloseCompletionQueue(_send_cq);
+        if (_recv_buff_id != RIO_INVALID_BUFFERID) _rio.RIODeregisterBuffer(_recv_buff_id);
+        if (_send_buff_id != RIO_INVALID_BUFFERID) _rio.RIODeregisterBuffer(_send_buff_id);
+        if (_recv_event != WSA_INVALID_EVENT) WSACloseEvent(_recv_event);
+        if (_send_event != WSA_INVALID_EVENT) WSACloseEvent(_send_event);
+    }
+
     //memory management -> buffers and fifos
     const size_t _recv_frame_size, _num_recv_frames;
     const size_t _send_frame_size, _num_send_frames;
     buffer_pool::sptr _recv_buffer_pool, _send_buffer_pool;
-    std::vector<boost::shared_ptr<udp_zero_copy_asio_msb> > _msb_pool;
-    std::vector<boost::shared_ptr<udp_zero_copy_asio_mrb> > _mrb_pool;
-    size_t _next_recv_buff_index, _next_send_buff_index;
-
-    //socket guts
-    SOCKET                  _sock_fd;
+    std::vector<boost::shared_ptr<udp_zero_copy_rio_msb> > _msb_pool;
+    std::vector<boost::shared_ptr<udp_zero_copy_rio_mrb> > _mrb_pool;
+    std::vector<size_t> _free_sends;
+
+    //registered IO guts
+    RIO_EXTENSION_FUNCTION_TABLE _rio;
+    RIO_BUFFERID _recv_buff_id, _send_buff_id;
+    RIO_CQ _recv_cq, _send_cq;
+    RIO_RQ _rq;
+    WSAEVENT _recv_event, _send_event;
+    boost::mutex _rq_mutex;
+
+    //completions reaped but not handed out yet
+    std::vector<RIORESULT> _recv_results;
+    size_t _num_recv_results, _next_recv_result;
+    std::vector<RIORESULT> _send_results;
 };
 
+void udp_zero_copy_rio_mrb::release(void){
+    _xport->post_recv(_index);
+}
+
+void udp_zero_copy_rio_msb::release(void){
+    _xport->post_send(_index, size());
+}
+#endif /*HAVE_WINSOCK_RIO*/
+
 /***********************************************************************
  * UDP zero copy make function
  **********************************************************************/
@@ -374,9 +750,16 @@ udp_zero_copy::sptr udp_zero_copy::make(
         }
     }
 
-    udp_zero_copy_wsa_impl::sptr udp_trans(
-        new udp_zero_copy_wsa_impl(addr, port, xport_params, hints)
-    );
+    //prefer registered IO when the OS supports it, udp_rio=0 opts out
+    udp_zero_copy_win_base::sptr udp_trans;
+    #ifdef HAVE_WINSOCK_RIO
+    if (hints.cast<int>("udp_rio", 1) != 0 and is_rio_supported()){
+        udp_trans.reset(new udp_zero_copy_rio_impl(addr, port, xport_params, hints));
+    }
+    #endif /*HAVE_WINSOCK_RIO*/
+    if (not udp_trans){
+        udp_trans.reset(new udp_zero_copy_wsa_impl(addr, port, xport_params, hints));
+    }
 
     // Read back the actual socket buffer sizes
     buff_params_out.recv_buff_size = udp_trans->get_recv_buff_size();
@@ -16,16 +16,55 @@
 //
 
 #include "udp_common.hpp"
+#include "xport_stats.hpp"
+#include "packet_framing.hpp"
+#include "../usrp/common/constrained_device_args.hpp"
 #include <uhd/transport/udp_zero_copy.hpp>
 #include <uhd/transport/udp_simple.hpp> //mtu
 #include <uhd/transport/buffer_pool.hpp>
+#include <uhd/transport/shared_frame_pool.hpp>
+#include <uhd/transport/if_addrs.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/atomic.hpp>
+#include <uhd/utils/safe_call.hpp>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/ref.hpp>
 #include <boost/thread/thread.hpp> //sleep
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <vector>
+#include <cerrno>
+#ifdef HAVE_RECVMMSG
+#include <sys/socket.h> //recvmmsg
+#endif /*HAVE_RECVMMSG*/
+#ifdef HAVE_SO_TIMESTAMPING
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#endif /*HAVE_SO_TIMESTAMPING*/
+#ifdef HAVE_UDP_GSO
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h> //UDP_SEGMENT, UDP_GRO
+#endif /*HAVE_UDP_GSO*/
+#ifdef HAVE_MSG_ZEROCOPY
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/errqueue.h>
+#include <poll.h>
+#endif /*HAVE_MSG_ZEROCOPY*/
+#if defined(HAVE_UDP_GSO) || defined(HAVE_MSG_ZEROCOPY)
+#define UDP_SEND_OFFLOAD
+#include <deque>
+#endif
 
 using namespace uhd;
 using namespace uhd::transport;
@@ -34,6 +73,106 @@ namespace asio = boost::asio;
 //A reasonable number of frames for send/recv and async/sync
 //static const size_t DEFAULT_NUM_FRAMES = 32;
 
+//Low latency mode defaults, see the latency_mode hint
+static const int DEFAULT_LATENCY_BUSY_POLL_US = 50;
+
+//Receive timestamping modes, see the udp_timestamp hint
+enum udp_timestamp_mode_t{
+    UDP_TIMESTAMP_NONE,
+    UDP_TIMESTAMP_SOFTWARE,
+    UDP_TIMESTAMP_HARDWARE
+};
+
+/***********************************************************************
+ * Low latency mode and instrumentation parameters:
+ *  - busy_poll_us: SO_BUSY_POLL time for blocking receives, 0 disables
+ *  - spin_timeout: seconds to spin on the socket before blocking
+ *  - incoming_cpu: SO_INCOMING_CPU steering, negative disables
+ *  - timestamp_mode: SO_TIMESTAMPING of received packets
+ *  - nic_name: the interface to enable hardware timestamps on
+ *  - priority: SO_PRIORITY of the sent packets, negative leaves it unchanged
+ **********************************************************************/
+struct udp_latency_params_t{
+    udp_latency_params_t(void):
+        busy_poll_us(0), spin_timeout(0.0), incoming_cpu(-1),
+        timestamp_mode(UDP_TIMESTAMP_NONE), priority(-1){}
+    int busy_poll_us;
+    double spin_timeout;
+    int incoming_cpu;
+    udp_timestamp_mode_t timestamp_mode;
+    std::string nic_name;
+    int priority;
+};
+
+/***********************************************************************
+ * Segmentation and zero copy offload parameters:
+ *  - gso_frames: frames per UDP_SEGMENT super-datagram, 1 disables
+ *  - framing: the packet framing, to send the end of a burst at once
+ *  - gro: receive UDP_GRO coalesced super-datagrams
+ *  - zerocopy: MSG_ZEROCOPY sends
+ **********************************************************************/
+struct udp_offload_params_t{
+    udp_offload_params_t(void): gso_frames(1), gro(false), zerocopy(false){}
+    size_t gso_frames;
+    packet_framing_params_t framing;
+    bool gro;
+    bool zerocopy;
+};
+
+//kernel limits of a UDP_SEGMENT super-datagram
+static const size_t UDP_GSO_MAX_SEGMENTS = 64;
+static const size_t UDP_GSO_MAX_BYTES = 65507;
+
+//room for the largest UDP_GRO coalesced datagram
+static const size_t UDP_GRO_STAGING_SIZE = 65536;
+
+#ifdef HAVE_SO_TIMESTAMPING
+//the payload of a SCM_TIMESTAMPING control message
+struct udp_scm_timestamping_t{
+    timespec ts[3];
+};
+
+//room for the control messages of a received packet
+static const size_t UDP_RECV_CTRL_SIZE = CMSG_SPACE(sizeof(udp_scm_timestamping_t));
+
+/*!
+ * Extract the receive time from the control messages of a packet.
+ * The raw hardware time (index 2) wins over the software time (index 0).
+ * \return true when the packet has a receive time
+ */
+static bool get_recv_timestamp(msghdr &msg, time_spec_t &time){
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)){
+        if (cmsg->cmsg_level != SOL_SOCKET or cmsg->cmsg_type != SO_TIMESTAMPING) continue;
+        udp_scm_timestamping_t stamps;
+        std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+        const timespec &ts = (stamps.ts[2].tv_sec != 0 or stamps.ts[2].tv_nsec != 0)? stamps.ts[2] : stamps.ts[0];
+        if (ts.tv_sec == 0 and ts.tv_nsec == 0) return false;
+        time = time_spec_t(time_t(ts.tv_sec), ts.tv_nsec/1e9);
+        return true;
+    }
+    return false;
+}
+#endif /*HAVE_SO_TIMESTAMPING*/
+
+/*!
+ * Wait for the socket to become readable:
+ * Spin with non-blocking checks for up to spin_timeout first,
+ * then block for the rest of the timeout.
+ */
+static UHD_INLINE bool wait_for_recv_ready_spin(
+    const int sock_fd, const double timeout, const double spin_timeout
+){
+    if (spin_timeout <= 0.0) return wait_for_recv_ready(sock_fd, timeout);
+    const boost::system_time start_time = boost::get_system_time();
+    const double spin_budget = std::min(spin_timeout, timeout);
+    double elapsed = 0.0;
+    do{
+        if (wait_for_recv_ready(sock_fd, 0.0)) return true;
+        elapsed = (boost::get_system_time() - start_time).total_microseconds()/1e6;
+    } while (elapsed < spin_budget);
+    return (timeout > elapsed) and wait_for_recv_ready(sock_fd, timeout - elapsed);
+}
+
 /***********************************************************************
  * Check registry for correct fast-path setting (windows only)
  **********************************************************************/
@@ -67,26 +206,38 @@ static void check_registry_for_fast_send_threshold(const size_t mtu){
  **********************************************************************/
 class udp_zero_copy_asio_mrb : public managed_recv_buffer{
 public:
-    udp_zero_copy_asio_mrb(void *mem, int sock_fd, const size_t frame_size):
-        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size), _len(0) { /*NOP*/ }
+    //with a frame pool, mem is NULL and a frame is taken per claim
+    udp_zero_copy_asio_mrb(void *mem, int sock_fd, const size_t frame_size, const double spin_timeout, const bool timestamping, shared_frame_pool::client *frame_pool = NULL):
+        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size), _spin_timeout(spin_timeout),
+        _timestamping(timestamping), _len(0), _frame_pool(frame_pool) { /*NOP*/ }
 
     void release(void){
+        this->give_frame();
         _claimer.release();
     }
 
     UHD_INLINE sptr get_new(const double timeout, size_t &index){
-        if (not _claimer.claim_with_wait(timeout)) return sptr();
+        if (not this->claim(timeout)) return sptr();
 
         #ifdef MSG_DONTWAIT //try a non-blocking recv() if supported
-        _len = ::recv(_sock_fd, (char *)_mem, _frame_size, MSG_DONTWAIT);
+        _len = recv_frame(MSG_DONTWAIT);
         if (_len > 0){
             index++; //advances the caller's buffer
             return make(this, _mem, size_t(_len));
         }
         #endif
 
-        if (wait_for_recv_ready(_sock_fd, timeout)){
-            _len = ::recv(_sock_fd, (char *)_mem, _frame_size, 0);
+        if (wait_for_recv_ready_spin(_sock_fd, timeout, _spin_timeout)){
+            #ifdef MSG_DONTWAIT
+            //the socket also wakes up for the error queue, e.g. with udp_zerocopy
+            _len = recv_frame(MSG_DONTWAIT);
+            if (_len < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)){
+                this->unclaim();
+                return sptr(); //null for timeout
+            }
+            #else
+            _len = recv_frame(0);
+            #endif
             if (_len == 0)
                 throw uhd::io_error("socket closed");
             if (_len < 0)
@@ -95,37 +246,228 @@ public:
             return make(this, _mem, size_t(_len));
         }
 
-        _claimer.release(); //undo claim
+        this->unclaim(); //undo claim
         return sptr(); //null for timeout
     }
 
+    /*!
+     * Batched receive support:
+     * The transport claims the buffer, fills it with recvmmsg()
+     * together with its neighbours, and hands it out with get_filled().
+     */
+    UHD_INLINE bool claim(const double timeout){
+        if (not _claimer.claim_with_wait(timeout)) return false;
+        if (_frame_pool == NULL) return true;
+        _mem = _frame_pool->alloc(timeout);
+        if (_mem != NULL) return true;
+        _claimer.release();
+        return false;
+    }
+
+    UHD_INLINE void unclaim(void){
+        this->give_frame();
+        _claimer.release();
+    }
+
+    UHD_INLINE void *get_mem(void) const{
+        return _mem;
+    }
+
+    UHD_INLINE size_t get_frame_size(void) const{
+        return _frame_size;
+    }
+
+    UHD_INLINE void set_len(const size_t len){
+        _len = ssize_t(len);
+    }
+
+    UHD_INLINE void set_recv_time(const bool has_recv_time, const time_spec_t &recv_time){
+        _has_recv_time = has_recv_time;
+        _recv_time = recv_time;
+    }
+
+    UHD_INLINE sptr get_filled(size_t &index){
+        if (_len == 0)
+            throw uhd::io_error("socket closed");
+        index++; //advances the caller's buffer
+        return make(this, _mem, size_t(_len));
+    }
+
 private:
     void *_mem;
     int _sock_fd;
     size_t _frame_size;
+    double _spin_timeout;
+    bool _timestamping;
     ssize_t _len;
+    shared_frame_pool::client *_frame_pool;
+
+    UHD_INLINE void give_frame(void){
+        if (_frame_pool == NULL) return;
+        _frame_pool->free(_mem);
+        _mem = NULL;
+    }
+
+    //receive into the buffer, with the receive time if timestamping
+    UHD_INLINE ssize_t recv_frame(const int flags){
+        #ifdef HAVE_SO_TIMESTAMPING
+        if (_timestamping){
+            iovec iov;
+            iov.iov_base = _mem;
+            iov.iov_len = _frame_size;
+            char ctrl[UDP_RECV_CTRL_SIZE];
+            msghdr msg;
+            std::memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = ctrl;
+            msg.msg_controllen = sizeof(ctrl);
+            const ssize_t len = ::recvmsg(_sock_fd, &msg, flags);
+            _has_recv_time = (len > 0) and get_recv_timestamp(msg, _recv_time);
+            return len;
+        }
+        #endif /*HAVE_SO_TIMESTAMPING*/
+        return ::recv(_sock_fd, (char *)_mem, _frame_size, flags);
+    }
     simple_claimer _claimer;
 };
 
 /***********************************************************************
  * Reusable managed send buffer:
  *  - commit performs the send operation
+ *  - with a send batcher, commit queues the frame and the batcher sends it
  **********************************************************************/
+class udp_send_batcher;
+
 class udp_zero_copy_asio_msb : public managed_send_buffer{
 public:
-    udp_zero_copy_asio_msb(void *mem, int sock_fd, const size_t frame_size):
-        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size) { /*NOP*/ }
+    udp_zero_copy_asio_msb(void *mem, int sock_fd, const size_t frame_size, zero_copy_stats_counters &stats, udp_send_batcher *batcher = NULL):
+        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size), _stats(stats), _batcher(batcher) { /*NOP*/ }
 
-    void release(void){
-        //Retry logic because send may fail with ENOBUFS.
-        //This is known to occur at least on some OSX systems.
-        //But it should be safe to always check for the error.
+    void release(void);
+
+    UHD_INLINE sptr get_new(const double timeout, size_t &index){
+        if (not _claimer.claim_with_wait(timeout)) return sptr();
+        index++; //advances the caller's buffer
+        return make(this, _mem, _frame_size);
+    }
+
+    UHD_INLINE const void *get_mem(void) const{
+        return _mem;
+    }
+
+    //! The frame is sent, and the kernel is done with its memory
+    UHD_INLINE void sent(void){
+        _claimer.release();
+    }
+
+private:
+    void *_mem;
+    int _sock_fd;
+    size_t _frame_size;
+    zero_copy_stats_counters &_stats;
+    udp_send_batcher *_batcher;
+    simple_claimer _claimer;
+};
+
+#ifdef UDP_SEND_OFFLOAD
+/***********************************************************************
+ * Send batcher:
+ * With udp_gso, committed frames of one size are queued and go out as
+ * one UDP_SEGMENT super-datagram, which the kernel or the NIC splits
+ * into datagrams again. Only the last frame of a super-datagram may be
+ * shorter, so a shorter frame ends the batch. A packet which ends a
+ * burst or is not a data packet flushes the queue, as with tcp_framing.
+ * With udp_zerocopy, the frames are sent with MSG_ZEROCOPY and stay
+ * claimed until the kernel reports on the error queue that it is done
+ * with their memory.
+ **********************************************************************/
+class udp_send_batcher{
+public:
+    udp_send_batcher(int sock_fd, const udp_offload_params_t &params, const size_t frame_size, zero_copy_stats_counters &stats):
+        _sock_fd(sock_fd), _params(params), _stats(stats),
+        _max_frames(std::max<size_t>(std::min(params.gso_frames,
+            std::min(UDP_GSO_MAX_SEGMENTS, UDP_GSO_MAX_BYTES/std::max<size_t>(frame_size, 1))), 1)),
+        _seg_size(0), _num_bytes(0), _next_zc_id(0), _warned_copied(false)
+    {
+        _msbs.reserve(_max_frames);
+        _iovs.reserve(_max_frames);
+    }
+
+    void push(udp_zero_copy_asio_msb *msb){
+        const size_t len = msb->size();
+        //all frames of a super-datagram but the last have the segment size
+        if (not _msbs.empty() and (len > _seg_size or _num_bytes + len > UDP_GSO_MAX_BYTES)) this->flush();
+        if (_msbs.empty()) _seg_size = len;
+        _msbs.push_back(msb);
+        _num_bytes += len;
+        if (
+            _msbs.size() >= _max_frames or len < _seg_size or len < sizeof(uint32_t) or
+            _params.framing.type == PACKET_FRAMING_NONE or
+            not is_mid_burst_data(_params.framing, get_header_word(_params.framing, msb->get_mem()))
+        ) this->flush();
+    }
+
+    /*!
+     * Make the frame ready to be claimed again:
+     * Send it if it is still queued, and with zero copy,
+     * wait for the kernel to be done with it.
+     * \return false on timeout
+     */
+    bool make_ready(const udp_zero_copy_asio_msb *msb, const double timeout){
+        if (std::find(_msbs.begin(), _msbs.end(), msb) != _msbs.end()) this->flush();
+        if (_in_flight.empty()) return true;
+        this->reap_completions();
+        const boost::system_time exit_time = boost::get_system_time() +
+            boost::posix_time::microseconds(long(timeout*1e6));
+        while (this->in_flight(msb)){
+            const long timeout_ms = long((exit_time - boost::get_system_time()).total_milliseconds());
+            if (not this->wait_for_completions(std::max<long>(timeout_ms, 0))) return false;
+            this->reap_completions();
+        }
+        return true;
+    }
+
+    void flush(void){
+        if (_msbs.empty()) return;
+        _iovs.resize(_msbs.size());
+        for (size_t i = 0; i < _msbs.size(); i++){
+            _iovs[i].iov_base = const_cast<void *>(_msbs[i]->get_mem());
+            _iovs[i].iov_len = _msbs[i]->size();
+        }
+        msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &_iovs.front();
+        msg.msg_iovlen = _iovs.size();
+        #ifdef HAVE_UDP_GSO
+        char ctrl[CMSG_SPACE(sizeof(uint16_t))];
+        if (_msbs.size() > 1){
+            std::memset(ctrl, 0, sizeof(ctrl));
+            msg.msg_control = ctrl;
+            msg.msg_controllen = sizeof(ctrl);
+            cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            const uint16_t seg_size = uint16_t(_seg_size);
+            std::memcpy(CMSG_DATA(cmsg), &seg_size, sizeof(seg_size));
+        }
+        #endif /*HAVE_UDP_GSO*/
+        int flags = 0;
+        #ifdef HAVE_MSG_ZEROCOPY
+        if (_params.zerocopy) flags |= MSG_ZEROCOPY;
+        #endif /*HAVE_MSG_ZEROCOPY*/
+
+        //Retry logic because send may fail with ENOBUFS, see the plain send.
+        //With zero copy, the pinned memory of the frames in flight counts
+        //against the socket, so their completions are reaped first.
         while (true)
         {
-            const ssize_t ret = ::send(_sock_fd, (const char *)_mem, size(), 0);
-            if (ret == ssize_t(size())) break;
-            if (ret == -1 and errno == ENOBUFS)
+            const ssize_t ret = ::sendmsg(_sock_fd, &msg, flags);
+            if (ret == ssize_t(_num_bytes)) break;
+            if (ret == -1 and (errno == ENOBUFS or errno == EAGAIN))
             {
+                this->reap_completions();
                 boost::this_thread::sleep(boost::posix_time::microseconds(1));
                 continue; //try to send again
             }
@@ -133,23 +475,124 @@ public:
             {
                 throw uhd::io_error(str(boost::format("send error on socket: %s") % strerror(errno)));
             }
-            UHD_ASSERT_THROW(ret == ssize_t(size()));
+            UHD_ASSERT_THROW(ret == ssize_t(_num_bytes));
         }
-        _claimer.release();
-    }
 
-    UHD_INLINE sptr get_new(const double timeout, size_t &index){
-        if (not _claimer.claim_with_wait(timeout)) return sptr();
-        index++; //advances the caller's buffer
-        return make(this, _mem, _frame_size);
+        for (size_t i = 0; i < _msbs.size(); i++){
+            _stats.count_send(_msbs[i]->size());
+            //the kernel numbers the zero copy sends in order
+            if (_params.zerocopy) _in_flight.push_back(std::make_pair(_next_zc_id, _msbs[i]));
+            else _msbs[i]->sent();
+        }
+        if (_params.zerocopy) _next_zc_id++;
+        _msbs.clear();
+        _num_bytes = 0;
     }
 
 private:
-    void *_mem;
-    int _sock_fd;
-    size_t _frame_size;
-    simple_claimer _claimer;
+    typedef std::pair<uint32_t, udp_zero_copy_asio_msb *> in_flight_t;
+
+    bool in_flight(const udp_zero_copy_asio_msb *msb) const{
+        for (size_t i = 0; i < _in_flight.size(); i++){
+            if (_in_flight[i].second == msb) return true;
+        }
+        return false;
+    }
+
+    //! Wait for the error queue to have a completion, false on timeout
+    bool wait_for_completions(const long timeout_ms){
+        #ifdef HAVE_MSG_ZEROCOPY
+        pollfd pfd;
+        pfd.fd = _sock_fd;
+        pfd.events = 0; //the error queue always reports as POLLERR
+        pfd.revents = 0;
+        return ::poll(&pfd, 1, int(timeout_ms)) > 0;
+        #else
+        return timeout_ms < 0; //nothing is ever in flight
+        #endif /*HAVE_MSG_ZEROCOPY*/
+    }
+
+    //! Read the zero copy completions and release their frames
+    void reap_completions(void){
+        #ifdef HAVE_MSG_ZEROCOPY
+        while (not _in_flight.empty()){
+            char ctrl[CMSG_SPACE(sizeof(sock_extended_err)) + CMSG_SPACE(sizeof(sockaddr_in))];
+            msghdr msg;
+            std::memset(&msg, 0, sizeof(msg));
+            msg.msg_control = ctrl;
+            msg.msg_controllen = sizeof(ctrl);
+            if (::recvmsg(_sock_fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) return;
+            for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)){
+                if (cmsg->cmsg_level != SOL_IP or cmsg->cmsg_type != IP_RECVERR) continue;
+                sock_extended_err serr;
+                std::memcpy(&serr, CMSG_DATA(cmsg), sizeof(serr));
+                if (serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY or serr.ee_errno != 0) continue;
+                #ifdef SO_EE_CODE_ZEROCOPY_COPIED
+                if ((serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) and not _warned_copied){
+                    UHD_LOG << "udp_zerocopy: the kernel copied the frames, the interface does not support zero copy" << std::endl;
+                    _warned_copied = true;
+                }
+                #endif /*SO_EE_CODE_ZEROCOPY_COPIED*/
+                this->complete(serr.ee_info, serr.ee_data);
+            }
+        }
+        #endif /*HAVE_MSG_ZEROCOPY*/
+    }
+
+    //! Release the frames of the sends lo to hi, the range may wrap
+    void complete(const uint32_t lo, const uint32_t hi){
+        std::deque<in_flight_t>::iterator it = _in_flight.begin();
+        while (it != _in_flight.end()){
+            if (uint32_t(it->first - lo) <= uint32_t(hi - lo)){
+                it->second->sent();
+                it = _in_flight.erase(it);
+            }
+            else ++it;
+        }
+    }
+
+    const int _sock_fd;
+    const udp_offload_params_t _params;
+    zero_copy_stats_counters &_stats;
+    const size_t _max_frames;
+    size_t _seg_size, _num_bytes;
+    std::vector<udp_zero_copy_asio_msb *> _msbs;
+    std::vector<iovec> _iovs;
+    std::deque<in_flight_t> _in_flight;
+    uint32_t _next_zc_id;
+    bool _warned_copied;
 };
+#endif /*UDP_SEND_OFFLOAD*/
+
+void udp_zero_copy_asio_msb::release(void){
+    #ifdef UDP_SEND_OFFLOAD
+    if (_batcher != NULL){
+        _batcher->push(this);
+        return;
+    }
+    #endif /*UDP_SEND_OFFLOAD*/
+
+    //Retry logic because send may fail with ENOBUFS.
+    //This is known to occur at least on some OSX systems.
+    //But it should be safe to always check for the error.
+    while (true)
+    {
+        const ssize_t ret = ::send(_sock_fd, (const char *)_mem, size(), 0);
+        if (ret == ssize_t(size())) break;
+        if (ret == -1 and errno == ENOBUFS)
+        {
+            boost::this_thread::sleep(boost::posix_time::microseconds(1));
+            continue; //try to send again
+        }
+        if (ret == -1)
+        {
+            throw uhd::io_error(str(boost::format("send error on socket: %s") % strerror(errno)));
+        }
+        UHD_ASSERT_THROW(ret == ssize_t(size()));
+    }
+    _stats.count_send(size());
+    _claimer.release();
+}
 
 /***********************************************************************
  * Zero Copy UDP implementation with ASIO:
@@ -165,15 +608,26 @@ public:
     udp_zero_copy_asio_impl(
         const std::string &addr,
         const std::string &port,
-        const zero_copy_xport_params& xport_params
+        const zero_copy_xport_params& xport_params,
+        const size_t recv_batch,
+        const device_addr_t &buff_hints,
+        const udp_latency_params_t &latency_params,
+        shared_frame_pool::sptr recv_frame_pool,
+        const udp_offload_params_t &offload_params
     ):
         _recv_frame_size(xport_params.recv_frame_size),
         _num_recv_frames(xport_params.num_recv_frames),
         _send_frame_size(xport_params.send_frame_size),
         _num_send_frames(xport_params.num_send_frames),
-        _recv_buffer_pool(buffer_pool::make(xport_params.num_recv_frames, xport_params.recv_frame_size)),
-        _send_buffer_pool(buffer_pool::make(xport_params.num_send_frames, xport_params.send_frame_size)),
-        _next_recv_buff_index(0), _next_send_buff_index(0)
+        _recv_buffer_pool(recv_frame_pool? buffer_pool::sptr() :
+            buffer_pool::make(xport_params.num_recv_frames, xport_params.recv_frame_size, 16, buff_hints)),
+        _send_buffer_pool(buffer_pool::make(xport_params.num_send_frames, xport_params.send_frame_size, 16, buff_hints)),
+        _next_recv_buff_index(0), _next_send_buff_index(0),
+        _recv_batch(std::max<size_t>(std::min(recv_batch, xport_params.num_recv_frames), 1)),
+        _num_batched_recv_frames(0),
+        _spin_timeout(latency_params.spin_timeout),
+        _timestamping(false),
+        _gro(false), _gro_len(0), _gro_offset(0), _gro_seg_size(0), _gro_has_time(false)
     {
         UHD_LOG << boost::format("Creating udp transport for %s %s") % addr % port << std::endl;
 
@@ -191,22 +645,215 @@ public:
         _socket->open(asio::ip::udp::v4());
         _socket->connect(receiver_endpoint);
         _sock_fd = _socket->native();
+        set_latency_options(latency_params);
+        const udp_offload_params_t offload = set_offload_options(offload_params);
 
-        //allocate re-usable managed receive buffers
+        //allocate re-usable managed receive buffers,
+        //with a shared frame pool they take their memory from it on claim
+        if (recv_frame_pool) _recv_frame_client = recv_frame_pool->make_client(get_num_recv_frames());
         for (size_t i = 0; i < get_num_recv_frames(); i++){
             _mrb_pool.push_back(boost::make_shared<udp_zero_copy_asio_mrb>(
-                _recv_buffer_pool->at(i), _sock_fd, get_recv_frame_size()
+                _recv_frame_client? NULL : _recv_buffer_pool->at(i),
+                _sock_fd, get_recv_frame_size(), _spin_timeout, _timestamping, _recv_frame_client.get()
             ));
         }
 
-        //allocate re-usable managed send buffers
+        #ifdef HAVE_RECVMMSG
+        //pre-initialize the message headers for batched receives,
+        //get_recv_buffs() may fill every buffer in the pool at once
+        _recv_msgs.resize(_num_recv_frames);
+        _recv_iovs.resize(_num_recv_frames);
+        std::memset(&_recv_msgs.front(), 0, sizeof(mmsghdr)*_num_recv_frames);
+        for (size_t i = 0; i < _num_recv_frames; i++){
+            _recv_msgs[i].msg_hdr.msg_iov = &_recv_iovs[i];
+            _recv_msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        #ifdef HAVE_SO_TIMESTAMPING
+        if (_timestamping) _recv_ctrls.resize(_num_recv_frames*UDP_RECV_CTRL_SIZE);
+        #endif /*HAVE_SO_TIMESTAMPING*/
+        #endif /*HAVE_RECVMMSG*/
+
+        #ifdef HAVE_UDP_GSO
+        //the staging buffer for GRO coalesced datagrams
+        if (_gro){
+            _gro_staging.resize(UDP_GRO_STAGING_SIZE);
+            size_t ctrl_size = CMSG_SPACE(sizeof(int));
+            #ifdef HAVE_SO_TIMESTAMPING
+            if (_timestamping) ctrl_size += UDP_RECV_CTRL_SIZE;
+            #endif /*HAVE_SO_TIMESTAMPING*/
+            _gro_ctrls.resize(ctrl_size);
+        }
+        #endif /*HAVE_UDP_GSO*/
+
+        //allocate re-usable managed send buffers,
+        //with segmentation or zero copy offload they commit to the batcher
+        udp_send_batcher *batcher = NULL;
+        #ifdef UDP_SEND_OFFLOAD
+        if (offload.gso_frames > 1 or offload.zerocopy){
+            _send_batcher.reset(new udp_send_batcher(_sock_fd, offload, get_send_frame_size(), _stats));
+            batcher = _send_batcher.get();
+        }
+        #else
+        (void)offload;
+        #endif /*UDP_SEND_OFFLOAD*/
         for (size_t i = 0; i < get_num_send_frames(); i++){
             _msb_pool.push_back(boost::make_shared<udp_zero_copy_asio_msb>(
-                _send_buffer_pool->at(i), _sock_fd, get_send_frame_size()
+                _send_buffer_pool->at(i), _sock_fd, get_send_frame_size(), boost::ref(_stats), batcher
             ));
         }
     }
 
+    ~udp_zero_copy_asio_impl(void){
+        #ifdef UDP_SEND_OFFLOAD
+        //send the frames still queued
+        if (_send_batcher) UHD_SAFE_CALL(_send_batcher->flush();)
+        #endif /*UDP_SEND_OFFLOAD*/
+    }
+
+    /*!
+     * Enable the segmentation and zero copy offloads.
+     * An offload the platform or the kernel does not support is
+     * disabled with a warning.
+     * \return the offload parameters which are in effect
+     */
+    udp_offload_params_t set_offload_options(const udp_offload_params_t &params){
+        udp_offload_params_t offload = params;
+        if (offload.gso_frames > 1){
+            #ifdef HAVE_UDP_GSO
+            int gso_size = 0;
+            socklen_t gso_size_len = sizeof(gso_size);
+            if (::getsockopt(_sock_fd, SOL_UDP, UDP_SEGMENT, &gso_size, &gso_size_len) != 0){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to use UDP segmentation offload (udp_gso): %s\n"
+                    "It requires Linux 4.18 or newer."
+                ) % strerror(errno) << std::endl;
+                offload.gso_frames = 1;
+            }
+            #else
+            UHD_MSG(warning) << "UDP segmentation offload (udp_gso) is not supported on this platform." << std::endl;
+            offload.gso_frames = 1;
+            #endif /*HAVE_UDP_GSO*/
+        }
+        if (offload.gro){
+            #ifdef HAVE_UDP_GSO
+            const int one = 1;
+            if (::setsockopt(_sock_fd, SOL_UDP, UDP_GRO, &one, sizeof(one)) != 0){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to use UDP receive offload (udp_gro): %s\n"
+                    "It requires Linux 5.0 or newer."
+                ) % strerror(errno) << std::endl;
+                offload.gro = false;
+            }
+            #else
+            UHD_MSG(warning) << "UDP receive offload (udp_gro) is not supported on this platform." << std::endl;
+            offload.gro = false;
+            #endif /*HAVE_UDP_GSO*/
+        }
+        if (offload.zerocopy){
+            #ifdef HAVE_MSG_ZEROCOPY
+            const int one = 1;
+            if (::setsockopt(_sock_fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) != 0){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to use zero copy sends (udp_zerocopy): %s\n"
+                    "They require Linux 5.0 or newer."
+                ) % strerror(errno) << std::endl;
+                offload.zerocopy = false;
+            }
+            #else
+            UHD_MSG(warning) << "Zero copy sends (udp_zerocopy) are not supported on this platform." << std::endl;
+            offload.zerocopy = false;
+            #endif /*HAVE_MSG_ZEROCOPY*/
+        }
+        _gro = offload.gro;
+        return offload;
+    }
+
+    //apply the socket options of the low latency mode
+    void set_latency_options(const udp_latency_params_t &latency_params){
+        if (latency_params.busy_poll_us > 0){
+            #ifdef SO_BUSY_POLL
+            const int busy_poll_us = latency_params.busy_poll_us;
+            if (::setsockopt(_sock_fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us)) != 0){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to set SO_BUSY_POLL to %d us: %s\n"
+                    "Raising it above net.core.busy_read requires CAP_NET_ADMIN."
+                ) % busy_poll_us % strerror(errno) << std::endl;
+            }
+            #else
+            UHD_MSG(warning) << "SO_BUSY_POLL is not supported on this platform." << std::endl;
+            #endif /*SO_BUSY_POLL*/
+        }
+        if (latency_params.incoming_cpu >= 0){
+            #ifdef SO_INCOMING_CPU
+            const int incoming_cpu = latency_params.incoming_cpu;
+            if (::setsockopt(_sock_fd, SOL_SOCKET, SO_INCOMING_CPU, &incoming_cpu, sizeof(incoming_cpu)) != 0){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to set SO_INCOMING_CPU to %d: %s"
+                ) % incoming_cpu % strerror(errno) << std::endl;
+            }
+            #else
+            UHD_MSG(warning) << "SO_INCOMING_CPU is not supported on this platform." << std::endl;
+            #endif /*SO_INCOMING_CPU*/
+        }
+        if (latency_params.priority >= 0){
+            #ifdef SO_PRIORITY
+            const int priority = latency_params.priority;
+            if (::setsockopt(_sock_fd, SOL_SOCKET, SO_PRIORITY, &priority, sizeof(priority)) != 0){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to set SO_PRIORITY to %d: %s\n"
+                    "Priorities above 6 require CAP_NET_ADMIN."
+                ) % priority % strerror(errno) << std::endl;
+            }
+            #else
+            UHD_MSG(warning) << "SO_PRIORITY is not supported on this platform." << std::endl;
+            #endif /*SO_PRIORITY*/
+        }
+        if (latency_params.timestamp_mode != UDP_TIMESTAMP_NONE){
+            #ifdef HAVE_SO_TIMESTAMPING
+            _timestamping = set_timestamping(latency_params.timestamp_mode, latency_params.nic_name);
+            #else
+            UHD_MSG(warning) << "Receive timestamping is not supported on this platform." << std::endl;
+            #endif /*HAVE_SO_TIMESTAMPING*/
+        }
+    }
+
+    #ifdef HAVE_SO_TIMESTAMPING
+    /*!
+     * Request a timestamp for every received packet.
+     * Hardware timestamps must be enabled on the interface first,
+     * without them the kernel's software timestamps are used.
+     * \return true when timestamping is enabled
+     */
+    bool set_timestamping(const udp_timestamp_mode_t mode, const std::string &nic_name){
+        int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        if (mode == UDP_TIMESTAMP_HARDWARE){
+            hwtstamp_config config;
+            std::memset(&config, 0, sizeof(config));
+            config.tx_type = HWTSTAMP_TX_OFF;
+            config.rx_filter = HWTSTAMP_FILTER_ALL;
+            ifreq ifr;
+            std::memset(&ifr, 0, sizeof(ifr));
+            std::strncpy(ifr.ifr_name, nic_name.c_str(), IFNAMSIZ-1);
+            ifr.ifr_data = reinterpret_cast<char *>(&config);
+            if (nic_name.empty() or ::ioctl(_sock_fd, SIOCSHWTSTAMP, &ifr) != 0){
+                UHD_MSG(warning) << boost::format(
+                    "Unable to enable hardware timestamps on interface \"%s\": %s\n"
+                    "Using software timestamps instead, this requires CAP_NET_ADMIN and driver support."
+                ) % nic_name % (nic_name.empty()? "unknown interface" : strerror(errno)) << std::endl;
+            } else {
+                flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+            }
+        }
+        if (::setsockopt(_sock_fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) != 0){
+            UHD_MSG(warning) << boost::format(
+                "Unable to enable receive timestamping: %s"
+            ) % strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+    #endif /*HAVE_SO_TIMESTAMPING*/
+
     //get size for internal socket buffer
     template <typename Opt> size_t get_buff_size(void) const{
         Opt option;
@@ -225,11 +872,201 @@ public:
      * Receive implementation:
      * Block on the managed buffer's get call and advance the index.
      ******************************************************************/
+    int get_recv_fd(void) const{
+        return _sock_fd;
+    }
+
     managed_recv_buffer::sptr get_recv_buff(double timeout){
+        managed_recv_buffer::sptr buff = get_next_recv_buff(timeout);
+        _stats.count_recv(buff);
+        return buff;
+    }
+
+    UHD_INLINE managed_recv_buffer::sptr get_next_recv_buff(const double timeout){
         if (_next_recv_buff_index == _num_recv_frames) _next_recv_buff_index = 0;
+        #ifdef HAVE_UDP_GSO
+        if (_gro) return get_gro_recv_buff(timeout);
+        #endif /*HAVE_UDP_GSO*/
+        #ifdef HAVE_RECVMMSG
+        if (_recv_batch > 1) return get_batched_recv_buff(timeout);
+        #endif /*HAVE_RECVMMSG*/
         return _mrb_pool[_next_recv_buff_index]->get_new(timeout, _next_recv_buff_index);
     }
 
+    #ifdef HAVE_RECVMMSG
+    /*******************************************************************
+     * Batched receive implementation:
+     * Claim the next buffer and up to udp_batch-1 free buffers after it,
+     * fill as many as possible with a single recvmmsg() call, and hand
+     * the filled buffers out in order on the following calls.
+     * A batch never wraps around the end of the buffer pool.
+     ******************************************************************/
+    managed_recv_buffer::sptr get_batched_recv_buff(const double timeout){
+        //buffers filled by a previous call are already claimed
+        if (_num_batched_recv_frames == 0 and not fill_recv_batch(timeout, _recv_batch)){
+            return managed_recv_buffer::sptr(); //null for timeout
+        }
+        _num_batched_recv_frames--;
+        return _mrb_pool[_next_recv_buff_index]->get_filled(_next_recv_buff_index);
+    }
+
+    /*******************************************************************
+     * Multi-buffer receive implementation:
+     * Hand out the buffers left from a previous batch first,
+     * then fill up to num_buffs more with a single recvmmsg() call.
+     ******************************************************************/
+    size_t get_recv_buffs(managed_recv_buffer::sptr *buffs, const size_t num_buffs, const double timeout){
+        #ifdef HAVE_UDP_GSO
+        //a coalesced datagram already holds a batch
+        if (_gro) return zero_copy_if::get_recv_buffs(buffs, num_buffs, timeout);
+        #endif /*HAVE_UDP_GSO*/
+        size_t num_got = 0;
+        while (num_got < num_buffs){
+            if (_next_recv_buff_index == _num_recv_frames) _next_recv_buff_index = 0;
+            if (_num_batched_recv_frames == 0 and not fill_recv_batch(
+                (num_got == 0)? timeout : 0.0, std::max(_recv_batch, num_buffs - num_got)
+            )) break;
+            _num_batched_recv_frames--;
+            buffs[num_got] = _mrb_pool[_next_recv_buff_index]->get_filled(_next_recv_buff_index);
+            _stats.count_recv(buffs[num_got++]);
+        }
+        if (num_got == 0) _stats.recv_timeouts.add();
+        return num_got;
+    }
+
+    /*!
+     * Claim up to max_frames buffers starting at the next buffer,
+     * and fill them with a single recvmmsg() call.
+     * \return true when at least one buffer was filled
+     */
+    bool fill_recv_batch(const double timeout, const size_t max_frames){
+        const size_t first = _next_recv_buff_index;
+        if (not _mrb_pool[first]->claim(timeout)) return false;
+        size_t num_claimed = 1;
+        while (
+            num_claimed < max_frames and first + num_claimed < _num_recv_frames and
+            _mrb_pool[first + num_claimed]->claim(0.0)
+        ) num_claimed++;
+
+        for (size_t i = 0; i < num_claimed; i++){
+            _recv_iovs[i].iov_base = _mrb_pool[first + i]->get_mem();
+            _recv_iovs[i].iov_len = _mrb_pool[first + i]->get_frame_size();
+            #ifdef HAVE_SO_TIMESTAMPING
+            if (_timestamping){
+                _recv_msgs[i].msg_hdr.msg_control = &_recv_ctrls[i*UDP_RECV_CTRL_SIZE];
+                _recv_msgs[i].msg_hdr.msg_controllen = UDP_RECV_CTRL_SIZE;
+            }
+            #endif /*HAVE_SO_TIMESTAMPING*/
+        }
+
+        int num_recvd = ::recvmmsg(_sock_fd, &_recv_msgs.front(), num_claimed, MSG_DONTWAIT, NULL);
+        int recv_errno = (num_recvd < 0)? errno : 0;
+        if (
+            num_recvd < 0 and (recv_errno == EAGAIN or recv_errno == EWOULDBLOCK) and
+            wait_for_recv_ready_spin(_sock_fd, timeout, _spin_timeout)
+        ){
+            num_recvd = ::recvmmsg(_sock_fd, &_recv_msgs.front(), num_claimed, MSG_DONTWAIT, NULL);
+            recv_errno = (num_recvd < 0)? errno : 0;
+        }
+
+        //undo the claims on buffers that were not filled
+        for (size_t i = std::max(num_recvd, 0); i < num_claimed; i++){
+            _mrb_pool[first + i]->unclaim();
+        }
+
+        if (num_recvd < 0){
+            if (recv_errno == EAGAIN or recv_errno == EWOULDBLOCK) return false;
+            throw uhd::io_error(str(boost::format("recv error on socket: %s") % strerror(recv_errno)));
+        }
+
+        for (int i = 0; i < num_recvd; i++){
+            _mrb_pool[first + i]->set_len(_recv_msgs[i].msg_len);
+            #ifdef HAVE_SO_TIMESTAMPING
+            if (_timestamping){
+                time_spec_t recv_time;
+                const bool has_recv_time = get_recv_timestamp(_recv_msgs[i].msg_hdr, recv_time);
+                _mrb_pool[first + i]->set_recv_time(has_recv_time, recv_time);
+            }
+            #endif /*HAVE_SO_TIMESTAMPING*/
+        }
+        _num_batched_recv_frames = size_t(num_recvd);
+        _stats.recv_queue_hwm.update_max(_num_batched_recv_frames);
+        return num_recvd > 0;
+    }
+    #endif /*HAVE_RECVMMSG*/
+
+    #ifdef HAVE_UDP_GSO
+    /*******************************************************************
+     * GRO receive implementation:
+     * The kernel coalesces the datagrams of the flow into a super-datagram
+     * with a segment size. Receive it into the staging buffer, and copy
+     * one segment per call out into the next buffer.
+     ******************************************************************/
+    managed_recv_buffer::sptr get_gro_recv_buff(const double timeout){
+        udp_zero_copy_asio_mrb &mrb = *_mrb_pool[_next_recv_buff_index];
+        if (not mrb.claim(timeout)) return managed_recv_buffer::sptr();
+        if (_gro_offset == _gro_len and not fill_gro_staging(timeout)){
+            mrb.unclaim();
+            return managed_recv_buffer::sptr(); //null for timeout
+        }
+        //a segment larger than the frame is cut, as recv() would do
+        const size_t seg_len = std::min(_gro_seg_size, _gro_len - _gro_offset);
+        const size_t len = std::min(seg_len, mrb.get_frame_size());
+        std::memcpy(mrb.get_mem(), &_gro_staging[_gro_offset], len);
+        _gro_offset += seg_len;
+        mrb.set_len(len);
+        mrb.set_recv_time(_gro_has_time, _gro_time);
+        return mrb.get_filled(_next_recv_buff_index);
+    }
+
+    //! Receive the next super-datagram, false on timeout
+    bool fill_gro_staging(const double timeout){
+        iovec iov;
+        iov.iov_base = &_gro_staging.front();
+        iov.iov_len = _gro_staging.size();
+        msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = &_gro_ctrls.front();
+        msg.msg_controllen = _gro_ctrls.size();
+
+        ssize_t len = ::recvmsg(_sock_fd, &msg, MSG_DONTWAIT);
+        int recv_errno = (len < 0)? errno : 0;
+        if (
+            len < 0 and (recv_errno == EAGAIN or recv_errno == EWOULDBLOCK) and
+            wait_for_recv_ready_spin(_sock_fd, timeout, _spin_timeout)
+        ){
+            msg.msg_controllen = _gro_ctrls.size();
+            len = ::recvmsg(_sock_fd, &msg, MSG_DONTWAIT);
+            recv_errno = (len < 0)? errno : 0;
+        }
+        if (len < 0){
+            if (recv_errno == EAGAIN or recv_errno == EWOULDBLOCK) return false;
+            throw uhd::io_error(str(boost::format("recv error on socket: %s") % strerror(recv_errno)));
+        }
+
+        //without the control message, the datagram was not coalesced
+        _gro_len = size_t(len);
+        _gro_offset = 0;
+        _gro_seg_size = _gro_len;
+        for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)){
+            if (cmsg->cmsg_level != SOL_UDP or cmsg->cmsg_type != UDP_GRO) continue;
+            int seg_size = 0;
+            std::memcpy(&seg_size, CMSG_DATA(cmsg), sizeof(seg_size));
+            if (seg_size > 0) _gro_seg_size = size_t(seg_size);
+        }
+        _gro_has_time = false;
+        #ifdef HAVE_SO_TIMESTAMPING
+        if (_timestamping) _gro_has_time = get_recv_timestamp(msg, _gro_time);
+        #endif /*HAVE_SO_TIMESTAMPING*/
+        if (_gro_seg_size != 0){
+            _stats.recv_queue_hwm.update_max((_gro_len + _gro_seg_size - 1)/_gro_seg_size);
+        }
+        return true;
+    }
+    #endif /*HAVE_UDP_GSO*/
+
     size_t get_num_recv_frames(void) const {return _num_recv_frames;}
     size_t get_recv_frame_size(void) const {return _recv_frame_size;}
 
@@ -239,21 +1076,64 @@ public:
      ******************************************************************/
     managed_send_buffer::sptr get_send_buff(double timeout){
         if (_next_send_buff_index == _num_send_frames) _next_send_buff_index = 0;
-        return _msb_pool[_next_send_buff_index]->get_new(timeout, _next_send_buff_index);
+        #ifdef UDP_SEND_OFFLOAD
+        if (_send_batcher and not _send_batcher->make_ready(_msb_pool[_next_send_buff_index].get(), timeout)){
+            _stats.send_timeouts.add();
+            return managed_send_buffer::sptr();
+        }
+        #endif /*UDP_SEND_OFFLOAD*/
+        managed_send_buffer::sptr buff = _msb_pool[_next_send_buff_index]->get_new(timeout, _next_send_buff_index);
+        if (not buff) _stats.send_timeouts.add();
+        return buff;
     }
 
     size_t get_num_send_frames(void) const {return _num_send_frames;}
     size_t get_send_frame_size(void) const {return _send_frame_size;}
 
+    zero_copy_stats_t get_stats(void) const {return _stats.get();}
+
 private:
+    //counters, referenced by the send buffers
+    zero_copy_stats_counters _stats;
+
+    #ifdef UDP_SEND_OFFLOAD
+    //segmentation and zero copy offload -> referenced by the send buffers
+    boost::scoped_ptr<udp_send_batcher> _send_batcher;
+    #endif /*UDP_SEND_OFFLOAD*/
+
     //memory management -> buffers and fifos
     const size_t _recv_frame_size, _num_recv_frames;
     const size_t _send_frame_size, _num_send_frames;
     buffer_pool::sptr _recv_buffer_pool, _send_buffer_pool;
+    shared_frame_pool::client::sptr _recv_frame_client; //instead of _recv_buffer_pool
     std::vector<boost::shared_ptr<udp_zero_copy_asio_msb> > _msb_pool;
     std::vector<boost::shared_ptr<udp_zero_copy_asio_mrb> > _mrb_pool;
     size_t _next_recv_buff_index, _next_send_buff_index;
 
+    //batched receive -> buffers filled but not yet handed out
+    const size_t _recv_batch;
+    size_t _num_batched_recv_frames;
+
+    //low latency mode -> spin before blocking
+    const double _spin_timeout;
+
+    //receive timestamping -> control message buffers for batched receives
+    bool _timestamping;
+    #ifdef HAVE_SO_TIMESTAMPING
+    std::vector<char> _recv_ctrls;
+    #endif /*HAVE_SO_TIMESTAMPING*/
+    #ifdef HAVE_RECVMMSG
+    std::vector<mmsghdr> _recv_msgs;
+    std::vector<iovec> _recv_iovs;
+    #endif /*HAVE_RECVMMSG*/
+
+    //receive offload -> a coalesced datagram and the segment to hand out next
+    bool _gro;
+    std::vector<char> _gro_staging, _gro_ctrls;
+    size_t _gro_len, _gro_offset, _gro_seg_size;
+    bool _gro_has_time;
+    time_spec_t _gro_time;
+
     //asio guts -> socket and service
     asio::io_service        _io_service;
     socket_sptr             _socket;
@@ -294,6 +1174,197 @@ template<typename Opt> static size_t resize_buff_helper(
     return actual_size;
 }
 
+/***********************************************************************
+ * Find the name of the network interface that routes to an address
+ * Returns an empty string when it is unknown.
+ **********************************************************************/
+static std::string get_nic_name(const std::string &addr, const std::string &port){
+    try{
+        asio::io_service io_service;
+        asio::ip::udp::resolver resolver(io_service);
+        asio::ip::udp::resolver::query query(asio::ip::udp::v4(), addr, port);
+        asio::ip::udp::socket socket(io_service);
+        socket.open(asio::ip::udp::v4());
+        socket.connect(*resolver.resolve(query));
+        const std::string local_addr = socket.local_endpoint().address().to_string();
+
+        BOOST_FOREACH(const if_addrs_t &if_addrs, get_if_addrs()){
+            if (if_addrs.inet == local_addr) return if_addrs.name;
+        }
+    }
+    catch(const std::exception &){
+        //the transport itself reports problems with the address
+    }
+    return "";
+}
+
+/***********************************************************************
+ * Find the NUMA node of the network interface that routes to an address
+ * Returns -1 when it is unknown.
+ **********************************************************************/
+static int get_nic_numa_node(const std::string &addr, const std::string &port){
+    const std::string nic_name = get_nic_name(addr, port);
+    if (nic_name.empty()) return -1;
+    std::ifstream numa_file(("/sys/class/net/" + nic_name + "/device/numa_node").c_str());
+    int numa_node = -1;
+    if (numa_file >> numa_node) return numa_node;
+    return -1;
+}
+
+/***********************************************************************
+ * The transport hints, parsed and checked once per transport
+ **********************************************************************/
+class udp_zero_copy_args_t : public uhd::usrp::constrained_device_args_t{
+public:
+    udp_zero_copy_args_t(const zero_copy_xport_params &default_buff_args):
+        //sizes are parsed as doubles, so 1e6 is a valid size
+        _recv_frame_size("recv_frame_size", double(default_buff_args.recv_frame_size)),
+        _num_recv_frames("num_recv_frames", double(default_buff_args.num_recv_frames)),
+        _send_frame_size("send_frame_size", double(default_buff_args.send_frame_size)),
+        _num_send_frames("num_send_frames", double(default_buff_args.num_send_frames)),
+        _recv_buff_size("recv_buff_size", 0.0),
+        _send_buff_size("send_buff_size", 0.0),
+        _udp_batch("udp_batch", 1.0),
+        _latency_mode("latency_mode", 0),
+        _udp_busy_poll_us("udp_busy_poll_us", DEFAULT_LATENCY_BUSY_POLL_US),
+        _udp_spin_us("udp_spin_us", 0.0),
+        _udp_incoming_cpu("udp_incoming_cpu", -1),
+        _udp_timestamp("udp_timestamp", ""),
+        _udp_priority("udp_priority", -1),
+        _udp_gso("udp_gso", 1.0),
+        _udp_framing("udp_framing", "none"),
+        _udp_gro("udp_gro", 0),
+        _udp_zerocopy("udp_zerocopy", 0),
+        _has_recv_buff_size(false),
+        _has_send_buff_size(false)
+    {}
+
+    zero_copy_xport_params get_xport_params(const zero_copy_xport_params &default_buff_args) const{
+        zero_copy_xport_params xport_params = default_buff_args;
+        xport_params.recv_frame_size = size_t(_recv_frame_size.get());
+        xport_params.num_recv_frames = size_t(_num_recv_frames.get());
+        xport_params.send_frame_size = size_t(_send_frame_size.get());
+        xport_params.num_send_frames = size_t(_num_send_frames.get());
+        return xport_params;
+    }
+    size_t get_recv_buff_size(void) const{
+        return _has_recv_buff_size? size_t(_recv_buff_size.get()) : min_recv_buff_size();
+    }
+    size_t get_send_buff_size(void) const{
+        return _has_send_buff_size? size_t(_send_buff_size.get()) : min_send_buff_size();
+    }
+    size_t get_udp_batch(void) const{
+        return size_t(_udp_batch.get());
+    }
+    udp_latency_params_t get_latency_params(void) const{
+        udp_latency_params_t latency_params;
+        if (_latency_mode.get() != 0){
+            latency_params.busy_poll_us = _udp_busy_poll_us.get();
+            latency_params.spin_timeout = _udp_spin_us.get()/1e6;
+            latency_params.incoming_cpu = _udp_incoming_cpu.get();
+        }
+        if (_udp_timestamp == "sw") latency_params.timestamp_mode = UDP_TIMESTAMP_SOFTWARE;
+        if (_udp_timestamp == "hw") latency_params.timestamp_mode = UDP_TIMESTAMP_HARDWARE;
+        latency_params.priority = _udp_priority.get();
+        return latency_params;
+    }
+    udp_offload_params_t get_offload_params(void) const{
+        udp_offload_params_t offload_params;
+        offload_params.gso_frames = std::max<size_t>(size_t(_udp_gso.get()), 1);
+        offload_params.framing = get_packet_framing_params("udp_framing", _udp_framing.get());
+        offload_params.gro = _udp_gro.get() != 0;
+        offload_params.zerocopy = _udp_zerocopy.get() != 0;
+        return offload_params;
+    }
+
+    inline virtual std::string to_string() const{
+        return _recv_frame_size.to_string() + ", " +
+               _num_recv_frames.to_string() + ", " +
+               _send_frame_size.to_string() + ", " +
+               _num_send_frames.to_string() + ", " +
+               _recv_buff_size.to_string() + ", " +
+               _send_buff_size.to_string() + ", " +
+               _udp_batch.to_string() + ", " +
+               _latency_mode.to_string() + ", " +
+               _udp_busy_poll_us.to_string() + ", " +
+               _udp_spin_us.to_string() + ", " +
+               _udp_incoming_cpu.to_string() + ", " +
+               _udp_timestamp.to_string() + ", " +
+               _udp_priority.to_string() + ", " +
+               _udp_gso.to_string() + ", " +
+               _udp_framing.to_string() + ", " +
+               _udp_gro.to_string() + ", " +
+               _udp_zerocopy.to_string();
+    }
+
+private:
+    size_t min_recv_buff_size(void) const{
+        return size_t(_num_recv_frames.get()) * MAX_ETHERNET_MTU;
+    }
+    size_t min_send_buff_size(void) const{
+        return size_t(_num_send_frames.get()) * MAX_ETHERNET_MTU;
+    }
+
+    virtual void _parse(const device_addr_t& dev_args){
+        _parse_arg(dev_args, _recv_frame_size);
+        _parse_arg(dev_args, _num_recv_frames);
+        _parse_arg(dev_args, _send_frame_size);
+        _parse_arg(dev_args, _num_send_frames);
+        _has_recv_buff_size = _parse_arg(dev_args, _recv_buff_size);
+        _has_send_buff_size = _parse_arg(dev_args, _send_buff_size);
+        _parse_arg(dev_args, _udp_batch);
+        _parse_arg(dev_args, _latency_mode);
+        _parse_arg(dev_args, _udp_busy_poll_us);
+        _parse_arg(dev_args, _udp_spin_us);
+        _parse_arg(dev_args, _udp_incoming_cpu);
+        _parse_arg(dev_args, _udp_timestamp);
+        _parse_arg(dev_args, _udp_priority);
+        _parse_arg(dev_args, _udp_gso);
+        _parse_arg(dev_args, _udp_framing);
+        _parse_arg(dev_args, _udp_gro);
+        _parse_arg(dev_args, _udp_zerocopy);
+
+        if (_has_recv_buff_size and get_recv_buff_size() < min_recv_buff_size()){
+            throw uhd::value_error((boost::format(
+                "recv_buff_size must be equal to or greater than %d")
+                % min_recv_buff_size()).str());
+        }
+        if (_has_send_buff_size and get_send_buff_size() < min_send_buff_size()){
+            throw uhd::value_error((boost::format(
+                "send_buff_size must be equal to or greater than %d")
+                % min_send_buff_size()).str());
+        }
+        if (not (_udp_timestamp == "" or _udp_timestamp == "sw" or _udp_timestamp == "hw")){
+            throw uhd::value_error("udp_timestamp must be sw or hw, got " + _udp_timestamp.get());
+        }
+        //a batch can only be held back while the burst goes on
+        const packet_framing_params_t framing = get_packet_framing_params("udp_framing", _udp_framing.get());
+        if (_udp_gso.get() > 1 and framing.type == PACKET_FRAMING_NONE){
+            throw uhd::value_error("udp_gso requires udp_framing to find the end of a burst");
+        }
+    }
+
+    num_arg<double> _recv_frame_size;
+    num_arg<double> _num_recv_frames;
+    num_arg<double> _send_frame_size;
+    num_arg<double> _num_send_frames;
+    num_arg<double> _recv_buff_size;
+    num_arg<double> _send_buff_size;
+    num_arg<double> _udp_batch;
+    num_arg<int>    _latency_mode;
+    num_arg<int>    _udp_busy_poll_us;
+    num_arg<double> _udp_spin_us;
+    num_arg<int>    _udp_incoming_cpu;
+    str_ci_arg      _udp_timestamp;
+    num_arg<int>    _udp_priority;
+    num_arg<double> _udp_gso;
+    str_ci_arg      _udp_framing;
+    num_arg<int>    _udp_gro;
+    num_arg<int>    _udp_zerocopy;
+    bool            _has_recv_buff_size;
+    bool            _has_send_buff_size;
+};
+
 udp_zero_copy::sptr udp_zero_copy::make(
     const std::string &addr,
     const std::string &port,
@@ -301,36 +1372,58 @@ udp_zero_copy::sptr udp_zero_copy::make(
     udp_zero_copy::buff_params& buff_params_out,
     const device_addr_t &hints
 ){
-    //Initialize xport_params
-    zero_copy_xport_params xport_params = default_buff_args;
+    //Parse and check the hints once
+    udp_zero_copy_args_t args(default_buff_args);
+    args.parse(hints);
 
-    xport_params.recv_frame_size = size_t(hints.cast<double>("recv_frame_size", default_buff_args.recv_frame_size));
-    xport_params.num_recv_frames = size_t(hints.cast<double>("num_recv_frames", default_buff_args.num_recv_frames));
-    xport_params.send_frame_size = size_t(hints.cast<double>("send_frame_size", default_buff_args.send_frame_size));
-    xport_params.num_send_frames = size_t(hints.cast<double>("num_send_frames", default_buff_args.num_send_frames));
+    //Initialize xport_params
+    zero_copy_xport_params xport_params = args.get_xport_params(default_buff_args);
 
     //extract buffer size hints from the device addr
-    size_t usr_recv_buff_size = size_t(hints.cast<double>("recv_buff_size", xport_params.num_recv_frames * MAX_ETHERNET_MTU));
-    size_t usr_send_buff_size = size_t(hints.cast<double>("send_buff_size", xport_params.num_send_frames * MAX_ETHERNET_MTU));
+    size_t usr_recv_buff_size = args.get_recv_buff_size();
+    size_t usr_send_buff_size = args.get_send_buff_size();
 
-    if (hints.has_key("recv_buff_size")) {
-        if (usr_recv_buff_size < xport_params.num_recv_frames * MAX_ETHERNET_MTU) {
-            throw uhd::value_error((boost::format(
-                "recv_buff_size must be equal to or greater than %d")
-                % (xport_params.num_recv_frames * MAX_ETHERNET_MTU)).str());
-        }
+    //number of frames to fill per receive call, 1 disables batching
+    const size_t recv_batch = args.get_udp_batch();
+    #ifndef HAVE_RECVMMSG
+    if (recv_batch > 1) UHD_MSG(warning) <<
+        "Batched receives (udp_batch) are not supported on this platform." << std::endl;
+    #endif /*HAVE_RECVMMSG*/
+
+    //buffer pool memory options, see buffer_pool::make()
+    //with any of them set, default to the NUMA node of the network interface
+    device_addr_t buff_hints;
+    BOOST_FOREACH(const std::string &key, hints.keys()){
+        if (key.find("buff_") == 0) buff_hints[key] = hints[key];
+    }
+    if (buff_hints.size() != 0 and not buff_hints.has_key("buff_numa_node")){
+        const int numa_node = get_nic_numa_node(addr, port);
+        if (numa_node >= 0) buff_hints["buff_numa_node"] = boost::lexical_cast<std::string>(numa_node);
     }
 
-    if (hints.has_key("send_buff_size")) {
-        if (usr_send_buff_size < xport_params.num_send_frames * MAX_ETHERNET_MTU) {
-            throw uhd::value_error((boost::format(
-                "send_buff_size must be equal to or greater than %d")
-                % (xport_params.num_send_frames * MAX_ETHERNET_MTU)).str());
-        }
+    //low latency mode: busy poll the socket in the kernel, optionally
+    //spin in user space, and steer the flow to a CPU
+    //receive timestamps for instrumentation, see managed_recv_buffer::get_recv_time()
+    udp_latency_params_t latency_params = args.get_latency_params();
+    if (latency_params.timestamp_mode == UDP_TIMESTAMP_HARDWARE){
+        latency_params.nic_name = get_nic_name(addr, port);
     }
 
+    //receive frames from a process wide pool, shared by the transports
+    //with the same frame size, instead of a buffer pool per transport
+    shared_frame_pool::sptr recv_frame_pool;
+    const size_t recv_pool_frames = hints.cast<size_t>("recv_pool_frames", 0);
+    if (recv_pool_frames != 0){
+        recv_frame_pool = shared_frame_pool::get_shared(
+            recv_pool_frames, xport_params.recv_frame_size, buff_hints);
+    }
+
+    //send batches of frames as one super-datagram, receive coalesced
+    //super-datagrams, and send from the frames without a copy
+    const udp_offload_params_t offload_params = args.get_offload_params();
+
     udp_zero_copy_asio_impl::sptr udp_trans(
-        new udp_zero_copy_asio_impl(addr, port, xport_params)
+        new udp_zero_copy_asio_impl(addr, port, xport_params, recv_batch, buff_hints, latency_params, recv_frame_pool, offload_params)
     );
 
     //call the helper to resize send and recv buffers
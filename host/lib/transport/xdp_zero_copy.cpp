@@ -0,0 +1,545 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "udp_common.hpp"
+#include <uhd/transport/xdp_zero_copy.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/atomic.hpp>
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/circular_buffer.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp> //yield
+#include <boost/algorithm/string.hpp>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <vector>
+#include <xdp/xsk.h>
+#include <linux/bpf.h> //XDP_PACKET_HEADROOM
+#include <linux/if_ether.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace uhd;
+using namespace uhd::transport;
+namespace asio = boost::asio;
+
+//UMEM frames are one page each, the kernel reserves headroom in front of the packet
+static const size_t XDP_FRAME_SIZE = XSK_UMEM__DEFAULT_FRAME_SIZE;
+static const size_t XDP_HDR_SIZE = sizeof(ethhdr) + sizeof(iphdr) + sizeof(udphdr);
+static const size_t XDP_MAX_PAYLOAD_SIZE = XDP_FRAME_SIZE - XDP_PACKET_HEADROOM - XDP_HDR_SIZE;
+
+static const size_t DEFAULT_XDP_QUEUE = 0;
+static const size_t DEFAULT_XDP_PORT = 50000;
+
+/***********************************************************************
+ * Helpers for the interface and endpoint addresses
+ **********************************************************************/
+static void parse_mac_addr(const std::string &mac_str, uint8_t *mac){
+    unsigned int b[ETH_ALEN];
+    if (std::sscanf(mac_str.c_str(), "%x:%x:%x:%x:%x:%x",
+            &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) != ETH_ALEN){
+        throw uhd::value_error(str(boost::format("invalid MAC address: %s") % mac_str));
+    }
+    for (size_t i = 0; i < ETH_ALEN; i++) mac[i] = uint8_t(b[i]);
+}
+
+static void get_iface_addrs(const std::string &iface, uint8_t *mac, uint32_t &ip){
+    const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) throw uhd::os_error("xdp: could not open a socket for interface queries");
+
+    ifreq ifr;
+    std::memset(&ifr, 0, sizeof(ifr));
+    std::strncpy(ifr.ifr_name, iface.c_str(), IFNAMSIZ - 1);
+    const bool ok_mac = ::ioctl(fd, SIOCGIFHWADDR, &ifr) == 0;
+    if (ok_mac) std::memcpy(mac, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+    const bool ok_ip = ::ioctl(fd, SIOCGIFADDR, &ifr) == 0;
+    if (ok_ip) ip = reinterpret_cast<sockaddr_in *>(&ifr.ifr_addr)->sin_addr.s_addr;
+    ::close(fd);
+
+    if (not ok_mac or not ok_ip) throw uhd::value_error(str(boost::format(
+        "xdp: could not get the addresses of interface %s: %s") % iface % strerror(errno)));
+}
+
+//! Look up the endpoint in the kernel's ARP cache, it was contacted during discovery
+static bool lookup_arp_cache(const std::string &iface, const std::string &ip, uint8_t *mac){
+    std::ifstream arp("/proc/net/arp");
+    std::string line;
+    std::getline(arp, line); //header line
+    while (std::getline(arp, line)){
+        std::vector<std::string> fields;
+        boost::split(fields, line, boost::is_any_of(" "), boost::token_compress_on);
+        //IP address, HW type, Flags, HW address, Mask, Device
+        if (fields.size() < 6 or fields[0] != ip or fields[5] != iface) continue;
+        if (fields[3] == "00:00:00:00:00:00") continue; //incomplete entry
+        parse_mac_addr(fields[3], mac);
+        return true;
+    }
+    return false;
+}
+
+static uint16_t ip_checksum(const void *data, const size_t len){
+    const uint16_t *words = reinterpret_cast<const uint16_t *>(data);
+    uint32_t sum = 0;
+    for (size_t i = 0; i < len/2; i++) sum += words[i];
+    while (sum >> 16) sum = (sum & 0xffff) + (sum >> 16);
+    return uint16_t(~sum);
+}
+
+static uint32_t next_pow2(const size_t n){
+    uint32_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+/***********************************************************************
+ * Queue allocation:
+ *   Only one AF_XDP socket can be bound to a queue of an interface.
+ *   Transports take the lowest free queue starting at xdp_queue.
+ **********************************************************************/
+static boost::mutex xdp_queue_mutex;
+static std::set<std::pair<std::string, size_t> > xdp_queues_in_use;
+
+static size_t allocate_queue(const std::string &iface, const size_t first_queue){
+    boost::mutex::scoped_lock lock(xdp_queue_mutex);
+    size_t queue = first_queue;
+    while (xdp_queues_in_use.count(std::make_pair(iface, queue))) queue++;
+    xdp_queues_in_use.insert(std::make_pair(iface, queue));
+    return queue;
+}
+
+static void free_queue(const std::string &iface, const size_t queue){
+    boost::mutex::scoped_lock lock(xdp_queue_mutex);
+    xdp_queues_in_use.erase(std::make_pair(iface, queue));
+}
+
+/***********************************************************************
+ * Reusable managed receive buffer:
+ *  - the buffer is claimed while its frame belongs to the kernel
+ *  - release makes the frame available for the fill ring again
+ **********************************************************************/
+class xdp_zero_copy_mrb : public managed_recv_buffer{
+public:
+    void release(void){
+        _claimer.release();
+    }
+
+    UHD_INLINE bool claim(void){
+        return _claimer.claim_with_wait(0.0);
+    }
+
+    UHD_INLINE sptr get_new(void *mem, const size_t len){
+        return make(this, mem, len);
+    }
+
+private:
+    simple_claimer _claimer;
+};
+
+/***********************************************************************
+ * Reusable managed send buffer:
+ *  - commit queues the frame on the tx ring
+ **********************************************************************/
+class xdp_zero_copy_impl;
+
+class xdp_zero_copy_msb : public managed_send_buffer{
+public:
+    xdp_zero_copy_msb(xdp_zero_copy_impl *xport, const size_t frame, void *mem, const size_t frame_size):
+        _xport(xport), _frame(frame), _mem(mem), _frame_size(frame_size) { /*NOP*/ }
+
+    void release(void);
+
+    UHD_INLINE sptr get_new(void){
+        return make(this, _mem, _frame_size);
+    }
+
+private:
+    xdp_zero_copy_impl *_xport;
+    const size_t _frame;
+    void *_mem;
+    const size_t _frame_size;
+};
+
+/***********************************************************************
+ * Zero copy AF_XDP implementation:
+ *   The UMEM holds num_recv_frames receive frames followed by
+ *   num_send_frames send frames. The receive side owns the fill and
+ *   rx rings, the send side owns the tx and completion rings, so
+ *   one thread may receive while another thread sends.
+ **********************************************************************/
+class xdp_zero_copy_impl : public xdp_zero_copy{
+public:
+    xdp_zero_copy_impl(
+        const std::string &addr,
+        const std::string &port,
+        const zero_copy_xport_params &xport_params,
+        const device_addr_t &hints
+    ):
+        _recv_frame_size(xport_params.recv_frame_size),
+        _num_recv_frames(xport_params.num_recv_frames),
+        _send_frame_size(xport_params.send_frame_size),
+        _num_send_frames(xport_params.num_send_frames),
+        _iface(hints["xdp_iface"]),
+        _queue(allocate_queue(_iface, hints.cast<size_t>("xdp_queue", DEFAULT_XDP_QUEUE))),
+        _umem_area(NULL), _umem(NULL), _xsk(NULL),
+        _recv_frames_out(_num_recv_frames)
+    {
+        try{
+            this->setup_addrs(addr, port, hints);
+            this->setup_socket(hints.has_key("xdp_copy"));
+        }
+        catch(...){
+            this->cleanup();
+            throw;
+        }
+
+        UHD_LOG << boost::format("Creating xdp transport for %s %s on %s queue %d port %d")
+            % addr % port % _iface % _queue % ntohs(_local_port) << std::endl;
+    }
+
+    ~xdp_zero_copy_impl(void){
+        this->cleanup();
+    }
+
+    /*******************************************************************
+     * Receive implementation:
+     * Return released frames to the fill ring, then take the next
+     * packet of this flow from the rx ring.
+     ******************************************************************/
+    managed_recv_buffer::sptr get_recv_buff(double timeout){
+        this->refill();
+
+        while (true){
+            uint32_t idx;
+            if (xsk_ring_cons__peek(&_rx, 1, &idx) == 0){
+                //poll also wakes up the driver when the fill ring needs it
+                if (not wait_for_recv_ready(_fd, timeout)) return managed_recv_buffer::sptr();
+                if (xsk_ring_cons__peek(&_rx, 1, &idx) == 0) return managed_recv_buffer::sptr();
+            }
+            const xdp_desc *desc = xsk_ring_cons__rx_desc(&_rx, idx);
+            const uint64_t frame_addr = desc->addr;
+            const size_t len = desc->len;
+            xsk_ring_cons__release(&_rx, 1);
+
+            uint8_t *pkt = static_cast<uint8_t *>(xsk_umem__get_data(_umem_area, frame_addr));
+            const size_t frame = size_t(frame_addr / XDP_FRAME_SIZE);
+            const size_t payload_len = this->parse_packet(pkt, len);
+            if (payload_len == 0){
+                this->fill_frames(&frame, 1); //not ours, recycle
+                continue;
+            }
+
+            _recv_frames_out.push_back(frame);
+            return _mrb_pool[frame]->get_new(pkt + XDP_HDR_SIZE, payload_len);
+        }
+    }
+
+    size_t get_num_recv_frames(void) const {return _num_recv_frames;}
+    size_t get_recv_frame_size(void) const {return _recv_frame_size;}
+
+    /*******************************************************************
+     * Send implementation:
+     * Take a free frame, reaping the completion ring when none is left.
+     ******************************************************************/
+    managed_send_buffer::sptr get_send_buff(double timeout){
+        this->reap_completions();
+        if (_free_send_frames.empty()){
+            const time_spec_t exit_time = time_spec_t::get_system_time() + time_spec_t(timeout);
+            do{
+                this->kick_tx();
+                boost::this_thread::yield();
+                this->reap_completions();
+                if (not _free_send_frames.empty()) break;
+            } while (time_spec_t::get_system_time() < exit_time);
+            if (_free_send_frames.empty()) return managed_send_buffer::sptr();
+        }
+
+        const size_t frame = _free_send_frames.back();
+        _free_send_frames.pop_back();
+        return _msb_pool[frame - _num_recv_frames]->get_new();
+    }
+
+    size_t get_num_send_frames(void) const {return _num_send_frames;}
+    size_t get_send_frame_size(void) const {return _send_frame_size;}
+
+    //! Add the headers to a committed send frame and queue it on the tx ring
+    void commit_frame(const size_t frame, const size_t len){
+        uint8_t *pkt = static_cast<uint8_t *>(_umem_area) + frame*XDP_FRAME_SIZE;
+        std::memcpy(pkt, _hdr_template, XDP_HDR_SIZE);
+        iphdr *ip = reinterpret_cast<iphdr *>(pkt + sizeof(ethhdr));
+        ip->tot_len = htons(uint16_t(sizeof(iphdr) + sizeof(udphdr) + len));
+        ip->check = ip_checksum(ip, sizeof(iphdr));
+        udphdr *udp = reinterpret_cast<udphdr *>(pkt + sizeof(ethhdr) + sizeof(iphdr));
+        udp->len = htons(uint16_t(sizeof(udphdr) + len));
+
+        //the tx ring holds every send frame, so a slot is always available
+        uint32_t idx;
+        UHD_ASSERT_THROW(xsk_ring_prod__reserve(&_tx, 1, &idx) == 1);
+        xdp_desc *desc = xsk_ring_prod__tx_desc(&_tx, idx);
+        desc->addr = uint64_t(frame*XDP_FRAME_SIZE);
+        desc->len = uint32_t(XDP_HDR_SIZE + len);
+        xsk_ring_prod__submit(&_tx, 1);
+        this->kick_tx();
+    }
+
+private:
+    void setup_addrs(const std::string &addr, const std::string &port, const device_addr_t &hints){
+        //resolve the endpoint
+        asio::ip::udp::resolver resolver(_io_service);
+        asio::ip::udp::resolver::query query(asio::ip::udp::v4(), addr, port);
+        const asio::ip::udp::endpoint endpoint = *resolver.resolve(query);
+        const std::string remote_ip = endpoint.address().to_string();
+
+        uint8_t local_mac[ETH_ALEN], remote_mac[ETH_ALEN];
+        uint32_t local_ip = 0;
+        get_iface_addrs(_iface, local_mac, local_ip);
+        if (hints.has_key("xdp_dst_mac")){
+            parse_mac_addr(hints["xdp_dst_mac"], remote_mac);
+        }
+        else if (not lookup_arp_cache(_iface, remote_ip, remote_mac)){
+            throw uhd::runtime_error(str(boost::format(
+                "xdp: %s is not in the ARP cache of %s.\n"
+                "Ping the device first or pass its MAC address with the xdp_dst_mac hint.")
+                % remote_ip % _iface));
+        }
+
+        //reserve the local port so that the kernel does not hand it out
+        const size_t port_base = hints.cast<size_t>("xdp_port", DEFAULT_XDP_PORT);
+        const size_t queue_base = hints.cast<size_t>("xdp_queue", DEFAULT_XDP_QUEUE);
+        const uint16_t local_port = uint16_t(port_base + _queue - queue_base);
+        _port_socket = socket_sptr(new asio::ip::udp::socket(_io_service));
+        _port_socket->open(asio::ip::udp::v4());
+        boost::system::error_code ec;
+        _port_socket->bind(asio::ip::udp::endpoint(asio::ip::udp::v4(), local_port), ec);
+        if (ec) throw uhd::runtime_error(str(boost::format(
+            "xdp: could not reserve local UDP port %d: %s") % local_port % ec.message()));
+
+        _local_port = htons(local_port);
+        _remote_port = htons(endpoint.port());
+        _remote_ip = htonl(uint32_t(endpoint.address().to_v4().to_ulong()));
+
+        //header template for the send frames
+        std::memset(_hdr_template, 0, sizeof(_hdr_template));
+        ethhdr *eth = reinterpret_cast<ethhdr *>(_hdr_template);
+        std::memcpy(eth->h_dest, remote_mac, ETH_ALEN);
+        std::memcpy(eth->h_source, local_mac, ETH_ALEN);
+        eth->h_proto = htons(ETH_P_IP);
+        iphdr *ip = reinterpret_cast<iphdr *>(_hdr_template + sizeof(ethhdr));
+        ip->version = 4;
+        ip->ihl = sizeof(iphdr)/4;
+        ip->frag_off = htons(IP_DF);
+        ip->ttl = 64;
+        ip->protocol = IPPROTO_UDP;
+        ip->saddr = local_ip;
+        ip->daddr = _remote_ip;
+        udphdr *udp = reinterpret_cast<udphdr *>(_hdr_template + sizeof(ethhdr) + sizeof(iphdr));
+        udp->source = _local_port;
+        udp->dest = _remote_port;
+        udp->check = 0; //optional for IPv4
+    }
+
+    void setup_socket(const bool copy_mode){
+        const size_t num_frames = _num_recv_frames + _num_send_frames;
+        const size_t umem_size = num_frames*XDP_FRAME_SIZE;
+        if (posix_memalign(&_umem_area, size_t(getpagesize()), umem_size) != 0){
+            _umem_area = NULL;
+            throw uhd::os_error("xdp: could not allocate the UMEM area");
+        }
+
+        xsk_umem_config umem_config;
+        std::memset(&umem_config, 0, sizeof(umem_config));
+        umem_config.fill_size = next_pow2(_num_recv_frames);
+        umem_config.comp_size = next_pow2(_num_send_frames);
+        umem_config.frame_size = XDP_FRAME_SIZE;
+        umem_config.frame_headroom = 0;
+        int ret = xsk_umem__create(&_umem, _umem_area, umem_size, &_fill, &_comp, &umem_config);
+        if (ret != 0) throw uhd::os_error(str(boost::format(
+            "xdp: could not create the UMEM: %s") % strerror(-ret)));
+
+        xsk_socket_config xsk_config;
+        std::memset(&xsk_config, 0, sizeof(xsk_config));
+        xsk_config.rx_size = umem_config.fill_size;
+        xsk_config.tx_size = umem_config.comp_size;
+        xsk_config.bind_flags = XDP_USE_NEED_WAKEUP | (copy_mode? XDP_COPY : XDP_ZEROCOPY);
+        ret = xsk_socket__create(&_xsk, _iface.c_str(), uint32_t(_queue), _umem, &_rx, &_tx, &xsk_config);
+        if (ret != 0 and not copy_mode){
+            UHD_MSG(warning) << boost::format(
+                "The driver of %s does not support AF_XDP zero copy, using the copy mode."
+            ) % _iface << std::endl;
+            xsk_config.bind_flags = XDP_USE_NEED_WAKEUP | XDP_COPY;
+            ret = xsk_socket__create(&_xsk, _iface.c_str(), uint32_t(_queue), _umem, &_rx, &_tx, &xsk_config);
+        }
+        if (ret != 0) throw uhd::os_error(str(boost::format(
+            "xdp: could not bind to %s queue %d: %s") % _iface % _queue % strerror(-ret)));
+        _fd = xsk_socket__fd(_xsk);
+
+        //receive frames start out in the fill ring
+        std::vector<size_t> frames;
+        for (size_t i = 0; i < _num_recv_frames; i++){
+            _mrb_pool.push_back(boost::make_shared<xdp_zero_copy_mrb>());
+            _mrb_pool[i]->claim();
+            frames.push_back(i);
+        }
+        this->fill_frames(&frames.front(), frames.size());
+
+        //send frames start out free
+        for (size_t i = _num_recv_frames; i < num_frames; i++){
+            _msb_pool.push_back(boost::make_shared<xdp_zero_copy_msb>(
+                this, i, static_cast<uint8_t *>(_umem_area) + i*XDP_FRAME_SIZE + XDP_HDR_SIZE,
+                _send_frame_size
+            ));
+            _free_send_frames.push_back(i);
+        }
+    }
+
+    void cleanup(void){
+        if (_xsk != NULL) xsk_socket__delete(_xsk);
+        if (_umem != NULL) xsk_umem__delete(_umem);
+        std::free(_umem_area);
+        _xsk = NULL;
+        _umem = NULL;
+        _umem_area = NULL;
+        free_queue(_iface, _queue);
+    }
+
+    //! \return the UDP payload length, or 0 when the packet is not for this flow
+    UHD_INLINE size_t parse_packet(const uint8_t *pkt, const size_t len) const{
+        if (len < XDP_HDR_SIZE) return 0;
+        const ethhdr *eth = reinterpret_cast<const ethhdr *>(pkt);
+        if (eth->h_proto != htons(ETH_P_IP)) return 0;
+        const iphdr *ip = reinterpret_cast<const iphdr *>(pkt + sizeof(ethhdr));
+        if (ip->ihl != sizeof(iphdr)/4 or ip->protocol != IPPROTO_UDP or ip->saddr != _remote_ip) return 0;
+        const udphdr *udp = reinterpret_cast<const udphdr *>(pkt + sizeof(ethhdr) + sizeof(iphdr));
+        if (udp->dest != _local_port or udp->source != _remote_port) return 0;
+        const size_t udp_len = ntohs(udp->len);
+        if (udp_len <= sizeof(udphdr) or udp_len - sizeof(udphdr) > len - XDP_HDR_SIZE) return 0;
+        return udp_len - sizeof(udphdr);
+    }
+
+    //! Return frames that were released by the caller to the fill ring, in order
+    UHD_INLINE void refill(void){
+        size_t frames[64];
+        size_t n = 0;
+        while (n < 64 and not _recv_frames_out.empty() and _mrb_pool[_recv_frames_out.front()]->claim()){
+            frames[n++] = _recv_frames_out.front();
+            _recv_frames_out.pop_front();
+        }
+        if (n > 0) this->fill_frames(frames, n);
+    }
+
+    UHD_INLINE void fill_frames(const size_t *frames, const size_t n){
+        //the fill ring holds every receive frame, so slots are always available
+        uint32_t idx;
+        UHD_ASSERT_THROW(xsk_ring_prod__reserve(&_fill, uint32_t(n), &idx) == n);
+        for (size_t i = 0; i < n; i++){
+            *xsk_ring_prod__fill_addr(&_fill, uint32_t(idx + i)) = uint64_t(frames[i]*XDP_FRAME_SIZE);
+        }
+        xsk_ring_prod__submit(&_fill, uint32_t(n));
+    }
+
+    UHD_INLINE void reap_completions(void){
+        uint32_t idx;
+        const uint32_t n = xsk_ring_cons__peek(&_comp, uint32_t(_num_send_frames), &idx);
+        for (uint32_t i = 0; i < n; i++){
+            _free_send_frames.push_back(size_t(*xsk_ring_cons__comp_addr(&_comp, idx + i) / XDP_FRAME_SIZE));
+        }
+        if (n > 0) xsk_ring_cons__release(&_comp, n);
+    }
+
+    UHD_INLINE void kick_tx(void){
+        if (not xsk_ring_prod__needs_wakeup(&_tx)) return;
+        //EAGAIN, EBUSY and ENOBUFS mean the kernel is still busy, try again later
+        const ssize_t ret = ::sendto(_fd, NULL, 0, MSG_DONTWAIT, NULL, 0);
+        if (ret < 0 and errno != EAGAIN and errno != EBUSY and errno != ENOBUFS and errno != ENETDOWN){
+            throw uhd::io_error(str(boost::format("xdp: send error on socket: %s") % strerror(errno)));
+        }
+    }
+
+    const size_t _recv_frame_size, _num_recv_frames;
+    const size_t _send_frame_size, _num_send_frames;
+    const std::string _iface;
+    const size_t _queue;
+
+    //addresses -> in network byte order
+    uint32_t _remote_ip;
+    uint16_t _local_port, _remote_port;
+    uint8_t _hdr_template[XDP_HDR_SIZE];
+
+    //AF_XDP guts -> umem, rings and socket
+    void *_umem_area;
+    xsk_umem *_umem;
+    xsk_socket *_xsk;
+    xsk_ring_prod _fill, _tx;
+    xsk_ring_cons _comp, _rx;
+    int _fd;
+
+    //receive side -> frames handed out but not yet back in the fill ring
+    std::vector<boost::shared_ptr<xdp_zero_copy_mrb> > _mrb_pool;
+    boost::circular_buffer<size_t> _recv_frames_out;
+
+    //send side -> frames not queued on the tx ring
+    std::vector<boost::shared_ptr<xdp_zero_copy_msb> > _msb_pool;
+    std::vector<size_t> _free_send_frames;
+
+    //kernel socket holding the local port
+    asio::io_service _io_service;
+    socket_sptr _port_socket;
+};
+
+void xdp_zero_copy_msb::release(void){
+    _xport->commit_frame(_frame, size());
+}
+
+/***********************************************************************
+ * XDP zero copy make function
+ **********************************************************************/
+xdp_zero_copy::sptr xdp_zero_copy::make(
+    const std::string &addr,
+    const std::string &port,
+    const zero_copy_xport_params &default_buff_args,
+    const device_addr_t &hints
+){
+    if (not hints.has_key("xdp_iface")){
+        throw uhd::value_error("xdp_zero_copy::make: the xdp_iface hint is required");
+    }
+
+    zero_copy_xport_params xport_params = default_buff_args;
+    xport_params.recv_frame_size = size_t(hints.cast<double>("recv_frame_size", default_buff_args.recv_frame_size));
+    xport_params.num_recv_frames = size_t(hints.cast<double>("num_recv_frames", default_buff_args.num_recv_frames));
+    xport_params.send_frame_size = size_t(hints.cast<double>("send_frame_size", default_buff_args.send_frame_size));
+    xport_params.num_send_frames = size_t(hints.cast<double>("num_send_frames", default_buff_args.num_send_frames));
+
+    //a packet must fit into a single UMEM frame
+    if (xport_params.recv_frame_size > XDP_MAX_PAYLOAD_SIZE or xport_params.send_frame_size > XDP_MAX_PAYLOAD_SIZE){
+        UHD_LOG << boost::format("xdp: limiting the frame sizes to %d bytes") % XDP_MAX_PAYLOAD_SIZE << std::endl;
+        xport_params.recv_frame_size = std::min(xport_params.recv_frame_size, XDP_MAX_PAYLOAD_SIZE);
+        xport_params.send_frame_size = std::min(xport_params.send_frame_size, XDP_MAX_PAYLOAD_SIZE);
+    }
+
+    return sptr(new xdp_zero_copy_impl(addr, port, xport_params, hints));
+}
@@ -16,9 +16,30 @@
 //
 
 #include "xport_benchmarker.hpp"
+#include <boost/chrono.hpp>
 
 namespace uhd { namespace transport {
 
+static double thread_cpu_secs(void)
+{
+    return boost::chrono::duration<double>(
+        boost::chrono::thread_clock::now().time_since_epoch()).count();
+}
+
+xport_benchmark_results_t::xport_benchmark_results_t(void):
+    tx_packets(0), rx_packets(0), tx_bytes(0), rx_bytes(0),
+    tx_timeouts(0), rx_timeouts(0), data_errors(0), lost_packets(0),
+    duration_s(0.0), tx_cpu_s(0.0), rx_cpu_s(0.0)
+{
+    /* NOP */
+}
+
+xport_benchmarker::xport_benchmarker(void):
+    _recv_wait("ns")
+{
+    _reset_counters();
+}
+
 const device_addr_t& xport_benchmarker::benchmark_throughput_chdr
 (
     zero_copy_if::sptr tx_transport,
@@ -26,9 +47,35 @@ const device_addr_t& xport_benchmarker::benchmark_throughput_chdr
     uint32_t sid,
     bool big_endian,
     uint32_t duration_ms)
+{
+    const xport_benchmark_results_t results = benchmark_chdr(tx_transport, rx_transport, sid, big_endian, duration_ms);
+
+    double tx_rate = (((double)results.tx_bytes)/results.duration_s);
+    double rx_rate = (((double)results.rx_bytes)/results.duration_s);
+
+    _results["TX-Bytes"] = (boost::format("%.2fMB") % (results.tx_bytes/(1024*1024))).str();
+    _results["RX-Bytes"] = (boost::format("%.2fMB") % (results.rx_bytes/(1024*1024))).str();
+    _results["TX-Throughput"] = (boost::format("%.2fMB/s") % (tx_rate/(1024*1024))).str();
+    _results["RX-Throughput"] = (boost::format("%.2fMB/s") % (rx_rate/(1024*1024))).str();
+    _results["TX-Timeouts"] = boost::lexical_cast<std::string>(results.tx_timeouts);
+    _results["RX-Timeouts"] = boost::lexical_cast<std::string>(results.rx_timeouts);
+    _results["Data-Errors"] = boost::lexical_cast<std::string>(results.data_errors);
+    _results["Lost-Packets"] = boost::lexical_cast<std::string>(results.lost_packets);
+
+    return _results;
+}
+
+xport_benchmark_results_t xport_benchmarker::benchmark_chdr
+(
+    zero_copy_if::sptr tx_transport,
+    zero_copy_if::sptr rx_transport,
+    uint32_t sid,
+    bool big_endian,
+    uint32_t duration_ms,
+    size_t frame_size)
 {
     vrt::if_packet_info_t pkt_info;
-    _initialize_chdr(tx_transport, rx_transport, sid, pkt_info);
+    _initialize_chdr(tx_transport, rx_transport, sid, frame_size, pkt_info);
     _reset_counters();
     boost::posix_time::ptime start_time(boost::posix_time::microsec_clock::local_time());
 
@@ -43,50 +90,59 @@ const device_addr_t& xport_benchmarker::benchmark_throughput_chdr
     _rx_thread->join();
 
     boost::posix_time::ptime stop_time(boost::posix_time::microsec_clock::local_time());
-    double duration_s = ((double)(stop_time-start_time).total_microseconds())/1e6;
-
-    uint64_t tx_bytes = pkt_info.num_payload_words32*sizeof(uint32_t)*_num_tx_packets;
-    uint64_t rx_bytes = pkt_info.num_payload_words32*sizeof(uint32_t)*_num_rx_packets;
-    double tx_rate = (((double)tx_bytes)/duration_s);
-    double rx_rate = (((double)rx_bytes)/duration_s);
 
-    _results["TX-Bytes"] = (boost::format("%.2fMB") % (tx_bytes/(1024*1024))).str();
-    _results["RX-Bytes"] = (boost::format("%.2fMB") % (rx_bytes/(1024*1024))).str();
-    _results["TX-Throughput"] = (boost::format("%.2fMB/s") % (tx_rate/(1024*1024))).str();
-    _results["RX-Throughput"] = (boost::format("%.2fMB/s") % (rx_rate/(1024*1024))).str();
-    _results["TX-Timeouts"] = boost::lexical_cast<std::string>(_num_tx_timeouts);
-    _results["RX-Timeouts"] = boost::lexical_cast<std::string>(_num_rx_timeouts);
-    _results["Data-Errors"] = boost::lexical_cast<std::string>(_num_data_errors);
-
-    return _results;
+    xport_benchmark_results_t results;
+    results.tx_packets = _num_tx_packets;
+    results.rx_packets = _num_rx_packets;
+    results.tx_bytes = pkt_info.num_payload_words32*sizeof(uint32_t)*_num_tx_packets;
+    results.rx_bytes = pkt_info.num_payload_words32*sizeof(uint32_t)*_num_rx_packets;
+    results.tx_timeouts = _num_tx_timeouts;
+    results.rx_timeouts = _num_rx_timeouts;
+    results.data_errors = _num_data_errors;
+    results.lost_packets = _num_lost_packets;
+    results.duration_s = ((double)(stop_time-start_time).total_microseconds())/1e6;
+    results.tx_cpu_s = _tx_cpu_s;
+    results.rx_cpu_s = _rx_cpu_s;
+    results.recv_wait = _recv_wait.get();
+    return results;
 }
 
-void xport_benchmarker::_stream_tx(zero_copy_if* transport, vrt::if_packet_info_t* pkt_info, bool big_endian)
+void xport_benchmarker::_stream_tx(zero_copy_if* transport, vrt::if_packet_info_t* exp_pkt_info, bool big_endian)
 {
+    const double cpu_start = thread_cpu_secs();
+    vrt::if_packet_info_t pkt_info = *exp_pkt_info;
     while (not boost::this_thread::interruption_requested()) {
         managed_send_buffer::sptr buff = transport->get_send_buff(_tx_timeout);
         if (buff) {
             uint32_t *packet_buff = buff->cast<uint32_t *>();
             //Populate packet
             if (big_endian) {
-                vrt::if_hdr_pack_be(packet_buff, *pkt_info);
+                vrt::if_hdr_pack_be(packet_buff, pkt_info);
             } else {
-                vrt::if_hdr_pack_le(packet_buff, *pkt_info);
+                vrt::if_hdr_pack_le(packet_buff, pkt_info);
             }
             //send the buffer over the interface
-            buff->commit(sizeof(uint32_t)*(pkt_info->num_packet_words32));
+            buff->commit(sizeof(uint32_t)*(pkt_info.num_packet_words32));
+            pkt_info.packet_count = (pkt_info.packet_count + 1) & 0xfff;
             _num_tx_packets++;
         } else {
             _num_tx_timeouts++;
         }
     }
+    _tx_cpu_s = thread_cpu_secs() - cpu_start;
 }
 
 void xport_benchmarker::_stream_rx(zero_copy_if* transport, const vrt::if_packet_info_t* exp_pkt_info, bool big_endian)
 {
+    const double cpu_start = thread_cpu_secs();
+    bool first_packet = true;
+    size_t next_packet_count = 0;
     while (not boost::this_thread::interruption_requested()) {
+        const int64_t wait_start = stats_time_now_ns();
         managed_recv_buffer::sptr buff = transport->get_recv_buff(_rx_timeout);
         if (buff) {
+            _recv_wait.record(uint64_t(stats_time_now_ns() - wait_start));
+
             //Extract packet info
             vrt::if_packet_info_t pkt_info;
             pkt_info.link_type = exp_pkt_info->link_type;
@@ -107,6 +163,13 @@ void xport_benchmarker::_stream_rx(zero_copy_if* transport, const vrt::if_packet
                     exp_pkt_info->num_payload_bytes != pkt_info.num_payload_bytes) {
                     _num_data_errors++;
                 }
+
+                //the 12-bit sequence number skips the packets lost on the way
+                if (not first_packet) {
+                    _num_lost_packets += (pkt_info.packet_count - next_packet_count) & 0xfff;
+                }
+                first_packet = false;
+                next_packet_count = (pkt_info.packet_count + 1) & 0xfff;
             } catch(const std::exception &ex) {
                 _num_data_errors++;
             }
@@ -114,6 +177,7 @@ void xport_benchmarker::_stream_rx(zero_copy_if* transport, const vrt::if_packet
             _num_rx_timeouts++;
         }
     }
+    _rx_cpu_s = thread_cpu_secs() - cpu_start;
 }
 
 void xport_benchmarker::_reset_counters(void)
@@ -123,18 +187,26 @@ void xport_benchmarker::_reset_counters(void)
     _num_tx_timeouts = 0;
     _num_rx_timeouts = 0;
     _num_data_errors = 0;
+    _num_lost_packets = 0;
+    _tx_cpu_s = 0.0;
+    _rx_cpu_s = 0.0;
+    _recv_wait.reset();
 }
 
 void xport_benchmarker::_initialize_chdr(
     zero_copy_if::sptr tx_transport,
     zero_copy_if::sptr rx_transport,
     uint32_t sid,
+    size_t frame_size,
     vrt::if_packet_info_t& pkt_info)
 {
     _tx_timeout = 0.5;
     _rx_timeout = 0.5;
 
-    size_t frame_size = std::min(tx_transport->get_send_frame_size(), rx_transport->get_recv_frame_size());
+    const size_t max_frame_size = std::min(tx_transport->get_send_frame_size(), rx_transport->get_recv_frame_size());
+    if (frame_size == 0 or frame_size > max_frame_size) {
+        frame_size = max_frame_size;
+    }
 
     pkt_info.link_type = vrt::if_packet_info_t::LINK_TYPE_CHDR;
     pkt_info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
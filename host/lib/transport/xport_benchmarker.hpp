@@ -18,8 +18,10 @@
 #ifndef INCLUDED_LIBUHD_XPORT_BENCHMARKER_HPP
 #define INCLUDED_LIBUHD_XPORT_BENCHMARKER_HPP
 
+#include "xport_stats.hpp"
 #include <uhd/transport/zero_copy.hpp>
 #include <uhd/types/device_addr.hpp>
+#include <uhd/types/histogram.hpp>
 #include <uhd/utils/msg.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/thread.hpp>
@@ -27,9 +29,29 @@
 
 namespace uhd { namespace transport {
 
+//The results of one xport_benchmarker::benchmark_chdr() run
+struct xport_benchmark_results_t {
+    xport_benchmark_results_t(void);
+
+    uint64_t    tx_packets;
+    uint64_t    rx_packets;
+    uint64_t    tx_bytes;
+    uint64_t    rx_bytes;
+    uint64_t    tx_timeouts;
+    uint64_t    rx_timeouts;
+    uint64_t    data_errors;
+    uint64_t    lost_packets;   //gaps in the CHDR sequence numbers
+    double      duration_s;     //wall clock time of the run
+    double      tx_cpu_s;       //CPU time of the TX thread
+    double      rx_cpu_s;       //CPU time of the RX thread
+    histogram_t recv_wait;      //ns in get_recv_buff() for each received frame
+};
+
 //Test class to benchmark a low-level transport object with a VITA/C-VITA data stream
 class xport_benchmarker : boost::noncopyable {
 public:
+    xport_benchmarker(void);
+
     const device_addr_t& benchmark_throughput_chdr(
         zero_copy_if::sptr tx_transport,
         zero_copy_if::sptr rx_transport,
@@ -37,6 +59,16 @@ public:
         bool big_endian,
         uint32_t duration_ms);
 
+    //Stream CHDR from tx_transport to rx_transport, with frames of frame_size
+    //bytes, or of the largest frame both transports support when it is 0
+    xport_benchmark_results_t benchmark_chdr(
+        zero_copy_if::sptr tx_transport,
+        zero_copy_if::sptr rx_transport,
+        uint32_t sid,
+        bool big_endian,
+        uint32_t duration_ms,
+        size_t frame_size = 0);
+
 private:
     void _stream_tx(
         zero_copy_if* transport,
@@ -52,6 +84,7 @@ private:
         zero_copy_if::sptr tx_transport,
         zero_copy_if::sptr rx_transport,
         uint32_t sid,
+        size_t frame_size,
         vrt::if_packet_info_t& pkt_info);
 
     void _reset_counters(void);
@@ -64,6 +97,10 @@ private:
     uint64_t     _num_tx_timeouts;
     uint64_t     _num_rx_timeouts;
     uint64_t     _num_data_errors;
+    uint64_t     _num_lost_packets;
+    double       _tx_cpu_s;
+    double       _rx_cpu_s;
+    stats_histogram _recv_wait;
 
     double              _tx_timeout;
     double              _rx_timeout;
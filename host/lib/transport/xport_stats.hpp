@@ -0,0 +1,242 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_XPORT_STATS_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_XPORT_STATS_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/dict.hpp>
+#include <uhd/types/histogram.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/transport/zero_copy.hpp>
+#include <boost/atomic.hpp>
+#include <boost/utility.hpp>
+#include <stdint.h>
+#include <string>
+
+namespace uhd{ namespace transport{
+
+/*!
+ * A statistics counter for the fast path.
+ * Updates are relaxed atomics, readers may see a slightly stale value.
+ */
+class stats_counter : boost::noncopyable{
+public:
+    stats_counter(void): _value(0){}
+
+    UHD_INLINE void add(const uint64_t num = 1){
+        _value.fetch_add(num, boost::memory_order_relaxed);
+    }
+
+    //! Raise the counter to value if it is larger, for high-water marks
+    UHD_INLINE void update_max(const uint64_t value){
+        uint64_t curr = _value.load(boost::memory_order_relaxed);
+        while (value > curr and not _value.compare_exchange_weak(
+            curr, value, boost::memory_order_relaxed
+        )){}
+    }
+
+    UHD_INLINE uint64_t get(void) const{
+        return _value.load(boost::memory_order_relaxed);
+    }
+
+private:
+    boost::atomic<uint64_t> _value;
+};
+
+/*!
+ * The counters behind zero_copy_if::get_stats().
+ */
+struct zero_copy_stats_counters : boost::noncopyable{
+    stats_counter recv_packets, recv_bytes, recv_timeouts, recv_queue_hwm;
+    stats_counter send_packets, send_bytes, send_timeouts, send_fc_stalls;
+
+    //! Count a received buffer, or a timeout if it is null
+    UHD_INLINE void count_recv(const managed_recv_buffer::sptr &buff){
+        if (buff){
+            recv_packets.add();
+            recv_bytes.add(buff->size());
+        }
+        else recv_timeouts.add();
+    }
+
+    //! Count a send buffer being committed with num_bytes
+    UHD_INLINE void count_send(const size_t num_bytes){
+        send_packets.add();
+        send_bytes.add(num_bytes);
+    }
+
+    zero_copy_stats_t get(void) const{
+        zero_copy_stats_t stats;
+        stats.recv_packets = recv_packets.get();
+        stats.recv_bytes = recv_bytes.get();
+        stats.recv_timeouts = recv_timeouts.get();
+        stats.recv_queue_hwm = recv_queue_hwm.get();
+        stats.send_packets = send_packets.get();
+        stats.send_bytes = send_bytes.get();
+        stats.send_timeouts = send_timeouts.get();
+        stats.send_fc_stalls = send_fc_stalls.get();
+        return stats;
+    }
+};
+
+/*!
+ * Counters of an RX or TX streamer, see the packet handlers.
+ * The TX streamer leaves the receive specific counters at 0.
+ */
+struct stream_stats_t{
+    stream_stats_t(void):
+        packets(0), bytes(0), sequence_errors(0), overflows(0),
+        late_commands(0), timeouts(0), queue_hwm(0), fc_acks(0)
+    {}
+
+    uint64_t packets;         //!< data packets over all channels
+    uint64_t bytes;           //!< payload bytes of the data packets
+    uint64_t sequence_errors; //!< packets missing from the sequence (D)
+    uint64_t overflows;       //!< overflow messages from the device (O)
+    uint64_t late_commands;   //!< late stream command messages from the device
+    uint64_t timeouts;        //!< calls which timed out waiting for the transport
+    uint64_t queue_hwm;       //!< the most packets taken from a transport at once
+    uint64_t fc_acks;         //!< flow control updates, the handler may coalesce acks
+
+    //! The counters by name, e.g. for publishing in the property tree
+    uhd::dict<std::string, uint64_t> to_dict(void) const{
+        uhd::dict<std::string, uint64_t> stats;
+        stats["packets"] = packets;
+        stats["bytes"] = bytes;
+        stats["sequence_errors"] = sequence_errors;
+        stats["overflows"] = overflows;
+        stats["late_commands"] = late_commands;
+        stats["timeouts"] = timeouts;
+        stats["queue_hwm"] = queue_hwm;
+        stats["fc_acks"] = fc_acks;
+        return stats;
+    }
+};
+
+//! The counters behind stream_stats_t
+struct stream_stats_counters : boost::noncopyable{
+    stats_counter packets, bytes, sequence_errors, overflows;
+    stats_counter late_commands, timeouts, queue_hwm, fc_acks;
+
+    stream_stats_t get(void) const{
+        stream_stats_t stats;
+        stats.packets = packets.get();
+        stats.bytes = bytes.get();
+        stats.sequence_errors = sequence_errors.get();
+        stats.overflows = overflows.get();
+        stats.late_commands = late_commands.get();
+        stats.timeouts = timeouts.get();
+        stats.queue_hwm = queue_hwm.get();
+        stats.fc_acks = fc_acks.get();
+        return stats;
+    }
+};
+
+//! The monotonic host time in ns, for the histograms of the streamers
+static UHD_INLINE int64_t stats_time_now_ns(void){
+    return uhd::time_spec_t::get_system_time().to_ticks(1e9);
+}
+
+/*!
+ * A histogram for the fast path, read as a uhd::histogram_t.
+ * Like the counters, values are recorded with relaxed atomics,
+ * so a snapshot taken while recording can be slightly inconsistent.
+ */
+class stats_histogram : boost::noncopyable{
+public:
+    stats_histogram(const std::string &unit): _unit(unit){
+        reset();
+    }
+
+    UHD_INLINE void record(const uint64_t value){
+        _buckets[uhd::histogram_t::bucket_index(value)].fetch_add(1, boost::memory_order_relaxed);
+        _count.fetch_add(1, boost::memory_order_relaxed);
+        _sum.fetch_add(value, boost::memory_order_relaxed);
+        uint64_t curr = _min.load(boost::memory_order_relaxed);
+        while (value < curr and not _min.compare_exchange_weak(curr, value, boost::memory_order_relaxed)){}
+        curr = _max.load(boost::memory_order_relaxed);
+        while (value > curr and not _max.compare_exchange_weak(curr, value, boost::memory_order_relaxed)){}
+    }
+
+    void reset(void){
+        for (size_t i = 0; i < uhd::histogram_t::NUM_BUCKETS; i++){
+            _buckets[i].store(0, boost::memory_order_relaxed);
+        }
+        _count.store(0, boost::memory_order_relaxed);
+        _sum.store(0, boost::memory_order_relaxed);
+        _min.store(~uint64_t(0), boost::memory_order_relaxed);
+        _max.store(0, boost::memory_order_relaxed);
+    }
+
+    uhd::histogram_t get(void) const{
+        uhd::histogram_t hist;
+        hist.unit = _unit;
+        for (size_t i = 0; i < uhd::histogram_t::NUM_BUCKETS; i++){
+            hist.buckets[i] = _buckets[i].load(boost::memory_order_relaxed);
+        }
+        hist.count = _count.load(boost::memory_order_relaxed);
+        hist.sum = _sum.load(boost::memory_order_relaxed);
+        hist.max = _max.load(boost::memory_order_relaxed);
+        hist.min = (hist.count == 0)? 0 : _min.load(boost::memory_order_relaxed);
+        return hist;
+    }
+
+private:
+    const std::string _unit;
+    boost::atomic<uint64_t> _buckets[uhd::histogram_t::NUM_BUCKETS];
+    boost::atomic<uint64_t> _count, _sum, _min, _max;
+};
+
+/*!
+ * The histograms of an RX or TX streamer, see the packet handlers.
+ * The TX streamer does not record packet ages.
+ */
+struct stream_histograms : boost::noncopyable{
+    stream_histograms(void):
+        sample_rate("samples/s"), packets_per_call("packets"),
+        xport_wait("ns"), convert("ns"), packet_age("ns")
+    {}
+
+    stats_histogram sample_rate;      //!< samples per second, per call since the last one returned
+    stats_histogram packets_per_call; //!< packets per channel handled by a call
+    stats_histogram xport_wait;       //!< time spent waiting on the transport per packet
+    stats_histogram convert;          //!< time spent converting per packet, all channels
+    stats_histogram packet_age;       //!< host time of arrival minus device time, see below
+
+    void reset(void){
+        sample_rate.reset();
+        packets_per_call.reset();
+        xport_wait.reset();
+        convert.reset();
+        packet_age.reset();
+    }
+
+    uhd::histograms_t get(const bool with_packet_age) const{
+        uhd::histograms_t hists;
+        hists["sample_rate"] = sample_rate.get();
+        hists["packets_per_call"] = packets_per_call.get();
+        hists["xport_wait"] = xport_wait.get();
+        hists["convert"] = convert.get();
+        if (with_packet_age) hists["packet_age"] = packet_age.get();
+        return hists;
+    }
+};
+
+}} //namespace
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_XPORT_STATS_HPP */
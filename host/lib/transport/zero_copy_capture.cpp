@@ -0,0 +1,481 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "xport_stats.hpp"
+#include <uhd/transport/zero_copy_capture.hpp>
+#include <uhd/transport/buffer_pool.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/safe_call.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::transport;
+namespace ip = boost::interprocess;
+
+/***********************************************************************
+ * Capture file layout:
+ * A header followed by one record per frame, in host byte order.
+ * Each record is followed by the frame, padded to 8 bytes.
+ **********************************************************************/
+static const char CAPTURE_MAGIC[8] = {'U', 'H', 'D', 'C', 'A', 'P', 'T', 'R'};
+static const uint32_t CAPTURE_VERSION = 1;
+static const size_t DEFAULT_CAPTURE_SIZE = 64*1024*1024;
+static const size_t DEFAULT_NUM_REPLAY_FRAMES = 32;
+
+struct capture_header_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recv_frame_size;
+    uint32_t send_frame_size;
+    uint32_t reserved;
+    uint64_t num_frames;
+    //! the file offset after the last record
+    uint64_t end_offset;
+};
+
+struct capture_record_t
+{
+    //! receive time in ns since the first frame
+    int64_t time_ns;
+    uint32_t length;
+    uint32_t reserved;
+};
+
+static UHD_INLINE size_t get_record_size(const size_t length)
+{
+    return sizeof(capture_record_t) + ((length + 7) & ~size_t(7));
+}
+
+/***********************************************************************
+ * Capture transport:
+ * Copies each received frame into the mapped file before handing it out.
+ **********************************************************************/
+class zero_copy_capture_impl : public zero_copy_capture {
+public:
+    zero_copy_capture_impl(
+        zero_copy_if::sptr transport,
+        const std::string &path,
+        const size_t capture_size
+    ):
+        _transport(transport),
+        _path(path),
+        _full(false)
+    {
+        try {
+            std::ofstream(_path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+            boost::filesystem::resize_file(_path,
+                std::max(capture_size, sizeof(capture_header_t)));
+            _file.reset(new ip::file_mapping(_path.c_str(), ip::read_write));
+            _region.reset(new ip::mapped_region(*_file, ip::read_write));
+        } catch (const std::exception &e) {
+            throw uhd::os_error(str(boost::format(
+                "Cannot create the capture file %s: %s") % _path % e.what()));
+        }
+
+        _mem = static_cast<char *>(_region->get_address());
+        _capacity = _region->get_size();
+        _header = reinterpret_cast<capture_header_t *>(_mem);
+        std::memcpy(_header->magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+        _header->version = CAPTURE_VERSION;
+        _header->recv_frame_size = uint32_t(_transport->get_recv_frame_size());
+        _header->send_frame_size = uint32_t(_transport->get_send_frame_size());
+        _header->reserved = 0;
+        _header->num_frames = 0;
+        _header->end_offset = sizeof(capture_header_t);
+
+        UHD_LOG << boost::format("Capturing frames to %s (%u bytes max)") % _path % _capacity << std::endl;
+    }
+
+    ~zero_copy_capture_impl(void)
+    {
+        UHD_SAFE_CALL(
+            const uint64_t end_offset = _header->end_offset;
+            _region->flush();
+            _region.reset();
+            _file.reset();
+            boost::filesystem::resize_file(_path, end_offset);
+        )
+    }
+
+    /*******************************************************************
+     * Receive implementation:
+     * Record the buffers of the underlying transport
+     ******************************************************************/
+    managed_recv_buffer::sptr get_recv_buff(double timeout)
+    {
+        managed_recv_buffer::sptr buff = _transport->get_recv_buff(timeout);
+        if (buff) record(buff);
+        return buff;
+    }
+
+    size_t get_recv_buffs(managed_recv_buffer::sptr *buffs, const size_t num_buffs, const double timeout)
+    {
+        const size_t num_got = _transport->get_recv_buffs(buffs, num_buffs, timeout);
+        for (size_t i = 0; i < num_got; i++) record(buffs[i]);
+        return num_got;
+    }
+
+    size_t get_num_recv_frames(void) const
+    {
+        return _transport->get_num_recv_frames();
+    }
+
+    size_t get_recv_frame_size(void) const
+    {
+        return _transport->get_recv_frame_size();
+    }
+
+    /*******************************************************************
+     * Send implementation:
+     * Sends are not recorded
+     ******************************************************************/
+    managed_send_buffer::sptr get_send_buff(double timeout)
+    {
+        return _transport->get_send_buff(timeout);
+    }
+
+    size_t get_send_buffs(managed_send_buffer::sptr *buffs, const size_t num_buffs, const double timeout)
+    {
+        return _transport->get_send_buffs(buffs, num_buffs, timeout);
+    }
+
+    size_t get_num_send_frames(void) const
+    {
+        return _transport->get_num_send_frames();
+    }
+
+    size_t get_send_frame_size(void) const
+    {
+        return _transport->get_send_frame_size();
+    }
+
+    zero_copy_stats_t get_stats(void) const
+    {
+        return _transport->get_stats();
+    }
+
+    size_t get_num_captured_frames(void) const
+    {
+        return size_t(_header->num_frames);
+    }
+
+private:
+    void record(const managed_recv_buffer::sptr &buff)
+    {
+        const size_t length = buff->size();
+        const size_t offset = size_t(_header->end_offset);
+        if (offset + get_record_size(length) > _capacity) {
+            if (not _full) UHD_MSG(warning) << boost::format(
+                "The capture file %s is full after %u frames, increase capture_size"
+            ) % _path % _header->num_frames << std::endl;
+            _full = true;
+            return;
+        }
+
+        //prefer the time the transport received the frame
+        time_spec_t time;
+        if (not buff->get_recv_time(time)) time = time_spec_t::get_system_time();
+        if (_header->num_frames == 0) _start_time = time;
+
+        capture_record_t *rec = reinterpret_cast<capture_record_t *>(_mem + offset);
+        rec->time_ns = (time - _start_time).to_ticks(1e9);
+        rec->length = uint32_t(length);
+        rec->reserved = 0;
+        std::memcpy(rec + 1, buff->cast<const void *>(), length);
+
+        //the header is updated last, a partial capture stays readable
+        _header->end_offset = offset + get_record_size(length);
+        _header->num_frames++;
+    }
+
+    zero_copy_if::sptr _transport;
+    const std::string _path;
+    boost::scoped_ptr<ip::file_mapping> _file;
+    boost::scoped_ptr<ip::mapped_region> _region;
+    char *_mem;
+    size_t _capacity;
+    capture_header_t *_header;
+    time_spec_t _start_time;
+    bool _full;
+};
+
+zero_copy_capture::sptr zero_copy_capture::make(
+        zero_copy_if::sptr transport,
+        const std::string &path,
+        const device_addr_t &hints)
+{
+    return boost::make_shared<zero_copy_capture_impl>(
+        transport, path,
+        size_t(hints.cast<double>("capture_size", DEFAULT_CAPTURE_SIZE))
+    );
+}
+
+/***********************************************************************
+ * Replay managed buffers:
+ * Frames point into the mapped file, send frames are dropped
+ **********************************************************************/
+class zero_copy_replay_mrb : public managed_recv_buffer
+{
+public:
+    void release(void)
+    {
+        /* NOP */
+    }
+
+    UHD_INLINE sptr get(void *mem, const size_t length)
+    {
+        return make(this, mem, length);
+    }
+};
+
+class zero_copy_replay_msb : public managed_send_buffer
+{
+public:
+    zero_copy_replay_msb(void *mem, const size_t frame_size):
+        _mem(mem), _frame_size(frame_size)
+    {
+        /* NOP */
+    }
+
+    void release(void)
+    {
+        /* NOP */
+    }
+
+    UHD_INLINE sptr get(void)
+    {
+        return make(this, _mem, _frame_size);
+    }
+
+private:
+    void *_mem;
+    const size_t _frame_size;
+};
+
+/***********************************************************************
+ * Replay transport:
+ * Hands out the recorded frames, paced by their receive times
+ **********************************************************************/
+class zero_copy_replay_impl : public zero_copy_replay {
+public:
+    zero_copy_replay_impl(
+        const std::string &path,
+        const double rate,
+        const size_t num_loops,
+        const size_t num_recv_frames,
+        const size_t num_send_frames
+    ):
+        _rate(rate),
+        _num_loops(num_loops),
+        _loop_count(0),
+        _next_frame(0),
+        _pass_started(false),
+        _recv_buffs(std::max<size_t>(1, num_recv_frames)),
+        _recv_buff_index(0),
+        _send_buff_index(0)
+    {
+        try {
+            _file.reset(new ip::file_mapping(path.c_str(), ip::read_only));
+            //copy on write, so the packet handlers may modify frames in place
+            _region.reset(new ip::mapped_region(*_file, ip::copy_on_write));
+        } catch (const std::exception &e) {
+            throw uhd::os_error(str(boost::format(
+                "Cannot open the capture file %s: %s") % path % e.what()));
+        }
+
+        char *mem = static_cast<char *>(_region->get_address());
+        const size_t file_size = _region->get_size();
+        const capture_header_t *header = reinterpret_cast<const capture_header_t *>(mem);
+        if (file_size < sizeof(capture_header_t)
+            or std::memcmp(header->magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0
+            or header->version != CAPTURE_VERSION
+            or header->end_offset > file_size
+        ) {
+            throw uhd::value_error(str(boost::format(
+                "%s is not a capture file") % path));
+        }
+        _recv_frame_size = header->recv_frame_size;
+        _send_frame_size = header->send_frame_size;
+
+        //index the records, stop at a record cut short
+        size_t offset = sizeof(capture_header_t);
+        while (_frames.size() < header->num_frames
+            and offset + sizeof(capture_record_t) <= header->end_offset
+        ) {
+            const capture_record_t *rec = reinterpret_cast<const capture_record_t *>(mem + offset);
+            if (offset + get_record_size(rec->length) > header->end_offset) break;
+            frame_t frame;
+            frame.mem = mem + offset + sizeof(capture_record_t);
+            frame.length = rec->length;
+            frame.time = time_spec_t::from_ticks(rec->time_ns, 1e9);
+            _frames.push_back(frame);
+            offset += get_record_size(rec->length);
+        }
+
+        for (size_t i = 0; i < _recv_buffs.size(); i++) {
+            _recv_buffs[i] = boost::make_shared<zero_copy_replay_mrb>();
+        }
+        _send_pool = buffer_pool::make(std::max<size_t>(1, num_send_frames), _send_frame_size);
+        for (size_t i = 0; i < _send_pool->size(); i++) {
+            _send_buffs.push_back(boost::make_shared<zero_copy_replay_msb>(
+                _send_pool->at(i), _send_frame_size));
+        }
+
+        UHD_LOG << boost::format("Replaying %u frames from %s") % _frames.size() % path << std::endl;
+    }
+
+    /*******************************************************************
+     * Receive implementation:
+     * Wait for the recorded time of the next frame unless the rate is 0
+     ******************************************************************/
+    managed_recv_buffer::sptr get_recv_buff(double timeout)
+    {
+        if (_next_frame == _frames.size()) {
+            if (_frames.empty() or (_num_loops != 0 and _loop_count + 1 >= _num_loops)) {
+                sleep(timeout);
+                _stats.recv_timeouts.add();
+                return managed_recv_buffer::sptr();
+            }
+            _loop_count++;
+            _next_frame = 0;
+            _pass_started = false;
+        }
+
+        const frame_t &frame = _frames[_next_frame];
+        if (_rate > 0.0) {
+            const time_spec_t now = time_spec_t::get_system_time();
+            if (not _pass_started) {
+                _pass_start = now;
+                _pass_started = true;
+            }
+            const double wait = (_pass_start - now).get_real_secs()
+                + (frame.time - _frames.front().time).get_real_secs() / _rate;
+            if (wait > timeout) {
+                sleep(timeout);
+                _stats.recv_timeouts.add();
+                return managed_recv_buffer::sptr();
+            }
+            sleep(wait);
+        }
+        _next_frame++;
+
+        boost::shared_ptr<zero_copy_replay_mrb> mrb = _recv_buffs[_recv_buff_index++];
+        _recv_buff_index %= _recv_buffs.size();
+        _stats.recv_packets.add();
+        _stats.recv_bytes.add(frame.length);
+        return mrb->get(frame.mem, frame.length);
+    }
+
+    size_t get_num_recv_frames(void) const
+    {
+        return _recv_buffs.size();
+    }
+
+    size_t get_recv_frame_size(void) const
+    {
+        return _recv_frame_size;
+    }
+
+    /*******************************************************************
+     * Send implementation:
+     * There is no device, sent frames are dropped
+     ******************************************************************/
+    managed_send_buffer::sptr get_send_buff(double)
+    {
+        boost::shared_ptr<zero_copy_replay_msb> msb = _send_buffs[_send_buff_index++];
+        _send_buff_index %= _send_buffs.size();
+        _stats.send_packets.add();
+        return msb->get();
+    }
+
+    size_t get_num_send_frames(void) const
+    {
+        return _send_buffs.size();
+    }
+
+    size_t get_send_frame_size(void) const
+    {
+        return _send_frame_size;
+    }
+
+    zero_copy_stats_t get_stats(void) const
+    {
+        return _stats.get();
+    }
+
+private:
+    static void sleep(const double secs)
+    {
+        if (secs <= 0.0) return;
+        boost::this_thread::sleep(boost::posix_time::microseconds(long(secs*1e6)));
+    }
+
+    struct frame_t
+    {
+        char *mem;
+        size_t length;
+        time_spec_t time;
+    };
+
+    boost::scoped_ptr<ip::file_mapping> _file;
+    boost::scoped_ptr<ip::mapped_region> _region;
+    std::vector<frame_t> _frames;
+    size_t _recv_frame_size, _send_frame_size;
+
+    // Pacing and looping
+    const double _rate;
+    const size_t _num_loops;
+    size_t _loop_count;
+    size_t _next_frame;
+    bool _pass_started;
+    time_spec_t _pass_start;
+
+    // Buffers
+    std::vector< boost::shared_ptr<zero_copy_replay_mrb> > _recv_buffs;
+    size_t _recv_buff_index;
+    buffer_pool::sptr _send_pool;
+    std::vector< boost::shared_ptr<zero_copy_replay_msb> > _send_buffs;
+    size_t _send_buff_index;
+
+    zero_copy_stats_counters _stats;
+};
+
+zero_copy_replay::sptr zero_copy_replay::make(
+        const std::string &path,
+        const device_addr_t &hints)
+{
+    return boost::make_shared<zero_copy_replay_impl>(
+        path,
+        hints.cast<double>("replay_rate", 1.0),
+        size_t(hints.cast<double>("replay_loops", 1)),
+        size_t(hints.cast<double>("num_recv_frames", DEFAULT_NUM_REPLAY_FRAMES)),
+        size_t(hints.cast<double>("num_send_frames", DEFAULT_NUM_REPLAY_FRAMES))
+    );
+}
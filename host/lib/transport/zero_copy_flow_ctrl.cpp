@@ -15,6 +15,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include "xport_stats.hpp"
 #include <uhd/transport/zero_copy_flow_ctrl.hpp>
 #include <uhd/transport/bounded_buffer.hpp>
 #include <uhd/transport/buffer_pool.hpp>
@@ -36,10 +37,12 @@ class zero_copy_flow_ctrl_msb : public managed_send_buffer
 {
 public:
     zero_copy_flow_ctrl_msb(
-        flow_ctrl_func flow_ctrl
+        flow_ctrl_func flow_ctrl,
+        stats_counter *fc_stalls
     ) :
         _mb(NULL),
-        _flow_ctrl(flow_ctrl)
+        _flow_ctrl(flow_ctrl),
+        _fc_stalls(fc_stalls)
     {
         /* NOP */
     }
@@ -54,7 +57,11 @@ public:
         if (_mb)
         {
             _mb->commit(size());
-            while (_flow_ctrl and not _flow_ctrl(_mb)) {}
+            if (_flow_ctrl and not _flow_ctrl(_mb))
+            {
+                _fc_stalls->add();
+                while (not _flow_ctrl(_mb)) {}
+            }
             _mb.reset();
         }
     }
@@ -68,6 +75,7 @@ public:
 private:
     sptr _mb;
     flow_ctrl_func _flow_ctrl;
+    stats_counter *_fc_stalls;
 };
 
 class zero_copy_flow_ctrl_mrb : public managed_recv_buffer
@@ -132,7 +140,7 @@ public:
 
         for (size_t i = 0; i < transport->get_num_send_frames(); i++)
         {
-            _send_buffers[i] = boost::make_shared<zero_copy_flow_ctrl_msb>(_send_flow_ctrl);
+            _send_buffers[i] = boost::make_shared<zero_copy_flow_ctrl_msb>(_send_flow_ctrl, &_fc_stalls);
         }
         for (size_t i = 0; i < transport->get_num_recv_frames(); i++)
         {
@@ -154,7 +162,7 @@ public:
         managed_recv_buffer::sptr buff = _transport->get_recv_buff(timeout);
         if (buff)
         {
-            boost::shared_ptr<zero_copy_flow_ctrl_mrb> mb = _recv_buffers[_recv_buff_index++];
+            const boost::shared_ptr<zero_copy_flow_ctrl_mrb> &mb = _recv_buffers[_recv_buff_index++];
             _recv_buff_index %= _recv_buffers.size();
             ptr = mb->get(buff);
         }
@@ -181,7 +189,7 @@ public:
         managed_send_buffer::sptr buff = _transport->get_send_buff(timeout);
         if (buff)
         {
-            boost::shared_ptr<zero_copy_flow_ctrl_msb> mb = _send_buffers[_send_buff_index++];
+            const boost::shared_ptr<zero_copy_flow_ctrl_msb> &mb = _send_buffers[_send_buff_index++];
             _send_buff_index %= _send_buffers.size();
             ptr = mb->get(buff);
         }
@@ -198,10 +206,20 @@ public:
         return _transport->get_send_frame_size();
     }
 
+    zero_copy_stats_t get_stats(void) const
+    {
+        zero_copy_stats_t stats = _transport->get_stats();
+        stats.send_fc_stalls += _fc_stalls.get();
+        return stats;
+    }
+
 private:
     // The underlying transport
     zero_copy_if::sptr _transport;
 
+    // Sends which had to wait for flow control credit
+    stats_counter _fc_stalls;
+
     // buffers
     std::vector< boost::shared_ptr<zero_copy_flow_ctrl_msb> > _send_buffers;
     std::vector< boost::shared_ptr<zero_copy_flow_ctrl_mrb> > _recv_buffers;
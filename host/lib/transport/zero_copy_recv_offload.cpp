@@ -15,22 +15,62 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include "xport_stats.hpp"
 #include <uhd/transport/zero_copy_recv_offload.hpp>
-#include <uhd/transport/bounded_buffer.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
 #include <uhd/transport/buffer_pool.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/safe_call.hpp>
+#include <uhd/utils/thread_priority.hpp>
 #include <boost/format.hpp>
+#include <boost/foreach.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/bind.hpp>
+#include <boost/atomic.hpp>
+#include <cstring>
+#include <vector>
 
 using namespace uhd;
 using namespace uhd::transport;
 
-typedef bounded_buffer<managed_recv_buffer::sptr> bounded_buffer_t;
+//the receive thread is the only producer, get_recv_buff() the only consumer
+typedef spsc_bounded_buffer<managed_recv_buffer::sptr> bounded_buffer_t;
+
+/***********************************************************************
+ * Elastic ring slot:
+ * The receive thread copies a frame of the transport into the slot and
+ * releases the transport's frame right away, so an application which
+ * stalls holds slots of the ring and not the frames of the transport.
+ **********************************************************************/
+class elastic_slot_mrb;
+typedef spsc_bounded_buffer<elastic_slot_mrb *> slot_buffer_t;
+
+class elastic_slot_mrb : public managed_recv_buffer{
+public:
+    elastic_slot_mrb(void *mem, slot_buffer_t &free_slots, boost::atomic<size_t> &num_filled):
+        _mem(mem), _free_slots(free_slots), _num_filled(num_filled) { /*NOP*/ }
+
+    void release(void){
+        _num_filled.fetch_sub(1, boost::memory_order_relaxed);
+        _free_slots.push_with_haste(this);
+    }
+
+    UHD_INLINE sptr get_new(const managed_recv_buffer::sptr &buff){
+        std::memcpy(_mem, buff->cast<const void *>(), buff->size());
+        _has_recv_time = buff->get_recv_time(_recv_time);
+        return make(this, _mem, buff->size());
+    }
+
+private:
+    void *_mem;
+    slot_buffer_t &_free_slots;
+    boost::atomic<size_t> &_num_filled;
+};
 
 /***********************************************************************
  * Zero copy offload transport:
@@ -42,12 +82,33 @@ public:
     typedef boost::shared_ptr<zero_copy_recv_offload_impl> sptr;
 
     zero_copy_recv_offload_impl(zero_copy_if::sptr transport,
-                          const double timeout) :
+                          const double timeout,
+                          const size_t batch_size,
+                          const std::vector<size_t> &cpus,
+                          const size_t num_elastic_slots,
+                          const device_addr_t &elastic_hints) :
         _transport(transport), _timeout(timeout),
-        _inbox(transport->get_num_recv_frames()),
+        _free_slots(num_elastic_slots),
+        _num_filled(0),
+        _inbox(std::max(transport->get_num_recv_frames(), num_elastic_slots)),
+        _batch(std::max<size_t>(1, std::min(batch_size, transport->get_num_recv_frames()))),
+        _cpus(cpus),
         _recv_done(false)
     {
-        UHD_LOG << "Created threaded transport" << std::endl;
+        UHD_LOG << "Created threaded transport, batch size = " << _batch.size() << std::endl;
+
+        //the elastic ring, every slot starts out free
+        if (num_elastic_slots != 0){
+            _elastic_pool = buffer_pool::make(
+                num_elastic_slots, transport->get_recv_frame_size(), 16, elastic_hints);
+            for (size_t i = 0; i < num_elastic_slots; i++){
+                _slots.push_back(boost::make_shared<elastic_slot_mrb>(
+                    _elastic_pool->at(i), boost::ref(_free_slots), boost::ref(_num_filled)
+                ));
+                _free_slots.push_with_haste(_slots.back().get());
+            }
+            UHD_LOG << boost::format("Created elastic receive ring of %u frames") % num_elastic_slots << std::endl;
+        }
 
         // Create the receive and send threads to offload
         // the system calls onto other threads
@@ -81,14 +142,41 @@ public:
     }
 
     // The receive thread function is responsible for
-    // pulling pointers to managed receiver buffers quickly
+    // pulling pointers to managed receiver buffers quickly.
+    // Each wakeup takes all frames that are ready, up to the batch size.
     void enqueue_recv()
     {
+        uhd::setup_thread("recv_offload");
+        try {
+            uhd::set_thread_affinity(_cpus);
+        } catch (const std::exception &e) {
+            UHD_MSG(warning) << boost::format(
+                "Unable to pin the receive offload thread to CPU %u.\n%s\n"
+            ) % _cpus.front() % e.what();
+        }
         while (not is_recv_done()) {
-            managed_recv_buffer::sptr buff = _transport->get_recv_buff(_timeout);
-            if (not buff) continue;
-            _inbox.push_with_timed_wait(buff, _timeout);
+            const size_t num_buffs = _transport->get_recv_buffs(&_batch.front(), _batch.size(), _timeout);
+            for (size_t i = 0; i < num_buffs; i++) {
+                if (_elastic_pool) this->push_elastic(_batch[i]);
+                else if (not _inbox.push_with_timed_wait(_batch[i], _timeout)) _stalls.add();
+                _batch[i].reset();
+            }
+        }
+    }
+
+    // Copy a frame into the elastic ring, waiting for a free slot
+    // when the ring is full: the transport then backs up behind it
+    void push_elastic(const managed_recv_buffer::sptr &buff)
+    {
+        elastic_slot_mrb *slot = NULL;
+        if (not _free_slots.pop_with_haste(slot)) {
+            _stalls.add();
+            while (not _free_slots.pop_with_timed_wait(slot, _timeout)) {
+                if (is_recv_done()) return;
+            }
         }
+        _elastic_hwm.update_max(_num_filled.fetch_add(1, boost::memory_order_relaxed) + 1);
+        _inbox.push_with_haste(slot->get_new(buff));
     }
 
     /*******************************************************************
@@ -102,6 +190,14 @@ public:
         return ptr;
     }
 
+    size_t get_recv_buffs(managed_recv_buffer::sptr *buffs, const size_t num_buffs, const double timeout)
+    {
+        if (num_buffs == 0 or not _inbox.pop_with_timed_wait(buffs[0], timeout)) return 0;
+        size_t num_got = 1;
+        while (num_got < num_buffs and _inbox.pop_with_haste(buffs[num_got])) num_got++;
+        return num_got;
+    }
+
     size_t get_num_recv_frames() const
     {
         return _transport->get_num_recv_frames();
@@ -131,15 +227,38 @@ public:
         return _transport->get_send_frame_size();
     }
 
+    zero_copy_stats_t get_stats(void) const
+    {
+        zero_copy_stats_t stats = _transport->get_stats();
+        stats.recv_stalls += _stalls.get();
+        stats.recv_elastic_hwm = std::max(stats.recv_elastic_hwm, _elastic_hwm.get());
+        return stats;
+    }
+
 private:
     // The linked transport
     zero_copy_if::sptr _transport;
 
     const double _timeout;
 
+    // Elastic ring, a slot goes back to the free list on release,
+    // declared before the inbox which may still hold slots
+    buffer_pool::sptr _elastic_pool;
+    std::vector<boost::shared_ptr<elastic_slot_mrb> > _slots;
+    slot_buffer_t _free_slots;
+    boost::atomic<size_t> _num_filled;
+
     // Shared buffers
     bounded_buffer_t _inbox;
 
+    // Receive thread state
+    std::vector<managed_recv_buffer::sptr> _batch;
+    const std::vector<size_t> _cpus;
+
+    // Stall accounting
+    stats_counter _stalls;
+    stats_counter _elastic_hwm;
+
     // Threading
     bool _recv_done;
     boost::thread _recv_thread;
@@ -148,10 +267,36 @@ private:
 
 zero_copy_recv_offload::sptr zero_copy_recv_offload::make(
         zero_copy_if::sptr transport,
-        const double timeout)
+        const double timeout,
+        const device_addr_t &hints)
 {
+    std::vector<size_t> cpus;
+    if (hints.has_key("recv_offload_cpus")) {
+        std::vector<std::string> toks;
+        const std::string cpu_list = boost::algorithm::trim_copy(hints["recv_offload_cpus"]);
+        boost::split(toks, cpu_list, boost::is_any_of(" "), boost::token_compress_on);
+        BOOST_FOREACH(const std::string &tok, toks) {
+            if (not tok.empty()) cpus.push_back(boost::lexical_cast<size_t>(tok));
+        }
+    }
+
+    //the elastic ring is backed by huge pages unless buff_hugepages says otherwise
+    size_t num_elastic_slots = 0;
+    device_addr_t elastic_hints;
+    const double elastic_bytes = hints.cast<double>("recv_elastic_bytes", 0);
+    if (elastic_bytes > 0) {
+        num_elastic_slots = std::max(transport->get_num_recv_frames(),
+            size_t(elastic_bytes/transport->get_recv_frame_size()));
+        BOOST_FOREACH(const std::string &key, hints.keys()) {
+            if (key.find("buff_") == 0) elastic_hints[key] = hints[key];
+        }
+        if (not elastic_hints.has_key("buff_hugepages")) elastic_hints["buff_hugepages"] = "2M";
+    }
+
     zero_copy_recv_offload_impl::sptr zero_copy_recv_offload(
-        new zero_copy_recv_offload_impl(transport, timeout)
+        new zero_copy_recv_offload_impl(transport, timeout,
+            size_t(hints.cast<double>("recv_offload_batch", 1)), cpus,
+            num_elastic_slots, elastic_hints)
     );
 
     return zero_copy_recv_offload;
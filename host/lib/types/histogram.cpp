@@ -0,0 +1,92 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/types/histogram.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <sstream>
+
+using namespace uhd;
+
+histogram_t::histogram_t(void):
+    count(0), min(0), max(0), sum(0), buckets(NUM_BUCKETS, 0)
+{
+    /* NOP */
+}
+
+size_t histogram_t::bucket_index(const uint64_t value){
+    if (value < SUB_BUCKETS) return size_t(value);
+
+    //the position of the highest bit, at least 4 here
+    size_t msb = 0;
+    for (size_t shift = 32; shift > 0; shift /= 2){
+        if ((value >> (msb + shift)) != 0) msb += shift;
+    }
+    const size_t index = SUB_BUCKETS*(msb - 3) + size_t((value >> (msb - 4)) & (SUB_BUCKETS - 1));
+    return std::min(index, NUM_BUCKETS - 1);
+}
+
+uint64_t histogram_t::bucket_lower_bound(const size_t index){
+    if (index < SUB_BUCKETS) return index;
+    const size_t msb = index/SUB_BUCKETS + 3;
+    return uint64_t(SUB_BUCKETS + index%SUB_BUCKETS) << (msb - 4);
+}
+
+double histogram_t::mean(void) const{
+    return (count == 0)? 0.0 : double(sum)/count;
+}
+
+uint64_t histogram_t::percentile(const double pct) const{
+    if (count == 0) return 0;
+    const double rank = std::max(1.0, std::min(pct, 100.0)/100.0*count);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++){
+        seen += buckets[i];
+        if (double(seen) >= rank) return std::max(min, bucket_lower_bound(i));
+    }
+    return max;
+}
+
+std::string histogram_t::to_json(void) const{
+    std::ostringstream ss;
+    ss << boost::format(
+        "{\"unit\":\"%s\",\"count\":%u,\"min\":%u,\"max\":%u,\"mean\":%.3f,"
+        "\"p50\":%u,\"p90\":%u,\"p99\":%u,\"p999\":%u,\"buckets\":["
+    ) % unit % count % min % max % mean()
+      % percentile(50) % percentile(90) % percentile(99) % percentile(99.9);
+    bool first = true;
+    for (size_t i = 0; i < buckets.size(); i++){
+        if (buckets[i] == 0) continue;
+        ss << (first? "" : ",") << boost::format("[%u,%u]") % bucket_lower_bound(i) % buckets[i];
+        first = false;
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+std::string uhd::to_json(const histograms_t &histograms){
+    std::ostringstream ss;
+    ss << "{";
+    bool first = true;
+    BOOST_FOREACH(const std::string &name, histograms.keys()){
+        ss << (first? "" : ",") << "\"" << name << "\":" << histograms[name].to_json();
+        first = false;
+    }
+    ss << "}";
+    return ss.str();
+}
@@ -32,6 +32,9 @@ std::string rx_metadata_t::to_pp_string(bool compact) const
         if (has_time_spec) {
             ss << "Time: " << time_spec.get_real_secs() << " s\n";
         }
+        if (has_host_time_spec) {
+            ss << "Host time: " << host_time_spec.get_real_secs() << " s\n";
+        }
         if (more_fragments) {
             ss << "Fragmentation offset: " << fragment_offset << "\n";
         }
@@ -44,15 +47,21 @@ std::string rx_metadata_t::to_pp_string(bool compact) const
         if (error_code != ERROR_CODE_NONE) {
             ss << strerror() << "\n";
         }
+        if (num_dropped_samps) {
+            ss << "Dropped samples: " << num_dropped_samps << "\n";
+        }
     } else {
         ss << "Has timespec: " << (has_time_spec ? "Yes" : "No")
            << "\tTime of first sample: " << time_spec.get_real_secs()
+           << "\nHas host timespec: " << (has_host_time_spec ? "Yes" : "No")
+           << "\tHost time of first packet: " << host_time_spec.get_real_secs()
            << "\nFragmented: " << (more_fragments ? "Yes" : "No")
            << "  Fragmentation offset: " << fragment_offset
            << "\nStart of burst: " << (start_of_burst ? "Yes" : "No")
            << "\tEnd of burst: " << (end_of_burst ? "Yes" : "No")
            << "\nError Code: " << strerror()
-           << "\tOut of sequence: " << (out_of_sequence ? "Yes" : "No");
+           << "\tOut of sequence: " << (out_of_sequence ? "Yes" : "No")
+           << "\nDropped samples: " << num_dropped_samps;
     }
 
     return ss.str();
@@ -108,6 +108,15 @@ uhd_error uhd_rx_metadata_out_of_sequence(
     )
 }
 
+uhd_error uhd_rx_metadata_num_dropped_samps(
+    uhd_rx_metadata_handle h,
+    size_t *num_dropped_samps_out
+){
+    UHD_SAFE_C_SAVE_ERROR(h,
+        *num_dropped_samps_out = h->rx_metadata_cpp.num_dropped_samps;
+    )
+}
+
 uhd_error uhd_rx_metadata_to_pp_string(
     uhd_rx_metadata_handle h,
     char* pp_string_out,
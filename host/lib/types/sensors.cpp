@@ -107,3 +107,44 @@ sensor_value_t& sensor_value_t::operator=(const sensor_value_t& rhs)
     this->type = rhs.type;
     return *this;
 }
+
+/***********************************************************************
+ * Sensor readings
+ **********************************************************************/
+sensor_reading_t::sensor_reading_t(
+    const std::string &key,
+    const sensor_value_t &value,
+    const time_spec_t &timestamp
+):
+    key(key), value(value), valid(true),
+    bool_value(false), real_value(0.0), timestamp(timestamp)
+{
+    try{
+        switch(value.type){
+        case sensor_value_t::BOOLEAN:
+            bool_value = value.to_bool();
+            real_value = bool_value? 1.0 : 0.0;
+            break;
+        case sensor_value_t::INTEGER:
+        case sensor_value_t::REALNUM:
+            real_value = value.to_real();
+            bool_value = (real_value != 0.0);
+            break;
+        case sensor_value_t::STRING:
+            break;
+        }
+    }
+    catch(const boost::bad_lexical_cast &){
+        valid = false;
+    }
+}
+
+sensor_reading_t::sensor_reading_t(
+    const std::string &key,
+    const time_spec_t &timestamp
+):
+    key(key), value(key, std::string(), std::string()), valid(false),
+    bool_value(false), real_value(0.0), timestamp(timestamp)
+{
+    /* NOP */
+}
@@ -54,3 +54,15 @@ uint16_t wb_iface::peek16(const wb_iface::wb_addr_type)
 {
     throw uhd::not_implemented_error("peek16 not implemented");
 }
+
+void wb_iface::transact(wb_iface::transactions_type &transactions)
+{
+    for (size_t i = 0; i < transactions.size(); i++) {
+        transaction_t &t = transactions[i];
+        switch (t.op) {
+        case transaction_t::POKE32: this->poke32(t.addr, uint32_t(t.data)); break;
+        case transaction_t::PEEK32: t.data = this->peek32(t.addr); break;
+        case transaction_t::PEEK64: t.data = this->peek64(t.addr); break;
+        }
+    }
+}
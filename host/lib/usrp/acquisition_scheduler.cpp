@@ -0,0 +1,287 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/usrp/acquisition_scheduler.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/msg.hpp>
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+using namespace uhd;
+using namespace uhd::usrp;
+
+acquisition_t::acquisition_t(const time_spec_t &start_, const size_t nsamps_):
+    start(start_), nsamps(nsamps_)
+{
+    /* NOP */
+}
+
+acquisition_scheduler::~acquisition_scheduler(void){
+    /* NOP */
+}
+
+/***********************************************************************
+ * Scheduler implementation
+ **********************************************************************/
+class acquisition_scheduler_impl : public acquisition_scheduler{
+public:
+    acquisition_scheduler_impl(
+        rx_streamer::sptr rx_stream, const double rate, const device_addr_t &args
+    ):
+        _rx_stream(rx_stream),
+        _rate(rate),
+        _max_cmd_samps(size_t(args.cast<double>("max_cmd_samps", 0x0fffffff))),
+        _cmd_depth(size_t(args.cast<double>("cmd_depth", 4))),
+        _resync_lead(args.cast<double>("resync_lead", 0.1)),
+        _base_index(0),
+        _recv_offset(0),
+        _issue_index(0),
+        _issue_offset(0),
+        _chain_open(false),
+        _last_index(0),
+        _num_dropped(0)
+    {
+        if (not _rx_stream) throw uhd::value_error("acquisition_scheduler: no RX streamer");
+        if (_rate <= 0.0) throw uhd::value_error("acquisition_scheduler: the rate must be positive");
+        if (_max_cmd_samps == 0 or _max_cmd_samps > 0x0fffffff) throw uhd::value_error(
+            "acquisition_scheduler: max_cmd_samps must be between 1 and 0x0fffffff");
+        //a chained command needs its follow-up issued before it starts
+        if (_cmd_depth < 2) throw uhd::value_error(
+            "acquisition_scheduler: cmd_depth must be at least 2");
+    }
+
+    ~acquisition_scheduler_impl(void){
+        if (not _cmds.empty()) try{
+            this->issue_stop();
+        } catch(...){}
+    }
+
+    void schedule(const std::vector<acquisition_t> &acqs){
+        for (size_t i = 0; i < acqs.size(); i++){
+            if (acqs[i].nsamps == 0) throw uhd::value_error(str(boost::format(
+                "acquisition_scheduler: acquisition %u has no samples") % i));
+            const acquisition_t *prev = (i == 0)? (_acqs.empty()? NULL : &_acqs.back()) : &acqs[i-1];
+            if (prev != NULL and acqs[i].start < end_time(*prev) - half_sample())
+                throw uhd::value_error(str(boost::format(
+                    "acquisition_scheduler: acquisition %u overlaps the previous one") % i));
+        }
+        _acqs.insert(_acqs.end(), acqs.begin(), acqs.end());
+        this->top_up();
+    }
+
+    size_t recv(
+        const rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t &metadata,
+        const double timeout
+    ){
+        this->top_up();
+        if (_acqs.empty()){
+            metadata.reset();
+            metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+            return 0;
+        }
+
+        //never return the samples of two acquisitions at once
+        const acquisition_t &acq = _acqs.front();
+        const size_t offset = _recv_offset;
+        const size_t nsamps = std::min(nsamps_per_buff, acq.nsamps - offset);
+        const size_t num_samps = _rx_stream->recv(buffs, nsamps, metadata, timeout);
+        _last_index = _base_index;
+
+        if (metadata.error_code != rx_metadata_t::ERROR_CODE_NONE
+            and metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT){
+            this->resync(buffs, nsamps_per_buff, metadata);
+            return 0;
+        }
+
+        this->consume(num_samps);
+        metadata.start_of_burst = (offset == 0 and num_samps != 0);
+        metadata.end_of_burst = false;
+        if (_recv_offset == acq.nsamps){
+            metadata.end_of_burst = true;
+            this->pop_acquisition();
+        }
+        this->top_up();
+        return num_samps;
+    }
+
+    size_t get_acquisition_index(void) const{
+        return _last_index;
+    }
+
+    size_t get_num_pending(void) const{
+        return _acqs.size();
+    }
+
+    size_t get_num_dropped(void) const{
+        return _num_dropped;
+    }
+
+    void stop(void){
+        if (not _cmds.empty()) this->issue_stop();
+        _base_index += _acqs.size();
+        _acqs.clear();
+        _recv_offset = 0;
+        _issue_index = _base_index;
+        _issue_offset = 0;
+    }
+
+private:
+    time_spec_t end_time(const acquisition_t &acq) const{
+        return acq.start + time_spec_t::from_ticks((long long)(acq.nsamps), _rate);
+    }
+
+    time_spec_t half_sample(void) const{
+        return time_spec_t(0.5/_rate);
+    }
+
+    //! Does the acquisition after i start where acquisition i ends?
+    bool chains_to_next(const size_t i) const{
+        if (i + 1 >= _acqs.size()) return false;
+        const double gap = (_acqs[i+1].start - end_time(_acqs[i])).get_real_secs();
+        return std::abs(gap) < 0.5/_rate;
+    }
+
+    //! Issue commands until the device holds cmd_depth of them
+    void top_up(void){
+        while (_cmds.size() < _cmd_depth and _issue_index - _base_index < _acqs.size()){
+            const size_t i = _issue_index - _base_index;
+            const acquisition_t &acq = _acqs[i];
+            const size_t remaining = acq.nsamps - _issue_offset;
+            const size_t nsamps = std::min(remaining, _max_cmd_samps);
+            const bool more = nsamps < remaining or this->chains_to_next(i);
+
+            stream_cmd_t cmd(more?
+                stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_MORE :
+                stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE
+            );
+            cmd.num_samps = nsamps;
+            //a chained command starts when the previous one ends
+            cmd.stream_now = _chain_open;
+            if (not _chain_open){
+                cmd.time_spec = acq.start + time_spec_t::from_ticks((long long)(_issue_offset), _rate);
+            }
+            _rx_stream->issue_stream_cmd(cmd);
+
+            _cmds.push_back(nsamps);
+            _chain_open = more;
+            _issue_offset += nsamps;
+            if (_issue_offset == acq.nsamps){
+                _issue_index++;
+                _issue_offset = 0;
+            }
+        }
+    }
+
+    //! Account for received samples, which complete the oldest commands
+    void consume(size_t nsamps){
+        _recv_offset += nsamps;
+        while (nsamps != 0 and not _cmds.empty()){
+            const size_t n = std::min(nsamps, _cmds.front());
+            _cmds.front() -= n;
+            nsamps -= n;
+            if (_cmds.front() == 0) _cmds.pop_front();
+        }
+    }
+
+    void pop_acquisition(void){
+        _acqs.pop_front();
+        _base_index++;
+        _recv_offset = 0;
+    }
+
+    void issue_stop(void){
+        _rx_stream->issue_stream_cmd(stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS);
+        _cmds.clear();
+        _chain_open = false;
+    }
+
+    /*!
+     * After an error: stop, drop the samples still in flight, and restart
+     * with the first acquisition which starts resync_lead after the error.
+     */
+    void resync(
+        const rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t &metadata
+    ){
+        const rx_metadata_t error_md = metadata;
+        this->issue_stop();
+
+        rx_metadata_t drain_md;
+        for (size_t i = 0; i < 1000; i++){
+            _rx_stream->recv(buffs, nsamps_per_buff, drain_md, 0.01, true);
+            if (drain_md.error_code == rx_metadata_t::ERROR_CODE_TIMEOUT) break;
+        }
+
+        UHD_MSG(warning) << boost::format(
+            "acquisition_scheduler: %s, dropping acquisition %u"
+        ) % error_md.strerror() % _base_index << std::endl;
+        this->pop_acquisition();
+        _num_dropped++;
+
+        if (error_md.has_time_spec){
+            const time_spec_t earliest = error_md.time_spec + time_spec_t(_resync_lead);
+            while (not _acqs.empty() and _acqs.front().start < earliest){
+                this->pop_acquisition();
+                _num_dropped++;
+            }
+        }
+        _issue_index = _base_index;
+        _issue_offset = 0;
+
+        metadata = error_md;
+        metadata.start_of_burst = false;
+        metadata.end_of_burst = true;
+        this->top_up();
+    }
+
+    const rx_streamer::sptr _rx_stream;
+    const double _rate;
+    const size_t _max_cmd_samps;
+    const size_t _cmd_depth;
+    const double _resync_lead;
+
+    //! The pending acquisitions, the first has the index _base_index
+    std::deque<acquisition_t> _acqs;
+    size_t _base_index;
+    size_t _recv_offset;
+
+    //! The next command to issue, as an acquisition index and offset
+    size_t _issue_index;
+    size_t _issue_offset;
+    bool _chain_open;
+
+    //! The samples still to come from each command given to the device
+    std::deque<size_t> _cmds;
+
+    size_t _last_index;
+    size_t _num_dropped;
+};
+
+/***********************************************************************
+ * The factory function
+ **********************************************************************/
+acquisition_scheduler::sptr acquisition_scheduler::make(
+    rx_streamer::sptr rx_stream, const double rate, const device_addr_t &args
+){
+    return boost::make_shared<acquisition_scheduler_impl>(rx_stream, rate, args);
+}
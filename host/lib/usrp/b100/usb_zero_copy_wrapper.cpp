@@ -83,7 +83,8 @@ private:
 class usb_zero_copy_wrapper_msb : public managed_send_buffer{
 public:
     usb_zero_copy_wrapper_msb(const zero_copy_if::sptr internal, const size_t fragmentation_size):
-        _internal(internal), _fragmentation_size(fragmentation_size)
+        _internal(internal), _fragmentation_size(fragmentation_size),
+        _bytes_in_buffer(0), _mem_buffer_tip(NULL)
     {
         _ok_to_auto_flush = false;
         _task = uhd::task::make(boost::bind(&usb_zero_copy_wrapper_msb::auto_flush, this));
@@ -102,6 +103,7 @@ public:
         //get a reference to the VITA header before incrementing
         const uint32_t vita_header = reinterpret_cast<const uint32_t *>(_mem_buffer_tip)[0];
 
+        const bool was_empty = _bytes_in_buffer == 0;
         _bytes_in_buffer += size();
         _mem_buffer_tip += size();
 
@@ -115,6 +117,10 @@ public:
             //notify the auto-flusher to restart its timed_wait
             lock.unlock(); _cond.notify_one();
         }
+        else if (was_empty){
+            //notify the auto-flusher to start timing this buffer
+            lock.unlock(); _cond.notify_one();
+        }
     }
 
     UHD_INLINE sptr get_new(const double timeout){
@@ -147,10 +153,13 @@ private:
     /*!
      * The auto flusher ensures that buffers are force committed when
      * the user has not called get_new() within a certain time window.
+     * It sleeps until a buffer is partially filled, so an idle
+     * transport does not wake it up every millisecond.
      */
     void auto_flush(void)
     {
         boost::mutex::scoped_lock lock(_mutex);
+        while (not _last_send_buff or _bytes_in_buffer == 0) _cond.wait(lock);
         const bool timeout = not _cond.timed_wait(lock, AUTOFLUSH_TIMEOUT);
         if (timeout and _ok_to_auto_flush and _last_send_buff and _bytes_in_buffer != 0)
         {
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include <boost/lexical_cast.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -80,6 +81,9 @@ const static int VREQ_MAX_SIZE_USB3 = 512;
 const static int VREQ_DEFAULT_SIZE  = VREQ_MAX_SIZE_USB2;
 const static int VREQ_MAX_SIZE      = VREQ_MAX_SIZE_USB3;
 
+//! The interval of the FX3 state polls while loading the FPGA
+const static boost::posix_time::milliseconds FX3_STATE_POLL_INTERVAL(1);
+
 typedef uint32_t hash_type;
 
 
@@ -232,10 +236,7 @@ public:
         //TODO
         //usrp_set_firmware_hash(hash); //set hash before reset
 
-        /* Success! Let the system settle. */
-        // TODO: Replace this with a polling loop in the FX3, or find out
-        // what the actual, correct timeout value is.
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1000));
+        //The FX3 now re-enumerates, the caller polls for the new device
     }
 
     void reset_fx3(void) {
@@ -374,10 +375,25 @@ public:
             throw uhd::io_error((boost::format("Short write on set FPGA hash (expecting: %d, returned: %d)") % bytes_to_send % ret).str());
     }
 
+    /*!
+     * Poll the FX3 state until it is the given one or an error state.
+     * \return the last state read, which is not \p state on a timeout
+     */
+    uint8_t wait_for_fx3_state(const uint8_t state, const boost::posix_time::time_duration &timeout) {
+        const boost::system_time exit_time = boost::get_system_time() + timeout;
+        while (true) {
+            const uint8_t fx3_state = get_fx3_status();
+            if ((fx3_state == state) || (fx3_state == FX3_STATE_ERROR) || (fx3_state == FX3_STATE_UNDEFINED)
+                    || (boost::get_system_time() > exit_time)) {
+                return fx3_state;
+            }
+            boost::this_thread::sleep(FX3_STATE_POLL_INTERVAL);
+        }
+    }
+
     uint32_t load_fpga(const std::string filestring, bool force) {
 
         uint8_t fx3_state = 0;
-        uint32_t wait_count;
         int ret = 0;
         int bytes_to_xfer = 0;
 
@@ -409,14 +425,8 @@ public:
             throw uhd::io_error((boost::format("load_fpga: short read on firmware loopback request (expecting: %d, returned: %d)") % ntoread % nread).str());
         transfer_size = std::min(transfer_size, nread); // Select the smaller value
 
-        size_t file_size = 0;
-        {
-            std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
-            file_size = size_t(file.tellg());
-        }
-
         std::ifstream file;
-        file.open(filename, std::ios::in | std::ios::binary);
+        file.open(filename, std::ios::in | std::ios::binary | std::ios::ate);
 
         if (!file.good()) {
             throw uhd::io_error("load_fpga: cannot open FPGA input file.");
@@ -433,18 +443,21 @@ public:
         else if (ret != bytes_to_xfer)
             throw uhd::io_error((boost::format("Short write on start FPGA config (expecting: %d, returned: %d)") % bytes_to_xfer % ret).str());
 
-        wait_count = 0;
-        do {
-            fx3_state = get_fx3_status();
-
-            if((wait_count >= 500) || (fx3_state == FX3_STATE_ERROR) || (fx3_state == FX3_STATE_UNDEFINED)) {
-                return fx3_state;
-            }
-
-            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        // Read the whole bitstream while the FX3 prepares the configuration,
+        // so the transfers below are not held up by the file system
+        const size_t file_size = size_t(file.tellg());
+        std::vector<char> bitstream(file_size);
+        file.seekg(0, std::ios::beg);
+        file.read(bitstream.data(), std::streamsize(file_size));
+        if (size_t(file.gcount()) != file_size) {
+            throw uhd::io_error("load_fpga: cannot read FPGA input file.");
+        }
+        file.close();
 
-            wait_count++;
-        } while(fx3_state != FX3_STATE_FPGA_READY);
+        fx3_state = wait_for_fx3_state(FX3_STATE_FPGA_READY, boost::posix_time::seconds(5));
+        if (fx3_state != FX3_STATE_FPGA_READY) {
+            return fx3_state;
+        }
 
         if (load_img_msg) UHD_MSG(status) << "Loading FPGA image: " \
             << filestring << "..." << std::flush;
@@ -456,62 +469,37 @@ public:
         else if (ret != bytes_to_xfer)
             throw uhd::io_error((boost::format("Short write on start FPGA bitstream (expecting: %d, returned: %d)") % bytes_to_xfer % ret).str());
 
-        wait_count = 0;
-        do {
-            fx3_state = get_fx3_status();
-
-            if((wait_count >= 1000) || (fx3_state == FX3_STATE_ERROR) || (fx3_state == FX3_STATE_UNDEFINED)) {
-                return fx3_state;
-            }
-
-            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
-
-            wait_count++;
-        } while(fx3_state != FX3_STATE_CONFIGURING_FPGA);
+        fx3_state = wait_for_fx3_state(FX3_STATE_CONFIGURING_FPGA, boost::posix_time::seconds(10));
+        if (fx3_state != FX3_STATE_CONFIGURING_FPGA) {
+            return fx3_state;
+        }
 
         size_t bytes_sent = 0;
-        while (!file.eof()) {
-            file.read((char *) out_buff, transfer_size);
-            const std::streamsize n = file.gcount();
-            if(n == 0)
-                continue;
-
-            uint16_t transfer_count = uint16_t(n);
+        while (bytes_sent < file_size) {
+            uint16_t transfer_count = uint16_t(std::min(size_t(transfer_size), file_size - bytes_sent));
 
             /* Send the data to the device. */
-            int nwritten = fx3_control_write(B200_VREQ_FPGA_DATA, 0, 0, out_buff, transfer_count, 5000);
+            int nwritten = fx3_control_write(B200_VREQ_FPGA_DATA, 0, 0,
+                (unsigned char *) &bitstream[bytes_sent], transfer_count, 5000);
             if (nwritten < 0)
                 throw uhd::io_error((boost::format("load_fpga: cannot write bitstream to FX3 (%d: %s)") % nwritten % libusb_error_name(nwritten)).str());
             else if (nwritten != transfer_count)
                 throw uhd::io_error((boost::format("load_fpga: short write while transferring bitstream to FX3  (expecting: %d, returned: %d)") % transfer_count % nwritten).str());
 
-            if (load_img_msg)
+            if (load_img_msg and bytes_sent == 0) UHD_MSG(status) << "  0%" << std::flush;
+            const size_t percent_before = size_t((bytes_sent*100)/file_size);
+            bytes_sent += transfer_count;
+            const size_t percent_after = size_t((bytes_sent*100)/file_size);
+            if (load_img_msg and percent_before != percent_after)
             {
-                if (bytes_sent == 0) UHD_MSG(status) << "  0%" << std::flush;
-                const size_t percent_before = size_t((bytes_sent*100)/file_size);
-                bytes_sent += transfer_count;
-                const size_t percent_after = size_t((bytes_sent*100)/file_size);
-                if (percent_before != percent_after)
-                {
-                    UHD_MSG(status) << "\b\b\b\b" << std::setw(3) << percent_after << "%" << std::flush;
-                }
+                UHD_MSG(status) << "\b\b\b\b" << std::setw(3) << percent_after << "%" << std::flush;
             }
         }
 
-        file.close();
-
-        wait_count = 0;
-        do {
-            fx3_state = get_fx3_status();
-
-            if((wait_count >= 500) || (fx3_state == FX3_STATE_ERROR) || (fx3_state == FX3_STATE_UNDEFINED)) {
-                return fx3_state;
-            }
-
-            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
-
-            wait_count++;
-        } while(fx3_state != FX3_STATE_RUNNING);
+        fx3_state = wait_for_fx3_state(FX3_STATE_RUNNING, boost::posix_time::seconds(5));
+        if (fx3_state != FX3_STATE_RUNNING) {
+            return fx3_state;
+        }
 
         usrp_set_fpga_hash(hash);
 
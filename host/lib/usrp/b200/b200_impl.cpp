@@ -19,6 +19,7 @@
 #include "b200_regs.hpp"
 #include <uhd/config.hpp>
 #include <uhd/transport/usb_control.hpp>
+#include <uhd/utils/init_profile.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/cast.hpp>
 #include <uhd/exception.hpp>
@@ -46,6 +47,7 @@ using namespace uhd::usrp::gpio_atr;
 using namespace uhd::transport;
 
 static const boost::posix_time::milliseconds REENUMERATION_TIMEOUT_MS(3000);
+static const boost::posix_time::milliseconds REENUMERATION_POLL_INTERVAL(10);
 
 // B200 + B210:
 class b200_ad9361_client_t : public ad9361_params {
@@ -215,6 +217,10 @@ static device_addrs_t b200_find(const device_addr_t &hint)
     {
         BOOST_FOREACH(usb_device_handle::sptr handle, get_b200_device_handles(hint))
         {
+            //a device which still runs the bootloader has not re-enumerated yet
+            try{if (not handle->firmware_loaded()) continue;}
+            catch(const uhd::exception &){continue;}
+
             usb_control::sptr control;
             try{control = usb_control::make(handle, 0);}
             catch(const uhd::exception &){continue;} //ignore claimed
@@ -242,6 +248,9 @@ static device_addrs_t b200_find(const device_addr_t &hint)
                 b200_addrs.push_back(new_addr);
             }
         }
+        if (b200_addrs.empty()){
+            boost::this_thread::sleep(REENUMERATION_POLL_INTERVAL);
+        }
     }
 
     return b200_addrs;
@@ -284,12 +293,15 @@ UHD_STATIC_BLOCK(register_b200_device)
 b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::sptr &handle) :
     _product(B200), // Some safe value
     _revision(0),
+    _time_estimate_max_age(device_addr.cast<double>("time_estimate_max_age", 0.0)),
     _time_source(UNKNOWN),
     _tick_rate(0.0) // Forces a clock initialization at startup
 {
     _tree = property_tree::make();
     _type = device::USRP;
     const fs_path mb_path = "/mboards/0";
+    init_profile::scoped_phase mb_phase("mboard", 0);
+    init_profile::scoped_phase phase("mboard/compat checks", 0);
 
     //try to match the given device address with something on the USB bus
     uint16_t vid = B200_VENDOR_ID;
@@ -362,6 +374,7 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     ////////////////////////////////////////////////////////////////////
     // setup the mboard eeprom
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/eeprom");
     const mboard_eeprom_t mb_eeprom(*_iface, "B200");
     _tree->create<mboard_eeprom_t>(mb_path / "eeprom")
         .set(mb_eeprom)
@@ -420,6 +433,7 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     ////////////////////////////////////////////////////////////////////
     // Load the FPGA image, then reset GPIF
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/fpga load");
     //extract the FPGA path for the B200
     std::string b200_fpga_image = find_image_path(
         device_addr.has_key("fpga")? device_addr["fpga"] : default_file_name
@@ -436,6 +450,7 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     ////////////////////////////////////////////////////////////////////
     // Create control transport
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/link");
     uint8_t usb_speed = _iface->get_usb_speed();
     UHD_MSG(status) << "Operating over USB " << (int) usb_speed << "." << std::endl;
     const std::string min_frame_size = (usb_speed == 3) ? "1024" : "512";
@@ -483,6 +498,7 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     ////////////////////////////////////////////////////////////////////
     // Create the GPSDO control
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/gpsdo");
     if (_gpsdo_capable)
     {
 
@@ -516,6 +532,7 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     ////////////////////////////////////////////////////////////////////
     // Initialize the properties tree
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/data transport");
     _tree->create<std::string>("/name").set("B-Series Device");
     _tree->create<std::string>(mb_path / "name").set(product_name);
     _tree->create<std::string>(mb_path / "codename").set((_product == B200MINI or _product == B205MINI) ? "Pixie" : "Sasquatch");
@@ -526,25 +543,33 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     // be in the FPGAs buffers doesn't get pulled into the transport
     // before being cleared.
     ////////////////////////////////////////////////////////////////////
-    device_addr_t data_xport_args;
-    data_xport_args["recv_frame_size"] = device_addr.get("recv_frame_size", "8192");
-    data_xport_args["num_recv_frames"] = device_addr.get("num_recv_frames", "16");
-    data_xport_args["send_frame_size"] = device_addr.get("send_frame_size", "8192");
-    data_xport_args["num_send_frames"] = device_addr.get("num_send_frames", "16");
+    _usb_handle = handle;
+    _usb_speed = usb_speed;
+    _data_xport_args["send_frame_size"] = device_addr.get("send_frame_size", "8192");
+    _data_xport_args["num_send_frames"] = device_addr.get("num_send_frames", "16");
+    if (device_addr.has_key("num_recv_frames")) {
+        _data_xport_args["num_recv_frames"] = device_addr["num_recv_frames"];
+    }
+    BOOST_FOREACH(const std::string &key, device_addr.keys()) {
+        if (key.find("usb_event_") == 0) _data_xport_args[key] = device_addr[key];
+    }
+    //Without explicit RX transfer sizes, each streamer resizes the transfers for its rate
+    _data_xport_auto = not device_addr.has_key("recv_frame_size")
+        and not device_addr.has_key("num_recv_frames")
+        and not device_addr.has_key("recv_bandwidth");
+    this->load_usb_xfer_cal();
 
     // This may throw a uhd::usb_error, which will be caught by b200_make().
-    _data_transport = usb_zero_copy::make(
-        handle,        // identifier
-        B200_USB_DATA_RECV_INTERFACE, B200_USB_DATA_RECV_ENDPOINT, //interface, endpoint
-        B200_USB_DATA_SEND_INTERFACE, B200_USB_DATA_SEND_ENDPOINT, //interface, endpoint
-        data_xport_args    // param hints
+    //Without num_recv_frames, the transport sizes the RX transfers for the link rate
+    this->setup_data_transport(
+        device_addr.cast<size_t>("recv_frame_size", B200_DEFAULT_RECV_FRAME_SIZE),
+        device_addr.cast<double>("recv_bandwidth", (usb_speed == 3) ? B200_MAX_RATE_USB3 : B200_MAX_RATE_USB2)
     );
-    while (_data_transport->get_recv_buff(0.0)){} //flush ctrl xport
-    _demux = recv_packet_demuxer_3000::make(_data_transport);
 
     ////////////////////////////////////////////////////////////////////
     // create time and clock control objects
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/clocking");
     _spi_iface = b200_local_spi_core::make(_local_ctrl);
     if (not (_product == B200MINI or _product == B205MINI)) {
         _adf4001_iface = boost::make_shared<b200_ref_pll_ctrl>(_spi_iface);
@@ -553,6 +578,7 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     ////////////////////////////////////////////////////////////////////
     // Init codec - turns on clocks
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/codec");
     UHD_MSG(status) << "Initialize CODEC control..." << std::endl;
     ad9361_params::sptr client_settings;
     if (_product == B200MINI or _product == B205MINI) {
@@ -560,7 +586,10 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     } else {
         client_settings = boost::make_shared<b200_ad9361_client_t>();
     }
-    _codec_ctrl = ad9361_ctrl::make_spi(client_settings, _spi_iface, AD9361_SLAVENO);
+    _codec_ctrl = ad9361_ctrl::make_spi(client_settings, _spi_iface, AD9361_SLAVENO, true /* burst writes */);
+    if (device_addr.has_key("cal_cache_temp_drift")) {
+        _codec_ctrl->set_cal_cache_temp_drift(device_addr.cast<double>("cal_cache_temp_drift", 0.0));
+    }
 
     ////////////////////////////////////////////////////////////////////
     // create codec control objects
@@ -610,6 +639,7 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     ////////////////////////////////////////////////////////////////////
     // setup radio control
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/radios");
     UHD_MSG(status) << "Initialize Radio control..." << std::endl;
     const size_t num_radio_chains = ((_local_ctrl->peek32(RB32_CORE_STATUS) >> 8) & 0xff);
     UHD_ASSERT_THROW(num_radio_chains > 0);
@@ -636,6 +666,13 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
         .set_publisher(boost::bind(&time_core_3000::get_time_now, _radio_perifs[0].time64))
         .add_coerced_subscriber(boost::bind(&b200_impl::set_time, this, _1))
         .set(0.0);
+    _tree->create<time_spec_t>(mb_path / "time" / "now_exact")
+        .set_publisher(boost::bind(&time_core_3000::get_time_now_exact, _radio_perifs[0].time64));
+    //optionally extrapolate the time from the host clock between reads
+    BOOST_FOREACH(radio_perifs_t &perif, _radio_perifs)
+    {
+        perif.time64->set_time_estimation(_time_estimate_max_age);
+    }
     //re-sync the times when the tick rate changes
     _tree->access<double>(mb_path / "tick_rate")
         .add_coerced_subscriber(boost::bind(&b200_impl::sync_times, this));
@@ -690,6 +727,7 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     ////////////////////////////////////////////////////////////////////
     // do some post-init tasks
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/properties");
     // Init the clock rate and the auto mcr appropriately
     if (not device_addr.has_key("master_clock_rate")) {
         UHD_MSG(status) << "Setting master clock rate selection to 'automatic'." << std::endl;
@@ -721,6 +759,11 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
         _radio_perifs[i].ddc->set_host_rate(default_tick_rate / ad936x_manager::DEFAULT_DECIM);
         _radio_perifs[i].duc->set_host_rate(default_tick_rate / ad936x_manager::DEFAULT_INTERP);
     }
+
+    //measure the RX transfer sizes this host controller can sustain
+    if (device_addr.has_key("usb_xfer_probe")) {
+        this->run_usb_xfer_probe();
+    }
 }
 
 b200_impl::~b200_impl(void)
@@ -47,6 +47,7 @@
 #include <boost/assign.hpp>
 #include <boost/weak_ptr.hpp>
 #include "recv_packet_demuxer_3000.hpp"
+#include "async_msg_dispatcher.hpp"
 static const uint8_t  B200_FW_COMPAT_NUM_MAJOR = 8;
 static const uint8_t  B200_FW_COMPAT_NUM_MINOR = 0;
 static const uint16_t B200_FPGA_COMPAT_NUM = 14;
@@ -55,6 +56,7 @@ static const double          B200_BUS_CLOCK_RATE = 100e6;
 static const uint32_t B200_GPSDO_ST_NONE = 0x83;
 static const size_t B200_MAX_RATE_USB2              =  53248000; // bytes/s
 static const size_t B200_MAX_RATE_USB3              = 500000000; // bytes/s
+static const size_t B200_DEFAULT_RECV_FRAME_SIZE    = 8192;      // bytes
 
 #define FLIP_SID(sid) (((sid)<<16)|((sid)>>16))
 
@@ -128,6 +130,7 @@ private:
     b200_product_t  _product;
     size_t          _revision;
     bool            _gpsdo_capable;
+    double          _time_estimate_max_age;
 
     //controllers
     b200_iface::sptr _iface;
@@ -143,6 +146,19 @@ private:
     uhd::transport::zero_copy_if::sptr _ctrl_transport;
     uhd::usrp::recv_packet_demuxer_3000::sptr _demux;
 
+    //data transport sizing, see b200_io_impl.cpp
+    uhd::transport::usb_device_handle::sptr _usb_handle;
+    uint8_t _usb_speed;
+    uhd::device_addr_t _data_xport_args;
+    bool _data_xport_auto;
+    //sustained RX bytes/s by transfer size, from the probe
+    uhd::dict<size_t, double> _usb_xfer_cal;
+    void setup_data_transport(const size_t recv_frame_size, const double recv_bandwidth);
+    void tune_data_transport(const double samp_rate, const size_t num_chans, const std::string &otw_format);
+    std::string get_usb_xfer_cal_path(void);
+    void load_usb_xfer_cal(void);
+    void run_usb_xfer_probe(void);
+
     boost::weak_ptr<uhd::rx_streamer> _rx_streamer;
     boost::weak_ptr<uhd::tx_streamer> _tx_streamer;
 
@@ -150,7 +166,7 @@ private:
 
     //async ctrl + msgs
     uhd::msg_task::sptr _async_task;
-    typedef uhd::transport::bounded_buffer<uhd::async_metadata_t> async_md_type;
+    typedef uhd::usrp::async_md_queue async_md_type;
     struct AsyncTaskData
     {
         boost::shared_ptr<async_md_type> async_md;
@@ -22,11 +22,21 @@
 #include "../../transport/super_send_packet_handler.hpp"
 #include "async_packet_handler.hpp"
 #include <uhd/utils/math.hpp>
+#include <uhd/utils/csv.hpp>
+#include <uhd/utils/paths.hpp>
 #include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/math/common_factor.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
 #include <set>
 
+namespace fs = boost::filesystem;
+
 using namespace uhd;
 using namespace uhd::usrp;
 using namespace uhd::transport;
@@ -363,7 +373,7 @@ boost::optional<uhd::msg_task::msg_type_t> b200_impl::handle_async_task(
         //fill in the async metadata
         async_metadata_t metadata;
         load_metadata_from_buff(uhd::wtohx<uint32_t>, metadata, if_packet_info, packet_buff, _tick_rate, i);
-        data->async_md->push_with_pop_on_full(metadata);
+        data->async_md->push(metadata);
         standard_async_msg_prints(metadata);
         break;
     }
@@ -375,6 +385,191 @@ boost::optional<uhd::msg_task::msg_type_t> b200_impl::handle_async_task(
     return boost::none;
 }
 
+/***********************************************************************
+ * Data transport sizing
+ **********************************************************************/
+//! The time of samples one RX transfer should hold, which bounds the latency
+static const double B200_XFER_TIME = 0.001;
+
+//! The largest RX transfer, the FPGA frames at most 4092 samples
+static const size_t B200_MAX_RECV_FRAME_SIZE = 16384;
+
+//! Headroom on the stream rate when choosing a calibrated transfer size
+static const double B200_XFER_CAL_MARGIN = 1.1;
+
+//! How long the probe streams with each transfer size
+static const double B200_XFER_PROBE_TIME = 1.0;
+
+void b200_impl::setup_data_transport(const size_t recv_frame_size, const double recv_bandwidth)
+{
+    device_addr_t data_xport_args = _data_xport_args;
+    data_xport_args["recv_frame_size"] = boost::lexical_cast<std::string>(recv_frame_size);
+    data_xport_args["recv_bandwidth"] = boost::lexical_cast<std::string>(recv_bandwidth);
+
+    //release the old transfers before the new ones are submitted
+    _demux.reset();
+    _data_transport.reset();
+    _data_transport = usb_zero_copy::make(
+        _usb_handle,        // identifier
+        B200_USB_DATA_RECV_INTERFACE, B200_USB_DATA_RECV_ENDPOINT, //interface, endpoint
+        B200_USB_DATA_SEND_INTERFACE, B200_USB_DATA_SEND_ENDPOINT, //interface, endpoint
+        data_xport_args    // param hints
+    );
+    while (_data_transport->get_recv_buff(0.0)){} //flush ctrl xport
+    _demux = recv_packet_demuxer_3000::make(_data_transport);
+}
+
+/*!
+ * Resize the RX transfers for a new streamer.
+ * A transfer holds about B200_XFER_TIME of samples, and there are
+ * enough transfers for the transport's buffering time at the stream rate.
+ * When the probe measured that a transfer size cannot keep up with the
+ * stream rate on this host, the smallest size that can is used instead.
+ * The transport is only replaced while no streamer is using it.
+ */
+void b200_impl::tune_data_transport(const double samp_rate, const size_t num_chans, const std::string &otw_format)
+{
+    if (not _data_xport_auto or max_chan_count() > 0) return;
+
+    const double bandwidth = samp_rate * num_chans * convert::get_bytes_per_item(otw_format);
+    const size_t max_bandwidth = (_usb_speed == 3) ? B200_MAX_RATE_USB3 : B200_MAX_RATE_USB2;
+    //whole USB bulk packets: 1024 bytes on USB 3, 512 bytes on USB 2
+    const size_t pkt_size = (_usb_speed == 3) ? 1024 : 512;
+    const size_t max_frame_size = (_usb_speed == 3) ? B200_MAX_RECV_FRAME_SIZE : B200_DEFAULT_RECV_FRAME_SIZE;
+
+    size_t frame_size = pkt_size * size_t(std::ceil(bandwidth * B200_XFER_TIME / pkt_size));
+    frame_size = std::min(std::max(frame_size, pkt_size), B200_DEFAULT_RECV_FRAME_SIZE);
+    if (_usb_xfer_cal.size() > 0) {
+        size_t best_size = 0;
+        BOOST_FOREACH(const size_t cal_size, _usb_xfer_cal.keys()) {
+            if (cal_size < frame_size or cal_size > max_frame_size) continue;
+            if (_usb_xfer_cal[cal_size] < bandwidth * B200_XFER_CAL_MARGIN) continue;
+            if (best_size == 0 or cal_size < best_size) best_size = cal_size;
+        }
+        if (best_size == 0) {
+            UHD_MSG(warning) << boost::format(
+                "The USB transfer probe measured no transfer size that sustains %.1f MB/s on this host.\n"
+                "Expect overflows, or run it again with usb_xfer_probe."
+            ) % (bandwidth/1e6) << std::endl;
+        }
+        else frame_size = best_size;
+    }
+
+    if (frame_size == _data_transport->get_recv_frame_size()) return;
+    UHD_LOG << boost::format("b200: RX transfers of %u bytes for %.1f MB/s") % frame_size % (bandwidth/1e6) << std::endl;
+    this->setup_data_transport(frame_size, std::min(bandwidth, double(max_bandwidth)));
+}
+
+std::string b200_impl::get_usb_xfer_cal_path(void)
+{
+    const std::string serial = _usb_handle->get_serial();
+    return (fs::path(uhd::get_app_path()) / ".uhd" / "cal" / ("b200_usb_xfer_cal_" + serial + ".csv")).string();
+}
+
+void b200_impl::load_usb_xfer_cal(void)
+{
+    const std::string path = this->get_usb_xfer_cal_path();
+    if (not fs::exists(path)) return;
+
+    std::ifstream cal_data(path.c_str());
+    const uhd::csv::rows_type rows = uhd::csv::to_rows(cal_data);
+    bool read_data = false, skip_next = false;
+    BOOST_FOREACH(const uhd::csv::row_type &row, rows) {
+        if (not read_data and not row.empty() and row[0] == "DATA STARTS HERE") {
+            read_data = true;
+            skip_next = true;
+            continue;
+        }
+        if (not read_data) continue;
+        if (skip_next) {
+            skip_next = false;
+            continue;
+        }
+        if (row.size() < 2) continue;
+        double frame_size = 0.0, sustained = 0.0;
+        std::sscanf(row[0].c_str(), "%lf", &frame_size);
+        std::sscanf(row[1].c_str(), "%lf", &sustained);
+        if (frame_size > 0) _usb_xfer_cal[size_t(frame_size)] = sustained;
+    }
+    UHD_MSG(status) << "Loaded " << path << std::endl;
+}
+
+/*!
+ * Stream from one channel at the highest rate with each RX transfer size,
+ * and record the rate that arrived without overflows.
+ * The results are written to ~/.uhd/cal and used by later sessions.
+ */
+void b200_impl::run_usb_xfer_probe(void)
+{
+    if (_usb_speed != 3) {
+        UHD_MSG(warning) << "The USB transfer probe needs a USB 3 link." << std::endl;
+        return;
+    }
+    UHD_MSG(status) << "Probing USB transfer sizes..." << std::endl;
+
+    const fs_path rate_path = "/mboards/0/rx_dsps/0/rate/value";
+    const double old_rate = _tree->access<double>(rate_path).get();
+    const bool old_auto = _data_xport_auto;
+    _data_xport_auto = false;
+
+    _usb_xfer_cal = uhd::dict<size_t, double>();
+    std::vector<size_t> overflows;
+    for (size_t frame_size = 4096; frame_size <= B200_MAX_RECV_FRAME_SIZE; frame_size *= 2) {
+        this->setup_data_transport(frame_size, B200_MAX_RATE_USB3);
+        _tree->access<double>(rate_path).set(ad9361_device_t::AD9361_MAX_CLOCK_RATE);
+        const double rate = _tree->access<double>(rate_path).get();
+
+        stream_args_t args("sc16", "sc16");
+        rx_streamer::sptr streamer = this->get_rx_stream(args);
+        std::vector<uint32_t> buff(streamer->get_max_num_samps());
+        rx_metadata_t md;
+        size_t num_samps = 0, num_overflows = 0;
+
+        streamer->issue_stream_cmd(stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+        const time_spec_t start_time = time_spec_t::get_system_time();
+        while ((time_spec_t::get_system_time() - start_time).get_real_secs() < B200_XFER_PROBE_TIME) {
+            num_samps += streamer->recv(&buff.front(), buff.size(), md, 0.1);
+            if (md.error_code == rx_metadata_t::ERROR_CODE_OVERFLOW) num_overflows++;
+        }
+        const double elapsed = (time_spec_t::get_system_time() - start_time).get_real_secs();
+        streamer->issue_stream_cmd(stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS);
+        while (streamer->recv(&buff.front(), buff.size(), md, 0.1)) {}
+
+        //an overflow means the sustained rate is below the stream rate
+        const double arrived = num_samps * sizeof(uint32_t) / elapsed;
+        const double sustained = (num_overflows == 0) ? rate * sizeof(uint32_t) : arrived;
+        _usb_xfer_cal[frame_size] = sustained;
+        overflows.push_back(num_overflows);
+        UHD_MSG(status) << boost::format("  %5u byte transfers: %.1f MB/s, %u overflows")
+            % frame_size % (sustained/1e6) % num_overflows << std::endl;
+    }
+
+    //write the results in the format of the other calibration files
+    const std::string path = this->get_usb_xfer_cal_path();
+    try {
+        fs::create_directories(fs::path(path).parent_path());
+        std::ofstream cal_data(path.c_str());
+        const std::time_t now = std::time(NULL);
+        cal_data << "name, B200 USB Transfer Calibration" << std::endl;
+        cal_data << "serial, " << _usb_handle->get_serial() << std::endl;
+        cal_data << "timestamp, " << now << std::endl;
+        cal_data << "version, 0, 1" << std::endl;
+        cal_data << "DATA STARTS HERE" << std::endl;
+        cal_data << "recv_frame_size, sustained_bytes_per_sec, overflows" << std::endl;
+        size_t i = 0;
+        BOOST_FOREACH(const size_t frame_size, _usb_xfer_cal.keys()) {
+            cal_data << frame_size << ", " << _usb_xfer_cal[frame_size] << ", " << overflows[i++] << std::endl;
+        }
+        UHD_MSG(status) << "Wrote " << path << std::endl;
+    } catch (const std::exception &e) {
+        UHD_MSG(warning) << "Cannot write " << path << ": " << e.what() << std::endl;
+    }
+
+    _tree->access<double>(rate_path).set(old_rate);
+    _data_xport_auto = old_auto;
+    this->setup_data_transport(B200_DEFAULT_RECV_FRAME_SIZE, B200_MAX_RATE_USB3);
+}
+
 /***********************************************************************
  * Receive streamer
  **********************************************************************/
@@ -393,6 +588,13 @@ rx_streamer::sptr b200_impl::get_rx_stream(const uhd::stream_args_t &args_)
     }
     check_streamer_args(args, this->get_tick_rate(), "RX");
 
+    //size the RX transfers for the rate of the first channel
+    this->tune_data_transport(
+        _tree->access<double>(str(boost::format("/mboards/0/rx_dsps/%u/rate/value")
+            % _tree->access<std::vector<size_t> >("/mboards/0/rx_chan_dsp_mapping").get().at(args.channels[0]))).get(),
+        args.channels.size(), args.otw_format
+    );
+
     boost::shared_ptr<sph::recv_packet_streamer> my_streamer;
     for (size_t stream_i = 0; stream_i < args.channels.size(); stream_i++)
     {
@@ -430,7 +632,7 @@ rx_streamer::sptr b200_impl::get_rx_stream(const uhd::stream_args_t &args_)
         id.num_inputs = 1;
         id.output_format = args.cpu_format;
         id.num_outputs = 1;
-        my_streamer->set_converter(id);
+        my_streamer->set_converter(id, args.args);
 
         perif.framer->clear();
         perif.framer->set_nsamps_per_packet(spp);
@@ -447,6 +649,11 @@ rx_streamer::sptr b200_impl::get_rx_stream(const uhd::stream_args_t &args_)
         my_streamer->set_issue_stream_cmd(stream_i, boost::bind(
             &rx_vita_core_3000::issue_stream_command, perif.framer, _1
         ));
+        if (_time_estimate_max_age > 0.0) {
+            my_streamer->set_time_observer(boost::bind(
+                &time_core_3000::update_time_estimate, perif.time64, _1
+            ));
+        }
         perif.rx_streamer = my_streamer; //store weak pointer
 
         //sets all tick and samp rates on this streamer
@@ -455,6 +662,8 @@ rx_streamer::sptr b200_impl::get_rx_stream(const uhd::stream_args_t &args_)
     }
     this->update_enables();
 
+    my_streamer->apply_stream_args(args.args);
+
     return my_streamer;
 }
 
@@ -537,18 +746,19 @@ tx_streamer::sptr b200_impl::get_tx_stream(const uhd::stream_args_t &args_)
         id.num_inputs = 1;
         id.output_format = args.otw_format + "_item32_le";
         id.num_outputs = 1;
-        my_streamer->set_converter(id);
+        my_streamer->set_converter(id, args.args);
 
         perif.deframer->clear();
         perif.deframer->setup(args);
         perif.duc->setup(args);
 
-        my_streamer->set_xport_chan_get_buff(stream_i, boost::bind(
-            &zero_copy_if::get_send_buff, _data_transport, _1
-        ));
+        my_streamer->set_xport_chan(stream_i, _data_transport);
         my_streamer->set_async_receiver(boost::bind(
             &async_md_type::pop_with_timed_wait, _async_task_data->async_md, _1, _2
         ));
+        my_streamer->set_async_msg_callback_setter(boost::bind(
+            &async_md_type::set_callback, _async_task_data->async_md, _1
+        ));
         my_streamer->set_xport_chan_sid(stream_i, true, radio_index ? B200_TX_DATA1_SID : B200_TX_DATA0_SID);
         my_streamer->set_enable_trailer(false); //TODO not implemented trailer support yet
         perif.tx_streamer = my_streamer; //store weak pointer
@@ -559,5 +769,7 @@ tx_streamer::sptr b200_impl::get_tx_stream(const uhd::stream_args_t &args_)
     }
     this->update_enables();
 
+    my_streamer->apply_stream_args(args.args);
+
     return my_streamer;
 }
@@ -36,8 +36,8 @@ using namespace uhd::usrp;
 class ad9361_io_spi : public ad9361_io
 {
 public:
-    ad9361_io_spi(uhd::spi_iface::sptr spi_iface, uint32_t slave_num) :
-        _spi_iface(spi_iface), _slave_num(slave_num) { }
+    ad9361_io_spi(uhd::spi_iface::sptr spi_iface, uint32_t slave_num, const bool burst_writes = false) :
+        _spi_iface(spi_iface), _slave_num(slave_num), _burst_writes(burst_writes) { }
 
     virtual ~ad9361_io_spi() { }
 
@@ -61,20 +61,58 @@ public:
     virtual void poke8(uint32_t reg, uint8_t val)
     {
         boost::lock_guard<boost::mutex> lock(_mutex);
+        _write_spi(reg, val);
+    }
+
+    virtual void poke8_bulk(const reg_writes_t &writes)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+
+        size_t i = 0;
+        while (i < writes.size()) {
+            const uint32_t reg = writes[i].first;
+            if (_burst_writes and i + 1 < writes.size() and writes[i + 1].first + 1 == reg) {
+                _write_spi_2bytes(reg, writes[i].second, writes[i + 1].second);
+                i += 2;
+            } else {
+                _write_spi(reg, writes[i].second);
+                i++;
+            }
+        }
+    }
 
+private:
+    static uhd::spi_config_t _get_spi_config()
+    {
         uhd::spi_config_t config;
         config.mosi_edge = uhd::spi_config_t::EDGE_FALL;
         config.miso_edge = uhd::spi_config_t::EDGE_FALL;    //TODO (Ashish): FPGA SPI workaround. This should be EDGE_RISE
+        return config;
+    }
 
+    void _write_spi(uint32_t reg, uint8_t val)
+    {
         uint32_t wr_word = AD9361_SPI_WRITE_CMD |
                            ((uint32_t(reg) << AD9361_SPI_ADDR_SHIFT) & AD9361_SPI_ADDR_MASK) |
                            ((uint32_t(val) << AD9361_SPI_DATA_SHIFT) & AD9361_SPI_DATA_MASK);
-        _spi_iface->write_spi(_slave_num, config, wr_word, AD9361_SPI_NUM_BITS);
+        _spi_iface->write_spi(_slave_num, _get_spi_config(), wr_word, AD9361_SPI_NUM_BITS);
+    }
+
+    //! Write reg and reg-1 in a single 32-bit transfer
+    void _write_spi_2bytes(uint32_t reg, uint8_t val, uint8_t next_val)
+    {
+        uint32_t wr_word = ((AD9361_SPI_WRITE_CMD | AD9361_SPI_2BYTES_CMD |
+                             ((uint32_t(reg) << AD9361_SPI_ADDR_SHIFT) & AD9361_SPI_ADDR_MASK))
+                            << AD9361_SPI_BURST_SHIFT) |
+                           (uint32_t(val) << AD9361_SPI_BURST_SHIFT) |
+                           uint32_t(next_val);
+        _spi_iface->write_spi(_slave_num, _get_spi_config(), wr_word, AD9361_SPI_BURST_NUM_BITS);
     }
 
-private:
     uhd::spi_iface::sptr    _spi_iface;
     uint32_t         _slave_num;
+    //! true if the SPI core can do 32-bit transfers
+    const bool              _burst_writes;
     boost::mutex            _mutex;
 
     static const uint32_t AD9361_SPI_WRITE_CMD  = 0x00800000;
@@ -84,6 +122,10 @@ private:
     static const uint32_t AD9361_SPI_DATA_MASK  = 0x000000FF;
     static const uint32_t AD9361_SPI_DATA_SHIFT = 0;
     static const uint32_t AD9361_SPI_NUM_BITS   = 24;
+    // The NB field of the instruction word is the number of bytes minus one
+    static const uint32_t AD9361_SPI_2BYTES_CMD = 0x00100000;
+    static const uint32_t AD9361_SPI_BURST_SHIFT = 8;
+    static const uint32_t AD9361_SPI_BURST_NUM_BITS = 32;
 };
 
 /***********************************************************************
@@ -193,6 +235,18 @@ public:
         return return_val;
     }
 
+    //! tune the given frontend through a tune profile, return the exact value
+    double tune_with_profile(const std::string &which, const size_t profile, const double freq)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+
+        //clip to known bounds
+        const double value = ad9361_ctrl::get_rf_freq_range().clip(freq);
+
+        ad9361_device_t::direction_t direction = _get_direction_from_antenna(which);
+        return _device.tune_with_profile(direction, profile, value);
+    }
+
     //! get the current frequency for the given frontend
     double get_freq(const std::string &which)
     {
@@ -241,6 +295,12 @@ public:
         _device.set_iq_balance_auto(direction,on);
     }
 
+    void set_cal_cache_temp_drift(const double max_temp_drift)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _device.set_cal_cache_temp_drift(max_temp_drift);
+    }
+
     double set_bw_filter(const std::string &which, const double bw)
     {
         boost::lock_guard<boost::mutex> lock(_mutex);
@@ -327,8 +387,9 @@ private:
 ad9361_ctrl::sptr ad9361_ctrl::make_spi(
     ad9361_params::sptr client_settings,
     uhd::spi_iface::sptr spi_iface,
-    uint32_t slave_num
+    uint32_t slave_num,
+    const bool burst_writes
 ) {
-    boost::shared_ptr<ad9361_io_spi> spi_io_iface = boost::make_shared<ad9361_io_spi>(spi_iface, slave_num);
+    boost::shared_ptr<ad9361_io_spi> spi_io_iface = boost::make_shared<ad9361_io_spi>(spi_iface, slave_num, burst_writes);
     return sptr(new ad9361_ctrl_impl(client_settings, spi_io_iface));
 }
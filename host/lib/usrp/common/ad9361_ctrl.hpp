@@ -54,11 +54,17 @@ public:
 
     virtual ~ad9361_ctrl(void) {};
 
-    //! make a new codec control object
+    /*! make a new codec control object
+     *
+     * \param burst_writes set this if spi_iface supports 32-bit transfers, so
+     *                     that register tables are written two registers at
+     *                     a time
+     */
     static sptr make_spi(
         ad9361_params::sptr client_settings,
         uhd::spi_iface::sptr spi_iface,
-        uint32_t slave_num
+        uint32_t slave_num,
+        const bool burst_writes = false
     );
 
     virtual void set_timed_spi(uhd::spi_iface::sptr spi_iface, uint32_t slave_num) = 0;
@@ -122,6 +128,14 @@ public:
     //! tune the given frontend, return the exact value
     virtual double tune(const std::string &which, const double value) = 0;
 
+    /*! Tune the given frontend using a tune profile, return the exact value
+     *
+     * Retuning to a frequency that was previously tuned through the same
+     * profile skips the synthesizer calibrations, see
+     * ad9361_device_t::tune_with_profile().
+     */
+    virtual double tune_with_profile(const std::string &which, const size_t profile, const double value) = 0;
+
     //! set the DC offset for I and Q manually
     void set_dc_offset(const std::string &, const std::complex<double>)
     {
@@ -142,6 +156,11 @@ public:
     //! enable or disable the quadrature calibration
     virtual void set_iq_balance_auto(const std::string &which, const bool on) = 0;
 
+    /*! Set the temperature drift (in degrees C) up to which cached calibration
+     *  results are reused. A negative value disables the calibration cache.
+     */
+    virtual void set_cal_cache_temp_drift(const double max_temp_drift) = 0;
+
     //! get the current frequency for the given frontend
     virtual double get_freq(const std::string &which) = 0;
 
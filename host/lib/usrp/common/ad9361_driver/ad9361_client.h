@@ -19,6 +19,8 @@
 #define INCLUDED_AD9361_CLIENT_H
 
 #include <boost/shared_ptr.hpp>
+#include <utility>
+#include <vector>
 
 namespace uhd { namespace usrp {
 
@@ -76,8 +78,24 @@ public:
 
     virtual ~ad9361_io() {}
 
+    typedef std::vector< std::pair<uint32_t, uint8_t> > reg_writes_t;
+
     virtual uint8_t peek8(uint32_t reg) = 0;
     virtual void poke8(uint32_t reg, uint8_t val) = 0;
+
+    /*!
+     * Write a sequence of registers, in the given order.
+     *
+     * Implementations may combine a write with the next one into a single
+     * transaction if the next write goes to the register just below (the
+     * AD9361 decrements the address within a multi-byte transfer).
+     */
+    virtual void poke8_bulk(const reg_writes_t &writes)
+    {
+        for (size_t i = 0; i < writes.size(); i++) {
+            poke8(writes[i].first, writes[i].second);
+        }
+    }
 };
 
 
@@ -22,6 +22,7 @@
 #include "ad9361_device.h"
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <limits>
 #include <uhd/exception.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/msg.hpp>
@@ -101,6 +102,23 @@ const double ad9361_device_t::AD9361_RECOMMENDED_MAX_BANDWIDTH = 56e6;
 const double ad9361_device_t::DEFAULT_RX_FREQ = 800e6;
 const double ad9361_device_t::DEFAULT_TX_FREQ = 850e6;
 
+/* Calibration cache settings */
+const double ad9361_device_t::DEFAULT_CAL_CACHE_TEMP_DRIFT = 10.0; // deg C
+static const size_t MAX_CAL_CACHE_ENTRIES = 32;
+
+/* Tune profiles, the value is given in the class */
+const size_t ad9361_device_t::NUM_TUNE_PROFILES;
+
+/* Registers holding the results of the baseband filter calibrations. */
+static const size_t NUM_RX_BBF_CAL_REGS = 11;
+static const uint16_t RX_BBF_CAL_REGS[NUM_RX_BBF_CAL_REGS] = {
+    0x1e0, 0x1e1, 0x1e4, 0x1e5, 0x1e6, 0x1e7, 0x1e8, 0x1e9, 0x1ea, 0x1eb, 0x1ec
+};
+static const size_t NUM_TX_BBF_CAL_REGS = 8;
+static const uint16_t TX_BBF_CAL_REGS[NUM_TX_BBF_CAL_REGS] = {
+    0x0c2, 0x0c3, 0x0c4, 0x0c5, 0x0c6, 0x0c7, 0x0c8, 0x0c9
+};
+
 /* Program either the RX or TX FIR filter.
  *
  * The process is the same for both filters, but the function must be told
@@ -138,26 +156,24 @@ void ad9361_device_t::_program_fir_filter(direction_t direction, chain_t chain,
     _io_iface->poke8(base + 5, reg_numtaps | reg_chain | 0x02);
     boost::this_thread::sleep(boost::posix_time::milliseconds(1));
 
-    /* Zero the unused taps just in case they have stale data */
+    /* Zero the unused taps just in case they have stale data, then iterate
+     * through indirect programming of filter coeffs using ADI recomended
+     * procedure. The coefficient and address registers are only latched by
+     * the write bit, so they are written in descending order, which allows
+     * the IO interface to combine those writes. */
+    ad9361_io::reg_writes_t writes;
+    writes.reserve(128 * 6);
     int addr;
-    for (addr = num_taps; addr < 128; addr++) {
-        _io_iface->poke8(base + 0, addr);
-        _io_iface->poke8(base + 1, 0x0);
-        _io_iface->poke8(base + 2, 0x0);
-        _io_iface->poke8(base + 5, reg_numtaps | reg_chain | (1 << 1) | (1 << 2));
-        _io_iface->poke8(base + 4, 0x00);
-        _io_iface->poke8(base + 4, 0x00);
-    }
-
-    /* Iterate through indirect programming of filter coeffs using ADI recomended procedure */
-    for (addr = 0; addr < num_taps; addr++) {
-        _io_iface->poke8(base + 0, addr);
-        _io_iface->poke8(base + 1, (coeffs[addr]) & 0xff);
-        _io_iface->poke8(base + 2, (coeffs[addr] >> 8) & 0xff);
-        _io_iface->poke8(base + 5, reg_numtaps | reg_chain | (1 << 1) | (1 << 2));
-        _io_iface->poke8(base + 4, 0x00);
-        _io_iface->poke8(base + 4, 0x00);
+    for (addr = 0; addr < 128; addr++) {
+        const uint16_t coeff = (addr < num_taps) ? coeffs[addr] : 0;
+        writes.push_back(std::make_pair(uint32_t(base + 2), uint8_t((coeff >> 8) & 0xff)));
+        writes.push_back(std::make_pair(uint32_t(base + 1), uint8_t(coeff & 0xff)));
+        writes.push_back(std::make_pair(uint32_t(base + 0), uint8_t(addr)));
+        writes.push_back(std::make_pair(uint32_t(base + 5), uint8_t(reg_numtaps | reg_chain | (1 << 1) | (1 << 2))));
+        writes.push_back(std::make_pair(uint32_t(base + 4), uint8_t(0x00)));
+        writes.push_back(std::make_pair(uint32_t(base + 4), uint8_t(0x00)));
     }
+    _io_iface->poke8_bulk(writes);
 
     /* UG-671 states (page 25) (paraphrased and clarified):
      " After the table has been programmed, write to register BASE+5 with the write bit D2 cleared and D1 high.
@@ -246,6 +262,71 @@ void ad9361_device_t::_setup_tx_fir(size_t num_taps, int32_t interpolation)
  * Calibration functions
  ***********************************************************************/
 
+/* Read the die temperature for the calibration cache.
+ *
+ * Only temperature differences are used, so no offset is applied. Returns
+ * NaN if the sensor could not be read, which invalidates the cache entry. */
+double ad9361_device_t::_get_cal_temperature()
+{
+    try {
+        return _get_temperature(0.0);
+    } catch (const uhd::runtime_error &) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+bool ad9361_device_t::_cal_temperature_valid(const double cal_temp, const double temp)
+{
+    return std::abs(temp - cal_temp) <= _cal_cache_max_temp_drift;
+}
+
+/* Write back the stored results of a calibration.
+ *
+ * Returns false if there are no results for the current BBPLL rate and the
+ * given bandwidth, or if the temperature drifted too much since they were
+ * stored. */
+bool ad9361_device_t::_restore_cal(
+        const cal_type_t type, const double bbbw, const double temp,
+        const uint16_t *regs, const size_t num_regs)
+{
+    for (std::vector<cal_cache_entry_t>::iterator it = _cal_cache.begin(); it != _cal_cache.end(); ++it) {
+        if (it->type != type
+                or not freq_is_nearly_equal(it->bbpll_freq, _bbpll_freq)
+                or not freq_is_nearly_equal(it->bbbw, bbbw)) {
+            continue;
+        }
+        if (not _cal_temperature_valid(it->temp, temp)) {
+            /* Stale, the new results will be stored instead. */
+            _cal_cache.erase(it);
+            return false;
+        }
+        for (size_t i = 0; i < num_regs; i++) {
+            _io_iface->poke8(regs[i], it->values[i]);
+        }
+        return true;
+    }
+    return false;
+}
+
+/* Store the results of a calibration that just ran. */
+void ad9361_device_t::_store_cal(
+        const cal_type_t type, const double bbbw, const double temp,
+        const uint16_t *regs, const size_t num_regs)
+{
+    if (_cal_cache.size() >= MAX_CAL_CACHE_ENTRIES) {
+        _cal_cache.erase(_cal_cache.begin());
+    }
+    cal_cache_entry_t entry;
+    entry.type = type;
+    entry.bbpll_freq = _bbpll_freq;
+    entry.bbbw = bbbw;
+    entry.temp = temp;
+    for (size_t i = 0; i < num_regs; i++) {
+        entry.values.push_back(_io_iface->peek8(regs[i]));
+    }
+    _cal_cache.push_back(entry);
+}
+
 /* Calibrate and lock the BBPLL.
  *
  * This function should be called anytime the BBPLL is tuned. */
@@ -353,6 +434,18 @@ double ad9361_device_t::_calibrate_baseband_rx_analog_filter(double req_rfbw)
     _io_iface->poke8(0x1d5, 0x3f);
     _io_iface->poke8(0x1c0, 0x03);
 
+    /* Reuse stored results for this rate and bandwidth, if available. The
+     * tuners must be disabled while writing them back. */
+    const bool use_cal_cache = (_cal_cache_max_temp_drift >= 0);
+    const double cal_temp = use_cal_cache ? _get_cal_temperature() : 0.0;
+    if (use_cal_cache) {
+        _io_iface->poke8(0x1e2, 0x03);
+        _io_iface->poke8(0x1e3, 0x03);
+        if (_restore_cal(CAL_RX_BBF, bbbw, cal_temp, RX_BBF_CAL_REGS, NUM_RX_BBF_CAL_REGS)) {
+            return bbbw;
+        }
+    }
+
     /* Enable RX1 & RX2 filter tuners. */
     _io_iface->poke8(0x1e2, 0x02);
     _io_iface->poke8(0x1e3, 0x02);
@@ -373,6 +466,10 @@ double ad9361_device_t::_calibrate_baseband_rx_analog_filter(double req_rfbw)
     _io_iface->poke8(0x1e2, 0x03);
     _io_iface->poke8(0x1e3, 0x03);
 
+    if (use_cal_cache) {
+        _store_cal(CAL_RX_BBF, bbbw, cal_temp, RX_BBF_CAL_REGS, NUM_RX_BBF_CAL_REGS);
+    }
+
     return bbbw;
 }
 
@@ -410,6 +507,16 @@ double ad9361_device_t::_calibrate_baseband_tx_analog_filter(double req_rfbw)
     _io_iface->poke8(0x0d6, (txbbfdiv & 0x00FF));
     _io_iface->poke8(0x0d7, _regs.bbftune_mode);
 
+    /* Reuse stored results for this rate and bandwidth, if available. */
+    const bool use_cal_cache = (_cal_cache_max_temp_drift >= 0);
+    const double cal_temp = use_cal_cache ? _get_cal_temperature() : 0.0;
+    if (use_cal_cache) {
+        _io_iface->poke8(0x0ca, 0x26);
+        if (_restore_cal(CAL_TX_BBF, bbbw, cal_temp, TX_BBF_CAL_REGS, NUM_TX_BBF_CAL_REGS)) {
+            return bbbw;
+        }
+    }
+
     /* Enable the filter tuner. */
     _io_iface->poke8(0x0ca, 0x22);
 
@@ -429,6 +536,10 @@ double ad9361_device_t::_calibrate_baseband_tx_analog_filter(double req_rfbw)
     /* Disable the filter tuner. */
     _io_iface->poke8(0x0ca, 0x26);
 
+    if (use_cal_cache) {
+        _store_cal(CAL_TX_BBF, bbbw, cal_temp, TX_BBF_CAL_REGS, NUM_TX_BBF_CAL_REGS);
+    }
+
     return bbbw;
 }
 
@@ -780,6 +891,9 @@ void ad9361_device_t::_calibrate_rf_dc_offset()
     }
 
     _io_iface->poke8(0x18b, 0x8d); // Enable RF DC tracking
+
+    _rf_dc_cal_freq = _rx_freq;
+    _rf_dc_cal_temp = (_cal_cache_max_temp_drift >= 0) ? _get_cal_temperature() : 0.0;
 }
 
 void ad9361_device_t::_configure_bb_dc_tracking()
@@ -959,17 +1073,20 @@ void ad9361_device_t::_program_mixer_gm_subtable()
     /* Start the clock. */
     _io_iface->poke8(0x13f, 0x02);
 
-    /* Program the GM Sub-table. */
+    /* Program the GM Sub-table. The data and address registers are written
+     * in descending order, see _program_fir_filter(). */
+    ad9361_io::reg_writes_t writes;
     int i;
     for (i = 15; i >= 0; i--) {
-        _io_iface->poke8(0x138, i);
-        _io_iface->poke8(0x139, gain[(15 - i)]);
-        _io_iface->poke8(0x13A, 0x00);
-        _io_iface->poke8(0x13B, gm[(15 - i)]);
-        _io_iface->poke8(0x13F, 0x06);
-        _io_iface->poke8(0x13C, 0x00);
-        _io_iface->poke8(0x13C, 0x00);
+        writes.push_back(std::make_pair(uint32_t(0x13B), gm[(15 - i)]));
+        writes.push_back(std::make_pair(uint32_t(0x13A), uint8_t(0x00)));
+        writes.push_back(std::make_pair(uint32_t(0x139), gain[(15 - i)]));
+        writes.push_back(std::make_pair(uint32_t(0x138), uint8_t(i)));
+        writes.push_back(std::make_pair(uint32_t(0x13F), uint8_t(0x06)));
+        writes.push_back(std::make_pair(uint32_t(0x13C), uint8_t(0x00)));
+        writes.push_back(std::make_pair(uint32_t(0x13C), uint8_t(0x00)));
     }
+    _io_iface->poke8_bulk(writes);
 
     /* Clear write bit and stop clock. */
     _io_iface->poke8(0x13f, 0x02);
@@ -1011,28 +1128,22 @@ void ad9361_device_t::_program_gain_table() {
      * gain table clock. */
     _io_iface->poke8(0x137, 0x1A);
 
-    /* IT'S PROGRAMMING TIME. */
-    uint8_t index = 0;
-    for (; index < 77; index++) {
-        _io_iface->poke8(0x130, index);
-        _io_iface->poke8(0x131, gain_table[index][0]);
-        _io_iface->poke8(0x132, gain_table[index][1]);
-        _io_iface->poke8(0x133, gain_table[index][2]);
-        _io_iface->poke8(0x137, 0x1E);
-        _io_iface->poke8(0x134, 0x00);
-        _io_iface->poke8(0x134, 0x00);
-    }
-
-    /* Everything above the 77th index is zero. */
-    for (; index < 91; index++) {
-        _io_iface->poke8(0x130, index);
-        _io_iface->poke8(0x131, 0x00);
-        _io_iface->poke8(0x132, 0x00);
-        _io_iface->poke8(0x133, 0x00);
-        _io_iface->poke8(0x137, 0x1E);
-        _io_iface->poke8(0x134, 0x00);
-        _io_iface->poke8(0x134, 0x00);
-    }
+    /* IT'S PROGRAMMING TIME. Everything above the 77th index is zero. The
+     * data and address registers are written in descending order, see
+     * _program_fir_filter(). */
+    ad9361_io::reg_writes_t writes;
+    writes.reserve(91 * 7);
+    for (uint8_t index = 0; index < 91; index++) {
+        const bool in_table = (index < 77);
+        writes.push_back(std::make_pair(uint32_t(0x133), in_table ? gain_table[index][2] : uint8_t(0x00)));
+        writes.push_back(std::make_pair(uint32_t(0x132), in_table ? gain_table[index][1] : uint8_t(0x00)));
+        writes.push_back(std::make_pair(uint32_t(0x131), in_table ? gain_table[index][0] : uint8_t(0x00)));
+        writes.push_back(std::make_pair(uint32_t(0x130), index));
+        writes.push_back(std::make_pair(uint32_t(0x137), uint8_t(0x1E)));
+        writes.push_back(std::make_pair(uint32_t(0x134), uint8_t(0x00)));
+        writes.push_back(std::make_pair(uint32_t(0x134), uint8_t(0x00)));
+    }
+    _io_iface->poke8_bulk(writes);
 
     /* Clear the write bit and stop the gain clock. */
     _io_iface->poke8(0x137, 0x1A);
@@ -1097,20 +1208,89 @@ void ad9361_device_t::_setup_gain_control(bool agc)
     }
 }
 
-/* Setup the RX or TX synthesizers.
+/* RX synthesizer registers, in the order they are programmed. The matching
+ * TX synthesizer registers are located 0x40 higher. The last register
+ * (Nint[7:0]) has to be written last, it starts the VCO calibration for the
+ * new frequency. */
+static const size_t NUM_SYNTH_REGS = 16;
+static const uint16_t SYNTH_REGS[NUM_SYNTH_REGS] = {
+    0x23a, 0x239, 0x242, 0x238, 0x245, 0x251, 0x250, 0x23b,
+    0x23e, 0x23f, 0x240, 0x233, 0x234, 0x235, 0x232, 0x231
+};
+
+/* Calculate the RX or TX synthesizer settings for a frequency.
  *
- * This setup depends on a fixed look-up table, which is stored in an
- * included header file. The table is indexed based on the passed VCO rate.
- */
-void ad9361_device_t::_setup_synth(direction_t direction, double vcorate)
+ * The synthesizer setup depends on a fixed look-up table, which is stored in
+ * an included header file. The table is indexed based on the VCO rate.
+ * Nothing is written to the chip here, see _program_synth(). */
+ad9361_device_t::synth_settings_t ad9361_device_t::_calc_synth_settings(direction_t direction, const double value)
 {
+    /* The RFPLL runs from 6 GHz - 12 GHz */
+    const double fref = 80e6;
+    const int modulus = 8388593;
+    const double vcomax = 12e9;
+    const double vcomin = 6e9;
+    double vcorate;
+    int vcodiv;
+
+    /* Iterate over VCO dividers until appropriate divider is found. */
+    int i;
+    for (i = 0; i <= 6; i++) {
+        vcodiv = 2 << i;
+        vcorate = value * vcodiv;
+        if (vcorate >= vcomin && vcorate <= vcomax)
+            break;
+    }
+    if (i == 7)
+        throw uhd::runtime_error("[ad9361_device_t] RFVCO can't find valid VCO rate!");
+
+    int nint = static_cast<int>(vcorate / fref);
+    int nfrac = static_cast<int>(((vcorate / fref) - nint) * modulus);
+
+    double actual_vcorate = fref * (nint + (double) (nfrac) / modulus);
+
+    synth_settings_t settings;
+    settings.req_freq = value;
+    settings.actual_lo = actual_vcorate / vcodiv;
+    settings.vcodiv = i & 0x0F;
+
+    /* Set band-specific settings. */
+    if (direction == RX) {
+        if (value < _client_params->get_band_edge(AD9361_RX_BAND0)) {
+            settings.inputsel = 0x30; // Port C, balanced
+        } else if ((value
+                >= _client_params->get_band_edge(AD9361_RX_BAND0))
+                && (value
+                        < _client_params->get_band_edge(AD9361_RX_BAND1))) {
+            settings.inputsel = 0x0C; // Port B, balanced
+        } else if ((value
+                >= _client_params->get_band_edge(AD9361_RX_BAND1))
+                && (value <= 6e9)) {
+            settings.inputsel = 0x03; // Port A, balanced
+        } else {
+            throw uhd::runtime_error("[ad9361_device_t] [_calc_synth_settings] INVALID_CODE_PATH");
+        }
+    } else if (direction == TX) {
+        if (value < _client_params->get_band_edge(AD9361_TX_BAND0)) {
+            settings.inputsel = 0x40;
+        } else if ((value
+                >= _client_params->get_band_edge(AD9361_TX_BAND0))
+                && (value <= 6e9)) {
+            settings.inputsel = 0x00;
+        } else {
+            throw uhd::runtime_error("[ad9361_device_t] [_calc_synth_settings] INVALID_CODE_PATH");
+        }
+    } else {
+        throw uhd::runtime_error("[ad9361_device_t] [_calc_synth_settings] INVALID_CODE_PATH");
+    }
+
     /* The vcorates in the vco_index array represent lower boundaries for
      * rates. Once we find a match, we use that index to look-up the rest of
      * the register values in the LUT. */
     int vcoindex = 0;
-    for (size_t i = 0; i < 53; i++) {
-        vcoindex = i;
-        if (vcorate > vco_index[i]) {
+    for (size_t j = 0; j < 53; j++) {
+        vcoindex = j;
+        if (actual_vcorate > vco_index[j]) {
             break;
         }
     }
@@ -1131,36 +1311,67 @@ void ad9361_device_t::_setup_synth(direction_t direction, double vcorate)
     uint8_t loop_filter_c3 = synth_cal_lut[vcoindex][10];
     uint8_t loop_filter_r3 = synth_cal_lut[vcoindex][11];
 
-    /* ... annnd program! */
+    /* ... annnd store them in SYNTH_REGS order. */
+    settings.regs[0] = 0x40 | vco_output_level;
+    settings.regs[1] = 0xC0 | vco_varactor;
+    settings.regs[2] = vco_bias_ref | (vco_bias_tcf << 3);
+    settings.regs[3] = (vco_cal_offset << 3);
+    settings.regs[4] = 0x00;
+    settings.regs[5] = vco_varactor_ref;
+    settings.regs[6] = 0x70;
+    settings.regs[7] = 0x80 | charge_pump_curr;
+    settings.regs[8] = loop_filter_c1 | (loop_filter_c2 << 4);
+    settings.regs[9] = loop_filter_c3 | (loop_filter_r1 << 4);
+    settings.regs[10] = loop_filter_r3;
+    settings.regs[11] = nfrac & 0xFF;
+    settings.regs[12] = (nfrac >> 8) & 0xFF;
+    settings.regs[13] = (nfrac >> 16) & 0xFF;
+    settings.regs[14] = (nint >> 8) & 0xFF;
+    settings.regs[15] = nint & 0xFF;
+    settings.valid = true;
+
+    return settings;
+}
+
+/* Program the RX or TX synthesizer.
+ *
+ * If only_changed is set, only the registers which differ from the settings
+ * currently in the chip are written (plus Nint[7:0], which triggers the
+ * retune). This does not wait for the PLL to lock. */
+void ad9361_device_t::_program_synth(direction_t direction, const synth_settings_t &settings, const bool only_changed)
+{
+    synth_settings_t &curr = (direction == RX) ? _rx_synth : _tx_synth;
+    const bool skip_unchanged = only_changed and curr.valid;
+    const uint16_t reg_offset = (direction == RX) ? 0x000 : 0x040;
+
+    const uint8_t old_inputsel = _regs.inputsel;
+    const uint8_t old_vcodivs = _regs.vcodivs;
     if (direction == RX) {
-        _io_iface->poke8(0x23a, 0x40 | vco_output_level);
-        _io_iface->poke8(0x239, 0xC0 | vco_varactor);
-        _io_iface->poke8(0x242, vco_bias_ref | (vco_bias_tcf << 3));
-        _io_iface->poke8(0x238, (vco_cal_offset << 3));
-        _io_iface->poke8(0x245, 0x00);
-        _io_iface->poke8(0x251, vco_varactor_ref);
-        _io_iface->poke8(0x250, 0x70);
-        _io_iface->poke8(0x23b, 0x80 | charge_pump_curr);
-        _io_iface->poke8(0x23e, loop_filter_c1 | (loop_filter_c2 << 4));
-        _io_iface->poke8(0x23f, loop_filter_c3 | (loop_filter_r1 << 4));
-        _io_iface->poke8(0x240, loop_filter_r3);
-    } else if (direction == TX) {
-        _io_iface->poke8(0x27a, 0x40 | vco_output_level);
-        _io_iface->poke8(0x279, 0xC0 | vco_varactor);
-        _io_iface->poke8(0x282, vco_bias_ref | (vco_bias_tcf << 3));
-        _io_iface->poke8(0x278, (vco_cal_offset << 3));
-        _io_iface->poke8(0x285, 0x00);
-        _io_iface->poke8(0x291, vco_varactor_ref);
-        _io_iface->poke8(0x290, 0x70);
-        _io_iface->poke8(0x27b, 0x80 | charge_pump_curr);
-        _io_iface->poke8(0x27e, loop_filter_c1 | (loop_filter_c2 << 4));
-        _io_iface->poke8(0x27f, loop_filter_c3 | (loop_filter_r1 << 4));
-        _io_iface->poke8(0x280, loop_filter_r3);
+        _regs.inputsel = (_regs.inputsel & 0xC0) | settings.inputsel;
+        _regs.vcodivs = (_regs.vcodivs & 0xF0) | settings.vcodiv;
     } else {
-        throw uhd::runtime_error("[ad9361_device_t] [_setup_synth] INVALID_CODE_PATH");
+        _regs.inputsel = (_regs.inputsel & 0xBF) | settings.inputsel;
+        _regs.vcodivs = (_regs.vcodivs & 0x0F) | (settings.vcodiv << 4);
+    }
+
+    if (not skip_unchanged or _regs.inputsel != old_inputsel) {
+        _io_iface->poke8(0x004, _regs.inputsel);
     }
-}
 
+    for (size_t r = 0; r < NUM_SYNTH_REGS; r++) {
+        if (skip_unchanged and r != NUM_SYNTH_REGS - 1
+                and curr.regs[r] == settings.regs[r]) {
+            continue;
+        }
+        _io_iface->poke8(SYNTH_REGS[r] + reg_offset, settings.regs[r]);
+    }
+
+    if (not skip_unchanged or _regs.vcodivs != old_vcodivs) {
+        _io_iface->poke8(0x005, _regs.vcodivs);
+    }
+
+    curr = settings;
+}
 
 /* Tune the baseband VCO.
  *
@@ -1256,66 +1467,14 @@ void ad9361_device_t::_reprogram_gains()
  * tune the RX or TX VCO. */
 double ad9361_device_t::_tune_helper(direction_t direction, const double value)
 {
-    /* The RFPLL runs from 6 GHz - 12 GHz */
-    const double fref = 80e6;
-    const int modulus = 8388593;
-    const double vcomax = 12e9;
-    const double vcomin = 6e9;
-    double vcorate;
-    int vcodiv;
-
-    /* Iterate over VCO dividers until appropriate divider is found. */
-    int i;
-    for (i = 0; i <= 6; i++) {
-        vcodiv = 2 << i;
-        vcorate = value * vcodiv;
-        if (vcorate >= vcomin && vcorate <= vcomax)
-            break;
-    }
-    if (i == 7)
-        throw uhd::runtime_error("[ad9361_device_t] RFVCO can't find valid VCO rate!");
-
-    int nint = static_cast<int>(vcorate / fref);
-    int nfrac = static_cast<int>(((vcorate / fref) - nint) * modulus);
-
-    double actual_vcorate = fref * (nint + (double) (nfrac) / modulus);
-    double actual_lo = actual_vcorate / vcodiv;
+    const synth_settings_t settings = _calc_synth_settings(direction, value);
 
     if (direction == RX) {
 
         _req_rx_freq = value;
 
-        /* Set band-specific settings. */
-        if (value < _client_params->get_band_edge(AD9361_RX_BAND0)) {
-            _regs.inputsel = (_regs.inputsel & 0xC0) | 0x30; // Port C, balanced
-        } else if ((value
-                >= _client_params->get_band_edge(AD9361_RX_BAND0))
-                && (value
-                        < _client_params->get_band_edge(AD9361_RX_BAND1))) {
-            _regs.inputsel = (_regs.inputsel & 0xC0) | 0x0C; // Port B, balanced
-        } else if ((value
-                >= _client_params->get_band_edge(AD9361_RX_BAND1))
-                && (value <= 6e9)) {
-            _regs.inputsel = (_regs.inputsel & 0xC0) | 0x03; // Port A, balanced
-        } else {
-            throw uhd::runtime_error("[ad9361_device_t] [_tune_helper] INVALID_CODE_PATH");
-        }
-
-        _io_iface->poke8(0x004, _regs.inputsel);
-
-        /* Store vcodiv setting. */
-        _regs.vcodivs = (_regs.vcodivs & 0xF0) | (i & 0x0F);
-
-        /* Setup the synthesizer. */
-        _setup_synth(RX, actual_vcorate);
-
         /* Tune!!!! */
-        _io_iface->poke8(0x233, nfrac & 0xFF);
-        _io_iface->poke8(0x234, (nfrac >> 8) & 0xFF);
-        _io_iface->poke8(0x235, (nfrac >> 16) & 0xFF);
-        _io_iface->poke8(0x232, (nint >> 8) & 0xFF);
-        _io_iface->poke8(0x231, nint & 0xFF);
-        _io_iface->poke8(0x005, _regs.vcodivs);
+        _program_synth(RX, settings, false);
 
         /* Lock the PLL! */
         boost::this_thread::sleep(boost::posix_time::milliseconds(2));
@@ -1323,40 +1482,16 @@ double ad9361_device_t::_tune_helper(direction_t direction, const double value)
             throw uhd::runtime_error("[ad9361_device_t] RX PLL NOT LOCKED");
         }
 
-        _rx_freq = actual_lo;
+        _rx_freq = settings.actual_lo;
 
-        return actual_lo;
+        return settings.actual_lo;
 
     } else {
 
         _req_tx_freq = value;
 
-        /* Set band-specific settings. */
-        if (value < _client_params->get_band_edge(AD9361_TX_BAND0)) {
-            _regs.inputsel = _regs.inputsel | 0x40;
-        } else if ((value
-                >= _client_params->get_band_edge(AD9361_TX_BAND0))
-                && (value <= 6e9)) {
-            _regs.inputsel = _regs.inputsel & 0xBF;
-        } else {
-            throw uhd::runtime_error("[ad9361_device_t] [_tune_helper] INVALID_CODE_PATH");
-        }
-
-        _io_iface->poke8(0x004, _regs.inputsel);
-
-        /* Store vcodiv setting. */
-        _regs.vcodivs = (_regs.vcodivs & 0x0F) | ((i & 0x0F) << 4);
-
-        /* Setup the synthesizer. */
-        _setup_synth(TX, actual_vcorate);
-
         /* Tune it, homey. */
-        _io_iface->poke8(0x273, nfrac & 0xFF);
-        _io_iface->poke8(0x274, (nfrac >> 8) & 0xFF);
-        _io_iface->poke8(0x275, (nfrac >> 16) & 0xFF);
-        _io_iface->poke8(0x272, (nint >> 8) & 0xFF);
-        _io_iface->poke8(0x271, nint & 0xFF);
-        _io_iface->poke8(0x005, _regs.vcodivs);
+        _program_synth(TX, settings, false);
 
         /* Lock the PLL! */
         boost::this_thread::sleep(boost::posix_time::milliseconds(2));
@@ -1364,9 +1499,9 @@ double ad9361_device_t::_tune_helper(direction_t direction, const double value)
             throw uhd::runtime_error("[ad9361_device_t] TX PLL NOT LOCKED");
         }
 
-        _tx_freq = actual_lo;
+        _tx_freq = settings.actual_lo;
 
-        return actual_lo;
+        return settings.actual_lo;
     }
 }
 
@@ -1543,6 +1678,15 @@ void ad9361_device_t::initialize()
     _adcclock_freq = 0.0;
     _rx_bbf_tunediv = 0;
     _curr_gain_table = 0;
+    _rx_synth = synth_settings_t();
+    _tx_synth = synth_settings_t();
+    _cal_cache.clear();
+    _rf_dc_cal_freq = 0.0;
+    _rf_dc_cal_temp = 0.0;
+    for (size_t i = 0; i < NUM_TUNE_PROFILES; i++) {
+        _rx_tune_profiles[i] = synth_settings_t();
+        _tx_tune_profiles[i] = synth_settings_t();
+    }
     _rx1_gain = 0;
     _rx2_gain = 0;
     _tx1_gain = 0;
@@ -1864,7 +2008,15 @@ double ad9361_device_t::set_clock_rate(const double req_rate)
     _setup_adc();
 
     _calibrate_baseband_dc_offset();
-    _calibrate_rf_dc_offset();
+    /* The RF DC offset correction does not depend on the rate, so keep it if
+     * the RX LO and the temperature did not change since it was measured. */
+    if (_cal_cache_max_temp_drift >= 0
+            and freq_is_nearly_equal(_rx_freq, _rf_dc_cal_freq)
+            and _cal_temperature_valid(_rf_dc_cal_temp, _get_cal_temperature())) {
+        _io_iface->poke8(0x18b, 0x8d); // Enable RF DC tracking
+    } else {
+        _calibrate_rf_dc_offset();
+    }
     _calibrate_rx_quadrature();
 
     /*
@@ -2071,6 +2223,77 @@ double ad9361_device_t::tune(direction_t direction, const double value)
     return tune_freq;
 }
 
+/* Tune the RX or TX frequency using a tune profile.
+ *
+ * A profile stores the synthesizer settings of the last frequency it was used
+ * for. Returning to that frequency only rewrites the synthesizer registers
+ * which differ, and skips the PLL lock wait and the calibrations. */
+double ad9361_device_t::tune_with_profile(direction_t direction, const size_t profile, const double value)
+{
+    boost::lock_guard<boost::recursive_mutex> lock(_mutex);
+
+    if (profile >= NUM_TUNE_PROFILES) {
+        throw uhd::value_error(str(
+            boost::format("[ad9361_device_t] Invalid tune profile %d (must be less than %d)")
+            % profile % NUM_TUNE_PROFILES
+        ));
+    }
+    if (direction != RX and direction != TX) {
+        throw uhd::runtime_error("[ad9361_device_t] [tune_with_profile] INVALID_CODE_PATH");
+    }
+
+    synth_settings_t &entry = (direction == RX) ? _rx_tune_profiles[profile] : _tx_tune_profiles[profile];
+
+    /* Profile miss: do a regular tune and remember the settings. */
+    if (not entry.valid or not freq_is_nearly_equal(value, entry.req_freq)) {
+        const double tune_freq = tune(direction, value);
+        entry = (direction == RX) ? _rx_synth : _tx_synth;
+        return tune_freq;
+    }
+
+    if (direction == RX and freq_is_nearly_equal(value, _req_rx_freq)) {
+        return _rx_freq;
+    }
+    if (direction == TX and freq_is_nearly_equal(value, _req_tx_freq)) {
+        return _tx_freq;
+    }
+
+    int not_in_alert = 0;
+    if ((_io_iface->peek8(0x017) & 0x0F) != 5) {
+        not_in_alert = 1;
+        _io_iface->poke8(0x014, 0x01);
+    }
+
+    _program_synth(direction, entry, true);
+
+    if (direction == RX) {
+        _req_rx_freq = entry.req_freq;
+        _rx_freq = entry.actual_lo;
+        /* Gain indices only change with the gain table. */
+        const uint8_t last_gain_table = _curr_gain_table;
+        _program_gain_table();
+        if (_curr_gain_table != last_gain_table) {
+            _reprogram_gains();
+        }
+    } else {
+        _req_tx_freq = entry.req_freq;
+        _tx_freq = entry.actual_lo;
+    }
+
+    if (not_in_alert) {
+        _io_iface->poke8(0x014, 0x21);
+    }
+
+    return entry.actual_lo;
+}
+
+void ad9361_device_t::set_cal_cache_temp_drift(const double max_temp_drift)
+{
+    boost::lock_guard<boost::recursive_mutex> lock(_mutex);
+    _cal_cache_max_temp_drift = max_temp_drift;
+    _cal_cache.clear();
+}
+
 /* Get the current RX or TX frequency. */
 double ad9361_device_t::get_freq(direction_t direction)
 {
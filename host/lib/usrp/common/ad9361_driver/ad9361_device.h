@@ -47,7 +47,9 @@ public:
         _tfir_factor(0), _rfir_factor(0),
         _rx1_agc_mode(GAIN_MODE_MANUAL), _rx2_agc_mode(GAIN_MODE_MANUAL),
         _rx1_agc_enable(false), _rx2_agc_enable(false),
-        _use_dc_offset_tracking(false), _use_iq_balance_tracking(false)
+        _use_dc_offset_tracking(false), _use_iq_balance_tracking(false),
+        _cal_cache_max_temp_drift(DEFAULT_CAL_CACHE_TEMP_DRIFT),
+        _rf_dc_cal_freq(0.0), _rf_dc_cal_temp(0.0)
     {
 
         /*
@@ -112,6 +114,16 @@ public:
      * After tuning, it runs any appropriate calibrations. */
     double tune(direction_t direction, const double value);
 
+    /* Tune the RX or TX frequency using one of the tune profiles.
+     *
+     * The first time a profile is used for a frequency, this does a regular
+     * tune() and stores the resulting synthesizer settings in the profile.
+     * Afterwards, tuning back to that frequency through the same profile only
+     * rewrites the synthesizer registers that differ from the current
+     * settings. It does not run the calibrations nor wait for the PLL to
+     * lock. */
+    double tune_with_profile(direction_t direction, const size_t profile, const double value);
+
     /* Get the current RX or TX frequency. */
     double get_freq(direction_t direction);
 
@@ -140,6 +152,16 @@ public:
      */
     double get_average_temperature(const double cal_offset = -30.0, const size_t num_samples = 3);
 
+    /* Configure the calibration cache.
+     *
+     * The results of the baseband filter calibrations are stored, and written
+     * back instead of recalibrating when the same BBPLL rate and bandwidth are
+     * used again. set_clock_rate() also keeps the RF DC offset calibration if
+     * the RX LO did not change. Stored results are only used while the die
+     * temperature is within max_temp_drift degrees C of the temperature they
+     * were measured at. A negative value disables the cache. */
+    void set_cal_cache_temp_drift(const double max_temp_drift);
+
     /* Turn on/off AD9361's RX DC offset correction */
     void set_dc_offset_auto(direction_t direction, const bool on);
 
@@ -173,6 +195,8 @@ public:
     static const double AD9361_RECOMMENDED_MAX_BANDWIDTH;
     static const double DEFAULT_RX_FREQ;
     static const double DEFAULT_TX_FREQ;
+    static const double DEFAULT_CAL_CACHE_TEMP_DRIFT;
+    static const size_t NUM_TUNE_PROFILES = 8;
 
 private:    //Methods
     void _program_fir_filter(direction_t direction, int num_taps, uint16_t *coeffs);
@@ -196,7 +220,8 @@ private:    //Methods
     void _program_mixer_gm_subtable();
     void _program_gain_table();
     void _setup_gain_control(bool use_agc);
-    void _setup_synth(direction_t direction, double vcorate);
+    double _get_cal_temperature();
+    bool _cal_temperature_valid(const double cal_temp, const double temp);
     double _tune_bbvco(const double rate);
     void _reprogram_gains();
     double _tune_helper(direction_t direction, const double value);
@@ -235,6 +260,41 @@ private:    //Members
         uint8_t bbftune_mode;
     };
 
+    //! The register values that tune one RF synthesizer (RX or TX)
+    struct synth_settings_t
+    {
+        synth_settings_t(): req_freq(0.0), actual_lo(0.0), inputsel(0), vcodiv(0), valid(false) {}
+        double  req_freq;
+        double  actual_lo;
+        //! Band select bits of the input select register (0x004)
+        uint8_t inputsel;
+        //! VCO divider, as written to the VCO divider register (0x005)
+        uint8_t vcodiv;
+        //! Values for the SYNTH_REGS registers, in programming order
+        uint8_t regs[16];
+        bool    valid;
+    };
+
+    synth_settings_t _calc_synth_settings(direction_t direction, const double value);
+    void _program_synth(direction_t direction, const synth_settings_t &settings, const bool only_changed);
+
+    enum cal_type_t { CAL_RX_BBF, CAL_TX_BBF };
+
+    //! Stored calibration results, see set_cal_cache_temp_drift()
+    struct cal_cache_entry_t
+    {
+        cal_type_t              type;
+        double                  bbpll_freq;
+        double                  bbbw;
+        double                  temp;
+        std::vector<uint8_t>    values;
+    };
+
+    bool _restore_cal(const cal_type_t type, const double bbbw, const double temp,
+                      const uint16_t *regs, const size_t num_regs);
+    void _store_cal(const cal_type_t type, const double bbbw, const double temp,
+                    const uint16_t *regs, const size_t num_regs);
+
     struct filter_query_helper
     {
         filter_query_helper(
@@ -277,10 +337,17 @@ private:    //Members
     bool                _rx1_agc_enable, _rx2_agc_enable;
     //Register soft-copies
     chip_regs_t         _regs;
+    synth_settings_t    _rx_synth, _tx_synth;
+    synth_settings_t    _rx_tune_profiles[NUM_TUNE_PROFILES];
+    synth_settings_t    _tx_tune_profiles[NUM_TUNE_PROFILES];
     //Synchronization
     boost::recursive_mutex  _mutex;
     bool _use_dc_offset_tracking;
     bool _use_iq_balance_tracking;
+    //Calibration cache
+    std::vector<cal_cache_entry_t> _cal_cache;
+    double              _cal_cache_max_temp_drift;
+    double              _rf_dc_cal_freq, _rf_dc_cal_temp;
 };
 
 }}  //namespace
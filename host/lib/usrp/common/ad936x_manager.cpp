@@ -17,6 +17,8 @@
 
 #include "ad936x_manager.hpp"
 #include <uhd/utils/msg.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <uhd/types/dict.hpp>
 #include <boost/foreach.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/thread/thread.hpp>
@@ -248,7 +250,11 @@ class ad936x_manager_impl : public ad936x_manager
         ;
         subtree->create<double>("freq/value")
             .set_publisher(boost::bind(&ad9361_ctrl::get_freq, _codec_ctrl, key))
-            .set_coercer(boost::bind(&ad9361_ctrl::tune, _codec_ctrl, key, _1))
+            .set_coercer(boost::bind(&ad936x_manager_impl::_tune, this, key, _1))
+        ;
+        subtree->create<device_addr_t>("tune_args")
+            .add_coerced_subscriber(boost::bind(&ad936x_manager_impl::_set_tune_args, this, key, _1))
+            .set(device_addr_t())
         ;
 
         // Frontend corrections
@@ -286,9 +292,27 @@ class ad936x_manager_impl : public ad936x_manager
     }
 
   private:
+    void _set_tune_args(const std::string &key, const device_addr_t &tune_args)
+    {
+        _tune_args[key] = tune_args;
+    }
+
+    //! Tune a frontend, through a tune profile if the tune args ask for one
+    double _tune(const std::string &key, const double freq)
+    {
+        if (_tune_args.has_key(key) and _tune_args[key].has_key("tune_profile")) {
+            const size_t profile = _tune_args[key].cast<size_t>("tune_profile", 0);
+            return _codec_ctrl->tune_with_profile(key, profile, freq);
+        }
+        return _codec_ctrl->tune(key, freq);
+    }
+
     //! Store a pointer to an actual AD936x control object
     ad9361_ctrl::sptr _codec_ctrl;
 
+    //! Current tune args for every frontend (RX1, TX1, ...)
+    uhd::dict<std::string, device_addr_t> _tune_args;
+
     //! Do we have 1 or 2 frontends?
     const size_t _n_frontends;
 
@@ -20,77 +20,144 @@
 #include <uhd/utils/paths.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/csv.hpp>
-#include <uhd/types/dict.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/foreach.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
 #include <cstdio>
 #include <complex>
 #include <fstream>
+#include <map>
 
 namespace fs = boost::filesystem;
 
-boost::mutex corrections_mutex;
-
 /***********************************************************************
- * Helper routines
+ * FE correction table
  **********************************************************************/
-static double linear_interp(double x, double x0, double y0, double x1, double y1){
-    return y0 + (x - x0)*(y1 - y0)/(x1 - x0);
-}
+/*!
+ * The corrections of one calibration file, sorted by LO frequency,
+ * with the slope of each segment between two points precomputed.
+ * A table is never changed after it is loaded, so it can be read
+ * without a lock.
+ */
+class fe_cal_table_t{
+public:
+    typedef boost::shared_ptr<const fe_cal_table_t> sptr;
 
-/***********************************************************************
- * FE apply corrections implementation
- **********************************************************************/
-struct fe_cal_t{
-    double lo_freq;
-    double iq_corr_real;
-    double iq_corr_imag;
-};
+    fe_cal_table_t(std::vector<std::pair<double, std::complex<double> > > points){
+        if (points.empty()) throw uhd::runtime_error("empty calibration table");
+        std::sort(points.begin(), points.end(), point_comp);
+        for (size_t i = 0; i < points.size(); i++){
+            _freqs.push_back(points[i].first);
+            _corrs.push_back(points[i].second);
+        }
+        for (size_t i = 0; i + 1 < points.size(); i++){
+            const double df = _freqs[i+1] - _freqs[i];
+            _slopes.push_back((df > 0.0)? (_corrs[i+1] - _corrs[i])/df : std::complex<double>(0.0));
+        }
+    }
 
-static bool fe_cal_comp(fe_cal_t a, fe_cal_t b){
-    return (a.lo_freq < b.lo_freq);
-}
+    /*!
+     * Get the correction at an LO frequency: interpolated between the
+     * two nearest points, or the first or last one outside the table.
+     */
+    std::complex<double> get_correction(const double lo_freq) const{
+        if (lo_freq <= _freqs.front()) return _corrs.front();
+        if (lo_freq >= _freqs.back()) return _corrs.back();
+        const size_t i = (std::upper_bound(_freqs.begin(), _freqs.end(), lo_freq) - _freqs.begin()) - 1;
+        return _corrs[i] + _slopes[i]*(lo_freq - _freqs[i]);
+    }
 
-static uhd::dict<std::string, std::vector<fe_cal_t> > fe_cal_cache;
+private:
+    static bool point_comp(
+        const std::pair<double, std::complex<double> > &a,
+        const std::pair<double, std::complex<double> > &b
+    ){
+        return a.first < b.first;
+    }
 
-static bool is_same_freq(const double f1, const double f2)
-{
-    const double epsilon = 0.1;
-    return ((f1 - epsilon) < f2 and (f1 + epsilon) > f2);
-}
+    std::vector<double> _freqs;
+    std::vector<std::complex<double> > _corrs;
+    std::vector<std::complex<double> > _slopes;
+};
 
-static std::complex<double> get_fe_correction(
-    const std::string &key, const double lo_freq
-){
-    const std::vector<fe_cal_t> &datas = fe_cal_cache[key];
-    if (datas.empty()) throw uhd::runtime_error("empty calibration table " + key);
-
-    //search for lo freq
-    size_t lo_index = 0;
-    size_t hi_index = datas.size()-1;
-    for (size_t i = 0; i < datas.size(); i++){
-        if (is_same_freq(datas[i].lo_freq, lo_freq))
-        {
-            hi_index = i;
-            lo_index = i;
-            break;
+static fe_cal_table_t::sptr load_fe_cal_table(const fs::path &cal_data_path){
+    if (not fs::exists(cal_data_path)) return fe_cal_table_t::sptr();
+
+    std::ifstream cal_data(cal_data_path.string().c_str());
+    const uhd::csv::rows_type rows = uhd::csv::to_rows(cal_data);
+
+    bool read_data = false, skip_next = false;;
+    std::vector<std::pair<double, std::complex<double> > > points;
+    BOOST_FOREACH(const uhd::csv::row_type &row, rows){
+        if (not read_data and not row.empty() and row[0] == "DATA STARTS HERE"){
+            read_data = true;
+            skip_next = true;
+            continue;
         }
-        if (datas[i].lo_freq > lo_freq){
-            hi_index = i;
-            break;
+        if (not read_data) continue;
+        if (skip_next){
+            skip_next = false;
+            continue;
         }
-        lo_index = i;
+        double lo_freq = 0.0, iq_corr_real = 0.0, iq_corr_imag = 0.0;
+        std::sscanf(row[0].c_str(), "%lf" , &lo_freq);
+        std::sscanf(row[1].c_str(), "%lf" , &iq_corr_real);
+        std::sscanf(row[2].c_str(), "%lf" , &iq_corr_imag);
+        points.push_back(std::make_pair(lo_freq, std::complex<double>(iq_corr_real, iq_corr_imag)));
     }
+    if (points.empty()) throw uhd::runtime_error("empty calibration table " + cal_data_path.string());
+
+    fe_cal_table_t::sptr table(new fe_cal_table_t(points));
+    UHD_MSG(status) << "Loaded " << cal_data_path.string() << std::endl;
+    return table;
+}
+
+/***********************************************************************
+ * FE apply corrections implementation
+ **********************************************************************/
+//! The tables by calibration file path, NULL if there is no such file
+typedef std::map<std::string, fe_cal_table_t::sptr> fe_cal_cache_t;
 
-    if (lo_index == 0) return std::complex<double>(datas[lo_index].iq_corr_real, datas[lo_index].iq_corr_imag);
-    if (hi_index == lo_index) return std::complex<double>(datas[hi_index].iq_corr_real, datas[hi_index].iq_corr_imag);
+/*!
+ * The published cache, which is never changed: loading a table
+ * publishes a copy with the new table, so a lookup is one atomic
+ * load and needs no lock. The copies are few and small, and the
+ * replaced ones are kept for the readers that may still use them.
+ */
+static boost::atomic<const fe_cal_cache_t *> fe_cal_cache(NULL);
+static std::vector<boost::shared_ptr<const fe_cal_cache_t> > fe_cal_caches;
+//! Serializes the loads of tables
+static boost::mutex fe_cal_cache_mutex;
 
-    //interpolation time
-    return std::complex<double>(
-        linear_interp(lo_freq, datas[lo_index].lo_freq, datas[lo_index].iq_corr_real, datas[hi_index].lo_freq, datas[hi_index].iq_corr_real),
-        linear_interp(lo_freq, datas[lo_index].lo_freq, datas[lo_index].iq_corr_imag, datas[hi_index].lo_freq, datas[hi_index].iq_corr_imag)
-    );
+/*!
+ * Get the table of a calibration file, which is loaded on first use.
+ * Whether the file exists is only checked then, so a calibration file
+ * written later is used from the next session on.
+ */
+static fe_cal_table_t::sptr get_fe_cal_table(const std::string &file_prefix, const std::string &serial){
+    const std::string key = file_prefix + serial;
+    const fe_cal_cache_t *cache = fe_cal_cache.load(boost::memory_order_acquire);
+    if (cache != NULL){
+        fe_cal_cache_t::const_iterator it = cache->find(key);
+        if (it != cache->end()) return it->second;
+    }
+    boost::mutex::scoped_lock lock(fe_cal_cache_mutex);
+    cache = fe_cal_cache.load(boost::memory_order_relaxed);
+    if (cache != NULL){
+        fe_cal_cache_t::const_iterator it = cache->find(key);
+        if (it != cache->end()) return it->second;
+    }
+    const fs::path cal_data_path = fs::path(uhd::get_app_path()) / ".uhd" / "cal" / (key + ".csv");
+    const fe_cal_table_t::sptr table = load_fe_cal_table(cal_data_path);
+    boost::shared_ptr<fe_cal_cache_t> new_cache(
+        (cache != NULL)? new fe_cal_cache_t(*cache) : new fe_cal_cache_t());
+    (*new_cache)[key] = table;
+    fe_cal_caches.push_back(new_cache);
+    fe_cal_cache.store(new_cache.get(), boost::memory_order_release);
+    return table;
 }
 
 static void apply_fe_corrections(
@@ -103,42 +170,11 @@ static void apply_fe_corrections(
     //extract eeprom serial
     const uhd::usrp::dboard_eeprom_t db_eeprom = sub_tree->access<uhd::usrp::dboard_eeprom_t>(db_path).get();
 
-    //make the calibration file path
-    const fs::path cal_data_path = fs::path(uhd::get_app_path()) / ".uhd" / "cal" / (file_prefix + db_eeprom.serial + ".csv");
-    if (not fs::exists(cal_data_path)) return;
-
-    //parse csv file or get from cache
-    if (not fe_cal_cache.has_key(cal_data_path.string())){
-        std::ifstream cal_data(cal_data_path.string().c_str());
-        const uhd::csv::rows_type rows = uhd::csv::to_rows(cal_data);
-
-        bool read_data = false, skip_next = false;;
-        std::vector<fe_cal_t> datas;
-        BOOST_FOREACH(const uhd::csv::row_type &row, rows){
-            if (not read_data and not row.empty() and row[0] == "DATA STARTS HERE"){
-                read_data = true;
-                skip_next = true;
-                continue;
-            }
-            if (not read_data) continue;
-            if (skip_next){
-                skip_next = false;
-                continue;
-            }
-            fe_cal_t data;
-            std::sscanf(row[0].c_str(), "%lf" , &data.lo_freq);
-            std::sscanf(row[1].c_str(), "%lf" , &data.iq_corr_real);
-            std::sscanf(row[2].c_str(), "%lf" , &data.iq_corr_imag);
-            datas.push_back(data);
-        }
-        std::sort(datas.begin(), datas.end(), fe_cal_comp);
-        fe_cal_cache[cal_data_path.string()] = datas;
-        UHD_MSG(status) << "Loaded " << cal_data_path.string() << std::endl;
-
-    }
+    const fe_cal_table_t::sptr table = get_fe_cal_table(file_prefix, db_eeprom.serial);
+    if (not table) return;
 
     sub_tree->access<std::complex<double> >(fe_path)
-        .set(get_fe_correction(cal_data_path.string(), lo_freq));
+        .set(table->get_correction(lo_freq));
 }
 
 /***********************************************************************
@@ -150,7 +186,6 @@ void uhd::usrp::apply_tx_fe_corrections( //overloading to work according to rfno
     const uhd::fs_path tx_fe_corr_path,
     const double lo_freq //actual lo freq
 ){
-    boost::mutex::scoped_lock l(corrections_mutex);
     try{
         apply_fe_corrections(
             sub_tree,
@@ -177,7 +212,6 @@ void uhd::usrp::apply_tx_fe_corrections(
     const std::string &slot, //name of dboard slot
     const double lo_freq //actual lo freq
 ){
-    boost::mutex::scoped_lock l(corrections_mutex);
     try{
         apply_fe_corrections(
             sub_tree,
@@ -205,7 +239,6 @@ void uhd::usrp::apply_rx_fe_corrections( //overloading to work according to rfno
     const uhd::fs_path rx_fe_corr_path,
     const double lo_freq //actual lo freq
 ){
-    boost::mutex::scoped_lock l(corrections_mutex);
     try{
         apply_fe_corrections(
             sub_tree,
@@ -225,7 +258,6 @@ void uhd::usrp::apply_rx_fe_corrections(
     const std::string &slot, //name of dboard slot
     const double lo_freq //actual lo freq
 ){
-    boost::mutex::scoped_lock l(corrections_mutex);
     try{
         apply_fe_corrections(
             sub_tree,
@@ -0,0 +1,154 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "async_msg_dispatcher.hpp"
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <boost/bind.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/weak_ptr.hpp>
+#include <exception>
+#include <map>
+
+using namespace uhd;
+using namespace uhd::usrp;
+
+/***********************************************************************
+ * Async metadata queue
+ **********************************************************************/
+async_md_queue::async_md_queue(const size_t capacity):
+    _queue(capacity),
+    _num_dropped(0),
+    _has_callback(false)
+{
+    /* NOP */
+}
+
+bool async_md_queue::push(const async_metadata_t &metadata)
+{
+    if (_has_callback.load(boost::memory_order_acquire)) {
+        boost::mutex::scoped_lock lock(_callback_mutex);
+        if (_callback) {
+            _callback(metadata);
+            return true;
+        }
+    }
+    if (_queue.push_with_haste(metadata)) return true;
+    _num_dropped++;
+    return false;
+}
+
+void async_md_queue::set_callback(const callback_type &callback)
+{
+    boost::mutex::scoped_lock lock(_callback_mutex);
+    _callback = callback;
+    _has_callback.store(bool(callback), boost::memory_order_release);
+}
+
+/***********************************************************************
+ * Async message dispatcher
+ **********************************************************************/
+//! The time in seconds to wait on all sources in one round of the task
+static const double SERVICE_ROUND_TIMEOUT = 0.1;
+
+async_msg_dispatcher::~async_msg_dispatcher(void){
+    /* NOP */
+}
+
+class async_msg_dispatcher_impl :
+    public async_msg_dispatcher,
+    public boost::enable_shared_from_this<async_msg_dispatcher_impl>
+{
+public:
+    async_msg_dispatcher_impl(void):
+        _next_source_id(0)
+    {
+        /* NOP */
+    }
+
+    ~async_msg_dispatcher_impl(void)
+    {
+        _task.reset();
+    }
+
+    source_handle add_source(const source_type &source)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        const size_t id = _next_source_id++;
+        _sources[id] = source;
+        if (not _task) {
+            _task = task::make(boost::bind(&async_msg_dispatcher_impl::service, this), "async_msg");
+        }
+        _cond.notify_one();
+        return source_handle(static_cast<void *>(NULL), boost::bind(
+            &async_msg_dispatcher_impl::remove_source,
+            boost::weak_ptr<async_msg_dispatcher_impl>(shared_from_this()), id
+        ));
+    }
+
+private:
+    typedef std::map<size_t, source_type> source_map_type;
+
+    static void remove_source(boost::weak_ptr<async_msg_dispatcher_impl> weak_self, const size_t id)
+    {
+        boost::shared_ptr<async_msg_dispatcher_impl> self = weak_self.lock();
+        if (not self) return;
+        //the task holds the lock while it calls the sources
+        boost::mutex::scoped_lock lock(self->_mutex);
+        self->_sources.erase(id);
+    }
+
+    /*!
+     * One round of the task:
+     * Wait on each source for its share of the round, and drain the
+     * messages that arrived meanwhile before moving on to the next one.
+     */
+    void service(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_sources.empty()) {
+            _cond.timed_wait(lock, boost::posix_time::microseconds(long(SERVICE_ROUND_TIMEOUT*1e6)));
+            return;
+        }
+        const double timeout = SERVICE_ROUND_TIMEOUT / _sources.size();
+        for (source_map_type::iterator it = _sources.begin(); it != _sources.end();) {
+            try {
+                if (it->second(timeout)) {
+                    while (it->second(0.0)) {};
+                }
+                ++it;
+            }
+            catch (const std::exception &e) {
+                UHD_MSG(error) << "Removing an async message source after an error: " << e.what() << std::endl;
+                _sources.erase(it++);
+            }
+        }
+        boost::this_thread::interruption_point();
+    }
+
+    boost::mutex _mutex;
+    boost::condition_variable _cond;
+    source_map_type _sources;
+    size_t _next_source_id;
+    task::sptr _task;
+};
+
+async_msg_dispatcher::sptr async_msg_dispatcher::make(void)
+{
+    return sptr(new async_msg_dispatcher_impl());
+}
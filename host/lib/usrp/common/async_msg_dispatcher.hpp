@@ -0,0 +1,124 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_USRP_COMMON_ASYNC_MSG_DISPATCHER_HPP
+#define INCLUDED_LIBUHD_USRP_COMMON_ASYNC_MSG_DISPATCHER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/transport/mpsc_bounded_buffer.hpp>
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+namespace uhd{ namespace usrp{
+
+    /*!
+     * The async messages of a streamer or a device.
+     *
+     * Any thread may push a message without taking a lock. Without a
+     * callback, the message is queued for recv_async_msg(), which blocks
+     * on the queue without polling. With a callback, the message is handed
+     * to the callback in the pushing thread instead.
+     */
+    class async_md_queue : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<async_md_queue> sptr;
+        typedef boost::function<void(const async_metadata_t &)> callback_type;
+
+        //! Make a new queue of the given capacity, rounded up to a power of two
+        async_md_queue(const size_t capacity);
+
+        /*!
+         * Hand a message to the callback, or queue it without one.
+         * A full queue drops the new message.
+         * \param metadata the message
+         * \return false when the message was dropped
+         */
+        bool push(const async_metadata_t &metadata);
+
+        /*!
+         * Pop a queued message, only one thread at a time may pop.
+         * \param metadata the message reference pop to
+         * \param timeout the timeout in seconds
+         * \return false when the operation times out
+         */
+        bool pop_with_timed_wait(async_metadata_t &metadata, const double timeout){
+            return _queue.pop_with_timed_wait(metadata, timeout);
+        }
+
+        /*!
+         * Set the callback for the messages pushed from now on.
+         * An empty callback queues them again.
+         * \param callback the callback
+         */
+        void set_callback(const callback_type &callback);
+
+        //! Get the number of messages dropped by a full queue
+        size_t get_num_dropped(void) const{
+            return _num_dropped.load(boost::memory_order_relaxed);
+        }
+
+    private:
+        transport::mpsc_bounded_buffer<async_metadata_t> _queue;
+        boost::atomic<size_t> _num_dropped;
+        //only locked when a callback is set
+        boost::atomic<bool> _has_callback;
+        boost::mutex _callback_mutex;
+        callback_type _callback;
+    };
+
+    /*!
+     * Services the async message sources of a device in a single task.
+     *
+     * A source is typically the async message transport of a streamer.
+     * The task waits on each source in turn, so adding a streamer does
+     * not add a thread. A source which throws is removed.
+     */
+    class async_msg_dispatcher : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<async_msg_dispatcher> sptr;
+
+        /*!
+         * Wait up to the timeout for one message, and handle it.
+         * Returns false on timeout.
+         */
+        typedef boost::function<bool(const double)> source_type;
+
+        //! Removes its source from the dispatcher when the last copy is destroyed
+        typedef boost::shared_ptr<void> source_handle;
+
+        virtual ~async_msg_dispatcher(void) = 0;
+
+        //! Make a new dispatcher, the task starts with the first source
+        static sptr make(void);
+
+        /*!
+         * Add a source to the dispatcher.
+         * The source is called from the task until the handle is destroyed.
+         * Destroying the handle waits until the source is no longer in use.
+         * \param source the source
+         * \return a handle that removes the source
+         */
+        virtual source_handle add_source(const source_type &source) = 0;
+    };
+
+}} //namespace uhd::usrp
+
+#endif /* INCLUDED_LIBUHD_USRP_COMMON_ASYNC_MSG_DISPATCHER_HPP */
@@ -0,0 +1,65 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "broadcast_find.hpp"
+#include <uhd/transport/if_addrs.hpp>
+#include <uhd/utils/msg.hpp>
+#include <boost/asio/ip/address_v4.hpp>
+#include <boost/foreach.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+using namespace uhd;
+using namespace uhd::transport;
+
+static void find_on_iface(
+    const usrp::broadcast_find_t &find,
+    const device_addr_t &hint,
+    device_addrs_t &addrs
+){
+    try{
+        addrs = find(hint);
+    }
+    catch(const std::exception &e){
+        UHD_MSG(error) << "Device discovery error on " << hint["addr"] << ": " << e.what() << std::endl;
+    }
+}
+
+std::vector<device_addrs_t> usrp::broadcast_find(
+    const device_addr_t &hint, const broadcast_find_t &find
+){
+    std::vector<device_addr_t> hints;
+    BOOST_FOREACH(const if_addrs_t &if_addrs, get_if_addrs()){
+        //avoid the loopback device
+        if (if_addrs.inet == boost::asio::ip::address_v4::loopback().to_string()) continue;
+
+        //create a new hint with this broadcast address
+        device_addr_t new_hint = hint;
+        new_hint["addr"] = if_addrs.bcast;
+        hints.push_back(new_hint);
+    }
+
+    std::vector<device_addrs_t> addrs(hints.size());
+    boost::thread_group threads;
+    for (size_t i = 0; i < hints.size(); i++){
+        threads.create_thread(boost::bind(
+            &find_on_iface, boost::cref(find), boost::cref(hints[i]), boost::ref(addrs[i])
+        ));
+    }
+    threads.join_all();
+    return addrs;
+}
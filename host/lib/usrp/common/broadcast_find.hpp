@@ -0,0 +1,48 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_USRP_COMMON_BROADCAST_FIND_HPP
+#define INCLUDED_LIBUHD_USRP_COMMON_BROADCAST_FIND_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/function.hpp>
+#include <vector>
+
+namespace uhd{ namespace usrp{
+
+    //! A finder for one address, like the ones passed to device::register_device()
+    typedef boost::function<device_addrs_t(const device_addr_t &)> broadcast_find_t;
+
+    /*!
+     * Call a finder once per network interface, with the broadcast address
+     * of the interface as "addr" in the hint. The loopback device is skipped.
+     *
+     * All calls run at the same time, so the discovery waits for the
+     * replies on all interfaces only once.
+     *
+     * \param hint the hint to pass on, with the address replaced
+     * \param find the finder to call
+     * \return the addresses found on each interface, in interface order
+     */
+    std::vector<device_addrs_t> broadcast_find(
+        const device_addr_t &hint, const broadcast_find_t &find
+    );
+
+}} //namespace uhd::usrp
+
+#endif /* INCLUDED_LIBUHD_USRP_COMMON_BROADCAST_FIND_HPP */
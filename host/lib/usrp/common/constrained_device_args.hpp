@@ -241,6 +241,17 @@ namespace usrp {
         //client specific device args
         virtual void _parse(const device_addr_t& dev_args) = 0;
 
+        /*!
+         * Utility: Parse the value of an arg if dev_args has its key
+         * \return true if the arg was given
+         */
+        template<typename arg_t>
+        static inline bool _parse_arg(const device_addr_t& dev_args, arg_t& arg) {
+            if (not dev_args.has_key(arg.key())) return false;
+            arg.parse(dev_args[arg.key()]);
+            return true;
+        }
+
         /*!
          * Utility: Ensure that the value of the device arg is between min and max
          */
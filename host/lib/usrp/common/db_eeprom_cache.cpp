@@ -0,0 +1,152 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "db_eeprom_cache.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/paths.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <fstream>
+
+namespace fs = boost::filesystem;
+using namespace uhd;
+
+//the common portion of a daughterboard EEPROM, see dboard_eeprom.cpp
+static const uint8_t DB_EEPROM_MAGIC_VALUE = 0xDB;
+static const size_t DB_EEPROM_ID_LEN = 0x03; //magic and ID
+static const uint16_t DB_EEPROM_CHKSUM = 0x1f;
+static const size_t DB_EEPROM_CLEN = 0x20;
+
+//! Has the copy the header and the checksum of a daughterboard EEPROM?
+static bool is_valid_db_eeprom(const byte_vector_t &bytes)
+{
+    if (bytes.size() != DB_EEPROM_CLEN or bytes[0] != DB_EEPROM_MAGIC_VALUE) {
+        return false;
+    }
+    int sum = 0;
+    for (size_t i = 0; i < DB_EEPROM_CHKSUM; i++) {
+        sum -= int(bytes[i]);
+    }
+    return bytes[DB_EEPROM_CHKSUM] == uint8_t(sum);
+}
+
+class db_eeprom_cache_impl : public i2c_iface
+{
+public:
+    db_eeprom_cache_impl(i2c_iface::sptr iface, const std::string &mb_serial, const std::string &cache_dir):
+        _iface(iface), _mb_serial(mb_serial),
+        _cache_dir(cache_dir.empty() ? fs::path(get_app_path()) / ".uhd" / "cache" : fs::path(cache_dir))
+    {
+        /* NOP */
+    }
+
+    void write_i2c(uint16_t addr, const byte_vector_t &buf)
+    {
+        _iface->write_i2c(addr, buf);
+    }
+
+    byte_vector_t read_i2c(uint16_t addr, size_t num_bytes)
+    {
+        return _iface->read_i2c(addr, num_bytes);
+    }
+
+    void write_eeprom(uint16_t addr, uint16_t offset, const byte_vector_t &buf)
+    {
+        if (not _mb_serial.empty()) {
+            boost::system::error_code ec;
+            fs::remove(get_path(addr), ec);
+        }
+        _iface->write_eeprom(addr, offset, buf);
+    }
+
+    byte_vector_t read_eeprom(uint16_t addr, uint16_t offset, size_t num_bytes)
+    {
+        if (_mb_serial.empty() or offset != 0 or num_bytes != DB_EEPROM_CLEN) {
+            return _iface->read_eeprom(addr, offset, num_bytes);
+        }
+
+        //the ID and checksum bytes tell if the copy is still the EEPROM contents
+        const fs::path path = get_path(addr);
+        const byte_vector_t cached = load(path);
+        if (is_valid_db_eeprom(cached)) {
+            const byte_vector_t id = _iface->read_eeprom(addr, 0, DB_EEPROM_ID_LEN);
+            const byte_vector_t chksum = _iface->read_eeprom(addr, DB_EEPROM_CHKSUM, 1);
+            if (id == byte_vector_t(cached.begin(), cached.begin() + DB_EEPROM_ID_LEN)
+                and chksum.size() == 1 and chksum[0] == cached[DB_EEPROM_CHKSUM]) {
+                UHD_LOG << "db_eeprom_cache: using " << path.string() << std::endl;
+                return cached;
+            }
+        }
+
+        const byte_vector_t bytes = _iface->read_eeprom(addr, offset, num_bytes);
+        if (is_valid_db_eeprom(bytes)) {
+            if (bytes != cached) save(path, bytes);
+        } else if (not cached.empty()) {
+            boost::system::error_code ec;
+            fs::remove(path, ec);
+        }
+        return bytes;
+    }
+
+private:
+    fs::path get_path(const uint16_t addr) const
+    {
+        return _cache_dir / str(boost::format("db_eeprom_%s_%02x.bin") % _mb_serial % addr);
+    }
+
+    static byte_vector_t load(const fs::path &path)
+    {
+        std::ifstream file(path.string().c_str(), std::ios::binary);
+        byte_vector_t bytes(DB_EEPROM_CLEN + 1);
+        file.read(reinterpret_cast<char *>(&bytes.front()), bytes.size());
+        bytes.resize(size_t(file.gcount()));
+        return bytes;
+    }
+
+    //! Write a copy, it's only a cache so failing is not an error
+    static void save(const fs::path &path, const byte_vector_t &bytes)
+    {
+        const fs::path tmp_path = path.string() + ".tmp";
+        try {
+            fs::create_directories(path.parent_path());
+            {
+                std::ofstream file(tmp_path.string().c_str(), std::ios::binary);
+                file.write(reinterpret_cast<const char *>(&bytes.front()), bytes.size());
+                if (not file) {
+                    throw uhd::io_error("Failed to write " + tmp_path.string());
+                }
+            }
+            fs::rename(tmp_path, path);
+        } catch (const std::exception &e) {
+            UHD_LOG << "db_eeprom_cache: not saving " << path.string() << ": " << e.what() << std::endl;
+        }
+    }
+
+    i2c_iface::sptr _iface;
+    const std::string _mb_serial;
+    const fs::path _cache_dir;
+};
+
+i2c_iface::sptr uhd::usrp::make_db_eeprom_cache(
+    i2c_iface::sptr iface,
+    const std::string &mb_serial,
+    const std::string &cache_dir
+){
+    return boost::make_shared<db_eeprom_cache_impl>(iface, mb_serial, cache_dir);
+}
@@ -0,0 +1,52 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_USRP_COMMON_DB_EEPROM_CACHE_HPP
+#define INCLUDED_LIBUHD_USRP_COMMON_DB_EEPROM_CACHE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/serial.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace uhd{ namespace usrp{
+
+    /*!
+     * An i2c_iface which keeps copies of the daughterboard EEPROMs on disk.
+     *
+     * A read of a whole daughterboard EEPROM first reads its ID and checksum
+     * bytes only. If the copy cached for the same motherboard serial and
+     * address has the same ID and checksum, the copy is returned and the
+     * rest of the EEPROM is not read. Only contents with a valid header and checksum are cached,
+     * and a write through this iface drops the copy. All other accesses go
+     * through unchanged.
+     *
+     * The copies are kept in the .uhd/cache directory of the app path.
+     *
+     * \param iface the I2C bus of the daughterboards
+     * \param mb_serial the motherboard serial, nothing is cached if empty
+     * \param cache_dir the directory of the copies, the app path if empty
+     */
+    uhd::i2c_iface::sptr make_db_eeprom_cache(
+        uhd::i2c_iface::sptr iface,
+        const std::string &mb_serial,
+        const std::string &cache_dir = ""
+    );
+
+}} //namespace uhd::usrp
+
+#endif /* INCLUDED_LIBUHD_USRP_COMMON_DB_EEPROM_CACHE_HPP */
@@ -46,6 +46,13 @@ extern "C" {
 #define FW_COMM_CMD_PEEK32          0x00000020
 #define FW_COMM_CMD_BLOCK_POKE32    0x00000030
 #define FW_COMM_CMD_BLOCK_PEEK32    0x00000040
+#define FW_COMM_CMD_MULTI_OP        0x00000050
+
+//A multi-op command carries (address, data) word pairs in the data field.
+//The low bit of the address selects a peek, the peek result replaces the data.
+//Older firmware replies with FW_COMM_ERR_CMD_ERROR and runs no op.
+#define FW_COMM_MULTI_OP_PEEK32     0x00000001
+#define FW_COMM_MAX_MULTI_OPS       (FW_COMM_MAX_DATA_WORDS / 2)
 
 #define FW_COMM_ERR_PKT_ERROR       0x80000000
 #define FW_COMM_ERR_CMD_ERROR       0x40000000
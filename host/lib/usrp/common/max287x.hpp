@@ -29,6 +29,7 @@
 #include <boost/thread.hpp>
 #include <boost/math/special_functions/round.hpp>
 #include <stdint.h>
+#include <map>
 #include <vector>
 #include "max2870_regs.hpp"
 #include "max2871_regs.hpp"
@@ -224,6 +225,23 @@ public:
      * Configure synthesizer for phase synchronization
      */
     virtual void config_for_sync(bool enable) = 0;
+
+    /**
+     * Enable or disable the VCO cache.
+     * When enabled, tuning to a VCO frequency for which the VCO sub-band
+     * is known programs that sub-band directly and bypasses the VCO
+     * auto selection (VAS), which shortens the lock time.
+     * @param enabled enable the VCO cache
+     */
+    virtual void set_vco_cache_enabled(bool enabled) = 0;
+
+    /**
+     * Store the VCO sub-band to use for an output frequency, for example
+     * from a sweep over a channel plan.
+     * @param freq the output frequency
+     * @param vco the VCO sub-band (0-63)
+     */
+    virtual void preload_vco(double freq, uint8_t vco) = 0;
 };
 
 /**
@@ -256,16 +274,28 @@ public:
     virtual void commit();
     virtual bool can_sync();
     virtual void config_for_sync(bool enable);
+    virtual void set_vco_cache_enabled(bool enabled);
+    virtual void preload_vco(double freq, uint8_t vco);
 
 protected:
+    //! Look up the VCO sub-band for a VCO frequency in the chip's VCO table
+    virtual bool _lookup_vco(double, uint8_t &) { return false; }
+    void _set_vas_enabled(bool enabled);
+
     max287x_regs_t _regs;
     bool _can_sync;
     bool _config_for_sync;
     bool _write_all_regs;
+    double _vco_freq;
 
 private:
+    static int64_t _get_vco_cache_key(double vco_freq);
+
     write_fn _write;
     bool _delay_after_write;
+    bool _vco_cache_enabled;
+    //! Known VCO sub-bands, keyed by VCO frequency in Hz
+    std::map<int64_t, uint8_t> _vco_cache;
 };
 
 /**
@@ -398,20 +428,8 @@ public:
         if (_config_for_sync)
         {
             // Need to manually program VCO value
-            static const double MIN_VCO_FREQ = 3e9;
-            double vco_freq = target_freq;
-            while (vco_freq < MIN_VCO_FREQ)
-                vco_freq *=2;
             uint8_t vco_index = 0xFF;
-            BOOST_FOREACH(const vco_map_t::value_type &vco, max2871_vco_map)
-            {
-                if (uhd::math::fp_compare::fp_compare_epsilon<double>(vco_freq) < vco.second.stop())
-                {
-                    vco_index = vco.first;
-                    break;
-                }
-            }
-            if (vco_index == 0xFF)
+            if (not _lookup_vco(_vco_freq, vco_index))
                 throw uhd::index_error("Invalid VCO frequency");
 
             // Settings required for phase synchronization as per MAX2871 datasheet
@@ -423,8 +441,8 @@ public:
         }
         else
         {
-            // Reset values to defaults
-            _regs.shutdown_vas = max2871_regs_t::SHUTDOWN_VAS_ENABLED;  // turn VCO auto selection on
+            // Reset values to defaults (VCO auto selection was set up by
+            // the VCO cache in max287x::set_frequency())
             _regs.low_noise_and_spur = max2871_regs_t::LOW_NOISE_AND_SPUR_LOW_SPUR_2;
             _regs.f01 = max2871_regs_t::F01_AUTO;
             _regs.aux_output_select = max2871_regs_t::AUX_OUTPUT_SELECT_FUNDAMENTAL;
@@ -453,6 +471,20 @@ public:
             _can_sync = false;
         }
     }
+
+protected:
+    bool _lookup_vco(double vco_freq, uint8_t &vco_index)
+    {
+        BOOST_FOREACH(const vco_map_t::value_type &vco, max2871_vco_map)
+        {
+            if (uhd::math::fp_compare::fp_compare_epsilon<double>(vco_freq) < vco.second.stop())
+            {
+                vco_index = vco.first;
+                return true;
+            }
+        }
+        return false;
+    }
 };
 
 
@@ -467,8 +499,10 @@ max287x<max287x_regs_t>::max287x(write_fn func) :
         _can_sync(false),
         _config_for_sync(false),
         _write_all_regs(true),
+        _vco_freq(0.0),
         _write(func),
-        _delay_after_write(true)
+        _delay_after_write(true),
+        _vco_cache_enabled(false)
 {
     power_up();
 }
@@ -686,6 +720,27 @@ double max287x<max287x_regs_t>::set_frequency(
         _write_all_regs = true;
     }
 
+    // Program a known VCO sub-band directly instead of running the VCO
+    // auto selection.  The first tune to an unknown VCO frequency uses the
+    // VCO auto selection.
+    _vco_freq = vco_freq;
+    uint8_t vco = 0;
+    if (_vco_cache_enabled and _vco_cache.count(_get_vco_cache_key(vco_freq)))
+    {
+        vco = _vco_cache[_get_vco_cache_key(vco_freq)];
+    }
+    else if (_vco_cache_enabled and _lookup_vco(vco_freq, vco))
+    {
+        _vco_cache[_get_vco_cache_key(vco_freq)] = vco;
+    }
+    else
+    {
+        _set_vas_enabled(true);
+        return actual_freq;
+    }
+    _regs.vco = vco;
+    _set_vas_enabled(false);
+
     return actual_freq;
 }
 
@@ -835,6 +890,45 @@ inline void max287x<max2871_regs_t>::set_auto_retune(bool enabled)
     _regs.vas_dly = enabled ? max2871_regs_t::VAS_DLY_ENABLED : max2871_regs_t::VAS_DLY_DISABLED;
 }
 
+template <typename max287x_regs_t>
+void max287x<max287x_regs_t>::_set_vas_enabled(bool enabled)
+{
+    _regs.vas = enabled ? max287x_regs_t::VAS_ENABLED : max287x_regs_t::VAS_DISABLED;
+}
+
+template <>
+inline void max287x<max2871_regs_t>::_set_vas_enabled(bool enabled)
+{
+    _regs.shutdown_vas = enabled ?
+        max2871_regs_t::SHUTDOWN_VAS_ENABLED :
+        max2871_regs_t::SHUTDOWN_VAS_DISABLED;
+}
+
+template <typename max287x_regs_t>
+int64_t max287x<max287x_regs_t>::_get_vco_cache_key(double vco_freq)
+{
+    return int64_t(boost::math::round(vco_freq));
+}
+
+template <typename max287x_regs_t>
+void max287x<max287x_regs_t>::set_vco_cache_enabled(bool enabled)
+{
+    _vco_cache_enabled = enabled;
+}
+
+template <typename max287x_regs_t>
+void max287x<max287x_regs_t>::preload_vco(double freq, uint8_t vco)
+{
+    static const double MIN_VCO_FREQ = 3e9;
+    UHD_ASSERT_THROW(freq > 0);
+    if (vco > 63)
+        throw uhd::value_error("MAX287x: VCO sub-band must be between 0 and 63");
+    double vco_freq = freq;
+    while (vco_freq < MIN_VCO_FREQ)
+        vco_freq *= 2;
+    _vco_cache[_get_vco_cache_key(vco_freq)] = vco;
+}
+
 template <typename max287x_regs_t>
 void max287x<max287x_regs_t>::set_clock_divider_mode(clock_divider_mode_t mode)
 {
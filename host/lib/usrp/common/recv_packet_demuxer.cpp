@@ -18,11 +18,13 @@
 #include "recv_packet_demuxer.hpp"
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/byteswap.hpp>
-#include <boost/thread/mutex.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/types/metadata.hpp>
-#include <queue>
-#include <deque>
+#include <uhd/types/time_spec.hpp>
+#include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
 #include <vector>
 
 using namespace uhd;
@@ -51,67 +53,95 @@ recv_packet_demuxer::~recv_packet_demuxer(void){
     /* NOP */
 }
 
+//! The longest a channel waits on its ring before it checks the claim again
+static const double CLAIM_POLL_TIMEOUT = 0.001;
+
+/***********************************************************************
+ * The thread that claims the transport receives from it and hands the
+ * packets of the other channels over through their rings, so channels
+ * in different threads never contend on a lock.
+ **********************************************************************/
 class recv_packet_demuxer_impl : public uhd::usrp::recv_packet_demuxer{
 public:
+    typedef spsc_bounded_buffer<managed_recv_buffer::sptr> queue_type;
+
     recv_packet_demuxer_impl(
         transport::zero_copy_if::sptr transport,
         const size_t size,
         const uint32_t sid_base
     ):
-        _transport(transport), _sid_base(sid_base), _queues(size)
+        _transport(transport), _sid_base(sid_base), _claimed(false)
     {
-        /* NOP */
+        //a ring holds all frames of the transport, so it is never full
+        for (size_t i = 0; i < size; i++){
+            _queues.push_back(boost::shared_ptr<queue_type>(
+                new queue_type(_transport->get_num_recv_frames(), 0)
+            ));
+        }
     }
 
     managed_recv_buffer::sptr get_recv_buff(const size_t index, const double timeout){
-        boost::mutex::scoped_lock lock(_mutex);
+        const time_spec_t exit_time = time_spec_t(timeout) + time_spec_t::get_system_time();
         managed_recv_buffer::sptr buff;
 
-        //there is already an entry in the queue, so pop that
-        if (not _queues[index].wrapper.empty()){
-            std::swap(buff, _queues[index].wrapper.front());
-            _queues[index].wrapper.pop();
-            return buff;
-        }
-
         while (true){
-            //otherwise call into the transport
-            buff = _transport->get_recv_buff(timeout);
-            if (buff.get() == NULL) return buff; //timeout
-
-            //check the stream id to know which channel
-            const size_t rx_index = extract_sid(buff) - _sid_base;
-            if (rx_index == index) return buff; //got expected message
-
-            //otherwise queue and try again
-            if (rx_index < _queues.size()) _queues[rx_index].wrapper.push(buff);
-            else
-            {
-                UHD_MSG(error) << "Got a data packet with unknown SID " << extract_sid(buff) << std::endl;
-                recv_pkt_demux_mrb *mrb = new recv_pkt_demux_mrb();
-                vrt::if_packet_info_t info;
-                info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
-                info.num_payload_words32 = 1;
-                info.num_payload_bytes = info.num_payload_words32*sizeof(uint32_t);
-                info.has_sid = true;
-                info.sid = _sid_base + index;
-                vrt::if_hdr_pack_le(mrb->buff, info);
-                mrb->buff[info.num_header_words32] = rx_metadata_t::ERROR_CODE_OVERFLOW;
-                return mrb->make(mrb, mrb->buff, info.num_packet_words32*sizeof(uint32_t));
+            //there is already an entry in the ring, so pop that
+            if (_queues[index]->pop_with_haste(buff)) return buff;
+
+            const double new_timeout = std::max(
+                (exit_time - time_spec_t::get_system_time()).get_real_secs(), 0.0);
+
+            //otherwise claim and call into the transport,
+            //or wait for the claimer to hand over a buffer
+            if (not _claimed.exchange(true, boost::memory_order_acquire)){
+                bool done = false;
+                buff = this->recv_from_transport(index, new_timeout, done);
+                _claimed.store(false, boost::memory_order_release);
+                if (done) return buff;
             }
+            else if (_queues[index]->pop_with_timed_wait(
+                buff, std::min(new_timeout, CLAIM_POLL_TIMEOUT)
+            )) return buff;
+
+            if (new_timeout <= 0.0) return managed_recv_buffer::sptr(); //timeout
         }
     }
 
 private:
+    //! Receive once from the transport, only called by the claimer
+    managed_recv_buffer::sptr recv_from_transport(const size_t index, const double timeout, bool &done){
+        managed_recv_buffer::sptr buff = _transport->get_recv_buff(timeout);
+        done = true;
+        if (buff.get() == NULL) return buff; //timeout
+
+        //check the stream id to know which channel
+        const size_t rx_index = extract_sid(buff) - _sid_base;
+        if (rx_index == index) return buff; //got expected message
+
+        //otherwise hand it over and try again
+        if (rx_index < _queues.size()){
+            _queues[rx_index]->push_with_haste(buff);
+            done = false;
+            return managed_recv_buffer::sptr();
+        }
+
+        UHD_MSG(error) << "Got a data packet with unknown SID " << extract_sid(buff) << std::endl;
+        recv_pkt_demux_mrb *mrb = new recv_pkt_demux_mrb();
+        vrt::if_packet_info_t info;
+        info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+        info.num_payload_words32 = 1;
+        info.num_payload_bytes = info.num_payload_words32*sizeof(uint32_t);
+        info.has_sid = true;
+        info.sid = _sid_base + index;
+        vrt::if_hdr_pack_le(mrb->buff, info);
+        mrb->buff[info.num_header_words32] = rx_metadata_t::ERROR_CODE_OVERFLOW;
+        return mrb->make(mrb, mrb->buff, info.num_packet_words32*sizeof(uint32_t));
+    }
+
     transport::zero_copy_if::sptr _transport;
     const uint32_t _sid_base;
-    boost::mutex _mutex;
-    struct channel_guts_type{
-        channel_guts_type(void): wrapper(container){}
-        std::deque<managed_recv_buffer::sptr> container;
-        std::queue<managed_recv_buffer::sptr> wrapper;
-    };
-    std::vector<channel_guts_type> _queues;
+    boost::atomic<bool> _claimed;
+    std::vector<boost::shared_ptr<queue_type> > _queues;
 };
 
 recv_packet_demuxer::sptr recv_packet_demuxer::make(transport::zero_copy_if::sptr transport, const size_t size, const uint32_t sid_base){
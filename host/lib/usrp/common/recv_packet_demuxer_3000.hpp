@@ -20,123 +20,153 @@
 
 #include <uhd/config.hpp>
 #include <uhd/transport/zero_copy.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
 #include <stdint.h>
+#include <boost/atomic.hpp>
 #include <boost/thread.hpp>
 #include <uhd/utils/msg.hpp>
-#include <uhd/utils/atomic.hpp>
 #include <uhd/types/time_spec.hpp>
 #include <uhd/utils/byteswap.hpp>
-#include <queue>
-#include <map>
+#include <uhd/exception.hpp>
 #include <boost/enable_shared_from_this.hpp>
+#include <algorithm>
 
 namespace uhd{ namespace usrp{
 
+    /*!
+     * Demux the packets of one transport by SID.
+     *
+     * The caller that claims the transport with a CAS receives from it,
+     * and hands the packets of other SIDs to their receivers through a
+     * single producer/single consumer ring per SID. The SIDs are looked
+     * up in a small fixed array. There is no lock on the receive path,
+     * so receivers of different SIDs may run in different threads; each
+     * SID must only be received from one thread at a time.
+     */
     struct recv_packet_demuxer_3000 : boost::enable_shared_from_this<recv_packet_demuxer_3000>
     {
         typedef boost::shared_ptr<recv_packet_demuxer_3000> sptr;
-        static sptr make(transport::zero_copy_if::sptr xport)
+        typedef transport::spsc_bounded_buffer<transport::managed_recv_buffer::sptr> queue_type_t;
+
+        //! The most SIDs that one transport can be demuxed to
+        static const size_t MAX_NUM_SIDS = 16;
+
+        //! The longest a receiver waits on its ring before it checks the claim again
+        static const long CLAIM_POLL_US = 1000;
+
+        static sptr make(transport::zero_copy_if::sptr xport, const bool big_endian = false)
         {
-            return sptr(new recv_packet_demuxer_3000(xport));
+            return sptr(new recv_packet_demuxer_3000(xport, big_endian));
         }
 
-        recv_packet_demuxer_3000(transport::zero_copy_if::sptr xport):
-            _xport(xport)
+        recv_packet_demuxer_3000(transport::zero_copy_if::sptr xport, const bool big_endian):
+            _xport(xport), _big_endian(big_endian), _num_sids(0), _claimed(false)
         {/*NOP*/}
 
         transport::managed_recv_buffer::sptr get_recv_buff(const uint32_t sid, const double timeout)
         {
-            const time_spec_t exit_time = time_spec_t(timeout) + time_spec_t::get_system_time();
-            transport::managed_recv_buffer::sptr buff;
-            buff = _internal_get_recv_buff(sid, timeout);
-            while (not buff) //loop until timeout
+            sid_entry_type *entry = this->find_sid(sid);
+            if (entry == NULL)
             {
-                const time_spec_t delta = exit_time - time_spec_t::get_system_time();
-                const double new_timeout = delta.get_real_secs();
-                if (new_timeout < 0.0) break;
-                buff = _internal_get_recv_buff(sid, new_timeout);
+                this->realloc_sid(sid);
+                entry = this->find_sid(sid);
             }
-            return buff;
-        }
 
-        transport::managed_recv_buffer::sptr _internal_get_recv_buff(const uint32_t sid, const double timeout)
-        {
+            const time_spec_t exit_time = time_spec_t(timeout) + time_spec_t::get_system_time();
             transport::managed_recv_buffer::sptr buff;
-
-            //----------------------------------------------------------
-            //-- Check the queue to see if we already have a buffer
-            //----------------------------------------------------------
+            while (true)
             {
-                boost::mutex::scoped_lock l(mutex);
-                queue_type_t &queue = _queues[sid];
-                if (not queue.empty())
+                //----------------------------------------------------------
+                //-- Check the ring to see if we already have a buffer
+                //----------------------------------------------------------
+                if (entry->queue->pop_with_haste(buff)) return buff;
+
+                const double new_timeout = (exit_time - time_spec_t::get_system_time()).get_real_secs();
+
+                //----------------------------------------------------------
+                //-- Claim the transport and receive, or wait on the ring
+                //-- for the claimer to hand over a buffer
+                //----------------------------------------------------------
+                if (not _claimed.exchange(true, boost::memory_order_acquire))
                 {
-                    buff = queue.front();
-                    queue.front().reset();
-                    queue.pop();
-                    return buff;
+                    buff = _internal_get_recv_buff(sid, std::max(new_timeout, 0.0));
+                    _claimed.store(false, boost::memory_order_release);
+                    if (buff) return buff;
                 }
-            }
-            // Following is disabled by default as super_recv_packet_handler (caller) is not thread safe
-            // Only underlying transport (libusb1_zero_copy) is thread safe
-            // The onus is on the caller to super_recv_packet_handler (and therefore this) to serialise access
-#ifdef RECV_PACKET_DEMUXER_3000_THREAD_SAFE
-            //----------------------------------------------------------
-            //-- Try to claim the transport or wait patiently
-            //----------------------------------------------------------
-            if (_claimed.cas(1, 0))
-            {
-                boost::mutex::scoped_lock l(mutex);
-                cond.timed_wait(l, boost::posix_time::microseconds(long(timeout*1e6)));
-            }
-
-            //----------------------------------------------------------
-            //-- Wait on the transport for input buffers
-            //----------------------------------------------------------
-            else
-#endif // RECV_PACKET_DEMUXER_3000_THREAD_SAFE
-            {
-                buff = _xport->get_recv_buff(timeout);
-                if (buff)
+                else if (entry->queue->pop_with_timed_wait(buff,
+                    std::max(std::min(new_timeout, CLAIM_POLL_US/1e6), 0.0)))
                 {
-                    const uint32_t new_sid = uhd::wtohx(buff->cast<const uint32_t *>()[1]);
-                    if (new_sid != sid)
-                    {
-                        boost::mutex::scoped_lock l(mutex);
-                        if (_queues.count(new_sid) == 0) UHD_MSG(error)
-                            << "recv packet demuxer unexpected sid 0x" << std::hex << new_sid << std::dec
-                            << std::endl;
-                        else _queues[new_sid].push(buff);
-                        buff.reset();
-                    }
+                    return buff;
                 }
-#ifdef RECV_PACKET_DEMUXER_3000_THREAD_SAFE
-                _claimed.write(0);
-                cond.notify_all();
-#endif // RECV_PACKET_DEMUXER_3000_THREAD_SAFE
+                if (new_timeout <= 0.0) break;
             }
             return buff;
         }
 
+        //! Receive once from the transport, only called by the claimer
+        transport::managed_recv_buffer::sptr _internal_get_recv_buff(const uint32_t sid, const double timeout)
+        {
+            transport::managed_recv_buffer::sptr buff = _xport->get_recv_buff(timeout);
+            if (not buff) return buff;
+
+            const uint32_t sid_word = buff->cast<const uint32_t *>()[1];
+            const uint32_t new_sid = _big_endian? uhd::ntohx(sid_word) : uhd::wtohx(sid_word);
+            if (new_sid == sid) return buff;
+
+            sid_entry_type *entry = this->find_sid(new_sid);
+            if (entry == NULL) UHD_MSG(error)
+                << "recv packet demuxer unexpected sid 0x" << std::hex << new_sid << std::dec
+                << std::endl;
+            //a ring holds all frames of the transport, so it is never full
+            else entry->queue->push_with_haste(buff);
+            return transport::managed_recv_buffer::sptr();
+        }
+
+        //! Allocate the ring of a SID, and clear it if it is already allocated
         void realloc_sid(const uint32_t sid)
         {
-            boost::mutex::scoped_lock l(mutex);
-            while(not _queues[sid].empty()) //allocated and clears if already allocated
+            boost::mutex::scoped_lock l(_setup_mutex);
+            sid_entry_type *entry = this->find_sid(sid);
+            if (entry == NULL)
             {
-                _queues[sid].pop();
+                const size_t num_sids = _num_sids.load(boost::memory_order_relaxed);
+                if (num_sids == MAX_NUM_SIDS) throw uhd::runtime_error(
+                    "recv packet demuxer: too many SIDs on one transport");
+                entry = &_sids[num_sids];
+                entry->sid = sid;
+                entry->queue.reset(new queue_type_t(_xport->get_num_recv_frames(), 0));
+                //publish the entry after it is filled in
+                _num_sids.store(num_sids + 1, boost::memory_order_release);
+                return;
             }
+            transport::managed_recv_buffer::sptr buff;
+            while (entry->queue->pop_with_haste(buff)) buff.reset();
         }
 
         transport::zero_copy_if::sptr make_proxy(const uint32_t sid);
 
-        typedef std::queue<transport::managed_recv_buffer::sptr> queue_type_t;
-        std::map<uint32_t, queue_type_t> _queues;
+        struct sid_entry_type
+        {
+            uint32_t sid;
+            boost::shared_ptr<queue_type_t> queue;
+        };
+
+        UHD_INLINE sid_entry_type *find_sid(const uint32_t sid)
+        {
+            const size_t num_sids = _num_sids.load(boost::memory_order_acquire);
+            for (size_t i = 0; i < num_sids; i++)
+            {
+                if (_sids[i].sid == sid) return &_sids[i];
+            }
+            return NULL;
+        }
+
         transport::zero_copy_if::sptr _xport;
-#ifdef RECV_PACKET_DEMUXER_3000_THREAD_SAFE
-        uhd::atomic_uint32_t _claimed;
-        boost::condition_variable cond;
-#endif // RECV_PACKET_DEMUXER_3000_THREAD_SAFE
-        boost::mutex mutex;
+        const bool _big_endian;
+        sid_entry_type _sids[MAX_NUM_SIDS];
+        boost::atomic<size_t> _num_sids;
+        boost::atomic<bool> _claimed;
+        boost::mutex _setup_mutex;
     };
 
     struct recv_packet_demuxer_proxy_3000 : transport::zero_copy_if
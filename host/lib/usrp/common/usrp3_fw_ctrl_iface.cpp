@@ -23,6 +23,7 @@
 #include <boost/format.hpp>
 #include <boost/asio.hpp> //used for htonl and ntohl
 #include <boost/foreach.hpp>
+#include <algorithm>
 #include "fw_comm_protocol.h"
 
 namespace uhd { namespace usrp { namespace usrp3 {
@@ -47,10 +48,17 @@ usrp3_fw_ctrl_iface::usrp3_fw_ctrl_iface(
     const uint16_t product_id,
     const bool verbose) :
     _product_id(product_id), _verbose(verbose), _udp_xport(udp_xport),
-    _seq_num(0)
+    _seq_num(0), _multi_ops(false)
 {
     flush();
     peek32(0);
+
+    //Probe for multi-op commands, older firmware rejects the command
+    try {
+        boost::mutex::scoped_lock lock(_mutex);
+        transaction_t probe(transaction_t::PEEK32, 0);
+        _multi_ops = _transact(&probe, 1);
+    } catch(...) {}
 }
 
 usrp3_fw_ctrl_iface::~usrp3_fw_ctrl_iface()
@@ -98,6 +106,29 @@ uint32_t usrp3_fw_ctrl_iface::peek32(const wb_addr_type addr)
     return 0;
 }
 
+void usrp3_fw_ctrl_iface::transact(transactions_type &transactions)
+{
+    if (not _multi_ops) return wb_iface::transact(transactions);
+
+    for (size_t first = 0; first < transactions.size(); first += FW_COMM_MAX_MULTI_OPS) {
+        const size_t num_ops = std::min<size_t>(transactions.size() - first, FW_COMM_MAX_MULTI_OPS);
+        boost::mutex::scoped_lock lock(_mutex);
+        for (size_t i = 1; i <= NUM_RETRIES; i++) {
+            try {
+                if (_transact(&transactions[first], num_ops)) break;
+                throw uhd::io_error("multi-op command not supported");
+            } catch(const uhd::not_implemented_error &) {
+                throw;
+            } catch(const std::exception &ex) {
+                const std::string error_msg = str(boost::format(
+                    "udp fw transact failure #%u\n%s") % i % ex.what());
+                if (_verbose) UHD_MSG(warning) << error_msg << std::endl;
+                if (i == NUM_RETRIES) throw uhd::io_error(error_msg);
+            }
+        }
+    }
+}
+
 void usrp3_fw_ctrl_iface::_poke32(const wb_addr_type addr, const uint32_t data)
 {
     //Load request struct
@@ -162,6 +193,58 @@ uint32_t usrp3_fw_ctrl_iface::_peek32(const wb_addr_type addr)
     return uhd::ntohx<uint32_t>(reply.data[0]);
 }
 
+bool usrp3_fw_ctrl_iface::_transact(transaction_t *ops, const size_t num_ops)
+{
+    //Load request struct
+    fw_comm_pkt_t request;
+    request.id = uhd::htonx<uint32_t>(FW_COMM_GENERATE_ID(_product_id));
+    request.flags = uhd::htonx<uint32_t>(FW_COMM_FLAGS_ACK | FW_COMM_CMD_MULTI_OP);
+    request.sequence = uhd::htonx<uint32_t>(_seq_num++);
+    request.addr = 0;
+    request.data_words = uhd::htonx<uint32_t>(2 * num_ops);
+    for (size_t i = 0; i < num_ops; i++) {
+        switch (ops[i].op) {
+        case transaction_t::POKE32:
+            request.data[2*i+0] = uhd::htonx(ops[i].addr);
+            request.data[2*i+1] = uhd::htonx(uint32_t(ops[i].data));
+            break;
+        case transaction_t::PEEK32:
+            request.data[2*i+0] = uhd::htonx<uint32_t>(ops[i].addr | FW_COMM_MULTI_OP_PEEK32);
+            request.data[2*i+1] = 0;
+            break;
+        default:
+            throw uhd::not_implemented_error("udp fw transact - only 32 bit accesses");
+        }
+    }
+
+    //Send request
+    _flush();
+    _udp_xport->send(boost::asio::buffer(&request, sizeof(request)));
+
+    //Recv reply
+    fw_comm_pkt_t reply;
+    const size_t nbytes = _udp_xport->recv(boost::asio::buffer(&reply, sizeof(reply)), 1.0);
+    if (nbytes == 0) throw uhd::io_error("udp fw transact - reply timed out");
+
+    //Older firmware does not know the command
+    const size_t flags = uhd::ntohx<uint32_t>(reply.flags);
+    if (flags & FW_COMM_ERR_CMD_ERROR) return false;
+
+    //Sanity checks
+    UHD_ASSERT_THROW(nbytes == sizeof(reply));
+    UHD_ASSERT_THROW(not (flags & FW_COMM_FLAGS_ERROR_MASK));
+    UHD_ASSERT_THROW((flags & FW_COMM_FLAGS_CMD_MASK) == FW_COMM_CMD_MULTI_OP);
+    UHD_ASSERT_THROW(flags & FW_COMM_FLAGS_ACK);
+    UHD_ASSERT_THROW(reply.sequence == request.sequence);
+
+    //Store the peek results
+    for (size_t i = 0; i < num_ops; i++) {
+        UHD_ASSERT_THROW(reply.data[2*i+0] == request.data[2*i+0]);
+        if (ops[i].op == transaction_t::PEEK32) ops[i].data = uhd::ntohx<uint32_t>(reply.data[2*i+1]);
+    }
+    return true;
+}
+
 void usrp3_fw_ctrl_iface::_flush(void)
 {
     char buff[FW_COMM_PROTOCOL_MTU] = {};
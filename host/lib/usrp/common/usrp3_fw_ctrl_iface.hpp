@@ -37,6 +37,7 @@ public:
     // -- uhd::wb_iface --
     void poke32(const wb_addr_type addr, const uint32_t data);
     uint32_t peek32(const wb_addr_type addr);
+    void transact(transactions_type &transactions);
     void flush();
 
     static uhd::wb_iface::sptr make(
@@ -56,12 +57,14 @@ public:
 private:
     void _poke32(const wb_addr_type addr, const uint32_t data);
     uint32_t _peek32(const wb_addr_type addr);
+    bool _transact(transaction_t *ops, const size_t num_ops);
     void _flush(void);
 
     const uint16_t               _product_id;
     const bool                          _verbose;
     uhd::transport::udp_simple::sptr    _udp_xport;
     uint32_t                     _seq_num;
+    bool                                _multi_ops;
     boost::mutex                        _mutex;
 
     static const size_t NUM_RETRIES = 3;
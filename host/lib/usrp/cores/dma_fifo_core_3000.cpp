@@ -40,6 +40,8 @@ protected:
         static const uint32_t RB_BIST_STATUS     = 1;
         static const uint32_t RB_BIST_XFER_CNT   = 2;
         static const uint32_t RB_BIST_CYC_CNT    = 3;
+        static const uint32_t RB_REPLAY_STATUS   = 4;
+        static const uint32_t RB_REPLAY_CNT      = 5;
 
         rb_addr_reg_t(uint32_t base):
             soft_reg32_wo_t(base + 0)
@@ -154,6 +156,48 @@ protected:
         }
     };
 
+    class replay_ctrl_reg_t : public soft_reg32_wo_t {
+    public:
+        UHD_DEFINE_SOFT_REG_FIELD(MODE,     /*width*/ 2, /*shift*/ 0);  //[1:0]
+        UHD_DEFINE_SOFT_REG_FIELD(GO,       /*width*/ 1, /*shift*/ 4);  //[4]
+
+        static const uint32_t MODE_FIFO     = 0;
+        static const uint32_t MODE_RECORD   = 1;
+        static const uint32_t MODE_PLAY     = 2;
+
+        replay_ctrl_reg_t(uint32_t base):
+            soft_reg32_wo_t(base + 32)
+        {
+            //Initial values
+            set(MODE, MODE_FIFO);
+            set(GO, 0);
+        }
+    };
+
+    class replay_size_reg_t : public soft_reg32_wo_t {
+    public:
+        UHD_DEFINE_SOFT_REG_FIELD(NUM_WORDS,    /*width*/ 27, /*shift*/ 0);  //[26:0]
+
+        replay_size_reg_t(uint32_t base):
+            soft_reg32_wo_t(base + 36)
+        {
+            //Initial values
+            set(NUM_WORDS, 0);
+        }
+    };
+
+    class replay_repeats_reg_t : public soft_reg32_wo_t {
+    public:
+        UHD_DEFINE_SOFT_REG_FIELD(NUM_REPEATS,  /*width*/ 32, /*shift*/ 0);  //[31:0]
+
+        replay_repeats_reg_t(uint32_t base):
+            soft_reg32_wo_t(base + 40)
+        {
+            //Initial values
+            set(NUM_REPEATS, 0);
+        }
+    };
+
 public:
     class fifo_readback {
     public:
@@ -204,6 +248,24 @@ public:
             return _iface->peek32(_rb_addr) & 0x80000000;
         }
 
+        bool is_replay_supported() {
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            _addr_reg.write(rb_addr_reg_t::ADDR, rb_addr_reg_t::RB_REPLAY_STATUS);
+            return _iface->peek32(_rb_addr) & 0x80000000;
+        }
+
+        bool is_replay_playing() {
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            _addr_reg.write(rb_addr_reg_t::ADDR, rb_addr_reg_t::RB_REPLAY_STATUS);
+            return _iface->peek32(_rb_addr) & 0x1;
+        }
+
+        uint32_t get_replay_cnt() {
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            _addr_reg.write(rb_addr_reg_t::ADDR, rb_addr_reg_t::RB_REPLAY_CNT);
+            return _iface->peek32(_rb_addr);
+        }
+
         double get_xfer_ratio() {
             boost::lock_guard<boost::mutex> lock(_mutex);
             uint32_t xfer_cnt = 0, cyc_cnt = 0;
@@ -225,7 +287,8 @@ public:
     dma_fifo_core_3000_impl(wb_iface::sptr iface, const size_t base, const size_t readback):
         _iface(iface), _fifo_readback(iface, base, readback),
         _fifo_ctrl_reg(base), _base_addr_reg(base), _addr_mask_reg(base),
-        _bist_ctrl_reg(base), _bist_cfg_reg(base), _bist_delay_reg(base), _bist_sid_reg(base)
+        _bist_ctrl_reg(base), _bist_cfg_reg(base), _bist_delay_reg(base), _bist_sid_reg(base),
+        _replay_ctrl_reg(base), _replay_size_reg(base), _replay_repeats_reg(base)
     {
         _fifo_ctrl_reg.initialize(*iface, true);
         _base_addr_reg.initialize(*iface, true);
@@ -237,6 +300,12 @@ public:
             _bist_delay_reg.initialize(*iface, true);
             _bist_sid_reg.initialize(*iface, true);
         }
+        _has_replay = _fifo_readback.is_replay_supported();
+        if (_has_replay) {
+            _replay_ctrl_reg.initialize(*iface, true);
+            _replay_size_reg.initialize(*iface, true);
+            _replay_repeats_reg.initialize(*iface, true);
+        }
         flush();
     }
 
@@ -258,6 +327,12 @@ public:
         uint32_t size_mask = size - 1;
         if (size & size_mask) throw uhd::runtime_error("DMA FIFO size must be a power of 2");
 
+        //Back to a plain FIFO
+        if (_has_replay) {
+            _replay_ctrl_reg.set(replay_ctrl_reg_t::GO, 0);
+            _replay_ctrl_reg.write(replay_ctrl_reg_t::MODE, replay_ctrl_reg_t::MODE_FIFO);
+        }
+
         //Clear the FIFO and hold it in that state
         _fifo_ctrl_reg.write(fifo_ctrl_reg_t::CLEAR_FIFO, 1);
         //Write base address and mask
@@ -337,7 +412,60 @@ public:
         }
     }
 
+    virtual bool replay_supported() {
+        return _has_replay;
+    }
+
+    virtual void record() {
+        _require_replay();
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _replay_ctrl_reg.set(replay_ctrl_reg_t::GO, 0);
+        _replay_ctrl_reg.write(replay_ctrl_reg_t::MODE, replay_ctrl_reg_t::MODE_FIFO);
+        //Clear the FIFO, then keep whatever is written to it
+        _fifo_ctrl_reg.write(fifo_ctrl_reg_t::CLEAR_FIFO, 1);
+        _wait_for_fifo_empty();
+        _replay_ctrl_reg.write(replay_ctrl_reg_t::MODE, replay_ctrl_reg_t::MODE_RECORD);
+        _fifo_ctrl_reg.write(fifo_ctrl_reg_t::CLEAR_FIFO, 0);
+    }
+
+    virtual void play(const uint32_t num_bytes, const uint32_t num_repeats) {
+        _require_replay();
+        static const uint32_t BYTES_PER_WORD = 8;
+        if (num_bytes == 0 or num_bytes % BYTES_PER_WORD != 0) {
+            throw uhd::value_error("dma_fifo_core_3000: The replay size must be a positive multiple of 8 bytes");
+        }
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _replay_size_reg.write(replay_size_reg_t::NUM_WORDS, num_bytes / BYTES_PER_WORD);
+        _replay_repeats_reg.write(replay_repeats_reg_t::NUM_REPEATS, num_repeats);
+        _replay_ctrl_reg.set(replay_ctrl_reg_t::MODE, replay_ctrl_reg_t::MODE_PLAY);
+        _replay_ctrl_reg.write(replay_ctrl_reg_t::GO, 1);
+    }
+
+    virtual void stop_play() {
+        _require_replay();
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _replay_ctrl_reg.write(replay_ctrl_reg_t::GO, 0);
+    }
+
+    virtual bool is_playing() {
+        _require_replay();
+        return _fifo_readback.is_replay_playing();
+    }
+
+    virtual uint32_t get_num_played() {
+        _require_replay();
+        return _fifo_readback.get_replay_cnt();
+    }
+
 private:
+    void _require_replay()
+    {
+        if (not _has_replay) {
+            throw uhd::not_implemented_error(
+                "dma_fifo_core_3000: Replay only available on FPGA images with replay enabled");
+        }
+    }
+
     void _wait_for_fifo_empty()
     {
         boost::posix_time::ptime start_time = boost::posix_time::microsec_clock::local_time();
@@ -370,6 +498,7 @@ private:
     wb_iface::sptr  _iface;
     boost::mutex    _mutex;
     bool            _has_ext_bist;
+    bool            _has_replay;
 
     fifo_readback       _fifo_readback;
     fifo_ctrl_reg_t     _fifo_ctrl_reg;
@@ -379,6 +508,9 @@ private:
     bist_cfg_reg_t      _bist_cfg_reg;
     bist_delay_reg_t    _bist_delay_reg;
     bist_sid_reg_t      _bist_sid_reg;
+    replay_ctrl_reg_t   _replay_ctrl_reg;
+    replay_size_reg_t   _replay_size_reg;
+    replay_repeats_reg_t _replay_repeats_reg;
 };
 
 //
@@ -81,6 +81,40 @@ public:
      */
     virtual double get_bist_throughput(double fifo_clock_rate) = 0;
 
+    /*!
+     * Is replay supported
+     */
+    virtual bool replay_supported() = 0;
+
+    /*!
+     * Clear the FIFO and keep what is written to it from now on (replay only).
+     * Nothing is read out until play() is called.
+     */
+    virtual void record() = 0;
+
+    /*!
+     * Read out the first bytes of the FIFO, num_repeats times (replay only).
+     * Playback starts with the settings bus write of this call, so a timed
+     * command starts it on time. num_repeats = 0 repeats until stopped.
+     */
+    virtual void play(const uint32_t num_bytes, const uint32_t num_repeats) = 0;
+
+    /*!
+     * Stop the playback at the end of the current packet (replay only).
+     * The recorded contents are kept.
+     */
+    virtual void stop_play() = 0;
+
+    /*!
+     * Is the FIFO playing (replay only)
+     */
+    virtual bool is_playing() = 0;
+
+    /*!
+     * Get the number of repeats played since play() (replay only)
+     */
+    virtual uint32_t get_num_played() = 0;
+
 };
 
 #endif /* INCLUDED_LIBUHD_USRP_DMA_FIFO_CORE_3000_HPP */
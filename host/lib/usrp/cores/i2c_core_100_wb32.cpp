@@ -19,6 +19,7 @@
 #include <uhd/exception.hpp>
 #include <uhd/utils/msg.hpp>
 #include <boost/thread/thread.hpp> //sleep
+#include <algorithm>
 
 #define REG_I2C_PRESCALER_LO _base + 0
 #define REG_I2C_PRESCALER_HI _base + 4
@@ -89,9 +90,10 @@ public:
         }
 
         for (size_t i = 0; i < bytes.size(); i++) {
-            _iface->poke32(REG_I2C_DATA, bytes[i]);
-            _iface->poke32(REG_I2C_CMD_STATUS, I2C_CMD_WR | ((i == (bytes.size() - 1)) ? I2C_CMD_STOP : 0));
-            if(!wait_chk_ack()) {
+            wb_iface::transactions_type batch;
+            batch.push_back(poke_op(REG_I2C_DATA, bytes[i]));
+            batch.push_back(poke_op(REG_I2C_CMD_STATUS, I2C_CMD_WR | ((i == (bytes.size() - 1)) ? I2C_CMD_STOP : 0)));
+            if (run_and_wait(batch) & I2C_ST_RXACK) {
                 _iface->poke32(REG_I2C_CMD_STATUS, I2C_CMD_STOP);
                 return;
             }
@@ -116,9 +118,9 @@ public:
             _iface->poke32(REG_I2C_CMD_STATUS, I2C_CMD_STOP);
         }
         for (size_t i = 0; i < num_bytes; i++) {
-            _iface->poke32(REG_I2C_CMD_STATUS, I2C_CMD_RD | ((num_bytes == i+1) ? (I2C_CMD_STOP | I2C_CMD_NACK) : 0));
-            i2c_wait();
-            bytes.push_back(uint8_t(_iface->peek32(REG_I2C_DATA)));
+            wb_iface::transactions_type batch;
+            batch.push_back(poke_op(REG_I2C_CMD_STATUS, I2C_CMD_RD | ((num_bytes == i+1) ? (I2C_CMD_STOP | I2C_CMD_NACK) : 0)));
+            bytes.push_back(uint8_t(run_and_wait(batch, true)));
         }
         return bytes;
     }
@@ -131,6 +133,21 @@ public:
         return this->read_i2c(addr, num_bytes);
     }
 
+    //override write_eeprom so we can write a page at once
+    //the default implementation writes and waits once per byte
+    void write_eeprom(uint16_t addr, uint16_t offset, const byte_vector_t &bytes)
+    {
+        for (size_t i = 0; i < bytes.size();) {
+            //8 bytes is the smallest page of the common 8 bit offset EEPROMs
+            const size_t n = std::min(bytes.size() - i, EEPROM_PAGE_SIZE - ((offset + i) % EEPROM_PAGE_SIZE));
+            byte_vector_t cmd(1, uint8_t(offset + i));
+            cmd.insert(cmd.end(), bytes.begin() + i, bytes.begin() + i + n);
+            this->write_i2c(addr, cmd);
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10)); //worst case write
+            i += n;
+        }
+    }
+
 private:
     void i2c_wait(void) {
         for (size_t i = 0; i < 10; i++)
@@ -146,6 +163,36 @@ private:
         return (_iface->peek32(REG_I2C_CMD_STATUS) & I2C_ST_RXACK) == 0;
     }
 
+    static wb_iface::transaction_t poke_op(const wb_iface::wb_addr_type addr, const uint32_t data)
+    {
+        return wb_iface::transaction_t(wb_iface::transaction_t::POKE32, addr, data);
+    }
+
+    /*!
+     * Start a transfer with the pokes and read back the status in the
+     * same batch, and the data byte too if get_data is set. The control
+     * path is usually slower than a byte on the bus, so only a transfer
+     * which is still running costs the extra round trips of i2c_wait().
+     * \return the data byte if get_data is set, otherwise the status
+     */
+    uint32_t run_and_wait(wb_iface::transactions_type &batch, const bool get_data = false)
+    {
+        const size_t status_index = batch.size();
+        batch.push_back(wb_iface::transaction_t(wb_iface::transaction_t::PEEK32, REG_I2C_CMD_STATUS));
+        if (get_data) batch.push_back(wb_iface::transaction_t(wb_iface::transaction_t::PEEK32, REG_I2C_DATA));
+        _iface->transact(batch);
+
+        uint32_t status = uint32_t(batch[status_index].data);
+        if (status & I2C_ST_TIP) {
+            i2c_wait();
+            if (get_data) return uint8_t(_iface->peek32(REG_I2C_DATA));
+            status = _iface->peek32(REG_I2C_CMD_STATUS);
+        }
+        return get_data ? uint8_t(batch[status_index + 1].data) : status;
+    }
+
+    static const size_t EEPROM_PAGE_SIZE = 8;
+
     wb_iface::sptr _iface;
     const size_t _base;
 };
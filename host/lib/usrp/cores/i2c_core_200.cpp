@@ -20,6 +20,7 @@
 #include <uhd/utils/msg.hpp>
 #include <boost/thread/thread.hpp> //sleep
 #include <boost/thread/mutex.hpp>
+#include <algorithm>
 
 #define REG_I2C_WR_PRESCALER_LO (1 << 3) | 0
 #define REG_I2C_WR_PRESCALER_HI (1 << 3) | 1
@@ -124,6 +125,29 @@ public:
         return bytes;
     }
 
+    //override read_eeprom so we can write once, read all N bytes
+    //the default implementation calls read i2c once per byte
+    byte_vector_t read_eeprom(uint16_t addr, uint16_t offset, size_t num_bytes)
+    {
+        this->write_i2c(addr, byte_vector_t(1, uint8_t(offset)));
+        return this->read_i2c(addr, num_bytes);
+    }
+
+    //override write_eeprom so we can write a page at once
+    //the default implementation writes and waits once per byte
+    void write_eeprom(uint16_t addr, uint16_t offset, const byte_vector_t &bytes)
+    {
+        for (size_t i = 0; i < bytes.size();) {
+            //8 bytes is the smallest page of the common 8 bit offset EEPROMs
+            const size_t n = std::min(bytes.size() - i, EEPROM_PAGE_SIZE - ((offset + i) % EEPROM_PAGE_SIZE));
+            byte_vector_t cmd(1, uint8_t(offset + i));
+            cmd.insert(cmd.end(), bytes.begin() + i, bytes.begin() + i + n);
+            this->write_i2c(addr, cmd);
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10)); //worst case write
+            i += n;
+        }
+    }
+
 private:
     void i2c_wait(void) {
         for (size_t i = 0; i < 100; i++){
@@ -155,6 +179,8 @@ private:
     const size_t _base;
     const size_t _readback;
     boost::mutex _mutex;
+
+    static const size_t EEPROM_PAGE_SIZE = 8;
 };
 
 i2c_core_200::sptr i2c_core_200::make(wb_iface::sptr iface, const size_t base, const size_t readback){
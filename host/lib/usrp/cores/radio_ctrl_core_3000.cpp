@@ -21,7 +21,8 @@
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/utils/safe_call.hpp>
-#include <uhd/transport/bounded_buffer.hpp>
+#include <uhd/utils/trace.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
@@ -100,6 +101,35 @@ public:
         return this->wait_for_ack(true);
     }
 
+    /*******************************************************************
+     * Batched transactions:
+     * Send all commands, waiting only when the window is full,
+     * and collect the readback values from the acks in order.
+     ******************************************************************/
+    void transact(transactions_type &transactions)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        //the acks of the commands sent before the batch come first
+        size_t num_skip = _outstanding_seqs.size();
+        size_t num_acked = 0;
+        size_t num_to_ack = 0; //up to and including the last readback
+        for (size_t i = 0; i < transactions.size(); i++) {
+            const transaction_t &t = transactions[i];
+            if (t.op == transaction_t::POKE32) {
+                this->send_pkt(t.addr/4, uint32_t(t.data));
+            } else {
+                this->send_pkt(SR_READBACK, t.addr/8);
+                num_to_ack = i + 1;
+            }
+            while (_outstanding_seqs.size() >= _resp_queue_size) {
+                this->recv_batch_ack(transactions, num_skip, num_acked);
+            }
+        }
+        while (num_acked < num_to_ack) {
+            this->recv_batch_ack(transactions, num_skip, num_acked);
+        }
+    }
+
     /*******************************************************************
      * Update methods for time
      ******************************************************************/
@@ -157,6 +187,9 @@ private:
         packet_info.has_tsi = false;
         packet_info.has_tsf = _use_time;
         packet_info.has_tlr = false;
+        if (_use_time) {
+            UHD_TRACE_INSTANT(POINT_TIMED_CMD, packet_info.tsf);
+        }
 
         //load header
         if (_bige) vrt::if_hdr_pack_be(pkt, packet_info);
@@ -173,113 +206,135 @@ private:
         _seq_out++;//inc seq for next call
     }
 
+    /*!
+     * Wait for acks until the window of outstanding commands has room.
+     * For a readback, wait for all acks and return the readback value.
+     */
     UHD_INLINE uint64_t wait_for_ack(const bool readback)
     {
+        uint64_t value = 0;
         while (readback or (_outstanding_seqs.size() >= _resp_queue_size))
         {
-            //get seq to ack from outstanding packets list
-            UHD_ASSERT_THROW(not _outstanding_seqs.empty());
-            const size_t seq_to_ack = _outstanding_seqs.front();
-            _outstanding_seqs.pop();
-
-            //parse the packet
-            vrt::if_packet_info_t packet_info;
-            resp_buff_type resp_buff;
-            memset(&resp_buff, 0x00, sizeof(resp_buff));
-            uint32_t const *pkt = NULL;
-            managed_recv_buffer::sptr buff;
-
-            //get buffer from response endpoint - or die in timeout
-            if (_resp_xport)
-            {
-                buff = _resp_xport->get_recv_buff(_timeout);
-                try
-                {
-                    UHD_ASSERT_THROW(bool(buff));
-                    UHD_ASSERT_THROW(buff->size() > 0);
-                }
-                catch(const std::exception &ex)
-                {
-                    throw uhd::io_error(str(boost::format("Radio ctrl (%s) no response packet - %s") % _name % ex.what()));
-                }
-                pkt = buff->cast<const uint32_t *>();
-                packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
-            }
+            this->recv_ack(_timeout, value);
+            if (readback and _outstanding_seqs.empty()) return value;
+        }
+        return 0;
+    }
 
-            //get buffer from response endpoint - or die in timeout
-            else
-            {
-                /*
-                 * Couldn't get message with haste.
-                 * Now check both possible queues for messages.
-                 * Messages should come in on _resp_queue,
-                 * but could end up in dump_queue.
-                 * If we don't get a message --> Die in timeout.
-                 */
-                double accum_timeout = 0.0;
-                const double short_timeout = 0.005; // == 5ms
-                while(not ((_resp_queue.pop_with_haste(resp_buff))
-                        || (check_dump_queue(resp_buff))
-                        || (_resp_queue.pop_with_timed_wait(resp_buff, short_timeout))
-                        )){
-                    /*
-                     * If a message couldn't be received within a given timeout
-                     * --> throw AssertionError!
-                     */
-                    accum_timeout += short_timeout;
-                    UHD_ASSERT_THROW(accum_timeout < _timeout);
-                }
-
-                pkt = resp_buff.data;
-                packet_info.num_packet_words32 = sizeof(resp_buff)/sizeof(uint32_t);
-            }
+    UHD_INLINE void recv_batch_ack(transactions_type &transactions, size_t &num_skip, size_t &num_acked)
+    {
+        uint64_t value;
+        this->recv_ack(_timeout, value);
+        if (num_skip > 0) {
+            num_skip--;
+            return;
+        }
+        transaction_t &t = transactions[num_acked++];
+        if (t.op == transaction_t::PEEK64) t.data = value;
+        if (t.op == transaction_t::PEEK32) t.data = ((t.addr/4) & 0x1)? (value >> 32) : (value & 0xffffffff);
+    }
 
-            //parse the buffer
+    //! Receive and check the ack of the oldest outstanding command
+    void recv_ack(const double timeout, uint64_t &value)
+    {
+        UHD_ASSERT_THROW(not _outstanding_seqs.empty());
+
+        //parse the packet
+        vrt::if_packet_info_t packet_info;
+        resp_buff_type resp_buff;
+        memset(&resp_buff, 0x00, sizeof(resp_buff));
+        uint32_t const *pkt = NULL;
+        managed_recv_buffer::sptr buff;
+
+        //get buffer from response endpoint - or die in timeout
+        if (_resp_xport)
+        {
+            buff = _resp_xport->get_recv_buff(timeout);
             try
             {
-                packet_info.link_type = _link_type;
-                if (_bige) vrt::if_hdr_unpack_be(pkt, packet_info);
-                else vrt::if_hdr_unpack_le(pkt, packet_info);
+                UHD_ASSERT_THROW(bool(buff));
+                UHD_ASSERT_THROW(buff->size() > 0);
             }
             catch(const std::exception &ex)
             {
-                UHD_MSG(error) << "Radio ctrl bad VITA packet: " << ex.what() << std::endl;
-                if (buff){
-                    UHD_VAR(buff->size());
-                }
-                else{
-                    UHD_MSG(status) << "buff is NULL" << std::endl;
-                }
-                UHD_MSG(status) << std::hex << pkt[0] << std::dec << std::endl;
-                UHD_MSG(status) << std::hex << pkt[1] << std::dec << std::endl;
-                UHD_MSG(status) << std::hex << pkt[2] << std::dec << std::endl;
-                UHD_MSG(status) << std::hex << pkt[3] << std::dec << std::endl;
+                throw uhd::io_error(str(boost::format("Radio ctrl (%s) no response packet - %s") % _name % ex.what()));
             }
+            pkt = buff->cast<const uint32_t *>();
+            packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
+        }
 
-            //check the buffer
-            try
-            {
-                UHD_ASSERT_THROW(packet_info.has_sid);
-                UHD_ASSERT_THROW(packet_info.sid == uint32_t((_sid >> 16) | (_sid << 16)));
-                UHD_ASSERT_THROW(packet_info.packet_count == (seq_to_ack & 0xfff));
-                UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
-                UHD_ASSERT_THROW(packet_info.packet_type == _packet_type);
-            }
-            catch(const std::exception &ex)
-            {
-                throw uhd::io_error(str(boost::format("Radio ctrl (%s) packet parse error - %s") % _name % ex.what()));
+        //get buffer from response endpoint - or die in timeout
+        else
+        {
+            /*
+             * Couldn't get message with haste.
+             * Now check both possible queues for messages.
+             * Messages should come in on _resp_queue,
+             * but could end up in dump_queue.
+             * If we don't get a message --> Die in timeout.
+             */
+            double accum_timeout = 0.0;
+            const double short_timeout = 0.005; // == 5ms
+            while(not ((_resp_queue.pop_with_haste(resp_buff))
+                    || (check_dump_queue(resp_buff))
+                    || (_resp_queue.pop_with_timed_wait(resp_buff, short_timeout))
+                    )){
+                /*
+                 * If a message couldn't be received within a given timeout
+                 * --> throw AssertionError!
+                 */
+                accum_timeout += short_timeout;
+                UHD_ASSERT_THROW(accum_timeout < timeout);
             }
 
-            //return the readback value
-            if (readback and _outstanding_seqs.empty())
-            {
-                const uint64_t hi = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+0]) : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
-                const uint64_t lo = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+1]) : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
-                return ((hi << 32) | lo);
+            pkt = resp_buff.data;
+            packet_info.num_packet_words32 = sizeof(resp_buff)/sizeof(uint32_t);
+        }
+
+        //get seq to ack from outstanding packets list
+        const size_t seq_to_ack = _outstanding_seqs.front();
+        _outstanding_seqs.pop();
+
+        //parse the buffer
+        try
+        {
+            packet_info.link_type = _link_type;
+            if (_bige) vrt::if_hdr_unpack_be(pkt, packet_info);
+            else vrt::if_hdr_unpack_le(pkt, packet_info);
+        }
+        catch(const std::exception &ex)
+        {
+            UHD_MSG(error) << "Radio ctrl bad VITA packet: " << ex.what() << std::endl;
+            if (buff){
+                UHD_VAR(buff->size());
+            }
+            else{
+                UHD_MSG(status) << "buff is NULL" << std::endl;
             }
+            UHD_MSG(status) << std::hex << pkt[0] << std::dec << std::endl;
+            UHD_MSG(status) << std::hex << pkt[1] << std::dec << std::endl;
+            UHD_MSG(status) << std::hex << pkt[2] << std::dec << std::endl;
+            UHD_MSG(status) << std::hex << pkt[3] << std::dec << std::endl;
         }
 
-        return 0;
+        //check the buffer
+        try
+        {
+            UHD_ASSERT_THROW(packet_info.has_sid);
+            UHD_ASSERT_THROW(packet_info.sid == uint32_t((_sid >> 16) | (_sid << 16)));
+            UHD_ASSERT_THROW(packet_info.packet_count == (seq_to_ack & 0xfff));
+            UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
+            UHD_ASSERT_THROW(packet_info.packet_type == _packet_type);
+        }
+        catch(const std::exception &ex)
+        {
+            throw uhd::io_error(str(boost::format("Radio ctrl (%s) packet parse error - %s") % _name % ex.what()));
+        }
+
+        //return the readback value
+        const uint64_t hi = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+0]) : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
+        const uint64_t lo = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+1]) : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
+        value = ((hi << 32) | lo);
     }
 
     /*
@@ -333,7 +388,7 @@ private:
     double _tick_rate;
     double _timeout;
     std::queue<size_t> _outstanding_seqs;
-    bounded_buffer<resp_buff_type> _resp_queue;
+    spsc_bounded_buffer<resp_buff_type> _resp_queue; //one pushing task, popped under _mutex
     const size_t _resp_queue_size;
 };
 
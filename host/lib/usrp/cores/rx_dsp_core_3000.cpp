@@ -17,6 +17,7 @@
 
 #include "rx_dsp_core_3000.hpp"
 #include "dsp_core_utils.hpp"
+#include "wb_shadow_iface.hpp"
 #include <uhd/types/dict.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/utils/math.hpp>
@@ -60,8 +61,15 @@ public:
         const size_t dsp_base,
         const bool is_b200
     ):
-        _iface(iface), _dsp_base(dsp_base), _is_b200(is_b200)
+        _dsp_base(dsp_base), _is_b200(is_b200)
     {
+        //skip rewrites of unchanged settings, the decim write resets the filters
+        wb_shadow_iface::sptr shadow = wb_shadow_iface::make(iface);
+        shadow->shadow(REG_DSP_RX_FREQ);
+        shadow->shadow(REG_DSP_RX_SCALE_IQ);
+        shadow->shadow(REG_DSP_RX_MUX);
+        _iface = shadow;
+
         // previously uninitialized - assuming zero for all
         _link_rate = _host_extra_scaling = _fxpt_scalar_correction = 0.0;
 
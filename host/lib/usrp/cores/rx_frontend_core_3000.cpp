@@ -17,6 +17,7 @@
 
 #include "rx_frontend_core_3000.hpp"
 #include "dsp_core_utils.hpp"
+#include "wb_shadow_iface.hpp"
 #include <boost/math/special_functions/round.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/bind.hpp>
@@ -64,9 +65,15 @@ public:
         _i_dc_off(0), _q_dc_off(0),
         _adc_rate(0.0),
         _fe_conn(fe_connection_t("IQ")),
-        _iface(iface), _base(base)
+        _base(base)
     {
-        //NOP
+        //skip rewrites of unchanged settings, the DC offset writes carry flags
+        wb_shadow_iface::sptr shadow = wb_shadow_iface::make(iface);
+        shadow->shadow(REG_RX_FE_MAG_CORRECTION);
+        shadow->shadow(REG_RX_FE_PHASE_CORRECTION);
+        shadow->shadow(REG_RX_FE_MAPPING);
+        shadow->shadow(REG_RX_FE_HET_CORDIC_PHASE);
+        _iface = shadow;
     }
 
     void set_adc_rate(const double rate) {
@@ -49,32 +49,11 @@ public:
     ){
         boost::lock_guard<boost::mutex> lock(_mutex);
 
-        //load SPI divider
-        size_t spi_divider = _div;
-        if (config.use_custom_divider) {
-            //The resulting SPI frequency will be f_system/(2*(divider+1))
-            //This math ensures the frequency will be equal to or less than the target
-            spi_divider = (config.divider-1)/2;
-        }
-
-        //conditionally send SPI divider
-        if (spi_divider != _divider_cache) {
-            _iface->poke32(SPI_DIV, spi_divider);
-            _divider_cache = spi_divider;
-        }
-
-        //load control word
-        uint32_t ctrl_word = 0;
-        ctrl_word |= ((which_slave & 0xffffff) << 0);
-        ctrl_word |= ((num_bits & 0x3f) << 24);
-        if (config.mosi_edge == spi_config_t::EDGE_FALL) ctrl_word |= (1 << 31);
-        if (config.miso_edge == spi_config_t::EDGE_RISE) ctrl_word |= (1 << 30);
-
-        //conditionally send control word
-        if (_ctrl_word_cache != ctrl_word)
-        {
-            _iface->poke32(SPI_CTRL, ctrl_word);
-            _ctrl_word_cache = ctrl_word;
+        //conditionally send SPI divider and control word
+        wb_iface::transactions_type transactions;
+        this->load_config(transactions, which_slave, config, num_bits);
+        for (size_t i = 0; i < transactions.size(); i++){
+            _iface->poke32(transactions[i].addr, uint32_t(transactions[i].data));
         }
 
         //load data word (must be in upper bits)
@@ -92,6 +71,27 @@ public:
         return 0;
     }
 
+    void write_spi_batch(
+        int which_slave,
+        const spi_config_t &config,
+        const std::vector<uint32_t> &data,
+        size_t num_bits
+    ){
+        boost::lock_guard<boost::mutex> lock(_mutex);
+
+        //queue the configuration once and all the data words,
+        //then wait for the whole batch at once
+        wb_iface::transactions_type transactions;
+        transactions.reserve(data.size() + 2);
+        this->load_config(transactions, which_slave, config, num_bits);
+        for (size_t i = 0; i < data.size(); i++){
+            transactions.push_back(wb_iface::transaction_t(
+                wb_iface::transaction_t::POKE32, SPI_DATA, data[i] << (32 - num_bits)
+            ));
+        }
+        _iface->transact(transactions);
+    }
+
     void set_shutdown(const bool shutdown)
     {
         _shutdown_cache = shutdown;
@@ -109,6 +109,45 @@ public:
     }
 
 private:
+    //! Queue the divider and control word writes which are not cached
+    void load_config(
+        wb_iface::transactions_type &transactions,
+        int which_slave,
+        const spi_config_t &config,
+        size_t num_bits
+    ){
+        //load SPI divider
+        size_t spi_divider = _div;
+        if (config.use_custom_divider) {
+            //The resulting SPI frequency will be f_system/(2*(divider+1))
+            //This math ensures the frequency will be equal to or less than the target
+            spi_divider = (config.divider-1)/2;
+        }
+
+        //conditionally send SPI divider
+        if (spi_divider != _divider_cache) {
+            transactions.push_back(wb_iface::transaction_t(
+                wb_iface::transaction_t::POKE32, SPI_DIV, spi_divider
+            ));
+            _divider_cache = spi_divider;
+        }
+
+        //load control word
+        uint32_t ctrl_word = 0;
+        ctrl_word |= ((which_slave & 0xffffff) << 0);
+        ctrl_word |= ((num_bits & 0x3f) << 24);
+        if (config.mosi_edge == spi_config_t::EDGE_FALL) ctrl_word |= (1 << 31);
+        if (config.miso_edge == spi_config_t::EDGE_RISE) ctrl_word |= (1 << 30);
+
+        //conditionally send control word
+        if (_ctrl_word_cache != ctrl_word)
+        {
+            transactions.push_back(wb_iface::transaction_t(
+                wb_iface::transaction_t::POKE32, SPI_CTRL, ctrl_word
+            ));
+            _ctrl_word_cache = ctrl_word;
+        }
+    }
 
     wb_iface::sptr _iface;
     const size_t _base;
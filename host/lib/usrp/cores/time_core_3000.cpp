@@ -19,6 +19,7 @@
 #include <uhd/utils/safe_call.hpp>
 #include <uhd/utils/msg.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
 
 #define REG_TIME_HI       _base + 0
 #define REG_TIME_LO       _base + 4
@@ -42,7 +43,9 @@ struct time_core_3000_impl : time_core_3000
     ):
         _iface(iface),
         _base(base),
-        _readback_bases(readback_bases)
+        _readback_bases(readback_bases),
+        _estimate_max_age(0.0),
+        _estimate_valid(false)
     {
         this->set_tick_rate(1); //init to non zero
     }
@@ -57,16 +60,18 @@ struct time_core_3000_impl : time_core_3000
 
     void set_tick_rate(const double rate)
     {
+        boost::mutex::scoped_lock lock(_estimate_mutex);
         _tick_rate = rate;
+        _estimate_valid = false;
     }
 
     void self_test(void)
     {
         const size_t sleep_millis = 100;
         UHD_MSG(status) << "Performing timer loopback test... " << std::flush;
-        const time_spec_t time0 = this->get_time_now();
+        const time_spec_t time0 = this->get_time_now_exact();
         boost::this_thread::sleep(boost::posix_time::milliseconds(sleep_millis));
-        const time_spec_t time1 = this->get_time_now();
+        const time_spec_t time1 = this->get_time_now_exact();
         const double approx_secs = (time1 - time0).get_real_secs();
         const bool test_fail = (approx_secs > 0.15) or (approx_secs < 0.05);
         UHD_MSG(status) << ((test_fail)? " fail" : "pass") << std::endl;
@@ -81,11 +86,58 @@ struct time_core_3000_impl : time_core_3000
     }
 
     uhd::time_spec_t get_time_now(void)
+    {
+        boost::mutex::scoped_lock lock(_estimate_mutex);
+        if (_estimate_max_age <= 0.0)
+        {
+            return this->get_time_now_exact();
+        }
+
+        const time_spec_t host_now = time_spec_t::get_system_time();
+        if (_estimate_valid and (host_now - _anchor_host_time).get_real_secs() < _estimate_max_age)
+        {
+            return _anchor_time + (host_now - _anchor_host_time);
+        }
+
+        //the time jumps on the next PPS, so do not anchor to the old time
+        if (host_now < _estimate_hold_until)
+        {
+            return this->get_time_now_exact();
+        }
+
+        //anchor to the host time half way through the register read
+        const time_spec_t host_before = time_spec_t::get_system_time();
+        _anchor_time = this->get_time_now_exact();
+        const time_spec_t host_after = time_spec_t::get_system_time();
+        _anchor_host_time = host_before + time_spec_t((host_after - host_before).get_real_secs()/2);
+        _estimate_valid = true;
+        return _anchor_time;
+    }
+
+    uhd::time_spec_t get_time_now_exact(void)
     {
         const uint64_t ticks = _iface->peek64(_readback_bases.rb_now);
         return time_spec_t::from_ticks(ticks, _tick_rate);
     }
 
+    void set_time_estimation(const double max_age)
+    {
+        boost::mutex::scoped_lock lock(_estimate_mutex);
+        _estimate_max_age = max_age;
+        _estimate_valid = false;
+    }
+
+    void update_time_estimate(const uhd::time_spec_t &time_passed)
+    {
+        boost::mutex::scoped_lock lock(_estimate_mutex);
+        if (not _estimate_valid) return;
+        const time_spec_t estimate = _anchor_time + (time_spec_t::get_system_time() - _anchor_host_time);
+        if (time_passed > estimate)
+        {
+            _anchor_time += time_passed - estimate;
+        }
+    }
+
     uhd::time_spec_t get_time_last_pps(void)
     {
         const uint64_t ticks = _iface->peek64(_readback_bases.rb_pps);
@@ -94,6 +146,7 @@ struct time_core_3000_impl : time_core_3000
 
     void set_time_now(const uhd::time_spec_t &time)
     {
+        this->_invalidate_estimate(0.0);
         const uint64_t ticks = time.to_ticks(_tick_rate);
         _iface->poke32(REG_TIME_HI, uint32_t(ticks >> 32));
         _iface->poke32(REG_TIME_LO, uint32_t(ticks >> 0));
@@ -102,6 +155,7 @@ struct time_core_3000_impl : time_core_3000
 
     void set_time_sync(const uhd::time_spec_t &time)
     {
+        this->_invalidate_estimate(0.0);
         const uint64_t ticks = time.to_ticks(_tick_rate);
         _iface->poke32(REG_TIME_HI, uint32_t(ticks >> 32));
         _iface->poke32(REG_TIME_LO, uint32_t(ticks >> 0));
@@ -110,18 +164,38 @@ struct time_core_3000_impl : time_core_3000
 
     void set_time_next_pps(const uhd::time_spec_t &time)
     {
+        this->_invalidate_estimate(PPS_HOLD_SECS);
         const uint64_t ticks = time.to_ticks(_tick_rate);
         _iface->poke32(REG_TIME_HI, uint32_t(ticks >> 32));
         _iface->poke32(REG_TIME_LO, uint32_t(ticks >> 0));
         _iface->poke32(REG_TIME_CTRL, CTRL_LATCH_TIME_PPS);
     }
 
+    void _invalidate_estimate(const double hold_secs)
+    {
+        boost::mutex::scoped_lock lock(_estimate_mutex);
+        _estimate_valid = false;
+        _estimate_hold_until = time_spec_t::get_system_time() + time_spec_t(hold_secs);
+    }
+
+    //a PPS edge is at most one second away, plus some margin
+    static const double PPS_HOLD_SECS;
+
     wb_iface::sptr _iface;
     const size_t _base;
     const readback_bases_type _readback_bases;
     double _tick_rate;
+
+    boost::mutex _estimate_mutex;
+    double _estimate_max_age;
+    bool _estimate_valid;
+    time_spec_t _anchor_time;
+    time_spec_t _anchor_host_time;
+    time_spec_t _estimate_hold_until;
 };
 
+const double time_core_3000_impl::PPS_HOLD_SECS = 1.1;
+
 time_core_3000::sptr time_core_3000::make(
     wb_iface::sptr iface, const size_t base,
     const readback_bases_type &readback_bases
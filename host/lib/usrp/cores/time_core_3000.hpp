@@ -47,8 +47,30 @@ public:
 
     virtual void set_tick_rate(const double rate) = 0;
 
+    /*!
+     * Get the current device time.
+     * With time estimation enabled, this extrapolates the time from the
+     * last register read using the host clock, and only reads the
+     * register again once the estimate is older than the maximum age.
+     */
     virtual uhd::time_spec_t get_time_now(void) = 0;
 
+    //! Get the current device time from a register read, always
+    virtual uhd::time_spec_t get_time_now_exact(void) = 0;
+
+    /*!
+     * Enable estimating the device time from the host clock.
+     * \param max_age seconds between register reads, 0 to disable
+     */
+    virtual void set_time_estimation(const double max_age) = 0;
+
+    /*!
+     * Tell the time estimate about a device time that has already passed,
+     * e.g. the end of a received packet. An estimate that lags behind it
+     * is moved forward.
+     */
+    virtual void update_time_estimate(const uhd::time_spec_t &time_passed) = 0;
+
     virtual uhd::time_spec_t get_time_last_pps(void) = 0;
 
     virtual void set_time_now(const uhd::time_spec_t &time) = 0;
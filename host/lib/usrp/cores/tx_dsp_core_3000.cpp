@@ -17,6 +17,7 @@
 
 #include "tx_dsp_core_3000.hpp"
 #include "dsp_core_utils.hpp"
+#include "wb_shadow_iface.hpp"
 #include <uhd/types/dict.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/utils/math.hpp>
@@ -50,8 +51,14 @@ public:
         wb_iface::sptr iface,
         const size_t dsp_base
     ):
-        _iface(iface), _dsp_base(dsp_base)
+        _dsp_base(dsp_base)
     {
+        //skip rewrites of unchanged settings, the interp write resets the filters
+        wb_shadow_iface::sptr shadow = wb_shadow_iface::make(iface);
+        shadow->shadow(REG_DSP_TX_FREQ);
+        shadow->shadow(REG_DSP_TX_SCALE_IQ);
+        _iface = shadow;
+
         // previously uninitialized - assuming zero for all
         _link_rate = _host_extra_scaling = _fxpt_scalar_correction = 0.0;
 
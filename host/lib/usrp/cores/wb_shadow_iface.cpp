@@ -0,0 +1,149 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "wb_shadow_iface.hpp"
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/make_shared.hpp>
+
+using namespace uhd;
+
+wb_shadow_iface::~wb_shadow_iface(void){
+    /* NOP */
+}
+
+class wb_shadow_iface_impl : public wb_shadow_iface{
+public:
+    wb_shadow_iface_impl(wb_iface::sptr iface):
+        _iface(iface), _num_skipped(0)
+    {
+        /* NOP */
+    }
+
+    void shadow(const wb_addr_type addr){
+        boost::mutex::scoped_lock lock(_mutex);
+        _regs[addr] = reg_state_t();
+    }
+
+    void force_poke32(const wb_addr_type addr, const uint32_t data){
+        boost::mutex::scoped_lock lock(_mutex);
+        _iface->poke32(addr, data);
+        this->update(addr, data);
+    }
+
+    void invalidate(void){
+        boost::mutex::scoped_lock lock(_mutex);
+        for (reg_map_type::iterator it = _regs.begin(); it != _regs.end(); ++it){
+            it->second.valid = false;
+        }
+    }
+
+    size_t get_num_skipped(void) const{
+        boost::mutex::scoped_lock lock(_mutex);
+        return _num_skipped;
+    }
+
+    /*******************************************************************
+     * wb_iface
+     ******************************************************************/
+    void poke32(const wb_addr_type addr, const uint32_t data){
+        boost::mutex::scoped_lock lock(_mutex);
+        if (this->unchanged(addr, data)){
+            _num_skipped++;
+            return;
+        }
+        _iface->poke32(addr, data);
+        this->update(addr, data);
+    }
+
+    uint32_t peek32(const wb_addr_type addr){
+        return _iface->peek32(addr);
+    }
+
+    void poke64(const wb_addr_type addr, const uint64_t data){
+        boost::mutex::scoped_lock lock(_mutex);
+        //a 64 bit write covers two registers, forget both
+        this->forget(addr);
+        this->forget(addr + 4);
+        _iface->poke64(addr, data);
+    }
+
+    uint64_t peek64(const wb_addr_type addr){
+        return _iface->peek64(addr);
+    }
+
+    void transact(transactions_type &transactions){
+        boost::mutex::scoped_lock lock(_mutex);
+        //drop the unchanged writes and send the rest as one batch
+        transactions_type sent;
+        sent.reserve(transactions.size());
+        std::vector<size_t> indexes;
+        indexes.reserve(transactions.size());
+        for (size_t i = 0; i < transactions.size(); i++){
+            const transaction_t &t = transactions[i];
+            if (t.op == transaction_t::POKE32 and this->unchanged(t.addr, uint32_t(t.data))){
+                _num_skipped++;
+                continue;
+            }
+            sent.push_back(t);
+            indexes.push_back(i);
+        }
+        if (sent.empty()) return;
+        _iface->transact(sent);
+
+        for (size_t j = 0; j < sent.size(); j++){
+            transactions[indexes[j]].data = sent[j].data;
+            if (sent[j].op == transaction_t::POKE32) this->update(sent[j].addr, uint32_t(sent[j].data));
+        }
+    }
+
+private:
+    struct reg_state_t{
+        reg_state_t(void): valid(false), value(0){}
+        bool valid;
+        uint32_t value;
+    };
+    typedef boost::unordered_map<wb_addr_type, reg_state_t> reg_map_type;
+
+    //! Would this write leave a shadowed register as it is? Call with the mutex held
+    bool unchanged(const wb_addr_type addr, const uint32_t data) const{
+        reg_map_type::const_iterator it = _regs.find(addr);
+        return it != _regs.end() and it->second.valid and it->second.value == data;
+    }
+
+    //! Remember a written value, call with the mutex held
+    void update(const wb_addr_type addr, const uint32_t data){
+        reg_map_type::iterator it = _regs.find(addr);
+        if (it == _regs.end()) return;
+        it->second.valid = true;
+        it->second.value = data;
+    }
+
+    void forget(const wb_addr_type addr){
+        reg_map_type::iterator it = _regs.find(addr);
+        if (it != _regs.end()) it->second.valid = false;
+    }
+
+    wb_iface::sptr _iface;
+    reg_map_type _regs;
+    size_t _num_skipped;
+    mutable boost::mutex _mutex;
+};
+
+wb_shadow_iface::sptr wb_shadow_iface::make(wb_iface::sptr iface){
+    return boost::make_shared<wb_shadow_iface_impl>(iface);
+}
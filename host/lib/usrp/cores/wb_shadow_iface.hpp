@@ -0,0 +1,56 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_USRP_WB_SHADOW_IFACE_HPP
+#define INCLUDED_LIBUHD_USRP_WB_SHADOW_IFACE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/wb_iface.hpp>
+#include <boost/utility.hpp>
+#include <boost/shared_ptr.hpp>
+
+/*!
+ * A write-through register shadow on top of a wb_iface.
+ *
+ * The shadowed registers remember the last value written to them, and
+ * a poke32() of the same value again is dropped. Only registers that
+ * hold state may be shadowed: strobes and registers whose writes start
+ * an action must be written every time. All other accesses go through
+ * unchanged.
+ */
+class wb_shadow_iface : public uhd::wb_iface, boost::noncopyable{
+public:
+    typedef boost::shared_ptr<wb_shadow_iface> sptr;
+
+    virtual ~wb_shadow_iface(void) = 0;
+
+    static sptr make(uhd::wb_iface::sptr iface);
+
+    //! Shadow a register, its first write is always sent
+    virtual void shadow(const wb_addr_type addr) = 0;
+
+    //! Write a register even if the value is unchanged
+    virtual void force_poke32(const wb_addr_type addr, const uint32_t data) = 0;
+
+    //! Forget the shadowed values, such as after a reset of the registers
+    virtual void invalidate(void) = 0;
+
+    //! Get the number of writes dropped because the value was unchanged
+    virtual size_t get_num_skipped(void) const = 0;
+};
+
+#endif /* INCLUDED_LIBUHD_USRP_WB_SHADOW_IFACE_HPP */
@@ -557,8 +557,7 @@ private:
     {
         boost::mutex::scoped_lock lock(_spi_mutex);
         ROUTE_SPI(_iface, dest);
-        BOOST_FOREACH(uint32_t value, values)
-            WRITE_SPI(_iface, value);
+        _iface->write_spi_batch(dboard_iface::UNIT_TX, spi_config_t::EDGE_RISE, values, 32);
     }
 
     void set_cpld_field(ubx_cpld_field_id_t id, uint32_t value)
@@ -797,6 +796,14 @@ private:
         device_addr_t tune_args = subtree->access<device_addr_t>("tune_args").get();
         is_int_n = boost::iequals(tune_args.get("mode_n",""), "integer");
         UHD_LOGV(rarely) << boost::format("UBX TX: the requested frequency is %f MHz") % (freq/1e6) << std::endl;
+
+        /*
+         * If the user sets 'vco_cache' in the tuning args, known VCO sub-bands
+         * are programmed directly instead of running the VCO auto selection.
+         */
+        const bool use_vco_cache = tune_args.has_key("vco_cache");
+        _txlo1->set_vco_cache_enabled(use_vco_cache);
+        _txlo2->set_vco_cache_enabled(use_vco_cache);
         double target_pfd_freq = _tx_target_pfd_freq;
         if (is_int_n and tune_args.has_key("int_n_step"))
         {
@@ -953,6 +960,9 @@ private:
         property_tree::sptr subtree = this->get_rx_subtree();
         device_addr_t tune_args = subtree->access<device_addr_t>("tune_args").get();
         is_int_n = boost::iequals(tune_args.get("mode_n",""), "integer");
+        const bool use_vco_cache = tune_args.has_key("vco_cache");
+        _rxlo1->set_vco_cache_enabled(use_vco_cache);
+        _rxlo2->set_vco_cache_enabled(use_vco_cache);
         double target_pfd_freq = _rx_target_pfd_freq;
         if (is_int_n and tune_args.has_key("int_n_step"))
         {
@@ -489,35 +489,44 @@ private:    //Functions
     }
 
     void _config_lo1_route(lo_config_route_t source)
+    {
+        _set_lo1_route(source);
+        _cpld_regs->rf0_reg2.flush();
+    }
+
+    void _config_lo2_route(lo_config_route_t source)
+    {
+        _set_lo2_route(source);
+        _cpld_regs->if0_reg2.flush();
+    }
+
+    void _set_lo1_route(lo_config_route_t source)
     {
         //Route SPI LEs through CPLD (will not assert them)
         _cpld_regs->rf0_reg2.set(rm::rf0_reg2_t::LO1_LE_CH1, bool2bin(source==LO_CONFIG_CH1||source==LO_CONFIG_BOTH));
         _cpld_regs->rf0_reg2.set(rm::rf0_reg2_t::LO1_LE_CH2, bool2bin(source==LO_CONFIG_CH2||source==LO_CONFIG_BOTH));
-        _cpld_regs->rf0_reg2.flush();
     }
 
-    void _config_lo2_route(lo_config_route_t source)
+    void _set_lo2_route(lo_config_route_t source)
     {
         //Route SPI LEs through CPLD (will not assert them)
         _cpld_regs->if0_reg2.set(rm::if0_reg2_t::LO2_LE_CH1, bool2bin(source==LO_CONFIG_CH1||source==LO_CONFIG_BOTH));
         _cpld_regs->if0_reg2.set(rm::if0_reg2_t::LO2_LE_CH2, bool2bin(source==LO_CONFIG_CH2||source==LO_CONFIG_BOTH));
-        _cpld_regs->if0_reg2.flush();
     }
 
     void _write_lo_spi(dboard_iface::unit_t unit, const std::vector<uint32_t> &regs)
     {
-        BOOST_FOREACH(uint32_t reg, regs) {
-             spi_config_t spi_config = spi_config_t(spi_config_t::EDGE_RISE);
-             spi_config.use_custom_divider = true;
-             spi_config.divider = 67;
-            _db_iface->write_spi(unit, spi_config, reg, 32);
-        }
+        spi_config_t spi_config = spi_config_t(spi_config_t::EDGE_RISE);
+        spi_config.use_custom_divider = true;
+        spi_config.divider = 67;
+        _db_iface->write_spi_batch(unit, spi_config, regs, 32);
     }
 
     void _commit()
     {
-        //Commit everything except the LO synthesizers
-        _cpld_regs->flush();
+        //The CPLD writes of a timed commit advance the command time to space
+        //their enables, the following commands are issued at the original time
+        const time_spec_t cmd_time = _gpio_iface->get_time();
 
         // Disable unused LO synthesizers
         _lo1_enable[size_t(CH1)] = _lo1_src[size_t(CH1)] == LO_INTERNAL  ||
@@ -541,71 +550,74 @@ private:    //Functions
         _lo2_iface[size_t(CH1)]->set_output_enable(adf435x_iface::RF_OUTPUT_A, _lo2_enable[size_t(CH1)].get());
         _lo2_iface[size_t(CH2)]->set_output_enable(adf435x_iface::RF_OUTPUT_A, _lo2_enable[size_t(CH2)].get());
 
-        //Commit LO1 frequency
         // Commit Channel 1's settings to both channels simultaneously if the frequency is the same.
-        bool simultaneous_commit_lo1 = _lo1_freq[size_t(CH1)].is_dirty() and
-                                       _lo1_freq[size_t(CH2)].is_dirty() and
-                                       _lo1_freq[size_t(CH1)].get() == _lo1_freq[size_t(CH2)].get() and
-                                       _lo1_enable[size_t(CH1)].get() == _lo1_enable[size_t(CH2)].get();
-
-        if (simultaneous_commit_lo1) {
-            _config_lo1_route(LO_CONFIG_BOTH);
-            //Only commit one of the channels. The route LO_CONFIG_BOTH
-            //will ensure that the LEs for both channels are enabled
-            _lo1_iface[size_t(CH1)]->commit();
-            _lo1_freq[size_t(CH1)].mark_clean();
-            _lo1_freq[size_t(CH2)].mark_clean();
-            _lo1_enable[size_t(CH1)].mark_clean();
-            _lo1_enable[size_t(CH2)].mark_clean();
-            _config_lo1_route(LO_CONFIG_NONE);
-        } else {
-            if (_lo1_freq[size_t(CH1)].is_dirty() || _lo1_enable[size_t(CH1)].is_dirty()) {
-                _config_lo1_route(LO_CONFIG_CH1);
-                _lo1_iface[size_t(CH1)]->commit();
-                _lo1_freq[size_t(CH1)].mark_clean();
-                _lo1_enable[size_t(CH1)].mark_clean();
-                _config_lo1_route(LO_CONFIG_NONE);
+        const bool simultaneous_commit_lo1 = _lo1_freq[size_t(CH1)].is_dirty() and
+                                             _lo1_freq[size_t(CH2)].is_dirty() and
+                                             _lo1_freq[size_t(CH1)].get() == _lo1_freq[size_t(CH2)].get() and
+                                             _lo1_enable[size_t(CH1)].get() == _lo1_enable[size_t(CH2)].get();
+
+        const bool simultaneous_commit_lo2 = _lo2_freq[size_t(CH1)].is_dirty() and
+                                             _lo2_freq[size_t(CH2)].is_dirty() and
+                                             _lo2_freq[size_t(CH1)].get() == _lo2_freq[size_t(CH2)].get() and
+                                             _lo2_enable[size_t(CH1)].get() == _lo2_enable[size_t(CH2)].get();
+
+        //The LO synthesizers are written in one pass per channel. LO1 and LO2
+        //are on separate SPI units, so a pass routes the LEs of both stages
+        //and writes both synthesizers, and the next pass re-routes directly
+        //without releasing the LEs in between. The routes of the first pass
+        //are flushed along with all the other CPLD registers.
+        bool flushed = false, routed = false;
+        for (size_t i = 0; i < NUM_CHANS; i++) {
+            const bool commit_lo1 = (_lo1_freq[i].is_dirty() or _lo1_enable[i].is_dirty());
+            const bool commit_lo2 = (_lo2_freq[i].is_dirty() or _lo2_enable[i].is_dirty());
+            if (not commit_lo1 and not commit_lo2) continue;
+
+            const lo_config_route_t route = (i == size_t(CH1)) ? LO_CONFIG_CH1 : LO_CONFIG_CH2;
+            //The route LO_CONFIG_BOTH will ensure that the LEs for both channels
+            //are enabled, so only the first channel is committed
+            _set_lo1_route(not commit_lo1 ? LO_CONFIG_NONE :
+                (simultaneous_commit_lo1 ? LO_CONFIG_BOTH : route));
+            _set_lo2_route(not commit_lo2 ? LO_CONFIG_NONE :
+                (simultaneous_commit_lo2 ? LO_CONFIG_BOTH : route));
+            if (flushed) {
+                _cpld_regs->rf0_reg2.flush();
+                _cpld_regs->if0_reg2.flush();
+            } else {
+                _cpld_regs->flush_all();
+                flushed = true;
+            }
+            routed = true;
+
+            if (commit_lo1) {
+                _lo1_iface[i]->commit();
+                _lo1_freq[i].mark_clean();
+                _lo1_enable[i].mark_clean();
+                if (simultaneous_commit_lo1) {
+                    _lo1_freq[size_t(CH2)].mark_clean();
+                    _lo1_enable[size_t(CH2)].mark_clean();
+                }
             }
-            if (_lo1_freq[size_t(CH2)].is_dirty() || _lo1_enable[size_t(CH2)].is_dirty()) {
-                _config_lo1_route(LO_CONFIG_CH2);
-                _lo1_iface[size_t(CH2)]->commit();
-                _lo1_freq[size_t(CH2)].mark_clean();
-                _lo1_enable[size_t(CH2)].mark_clean();
-                _config_lo1_route(LO_CONFIG_NONE);
+            if (commit_lo2) {
+                _lo2_iface[i]->commit();
+                _lo2_freq[i].mark_clean();
+                _lo2_enable[i].mark_clean();
+                if (simultaneous_commit_lo2) {
+                    _lo2_freq[size_t(CH2)].mark_clean();
+                    _lo2_enable[size_t(CH2)].mark_clean();
+                }
             }
         }
 
-        //Commit LO2 frequency
-        bool simultaneous_commit_lo2 = _lo2_freq[size_t(CH1)].is_dirty() and
-                                       _lo2_freq[size_t(CH2)].is_dirty() and
-                                       _lo2_freq[size_t(CH1)].get() == _lo2_freq[size_t(CH2)].get() and
-                                       _lo2_enable[size_t(CH1)].get() == _lo2_enable[size_t(CH2)].get();
-
-        if (simultaneous_commit_lo2) {
-            _config_lo2_route(LO_CONFIG_BOTH);
-            //Only commit one of the channels. The route LO_CONFIG_BOTH
-            //will ensure that the LEs for both channels are enabled
-            _lo2_iface[size_t(CH1)]->commit();
-            _lo2_freq[size_t(CH1)].mark_clean();
-            _lo2_freq[size_t(CH2)].mark_clean();
-            _lo2_enable[size_t(CH1)].mark_clean();
-            _lo2_enable[size_t(CH2)].mark_clean();
+        if (not flushed) {
+            //Commit everything except the LO synthesizers
+            _cpld_regs->flush_all();
+        }
+        if (routed) {
+            _config_lo1_route(LO_CONFIG_NONE);
             _config_lo2_route(LO_CONFIG_NONE);
-        } else {
-            if (_lo2_freq[size_t(CH1)].is_dirty() || _lo2_enable[size_t(CH1)].is_dirty()) {
-                _config_lo2_route(LO_CONFIG_CH1);
-                _lo2_iface[size_t(CH1)]->commit();
-                _lo2_freq[size_t(CH1)].mark_clean();
-                _lo2_enable[size_t(CH1)].mark_clean();
-                _config_lo2_route(LO_CONFIG_NONE);
-            }
-            if (_lo2_freq[size_t(CH2)].is_dirty() || _lo2_enable[size_t(CH2)].is_dirty()) {
-                _config_lo2_route(LO_CONFIG_CH2);
-                _lo2_iface[size_t(CH2)]->commit();
-                _lo2_freq[size_t(CH2)].mark_clean();
-                _lo2_enable[size_t(CH2)].mark_clean();
-                _config_lo2_route(LO_CONFIG_NONE);
-            }
+        }
+        if (cmd_time != time_spec_t(0.0)) {
+            _gpio_iface->set_time(cmd_time);
         }
     }
 
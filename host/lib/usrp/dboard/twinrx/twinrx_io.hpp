@@ -108,9 +108,17 @@ public:
         _db_iface->set_gpio_out(dboard_iface::UNIT_BOTH,
             (cpld::get_reg(addr) << shift(CPLD_FULL_ADDR)) | (data << shift(CPLD_DATA)),
             mask<uint32_t>(CPLD_FULL_ADDR)|mask<uint32_t>(CPLD_DATA));
-        //Sleep for 166ns to ensure that we don't toggle the enables too quickly
-        //The underlying sleep function rounds to microsecond precision.
-        _db_iface->sleep(boost::chrono::nanoseconds(166));
+        //Wait 166ns to ensure that we don't toggle the enables too quickly.
+        //A timed write is delayed on the device instead (200ns, so that the
+        //rounding to ticks cannot shorten it), which keeps a batch of timed
+        //writes free of host sleeps. The underlying sleep function rounds to
+        //microsecond precision.
+        const time_spec_t cmd_time = _db_iface->get_command_time();
+        if (cmd_time != time_spec_t(0.0)) {
+            _db_iface->set_command_time(cmd_time + time_spec_t(200e-9));
+        } else {
+            _db_iface->sleep(boost::chrono::nanoseconds(166));
+        }
         //Step 2: Write the reg offset and data, and assert the necessary enable
         _db_iface->set_gpio_out(dboard_iface::UNIT_BOTH,
             (static_cast<uint32_t>(addr) << shift(CPLD_FULL_ADDR)) | (data << shift(CPLD_DATA)),
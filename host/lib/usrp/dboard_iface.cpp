@@ -29,3 +29,14 @@ void dboard_iface::sleep(const boost::chrono::nanoseconds& time)
       boost::this_thread::sleep_for(time);
    }
 }
+
+void dboard_iface::write_spi_batch(
+    unit_t unit,
+    const spi_config_t &config,
+    const std::vector<uint32_t> &data,
+    size_t num_bits
+){
+    for (size_t i = 0; i < data.size(); i++){
+        write_spi(unit, config, data[i], num_bits);
+    }
+}
@@ -16,6 +16,7 @@
 //
 
 #include "dboard_ctor_args.hpp"
+#include "../utils/load_modules.hpp"
 #include <uhd/usrp/dboard_manager.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/log.hpp>
@@ -28,6 +29,8 @@
 #include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 #include <boost/assign/list_of.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
 
 using namespace uhd;
 using namespace uhd::usrp;
@@ -197,8 +200,14 @@ public:
 
     void initialize_dboards();
 
+    void initialize_frontend(const uhd::direction_t dir, const std::string &fe_name);
+
 private:
     void init(dboard_id_t, dboard_id_t, property_tree::sptr, bool);
+    void defer_container_init(const dboard_base::sptr &, std::vector<dboard_base::sptr> &,
+                              uhd::dict<std::string, dboard_base::sptr> &,
+                              const std::vector<std::string> &);
+    void initialize_container(const dboard_base::sptr &);
     //list of rx and tx dboards in this dboard_manager
     //each dboard here is actually a subdevice proxy
     //the subdevice proxy is internal to the cpp file
@@ -206,6 +215,10 @@ private:
     uhd::dict<std::string, dboard_base::sptr> _tx_dboards;
     std::vector<dboard_base::sptr>            _rx_containers;
     std::vector<dboard_base::sptr>            _tx_containers;
+    //the deferred container each frontend needs initialized before use
+    uhd::dict<std::string, dboard_base::sptr> _rx_fe_containers;
+    uhd::dict<std::string, dboard_base::sptr> _tx_fe_containers;
+    boost::mutex                              _init_mutex;
     std::vector<std::string>                  _rx_frontends;
     std::vector<std::string>                  _tx_frontends;
     dboard_iface::sptr _iface;
@@ -223,6 +236,8 @@ dboard_manager::sptr dboard_manager::make(
     property_tree::sptr subtree,
     bool defer_db_init
 ){
+    //modules register their dboards when they are loaded
+    uhd::load_modules();
     return dboard_manager::sptr(
         new dboard_manager_impl(
             rx_dboard_id,
@@ -335,7 +350,8 @@ void dboard_manager_impl::init(
         //initialize the container after all subdevs have been created
         if (container_ctor) {
             if (defer_db_init) {
-                _rx_containers.push_back(db_ctor_args.rx_container);
+                defer_container_init(db_ctor_args.rx_container, _rx_containers, _rx_fe_containers, subdevs);
+                _tx_fe_containers = _rx_fe_containers;
             } else {
                 db_ctor_args.rx_container->initialize();
             }
@@ -383,7 +399,7 @@ void dboard_manager_impl::init(
         //initialize the container after all subdevs have been created
         if (rx_cont_ctor) {
             if (defer_db_init) {
-                _rx_containers.push_back(db_ctor_args.rx_container);
+                defer_container_init(db_ctor_args.rx_container, _rx_containers, _rx_fe_containers, rx_subdevs);
             } else {
                 db_ctor_args.rx_container->initialize();
             }
@@ -422,7 +438,7 @@ void dboard_manager_impl::init(
         //initialize the container after all subdevs have been created
         if (tx_cont_ctor) {
             if (defer_db_init) {
-                _tx_containers.push_back(db_ctor_args.tx_container);
+                defer_container_init(db_ctor_args.tx_container, _tx_containers, _tx_fe_containers, tx_subdevs);
             } else {
                 db_ctor_args.tx_container->initialize();
             }
@@ -435,13 +451,50 @@ void dboard_manager_impl::init(
     }
 }
 
+void dboard_manager_impl::defer_container_init(
+    const dboard_base::sptr &container,
+    std::vector<dboard_base::sptr> &containers,
+    uhd::dict<std::string, dboard_base::sptr> &fe_containers,
+    const std::vector<std::string> &subdevs
+){
+    containers.push_back(container);
+    BOOST_FOREACH(const std::string &subdev, subdevs){
+        fe_containers[subdev] = container;
+    }
+}
+
+void dboard_manager_impl::initialize_container(const dboard_base::sptr &container) {
+    //a container is only listed until it has been initialized
+    std::vector<dboard_base::sptr>::iterator it;
+    it = std::find(_rx_containers.begin(), _rx_containers.end(), container);
+    if (it != _rx_containers.end()) {
+        container->initialize();
+        _rx_containers.erase(it);
+        return;
+    }
+    it = std::find(_tx_containers.begin(), _tx_containers.end(), container);
+    if (it != _tx_containers.end()) {
+        container->initialize();
+        _tx_containers.erase(it);
+    }
+}
+
 void dboard_manager_impl::initialize_dboards(void) {
-    BOOST_FOREACH(dboard_base::sptr& _rx_container, _rx_containers) {
-        _rx_container->initialize();
+    boost::mutex::scoped_lock lock(_init_mutex);
+    while (not _rx_containers.empty()) {
+        initialize_container(_rx_containers.front());
     }
+    while (not _tx_containers.empty()) {
+        initialize_container(_tx_containers.front());
+    }
+}
 
-    BOOST_FOREACH(dboard_base::sptr& _tx_container, _tx_containers) {
-        _tx_container->initialize();
+void dboard_manager_impl::initialize_frontend(const uhd::direction_t dir, const std::string &fe_name) {
+    boost::mutex::scoped_lock lock(_init_mutex);
+    const uhd::dict<std::string, dboard_base::sptr> &fe_containers =
+        (dir == uhd::TX_DIRECTION) ? _tx_fe_containers : _rx_fe_containers;
+    if (fe_containers.has_key(fe_name)) {
+        initialize_container(fe_containers[fe_name]);
     }
 }
 
@@ -18,10 +18,16 @@
 #include "device3_impl.hpp"
 #include "graph_impl.hpp"
 #include "ctrl_iface.hpp"
+#include <uhd/utils/init_profile.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/rfnoc/block_ctrl_base.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
 #include <algorithm>
+#include <map>
 
 #define UHD_DEVICE3_LOG() UHD_LOGV(never)
 
@@ -32,6 +38,7 @@ device3_impl::device3_impl()
 {
     _type = uhd::device::USRP;
     _async_md.reset(new async_md_type(1000/*messages deep*/));
+    _async_msg_dispatcher = async_msg_dispatcher::make();
     _tree = uhd::property_tree::make();
 };
 
@@ -100,17 +107,98 @@ void device3_impl::merge_channel_defs(
 /***********************************************************************
  * RFNoC-Specific
  **********************************************************************/
+/***********************************************************************
+ * RFNoC block enumeration
+ **********************************************************************/
+namespace {
+    //! The control interface setup of one block port
+    struct ctrl_setup_t
+    {
+        uhd::both_xports_t xport;
+        std::string name;
+        uhd::rfnoc::ctrl_iface::sptr ctrl;
+        std::string error;
+    };
+
+    //! The setup of one block, port 0 is always set up
+    struct block_setup_t
+    {
+        block_setup_t(void) : noc_id(0) {}
+
+        uint64_t noc_id;
+        uhd::rfnoc::blockdef::sptr block_def;
+        std::map<size_t, ctrl_setup_t> ports;
+    };
+
+    //! Make the control interface, this waits for the block to answer
+    void make_ctrl(ctrl_setup_t &setup, const bool big_endian)
+    {
+        try {
+            UHD_DEVICE3_LOG() << str(boost::format("Setting up NoC-Shell Control %s (SID: %s)...") % setup.name % setup.xport.send_sid.to_pp_string_hex()) << std::endl;
+            setup.ctrl = uhd::rfnoc::ctrl_iface::make(
+                    big_endian,
+                    setup.xport.send,
+                    setup.xport.recv,
+                    setup.xport.send_sid,
+                    setup.name
+            );
+        } catch (const std::exception &e) {
+            setup.error = e.what();
+        }
+    }
+
+    //! Make the port 0 control interface, then read the NoC ID and find the block definition
+    void identify_block(block_setup_t &setup, const bool big_endian)
+    {
+        ctrl_setup_t &port0 = setup.ports[0];
+        make_ctrl(port0, big_endian);
+        if (not port0.error.empty()) {
+            return;
+        }
+        try {
+            setup.noc_id = port0.ctrl->peek64(uhd::rfnoc::SR_READBACK_REG_ID);
+            UHD_DEVICE3_LOG() << str(boost::format("%s: Found NoC-Block with ID %016X.") % port0.name % setup.noc_id) << std::endl;
+            setup.block_def = uhd::rfnoc::blockdef::make_from_noc_id(setup.noc_id);
+            if (not setup.block_def) {
+                UHD_DEVICE3_LOG() << "Using default block configuration." << std::endl;
+                setup.block_def = uhd::rfnoc::blockdef::make_from_noc_id(uhd::rfnoc::DEFAULT_NOC_ID);
+            }
+            UHD_ASSERT_THROW(setup.block_def);
+        } catch (const std::exception &e) {
+            port0.error = e.what();
+        }
+    }
+
+    //! Throws the first error of any port
+    void check_ctrl_errors(const std::vector<block_setup_t> &blocks)
+    {
+        BOOST_FOREACH(const block_setup_t &block, blocks) {
+            for (std::map<size_t, ctrl_setup_t>::const_iterator it = block.ports.begin(); it != block.ports.end(); ++it) {
+                if (not it->second.error.empty()) {
+                    throw uhd::runtime_error(str(
+                            boost::format("Failed to set up NoC-Shell Control %s: %s")
+                            % it->second.name % it->second.error
+                    ));
+                }
+            }
+        }
+    }
+}
+
 void device3_impl::enumerate_rfnoc_blocks(
         size_t device_index,
         size_t n_blocks,
         size_t base_port,
         const uhd::sid_t &base_sid,
         uhd::device_addr_t transport_args,
-        uhd::endianness_t endianness
+        uhd::endianness_t endianness,
+        const bool parallel_setup
 ) {
+    uhd::init_profile::scoped_phase rfnoc_phase("rfnoc", device_index);
     // entries that are already connected to this block
     uhd::sid_t ctrl_sid = base_sid;
     uhd::property_tree::sptr subtree = _tree->subtree(uhd::fs_path("/mboards") / device_index);
+    const bool big_endian = (endianness == ENDIANNESS_BIG);
     // 1) Clean property tree entries
     // TODO put this back once radios are actual rfnoc blocks!!!!!!
     //if (subtree->exists("xbar")) {
@@ -119,62 +207,82 @@ void device3_impl::enumerate_rfnoc_blocks(
     // 2) Destroy existing block controllers
     // TODO: Clear out all the old block control classes
     // 3) Create new block controllers
+    // Making transports allocates SIDs, so that is done one after the other.
+    // Every control interface waits for its block to answer, so those
+    // are set up at the same time if the transports are independent.
+    std::vector<block_setup_t> blocks(n_blocks);
+    uhd::init_profile::scoped_phase phase("rfnoc/identify blocks", device_index);
+    // First, make a transport for port number zero, because we always need that:
     for (size_t i = 0; i < n_blocks; i++) {
-        UHD_DEVICE3_LOG() << "[RFNOC] ------- Block Setup -----------" << std::endl;
-        // First, make a transport for port number zero, because we always need that:
         ctrl_sid.set_dst_xbarport(base_port + i);
         ctrl_sid.set_dst_blockport(0);
-        both_xports_t xport = this->make_transport(
-            ctrl_sid,
-            CTRL,
-            transport_args
-        );
-        UHD_DEVICE3_LOG() << str(boost::format("Setting up NoC-Shell Control for port #0 (SID: %s)...") % xport.send_sid.to_pp_string_hex());
-        uhd::rfnoc::ctrl_iface::sptr ctrl = uhd::rfnoc::ctrl_iface::make(
-                endianness == ENDIANNESS_BIG,
-                xport.send,
-                xport.recv,
-                xport.send_sid,
-                str(boost::format("CE_%02d_Port_%02X") % i % ctrl_sid.get_dst_endpoint())
-        );
-        UHD_DEVICE3_LOG() << "OK" << std::endl;
-        uint64_t noc_id = ctrl->peek64(uhd::rfnoc::SR_READBACK_REG_ID);
-        UHD_DEVICE3_LOG() << str(boost::format("Port %d: Found NoC-Block with ID %016X.") % int(ctrl_sid.get_dst_endpoint()) % noc_id) << std::endl;
-        uhd::rfnoc::make_args_t make_args;
-        uhd::rfnoc::blockdef::sptr block_def = uhd::rfnoc::blockdef::make_from_noc_id(noc_id);
-        if (not block_def) {
-            UHD_DEVICE3_LOG() << "Using default block configuration." << std::endl;
-            block_def = uhd::rfnoc::blockdef::make_from_noc_id(uhd::rfnoc::DEFAULT_NOC_ID);
+        both_xports_t xport = this->make_transport(ctrl_sid, CTRL, transport_args);
+        ctrl_setup_t &port0 = blocks[i].ports[0];
+        port0.xport = xport;
+        port0.name = str(boost::format("CE_%02d_Port_%02X") % i % ctrl_sid.get_dst_endpoint());
+    }
+    if (parallel_setup) {
+        boost::thread_group threads;
+        BOOST_FOREACH(block_setup_t &block, blocks) {
+            threads.create_thread(boost::bind(&identify_block, boost::ref(block), big_endian));
+        }
+        threads.join_all();
+    } else {
+        BOOST_FOREACH(block_setup_t &block, blocks) {
+            identify_block(block, big_endian);
+            if (not block.ports[0].error.empty()) {
+                break;
+            }
         }
-        UHD_ASSERT_THROW(block_def);
-        make_args.ctrl_ifaces[0] = ctrl;
-        BOOST_FOREACH(const size_t port_number, block_def->get_all_port_numbers()) {
+    }
+    check_ctrl_errors(blocks);
+
+    // Then all the other ports the block definitions ask for:
+    phase.next("rfnoc/control ports");
+    std::vector<ctrl_setup_t *> other_ports;
+    for (size_t i = 0; i < n_blocks; i++) {
+        ctrl_sid.set_dst_xbarport(base_port + i);
+        BOOST_FOREACH(const size_t port_number, blocks[i].block_def->get_all_port_numbers()) {
             if (port_number == 0) { // We've already set this up
                 continue;
             }
             ctrl_sid.set_dst_blockport(port_number);
-            both_xports_t xport1 = this->make_transport(
-                ctrl_sid,
-                CTRL,
-                transport_args
-            );
-            UHD_DEVICE3_LOG() << str(boost::format("Setting up NoC-Shell Control for port #%d (SID: %s)...") % port_number % xport1.send_sid.to_pp_string_hex());
-            uhd::rfnoc::ctrl_iface::sptr ctrl1 = uhd::rfnoc::ctrl_iface::make(
-                    endianness == ENDIANNESS_BIG,
-                    xport1.send,
-                    xport1.recv,
-                    xport1.send_sid,
-                    str(boost::format("CE_%02d_Port_%02d") % i % ctrl_sid.get_dst_endpoint())
-            );
-            UHD_DEVICE3_LOG() << "OK" << std::endl;
-            make_args.ctrl_ifaces[port_number] = ctrl1;
+            both_xports_t xport = this->make_transport(ctrl_sid, CTRL, transport_args);
+            ctrl_setup_t &port = blocks[i].ports[port_number];
+            port.xport = xport;
+            port.name = str(boost::format("CE_%02d_Port_%02d") % i % ctrl_sid.get_dst_endpoint());
+            other_ports.push_back(&port);
+        }
+    }
+    if (parallel_setup) {
+        boost::thread_group threads;
+        BOOST_FOREACH(ctrl_setup_t *port, other_ports) {
+            threads.create_thread(boost::bind(&make_ctrl, boost::ref(*port), big_endian));
+        }
+        threads.join_all();
+    } else {
+        BOOST_FOREACH(ctrl_setup_t *port, other_ports) {
+            make_ctrl(*port, big_endian);
+            if (not port->error.empty()) {
+                break;
+            }
         }
+    }
+    check_ctrl_errors(blocks);
 
-        make_args.base_address = xport.send_sid.get_dst();
+    // Finally, the block controllers, in order:
+    phase.next("rfnoc/block controllers");
+    BOOST_FOREACH(const block_setup_t &block, blocks) {
+        UHD_DEVICE3_LOG() << "[RFNOC] ------- Block Setup -----------" << std::endl;
+        uhd::rfnoc::make_args_t make_args;
+        for (std::map<size_t, ctrl_setup_t>::const_iterator it = block.ports.begin(); it != block.ports.end(); ++it) {
+            make_args.ctrl_ifaces[it->first] = it->second.ctrl;
+        }
+        make_args.base_address = block.ports.find(0)->second.xport.send_sid.get_dst();
         make_args.device_index = device_index;
         make_args.tree = subtree;
-        make_args.is_big_endian = (endianness == ENDIANNESS_BIG);
-        _rfnoc_block_ctrl.push_back(uhd::rfnoc::block_ctrl_base::make(make_args, noc_id));
+        make_args.is_big_endian = big_endian;
+        _rfnoc_block_ctrl.push_back(uhd::rfnoc::block_ctrl_base::make(make_args, block.noc_id));
     }
 }
 
@@ -183,7 +291,16 @@ uhd::rfnoc::graph::sptr device3_impl::create_graph(const std::string &name)
 {
     return boost::make_shared<uhd::rfnoc::graph_impl>(
             name,
-            shared_from_this()
+            shared_from_this(),
+            boost::bind(&device3_impl::route_between_devices, this, _1)
     );
 }
 
+void device3_impl::route_between_devices(const uhd::sid_t &sid)
+{
+    throw uhd::not_implemented_error(str(
+        boost::format("Can't route %s: This device can't stream between motherboards.")
+        % sid.to_pp_string_hex()
+    ));
+}
+
@@ -32,6 +32,7 @@
 #include <uhd/utils/tasks.hpp>
 #include <uhd/device3.hpp>
 #include "xports.hpp"
+#include "../common/async_msg_dispatcher.hpp"
 
 namespace uhd { namespace usrp {
 
@@ -45,13 +46,15 @@ static const size_t DEVICE3_TX_FC_RESPONSE_CYCLES      = 0;     // Cycles: Off.
 static const size_t DEVICE3_TX_MAX_HDR_LEN             = uhd::transport::vrt::chdr::max_if_hdr_words64 * sizeof(uint64_t);    // Bytes
 static const size_t DEVICE3_RX_MAX_HDR_LEN             = uhd::transport::vrt::chdr::max_if_hdr_words64 * sizeof(uint64_t);    // Bytes
 
+class stream_xport_pool;
+
 class device3_impl : public uhd::device3, public boost::enable_shared_from_this<device3_impl>
 {
 public:
     /***********************************************************************
      * device3-specific Types
      **********************************************************************/
-    typedef uhd::transport::bounded_buffer<uhd::async_metadata_t> async_md_type;
+    typedef uhd::usrp::async_md_queue async_md_type;
 
     //! The purpose of a transport
     enum xport_type_t {
@@ -96,6 +99,10 @@ public:
      * Other public APIs
      **********************************************************************/
     rfnoc::graph::sptr create_graph(const std::string &name="");
+    void reconfigure_streamers(
+        const reconfigure_fn_t &reconfigure,
+        const std::vector<uhd::rx_streamer::sptr> &rx_streamers
+    );
 
 protected:
     /***********************************************************************
@@ -133,6 +140,33 @@ protected:
         const uhd::device_addr_t& args
     ) = 0;
 
+    /*! \brief Get a data transport for a streamer.
+     *
+     * Streamers release their transports into a pool when they are
+     * destroyed. A transport in the pool that was made for the same
+     * address, type and args is drained until no more packets arrive and
+     * handed out again, every other request goes to make_transport().
+     * The pool is only used when the reuse_xport stream arg is set to 1.
+     *
+     * \param address The endpoint address, see make_transport()
+     * \param xport_type TX_DATA, RX_DATA or ASYNC_MSG
+     * \param args The transport args, see make_transport()
+     * \param reuse false to always make a new transport
+     */
+    uhd::both_xports_t get_stream_transport(
+        const uhd::sid_t &address,
+        const xport_type_t xport_type,
+        const uhd::device_addr_t& args,
+        const bool reuse = false
+    );
+
+    /*! Destroy the idle transports of the pool.
+     *
+     * Devices call this in their destructor, so the pooled transports go
+     * away before the links they were made on.
+     */
+    void release_stream_transports(void);
+
     virtual uhd::device_addr_t get_tx_hints(size_t) { return uhd::device_addr_t(); };
     virtual uhd::device_addr_t get_rx_hints(size_t) { return uhd::device_addr_t(); };
     virtual uhd::endianness_t get_transport_endianness(size_t mb_index) = 0;
@@ -140,6 +174,20 @@ protected:
     //! Is called after a streamer is generated
     virtual void post_streamer_hooks(uhd::direction_t) {};
 
+    /*! \brief Route a stream between blocks on different motherboards.
+     *
+     * Sets up the devices such that packets with the SID \p sid go straight
+     * from the source to the destination block, and the flow control
+     * responses (using the reversed SID) go back the same way, without
+     * passing through the host.
+     *
+     * The default implementation throws a uhd::not_implemented_error.
+     *
+     * \param sid The SID of the stream. The source and destination addresses
+     *            are the addresses of the two motherboards.
+     */
+    virtual void route_between_devices(const uhd::sid_t &sid);
+
     /***********************************************************************
      * Channel-related
      **********************************************************************/
@@ -163,13 +211,21 @@ protected:
     /***********************************************************************
      * RFNoC-Specific
      **********************************************************************/
+    /*! Find the blocks on a device and make their block controllers
+     *
+     * \param parallel_setup Set up the control interfaces of all blocks at
+     *                       the same time. This requires that transports made
+     *                       by make_transport() can be used by different
+     *                       threads at the same time.
+     */
     void enumerate_rfnoc_blocks(
             size_t device_index,
             size_t n_blocks,
             size_t base_port,
             const uhd::sid_t &base_sid,
             uhd::device_addr_t transport_args,
-            uhd::endianness_t endianness
+            uhd::endianness_t endianness,
+            const bool parallel_setup = false
     );
 
     /***********************************************************************
@@ -189,8 +245,14 @@ private:
     //! Buffer for async metadata
     boost::shared_ptr<async_md_type> _async_md;
 
+    //! Services the async message transports of all TX streamers
+    async_msg_dispatcher::sptr _async_msg_dispatcher;
+
     //! This mutex locks the get_xx_stream() functions.
     boost::mutex _transport_setup_mutex;
+
+    //! The transports released by streamers, see get_stream_transport()
+    boost::shared_ptr<stream_xport_pool> _stream_xport_pool;
 };
 
 }} /* namespace uhd::usrp */
@@ -21,9 +21,11 @@
 #include <uhd/rfnoc/constants.hpp>
 #include <uhd/rfnoc/source_block_ctrl_base.hpp>
 #include <uhd/rfnoc/sink_block_ctrl_base.hpp>
+#include <uhd/rfnoc/host_block_ctrl.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/msg.hpp>
+#include <uhd/utils/trace.hpp>
 #include "../common/async_packet_handler.hpp"
 #include "../../transport/super_recv_packet_handler.hpp"
 #include "../../transport/super_send_packet_handler.hpp"
@@ -33,6 +35,8 @@
 #include <uhd/rfnoc/radio_ctrl.hpp>
 #include <uhd/transport/zero_copy_flow_ctrl.hpp>
 #include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <cmath>
 
 #define UHD_STREAMER_LOG() UHD_LOGV(never)
 
@@ -42,11 +46,68 @@ using namespace uhd::transport;
 
 //! CHDR uses 12-Bit sequence numbers
 static const uint32_t HW_SEQ_NUM_MASK = 0xfff;
+//! Default number of buffers an RX streamer takes per transport call
+static const size_t DEFAULT_RX_BUFF_BATCH = 8;
+//! Time worth of samples in one packet with profile=latency (seconds)
+static const double LATENCY_PROFILE_PKT_TIME = 50e-6;
+//! Time worth of packets in flight with profile=latency (seconds)
+static const double LATENCY_PROFILE_WINDOW_TIME = 1e-3;
+//! Smallest packets with profile=latency (samples)
+static const size_t LATENCY_PROFILE_MIN_SPP = 32;
+//! Smallest flow control window with profile=latency (packets)
+static const size_t LATENCY_PROFILE_MIN_WINDOW = 4;
+//! Time for the stop commands of reconfigure_streamers() to take effect (milliseconds)
+static const long RECONFIGURE_STOP_DELAY_MS = 10;
+//! Time without packets after which a reused transport counts as drained (seconds)
+static const double REUSE_XPORT_DRAIN_TIMEOUT = 0.01;
 
 
 /***********************************************************************
  * Helper functions for get_?x_stream()
  **********************************************************************/
+/*! Find the host block a streamer goes through on a port of a block.
+ *
+ * \param blk_ctrl The block the streamer connects to
+ * \param downstream true to look downstream of the block (rx), false to
+ *                   look upstream (tx)
+ * \param block_port The port of the block, ANY_PORT takes the first one
+ *                   with a host block, and is then set to that port
+ * \param host_port Set to the port of the host block
+ * \returns the host block, or NULL if there is none that is not in use
+ */
+static uhd::rfnoc::host_block_ctrl::sptr find_host_block(
+        uhd::rfnoc::node_ctrl_base::sptr blk_ctrl,
+        const bool downstream,
+        size_t &block_port,
+        size_t &host_port
+) {
+    typedef uhd::rfnoc::node_ctrl_base::node_map_t node_map_t;
+    const node_map_t nodes = downstream ?
+        blk_ctrl->list_downstream_nodes() : blk_ctrl->list_upstream_nodes();
+    BOOST_FOREACH(const node_map_t::value_type &node, nodes) {
+        if (block_port != uhd::rfnoc::ANY_PORT and node.first != block_port) {
+            continue;
+        }
+        uhd::rfnoc::host_block_ctrl::sptr host_block =
+            boost::dynamic_pointer_cast<uhd::rfnoc::host_block_ctrl>(node.second.lock());
+        if (not host_block) {
+            continue;
+        }
+        const size_t this_host_port = downstream ?
+            blk_ctrl->get_downstream_port(node.first) : blk_ctrl->get_upstream_port(node.first);
+        // Skip host blocks that another streamer goes through
+        const node_map_t streamer_side = downstream ?
+            host_block->list_downstream_nodes() : host_block->list_upstream_nodes();
+        if (streamer_side.count(this_host_port) and not streamer_side.at(this_host_port).expired()) {
+            continue;
+        }
+        block_port = node.first;
+        host_port = this_host_port;
+        return host_block;
+    }
+    return uhd::rfnoc::host_block_ctrl::sptr();
+}
+
 static uhd::stream_args_t sanitize_stream_args(const uhd::stream_args_t &args_)
 {
     uhd::stream_args_t args = args_;
@@ -89,6 +150,98 @@ static void check_stream_sig_compatible(const rfnoc::stream_sig_t &stream_sig, s
     }
 }
 
+/*! \brief Returns the link rate of a stream from or to a block port, in bytes/s
+ *
+ * Devices use this to balance streams across their links. Returns 0 if the
+ * sampling rate of the block port isn't known (yet).
+ */
+static double get_stream_link_rate(
+        rfnoc::node_ctrl_base::sptr blk_ctrl,
+        const size_t block_port,
+        const bool downstream,
+        const std::string &otw_format
+) {
+    rfnoc::rate_node_ctrl::sptr rate_node = boost::dynamic_pointer_cast<rfnoc::rate_node_ctrl>(blk_ctrl);
+    if (not rate_node) {
+        return 0.0;
+    }
+    double samp_rate = rfnoc::rate_node_ctrl::RATE_UNDEFINED;
+    try {
+        samp_rate = downstream ?
+            rate_node->get_output_samp_rate(block_port) :
+            rate_node->get_input_samp_rate(block_port);
+    } catch (const uhd::runtime_error &) {
+        // Ambiguous rates, don't guess
+    }
+    if (samp_rate == rfnoc::rate_node_ctrl::RATE_UNDEFINED) {
+        return 0.0;
+    }
+    return samp_rate * convert::get_bytes_per_item(otw_format);
+}
+
+/*! \brief Apply the profile stream arg to the stream args and transport hints.
+ *
+ * - profile=throughput (the default) keeps the largest packets the link
+ *   allows, and a flow control window as large as the buffers allow.
+ * - profile=latency picks packets of LATENCY_PROFILE_PKT_TIME worth of
+ *   samples, and limits the flow control window to
+ *   LATENCY_PROFILE_WINDOW_TIME worth of packets (max_recv_window or
+ *   max_send_window). RX streamers also hand out every packet right away.
+ *
+ * Values that are set explicitly in the stream args or the hints are
+ * never changed. The latency profile needs to know the link rate.
+ *
+ * \returns true if the samples per packet were set by the profile
+ */
+static bool apply_stream_profile(
+        stream_args_t &args,
+        device_addr_t &hints,
+        const double link_rate,
+        const std::string &tx_rx
+) {
+    const std::string profile = args.args.get("profile", "throughput");
+    if (profile == "throughput") {
+        return false;
+    } else if (profile != "latency") {
+        throw uhd::value_error(str(
+            boost::format("[%s Streamer] Invalid profile stream arg: %s (expected throughput or latency)")
+            % tx_rx % profile
+        ));
+    }
+    if (link_rate <= 0) {
+        UHD_MSG(warning) << "[" << tx_rx << " Streamer] The sampling rate is unknown, "
+                         << "can't apply profile=latency." << std::endl;
+        return false;
+    }
+
+    const size_t bpi = convert::get_bytes_per_item(args.otw_format);
+    const double samp_rate = link_rate / bpi;
+    bool spp_set = false;
+    if (not args.args.has_key("spp")) {
+        size_t spp = std::max(
+            LATENCY_PROFILE_MIN_SPP,
+            size_t(std::ceil(samp_rate * LATENCY_PROFILE_PKT_TIME))
+        );
+        // Packets are made from whole 32-bit items
+        spp = (spp + 3) & ~size_t(3);
+        args.args["spp"] = str(boost::format("%d") % spp);
+        spp_set = true;
+    }
+    const size_t spp = args.args.cast<size_t>("spp", 0);
+    const std::string window_key = (tx_rx == "RX") ? "max_recv_window" : "max_send_window";
+    if (not hints.has_key(window_key) and spp != 0) {
+        const size_t window = std::max(
+            LATENCY_PROFILE_MIN_WINDOW,
+            size_t(std::ceil(samp_rate * LATENCY_PROFILE_WINDOW_TIME / spp))
+        );
+        hints[window_key] = str(boost::format("%d") % window);
+    }
+    if (tx_rx == "RX" and not hints.has_key("recv_batch")) {
+        hints["recv_batch"] = "1";
+    }
+    return spp_set;
+}
+
 /*! \brief Returns a list of rx or tx channels for a streamer.
  *
  * If the given stream args contain instructions to set up channels,
@@ -148,6 +301,167 @@ void generate_channel_list(
     chan_args = chan_args_;
 }
 
+//! Read one counter of a transport or streamer, or 0 once it is gone
+template <typename stats_source_t>
+static uint64_t get_stats_counter(
+        boost::weak_ptr<stats_source_t> weak_source,
+        const std::string &name
+) {
+    boost::shared_ptr<stats_source_t> source = weak_source.lock();
+    return source ? source->get_stats().to_dict()[name] : 0;
+}
+
+/*! Publish the counters of a transport or streamer in the property tree.
+ *
+ * A node per counter is created at \p path, replacing the nodes of an
+ * earlier transport or streamer at the same path. The tree only holds a
+ * weak reference, so the nodes read 0 once \p source was destroyed.
+ */
+template <typename stats_t, typename stats_source_t>
+static void publish_stats(
+        property_tree::sptr tree,
+        const fs_path &path,
+        boost::shared_ptr<stats_source_t> source
+) {
+    if (tree->exists(path)) {
+        tree->remove(path);
+    }
+    BOOST_FOREACH(const std::string &name, stats_t().to_dict().keys()) {
+        tree->create<uint64_t>(path / name).set_publisher(boost::bind(
+            &get_stats_counter<stats_source_t>,
+            boost::weak_ptr<stats_source_t>(source), name
+        ));
+    }
+}
+
+/*! Publish the streaming parameters a streamer ended up with.
+ *
+ * These are the values picked from the profile stream arg, or the
+ * defaults, for the first channel of the streamer.
+ */
+static void publish_stream_params(
+        property_tree::sptr tree,
+        const fs_path &path,
+        const device_addr_t &params
+) {
+    if (tree->exists(path)) {
+        tree->remove(path);
+    }
+    tree->create<device_addr_t>(path).set(params);
+}
+
+/***********************************************************************
+ * Pool of streaming transports
+ **********************************************************************/
+/*! The transports released by destroyed streamers.
+ *
+ * A streamer gets its transports through a lease: the transports it
+ * holds share ownership of the lease, and when the last of them is
+ * dropped the lease puts the transports back into the pool.
+ */
+class uhd::usrp::stream_xport_pool : boost::noncopyable
+{
+public:
+    typedef boost::shared_ptr<stream_xport_pool> sptr;
+
+    //! Take an idle transport for a key, false if there is none
+    bool take(const std::string &key, both_xports_t &xports)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        std::multimap<std::string, both_xports_t>::iterator it = _idle.find(key);
+        if (it == _idle.end()) {
+            return false;
+        }
+        xports = it->second;
+        _idle.erase(it);
+        return true;
+    }
+
+    void put(const std::string &key, const both_xports_t &xports)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _idle.insert(std::make_pair(key, xports));
+    }
+
+    void clear(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _idle.clear();
+    }
+
+private:
+    boost::mutex _mutex;
+    std::multimap<std::string, both_xports_t> _idle;
+};
+
+namespace {
+    struct stream_xport_lease : boost::noncopyable
+    {
+        ~stream_xport_lease(void)
+        {
+            stream_xport_pool::sptr pool = weak_pool.lock();
+            if (pool) {
+                pool->put(key, xports);
+            }
+        }
+        both_xports_t xports;
+        std::string key;
+        boost::weak_ptr<stream_xport_pool> weak_pool;
+    };
+}
+
+//! Drop the packets that arrived on an idle transport, or are still in flight
+static void drain_stream_transport(zero_copy_if::sptr xport)
+{
+    if (not xport) {
+        return;
+    }
+    while (xport->get_recv_buff(REUSE_XPORT_DRAIN_TIMEOUT)) {
+        // The packets of the previous streamer are discarded
+    }
+}
+
+both_xports_t device3_impl::get_stream_transport(
+    const uhd::sid_t &address,
+    const xport_type_t xport_type,
+    const uhd::device_addr_t& args,
+    const bool reuse
+) {
+    if (not reuse) {
+        return make_transport(address, xport_type, args);
+    }
+    if (not _stream_xport_pool) {
+        _stream_xport_pool = boost::make_shared<stream_xport_pool>();
+    }
+
+    boost::shared_ptr<stream_xport_lease> lease = boost::make_shared<stream_xport_lease>();
+    lease->key = str(boost::format("%d,%s,%s") % int(xport_type) % address.to_pp_string_hex() % args.to_string());
+    if (_stream_xport_pool->take(lease->key, lease->xports)) {
+        UHD_STREAMER_LOG() << "[device3] reusing transport " << lease->key << std::endl;
+        drain_stream_transport(lease->xports.recv);
+    } else {
+        both_xports_t made = make_transport(address, xport_type, args);
+        lease->xports = made;
+    }
+    lease->weak_pool = _stream_xport_pool;
+
+    // The handed out transports keep the lease alive
+    both_xports_t xports = lease->xports;
+    if (xports.recv) {
+        xports.recv = zero_copy_if::sptr(lease, lease->xports.recv.get());
+    }
+    if (xports.send) {
+        xports.send = zero_copy_if::sptr(lease, lease->xports.send.get());
+    }
+    return xports;
+}
+
+void device3_impl::release_stream_transports(void)
+{
+    if (_stream_xport_pool) {
+        _stream_xport_pool->clear();
+    }
+}
 
 /***********************************************************************
  * RX Flow Control Functions
@@ -155,11 +469,84 @@ void generate_channel_list(
 //! Stores the state of RX flow control
 struct rx_fc_cache_t
 {
-    rx_fc_cache_t():
-        last_seq_in(0){}
+    rx_fc_cache_t(
+            const size_t window_ = 0,
+            const size_t handle_window_ = 1,
+            const size_t ack_pkts_ = 1,
+            const double ack_interval_ = 0.0
+    ):
+        last_seq_in(0),
+        last_seq_acked(0),
+        window(window_),
+        handle_window(handle_window_),
+        ack_pkts(ack_pkts_),
+        ack_interval(ack_interval_),
+        num_acks_sent(0),
+        num_acks_coalesced(0),
+        num_acks_deferred(0),
+        adaptive(false),
+        min_window(window_),
+        cur_window(window_),
+        last_adapt_seq(0),
+        num_adapt_calls(0),
+        pkt_rate(0.0),
+        peak_gap(0.0){}
+
+    ~rx_fc_cache_t()
+    {
+        UHD_LOG << boost::format(
+            "RX flow control: %u acks sent, %u coalesced, %u deferred for lack of a send buffer"
+        ) % num_acks_sent % num_acks_coalesced % num_acks_deferred << std::endl;
+        if (adaptive) {
+            UHD_LOG << boost::format(
+                "RX flow control: adaptive window ended at %u of [%u, %u] packets"
+            ) % size_t(cur_window) % min_window % window << std::endl;
+        }
+    }
+
     size_t last_seq_in;
+    //! The 32-bit sequence number of the last ack that was sent
+    size_t last_seq_acked;
+    //! The number of packets the source may send without an ack
+    size_t window;
+    //! The number of packets between calls into handle_rx_flowctrl()
+    size_t handle_window;
+    //! Send an ack once this many packets were consumed since the last one, ...
+    size_t ack_pkts;
+    //! ... or once this many seconds passed since the last one (0 disables)
+    double ack_interval;
+    uhd::time_spec_t last_ack_time;
+    //! Counters of the acks sent and skipped
+    size_t num_acks_sent;
+    size_t num_acks_coalesced;
+    size_t num_acks_deferred;
+    //! Adapt the window to the host between min_window and window
+    bool adaptive;
+    size_t min_window;
+    //! The window currently granted to the source, read by the property tree
+    boost::atomic<size_t> cur_window;
+    //! The state of the adaption: consumption rate and longest host gap
+    size_t last_adapt_seq;
+    uhd::time_spec_t last_adapt_time;
+    size_t num_adapt_calls;
+    double pkt_rate;
+    double peak_gap;
 };
 
+//! The adaptive window covers this multiple of the longest recent host gap
+static const double RX_FC_ADAPT_HEADROOM    = 2.0;
+//! The time in seconds after which a host gap is forgotten
+static const double RX_FC_ADAPT_DECAY_TIME  = 1.0;
+//! The gain of the moving average of the consumption rate
+static const double RX_FC_ADAPT_RATE_GAIN   = 0.125;
+
+//! Read the current RX flow control window, or 0 once the streamer is gone
+static uint64_t get_rx_fc_window(boost::weak_ptr<rx_fc_cache_t> weak_fc_cache)
+{
+    boost::shared_ptr<rx_fc_cache_t> fc_cache = weak_fc_cache.lock();
+    return fc_cache ? uint64_t(fc_cache->cur_window) : 0;
+}
+
 /*! Determine the size of the flow control window in number of packets.
  *
  * This value depends on three things:
@@ -204,6 +591,93 @@ static size_t get_rx_flow_control_window(
     return window_in_pkts;
 }
 
+/*! Configure the coalescing of RX flow control acks.
+ *
+ * handle_rx_flowctrl() is called every \p handle_window packets. By
+ * default, every call sends an ack. These options reduce the number of
+ * acks at high packet rates:
+ * - 'recv_fc_ack_pkts': Send an ack at the latest after this many packets.
+ * - 'recv_fc_ack_us': Also send an ack if this many microseconds passed
+ *   since the last one (defaults to 0, only the packet count applies).
+ *
+ * The packet count is limited so that the source can always send enough
+ * packets to reach the next call while the last ack is pending.
+ *
+ * \param window The flow control window of the source in packets
+ * \param handle_window The number of packets between calls
+ * \param rx_args The transport hints
+ */
+static boost::shared_ptr<rx_fc_cache_t> make_rx_fc_cache(
+        const size_t window,
+        const size_t handle_window,
+        const device_addr_t& rx_args
+) {
+    const size_t max_ack_pkts = (window > 2*handle_window)? window - handle_window : handle_window;
+    const size_t ack_pkts = std::max(handle_window, std::min(max_ack_pkts,
+        rx_args.cast<size_t>("recv_fc_ack_pkts", handle_window)
+    ));
+    const double ack_interval = rx_args.cast<double>("recv_fc_ack_us", 0.0) * 1e-6;
+    if (ack_interval < 0.0) {
+        throw uhd::value_error("recv_fc_ack_us must not be negative");
+    }
+    boost::shared_ptr<rx_fc_cache_t> fc_cache =
+        boost::make_shared<rx_fc_cache_t>(window, handle_window, ack_pkts, ack_interval);
+    if (rx_args.cast<size_t>("recv_fc_adapt", 0) != 0) {
+        // The source must always be able to send the packets up to the
+        // next ack, so that is the smallest useful window.
+        const size_t min_window = std::min(window, std::max(
+            ack_pkts + 2*handle_window,
+            rx_args.cast<size_t>("min_recv_window", 0)
+        ));
+        fc_cache->adaptive = true;
+        fc_cache->min_window = min_window;
+    }
+    return fc_cache;
+}
+
+/*! Adapt the RX flow control window to the host.
+ *
+ * The window has to hold the packets that arrive while the host does not
+ * consume any, so it follows the consumption rate times the longest
+ * recent gap between two calls. It grows at once, and shrinks by at most
+ * one handle window per call.
+ *
+ * \param fc_cache The flow control state
+ * \param seq32 The 32-bit sequence number of the last consumed packet
+ * \param now The current system time
+ */
+static void adapt_rx_fc_window(
+        rx_fc_cache_t &fc_cache,
+        const size_t seq32,
+        const uhd::time_spec_t &now
+) {
+    if (fc_cache.num_adapt_calls++ == 0) {
+        fc_cache.last_adapt_seq = seq32;
+        fc_cache.last_adapt_time = now;
+        return;
+    }
+    const double gap = (now - fc_cache.last_adapt_time).get_real_secs();
+    const size_t pkts = (seq32 - fc_cache.last_adapt_seq) & 0xffffffff;
+    if (gap <= 0.0 or pkts == 0) {
+        return;
+    }
+    fc_cache.last_adapt_seq = seq32;
+    fc_cache.last_adapt_time = now;
+
+    const double rate = pkts / gap;
+    fc_cache.pkt_rate = (fc_cache.pkt_rate == 0.0) ? rate :
+        fc_cache.pkt_rate + RX_FC_ADAPT_RATE_GAIN * (rate - fc_cache.pkt_rate);
+    fc_cache.peak_gap = std::max(gap,
+        fc_cache.peak_gap * std::max(0.0, 1.0 - gap / RX_FC_ADAPT_DECAY_TIME));
+
+    const size_t wanted = fc_cache.handle_window +
+        size_t(std::ceil(fc_cache.pkt_rate * fc_cache.peak_gap * RX_FC_ADAPT_HEADROOM));
+    const size_t current = fc_cache.cur_window;
+    const size_t next = (wanted >= current) ? wanted :
+        std::max(wanted, current - std::min(current, fc_cache.handle_window));
+    fc_cache.cur_window = std::min(fc_cache.window, std::max(fc_cache.min_window, next));
+}
+
 
 /*! Send out RX flow control packets.
  *
@@ -225,21 +699,15 @@ static size_t get_rx_flow_control_window(
  */
 static void handle_rx_flowctrl(
         const sid_t &sid,
-        zero_copy_if::sptr xport,
+        const zero_copy_if::sptr &xport,
         endianness_t endianness,
-        boost::shared_ptr<rx_fc_cache_t> fc_cache,
+        const boost::shared_ptr<rx_fc_cache_t> &fc_cache,
         const size_t last_seq
 ) {
     static const size_t RXFC_PACKET_LEN_IN_WORDS    = 2;
     static const size_t RXFC_CMD_CODE_OFFSET        = 0;
     static const size_t RXFC_SEQ_NUM_OFFSET         = 1;
 
-    managed_send_buffer::sptr buff = xport->get_send_buff(0.0);
-    if (not buff) {
-        throw uhd::runtime_error("handle_rx_flowctrl timed out getting a send buffer");
-    }
-    uint32_t *pkt = buff->cast<uint32_t *>();
-
     // Recover sequence number. The sequence numbers handled by the streamers
     // are 12 Bits, but we want to know the 32-Bit sequence number.
     size_t &seq32 = fc_cache->last_seq_in;
@@ -249,6 +717,51 @@ static void handle_rx_flowctrl(
     seq32 &= ~HW_SEQ_NUM_MASK;
     seq32 |= last_seq;
 
+    uhd::time_spec_t now;
+    if (fc_cache->ack_interval > 0.0 or fc_cache->adaptive) now = uhd::time_spec_t::get_system_time();
+
+    // The adaptive window is applied by acking that many packets less
+    // than were consumed, the source is configured for the full window.
+    if (fc_cache->adaptive) {
+        adapt_rx_fc_window(*fc_cache, seq32, now);
+    }
+    const size_t window = fc_cache->cur_window;
+    const size_t ack_seq = (seq32 - (fc_cache->window - window)) & 0xffffffff;
+
+    // Coalesce acks: Acks are cumulative, so skipping one is fine as long
+    // as the source can still send the packets up to the next call.
+    const size_t pkts_since_ack = (ack_seq - fc_cache->last_seq_acked) & 0xffffffff;
+    const bool first_ack = fc_cache->num_acks_sent == 0;
+    if (not first_ack and pkts_since_ack > 0x7fffffff) {
+        // The window shrank by more than was consumed, acks never go back
+        fc_cache->num_acks_coalesced++;
+        return;
+    }
+    if (not first_ack and pkts_since_ack < fc_cache->ack_pkts and not (
+        fc_cache->ack_interval > 0.0 and (now - fc_cache->last_ack_time).get_real_secs() >= fc_cache->ack_interval
+    )) {
+        fc_cache->num_acks_coalesced++;
+        return;
+    }
+
+    // Without a send buffer, defer the ack to the next call while that is
+    // still safe, and only then wait for one.
+    managed_send_buffer::sptr buff = xport->get_send_buff(0.0);
+    if (not buff) {
+        if (not first_ack and pkts_since_ack + 2*fc_cache->handle_window < window) {
+            fc_cache->num_acks_deferred++;
+            return;
+        }
+        buff = xport->get_send_buff(0.1);
+    }
+    if (not buff) {
+        throw uhd::runtime_error("handle_rx_flowctrl timed out getting a send buffer");
+    }
+    uint32_t *pkt = buff->cast<uint32_t *>();
+    fc_cache->last_seq_acked = ack_seq;
+    fc_cache->last_ack_time = now;
+    fc_cache->num_acks_sent++;
+
     // Super-verbose mode:
     //static size_t fc_pkt_count = 0;
     //UHD_MSG(status) << "sending flow ctrl packet " << fc_pkt_count++ << ", acking " << str(boost::format("%04d\tseq_sw==0x%08x") % last_seq % seq32) << std::endl;
@@ -258,7 +771,7 @@ static void handle_rx_flowctrl(
     packet_info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_FC;
     packet_info.num_payload_words32 = RXFC_PACKET_LEN_IN_WORDS;
     packet_info.num_payload_bytes = packet_info.num_payload_words32*sizeof(uint32_t);
-    packet_info.packet_count = seq32;
+    packet_info.packet_count = ack_seq;
     packet_info.sob = false;
     packet_info.eob = false;
     packet_info.sid = sid.get();
@@ -273,13 +786,13 @@ static void handle_rx_flowctrl(
         vrt::chdr::if_hdr_pack_be(pkt, packet_info);
         // Load Payload: (the sequence number)
         pkt[packet_info.num_header_words32+RXFC_CMD_CODE_OFFSET] = uhd::htonx<uint32_t>(0);
-        pkt[packet_info.num_header_words32+RXFC_SEQ_NUM_OFFSET]  = uhd::htonx<uint32_t>(seq32);
+        pkt[packet_info.num_header_words32+RXFC_SEQ_NUM_OFFSET]  = uhd::htonx<uint32_t>(ack_seq);
     } else {
         // Load Header:
         vrt::chdr::if_hdr_pack_le(pkt, packet_info);
         // Load Payload: (the sequence number)
         pkt[packet_info.num_header_words32+RXFC_CMD_CODE_OFFSET] = uhd::htowx<uint32_t>(0);
-        pkt[packet_info.num_header_words32+RXFC_SEQ_NUM_OFFSET]  = uhd::htowx<uint32_t>(seq32);
+        pkt[packet_info.num_header_words32+RXFC_SEQ_NUM_OFFSET]  = uhd::htowx<uint32_t>(ack_seq);
     }
 
     //std::cout << "  SID=" << std::hex << sid << " hdr bits=" << packet_info.packet_type << " seq32=" << seq32 << std::endl;
@@ -295,6 +808,33 @@ static void handle_rx_flowctrl(
     buff->commit(sizeof(uint32_t)*(packet_info.num_packet_words32));
 }
 
+//! The flow control of an RX streamer channel, calls handle_rx_flowctrl()
+class rx_flowctrl_t : public sph::recv_flowctrl_if
+{
+public:
+    rx_flowctrl_t(
+            const sid_t &sid,
+            zero_copy_if::sptr xport,
+            endianness_t endianness,
+            boost::shared_ptr<rx_fc_cache_t> fc_cache
+    ):
+        _sid(sid),
+        _xport(xport),
+        _endianness(endianness),
+        _fc_cache(fc_cache) {}
+
+    void handle_flowctrl(const size_t last_seq)
+    {
+        handle_rx_flowctrl(_sid, _xport, _endianness, _fc_cache, last_seq);
+    }
+
+private:
+    const sid_t _sid;
+    const zero_copy_if::sptr _xport;
+    const endianness_t _endianness;
+    const boost::shared_ptr<rx_fc_cache_t> _fc_cache;
+};
+
 /***********************************************************************
  * TX Flow Control Functions
  **********************************************************************/
@@ -308,7 +848,8 @@ struct tx_fc_cache_t
         space(capacity) {}
 
     size_t last_seq_ack;
-    size_t space;
+    //! Only decremented by the sending thread, so a non-zero value can be taken
+    boost::atomic<size_t> space;
 };
 
 /*! Return the size of the flow control window in packets.
@@ -319,7 +860,8 @@ struct tx_fc_cache_t
  * before getting another ack).
  *
  * Note: If `send_buff_size` is set in \p tx_hints, this will
- * override hw_buff_size_.
+ * override hw_buff_size_. If `max_send_window` is set, the window
+ * is at most that many packets.
  */
 static size_t get_tx_flow_control_window(
         size_t pkt_size,
@@ -328,15 +870,57 @@ static size_t get_tx_flow_control_window(
 ) {
     double hw_buff_size = tx_hints.cast<double>("send_buff_size", hw_buff_size_);
     size_t window_in_pkts = (static_cast<size_t>(hw_buff_size) / pkt_size);
+    if (tx_hints.has_key("max_send_window")) {
+        window_in_pkts = std::min(
+            window_in_pkts,
+            tx_hints.cast<size_t>("max_send_window", window_in_pkts)
+        );
+    }
     if (window_in_pkts == 0) {
         throw uhd::value_error("send_buff_size must be larger than the send_frame_size.");
     }
     return window_in_pkts;
 }
 
+/*! Update the TX flow control credit from a flow control response.
+ *
+ * \return false if the packet is not a valid flow control packet
+ */
+static bool update_tx_flow_ctrl(
+    const boost::shared_ptr<tx_fc_cache_t> &fc_cache,
+    const managed_recv_buffer::sptr &buff,
+    uint32_t (*endian_conv)(uint32_t),
+    void (*unpack)(const uint32_t *packet_buff, vrt::if_packet_info_t &)
+) {
+    vrt::if_packet_info_t if_packet_info;
+    if_packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
+    const uint32_t *packet_buff = buff->cast<const uint32_t *>();
+    try {
+        unpack(packet_buff, if_packet_info);
+    }
+    catch(const std::exception &ex)
+    {
+        UHD_MSG(error) << "Error unpacking async flow control packet: " << ex.what() << std::endl;
+        return false;
+    }
+
+    if (if_packet_info.packet_type != vrt::if_packet_info_t::PACKET_TYPE_FC)
+    {
+        UHD_MSG(error) << "Unexpected packet type received by flow control handler: " << if_packet_info.packet_type << std::endl;
+        return false;
+    }
+
+    // update the amount of space
+    size_t seq_ack = endian_conv(packet_buff[if_packet_info.num_header_words32+1]);
+    UHD_TRACE_INSTANT(POINT_FC_RECV, seq_ack);
+    fc_cache->space += (seq_ack - fc_cache->last_seq_ack) & HW_SEQ_NUM_MASK;
+    fc_cache->last_seq_ack = seq_ack;
+    return true;
+}
+
 static bool tx_flow_ctrl(
-    boost::shared_ptr<tx_fc_cache_t> fc_cache,
-	zero_copy_if::sptr async_xport,
+    const boost::shared_ptr<tx_fc_cache_t> &fc_cache,
+    const zero_copy_if::sptr &async_xport,
     uint32_t (*endian_conv)(uint32_t),
     void (*unpack)(const uint32_t *packet_buff, vrt::if_packet_info_t &),
     managed_buffer::sptr
@@ -351,39 +935,59 @@ static bool tx_flow_ctrl(
             return true;
         }
 
-		// Look for a flow control message to update the space available in the buffer.
+        // Look for a flow control message to update the space available in the buffer.
         // A minimal timeout is used because larger timeouts can cause the thread to be
         // scheduled out for too long at high data rates and result in underruns.
-		managed_recv_buffer::sptr buff = async_xport->get_recv_buff(0.000001);
-		if (buff)
-		{
-			vrt::if_packet_info_t if_packet_info;
-			if_packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
-			const uint32_t *packet_buff = buff->cast<const uint32_t *>();
-			try {
-				unpack(packet_buff, if_packet_info);
-			}
-			catch(const std::exception &ex)
-			{
-				UHD_MSG(error) << "Error unpacking async flow control packet: " << ex.what() << std::endl;
-				continue;
-			}
-
-			if (if_packet_info.packet_type != vrt::if_packet_info_t::PACKET_TYPE_FC)
-			{
-				UHD_MSG(error) << "Unexpected packet type received by flow control handler: " << if_packet_info.packet_type << std::endl;
-				continue;
-			}
-
-			// update the amount of space
-			size_t seq_ack = endian_conv(packet_buff[if_packet_info.num_header_words32+1]);
-			fc_cache->space += (seq_ack - fc_cache->last_seq_ack) & HW_SEQ_NUM_MASK;
-			fc_cache->last_seq_ack = seq_ack;
-		}
+        managed_recv_buffer::sptr buff = async_xport->get_recv_buff(0.000001);
+        if (buff)
+        {
+            update_tx_flow_ctrl(fc_cache, buff, endian_conv, unpack);
+        }
     }
     return false;
 }
 
+/*! TX flow control when a task consumes the flow control responses.
+ *
+ * The sending thread only waits on the credit counter and never
+ * calls into the transport.
+ */
+static bool tx_flow_ctrl_threaded(
+    const boost::shared_ptr<tx_fc_cache_t> &fc_cache,
+    managed_buffer::sptr
+) {
+    while (true)
+    {
+        if (fc_cache->space)
+        {
+            fc_cache->space--;
+            return true;
+        }
+        boost::this_thread::yield();
+    }
+    return false;
+}
+
+//! The packets which can be sent now, for get_buffer_status()
+static size_t get_tx_fc_credits(const boost::shared_ptr<tx_fc_cache_t> &fc_cache)
+{
+    return fc_cache->space;
+}
+
+//! The loop body of the task consuming TX flow control responses
+static void tx_flow_ctrl_task(
+    const boost::shared_ptr<tx_fc_cache_t> &fc_cache,
+    const zero_copy_if::sptr &async_xport,
+    uint32_t (*endian_conv)(uint32_t),
+    void (*unpack)(const uint32_t *packet_buff, vrt::if_packet_info_t &)
+) {
+    managed_recv_buffer::sptr buff = async_xport->get_recv_buff(0.1);
+    if (buff)
+    {
+        update_tx_flow_ctrl(fc_cache, buff, endian_conv, unpack);
+    }
+}
+
 /***********************************************************************
  * TX Async Message Functions
  **********************************************************************/
@@ -393,23 +997,30 @@ struct async_tx_info_t
     size_t device_channel;
     boost::shared_ptr<device3_impl::async_md_type> async_queue;
     boost::shared_ptr<device3_impl::async_md_type> old_async_queue;
+    burst_ack_tracker::sptr burst_acks;
+    size_t burst_ack_chan;
+    //! Set by update_tx_streamers(), so no message walks the graph for it
+    boost::atomic<double> tick_rate;
 };
 
 /*! Handle incoming messages.
  *  Send them to the async message queue for the user to poll.
  *
- * This is run inside a uhd::task as long as this streamer lives.
+ * This is a source of the device's async message dispatcher
+ * as long as this streamer lives.
+ *
+ * \return false if no message arrived within the timeout
  */
-static void handle_tx_async_msgs(
-        boost::shared_ptr<async_tx_info_t> async_info,
-        zero_copy_if::sptr xport,
+static bool handle_tx_async_msgs(
+        const boost::shared_ptr<async_tx_info_t> &async_info,
+        const zero_copy_if::sptr &xport,
         endianness_t endianness,
-        boost::function<double(void)> get_tick_rate
+        const double timeout
 ) {
-    managed_recv_buffer::sptr buff = xport->get_recv_buff();
+    managed_recv_buffer::sptr buff = xport->get_recv_buff(timeout);
     if (not buff)
     {
-        return;
+        return false;
     }
 
     //extract packet info
@@ -435,13 +1046,10 @@ static void handle_tx_async_msgs(
     catch(const std::exception &ex)
     {
         UHD_MSG(error) << "Error parsing async message packet: " << ex.what() << std::endl;
-        return;
+        return true;
     }
 
-    double tick_rate = get_tick_rate();
-    if (tick_rate == rfnoc::tick_node_ctrl::RATE_UNDEFINED) {
-        tick_rate = 1;
-    }
+    const double tick_rate = async_info->tick_rate.load(boost::memory_order_relaxed);
 
     //fill in the async metadata
     async_metadata_t metadata;
@@ -459,11 +1067,16 @@ static void handle_tx_async_msgs(
     {
         UHD_MSG(error) << "Unexpected flow control message found in async message handling" << std::endl;
     } else {
-        async_info->async_queue->push_with_pop_on_full(metadata);
+        //wake wait_for_burst_ack() before queuing the message
+        if (metadata.event_code == async_metadata_t::EVENT_CODE_BURST_ACK) {
+            async_info->burst_acks->notify_ack(async_info->burst_ack_chan);
+        }
+        async_info->async_queue->push(metadata);
         metadata.channel = async_info->device_channel;
-        async_info->old_async_queue->push_with_pop_on_full(metadata);
+        async_info->old_async_queue->push(metadata);
         standard_async_msg_prints(metadata);
     }
+    return true;
 }
 
 bool device3_impl::recv_async_msg(
@@ -505,6 +1118,44 @@ void device3_impl::update_rx_streamers(double /* rate */)
     }
 }
 
+void device3_impl::reconfigure_streamers(
+    const reconfigure_fn_t &reconfigure,
+    const std::vector<rx_streamer::sptr> &rx_streamers
+) {
+    boost::mutex::scoped_lock lock(_transport_setup_mutex);
+
+    // Stop the streams first, so the blocks don't produce samples
+    // at a mix of the old and the new rate
+    std::vector<rfnoc::rx_stream_terminator::sptr> stopped;
+    BOOST_FOREACH(const rx_streamer::sptr &streamer, rx_streamers) {
+        boost::shared_ptr<sph::recv_packet_streamer> my_streamer =
+            boost::dynamic_pointer_cast<sph::recv_packet_streamer>(streamer);
+        if (my_streamer and my_streamer->get_terminator()->stop_streaming()) {
+            stopped.push_back(my_streamer->get_terminator());
+        }
+    }
+    if (not stopped.empty()) {
+        // Let the stop commands reach the radios and the last packets leave the blocks
+        boost::this_thread::sleep(boost::posix_time::milliseconds(RECONFIGURE_STOP_DELAY_MS));
+    }
+
+    try {
+        reconfigure();
+    } catch (...) {
+        update_rx_streamers();
+        update_tx_streamers();
+        BOOST_FOREACH(const rfnoc::rx_stream_terminator::sptr &terminator, stopped) {
+            terminator->restart_streaming();
+        }
+        throw;
+    }
+    update_rx_streamers();
+    update_tx_streamers();
+    BOOST_FOREACH(const rfnoc::rx_stream_terminator::sptr &terminator, stopped) {
+        terminator->restart_streaming();
+    }
+}
+
 rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
 {
     boost::mutex::scoped_lock lock(_transport_setup_mutex);
@@ -522,6 +1173,17 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
     // There is only one terminator. If the streamer has multiple channels,
     // it will be connected to each upstream block.
     rfnoc::rx_stream_terminator::sptr recv_terminator = rfnoc::rx_stream_terminator::make();
+    const std::string overflow_recovery = chan_args.empty() ?
+        "restart" : chan_args[0].get("overflow_recovery", "restart");
+    if (overflow_recovery == "resume") {
+        recv_terminator->set_overflow_recovery(rfnoc::rx_stream_terminator::OVERFLOW_RECOVERY_RESUME);
+    } else if (overflow_recovery != "restart") {
+        throw uhd::value_error(str(
+            boost::format("Invalid overflow_recovery stream arg: %s (expected restart or resume)")
+            % overflow_recovery
+        ));
+    }
+    device_addr_t stream_params;
     for (size_t stream_i = 0; stream_i < chan_list.size(); stream_i++) {
         // Get block ID and mb index
         uhd::rfnoc::block_id_t block_id = chan_list[stream_i];
@@ -535,26 +1197,54 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
         uhd::rfnoc::source_block_ctrl_base::sptr blk_ctrl =
             boost::dynamic_pointer_cast<uhd::rfnoc::source_block_ctrl_base>(get_block_ctrl(block_id));
 
-        // Connect the terminator with this channel's block.
-        size_t block_port = blk_ctrl->connect_downstream(
-                recv_terminator,
-                suggested_block_port,
-                args.args
-        );
-        const size_t terminator_port = recv_terminator->connect_upstream(blk_ctrl);
-        blk_ctrl->set_downstream_port(block_port, terminator_port);
-        recv_terminator->set_upstream_port(terminator_port, block_port);
+        // Connect the terminator with this channel's block, or with the
+        // host block connected to it.
+        size_t block_port = suggested_block_port;
+        size_t host_port = 0;
+        uhd::rfnoc::host_block_ctrl::sptr host_blk = find_host_block(blk_ctrl, true, block_port, host_port);
+        if (host_blk) {
+            host_blk->connect_downstream(recv_terminator, host_port, args.args);
+            const size_t terminator_port = recv_terminator->connect_upstream(host_blk);
+            host_blk->set_downstream_port(host_port, terminator_port);
+            recv_terminator->set_upstream_port(terminator_port, host_port);
+        } else {
+            block_port = blk_ctrl->connect_downstream(
+                    recv_terminator,
+                    suggested_block_port,
+                    args.args
+            );
+            const size_t terminator_port = recv_terminator->connect_upstream(blk_ctrl);
+            blk_ctrl->set_downstream_port(block_port, terminator_port);
+            recv_terminator->set_upstream_port(terminator_port, block_port);
+        }
 
         // Check if the block connection is compatible (spp and item type)
         check_stream_sig_compatible(blk_ctrl->get_output_signature(block_port), args, "RX");
 
         // Setup the DSP transport hints
         device_addr_t rx_hints = get_rx_hints(mb_index);
+        const double link_rate = get_stream_link_rate(blk_ctrl, block_port, true, args.otw_format);
+        if (not rx_hints.has_key("link_rate")) {
+            rx_hints["link_rate"] = boost::lexical_cast<std::string>(link_rate);
+        }
+        if (apply_stream_profile(args, rx_hints, link_rate, "RX")) {
+            // The radios decide how large the packets are
+            std::vector<boost::shared_ptr<uhd::rfnoc::radio_ctrl> > radio_nodes =
+                blk_ctrl->find_upstream_node<uhd::rfnoc::radio_ctrl>();
+            uhd::rfnoc::radio_ctrl::sptr this_radio = boost::dynamic_pointer_cast<uhd::rfnoc::radio_ctrl>(blk_ctrl);
+            if (this_radio) {
+                radio_nodes.push_back(this_radio);
+            }
+            BOOST_FOREACH(const boost::shared_ptr<uhd::rfnoc::radio_ctrl> &node, radio_nodes) {
+                node->set_arg<int>("spp", args.args.cast<int>("spp", 0));
+            }
+        }
 
         //allocate sid and create transport
         uhd::sid_t stream_address = blk_ctrl->get_address(block_port);
+        const bool reuse_xport = args.args.cast<int>("reuse_xport", 0) != 0;
         UHD_STREAMER_LOG() << "[RX Streamer] creating rx stream " << rx_hints.to_string() << std::endl;
-        both_xports_t xport = make_transport(stream_address, RX_DATA, rx_hints);
+        both_xports_t xport = get_stream_transport(stream_address, RX_DATA, rx_hints, reuse_xport);
         UHD_STREAMER_LOG() << std::hex << "[RX Streamer] data_sid = " << xport.send_sid << std::dec << " actual recv_buff_size = " << xport.recv_buff_size << std::endl;
 
         // Configure the block
@@ -585,10 +1275,10 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
         //init some streamer stuff
         std::string conv_endianness;
         if (get_transport_endianness(mb_index) == ENDIANNESS_BIG) {
-            my_streamer->set_vrt_unpacker(&vrt::chdr::if_hdr_unpack_be);
+            my_streamer->set_chdr_unpacker(ENDIANNESS_BIG);
             conv_endianness = "be";
         } else {
-            my_streamer->set_vrt_unpacker(&vrt::chdr::if_hdr_unpack_le);
+            my_streamer->set_chdr_unpacker(ENDIANNESS_LITTLE);
             conv_endianness = "le";
         }
 
@@ -598,25 +1288,53 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
         id.num_inputs = 1;
         id.output_format = args.cpu_format;
         id.num_outputs = 1;
-        my_streamer->set_converter(id);
+        my_streamer->set_converter(id, args.args);
+
+        //run the host block on the samples before they are converted
+        if (host_blk) {
+            host_blk->set_item_format(id.input_format, host_port);
+            my_streamer->set_host_work(stream_i,
+                boost::bind(&uhd::rfnoc::host_block_ctrl::work, host_blk, _1, _2, host_port)
+            );
+        }
+
+        //the data packets are spp samples except at the end of a burst
+        if (args.args.cast<int>("fixed_spp", 1) != 0) {
+            my_streamer->set_fixed_spp(spp);
+        }
 
         //flow control setup
         const size_t pkt_size = spp * bpi + stream_options.rx_max_len_hdr;
         const size_t fc_window = get_rx_flow_control_window(pkt_size, xport.recv_buff_size, rx_hints);
         const size_t fc_handle_window = std::max<size_t>(1, fc_window / stream_options.rx_fc_request_freq);
         UHD_STREAMER_LOG()<< "[RX Streamer] Flow Control Window (minus one) = " << fc_window-1 << ", Flow Control Handler Window = " << fc_handle_window << std::endl;
+        if (stream_i == 0) {
+            stream_params["profile"] = args.args.get("profile", "throughput");
+            stream_params["spp"] = boost::lexical_cast<std::string>(spp);
+            stream_params["fc_window"] = boost::lexical_cast<std::string>(fc_window);
+            stream_params["recv_frame_size"] = boost::lexical_cast<std::string>(xport.recv->get_recv_frame_size());
+            stream_params["num_recv_frames"] = boost::lexical_cast<std::string>(xport.recv->get_num_recv_frames());
+        }
         blk_ctrl->configure_flow_control_out(
                 fc_window-1, // Leave one space for overrun packets TODO make this obsolete
                 block_port
         );
 
-        //Give the streamer a functor to get the recv_buffer
-        //bind requires a zero_copy_if::sptr to add a streamer->xport lifetime dependency
-        my_streamer->set_xport_chan_get_buff(
+        //Give the streamer the transport to get the recv_buffer from,
+        //the streamer holds a reference for the streamer->xport lifetime dependency.
+        //Take the packets that are already waiting in one transport call,
+        //but hold on to at most a quarter of the transport's frames
+        const size_t buff_batch = std::min<size_t>(
+            size_t(rx_hints.cast<double>("recv_batch", DEFAULT_RX_BUFF_BATCH)),
+            std::max<size_t>(1, xport.recv->get_num_recv_frames() / 4)
+        );
+        my_streamer->set_xport_chan(
             stream_i,
-            boost::bind(&zero_copy_if::get_recv_buff, xport.recv, _1),
+            xport.recv,
+            buff_batch,
             true /*flush*/
         );
+        my_streamer->set_xport_chan_mboard(stream_i, mb_index);
 
         //Give the streamer a functor to handle overruns
         //bind requires a weak_ptr to break the a streamer->streamer circular dependency
@@ -629,17 +1347,16 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
               )
         );
 
-        //Give the streamer a functor to send flow control messages
+        //Give the streamer the flow control to send flow control messages
         //handle_rx_flowctrl is static and has no lifetime issues
-        boost::shared_ptr<rx_fc_cache_t> fc_cache(new rx_fc_cache_t());
-        my_streamer->set_xport_handle_flowctrl(
-            stream_i, boost::bind(
-                &handle_rx_flowctrl,
+        boost::shared_ptr<rx_fc_cache_t> fc_cache = make_rx_fc_cache(fc_window-1, fc_handle_window, rx_hints);
+        my_streamer->set_xport_flowctrl(
+            stream_i,
+            boost::make_shared<rx_flowctrl_t>(
                 xport.send_sid,
                 xport.send,
                 get_transport_endianness(mb_index),
-                fc_cache,
-                _1
+                fc_cache
             ),
             fc_handle_window,
             true/*init*/
@@ -654,6 +1371,19 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
 
         // Tell the streamer which SID is valid for this channel
         my_streamer->set_xport_chan_sid(stream_i, true, xport.send_sid);
+
+        publish_stats<zero_copy_stats_t>(_tree,
+            fs_path("/mboards") / mb_index / "xports" / xport.send_sid.to_pp_string_hex() / "stats",
+            xport.recv
+        );
+        const fs_path fc_window_path =
+            fs_path("/mboards") / mb_index / "xports" / xport.send_sid.to_pp_string_hex() / "fc_window";
+        if (_tree->exists(fc_window_path)) {
+            _tree->remove(fc_window_path);
+        }
+        _tree->create<uint64_t>(fc_window_path).set_publisher(boost::bind(
+            &get_rx_fc_window, boost::weak_ptr<rx_fc_cache_t>(fc_cache)
+        ));
     }
 
     // Connect the terminator to the streamer
@@ -666,11 +1396,21 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
     // Note that we store the streamer only once, and use its terminator's
     // ID to do so.
     _rx_streamers[recv_terminator->unique_id()] = boost::weak_ptr<sph::recv_packet_streamer>(my_streamer);
+    publish_stats<transport::stream_stats_t>(_tree,
+        fs_path("/mboards") / chan_list[0].get_device_no() / "rx_streamers" / recv_terminator->unique_id() / "stats",
+        my_streamer
+    );
+    publish_stream_params(_tree,
+        fs_path("/mboards") / chan_list[0].get_device_no() / "rx_streamers" / recv_terminator->unique_id() / "params",
+        stream_params
+    );
 
     // Sets tick rate, samp rate and scaling on this streamer.
     // A registered terminator is required to do this.
     update_rx_streamers();
 
+    my_streamer->apply_stream_args(args.args);
+
     post_streamer_hooks(RX_DIRECTION);
     return my_streamer;
 }
@@ -678,12 +1418,29 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
 /***********************************************************************
  * Transmit streamer
  **********************************************************************/
+// This class manages the lifetime of the TX async message handler task and transports
+class device3_send_packet_streamer : public sph::send_packet_streamer
+{
+public:
+	device3_send_packet_streamer(const size_t max_num_samps) : sph::send_packet_streamer(max_num_samps) {};
+	~device3_send_packet_streamer() {
+		_tx_async_msg_sources.clear();	// Make sure the async sources are removed before the transports
+		_tx_fc_tasks.clear();
+	};
+
+	both_xports_t _xport;
+	both_xports_t _async_xport;
+	std::vector<async_msg_dispatcher::source_handle> _tx_async_msg_sources;
+	std::vector<task::sptr> _tx_fc_tasks;
+	std::vector<boost::shared_ptr<async_tx_info_t> > _tx_async_infos;
+};
+
 void device3_impl::update_tx_streamers(double /* rate */)
 {
     BOOST_FOREACH(const std::string &block_id, _tx_streamers.keys()) {
         UHD_STREAMER_LOG() << "[Device3] updating TX streamer: " << block_id << std::endl;
-        boost::shared_ptr<sph::send_packet_streamer> my_streamer =
-            boost::dynamic_pointer_cast<sph::send_packet_streamer>(_tx_streamers[block_id].lock());
+        boost::shared_ptr<device3_send_packet_streamer> my_streamer =
+            boost::dynamic_pointer_cast<device3_send_packet_streamer>(_tx_streamers[block_id].lock());
         if (my_streamer) {
             double tick_rate = my_streamer->get_terminator()->get_tick_rate();
             if (tick_rate == rfnoc::tick_node_ctrl::RATE_UNDEFINED) {
@@ -701,24 +1458,13 @@ void device3_impl::update_tx_streamers(double /* rate */)
             my_streamer->set_tick_rate(tick_rate);
             my_streamer->set_samp_rate(samp_rate);
             my_streamer->set_scale_factor(scaling);
+            BOOST_FOREACH(const boost::shared_ptr<async_tx_info_t> &async_info, my_streamer->_tx_async_infos) {
+                async_info->tick_rate = tick_rate;
+            }
         }
     }
 }
 
-// This class manages the lifetime of the TX async message handler task and transports
-class device3_send_packet_streamer : public sph::send_packet_streamer
-{
-public:
-	device3_send_packet_streamer(const size_t max_num_samps) : sph::send_packet_streamer(max_num_samps) {};
-	~device3_send_packet_streamer() {
-		_tx_async_msg_task.reset();	// Make sure the async task is destroyed before the transports
-	};
-
-	both_xports_t _xport;
-	both_xports_t _async_xport;
-	task::sptr _tx_async_msg_task;
-};
-
 tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
 {
     boost::mutex::scoped_lock lock(_transport_setup_mutex);
@@ -732,6 +1478,8 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
 
     //shared async queue for all channels in streamer
     boost::shared_ptr<async_md_type> async_md(new async_md_type(1000/*messages deep*/));
+    //burst acks of all channels, counted as they arrive
+    burst_ack_tracker::sptr burst_acks(new burst_ack_tracker(chan_list.size()));
 
     // II. Iterate over all channels
     boost::shared_ptr<device3_send_packet_streamer> my_streamer;
@@ -739,6 +1487,7 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
     // There is only one terminator. If the streamer has multiple channels,
     // it will be connected to each downstream block.
     rfnoc::tx_stream_terminator::sptr send_terminator = rfnoc::tx_stream_terminator::make();
+    device_addr_t stream_params;
     for (size_t stream_i = 0; stream_i < chan_list.size(); stream_i++) {
         // Get block ID and mb index
         uhd::rfnoc::block_id_t block_id = chan_list[stream_i];
@@ -752,28 +1501,45 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
         uhd::rfnoc::sink_block_ctrl_base::sptr blk_ctrl =
             boost::dynamic_pointer_cast<uhd::rfnoc::sink_block_ctrl_base>(get_block_ctrl(block_id));
 
-        // Connect the terminator with this channel's block.
+        // Connect the terminator with this channel's block, or with the
+        // host block connected to it.
         // This will throw if the connection is not possible.
-        size_t block_port = blk_ctrl->connect_upstream(
-                send_terminator,
-                suggested_block_port,
-                args.args
-        );
-        const size_t terminator_port = send_terminator->connect_downstream(blk_ctrl);
-        blk_ctrl->set_upstream_port(block_port, terminator_port);
-        send_terminator->set_downstream_port(terminator_port, block_port);
+        size_t block_port = suggested_block_port;
+        size_t host_port = 0;
+        uhd::rfnoc::host_block_ctrl::sptr host_blk = find_host_block(blk_ctrl, false, block_port, host_port);
+        if (host_blk) {
+            host_blk->connect_upstream(send_terminator, host_port, args.args);
+            const size_t terminator_port = send_terminator->connect_downstream(host_blk);
+            host_blk->set_upstream_port(host_port, terminator_port);
+            send_terminator->set_downstream_port(terminator_port, host_port);
+        } else {
+            block_port = blk_ctrl->connect_upstream(
+                    send_terminator,
+                    suggested_block_port,
+                    args.args
+            );
+            const size_t terminator_port = send_terminator->connect_downstream(blk_ctrl);
+            blk_ctrl->set_upstream_port(block_port, terminator_port);
+            send_terminator->set_downstream_port(terminator_port, block_port);
+        }
 
         // Check if the block connection is compatible (spp and item type)
         check_stream_sig_compatible(blk_ctrl->get_input_signature(block_port), args, "TX");
 
         // Setup the dsp transport hints
         device_addr_t tx_hints = get_tx_hints(mb_index);
+        const double link_rate = get_stream_link_rate(blk_ctrl, block_port, false, args.otw_format);
+        if (not tx_hints.has_key("link_rate")) {
+            tx_hints["link_rate"] = boost::lexical_cast<std::string>(link_rate);
+        }
+        apply_stream_profile(args, tx_hints, link_rate, "TX");
 
         //allocate sid and create transport
         uhd::sid_t stream_address = blk_ctrl->get_address(block_port);
+        const bool reuse_xport = args.args.cast<int>("reuse_xport", 0) != 0;
         UHD_STREAMER_LOG() << "[TX Streamer] creating tx stream " << tx_hints.to_string() << std::endl;
-        both_xports_t xport = make_transport(stream_address, TX_DATA, tx_hints);
-		both_xports_t async_xport = make_transport(stream_address, ASYNC_MSG, device_addr_t(""));
+        both_xports_t xport = get_stream_transport(stream_address, TX_DATA, tx_hints, reuse_xport);
+		both_xports_t async_xport = get_stream_transport(stream_address, ASYNC_MSG, device_addr_t(""), reuse_xport);
         UHD_STREAMER_LOG() << std::hex << "[TX Streamer] data_sid = " << xport.send_sid << std::dec << std::endl;
 
         // To calculate the max number of samples per packet, we assume the maximum header length
@@ -793,10 +1559,10 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
         //init some streamer stuff
         std::string conv_endianness;
         if (get_transport_endianness(mb_index) == ENDIANNESS_BIG) {
-            my_streamer->set_vrt_packer(&vrt::chdr::if_hdr_pack_be);
+            my_streamer->set_chdr_packer(ENDIANNESS_BIG);
             conv_endianness = "be";
         } else {
-            my_streamer->set_vrt_packer(&vrt::chdr::if_hdr_pack_le);
+            my_streamer->set_chdr_packer(ENDIANNESS_LITTLE);
             conv_endianness = "le";
         }
 
@@ -806,7 +1572,15 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
         id.num_inputs = 1;
         id.output_format = args.otw_format + "_item32_" + conv_endianness;
         id.num_outputs = 1;
-        my_streamer->set_converter(id);
+        my_streamer->set_converter(id, args.args);
+
+        //run the host block on the samples after they are converted
+        if (host_blk) {
+            host_blk->set_item_format(id.output_format, host_port);
+            my_streamer->set_host_work(stream_i,
+                boost::bind(&uhd::rfnoc::host_block_ctrl::work, host_blk, _1, _2, host_port)
+            );
+        }
 
         //flow control setup
         const size_t pkt_size = spp * bpi + stream_options.tx_max_len_hdr;
@@ -818,6 +1592,13 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
         );
         const size_t fc_handle_window = std::max<size_t>(1, fc_window / stream_options.tx_fc_response_freq);
         UHD_STREAMER_LOG() << "[TX Streamer] Flow Control Window = " << fc_window << ", Flow Control Handler Window = " << fc_handle_window << std::endl;
+        if (stream_i == 0) {
+            stream_params["profile"] = args.args.get("profile", "throughput");
+            stream_params["spp"] = boost::lexical_cast<std::string>(spp);
+            stream_params["fc_window"] = boost::lexical_cast<std::string>(fc_window);
+            stream_params["send_frame_size"] = boost::lexical_cast<std::string>(xport.send->get_send_frame_size());
+            stream_params["num_send_frames"] = boost::lexical_cast<std::string>(xport.send->get_num_send_frames());
+        }
         blk_ctrl->configure_flow_control_in(
                 stream_options.tx_fc_response_cycles,
                 fc_handle_window, /*pkts*/
@@ -829,22 +1610,20 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
         async_tx_info->device_channel = mb_index;
         async_tx_info->async_queue = async_md;
         async_tx_info->old_async_queue = _async_md;
+        async_tx_info->burst_acks = burst_acks;
+        async_tx_info->burst_ack_chan = stream_i;
+        async_tx_info->tick_rate = 1.0; //until update_tx_streamers() below
+        my_streamer->_tx_async_infos.push_back(async_tx_info);
 
-        boost::function<double(void)> tick_rate_retriever = boost::bind(
-                &rfnoc::tick_node_ctrl::get_tick_rate,
-                send_terminator,
-                std::set< rfnoc::node_ctrl_base::sptr >() // Need to specify default args with bind
-        );
-
-        my_streamer->_tx_async_msg_task = task::make(
+        my_streamer->_tx_async_msg_sources.push_back(_async_msg_dispatcher->add_source(
                 boost::bind(
                     &handle_tx_async_msgs,
                     async_tx_info,
                     my_streamer->_async_xport.recv,
                     endianness,
-                    tick_rate_retriever
+                    _1
                 )
-        );
+        ));
 
         blk_ctrl->sr_write(uhd::rfnoc::SR_CLEAR_RX_FC, 0xc1ea12, block_port);
         blk_ctrl->sr_write(uhd::rfnoc::SR_RESP_IN_DST_SID, my_streamer->_async_xport.recv_sid.get_dst(), block_port);
@@ -880,30 +1659,58 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
         }
 
         // Add flow control
+        // With send_fc_thread=1, a task consumes the flow control responses
+        // and the sending thread only checks the credit counter.
         boost::shared_ptr<tx_fc_cache_t> fc_cache(new tx_fc_cache_t(fc_window));
-        my_streamer->_xport.send = zero_copy_flow_ctrl::make(
-            my_streamer->_xport.send,
-            boost::bind(
-				&tx_flow_ctrl,
-				fc_cache,
-				my_streamer->_xport.recv,
-				(endianness == ENDIANNESS_BIG ? uhd::ntohx<uint32_t> : uhd::wtohx<uint32_t>),
-				(endianness == ENDIANNESS_BIG ? vrt::chdr::if_hdr_unpack_be : vrt::chdr::if_hdr_unpack_le),
-				 _1),
-            NULL);
-
-        //Give the streamer a functor to get the send buffer
-        my_streamer->set_xport_chan_get_buff(
-            stream_i,
-            boost::bind(&zero_copy_if::get_send_buff, my_streamer->_xport.send, _1)
-        );
+        uint32_t (*fc_endian_conv)(uint32_t) = (endianness == ENDIANNESS_BIG ? uhd::ntohx<uint32_t> : uhd::wtohx<uint32_t>);
+        void (*fc_unpack)(const uint32_t *, vrt::if_packet_info_t &) = (endianness == ENDIANNESS_BIG ? vrt::chdr::if_hdr_unpack_be : vrt::chdr::if_hdr_unpack_le);
+        if (tx_hints.cast<int>("send_fc_thread", 0) != 0) {
+            my_streamer->_tx_fc_tasks.push_back(task::make(boost::bind(
+                &tx_flow_ctrl_task,
+                fc_cache,
+                my_streamer->_xport.recv,
+                fc_endian_conv,
+                fc_unpack
+            ), "tx_fc"));
+            my_streamer->_xport.send = zero_copy_flow_ctrl::make(
+                my_streamer->_xport.send,
+                boost::bind(&tx_flow_ctrl_threaded, fc_cache, _1),
+                NULL);
+        } else {
+            my_streamer->_xport.send = zero_copy_flow_ctrl::make(
+                my_streamer->_xport.send,
+                boost::bind(
+                    &tx_flow_ctrl,
+                    fc_cache,
+                    my_streamer->_xport.recv,
+                    fc_endian_conv,
+                    fc_unpack,
+                    _1),
+                NULL);
+        }
+
+        //Give the streamer the transport to get the send buffer from
+        my_streamer->set_xport_chan(stream_i, my_streamer->_xport.send);
+        // Without send_fc_thread, the responses are only read when the
+        // credits run out, so the buffer status lags behind the device.
+        my_streamer->set_xport_chan_fc_credits(stream_i,
+            boost::bind(&get_tx_fc_credits, fc_cache), fc_window);
         //Give the streamer a functor handled received async messages
         my_streamer->set_async_receiver(
             boost::bind(&async_md_type::pop_with_timed_wait, async_md, _1, _2)
         );
+        my_streamer->set_async_msg_callback_setter(
+            boost::bind(&async_md_type::set_callback, async_md, _1)
+        );
+        my_streamer->set_burst_ack_tracker(burst_acks);
         my_streamer->set_xport_chan_sid(stream_i, true, xport.send_sid);
         // CHDR does not support trailers
         my_streamer->set_enable_trailer(false);
+
+        publish_stats<zero_copy_stats_t>(_tree,
+            fs_path("/mboards") / mb_index / "xports" / xport.send_sid.to_pp_string_hex() / "stats",
+            my_streamer->_xport.send
+        );
     }
 
     // Connect the terminator to the streamer
@@ -916,11 +1723,21 @@ tx_streamer::sptr device3_impl::get_tx_stream(const uhd::stream_args_t &args_)
     // Note that we store the streamer only once, and use its terminator's
     // ID to do so.
     _tx_streamers[send_terminator->unique_id()] = boost::weak_ptr<sph::send_packet_streamer>(my_streamer);
+    publish_stats<transport::stream_stats_t>(_tree,
+        fs_path("/mboards") / chan_list[0].get_device_no() / "tx_streamers" / send_terminator->unique_id() / "stats",
+        my_streamer
+    );
+    publish_stream_params(_tree,
+        fs_path("/mboards") / chan_list[0].get_device_no() / "tx_streamers" / send_terminator->unique_id() / "params",
+        stream_params
+    );
 
     // Sets tick rate, samp rate and scaling on this streamer
     // A registered terminator is required to do this.
     update_tx_streamers();
 
+    my_streamer->apply_stream_args(args.args);
+
     post_streamer_hooks(TX_DIRECTION);
     return my_streamer;
 }
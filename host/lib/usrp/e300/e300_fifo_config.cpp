@@ -79,7 +79,8 @@ static UHD_INLINE size_t ZF_STREAM_OFF(const size_t which)
 #include "e300_fifo_config.hpp"
 #include <sys/mman.h> //mmap
 #include <fcntl.h> //open, close
-#include <poll.h> //poll
+#include <poll.h> //poll, ppoll
+#include <algorithm> //min
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/msg.hpp>
 #include <boost/format.hpp>
@@ -103,14 +104,14 @@ struct e300_fifo_poll_waiter
 
     void wait(const double timeout)
     {
-        if (timeout == 0) {
+        if (timeout <= 0) {
             return;
         }
 
         boost::mutex::scoped_lock l(_mutex);
         if (_poll_claimed)
         {
-            _cond.timed_wait(l, boost::posix_time::microseconds(timeout*1000000));
+            _cond.timed_wait(l, boost::posix_time::microseconds(long(timeout*1000000)));
         }
         else
         {
@@ -119,7 +120,12 @@ struct e300_fifo_poll_waiter
             struct pollfd fds[1];
             fds[0].fd = _fd;
             fds[0].events = POLLIN;
-            ::poll(fds, 1, long(timeout*1000));
+            //ppoll() rather than poll(), which would truncate
+            //sub-millisecond timeouts to a busy loop
+            struct timespec ts;
+            ts.tv_sec = time_t(timeout);
+            ts.tv_nsec = long((timeout - ts.tv_sec)*1e9);
+            ::ppoll(fds, 1, &ts, NULL);
             if (fds[0].revents & POLLIN)
                 ::read(_fd, NULL, 0);
 
@@ -201,13 +207,16 @@ public:
         const size_t num_frames,
         const size_t frame_size,
         e300_fifo_poll_waiter *waiter,
-        const bool auto_release
+        const bool auto_release,
+        const double busy_poll_time
     ):
         _allocator(allocator),
         _addrs(addrs),
         _num_frames(num_frames),
         _frame_size(frame_size),
         _index(0),
+        _num_ready(0),
+        _busy_poll_time(busy_poll_time),
         _waiter(waiter)
     {
         //UHD_MSG(status) << boost::format("phys 0x%x") % addrs.phys << std::endl;
@@ -243,24 +252,31 @@ public:
     template <typename T>
     UHD_INLINE typename T::sptr get_buff(const double timeout)
     {
-        const time_spec_t exit_time = time_spec_t::get_system_time() + time_spec_t(timeout);
+        //fast path: a frame completed since the last status fifo read
+        if (_num_ready == 0)
+            _num_ready = zf_peek32(_addrs.ctrl + ARBITER_RB_STATUS_OCC);
+        if (_num_ready != 0)
+            return this->pop_buff<T>();
+
+        const time_spec_t now = time_spec_t::get_system_time();
+        const time_spec_t exit_time = now + time_spec_t(timeout);
+        const time_spec_t spin_time = now + time_spec_t(std::min(timeout, _busy_poll_time));
         while (1)
         {
-            if (zf_peek32(_addrs.ctrl + ARBITER_RB_STATUS_OCC))
-            {
-                const uint32_t sts = zf_peek32(_addrs.ctrl + ARBITER_RB_STATUS);
-                UHD_ASSERT_THROW((sts >> 7) & 0x1); //assert OK
-                UHD_ASSERT_THROW((sts & 0xf) == _addrs.which); //expected tag
-                zf_poke32(_addrs.ctrl + ARBITER_WR_STS_RDY, 1); //pop from sts fifo
-                if (_index == _num_frames)
-                    _index = 0;
-                return _buffs[_index++]->get_new<T>();
-            }
-            if (time_spec_t::get_system_time() > exit_time) {
+            //take every frame completed by this wakeup at once,
+            //so the next calls do not touch the occupancy register
+            _num_ready = zf_peek32(_addrs.ctrl + ARBITER_RB_STATUS_OCC);
+            if (_num_ready != 0)
+                return this->pop_buff<T>();
+
+            const time_spec_t time_now = time_spec_t::get_system_time();
+            if (time_now > exit_time) {
                 break;
             }
-            _waiter->wait(timeout);
-            //boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+            if (time_now < spin_time) {
+                continue; //within the busy poll budget
+            }
+            _waiter->wait((exit_time - time_now).get_real_secs());
         }
 
         return typename T::sptr();
@@ -297,11 +313,26 @@ public:
     }
 
 private:
+    template <typename T>
+    UHD_INLINE typename T::sptr pop_buff(void)
+    {
+        const uint32_t sts = zf_peek32(_addrs.ctrl + ARBITER_RB_STATUS);
+        UHD_ASSERT_THROW((sts >> 7) & 0x1); //assert OK
+        UHD_ASSERT_THROW((sts & 0xf) == _addrs.which); //expected tag
+        zf_poke32(_addrs.ctrl + ARBITER_WR_STS_RDY, 1); //pop from sts fifo
+        _num_ready--;
+        if (_index == _num_frames)
+            _index = 0;
+        return _buffs[_index++]->get_new<T>();
+    }
+
     boost::shared_ptr<void> _allocator;
     const __mem_addrz_t _addrs;
     const size_t _num_frames;
     const size_t _frame_size;
     size_t _index;
+    uint32_t _num_ready;
+    const double _busy_poll_time;
     e300_fifo_poll_waiter *_waiter;
     std::vector<boost::shared_ptr<e300_fifo_mb> > _buffs;
 };
@@ -395,8 +426,8 @@ private:
         addrs.ctrl = ((is_recv)? S2H_BASE(_ctrl_space) : H2S_BASE(_ctrl_space)) + ZF_STREAM_OFF(which_stream);
 
         uhd::transport::zero_copy_if::sptr xport;
-        if (is_recv) xport.reset(new e300_transport(shared_from_this(), addrs, num_frames, frame_size, _waiter, is_recv));
-        else         xport.reset(new e300_transport(shared_from_this(), addrs, num_frames, frame_size, _waiter, is_recv));
+        xport.reset(new e300_transport(
+            shared_from_this(), addrs, num_frames, frame_size, _waiter, is_recv, _config.busy_poll_time));
 
         _bytes_in_use += num_frames*frame_size;
         entries_in_use += num_frames;
@@ -28,6 +28,8 @@ struct e300_fifo_config_t
     size_t ctrl_length;
     size_t buff_length;
     size_t phys_addr;
+    //! time in seconds to spin on the status fifo before sleeping in poll()
+    double busy_poll_time;
 };
 
 e300_fifo_config_t e300_read_sysfs(void);
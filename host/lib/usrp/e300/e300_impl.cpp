@@ -392,6 +392,7 @@ e300_impl::e300_impl(const uhd::device_addr_t &device_addr)
         } catch (...) {
             throw uhd::runtime_error("Failed to get driver parameters from sysfs.");
         }
+        fifo_cfg.busy_poll_time = device_addr.cast<double>("busy_poll_us", 0.0)/1e6;
         _fifo_iface = e300_fifo_interface::make(fifo_cfg);
         _global_regs = global_regs::make(_fifo_iface->get_global_regs_base());
 
@@ -41,6 +41,9 @@
 #include <boost/make_shared.hpp>
 
 #include <fstream>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h> //sendmmsg, recvmmsg
 
 using namespace uhd;
 using namespace uhd::transport;
@@ -69,8 +72,13 @@ static inline bool wait_for_recv_ready(int sock_fd, const size_t timeout_ms)
 
 static boost::mutex endpoint_mutex;
 
+//! the most packets relayed per sendmmsg() or recvmmsg() call
+static const size_t E300_NETWORK_BATCH_SIZE = 16;
+
 /***********************************************************************
  * Receive tunnel - forwards recv interface to send socket
+ * The packets are sent straight from the DMA buffers, and all frames
+ * that are ready are sent with a single sendmmsg() call.
  **********************************************************************/
 static void e300_recv_tunnel(
     const std::string &name,
@@ -81,14 +89,25 @@ static void e300_recv_tunnel(
 )
 {
     asio::ip::udp::endpoint _tx_endpoint;
+    std::vector<managed_recv_buffer::sptr> buffs;
+    buffs.reserve(E300_NETWORK_BATCH_SIZE);
+    iovec iovs[E300_NETWORK_BATCH_SIZE];
+    mmsghdr msgs[E300_NETWORK_BATCH_SIZE];
     try
     {
         while (*running)
         {
-            //step 1 - get the buffer
+            //step 1 - wait for a buffer, then take the others that are ready
             managed_recv_buffer::sptr buff = recver->get_recv_buff();
             if (not buff) continue;
-            if (E300_NETWORK_DEBUG) UHD_MSG(status) << name << " got " << buff->size() << std::endl;
+            buffs.push_back(buff);
+            while (buffs.size() < E300_NETWORK_BATCH_SIZE)
+            {
+                buff = recver->get_recv_buff(0.0);
+                if (not buff) break;
+                buffs.push_back(buff);
+            }
+            if (E300_NETWORK_DEBUG) UHD_MSG(status) << name << " got " << buffs.size() << " buffers" << std::endl;
 
             //step 1.5 -- update endpoint
             {
@@ -97,7 +116,28 @@ static void e300_recv_tunnel(
             }
 
             //step 2 - send to the socket
-            sender->send_to(asio::buffer(buff->cast<const void *>(), buff->size()), _tx_endpoint);
+            std::memset(msgs, 0, sizeof(msgs));
+            for (size_t i = 0; i < buffs.size(); i++)
+            {
+                iovs[i].iov_base = buffs[i]->cast<void *>();
+                iovs[i].iov_len = buffs[i]->size();
+                msgs[i].msg_hdr.msg_name = _tx_endpoint.data();
+                msgs[i].msg_hdr.msg_namelen = _tx_endpoint.size();
+                msgs[i].msg_hdr.msg_iov = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            size_t num_sent = 0;
+            while (num_sent < buffs.size())
+            {
+                const int ret = ::sendmmsg(sender->native(), msgs + num_sent, buffs.size() - num_sent, 0);
+                if (ret < 0 and errno == EINTR) continue;
+                if (ret < 0) throw uhd::io_error(str(boost::format(
+                    "sendmmsg failed: %s") % strerror(errno)));
+                num_sent += size_t(ret);
+            }
+
+            //step 3 - hand the buffers back to the DMA engine
+            buffs.clear();
         }
     }
     catch(const std::exception &ex)
@@ -114,6 +154,8 @@ static void e300_recv_tunnel(
 
 /***********************************************************************
  * Send tunnel - forwards recv socket to send interface
+ * The packets are received straight into the DMA buffers, and all
+ * packets that are queued on the socket are taken with one recvmmsg().
  **********************************************************************/
 static void e300_send_tunnel(
     const std::string &name,
@@ -124,28 +166,68 @@ static void e300_send_tunnel(
 )
 {
     asio::ip::udp::endpoint _rx_endpoint;
+    std::vector<managed_send_buffer::sptr> buffs;
+    buffs.reserve(E300_NETWORK_BATCH_SIZE);
+    iovec iovs[E300_NETWORK_BATCH_SIZE];
+    mmsghdr msgs[E300_NETWORK_BATCH_SIZE];
+    sockaddr_storage addrs[E300_NETWORK_BATCH_SIZE];
     try
     {
         while (*running)
         {
-            //step 1 - get the buffer
-            managed_send_buffer::sptr buff = sender->get_send_buff();
-            if (not buff) continue;
+            //step 1 - get the buffers, the ones left over from the last batch are kept
+            if (buffs.empty())
+            {
+                managed_send_buffer::sptr buff = sender->get_send_buff();
+                if (not buff) continue;
+                buffs.push_back(buff);
+            }
+            while (buffs.size() < E300_NETWORK_BATCH_SIZE)
+            {
+                managed_send_buffer::sptr buff = sender->get_send_buff(0.0);
+                if (not buff) break;
+                buffs.push_back(buff);
+            }
 
-            //step 2 - recv from socket
-            while (not wait_for_recv_ready(recver->native(), 100) and *running){}
-            if (not *running) break;
-            const size_t num_bytes = recver->receive_from(asio::buffer(buff->cast<void *>(), buff->size()), _rx_endpoint);
-            if (E300_NETWORK_DEBUG) UHD_MSG(status) << name << " got " << num_bytes << std::endl;
+            //step 2 - recv from socket, waiting only when it is empty
+            std::memset(msgs, 0, sizeof(msgs));
+            for (size_t i = 0; i < buffs.size(); i++)
+            {
+                iovs[i].iov_base = buffs[i]->cast<void *>();
+                iovs[i].iov_len = buffs[i]->size();
+                msgs[i].msg_hdr.msg_name = &addrs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+                msgs[i].msg_hdr.msg_iov = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            const int ret = ::recvmmsg(recver->native(), msgs, buffs.size(), MSG_DONTWAIT, NULL);
+            if (ret < 0)
+            {
+                if (errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR)
+                    throw uhd::io_error(str(boost::format("recvmmsg failed: %s") % strerror(errno)));
+                while (not wait_for_recv_ready(recver->native(), 100) and *running){}
+                continue;
+            }
+            const size_t num_recvd = size_t(ret);
+            if (E300_NETWORK_DEBUG) UHD_MSG(status) << name << " got " << num_recvd << " packets" << std::endl;
 
             //step 2.5 -- update endpoint
+            const size_t addr_len = msgs[num_recvd-1].msg_hdr.msg_namelen;
+            if (addr_len <= _rx_endpoint.capacity())
             {
+                std::memcpy(_rx_endpoint.data(), &addrs[num_recvd-1], addr_len);
+                _rx_endpoint.resize(addr_len);
                 boost::mutex::scoped_lock l(endpoint_mutex);
                 *endpoint = _rx_endpoint;
             }
 
-            //step 3 - commit the buffer
-            buff->commit(num_bytes);
+            //step 3 - commit the buffers
+            for (size_t i = 0; i < num_recvd; i++)
+            {
+                buffs[i]->commit(msgs[i].msg_len);
+                buffs[i].reset();
+            }
+            buffs.erase(buffs.begin(), buffs.begin() + num_recvd);
         }
     }
     catch(const std::exception &ex)
@@ -504,32 +586,34 @@ void network_server_impl::_run_server(
             UHD_MSG(status) << "e300 socket accept on port " << port << " for " << what << std::endl;
             //asio::ip::udp::no_delay option(true);
             //socket->set_option(option);
+            //the second tunnel of a pair gets a thread,
+            //the first one, or the only one, runs in this thread
             boost::thread_group tg;
             bool running = true;
             xports_t &perif = _xports[fe];
             if (what == "RX") {
-                tg.create_thread(boost::bind(&e300_recv_tunnel, "RX data tunnel", perif.rx_data_xport, socket, &endpoint, &running));
                 tg.create_thread(boost::bind(&e300_send_tunnel, "RX flow tunnel", socket, perif.rx_flow_xport, &endpoint, &running));
+                e300_recv_tunnel("RX data tunnel", perif.rx_data_xport, socket, &endpoint, &running);
             }
             if (what == "TX") {
                 tg.create_thread(boost::bind(&e300_recv_tunnel, "TX flow tunnel", perif.tx_flow_xport, socket, &endpoint, &running));
-                tg.create_thread(boost::bind(&e300_send_tunnel, "TX data tunnel", socket, perif.tx_data_xport, &endpoint, &running));
+                e300_send_tunnel("TX data tunnel", socket, perif.tx_data_xport, &endpoint, &running);
             }
             if (what == "CTRL") {
                 tg.create_thread(boost::bind(&e300_recv_tunnel, "response tunnel", perif.recv_ctrl_xport, socket, &endpoint, &running));
-                tg.create_thread(boost::bind(&e300_send_tunnel, "control tunnel", socket, perif.send_ctrl_xport, &endpoint, &running));
+                e300_send_tunnel("control tunnel", socket, perif.send_ctrl_xport, &endpoint, &running);
             }
             if (what == "CODEC") {
-                tg.create_thread(boost::bind(&e300_codec_ctrl_tunnel, "CODEC tunnel", socket, _codec_ctrl, &endpoint, &running));
+                e300_codec_ctrl_tunnel("CODEC tunnel", socket, _codec_ctrl, &endpoint, &running);
             }
             if (what == "I2C") {
-                tg.create_thread(boost::bind(&e300_i2c_tunnel, "I2C tunnel", socket, _eeprom_manager->get_i2c_sptr(), &endpoint, &running));
+                e300_i2c_tunnel("I2C tunnel", socket, _eeprom_manager->get_i2c_sptr(), &endpoint, &running);
             }
             if (what == "GREGS") {
-                tg.create_thread(boost::bind(&e300_global_regs_tunnel, "GREGS tunnel", socket, _global_regs, &endpoint, &running));
+                e300_global_regs_tunnel("GREGS tunnel", socket, _global_regs, &endpoint, &running);
             }
             if (what == "SENSOR") {
-                tg.create_thread(boost::bind(&e300_sensor_tunnel, "SENSOR tunnel", socket, _sensor_manager, &endpoint, &running));
+                e300_sensor_tunnel("SENSOR tunnel", socket, _sensor_manager, &endpoint, &running);
             }
 
             tg.join_all();
@@ -619,6 +703,7 @@ network_server_impl::network_server_impl(const uhd::device_addr_t &device_addr)
     } catch (uhd::lookup_error &e) {
         throw uhd::runtime_error("Failed to get driver parameters from sysfs.");
     }
+    fifo_cfg.busy_poll_time = device_addr.cast<double>("busy_poll_us", 0.0)/1e6;
     _fifo_iface = e300_fifo_interface::make(fifo_cfg);
     _global_regs = global_regs::make(_fifo_iface->get_global_regs_base());
 
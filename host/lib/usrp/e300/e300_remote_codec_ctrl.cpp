@@ -99,6 +99,12 @@ public:
         return _retval.freq;
     }
 
+    double tune_with_profile(const std::string &which, const size_t, const double value)
+    {
+        // Tune profiles are not part of the network protocol
+        return tune(which, value);
+    }
+
     double get_freq(const std::string &which)
     {
         _clear();
@@ -175,6 +181,11 @@ public:
         _transact();
     }
 
+    void set_cal_cache_temp_drift(const double)
+    {
+        // The calibration cache is configured on the device side
+    }
+
     void set_agc(const std::string &which, bool enable)
     {
         _clear();
@@ -102,6 +102,7 @@ e300_fifo_config_t e300_read_sysfs(void)
         e300_get_sysfs_attr(E300_AXI_FPGA_SYSFS, "control_length"));
     config.phys_addr = boost::lexical_cast<unsigned long>(
         e300_get_sysfs_attr(E300_AXI_FPGA_SYSFS, "phys_addr"));
+    config.busy_poll_time = 0.0;
 
     return config;
 }
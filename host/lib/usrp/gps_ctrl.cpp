@@ -20,6 +20,7 @@
 #include <uhd/utils/log.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/types/sensors.hpp>
+#include <uhd/utils/tasks.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/assign/list_of.hpp>
 #include <stdint.h>
@@ -29,6 +30,8 @@
 #include <boost/format.hpp>
 #include <boost/regex.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/bind.hpp>
 
 #include "boost/tuple/tuple.hpp"
 #include "boost/foreach.hpp"
@@ -51,65 +54,52 @@ class gps_ctrl_impl : public gps_ctrl{
 private:
     std::map<std::string, boost::tuple<std::string, boost::system_time, bool> > sentences;
     boost::mutex cache_mutex;
-    boost::system_time _last_cache_update;
+    boost::condition_variable _cache_cond;
+    bool _init_pending;
+    task::sptr _reader_task;
 
     std::string get_sentence(const std::string which, const int max_age_ms, const int timeout, const bool wait_for_next = false)
     {
-        std::string sentence;
-        boost::system_time now = boost::get_system_time();
-        boost::system_time exit_time = now + milliseconds(timeout);
-        boost::posix_time::time_duration age;
+        boost::mutex::scoped_lock lock(cache_mutex);
+
+        // sensor reads issued during the GPSDO setup wait for it to finish
+        const boost::system_time init_exit_time = boost::get_system_time() + milliseconds(GPSDO_INIT_TIMEOUT_MS);
+        while (_init_pending)
+        {
+            if (not _cache_cond.timed_wait(lock, init_exit_time))
+                break;
+        }
+
+        const boost::system_time exit_time = boost::get_system_time() + milliseconds(timeout);
 
         if (wait_for_next)
         {
-            boost::lock_guard<boost::mutex> lock(cache_mutex);
-            update_cache();
             //mark sentence as touched
             if (sentences.find(which) != sentences.end())
                 sentences[which].get<2>() = true;
         }
+
+        // the reader task keeps the cache current, so a fresh sentence is
+        // returned right away and a stale one waits for the next update
         while (1)
         {
-            try
+            if (sentences.find(which) != sentences.end())
             {
-                boost::lock_guard<boost::mutex> lock(cache_mutex);
-
-                // update cache if older than a millisecond
-                if (now - _last_cache_update > milliseconds(1))
-                {
-                    update_cache();
-                }
-
-                if (sentences.find(which) == sentences.end())
-                {
-                    age = milliseconds(max_age_ms);
-                } else {
-                    age = boost::get_system_time() - sentences[which].get<1>();
-                }
+                const boost::posix_time::time_duration age = boost::get_system_time() - sentences[which].get<1>();
                 if (age < milliseconds(max_age_ms) and (not (wait_for_next and sentences[which].get<2>())))
                 {
-                    sentence = sentences[which].get<0>();
                     sentences[which].get<2>() = true;
+                    return sentences[which].get<0>();
                 }
-            } catch(std::exception &e) {
-                UHD_LOGV(often) << "get_sentence: " << e.what();
             }
 
-            if (not sentence.empty() or now > exit_time)
+            if (not _cache_cond.timed_wait(lock, exit_time))
             {
                 break;
             }
-
-            sleep(boost::posix_time::milliseconds(1));
-            now = boost::get_system_time();
         }
 
-        if (sentence.empty())
-        {
-            throw uhd::value_error("gps ctrl: No " + which + " message found");
-        }
-
-        return sentence;
+        throw uhd::value_error("gps ctrl: No " + which + " message found");
     }
 
     static bool is_nmea_checksum_ok(std::string nmea)
@@ -181,6 +171,7 @@ private:
     boost::system_time time = boost::get_system_time();
 
     // Update sentences with newly read data
+    boost::mutex::scoped_lock lock(cache_mutex);
     BOOST_FOREACH(std::string key, keys)
     {
         if (not msgs[key].empty())
@@ -188,12 +179,26 @@ private:
             sentences[key] = boost::make_tuple(msgs[key], time, false);
         }
     }
+    _cache_cond.notify_all();
+  }
 
-    _last_cache_update = time;
+  void reader_loop(void)
+  {
+    if (_init_pending)
+    {
+        init_gpsdo();
+        boost::mutex::scoped_lock lock(cache_mutex);
+        _init_pending = false;
+        _cache_cond.notify_all();
+    }
+
+    update_cache();
+    sleep(milliseconds(GPS_READER_POLL_MS));
   }
 
 public:
   gps_ctrl_impl(uart_iface::sptr uart) :
+      _init_pending(false),
       _uart(uart),
       _gps_type(GPS_TYPE_NONE)
   {
@@ -243,7 +248,8 @@ public:
       erase_all(reply, "\r");
       erase_all(reply, "\n");
       UHD_MSG(status) << "Found an internal GPSDO: " << reply << std::endl;
-      init_gpsdo();
+      // the setup commands take seconds, so the reader task sends them
+      _init_pending = true;
       break;
 
     case GPS_TYPE_GENERIC_NMEA:
@@ -257,12 +263,16 @@ public:
 
     }
 
-    // initialize cache
-    update_cache();
+    // parse sentences in the background so sensor reads are cache lookups
+    if (gps_detected())
+    {
+        _reader_task = task::make(boost::bind(&gps_ctrl_impl::reader_loop, this), "gps_reader");
+    }
   }
 
   ~gps_ctrl_impl(void){
-    /* NOP */
+    // stop the reader before the UART and the cache go away
+    _reader_task.reset();
   }
 
   //return a list of supported sensors
@@ -424,6 +434,8 @@ private:
   static const int GPS_LOCK_FRESHNESS = 2500;
   static const int GPS_TIMEOUT_DELAY_MS = 200;
   static const int GPSDO_COMMAND_DELAY_MS = 200;
+  static const int GPSDO_INIT_TIMEOUT_MS = 8 * GPSDO_COMMAND_DELAY_MS;
+  static const int GPS_READER_POLL_MS = 10;
 };
 
 /***********************************************************************
@@ -0,0 +1,205 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "../transport/xport_stats.hpp"
+#include <uhd/usrp/latency_probe.hpp>
+#include <uhd/exception.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <sstream>
+
+using namespace uhd;
+using namespace uhd::usrp;
+using uhd::transport::stats_histogram;
+using uhd::transport::stats_time_now_ns;
+
+latency_config_t::latency_config_t(void):
+    nsamps(100), nruns(1000), rtt(0.001), rx_lead(0.01)
+{
+    /* NOP */
+}
+
+latency_result_t::latency_result_t(void):
+    num_runs(0), num_acks(0), num_late(0), num_underflows(0),
+    num_timeouts(0), num_other(0)
+{
+    /* NOP */
+}
+
+std::string latency_result_t::to_json(void) const{
+    std::ostringstream ss;
+    ss << boost::format(
+        "{\"num_runs\":%u,\"num_acks\":%u,\"num_late\":%u,\"num_underflows\":%u,"
+        "\"num_timeouts\":%u,\"num_other\":%u,\"histograms\":%s}"
+    ) % num_runs % num_acks % num_late % num_underflows
+      % num_timeouts % num_other % uhd::to_json(histograms);
+    return ss.str();
+}
+
+/***********************************************************************
+ * Helpers
+ **********************************************************************/
+//! Record a duration, negative ones come from the clock comparison and count as 0
+static void record_ns(stats_histogram &hist, const int64_t ns){
+    hist.record(uint64_t(std::max<int64_t>(ns, 0)));
+}
+
+static void count_async_msg(latency_result_t &result, const async_metadata_t &async_md){
+    switch(async_md.event_code){
+    case async_metadata_t::EVENT_CODE_BURST_ACK:
+        result.num_acks++;
+        break;
+
+    case async_metadata_t::EVENT_CODE_TIME_ERROR:
+        result.num_late++;
+        break;
+
+    case async_metadata_t::EVENT_CODE_UNDERFLOW:
+    case async_metadata_t::EVENT_CODE_UNDERFLOW_IN_PACKET:
+        result.num_underflows++;
+        break;
+
+    default:
+        result.num_other++;
+        break;
+    }
+}
+
+//! Copy the histograms of a streamer with a prefix, when it has them
+template <typename streamer_t>
+static void copy_histograms(
+    latency_result_t &result, streamer_t &stream,
+    const std::string &prefix, const std::string &name_a, const std::string &name_b
+){
+    try{
+        const histograms_t hists = stream->get_histograms();
+        if (hists.has_key(name_a)) result.histograms[prefix + name_a] = hists[name_a];
+        if (hists.has_key(name_b)) result.histograms[prefix + name_b] = hists[name_b];
+        stream->set_histograms_enabled(false);
+    }
+    catch(const uhd::not_implemented_error &){
+        //this streamer does not record histograms
+    }
+}
+
+template <typename streamer_t>
+static void enable_histograms(streamer_t &stream){
+    try{
+        stream->set_histograms_enabled(true);
+    }
+    catch(const uhd::not_implemented_error &){
+        //this streamer does not record histograms
+    }
+}
+
+/***********************************************************************
+ * The measurement
+ **********************************************************************/
+latency_result_t uhd::usrp::measure_latency(
+    rx_streamer::sptr rx_stream,
+    tx_streamer::sptr tx_stream,
+    const time_source_t &get_time_now,
+    const latency_config_t &config
+){
+    stats_histogram turnaround("ns"), receive("ns"), application("ns"), send("ns");
+    enable_histograms(rx_stream);
+    enable_histograms(tx_stream);
+
+    //compare the clocks once, the device time t is at the host time t + offset
+    const int64_t host_before_ns = stats_time_now_ns();
+    const time_spec_t device_time = get_time_now();
+    const int64_t host_after_ns = stats_time_now_ns();
+    const int64_t offset_ns = (host_before_ns + host_after_ns)/2 - device_time.to_ticks(1e9);
+
+    std::vector<std::complex<float> > buffer(config.nsamps);
+    latency_result_t result;
+
+    for (size_t nrun = 0; nrun < config.nruns; nrun++){
+        result.num_runs++;
+
+        //request the burst some time in the near future
+        stream_cmd_t stream_cmd(stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
+        stream_cmd.num_samps = buffer.size();
+        stream_cmd.stream_now = false;
+        stream_cmd.time_spec = get_time_now() + time_spec_t(config.rx_lead);
+        rx_stream->issue_stream_cmd(stream_cmd);
+
+        rx_metadata_t rx_md;
+        const size_t num_rx_samps = rx_stream->recv(
+            &buffer.front(), buffer.size(), rx_md, config.rx_lead + 0.1
+        );
+        const int64_t recv_done_ns = stats_time_now_ns();
+        if (num_rx_samps == 0 or rx_md.error_code != rx_metadata_t::ERROR_CODE_NONE){
+            result.num_timeouts++;
+            continue;
+        }
+
+        if (config.work) config.work(buffer);
+
+        //send the burst back, timed rtt after it was received
+        tx_metadata_t tx_md;
+        tx_md.start_of_burst = true;
+        tx_md.end_of_burst = true;
+        tx_md.has_time_spec = true;
+        tx_md.time_spec = rx_md.time_spec + time_spec_t(config.rtt);
+        const int64_t send_call_ns = stats_time_now_ns();
+        tx_stream->send(&buffer.front(), num_rx_samps, tx_md, config.rtt + 0.1);
+        const int64_t send_done_ns = stats_time_now_ns();
+
+        const int64_t burst_ns = rx_md.time_spec.to_ticks(1e9) + offset_ns;
+        record_ns(turnaround, send_done_ns - burst_ns);
+        record_ns(receive, recv_done_ns - burst_ns);
+        record_ns(application, send_call_ns - recv_done_ns);
+        record_ns(send, send_done_ns - send_call_ns);
+
+        async_metadata_t async_md;
+        if (tx_stream->recv_async_msg(async_md, config.rtt + 0.1)){
+            count_async_msg(result, async_md);
+        }
+        else{
+            result.num_timeouts++;
+        }
+    }
+
+    //count the messages of late acknowledgements
+    async_metadata_t async_md;
+    while (tx_stream->recv_async_msg(async_md)){
+        count_async_msg(result, async_md);
+    }
+
+    result.histograms["turnaround"] = turnaround.get();
+    result.histograms["receive"] = receive.get();
+    result.histograms["application"] = application.get();
+    result.histograms["send"] = send.get();
+    copy_histograms(result, rx_stream, "rx_", "xport_wait", "convert");
+    copy_histograms(result, tx_stream, "tx_", "xport_wait", "convert");
+    return result;
+}
+
+latency_result_t uhd::usrp::measure_latency(
+    multi_usrp::sptr usrp,
+    rx_streamer::sptr rx_stream,
+    tx_streamer::sptr tx_stream,
+    const latency_config_t &config
+){
+    return measure_latency(
+        rx_stream, tx_stream,
+        boost::bind(&multi_usrp::get_time_now, usrp, 0),
+        config
+    );
+}
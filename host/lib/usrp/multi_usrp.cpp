@@ -28,13 +28,19 @@
 #include <uhd/convert.hpp>
 #include <uhd/utils/soft_register.hpp>
 #include "legacy_compat.hpp"
+#include "../experts/expert_container.hpp"
 #include <boost/assign/list_of.hpp>
 #include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <set>
 
 using namespace uhd;
 using namespace uhd::usrp;
@@ -231,6 +237,28 @@ static gain_fcns_t make_gain_fcns_from_subtree(property_tree::sptr subtree){
 static const double RX_SIGN = +1.0;
 static const double TX_SIGN = -1.0;
 
+/*!
+ * Get the DSP-only retune window of a tune request, see tune_request_t::args.
+ * "auto" keeps the requested band within the frontend filter.
+ * \return the window in Hz, or a negative value when it is disabled
+ */
+static double get_dsp_retune_window(
+    property_tree::sptr dsp_subtree,
+    property_tree::sptr rf_fe_subtree,
+    const tune_request_t &tune_request
+){
+    if (tune_request.rf_freq_policy != tune_request_t::POLICY_AUTO
+        or tune_request.dsp_freq_policy != tune_request_t::POLICY_AUTO
+        or not tune_request.args.has_key("dsp_retune_window")
+    ) return -1.0;
+
+    const std::string window = tune_request.args["dsp_retune_window"];
+    if (window != "auto") return tune_request.args.cast<double>("dsp_retune_window", -1.0);
+    const double rate = dsp_subtree->access<double>("rate/value").get();
+    const double bw = rf_fe_subtree->access<double>("bandwidth/value").get();
+    return std::max((bw - rate)/2, 0.0);
+}
+
 static tune_result_t tune_xx_subdev_and_dsp(
     const double xx_sign,
     property_tree::sptr dsp_subtree,
@@ -276,6 +304,28 @@ static tune_result_t tune_xx_subdev_and_dsp(
         if (bw > rate) lo_offset = std::min((bw - rate)/2, rate/2);
     }
 
+    //------------------------------------------------------------------
+    //-- DSP-only retune: when the target is close enough to the tuned LO,
+    //-- only the CORDIC moves and the RF frontend is left untouched
+    //------------------------------------------------------------------
+    const double retune_window = get_dsp_retune_window(dsp_subtree, rf_fe_subtree, tune_request);
+    if (retune_window >= 0.0){
+        const double actual_rf_freq = rf_fe_subtree->access<double>("freq/value").get();
+        const double target_dsp_freq = (actual_rf_freq - clipped_requested_freq) * xx_sign;
+        if (std::abs(actual_rf_freq - clipped_requested_freq) <= retune_window
+            and dsp_range.start() <= target_dsp_freq and target_dsp_freq <= dsp_range.stop()
+        ){
+            dsp_subtree->access<double>("freq/value").set(target_dsp_freq);
+            tune_result_t tune_result;
+            tune_result.clipped_rf_freq = clipped_requested_freq;
+            tune_result.target_rf_freq = actual_rf_freq;
+            tune_result.actual_rf_freq = actual_rf_freq;
+            tune_result.target_dsp_freq = target_dsp_freq;
+            tune_result.actual_dsp_freq = dsp_subtree->access<double>("freq/value").get();
+            return tune_result;
+        }
+    }
+
     //------------------------------------------------------------------
     //-- poke the tune request args into the dboard
     //------------------------------------------------------------------
@@ -383,6 +433,208 @@ static double derive_freq_from_xx_subdev_and_dsp(
     return actual_rf_freq - actual_dsp_freq * xx_sign;
 }
 
+/***********************************************************************
+ * Sensor snapshots
+ **********************************************************************/
+static std::vector<sensor_reading_t> get_sensor_snapshot(
+    property_tree::sptr tree,
+    const fs_path &sensors_root,
+    const std::vector<std::string> &names
+){
+    const std::vector<std::string> keys = names.empty()? tree->list(sensors_root) : names;
+
+    //read each sensor once, even if it is requested several times
+    std::map<std::string, size_t> read_index;
+    std::vector<sensor_reading_t> readings;
+    BOOST_FOREACH(const std::string &key, keys){
+        if (read_index.count(key)){
+            readings.push_back(readings[read_index[key]]);
+            continue;
+        }
+        read_index[key] = readings.size();
+        try{
+            const sensor_value_t value = tree->access<sensor_value_t>(sensors_root / key).get();
+            readings.push_back(sensor_reading_t(key, value, time_spec_t::get_system_time()));
+        }
+        catch(const std::exception &e){
+            UHD_LOGV(often) << "sensor snapshot: " << key << ": " << e.what() << std::endl;
+            readings.push_back(sensor_reading_t(key, time_spec_t::get_system_time()));
+        }
+    }
+    return readings;
+}
+
+/***********************************************************************
+ * Hop tables
+ **********************************************************************/
+struct hop_entry_t{
+    device_addr_t args;
+    tune_result_t result;
+};
+
+struct hop_table_t{
+    property_tree::sptr dsp_subtree;
+    property_tree::sptr rf_fe_subtree;
+    std::vector<hop_entry_t> hops;
+};
+
+static std::vector<tune_result_t> make_xx_hop_table(
+    const double xx_sign,
+    property_tree::sptr dsp_subtree,
+    property_tree::sptr rf_fe_subtree,
+    const std::vector<tune_request_t> &tune_requests,
+    hop_table_t &hop_table
+){
+    //remember the current tuning so it can be restored afterwards
+    const double rf_freq = rf_fe_subtree->access<double>("freq/value").get();
+    const double dsp_freq = dsp_subtree->access<double>("freq/value").get();
+
+    hop_table.dsp_subtree = dsp_subtree;
+    hop_table.rf_fe_subtree = rf_fe_subtree;
+    hop_table.hops.clear();
+
+    std::vector<tune_result_t> results;
+    BOOST_FOREACH(const tune_request_t &tune_request, tune_requests){
+        hop_entry_t hop;
+        hop.args = tune_request.args;
+        hop.result = tune_xx_subdev_and_dsp(xx_sign, dsp_subtree, rf_fe_subtree, tune_request);
+        hop_table.hops.push_back(hop);
+        results.push_back(hop.result);
+    }
+
+    if (rf_fe_subtree->exists("tune_args")) {
+        rf_fe_subtree->access<device_addr_t>("tune_args").set(device_addr_t());
+    }
+    rf_fe_subtree->access<double>("freq/value").set(rf_freq);
+    dsp_subtree->access<double>("freq/value").set(dsp_freq);
+
+    return results;
+}
+
+static tune_result_t do_xx_hop(
+    const std::string &xx,
+    const uhd::dict<size_t, hop_table_t> &hop_tables,
+    const size_t hop_index,
+    const size_t chan
+){
+    if (not hop_tables.has_key(chan)) {
+        throw uhd::key_error(str(
+            boost::format("No %s hop table has been set for channel %u") % xx % chan));
+    }
+    const hop_table_t &hop_table = hop_tables[chan];
+    if (hop_index >= hop_table.hops.size()) {
+        throw uhd::index_error(str(
+            boost::format("%s hop index %u out of range for channel %u (%u hops)")
+            % xx % hop_index % chan % hop_table.hops.size()));
+    }
+    const hop_entry_t &hop = hop_table.hops[hop_index];
+
+    //The frequencies in the table are already coerced, so the tune plan is
+    //not recomputed. Hops that share an RF frequency only touch the DSP.
+    property<double> &rf_freq = hop_table.rf_fe_subtree->access<double>("freq/value");
+    if (rf_freq.get() != hop.result.actual_rf_freq) {
+        if (hop_table.rf_fe_subtree->exists("tune_args")) {
+            hop_table.rf_fe_subtree->access<device_addr_t>("tune_args").set(hop.args);
+        }
+        rf_freq.set(hop.result.actual_rf_freq);
+    }
+    hop_table.dsp_subtree->access<double>("freq/value").set(hop.result.actual_dsp_freq);
+    return hop.result;
+}
+
+/***********************************************************************
+ * Getter cache
+ **********************************************************************/
+/*!
+ * The values of the cached getters, see multi_usrp::set_getter_cache().
+ * The subscribers of the properties the values depend on hold it, so it
+ * outlives the multi_usrp when the device is shared.
+ */
+class getter_cache : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<getter_cache> sptr;
+    typedef std::pair<std::string, size_t> key_type;
+
+    getter_cache(void): _enabled(false), _generation(0), _resolve_count(0){
+        /* NOP */
+    }
+
+    void set_enabled(const bool enable){
+        boost::mutex::scoped_lock lock(_mutex);
+        _enabled = enable;
+        this->clear_locked();
+    }
+
+    bool is_enabled(void){
+        boost::mutex::scoped_lock lock(_mutex);
+        return _enabled;
+    }
+
+    void clear(void){
+        boost::mutex::scoped_lock lock(_mutex);
+        this->clear_locked();
+    }
+
+    //! Subscriber of the watched properties
+    template <typename T> void on_change(const T &){
+        this->clear();
+    }
+
+    /*!
+     * Mark a property as watched.
+     * \return true the first time, when the caller must subscribe to it
+     */
+    bool watch(const fs_path &path){
+        boost::mutex::scoped_lock lock(_mutex);
+        return _watched.insert(path).second;
+    }
+
+    /*!
+     * Get a value from the cache, or read it when it is not cached.
+     * The device is read without the lock held, so the subscribers
+     * which run meanwhile can drop the values.
+     */
+    double get(const key_type &key, const boost::function<double(void)> &read){
+        boost::mutex::scoped_lock lock(_mutex);
+        if (not _enabled){
+            lock.unlock();
+            return read();
+        }
+        if (_resolve_count != experts::expert_container::get_resolve_count()){
+            this->clear_locked();
+        }
+        std::map<key_type, double>::const_iterator it = _values.find(key);
+        if (it != _values.end()) return it->second;
+        const size_t generation = _generation;
+        lock.unlock();
+
+        const double value = read();
+        const size_t resolve_count = experts::expert_container::get_resolve_count();
+
+        lock.lock();
+        //a value read while the cache was cleared may be stale already
+        if (_enabled and _generation == generation){
+            if (_values.empty()) _resolve_count = resolve_count;
+            if (_resolve_count == resolve_count) _values[key] = value;
+        }
+        return value;
+    }
+
+private:
+    void clear_locked(void){
+        _values.clear();
+        _generation++;
+        _resolve_count = experts::expert_container::get_resolve_count();
+    }
+
+    boost::mutex _mutex;
+    bool _enabled;
+    size_t _generation;
+    size_t _resolve_count;
+    std::map<key_type, double> _values;
+    std::set<fs_path> _watched;
+};
+
 /***********************************************************************
  * Multi USRP Implementation
  **********************************************************************/
@@ -391,6 +643,7 @@ public:
     multi_usrp_impl(const device_addr_t &addr){
         _dev = device::make(addr, device::USRP);
         _tree = _dev->get_tree();
+        _getter_cache.reset(new getter_cache());
         _is_device3 = bool(boost::dynamic_pointer_cast<uhd::device3>(_dev));
 
         if (is_device3()) {
@@ -470,7 +723,22 @@ public:
     }
 
     double get_master_clock_rate(size_t mboard){
-        return _tree->access<double>(mb_root(mboard) / "tick_rate").get();
+        return _getter_cache->get(getter_cache::key_type("tick_rate", mboard),
+            boost::bind(&multi_usrp_impl::read_master_clock_rate, this, mboard));
+    }
+
+    void set_getter_cache(bool enable){
+        _getter_cache->set_enabled(enable);
+        if (not enable) return;
+        //the channels map to other frontends when a subdev spec changes
+        for (size_t m = 0; m < get_num_mboards(); m++){
+            watch_for_getter_cache<subdev_spec_t>(mb_root(m) / "rx_subdev_spec");
+            watch_for_getter_cache<subdev_spec_t>(mb_root(m) / "tx_subdev_spec");
+        }
+    }
+
+    void clear_getter_cache(void){
+        _getter_cache->clear();
     }
 
     std::string get_pp_string(void){
@@ -532,6 +800,13 @@ public:
         return _tree->access<time_spec_t>(mb_root(mboard) / "time/now").get();
     }
 
+    time_spec_t get_time_now_exact(size_t mboard = 0){
+        if (_tree->exists(mb_root(mboard) / "time/now_exact")) {
+            return _tree->access<time_spec_t>(mb_root(mboard) / "time/now_exact").get();
+        }
+        return this->get_time_now(mboard);
+    }
+
     time_spec_t get_time_last_pps(size_t mboard = 0){
         return _tree->access<time_spec_t>(mb_root(mboard) / "time/pps").get();
     }
@@ -557,9 +832,51 @@ public:
     }
 
     void set_time_unknown_pps(const time_spec_t &time_spec){
+        BOOST_FOREACH(const time_sync_status_t &status, this->sync_time_unknown_pps(time_spec)){
+            if (status.aligned) continue;
+            UHD_MSG(warning) << boost::format(
+                "Board %d did not latch the time at the PPS edge.\n"
+                "%s"
+                "The last PPS time of board %d is %f seconds.\n"
+            ) % status.mboard % (status.pps_detected? "" : "No PPS detected on this board.\n")
+              % status.mboard % status.last_pps.get_real_secs();
+        }
+    }
+
+    std::vector<time_sync_status_t> sync_time_unknown_pps(const time_spec_t &time_spec){
+        const size_t num_mboards = get_num_mboards();
+        std::vector<time_spec_t> prev_pps(num_mboards);
+
         UHD_MSG(status) << "    1) catch time transition at pps edge" << std::endl;
-        boost::system_time end_time = boost::get_system_time() + boost::posix_time::milliseconds(1100);
-        time_spec_t time_start_last_pps = get_time_last_pps();
+        for (size_t attempt = 0;; attempt++){
+            const boost::system_time edge_time = wait_for_pps_edge();
+
+            UHD_MSG(status) << "    2) set times next pps (synchronously)" << std::endl;
+            run_concurrently(num_mboards, boost::bind(
+                &multi_usrp_impl::read_last_pps_at, this, boost::ref(prev_pps), _1));
+            run_concurrently(num_mboards, boost::bind(
+                &multi_usrp_impl::set_time_next_pps, this, boost::cref(time_spec), _1));
+
+            //a board that was set after the next edge would be off by a second
+            if (boost::get_system_time() - edge_time < boost::posix_time::milliseconds(500)) break;
+            if (attempt == 2) throw uhd::runtime_error(
+                "Could not set the time of all boards within half a PPS period.");
+            UHD_MSG(warning) << "Setting the time took too long after the PPS edge, retrying." << std::endl;
+        }
+
+        //verify the PPS time latched by each board at the next edge
+        wait_for_pps_edge();
+        std::vector<time_sync_status_t> statuses(num_mboards);
+        run_concurrently(num_mboards, boost::bind(
+            &multi_usrp_impl::read_time_sync_status_at, this,
+            boost::cref(time_spec), boost::cref(prev_pps), boost::ref(statuses), _1));
+        return statuses;
+    }
+
+    //! Wait for the last PPS time of board 0 to change, return the host time
+    boost::system_time wait_for_pps_edge(void){
+        const boost::system_time end_time = boost::get_system_time() + boost::posix_time::milliseconds(1100);
+        const time_spec_t time_start_last_pps = get_time_last_pps();
         while (time_start_last_pps == get_time_last_pps())
         {
             if (boost::get_system_time() > end_time)
@@ -572,23 +889,26 @@ public:
             }
             boost::this_thread::sleep(boost::posix_time::milliseconds(1));
         }
+        return boost::get_system_time();
+    }
 
-        UHD_MSG(status) << "    2) set times next pps (synchronously)" << std::endl;
-        set_time_next_pps(time_spec, ALL_MBOARDS);
-        boost::this_thread::sleep(boost::posix_time::seconds(1));
+    void read_last_pps_at(std::vector<time_spec_t> &last_pps, const size_t mboard){
+        last_pps[mboard] = get_time_last_pps(mboard);
+    }
 
-        //verify that the time registers are read to be within a few RTT
-        for (size_t m = 1; m < get_num_mboards(); m++){
-            time_spec_t time_0 = this->get_time_now(0);
-            time_spec_t time_i = this->get_time_now(m);
-            if (time_i < time_0 or (time_i - time_0) > time_spec_t(0.01)){ //10 ms: greater than RTT but not too big
-                UHD_MSG(warning) << boost::format(
-                    "Detected time deviation between board %d and board 0.\n"
-                    "Board 0 time is %f seconds.\n"
-                    "Board %d time is %f seconds.\n"
-                ) % m % time_0.get_real_secs() % m % time_i.get_real_secs();
-            }
-        }
+    void read_time_sync_status_at(
+        const time_spec_t &time_spec,
+        const std::vector<time_spec_t> &prev_pps,
+        std::vector<time_sync_status_t> &statuses,
+        const size_t mboard
+    ){
+        time_sync_status_t &status = statuses[mboard];
+        status.mboard = mboard;
+        status.last_pps = get_time_last_pps(mboard);
+        status.pps_detected = status.last_pps != prev_pps[mboard];
+        //the time is read back in ticks of the board
+        const double half_tick = 0.5/get_master_clock_rate(mboard);
+        status.aligned = std::abs((status.last_pps - time_spec).get_real_secs()) < half_tick;
     }
 
     bool get_time_synchronized(void){
@@ -602,6 +922,10 @@ public:
 
     void set_command_time(const time_spec_t &time_spec, size_t mboard){
         if (mboard != ALL_MBOARDS){
+            if (is_device3()) {
+                _legacy_compat->set_command_time(time_spec, mboard);
+                return;
+            }
             if (not _tree->exists(mb_root(mboard) / "time/cmd")){
                 throw uhd::not_implemented_error("timed command feature not implemented on this hardware");
             }
@@ -623,6 +947,21 @@ public:
         }
     }
 
+    void commit_transaction(property_transaction &transaction, const time_spec_t &cmd_time, size_t mboard){
+        const bool timed = cmd_time != time_spec_t(0.0);
+        if (timed) set_command_time(cmd_time, mboard);
+        try{
+            transaction.commit();
+        }
+        catch(...){
+            if (timed) try{
+                clear_command_time(mboard);
+            } catch(...){}
+            throw;
+        }
+        if (timed) clear_command_time(mboard);
+    }
+
     void issue_stream_cmd(const stream_cmd_t &stream_cmd, size_t chan){
         if (chan != ALL_CHANS){
             if (is_device3()) {
@@ -638,6 +977,11 @@ public:
         }
     }
 
+    void issue_stream_cmd(const stream_cmd_t &stream_cmd, const std::vector<size_t> &chans){
+        for_each_rx_chan(chans, time_spec_t(0.0), boost::bind(
+            &multi_usrp_impl::issue_stream_cmd_at, this, boost::cref(stream_cmd), boost::cref(chans), _1));
+    }
+
     void set_clock_config(const clock_config_t &clock_config, size_t mboard){
         //set the reference source...
         std::string clock_source;
@@ -749,6 +1093,10 @@ public:
         return _tree->list(mb_root(mboard) / "sensors");
     }
 
+    std::vector<sensor_reading_t> get_mboard_sensor_snapshot(const std::vector<std::string> &names, size_t mboard){
+        return get_sensor_snapshot(_tree, mb_root(mboard) / "sensors", names);
+    }
+
     void set_user_register(const uint8_t addr, const uint32_t data, size_t mboard){
         if (mboard != ALL_MBOARDS){
             typedef std::pair<uint8_t, uint32_t> user_reg_t;
@@ -814,6 +1162,10 @@ public:
         return _tree->access<std::string>(rx_rf_fe_root(chan) / "name").get();
     }
 
+    property_transaction make_rx_fe_transaction(size_t chan){
+        return property_transaction(_tree->subtree(rx_rf_fe_root(chan)));
+    }
+
     void set_rx_rate(double rate, size_t chan){
         if (is_device3()) {
             _legacy_compat->set_rx_rate(rate, chan);
@@ -837,8 +1189,15 @@ public:
         }
     }
 
+    void set_rx_rate(const std::vector<double> &rates, const std::vector<size_t> &chans){
+        check_num_values(rates.size(), chans.size(), "set_rx_rate");
+        for_each_rx_chan(chans, time_spec_t(0.0), boost::bind(
+            &multi_usrp_impl::set_rx_rate_at, this, boost::cref(rates), boost::cref(chans), _1));
+    }
+
     double get_rx_rate(size_t chan){
-        return _tree->access<double>(rx_dsp_root(chan) / "rate" / "value").get();
+        return _getter_cache->get(getter_cache::key_type("rx_rate", chan),
+            boost::bind(&multi_usrp_impl::read_rx_rate, this, chan));
     }
 
     meta_range_t get_rx_rates(size_t chan){
@@ -854,8 +1213,33 @@ public:
         return result;
     }
 
+    std::vector<tune_result_t> set_rx_freq(
+        const std::vector<tune_request_t> &tune_requests,
+        const std::vector<size_t> &chans,
+        const time_spec_t &cmd_time
+    ){
+        check_num_values(tune_requests.size(), chans.size(), "set_rx_freq");
+        std::vector<tune_result_t> results(chans.size());
+        for_each_rx_chan(chans, cmd_time, boost::bind(
+            &multi_usrp_impl::set_rx_freq_at, this,
+            boost::cref(tune_requests), boost::cref(chans), boost::ref(results), _1));
+        return results;
+    }
+
+    std::vector<tune_result_t> set_rx_hop_table(const std::vector<tune_request_t> &tune_requests, size_t chan){
+        return make_xx_hop_table(RX_SIGN,
+                _tree->subtree(rx_dsp_root(chan)),
+                _tree->subtree(rx_rf_fe_root(chan)),
+                tune_requests, _rx_hop_tables[chan]);
+    }
+
+    tune_result_t set_rx_freq_hop(size_t hop_index, size_t chan){
+        return do_xx_hop("RX", _rx_hop_tables, hop_index, chan);
+    }
+
     double get_rx_freq(size_t chan){
-        return derive_freq_from_xx_subdev_and_dsp(RX_SIGN, _tree->subtree(rx_dsp_root(chan)), _tree->subtree(rx_rf_fe_root(chan)));
+        return _getter_cache->get(getter_cache::key_type("rx_freq", chan),
+            boost::bind(&multi_usrp_impl::read_rx_freq, this, chan));
     }
 
     freq_range_t get_rx_freq_range(size_t chan){
@@ -1063,6 +1447,18 @@ public:
         }
     }
 
+    void set_rx_gain(
+        const std::vector<double> &gains,
+        const std::vector<size_t> &chans,
+        const std::string &name,
+        const time_spec_t &cmd_time
+    ){
+        check_num_values(gains.size(), chans.size(), "set_rx_gain");
+        for_each_rx_chan(chans, cmd_time, boost::bind(
+            &multi_usrp_impl::set_rx_gain_at, this,
+            boost::cref(gains), boost::cref(chans), boost::cref(name), _1));
+    }
+
     void set_normalized_rx_gain(double gain, size_t chan = 0)
     {
       if (gain > 1.0 || gain < 0.0) {
@@ -1091,7 +1487,8 @@ public:
 
     double get_rx_gain(const std::string &name, size_t chan){
         try {
-            return rx_gain_group(chan)->get_value(name);
+            return _getter_cache->get(getter_cache::key_type("rx_gain/" + name, chan),
+                boost::bind(&multi_usrp_impl::read_rx_gain, this, name, chan));
         } catch (uhd::key_error &) {
             THROW_GAIN_NAME_ERROR(name,chan,rx);
         }
@@ -1160,6 +1557,10 @@ public:
         return _tree->list(rx_rf_fe_root(chan) / "sensors");
     }
 
+    std::vector<sensor_reading_t> get_rx_sensor_snapshot(const std::vector<std::string> &names, size_t chan){
+        return get_sensor_snapshot(_tree, rx_rf_fe_root(chan) / "sensors", names);
+    }
+
     void set_rx_dc_offset(const bool enb, size_t chan){
         if (chan != ALL_CHANS){
             if (_tree->exists(rx_fe_root(chan) / "dc_offset" / "enable")) {
@@ -1311,6 +1712,14 @@ public:
         return this->get_device()->get_tx_stream(args);
     }
 
+    rfnoc::siggen_block_ctrl::sptr get_tx_siggen(size_t chan) {
+        if (not is_device3()) {
+            throw uhd::not_implemented_error("get_tx_siggen() needs a generation-3 device");
+        }
+        mboard_chan_pair mcp = tx_chan_to_mcp(chan);
+        return _legacy_compat->get_tx_siggen(mcp.mboard, mcp.chan);
+    }
+
     void set_tx_subdev_spec(const subdev_spec_t &spec, size_t mboard){
         if (mboard != ALL_MBOARDS){
             _tree->access<subdev_spec_t>(mb_root(mboard) / "tx_subdev_spec").set(spec);
@@ -1378,7 +1787,8 @@ public:
     }
 
     double get_tx_rate(size_t chan){
-        return _tree->access<double>(tx_dsp_root(chan) / "rate" / "value").get();
+        return _getter_cache->get(getter_cache::key_type("tx_rate", chan),
+            boost::bind(&multi_usrp_impl::read_tx_rate, this, chan));
     }
 
     meta_range_t get_tx_rates(size_t chan){
@@ -1394,8 +1804,20 @@ public:
         return result;
     }
 
+    std::vector<tune_result_t> set_tx_hop_table(const std::vector<tune_request_t> &tune_requests, size_t chan){
+        return make_xx_hop_table(TX_SIGN,
+                _tree->subtree(tx_dsp_root(chan)),
+                _tree->subtree(tx_rf_fe_root(chan)),
+                tune_requests, _tx_hop_tables[chan]);
+    }
+
+    tune_result_t set_tx_freq_hop(size_t hop_index, size_t chan){
+        return do_xx_hop("TX", _tx_hop_tables, hop_index, chan);
+    }
+
     double get_tx_freq(size_t chan){
-        return derive_freq_from_xx_subdev_and_dsp(TX_SIGN, _tree->subtree(tx_dsp_root(chan)), _tree->subtree(tx_rf_fe_root(chan)));
+        return _getter_cache->get(getter_cache::key_type("tx_freq", chan),
+            boost::bind(&multi_usrp_impl::read_tx_freq, this, chan));
     }
 
     freq_range_t get_tx_freq_range(size_t chan){
@@ -1431,7 +1853,8 @@ public:
 
     double get_tx_gain(const std::string &name, size_t chan){
         try {
-            return tx_gain_group(chan)->get_value(name);
+            return _getter_cache->get(getter_cache::key_type("tx_gain/" + name, chan),
+                boost::bind(&multi_usrp_impl::read_tx_gain, this, name, chan));
         } catch (uhd::key_error &) {
             THROW_GAIN_NAME_ERROR(name,chan,tx);
         }
@@ -1500,6 +1923,10 @@ public:
         return _tree->list(tx_rf_fe_root(chan) / "sensors");
     }
 
+    std::vector<sensor_reading_t> get_tx_sensor_snapshot(const std::vector<std::string> &names, size_t chan){
+        return get_sensor_snapshot(_tree, tx_rf_fe_root(chan) / "sensors", names);
+    }
+
     void set_tx_dc_offset(const std::complex<double> &offset, size_t chan){
         if (chan != ALL_CHANS){
             if (_tree->exists(tx_fe_root(chan) / "dc_offset" / "value")) {
@@ -1713,8 +2140,11 @@ public:
 private:
     device::sptr _dev;
     property_tree::sptr _tree;
+    getter_cache::sptr _getter_cache;
     bool _is_device3;
     uhd::rfnoc::legacy_compat::sptr _legacy_compat;
+    uhd::dict<size_t, hop_table_t> _rx_hop_tables;
+    uhd::dict<size_t, hop_table_t> _tx_hop_tables;
 
     struct mboard_chan_pair{
         size_t mboard, chan;
@@ -1751,6 +2181,124 @@ private:
         return mcp;
     }
 
+    /*******************************************************************
+     * Multi-channel calls
+     ******************************************************************/
+    //! Check a list of per-channel values: one for each channel, or one for all
+    static void check_num_values(const size_t num_values, const size_t num_chans, const std::string &what){
+        if (num_values == num_chans or (num_values == 1 and num_chans != 0)) return;
+        throw uhd::value_error(str(boost::format(
+            "multi_usrp::%s: got %u values for %u channels") % what % num_values % num_chans));
+    }
+
+    static size_t value_index(const size_t num_values, const size_t i){
+        return (num_values == 1)? 0 : i;
+    }
+
+    void set_rx_freq_at(
+        const std::vector<tune_request_t> &tune_requests,
+        const std::vector<size_t> &chans,
+        std::vector<tune_result_t> &results,
+        const size_t i
+    ){
+        results[i] = set_rx_freq(tune_requests[value_index(tune_requests.size(), i)], chans[i]);
+    }
+
+    void set_rx_gain_at(
+        const std::vector<double> &gains,
+        const std::vector<size_t> &chans,
+        const std::string &name,
+        const size_t i
+    ){
+        set_rx_gain(gains[value_index(gains.size(), i)], name, chans[i]);
+    }
+
+    void set_rx_rate_at(const std::vector<double> &rates, const std::vector<size_t> &chans, const size_t i){
+        set_rx_rate(rates[value_index(rates.size(), i)], chans[i]);
+    }
+
+    void issue_stream_cmd_at(const stream_cmd_t &stream_cmd, const std::vector<size_t> &chans, const size_t i){
+        issue_stream_cmd(stream_cmd, chans[i]);
+    }
+
+    typedef boost::function<void(size_t)> index_func_t;
+
+    static void run_and_catch(const index_func_t &func, const size_t n, boost::shared_ptr<uhd::exception> &error){
+        try{
+            func(n);
+        }
+        catch(const uhd::exception &e){
+            error.reset(e.dynamic_clone());
+        }
+        catch(const std::exception &e){
+            error.reset(new uhd::runtime_error(e.what()));
+        }
+    }
+
+    /*!
+     * Run func(0) to func(num - 1), each in its own thread when threaded.
+     * The first error, in index order, is thrown after all are done.
+     */
+    static void run_concurrently(const size_t num, const index_func_t &func, const bool threaded = true){
+        std::vector<boost::shared_ptr<uhd::exception> > errors(num);
+        if (threaded and num > 1){
+            boost::thread_group threads;
+            for (size_t n = 0; n < num; n++){
+                threads.create_thread(boost::bind(&multi_usrp_impl::run_and_catch, boost::cref(func), n, boost::ref(errors[n])));
+            }
+            threads.join_all();
+        }
+        else for (size_t n = 0; n < num; n++){
+            run_and_catch(func, n, errors[n]);
+            if (errors[n]) break;
+        }
+        BOOST_FOREACH(const boost::shared_ptr<uhd::exception> &error, errors){
+            if (error) error->dynamic_throw();
+        }
+    }
+
+    //! The channels of one motherboard, as indexes into a channel list
+    typedef std::pair<size_t, std::vector<size_t> > mboard_indexes_t;
+
+    //! Run a call for the channels of one motherboard, under one command time
+    void run_mboard_chans(
+        const std::vector<mboard_indexes_t> &groups,
+        const time_spec_t &cmd_time,
+        const index_func_t &func,
+        const size_t n
+    ){
+        const size_t mboard = groups[n].first;
+        const bool timed = cmd_time != time_spec_t(0.0);
+        if (timed) set_command_time(cmd_time, mboard);
+        try{
+            BOOST_FOREACH(const size_t i, groups[n].second) func(i);
+        }
+        catch(...){
+            if (timed) try{
+                clear_command_time(mboard);
+            } catch(...){}
+            throw;
+        }
+        if (timed) clear_command_time(mboard);
+    }
+
+    /*!
+     * Run a call for each of the given RX channels: the channels are
+     * grouped by motherboard, and each motherboard gets its own thread.
+     * The call gets the index into the channel list.
+     */
+    void for_each_rx_chan(const std::vector<size_t> &chans, const time_spec_t &cmd_time, const index_func_t &func){
+        std::map<size_t, std::vector<size_t> > mboard_indexes;
+        for (size_t i = 0; i < chans.size(); i++){
+            mboard_indexes[rx_chan_to_mcp(chans[i]).mboard].push_back(i);
+        }
+        const std::vector<mboard_indexes_t> groups(mboard_indexes.begin(), mboard_indexes.end());
+        //the RFNoC compat layer is shared by all motherboards
+        run_concurrently(groups.size(), boost::bind(
+            &multi_usrp_impl::run_mboard_chans, this, boost::cref(groups), boost::cref(cmd_time), boost::cref(func), _1),
+            not is_device3());
+    }
+
     fs_path mb_root(const size_t mboard)
     {
         try
@@ -1873,6 +2421,79 @@ private:
         }
     }
 
+    /*******************************************************************
+     * Cached getter helpers
+     ******************************************************************/
+    //! Drop the cached values when the property is set, if the cache is enabled
+    template <typename T> void watch_for_getter_cache(const fs_path &path){
+        if (not _getter_cache->is_enabled() or not _tree->exists(path)) return;
+        if (not _getter_cache->watch(path)) return;
+        property<T> &prop = _tree->access<T>(path);
+        prop.add_desired_subscriber(boost::bind(&getter_cache::on_change<T>, _getter_cache, _1));
+        prop.add_coerced_subscriber(boost::bind(&getter_cache::on_change<T>, _getter_cache, _1));
+    }
+
+    void watch_gains_for_getter_cache(const fs_path &gains_root){
+        if (not _getter_cache->is_enabled()) return;
+        BOOST_FOREACH(const std::string &name, _tree->list(gains_root)){
+            watch_for_getter_cache<double>(gains_root / name / "value");
+        }
+    }
+
+    double read_master_clock_rate(const size_t mboard){
+        const fs_path path = mb_root(mboard) / "tick_rate";
+        watch_for_getter_cache<double>(path);
+        return _tree->access<double>(path).get();
+    }
+
+    double read_rx_rate(const size_t chan){
+        const fs_path path = rx_dsp_root(chan) / "rate" / "value";
+        watch_for_getter_cache<double>(path);
+        return _tree->access<double>(path).get();
+    }
+
+    double read_tx_rate(const size_t chan){
+        const fs_path path = tx_dsp_root(chan) / "rate" / "value";
+        watch_for_getter_cache<double>(path);
+        return _tree->access<double>(path).get();
+    }
+
+    double read_rx_freq(const size_t chan){
+        const fs_path dsp_root = rx_dsp_root(chan);
+        const fs_path rf_fe_root = rx_rf_fe_root(chan);
+        watch_for_getter_cache<double>(dsp_root / "freq" / "value");
+        watch_for_getter_cache<double>(rf_fe_root / "freq" / "value");
+        return derive_freq_from_xx_subdev_and_dsp(RX_SIGN, _tree->subtree(dsp_root), _tree->subtree(rf_fe_root));
+    }
+
+    double read_tx_freq(const size_t chan){
+        const fs_path dsp_root = tx_dsp_root(chan);
+        const fs_path rf_fe_root = tx_rf_fe_root(chan);
+        watch_for_getter_cache<double>(dsp_root / "freq" / "value");
+        watch_for_getter_cache<double>(rf_fe_root / "freq" / "value");
+        return derive_freq_from_xx_subdev_and_dsp(TX_SIGN, _tree->subtree(dsp_root), _tree->subtree(rf_fe_root));
+    }
+
+    double read_rx_gain(const std::string &name, const size_t chan){
+        if (_getter_cache->is_enabled()){
+            mboard_chan_pair mcp = rx_chan_to_mcp(chan);
+            const subdev_spec_pair_t spec = get_rx_subdev_spec(mcp.mboard).at(mcp.chan);
+            watch_gains_for_getter_cache(mb_root(mcp.mboard) / "rx_codecs" / spec.db_name / "gains");
+            watch_gains_for_getter_cache(rx_rf_fe_root(chan) / "gains");
+        }
+        return rx_gain_group(chan)->get_value(name);
+    }
+
+    double read_tx_gain(const std::string &name, const size_t chan){
+        if (_getter_cache->is_enabled()){
+            mboard_chan_pair mcp = tx_chan_to_mcp(chan);
+            const subdev_spec_pair_t spec = get_tx_subdev_spec(mcp.mboard).at(mcp.chan);
+            watch_gains_for_getter_cache(mb_root(mcp.mboard) / "tx_codecs" / spec.db_name / "gains");
+            watch_gains_for_getter_cache(tx_rf_fe_root(chan) / "gains");
+        }
+        return tx_gain_group(chan)->get_value(name);
+    }
+
     gain_group::sptr rx_gain_group(size_t chan){
         mboard_chan_pair mcp = rx_chan_to_mcp(chan);
         const subdev_spec_pair_t spec = get_rx_subdev_spec(mcp.mboard).at(mcp.chan);
@@ -127,7 +127,8 @@ n230_resource_manager::n230_resource_manager(
     _check_fw_compat();
 
     //Start the device claimer
-    _claimer_task = uhd::task::make(boost::bind(&n230_resource_manager::_claimer_loop, this));
+    _claimer_task = uhd::pooled_task::make(
+        boost::bind(&n230_resource_manager::_claimer_loop, this), N230_CLAIMER_TIMEOUT_IN_MS / 2e3);
 
     //Create common settings interface
     const sid_t core_sid = _generate_sid(CORE, _get_conn(PRI_ETH).type);
@@ -276,6 +277,20 @@ transport::zero_copy_if::sptr n230_resource_manager::create_transport(
     return xport;
 }
 
+transport::zero_copy_if::sptr n230_resource_manager::share_transport(
+    n230_data_dir_t direction,
+    size_t radio_instance,
+    transport::zero_copy_if::sptr xport,
+    sid_t& sid_pair)
+{
+    //the radios share a link when there is only one
+    UHD_ASSERT_THROW(_eth_conns.size() == 1);
+    const n230_eth_conn_t& conn = _get_conn((radio_instance==1)?SEC_ETH:PRI_ETH);
+    sid_pair = _generate_sid(direction==RX_DATA?RADIO_RX_DATA:RADIO_TX_DATA, conn.type, radio_instance);
+    _program_dispatcher(*xport, conn.type, sid_pair);
+    return xport;
+}
+
 bool n230_resource_manager::is_device_claimed(uhd::usrp::usrp3::usrp3_fw_ctrl_iface::sptr fw_ctrl)
 {
     boost::mutex::scoped_lock(_claimer_mutex);
@@ -288,14 +303,14 @@ bool n230_resource_manager::is_device_claimed(uhd::usrp::usrp3::usrp3_fw_ctrl_if
     return fw_ctrl->peek32(N230_FW_HOST_SHMEM_OFFSET(claim_src)) != get_process_hash();
 }
 
-void n230_resource_manager::_claimer_loop()
+bool n230_resource_manager::_claimer_loop()
 {
     {   //Critical section
         boost::mutex::scoped_lock(_claimer_mutex);
         _fw_ctrl->poke32(N230_FW_HOST_SHMEM_OFFSET(claim_time), time(NULL));
         _fw_ctrl->poke32(N230_FW_HOST_SHMEM_OFFSET(claim_src), get_process_hash());
     }
-    boost::this_thread::sleep(boost::posix_time::milliseconds(N230_CLAIMER_TIMEOUT_IN_MS / 2));
+    return false; //called again after the task period
 }
 
 void n230_resource_manager::_initialize_radio(size_t instance)
@@ -203,7 +203,16 @@ public:     //Methods
         const device_addr_t &params, sid_t& sid,
         transport::udp_zero_copy::buff_params& buff_out_params);
 
+    //Add the data stream of a radio to the transport of another radio on the same link
+    transport::zero_copy_if::sptr share_transport(
+        n230_data_dir_t direction, size_t radio_instance,
+        transport::zero_copy_if::sptr xport, sid_t& sid);
+
     //Misc
+    inline size_t get_num_eth_links() {
+        return _eth_conns.size();
+    }
+
     inline double get_max_link_rate() {
         return fpga::N230_LINK_RATE_BPS * _eth_conns.size();
     }
@@ -236,7 +245,7 @@ private:
 
     //-- Functions --
 
-    void _claimer_loop();
+    bool _claimer_loop();
 
     void _initialize_radio(size_t instance);
 
@@ -277,7 +286,7 @@ private:
 
     //Firmware register interface
     uhd::usrp::usrp3::usrp3_fw_ctrl_iface::sptr   _fw_ctrl;
-    uhd::task::sptr                 _claimer_task;
+    uhd::pooled_task::sptr          _claimer_task;
     static boost::mutex             _claimer_mutex;  //All claims and checks in this process are serialized
 
     //Transport
@@ -20,11 +20,13 @@
 #include "../../transport/super_recv_packet_handler.hpp"
 #include "../../transport/super_send_packet_handler.hpp"
 #include "async_packet_handler.hpp"
+#include "recv_packet_demuxer_3000.hpp"
 #include <uhd/transport/bounded_buffer.hpp>
 #include <boost/bind.hpp>
 #include <uhd/utils/tasks.hpp>
 #include <uhd/utils/log.hpp>
 #include <boost/foreach.hpp>
+#include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 
 static const double N230_RX_SW_BUFF_FULL_FACTOR   = 0.90;     //Buffer should ideally be 90% full.
@@ -71,6 +73,13 @@ rx_streamer::sptr n230_stream_manager::get_rx_stream(const uhd::stream_args_t &a
     if (args.otw_format.empty()) args.otw_format = "sc16";
     args.channels = args.channels.empty()? std::vector<size_t>(1, 0) : args.channels;
 
+    //With shared_xport, all channels of the streamer receive over the
+    //transport of the first one, and the packets are demuxed by SID
+    const bool share_xport = args.args.has_key("shared_xport")
+        and args.channels.size() > 1 and _resource_mgr->get_num_eth_links() == 1;
+    recv_packet_demuxer_3000::sptr demux;
+    transport::udp_zero_copy::buff_params buff_params_out;
+
     boost::shared_ptr<sph::recv_packet_streamer> my_streamer;
     for (size_t stream_i = 0; stream_i < args.channels.size(); stream_i++)
     {
@@ -90,10 +99,16 @@ rx_streamer::sptr n230_stream_manager::get_rx_stream(const uhd::stream_args_t &a
             device_addr["num_recv_frames"] = boost::lexical_cast<std::string>(_dev_args.get_num_recv_frames());
         }
 
-        transport::udp_zero_copy::buff_params buff_params_out;
         sid_t sid;
-        zero_copy_if::sptr xport = _resource_mgr->create_transport(
-            RX_DATA, chan, device_addr, sid, buff_params_out);
+        zero_copy_if::sptr xport;
+        if (demux) {
+            _resource_mgr->share_transport(RX_DATA, chan, demux->_xport, sid);
+        } else {
+            xport = _resource_mgr->create_transport(
+                RX_DATA, chan, device_addr, sid, buff_params_out);
+            if (share_xport) demux = recv_packet_demuxer_3000::make(xport, true /*big endian*/);
+        }
+        if (demux) xport = demux->make_proxy(sid.reversed().get());
 
         //calculate packet size
         static const size_t hdr_size = 0
@@ -120,7 +135,7 @@ rx_streamer::sptr n230_stream_manager::get_rx_stream(const uhd::stream_args_t &a
         id.num_inputs = 1;
         id.output_format = args.cpu_format;
         id.num_outputs = 1;
-        my_streamer->set_converter(id);
+        my_streamer->set_converter(id, args.args);
 
         perif.framer->clear();
         perif.framer->set_nsamps_per_packet(spp);
@@ -144,8 +159,10 @@ rx_streamer::sptr n230_stream_manager::get_rx_stream(const uhd::stream_args_t &a
             &rx_vita_core_3000::issue_stream_command, perif.framer, _1
         ));
 
+        //the channels on a shared transport split its socket buffer
         const size_t fc_window = _get_rx_flow_control_window(
-            xport->get_recv_frame_size(), buff_params_out.recv_buff_size);
+            xport->get_recv_frame_size(),
+            buff_params_out.recv_buff_size / (share_xport? args.channels.size() : 1));
         const size_t fc_handle_window = std::max<size_t>(1, fc_window / N230_RX_FC_REQUEST_FREQ);
 
         perif.framer->configure_flow_control(fc_window);
@@ -176,6 +193,8 @@ rx_streamer::sptr n230_stream_manager::get_rx_stream(const uhd::stream_args_t &a
     }
     update_stream_states();
 
+    my_streamer->apply_stream_args(args.args);
+
     return my_streamer;
 }
 
@@ -198,6 +217,14 @@ tx_streamer::sptr n230_stream_manager::get_tx_stream(const uhd::stream_args_t &a
     //shared async queue for all channels in streamer
     boost::shared_ptr<async_md_queue_t> async_md(new async_md_queue_t(N230_TX_MAX_ASYNC_MESSAGES));
 
+    //With shared_xport, all channels of the streamer send over the transport
+    //of the first one, and one task handles all of their async messages
+    const bool share_xport = args.args.has_key("shared_xport")
+        and args.channels.size() > 1 and _resource_mgr->get_num_eth_links() == 1;
+    zero_copy_if::sptr shared_xport;
+    boost::shared_ptr<tx_fc_cache_map_t> shared_fc_caches;
+    task::sptr shared_task;
+
     boost::shared_ptr<sph::send_packet_streamer> my_streamer;
     for (size_t stream_i = 0; stream_i < args.channels.size(); stream_i++)
     {
@@ -219,8 +246,14 @@ tx_streamer::sptr n230_stream_manager::get_tx_stream(const uhd::stream_args_t &a
 
         transport::udp_zero_copy::buff_params buff_params_out;
         sid_t sid;
-        zero_copy_if::sptr xport = _resource_mgr->create_transport(
-            TX_DATA, chan, device_addr, sid, buff_params_out);
+        zero_copy_if::sptr xport;
+        if (shared_xport) {
+            xport = _resource_mgr->share_transport(TX_DATA, chan, shared_xport, sid);
+        } else {
+            xport = _resource_mgr->create_transport(
+                TX_DATA, chan, device_addr, sid, buff_params_out);
+            if (share_xport) shared_xport = xport;
+        }
 
         //calculate packet size
         static const size_t hdr_size = 0
@@ -245,7 +278,7 @@ tx_streamer::sptr n230_stream_manager::get_tx_stream(const uhd::stream_args_t &a
         id.num_inputs = 1;
         id.output_format = args.otw_format + "_item32_be";
         id.num_outputs = 1;
-        my_streamer->set_converter(id);
+        my_streamer->set_converter(id, args.args);
 
         perif.deframer->clear();
         perif.deframer->setup(args);
@@ -265,9 +298,22 @@ tx_streamer::sptr n230_stream_manager::get_tx_stream(const uhd::stream_args_t &a
         fc_cache->old_async_queue = _async_md_queue;
 
         tick_rate_retriever_t get_tick_rate_fn = boost::bind(&n230_stream_manager::_get_tick_rate, this);
-        task::sptr task = task::make(
-            boost::bind(&n230_stream_manager::_handle_tx_async_msgs,
-                fc_cache, xport, get_tick_rate_fn));
+        task::sptr task;
+        if (share_xport) {
+            if (not shared_task) {
+                shared_fc_caches = boost::make_shared<tx_fc_cache_map_t>();
+                shared_task = task::make(
+                    boost::bind(&n230_stream_manager::_handle_shared_tx_async_msgs,
+                        shared_fc_caches, xport, get_tick_rate_fn), "async_msg");
+            }
+            boost::mutex::scoped_lock l(shared_fc_caches->mutex);
+            shared_fc_caches->caches[sid.reversed().get()] = fc_cache;
+            task = shared_task;
+        } else {
+            task = task::make(
+                boost::bind(&n230_stream_manager::_handle_tx_async_msgs,
+                    fc_cache, xport, get_tick_rate_fn));
+        }
 
         //Give the streamer a functor to get the send buffer
         //get_tx_buff_with_flowctrl is static so bind has no lifetime issues
@@ -301,6 +347,8 @@ tx_streamer::sptr n230_stream_manager::get_tx_stream(const uhd::stream_args_t &a
     }
     update_stream_states();
 
+    my_streamer->apply_stream_args(args.args);
+
     return my_streamer;
 }
 
@@ -466,7 +514,36 @@ void n230_stream_manager::_handle_tx_async_msgs(
 {
     managed_recv_buffer::sptr buff = xport->get_recv_buff();
     if (not buff) return;
+    _handle_tx_async_msg(fc_cache, buff, get_tick_rate);
+}
 
+void n230_stream_manager::_handle_shared_tx_async_msgs(
+    boost::shared_ptr<tx_fc_cache_map_t> fc_caches,
+    zero_copy_if::sptr xport,
+    tick_rate_retriever_t get_tick_rate)
+{
+    managed_recv_buffer::sptr buff = xport->get_recv_buff();
+    if (not buff or buff->size() < 2*sizeof(uint32_t)) return;
+
+    //find the channel from the SID in the second header word
+    const uint32_t sid = uhd::ntohx(buff->cast<const uint32_t *>()[1]);
+    boost::shared_ptr<tx_fc_cache_t> fc_cache;
+    {
+        boost::mutex::scoped_lock l(fc_caches->mutex);
+        if (fc_caches->caches.count(sid)) fc_cache = fc_caches->caches[sid];
+    }
+    if (not fc_cache) {
+        UHD_MSG(error) << boost::format("Async message with unexpected SID 0x%08x") % sid << std::endl;
+        return;
+    }
+    _handle_tx_async_msg(fc_cache, buff, get_tick_rate);
+}
+
+void n230_stream_manager::_handle_tx_async_msg(
+    boost::shared_ptr<tx_fc_cache_t> fc_cache,
+    managed_recv_buffer::sptr buff,
+    tick_rate_retriever_t get_tick_rate)
+{
     //extract packet info
     vrt::if_packet_info_t if_packet_info;
     if_packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
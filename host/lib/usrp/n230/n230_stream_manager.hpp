@@ -29,6 +29,8 @@
 #include <uhd/property_tree.hpp>
 #include <uhd/utils/tasks.hpp>
 #include <boost/smart_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
 #include "n230_device_args.hpp"
 #include "n230_resource_manager.hpp"
 
@@ -91,6 +93,13 @@ private:
         boost::shared_ptr<async_md_queue_t> old_async_queue;
     };
 
+    //The TX flow control caches of the channels on one shared transport, by response SID
+    struct tx_fc_cache_map_t
+    {
+        boost::mutex mutex;
+        std::map<uint32_t, boost::shared_ptr<tx_fc_cache_t> > caches;
+    };
+
     typedef boost::function<double(void)> tick_rate_retriever_t;
 
     void _handle_overflow(const size_t i);
@@ -111,6 +120,16 @@ private:
         transport::zero_copy_if::sptr xport,
         tick_rate_retriever_t get_tick_rate);
 
+    static void _handle_shared_tx_async_msgs(
+        boost::shared_ptr<tx_fc_cache_map_t> fc_caches,
+        transport::zero_copy_if::sptr xport,
+        tick_rate_retriever_t get_tick_rate);
+
+    static void _handle_tx_async_msg(
+        boost::shared_ptr<tx_fc_cache_t> guts,
+        transport::managed_recv_buffer::sptr buff,
+        tick_rate_retriever_t get_tick_rate);
+
     static transport::managed_send_buffer::sptr _get_tx_buff_with_flowctrl(
         task::sptr /*holds ref*/,
         boost::shared_ptr<tx_fc_cache_t> guts,
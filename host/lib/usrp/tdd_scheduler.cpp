@@ -0,0 +1,234 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/usrp/tdd_scheduler.hpp>
+#include <uhd/usrp/acquisition_scheduler.hpp>
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <deque>
+
+using namespace uhd;
+using namespace uhd::usrp;
+
+tdd_frame_t::tdd_frame_t(
+    const size_t rx_samps_,
+    const size_t rx_tx_guard_,
+    const size_t tx_samps_,
+    const size_t tx_rx_guard_
+):
+    rx_samps(rx_samps_), rx_tx_guard(rx_tx_guard_),
+    tx_samps(tx_samps_), tx_rx_guard(tx_rx_guard_)
+{
+    /* NOP */
+}
+
+size_t tdd_frame_t::get_length(void) const{
+    return rx_samps + rx_tx_guard + tx_samps + tx_rx_guard;
+}
+
+tdd_atr_t::tdd_atr_t(void):
+    idle(0), rx(0), tx(0), full_duplex(0), mask(0)
+{
+    /* NOP */
+}
+
+tdd_scheduler::~tdd_scheduler(void){
+    /* NOP */
+}
+
+/***********************************************************************
+ * Scheduler implementation
+ **********************************************************************/
+class tdd_scheduler_impl : public tdd_scheduler{
+public:
+    tdd_scheduler_impl(
+        rx_streamer::sptr rx_stream,
+        tx_streamer::sptr tx_stream,
+        const double rate,
+        const tdd_frame_t &frame,
+        const time_spec_t &start,
+        const device_addr_t &args
+    ):
+        _tx_stream(tx_stream),
+        _rate(rate),
+        _frame(frame),
+        _start(start),
+        _frame_depth(size_t(args.cast<double>("frame_depth", 4))),
+        _resync_lead(args.cast<double>("resync_lead", 0.1)),
+        _next_frame(0),
+        _acq_base(0),
+        _last_frame(0),
+        _num_skipped(0),
+        _stopped(false)
+    {
+        if (_rate <= 0.0) throw uhd::value_error("tdd_scheduler: the rate must be positive");
+        if (_frame.get_length() == 0) throw uhd::value_error("tdd_scheduler: the frame is empty");
+        if (_frame.rx_samps != 0 and not rx_stream) throw uhd::value_error(
+            "tdd_scheduler: the frame has an RX window but there is no RX streamer");
+        if (_frame.tx_samps != 0 and not _tx_stream) throw uhd::value_error(
+            "tdd_scheduler: the frame has a TX window but there is no TX streamer");
+        if (_frame_depth == 0) throw uhd::value_error(
+            "tdd_scheduler: frame_depth must be at least 1");
+        if (_frame.rx_samps != 0){
+            _acq = acquisition_scheduler::make(rx_stream, _rate, args);
+            this->top_up();
+        }
+    }
+
+    time_spec_t get_frame_time(const size_t frame) const{
+        return _start + time_spec_t::from_ticks((long long)(frame)*(long long)(_frame.get_length()), _rate);
+    }
+
+    time_spec_t get_tx_time(const size_t frame) const{
+        return this->get_frame_time(frame) + time_spec_t::from_ticks(
+            (long long)(_frame.rx_samps + _frame.rx_tx_guard), _rate);
+    }
+
+    size_t recv(
+        const rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t &metadata,
+        const double timeout
+    ){
+        if (not _acq) throw uhd::runtime_error("tdd_scheduler: the frame has no RX window");
+        this->top_up();
+        const size_t num_dropped = _acq->get_num_dropped();
+        const size_t num_samps = _acq->recv(buffs, nsamps_per_buff, metadata, timeout);
+        _last_frame = this->frame_of(_acq->get_acquisition_index());
+
+        //after an error, skip the frames which are too close to start in time
+        if (_acq->get_num_dropped() != num_dropped and metadata.has_time_spec){
+            const time_spec_t earliest = metadata.time_spec + time_spec_t(_resync_lead);
+            if (_acq->get_num_pending() == 0){
+                while (this->get_frame_time(_next_frame) < earliest){
+                    _next_frame++;
+                    _num_skipped++;
+                }
+            }
+        }
+        this->top_up();
+        return num_samps;
+    }
+
+    size_t get_rx_frame(void) const{
+        return _last_frame;
+    }
+
+    size_t get_num_dropped(void) const{
+        return (_acq? _acq->get_num_dropped() : 0) + _num_skipped;
+    }
+
+    size_t send(
+        const tx_streamer::buffs_type &buffs,
+        const size_t nsamps,
+        const size_t frame,
+        const double timeout
+    ){
+        if (not _tx_stream) throw uhd::runtime_error("tdd_scheduler: the frame has no TX window");
+        if (nsamps > _frame.tx_samps) throw uhd::value_error(str(boost::format(
+            "tdd_scheduler: a burst of %u samples does not fit the TX window of %u samples"
+        ) % nsamps % _frame.tx_samps));
+
+        tx_metadata_t md;
+        md.start_of_burst = true;
+        md.end_of_burst = true;
+        md.has_time_spec = true;
+        md.time_spec = this->get_tx_time(frame);
+        return _tx_stream->send(buffs, nsamps, md, timeout);
+    }
+
+    void stop(void){
+        if (not _acq) return;
+        _acq->stop();
+        _acq_base += _frames.size();
+        _frames.clear();
+        _stopped = true;
+    }
+
+private:
+    //! Schedule the RX windows of the frames up to frame_depth ahead
+    void top_up(void){
+        if (_stopped) return;
+        std::vector<acquisition_t> acqs;
+        while (_acq->get_num_pending() + acqs.size() < _frame_depth){
+            acqs.push_back(acquisition_t(this->get_frame_time(_next_frame), _frame.rx_samps));
+            _frames.push_back(_next_frame++);
+        }
+        if (not acqs.empty()) _acq->schedule(acqs);
+
+        //forget the frames of the acquisitions which are done
+        const size_t pending_base = _acq_base + _frames.size() - _acq->get_num_pending();
+        while (_acq_base + 1 < pending_base and _frames.size() > 1){
+            _frames.pop_front();
+            _acq_base++;
+        }
+    }
+
+    //! Get the frame of an acquisition index
+    size_t frame_of(const size_t index) const{
+        if (index < _acq_base or index - _acq_base >= _frames.size()) return _last_frame;
+        return _frames[index - _acq_base];
+    }
+
+    acquisition_scheduler::sptr _acq;
+    const tx_streamer::sptr _tx_stream;
+    const double _rate;
+    const tdd_frame_t _frame;
+    const time_spec_t _start;
+    const size_t _frame_depth;
+    const double _resync_lead;
+
+    //! The next frame to schedule
+    size_t _next_frame;
+
+    //! The frame of each acquisition, the first has the index _acq_base
+    std::deque<size_t> _frames;
+    size_t _acq_base;
+
+    size_t _last_frame;
+    size_t _num_skipped;
+    bool _stopped;
+};
+
+/***********************************************************************
+ * The factory function and the ATR setup
+ **********************************************************************/
+tdd_scheduler::sptr tdd_scheduler::make(
+    rx_streamer::sptr rx_stream,
+    tx_streamer::sptr tx_stream,
+    const double rate,
+    const tdd_frame_t &frame,
+    const time_spec_t &start,
+    const device_addr_t &args
+){
+    return boost::make_shared<tdd_scheduler_impl>(rx_stream, tx_stream, rate, frame, start, args);
+}
+
+void tdd_scheduler::set_atr(
+    multi_usrp::sptr usrp,
+    const std::string &bank,
+    const tdd_atr_t &atr,
+    const size_t mboard
+){
+    usrp->set_gpio_attr(bank, "ATR_0X", atr.idle, atr.mask, mboard);
+    usrp->set_gpio_attr(bank, "ATR_RX", atr.rx, atr.mask, mboard);
+    usrp->set_gpio_attr(bank, "ATR_TX", atr.tx, atr.mask, mboard);
+    usrp->set_gpio_attr(bank, "ATR_XX", atr.full_duplex, atr.mask, mboard);
+    usrp->set_gpio_attr(bank, "DDR", atr.mask, atr.mask, mboard);
+    usrp->set_gpio_attr(bank, "CTRL", atr.mask, atr.mask, mboard);
+}
@@ -305,12 +305,12 @@ void usrp1_impl::vandal_conquest_loop(void){
         if (_tx_enabled and underflow){
             async_metadata.time_spec = _soft_time_ctrl->get_time();
             _soft_time_ctrl->get_async_queue().push_with_pop_on_full(async_metadata);
-            UHD_MSG(fastpath) << "U";
+            uhd::msg::fastpath_event('U');
         }
         if (_rx_enabled and overflow){
             inline_metadata.time_spec = _soft_time_ctrl->get_time();
             _soft_time_ctrl->get_inline_queue().push_with_pop_on_full(inline_metadata);
-            UHD_MSG(fastpath) << "O";
+            uhd::msg::fastpath_event('O');
         }
 
         boost::this_thread::sleep(boost::posix_time::milliseconds(50));
@@ -339,6 +339,11 @@ public:
         return _max_num_samps;
     }
 
+    void apply_stream_args(const uhd::device_addr_t &args){
+        sph::recv_packet_handler::set_converter_threads(args);
+        sph::recv_packet_handler::warm_start(args, _max_num_samps);
+    }
+
     size_t recv(
         const rx_streamer::buffs_type &buffs,
         const size_t nsamps_per_buff,
@@ -386,6 +391,11 @@ public:
         return _max_num_samps;
     }
 
+    void apply_stream_args(const uhd::device_addr_t &args){
+        sph::send_packet_handler::set_converter_threads(args);
+        sph::send_packet_handler::warm_start(args, _max_num_samps);
+    }
+
     size_t send(
         const tx_streamer::buffs_type &buffs,
         const size_t nsamps_per_buff,
@@ -512,6 +522,8 @@ double usrp1_impl::update_rx_samp_rate(size_t dspno, const double samp_rate){
         _iface->poke32(FR_DECIM_RATE, rate/div - 1);
         this->restore_rx(s);
 
+        _soft_time_ctrl->set_samp_rate(_master_clock_rate / rate);
+
         //update the streamer if created
         boost::shared_ptr<usrp1_recv_packet_streamer> my_streamer =
             boost::dynamic_pointer_cast<usrp1_recv_packet_streamer>(_rx_streamer.lock());
@@ -652,7 +664,7 @@ rx_streamer::sptr usrp1_impl::get_rx_stream(const uhd::stream_args_t &args_){
     id.num_inputs = 1;
     id.output_format = args.cpu_format;
     id.num_outputs = args.channels.size();
-    my_streamer->set_converter(id);
+    my_streamer->set_converter(id, args.args);
 
     //special scale factor change for sc8
     if (args.otw_format == "sc8")
@@ -664,6 +676,8 @@ rx_streamer::sptr usrp1_impl::get_rx_stream(const uhd::stream_args_t &args_){
     //sets all tick and samp rates on this streamer
     this->update_rates();
 
+    my_streamer->apply_stream_args(args.args);
+
     return my_streamer;
 }
 
@@ -709,7 +723,7 @@ tx_streamer::sptr usrp1_impl::get_tx_stream(const uhd::stream_args_t &args_){
     id.num_inputs = args.channels.size();
     id.output_format = args.otw_format + "_item16_usrp1";
     id.num_outputs = 1;
-    my_streamer->set_converter(id);
+    my_streamer->set_converter(id, args.args);
 
     //save as weak ptr for update access
     _tx_streamer = my_streamer;
@@ -717,5 +731,7 @@ tx_streamer::sptr usrp1_impl::get_tx_stream(const uhd::stream_args_t &args_){
     //sets all tick and samp rates on this streamer
     this->update_rates();
 
+    my_streamer->apply_stream_args(args.args);
+
     return my_streamer;
 }
@@ -19,8 +19,14 @@
 #include <uhd/utils/tasks.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <deque>
 #include <iostream>
+#ifdef HAVE_CLOCK_GETTIME
+#include <cerrno>
+#include <time.h>
+#endif
 
 using namespace uhd;
 using namespace uhd::usrp;
@@ -29,6 +35,26 @@ namespace pt = boost::posix_time;
 
 static const time_spec_t TWIDDLE(0.0011);
 
+//! the end of a sleep that is spent in the precise, uninterruptible sleep
+static const double PRECISE_SLEEP_MARGIN = 0.002;
+
+/*!
+ * Sleep until a system time, with the resolution of the OS timer.
+ * With clock_gettime(), the system time is CLOCK_MONOTONIC and the
+ * deadline is absolute, so the time spent before the call adds no error.
+ */
+static void sleep_until_system_time(const time_spec_t &time){
+#ifdef HAVE_CLOCK_GETTIME
+    timespec ts;
+    ts.tv_sec = time.get_full_secs();
+    ts.tv_nsec = long(time.get_frac_secs()*1e9);
+    while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR){}
+#else
+    const double seconds_to_sleep = (time - time_spec_t::get_system_time()).get_real_secs();
+    if (seconds_to_sleep > 0) boost::this_thread::sleep(pt::microseconds(long(seconds_to_sleep*1e6)));
+#endif
+}
+
 soft_time_ctrl::~soft_time_ctrl(void){
     /* NOP */
 }
@@ -42,13 +68,14 @@ public:
     soft_time_ctrl_impl(const cb_fcn_type &stream_on_off):
         _nsamps_remaining(0),
         _stream_mode(stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS),
-        _cmd_queue(2),
+        _samp_rate(0.0),
+        _nsamps_since_start(0),
         _async_msg_queue(1000),
         _inline_msg_queue(1000),
         _stream_on_off(stream_on_off)
     {
         //synchronously spawn a new thread
-        _recv_cmd_task = task::make(boost::bind(&soft_time_ctrl_impl::recv_cmd_task, this));
+        _recv_cmd_task = task::make(boost::bind(&soft_time_ctrl_impl::recv_cmd_task, this), "soft_time_ctrl");
 
         //initialize the time to something
         this->set_time(time_spec_t(0.0));
@@ -75,15 +102,33 @@ public:
     UHD_INLINE void sleep_until_time(
         boost::mutex::scoped_lock &lock, const time_spec_t &time
     ){
-        boost::condition_variable cond;
-        //use a condition variable to unlock, sleep, lock
-        double seconds_to_sleep = (time - time_now()).get_real_secs();
-        cond.timed_wait(lock, pt::microseconds(long(seconds_to_sleep*1e6)));
+        const time_spec_t system_time = time + _time_offset;
+        lock.unlock();
+
+        //the interruptible sleep wakes up early, the precise sleep ends on time
+        const double seconds_to_sleep = (system_time - time_spec_t::get_system_time()).get_real_secs();
+        if (seconds_to_sleep > PRECISE_SLEEP_MARGIN){
+            boost::this_thread::sleep(pt::microseconds(long((seconds_to_sleep - PRECISE_SLEEP_MARGIN)*1e6)));
+        }
+        sleep_until_system_time(system_time);
+
+        lock.lock();
     }
 
     /*******************************************************************
      * Receive control
      ******************************************************************/
+    void set_samp_rate(const double rate){
+        boost::mutex::scoped_lock lock(_update_mutex);
+
+        //restart counting from the time of the next sample
+        if (_samp_rate > 0){
+            _stream_time += time_spec_t::from_ticks(_nsamps_since_start, _samp_rate);
+        }
+        _nsamps_since_start = 0;
+        _samp_rate = rate;
+    }
+
     size_t recv_post(rx_metadata_t &md, const size_t nsamps){
         boost::mutex::scoped_lock lock(_update_mutex);
 
@@ -93,10 +138,20 @@ public:
             if (_inline_msg_queue.pop_with_haste(md)) return 0;
         }
 
-        //load the metadata with the expected time
+        //load the metadata with the expected time:
+        //the time of the first sample, counted from the start of the stream
         md.has_time_spec = true;
-        md.time_spec = time_now();
+        if (_samp_rate > 0 and _stream_mode != stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS){
+            md.time_spec = _stream_time + time_spec_t::from_ticks(_nsamps_since_start, _samp_rate);
+        }
+        else md.time_spec = time_now();
 
+        const size_t nsamps_out = this->clip_nsamps(md, nsamps);
+        _nsamps_since_start += nsamps_out;
+        return nsamps_out;
+    }
+
+    UHD_INLINE size_t clip_nsamps(rx_metadata_t &md, const size_t nsamps){
         //none of the stuff below matters in continuous streaming mode
         if (_stream_mode == stream_cmd_t::STREAM_MODE_START_CONTINUOUS) return nsamps;
 
@@ -124,7 +179,10 @@ public:
     }
 
     void issue_stream_cmd(const stream_cmd_t &cmd){
-        _cmd_queue.push_with_wait(boost::make_shared<stream_cmd_t>(cmd));
+        boost::mutex::scoped_lock lock(_cmd_mutex);
+        _cmd_queue.push_back(cmd);
+        lock.unlock();
+        _cmd_cond.notify_one();
     }
 
     void stream_on_off(bool enb){
@@ -163,7 +221,8 @@ public:
     void recv_cmd_handle_cmd(const stream_cmd_t &cmd){
         boost::mutex::scoped_lock lock(_update_mutex);
 
-        //handle the stream at time by sleeping
+        //handle the stream at time by sleeping until its deadline
+        time_spec_t stream_time = time_now();
         if (not cmd.stream_now){
             time_spec_t time_at(cmd.time_spec - TWIDDLE);
             if (time_at < time_now()){
@@ -177,6 +236,7 @@ public:
             }
             else{
                 sleep_until_time(lock, time_at);
+                stream_time = cmd.time_spec;
             }
         }
 
@@ -188,9 +248,14 @@ public:
 
         //When to start streaming:
         //Start streaming when the command is not a stop and not streaming.
+        //The sample count starts over at the time of the first sample.
         if (cmd.stream_mode != stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS
            and _stream_mode == stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS
-        ) stream_on_off(true);
+        ){
+            stream_on_off(true);
+            _stream_time = stream_time;
+            _nsamps_since_start = 0;
+        }
 
         //update the state
         _nsamps_remaining += cmd.num_samps;
@@ -198,9 +263,13 @@ public:
     }
 
     void recv_cmd_task(void){ //task is looped
-        boost::shared_ptr<stream_cmd_t> cmd;
-        _cmd_queue.pop_with_wait(cmd);
-        recv_cmd_handle_cmd(*cmd);
+        //commands run in order, each one waits for its deadline
+        boost::mutex::scoped_lock lock(_cmd_mutex);
+        while (_cmd_queue.empty()) _cmd_cond.wait(lock);
+        const stream_cmd_t cmd = _cmd_queue.front();
+        _cmd_queue.pop_front();
+        lock.unlock();
+        recv_cmd_handle_cmd(cmd);
     }
 
     bounded_buffer<async_metadata_t> &get_async_queue(void){
@@ -220,7 +289,12 @@ private:
     size_t _nsamps_remaining;
     stream_cmd_t::stream_mode_t _stream_mode;
     time_spec_t _time_offset;
-    bounded_buffer<boost::shared_ptr<stream_cmd_t> > _cmd_queue;
+    double _samp_rate;
+    time_spec_t _stream_time;
+    size_t _nsamps_since_start;
+    boost::mutex _cmd_mutex;
+    boost::condition_variable _cmd_cond;
+    std::deque<stream_cmd_t> _cmd_queue;
     bounded_buffer<async_metadata_t> _async_msg_queue;
     bounded_buffer<rx_metadata_t> _inline_msg_queue;
     const cb_fcn_type _stream_on_off;
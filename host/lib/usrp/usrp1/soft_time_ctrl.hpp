@@ -55,6 +55,9 @@ public:
     //! Get the current time
     virtual time_spec_t get_time(void) = 0;
 
+    //! Set the RX sample rate, used to time stamp the samples by count
+    virtual void set_samp_rate(const double rate) = 0;
+
     //! Call after the internal recv function
     virtual size_t recv_post(rx_metadata_t &md, const size_t nsamps) = 0;
 
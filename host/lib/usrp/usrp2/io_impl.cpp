@@ -35,6 +35,8 @@
 #include <boost/asio.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/foreach.hpp>
+#include <algorithm>
 #include <iostream>
 
 using namespace uhd;
@@ -54,6 +56,7 @@ static UHD_INLINE pt::time_duration to_time_dur(double timeout){
  * constants
  **********************************************************************/
 static const size_t vrt_send_header_offset_words32 = 1;
+static const size_t DEFAULT_RX_BUFF_BATCH = 8;
 
 /***********************************************************************
  * flow control monitor for a single tx channel
@@ -112,6 +115,18 @@ public:
         _fc_cond.notify_one();
     }
 
+    //! Get the max num seqs before throttling
+    size_t get_window(void) const{
+        return _max_seqs_out;
+    }
+
+    //! Get the num seqs which can go out before throttling
+    size_t get_num_credits(void){
+        boost::mutex::scoped_lock lock(_fc_mutex);
+        const seq_type seqs_out = _last_seq_out - _last_seq_ack;
+        return (seqs_out < _max_seqs_out)? _max_seqs_out - seqs_out : 0;
+    }
+
 private:
     bool ready(void){
         return seq_type(_last_seq_out -_last_seq_ack) < _max_seqs_out;
@@ -431,9 +446,20 @@ rx_streamer::sptr usrp2_impl::get_rx_stream(const uhd::stream_args_t &args_){
         - sizeof(vrt::if_packet_info_t().cid) //no class id ever used
         - sizeof(vrt::if_packet_info_t().tsi) //no int time ever used
     ;
-    const size_t bpp = _mbc[_mbc.keys().front()].rx_dsp_xports[0]->get_recv_frame_size() - hdr_size;
+    //The FPGA buffers one jumbo frame, so when several DSPs stream at once,
+    //the packets must fit into a standard frame
+    size_t frame_size = _mbc[_mbc.keys().front()].rx_dsp_xports[0]->get_recv_frame_size();
+    size_t num_dsps_streaming = args.channels.size();
+    BOOST_FOREACH(const std::string &mb, _mbc.keys()){
+        BOOST_FOREACH(const boost::weak_ptr<rx_streamer> &streamer, _mbc[mb].rx_streamers){
+            if (not streamer.expired()) num_dsps_streaming++;
+        }
+    }
+    if (num_dsps_streaming > 1) frame_size = std::min(frame_size, udp_simple::mtu);
+    const size_t bpp = frame_size - hdr_size;
     const size_t bpi = convert::get_bytes_per_item(args.otw_format);
     const size_t spp = args.args.cast<size_t>("spp", bpp/bpi);
+    const size_t recv_batch = args.args.cast<size_t>("recv_batch", DEFAULT_RX_BUFF_BATCH);
 
     //make the new streamer given the samples per packet
     boost::shared_ptr<sph::recv_packet_streamer> my_streamer = boost::make_shared<sph::recv_packet_streamer>(spp);
@@ -448,12 +474,12 @@ rx_streamer::sptr usrp2_impl::get_rx_stream(const uhd::stream_args_t &args_){
     id.num_inputs = 1;
     id.output_format = args.cpu_format;
     id.num_outputs = 1;
-    my_streamer->set_converter(id);
+    my_streamer->set_converter(id, args.args);
 
     //bind callbacks for the handler
     for (size_t chan_i = 0; chan_i < args.channels.size(); chan_i++){
         const size_t chan = args.channels[chan_i];
-        size_t num_chan_so_far = 0;
+        size_t num_chan_so_far = 0, mb_index = 0;
         BOOST_FOREACH(const std::string &mb, _mbc.keys()){
             num_chan_so_far += _mbc[mb].rx_chan_occ;
             if (chan < num_chan_so_far){
@@ -461,14 +487,14 @@ rx_streamer::sptr usrp2_impl::get_rx_stream(const uhd::stream_args_t &args_){
                 _mbc[mb].rx_dsps[dsp]->set_nsamps_per_packet(spp); //seems to be a good place to set this
                 _mbc[mb].rx_dsps[dsp]->setup(args);
                 this->program_stream_dest(_mbc[mb].rx_dsp_xports[dsp], args);
-                my_streamer->set_xport_chan_get_buff(chan_i, boost::bind(
-                    &zero_copy_if::get_recv_buff, _mbc[mb].rx_dsp_xports[dsp], _1
-                ), true /*flush*/);
+                my_streamer->set_xport_chan(chan_i, _mbc[mb].rx_dsp_xports[dsp], recv_batch, true /*flush*/);
+                my_streamer->set_xport_chan_mboard(chan_i, mb_index);
                 my_streamer->set_issue_stream_cmd(chan_i, boost::bind(
                     &rx_dsp_core_200::issue_stream_command, _mbc[mb].rx_dsps[dsp], _1));
                 _mbc[mb].rx_streamers[dsp] = my_streamer; //store weak pointer
                 break;
             }
+            mb_index++;
         }
     }
 
@@ -479,6 +505,8 @@ rx_streamer::sptr usrp2_impl::get_rx_stream(const uhd::stream_args_t &args_){
     //sets all tick and samp rates on this streamer
     this->update_rates();
 
+    my_streamer->apply_stream_args(args.args);
+
     return my_streamer;
 }
 
@@ -517,7 +545,7 @@ tx_streamer::sptr usrp2_impl::get_tx_stream(const uhd::stream_args_t &args_){
     id.num_inputs = 1;
     id.output_format = args.otw_format + "_item32_be";
     id.num_outputs = 1;
-    my_streamer->set_converter(id);
+    my_streamer->set_converter(id, args.args);
 
     //bind callbacks for the handler
     for (size_t chan_i = 0; chan_i < args.channels.size(); chan_i++){
@@ -535,6 +563,9 @@ tx_streamer::sptr usrp2_impl::get_tx_stream(const uhd::stream_args_t &args_){
                 my_streamer->set_xport_chan_get_buff(chan_i, boost::bind(
                     &usrp2_impl::io_impl::get_send_buff, _io_impl.get(), abs, _1
                 ));
+                my_streamer->set_xport_chan_fc_credits(chan_i, boost::bind(
+                    &flow_control_monitor::get_num_credits, _io_impl->fc_mons[abs].get()
+                ), _io_impl->fc_mons[abs]->get_window());
                 my_streamer->set_async_receiver(boost::bind(&bounded_buffer<async_metadata_t>::pop_with_timed_wait, &(_io_impl->async_msg_fifo), _1, _2));
                 _mbc[mb].tx_streamers[dsp] = my_streamer; //store weak pointer
                 break;
@@ -546,5 +577,7 @@ tx_streamer::sptr usrp2_impl::get_tx_stream(const uhd::stream_args_t &args_){
     //sets all tick and samp rates on this streamer
     this->update_rates();
 
+    my_streamer->apply_stream_args(args.args);
+
     return my_streamer;
 }
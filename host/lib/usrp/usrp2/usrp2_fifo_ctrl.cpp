@@ -22,6 +22,7 @@
 #include <uhd/transport/vrt_if_packet.hpp>
 #include "usrp2_fifo_ctrl.hpp"
 #include <boost/thread/mutex.hpp>
+#include <queue>
 #include <boost/thread/thread.hpp>
 #include <boost/asio.hpp> //htonl
 #include <boost/format.hpp>
@@ -83,6 +84,47 @@ public:
         return this->wait_for_ack(_seq_out);
     }
 
+    /*******************************************************************
+     * Batched transactions:
+     * Send all commands, waiting only when the window is full,
+     * and collect the readback values from the acks in order.
+     ******************************************************************/
+    void transact(transactions_type &transactions){
+        for (size_t i = 0; i < transactions.size(); i++){
+            if (transactions[i].op == transaction_t::PEEK64){
+                throw uhd::not_implemented_error("peek64 not implemented in fifo ctrl module");
+            }
+        }
+
+        boost::mutex::scoped_lock lock(_mutex);
+
+        //sequence numbers and indexes of the readbacks not acked yet
+        std::queue<std::pair<uint16_t, size_t> > peeks;
+        for (size_t i = 0; i < transactions.size(); i++){
+            const transaction_t &t = transactions[i];
+            if (t.op == transaction_t::POKE32){
+                this->send_pkt((t.addr - SETTING_REGS_BASE)/4, uint32_t(t.data), POKE32_CMD);
+            }
+            else{
+                this->send_pkt((t.addr - READBACK_BASE)/4, 0, PEEK32_CMD);
+                peeks.push(std::make_pair(_seq_out, i));
+            }
+
+            //collect the readbacks that leave the window before waiting on it
+            const uint16_t seq_window = uint16_t(_seq_out-MAX_SEQS_OUT);
+            while (not peeks.empty() and not wraparound_lt16(seq_window, peeks.front().first)){
+                transactions[peeks.front().second].data = this->wait_for_ack(peeks.front().first);
+                peeks.pop();
+            }
+            this->wait_for_ack(seq_window);
+        }
+
+        while (not peeks.empty()){
+            transactions[peeks.front().second].data = this->wait_for_ack(peeks.front().first);
+            peeks.pop();
+        }
+    }
+
     /*******************************************************************
      * Peek and poke 16 bit not implemented
      ******************************************************************/
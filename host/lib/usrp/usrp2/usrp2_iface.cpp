@@ -98,7 +98,7 @@ public:
     void lock_device(bool lock){
         if (lock){
             this->pokefw(U2_FW_REG_LOCK_GPID, get_process_hash());
-            _lock_task = task::make(boost::bind(&usrp2_iface_impl::lock_task, this));
+            _lock_task = pooled_task::make(boost::bind(&usrp2_iface_impl::lock_task, this), 1.5 /* seconds */);
         }
         else{
             _lock_task.reset(); //shutdown the task
@@ -125,11 +125,10 @@ public:
         return lock_gpid != get_process_hash();
     }
 
-    void lock_task(void){
-        //re-lock in task
+    bool lock_task(void){
+        //re-lock in task, called again after the task period
         this->pokefw(U2_FW_REG_LOCK_TIME, this->get_curr_time());
-        //sleep for a bit
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1500));
+        return false;
     }
 
     uint32_t get_curr_time(void){
@@ -419,7 +418,7 @@ private:
     uint32_t _protocol_compat;
 
     //lock thread stuff
-    task::sptr _lock_task;
+    pooled_task::sptr _lock_task;
 };
 
 /***********************************************************************
@@ -18,6 +18,7 @@
 #include "usrp2_impl.hpp"
 #include "fw_common.h"
 #include "apply_corrections.hpp"
+#include "broadcast_find.hpp"
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/exception.hpp>
@@ -45,6 +46,9 @@ namespace asio = boost::asio;
 //A reasonable number of frames for send/recv and async/sync
 static const size_t DEFAULT_NUM_FRAMES = 32;
 
+//The number of RX DSP frames to take per system call, see udp_batch
+static const size_t DEFAULT_RECV_UDP_BATCH = 16;
+
 /***********************************************************************
  * Discovery over the udp transport
  **********************************************************************/
@@ -81,16 +85,7 @@ device_addrs_t usrp2_find(const device_addr_t &hint_){
 
     //if no address was specified, send a broadcast on each interface
     if (not hint.has_key("addr")){
-        BOOST_FOREACH(const if_addrs_t &if_addrs, get_if_addrs()){
-            //avoid the loopback device
-            if (if_addrs.inet == asio::ip::address_v4::loopback().to_string()) continue;
-
-            //create a new hint with this broadcast address
-            device_addr_t new_hint = hint;
-            new_hint["addr"] = if_addrs.bcast;
-
-            //call discover with the new hint and append results
-            device_addrs_t new_usrp2_addrs = usrp2_find(new_hint);
+        BOOST_FOREACH(const device_addrs_t &new_usrp2_addrs, broadcast_find(hint, &usrp2_find)){
             usrp2_addrs.insert(usrp2_addrs.begin(),
                 new_usrp2_addrs.begin(), new_usrp2_addrs.end()
             );
@@ -289,6 +284,15 @@ static zero_copy_if::sptr make_xport(
         filtered_hints[key] = hints[key];
     }
 
+    //batch the receives of the RX DSP transports where recvmmsg() exists
+    if (filter == "recv"){
+        #if defined(UHD_PLATFORM_LINUX)
+        filtered_hints["udp_batch"] = hints.get("udp_batch", boost::lexical_cast<std::string>(DEFAULT_RECV_UDP_BATCH));
+        #else
+        if (hints.has_key("udp_batch")) filtered_hints["udp_batch"] = hints["udp_batch"];
+        #endif
+    }
+
     zero_copy_xport_params default_buff_args;
     default_buff_args.send_frame_size = transport::udp_simple::mtu;
     default_buff_args.recv_frame_size = transport::udp_simple::mtu;
@@ -339,9 +343,10 @@ usrp2_impl::usrp2_impl(const device_addr_t &_device_addr) :
 
     device_addrs_t device_args = separate_device_addr(device_addr);
 
-    //extract the user's requested MTU size or default
+    //extract the user's requested MTU size or default,
+    //jumbo frames are used for RX when the path to the device passes them
     mtu_result_t user_mtu;
-    user_mtu.recv_mtu = size_t(device_addr.cast<double>("recv_frame_size", udp_simple::mtu));
+    user_mtu.recv_mtu = size_t(device_addr.cast<double>("recv_frame_size", USRP2_MAX_RECV_FRAME_SIZE));
     user_mtu.send_mtu = size_t(device_addr.cast<double>("send_frame_size", udp_simple::mtu));
 
     try{
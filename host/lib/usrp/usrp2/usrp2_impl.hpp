@@ -52,6 +52,8 @@ static const double mimo_clock_delay_usrp2_rev4 = 4.18e-9;
 static const double mimo_clock_delay_usrp_n2xx = 4.10e-9;
 static const size_t mimo_clock_sync_delay_cycles = 138;
 static const size_t USRP2_SRAM_BYTES = size_t(1 << 20);
+//The largest RX frame the FPGA buffers, when one DSP streams at a time
+static const size_t USRP2_MAX_RECV_FRAME_SIZE = 4000;
 static const uint32_t USRP2_TX_ASYNC_SID = 2;
 static const uint32_t USRP2_RX_SID_BASE = 3;
 static const std::string USRP2_EEPROM_MAP_KEY = "N100";
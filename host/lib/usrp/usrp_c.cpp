@@ -68,12 +68,20 @@ struct uhd_tx_streamer {
     size_t usrp_index;
     size_t streamer_index;
     std::string last_error;
+    bool last_error_set;
+    /* Cached at get_tx_stream() time for the streaming calls */
+    uhd::tx_streamer *streamer;
+    size_t num_channels;
 };
 
 struct uhd_rx_streamer {
     size_t usrp_index;
     size_t streamer_index;
     std::string last_error;
+    bool last_error_set;
+    /* Cached at get_rx_stream() time for the streaming calls */
+    uhd::rx_streamer *streamer;
+    size_t num_channels;
 };
 
 /* Not public: We use this for our internal registry */
@@ -102,6 +110,10 @@ uhd_error uhd_rx_streamer_make(uhd_rx_streamer_handle* h){
     UHD_SAFE_C(
         boost::mutex::scoped_lock(_rx_streamer_make_mutex);
         (*h) = new uhd_rx_streamer;
+        (*h)->last_error = "None";
+        (*h)->last_error_set = false;
+        (*h)->streamer = NULL;
+        (*h)->num_channels = 0;
     )
 }
 
@@ -116,14 +128,14 @@ uhd_error uhd_rx_streamer_free(uhd_rx_streamer_handle* h){
 
 uhd_error uhd_rx_streamer_num_channels(uhd_rx_streamer_handle h,
                                        size_t *num_channels_out){
-    UHD_SAFE_C_SAVE_ERROR(h,
+    UHD_SAFE_C_SAVE_STREAM_ERROR(h,
         *num_channels_out = RX_STREAMER(h)->get_num_channels();
     )
 }
 
 uhd_error uhd_rx_streamer_max_num_samps(uhd_rx_streamer_handle h,
                                         size_t *max_num_samps_out){
-    UHD_SAFE_C_SAVE_ERROR(h,
+    UHD_SAFE_C_SAVE_STREAM_ERROR(h,
         *max_num_samps_out = RX_STREAMER(h)->get_max_num_samps();
     )
 }
@@ -137,9 +149,9 @@ uhd_error uhd_rx_streamer_recv(
     bool one_packet,
     size_t *items_recvd
 ){
-    UHD_SAFE_C_SAVE_ERROR(h,
-        uhd::rx_streamer::buffs_type buffs_cpp(buffs, RX_STREAMER(h)->get_num_channels());
-        *items_recvd = RX_STREAMER(h)->recv(buffs_cpp, samps_per_buff, (*md)->rx_metadata_cpp, timeout, one_packet);
+    UHD_SAFE_C_SAVE_STREAM_ERROR(h,
+        uhd::rx_streamer::buffs_type buffs_cpp(buffs, h->num_channels);
+        *items_recvd = h->streamer->recv(buffs_cpp, samps_per_buff, (*md)->rx_metadata_cpp, timeout, one_packet);
     )
 }
 
@@ -147,7 +159,7 @@ uhd_error uhd_rx_streamer_issue_stream_cmd(
     uhd_rx_streamer_handle h,
     const uhd_stream_cmd_t *stream_cmd
 ){
-    UHD_SAFE_C_SAVE_ERROR(h,
+    UHD_SAFE_C_SAVE_STREAM_ERROR(h,
         RX_STREAMER(h)->issue_stream_cmd(stream_cmd_c_to_cpp(stream_cmd));
     )
 }
@@ -157,7 +169,7 @@ uhd_error uhd_rx_streamer_last_error(
     char* error_out,
     size_t strbuffer_len
 ){
-    UHD_SAFE_C_SAVE_ERROR(h,
+    UHD_SAFE_C(
         memset(error_out, '\0', strbuffer_len);
         strncpy(error_out, h->last_error.c_str(), strbuffer_len);
     )
@@ -173,6 +185,10 @@ uhd_error uhd_tx_streamer_make(
     UHD_SAFE_C(
         boost::mutex::scoped_lock lock(_tx_streamer_make_mutex);
         (*h) = new uhd_tx_streamer;
+        (*h)->last_error = "None";
+        (*h)->last_error_set = false;
+        (*h)->streamer = NULL;
+        (*h)->num_channels = 0;
     )
 }
 
@@ -191,7 +207,7 @@ uhd_error uhd_tx_streamer_num_channels(
     uhd_tx_streamer_handle h,
     size_t *num_channels_out
 ){
-    UHD_SAFE_C_SAVE_ERROR(h,
+    UHD_SAFE_C_SAVE_STREAM_ERROR(h,
         *num_channels_out = TX_STREAMER(h)->get_num_channels();
     )
 }
@@ -200,7 +216,7 @@ uhd_error uhd_tx_streamer_max_num_samps(
     uhd_tx_streamer_handle h,
     size_t *max_num_samps_out
 ){
-    UHD_SAFE_C_SAVE_ERROR(h,
+    UHD_SAFE_C_SAVE_STREAM_ERROR(h,
         *max_num_samps_out = TX_STREAMER(h)->get_max_num_samps();
     )
 }
@@ -213,9 +229,9 @@ uhd_error uhd_tx_streamer_send(
     double timeout,
     size_t *items_sent
 ){
-    UHD_SAFE_C_SAVE_ERROR(h,
-        uhd::tx_streamer::buffs_type buffs_cpp(buffs, TX_STREAMER(h)->get_num_channels());
-        *items_sent = TX_STREAMER(h)->send(
+    UHD_SAFE_C_SAVE_STREAM_ERROR(h,
+        uhd::tx_streamer::buffs_type buffs_cpp(buffs, h->num_channels);
+        *items_sent = h->streamer->send(
             buffs_cpp,
             samps_per_buff,
             (*md)->tx_metadata_cpp,
@@ -230,7 +246,7 @@ uhd_error uhd_tx_streamer_recv_async_msg(
     const double timeout,
     bool *valid
 ){
-    UHD_SAFE_C_SAVE_ERROR(h,
+    UHD_SAFE_C_SAVE_STREAM_ERROR(h,
         *valid = TX_STREAMER(h)->recv_async_msg((*md)->async_metadata_cpp, timeout);
     )
 }
@@ -337,6 +353,8 @@ uhd_error uhd_usrp_get_rx_stream(
         );
         h_s->usrp_index     = h_u->usrp_index;
         h_s->streamer_index = usrp.rx_streamers.size() - 1;
+        h_s->streamer       = usrp.rx_streamers.back().get();
+        h_s->num_channels   = h_s->streamer->get_num_channels();
     )
 }
 
@@ -359,6 +377,8 @@ uhd_error uhd_usrp_get_tx_stream(
         );
         h_s->usrp_index     = h_u->usrp_index;
         h_s->streamer_index = usrp.tx_streamers.size() - 1;
+        h_s->streamer       = usrp.tx_streamers.back().get();
+        h_s->num_channels   = h_s->streamer->get_num_channels();
     )
 }
 
@@ -35,10 +35,14 @@ x300_adc_ctrl::~x300_adc_ctrl(void){
 class x300_adc_ctrl_impl : public x300_adc_ctrl
 {
 public:
-    x300_adc_ctrl_impl(uhd::spi_iface::sptr iface, const size_t slaveno):
-        _iface(iface), _slaveno(slaveno)
+    x300_adc_ctrl_impl(uhd::spi_iface::sptr iface, const size_t slaveno,
+            const bool warm_start, const bool keep_powered):
+        _iface(iface), _slaveno(slaveno), _keep_powered(keep_powered), _shadow_only(warm_start)
     {
+        //On a warm start the ADC still holds the configuration from init(),
+        //so only the register shadow is populated.
         init();
+        _shadow_only = false;
     }
 
     void init()
@@ -119,6 +123,7 @@ public:
 
     ~x300_adc_ctrl_impl(void)
     {
+        if (_keep_powered) return;
         _ads62p48_regs.power_down = ads62p48_regs_t::POWER_DOWN_GLOBAL;
         UHD_SAFE_CALL
         (
@@ -130,9 +135,12 @@ private:
     ads62p48_regs_t _ads62p48_regs;
     uhd::spi_iface::sptr _iface;
     const size_t _slaveno;
+    const bool _keep_powered;
+    bool _shadow_only;
 
     void send_ads62p48_reg(uint8_t addr)
     {
+        if (_shadow_only) return;
         uint16_t reg = _ads62p48_regs.get_write_reg(addr);
         _iface->write_spi(_slaveno, spi_config_t::EDGE_FALL, reg, 16);
     }
@@ -141,7 +149,8 @@ private:
 /***********************************************************************
  * Public make function for the ADC control
  **********************************************************************/
-x300_adc_ctrl::sptr x300_adc_ctrl::make(uhd::spi_iface::sptr iface, const size_t slaveno)
+x300_adc_ctrl::sptr x300_adc_ctrl::make(uhd::spi_iface::sptr iface, const size_t slaveno,
+        const bool warm_start, const bool keep_powered)
 {
-    return sptr(new x300_adc_ctrl_impl(iface, slaveno));
+    return sptr(new x300_adc_ctrl_impl(iface, slaveno, warm_start, keep_powered));
 }
@@ -33,9 +33,12 @@ public:
      * Make a codec control for the ADC.
      * \param iface a pointer to the interface object
      * \param spiface the interface to spi
+     * \param warm_start the ADC is already configured, do not reset it
+     * \param keep_powered do not power down the ADC on destruction
      * \return a new codec control object
      */
-    static sptr make(uhd::spi_iface::sptr iface, const size_t slaveno);
+    static sptr make(uhd::spi_iface::sptr iface, const size_t slaveno,
+            const bool warm_start = false, const bool keep_powered = false);
 
     virtual double set_gain(const double &) = 0;
 
@@ -25,6 +25,7 @@
 #include <stdexcept>
 #include <cmath>
 #include <cstdlib>
+#include <vector>
 
 static const double X300_REF_CLK_OUT_RATE  = 10e6;
 static const uint16_t X300_MAX_CLKOUT_DIV = 1045;
@@ -70,18 +71,25 @@ public:
         const size_t hw_rev,
         const double master_clock_rate,
         const double dboard_clock_rate,
-        const double system_ref_rate):
+        const double system_ref_rate,
+        const bool warm_start):
         _spiface(spiface),
         _slaveno(slaveno),
         _hw_rev(hw_rev),
         _master_clock_rate(master_clock_rate),
         _dboard_clock_rate(dboard_clock_rate),
-        _system_ref_rate(system_ref_rate)
+        _system_ref_rate(system_ref_rate),
+        _shadow_only(warm_start),
+        _batch_writes(false)
     {
+        //On a warm start, the LMK is already running with the configuration
+        //init() computes, so only the register shadow is populated.
         init();
+        _shadow_only = false;
     }
 
     void reset_clocks() {
+        _batch_writes = true;
         _lmk04816_regs.RESET = lmk04816_regs_t::RESET_RESET;
         this->write_regs(0);
         _lmk04816_regs.RESET = lmk04816_regs_t::RESET_NO_RESET;
@@ -92,6 +100,7 @@ public:
             this->write_regs(i);
         }
         sync_clocks();
+        this->write_batch();
     }
 
     void sync_clocks(void) {
@@ -235,8 +244,21 @@ public:
     }
 
     void write_regs(uint8_t addr) {
+        if (_shadow_only) return;
         uint32_t data = _lmk04816_regs.get_reg(addr);
-        _spiface->write_spi(_slaveno, spi_config_t::EDGE_RISE, data,32);
+        if (_batch_writes) {
+            _batch.push_back(data);
+        } else {
+            _spiface->write_spi(_slaveno, spi_config_t::EDGE_RISE, data,32);
+        }
+    }
+
+    //! Send the writes queued since _batch_writes was set, in one SPI batch
+    void write_batch() {
+        _batch_writes = false;
+        if (_batch.empty()) return;
+        _spiface->write_spi_batch(_slaveno, spi_config_t::EDGE_RISE, _batch, 32);
+        _batch.clear();
     }
 
     double set_clock_delay(const x300_clock_which_t which, const double delay_ns, const bool resync = true) {
@@ -606,7 +628,9 @@ private:
         uint16_t dboard_div = static_cast<uint16_t>(
             std::ceil(_vco_freq / _dboard_clock_rate));
 
-        /* Reset the LMK clock controller. */
+        /* Reset the LMK clock controller. The whole programming sequence
+         * is queued and sent as one batch at the end. */
+        _batch_writes = true;
         _lmk04816_regs.RESET = lmk04816_regs_t::RESET_RESET;
         this->write_regs(0);
         _lmk04816_regs.RESET = lmk04816_regs_t::RESET_NO_RESET;
@@ -726,6 +750,7 @@ private:
         }
 
         this->sync_clocks();
+        this->write_batch();
     }
 
     const spi_iface::sptr   _spiface;
@@ -737,6 +762,9 @@ private:
     lmk04816_regs_t         _lmk04816_regs;
     double                  _vco_freq;
     x300_clk_delays         _delays;
+    bool                    _shadow_only;
+    bool                    _batch_writes;
+    std::vector<uint32_t>   _batch;
 };
 
 x300_clock_ctrl::sptr x300_clock_ctrl::make(uhd::spi_iface::sptr spiface,
@@ -744,7 +772,8 @@ x300_clock_ctrl::sptr x300_clock_ctrl::make(uhd::spi_iface::sptr spiface,
         const size_t hw_rev,
         const double master_clock_rate,
         const double dboard_clock_rate,
-        const double system_ref_rate) {
+        const double system_ref_rate,
+        const bool warm_start) {
     return sptr(new x300_clock_ctrl_impl(spiface, slaveno, hw_rev,
-                master_clock_rate, dboard_clock_rate, system_ref_rate));
+                master_clock_rate, dboard_clock_rate, system_ref_rate, warm_start));
 }
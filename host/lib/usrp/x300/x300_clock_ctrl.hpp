@@ -44,12 +44,17 @@ public:
 
     virtual ~x300_clock_ctrl(void) = 0;
 
+    /*! Make a clock control for the LMK04816.
+     * \param warm_start true if the LMK already runs the configuration
+     *        implied by the other arguments; it is then not reprogrammed
+     */
     static sptr make(uhd::spi_iface::sptr spiface,
             const size_t slaveno,
             const size_t hw_rev,
             const double master_clock_rate,
             const double dboard_clock_rate,
-            const double system_ref_rate);
+            const double system_ref_rate,
+            const bool warm_start = false);
 
     /*! Get the master clock rate of the device.
      * \return the clock frequency in Hz
@@ -29,6 +29,10 @@
 
 using namespace uhd;
 
+//Every status poll is two SPI reads, each a round trip, so the PLL lock
+//and the backend sync are seen as soon as the DAC reports them
+static const boost::posix_time::microseconds X300_DAC_POLL_INTERVAL(100);
+
 #define write_ad9146_reg(addr, data) \
     _iface->write_spi(_slaveno, spi_config_t::EDGE_RISE, ((addr) << 8) | (data), 16)
 #define read_ad9146_reg(addr) \
@@ -44,18 +48,31 @@ x300_dac_ctrl::~x300_dac_ctrl(void){
 class x300_dac_ctrl_impl : public x300_dac_ctrl
 {
 public:
-    x300_dac_ctrl_impl(uhd::spi_iface::sptr iface, const size_t slaveno, const double refclk):
-        _iface(iface), _slaveno(slaveno), _refclk(refclk)
+    x300_dac_ctrl_impl(uhd::spi_iface::sptr iface, const size_t slaveno, const double refclk,
+            const bool warm_start, const bool keep_powered):
+        _iface(iface), _slaveno(slaveno), _refclk(refclk), _keep_powered(keep_powered)
     {
         //Power up all DAC subsystems
         write_ad9146_reg(0x01, 0x10); //Up: I DAC, Q DAC, Receiver, Voltage Ref, Clocks
         write_ad9146_reg(0x02, 0x00); //No extended delays. Up: Voltage Ref, PLL, DAC, FIFO, Filters
 
+        if (warm_start) {
+            //The DAC was left configured and synchronized by a previous session.
+            //Only fall back to a full reset if it is no longer locked.
+            try {
+                _check_pll();
+                _check_dac_sync();
+                return;
+            } catch (const uhd::runtime_error &) {
+                UHD_MSG(warning) << "x300_dac_ctrl: DAC lost its configuration, resetting it." << std::endl;
+            }
+        }
         reset();
     }
 
     ~x300_dac_ctrl_impl(void)
     {
+        if (_keep_powered) return;
         UHD_SAFE_CALL
         (
             //Power down all DAC subsystems
@@ -203,7 +220,7 @@ public:
                 throw uhd::runtime_error("x300_dac_ctrl: timeout waiting for DAC PLL to lock");
             if (reg_6 & (1 << 7))               // Lock lost?
                 write_ad9146_reg(0x06, 0xC0);   // Clear PLL event flags
-            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+            boost::this_thread::sleep(X300_DAC_POLL_INTERVAL);
         }
     }
 
@@ -215,7 +232,6 @@ public:
         const time_spec_t exit_time = time_spec_t::get_system_time() + time_spec_t(1.0);
         while (true)
         {
-            boost::this_thread::sleep(boost::posix_time::milliseconds(1));  // wait for sync to complete
             const size_t reg_12 = read_ad9146_reg(0x12);    // Sync Status (Expect bit 7 = 0, bit 6 = 1)
             const size_t reg_6 = read_ad9146_reg(0x06);     // Event Flags (Expect bit 5 = 0 and bit 4 = 1)
             if ((((reg_12 >> 6) & 0x3) == 0x1) && (((reg_6 >> 4) & 0x3) == 0x1))
@@ -228,6 +244,7 @@ public:
             if (reg_12 & (1 << 7))              // Sync acquired and lost?
                 write_ad9146_reg(0x10, 0xC7);   // Enable SYNC mode. Falling edge sync. Averaging set to 128.
 #endif
+            boost::this_thread::sleep(X300_DAC_POLL_INTERVAL);  // wait for sync to complete
         }
     }
 
@@ -266,12 +283,14 @@ private:
     uhd::spi_iface::sptr _iface;
     const size_t _slaveno;
     const double _refclk;
+    const bool _keep_powered;
 };
 
 /***********************************************************************
  * Public make function for the DAC control
  **********************************************************************/
-x300_dac_ctrl::sptr x300_dac_ctrl::make(uhd::spi_iface::sptr iface, const size_t slaveno, const double clock_rate)
+x300_dac_ctrl::sptr x300_dac_ctrl::make(uhd::spi_iface::sptr iface, const size_t slaveno, const double clock_rate,
+        const bool warm_start, const bool keep_powered)
 {
-    return sptr(new x300_dac_ctrl_impl(iface, slaveno, clock_rate));
+    return sptr(new x300_dac_ctrl_impl(iface, slaveno, clock_rate, warm_start, keep_powered));
 }
@@ -33,9 +33,12 @@ public:
      * Make a codec control for the DAC.
      * \param iface a pointer to the interface object
      * \param spiface the interface to spi
+     * \param warm_start the DAC is already configured, only verify its sync
+     * \param keep_powered do not power down the DAC on destruction
      * \return a new codec control object
      */
-    static sptr make(uhd::spi_iface::sptr iface, const size_t slaveno, const double clock_rate);
+    static sptr make(uhd::spi_iface::sptr iface, const size_t slaveno, const double clock_rate,
+            const bool warm_start = false, const bool keep_powered = false);
 
     // ! Reset the DAC
     virtual void reset(void) = 0;
@@ -88,6 +88,13 @@ public:
         size_t num_bits
     );
 
+    void write_spi_batch(
+        unit_t unit,
+        const uhd::spi_config_t &config,
+        const std::vector<uint32_t> &data,
+        size_t num_bits
+    );
+
     uint32_t read_write_spi(
         unit_t unit,
         const uhd::spi_config_t &config,
@@ -50,6 +50,7 @@ extern "C" {
 #define X300_FW_SHMEM_ROUTE_MAP_ADDR 11
 #define X300_FW_SHMEM_ROUTE_MAP_LEN 12
 #define X300_FW_SHMEM_IDENT 13 // (13-39) EEPROM values in use
+#define X300_FW_SHMEM_INIT_STATE 40 // Signature of the last completed host initialization
 #define X300_FW_SHMEM_DEBUG 128
 #define X300_FW_SHMEM_ADDR(offset) X300_FW_SHMEM_BASE + (4 * (offset))
 
@@ -81,6 +82,9 @@ extern "C" {
 #define X300_FW_COMMS_FLAGS_ERROR      (1 << 1)
 #define X300_FW_COMMS_FLAGS_POKE32     (1 << 2)
 #define X300_FW_COMMS_FLAGS_PEEK32     (1 << 3)
+#define X300_FW_COMMS_FLAGS_MULTI      (1 << 4)
+
+#define X300_FW_COMMS_MAX_OPS          32
 
 #define X300_FPGA_PROG_FLAGS_ACK       (1 << 0)
 #define X300_FPGA_PROG_FLAGS_ERROR     (1 << 1)
@@ -127,6 +131,26 @@ typedef struct
     uint32_t data;
 } x300_fw_comms_t;
 
+//! One access of a multi-op request, flags is PEEK32 or POKE32
+typedef struct
+{
+    uint32_t flags;
+    uint32_t addr;
+    uint32_t data;
+} x300_fw_comms_op_t;
+
+/*!
+ * A multi-op request has the MULTI flag set and the number of ops in
+ * header.addr, only those ops are sent. The ops are run in order, and
+ * the reply is the request with the peek results in the data fields.
+ * Older firmware replies with the header only and runs no op.
+ */
+typedef struct
+{
+    x300_fw_comms_t header;
+    x300_fw_comms_op_t ops[X300_FW_COMMS_MAX_OPS];
+} x300_fw_comms_multi_t;
+
 typedef struct
 {
     uint32_t flags;
@@ -28,6 +28,7 @@
 #include "x300_regs.hpp"
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/thread/thread.hpp>
+#include <algorithm>
 
 using namespace uhd;
 using namespace uhd::niusrprio;
@@ -106,16 +107,109 @@ class x300_ctrl_iface_enet : public x300_ctrl_iface
 {
 public:
     x300_ctrl_iface_enet(uhd::transport::udp_simple::sptr udp, bool enable_errors = true):
-        x300_ctrl_iface(enable_errors), udp(udp), seq(0)
+        x300_ctrl_iface(enable_errors), udp(udp), seq(0), multi_ops(false)
     {
         try
         {
             this->peek32(0);
         }
         catch(...){}
+
+        //probe for multi-op requests, older firmware only echoes the header
+        try
+        {
+            boost::mutex::scoped_lock lock(reg_access);
+            transaction_t probe(transaction_t::PEEK32, 0);
+            multi_ops = this->__transact(&probe, 1);
+        }
+        catch(...){}
+    }
+
+    void transact(transactions_type &transactions)
+    {
+        if (not multi_ops) return x300_ctrl_iface::transact(transactions);
+
+        for (size_t first = 0; first < transactions.size(); first += X300_FW_COMMS_MAX_OPS)
+        {
+            const size_t num_ops = std::min<size_t>(transactions.size() - first, X300_FW_COMMS_MAX_OPS);
+            for (size_t i = 1; i <= num_retries; i++)
+            {
+                boost::mutex::scoped_lock lock(reg_access);
+                try
+                {
+                    if (this->__transact(&transactions[first], num_ops)) break;
+                    throw uhd::io_error("x300 fw transact - multi-op request not supported");
+                }
+                catch(const uhd::io_error &ex)
+                {
+                    std::string error_msg = str(boost::format(
+                        "x300 fw communication failure #%u\n%s") % i % ex.what());
+                    if (errors) UHD_MSG(error) << error_msg << std::endl;
+                    if (i == num_retries) throw uhd::io_error(error_msg);
+                }
+            }
+        }
     }
 
 protected:
+    /*!
+     * Run up to X300_FW_COMMS_MAX_OPS accesses with one request.
+     * \return false if the firmware does not know multi-op requests
+     */
+    bool __transact(transaction_t *ops, const size_t num_ops)
+    {
+        //load request struct
+        x300_fw_comms_multi_t request = x300_fw_comms_multi_t();
+        request.header.flags = uhd::htonx<uint32_t>(X300_FW_COMMS_FLAGS_ACK | X300_FW_COMMS_FLAGS_MULTI);
+        request.header.sequence = uhd::htonx<uint32_t>(seq++);
+        request.header.addr = uhd::htonx<uint32_t>(num_ops);
+        for (size_t i = 0; i < num_ops; i++)
+        {
+            switch (ops[i].op)
+            {
+            case transaction_t::POKE32:
+                request.ops[i].flags = uhd::htonx<uint32_t>(X300_FW_COMMS_FLAGS_POKE32);
+                request.ops[i].data = uhd::htonx(uint32_t(ops[i].data));
+                break;
+            case transaction_t::PEEK32:
+                request.ops[i].flags = uhd::htonx<uint32_t>(X300_FW_COMMS_FLAGS_PEEK32);
+                break;
+            default:
+                throw uhd::not_implemented_error("x300 fw transact - only 32 bit accesses");
+            }
+            request.ops[i].addr = uhd::htonx(ops[i].addr);
+        }
+        const size_t num_bytes = sizeof(x300_fw_comms_t) + num_ops*sizeof(x300_fw_comms_op_t);
+
+        //send request
+        __flush();
+        udp->send(boost::asio::buffer(&request, num_bytes));
+
+        //recv reply
+        x300_fw_comms_multi_t reply = x300_fw_comms_multi_t();
+        const size_t nbytes = udp->recv(boost::asio::buffer(&reply, sizeof(reply)), 1.0);
+        if (nbytes == 0) throw uhd::io_error("x300 fw transact - reply timed out");
+
+        //older firmware sends back the header without running the ops
+        const size_t flags = uhd::ntohx<uint32_t>(reply.header.flags);
+        if (nbytes == sizeof(x300_fw_comms_t) and not (flags & X300_FW_COMMS_FLAGS_ERROR)) return false;
+
+        //sanity checks
+        UHD_ASSERT_THROW(nbytes == num_bytes);
+        UHD_ASSERT_THROW(not (flags & X300_FW_COMMS_FLAGS_ERROR));
+        UHD_ASSERT_THROW(flags & X300_FW_COMMS_FLAGS_MULTI);
+        UHD_ASSERT_THROW(flags & X300_FW_COMMS_FLAGS_ACK);
+        UHD_ASSERT_THROW(reply.header.sequence == request.header.sequence);
+
+        //store the peek results
+        for (size_t i = 0; i < num_ops; i++)
+        {
+            UHD_ASSERT_THROW(reply.ops[i].addr == request.ops[i].addr);
+            if (ops[i].op == transaction_t::PEEK32) ops[i].data = uhd::ntohx<uint32_t>(reply.ops[i].data);
+        }
+        return true;
+    }
+
     virtual void __poke32(const wb_addr_type addr, const uint32_t data)
     {
         //load request struct
@@ -185,6 +279,7 @@ protected:
 private:
     uhd::transport::udp_simple::sptr udp;
     size_t seq;
+    bool multi_ops;
 };
 
 
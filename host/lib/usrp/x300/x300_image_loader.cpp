@@ -19,9 +19,13 @@
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <uhd/config.hpp>
 #include <uhd/device.hpp>
@@ -242,6 +246,97 @@ static UHD_INLINE void x300_bitswap(uint8_t *num){
     *num = ((*num & 0xAA) >> 1) | ((*num & 0x55) << 1);
 } 
 
+/*
+ * Prepares the image for the Ethernet load in its own thread, one sector
+ * at a time, so reading and swapping the image overlaps with the writes
+ * to the device.
+ */
+class x300_image_pipeline{
+public:
+    x300_image_pipeline(const x300_session_t &session):
+        _session(session),
+        // Round up to whole packets, the last one is padded with zeros
+        _data(((session.size + X300_PACKET_SIZE_BYTES - 1) / X300_PACKET_SIZE_BYTES) * X300_PACKET_SIZE_BYTES, 0),
+        _num_ready(0),
+        _done(false)
+    {
+        _thread = boost::thread(boost::bind(&x300_image_pipeline::run, this));
+    }
+
+    ~x300_image_pipeline(void){
+        _thread.interrupt();
+        _thread.join();
+    }
+
+    /*
+     * Wait until the packet at pos is ready and get its data.
+     */
+    const uint8_t* get_packet(const size_t pos){
+        boost::mutex::scoped_lock lock(_mutex);
+        while(_num_ready < pos + X300_PACKET_SIZE_BYTES and not _done){
+            _cond.wait(lock);
+        }
+        if(not _error.empty()) throw uhd::runtime_error(_error);
+        if(_num_ready < pos + X300_PACKET_SIZE_BYTES){
+            throw uhd::runtime_error("The FPGA image ended unexpectedly.");
+        }
+        return &_data[pos];
+    }
+
+private:
+    void run(void){
+        try{
+            std::ifstream image;
+            if(not _session.lvbitx) image.open(_session.filepath.c_str(), std::ios::binary);
+            for(size_t i = 0; i < _data.size(); i += X300_FLASH_SECTOR_SIZE){
+                boost::this_thread::interruption_point();
+                const size_t len = std::min<size_t>(X300_FLASH_SECTOR_SIZE, _data.size() - i);
+                const size_t image_len = std::min<size_t>(len, _session.size - std::min<size_t>(i, _session.size));
+                if(_session.lvbitx){
+                    memcpy(&_data[i], &_session.bitstream[i], image_len);
+                }
+                else{
+                    image.read((char*)&_data[i], image_len);
+                }
+
+                // Data must be bitswapped and byteswapped
+                for(size_t k = i; k < i + len; k++){
+                    x300_bitswap(&_data[k]);
+                }
+                for(size_t k = i; k < i + len; k += 2){
+                    uint16_t word;
+                    memcpy(&word, &_data[k], sizeof(word));
+                    word = htonx<uint16_t>(word);
+                    memcpy(&_data[k], &word, sizeof(word));
+                }
+
+                boost::mutex::scoped_lock lock(_mutex);
+                _num_ready = i + len;
+                _cond.notify_one();
+            }
+        }
+        catch(const boost::thread_interrupted &){
+            /* The load was stopped */
+        }
+        catch(const std::exception &e){
+            boost::mutex::scoped_lock lock(_mutex);
+            _error = std::string("Failed to read the FPGA image: ") + e.what();
+        }
+        boost::mutex::scoped_lock lock(_mutex);
+        _done = true;
+        _cond.notify_one();
+    }
+
+    const x300_session_t &_session;
+    std::vector<uint8_t> _data;
+    size_t _num_ready;
+    bool _done;
+    std::string _error;
+    boost::mutex _mutex;
+    boost::condition_variable _cond;
+    boost::thread _thread;
+};
+
 static void x300_ethernet_load(x300_session_t &session){
 
     // UDP receive buffer
@@ -268,9 +363,8 @@ static void x300_ethernet_load(x300_session_t &session){
         std::cout << "-- NOTE: Device is verifying the image it is receiving, increasing the loading time." << std::endl;
     }
 
-    size_t current_pos = 0;
     size_t sectors = (session.size / X300_FLASH_SECTOR_SIZE);
-    std::ifstream image(session.filepath.c_str(), std::ios::binary);
+    x300_image_pipeline image(session);
 
     // Each sector
     for(size_t i = 0; i < session.size; i += X300_FLASH_SECTOR_SIZE){
@@ -294,38 +388,18 @@ static void x300_ethernet_load(x300_session_t &session){
             pkt_out.index  = htonx<uint32_t>((j % X300_FLASH_SECTOR_SIZE) / 2);
             pkt_out.size   = htonx<uint32_t>(X300_PACKET_SIZE_BYTES / 2);
 
-            // Read next piece of image
-            memset(pkt_out.data8, 0, X300_PACKET_SIZE_BYTES);
-            if(session.lvbitx){
-                memcpy(pkt_out.data8, &session.bitstream[current_pos], X300_PACKET_SIZE_BYTES);
-                current_pos += X300_PACKET_SIZE_BYTES;
-            }
-            else{
-                image.read((char*)pkt_out.data8, X300_PACKET_SIZE_BYTES);
-            }
-
-            // Data must be bitswapped and byteswapped
-            for(size_t k = 0; k < X300_PACKET_SIZE_BYTES; k++){
-                x300_bitswap(&pkt_out.data8[k]);
-            }
-            for(size_t k = 0; k < (X300_PACKET_SIZE_BYTES/2); k++){
-                pkt_out.data16[k] = htonx<uint16_t>(pkt_out.data16[k]);
-            }
+            // Next piece of image, already swapped
+            memcpy(pkt_out.data8, image.get_packet(j), X300_PACKET_SIZE_BYTES);
 
             len = x300_send_and_recv(session.xport, flags, &pkt_out, session.data_in);
             if(len == 0){
-                if(!session.lvbitx) image.close();
                 throw uhd::runtime_error("Timed out waiting for reply from device.");
             }
             else if((ntohl(pkt_in->flags) & X300_FPGA_PROG_FLAGS_ERROR)){
-                if(!session.lvbitx) image.close();
                 throw uhd::runtime_error("Device reported an error.");
             }
         }
     }
-    if(!session.lvbitx){
-        image.close();
-    }
 
     std::cout << boost::format("\r-- Loading %s FPGA image: 100%% (%d/%d sectors)")
                  % session.fpga_type
@@ -334,7 +408,6 @@ static void x300_ethernet_load(x300_session_t &session){
              << std::endl;
 
     // Cleanup
-    if(!session.lvbitx) image.close();
     flags = (X300_FPGA_PROG_FLAGS_CLEANUP | X300_FPGA_PROG_FLAGS_ACK);
     pkt_out.sector = pkt_out.index = pkt_out.size = 0;
     memset(pkt_out.data8, 0, X300_PACKET_SIZE_BYTES);
@@ -20,8 +20,11 @@
 #include "x310_lvbitx.hpp"
 #include "x300_mb_eeprom.hpp"
 #include "apply_corrections.hpp"
+#include "broadcast_find.hpp"
+#include "db_eeprom_cache.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/asio.hpp>
+#include <uhd/utils/init_profile.hpp>
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/paths.hpp>
@@ -30,22 +33,31 @@
 #include <uhd/transport/if_addrs.hpp>
 #include <boost/foreach.hpp>
 #include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/assign/list_of.hpp>
 #include <uhd/transport/udp_zero_copy.hpp>
+#include <uhd/transport/xdp_zero_copy.hpp>
 #include <uhd/transport/udp_constants.hpp>
 #include <uhd/transport/zero_copy_recv_offload.hpp>
 #include <uhd/transport/nirio_zero_copy.hpp>
 #include <uhd/transport/nirio/niusrprio_session.h>
 #include <uhd/utils/platform.hpp>
+#include <uhd/version.hpp>
 #include <uhd/types/sid.hpp>
+#include <uhd/types/mac_addr.hpp>
 #include <fstream>
 
 #define NIUSRPRIO_DEFAULT_RPC_PORT "5444"
 
 #define X300_REV(x) ((x) - "A" + 1)
 
+//A lock status read is a round trip to the ZPU, so there is no point
+//in polling faster, but a lock is seen well before the next millisecond
+static const boost::posix_time::microseconds X300_CLK_LOCK_POLL_INTERVAL(100);
+
 using namespace uhd;
 using namespace uhd::usrp;
 using namespace uhd::rfnoc;
@@ -191,7 +203,13 @@ static device_addrs_t x300_find_pcie(const device_addr_t &hint, bool explicit_qu
         std::string resource_d(dev_info.resource_name);
         boost::to_upper(resource_d);
 
-        switch (x300_impl::get_mb_type_from_pcie(resource_d, rpc_port_name)) {
+        //The enumeration has the interface path already, asking the RPC
+        //server for it again would cost a connection per device
+        niriok_proxy::sptr kernel_proxy = dev_info.interface_path.empty() ?
+            niusrprio_session::create_kernel_proxy(resource_d, rpc_port_name) :
+            niriok_proxy::make_and_open(dev_info.interface_path);
+
+        switch (x300_impl::get_mb_type_from_pcie(kernel_proxy)) {
             case x300_impl::USRP_X300_MB:
                 new_addr["product"] = "X300";
                 break;
@@ -202,8 +220,6 @@ static device_addrs_t x300_find_pcie(const device_addr_t &hint, bool explicit_qu
                 continue;
         }
 
-        niriok_proxy::sptr kernel_proxy = niriok_proxy::make_and_open(dev_info.interface_path);
-
         //Attempt to read the name from the EEPROM and perform filtering.
         //This operation can throw due to compatibility mismatch.
         try
@@ -217,7 +233,7 @@ static device_addrs_t x300_find_pcie(const device_addr_t &hint, bool explicit_qu
 
             //Hold on to the registry mutex as long as zpu_ctrl is alive
             //to prevent any use by different threads while enumerating
-            boost::mutex::scoped_lock(pcie_zpu_iface_registry_mutex);
+            boost::mutex::scoped_lock lock(pcie_zpu_iface_registry_mutex);
 
             if (get_pcie_zpu_iface_registry().has_key(resource_d)) {
                 zpu_ctrl = get_pcie_zpu_iface_registry()[resource_d].lock();
@@ -270,6 +286,19 @@ static device_addrs_t x300_find_pcie(const device_addr_t &hint, bool explicit_qu
     return addrs;
 }
 
+//! Enumerate the PCIe devices from another thread
+static void x300_find_pcie_into(const device_addr_t &hint, device_addrs_t &addrs)
+{
+    try
+    {
+        addrs = x300_find_pcie(hint, false);
+    }
+    catch(const std::exception &ex)
+    {
+        UHD_MSG(error) << "X300 PCIe discovery error " << ex.what() << std::endl;
+    }
+}
+
 device_addrs_t x300_find(const device_addr_t &hint_)
 {
     //handle the multi-device discovery
@@ -319,20 +348,20 @@ device_addrs_t x300_find(const device_addr_t &hint_)
         return reply_addrs;
     }
 
-    if (!hint.has_key("resource"))
+    device_addrs_t pcie_addrs;
+    if (hint.has_key("resource"))
     {
+        pcie_addrs = x300_find_pcie(hint, true);
+    }
+    else
+    {
+        //enumerate the PCIe devices while the broadcasts wait for replies
+        boost::thread_group pcie_thread;
+        pcie_thread.create_thread(boost::bind(&x300_find_pcie_into, boost::cref(hint), boost::ref(pcie_addrs)));
+
         //otherwise, no address was specified, send a broadcast on each interface
-        BOOST_FOREACH(const if_addrs_t &if_addrs, get_if_addrs())
+        BOOST_FOREACH(device_addrs_t new_addrs, usrp::broadcast_find(hint, &x300_find))
         {
-            //avoid the loopback device
-            if (if_addrs.inet == asio::ip::address_v4::loopback().to_string()) continue;
-
-            //create a new hint with this broadcast address
-            device_addr_t new_hint = hint;
-            new_hint["addr"] = if_addrs.bcast;
-
-            //call discover with the new hint and append results
-            device_addrs_t new_addrs = x300_find(new_hint);
             //if we are looking for a serial, only add the one device with a matching serial
             if (hint.has_key("serial")) {
                 bool found_serial = false; //signal to break out of the interface loop
@@ -349,9 +378,9 @@ device_addrs_t x300_find(const device_addr_t &hint_)
                 addrs.insert(addrs.begin(), new_addrs.begin(), new_addrs.end());
             }
         }
+        pcie_thread.join_all();
     }
 
-    device_addrs_t pcie_addrs = x300_find_pcie(hint, hint.has_key("resource"));
     if (not pcie_addrs.empty()) addrs.insert(addrs.end(), pcie_addrs.begin(), pcie_addrs.end());
 
     return addrs;
@@ -395,6 +424,54 @@ static void x300_load_fw(wb_iface::sptr fw_reg_ctrl, const std::string &file_nam
     UHD_MSG(status) << " done!" << std::endl;
 }
 
+/***********************************************************************
+ * Multi-motherboard setup
+ **********************************************************************/
+typedef boost::function<void(const size_t, const device_addr_t &)> mb_setup_fn_t;
+
+//! Run one setup step of a motherboard, and keep its error for the caller
+static void run_mb_setup(
+        const mb_setup_fn_t &setup_fn,
+        const size_t mb_i,
+        const device_addr_t &dev_addr,
+        boost::shared_ptr<uhd::exception> &error
+) {
+    try {
+        setup_fn(mb_i, dev_addr);
+    } catch (const uhd::exception &ex) {
+        error.reset(ex.dynamic_clone());
+    } catch (const std::exception &ex) {
+        error.reset(new uhd::runtime_error(ex.what()));
+    } catch (...) {
+        error.reset(new uhd::runtime_error(str(
+            boost::format("Unknown error setting up motherboard %d") % mb_i
+        )));
+    }
+}
+
+/*!
+ * Run a setup step on all motherboards at the same time, and wait for
+ * all of them. The error of the lowest failing motherboard is rethrown.
+ */
+static void setup_all_mbs(const mb_setup_fn_t &setup_fn, const device_addrs_t &device_args)
+{
+    if (device_args.size() == 1) {
+        setup_fn(0, device_args[0]);
+        return;
+    }
+    std::vector<boost::shared_ptr<uhd::exception> > errors(device_args.size());
+    boost::thread_group threads;
+    for (size_t i = 0; i < device_args.size(); i++) {
+        threads.create_thread(boost::bind(
+            &run_mb_setup, setup_fn, i, boost::cref(device_args[i]), boost::ref(errors[i])
+        ));
+    }
+    threads.join_all();
+    BOOST_FOREACH(const boost::shared_ptr<uhd::exception> &error, errors) {
+        if (error) error->dynamic_throw();
+    }
+}
+
 x300_impl::x300_impl(const uhd::device_addr_t &dev_addr) 
     : device3_impl()
     , _sid_framer(0)
@@ -405,10 +482,18 @@ x300_impl::x300_impl(const uhd::device_addr_t &dev_addr)
 
     const device_addrs_t device_args = separate_device_addr(dev_addr);
     _mb.resize(device_args.size());
+    _max_frame_sizes.recv_frame_size = X300_10GE_DATA_FRAME_MAX_SIZE;
+    _max_frame_sizes.send_frame_size = X300_10GE_DATA_FRAME_MAX_SIZE;
+
+    // The motherboards are brought up at the same time. Only the RFNoC
+    // blocks are enumerated one board after the other, because that
+    // allocates SIDs and fills the block list in motherboard order.
+    setup_all_mbs(boost::bind(&x300_impl::setup_mb, this, _1, _2), device_args);
     for (size_t i = 0; i < device_args.size(); i++)
     {
-        this->setup_mb(i, device_args[i]);
+        this->setup_mb_blocks(i, device_args[i]);
     }
+    setup_all_mbs(boost::bind(&x300_impl::setup_radios, this, _1, _2), device_args);
 }
 
 void x300_impl::mboard_members_t::discover_eth(
@@ -513,11 +598,72 @@ void x300_impl::mboard_members_t::discover_eth(
         throw uhd::assertion_error("X300 Initialization Error: No ethernet interfaces specified.");
 }
 
+/*!
+ * Compute a signature of everything that goes into the clock and codec setup.
+ * It is stored in the firmware shared memory after a fast_reinit session has
+ * finished initializing, which does not survive an FPGA reload.
+ */
+static uint32_t get_init_signature(
+        wb_iface::sptr zpu_ctrl,
+        const std::string &fpga_image,
+        const size_t hw_rev,
+        const double master_clock_rate,
+        const double dboard_clock_rate,
+        const double system_ref_rate
+) {
+    size_t seed = 0;
+    boost::hash_combine(seed, uhd::get_version_string());
+    boost::hash_combine(seed, zpu_ctrl->peek32(SR_ADDR(SET0_BASE, ZPU_RB_COMPAT_NUM)));
+    boost::hash_combine(seed, zpu_ctrl->peek32(SR_ADDR(SET0_BASE, ZPU_RB_GIT_HASH)));
+    boost::hash_combine(seed, fpga_image);
+    boost::hash_combine(seed, hw_rev);
+    boost::hash_combine(seed, master_clock_rate);
+    boost::hash_combine(seed, dboard_clock_rate);
+    boost::hash_combine(seed, system_ref_rate);
+    boost::hash_combine(seed, X300_DEFAULT_CLOCK_SOURCE);
+    const uint32_t signature = uint32_t(seed ^ (uint64_t(seed) >> 32));
+    return (signature == 0) ? 1 : signature; //zero means "not initialized"
+}
+
+/***********************************************************************
+ * PCIe data frame sizes
+ **********************************************************************/
+//! Get the data frame size for one direction, bounded by the largest CHDR packet
+static size_t get_pcie_data_frame_size(
+    const device_addr_t &args, const std::string &key, const size_t default_frame_size
+) {
+    if (not args.has_key(key)) return default_frame_size;
+    const size_t requested = size_t(args.cast<double>(key, double(default_frame_size)));
+    // The DMA FIFOs move 8 byte elements
+    const size_t frame_size = std::min(requested, X300_PCIE_DATA_FRAME_MAX_SIZE) & ~size_t(7);
+    if (frame_size != requested) {
+        UHD_MSG(warning) << boost::format(
+            "You requested a %s of %u bytes, but PCIe DMA frames are multiples of 8 bytes, up to %u bytes. UHD will use %u bytes."
+        ) % key % requested % X300_PCIE_DATA_FRAME_MAX_SIZE % frame_size << std::endl;
+    }
+    return std::max<size_t>(frame_size, X300_PCIE_MSG_FRAME_SIZE);
+}
+
+/*!
+ * Get the number of data frames that keeps the buffer of the default frames.
+ * 512 frames of a multiple of 8 bytes fill whole 4 KiB pages, so the count
+ * is rounded down to a multiple of 512.
+ */
+static size_t get_pcie_data_num_frames(
+    const size_t frame_size, const size_t default_frame_size, const size_t default_num_frames
+) {
+    static const size_t FRAME_COUNT_ALIGN = 512;
+    const size_t num_frames = (default_num_frames * default_frame_size / frame_size)
+        / FRAME_COUNT_ALIGN * FRAME_COUNT_ALIGN;
+    return std::max(num_frames, FRAME_COUNT_ALIGN);
+}
+
 void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
 {
     const fs_path mb_path = "/mboards/"+boost::lexical_cast<std::string>(mb_i);
     mboard_members_t &mb = _mb[mb_i];
     mb.initialization_done = false;
+    init_profile::scoped_phase mb_phase("mboard", mb_i);
 
     std::vector<std::string> eth_addrs;
     // Not choosing eth0 based on resource might cause user issues
@@ -546,6 +692,7 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
 
     if (mb.xport_path == "nirio")
     {
+        init_profile::scoped_phase fpga_phase("mboard/fpga load", mb_i);
         nirio_status status = 0;
 
         std::string rpc_port_name(NIUSRPRIO_DEFAULT_RPC_PORT);
@@ -554,9 +701,12 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
         }
         UHD_MSG(status) << boost::format("Connecting to niusrpriorpc at localhost:%s...\n") % rpc_port_name;
 
+        //The session opens the kernel proxy, the motherboard type is read through it
+        mb.rio_fpga_interface.reset(new niusrprio_session(dev_addr["resource"], rpc_port_name));
+
         //Instantiate the correct lvbitx object
         nifpga_lvbitx::sptr lvbitx;
-        switch (get_mb_type_from_pcie(dev_addr["resource"], rpc_port_name)) {
+        switch (get_mb_type_from_pcie(mb.rio_fpga_interface->get_kernel_proxy())) {
             case USRP_X300_MB:
                 lvbitx.reset(new x300_lvbitx(dev_addr["fpga"]));
                 break;
@@ -570,23 +720,52 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
         }
         //Load the lvbitx onto the device
         UHD_MSG(status) << boost::format("Using LVBITX bitfile %s...\n") % lvbitx->get_bitfile_path();
-        mb.rio_fpga_interface.reset(new niusrprio_session(dev_addr["resource"], rpc_port_name));
         nirio_status_chain(mb.rio_fpga_interface->open(lvbitx, dev_addr.has_key("download-fpga")), status);
         nirio_status_to_exception(status, "x300_impl: Could not initialize RIO session.");
 
         //Tell the quirks object which FIFOs carry TX stream data
         const uint32_t tx_data_fifos[2] = {X300_RADIO_DEST_PREFIX_TX, X300_RADIO_DEST_PREFIX_TX + 3};
         mb.rio_fpga_interface->get_kernel_proxy()->get_rio_quirks().register_tx_streams(tx_data_fifos, 2);
-
-        _tree->create<size_t>(mb_path / "mtu/recv").set(X300_PCIE_RX_DATA_FRAME_SIZE);
-        _tree->create<size_t>(mb_path / "mtu/send").set(X300_PCIE_TX_DATA_FRAME_SIZE);
-        _tree->create<double>(mb_path / "link_max_rate").set(X300_MAX_RATE_PCIE);
     }
 
+    init_profile::scoped_phase phase("mboard/link", mb_i);
     BOOST_FOREACH(const std::string &key, dev_addr.keys())
     {
         if (key.find("recv") != std::string::npos) mb.recv_args[key] = dev_addr[key];
         if (key.find("send") != std::string::npos) mb.send_args[key] = dev_addr[key];
+        //AF_XDP data transports, see xdp_zero_copy::make()
+        if (key.find("xdp_") == 0) mb.recv_args[key] = mb.send_args[key] = dev_addr[key];
+        //PCIe message demuxer, see muxed_zero_copy_if::make()
+        if (key.find("mux_") == 0) mb.recv_args[key] = dev_addr[key];
+        //buffer pool memory options, see buffer_pool::make()
+        if (key.find("buff_") == 0) mb.recv_args[key] = mb.send_args[key] = dev_addr[key];
+        //UDP receive options, see udp_zero_copy::make()
+        if (key.find("udp_") == 0) mb.recv_args[key] = dev_addr[key];
+    }
+    if (dev_addr.has_key("latency_mode")) mb.recv_args["latency_mode"] = dev_addr["latency_mode"];
+
+    //The control transports do not share the data transport options. They
+    //get their own socket per block (Ethernet) or their own DMA channel and
+    //demux thread (PCIe), with higher priority defaults, which the ctrl_
+    //arguments override, e.g. ctrl_latency_mode=1 or ctrl_mux_recv_timeout=0.1.
+    mb.ctrl_args["udp_priority"] = boost::lexical_cast<std::string>(X300_CTRL_UDP_PRIORITY);
+    mb.ctrl_args["mux_role"] = "ctrl_demux";
+    BOOST_FOREACH(const std::string &key, mb.recv_args.keys())
+    {
+        if (key.find("mux_") == 0) mb.ctrl_args[key] = mb.recv_args[key];
+    }
+    BOOST_FOREACH(const std::string &key, dev_addr.keys())
+    {
+        if (key.find("ctrl_") == 0) mb.ctrl_args[key.substr(5)] = dev_addr[key];
+    }
+
+    if (mb.xport_path == "nirio") {
+        // Larger DMA frames mean fewer frames to acquire and release per sample
+        mb.pcie_recv_frame_size = get_pcie_data_frame_size(mb.recv_args, "recv_frame_size", X300_PCIE_RX_DATA_FRAME_SIZE);
+        mb.pcie_send_frame_size = get_pcie_data_frame_size(mb.send_args, "send_frame_size", X300_PCIE_TX_DATA_FRAME_SIZE);
+        _tree->create<size_t>(mb_path / "mtu/recv").set(mb.pcie_recv_frame_size);
+        _tree->create<size_t>(mb_path / "mtu/send").set(mb.pcie_send_frame_size);
+        _tree->create<double>(mb_path / "link_max_rate").set(X300_MAX_RATE_PCIE);
     }
 
     if (mb.xport_path == "eth" ) {
@@ -618,12 +797,13 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
         #endif
 
         // Detect the frame size on the path to the USRP
+        frame_size_t max_frame_sizes = req_max_frame_size;
         try {
             frame_size_t pri_frame_sizes = determine_max_frame_size(
                 eth_addrs.at(0), req_max_frame_size
             );
 
-            _max_frame_sizes = pri_frame_sizes;
+            max_frame_sizes = pri_frame_sizes;
             if (eth_addrs.size() > 1) {
                 frame_size_t sec_frame_sizes = determine_max_frame_size(
                     eth_addrs.at(1), req_max_frame_size
@@ -631,12 +811,12 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
 
                 // Choose the minimum of the max frame sizes
                 // to ensure we don't exceed any one of the links' MTU
-                _max_frame_sizes.recv_frame_size = std::min(
+                max_frame_sizes.recv_frame_size = std::min(
                     pri_frame_sizes.recv_frame_size,
                     sec_frame_sizes.recv_frame_size
                 );
 
-                _max_frame_sizes.send_frame_size = std::min(
+                max_frame_sizes.send_frame_size = std::min(
                     pri_frame_sizes.send_frame_size,
                     sec_frame_sizes.send_frame_size
                 );
@@ -646,11 +826,11 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
         }
 
         if ((mb.recv_args.has_key("recv_frame_size"))
-                && (req_max_frame_size.recv_frame_size > _max_frame_sizes.recv_frame_size)) {
+                && (req_max_frame_size.recv_frame_size > max_frame_sizes.recv_frame_size)) {
             UHD_MSG(warning)
                 << boost::format("You requested a receive frame size of (%lu) but your NIC's max frame size is (%lu).")
                 % req_max_frame_size.recv_frame_size
-                % _max_frame_sizes.recv_frame_size
+                % max_frame_sizes.recv_frame_size
                 << std::endl
                 << boost::format("Please verify your NIC's MTU setting using '%s' or set the recv_frame_size argument appropriately.")
                 % mtu_tool << std::endl
@@ -659,11 +839,11 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
         }
 
         if ((mb.recv_args.has_key("send_frame_size"))
-                && (req_max_frame_size.send_frame_size > _max_frame_sizes.send_frame_size)) {
+                && (req_max_frame_size.send_frame_size > max_frame_sizes.send_frame_size)) {
             UHD_MSG(warning)
                 << boost::format("You requested a send frame size of (%lu) but your NIC's max frame size is (%lu).")
                 % req_max_frame_size.send_frame_size
-                % _max_frame_sizes.send_frame_size
+                % max_frame_sizes.send_frame_size
                 << std::endl
                 << boost::format("Please verify your NIC's MTU setting using '%s' or set the send_frame_size argument appropriately.")
                 % mtu_tool << std::endl
@@ -671,15 +851,23 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
                 << std::endl;
         }
 
-        _tree->create<size_t>(mb_path / "mtu/recv").set(_max_frame_sizes.recv_frame_size);
-        _tree->create<size_t>(mb_path / "mtu/send").set(std::min(_max_frame_sizes.send_frame_size, X300_ETH_DATA_FRAME_MAX_TX_SIZE));
+        // All transports use the same frame sizes, so they have to fit the
+        // links of every motherboard
+        {
+            boost::mutex::scoped_lock lock(_setup_mutex);
+            _max_frame_sizes.recv_frame_size = std::min(_max_frame_sizes.recv_frame_size, max_frame_sizes.recv_frame_size);
+            _max_frame_sizes.send_frame_size = std::min(_max_frame_sizes.send_frame_size, max_frame_sizes.send_frame_size);
+        }
+
+        _tree->create<size_t>(mb_path / "mtu/recv").set(max_frame_sizes.recv_frame_size);
+        _tree->create<size_t>(mb_path / "mtu/send").set(std::min(max_frame_sizes.send_frame_size, X300_ETH_DATA_FRAME_MAX_TX_SIZE));
         _tree->create<double>(mb_path / "link_max_rate").set(X300_MAX_RATE_10GIGE);
     }
 
     //create basic communication
     UHD_MSG(status) << "Setup basic communication..." << std::endl;
     if (mb.xport_path == "nirio") {
-        boost::mutex::scoped_lock(pcie_zpu_iface_registry_mutex);
+        boost::mutex::scoped_lock lock(pcie_zpu_iface_registry_mutex);
         if (get_pcie_zpu_iface_registry().has_key(mb.get_pri_eth().addr)) {
             throw uhd::assertion_error("Someone else has a ZPU transport to the device open. Internal error!");
         } else {
@@ -695,10 +883,11 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
     if (not try_to_claim(mb.zpu_ctrl)) {
         throw uhd::runtime_error("Failed to claim device");
     }
-    mb.claimer_task = uhd::task::make(boost::bind(&x300_impl::claimer_loop, this, mb.zpu_ctrl));
+    mb.claimer_task = uhd::pooled_task::make(boost::bind(&x300_impl::claimer_loop, this, mb.zpu_ctrl), 1.0 /* second */);
 
     //extract the FW path for the X300
     //and live load fw over ethernet link
+    phase.next("mboard/firmware");
     if (dev_addr.has_key("fw"))
     {
         const std::string x300_fw_image = find_image_path(
@@ -709,6 +898,7 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
 
     //check compat numbers
     //check fpga compat before fw compat because the fw is a subset of the fpga image
+    phase.next("mboard/compat checks");
     this->check_fpga_compat(mb_path, mb);
     this->check_fw_compat(mb_path, mb.zpu_ctrl);
 
@@ -749,6 +939,7 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
     ////////////////////////////////////////////////////////////////////
     // setup the mboard eeprom
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/eeprom");
     UHD_MSG(status) << "Loading values from EEPROM..." << std::endl;
     x300_mb_eeprom_iface::sptr eeprom16 = x300_mb_eeprom_iface::make(mb.zpu_ctrl, mb.zpu_i2c);
     if (dev_addr.has_key("blank_eeprom"))
@@ -791,6 +982,7 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
     ////////////////////////////////////////////////////////////////////
     // determine routing based on address match
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/interfaces");
     if (mb.xport_path != "nirio") {
         // Discover ethernet interfaces
         mb.discover_eth(mb_eeprom, eth_addrs);
@@ -842,23 +1034,61 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
                 % mb.hw_rev));
     }
 
+    ////////////////////////////////////////////////////////////////////
+    // check for a warm restart
+    ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/clocking");
+    const double master_clock_rate = dev_addr.cast<double>("master_clock_rate", X300_DEFAULT_TICK_RATE);
+    const double dboard_clock_rate = dev_addr.cast<double>("dboard_clock_rate", X300_DEFAULT_DBOARD_CLK_RATE);
+    const double system_ref_rate = dev_addr.cast<double>("system_ref_rate", X300_DEFAULT_SYSREF_RATE);
+
+    //The ADC delay self-cal reprograms the LMK in ways we can't reproduce,
+    //so it always gets a full initialization.
+    mb.fast_reinit = dev_addr.has_key("fast_reinit")
+        and not dev_addr.has_key("self_cal_adc_delay")
+        and not recover_mb_eeprom;
+    mb.init_signature = get_init_signature(mb.zpu_ctrl, mb.loaded_fpga_image,
+        mb.hw_rev, master_clock_rate, dboard_clock_rate, system_ref_rate);
+    mb.warm_start = mb.fast_reinit
+        and mb.hw_rev > 4 //The LMK lock status is not reliable on older boards
+        and mb.zpu_ctrl->peek32(X300_FW_SHMEM_ADDR(X300_FW_SHMEM_INIT_STATE)) == mb.init_signature
+        and wait_for_clk_locked(mb, fw_regmap_t::clk_status_reg_t::LMK_LOCK, 0.0)
+        and wait_for_clk_locked(mb, fw_regmap_t::clk_status_reg_t::RADIO_CLK_LOCK, 0.0)
+        and wait_for_clk_locked(mb, fw_regmap_t::clk_status_reg_t::IDELAYCTRL_LOCK, 0.0);
+    //Whatever a previous session left behind is invalid until we are done
+    mb.zpu_ctrl->poke32(X300_FW_SHMEM_ADDR(X300_FW_SHMEM_INIT_STATE), 0);
+    _tree->create<bool>(mb_path / "fast_reinit" / "enabled").set(mb.fast_reinit);
+    _tree->create<bool>(mb_path / "fast_reinit" / "warm_start").set(mb.warm_start);
+
     ////////////////////////////////////////////////////////////////////
     // create clock control objects
     ////////////////////////////////////////////////////////////////////
-    UHD_MSG(status) << "Setup RF frontend clocking..." << std::endl;
+    UHD_MSG(status) << "Setup RF frontend clocking"
+                    << (mb.warm_start ? " (warm start)..." : "...") << std::endl;
 
-    //Initialize clock control registers. NOTE: This does not configure the LMK yet.
-    mb.clock = x300_clock_ctrl::make(mb.zpu_spi,
-        1 /*slaveno*/,
-        mb.hw_rev,
-        dev_addr.cast<double>("master_clock_rate", X300_DEFAULT_TICK_RATE),
-        dev_addr.cast<double>("dboard_clock_rate", X300_DEFAULT_DBOARD_CLK_RATE),
-        dev_addr.cast<double>("system_ref_rate", X300_DEFAULT_SYSREF_RATE));
+    {
+        init_profile::scoped_phase clocking_phase("mboard/clocking/lmk", mb_i);
+        //Initialize clock control registers. NOTE: This does not configure the LMK yet.
+        mb.clock = x300_clock_ctrl::make(mb.zpu_spi,
+            1 /*slaveno*/,
+            mb.hw_rev,
+            master_clock_rate,
+            dboard_clock_rate,
+            system_ref_rate,
+            mb.warm_start);
+
+        //On a warm start, the LMK and the FPGA clocking are still running off the
+        //internal reference, so only the lock check below is done.
+        if (mb.warm_start) {
+            mb.current_refclk_src = X300_DEFAULT_CLOCK_SOURCE;
+        }
 
-    //Initialize clock source to use internal reference and generate
-    //a valid radio clock. This may change after configuration is done.
-    //This will configure the LMK and wait for lock
-    update_clock_source(mb, X300_DEFAULT_CLOCK_SOURCE);
+        //Initialize clock source to use internal reference and generate
+        //a valid radio clock. This may change after configuration is done.
+        //This will configure the LMK and wait for lock
+        clocking_phase.next("mboard/clocking/lock");
+        update_clock_source(mb, X300_DEFAULT_CLOCK_SOURCE);
+    }
 
     ////////////////////////////////////////////////////////////////////
     // create clock properties
@@ -873,6 +1103,7 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
     ////////////////////////////////////////////////////////////////////
     // Create the GPSDO control
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/gpsdo");
     static const uint32_t dont_look_for_gpsdo = 0x1234abcdul;
 
     //otherwise if not disabled, look for the internal GPSDO
@@ -904,9 +1135,12 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
     ////////////////////////////////////////////////////////////////////
     //clear router?
     ////////////////////////////////////////////////////////////////////
+    phase.next("mboard/properties");
+    wb_iface::transactions_type clear_router;
     for (size_t i = 0; i < 512; i++) {
-        mb.zpu_ctrl->poke32(SR_ADDR(SETXB_BASE, i), 0);
+        clear_router.push_back(wb_iface::transaction_t(wb_iface::transaction_t::POKE32, SR_ADDR(SETXB_BASE, i), 0));
     }
+    mb.zpu_ctrl->transact(clear_router);
 
 
     ////////////////////////////////////////////////////////////////////
@@ -959,6 +1193,12 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
     _tree->create<sensor_value_t>(mb_path / "sensors" / "ref_locked")
         .set_publisher(boost::bind(&x300_impl::get_ref_locked, this, mb));
 
+}
+
+void x300_impl::setup_mb_blocks(const size_t mb_i, const uhd::device_addr_t &dev_addr)
+{
+    mboard_members_t &mb = _mb[mb_i];
+
     //////////////// RFNOC /////////////////
     const size_t n_rfnoc_blocks = mb.zpu_ctrl->peek32(SR_ADDR(SET0_BASE, ZPU_RB_NUM_CE));
     enumerate_rfnoc_blocks(
@@ -967,9 +1207,17 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
         X300_XB_DST_PCI + 1, /* base port */
         uhd::sid_t(X300_SRC_ADDR0, 0, X300_DST_ADDR + mb_i, 0),
         dev_addr,
-        mb.if_pkt_is_big_endian ? ENDIANNESS_BIG : ENDIANNESS_LITTLE
+        mb.if_pkt_is_big_endian ? ENDIANNESS_BIG : ENDIANNESS_LITTLE,
+        // The PCIe control transports are streams of one DMA channel
+        mb.xport_path != "nirio"
     );
     //////////////// RFNOC /////////////////
+}
+
+void x300_impl::setup_radios(const size_t mb_i, const uhd::device_addr_t &dev_addr)
+{
+    mboard_members_t &mb = _mb[mb_i];
+    init_profile::scoped_phase radios_phase("radios", mb_i);
 
     // If we have a radio, we must configure its codec control:
     const std::string radio_blockid_hint = str(boost::format("%d/Radio") % mb_i);
@@ -981,20 +1229,28 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
             radio_ids.resize(2);
         }
 
+        // The dboard EEPROMs are only read in full when they changed
+        init_profile::scoped_phase phase("radios/dboards", mb_i);
+        const mboard_eeprom_t mb_eeprom =
+            _tree->access<mboard_eeprom_t>(fs_path("/mboards") / mb_i / "eeprom").get();
+        const i2c_iface::sptr db_i2c = usrp::make_db_eeprom_cache(mb.zpu_i2c, mb_eeprom.get("serial", ""));
+
         BOOST_FOREACH(const rfnoc::block_id_t &id, radio_ids) {
             rfnoc::x300_radio_ctrl_impl::sptr radio(get_block_ctrl<rfnoc::x300_radio_ctrl_impl>(id));
             mb.radios.push_back(radio);
             radio->setup_radio(
-                    mb.zpu_i2c,
+                    db_i2c,
                     mb.clock,
                     dev_addr.has_key("ignore-cal-file"),
-                    dev_addr.has_key("self_cal_adc_delay")
+                    dev_addr.has_key("self_cal_adc_delay"),
+                    dev_addr.has_key("lazy_dboard_init")
             );
         }
 
         ////////////////////////////////////////////////////////////////////
         // ADC test and cal
         ////////////////////////////////////////////////////////////////////
+        phase.next("radios/adc cal");
         if (dev_addr.has_key("self_cal_adc_delay")) {
             rfnoc::x300_radio_ctrl_impl::self_cal_adc_xfer_delay(
                 mb.radios, mb.clock,
@@ -1005,7 +1261,7 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
             rfnoc::x300_radio_ctrl_impl::extended_adc_test(
                 mb.radios,
                 dev_addr.cast<double>("ext_adc_self_test", 30));
-        } else if (not dev_addr.has_key("recover_mb_eeprom")){
+        } else if (not dev_addr.has_key("recover_mb_eeprom") and not mb.warm_start) {
             for (size_t i = 0; i < mb.radios.size(); i++) {
                 mb.radios.at(i)->self_test_adc();
             }
@@ -1014,6 +1270,7 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
         ////////////////////////////////////////////////////////////////////
         // Synchronize times (dboard initialization can desynchronize them)
         ////////////////////////////////////////////////////////////////////
+        phase.next("radios/time sync");
         if (radio_ids.size() == 2) {
             this->sync_times(mb, mb.radios[0]->get_time_now());
         }
@@ -1022,6 +1279,10 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
         UHD_MSG(status) << "No Radio Block found. Assuming radio-less operation." << std::endl;
     } /* end of radio block(s) initialization */
 
+    //Let the next fast_reinit session know it can reuse this setup
+    if (mb.fast_reinit) {
+        mb.zpu_ctrl->poke32(X300_FW_SHMEM_ADDR(X300_FW_SHMEM_INIT_STATE), mb.init_signature);
+    }
     mb.initialization_done = true;
 }
 
@@ -1029,12 +1290,14 @@ x300_impl::~x300_impl(void)
 {
     try
     {
+        //the pooled streaming transports go before the links they use
+        release_stream_transports();
         BOOST_FOREACH(mboard_members_t &mb, _mb)
         {
             //kill the claimer task and unclaim the device
             mb.claimer_task.reset();
             {   //Critical section
-                boost::mutex::scoped_lock(pcie_zpu_iface_registry_mutex);
+                boost::mutex::scoped_lock lock(pcie_zpu_iface_registry_mutex);
                 release(mb.zpu_ctrl);
                 //If the process is killed, the entire registry will disappear so we
                 //don't need to worry about unclean shutdowns here.
@@ -1084,7 +1347,8 @@ static uhd::transport::muxed_zero_copy_if::sptr make_muxed_pcie_msg_xport
 (
     uhd::niusrprio::niusrprio_session::sptr rio_fpga_interface,
     uint32_t dma_channel_num,
-    size_t max_muxed_ports
+    size_t max_muxed_ports,
+    const uhd::device_addr_t &mux_hints
 ) {
     zero_copy_xport_params buff_args;
     buff_args.send_frame_size = X300_PCIE_MSG_FRAME_SIZE;
@@ -1095,7 +1359,57 @@ static uhd::transport::muxed_zero_copy_if::sptr make_muxed_pcie_msg_xport
     zero_copy_if::sptr base_xport = nirio_zero_copy::make(
         rio_fpga_interface, dma_channel_num,
         buff_args, uhd::device_addr_t());
-    return muxed_zero_copy_if::make(base_xport, extract_sid_from_pkt, max_muxed_ports);
+    //The DMA FIFOs release their frames in order, so they need no copies
+    uhd::device_addr_t hints = mux_hints;
+    if (not hints.has_key("mux_release_in_order")) hints["mux_release_in_order"] = "1";
+    return muxed_zero_copy_if::make(base_xport, extract_sid_from_pkt, max_muxed_ports, hints);
+}
+
+double x300_impl::mboard_members_t::get_eth_link_rate(const size_t eth_idx) const
+{
+    if (loaded_fpga_image == "HG") {
+        return (eth_conns[eth_idx].type == X300_IFACE_ETH0) ?
+            X300_MAX_RATE_1GIGE : X300_MAX_RATE_10GIGE;
+    } else if (loaded_fpga_image == "HA") {
+        return X300_MAX_RATE_1GIGE;
+    }
+    return X300_MAX_RATE_10GIGE;
+}
+
+size_t x300_impl::mboard_members_t::select_data_eth(
+        const xport_type_t xport_type,
+        const size_t next_idx,
+        const double link_rate
+) {
+    // Forget about the streams that have gone away
+    for (std::vector<eth_stream_t>::iterator it = eth_streams.begin(); it != eth_streams.end();) {
+        if (it->xport.expired()) {
+            it = eth_streams.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::vector<double> loads(eth_conns.size(), 0.0);
+    std::vector<size_t> num_streams(eth_conns.size(), 0);
+    BOOST_FOREACH(const eth_stream_t &stream, eth_streams) {
+        if (stream.xport_type == xport_type) {
+            loads[stream.eth_idx] += stream.link_rate;
+            num_streams[stream.eth_idx]++;
+        }
+    }
+
+    size_t best_idx = next_idx;
+    double best_load = (loads[next_idx] + link_rate) / get_eth_link_rate(next_idx);
+    for (size_t i = 1; i < eth_conns.size(); i++) {
+        const size_t eth_idx = (next_idx + i) % eth_conns.size();
+        const double load = (loads[eth_idx] + link_rate) / get_eth_link_rate(eth_idx);
+        if (load < best_load or (load == best_load and num_streams[eth_idx] < num_streams[best_idx])) {
+            best_idx = eth_idx;
+            best_load = load;
+        }
+    }
+    return best_idx;
 }
 
 uhd::both_xports_t x300_impl::make_transport(
@@ -1105,7 +1419,7 @@ uhd::both_xports_t x300_impl::make_transport(
 ) {
     const size_t mb_index = address.get_dst_addr() - X300_DST_ADDR;
     mboard_members_t &mb = _mb[mb_index];
-    const uhd::device_addr_t& xport_args = (xport_type == CTRL) ? uhd::device_addr_t() : args;
+    const uhd::device_addr_t& xport_args = (xport_type == CTRL) ? mb.ctrl_args : args;
     zero_copy_xport_params default_buff_args;
 
     both_xports_t xports;
@@ -1122,7 +1436,8 @@ uhd::both_xports_t x300_impl::make_transport(
                 mb.ctrl_dma_xport = make_muxed_pcie_msg_xport(
                     mb.rio_fpga_interface,
                     dma_channel_num,
-                    X300_PCIE_MAX_MUXED_CTRL_XPORTS);
+                    X300_PCIE_MAX_MUXED_CTRL_XPORTS,
+                    mb.ctrl_args);
             }
             //Create a virtual control transport
             xports.recv = mb.ctrl_dma_xport->make_stream(xports.recv_sid.get_dst());
@@ -1134,7 +1449,8 @@ uhd::both_xports_t x300_impl::make_transport(
                 mb.async_msg_dma_xport = make_muxed_pcie_msg_xport(
                     mb.rio_fpga_interface,
                     dma_channel_num,
-                    X300_PCIE_MAX_MUXED_ASYNC_XPORTS);
+                    X300_PCIE_MAX_MUXED_ASYNC_XPORTS,
+                    mb.recv_args);
             }
             //Create a virtual async message transport
             xports.recv = mb.async_msg_dma_xport->make_stream(xports.recv_sid.get_dst());
@@ -1142,27 +1458,41 @@ uhd::both_xports_t x300_impl::make_transport(
             //Transport for data stream
             default_buff_args.send_frame_size =
                 (xport_type == TX_DATA)
-                ? X300_PCIE_TX_DATA_FRAME_SIZE
+                ? mb.pcie_send_frame_size
                 : X300_PCIE_MSG_FRAME_SIZE;
 
             default_buff_args.recv_frame_size =
                 (xport_type == RX_DATA)
-                ? X300_PCIE_RX_DATA_FRAME_SIZE
+                ? mb.pcie_recv_frame_size
                 : X300_PCIE_MSG_FRAME_SIZE;
 
-			default_buff_args.num_send_frames =
-				(xport_type == TX_DATA)
-                ? X300_PCIE_TX_DATA_NUM_FRAMES
+            default_buff_args.num_send_frames =
+                (xport_type == TX_DATA)
+                ? get_pcie_data_num_frames(mb.pcie_send_frame_size, X300_PCIE_TX_DATA_FRAME_SIZE, X300_PCIE_TX_DATA_NUM_FRAMES)
                 : X300_PCIE_MSG_NUM_FRAMES;
 
             default_buff_args.num_recv_frames =
                 (xport_type == RX_DATA)
-                ? X300_PCIE_RX_DATA_NUM_FRAMES
+                ? get_pcie_data_num_frames(mb.pcie_recv_frame_size, X300_PCIE_RX_DATA_FRAME_SIZE, X300_PCIE_RX_DATA_NUM_FRAMES)
                 : X300_PCIE_MSG_NUM_FRAMES;
 
+            //The frame sizes were already bounded for the DMA FIFOs
+            device_addr_t data_xport_args = xport_args;
+            if (data_xport_args.has_key("recv_frame_size")) data_xport_args.pop("recv_frame_size");
+            if (data_xport_args.has_key("send_frame_size")) data_xport_args.pop("send_frame_size");
+
             xports.recv = nirio_zero_copy::make(
                 mb.rio_fpga_interface, dma_channel_num,
-                default_buff_args, xport_args);
+                default_buff_args, data_xport_args);
+
+            //Optionally move the DMA FIFO waits to a receive thread
+            if (xport_type == RX_DATA and xport_args.cast<int>("recv_offload", 0) != 0) {
+                xports.recv = zero_copy_recv_offload::make(
+                        xports.recv,
+                        X300_THREAD_BUFFER_TIMEOUT,
+                        xport_args
+                );
+            }
         }
 
         xports.send = xports.recv;
@@ -1183,12 +1513,18 @@ uhd::both_xports_t x300_impl::make_transport(
             xport_type == TX_DATA ? mb.next_tx_src_addr :
             xport_type == RX_DATA ? mb.next_rx_src_addr :
             mb.next_src_addr;
-        std::string interface_addr = mb.eth_conns[next_src_addr].addr;
+        // Data streams go on the least loaded link, if we know their rates
+        const bool is_data_xport = (xport_type == TX_DATA or xport_type == RX_DATA);
+        const double link_rate = args.cast<double>("link_rate", 0.0);
+        const size_t eth_idx = is_data_xport ?
+            mb.select_data_eth(xport_type, next_src_addr, link_rate) :
+            next_src_addr;
+        std::string interface_addr = mb.eth_conns[eth_idx].addr;
         const uint32_t xbar_src_addr =
-            next_src_addr==0 ? X300_SRC_ADDR0 : X300_SRC_ADDR1;
+            eth_idx==0 ? X300_SRC_ADDR0 : X300_SRC_ADDR1;
         const uint32_t xbar_src_dst =
-            mb.eth_conns[next_src_addr].type==X300_IFACE_ETH0 ? X300_XB_DST_E0 : X300_XB_DST_E1;
-        next_src_addr = (next_src_addr + 1) % mb.eth_conns.size();
+            mb.eth_conns[eth_idx].type==X300_IFACE_ETH0 ? X300_XB_DST_E0 : X300_XB_DST_E1;
+        next_src_addr = (eth_idx + 1) % mb.eth_conns.size();
 
         xports.send_sid = this->allocate_sid(mb, address, xbar_src_addr, xbar_src_dst);
         xports.recv_sid = xports.send_sid.reversed();
@@ -1274,23 +1610,47 @@ uhd::both_xports_t x300_impl::make_transport(
         //make a new transport - fpga has no idea how to talk to us on this yet
         udp_zero_copy::buff_params buff_params;
 
-        xports.recv = udp_zero_copy::make(
-                interface_addr,
-                BOOST_STRINGIZE(X300_VITA_UDP_PORT),
-                default_buff_args,
-                buff_params,
-                xport_args);
+        if (xport_args.has_key("xdp_iface")) {
+            //Data streams can bypass the kernel network stack
+            xports.recv = xdp_zero_copy::make(
+                    interface_addr,
+                    BOOST_STRINGIZE(X300_VITA_UDP_PORT),
+                    default_buff_args,
+                    xport_args);
+            //For the AF_XDP transport the buffer size is the size of the UMEM
+            buff_params.recv_buff_size = xports.recv->get_num_recv_frames() * xports.recv->get_recv_frame_size();
+            buff_params.send_buff_size = xports.recv->get_num_send_frames() * xports.recv->get_send_frame_size();
+        } else {
+            xports.recv = udp_zero_copy::make(
+                    interface_addr,
+                    BOOST_STRINGIZE(X300_VITA_UDP_PORT),
+                    default_buff_args,
+                    buff_params,
+                    xport_args);
+        }
 
         // Create a threaded transport for the receive chain only
         // Note that this shouldn't affect PCIe
         if (xport_type == RX_DATA) {
             xports.recv = zero_copy_recv_offload::make(
                     xports.recv,
-                    X300_THREAD_BUFFER_TIMEOUT
+                    X300_THREAD_BUFFER_TIMEOUT,
+                    xport_args
             );
         }
         xports.send = xports.recv;
 
+        if (is_data_xport) {
+            mboard_members_t::eth_stream_t stream;
+            stream.xport = xports.recv;
+            stream.xport_type = xport_type;
+            stream.eth_idx = eth_idx;
+            stream.link_rate = link_rate;
+            mb.eth_streams.push_back(stream);
+            UHD_LOG << "[X300] Data stream on " << interface_addr << ": "
+                << (link_rate / 1e6) << " MB/s" << std::endl;
+        }
+
         //For the UDP transport the buffer size if the size of the socket buffer
         //in the kernel
         xports.recv_buff_size = buff_params.recv_buff_size;
@@ -1353,6 +1713,103 @@ uhd::sid_t x300_impl::allocate_sid(
     return sid;
 }
 
+/***********************************************************************
+ * Device-to-device streaming
+ **********************************************************************/
+//! The MAC address of an ethernet interface, as stored in the mboard EEPROM
+static byte_vector_t get_eth_mac_addr(
+        const mboard_eeprom_t &mb_eeprom,
+        const x300_eth_iface_t iface
+) {
+    const std::string key = (iface == X300_IFACE_ETH0) ? "mac-addr0" : "mac-addr1";
+    if (not mb_eeprom.has_key(key)) {
+        throw uhd::lookup_error(str(boost::format(
+            "Can't route between motherboards: %s is not set in the mboard EEPROM.") % key
+        ));
+    }
+    return mac_addr_t::from_string(mb_eeprom[key]).to_bytes();
+}
+
+void x300_impl::route_between_devices(const uhd::sid_t &sid)
+{
+    if (sid.get_src_addr() < X300_DST_ADDR or sid.get_src_addr() - X300_DST_ADDR >= _mb.size()
+        or sid.get_dst_addr() < X300_DST_ADDR or sid.get_dst_addr() - X300_DST_ADDR >= _mb.size()
+        or sid.get_src_addr() == sid.get_dst_addr()) {
+        throw uhd::value_error(str(boost::format(
+            "Can't route %s: Source and destination must be two different motherboards.")
+            % sid.to_pp_string_hex()
+        ));
+    }
+    const size_t src_mb_i = sid.get_src_addr() - X300_DST_ADDR;
+    const size_t dst_mb_i = sid.get_dst_addr() - X300_DST_ADDR;
+    if (_mb[src_mb_i].xport_path != "eth" or _mb[dst_mb_i].xport_path != "eth") {
+        throw uhd::not_implemented_error(str(boost::format(
+            "Can't route %s: Streaming between motherboards requires both to be connected over Ethernet.")
+            % sid.to_pp_string_hex()
+        ));
+    }
+
+    // Data packets go from the source to the destination block, flow
+    // control responses come back the other way.
+    uhd::sid_t fc_sid = sid;
+    program_device_route(src_mb_i, dst_mb_i, sid);
+    program_device_route(dst_mb_i, src_mb_i, fc_sid.reversed());
+}
+
+void x300_impl::program_device_route(
+        const size_t from_mb_i,
+        const size_t to_mb_i,
+        const uhd::sid_t &sid
+) {
+    mboard_members_t &from_mb = _mb[from_mb_i];
+    mboard_members_t &to_mb = _mb[to_mb_i];
+    // The motherboards talk to each other on their primary interfaces, so
+    // these need to be on the same network (or cabled to each other).
+    const x300_eth_conn_t &local = from_mb.get_pri_eth();
+    const x300_eth_conn_t &remote = to_mb.get_pri_eth();
+    const byte_vector_t local_mac = get_eth_mac_addr(
+        _tree->access<mboard_eeprom_t>(fs_path("/mboards") / from_mb_i / "eeprom").get(), local.type
+    );
+    const byte_vector_t remote_mac = get_eth_mac_addr(
+        _tree->access<mboard_eeprom_t>(fs_path("/mboards") / to_mb_i / "eeprom").get(), remote.type
+    );
+    const uint32_t local_ip = asio::ip::address_v4::from_string(local.addr).to_ulong();
+    const uint32_t remote_ip = asio::ip::address_v4::from_string(remote.addr).to_ulong();
+    const size_t ethbase = (local.type == X300_IFACE_ETH0) ? ZPU_SR_ETHINT0 : ZPU_SR_ETHINT1;
+
+    // Program CAM entry for packets to the other motherboard. These don't
+    // match the XB_LOCAL address and are looked up in the lower half of the CAM.
+    from_mb.zpu_ctrl->poke32(SR_ADDR(SETXB_BASE, 0 + sid.get_dst_addr()),
+        (local.type == X300_IFACE_ETH0) ? X300_XB_DST_E0 : X300_XB_DST_E1);
+
+    // Program the ethernet framer, like the firmware does for host streams:
+    // The destination is looked up by the SID's destination address.
+    from_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, ethbase + ETH_FRAMER_SRC_MAC_HI),
+        (uint32_t(local_mac[0]) << 8) | (uint32_t(local_mac[1]) << 0));
+    from_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, ethbase + ETH_FRAMER_SRC_MAC_LO),
+        (uint32_t(local_mac[2]) << 24) | (uint32_t(local_mac[3]) << 16) |
+        (uint32_t(local_mac[4]) << 8) | (uint32_t(local_mac[5]) << 0));
+    from_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, ethbase + ETH_FRAMER_SRC_IP_ADDR), local_ip);
+    from_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, ethbase + ETH_FRAMER_SRC_UDP_PORT), X300_VITA_UDP_PORT);
+    from_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, ethbase + ETH_FRAMER_DST_RAM_ADDR), sid.get_dst_addr());
+    from_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, ethbase + ETH_FRAMER_DST_IP_ADDR), remote_ip);
+    from_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, ethbase + ETH_FRAMER_DST_UDP_MAC),
+        (uint32_t(X300_VITA_UDP_PORT) << 16) |
+        (uint32_t(remote_mac[0]) << 8) | (uint32_t(remote_mac[1]) << 0));
+    from_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, ethbase + ETH_FRAMER_DST_MAC_LO),
+        (uint32_t(remote_mac[2]) << 24) | (uint32_t(remote_mac[3]) << 16) |
+        (uint32_t(remote_mac[4]) << 8) | (uint32_t(remote_mac[5]) << 0));
+
+    // On the other side, the packets match the XB_LOCAL address and go to
+    // the block (CAM entry in the upper half).
+    to_mb.zpu_ctrl->poke32(SR_ADDR(SETXB_BASE, 256 + sid.get_dst_endpoint()), sid.get_dst_xbarport());
+    // Make sure the dispatcher passes CHDR packets on to the crossbar
+    to_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, (ZPU_SR_ETHINT0+8+3)), X300_VITA_UDP_PORT);
+    to_mb.zpu_ctrl->poke32(SR_ADDR(SET0_BASE, (ZPU_SR_ETHINT1+8+3)), X300_VITA_UDP_PORT);
+
+    UHD_LOG << "done device route config for sid " << sid << std::endl;
+}
+
 /***********************************************************************
  * clock and time control logic
  **********************************************************************/
@@ -1383,6 +1840,9 @@ void x300_impl::update_clock_source(mboard_members_t &mb, const std::string &sou
         }
         mb.fw_regmap->clock_ctrl_reg.flush();
 
+        //The clocking no longer matches what a fast_reinit session may reuse
+        mb.zpu_ctrl->poke32(X300_FW_SHMEM_ADDR(X300_FW_SHMEM_INIT_STATE), 0);
+
         //Reset the LMK to make sure it re-locks to the new reference
         mb.clock->reset_clocks();
     }
@@ -1475,7 +1935,7 @@ bool x300_impl::wait_for_clk_locked(mboard_members_t& mb, uint32_t which, double
     do {
         if (mb.fw_regmap->clock_status_reg.read(which)==1)
             return true;
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        boost::this_thread::sleep(X300_CLK_LOCK_POLL_INTERVAL);
     } while (boost::get_system_time() < timeout_time);
 
     //Check one last time
@@ -1519,10 +1979,10 @@ void x300_impl::set_mb_eeprom(i2c_iface::sptr i2c, const mboard_eeprom_t &mb_eep
  * claimer logic
  **********************************************************************/
 
-void x300_impl::claimer_loop(wb_iface::sptr iface)
+bool x300_impl::claimer_loop(wb_iface::sptr iface)
 {
     claim(iface);
-    boost::this_thread::sleep(boost::posix_time::milliseconds(1000)); //1 second
+    return false; //called again after the task period
 }
 
 x300_impl::claim_status_t x300_impl::claim_status(wb_iface::sptr iface)
@@ -1736,18 +2196,15 @@ void x300_impl::check_fpga_compat(const fs_path &mb_path, const mboard_members_t
         % ((git_hash & 0xF000000) ? "-dirty" : "")));
 }
 
-x300_impl::x300_mboard_t x300_impl::get_mb_type_from_pcie(const std::string& resource, const std::string& rpc_port)
+x300_impl::x300_mboard_t x300_impl::get_mb_type_from_pcie(niriok_proxy::sptr kernel_proxy)
 {
     x300_mboard_t mb_type = UNKNOWN;
 
     //Detect the PCIe product ID to distinguish between X300 and X310
     nirio_status status = NiRio_Status_Success;
     uint32_t pid;
-    niriok_proxy::sptr discovery_proxy =
-        niusrprio_session::create_kernel_proxy(resource, rpc_port);
-    if (discovery_proxy) {
-        nirio_status_chain(discovery_proxy->get_attribute(RIO_PRODUCT_NUMBER, pid), status);
-        discovery_proxy->close();
+    if (kernel_proxy) {
+        nirio_status_chain(kernel_proxy->get_attribute(RIO_PRODUCT_NUMBER, pid), status);
         if (nirio_status_not_fatal(status)) {
             //The PCIe ID -> MB mapping may be different from the EEPROM -> MB mapping
             switch (pid) {
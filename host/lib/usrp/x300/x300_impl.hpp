@@ -29,6 +29,7 @@
 #include <uhd/transport/udp_simple.hpp> //mtu
 #include "i2c_core_100_wb32.hpp"
 #include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <uhd/usrp/gps_ctrl.hpp>
 #include <uhd/transport/nirio/niusrprio_session.h>
 #include <uhd/transport/vrt_if_packet.hpp>
@@ -60,6 +61,9 @@ static const size_t X300_PCIE_RX_DATA_NUM_FRAMES        = 4096;
 static const size_t X300_PCIE_TX_DATA_FRAME_SIZE        = 4096;     //bytes
 static const size_t X300_PCIE_TX_DATA_NUM_FRAMES	    = 4096;
 static const size_t X300_PCIE_MSG_FRAME_SIZE            = 256;      //bytes
+//Larger data frames can be requested with recv_frame_size and send_frame_size, up to the
+//largest CHDR packet. The number of frames then shrinks to keep the buffer size.
+static const size_t X300_PCIE_DATA_FRAME_MAX_SIZE       = 8192;     //bytes
 static const size_t X300_PCIE_MSG_NUM_FRAMES            = 64;
 static const size_t X300_PCIE_MAX_CHANNELS              = 6;
 static const size_t X300_PCIE_MAX_MUXED_CTRL_XPORTS     = 32;
@@ -68,6 +72,7 @@ static const size_t X300_PCIE_MAX_MUXED_ASYNC_XPORTS    = 4;
 static const size_t X300_10GE_DATA_FRAME_MAX_SIZE   = 8000;     // CHDR packet size in bytes
 static const size_t X300_1GE_DATA_FRAME_MAX_SIZE    = 1472;     // CHDR packet size in bytes
 static const size_t X300_ETH_MSG_FRAME_SIZE         = uhd::transport::udp_simple::mtu;  //bytes
+static const int    X300_CTRL_UDP_PRIORITY          = 6;        //SO_PRIORITY of the control sockets, the highest without CAP_NET_ADMIN
 // MTU throttling for ethernet/TX (see above):
 static const size_t X300_ETH_DATA_FRAME_MAX_TX_SIZE = 8000;
 
@@ -127,7 +132,12 @@ class x300_impl : public uhd::usrp::device3_impl
 public:
 
     x300_impl(const uhd::device_addr_t &);
+    //! Bring up one motherboard, may run for all of them at the same time
     void setup_mb(const size_t which, const uhd::device_addr_t &);
+    //! Enumerate the RFNoC blocks of one motherboard, one board after the other
+    void setup_mb_blocks(const size_t which, const uhd::device_addr_t &);
+    //! Set up the radios of one motherboard, may run for all of them at the same time
+    void setup_radios(const size_t which, const uhd::device_addr_t &);
     ~x300_impl(void);
 
     // device claim functions
@@ -140,7 +150,7 @@ public:
     enum x300_mboard_t {
         USRP_X300_MB, USRP_X310_MB, UNKNOWN
     };
-    static x300_mboard_t get_mb_type_from_pcie(const std::string& resource, const std::string& rpc_port);
+    static x300_mboard_t get_mb_type_from_pcie(uhd::niusrprio::niriok_proxy::sptr kernel_proxy);
     static x300_mboard_t get_mb_type_from_eeprom(const uhd::usrp::mboard_eeprom_t& mb_eeprom);
 
 protected:
@@ -158,7 +168,7 @@ private:
     struct mboard_members_t
     {
         bool initialization_done;
-        uhd::task::sptr claimer_task;
+        uhd::pooled_task::sptr claimer_task;
         std::string xport_path;
 
         std::vector<x300_eth_conn_t> eth_conns;
@@ -176,8 +186,37 @@ private:
             return eth_conns[0];
         }
 
+        //! A data stream on one of the ethernet connections
+        struct eth_stream_t
+        {
+            boost::weak_ptr<uhd::transport::zero_copy_if> xport;
+            xport_type_t xport_type;
+            size_t eth_idx;
+            double link_rate; // bytes/s, 0 if unknown
+        };
+        std::vector<eth_stream_t> eth_streams;
+
+        //! Returns the max. rate of an ethernet connection in bytes/s
+        double get_eth_link_rate(const size_t eth_idx) const;
+
+        /*! Pick the ethernet connection for a new data stream
+         *
+         * Chooses the connection that has the lowest load (relative to its
+         * link rate) in the direction of the stream, once the new stream is
+         * added. Ties go to the connection with fewer streams, and then to
+         * the first one in round-robin order, starting at \p next_idx.
+         *
+         * \param link_rate The rate of the new stream in bytes/s, or 0 if unknown
+         */
+        size_t select_data_eth(
+                const xport_type_t xport_type,
+                const size_t next_idx,
+                const double link_rate);
+
         uhd::device_addr_t send_args;
         uhd::device_addr_t recv_args;
+        //! The transport hints of the control transports, see ctrl_ arguments
+        uhd::device_addr_t ctrl_args;
         bool if_pkt_is_big_endian;
         uhd::niusrprio::niusrprio_session::sptr  rio_fpga_interface;
 
@@ -198,12 +237,22 @@ private:
         size_t hw_rev;
         std::string current_refclk_src;
 
+        //! The user asked to reuse the clock and codec setup across sessions
+        bool fast_reinit;
+        //! The setup of a previous session is still valid and is being reused
+        bool warm_start;
+        //! Identifies the configuration this session sets up (see X300_FW_SHMEM_INIT_STATE)
+        uint32_t init_signature;
+
         std::vector<uhd::rfnoc::x300_radio_ctrl_impl::sptr> radios;
 
         // PCIe specific components:
 
         //! Maps SID -> DMA channel
         std::map<uint32_t, uint32_t> _dma_chan_pool;
+        //! The frame sizes of the data DMA channels
+        size_t pcie_recv_frame_size;
+        size_t pcie_send_frame_size;
         //! Control transport for one PCIe connection
         uhd::transport::muxed_zero_copy_if::sptr ctrl_dma_xport;
         //! Async message transport
@@ -218,7 +267,7 @@ private:
     std::vector<mboard_members_t> _mb;
 
     //task for periodically reclaiming the device from others
-    void claimer_loop(uhd::wb_iface::sptr);
+    bool claimer_loop(uhd::wb_iface::sptr);
 
     size_t _sid_framer;
 
@@ -233,6 +282,12 @@ private:
         const uhd::device_addr_t& args
     );
 
+    void route_between_devices(const uhd::sid_t &sid);
+    void program_device_route(
+        const size_t from_mb_i,
+        const size_t to_mb_i,
+        const uhd::sid_t &sid);
+
     struct frame_size_t
     {
         size_t recv_frame_size;
@@ -240,6 +295,9 @@ private:
     };
     frame_size_t _max_frame_sizes;
 
+    //! Protects the members that the motherboard setups share
+    boost::mutex _setup_mutex;
+
     /*!
      * Automatically determine the maximum frame size available by sending a UDP packet
      * to the device and see which packet sizes actually work. This way, we can take
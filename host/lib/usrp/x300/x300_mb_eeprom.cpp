@@ -143,17 +143,23 @@ public:
         x300_impl::claim_status_t status = x300_impl::claim_status(_wb);
         if (_compat_num >= X300_FW_SHMEM_IDENT_MIN_VERSION)
         {
-            // Get MB EEPROM data from firmware memory
+            // Get MB EEPROM data from firmware memory, all words in one batch
             if (num_bytes == 0) return bytes;
 
-            size_t bytes_read = 0;
-            for (size_t word = offset / 4; bytes_read < num_bytes; word++)
+            wb_iface::transactions_type words;
+            for (size_t word = offset / 4; word <= (offset + num_bytes - 1) / 4; word++)
             {
-                uint32_t value = byteswap(_wb->peek32(X300_FW_SHMEM_ADDR(X300_FW_SHMEM_IDENT + word)));
-                for (size_t byte = offset % 4; byte < 4 and bytes_read < num_bytes; byte++)
+                words.push_back(wb_iface::transaction_t(wb_iface::transaction_t::PEEK32,
+                    X300_FW_SHMEM_ADDR(X300_FW_SHMEM_IDENT + word)));
+            }
+            _wb->transact(words);
+
+            for (size_t i = 0; i < words.size(); i++)
+            {
+                uint32_t value = byteswap(uint32_t(words[i].data));
+                for (size_t byte = (i == 0) ? offset % 4 : 0; byte < 4 and bytes.size() < num_bytes; byte++)
                 {
                     bytes.push_back(uint8_t((value >> (byte * 8)) & 0xff));
-                    bytes_read++;
                 }
             }
         } else {
@@ -29,6 +29,7 @@
 #include <uhd/utils/math.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/function.hpp>
 #include <boost/date_time/posix_time/posix_time_io.hpp>
 
 using namespace uhd;
@@ -43,6 +44,7 @@ static const size_t IO_MASTER_RADIO = 0;
  ***************************************************************************/
 UHD_RFNOC_RADIO_BLOCK_CONSTRUCTOR(x300_radio_ctrl)
     , _ignore_cal_file(false)
+    , _warm_start(false)
 {
     UHD_RFNOC_BLOCK_TRACE() << "x300_radio_ctrl_impl::ctor() " << std::endl;
 
@@ -52,16 +54,24 @@ UHD_RFNOC_RADIO_BLOCK_CONSTRUCTOR(x300_radio_ctrl)
     _radio_type = (get_block_id().get_block_count() == 0) ? PRIMARY : SECONDARY;
     _radio_slot = (get_block_id().get_block_count() == 0) ? "A" : "B";
     _radio_clk_rate = _tree->access<double>("master_clock_rate").get();
+    const bool fast_reinit = _tree->exists("fast_reinit/enabled")
+        and _tree->access<bool>("fast_reinit/enabled").get();
+    _warm_start = fast_reinit and _tree->access<bool>("fast_reinit/warm_start").get();
 
     ////////////////////////////////////////////////////////////////////
     // Set up peripherals
     ////////////////////////////////////////////////////////////////////
     wb_iface::sptr ctrl = _get_ctrl(IO_MASTER_RADIO);
     _regs = boost::make_shared<radio_regmap_t>(_radio_type==PRIMARY?0:1);
+    if (_warm_start) {
+        //Don't glitch the running codecs when syncing the register defaults
+        _regs->misc_outs_reg.set(radio_regmap_t::misc_outs_reg_t::DAC_RESET_N, 1);
+        _regs->misc_outs_reg.set(radio_regmap_t::misc_outs_reg_t::DAC_ENABLED, 1);
+    }
     _regs->initialize(*ctrl, true);
 
     //Only Radio0 has the ADC/DAC reset bits. Those bits are reserved for Radio1
-    if (_radio_type==PRIMARY) {
+    if (_radio_type==PRIMARY and not _warm_start) {
         _regs->misc_outs_reg.set(radio_regmap_t::misc_outs_reg_t::ADC_RESET, 1);
         _regs->misc_outs_reg.set(radio_regmap_t::misc_outs_reg_t::DAC_RESET_N, 0);
         _regs->misc_outs_reg.flush();
@@ -77,8 +87,8 @@ UHD_RFNOC_RADIO_BLOCK_CONSTRUCTOR(x300_radio_ctrl)
     _spi = spi_core_3000::make(ctrl,
         radio_ctrl_impl::regs::sr_addr(radio_ctrl_impl::regs::SPI),
         radio_ctrl_impl::regs::RB_SPI);
-    _adc = x300_adc_ctrl::make(_spi, DB_ADC_SEN);
-    _dac = x300_dac_ctrl::make(_spi, DB_DAC_SEN, _radio_clk_rate);
+    _adc = x300_adc_ctrl::make(_spi, DB_ADC_SEN, _warm_start, fast_reinit);
+    _dac = x300_dac_ctrl::make(_spi, DB_DAC_SEN, _radio_clk_rate, _warm_start, fast_reinit);
 
     if (_radio_type==PRIMARY) {
         _fp_gpio = gpio_atr::gpio_atr_3000::make(ctrl, regs::sr_addr(regs::FP_GPIO), regs::RB_FP_GPIO);
@@ -325,9 +335,13 @@ void x300_radio_ctrl_impl::setup_radio(
         uhd::i2c_iface::sptr zpu_i2c,
         x300_clock_ctrl::sptr clock,
         bool ignore_cal_file,
-        bool verbose)
+        bool verbose,
+        bool lazy_dboard_init)
 {
-    _self_cal_adc_capture_delay(verbose);
+    //The IDELAY taps found by a previous session are still loaded on a warm start
+    if (not _warm_start) {
+        _self_cal_adc_capture_delay(verbose);
+    }
     _ignore_cal_file = ignore_cal_file;
 
     ////////////////////////////////////////////////////////////////////
@@ -405,8 +419,20 @@ void x300_radio_ctrl_impl::setup_radio(
     }
     UHD_ASSERT_THROW(rx_chan or tx_chan);
 
-    // Initialize the daughterboards now that frontend cores and connections exist
-    _db_manager->initialize_dboards();
+    // Initialize the daughterboards now that frontend cores and connections exist.
+    // In lazy mode, a frontend is initialized when it is first configured or streamed.
+    if (lazy_dboard_init) {
+        for (size_t i = 0; i < _rx_fe_map.size(); i++) {
+            _defer_frontend_init(db_path / "rx_frontends" / _rx_fe_map[i].db_fe_name,
+                uhd::RX_DIRECTION, _rx_fe_map[i].db_fe_name);
+        }
+        for (size_t i = 0; i < _tx_fe_map.size(); i++) {
+            _defer_frontend_init(db_path / "tx_frontends" / _tx_fe_map[i].db_fe_name,
+                uhd::TX_DIRECTION, _tx_fe_map[i].db_fe_name);
+        }
+    } else {
+        _db_manager->initialize_dboards();
+    }
 
     //now that dboard is created -- register into rx antenna event
     if (not _rx_fe_map.empty()) {
@@ -922,9 +948,54 @@ void x300_radio_ctrl_impl::_set_command_time(const time_spec_t &spec, const size
 /****************************************************************************
  * Helpers
  ***************************************************************************/
+void x300_radio_ctrl_impl::_defer_frontend_init(
+        const fs_path &fe_path,
+        const uhd::direction_t dir,
+        const std::string &fe
+) {
+    //The desired subscribers run before the value is coerced and published,
+    //so the frontend is fully initialized by the time the write takes effect.
+    const boost::function<void(void)> init_fe =
+        boost::bind(&x300_radio_ctrl_impl::_init_frontend, this, dir, fe);
+    if (_tree->exists(fe_path / "freq" / "value")) {
+        _tree->access<double>(fe_path / "freq" / "value").add_desired_subscriber(boost::bind(init_fe));
+    }
+    if (_tree->exists(fe_path / "bandwidth" / "value")) {
+        _tree->access<double>(fe_path / "bandwidth" / "value").add_desired_subscriber(boost::bind(init_fe));
+    }
+    if (_tree->exists(fe_path / "antenna" / "value")) {
+        _tree->access<std::string>(fe_path / "antenna" / "value").add_desired_subscriber(boost::bind(init_fe));
+    }
+    if (_tree->exists(fe_path / "enabled")) {
+        _tree->access<bool>(fe_path / "enabled").add_desired_subscriber(boost::bind(init_fe));
+    }
+    if (_tree->exists(fe_path / "gains")) {
+        BOOST_FOREACH(const std::string &name, _tree->list(fe_path / "gains")) {
+            if (_tree->exists(fe_path / "gains" / name / "value")) {
+                _tree->access<double>(fe_path / "gains" / name / "value").add_desired_subscriber(boost::bind(init_fe));
+            }
+        }
+    }
+}
+
+void x300_radio_ctrl_impl::_init_frontend(const uhd::direction_t dir, const std::string &fe)
+{
+    _db_manager->initialize_frontend(dir, fe);
+}
+
 bool x300_radio_ctrl_impl::check_radio_config()
 {
     UHD_RFNOC_BLOCK_TRACE() << "x300_radio_ctrl_impl::check_radio_config() " << std::endl;
+    //Frontends that are streamed must be initialized, even if they were never configured
+    for (size_t chan = 0; chan < _get_num_radios(); chan++) {
+        if (_rx_fe_map.count(chan) and _is_streamer_active(uhd::RX_DIRECTION, chan)) {
+            _init_frontend(uhd::RX_DIRECTION, _rx_fe_map.at(chan).db_fe_name);
+        }
+        if (_tx_fe_map.count(chan) and _is_streamer_active(uhd::TX_DIRECTION, chan)) {
+            _init_frontend(uhd::TX_DIRECTION, _tx_fe_map.at(chan).db_fe_name);
+        }
+    }
+
     const fs_path rx_fe_path = fs_path("dboards" / _radio_slot / "rx_frontends");
     for (size_t chan = 0; chan < _get_num_radios(); chan++) {
         if (_tree->exists(rx_fe_path / _rx_fe_map.at(chan).db_fe_name / "enabled")) {
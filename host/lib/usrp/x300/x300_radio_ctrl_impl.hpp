@@ -76,7 +76,8 @@ public:
         uhd::i2c_iface::sptr zpu_i2c,
         x300_clock_ctrl::sptr clock,
         bool ignore_cal_file,
-        bool verbose
+        bool verbose,
+        bool lazy_dboard_init = false
     );
 
     void reset_codec();
@@ -152,6 +153,10 @@ private:
 
     void _update_atr_leds(const std::string &rx_ant, const size_t chan);
 
+    void _defer_frontend_init(const uhd::fs_path &fe_path, const uhd::direction_t dir, const std::string &fe);
+
+    void _init_frontend(const uhd::direction_t dir, const std::string &fe);
+
     void _self_cal_adc_capture_delay(bool print_status);
 
     void _check_adc(const uint32_t val);
@@ -199,6 +204,9 @@ private: // members
 
     bool _ignore_cal_file;
 
+    //! The codecs and ADC capture delays were left configured by a previous session
+    bool _warm_start;
+
 }; /* class radio_ctrl_impl */
 
 }} /* namespace uhd::rfnoc */
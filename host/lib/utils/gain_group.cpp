@@ -22,15 +22,18 @@
 #include <uhd/exception.hpp>
 #include <boost/foreach.hpp>
 #include <boost/bind.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <boost/thread/mutex.hpp>
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 using namespace uhd;
 
 static bool compare_by_step_size(
-    const size_t &rhs, const size_t &lhs, std::vector<gain_fcns_t> &fcns
+    const size_t &rhs, const size_t &lhs, const std::vector<gain_range_t> &ranges
 ){
-    return fcns.at(rhs).get_range().step() > fcns.at(lhs).get_range().step();
+    return ranges.at(rhs).step() > ranges.at(lhs).step();
 }
 
 /*!
@@ -63,9 +66,24 @@ gain_group::~gain_group(void){
 /***********************************************************************
  * gain group implementation
  **********************************************************************/
+//! The most gain steps to keep a distribution table for
+static const size_t MAX_TABLE_SIZE = 8192;
+
+static bool ranges_equal(const gain_range_t &lhs, const gain_range_t &rhs){
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); i++){
+        if (lhs[i].start() != rhs[i].start()) return false;
+        if (lhs[i].stop() != rhs[i].stop()) return false;
+        if (lhs[i].step() != rhs[i].step()) return false;
+    }
+    return true;
+}
+
 class gain_group_impl : public gain_group{
 public:
-    gain_group_impl(void){
+    gain_group_impl(void):
+        _table_valid(false), _max_step(0), _table_start(0), _table_step(0)
+    {
         /*NOP*/
     }
 
@@ -97,58 +115,33 @@ public:
     void set_value(double gain, const std::string &name){
         if (not name.empty()) return _name_to_fcns.get(name).set_value(gain);
 
-        std::vector<gain_fcns_t> all_fcns = get_all_fcns();
-        if (all_fcns.size() == 0) return; //nothing to set!
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_all_fcns.size() == 0) return; //nothing to set!
+        update_table();
 
-        //get the max step size among the gains
-        double max_step = 0;
-        BOOST_FOREACH(const gain_fcns_t &fcns, all_fcns){
-            max_step = std::max(max_step, fcns.get_range().step());
+        //the gains on the steps of the overall range come from the table
+        const double *gain_bucket = NULL;
+        if (not _table.empty()){
+            const double index = boost::math::round((gain - _table_start)/_table_step);
+            const size_t num_entries = _table.size()/_all_fcns.size();
+            if (index >= 0 and index < double(num_entries)
+                and std::abs(gain - (_table_start + index*_table_step)) <= _table_step*1e-6
+            ){
+                gain_bucket = &_table[size_t(index)*_all_fcns.size()];
+            }
         }
-
-        //create gain bucket to distribute power
-        std::vector<double> gain_bucket;
-
-        //distribute power according to priority (round to max step)
-        double gain_left_to_distribute = gain;
-        BOOST_FOREACH(const gain_fcns_t &fcns, all_fcns){
-            const gain_range_t range = fcns.get_range();
-            gain_bucket.push_back(floor_step(uhd::clip(
-                gain_left_to_distribute, range.start(), range.stop()
-            ), max_step));
-            gain_left_to_distribute -= gain_bucket.back();
+        if (gain_bucket == NULL){
+            distribute(gain, &_gain_bucket.front());
+            gain_bucket = &_gain_bucket.front();
         }
 
-        //get a list of indexes sorted by step size large to small
-        std::vector<size_t> indexes_step_size_dec;
-        for (size_t i = 0; i < all_fcns.size(); i++){
-            indexes_step_size_dec.push_back(i);
-        }
-        std::sort(
-            indexes_step_size_dec.begin(), indexes_step_size_dec.end(),
-            boost::bind(&compare_by_step_size, _1, _2, all_fcns)
-        );
-        UHD_ASSERT_THROW(
-            all_fcns.at(indexes_step_size_dec.front()).get_range().step() >=
-            all_fcns.at(indexes_step_size_dec.back()).get_range().step()
-        );
-
-        //distribute the remainder (less than max step)
-        //fill in the largest step sizes first that are less than the remainder
-        BOOST_FOREACH(size_t i, indexes_step_size_dec){
-            const gain_range_t range = all_fcns.at(i).get_range();
-            double additional_gain = floor_step(uhd::clip(
-                gain_bucket.at(i) + gain_left_to_distribute, range.start(), range.stop()
-            ), range.step()) - gain_bucket.at(i);
-            gain_bucket.at(i) += additional_gain;
-            gain_left_to_distribute -= additional_gain;
-        }
-        UHD_LOGV(often) << "gain_left_to_distribute " << gain_left_to_distribute << std::endl;
-
-        //now write the bucket out to the individual gain values
-        for (size_t i = 0; i < gain_bucket.size(); i++){
-            UHD_LOGV(often) << i << ": " << gain_bucket.at(i) << std::endl;
-            all_fcns.at(i).set_value(gain_bucket.at(i));
+        //now write the bucket out to the individual gain values,
+        //the elements which already have their value are not written
+        for (size_t i = 0; i < _all_fcns.size(); i++){
+            UHD_LOGV(often) << i << ": " << gain_bucket[i] << std::endl;
+            if (_all_fcns[i].get_value() != gain_bucket[i]){
+                _all_fcns[i].set_value(gain_bucket[i]);
+            }
         }
     }
 
@@ -165,8 +158,13 @@ public:
             //ensure the name name is unique and non-empty
             return register_fcns(name + "_", gain_fcns, priority);
         }
+        boost::mutex::scoped_lock lock(_mutex);
         _registry[priority].push_back(gain_fcns);
         _name_to_fcns[name] = gain_fcns;
+        _all_fcns = get_all_fcns();
+        _ranges.resize(_all_fcns.size());
+        _gain_bucket.resize(_all_fcns.size());
+        _table_valid = false;
     }
 
 private:
@@ -180,8 +178,104 @@ private:
         return all_fcns;
     }
 
+    /*!
+     * Rebuild the distribution table when a range changed.
+     * The table holds the gain of each element for every step of the
+     * overall range, so setting a gain on a step is a lookup.
+     */
+    void update_table(void){
+        bool changed = not _table_valid;
+        for (size_t i = 0; i < _all_fcns.size(); i++){
+            const gain_range_t range = _all_fcns[i].get_range();
+            if (changed or not ranges_equal(range, _ranges[i])){
+                _ranges[i] = range;
+                changed = true;
+            }
+        }
+        if (not changed) return;
+        _table_valid = true;
+
+        //get the max step size among the gains
+        _max_step = 0;
+        BOOST_FOREACH(const gain_range_t &range, _ranges){
+            _max_step = std::max(_max_step, range.step());
+        }
+
+        //get a list of indexes sorted by step size large to small
+        _indexes_step_size_dec.clear();
+        for (size_t i = 0; i < _ranges.size(); i++){
+            _indexes_step_size_dec.push_back(i);
+        }
+        std::sort(
+            _indexes_step_size_dec.begin(), _indexes_step_size_dec.end(),
+            boost::bind(&compare_by_step_size, _1, _2, boost::cref(_ranges))
+        );
+        UHD_ASSERT_THROW(
+            _ranges.at(_indexes_step_size_dec.front()).step() >=
+            _ranges.at(_indexes_step_size_dec.back()).step()
+        );
+
+        //the steps of the overall range, see get_range()
+        double overall_min = 0, overall_max = 0, overall_step = 0;
+        BOOST_FOREACH(const gain_range_t &range, _ranges){
+            overall_min += range.start();
+            overall_max += range.stop();
+            if (overall_step == 0) overall_step = range.step();
+            overall_step = std::min(overall_step, range.step());
+        }
+        _table.clear();
+        if (overall_step <= 0) return;
+        const double num_entries = std::floor((overall_max - overall_min)/overall_step + 0.5) + 1;
+        if (num_entries > MAX_TABLE_SIZE) return;
+
+        _table_start = overall_min;
+        _table_step = overall_step;
+        _table.resize(size_t(num_entries)*_ranges.size());
+        for (size_t i = 0; i < size_t(num_entries); i++){
+            distribute(_table_start + double(i)*_table_step, &_table[i*_ranges.size()]);
+        }
+    }
+
+    //! Distribute a gain across the elements by priority and step size
+    void distribute(const double gain, double *gain_bucket){
+        //distribute power according to priority (round to max step)
+        double gain_left_to_distribute = gain;
+        for (size_t i = 0; i < _ranges.size(); i++){
+            const gain_range_t &range = _ranges[i];
+            gain_bucket[i] = floor_step(uhd::clip(
+                gain_left_to_distribute, range.start(), range.stop()
+            ), _max_step);
+            gain_left_to_distribute -= gain_bucket[i];
+        }
+
+        //distribute the remainder (less than max step)
+        //fill in the largest step sizes first that are less than the remainder
+        BOOST_FOREACH(size_t i, _indexes_step_size_dec){
+            const gain_range_t &range = _ranges[i];
+            double additional_gain = floor_step(uhd::clip(
+                gain_bucket[i] + gain_left_to_distribute, range.start(), range.stop()
+            ), range.step()) - gain_bucket[i];
+            gain_bucket[i] += additional_gain;
+            gain_left_to_distribute -= additional_gain;
+        }
+        UHD_LOGV(often) << "gain_left_to_distribute " << gain_left_to_distribute << std::endl;
+    }
+
     uhd::dict<size_t, std::vector<gain_fcns_t> > _registry;
     uhd::dict<std::string, gain_fcns_t> _name_to_fcns;
+
+    boost::mutex _mutex;
+    //! The gain function sets in order (highest priority first)
+    std::vector<gain_fcns_t> _all_fcns;
+    //! The ranges of the table, in the same order
+    std::vector<gain_range_t> _ranges;
+    bool _table_valid;
+    double _max_step;
+    std::vector<size_t> _indexes_step_size_dec;
+    //! The gains of the elements for each step, one row per step
+    std::vector<double> _table;
+    double _table_start, _table_step;
+    std::vector<double> _gain_bucket;
 };
 
 /***********************************************************************
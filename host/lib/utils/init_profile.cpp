@@ -0,0 +1,167 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/utils/init_profile.hpp>
+#include <uhd/utils/static.hpp>
+#include <boost/atomic.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+using namespace uhd::init_profile;
+
+typedef boost::chrono::steady_clock clock_type;
+
+struct init_profile_state{
+    init_profile_state(void): enabled(false) {}
+
+    boost::atomic<bool> enabled;
+    boost::mutex mutex;
+    clock_type::time_point start;
+    std::vector<phase_t> phases;
+};
+
+UHD_SINGLETON_FCN(init_profile_state, get_state)
+
+static double seconds_since_start(const clock_type::time_point &time){
+    const boost::chrono::duration<double> elapsed = time - get_state().start;
+    return elapsed.count();
+}
+
+static bool phase_start_lt(const phase_t &lhs, const phase_t &rhs){
+    return lhs.start < rhs.start;
+}
+
+/***********************************************************************
+ * Recording
+ **********************************************************************/
+void uhd::init_profile::start(void){
+    init_profile_state &state = get_state();
+    boost::mutex::scoped_lock lock(state.mutex);
+    state.phases.clear();
+    state.start = clock_type::now();
+    state.enabled = true;
+}
+
+void uhd::init_profile::stop(void){
+    get_state().enabled = false;
+}
+
+bool uhd::init_profile::is_enabled(void){
+    return get_state().enabled;
+}
+
+scoped_phase::scoped_phase(const std::string &name, const size_t mboard):
+    _name(name), _mboard(mboard), _active(is_enabled())
+{
+    if (_active) _start = clock_type::now();
+}
+
+scoped_phase::~scoped_phase(void){
+    this->end();
+}
+
+void scoped_phase::next(const std::string &name){
+    this->end();
+    _name = name;
+    _active = is_enabled();
+    if (_active) _start = clock_type::now();
+}
+
+void scoped_phase::end(void){
+    if (not _active) return;
+    _active = false;
+    const clock_type::time_point now = clock_type::now();
+    init_profile_state &state = get_state();
+    boost::mutex::scoped_lock lock(state.mutex);
+    //a phase which outlived its profile is not reported in the next one
+    if (not state.enabled or _start < state.start) return;
+    phase_t phase;
+    phase.name = _name;
+    phase.mboard = _mboard;
+    phase.start = seconds_since_start(_start);
+    phase.duration = boost::chrono::duration<double>(now - _start).count();
+    phase.count = 1;
+    state.phases.push_back(phase);
+}
+
+/***********************************************************************
+ * Reporting
+ **********************************************************************/
+std::vector<phase_t> uhd::init_profile::get_phases(void){
+    init_profile_state &state = get_state();
+    std::vector<phase_t> phases;
+    {
+        boost::mutex::scoped_lock lock(state.mutex);
+        phases = state.phases;
+    }
+    //phases are recorded when they end, so the outer ones come last
+    std::stable_sort(phases.begin(), phases.end(), &phase_start_lt);
+    return phases;
+}
+
+std::vector<phase_t> uhd::init_profile::get_breakdown(const size_t mboard){
+    std::vector<phase_t> breakdown;
+    BOOST_FOREACH(const phase_t &phase, get_phases()){
+        if (phase.mboard != mboard) continue;
+        std::vector<phase_t>::iterator it = breakdown.begin();
+        while (it != breakdown.end() and it->name != phase.name) ++it;
+        if (it == breakdown.end()){
+            breakdown.push_back(phase);
+        }
+        else{
+            it->duration += phase.duration;
+            it->count += phase.count;
+        }
+    }
+    return breakdown;
+}
+
+std::string uhd::init_profile::to_pp_string(void){
+    std::set<size_t> mboards;
+    BOOST_FOREACH(const phase_t &phase, get_phases()){
+        mboards.insert(phase.mboard);
+    }
+
+    std::ostringstream ss;
+    ss << "Device initialization profile" << std::endl;
+    ss << boost::format("  %10s %10s  %s") % "start ms" % "time ms" % "phase" << std::endl;
+    //ALL_MBOARDS is the largest index, so it is moved to the front
+    std::vector<size_t> order(mboards.begin(), mboards.end());
+    if (mboards.count(ALL_MBOARDS)){
+        std::rotate(order.begin(), order.end() - 1, order.end());
+    }
+    BOOST_FOREACH(const size_t mboard, order){
+        if (mboard != ALL_MBOARDS){
+            ss << boost::format("  Motherboard %u") % mboard << std::endl;
+        }
+        BOOST_FOREACH(const phase_t &phase, get_breakdown(mboard)){
+            //the parents are not repeated, the depth is shown by indenting
+            const size_t depth = std::count(phase.name.begin(), phase.name.end(), '/');
+            const std::string leaf = phase.name.substr(phase.name.rfind('/') + 1);
+            ss << boost::format("  %10.1f %10.1f  %s%s")
+                % (phase.start*1e3) % (phase.duration*1e3)
+                % std::string(2*depth + (mboard == ALL_MBOARDS ? 0 : 2), ' ') % leaf;
+            if (phase.count > 1) ss << boost::format(" (x%u)") % phase.count;
+            ss << std::endl;
+        }
+    }
+    return ss.str();
+}
@@ -15,12 +15,16 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include "load_modules.hpp"
+#include <uhd/utils/init_profile.hpp>
 #include <uhd/utils/paths.hpp>
-#include <uhd/utils/static.hpp>
 #include <uhd/exception.hpp>
+#include <boost/chrono.hpp>
 #include <boost/format.hpp>
 #include <boost/foreach.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/thread/once.hpp>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -90,19 +94,32 @@ static void load_module_path(const fs::path &path){
     }
 
     //its not a directory, try to load it
+    const boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
     try{
         load_module(path.string());
     }
     catch(const std::exception &err){
         std::cerr << boost::format("Error: %s") % err.what() << std::endl;
     }
+    if (std::getenv("UHD_PROFILE_STARTUP") != NULL){
+        const boost::chrono::duration<double, boost::milli> elapsed = boost::chrono::steady_clock::now() - start;
+        std::cerr << boost::format("[UHD startup] module %s: %.3f ms") % path.string() % elapsed.count() << std::endl;
+    }
 }
 
 /*!
  * Load all the modules given in the module paths.
  */
-UHD_STATIC_BLOCK(load_modules){
+static void load_all_modules(void){
+    //the first use is the discovery of device::make()
+    uhd::init_profile::scoped_phase phase("discovery/modules");
     BOOST_FOREACH(const fs::path &path, uhd::get_module_paths()){
         load_module_path(path);
     }
 }
+
+static boost::once_flag load_modules_flag = BOOST_ONCE_INIT;
+
+void uhd::load_modules(void){
+    boost::call_once(&load_all_modules, load_modules_flag);
+}
@@ -0,0 +1,35 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_UTILS_LOAD_MODULES_HPP
+#define INCLUDED_LIBUHD_UTILS_LOAD_MODULES_HPP
+
+namespace uhd{
+
+    /*!
+     * Load all the modules in the module paths, once.
+     * Modules register devices, dboards, converters and image loaders,
+     * so this must be called before any of these registries is used.
+     * Loading the modules on first use, instead of when the library is
+     * loaded, keeps the start of the tools which never use them fast.
+     * Does not throw, prints the errors to std error.
+     */
+    void load_modules(void);
+
+} //namespace uhd
+
+#endif /* INCLUDED_LIBUHD_UTILS_LOAD_MODULES_HPP */
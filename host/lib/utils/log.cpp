@@ -19,19 +19,87 @@
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/paths.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/date_time/c_local_time_adjustor.hpp>
 #include <boost/thread/locks.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
+#include <algorithm>
 #include <fstream>
 #include <cctype>
+#include <vector>
 
 namespace fs = boost::filesystem;
 namespace pt = boost::posix_time;
 namespace ip = boost::interprocess;
 
+/***********************************************************************
+ * Log records
+ **********************************************************************/
+//! A log entry, the headers are only formatted by the writer
+struct uhd::_log::log::record_type{
+    pt::ptime time; //universal time, the local time conversion is deferred
+    verbosity_t verbosity;
+    std::string file;
+    unsigned int line;
+    std::string function;
+    std::string message;
+};
+
+typedef uhd::_log::log::record_type log_record_type;
+
+typedef uhd::transport::spsc_bounded_buffer<log_record_type *> log_queue_type;
+
+//! The number of entries each thread can queue before entries are dropped
+static const size_t LOG_QUEUE_CAPACITY = 4096;
+
+//! The period in milliseconds at which the writer checks the queues
+static const long LOG_WRITER_PERIOD_MS = 10;
+
+static bool log_record_time_less(const log_record_type *lhs, const log_record_type *rhs){
+    return lhs->time < rhs->time;
+}
+
+//! get the relative file path from the host directory
+static std::string get_rel_file_path(const fs::path &file){
+    fs::path abs_path = file.parent_path();
+    fs::path rel_path = file.leaf();
+    while (not abs_path.empty() and abs_path.leaf() != "host"){
+        rel_path = abs_path.leaf() / rel_path;
+        abs_path = abs_path.parent_path();
+    }
+    return rel_path.string();
+}
+
+static std::string format_log_record(const log_record_type &record){
+    const pt::ptime local_time = boost::date_time::c_local_adjustor<pt::ptime>::utc_to_local(record.time);
+    const std::string time = pt::to_simple_string(local_time);
+    const std::string header1 = str(boost::format("-- %s - level %d") % time % int(record.verbosity));
+    const std::string header2 = str(boost::format("-- %s") % record.function).substr(0, 80);
+    const std::string header3 = str(boost::format("-- %s:%u") % get_rel_file_path(record.file) % record.line);
+    const std::string border = std::string(std::max(std::max(header1.size(), header2.size()), header3.size()), '-');
+    std::ostringstream ss;
+    ss << std::endl
+        << border << std::endl
+        << header1 << std::endl
+        << header2 << std::endl
+        << header3 << std::endl
+        << border << std::endl
+        << record.message << std::endl
+    ;
+    return ss.str();
+}
+
 /***********************************************************************
  * Global resources for the logger
  **********************************************************************/
@@ -39,7 +107,9 @@ class log_resource_type{
 public:
     uhd::_log::verbosity_t level;
 
-    log_resource_type(void){
+    log_resource_type(void):
+        _dropped(0)
+    {
 
         //file lock pointer must be null
         _file_lock = NULL;
@@ -55,14 +125,38 @@ public:
         //allow override from environment variable
         const char * log_level_env = std::getenv("UHD_LOG_LEVEL");
         if (log_level_env != NULL) _set_log_level(log_level_env);
+
+        //entries are written by a background thread unless disabled
+        const char * log_async_env = std::getenv("UHD_LOG_ASYNC");
+        _async = (log_async_env == NULL or std::string(log_async_env) != "0");
     }
 
     ~log_resource_type(void){
+        //stop the writer, then write whatever is still queued
+        _writer.reset();
+        try{
+            this->write_queued();
+        }
+        catch(...){}
         boost::lock_guard<boost::mutex> lock(_mutex);
         _file_stream.close();
         if (_file_lock != NULL) delete _file_lock;
     }
 
+    void log_record(log_record_type *record){
+        if (not _async){
+            const std::string msg = format_log_record(*record);
+            delete record;
+            this->log_to_file(msg);
+            return;
+        }
+        //the caller never waits: a full queue only counts the entry
+        if (not this->get_thread_queue().push_with_haste(record)){
+            delete record;
+            _dropped.fetch_add(1, boost::memory_order_relaxed);
+        }
+    }
+
     void log_to_file(const std::string &log_msg){
         boost::lock_guard<boost::mutex> lock(_mutex);
         if (_file_lock == NULL){
@@ -76,6 +170,70 @@ public:
     }
 
 private:
+    //! get the queue of the calling thread, register it on first use
+    log_queue_type &get_thread_queue(void){
+        if (_thread_queue.get() == NULL){
+            boost::shared_ptr<log_queue_type> queue(new log_queue_type(LOG_QUEUE_CAPACITY));
+            boost::lock_guard<boost::mutex> lock(_queues_mutex);
+            _queues.push_back(queue);
+            _thread_queue.reset(new boost::shared_ptr<log_queue_type>(queue));
+            if (not _writer){
+                _writer = uhd::pooled_task::make(boost::bind(&log_resource_type::writer_task, this), LOG_WRITER_PERIOD_MS/1e3);
+            }
+        }
+        return **_thread_queue;
+    }
+
+    bool writer_task(void){
+        bool wrote = false;
+        try{
+            wrote = this->write_queued();
+        }
+        catch(const std::exception &e){
+            /*!
+             * The message facility calls into the logging facility,
+             * so disable the logger (level = never) before messaging.
+             */
+            level = uhd::_log::never;
+            UHD_MSG(error)
+                << "Logging failed: " << e.what() << std::endl
+                << "Logging has been disabled for this process" << std::endl
+            ;
+        }
+        return wrote;
+    }
+
+    //! write the queued entries of all threads in time order
+    bool write_queued(void){
+        std::vector<log_record_type *> records;
+        {
+            boost::lock_guard<boost::mutex> lock(_queues_mutex);
+            std::vector<boost::shared_ptr<log_queue_type> >::iterator it = _queues.begin();
+            while (it != _queues.end()){
+                log_record_type *record = NULL;
+                while ((*it)->pop_with_haste(record)) records.push_back(record);
+                //the thread exited and its queue is drained
+                if (it->unique()) it = _queues.erase(it);
+                else ++it;
+            }
+        }
+
+        const size_t dropped = _dropped.exchange(0, boost::memory_order_relaxed);
+        if (records.empty() and dropped == 0) return false;
+
+        std::stable_sort(records.begin(), records.end(), &log_record_time_less);
+        std::string msgs;
+        BOOST_FOREACH(log_record_type *record, records){
+            msgs += format_log_record(*record);
+            delete record;
+        }
+        if (dropped != 0){
+            msgs += str(boost::format("\n-- %u log entries were dropped, the log queues were full\n") % dropped);
+        }
+        this->log_to_file(msgs);
+        return true;
+    }
+
     //! set the log level from a string that is either a digit or an enum name
     void _set_log_level(const std::string &log_level_str){
         const uhd::_log::verbosity_t log_level_num = uhd::_log::verbosity_t(log_level_str[0]-'0');
@@ -96,6 +254,14 @@ private:
     std::ofstream _file_stream;
     ip::file_lock *_file_lock;
     boost::mutex _mutex;
+
+    //asynchronous writer:
+    bool _async;
+    boost::thread_specific_ptr<boost::shared_ptr<log_queue_type> > _thread_queue;
+    std::vector<boost::shared_ptr<log_queue_type> > _queues;
+    boost::mutex _queues_mutex;
+    boost::atomic<size_t> _dropped;
+    uhd::pooled_task::sptr _writer;
 };
 
 UHD_SINGLETON_FCN(log_resource_type, log_rs);
@@ -103,40 +269,28 @@ UHD_SINGLETON_FCN(log_resource_type, log_rs);
 /***********************************************************************
  * The logger object implementation
  **********************************************************************/
-//! get the relative file path from the host directory
-static std::string get_rel_file_path(const fs::path &file){
-    fs::path abs_path = file.parent_path();
-    fs::path rel_path = file.leaf();
-    while (not abs_path.empty() and abs_path.leaf() != "host"){
-        rel_path = abs_path.leaf() / rel_path;
-        abs_path = abs_path.parent_path();
-    }
-    return rel_path.string();
+bool uhd::_log::is_enabled(const verbosity_t verbosity)
+{
+    return verbosity >= log_rs().level;
 }
 
-
 uhd::_log::log::log(
     const verbosity_t verbosity,
     const std::string &file,
     const unsigned int line,
     const std::string &function
-    )
+    ):
+    _record(NULL)
 {
     _log_it = (verbosity >= log_rs().level);
     if (_log_it)
     {
-        const std::string time = pt::to_simple_string(pt::microsec_clock::local_time());
-        const std::string header1 = str(boost::format("-- %s - level %d") % time % int(verbosity));
-        const std::string header2 = str(boost::format("-- %s") % function).substr(0, 80);
-        const std::string header3 = str(boost::format("-- %s:%u") % get_rel_file_path(file) % line);
-        const std::string border = std::string(std::max(std::max(header1.size(), header2.size()), header3.size()), '-');
-        _ss << std::endl
-            << border << std::endl
-            << header1 << std::endl
-            << header2 << std::endl
-            << header3 << std::endl
-            << border << std::endl
-        ;
+        _record = new record_type();
+        _record->time = pt::microsec_clock::universal_time();
+        _record->verbosity = verbosity;
+        _record->file = file;
+        _record->line = line;
+        _record->function = function;
     }
 }
 
@@ -145,9 +299,9 @@ uhd::_log::log::~log(void)
     if (not _log_it)
         return;
 
-    _ss << std::endl;
+    _record->message = _ss.str();
     try{
-        log_rs().log_to_file(_ss.str());
+        log_rs().log_record(_record);
     }
     catch(const std::exception &e){
         /*!
@@ -18,8 +18,13 @@
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/static.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 #include <boost/foreach.hpp>
+#include <boost/format.hpp>
 #include <boost/tokenizer.hpp>
 #include <sstream>
 #include <iostream>
@@ -78,9 +83,10 @@ void uhd::msg::register_handler(const handler_t &handler){
     msg_rs().handler = handler;
 }
 
+UHD_SINGLETON_FCN(boost::mutex, default_msg_mutex);
+
 static void default_msg_handler(uhd::msg::type_t type, const std::string &msg){
-    static boost::mutex msg_mutex;
-    boost::mutex::scoped_lock lock(msg_mutex);
+    boost::mutex::scoped_lock lock(default_msg_mutex());
     switch(type){
     case uhd::msg::fastpath:
         std::cerr << msg << std::flush;
@@ -128,3 +134,55 @@ uhd::msg::_msg::~_msg(void){
 std::ostream & uhd::msg::_msg::operator()(void){
     return _impl->ss;
 }
+
+/***********************************************************************
+ * Fast-path events
+ **********************************************************************/
+//! The period in milliseconds over which fast-path events are coalesced
+static const long FASTPATH_REPORT_PERIOD_MS = 100;
+
+/*!
+ * Counts the fast-path events, one counter per character, and prints
+ * them from its own task so the streaming threads never wait on the
+ * message mutex or do any formatting.
+ */
+struct fastpath_reporter_type{
+    fastpath_reporter_type(void){
+        //the reporter prints from its destructor, so the resources of the
+        //default handler must be created first (and destroyed after it)
+        default_msg_mutex();
+        for (size_t i = 0; i < NUM_EVENTS; i++) counts[i] = 0;
+        task = uhd::pooled_task::make(boost::bind(&fastpath_reporter_type::report_task, this), FASTPATH_REPORT_PERIOD_MS/1e3);
+    }
+
+    ~fastpath_reporter_type(void){
+        task.reset();
+        report(); //do not lose the events of the last period
+    }
+
+    bool report_task(void){
+        report();
+        return false;
+    }
+
+    void report(void){
+        for (size_t i = 0; i < NUM_EVENTS; i++){
+            if (counts[i].load(boost::memory_order_relaxed) == 0) continue;
+            const size_t count = counts[i].exchange(0, boost::memory_order_relaxed);
+            if (count == 1) UHD_MSG(fastpath) << char(i);
+            else if (count > 1) UHD_MSG(fastpath) << boost::format(
+                "\n%c x %u in last %ums\n"
+            ) % char(i) % count % FASTPATH_REPORT_PERIOD_MS;
+        }
+    }
+
+    static const size_t NUM_EVENTS = 256;
+    boost::atomic<size_t> counts[NUM_EVENTS];
+    uhd::pooled_task::sptr task;
+};
+
+UHD_SINGLETON_FCN(fastpath_reporter_type, fastpath_rs);
+
+void uhd::msg::fastpath_event(const char event){
+    fastpath_rs().counts[static_cast<unsigned char>(event)].fetch_add(1, boost::memory_order_relaxed);
+}
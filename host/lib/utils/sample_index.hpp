@@ -0,0 +1,63 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_UTILS_SAMPLE_INDEX_HPP
+#define INCLUDED_LIBUHD_UTILS_SAMPLE_INDEX_HPP
+
+#include <uhd/config.hpp>
+#include <stdint.h>
+#include <cstring>
+
+/*!
+ * The sidecar index of a capture by the sample recorder.
+ *
+ * The index file is a header followed by entries, in the byte order of
+ * the recording host. An entry maps a byte offset in the capture, counted
+ * over all of its files, to the time of the sample at that offset.
+ * Entries are spaced by the index stride, plus one after every
+ * discontinuity. Between two entries the samples are contiguous in time.
+ */
+namespace uhd{ namespace sample_index{
+
+    static const char MAGIC[8] = {'U', 'H', 'D', 'I', 'D', 'X', '0', '1'};
+
+    //! The entry follows lost samples
+    static const uint32_t FLAG_DISCONTINUITY = 1 << 0;
+
+    struct header_t{
+        char magic[8];
+        uint32_t item_size; //bytes per sample
+        uint32_t num_files; //the files the buffers are striped across
+        uint64_t buff_size; //bytes per stripe
+        double samp_rate;
+    };
+
+    struct entry_t{
+        uint64_t offset; //bytes before the sample, over all files
+        int64_t full_secs;
+        double frac_secs;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+
+    UHD_INLINE bool has_magic(const header_t &header){
+        return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+}} //namespace uhd::sample_index
+
+#endif /* INCLUDED_LIBUHD_UTILS_SAMPLE_INDEX_HPP */
@@ -0,0 +1,192 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "sample_index.hpp"
+#include <uhd/utils/sample_reader.hpp>
+#include <uhd/exception.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace uhd;
+namespace ip = boost::interprocess;
+
+//! The fraction of a tick below which a time is taken to be on the tick
+static const double TICK_EPSILON = 1e-3;
+
+sample_reader::~sample_reader(void){
+    /* NOP */
+}
+
+class sample_reader_impl : public sample_reader{
+public:
+    sample_reader_impl(const std::vector<std::string> &paths, const std::string &index_path):
+        _num_bytes(0)
+    {
+        std::ifstream index(index_path.c_str(), std::ifstream::binary);
+        if (not index.is_open()){
+            throw uhd::io_error("sample_reader: cannot open the index " + index_path);
+        }
+        if (not index.read(reinterpret_cast<char *>(&_header), sizeof(_header)) or not sample_index::has_magic(_header)){
+            throw uhd::value_error("sample_reader: not a sample index " + index_path);
+        }
+        if (_header.item_size == 0 or _header.buff_size == 0 or _header.samp_rate <= 0.0){
+            throw uhd::value_error("sample_reader: corrupt sample index " + index_path);
+        }
+        if (_header.num_files != paths.size()){
+            throw uhd::value_error(str(boost::format(
+                "sample_reader: the index is for %u files, got %u") % _header.num_files % paths.size()));
+        }
+
+        sample_index::entry_t entry;
+        while (index.read(reinterpret_cast<char *>(&entry), sizeof(entry))){
+            if (entry.offset % _header.item_size != 0){
+                throw uhd::value_error("sample_reader: corrupt sample index " + index_path);
+            }
+            _entry_offsets.push_back(entry.offset/_header.item_size);
+            _entry_times.push_back(time_spec_t(time_t(entry.full_secs), entry.frac_secs));
+            if (entry.flags & sample_index::FLAG_DISCONTINUITY){
+                _discontinuities.push_back(_entry_offsets.back());
+            }
+        }
+
+        //empty files cannot be mapped, they hold no samples anyway
+        for (size_t i = 0; i < paths.size(); i++){
+            if (not boost::filesystem::exists(paths[i])){
+                throw uhd::io_error("sample_reader: cannot open " + paths[i]);
+            }
+            const uint64_t size = boost::filesystem::file_size(paths[i]);
+            _num_bytes += size;
+            if (size == 0){
+                _regions.push_back(boost::shared_ptr<ip::mapped_region>());
+                continue;
+            }
+            try{
+                ip::file_mapping mapping(paths[i].c_str(), ip::read_only);
+                _regions.push_back(boost::shared_ptr<ip::mapped_region>(new ip::mapped_region(mapping, ip::read_only)));
+            }
+            catch(const ip::interprocess_exception &ex){
+                throw uhd::io_error(str(boost::format("sample_reader: cannot map %s: %s") % paths[i] % ex.what()));
+            }
+        }
+
+        if (_num_bytes % _header.item_size != 0 or
+            (not _entry_offsets.empty() and _entry_offsets.back() > get_num_samps())){
+            throw uhd::value_error("sample_reader: the index does not match the files");
+        }
+        if (_entry_offsets.empty() and _num_bytes != 0){
+            throw uhd::value_error("sample_reader: the index has no timed entries");
+        }
+    }
+
+    size_t get_item_size(void) const{
+        return _header.item_size;
+    }
+
+    double get_samp_rate(void) const{
+        return _header.samp_rate;
+    }
+
+    size_t get_stripe_size(void) const{
+        return size_t(_header.buff_size);
+    }
+
+    uint64_t get_num_samps(void) const{
+        return _num_bytes/_header.item_size;
+    }
+
+    time_spec_t get_time(const uint64_t samp_offset) const{
+        if (samp_offset >= get_num_samps()){
+            throw uhd::index_error(str(boost::format(
+                "sample_reader: sample %u is past the end of the capture") % samp_offset));
+        }
+        //the last entry at or before the sample, samples before the first one precede it
+        const size_t i = std::upper_bound(_entry_offsets.begin(), _entry_offsets.end(), samp_offset) - _entry_offsets.begin();
+        if (i == 0){
+            return _entry_times.front() - time_spec_t::from_ticks(
+                (long long)(_entry_offsets.front() - samp_offset), _header.samp_rate);
+        }
+        return _entry_times[i-1] + time_spec_t::from_ticks(
+            (long long)(samp_offset - _entry_offsets[i-1]), _header.samp_rate);
+    }
+
+    uint64_t find(const time_spec_t &time) const{
+        if (_entry_times.empty()) return 0;
+        //the last entry at or before the time
+        const size_t i = std::upper_bound(_entry_times.begin(), _entry_times.end(), time) - _entry_times.begin();
+        if (i == 0){
+            const long long ticks = (_entry_times.front() - time).to_ticks(_header.samp_rate);
+            return uint64_t(std::max<long long>(0, (long long)(_entry_offsets.front()) - ticks));
+        }
+
+        //round up to the first sample at or after the time, within a rounding error of a tick
+        const time_spec_t delta = time - _entry_times[i-1];
+        long long ticks = delta.to_ticks(_header.samp_rate);
+        if ((delta - time_spec_t::from_ticks(ticks, _header.samp_rate)).get_real_secs()*_header.samp_rate > TICK_EPSILON) ticks++;
+
+        //a time in the gap before the next entry clamps to that entry
+        const uint64_t end = (i < _entry_offsets.size())? _entry_offsets[i] : get_num_samps();
+        return std::min<uint64_t>(_entry_offsets[i-1] + uint64_t(ticks), end);
+    }
+
+    std::vector<uint64_t> get_discontinuities(void) const{
+        return _discontinuities;
+    }
+
+    size_t read(void *buff, const uint64_t samp_offset, const size_t nsamps) const{
+        if (samp_offset >= get_num_samps()) return 0;
+        const size_t nsamps_read = size_t(std::min<uint64_t>(nsamps, get_num_samps() - samp_offset));
+
+        //undo the striping: buffer k of the capture is in file k % num_files
+        uint64_t offset = samp_offset*_header.item_size;
+        const uint64_t end = offset + uint64_t(nsamps_read)*_header.item_size;
+        char *out = static_cast<char *>(buff);
+        while (offset < end){
+            const uint64_t buff_index = offset/_header.buff_size;
+            const uint64_t buff_offset = offset%_header.buff_size;
+            const size_t nbytes = size_t(std::min<uint64_t>(end - offset, _header.buff_size - buff_offset));
+            const boost::shared_ptr<ip::mapped_region> &region = _regions[size_t(buff_index % _header.num_files)];
+            const uint64_t file_offset = (buff_index/_header.num_files)*_header.buff_size + buff_offset;
+            if (not region or file_offset + nbytes > region->get_size()){
+                throw uhd::value_error("sample_reader: the files are not a striped capture");
+            }
+            std::memcpy(out, static_cast<const char *>(region->get_address()) + file_offset, nbytes);
+            out += nbytes;
+            offset += nbytes;
+        }
+        return nsamps_read;
+    }
+
+private:
+    sample_index::header_t _header;
+    uint64_t _num_bytes;
+    std::vector<uint64_t> _entry_offsets;
+    std::vector<time_spec_t> _entry_times;
+    std::vector<uint64_t> _discontinuities;
+    std::vector<boost::shared_ptr<ip::mapped_region> > _regions;
+};
+
+sample_reader::sptr sample_reader::make(
+    const std::vector<std::string> &paths,
+    const std::string &index_path
+){
+    return sptr(new sample_reader_impl(paths, index_path));
+}
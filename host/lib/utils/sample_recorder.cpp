@@ -0,0 +1,418 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "sample_index.hpp"
+#include <uhd/utils/sample_recorder.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/transport/bounded_buffer.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/safe_call.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#ifdef UHD_PLATFORM_WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace uhd;
+
+//! Direct I/O needs the memory, the file offset and the length on this boundary
+static const size_t PAGE_ALIGN = 4096;
+
+static const size_t DEFAULT_BUFF_SIZE = 4*1024*1024;
+static const size_t DEFAULT_NUM_BUFFS = 32;
+
+//! The timeout in seconds of one round of the I/O threads
+static const double IO_TIMEOUT = 0.1;
+
+sample_recorder::~sample_recorder(void){
+    /* NOP */
+}
+
+/***********************************************************************
+ * One file of the recorder
+ **********************************************************************/
+class recorder_file : boost::noncopyable{
+public:
+    recorder_file(const std::string &path, const bool direct_io):
+        _path(path), _direct(false)
+    {
+#ifdef UHD_PLATFORM_WIN32
+        (void)direct_io;
+        _file = std::fopen(path.c_str(), "wb");
+        if (_file == NULL) throw_errno("open");
+#else
+        const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+        _fd = -1;
+#ifdef O_DIRECT
+        if (direct_io){
+            _fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+            _direct = (_fd >= 0);
+            //e.g. tmpfs does not support direct I/O
+            if (not _direct and errno != EINVAL) throw_errno("open");
+        }
+#else
+        (void)direct_io;
+#endif
+        if (_fd < 0) _fd = ::open(path.c_str(), flags, 0644);
+        if (_fd < 0) throw_errno("open");
+#endif
+    }
+
+    ~recorder_file(void){
+#ifdef UHD_PLATFORM_WIN32
+        std::fclose(_file);
+#else
+        ::close(_fd);
+#endif
+    }
+
+    /*!
+     * Write all of the bytes.
+     * Only the last write may have a length off the page boundary.
+     * \throws uhd::io_error on failure
+     */
+    void write(const char *buff, size_t nbytes){
+#ifdef UHD_PLATFORM_WIN32
+        if (std::fwrite(buff, 1, nbytes, _file) != nbytes) throw_errno("write");
+#else
+#ifdef O_DIRECT
+        if (_direct and nbytes % PAGE_ALIGN != 0){
+            const size_t aligned_bytes = nbytes - nbytes % PAGE_ALIGN;
+            this->write_all(buff, aligned_bytes);
+            buff += aligned_bytes;
+            nbytes -= aligned_bytes;
+            if (::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) & ~O_DIRECT) != 0) throw_errno("fcntl");
+            _direct = false;
+        }
+#endif
+        this->write_all(buff, nbytes);
+#endif
+    }
+
+private:
+#ifndef UHD_PLATFORM_WIN32
+    void write_all(const char *buff, size_t nbytes){
+        while (nbytes > 0){
+            const ssize_t ret = ::write(_fd, buff, nbytes);
+            if (ret < 0 and errno == EINTR) continue;
+            if (ret <= 0) throw_errno("write");
+            buff += ret;
+            nbytes -= size_t(ret);
+        }
+    }
+#endif
+
+    void throw_errno(const std::string &what){
+        throw uhd::io_error(str(boost::format(
+            "sample_recorder: %s of %s failed: %s") % what % _path % std::strerror(errno)
+        ));
+    }
+
+    const std::string _path;
+    bool _direct;
+#ifdef UHD_PLATFORM_WIN32
+    std::FILE *_file;
+#else
+    int _fd;
+#endif
+};
+
+/***********************************************************************
+ * The recorder implementation
+ **********************************************************************/
+class sample_recorder_impl : public sample_recorder{
+public:
+    sample_recorder_impl(const std::vector<std::string> &paths, const device_addr_t &args):
+        _buff_size(args.cast<size_t>("buff_size", DEFAULT_BUFF_SIZE)),
+        _num_buffs(args.cast<size_t>("num_buffs", DEFAULT_NUM_BUFFS)),
+        _free_buffs(_num_buffs),
+        _curr_buff(NULL), _curr_len(0),
+        _next_stripe(0), _num_pending(0),
+        _num_written(0), _num_dropped(0),
+        _closed(false),
+        _offset(0),
+        _item_size(args.cast<size_t>("item_size", 0)),
+        _samp_rate(args.cast<double>("samp_rate", 0.0)),
+        _index_stride(args.cast<uint64_t>("index_stride", _buff_size)),
+        _has_entry(false), _discontinuity(false),
+        _last_entry_offset(0), _next_entry_offset(0)
+    {
+        if (paths.empty()) throw uhd::value_error("sample_recorder: no file to record to");
+        if (_buff_size == 0 or _buff_size % PAGE_ALIGN != 0){
+            throw uhd::value_error(str(boost::format(
+                "sample_recorder: buff_size must be a positive multiple of %u") % PAGE_ALIGN
+            ));
+        }
+        if (_num_buffs == 0) throw uhd::value_error("sample_recorder: num_buffs must be positive");
+
+        //one allocation for the ring, aligned to the page
+        _mem.reset(new char[_num_buffs*_buff_size + PAGE_ALIGN]);
+        char *ring = _mem.get() + (PAGE_ALIGN - size_t(_mem.get()) % PAGE_ALIGN) % PAGE_ALIGN;
+        for (size_t i = 0; i < _num_buffs; i++){
+            _free_buffs.push_with_haste(ring + i*_buff_size);
+        }
+        _reserved.reserve(_num_buffs);
+
+        if (args.has_key("index")){
+            if (_item_size == 0 or _samp_rate <= 0.0 or _index_stride == 0){
+                throw uhd::value_error("sample_recorder: an index needs a positive item_size, samp_rate and index_stride");
+            }
+            _index.reset(new std::ofstream(args["index"].c_str(), std::ofstream::binary));
+            if (not _index->is_open()){
+                throw uhd::io_error("sample_recorder: cannot open the index " + args["index"]);
+            }
+            sample_index::header_t header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, sample_index::MAGIC, sizeof(header.magic));
+            header.item_size = uint32_t(_item_size);
+            header.num_files = uint32_t(paths.size());
+            header.buff_size = _buff_size;
+            header.samp_rate = _samp_rate;
+            _index->write(reinterpret_cast<const char *>(&header), sizeof(header));
+        }
+
+        const bool direct_io = args.cast<int>("direct_io", 1) != 0;
+        for (size_t i = 0; i < paths.size(); i++){
+            _stripes.push_back(boost::shared_ptr<stripe_type>(new stripe_type(paths[i], direct_io, _num_buffs)));
+        }
+        for (size_t i = 0; i < _stripes.size(); i++){
+            _stripes[i]->io_task = task::make(boost::bind(
+                &sample_recorder_impl::write_one_buff, this, boost::ref(*_stripes[i])
+            ));
+        }
+    }
+
+    ~sample_recorder_impl(void){
+        UHD_SAFE_CALL(this->close();)
+    }
+
+    bool write(const void *buff, const size_t nbytes){
+        if (_closed) throw uhd::runtime_error("sample_recorder: write after close");
+
+        //reserve every buffer the samples need first, to drop them whole
+        const size_t space = (_curr_buff == NULL)? 0 : _buff_size - _curr_len;
+        _reserved.clear();
+        if (nbytes > space){
+            const size_t num_new = (nbytes - space + _buff_size - 1)/_buff_size;
+            char *mem;
+            while (_reserved.size() < num_new and _free_buffs.pop_with_haste(mem)){
+                _reserved.push_back(mem);
+            }
+            if (_reserved.size() < num_new){
+                for (size_t i = 0; i < _reserved.size(); i++) _free_buffs.push_with_haste(_reserved[i]);
+                _num_dropped += nbytes;
+                return false;
+            }
+        }
+        _offset += nbytes;
+
+        const char *in = reinterpret_cast<const char *>(buff);
+        size_t nleft = nbytes;
+        size_t reserved_index = 0;
+        while (nleft > 0){
+            if (_curr_buff == NULL){
+                _curr_buff = _reserved[reserved_index++];
+                _curr_len = 0;
+            }
+            const size_t ncopy = std::min(nleft, _buff_size - _curr_len);
+            std::memcpy(_curr_buff + _curr_len, in, ncopy);
+            _curr_len += ncopy;
+            in += ncopy;
+            nleft -= ncopy;
+            if (_curr_len == _buff_size){
+                this->submit(_curr_buff, _curr_len);
+                _curr_buff = NULL;
+            }
+        }
+        return true;
+    }
+
+    bool write(const void *buff, const size_t nbytes, const rx_metadata_t &metadata){
+        if (not _index) return this->write(buff, nbytes);
+        if (nbytes == 0){
+            if (metadata.error_code != rx_metadata_t::ERROR_CODE_NONE and
+                metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) _discontinuity = true;
+            return true;
+        }
+
+        const uint64_t offset = _offset;
+        bool add_entry = false;
+        if (metadata.has_time_spec){
+            const time_spec_t expected_time = _last_entry_time + time_spec_t::from_ticks(
+                (offset - _last_entry_offset)/_item_size, _samp_rate);
+            if (_has_entry and (metadata.time_spec - expected_time).to_ticks(_samp_rate) != 0){
+                _discontinuity = true;
+            }
+            add_entry = (not _has_entry) or _discontinuity or (offset >= _next_entry_offset);
+        }
+
+        if (not this->write(buff, nbytes)){
+            //the samples are missing from the capture
+            _discontinuity = true;
+            return false;
+        }
+        if (add_entry){
+            sample_index::entry_t entry;
+            entry.offset = offset;
+            entry.full_secs = int64_t(metadata.time_spec.get_full_secs());
+            entry.frac_secs = metadata.time_spec.get_frac_secs();
+            entry.flags = (_discontinuity and _has_entry)? sample_index::FLAG_DISCONTINUITY : 0;
+            entry.reserved = 0;
+            _index->write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+            _has_entry = true;
+            _discontinuity = false;
+            _last_entry_offset = offset;
+            _last_entry_time = metadata.time_spec;
+            _next_entry_offset = (offset/_index_stride + 1)*_index_stride;
+        }
+        return true;
+    }
+
+    void close(void){
+        if (_closed) return;
+        _closed = true;
+        if (_curr_buff != NULL){
+            this->submit(_curr_buff, _curr_len);
+            _curr_buff = NULL;
+        }
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            while (_num_pending != 0) _pending_cond.wait(lock);
+        }
+        //stops the I/O threads and closes the files
+        _stripes.clear();
+        if (_index){
+            _index->close();
+            if (_index->fail() and _error.empty()) _error = "sample_recorder: writing the index failed";
+        }
+        if (not _error.empty()) throw uhd::io_error(_error);
+    }
+
+    uint64_t get_num_written_bytes(void) const{
+        return _num_written.load(boost::memory_order_relaxed);
+    }
+
+    uint64_t get_num_dropped_bytes(void) const{
+        return _num_dropped.load(boost::memory_order_relaxed);
+    }
+
+private:
+    struct buff_type{
+        buff_type(void): mem(NULL), len(0) {}
+        buff_type(char *mem_, const size_t len_): mem(mem_), len(len_) {}
+        char *mem;
+        size_t len;
+    };
+
+    struct stripe_type{
+        stripe_type(const std::string &path, const bool direct_io, const size_t num_buffs):
+            file(path, direct_io), full_buffs(num_buffs), failed(false)
+        {}
+        ~stripe_type(void){
+            io_task.reset();
+        }
+        recorder_file file;
+        transport::bounded_buffer<buff_type> full_buffs;
+        bool failed; //only used by the task
+        task::sptr io_task;
+    };
+
+    //! Hand a buffer to the I/O thread of the next file
+    void submit(char *mem, const size_t len){
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            _num_pending++;
+        }
+        //holds every buffer of the ring, so this never drops
+        _stripes[_next_stripe]->full_buffs.push_with_haste(buff_type(mem, len));
+        _next_stripe = (_next_stripe + 1) % _stripes.size();
+    }
+
+    //! One round of the I/O thread of a file
+    void write_one_buff(stripe_type &stripe){
+        buff_type buff;
+        if (not stripe.full_buffs.pop_with_timed_wait(buff, IO_TIMEOUT)) return;
+        if (not stripe.failed){
+            try{
+                stripe.file.write(buff.mem, buff.len);
+                _num_written += buff.len;
+            }
+            catch(const uhd::io_error &e){
+                UHD_MSG(error) << e.what() << std::endl;
+                stripe.failed = true;
+                boost::mutex::scoped_lock lock(_mutex);
+                if (_error.empty()) _error = e.what();
+            }
+        }
+        if (stripe.failed) _num_dropped += buff.len;
+        _free_buffs.push_with_haste(buff.mem);
+
+        boost::mutex::scoped_lock lock(_mutex);
+        _num_pending--;
+        _pending_cond.notify_one();
+    }
+
+    const size_t _buff_size;
+    const size_t _num_buffs;
+    boost::scoped_array<char> _mem;
+    transport::bounded_buffer<char *> _free_buffs;
+    std::vector<boost::shared_ptr<stripe_type> > _stripes;
+
+    //only used by the writing thread
+    char *_curr_buff;
+    size_t _curr_len;
+    std::vector<char *> _reserved;
+    size_t _next_stripe;
+
+    boost::mutex _mutex;
+    boost::condition_variable _pending_cond;
+    size_t _num_pending;
+    std::string _error;
+
+    boost::atomic<uint64_t> _num_written;
+    boost::atomic<uint64_t> _num_dropped;
+    bool _closed;
+
+    //the index, only used by the writing thread
+    uint64_t _offset; //bytes accepted so far
+    const size_t _item_size;
+    const double _samp_rate;
+    const uint64_t _index_stride;
+    boost::scoped_ptr<std::ofstream> _index;
+    bool _has_entry, _discontinuity;
+    uint64_t _last_entry_offset, _next_entry_offset;
+    time_spec_t _last_entry_time;
+};
+
+sample_recorder::sptr sample_recorder::make(
+    const std::vector<std::string> &paths, const device_addr_t &args
+){
+    return sptr(new sample_recorder_impl(paths, args));
+}
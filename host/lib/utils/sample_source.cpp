@@ -0,0 +1,252 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/utils/sample_source.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/transport/bounded_buffer.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace uhd;
+
+static const size_t DEFAULT_BUFF_SIZE = 1024*1024;
+static const size_t DEFAULT_NUM_BUFFS = 16;
+
+//! The timeout in seconds of one round of the read-ahead thread
+static const double IO_TIMEOUT = 0.1;
+
+sample_source::~sample_source(void){
+    /* NOP */
+}
+
+class sample_source_impl : public sample_source{
+public:
+    sample_source_impl(const std::vector<std::string> &paths, const device_addr_t &args):
+        _buff_size(args.cast<size_t>("buff_size", DEFAULT_BUFF_SIZE)),
+        _num_buffs(args.cast<size_t>("num_buffs", DEFAULT_NUM_BUFFS)),
+        _stripe_size(args.cast<uint64_t>("stripe_size", 0)),
+        _loop(args.cast<int>("loop", 0) != 0),
+        _num_bytes(0),
+        _pos(args.cast<uint64_t>("offset", 0)),
+        _ended(false),
+        _full_buffs(_num_buffs),
+        _free_buffs(_num_buffs),
+        _num_filled(0),
+        _curr_off(0), _eof(false), _num_stalls(0)
+    {
+        if (paths.empty()) throw uhd::value_error("sample_source: no file to play");
+        if (_buff_size == 0) throw uhd::value_error("sample_source: buff_size must be positive");
+        if (_num_buffs == 0) throw uhd::value_error("sample_source: num_buffs must be positive");
+
+        for (size_t i = 0; i < paths.size(); i++){
+            boost::shared_ptr<std::ifstream> file(new std::ifstream(paths[i].c_str(), std::ifstream::binary));
+            if (not file->is_open()) throw uhd::io_error("sample_source: cannot open " + paths[i]);
+            _files.push_back(file);
+            _file_sizes.push_back(boost::filesystem::file_size(paths[i]));
+            _num_bytes += _file_sizes.back();
+        }
+        if (_pos > _num_bytes){
+            throw uhd::value_error(str(boost::format(
+                "sample_source: offset %u is past the end of the files") % _pos));
+        }
+
+        _mem.reset(new char[_num_buffs*_buff_size]);
+        for (size_t i = 0; i < _num_buffs; i++){
+            _free_buffs.push_with_haste(_mem.get() + i*_buff_size);
+        }
+        _read_task = task::make(boost::bind(&sample_source_impl::read_one_buff, this));
+
+        //start with a full ring, or with all of a short file
+        boost::mutex::scoped_lock lock(_mutex);
+        while (_num_filled < _num_buffs and not _ended) _filled_cond.wait(lock);
+    }
+
+    ~sample_source_impl(void){
+        _read_task.reset();
+    }
+
+    size_t read(void *buff, const size_t nbytes, const double timeout){
+        char *out = static_cast<char *>(buff);
+        size_t copied = 0;
+        while (copied < nbytes and not _eof){
+            if (_curr.mem == NULL){
+                if (not _full_buffs.pop_with_haste(_curr)){
+                    if (copied != 0) break;
+                    _num_stalls++;
+                    if (not _full_buffs.pop_with_timed_wait(_curr, timeout)) break;
+                }
+                _curr_off = 0;
+                //an empty buffer marks the end
+                if (_curr.len == 0){
+                    _free_buffs.push_with_haste(_curr.mem);
+                    _curr = buff_type();
+                    _eof = true;
+                    boost::mutex::scoped_lock lock(_mutex);
+                    if (not _error.empty()) throw uhd::io_error(_error);
+                    break;
+                }
+            }
+            const size_t ncopy = std::min(nbytes - copied, _curr.len - _curr_off);
+            std::memcpy(out + copied, _curr.mem + _curr_off, ncopy);
+            copied += ncopy;
+            _curr_off += ncopy;
+            if (_curr_off == _curr.len){
+                _free_buffs.push_with_haste(_curr.mem);
+                _curr = buff_type();
+            }
+        }
+        return copied;
+    }
+
+    bool eof(void) const{
+        return _eof;
+    }
+
+    uint64_t get_num_bytes(void) const{
+        return _num_bytes;
+    }
+
+    size_t get_num_stalls(void) const{
+        return _num_stalls;
+    }
+
+private:
+    struct buff_type{
+        buff_type(void): mem(NULL), len(0) {}
+        buff_type(char *mem_, const size_t len_): mem(mem_), len(len_) {}
+        char *mem;
+        size_t len;
+    };
+
+    //! Find the file and its offset of a byte, and the bytes that follow it in that file
+    void locate(const uint64_t pos, size_t &file_index, uint64_t &file_offset, uint64_t &len) const{
+        if (_stripe_size != 0){
+            //buffer k of a striped capture is in file k % num_files
+            const uint64_t stripe_index = pos/_stripe_size;
+            file_index = size_t(stripe_index % _files.size());
+            file_offset = (stripe_index/_files.size())*_stripe_size + pos%_stripe_size;
+            len = _stripe_size - pos%_stripe_size;
+            return;
+        }
+        uint64_t file_pos = pos;
+        file_index = 0;
+        while (file_pos >= _file_sizes[file_index]){
+            file_pos -= _file_sizes[file_index];
+            file_index++;
+        }
+        file_offset = file_pos;
+        len = _file_sizes[file_index] - file_pos;
+    }
+
+    //! Fill a buffer from the current position, wraps around when looping
+    size_t fill(char *mem){
+        size_t len = 0;
+        while (len < _buff_size){
+            if (_pos == _num_bytes){
+                if (not _loop or _num_bytes == 0) break;
+                _pos = 0;
+            }
+            size_t file_index;
+            uint64_t file_offset, file_len;
+            this->locate(_pos, file_index, file_offset, file_len);
+            const size_t nread = size_t(std::min<uint64_t>(
+                std::min<uint64_t>(file_len, _num_bytes - _pos), _buff_size - len));
+            std::ifstream &file = *_files[file_index];
+            file.seekg(std::streamoff(file_offset));
+            file.read(mem + len, std::streamsize(nread));
+            if (file.gcount() != std::streamsize(nread)){
+                throw uhd::io_error(str(boost::format(
+                    "sample_source: short read at byte %u of file %u") % file_offset % file_index));
+            }
+            len += nread;
+            _pos += nread;
+        }
+        return len;
+    }
+
+    //! One round of the read-ahead thread
+    void read_one_buff(void){
+        if (_ended){
+            boost::this_thread::sleep(boost::posix_time::milliseconds(long(IO_TIMEOUT*1000)));
+            return;
+        }
+        char *mem;
+        if (not _free_buffs.pop_with_timed_wait(mem, IO_TIMEOUT)) return;
+
+        size_t len = 0;
+        try{
+            len = this->fill(mem);
+        }
+        catch(const uhd::io_error &e){
+            UHD_MSG(error) << e.what() << std::endl;
+            boost::mutex::scoped_lock lock(_mutex);
+            _error = e.what();
+            len = 0;
+        }
+        //holds every buffer of the ring, so this never drops
+        _full_buffs.push_with_haste(buff_type(mem, len));
+
+        boost::mutex::scoped_lock lock(_mutex);
+        if (len == 0) _ended = true;
+        _num_filled++;
+        _filled_cond.notify_one();
+    }
+
+    const size_t _buff_size;
+    const size_t _num_buffs;
+    const uint64_t _stripe_size;
+    const bool _loop;
+    std::vector<boost::shared_ptr<std::ifstream> > _files;
+    std::vector<uint64_t> _file_sizes;
+    uint64_t _num_bytes;
+
+    //only used by the read-ahead thread, and _ended under the mutex
+    uint64_t _pos;
+    bool _ended;
+
+    boost::scoped_array<char> _mem;
+    transport::bounded_buffer<buff_type> _full_buffs;
+    transport::bounded_buffer<char *> _free_buffs;
+    task::sptr _read_task;
+
+    boost::mutex _mutex;
+    boost::condition_variable _filled_cond;
+    size_t _num_filled;
+    std::string _error;
+
+    //only used by the reading thread
+    buff_type _curr;
+    size_t _curr_off;
+    bool _eof;
+    size_t _num_stalls;
+};
+
+sample_source::sptr sample_source::make(
+    const std::vector<std::string> &paths, const device_addr_t &args
+){
+    return sptr(new sample_source_impl(paths, args));
+}
@@ -16,9 +16,25 @@
 //
 
 #include <uhd/utils/static.hpp>
+#include <boost/chrono.hpp>
+#include <boost/format.hpp>
+#include <cstdlib>
 #include <stdexcept>
 #include <iostream>
+/*!
+ * With UHD_PROFILE_STARTUP set, the time of each static block is printed,
+ * with the total time of the static blocks so far.
+ */
+static void print_static_block_time(const char *name, const double ms){
+    static double total_ms = 0.0;
+    total_ms += ms;
+    std::cerr << boost::format("[UHD startup] static block %s: %.3f ms (total %.3f ms)")
+        % name % ms % total_ms << std::endl;
+}
+
 _uhd_static_fixture::_uhd_static_fixture(void (*fcn)(void), const char *name){
+    const bool profile = (std::getenv("UHD_PROFILE_STARTUP") != NULL);
+    const boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
     try{
         fcn();
     }
@@ -29,4 +45,8 @@ _uhd_static_fixture::_uhd_static_fixture(void (*fcn)(void), const char *name){
     catch(...){
         std::cerr << "Exception in static block " << name << std::endl;
     }
+    if (profile){
+        const boost::chrono::duration<double, boost::milli> elapsed = boost::chrono::steady_clock::now() - start;
+        print_static_block_time(name, elapsed.count());
+    }
 }
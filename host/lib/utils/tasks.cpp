@@ -18,8 +18,18 @@
 #include <uhd/utils/tasks.hpp>
 #include <uhd/utils/msg_task.hpp>
 #include <uhd/utils/msg.hpp>
+#include <uhd/utils/static.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <boost/atomic.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/barrier.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/unordered_map.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
 #include <exception>
 #include <iostream>
 #include <vector>
@@ -29,10 +39,10 @@ using namespace uhd;
 class task_impl : public task{
 public:
 
-    task_impl(const task_fcn_type &task_fcn):
+    task_impl(const task_fcn_type &task_fcn, const std::string &role):
         _spawn_barrier(2)
     {
-        (void)_thread_group.create_thread(boost::bind(&task_impl::task_loop, this, task_fcn));
+        (void)_thread_group.create_thread(boost::bind(&task_impl::task_loop, this, task_fcn, role));
         _spawn_barrier.wait();
     }
 
@@ -44,9 +54,10 @@ public:
 
 private:
 
-    void task_loop(const task_fcn_type &task_fcn){
+    void task_loop(const task_fcn_type &task_fcn, const std::string &role){
         _running = true;
         _spawn_barrier.wait();
+        uhd::setup_thread(role);
 
         try{
             while (_running){
@@ -79,10 +90,198 @@ private:
     bool _running;
 };
 
-task::sptr task::make(const task_fcn_type &task_fcn){
-    return task::sptr(new task_impl(task_fcn));
+task::sptr task::make(const task_fcn_type &task_fcn, const std::string &role){
+    return task::sptr(new task_impl(task_fcn, role));
+}
+
+/***********************************************************************
+ * Pooled tasks
+ **********************************************************************/
+//! The number of pool threads unless UHD_TASK_POOL_THREADS is set
+static const size_t DEFAULT_TASK_POOL_THREADS = 2;
+
+//! The longest time a pool thread sleeps without checking its tasks
+static const long TASK_POOL_MAX_IDLE_MS = 1000;
+
+class task_pool : boost::noncopyable{
+public:
+    struct entry_type{
+        pooled_task::task_fcn_type task_fcn;
+        boost::posix_time::time_duration period;
+        boost::system_time next_run;
+        bool busy;
+        bool notified;
+        boost::thread::id runner;
+    };
+    typedef boost::shared_ptr<entry_type> entry_sptr;
+
+    task_pool(const size_t num_threads):
+        _num_threads(std::max<size_t>(num_threads, 1))
+    {
+        /* NOP */
+    }
+
+    ~task_pool(void){
+        _thread_group.interrupt_all();
+        _thread_group.join_all();
+    }
+
+    void add(entry_sptr entry){
+        boost::mutex::scoped_lock lock(_mutex);
+        _entries.push_back(entry);
+        while (_thread_group.size() < _num_threads){
+            (void)_thread_group.create_thread(boost::bind(&task_pool::worker, this));
+        }
+        _cond.notify_one();
+    }
+
+    void remove(entry_sptr entry){
+        boost::mutex::scoped_lock lock(_mutex);
+        this->erase(entry);
+        //wait for a running call, unless the task removes itself
+        while (entry->busy and entry->runner != boost::this_thread::get_id()){
+            _done_cond.wait(lock);
+        }
+    }
+
+    void notify(entry_sptr entry){
+        boost::mutex::scoped_lock lock(_mutex);
+        entry->notified = true;
+        entry->next_run = boost::get_system_time();
+        _cond.notify_one();
+    }
+
+private:
+    void erase(entry_sptr entry){
+        _entries.erase(std::remove(_entries.begin(), _entries.end(), entry), _entries.end());
+    }
+
+    //! runs the due task with the earliest deadline, or sleeps until one is due
+    void worker(void){
+        uhd::setup_thread("task_pool");
+        boost::mutex::scoped_lock lock(_mutex);
+        try{
+            while (true){
+                const boost::system_time now = boost::get_system_time();
+                boost::system_time wake = now + boost::posix_time::milliseconds(TASK_POOL_MAX_IDLE_MS);
+                entry_sptr next;
+                BOOST_FOREACH(const entry_sptr &entry, _entries){
+                    if (entry->busy) continue;
+                    if (entry->next_run > now) wake = std::min(wake, entry->next_run);
+                    else if (not next or entry->next_run < next->next_run) next = entry;
+                }
+                if (not next){
+                    _cond.timed_wait(lock, wake);
+                    continue;
+                }
+
+                next->busy = true;
+                next->notified = false;
+                next->runner = boost::this_thread::get_id();
+                bool did_work = false;
+                lock.unlock();
+                try{
+                    did_work = next->task_fcn();
+                }
+                catch(const boost::thread_interrupted &){
+                    throw;
+                }
+                catch(const std::exception &e){
+                    lock.lock();
+                    this->erase(next);
+                    lock.unlock();
+                    do_error_msg(e.what());
+                }
+                catch(...){
+                    lock.lock();
+                    this->erase(next);
+                    lock.unlock();
+                }
+                lock.lock();
+
+                next->busy = false;
+                next->next_run = (did_work or next->notified)?
+                    boost::get_system_time() : boost::get_system_time() + next->period;
+                _done_cond.notify_all();
+            }
+        }
+        catch(const boost::thread_interrupted &){
+            //this is an ok way to exit the pool
+        }
+    }
+
+    static void do_error_msg(const std::string &msg){
+        UHD_MSG(error)
+            << "An unexpected exception was caught in a pooled task." << std::endl
+            << "The task will not be called again, things may not work." << std::endl
+            << msg << std::endl
+        ;
+    }
+
+    const size_t _num_threads;
+    boost::mutex _mutex;
+    boost::condition_variable _cond, _done_cond;
+    std::vector<entry_sptr> _entries;
+    boost::thread_group _thread_group;
+};
+
+//! The pooled tasks hold the pool, so it outlives the static destructors of its users
+struct task_pool_holder_type{
+    task_pool_holder_type(void){
+        size_t num_threads = DEFAULT_TASK_POOL_THREADS;
+        const char *num_threads_env = std::getenv("UHD_TASK_POOL_THREADS");
+        if (num_threads_env != NULL){
+            //no message on error: messages log, and the logger uses this pool
+            try{
+                num_threads = boost::lexical_cast<size_t>(num_threads_env);
+            }
+            catch(const boost::bad_lexical_cast &){}
+        }
+        pool.reset(new task_pool(num_threads));
+    }
+    boost::shared_ptr<task_pool> pool;
+};
+
+UHD_SINGLETON_FCN(task_pool_holder_type, task_pool_holder);
+
+pooled_task::~pooled_task(void){
+    /* NOP */
+}
+
+class pooled_task_impl : public pooled_task{
+public:
+    pooled_task_impl(const task_fcn_type &task_fcn, const double period):
+        _pool(task_pool_holder().pool),
+        _entry(new task_pool::entry_type())
+    {
+        _entry->task_fcn = task_fcn;
+        _entry->period = boost::posix_time::microseconds(long(period*1e6));
+        _entry->next_run = boost::get_system_time();
+        _entry->busy = false;
+        _entry->notified = false;
+        _pool->add(_entry);
+    }
+
+    ~pooled_task_impl(void){
+        _pool->remove(_entry);
+    }
+
+    void notify(void){
+        _pool->notify(_entry);
+    }
+
+private:
+    boost::shared_ptr<task_pool> _pool;
+    task_pool::entry_sptr _entry;
+};
+
+pooled_task::sptr pooled_task::make(const task_fcn_type &task_fcn, const double period){
+    return pooled_task::sptr(new pooled_task_impl(task_fcn, period));
 }
 
+/***********************************************************************
+ * Message tasks
+ **********************************************************************/
 msg_task::~msg_task(void){
     /* NOP */
 }
@@ -97,7 +296,8 @@ class msg_task_impl : public msg_task{
 public:
 
     msg_task_impl(const task_fcn_type &task_fcn):
-        _spawn_barrier(2)
+        _spawn_barrier(2),
+        _dump_count(0)
     {
         (void)_thread_group.create_thread(boost::bind(&msg_task_impl::task_loop, this, task_fcn));
         _spawn_barrier.wait();
@@ -117,15 +317,18 @@ public:
      */
     msg_payload_t get_msg_from_dump_queue(uint32_t sid)
     {
-        boost::mutex::scoped_lock lock(_mutex);
         msg_payload_t b;
-        for (size_t i = 0; i < _dump_queue.size(); i++) {
-            if (sid == _dump_queue[i].first) {
-                b = _dump_queue[i].second;
-                _dump_queue.erase(_dump_queue.begin() + i);
-                break;
-            }
-        }
+        //the common case is an empty dump queue, check without locking
+        if (_dump_count.load(boost::memory_order_acquire) == 0) return b;
+
+        dump_bucket_type &bucket = get_dump_bucket(sid);
+        boost::mutex::scoped_lock lock(bucket.mutex);
+        dump_map_type::iterator it = bucket.queues.find(sid);
+        if (it == bucket.queues.end()) return b;
+        b.swap(it->second.front());
+        it->second.pop_front();
+        if (it->second.empty()) bucket.queues.erase(it);
+        _dump_count.fetch_sub(1, boost::memory_order_release);
         return b;
     }
 
@@ -134,6 +337,7 @@ private:
     void task_loop(const task_fcn_type &task_fcn){
         _running = true;
         _spawn_barrier.wait();
+        uhd::setup_thread("msg_task");
 
         try{
             while (_running){
@@ -143,8 +347,7 @@ private:
             	     * If a message gets stranded it is returned by task_fcn and then pushed to the dump_queue.
             	     * This way ctrl_cores can check dump_queue for missing messages.
             	     */
-            	    boost::mutex::scoped_lock lock(_mutex);
-            	    _dump_queue.push_back(buff.get() );
+            	    push_to_dump_queue(buff.get());
             	}
             }
         }
@@ -169,15 +372,40 @@ private:
         ;
     }
 
-    boost::mutex _mutex;
+    /*
+     * Stranded messages are queued per SID. The SIDs are spread over a
+     * few buckets with their own lock, so ctrl cores waiting on different
+     * SIDs don't contend with each other or with the task loop.
+     */
+    typedef boost::unordered_map<uint32_t, std::deque<msg_payload_t> > dump_map_type;
+    struct dump_bucket_type{
+        boost::mutex mutex;
+        dump_map_type queues;
+    };
+    static const size_t NUM_DUMP_BUCKETS = 16;
+
+    dump_bucket_type &get_dump_bucket(const uint32_t sid){
+        return _dump_buckets[(sid ^ (sid >> 16)) % NUM_DUMP_BUCKETS];
+    }
+
+    void push_to_dump_queue(msg_type_t &msg){
+        dump_bucket_type &bucket = get_dump_bucket(msg.first);
+        boost::mutex::scoped_lock lock(bucket.mutex);
+        std::deque<msg_payload_t> &queue = bucket.queues[msg.first];
+        queue.push_back(msg_payload_t());
+        queue.back().swap(msg.second);
+        _dump_count.fetch_add(1, boost::memory_order_release);
+    }
+
     boost::thread_group _thread_group;
     boost::barrier _spawn_barrier;
     bool _running;
 
     /*
-     * This queue holds stranded messages until a radio_ctrl_core grabs them via 'get_msg_from_dump_queue'.
+     * These queues hold stranded messages until a radio_ctrl_core grabs them via 'get_msg_from_dump_queue'.
      */
-    std::vector <msg_type_t> _dump_queue;
+    dump_bucket_type _dump_buckets[NUM_DUMP_BUCKETS];
+    boost::atomic<size_t> _dump_count;
 };
 
 msg_task::sptr msg_task::make(const task_fcn_type &task_fcn){
@@ -17,9 +17,15 @@
 
 #include <uhd/utils/thread_priority.hpp>
 #include <uhd/utils/msg.hpp>
+#include <uhd/utils/static.hpp>
 #include <uhd/exception.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
 #include <iostream>
+#include <map>
 
 bool uhd::set_thread_priority_safe(float priority, bool realtime){
     try{
@@ -46,12 +52,9 @@ static void check_priority_range(float priority){
 #ifdef HAVE_PTHREAD_SETSCHEDPARAM
     #include <pthread.h>
 
-    void uhd::set_thread_priority(float priority, bool realtime){
+    static void set_pthread_sched(int policy, float priority){
         check_priority_range(priority);
 
-        //when realtime is not enabled, use sched other
-        int policy = (realtime)? SCHED_RR : SCHED_OTHER;
-
         //we cannot have below normal priority, set to zero
         if (priority < 0) priority = 0;
 
@@ -66,6 +69,19 @@ static void check_priority_range(float priority){
         int ret = pthread_setschedparam(pthread_self(), policy, &sp);
         if (ret != 0) throw uhd::os_error("error in pthread_setschedparam");
     }
+
+    void uhd::set_thread_priority(float priority, bool realtime){
+        //when realtime is not enabled, use sched other
+        set_pthread_sched((realtime)? SCHED_RR : SCHED_OTHER, priority);
+    }
+
+    static void set_thread_sched(uhd::thread_sched_t sched, float priority){
+        switch (sched){
+        case uhd::THREAD_SCHED_FIFO: set_pthread_sched(SCHED_FIFO, priority); return;
+        case uhd::THREAD_SCHED_RR: set_pthread_sched(SCHED_RR, priority); return;
+        default: set_pthread_sched(SCHED_OTHER, priority); return;
+        }
+    }
 #endif /* HAVE_PTHREAD_SETSCHEDPARAM */
 
 /***********************************************************************
@@ -97,6 +113,11 @@ static void check_priority_range(float priority){
         if (SetThreadPriority(GetCurrentThread(), priorities[pri_index]) == 0)
             throw uhd::os_error("error in SetThreadPriority");
     }
+
+    static void set_thread_sched(uhd::thread_sched_t sched, float priority){
+        //there is no separate fifo class, both realtime classes map to the same
+        uhd::set_thread_priority(priority, sched != uhd::THREAD_SCHED_OTHER);
+    }
 #endif /* HAVE_WIN_SETTHREADPRIORITY */
 
 /***********************************************************************
@@ -107,4 +128,271 @@ static void check_priority_range(float priority){
         throw uhd::not_implemented_error("set thread priority not implemented");
     }
 
+    static void set_thread_sched(uhd::thread_sched_t, float){
+        throw uhd::not_implemented_error("set thread priority not implemented");
+    }
+
 #endif /* HAVE_THREAD_PRIO_DUMMY */
+
+/***********************************************************************
+ * Pthread API to set affinity
+ **********************************************************************/
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+    #include <pthread.h>
+
+    void uhd::set_thread_affinity(const std::vector<size_t> &cpu_affinity_list){
+        if (cpu_affinity_list.empty()) return;
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (size_t i = 0; i < cpu_affinity_list.size(); i++){
+            if (cpu_affinity_list[i] >= CPU_SETSIZE)
+                throw uhd::value_error("CPU index out of range for affinity mask");
+            CPU_SET(cpu_affinity_list[i], &cpu_set);
+        }
+
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+        if (ret != 0) throw uhd::os_error("error in pthread_setaffinity_np");
+    }
+#endif /* HAVE_PTHREAD_SETAFFINITY_NP */
+
+/***********************************************************************
+ * Windows API to set affinity
+ **********************************************************************/
+#ifdef HAVE_WIN_SETTHREADAFFINITYMASK
+    #include <windows.h>
+
+    void uhd::set_thread_affinity(const std::vector<size_t> &cpu_affinity_list){
+        if (cpu_affinity_list.empty()) return;
+
+    #ifdef HAVE_WIN_SETTHREADGROUPAFFINITY
+        //Hosts with more than 64 CPUs split them into processor groups.
+        //The CPU indexes count through the groups in order,
+        //and a thread can only be placed within one group.
+        GROUP_AFFINITY affinity;
+        ZeroMemory(&affinity, sizeof(affinity));
+        for (size_t i = 0; i < cpu_affinity_list.size(); i++){
+            size_t cpu = cpu_affinity_list[i];
+            WORD group = 0;
+            const WORD num_groups = GetActiveProcessorGroupCount();
+            while (group < num_groups and cpu >= GetActiveProcessorCount(group)){
+                cpu -= GetActiveProcessorCount(group);
+                group++;
+            }
+            if (group == num_groups or cpu >= sizeof(KAFFINITY)*8)
+                throw uhd::value_error("CPU index out of range for affinity mask");
+            if (i != 0 and group != affinity.Group)
+                throw uhd::value_error("the CPUs for the affinity mask are in different processor groups");
+            affinity.Group = group;
+            affinity.Mask |= KAFFINITY(1) << cpu;
+        }
+
+        if (SetThreadGroupAffinity(GetCurrentThread(), &affinity, NULL) == 0)
+            throw uhd::os_error("error in SetThreadGroupAffinity");
+    #else
+        DWORD_PTR cpu_set = 0;
+        for (size_t i = 0; i < cpu_affinity_list.size(); i++){
+            if (cpu_affinity_list[i] >= sizeof(DWORD_PTR)*8)
+                throw uhd::value_error("CPU index out of range for affinity mask");
+            cpu_set |= DWORD_PTR(1) << cpu_affinity_list[i];
+        }
+
+        if (SetThreadAffinityMask(GetCurrentThread(), cpu_set) == 0)
+            throw uhd::os_error("error in SetThreadAffinityMask");
+    #endif /* HAVE_WIN_SETTHREADGROUPAFFINITY */
+    }
+#endif /* HAVE_WIN_SETTHREADAFFINITYMASK */
+
+/***********************************************************************
+ * Unimplemented API to set affinity
+ **********************************************************************/
+#ifdef HAVE_THREAD_AFFINITY_DUMMY
+    void uhd::set_thread_affinity(const std::vector<size_t> &cpu_affinity_list){
+        if (cpu_affinity_list.empty()) return;
+        throw uhd::not_implemented_error("set thread affinity not implemented");
+    }
+#endif /* HAVE_THREAD_AFFINITY_DUMMY */
+
+/***********************************************************************
+ * Windows multimedia class scheduler (MMCSS)
+ **********************************************************************/
+#ifdef HAVE_WIN_AVRT
+    #include <windows.h>
+    #include <avrt.h>
+
+    void uhd::set_thread_mmcss(const std::string &task, float priority){
+        if (task.empty()) return;
+        check_priority_range(priority);
+
+        //the registration is kept until the thread exits
+        DWORD task_index = 0;
+        HANDLE handle = AvSetMmThreadCharacteristicsA(task.c_str(), &task_index);
+        if (handle == NULL) throw uhd::os_error(str(boost::format(
+            "error in AvSetMmThreadCharacteristics for task \"%s\" (error %d)"
+        ) % task % GetLastError()));
+
+        //scale the priority value to the constants
+        AVRT_PRIORITY priorities[] = {
+            AVRT_PRIORITY_LOW, AVRT_PRIORITY_NORMAL, AVRT_PRIORITY_HIGH, AVRT_PRIORITY_CRITICAL
+        };
+        size_t pri_index = size_t((priority+1.0)*4/2.0); // -1 -> 0, +1 -> 4
+        if (pri_index > 3) pri_index = 3;
+        if (AvSetMmThreadPriority(handle, priorities[pri_index]) == 0)
+            throw uhd::os_error("error in AvSetMmThreadPriority");
+    }
+#else
+    void uhd::set_thread_mmcss(const std::string &task, float){
+        if (task.empty()) return;
+        throw uhd::not_implemented_error("multimedia class scheduling not implemented");
+    }
+#endif /* HAVE_WIN_AVRT */
+
+/***********************************************************************
+ * Thread names
+ **********************************************************************/
+#ifdef HAVE_PTHREAD_SETNAME_NP
+    #include <pthread.h>
+
+    void uhd::set_thread_name(const std::string &name){
+        //the name is limited to 16 bytes including the terminator
+        (void)pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+    }
+#else
+    void uhd::set_thread_name(const std::string &){
+        /* NOP */
+    }
+#endif /* HAVE_PTHREAD_SETNAME_NP */
+
+/***********************************************************************
+ * Thread configuration by role
+ **********************************************************************/
+uhd::thread_config_t::thread_config_t(void):
+    sched(THREAD_SCHED_INHERIT), priority(default_thread_priority)
+{
+    /* NOP */
+}
+
+namespace {
+    struct thread_registry_type{
+        boost::mutex mutex;
+        std::map<std::string, uhd::thread_config_t> configs;
+        uhd::thread_start_hook_t hook;
+    };
+}
+
+UHD_SINGLETON_FCN(thread_registry_type, get_thread_registry);
+
+static uhd::thread_sched_t string_to_sched(const std::string &sched){
+    if (sched == "other") return uhd::THREAD_SCHED_OTHER;
+    if (sched == "rr") return uhd::THREAD_SCHED_RR;
+    if (sched == "fifo") return uhd::THREAD_SCHED_FIFO;
+    throw uhd::value_error("unknown thread scheduling class: " + sched);
+}
+
+void uhd::set_thread_config(const std::string &role, const thread_config_t &config){
+    thread_registry_type &registry = get_thread_registry();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    registry.configs[role] = config;
+}
+
+void uhd::set_thread_config(const device_addr_t &args){
+    static const std::string prefix = "thread_";
+    thread_registry_type &registry = get_thread_registry();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    BOOST_FOREACH(const std::string &key, args.keys()){
+        if (not boost::algorithm::starts_with(key, prefix)) continue;
+        const size_t split = key.rfind('_');
+        if (split <= prefix.size()) continue;
+        const std::string role = key.substr(prefix.size(), split - prefix.size());
+        const std::string field = key.substr(split + 1);
+        const std::string value = boost::algorithm::trim_copy(args[key]);
+        if (field == "cpus"){
+            std::vector<std::string> toks;
+            std::vector<size_t> cpus;
+            boost::split(toks, value, boost::is_any_of(": "), boost::token_compress_on);
+            BOOST_FOREACH(const std::string &tok, toks){
+                if (tok.empty()) continue;
+                try{
+                    cpus.push_back(boost::lexical_cast<size_t>(tok));
+                }catch(const boost::bad_lexical_cast &){
+                    throw uhd::value_error(str(boost::format("invalid CPU list for %s: %s") % key % value));
+                }
+            }
+            registry.configs[role].cpus = cpus;
+        }
+        else if (field == "sched"){
+            registry.configs[role].sched = string_to_sched(boost::algorithm::to_lower_copy(value));
+        }
+        else if (field == "prio"){
+            float priority;
+            try{
+                priority = boost::lexical_cast<float>(value);
+            }catch(const boost::bad_lexical_cast &){
+                throw uhd::value_error(str(boost::format("invalid priority for %s: %s") % key % value));
+            }
+            check_priority_range(priority);
+            thread_config_t &config = registry.configs[role];
+            config.priority = priority;
+            //a priority alone selects realtime scheduling, like set_thread_priority()
+            if (config.sched == THREAD_SCHED_INHERIT) config.sched = THREAD_SCHED_RR;
+        }
+        else if (field == "mmcss"){
+            registry.configs[role].mmcss_task = value;
+        }
+    }
+}
+
+uhd::thread_config_t uhd::get_thread_config(const std::string &role){
+    thread_registry_type &registry = get_thread_registry();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    if (registry.configs.count(role) == 0) return thread_config_t();
+    return registry.configs[role];
+}
+
+void uhd::set_thread_start_hook(const thread_start_hook_t &hook){
+    thread_registry_type &registry = get_thread_registry();
+    boost::mutex::scoped_lock lock(registry.mutex);
+    registry.hook = hook;
+}
+
+void uhd::setup_thread(const std::string &role){
+    set_thread_name("uhd_" + role);
+
+    thread_config_t config;
+    thread_start_hook_t hook;
+    {
+        thread_registry_type &registry = get_thread_registry();
+        boost::mutex::scoped_lock lock(registry.mutex);
+        if (registry.configs.count(role)) config = registry.configs[role];
+        hook = registry.hook;
+    }
+
+    try{
+        set_thread_affinity(config.cpus);
+    }catch(const std::exception &e){
+        UHD_MSG(warning) << boost::format(
+            "Unable to set the CPU affinity of the %s thread.\n%s\n"
+        ) % role % e.what();
+    }
+    if (config.sched != THREAD_SCHED_INHERIT) try{
+        set_thread_sched(config.sched, config.priority);
+    }catch(const std::exception &e){
+        UHD_MSG(warning) << boost::format(
+            "Unable to set the scheduling of the %s thread.\n%s\n"
+        ) % role % e.what();
+    }
+    if (not config.mmcss_task.empty()) try{
+        set_thread_mmcss(config.mmcss_task, config.priority);
+    }catch(const std::exception &e){
+        UHD_MSG(warning) << boost::format(
+            "Unable to register the %s thread with the multimedia class scheduler.\n%s\n"
+        ) % role % e.what();
+    }
+    if (hook) try{
+        hook(role);
+    }catch(const std::exception &e){
+        UHD_MSG(warning) << boost::format(
+            "The thread start hook failed for the %s thread.\n%s\n"
+        ) % role % e.what();
+    }
+}
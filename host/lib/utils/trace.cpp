@@ -0,0 +1,184 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/utils/trace.hpp>
+#include <uhd/utils/static.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/exception.hpp>
+#include <boost/atomic.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+using namespace uhd::trace;
+
+//! The number of events in the ring of each thread, a power of two
+static const size_t TRACE_RING_SIZE = 1 << 14;
+
+static const char *point_names[NUM_POINTS] = {
+    "recv_buff_get",
+    "recv_buff_release",
+    "send_buff_get",
+    "send_buff_commit",
+    "hdr_unpack",
+    "recv_align",
+    "recv_convert",
+    "send_convert",
+    "fc_send",
+    "fc_recv",
+    "timed_cmd"
+};
+
+/***********************************************************************
+ * Per thread event rings
+ **********************************************************************/
+struct trace_event_type{
+    int64_t time_ns;
+    uint64_t arg;
+    uint16_t point;
+    char phase;
+};
+
+struct trace_ring_type{
+    trace_ring_type(const size_t tid):
+        tid(tid), count(0), events(TRACE_RING_SIZE)
+    {
+        /* NOP */
+    }
+
+    const size_t tid;
+    //only written by the owning thread, the total number of events recorded
+    boost::atomic<uint64_t> count;
+    std::vector<trace_event_type> events;
+};
+
+static boost::atomic<bool> trace_enabled(false);
+
+namespace {
+    class trace_registry_type{
+    public:
+        trace_registry_type(void){
+            const char *path = std::getenv("UHD_TRACE_FILE");
+            if (path != NULL and path[0] != '\0'){
+                _exit_path = path;
+                trace_enabled = true;
+            }
+        }
+
+        ~trace_registry_type(void){
+            if (_exit_path.empty()) return;
+            trace_enabled = false;
+            try{
+                this->write(_exit_path);
+            }catch(...){
+                //nothing left to report to at exit
+            }
+        }
+
+        //! get the ring of the calling thread, register it on first use
+        trace_ring_type &get_thread_ring(void){
+            if (_thread_ring.get() == NULL){
+                boost::mutex::scoped_lock lock(_mutex);
+                boost::shared_ptr<trace_ring_type> ring(new trace_ring_type(_rings.size() + 1));
+                _rings.push_back(ring);
+                _thread_ring.reset(new boost::shared_ptr<trace_ring_type>(ring));
+            }
+            return **_thread_ring;
+        }
+
+        void clear(void){
+            boost::mutex::scoped_lock lock(_mutex);
+            BOOST_FOREACH(const boost::shared_ptr<trace_ring_type> &ring, _rings){
+                ring->count = 0;
+            }
+        }
+
+        void write(const std::string &path){
+            std::ofstream out(path.c_str());
+            if (not out) throw uhd::io_error("trace: cannot open " + path);
+
+            boost::mutex::scoped_lock lock(_mutex);
+            out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+            bool first = true;
+            BOOST_FOREACH(const boost::shared_ptr<trace_ring_type> &ring, _rings){
+                const uint64_t count = ring->count.load(boost::memory_order_acquire);
+                const uint64_t start = (count > TRACE_RING_SIZE)? count - TRACE_RING_SIZE : 0;
+                for (uint64_t i = start; i < count; i++){
+                    const trace_event_type &ev = ring->events[i & (TRACE_RING_SIZE - 1)];
+                    if (ev.point >= NUM_POINTS) continue;
+                    out << (first? "\n" : ",\n") << boost::format(
+                        "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,%s\"args\":{\"arg\":%u}}"
+                    ) % point_names[ev.point] % ev.phase % (ev.time_ns/1e3) % ring->tid
+                      % ((ev.phase == PHASE_INSTANT)? "\"s\":\"t\"," : "") % ev.arg;
+                    first = false;
+                }
+            }
+            out << "\n]}\n";
+            if (not out) throw uhd::io_error("trace: cannot write " + path);
+        }
+
+    private:
+        boost::mutex _mutex;
+        std::vector<boost::shared_ptr<trace_ring_type> > _rings;
+        boost::thread_specific_ptr<boost::shared_ptr<trace_ring_type> > _thread_ring;
+        std::string _exit_path;
+    };
+}
+
+UHD_SINGLETON_FCN(trace_registry_type, get_trace_registry);
+
+//enable tracing from the environment when the library is loaded
+UHD_STATIC_BLOCK(trace_registry_init){
+    (void)get_trace_registry();
+}
+
+/***********************************************************************
+ * Trace API
+ **********************************************************************/
+bool uhd::trace::is_enabled(void){
+    return trace_enabled.load(boost::memory_order_relaxed);
+}
+
+void uhd::trace::set_enabled(const bool enb){
+    //construct the registry before the first event
+    (void)get_trace_registry();
+    trace_enabled = enb;
+}
+
+void uhd::trace::record(const point_t point, const phase_t phase, const uint64_t arg){
+    trace_ring_type &ring = get_trace_registry().get_thread_ring();
+    const uint64_t index = ring.count.load(boost::memory_order_relaxed);
+    trace_event_type &ev = ring.events[index & (TRACE_RING_SIZE - 1)];
+    ev.time_ns = uhd::time_spec_t::get_system_time().to_ticks(1e9);
+    ev.arg = arg;
+    ev.point = uint16_t(point);
+    ev.phase = char(phase);
+    ring.count.store(index + 1, boost::memory_order_release);
+}
+
+void uhd::trace::clear(void){
+    get_trace_registry().clear();
+}
+
+void uhd::trace::write_chrome_trace(const std::string &path){
+    get_trace_registry().write(path);
+}
@@ -0,0 +1,229 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/usrp/acquisition_scheduler.hpp>
+#include <uhd/exception.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+#include <deque>
+#include <vector>
+
+static const double RATE = 1e6;
+
+/***********************************************************************
+ * A dummy device which runs the stream commands in its queue: each
+ * sample is the tick count of its time, so gaps are easy to spot
+ **********************************************************************/
+class dummy_rx_streamer : public uhd::rx_streamer{
+public:
+    dummy_rx_streamer(void):
+        max_queue_depth(0), num_timed_cmds(0), overflow_tick(-1),
+        _active(false), _remaining(0), _more(false), _tick(0)
+    {
+        /* NOP */
+    }
+
+    size_t get_num_channels(void) const{
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return 64;
+    }
+
+    size_t recv(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double = 0.1,
+        const bool = false
+    ){
+        metadata.reset();
+        bool start = false;
+        if (not _active){
+            if (_queue.empty()){
+                metadata.error_code = _more?
+                    uhd::rx_metadata_t::ERROR_CODE_BROKEN_CHAIN :
+                    uhd::rx_metadata_t::ERROR_CODE_TIMEOUT;
+                _more = false;
+                return 0;
+            }
+            const uhd::stream_cmd_t cmd = _queue.front();
+            _queue.pop_front();
+            _active = true;
+            _remaining = cmd.num_samps;
+            start = not _more;
+            if (not cmd.stream_now) _tick = cmd.time_spec.to_ticks(RATE);
+            _more = cmd.stream_mode == uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_MORE;
+        }
+
+        if (overflow_tick >= 0 and _tick >= overflow_tick){
+            overflow_tick = -1;
+            metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_OVERFLOW;
+            metadata.has_time_spec = true;
+            metadata.time_spec = uhd::time_spec_t::from_ticks(_tick, RATE);
+            return 0;
+        }
+
+        const size_t nsamps = std::min(std::min(nsamps_per_buff, _remaining), get_max_num_samps());
+        boost::uint64_t *samps = reinterpret_cast<boost::uint64_t *>(buffs[0]);
+        metadata.has_time_spec = true;
+        metadata.time_spec = uhd::time_spec_t::from_ticks(_tick, RATE);
+        metadata.start_of_burst = start;
+        for (size_t i = 0; i < nsamps; i++) samps[i] = boost::uint64_t(_tick++);
+        _remaining -= nsamps;
+        if (_remaining == 0){
+            _active = false;
+            metadata.end_of_burst = not _more;
+        }
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const uhd::stream_cmd_t &stream_cmd){
+        cmds.push_back(stream_cmd);
+        if (stream_cmd.stream_mode == uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS){
+            _queue.clear();
+            _active = false;
+            _more = false;
+            return;
+        }
+        if (not stream_cmd.stream_now) num_timed_cmds++;
+        _queue.push_back(stream_cmd);
+        max_queue_depth = std::max(max_queue_depth, _queue.size() + (_active? 1 : 0));
+    }
+
+    std::vector<uhd::stream_cmd_t> cmds;
+    size_t max_queue_depth;
+    size_t num_timed_cmds;
+    long long overflow_tick;
+
+private:
+    std::deque<uhd::stream_cmd_t> _queue;
+    bool _active;
+    size_t _remaining;
+    bool _more;
+    long long _tick;
+};
+
+static uhd::usrp::acquisition_t make_acq(const long long start_tick, const size_t nsamps){
+    return uhd::usrp::acquisition_t(uhd::time_spec_t::from_ticks(start_tick, RATE), nsamps);
+}
+
+/***********************************************************************
+ * Test cases
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_acquisition_scheduler_gapless){
+    boost::shared_ptr<dummy_rx_streamer> rx_stream = boost::make_shared<dummy_rx_streamer>();
+    uhd::usrp::acquisition_scheduler::sptr scheduler = uhd::usrp::acquisition_scheduler::make(
+        rx_stream, RATE, uhd::device_addr_t("max_cmd_samps=100,cmd_depth=3"));
+
+    //three back to back acquisitions, then one after a gap
+    std::vector<uhd::usrp::acquisition_t> acqs;
+    acqs.push_back(make_acq(1000, 250));
+    acqs.push_back(make_acq(1250, 300));
+    acqs.push_back(make_acq(1550, 50));
+    acqs.push_back(make_acq(5000, 120));
+    scheduler->schedule(acqs);
+    BOOST_CHECK_EQUAL(scheduler->get_num_pending(), 4);
+
+    std::vector<boost::uint64_t> buff(80);
+    for (size_t i = 0; i < acqs.size(); i++){
+        size_t offset = 0;
+        while (offset < acqs[i].nsamps){
+            uhd::rx_metadata_t md;
+            const size_t nsamps = scheduler->recv(&buff.front(), buff.size(), md, 1.0);
+            BOOST_REQUIRE_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+            BOOST_REQUIRE(nsamps > 0);
+            BOOST_CHECK_EQUAL(scheduler->get_acquisition_index(), i);
+            BOOST_CHECK_EQUAL(md.start_of_burst, offset == 0);
+            for (size_t j = 0; j < nsamps; j++){
+                BOOST_REQUIRE_EQUAL(buff[j], boost::uint64_t(acqs[i].start.to_ticks(RATE) + offset + j));
+            }
+            offset += nsamps;
+            BOOST_CHECK_EQUAL(md.end_of_burst, offset == acqs[i].nsamps);
+            BOOST_REQUIRE(offset <= acqs[i].nsamps);
+        }
+    }
+    BOOST_CHECK_EQUAL(scheduler->get_num_pending(), 0);
+    BOOST_CHECK_EQUAL(scheduler->get_num_dropped(), 0);
+
+    //one timed command for the chained acquisitions and one after the gap
+    BOOST_CHECK_EQUAL(rx_stream->num_timed_cmds, 2);
+    BOOST_CHECK(rx_stream->max_queue_depth <= 3);
+    for (size_t i = 0; i < rx_stream->cmds.size(); i++){
+        BOOST_CHECK(rx_stream->cmds[i].num_samps <= 100);
+    }
+
+    uhd::rx_metadata_t md;
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 0.0), 0);
+    BOOST_CHECK_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
+BOOST_AUTO_TEST_CASE(test_acquisition_scheduler_resync){
+    boost::shared_ptr<dummy_rx_streamer> rx_stream = boost::make_shared<dummy_rx_streamer>();
+    uhd::usrp::acquisition_scheduler::sptr scheduler = uhd::usrp::acquisition_scheduler::make(
+        rx_stream, RATE, uhd::device_addr_t("resync_lead=0.001"));
+    rx_stream->overflow_tick = 1128;
+
+    //the second acquisition starts too soon after the overflow
+    std::vector<uhd::usrp::acquisition_t> acqs;
+    acqs.push_back(make_acq(1000, 200));
+    acqs.push_back(make_acq(1200, 200));
+    acqs.push_back(make_acq(10000, 100));
+    scheduler->schedule(acqs);
+
+    std::vector<boost::uint64_t> buff(100);
+    uhd::rx_metadata_t md;
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 1.0), 64);
+    BOOST_CHECK(md.start_of_burst);
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 1.0), 64);
+    BOOST_CHECK(not md.start_of_burst);
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 1.0), 0);
+    BOOST_CHECK_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK(md.end_of_burst);
+    BOOST_CHECK_EQUAL(scheduler->get_acquisition_index(), 0);
+    BOOST_CHECK_EQUAL(scheduler->get_num_dropped(), 2);
+    BOOST_CHECK_EQUAL(scheduler->get_num_pending(), 1);
+
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 1.0), 64);
+    BOOST_CHECK_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+    BOOST_CHECK_EQUAL(scheduler->get_acquisition_index(), 2);
+    BOOST_CHECK(md.start_of_burst);
+    BOOST_CHECK_EQUAL(buff[0], 10000);
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 1.0), 36);
+    BOOST_CHECK(md.end_of_burst);
+    BOOST_CHECK_EQUAL(scheduler->get_num_pending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_acquisition_scheduler_bad_args){
+    boost::shared_ptr<dummy_rx_streamer> rx_stream = boost::make_shared<dummy_rx_streamer>();
+    BOOST_CHECK_THROW(uhd::usrp::acquisition_scheduler::make(
+        rx_stream, RATE, uhd::device_addr_t("cmd_depth=1")), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::usrp::acquisition_scheduler::make(
+        rx_stream, 0.0), uhd::value_error);
+
+    uhd::usrp::acquisition_scheduler::sptr scheduler =
+        uhd::usrp::acquisition_scheduler::make(rx_stream, RATE);
+    std::vector<uhd::usrp::acquisition_t> acqs;
+    acqs.push_back(make_acq(1000, 200));
+    acqs.push_back(make_acq(1100, 200));
+    BOOST_CHECK_THROW(scheduler->schedule(acqs), uhd::value_error);
+    acqs.clear();
+    acqs.push_back(make_acq(1000, 0));
+    BOOST_CHECK_THROW(scheduler->schedule(acqs), uhd::value_error);
+}
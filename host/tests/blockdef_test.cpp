@@ -92,3 +92,15 @@ BOOST_AUTO_TEST_CASE(test_regs) {
     BOOST_CHECK_EQUAL(user_regs["RB_MAGNITUDE_OUT"], 1);
 }
 
+
+BOOST_AUTO_TEST_CASE(test_shared) {
+    // The definitions are only read once, and shared between blocks:
+    blockdef::sptr fft0 = blockdef::make_from_noc_id(0xFF70000000000000);
+    blockdef::sptr fft1 = blockdef::make_from_noc_id(0xFF70000000000000);
+    BOOST_REQUIRE(fft0);
+    BOOST_CHECK(fft0 == fft1);
+    BOOST_CHECK_EQUAL(fft0->noc_id(), 0xFF70000000000000);
+
+    // Unknown NoC IDs don't find anything, also not through the index:
+    BOOST_CHECK(not blockdef::make_from_noc_id(0x1234567812345678));
+}
@@ -0,0 +1,103 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/transport/buffer_pool.hpp>
+#include <uhd/exception.hpp>
+#include <boost/bind.hpp>
+#include <cstdlib>
+
+using namespace uhd::transport;
+
+//! Counts the calls of an allocator and remembers the last block
+struct allocator_calls_type{
+    allocator_calls_type(void): num_alloc(0), num_free(0), num_register(0), num_unregister(0), mem(NULL), len(0) {}
+    size_t num_alloc, num_free, num_register, num_unregister;
+    void *mem;
+    size_t len;
+};
+
+static void *counted_alloc(allocator_calls_type *calls, const size_t len){
+    calls->num_alloc++;
+    calls->len = len;
+    return calls->mem = std::malloc(len);
+}
+
+static void counted_free(allocator_calls_type *calls, void *mem, const size_t){
+    calls->num_free++;
+    std::free(mem);
+}
+
+static void counted_register(allocator_calls_type *calls, void *mem, const size_t len){
+    calls->num_register++;
+    calls->mem = mem;
+    calls->len = len;
+}
+
+static void counted_unregister(allocator_calls_type *calls, void *mem, const size_t){
+    BOOST_CHECK(mem == calls->mem);
+    calls->num_unregister++;
+}
+
+//! Is every buffer of the pool in the last block of the allocator?
+static bool pool_in_block(buffer_pool::sptr pool, const size_t buff_size, const allocator_calls_type &calls){
+    const char *begin = static_cast<const char *>(calls.mem);
+    for (size_t i = 0; i < pool->size(); i++){
+        const char *buff = static_cast<const char *>(pool->at(i));
+        if (buff < begin or buff + buff_size > begin + calls.len) return false;
+    }
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(test_buffer_pool_allocator){
+    allocator_calls_type calls;
+    buffer_pool::allocator_type allocator;
+    allocator.alloc = boost::bind(&counted_alloc, &calls, _1);
+    allocator.free = boost::bind(&counted_free, &calls, _1, _2);
+    buffer_pool::register_allocator("test_alloc", allocator);
+
+    buffer_pool::sptr pool = buffer_pool::make(4, 100, 64, uhd::device_addr_t("buff_allocator=test_alloc"));
+    BOOST_CHECK_EQUAL(calls.num_alloc, 1);
+    BOOST_CHECK(pool_in_block(pool, 100, calls));
+    for (size_t i = 0; i < pool->size(); i++){
+        BOOST_CHECK_EQUAL(size_t(pool->at(i)) % 64, 0);
+    }
+    pool.reset();
+    BOOST_CHECK_EQUAL(calls.num_free, 1);
+
+    //alloc needs free
+    allocator.free.clear();
+    BOOST_CHECK_THROW(buffer_pool::register_allocator("test_alloc", allocator), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_buffer_pool_register){
+    allocator_calls_type calls;
+    buffer_pool::allocator_type allocator;
+    allocator.register_mem = boost::bind(&counted_register, &calls, _1, _2);
+    allocator.unregister_mem = boost::bind(&counted_unregister, &calls, _1, _2);
+    buffer_pool::register_allocator("test_register", allocator);
+
+    //the pool allocates the memory, and registers all of it once
+    buffer_pool::sptr pool = buffer_pool::make(8, 1000, 16, uhd::device_addr_t("buff_allocator=test_register"));
+    BOOST_CHECK_EQUAL(calls.num_register, 1);
+    BOOST_CHECK(pool_in_block(pool, 1000, calls));
+    BOOST_CHECK_EQUAL(calls.num_unregister, 0);
+    pool.reset();
+    BOOST_CHECK_EQUAL(calls.num_unregister, 1);
+
+    BOOST_CHECK_THROW(buffer_pool::make(1, 100, 16, uhd::device_addr_t("buff_allocator=nope")), uhd::key_error);
+}
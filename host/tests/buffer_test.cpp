@@ -17,7 +17,12 @@
 
 #include <boost/test/unit_test.hpp>
 #include <uhd/transport/bounded_buffer.hpp>
+#include <uhd/transport/mpsc_bounded_buffer.hpp>
+#include <uhd/transport/spsc_bounded_buffer.hpp>
 #include <boost/assign/list_of.hpp>
+#include <boost/foreach.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 
 using namespace boost::assign;
 using namespace uhd::transport;
@@ -62,3 +67,103 @@ BOOST_AUTO_TEST_CASE(test_bounded_buffer_with_pop_on_full){
     BOOST_CHECK(bb.pop_with_timed_wait(val, timeout));
     BOOST_CHECK_EQUAL(val, 3);
 }
+
+BOOST_AUTO_TEST_CASE(test_spsc_bounded_buffer_with_timed_wait){
+    spsc_bounded_buffer<int> bb(3);
+
+    //push elements, check for timeout
+    BOOST_CHECK(bb.push_with_timed_wait(0, timeout));
+    BOOST_CHECK(bb.push_with_timed_wait(1, timeout));
+    BOOST_CHECK(bb.push_with_timed_wait(2, timeout));
+    BOOST_CHECK(not bb.push_with_timed_wait(3, timeout));
+    BOOST_CHECK(not bb.push_with_haste(3));
+
+    int val;
+    //pop elements, check for timeout and check values
+    BOOST_CHECK(bb.pop_with_timed_wait(val, timeout));
+    BOOST_CHECK_EQUAL(val, 0);
+    BOOST_CHECK(bb.pop_with_haste(val));
+    BOOST_CHECK_EQUAL(val, 1);
+    BOOST_CHECK(bb.pop_with_timed_wait(val, timeout));
+    BOOST_CHECK_EQUAL(val, 2);
+    BOOST_CHECK(not bb.pop_with_timed_wait(val, timeout));
+    BOOST_CHECK(not bb.pop_with_haste(val));
+}
+
+static void spsc_producer(spsc_bounded_buffer<size_t> *bb, const size_t num){
+    for (size_t i = 0; i < num; i++) bb->push_with_wait(i);
+}
+
+BOOST_AUTO_TEST_CASE(test_spsc_bounded_buffer_threaded){
+    //no spinning at all and with spinning, to test the blocking waits
+    BOOST_FOREACH(const size_t spin_count, std::vector<size_t>(list_of(0)(1000))){
+        static const size_t num = 100000;
+        spsc_bounded_buffer<size_t> bb(4, spin_count);
+        boost::thread producer(boost::bind(&spsc_producer, &bb, num));
+        size_t val = 0, num_errors = 0;
+        for (size_t i = 0; i < num; i++){
+            if (i % 2) bb.pop_with_wait(val);
+            else BOOST_REQUIRE(bb.pop_with_timed_wait(val, 1.0));
+            if (val != i) num_errors++;
+        }
+        producer.join();
+        BOOST_CHECK_EQUAL(num_errors, 0);
+        BOOST_CHECK(not bb.pop_with_haste(val));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_mpsc_bounded_buffer_with_timed_wait){
+    mpsc_bounded_buffer<int> bb(4);
+
+    //push elements, the new element is dropped when full
+    BOOST_CHECK(bb.push_with_haste(0));
+    BOOST_CHECK(bb.push_with_haste(1));
+    BOOST_CHECK(bb.push_with_haste(2));
+    BOOST_CHECK(bb.push_with_haste(3));
+    BOOST_CHECK(not bb.push_with_haste(4));
+
+    int val;
+    //pop elements, check for timeout and check values
+    BOOST_CHECK(bb.pop_with_timed_wait(val, timeout));
+    BOOST_CHECK_EQUAL(val, 0);
+    BOOST_CHECK(bb.pop_with_haste(val));
+    BOOST_CHECK_EQUAL(val, 1);
+    BOOST_CHECK(bb.push_with_haste(5));
+    BOOST_CHECK(bb.pop_with_timed_wait(val, timeout));
+    BOOST_CHECK_EQUAL(val, 2);
+    BOOST_CHECK(bb.pop_with_timed_wait(val, timeout));
+    BOOST_CHECK_EQUAL(val, 3);
+    BOOST_CHECK(bb.pop_with_timed_wait(val, timeout));
+    BOOST_CHECK_EQUAL(val, 5);
+    BOOST_CHECK(not bb.pop_with_timed_wait(val, timeout));
+    BOOST_CHECK(not bb.pop_with_haste(val));
+}
+
+static void mpsc_producer(mpsc_bounded_buffer<size_t> *bb, const size_t producer, const size_t num){
+    for (size_t i = 0; i < num; i++){
+        while (not bb->push_with_haste(producer*num + i)) boost::this_thread::yield();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_mpsc_bounded_buffer_threaded){
+    static const size_t num = 50000;
+    static const size_t num_producers = 4;
+    mpsc_bounded_buffer<size_t> bb(8);
+    boost::thread_group producers;
+    for (size_t p = 0; p < num_producers; p++){
+        producers.create_thread(boost::bind(&mpsc_producer, &bb, p, num));
+    }
+
+    //the elements of each producer arrive in order
+    std::vector<size_t> next(num_producers, 0);
+    size_t val = 0, num_errors = 0;
+    for (size_t i = 0; i < num*num_producers; i++){
+        if (i % 2) bb.pop_with_wait(val);
+        else BOOST_REQUIRE(bb.pop_with_timed_wait(val, 1.0));
+        const size_t p = val / num;
+        if (p >= num_producers or val % num != next[p]++) num_errors++;
+    }
+    producers.join_all();
+    BOOST_CHECK_EQUAL(num_errors, 0);
+    BOOST_CHECK(not bb.pop_with_haste(val));
+}
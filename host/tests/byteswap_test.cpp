@@ -17,6 +17,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <uhd/utils/byteswap.hpp>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(test_byteswap16){
     uint16_t x = 0x0123;
@@ -37,3 +38,28 @@ BOOST_AUTO_TEST_CASE(test_byteswap64){
     BOOST_CHECK_EQUAL(uhd::byteswap(x), y);
 }
 
+
+template <typename T>
+static void test_byteswap_array(const T seed){
+    //cover the vector loop, the tail, and swapping in place
+    for (size_t num = 0; num < 40; num++){
+        std::vector<T> in(num), out(num);
+        for (size_t i = 0; i < num; i++) in[i] = T(seed*(i+1));
+        uhd::byteswap(in.empty()? NULL : &in.front(), out.empty()? NULL : &out.front(), num);
+        for (size_t i = 0; i < num; i++){
+            BOOST_CHECK_EQUAL(out[i], uhd::byteswap(in[i]));
+        }
+        if (num == 0) continue;
+        uhd::ntohx(&out.front(), &out.front(), num);
+        uhd::htowx(&out.front(), &out.front(), num);
+        for (size_t i = 0; i < num; i++){
+            BOOST_CHECK_EQUAL(out[i], uhd::htowx(uhd::ntohx(uhd::byteswap(in[i]))));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_byteswap_arrays){
+    test_byteswap_array<uint16_t>(0x0123);
+    test_byteswap_array<uint32_t>(0x01234567);
+    test_byteswap_array<uint64_t>(0x01234567 | (uint64_t(0x89abcdef) << 32));
+}
@@ -16,9 +16,11 @@
 //
 
 #include <uhd/transport/chdr.hpp>
+#include "../lib/transport/chdr_codec.hpp"
 #include <uhd/utils/byteswap.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -142,3 +144,37 @@ BOOST_AUTO_TEST_CASE(test_with_chdr_err){
     pack_and_unpack(if_packet_info);
 }
 
+template <uhd::endianness_t endianness>
+static void check_header_template(void)
+{
+    chdr::header_template hdr_template;
+    hdr_template.set<endianness>(if_packet_info_t::PACKET_TYPE_DATA, 0xAABBCCDD);
+
+    for (size_t n = 0; n < 4; n++){
+        if_packet_info_t if_packet_info;
+        if_packet_info.packet_type = if_packet_info_t::PACKET_TYPE_DATA;
+        if_packet_info.eob = (n & 1) != 0;
+        if_packet_info.packet_count = 4094 + n;
+        if_packet_info.has_tsf = (n & 2) != 0;
+        if_packet_info.tsf = 0x1234567890ABCDEFull;
+        if_packet_info.sid = 0xAABBCCDD;
+        if_packet_info.num_payload_words32 = 24;
+        if_packet_info.num_payload_bytes = 95;
+
+        //the template must match the codec and leave the payload alone
+        uint32_t expected[8], packed[8];
+        std::fill(expected, expected+8, 0x55555555);
+        std::fill(packed, packed+8, 0x55555555);
+        if_packet_info_t expected_info = if_packet_info;
+        chdr::codec<endianness>::pack(expected, expected_info);
+        hdr_template.pack<endianness>(packed, if_packet_info);
+        BOOST_CHECK_EQUAL_COLLECTIONS(expected, expected+8, packed, packed+8);
+        BOOST_CHECK_EQUAL(if_packet_info.num_header_words32, expected_info.num_header_words32);
+        BOOST_CHECK_EQUAL(if_packet_info.num_packet_words32, expected_info.num_packet_words32);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_chdr_header_template){
+    check_header_template<uhd::ENDIANNESS_BIG>();
+    check_header_template<uhd::ENDIANNESS_LITTLE>();
+}
@@ -16,13 +16,17 @@
 //
 
 #include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/byteswap.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/foreach.hpp>
 #include <stdint.h>
 #include <boost/assign/list_of.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 #include <complex>
 #include <vector>
 #include <cstdlib>
+#include <cmath>
 #include <iostream>
 
 using namespace uhd;
@@ -206,6 +210,195 @@ BOOST_AUTO_TEST_CASE(test_convert_types_le_fc64){
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_convert_types_wide_simd){
+    //the AVX2 and AVX-512 converters handle 8 or 16 samples per loop,
+    //so run lengths long enough to cover the vector loops and the tails
+    BOOST_FOREACH(const std::string &otw, std::vector<std::string>(
+        boost::assign::list_of("sc16_item32_le")("sc16_item32_be")
+    )){
+        convert::id_type id;
+        id.num_inputs = 1;
+        id.output_format = otw;
+        id.num_outputs = 1;
+        for (size_t nsamps = 16; nsamps < 48; nsamps++){
+            id.input_format = "sc16";
+            test_convert_types_sc16(nsamps, id);
+            id.input_format = "fc32";
+            test_convert_types_for_floats<fc32_t>(nsamps, id);
+            id.input_format = "fc64";
+            test_convert_types_for_floats<fc64_t>(nsamps, id);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_infos){
+    convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_le";
+    id.num_outputs = 1;
+
+    const std::vector<convert::converter_info_type> infos = convert::get_converter_infos(id);
+    BOOST_REQUIRE(not infos.empty());
+    BOOST_CHECK_EQUAL(infos.back().name, "generic");
+    BOOST_CHECK_EQUAL(infos.back().prio, 0);
+    for (size_t i = 1; i < infos.size(); i++){
+        BOOST_CHECK(infos[i-1].prio > infos[i].prio);
+    }
+
+    //every listed converter can be selected by name
+    BOOST_FOREACH(const convert::converter_info_type &info, infos){
+        BOOST_TEST_MESSAGE(id.to_string() << ": " << info.to_string());
+        BOOST_CHECK(convert::get_converter(id, info.name)());
+    }
+    BOOST_CHECK_THROW(convert::get_converter(id, "no_such_converter"), uhd::key_error);
+
+    id.input_format = "no_such_format";
+    BOOST_CHECK(convert::get_converter_infos(id).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_all_simd){
+    //compare every registered converter (not only the best one) against the generic one
+    BOOST_FOREACH(const std::string &otw, std::vector<std::string>(
+        boost::assign::list_of("sc16_item32_le")("sc16_item32_be")
+    )){
+        convert::id_type id;
+        id.input_format = "fc32";
+        id.num_inputs = 1;
+        id.output_format = otw;
+        id.num_outputs = 1;
+        convert::id_type out_id = id;
+        std::swap(out_id.input_format, out_id.output_format);
+
+        std::vector<fc32_t> input(40), output(40);
+        BOOST_FOREACH(fc32_t &in, input) in = fc32_t(
+            (std::rand()/(float(RAND_MAX)/2)) - 1,
+            (std::rand()/(float(RAND_MAX)/2)) - 1
+        );
+        BOOST_FOREACH(const convert::converter_info_type &info, convert::get_converter_infos(id)){
+            BOOST_FOREACH(const convert::converter_info_type &out_info, convert::get_converter_infos(out_id)){
+                for (size_t nsamps = 1; nsamps <= input.size(); nsamps++){
+                    loopback(nsamps, id, out_id, input, output, info.prio, out_info.prio);
+                    for (size_t i = 0; i < nsamps; i++){
+                        MY_CHECK_CLOSE(input[i].real(), output[i].real(), float(1./(1 << 14)));
+                        MY_CHECK_CLOSE(input[i].imag(), output[i].imag(), float(1./(1 << 14)));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/***********************************************************************
+ * Test the streaming store converters against the generic ones
+ **********************************************************************/
+template <typename data_type>
+static void test_convert_nt_converters(const std::string &cpu_format, const double scalar){
+    std::vector<uint32_t> input(80);
+    BOOST_FOREACH(uint32_t &in, input) in = uint32_t(std::rand()) ^ (uint32_t(std::rand()) << 16);
+    std::vector<const void *> input0(1, &input[0]);
+
+    BOOST_FOREACH(const std::string &otw, std::vector<std::string>(
+        boost::assign::list_of("sc16_item32_le")("sc16_item32_be")
+    )){
+        convert::id_type id;
+        id.input_format = otw;
+        id.num_inputs = 1;
+        id.output_format = cpu_format;
+        id.num_outputs = 1;
+        convert::converter::sptr generic = convert::get_converter(id, "generic")();
+        generic->set_scalar(scalar);
+
+        BOOST_FOREACH(const convert::converter_info_type &info, convert::get_converter_infos(id)){
+            if (not boost::algorithm::ends_with(info.name, "_nt")) continue;
+            BOOST_CHECK(info.prio < 0); //never picked by default
+            BOOST_TEST_MESSAGE("    converter " << info.to_string() << " from " << otw);
+            convert::converter::sptr c = convert::get_converter(id, info.name)();
+            c->set_scalar(scalar);
+
+            //the output offsets hit the alignment head, the lengths the tail
+            std::vector<data_type> expected(input.size() + 8), output(input.size() + 8);
+            for (size_t offset = 0; offset < 8; offset++){
+                for (size_t nsamps = 1; nsamps <= input.size(); nsamps++){
+                    std::fill(expected.begin(), expected.end(), data_type(0));
+                    std::fill(output.begin(), output.end(), data_type(0));
+                    std::vector<void *> output0(1, &expected[offset]), output1(1, &output[offset]);
+                    generic->conv(input0, output0, nsamps);
+                    c->conv(input0, output1, nsamps);
+                    BOOST_CHECK(expected == output);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_nt){
+    test_convert_nt_converters<fc32_t>("fc32", 1/32767.);
+    test_convert_nt_converters<sc16_t>("sc16", 1.0);
+}
+
+/***********************************************************************
+ * Test planar float to/from interleaved channels of items32
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_convert_types_planar_fc32){
+    const size_t nsamps_max = 21;
+    BOOST_FOREACH(const std::string &otw, std::vector<std::string>(
+        boost::assign::list_of("sc16_item32_le")("sc16_item32_be")
+    )){
+    BOOST_FOREACH(const size_t width, std::vector<size_t>(boost::assign::list_of(2)(4))){
+        convert::id_type in_id;
+        in_id.input_format = "fc32";
+        in_id.num_inputs = width;
+        in_id.output_format = otw;
+        in_id.num_outputs = 1;
+        convert::id_type out_id = in_id;
+        std::swap(out_id.input_format, out_id.output_format);
+        std::swap(out_id.num_inputs, out_id.num_outputs);
+        convert::id_type interleaved_id = out_id;
+        interleaved_id.num_outputs = 1;
+
+        std::vector<std::vector<fc32_t> > input(width, std::vector<fc32_t>(nsamps_max));
+        std::vector<std::vector<fc32_t> > output(width, std::vector<fc32_t>(nsamps_max));
+        std::vector<fc32_t> interleaved(nsamps_max*width);
+        std::vector<uint32_t> interm(nsamps_max*width);
+        std::vector<const void *> input0, input1(1, &interm[0]);
+        std::vector<void *> output0(1, &interm[0]), output1, output2(1, &interleaved[0]);
+        for (size_t w = 0; w < width; w++){
+            BOOST_FOREACH(fc32_t &in, input[w]) in = fc32_t(
+                (std::rand()/(float(RAND_MAX)/2)) - 1,
+                (std::rand()/(float(RAND_MAX)/2)) - 1
+            );
+            input0.push_back(&input[w][0]);
+            output1.push_back(&output[w][0]);
+        }
+        convert::converter::sptr c2 = convert::get_converter(interleaved_id)();
+        c2->set_scalar(1/32767.);
+
+        BOOST_FOREACH(const convert::converter_info_type &in_info, convert::get_converter_infos(in_id)){
+        BOOST_FOREACH(const convert::converter_info_type &out_info, convert::get_converter_infos(out_id)){
+            BOOST_TEST_MESSAGE("    " << width << " channels " << otw << ": "
+                << in_info.to_string() << ", " << out_info.to_string());
+            convert::converter::sptr c0 = convert::get_converter(in_id, in_info.name)();
+            convert::converter::sptr c1 = convert::get_converter(out_id, out_info.name)();
+            c0->set_scalar(32767.);
+            c1->set_scalar(1/32767.);
+            for (size_t nsamps = 1; nsamps <= nsamps_max; nsamps++){
+                c0->conv(input0, output0, nsamps);
+                c1->conv(input1, output1, nsamps);
+                c2->conv(input1, output2, nsamps*width);
+                for (size_t i = 0; i < nsamps; i++){
+                    for (size_t w = 0; w < width; w++){
+                        MY_CHECK_CLOSE(input[w][i].real(), output[w][i].real(), float(1./(1 << 14)));
+                        MY_CHECK_CLOSE(input[w][i].imag(), output[w][i].imag(), float(1./(1 << 14)));
+                        //the channels are interleaved sample by sample on the wire
+                        BOOST_CHECK_EQUAL(output[w][i], interleaved[i*width + w]);
+                    }
+                }
+            }
+        }}
+    }}
+}
+
 /***********************************************************************
  * Test float to/from sc12 conversion loopback
  **********************************************************************/
@@ -236,6 +429,68 @@ BOOST_AUTO_TEST_CASE(test_convert_types_be_sc12_with_fc32){
     }
 }
 
+/***********************************************************************
+ * Test every sc12 converter pair, starting at every offset into a block
+ **********************************************************************/
+template <typename data_type>
+static void test_convert_sc12_all_converters(
+    const std::string &cpu_format, const std::string &otw_format,
+    const std::vector<data_type> &input, const double tolerance
+){
+    convert::id_type in_id;
+    in_id.input_format = cpu_format;
+    in_id.num_inputs = 1;
+    in_id.output_format = otw_format;
+    in_id.num_outputs = 1;
+    convert::id_type out_id = in_id;
+    std::swap(out_id.input_format, out_id.output_format);
+
+    std::vector<data_type> output(input.size());
+    std::vector<uint32_t> interm(input.size()*3/4 + 4);
+    BOOST_FOREACH(const convert::converter_info_type &in_info, convert::get_converter_infos(in_id)){
+    BOOST_FOREACH(const convert::converter_info_type &out_info, convert::get_converter_infos(out_id)){
+        convert::converter::sptr c0 = convert::get_converter(in_id, in_info.name)();
+        convert::converter::sptr c1 = convert::get_converter(out_id, out_info.name)();
+        c0->set_scalar(32767.);
+        c1->set_scalar(1/32767.);
+        for (size_t offset = 0; offset < 4; offset++){
+            //the converters derive the position in the 3 line block from the address
+            char *otw = reinterpret_cast<char *>(&interm[0]) + 3*offset;
+            for (size_t nsamps = 1; nsamps <= input.size(); nsamps++){
+                std::vector<const void *> input0(1, &input[0]), input1(1, otw);
+                std::vector<void *> output0(1, otw), output1(1, &output[0]);
+                c0->conv(input0, output0, nsamps);
+                c1->conv(input1, output1, nsamps);
+                for (size_t i = 0; i < nsamps; i++){
+                    MY_CHECK_CLOSE(input[i].real(), output[i].real(), tolerance);
+                    MY_CHECK_CLOSE(input[i].imag(), output[i].imag(), tolerance);
+                }
+            }
+        }
+    }}
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_sc12_all_converters){
+    std::vector<fc32_t> input_fc32(40);
+    BOOST_FOREACH(fc32_t &in, input_fc32) in = fc32_t(
+        ((std::rand()/(float(RAND_MAX)/2)) - 1)/16,
+        ((std::rand()/(float(RAND_MAX)/2)) - 1)/16
+    );
+
+    //sc16 keeps the upper 12 bits
+    std::vector<sc16_t> input_sc16(40);
+    BOOST_FOREACH(sc16_t &in, input_sc16) in = sc16_t(
+        short(std::rand() & 0xfff0), short(std::rand() & 0xfff0)
+    );
+
+    BOOST_FOREACH(const std::string &otw, std::vector<std::string>(
+        boost::assign::list_of("sc12_item32_le")("sc12_item32_be")
+    )){
+        test_convert_sc12_all_converters(std::string("fc32"), otw, input_fc32, 1./(1 << 14));
+        test_convert_sc12_all_converters(std::string("sc16"), otw, input_sc16, 1);
+    }
+}
+
 /***********************************************************************
  * Test float to/from fc32 conversion loopback
  **********************************************************************/
@@ -356,6 +611,69 @@ BOOST_AUTO_TEST_CASE(test_convert_types_sc16_to_fc32){
     }
 }
 
+/***********************************************************************
+ * Test short to float conversion with gain and offset correction
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_convert_types_sc16_to_fc32_corrected){
+    const fc64_t gain(0.75, -0.5), offset(0.125, -0.25);
+
+    convert::id_type in_id;
+    in_id.input_format = "sc16";
+    in_id.num_inputs = 1;
+    in_id.num_outputs = 1;
+
+    const size_t nsamps = 37;
+    std::vector<sc16_t> input(nsamps);
+    BOOST_FOREACH(sc16_t &in, input) in = sc16_t(
+        std::rand()-(RAND_MAX/2),
+        std::rand()-(RAND_MAX/2)
+    );
+    std::vector<uint32_t> interm(nsamps);
+    std::vector<fc32_t> output(nsamps);
+    std::vector<const void *> input0(1, &input[0]), input1(1, &interm[0]);
+    std::vector<void *> output0(1, &interm[0]), output1(1, &output[0]);
+
+    BOOST_FOREACH(const std::string &otw, std::vector<std::string>(
+        boost::assign::list_of("sc16_item32_le")("sc16_item32_be")
+    )){
+        in_id.output_format = otw;
+        convert::id_type out_id = in_id;
+        std::swap(out_id.input_format, out_id.output_format);
+        out_id.output_format = "fc32";
+
+        convert::get_converter(in_id)()->conv(input0, output0, nsamps);
+
+        BOOST_FOREACH(const convert::converter_info_type &info, convert::get_converter_infos(out_id)){
+            convert::converter::sptr c1 = convert::get_converter(out_id, info.name)();
+            c1->set_scalar(1/32767.);
+            try{
+                c1->set_correction(gain, offset);
+            }catch(const uhd::not_implemented_error &){
+                continue; //not all converters support corrections
+            }
+            BOOST_TEST_MESSAGE("    converter " << info.to_string() << " with " << otw);
+            //odd sample counts hit the tail of the SIMD converters
+            for (size_t n = nsamps-17; n <= nsamps; n++){
+                std::fill(output.begin(), output.end(), fc32_t(0, 0));
+                c1->conv(input1, output1, n);
+                for (size_t i = 0; i < n; i++){
+                    const fc64_t expected = fc64_t(input[i].real(), input[i].imag())/32767. * gain + offset;
+                    MY_CHECK_CLOSE(expected.real(), output[i].real(), 1e-5);
+                    MY_CHECK_CLOSE(expected.imag(), output[i].imag(), 1e-5);
+                }
+            }
+        }
+    }
+
+    //the fixed point output can not be corrected
+    in_id.output_format = "sc16_item32_le";
+    convert::id_type out_id = in_id;
+    std::swap(out_id.input_format, out_id.output_format);
+    convert::converter::sptr c = convert::get_converter(out_id)();
+    c->set_correction(1.0, 0.0); //no correction is always fine
+    BOOST_CHECK_THROW(c->set_correction(gain, offset), uhd::not_implemented_error);
+}
+
 /***********************************************************************
  * Test sc8 conversions
  **********************************************************************/
@@ -397,6 +715,24 @@ BOOST_AUTO_TEST_CASE(test_convert_types_fc32_and_sc8){
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_convert_types_wide_simd_sc8){
+    //the AVX2 sc8 converters handle 8 or 16 samples per loop
+    BOOST_FOREACH(const std::string &otw, std::vector<std::string>(
+        boost::assign::list_of("sc8_item32_le")("sc8_item32_be")
+    )){
+        convert::id_type id;
+        id.num_inputs = 1;
+        id.output_format = otw;
+        id.num_outputs = 1;
+        for (size_t nsamps = 16; nsamps < 48; nsamps++){
+            id.input_format = "fc32";
+            test_convert_types_for_floats<fc32_t>(nsamps, id, 1./256);
+            id.input_format = "fc64";
+            test_convert_types_for_floats<fc64_t>(nsamps, id, 1./256);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_convert_types_sc16_and_sc8){
     convert::id_type id;
     id.input_format = "sc16";
@@ -416,6 +752,130 @@ BOOST_AUTO_TEST_CASE(test_convert_types_sc16_and_sc8){
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_convert_types_sc16_to_sc8_scaled){
+    //the SIMD converters must produce what the lookup table produces,
+    //the generic converter does not scale and is left out;
+    //with 32767./4, every input of 4k+2 is a tie, which the table rounds
+    //away from zero
+    std::vector<sc16_t> input(41);
+    BOOST_FOREACH(sc16_t &in, input) in = sc16_t(
+        short((std::rand() % 761) - 380), short((std::rand() % 761) - 380)
+    );
+    input[0] = sc16_t(2, -2);
+    input[1] = sc16_t(-10, 10);
+    input[9] = sc16_t(6, -6);
+    BOOST_FOREACH(const double scalar, std::vector<double>(
+        boost::assign::list_of(32767./3)(32767./4)
+    )){
+        BOOST_FOREACH(const std::string &otw, std::vector<std::string>(
+            boost::assign::list_of("sc8_item32_le")("sc8_item32_be")
+        )){
+            convert::id_type id;
+            id.input_format = "sc16";
+            id.num_inputs = 1;
+            id.output_format = otw;
+            id.num_outputs = 1;
+
+            std::vector<uint32_t> expected(input.size()), output(input.size());
+            std::vector<const void *> input0(1, &input[0]);
+            std::vector<void *> output0(1, &expected[0]), output1(1, &output[0]);
+            convert::converter::sptr table = convert::get_converter(id, "table")();
+            table->set_scalar(scalar);
+
+            BOOST_FOREACH(const convert::converter_info_type &info, convert::get_converter_infos(id)){
+                if (info.name == "generic") continue;
+                BOOST_TEST_MESSAGE("    converter " << info.to_string() << " to " << otw);
+                convert::converter::sptr c = convert::get_converter(id, info.name)();
+                c->set_scalar(scalar);
+                for (size_t nsamps = 1; nsamps <= input.size(); nsamps++){
+                    std::fill(expected.begin(), expected.end(), 0);
+                    std::fill(output.begin(), output.end(), 0);
+                    table->conv(input0, output0, nsamps);
+                    c->conv(input0, output1, nsamps);
+                    for (size_t i = 0; i < (nsamps+1)/2; i++){
+                        BOOST_CHECK_EQUAL(expected[i], output[i]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_sc8_to_sc16_scaled){
+    //the SIMD converters must produce what the lookup table produces,
+    //the generic converter does not scale and is left out;
+    //the scalars keep -128*scalar*32767 in range, as the streamers do,
+    //the table wraps out of range values and the SIMD converters saturate
+    std::vector<uint32_t> input(21);
+    BOOST_FOREACH(uint32_t &in, input) in = (uint32_t(std::rand()) << 16) ^ uint32_t(std::rand());
+    BOOST_FOREACH(const double scalar, std::vector<double>(
+        boost::assign::list_of(1./128)(1./300)
+    )){
+        BOOST_FOREACH(const std::string &otw, std::vector<std::string>(
+            boost::assign::list_of("sc8_item32_le")("sc8_item32_be")
+        )){
+            convert::id_type id;
+            id.input_format = otw;
+            id.num_inputs = 1;
+            id.output_format = "sc16";
+            id.num_outputs = 1;
+
+            std::vector<sc16_t> expected(2*input.size()), output(2*input.size());
+            convert::converter::sptr table = convert::get_converter(id, "table")();
+            table->set_scalar(scalar);
+
+            BOOST_FOREACH(const convert::converter_info_type &info, convert::get_converter_infos(id)){
+                if (info.name == "generic") continue;
+                BOOST_TEST_MESSAGE("    converter " << otw << " to " << info.to_string());
+                convert::converter::sptr c = convert::get_converter(id, info.name)();
+                c->set_scalar(scalar);
+                //start on both halves of the first item
+                for (size_t offset = 0; offset < 4; offset += 2){
+                    std::vector<const void *> input0(1, reinterpret_cast<const char *>(&input[0]) + offset);
+                    std::vector<void *> output0(1, &expected[0]), output1(1, &output[0]);
+                    for (size_t nsamps = 1; nsamps < expected.size() - 1; nsamps++){
+                        std::fill(expected.begin(), expected.end(), sc16_t(0));
+                        std::fill(output.begin(), output.end(), sc16_t(0));
+                        table->conv(input0, output0, nsamps);
+                        c->conv(input0, output1, nsamps);
+                        for (size_t i = 0; i < nsamps; i++){
+                            BOOST_CHECK_EQUAL(expected[i], output[i]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_shared_tables){
+    //table converters with the same scalar share the table, changing
+    //the scalar of one converter must not change the other's output
+    convert::id_type id;
+    id.input_format = "sc16_item32_le";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    convert::converter::sptr c0 = convert::get_converter(id, "table")();
+    convert::converter::sptr c1 = convert::get_converter(id, "table")();
+    c0->set_scalar(1/32767.);
+    c1->set_scalar(1/32767.);
+
+    const std::vector<uint32_t> input(1, 0x40002000);
+    std::vector<fc32_t> output(1);
+    std::vector<const void *> input0(1, &input[0]);
+    std::vector<void *> output0(1, &output[0]);
+
+    c1->set_scalar(2/32767.);
+    c0->conv(input0, output0, 1);
+    MY_CHECK_CLOSE(output[0].real(), 0x4000/32767.f, 1e-6);
+    MY_CHECK_CLOSE(output[0].imag(), 0x2000/32767.f, 1e-6);
+    c1->conv(input0, output0, 1);
+    MY_CHECK_CLOSE(output[0].real(), 2*0x4000/32767.f, 1e-6);
+    MY_CHECK_CLOSE(output[0].imag(), 2*0x2000/32767.f, 1e-6);
+}
+
 /***********************************************************************
  * Test u8 conversion
  **********************************************************************/
@@ -615,3 +1075,98 @@ BOOST_AUTO_TEST_CASE(test_convert_types_f32_and_f32){
         test_convert_types_f32(nsamps, id);
     }
 }
+
+/***********************************************************************
+ * Test half float conversion
+ **********************************************************************/
+typedef std::complex<uint16_t> fc16_t;
+
+static float half_to_float(const uint16_t half){
+    const int exp = (half >> 10) & 0x1f;
+    const float mant = float(half & 0x3ff);
+    const float num = (exp == 0)? std::ldexp(mant, -24) : std::ldexp(mant + 1024, exp - 25);
+    return (half & 0x8000)? -num : num;
+}
+
+static void test_convert_fc16_all_converters(
+    const std::string &otw_format, const double scalar, const double tolerance
+){
+    convert::id_type in_id;
+    in_id.input_format = "fc16";
+    in_id.num_inputs = 1;
+    in_id.output_format = otw_format;
+    in_id.num_outputs = 1;
+    convert::id_type out_id = in_id;
+    std::swap(out_id.input_format, out_id.output_format);
+
+    //normal halves below 1.0, shifted down to the wire format full scale
+    std::vector<fc16_t> input(600), output(input.size());
+    BOOST_FOREACH(fc16_t &in, input) in = fc16_t(
+        uint16_t((std::rand() & 0x83ff) | ((10 + std::rand()%5) << 10)),
+        uint16_t((std::rand() & 0x83ff) | ((10 + std::rand()%5) << 10))
+    );
+
+    std::vector<uint32_t> interm(input.size() + 4);
+    BOOST_FOREACH(const convert::converter_info_type &in_info, convert::get_converter_infos(in_id)){
+    BOOST_FOREACH(const convert::converter_info_type &out_info, convert::get_converter_infos(out_id)){
+        convert::converter::sptr c0 = convert::get_converter(in_id, in_info.name)();
+        convert::converter::sptr c1 = convert::get_converter(out_id, out_info.name)();
+        c0->set_scalar(scalar);
+        c1->set_scalar(1/scalar);
+        //the sc12 converters take the position in the 3 line block from the address,
+        //which has to hold across the blocks the converters go through fc32 in
+        const size_t num_offsets = (otw_format.find("sc12") == 0)? 4 : 1;
+        for (size_t offset = 0; offset < num_offsets; offset++){
+            char *otw = reinterpret_cast<char *>(&interm[0]) + 3*offset;
+            for (size_t nsamps = 1; nsamps <= input.size(); nsamps += (nsamps < 40)? 1 : 280){
+                std::vector<const void *> input0(1, &input[0]), input1(1, otw);
+                std::vector<void *> output0(1, otw), output1(1, &output[0]);
+                c0->conv(input0, output0, nsamps);
+                c1->conv(input1, output1, nsamps);
+                for (size_t i = 0; i < nsamps; i++){
+                    MY_CHECK_CLOSE(half_to_float(input[i].real()), half_to_float(output[i].real()), tolerance);
+                    MY_CHECK_CLOSE(half_to_float(input[i].imag()), half_to_float(output[i].imag()), tolerance);
+                }
+            }
+        }
+    }}
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_fc16){
+    BOOST_CHECK_EQUAL(convert::get_bytes_per_item("fc16"), sizeof(fc16_t));
+    BOOST_FOREACH(const std::string &end, std::vector<std::string>(
+        boost::assign::list_of("le")("be")
+    )){
+        test_convert_fc16_all_converters("sc16_item32_" + end, 32767., 1./(1 << 10));
+        test_convert_fc16_all_converters("sc12_item32_" + end, 2047., 1./(1 << 9));
+        test_convert_fc16_all_converters("sc8_item32_" + end, 127., 1./(1 << 6));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_fc16_rounding){
+    //every converter rounds to the nearest half, ties to even like F16C and NEON
+    const uint32_t items[] = {1024, uint32_t(-512) & 0xffff, 2049, 2051, 0x7fff, 1};
+    const uint16_t halves[] = {0x6400, 0xe000, 0x6800, 0x6802, 0x7800, 0x3c00};
+    std::vector<uint32_t> input(16);
+    for (size_t i = 0; i < input.size(); i++){
+        input[i] = uhd::htonx(uint32_t((items[(2*i+0)%6] << 16) | items[(2*i+1)%6]));
+    }
+
+    convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc16";
+    id.num_outputs = 1;
+    BOOST_FOREACH(const convert::converter_info_type &info, convert::get_converter_infos(id)){
+        std::vector<fc16_t> output(input.size());
+        std::vector<const void *> input0(1, &input[0]);
+        std::vector<void *> output0(1, &output[0]);
+        convert::converter::sptr c = convert::get_converter(id, info.name)();
+        c->set_scalar(1.0);
+        c->conv(input0, output0, input.size());
+        for (size_t i = 0; i < input.size(); i++){
+            BOOST_CHECK_EQUAL(output[i].real(), halves[(2*i+0)%6]);
+            BOOST_CHECK_EQUAL(output[i].imag(), halves[(2*i+1)%6]);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "db_eeprom_cache.hpp"
+#include <uhd/utils/paths.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/format.hpp>
+#include <map>
+#include <unistd.h>
+
+namespace fs = boost::filesystem;
+using namespace uhd;
+
+//! An EEPROM in memory which counts the bytes read
+class mem_eeprom_iface : public i2c_iface{
+public:
+    mem_eeprom_iface(void): num_read(0){}
+
+    void write_i2c(uint16_t, const byte_vector_t &){}
+
+    byte_vector_t read_i2c(uint16_t, size_t){
+        return byte_vector_t();
+    }
+
+    void write_eeprom(uint16_t addr, uint16_t offset, const byte_vector_t &bytes){
+        std::copy(bytes.begin(), bytes.end(), get_mem(addr).begin() + offset);
+    }
+
+    byte_vector_t read_eeprom(uint16_t addr, uint16_t offset, size_t num_bytes){
+        num_read += num_bytes;
+        const byte_vector_t &mem = get_mem(addr);
+        return byte_vector_t(mem.begin() + offset, mem.begin() + offset + num_bytes);
+    }
+
+    size_t num_read;
+
+private:
+    //! The contents of an EEPROM, all 0xff for an empty slot
+    byte_vector_t &get_mem(const uint16_t addr){
+        if (_mem.count(addr) == 0) _mem[addr] = byte_vector_t(0x100, 0xff);
+        return _mem[addr];
+    }
+
+    std::map<uint16_t, byte_vector_t> _mem;
+};
+
+static byte_vector_t make_db_eeprom(const uint8_t id, const uint8_t serial){
+    byte_vector_t bytes(0x20, 0);
+    bytes[0x00] = 0xdb;
+    bytes[0x01] = id;
+    bytes[0x09] = serial;
+    int sum = 0;
+    for (size_t i = 0; i < 0x1f; i++) sum -= int(bytes[i]);
+    bytes[0x1f] = uint8_t(sum);
+    return bytes;
+}
+
+BOOST_AUTO_TEST_CASE(test_db_eeprom_cache){
+    const fs::path cache_dir = fs::path(get_tmp_path()) / str(boost::format("db_eeprom_cache_test_%d") % getpid());
+    fs::remove_all(cache_dir);
+
+    boost::shared_ptr<mem_eeprom_iface> eeprom = boost::make_shared<mem_eeprom_iface>();
+    eeprom->write_eeprom(0x50, 0, make_db_eeprom(0x42, 1));
+
+    //the first read is a full read, the second one only checks the ID and checksum
+    i2c_iface::sptr cache = usrp::make_db_eeprom_cache(eeprom, "ABC123", cache_dir.string());
+    BOOST_CHECK(cache->read_eeprom(0x50, 0, 0x20) == make_db_eeprom(0x42, 1));
+    BOOST_CHECK_EQUAL(eeprom->num_read, 0x20);
+    eeprom->num_read = 0;
+    cache = usrp::make_db_eeprom_cache(eeprom, "ABC123", cache_dir.string());
+    BOOST_CHECK(cache->read_eeprom(0x50, 0, 0x20) == make_db_eeprom(0x42, 1));
+    BOOST_CHECK_EQUAL(eeprom->num_read, 4);
+
+    //another board has another checksum
+    eeprom->write_eeprom(0x50, 0, make_db_eeprom(0x42, 2));
+    eeprom->num_read = 0;
+    BOOST_CHECK(cache->read_eeprom(0x50, 0, 0x20) == make_db_eeprom(0x42, 2));
+    BOOST_CHECK_EQUAL(eeprom->num_read, 4 + 0x20);
+
+    //a write through the cache drops the copy
+    cache->write_eeprom(0x50, 0, make_db_eeprom(0x43, 2));
+    eeprom->num_read = 0;
+    BOOST_CHECK(cache->read_eeprom(0x50, 0, 0x20) == make_db_eeprom(0x43, 2));
+    BOOST_CHECK_EQUAL(eeprom->num_read, 0x20);
+
+    //an empty slot is not cached
+    eeprom->num_read = 0;
+    BOOST_CHECK(cache->read_eeprom(0x51, 0, 0x20) == byte_vector_t(0x20, 0xff));
+    BOOST_CHECK(cache->read_eeprom(0x51, 0, 0x20) == byte_vector_t(0x20, 0xff));
+    BOOST_CHECK_EQUAL(eeprom->num_read, 2*0x20);
+
+    //other boards have their own copies
+    cache = usrp::make_db_eeprom_cache(eeprom, "XYZ789", cache_dir.string());
+    eeprom->num_read = 0;
+    BOOST_CHECK(cache->read_eeprom(0x50, 0, 0x20) == make_db_eeprom(0x43, 2));
+    BOOST_CHECK_EQUAL(eeprom->num_read, 0x20);
+
+    fs::remove_all(cache_dir);
+}
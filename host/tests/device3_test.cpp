@@ -23,6 +23,7 @@
 #include <uhd/device3.hpp>
 #include <uhd/rfnoc/block_ctrl.hpp>
 #include <uhd/rfnoc/graph.hpp>
+#include <boost/bind.hpp>
 
 using namespace uhd;
 using namespace uhd::rfnoc;
@@ -153,6 +154,20 @@ BOOST_AUTO_TEST_CASE(test_device3_cast) {
     BOOST_CHECK_EQUAL(block1->get_block_id(), "0/Block_1");
 }
 
+static void count_call(size_t *count)
+{
+    (*count)++;
+}
+
+BOOST_AUTO_TEST_CASE(test_device3_reconfigure_streamers) {
+    device3::sptr my_device = make_pseudo_device();
+
+    // Without streamers, the blocks are only reconfigured
+    size_t count = 0;
+    my_device->reconfigure_streamers(boost::bind(&count_call, &count));
+    BOOST_CHECK_EQUAL(count, size_t(1));
+}
+
 BOOST_AUTO_TEST_CASE(test_device3_fail) {
     device3::sptr my_device = make_pseudo_device();
 
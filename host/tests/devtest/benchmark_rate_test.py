@@ -17,7 +17,9 @@
 #
 """ Test using benchmark_rate. """
 
-import re
+import os
+import json
+import tempfile
 from uhd_test_base import uhd_example_test_case
 
 class uhd_benchmark_rate_test(uhd_example_test_case):
@@ -60,34 +62,44 @@ class uhd_benchmark_rate_test(uhd_example_test_case):
         if 'rx' in test_args.get('direction', ''):
             args.append('--rx_rate')
             args.append(str(samp_rate))
+        if test_args.get('multi_streamer', False):
+            args.append('--multi_streamer')
+        (json_fd, json_file) = tempfile.mkstemp(suffix='.json')
+        os.close(json_fd)
+        args.append('--json_file')
+        args.append(json_file)
         (app, run_results) = self.run_example('benchmark_rate', args)
-        match = re.search(r'(Num received samples):\s*(.*)', app.stdout)
-        run_results['num_rx_samples'] = int(match.group(2)) if match else -1
+        try:
+            with open(json_file) as json_results:
+                results = json.load(json_results)
+        except ValueError:
+            results = {}
+        finally:
+            os.remove(json_file)
+        rx_totals = results.get('rx_totals', {})
+        tx_totals = results.get('tx_totals', {})
+        run_results['num_rx_samples'] = rx_totals.get('samps', -1)
         if run_results['num_rx_samples'] != -1:
             run_results['rel_rx_samples_error'] = 1.0 * abs(run_results['num_rx_samples'] - test_args.get('rx_buffer',0) - expected_samples) / expected_samples
         else:
             run_results['rel_rx_samples_error'] = 100
-        match = re.search(r'(Num dropped samples):\s*(.*)', app.stdout)
-        run_results['num_rx_dropped'] = int(match.group(2)) if match else -1
-        match = re.search(r'(Num overflows detected):\s*(.*)', app.stdout)
-        run_results['num_rx_overruns'] = int(match.group(2)) if match else -1
-        match = re.search(r'(Num transmitted samples):\s*(.*)', app.stdout)
-        run_results['num_tx_samples'] = int(match.group(2)) if match else -1
+        run_results['num_rx_dropped'] = rx_totals.get('dropped_samps', -1)
+        run_results['num_rx_overruns'] = rx_totals.get('overflows', -1)
+        run_results['num_tx_samples'] = tx_totals.get('samps', -1)
         if run_results['num_tx_samples'] != -1:
             run_results['rel_tx_samples_error'] = 1.0 * abs(run_results['num_tx_samples'] - test_args.get('tx_buffer',0) - expected_samples) / expected_samples
         else:
             run_results['rel_tx_samples_error'] = 100
-        match = re.search(r'(Num sequence errors):\s*(.*)', app.stdout)
-        run_results['num_tx_seqerrs'] = int(match.group(2)) if match else -1
-        match = re.search(r'(Num underflows detected):\s*(.*)', app.stdout)
-        run_results['num_tx_underruns'] = int(match.group(2)) if match else -1
-        match = re.search(r'(Num timeouts):\s*(.*)', app.stdout)
-        run_results['num_timeouts'] = int(match.group(2)) if match else -1
+        run_results['num_tx_seqerrs'] = tx_totals.get('seq_errors', -1)
+        run_results['num_tx_underruns'] = tx_totals.get('underflows', -1)
+        run_results['num_tx_late'] = tx_totals.get('late_packets', -1)
+        run_results['num_timeouts'] = rx_totals.get('timeouts', -1)
         run_results['passed'] = all([
             run_results['return_code'] == 0,
             run_results['num_rx_dropped'] == 0,
             run_results['num_tx_seqerrs'] == 0,
             run_results['num_tx_underruns'] <= test_args.get('acceptable-underruns', 0),
+            run_results['num_tx_late'] == 0,
             run_results['num_rx_samples'] > 0,
             run_results['num_tx_samples'] > 0,
             run_results['num_timeouts'] == 0,
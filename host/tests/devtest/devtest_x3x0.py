@@ -38,6 +38,16 @@ uhd_benchmark_rate_test.tests = {
         'tx_buffer': (0.1*12.5e6)+32e6*8*1/32,  # 32 MB DRAM for each channel (32 bit OTW format),
         'rx_buffer': 0.1*12.5e6,
     },
+    'mimo_multi_streamer': {
+        'duration': 1,
+        'direction': 'tx,rx',
+        'chan': '0,1',
+        'rate': 12.5e6,
+        'multi_streamer': True,
+        'acceptable-underruns': 500,
+        'tx_buffer': (0.1*12.5e6)+32e6*8*1/32,  # 32 MB DRAM for each channel (32 bit OTW format),
+        'rx_buffer': 0.1*12.5e6,
+    },
     'siso_chan0_slow': {
         'duration': 1,
         'direction': 'tx,rx',
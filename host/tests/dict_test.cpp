@@ -18,6 +18,7 @@
 #include <boost/test/unit_test.hpp>
 #include <uhd/types/dict.hpp>
 #include <boost/assign/list_of.hpp>
+#include <boost/lexical_cast.hpp>
 
 BOOST_AUTO_TEST_CASE(test_dict_init){
     uhd::dict<int, int> d;
@@ -95,3 +96,42 @@ BOOST_AUTO_TEST_CASE(test_dict_update)
 }
 
 
+
+BOOST_AUTO_TEST_CASE(test_dict_large)
+{
+    uhd::dict<std::string, int> d;
+    for (int i = 0; i < 1000; i++){
+        d[boost::lexical_cast<std::string>(999 - i)] = i;
+    }
+    BOOST_CHECK_EQUAL(d.size(), 1000);
+    BOOST_CHECK_EQUAL(d.keys()[0], "999");
+    BOOST_CHECK_EQUAL(d.vals()[999], 999);
+    BOOST_CHECK_EQUAL(d["500"], 499);
+    BOOST_CHECK_EQUAL(d.pop("500"), 499);
+    BOOST_CHECK(not d.has_key("500"));
+    BOOST_CHECK_EQUAL(d.keys()[499], "499");
+
+    //a copy has its own index
+    uhd::dict<std::string, int> d2 = d;
+    d.pop("0");
+    d["500"] = -1;
+    BOOST_CHECK(d2.has_key("0"));
+    BOOST_CHECK(not d2.has_key("500"));
+    d2 = d;
+    d.pop("500");
+    BOOST_CHECK_EQUAL(d2["500"], -1);
+    BOOST_CHECK_EQUAL(d2.keys().back(), "500");
+}
+
+BOOST_AUTO_TEST_CASE(test_dict_repeated_key)
+{
+    uhd::dict<std::string, std::string> d = boost::assign::map_list_of
+        ("key1", "val1")
+        ("key2", "val2")
+        ("key1", "val3")
+    ;
+    BOOST_CHECK_EQUAL(d.size(), 3);
+    BOOST_CHECK_EQUAL(d["key1"], "val1");
+    BOOST_CHECK_EQUAL(d.pop("key1"), "val1");
+    BOOST_CHECK_EQUAL(d["key1"], "val3");
+}
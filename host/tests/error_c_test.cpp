@@ -142,3 +142,36 @@ BOOST_AUTO_TEST_CASE(test_unknown_exception){
     BOOST_CHECK_EQUAL(error_code, UHD_ERROR_UNKNOWN);
     BOOST_CHECK_EQUAL(handle.last_error, "Unrecognized exception caught.");
 }
+
+typedef struct {
+    std::string last_error;
+    bool last_error_set;
+} dummy_stream_handle_t;
+
+UHD_INLINE uhd_error stream_call(dummy_stream_handle_t *handle, bool fail){
+    UHD_SAFE_C_SAVE_STREAM_ERROR(handle,
+        if (fail) throw uhd::io_error("This is a uhd::io_error.");
+    )
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_error){
+    dummy_stream_handle_t handle;
+    handle.last_error = "None";
+    handle.last_error_set = false;
+
+    set_c_global_error_string("Previous error");
+    BOOST_CHECK_EQUAL(stream_call(&handle, false), UHD_ERROR_NONE);
+    BOOST_CHECK_EQUAL(handle.last_error, "None");
+    BOOST_CHECK(not handle.last_error_set);
+    // A successful streaming call leaves the global string alone
+    BOOST_CHECK_EQUAL(get_c_global_error_string(), "Previous error");
+
+    BOOST_CHECK_EQUAL(stream_call(&handle, true), UHD_ERROR_IO);
+    BOOST_CHECK_EQUAL(handle.last_error, "EnvironmentError: IOError: This is a uhd::io_error.");
+    BOOST_CHECK(handle.last_error_set);
+    BOOST_CHECK_EQUAL(get_c_global_error_string(), handle.last_error);
+
+    BOOST_CHECK_EQUAL(stream_call(&handle, false), UHD_ERROR_NONE);
+    BOOST_CHECK_EQUAL(handle.last_error, "None");
+    BOOST_CHECK(not handle.last_error_set);
+}
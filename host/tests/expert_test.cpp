@@ -169,9 +169,9 @@ private:
     BOOST_CHECK(nodeG.get() == *final_output);
 
 
-BOOST_AUTO_TEST_CASE(test_experts){
+static void test_experts_with_threads(const size_t num_resolver_threads){
     //Initialize container object
-    expert_container::sptr container = expert_factory::create_container("example");
+    expert_container::sptr container = expert_factory::create_container("example", num_resolver_threads);
     uhd::property_tree::sptr tree = uhd::property_tree::make();
 
     //Output of expert tree
@@ -253,4 +253,110 @@ BOOST_AUTO_TEST_CASE(test_experts){
     BOOST_CHECK(!nodeC.is_dirty());
     container->resolve_to("Consume_G");
     VALIDATE_ALL_DEPENDENCIES
+
+    //Resolve from a node without a write callback
+    tree->access<int>("B").set(7);
+    BOOST_CHECK(nodeB.is_dirty());
+    container->resolve_from("B");
+    VALIDATE_ALL_DEPENDENCIES
+
+    //Cached resolve plans must be reused across resolves
+    tree->access<int>("B").set(-4);
+    container->resolve_from("B");
+    VALIDATE_ALL_DEPENDENCIES
+
+    BOOST_CHECK_THROW(container->resolve_from("Z"), uhd::lookup_error);
+    BOOST_CHECK_THROW(container->resolve_to("Z"), uhd::lookup_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_experts){
+    test_experts_with_threads(1);
+}
+
+BOOST_AUTO_TEST_CASE(test_experts_parallel){
+    test_experts_with_threads(3);
+}
+
+//=============================================================================
+
+class sum_worker_t : public worker_node_t {
+public:
+    sum_worker_t(const node_retriever_t& db, boost::shared_ptr<int> count)
+    : worker_node_t("X+Y=Z"), _x(db, "X"), _y(db, "Y"), _z(db, "Z"), _count(count)
+    {
+        bind_accessor(_x);
+        bind_accessor(_y);
+        bind_accessor(_z);
+    }
+
+private:
+    void resolve() {
+        (*_count)++;
+        _z = _x + _y;
+    }
+
+    data_reader_t<int> _x;
+    data_reader_t<int> _y;
+    data_writer_t<int> _z;
+    boost::shared_ptr<int> _count;
+};
+
+BOOST_AUTO_TEST_CASE(test_experts_resolve_batch){
+    expert_container::sptr container = expert_factory::create_container("batch");
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    boost::shared_ptr<int> count = boost::make_shared<int>(0);
+
+    expert_factory::add_prop_node<int>(container, tree, "X", 0, uhd::experts::AUTO_RESOLVE_ON_WRITE);
+    expert_factory::add_prop_node<int>(container, tree, "Y", 0, uhd::experts::AUTO_RESOLVE_ON_WRITE);
+    expert_factory::add_prop_node<int>(container, tree, "Z", 0, uhd::experts::AUTO_RESOLVE_ON_READ);
+    expert_factory::add_worker_node<sum_worker_t>(container, container->node_retriever(), count);
+    container->resolve_all();
+    *count = 0;
+
+    //without a batch, every write resolves
+    tree->access<int>("X").set(1);
+    tree->access<int>("Y").set(2);
+    BOOST_CHECK_EQUAL(*count, 2);
+
+    //in a batch, the writes resolve once at the end
+    *count = 0;
+    {
+        resolve_batch outer;
+        tree->access<int>("X").set(10);
+        {
+            resolve_batch inner;
+            tree->access<int>("Y").set(20);
+        }
+        BOOST_CHECK_EQUAL(*count, 0);
+        outer.commit();
+        outer.commit();
+    }
+    BOOST_CHECK_EQUAL(*count, 1);
+    BOOST_CHECK_EQUAL(tree->access<int>("Z").get(), 30);
+
+    //a read in a batch resolves the deferred writes first
+    *count = 0;
+    {
+        resolve_batch batch;
+        tree->access<int>("X").set(5);
+        BOOST_CHECK_EQUAL(tree->access<int>("Z").get(), 25);
+        tree->access<int>("Y").set(6);
+    }
+    BOOST_CHECK_EQUAL(tree->access<int>("Z").get(), 11);
+    BOOST_CHECK_EQUAL(*count, 2);
+
+    //a property transaction commits in one batch
+    *count = 0;
+    uhd::property_transaction transaction(tree);
+    transaction.set<int>("X", 100).set<int>("Y", 200);
+    transaction.commit();
+    BOOST_CHECK_EQUAL(*count, 1);
+    BOOST_CHECK_EQUAL(tree->access<int>("Z").get(), 300);
+
+    //only the resolves which ran a worker are counted
+    const size_t resolve_count = expert_container::get_resolve_count();
+    tree->access<int>("Z").get();
+    BOOST_CHECK_EQUAL(expert_container::get_resolve_count(), resolve_count);
+    tree->access<int>("X").set(1);
+    BOOST_CHECK_EQUAL(expert_container::get_resolve_count(), resolve_count + 1);
 }
@@ -120,3 +120,73 @@ BOOST_AUTO_TEST_CASE(test_gain_group_priority){
     //test the the higher priority gain got filled first (gain 2)
     BOOST_CHECK_CLOSE(g2.get_value(), g2.get_range().stop(), tolerance);
 }
+
+/***********************************************************************
+ * A gain element with a settable range, counting its writes
+ **********************************************************************/
+class counted_element{
+public:
+    counted_element(const gain_range_t &range):
+        range(range), gain(0), num_writes(0)
+    {
+        /* NOP */
+    }
+
+    gain_range_t get_range(void){
+        return range;
+    }
+
+    double get_value(void){
+        return gain;
+    }
+
+    void set_value(double new_gain){
+        gain = new_gain;
+        num_writes++;
+    }
+
+    gain_range_t range;
+    double gain;
+    size_t num_writes;
+};
+
+static gain_fcns_t get_fcns(counted_element &element){
+    gain_fcns_t gain_fcns;
+    gain_fcns.get_range = boost::bind(&counted_element::get_range, &element);
+    gain_fcns.get_value = boost::bind(&counted_element::get_value, &element);
+    gain_fcns.set_value = boost::bind(&counted_element::set_value, &element, _1);
+    return gain_fcns;
+}
+
+BOOST_AUTO_TEST_CASE(test_gain_group_table){
+    counted_element e1(gain_range_t(0, 31.5, 0.5));
+    counted_element e2(gain_range_t(0, 60, 2));
+    gain_group::sptr gg(gain_group::make());
+    gg->register_fcns("e1", get_fcns(e1), 0);
+    gg->register_fcns("e2", get_fcns(e2), 1);
+
+    //every step of the overall range
+    for (double gain = 0; gain <= 91.5; gain += 0.5){
+        gg->set_value(gain);
+        BOOST_CHECK_CLOSE(gg->get_value(), gain, tolerance);
+    }
+
+    //between the steps, the gain rounds down like on the steps
+    gg->set_value(10.26);
+    BOOST_CHECK_CLOSE(e2.gain, 10.0, tolerance);
+    BOOST_CHECK_SMALL(e1.gain, tolerance);
+
+    //only the elements which change are written
+    e1.num_writes = e2.num_writes = 0;
+    gg->set_value(10.0);
+    BOOST_CHECK_EQUAL(e1.num_writes + e2.num_writes, 0U);
+    gg->set_value(10.5);
+    BOOST_CHECK_EQUAL(e1.num_writes, 1U);
+    BOOST_CHECK_EQUAL(e2.num_writes, 0U);
+
+    //a changed range is picked up by the next set
+    e2.range = gain_range_t(0, 30, 2);
+    gg->set_value(80);
+    BOOST_CHECK_CLOSE(e2.gain, 30.0, tolerance);
+    BOOST_CHECK_CLOSE(gg->get_value(), 61.5, tolerance);
+}
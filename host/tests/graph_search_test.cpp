@@ -167,3 +167,43 @@ BOOST_AUTO_TEST_CASE(test_mini_cycle_downstream_and_upstream)
     BOOST_REQUIRE_EQUAL(result.size(), 1);
     BOOST_REQUIRE(result[0] == node_A);
 }
+
+BOOST_AUTO_TEST_CASE(test_cached_search)
+{
+    MAKE_NODE(node_A);
+    MAKE_NODE(node_B);
+    MAKE_RESULT_NODE(node_C);
+    MAKE_RESULT_NODE(node_D);
+
+    connect_nodes(node_A, node_B);
+    connect_nodes(node_B, node_C);
+
+    // Searching twice gives the same (cached) result
+    std::vector< result_node::sptr > result = node_A->find_downstream_node<result_node>();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_C);
+    result = node_A->find_downstream_node<result_node>();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_C);
+
+    // A connection further down the graph invalidates the result
+    connect_nodes(node_B, node_D);
+    result = node_A->find_downstream_node<result_node>();
+    BOOST_CHECK_EQUAL(result.size(), 2);
+
+    // So does a disconnect
+    node_D->disconnect();
+    result = node_A->find_downstream_node<result_node>();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(result[0] == node_C);
+
+    // Searches for other types or directions are cached separately
+    BOOST_CHECK_EQUAL(node_A->find_downstream_node<test_node>().size(), 1);
+    BOOST_CHECK_EQUAL(node_C->find_upstream_node<test_node>().size(), 1);
+    BOOST_CHECK_EQUAL(node_C->find_upstream_node<result_node>().size(), 0);
+
+    // Nodes that are gone are never returned
+    result.clear();
+    node_C.reset();
+    BOOST_CHECK_EQUAL(node_A->find_downstream_node<result_node>().size(), 0);
+}
@@ -0,0 +1,87 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/types/histogram.hpp>
+#include <stdint.h>
+
+using namespace uhd;
+
+static void add_value(histogram_t &hist, const uint64_t value){
+    hist.buckets[histogram_t::bucket_index(value)]++;
+    if (hist.count == 0 or value < hist.min) hist.min = value;
+    if (value > hist.max) hist.max = value;
+    hist.count++;
+    hist.sum += value;
+}
+
+BOOST_AUTO_TEST_CASE(test_histogram_buckets){
+    //small values have a bucket each
+    for (uint64_t i = 0; i < histogram_t::SUB_BUCKETS; i++){
+        BOOST_CHECK_EQUAL(histogram_t::bucket_index(i), size_t(i));
+        BOOST_CHECK_EQUAL(histogram_t::bucket_lower_bound(size_t(i)), i);
+    }
+
+    //the lower bounds are increasing and map back to their bucket
+    for (size_t i = 1; i < histogram_t::NUM_BUCKETS; i++){
+        const uint64_t lower = histogram_t::bucket_lower_bound(i);
+        BOOST_CHECK(lower > histogram_t::bucket_lower_bound(i - 1));
+        BOOST_CHECK_EQUAL(histogram_t::bucket_index(lower), i);
+        BOOST_CHECK_EQUAL(histogram_t::bucket_index(lower - 1), i - 1);
+    }
+
+    //a bucket spans at most 1/16 of its lower bound
+    BOOST_CHECK_EQUAL(histogram_t::bucket_index(1000), histogram_t::bucket_index(1023));
+    BOOST_CHECK_EQUAL(histogram_t::bucket_lower_bound(histogram_t::bucket_index(1000)), uint64_t(992));
+
+    //huge values go into the last bucket
+    BOOST_CHECK_EQUAL(histogram_t::bucket_index(~uint64_t(0)), histogram_t::NUM_BUCKETS - 1);
+    BOOST_CHECK_EQUAL(histogram_t::bucket_index(uint64_t(1) << 48), histogram_t::NUM_BUCKETS - 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_histogram_percentile){
+    histogram_t hist;
+    BOOST_CHECK_EQUAL(hist.percentile(50), uint64_t(0));
+    BOOST_CHECK_EQUAL(hist.mean(), 0.0);
+
+    for (uint64_t i = 1; i <= 100; i++) add_value(hist, i);
+    BOOST_CHECK_EQUAL(hist.percentile(0), uint64_t(1));
+    BOOST_CHECK_EQUAL(hist.percentile(10), uint64_t(10));
+    BOOST_CHECK_EQUAL(hist.percentile(50), uint64_t(50));
+    //within the resolution of the buckets
+    BOOST_CHECK_EQUAL(hist.percentile(99), uint64_t(96));
+    BOOST_CHECK_CLOSE(hist.mean(), 50.5, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(test_histogram_json){
+    histogram_t hist;
+    hist.unit = "ns";
+    add_value(hist, 3);
+    add_value(hist, 3);
+    add_value(hist, 1000);
+    BOOST_CHECK_EQUAL(hist.to_json(),
+        "{\"unit\":\"ns\",\"count\":3,\"min\":3,\"max\":1000,\"mean\":335.333,"
+        "\"p50\":3,\"p90\":992,\"p99\":992,\"p999\":992,\"buckets\":[[3,2],[992,1]]}"
+    );
+
+    histograms_t hists;
+    hists["a"] = histogram_t();
+    hists["b"] = hist;
+    const std::string json = to_json(hists);
+    BOOST_CHECK_EQUAL(json.find("{\"a\":{\"unit\":\"\",\"count\":0,"), size_t(0));
+    BOOST_CHECK(json.find(",\"b\":{\"unit\":\"ns\",\"count\":3,") != std::string::npos);
+}
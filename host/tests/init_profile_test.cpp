@@ -0,0 +1,77 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/utils/init_profile.hpp>
+#include <boost/thread/thread.hpp>
+#include <iostream>
+
+using namespace uhd::init_profile;
+
+BOOST_AUTO_TEST_CASE(test_init_profile_phases){
+    //phases outside of a profile are not recorded
+    stop();
+    {
+        scoped_phase phase("ignored");
+    }
+
+    start();
+    BOOST_CHECK(is_enabled());
+    {
+        scoped_phase mb_phase("mboard", 0);
+        scoped_phase phase("mboard/eeprom", 0);
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        phase.next("mboard/clocking");
+    }
+    for (size_t i = 0; i < 3; i++){
+        scoped_phase phase("blockdefs");
+    }
+    stop();
+    {
+        scoped_phase phase("after");
+    }
+
+    const std::vector<phase_t> phases = get_phases();
+    BOOST_REQUIRE_EQUAL(phases.size(), 6U);
+    BOOST_CHECK_EQUAL(phases[0].name, "mboard");
+    BOOST_CHECK_EQUAL(phases[1].name, "mboard/eeprom");
+    BOOST_CHECK_EQUAL(phases[2].name, "mboard/clocking");
+    BOOST_CHECK_EQUAL(phases[0].mboard, 0U);
+    BOOST_CHECK_EQUAL(phases[3].mboard, ALL_MBOARDS);
+    BOOST_CHECK(phases[1].duration >= 0.01);
+    BOOST_CHECK(phases[0].duration >= phases[1].duration + phases[2].duration);
+    BOOST_CHECK(phases[2].start >= phases[1].start + phases[1].duration);
+
+    //the phases of the same name are merged
+    const std::vector<phase_t> breakdown = get_breakdown(ALL_MBOARDS);
+    BOOST_REQUIRE_EQUAL(breakdown.size(), 1U);
+    BOOST_CHECK_EQUAL(breakdown[0].name, "blockdefs");
+    BOOST_CHECK_EQUAL(breakdown[0].count, 3U);
+    BOOST_CHECK_EQUAL(get_breakdown(0).size(), 3U);
+    BOOST_CHECK(get_breakdown(1).empty());
+
+    const std::string report = to_pp_string();
+    std::cout << report;
+    BOOST_CHECK(report.find("Motherboard 0") != std::string::npos);
+    BOOST_CHECK(report.find("    clocking") != std::string::npos);
+    BOOST_CHECK(report.find("blockdefs (x3)") != std::string::npos);
+
+    //a new profile starts empty
+    start();
+    BOOST_CHECK(get_phases().empty());
+    stop();
+}
@@ -0,0 +1,160 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/usrp/latency_probe.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
+
+/***********************************************************************
+ * A dummy device: its time is the host time, bursts arrive when due
+ * and a TX burst is late when it is sent after its time
+ **********************************************************************/
+static uhd::time_spec_t device_time_now(void){
+    return uhd::time_spec_t::get_system_time();
+}
+
+class dummy_rx_streamer : public uhd::rx_streamer{
+public:
+    dummy_rx_streamer(void): _cmd(uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE){}
+
+    size_t get_num_channels(void) const{
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return 1000;
+    }
+
+    size_t recv(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double = 0.1,
+        const bool = false
+    ){
+        metadata.reset();
+        const double wait = (_cmd.time_spec - device_time_now()).get_real_secs();
+        if (wait > 0) boost::this_thread::sleep(boost::posix_time::microseconds(long(wait*1e6)));
+        std::complex<float> *samps = reinterpret_cast<std::complex<float> *>(buffs[0]);
+        const size_t nsamps = std::min(nsamps_per_buff, size_t(_cmd.num_samps));
+        std::fill(samps, samps + nsamps, std::complex<float>(1.0, 0.0));
+        metadata.has_time_spec = true;
+        metadata.time_spec = _cmd.time_spec;
+        metadata.end_of_burst = true;
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const uhd::stream_cmd_t &stream_cmd){
+        _cmd = stream_cmd;
+    }
+
+private:
+    uhd::stream_cmd_t _cmd;
+};
+
+class dummy_tx_streamer : public uhd::tx_streamer{
+public:
+    dummy_tx_streamer(void): num_samps_sent(0){}
+
+    size_t get_num_channels(void) const{
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return 1000;
+    }
+
+    size_t send(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const uhd::tx_metadata_t &metadata,
+        const double = 0.1
+    ){
+        const std::complex<float> *samps = reinterpret_cast<const std::complex<float> *>(buffs[0]);
+        for (size_t i = 0; i < nsamps_per_buff; i++){
+            BOOST_CHECK_EQUAL(samps[i], std::complex<float>(2.0, 0.0));
+        }
+        num_samps_sent += nsamps_per_buff;
+        uhd::async_metadata_t async_md;
+        async_md.event_code = (metadata.time_spec < device_time_now())?
+            uhd::async_metadata_t::EVENT_CODE_TIME_ERROR :
+            uhd::async_metadata_t::EVENT_CODE_BURST_ACK;
+        _msgs.push_back(async_md);
+        return nsamps_per_buff;
+    }
+
+    bool recv_async_msg(uhd::async_metadata_t &async_md, double = 0.1){
+        if (_msgs.empty()) return false;
+        async_md = _msgs.front();
+        _msgs.pop_front();
+        return true;
+    }
+
+    size_t num_samps_sent;
+
+private:
+    std::deque<uhd::async_metadata_t> _msgs;
+};
+
+static void double_samps(std::vector<std::complex<float> > &buff){
+    for (size_t i = 0; i < buff.size(); i++) buff[i] *= 2.0f;
+}
+
+typedef boost::shared_ptr<dummy_tx_streamer> dummy_tx_sptr;
+
+static uhd::usrp::latency_result_t run(const double rtt, dummy_tx_sptr &tx_stream){
+    uhd::usrp::latency_config_t config;
+    config.nsamps = 10;
+    config.nruns = 20;
+    config.rtt = rtt;
+    config.rx_lead = 0.001;
+    config.work = &double_samps;
+    tx_stream = boost::make_shared<dummy_tx_streamer>();
+    return uhd::usrp::measure_latency(
+        boost::make_shared<dummy_rx_streamer>(), tx_stream, &device_time_now, config
+    );
+}
+
+/***********************************************************************
+ * Tests
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_latency_probe_acks){
+    dummy_tx_sptr tx_stream;
+    const uhd::usrp::latency_result_t result = run(10.0, tx_stream);
+    BOOST_CHECK_EQUAL(result.num_runs, 20);
+    BOOST_CHECK_EQUAL(result.num_acks, 20);
+    BOOST_CHECK_EQUAL(result.num_late, 0);
+    BOOST_CHECK_EQUAL(result.num_timeouts, 0);
+    BOOST_CHECK_EQUAL(tx_stream->num_samps_sent, 200);
+
+    //the dummy streamers have no histograms of their own
+    BOOST_CHECK_EQUAL(result.histograms.keys().size(), 4);
+    BOOST_CHECK_EQUAL(result.histograms["turnaround"].count, 20);
+    BOOST_CHECK_EQUAL(result.histograms["application"].count, 20);
+    BOOST_CHECK(result.histograms["turnaround"].max >= result.histograms["receive"].min);
+    BOOST_CHECK(result.to_json().find("\"num_acks\":20") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_latency_probe_late){
+    dummy_tx_sptr tx_stream;
+    const uhd::usrp::latency_result_t result = run(-1.0, tx_stream);
+    BOOST_CHECK_EQUAL(result.num_acks, 0);
+    BOOST_CHECK_EQUAL(result.num_late, 20);
+}
@@ -17,7 +17,9 @@
 
 #include <boost/test/unit_test.hpp>
 #include <uhd/utils/msg.hpp>
+#include <boost/thread/thread.hpp>
 #include <iostream>
+#include <string>
 
 BOOST_AUTO_TEST_CASE(test_messages){
     std::cerr << "---begin print test ---" << std::endl;
@@ -38,3 +40,25 @@ BOOST_AUTO_TEST_CASE(test_messages){
     UHD_VAR(x);
     std::cerr << "---end print test ---" << std::endl;
 }
+
+static std::string fastpath_msgs;
+
+static void fastpath_handler(uhd::msg::type_t type, const std::string &msg){
+    if (type == uhd::msg::fastpath) fastpath_msgs += msg;
+    else std::cerr << msg << std::flush;
+}
+
+BOOST_AUTO_TEST_CASE(test_fastpath_events){
+    uhd::msg::register_handler(&fastpath_handler);
+
+    //the events are reported in the background, several as a summary
+    uhd::msg::fastpath_event('L');
+    for (size_t i = 0; i < 37; i++) uhd::msg::fastpath_event('O');
+    boost::this_thread::sleep(boost::posix_time::milliseconds(300));
+
+    //the burst may be split over two report periods
+    std::cerr << fastpath_msgs << std::endl;
+    BOOST_CHECK(fastpath_msgs.find("L") != std::string::npos);
+    BOOST_CHECK(fastpath_msgs.find("O x ") != std::string::npos);
+    BOOST_CHECK(fastpath_msgs.find(" in last 100ms") != std::string::npos);
+}
@@ -330,7 +330,8 @@ class functable_mockup_impl : public function_table
             const std::string &,
             const function_table::function_ptr &,
             const expression::type_t,
-            const expression_function::argtype_list_type &
+            const expression_function::argtype_list_type &,
+            const bool
     ) {};
 
 };
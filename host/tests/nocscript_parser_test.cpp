@@ -165,3 +165,58 @@ BOOST_AUTO_TEST_CASE(test_multi_commmand)
     BOOST_CHECK_EQUAL(dummy_false_counter, 3);
 }
 
+
+int dummy_counter = 0;
+expression_literal dummy_count(expression_container::expr_list_type)
+{
+    dummy_counter++;
+    return expression_literal(dummy_counter);
+}
+
+BOOST_AUTO_TEST_CASE(test_const_folding)
+{
+    SETUP_FT_AND_PARSER();
+    BOOST_CHECK(ft->is_pure("ADD", two_int_args));
+    BOOST_CHECK(not ft->is_pure("SLEEP", one_double_arg));
+
+    // Constant expressions become literals:
+    expression::sptr e = p->create_expr_tree("ADD(1, ADD(2, 3))");
+    BOOST_CHECK(e->is_constant());
+    BOOST_CHECK_EQUAL(e->eval().get_int(), 6);
+    e = p->create_expr_tree("ADD(1, ADD(2, $spp))");
+    BOOST_CHECK(not e->is_constant());
+    BOOST_CHECK_EQUAL(e->eval().get_int(), 3+SPP_VALUE);
+    BOOST_CHECK_EQUAL(e->eval().get_int(), 3+SPP_VALUE);
+
+    // Pure functions only get called while parsing:
+    ft->register_function(
+            "COUNT_PURE",
+            boost::bind(&dummy_count, _1),
+            expression::TYPE_INT,
+            no_args,
+            true
+    );
+    dummy_counter = 0;
+    e = p->create_expr_tree("ADD(COUNT_PURE(), 1)");
+    BOOST_CHECK_EQUAL(dummy_counter, 1);
+    BOOST_CHECK_EQUAL(e->eval().get_int(), 2);
+    BOOST_CHECK_EQUAL(e->eval().get_int(), 2);
+    BOOST_CHECK_EQUAL(dummy_counter, 1);
+
+    // All others on every evaluation:
+    ft->register_function(
+            "COUNT",
+            boost::bind(&dummy_count, _1),
+            expression::TYPE_INT,
+            no_args
+    );
+    dummy_counter = 0;
+    e = p->create_expr_tree("ADD(COUNT(), 1)");
+    BOOST_CHECK_EQUAL(dummy_counter, 0);
+    BOOST_CHECK_EQUAL(e->eval().get_int(), 2);
+    BOOST_CHECK_EQUAL(e->eval().get_int(), 3);
+
+    // Errors are raised when evaluating, not when parsing:
+    e = p->create_expr_tree("IF(FALSE(), EQUAL(LOG2(-1), 0))");
+    BOOST_CHECK_EQUAL(e->eval().get_bool(), false);
+}
@@ -0,0 +1,98 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "../lib/transport/pfb_channelizer.hpp"
+#include <boost/test/unit_test.hpp>
+#include <uhd/exception.hpp>
+#include <complex>
+#include <cmath>
+#include <vector>
+
+using uhd::transport::pfb_channelizer;
+
+static const double PI = 3.14159265358979323846;
+
+//! Channelize a tone at the center of a channel, check that only it sees the tone
+static void check_tone(const size_t num_chans, const size_t chan){
+    static const size_t TAPS = 12;
+    static const size_t NUM_OUTPUTS = 200;
+    pfb_channelizer channelizer(num_chans, TAPS);
+    const size_t num_inputs = channelizer.get_num_inputs(NUM_OUTPUTS);
+    BOOST_CHECK_EQUAL(channelizer.get_num_outputs(num_inputs), NUM_OUTPUTS);
+
+    std::vector<std::complex<float> > in(num_inputs);
+    for (size_t i = 0; i < in.size(); i++){
+        const double phase = 2*PI*double(chan)*i/num_chans;
+        in[i] = std::complex<float>(float(std::cos(phase)), float(std::sin(phase)));
+    }
+    std::vector<std::vector<std::complex<float> > > outs(num_chans, std::vector<std::complex<float> >(NUM_OUTPUTS));
+    std::vector<std::complex<float> *> out_ptrs(num_chans);
+    for (size_t k = 0; k < num_chans; k++) out_ptrs[k] = &outs[k].front();
+    BOOST_CHECK_EQUAL(channelizer.process(&in.front(), in.size(), &out_ptrs.front()), NUM_OUTPUTS);
+
+    //past the filter, the tone is at DC in its channel and gone elsewhere
+    for (size_t n = TAPS; n < NUM_OUTPUTS; n++){
+        for (size_t k = 0; k < num_chans; k++){
+            const float expected = (k == chan)? 1.0f : 0.0f;
+            BOOST_CHECK_SMALL(std::abs(outs[k][n]) - expected, 1e-3f);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_pfb_channelizer_tones){
+    for (size_t chan = 0; chan < 8; chan++) check_tone(8, chan); //radix 2 FFT
+    for (size_t chan = 0; chan < 6; chan++) check_tone(6, chan); //DFT
+    BOOST_CHECK_THROW(pfb_channelizer(1, 12), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_pfb_channelizer_blocks){
+    static const size_t NCHANS = 16;
+    std::vector<std::complex<float> > in(1000);
+    for (size_t i = 0; i < in.size(); i++){
+        in[i] = std::complex<float>(float(std::cos(0.01*i*i)), float(std::sin(0.03*i)));
+    }
+
+    //one block and odd sized blocks give the same streams
+    pfb_channelizer one(NCHANS, 8);
+    const size_t num_outputs = one.get_num_outputs(in.size());
+    BOOST_CHECK_EQUAL(num_outputs, 63U);
+    std::vector<std::complex<float> > expected(NCHANS*num_outputs);
+    std::vector<std::complex<float> *> ptrs(NCHANS);
+    for (size_t k = 0; k < NCHANS; k++) ptrs[k] = &expected[k*num_outputs];
+    BOOST_CHECK_EQUAL(one.process(&in.front(), in.size(), &ptrs.front()), num_outputs);
+
+    pfb_channelizer blocks(NCHANS, 8);
+    std::vector<std::complex<float> > out(NCHANS*num_outputs);
+    size_t num_got = 0;
+    for (size_t i = 0, n = 1; i < in.size(); i += n, n = n % 37 + 3){
+        const size_t num_inputs = std::min(n, in.size() - i);
+        for (size_t k = 0; k < NCHANS; k++) ptrs[k] = &out[k*num_outputs + num_got];
+        const size_t num_block = blocks.get_num_outputs(num_inputs);
+        BOOST_CHECK_EQUAL(blocks.process(&in[i], num_inputs, &ptrs.front()), num_block);
+        num_got += num_block;
+    }
+    BOOST_REQUIRE_EQUAL(num_got, num_outputs);
+    for (size_t i = 0; i < out.size(); i++){
+        BOOST_CHECK_SMALL(std::abs(out[i] - expected[i]), 1e-5f);
+    }
+
+    //the inputs that outputs need produce exactly as many outputs
+    for (size_t n = 1; n < 50; n++){
+        BOOST_CHECK_EQUAL(blocks.get_num_outputs(blocks.get_num_inputs(n)), n);
+        BOOST_CHECK_EQUAL(blocks.get_num_outputs(blocks.get_num_inputs(n) - 1), n - 1);
+    }
+}
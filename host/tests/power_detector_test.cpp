@@ -0,0 +1,50 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "../lib/transport/power_detector.hpp"
+#include <boost/test/unit_test.hpp>
+#include <boost/cstdint.hpp>
+#include <uhd/exception.hpp>
+#include <complex>
+#include <vector>
+
+using uhd::transport::power_detector;
+
+//! Place samples of 0.1 and 0.5 of full scale, find the loud ones at -10 dBFS
+template <typename samp_type>
+static void check_find(const std::string &format, const double full_scale){
+    std::vector<samp_type> samps(37, samp_type(0.1*full_scale, 0));
+    samps[5] = samp_type(0, -0.5*full_scale);
+    samps[22] = samp_type(0.5*full_scale, 0.5*full_scale);
+    power_detector detector(format, -10.0);
+    BOOST_CHECK_EQUAL(detector.find(&samps.front(), 0, samps.size()), 5);
+    BOOST_CHECK_EQUAL(detector.find(&samps.front(), 6, samps.size()), 22);
+    BOOST_CHECK_EQUAL(detector.find(&samps.front(), 6, 22), 22);
+    BOOST_CHECK_EQUAL(detector.find(&samps.front(), 23, samps.size()), samps.size());
+
+    //the quiet samples are at -20 dBFS
+    power_detector low(format, -21.0);
+    BOOST_CHECK_EQUAL(low.find(&samps.front(), 1, samps.size()), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_power_detector_formats){
+    check_find<std::complex<float> >("fc32", 1.0);
+    check_find<std::complex<double> >("fc64", 1.0);
+    check_find<std::complex<boost::int16_t> >("sc16", 32767.0);
+    check_find<std::complex<boost::int8_t> >("sc8", 127.0);
+    BOOST_CHECK_THROW(power_detector("sc12", 0.0), uhd::value_error);
+}
@@ -0,0 +1,328 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// Measures the software side of tuning without hardware: property tree
+// lookups, get and set through coercer and subscriber chains, and the
+// resolves of an expert graph laid out like the TwinRX one.
+
+#include "../lib/experts/expert_container.hpp"
+#include "../lib/experts/expert_factory.hpp"
+#include "../lib/transport/xport_stats.hpp"
+#include <uhd/property_tree.hpp>
+#include <uhd/types/ranges.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/function.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace uhd::experts;
+using uhd::transport::stats_histogram;
+using uhd::transport::stats_time_now_ns;
+
+static const char *FE_GAINS[] = {"LNA1", "LNA2", "DSA1", "DSA2", "AMP"};
+
+/***********************************************************************
+ * Measurement
+ **********************************************************************/
+//! Time each call of an operation, print and return its latency histogram in ns
+static uhd::histogram_t measure(
+    const std::string &name,
+    const boost::function<void(size_t)> &op,
+    const size_t iterations
+){
+    stats_histogram hist("ns");
+    op(0); //the first call can set up state, keep it out of the numbers
+    const int64_t start = stats_time_now_ns();
+    for (size_t i = 0; i < iterations; i++){
+        const int64_t t0 = stats_time_now_ns();
+        op(i);
+        hist.record(uint64_t(stats_time_now_ns() - t0));
+    }
+    const double total_secs = (stats_time_now_ns() - start)/1e9;
+
+    const uhd::histogram_t result = hist.get();
+    std::cout << boost::format(
+        "%-16s %10.0f/s  mean %8.0f ns  p50 %8u  p99 %8u  max %8u"
+    ) % name % (iterations/total_secs) % result.mean()
+      % result.percentile(50) % result.percentile(99) % result.max << std::endl;
+    return result;
+}
+
+/***********************************************************************
+ * Property tree
+ **********************************************************************/
+static double clip_to_range(const uhd::meta_range_t &range, const double value){
+    return range.clip(value);
+}
+
+static void count_update(size_t *count, const double){
+    (*count)++;
+}
+
+/*!
+ * Build the frontends of a device with TwinRX-like daughterboards,
+ * with a clipping coercer and num_subscribers subscribers on the tuning
+ * properties, and return the paths of the frequency properties.
+ */
+static std::vector<uhd::fs_path> make_mock_tree(
+    uhd::property_tree::sptr tree, const size_t num_subscribers, size_t *num_updates
+){
+    std::vector<uhd::fs_path> freq_paths;
+    const uhd::meta_range_t freq_range(10e6, 6e9);
+    const uhd::meta_range_t gain_range(0, 31.5, 0.5);
+    for (size_t db = 0; db < 2; db++){
+        const uhd::fs_path db_path = str(boost::format("/mboards/0/dboards/%c") % char('A' + db));
+        tree->create<std::string>(db_path / "rx_eeprom").set("twinrx");
+        for (size_t fe = 0; fe < 2; fe++){
+            const uhd::fs_path fe_path = db_path / "rx_frontends" / boost::lexical_cast<std::string>(fe);
+            tree->create<std::string>(fe_path / "name").set("TwinRX RX");
+            tree->create<std::string>(fe_path / "antenna/value").set("RX1");
+            tree->create<uhd::meta_range_t>(fe_path / "freq/range").set(freq_range);
+            tree->create<double>(fe_path / "bandwidth/value").set(80e6);
+            tree->create<bool>(fe_path / "enabled").set(true);
+            tree->create<std::string>(fe_path / "ch1/sources/lo1").set("internal");
+            tree->create<std::string>(fe_path / "ch1/sources/lo2").set("internal");
+
+            uhd::property<double> &freq = tree->create<double>(fe_path / "freq/value")
+                .set_coercer(boost::bind(&clip_to_range, freq_range, _1));
+            for (size_t i = 0; i < num_subscribers; i++){
+                freq.add_coerced_subscriber(boost::bind(&count_update, num_updates, _1));
+            }
+            freq.set(1e9);
+            freq_paths.push_back(fe_path / "freq/value");
+
+            BOOST_FOREACH(const char *gain, FE_GAINS){
+                tree->create<uhd::meta_range_t>(fe_path / "gains" / gain / "range").set(gain_range);
+                tree->create<double>(fe_path / "gains" / gain / "value")
+                    .set_coercer(boost::bind(&clip_to_range, gain_range, _1))
+                    .set(0.0);
+            }
+            for (size_t lo = 1; lo <= 2; lo++){
+                tree->create<bool>(fe_path / str(boost::format("sensors/lo%u_locked") % lo)).set(true);
+            }
+        }
+    }
+    for (size_t ch = 0; ch < 4; ch++){
+        const uhd::fs_path dsp_path = str(boost::format("/mboards/0/rx_dsps/%u") % ch);
+        tree->create<double>(dsp_path / "rate/value").set(100e6);
+        tree->create<double>(dsp_path / "freq/value").set(0.0);
+    }
+    return freq_paths;
+}
+
+/*!
+ * Build a tree from the output of uhd_usrp_probe --tree, with a double
+ * property at each leaf path, and return the leaf paths.
+ */
+static std::vector<uhd::fs_path> load_tree(uhd::property_tree::sptr tree, const std::string &file){
+    std::ifstream in(file.c_str());
+    if (not in) throw uhd::io_error("Cannot open the tree file " + file);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)){
+        boost::trim(line);
+        if (not line.empty() and line[0] == '/') lines.push_back(line);
+    }
+    std::vector<uhd::fs_path> leaves;
+    for (size_t i = 0; i < lines.size(); i++){
+        //the dump lists each node before its children
+        const bool is_leaf = (i + 1 == lines.size()) or not boost::starts_with(lines[i+1], lines[i] + "/");
+        if (not is_leaf or lines[i] == "/") continue;
+        tree->create<double>(lines[i]).set(0.0);
+        leaves.push_back(lines[i]);
+    }
+    return leaves;
+}
+
+static void tree_get(uhd::property_tree::sptr tree, const std::vector<uhd::fs_path> &paths, const size_t i){
+    tree->access<double>(paths[i % paths.size()]).get();
+}
+
+static void handle_get(const std::vector<boost::shared_ptr<uhd::property<double> > > &handles, const size_t i){
+    handles[i % handles.size()]->get();
+}
+
+static void tree_set(uhd::property_tree::sptr tree, const std::vector<uhd::fs_path> &paths, const size_t i){
+    tree->access<double>(paths[i % paths.size()]).set(1e9 + double(i % 2));
+}
+
+static void tree_list(uhd::property_tree::sptr tree, const std::vector<uhd::fs_path> &paths, const size_t i){
+    tree->list(paths[i % paths.size()].branch_path());
+}
+
+/***********************************************************************
+ * Expert graph
+ **********************************************************************/
+//! A worker that writes a function of its inputs to all its outputs
+class mock_worker_t : public worker_node_t {
+public:
+    mock_worker_t(
+        const node_retriever_t &db, const std::string &name,
+        const std::vector<std::string> &inputs, const std::vector<std::string> &outputs
+    ) : worker_node_t(name)
+    {
+        BOOST_FOREACH(const std::string &input, inputs){
+            _readers.push_back(boost::make_shared<data_reader_t<double> >(db, input));
+            bind_accessor(*_readers.back());
+        }
+        BOOST_FOREACH(const std::string &output, outputs){
+            _writers.push_back(boost::make_shared<data_writer_t<double> >(db, output));
+            bind_accessor(*_writers.back());
+        }
+    }
+
+private:
+    void resolve() {
+        double value = 0.0;
+        BOOST_FOREACH(const boost::shared_ptr<data_reader_t<double> > &reader, _readers){
+            value += reader->get();
+        }
+        for (size_t i = 0; i < _writers.size(); i++){
+            _writers[i]->set(value + double(i));
+        }
+    }
+
+    std::vector<boost::shared_ptr<data_reader_t<double> > > _readers;
+    std::vector<boost::shared_ptr<data_writer_t<double> > > _writers;
+};
+
+static std::vector<std::string> names(const std::string &prefix, const char *a, const char *b = NULL, const char *c = NULL){
+    std::vector<std::string> result(1, prefix + a);
+    if (b) result.push_back(prefix + b);
+    if (c) result.push_back(prefix + c);
+    return result;
+}
+
+/*!
+ * Build the experts of the TwinRX channels: the signal path, the LO
+ * frequencies, a synthesizer per LO, the frequency coercion and the gain
+ * mapping per channel, and one settings expert that writes them all.
+ * Return the paths of the frequency and gain properties.
+ */
+static void make_mock_experts(
+    expert_container::sptr container, uhd::property_tree::sptr tree, const size_t num_chans,
+    std::vector<uhd::fs_path> &freq_paths, std::vector<uhd::fs_path> &gain_paths
+){
+    std::vector<std::string> settings_inputs;
+    for (size_t ch = 0; ch < num_chans; ch++){
+        const std::string p = str(boost::format("ch%u/") % ch);
+        const uhd::fs_path fe_path = str(boost::format("/dboards/%u/rx_frontends/%u") % (ch/2) % (ch%2));
+        expert_factory::add_dual_prop_node<double>(container, tree, fe_path / "freq/value",
+            p + "freq/desired", p + "freq/coerced", 1e9, AUTO_RESOLVE_ON_WRITE);
+        expert_factory::add_dual_prop_node<double>(container, tree, fe_path / "gain/value",
+            p + "gain/desired", p + "gain/coerced", 0.0, AUTO_RESOLVE_ON_WRITE);
+        freq_paths.push_back(fe_path / "freq/value");
+        gain_paths.push_back(fe_path / "gain/value");
+
+        const char *data_nodes[] = {"path", "if_freq", "lo1_freq", "lo2_freq", "lo1_actual", "lo2_actual", "atten"};
+        BOOST_FOREACH(const char *node, data_nodes){
+            expert_factory::add_data_node<double>(container, p + node, 0.0);
+        }
+        expert_factory::add_worker_node<mock_worker_t>(container, container->node_retriever(), p + "frontend_path",
+            names(p, "freq/desired"), names(p, "path", "if_freq"));
+        expert_factory::add_worker_node<mock_worker_t>(container, container->node_retriever(), p + "lo_freq",
+            names(p, "freq/desired", "path", "if_freq"), names(p, "lo1_freq", "lo2_freq"));
+        expert_factory::add_worker_node<mock_worker_t>(container, container->node_retriever(), p + "lo1_synth",
+            names(p, "lo1_freq"), names(p, "lo1_actual"));
+        expert_factory::add_worker_node<mock_worker_t>(container, container->node_retriever(), p + "lo2_synth",
+            names(p, "lo2_freq"), names(p, "lo2_actual"));
+        expert_factory::add_worker_node<mock_worker_t>(container, container->node_retriever(), p + "freq_coercion",
+            names(p, "lo1_actual", "lo2_actual"), names(p, "freq/coerced"));
+        expert_factory::add_worker_node<mock_worker_t>(container, container->node_retriever(), p + "gain",
+            names(p, "gain/desired", "freq/desired", "path"), names(p, "gain/coerced", "atten"));
+
+        const char *settings[] = {"path", "lo1_actual", "lo2_actual", "atten"};
+        BOOST_FOREACH(const char *node, settings){
+            settings_inputs.push_back(p + node);
+        }
+    }
+    expert_factory::add_data_node<double>(container, "regs", 0.0);
+    expert_factory::add_worker_node<mock_worker_t>(container, container->node_retriever(), "settings",
+        settings_inputs, std::vector<std::string>(1, "regs"));
+    container->resolve_all(true);
+}
+
+static void resolve_all(expert_container::sptr container, const size_t){
+    container->resolve_all(true);
+}
+
+/***********************************************************************
+ * Main
+ **********************************************************************/
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    std::string tree_file;
+    size_t iterations, num_subscribers, num_chans, num_threads;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("iterations", po::value<size_t>(&iterations)->default_value(100000), "the number of operations per test")
+        ("tree_file", po::value<std::string>(&tree_file), "build the tree from the output of uhd_usrp_probe --tree")
+        ("subscribers", po::value<size_t>(&num_subscribers)->default_value(4), "the subscribers on each mock frequency property")
+        ("chans", po::value<size_t>(&num_chans)->default_value(4), "the channels of the expert graph")
+        ("resolver_threads", po::value<size_t>(&num_threads)->default_value(1), "the resolver threads of the expert container")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")){
+        std::cout << boost::format("UHD Property Tree Benchmark %s") % desc << std::endl;
+        return ~0;
+    }
+
+    //property tree
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    size_t num_updates = 0;
+    const std::vector<uhd::fs_path> freq_paths = make_mock_tree(tree, num_subscribers, &num_updates);
+    std::vector<uhd::fs_path> get_paths = freq_paths;
+    if (vm.count("tree_file")){
+        get_paths = load_tree(tree->subtree("/probe"), tree_file);
+        BOOST_FOREACH(uhd::fs_path &path, get_paths) path = "/probe" + path;
+        std::cout << boost::format("Loaded %u properties from %s") % get_paths.size() % tree_file << std::endl;
+    }
+    std::vector<boost::shared_ptr<uhd::property<double> > > handles;
+    BOOST_FOREACH(const uhd::fs_path &path, get_paths){
+        handles.push_back(tree->access_handle<double>(path));
+    }
+
+    measure("tree_get", boost::bind(&tree_get, tree, boost::cref(get_paths), _1), iterations);
+    measure("handle_get", boost::bind(&handle_get, boost::cref(handles), _1), iterations);
+    measure("tree_list", boost::bind(&tree_list, tree, boost::cref(get_paths), _1), iterations);
+    measure("tree_set", boost::bind(&tree_set, tree, boost::cref(freq_paths), _1), iterations);
+
+    //expert graph
+    expert_container::sptr container = expert_factory::create_container("benchmark", num_threads);
+    std::vector<uhd::fs_path> retune_paths, gain_paths;
+    make_mock_experts(container, tree->subtree("/experts"), num_chans, retune_paths, gain_paths);
+    BOOST_FOREACH(uhd::fs_path &path, retune_paths) path = "/experts" + path;
+    BOOST_FOREACH(uhd::fs_path &path, gain_paths) path = "/experts" + path;
+
+    measure("expert_retune", boost::bind(&tree_set, tree, boost::cref(retune_paths), _1), iterations);
+    measure("expert_gain", boost::bind(&tree_set, tree, boost::cref(gain_paths), _1), iterations);
+    measure("expert_resolve", boost::bind(&resolve_all, container, _1), iterations);
+
+    return EXIT_SUCCESS;
+}
@@ -209,6 +209,46 @@ BOOST_AUTO_TEST_CASE(test_prop_tree){
 
 }
 
+BOOST_AUTO_TEST_CASE(test_prop_tree_paths){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+
+    tree->create<int>("/test/dir/prop0").set(7);
+
+    //redundant slashes resolve to the same node
+    BOOST_CHECK(tree->exists("test/dir/prop0"));
+    BOOST_CHECK(tree->exists("//test//dir/prop0/"));
+    BOOST_CHECK_EQUAL(tree->access<int>("test//dir/prop0").get(), 7);
+    BOOST_CHECK_THROW(tree->access<int>("/test/dir/prop1"), uhd::lookup_error);
+
+    //removing a directory removes all paths below it
+    tree->create<int>("/test/dir2/prop0");
+    tree->remove("/test/dir");
+    BOOST_CHECK(not tree->exists("/test/dir"));
+    BOOST_CHECK(not tree->exists("/test/dir/prop0"));
+    BOOST_CHECK(tree->exists("/test/dir2/prop0"));
+    BOOST_CHECK_THROW(tree->remove("/test/dir"), uhd::lookup_error);
+    BOOST_CHECK_THROW(tree->remove("/"), uhd::runtime_error);
+
+    //re-created paths are found again
+    tree->create<int>("/test/dir/prop0").set(8);
+    BOOST_CHECK_EQUAL(tree->access<int>("/test/dir/prop0").get(), 8);
+}
+
+BOOST_AUTO_TEST_CASE(test_prop_tree_handle){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    tree->create<int>("/test/prop0").set(42);
+
+    boost::shared_ptr<uhd::property<int> > handle = tree->access_handle<int>("/test/prop0");
+    BOOST_CHECK_EQUAL(handle->get(), 42);
+    handle->set(34);
+    BOOST_CHECK_EQUAL(tree->access<int>("/test/prop0").get(), 34);
+
+    //the handle outlives the removal from the tree
+    tree->remove("/test/prop0");
+    BOOST_CHECK_EQUAL(handle->get(), 34);
+    BOOST_CHECK_THROW(tree->access_handle<int>("/test/prop0"), uhd::lookup_error);
+}
+
 BOOST_AUTO_TEST_CASE(test_prop_subtree){
     uhd::property_tree::sptr tree = uhd::property_tree::make();
     tree->create<int>("/subdir1/subdir2");
@@ -245,3 +285,76 @@ BOOST_AUTO_TEST_CASE(test_prop_operators)
     path4 = path4 / x;
     BOOST_CHECK_EQUAL(path4, "/root/2");
 }
+
+BOOST_AUTO_TEST_CASE(test_prop_transaction){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    setter_type setter;
+    uhd::property<int> &prop1 = tree->create<int>("/a/x");
+    uhd::property<int> &prop2 = tree->create<int>("/a/y");
+    prop2.add_coerced_subscriber(boost::bind(&setter_type::doit, &setter, _1));
+
+    uhd::property_transaction transaction(tree->subtree("/a"));
+    transaction.set<int>("x", 1).set<int>("y", 2).set<int>("x", 3);
+    BOOST_CHECK_EQUAL(transaction.size(), 3);
+    BOOST_CHECK_THROW(transaction.set<int>("z", 4), uhd::lookup_error);
+    BOOST_CHECK(prop1.empty());
+
+    //applied in order, the last change of a property wins
+    transaction.commit();
+    BOOST_CHECK_EQUAL(prop1.get(), 3);
+    BOOST_CHECK_EQUAL(prop2.get(), 2);
+    BOOST_CHECK_EQUAL(setter._x, 2);
+
+    transaction.clear();
+    BOOST_CHECK_EQUAL(transaction.size(), 0);
+    transaction.commit();
+    BOOST_CHECK_EQUAL(prop1.get(), 3);
+}
+
+static int coerce_to_rate(uhd::property<int> *rate, int x){
+    return x - x % rate->get();
+}
+
+BOOST_AUTO_TEST_CASE(test_prop_snapshot){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    setter_type rate_setter, freq_setter, gain_setter;
+    uhd::property<int> &rate = tree->create<int>("/a/rate");
+    rate.add_coerced_subscriber(boost::bind(&setter_type::doit, &rate_setter, _1));
+    uhd::property<int> &freq = tree->create<int>("/a/freq", uhd::property_tree::MANUAL_COERCE);
+    freq.set_coercer(boost::bind(&coerce_to_rate, &rate, _1));
+    freq.add_coerced_subscriber(boost::bind(&setter_type::doit, &freq_setter, _1));
+    uhd::property<int> &gain = tree->create<int>("/a/gain");
+    gain.add_coerced_subscriber(boost::bind(&setter_type::doit, &gain_setter, _1));
+    tree->create<int>("/a/unset");
+
+    rate.set(4);
+    freq.set(10);
+    gain.set(5);
+    BOOST_CHECK_EQUAL(freq.get(), 8);
+
+    uhd::property_snapshot snapshot(tree->subtree("/a"));
+    snapshot.add<int>("rate").add<int>("freq").add<int>("gain").add<int>("unset");
+    BOOST_CHECK_EQUAL(snapshot.size(), 4);
+    BOOST_CHECK_THROW(snapshot.add<int>("missing"), uhd::lookup_error);
+    snapshot.capture();
+
+    //the frequency has the same desired value, but was coerced to the new rate
+    rate.set(3);
+    freq.set(10);
+    BOOST_CHECK_EQUAL(freq.get(), 9);
+    rate_setter._count = freq_setter._count = gain_setter._count = 0;
+
+    //only the changed properties are set, in order
+    snapshot.restore();
+    BOOST_CHECK_EQUAL(rate.get(), 4);
+    BOOST_CHECK_EQUAL(freq.get(), 8);
+    BOOST_CHECK_EQUAL(rate_setter._count, 1);
+    BOOST_CHECK_EQUAL(freq_setter._count, 1);
+    BOOST_CHECK_EQUAL(gain_setter._count, 0);
+    BOOST_CHECK(tree->access<int>("/a/unset").empty());
+
+    //nothing to do when nothing changed
+    snapshot.restore();
+    BOOST_CHECK_EQUAL(rate_setter._count, 1);
+    BOOST_CHECK_EQUAL(freq_setter._count, 1);
+}
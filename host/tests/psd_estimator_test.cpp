@@ -0,0 +1,98 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "../lib/transport/psd_estimator.hpp"
+#include <boost/test/unit_test.hpp>
+#include <uhd/exception.hpp>
+#include <complex>
+#include <cmath>
+#include <vector>
+
+using uhd::transport::complex_fft;
+using uhd::transport::psd_estimator;
+
+static const double PI = 3.14159265358979323846;
+
+//! A full scale tone on a bin, negative bins are the upper half
+static std::vector<std::complex<float> > make_tone(const size_t size, const double bin){
+    std::vector<std::complex<float> > tone(size);
+    for (size_t n = 0; n < size; n++){
+        const double phase = 2*PI*bin*n/size;
+        tone[n] = std::complex<float>(float(std::cos(phase)), float(std::sin(phase)));
+    }
+    return tone;
+}
+
+BOOST_AUTO_TEST_CASE(test_complex_fft_matches_dft){
+    for (size_t size = 1; size <= 16; size++){
+        std::vector<std::complex<float> > x(size), y(size);
+        for (size_t n = 0; n < size; n++) x[n] = std::complex<float>(float(n % 3) - 0.5f, float(n % 5)*0.25f);
+        for (size_t k = 0; k < size; k++){
+            std::complex<double> acc;
+            for (size_t n = 0; n < size; n++) acc += std::complex<double>(x[n])*std::polar(1.0, -2*PI*double(k*n)/size);
+            y[k] = std::complex<float>(acc);
+        }
+        complex_fft fft(size, true);
+        fft.transform(&x.front());
+        for (size_t k = 0; k < size; k++) BOOST_CHECK_SMALL(std::abs(x[k] - y[k]), 1e-4f);
+    }
+    BOOST_CHECK_THROW(complex_fft(0, true), uhd::value_error);
+}
+
+//! Average tones, check the tone bin, its window neighbours and the floor
+static void check_tone(const size_t size, const int bin){
+    psd_estimator psd(size, false);
+    const std::vector<std::complex<float> > tone = make_tone(size, bin);
+    for (size_t i = 0; i < 4; i++) psd.add_frame(&tone.front());
+    BOOST_CHECK_EQUAL(psd.get_num_frames(), 4);
+
+    std::vector<float> bins;
+    psd.get_average(bins);
+    BOOST_REQUIRE_EQUAL(bins.size(), size);
+    const size_t center = size/2 + bin;
+    for (size_t i = 0; i < size; i++){
+        if (i == center) BOOST_CHECK_SMALL(bins[i], 0.01f);
+        else if (i + 1 == center or i == center + 1) BOOST_CHECK_CLOSE(bins[i], -6.02f, 0.5);
+        else BOOST_CHECK_LT(bins[i], -80.0f);
+    }
+
+    psd.reset();
+    BOOST_CHECK_EQUAL(psd.get_num_frames(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_psd_estimator_tones){
+    check_tone(64, 5);  //radix 2 FFT
+    check_tone(64, -3);
+    check_tone(64, 0);
+    check_tone(48, 7);  //DFT
+    check_tone(48, -20);
+}
+
+BOOST_AUTO_TEST_CASE(test_psd_estimator_transformed){
+    //spectra are averaged as they come, with no shift
+    psd_estimator psd(16, true);
+    std::vector<std::complex<float> > frame(16);
+    frame[7] = std::complex<float>(0.0f, 0.5f);
+    psd.add_frame(&frame.front());
+    frame[7] = std::complex<float>(0.5f, 0.0f);
+    psd.add_frame(&frame.front());
+
+    std::vector<float> bins;
+    psd.get_average(bins);
+    BOOST_CHECK_CLOSE(bins[7], -6.02f, 0.1);
+    BOOST_CHECK_LT(bins[0], -150.0f);
+}
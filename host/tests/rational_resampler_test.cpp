@@ -0,0 +1,98 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "../lib/transport/rational_resampler.hpp"
+#include <boost/test/unit_test.hpp>
+#include <uhd/exception.hpp>
+#include <complex>
+#include <cmath>
+#include <vector>
+
+using uhd::transport::rational_resampler;
+
+static const double PI = 3.14159265358979323846;
+
+BOOST_AUTO_TEST_CASE(test_rational_resampler_factors){
+    size_t interp, decim;
+    BOOST_CHECK_EQUAL(rational_resampler::get_factors(25e6, 20e6, 1024, interp, decim), 20e6);
+    BOOST_CHECK_EQUAL(interp, 4U);
+    BOOST_CHECK_EQUAL(decim, 5U);
+
+    BOOST_CHECK_CLOSE(rational_resampler::get_factors(200e6/3, 61.44e6, 1024, interp, decim), 61.44e6, 1e-9);
+    BOOST_CHECK_EQUAL(interp, 576U);
+    BOOST_CHECK_EQUAL(decim, 625U);
+
+    //no exact factors within the limit, the closest rate comes back
+    const double rate = rational_resampler::get_factors(1e6, 1e6*std::sqrt(2.0), 100, interp, decim);
+    BOOST_CHECK(interp <= 100 and decim <= 100);
+    BOOST_CHECK_CLOSE(rate, 1e6*std::sqrt(2.0), 0.01);
+
+    BOOST_CHECK_THROW(rational_resampler::get_factors(1e6, 1e3, 100, interp, decim), uhd::value_error);
+    BOOST_CHECK_THROW(rational_resampler::get_factors(0.0, 1e3, 100, interp, decim), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_rational_resampler_blocks){
+    std::vector<std::complex<float> > in(1000);
+    for (size_t i = 0; i < in.size(); i++){
+        in[i] = std::complex<float>(float(std::cos(0.01*i*i)), float(std::sin(0.03*i)));
+    }
+
+    //one block and odd sized blocks give the same stream
+    rational_resampler one(4, 5, 16);
+    BOOST_CHECK_EQUAL(one.get_num_outputs(in.size()), 800U);
+    BOOST_CHECK_EQUAL(one.get_num_inputs(800), 999U);
+    std::vector<std::complex<float> > expected(one.get_num_outputs(in.size()));
+    BOOST_CHECK_EQUAL(one.process(&in.front(), in.size(), &expected.front()), 800U);
+
+    rational_resampler blocks(4, 5, 16);
+    std::vector<std::complex<float> > out;
+    for (size_t i = 0, n = 1; i < in.size(); i += n, n = n % 37 + 3){
+        const size_t num_inputs = std::min(n, in.size() - i);
+        std::vector<std::complex<float> > block(blocks.get_num_outputs(num_inputs));
+        BOOST_CHECK_EQUAL(blocks.process(&in[i], num_inputs, block.empty()? NULL : &block.front()), block.size());
+        out.insert(out.end(), block.begin(), block.end());
+    }
+    BOOST_REQUIRE_EQUAL(out.size(), expected.size());
+    for (size_t i = 0; i < out.size(); i++){
+        BOOST_CHECK_SMALL(std::abs(out[i] - expected[i]), 1e-5f);
+    }
+
+    //the inputs that outputs need produce at least as many outputs
+    for (size_t n = 1; n < 50; n++){
+        BOOST_CHECK(blocks.get_num_outputs(blocks.get_num_inputs(n)) >= n);
+        BOOST_CHECK(blocks.get_num_outputs(blocks.get_num_inputs(n) - 1) < n);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_rational_resampler_tone){
+    //a 1 MHz tone from 25 Msps to 20 Msps
+    const double in_rate = 25e6, out_rate = 20e6, freq = 1e6;
+    std::vector<std::complex<float> > in(2000);
+    for (size_t i = 0; i < in.size(); i++){
+        in[i] = std::polar(1.0f, float(2*PI*freq*i/in_rate));
+    }
+    rational_resampler resampler(4, 5, 32);
+    std::vector<std::complex<float> > out(resampler.get_num_outputs(in.size()));
+    resampler.process(&in.front(), in.size(), &out.front());
+
+    //past the filter, output n is the tone at the time n/out_rate - delay/in_rate
+    const double delay = resampler.get_delay()/in_rate;
+    for (size_t n = 100; n < out.size(); n++){
+        const std::complex<float> expected = std::polar(1.0f, float(2*PI*freq*(n/out_rate - delay)));
+        BOOST_CHECK_SMALL(std::abs(out[n] - expected), 1e-3f);
+    }
+}
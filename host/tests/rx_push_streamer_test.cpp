@@ -0,0 +1,180 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/rx_push_streamer.hpp>
+#include <uhd/exception.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+static const double SAMP_RATE = 1e6;
+
+/***********************************************************************
+ * A dummy rx streamer: each sample holds its index in the stream
+ **********************************************************************/
+class dummy_rx_streamer : public uhd::rx_streamer{
+public:
+    dummy_rx_streamer(const size_t num_chans, const size_t num_samps_total):
+        _num_chans(num_chans), _num_samps_total(num_samps_total), _num_samps(0)
+    {
+        /* NOP */
+    }
+
+    size_t get_num_channels(void) const{
+        return _num_chans;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return 100;
+    }
+
+    size_t recv(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout = 0.1,
+        const bool = false
+    ){
+        metadata.reset();
+        if (_num_samps == _num_samps_total){
+            boost::this_thread::sleep(boost::posix_time::microseconds(long(timeout*1e6)));
+            metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_TIMEOUT;
+            return 0;
+        }
+        const size_t nsamps = std::min(nsamps_per_buff, _num_samps_total - _num_samps);
+        for (size_t ch = 0; ch < _num_chans; ch++){
+            uint32_t *samps = reinterpret_cast<uint32_t *>(buffs[ch]);
+            for (size_t i = 0; i < nsamps; i++) samps[i] = uint32_t(_num_samps + i);
+        }
+        metadata.has_time_spec = true;
+        metadata.time_spec = uhd::time_spec_t::from_ticks(_num_samps, SAMP_RATE);
+        _num_samps += nsamps;
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const uhd::stream_cmd_t &){
+        /* NOP */
+    }
+
+private:
+    const size_t _num_chans;
+    const size_t _num_samps_total;
+    size_t _num_samps;
+};
+
+/***********************************************************************
+ * A handler that keeps every block
+ **********************************************************************/
+struct block_keeper{
+    void handle(const uhd::rx_push_streamer::block_sptr &block){
+        boost::mutex::scoped_lock lock(mutex);
+        blocks.push_back(block);
+    }
+
+    size_t size(void){
+        boost::mutex::scoped_lock lock(mutex);
+        return blocks.size();
+    }
+
+    bool wait_for_size(const size_t num_blocks){
+        for (size_t i = 0; i < 100; i++){
+            if (this->size() >= num_blocks) return true;
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        }
+        return false;
+    }
+
+    boost::mutex mutex;
+    std::vector<uhd::rx_push_streamer::block_sptr> blocks;
+};
+
+BOOST_AUTO_TEST_CASE(test_rx_push_streamer_blocks){
+    static const size_t NUM_SAMPS = 1050;
+    static const size_t BLOCK_SIZE = 250;
+    uhd::rx_streamer::sptr rx_stream(new dummy_rx_streamer(2, NUM_SAMPS));
+    block_keeper keeper;
+    uhd::rx_push_streamer::sptr pump = uhd::rx_push_streamer::make(
+        rx_stream, uhd::stream_args_t("sc16"),
+        boost::bind(&block_keeper::handle, &keeper, _1),
+        uhd::device_addr_t("block_size=250,queue_depth=8")
+    );
+    BOOST_CHECK_EQUAL(pump->get_block_size(), BLOCK_SIZE);
+    BOOST_CHECK_EQUAL(pump->get_queue_depth(), 8U);
+
+    //the last block is short, timeouts are not handed out
+    static const size_t NUM_BLOCKS = (NUM_SAMPS + BLOCK_SIZE - 1)/BLOCK_SIZE;
+    BOOST_REQUIRE(keeper.wait_for_size(NUM_BLOCKS));
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+    BOOST_REQUIRE_EQUAL(keeper.size(), NUM_BLOCKS);
+
+    size_t num_accum_samps = 0;
+    for (size_t i = 0; i < NUM_BLOCKS; i++){
+        const uhd::rx_push_streamer::block_sptr block = keeper.blocks[i];
+        BOOST_CHECK_EQUAL(block->metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK_EQUAL(block->metadata.time_spec.to_ticks(SAMP_RATE), (long long)num_accum_samps);
+        BOOST_CHECK_EQUAL(block->nsamps, std::min(BLOCK_SIZE, NUM_SAMPS - num_accum_samps));
+        BOOST_REQUIRE_EQUAL(block->buffs.size(), 2U);
+        for (size_t ch = 0; ch < 2; ch++){
+            const uint32_t *samps = reinterpret_cast<const uint32_t *>(block->buffs[ch]);
+            BOOST_CHECK_EQUAL(samps[0], num_accum_samps);
+            BOOST_CHECK_EQUAL(samps[block->nsamps-1], num_accum_samps + block->nsamps - 1);
+        }
+        num_accum_samps += block->nsamps;
+    }
+    BOOST_CHECK_EQUAL(pump->get_num_stalls(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(test_rx_push_streamer_queue_depth){
+    uhd::rx_streamer::sptr rx_stream(new dummy_rx_streamer(1, 100000));
+    block_keeper keeper;
+    uhd::rx_push_streamer::sptr pump = uhd::rx_push_streamer::make(
+        rx_stream, uhd::stream_args_t("sc16"),
+        boost::bind(&block_keeper::handle, &keeper, _1),
+        uhd::device_addr_t("queue_depth=4")
+    );
+    BOOST_CHECK_EQUAL(pump->get_block_size(), rx_stream->get_max_num_samps());
+
+    //holding every block stalls the thread
+    BOOST_REQUIRE(keeper.wait_for_size(4));
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+    BOOST_CHECK_EQUAL(keeper.size(), 4U);
+    BOOST_CHECK(pump->get_num_stalls() > 0);
+
+    //releasing the blocks lets it continue
+    {
+        boost::mutex::scoped_lock lock(keeper.mutex);
+        keeper.blocks.clear();
+    }
+    BOOST_CHECK(keeper.wait_for_size(4));
+
+    //the held blocks outlive the push streamer
+    pump.reset();
+    BOOST_CHECK(keeper.size() >= 4);
+    BOOST_CHECK_EQUAL(keeper.blocks.front()->nsamps, rx_stream->get_max_num_samps());
+}
+
+BOOST_AUTO_TEST_CASE(test_rx_push_streamer_bad_args){
+    uhd::rx_streamer::sptr rx_stream(new dummy_rx_streamer(1, 0));
+    block_keeper keeper;
+    BOOST_CHECK_THROW(uhd::rx_push_streamer::make(
+        rx_stream, uhd::stream_args_t("sc16"),
+        boost::bind(&block_keeper::handle, &keeper, _1),
+        uhd::device_addr_t("queue_depth=0")
+    ), uhd::value_error);
+}
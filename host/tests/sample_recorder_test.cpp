@@ -0,0 +1,174 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/utils/sample_recorder.hpp>
+#include <uhd/utils/sample_reader.hpp>
+#include <uhd/exception.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+static fs::path make_temp_path(void){
+    return fs::temp_directory_path() / fs::unique_path("sample_recorder_test_%%%%-%%%%.dat");
+}
+
+static std::vector<char> read_file(const fs::path &path){
+    std::ifstream file(path.string().c_str(), std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+static std::vector<char> make_samples(const size_t nbytes){
+    std::vector<char> samples(nbytes);
+    for (size_t i = 0; i < nbytes; i++) samples[i] = char(i*7 + i/4096);
+    return samples;
+}
+
+BOOST_AUTO_TEST_CASE(test_sample_recorder_one_file){
+    const fs::path path = make_temp_path();
+    const std::vector<char> samples = make_samples(10*4096 + 1000);
+
+    uhd::sample_recorder::sptr recorder = uhd::sample_recorder::make(
+        std::vector<std::string>(1, path.string()), uhd::device_addr_t("buff_size=4096,num_buffs=16")
+    );
+    for (size_t offset = 0; offset < samples.size(); offset += 1000){
+        const size_t nbytes = std::min<size_t>(1000, samples.size() - offset);
+        BOOST_CHECK(recorder->write(&samples[offset], nbytes));
+    }
+    recorder->close();
+    BOOST_CHECK_EQUAL(recorder->get_num_written_bytes(), samples.size());
+    BOOST_CHECK_EQUAL(recorder->get_num_dropped_bytes(), 0U);
+
+    const std::vector<char> recorded = read_file(path);
+    BOOST_CHECK(recorded == samples);
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(test_sample_recorder_striped){
+    std::vector<std::string> paths;
+    paths.push_back(make_temp_path().string());
+    paths.push_back(make_temp_path().string());
+    const std::vector<char> samples = make_samples(3*4096 + 100);
+
+    uhd::sample_recorder::sptr recorder = uhd::sample_recorder::make(
+        paths, uhd::device_addr_t("buff_size=4096,num_buffs=8")
+    );
+    BOOST_CHECK(recorder->write(&samples.front(), samples.size()));
+    recorder->close();
+
+    //buffers 0 and 2 go to the first file, 1 and the last partial one to the second
+    std::vector<char> expected0(samples.begin(), samples.begin() + 4096);
+    expected0.insert(expected0.end(), samples.begin() + 2*4096, samples.begin() + 3*4096);
+    std::vector<char> expected1(samples.begin() + 4096, samples.begin() + 2*4096);
+    expected1.insert(expected1.end(), samples.begin() + 3*4096, samples.end());
+    BOOST_CHECK(read_file(paths[0]) == expected0);
+    BOOST_CHECK(read_file(paths[1]) == expected1);
+    fs::remove(paths[0]);
+    fs::remove(paths[1]);
+}
+
+BOOST_AUTO_TEST_CASE(test_sample_recorder_overflow){
+    const fs::path path = make_temp_path();
+    const std::vector<char> samples = make_samples(2*4096);
+
+    uhd::sample_recorder::sptr recorder = uhd::sample_recorder::make(
+        std::vector<std::string>(1, path.string()), uhd::device_addr_t("buff_size=4096,num_buffs=1")
+    );
+    //needs two buffers of a ring of one: dropped whole
+    BOOST_CHECK(not recorder->write(&samples.front(), samples.size()));
+    BOOST_CHECK_EQUAL(recorder->get_num_dropped_bytes(), samples.size());
+    BOOST_CHECK(recorder->write(&samples.front(), 100));
+    recorder->close();
+    BOOST_CHECK_EQUAL(recorder->get_num_written_bytes(), 100U);
+    BOOST_CHECK_EQUAL(fs::file_size(path), 100U);
+    fs::remove(path);
+
+    BOOST_CHECK_THROW(uhd::sample_recorder::make(
+        std::vector<std::string>(1, path.string()), uhd::device_addr_t("buff_size=1000")
+    ), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::sample_recorder::make(
+        std::vector<std::string>(1, (path / "no_such_dir" / "file").string())
+    ), uhd::io_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_sample_recorder_index){
+    std::vector<std::string> paths;
+    paths.push_back(make_temp_path().string());
+    paths.push_back(make_temp_path().string());
+    const fs::path index_path = make_temp_path();
+    const double rate = 1e6;
+
+    uhd::sample_recorder::sptr recorder = uhd::sample_recorder::make(paths, uhd::device_addr_t(
+        "buff_size=4096,num_buffs=16,item_size=4,samp_rate=1e6,index=" + index_path.string()
+    ));
+    std::vector<uint32_t> samples(1000);
+    uhd::rx_metadata_t md;
+    md.has_time_spec = true;
+    for (size_t n = 0; n < 10; n++){
+        //an overflow loses 95 ms after the fifth block
+        if (n == 5){
+            uhd::rx_metadata_t overflow;
+            overflow.error_code = uhd::rx_metadata_t::ERROR_CODE_OVERFLOW;
+            BOOST_CHECK(recorder->write(NULL, 0, overflow));
+        }
+        for (size_t i = 0; i < samples.size(); i++) samples[i] = uint32_t(n*1000 + i);
+        md.time_spec = uhd::time_spec_t(1.0) + uhd::time_spec_t::from_ticks(n*1000 + ((n < 5)? 0 : 95000), rate);
+        BOOST_CHECK(recorder->write(&samples.front(), samples.size()*4, md));
+    }
+    recorder->close();
+
+    uhd::sample_reader::sptr reader = uhd::sample_reader::make(paths, index_path.string());
+    BOOST_CHECK_EQUAL(reader->get_item_size(), 4U);
+    BOOST_CHECK_EQUAL(reader->get_samp_rate(), rate);
+    BOOST_CHECK_EQUAL(reader->get_num_samps(), 10000U);
+    BOOST_CHECK_EQUAL(reader->get_time(0).to_ticks(rate), 1000000);
+    BOOST_CHECK_EQUAL(reader->get_time(4999).to_ticks(rate), 1004999);
+    BOOST_CHECK_EQUAL(reader->get_time(5000).to_ticks(rate), 1100000);
+    BOOST_CHECK_EQUAL(reader->get_time(9999).to_ticks(rate), 1104999);
+    BOOST_CHECK_THROW(reader->get_time(10000), uhd::index_error);
+
+    const std::vector<uint64_t> discontinuities = reader->get_discontinuities();
+    BOOST_REQUIRE_EQUAL(discontinuities.size(), 1U);
+    BOOST_CHECK_EQUAL(discontinuities[0], 5000U);
+
+    BOOST_CHECK_EQUAL(reader->find(uhd::time_spec_t(0.5)), 0U);
+    BOOST_CHECK_EQUAL(reader->find(uhd::time_spec_t(1.002)), 2000U);
+    BOOST_CHECK_EQUAL(reader->find(uhd::time_spec_t(1.05)), 5000U);
+    BOOST_CHECK_EQUAL(reader->find(uhd::time_spec_t(1.1005)), 5500U);
+    BOOST_CHECK_EQUAL(reader->find(uhd::time_spec_t(2.0)), 10000U);
+
+    //crosses the stripes of both files
+    std::vector<uint32_t> read_samples(3000);
+    BOOST_CHECK_EQUAL(reader->read(&read_samples.front(), 4000, read_samples.size()), 3000U);
+    for (size_t i = 0; i < read_samples.size(); i++){
+        BOOST_CHECK_EQUAL(read_samples[i], uint32_t(4000 + i));
+    }
+    BOOST_CHECK_EQUAL(reader->read(&read_samples.front(), 9500, read_samples.size()), 500U);
+    BOOST_CHECK_EQUAL(read_samples[499], 9999U);
+
+    reader.reset();
+    fs::remove(paths[0]);
+    fs::remove(paths[1]);
+    fs::remove(index_path);
+
+    BOOST_CHECK_THROW(uhd::sample_recorder::make(paths, uhd::device_addr_t(
+        "item_size=4,index=" + index_path.string()
+    )), uhd::value_error);
+}
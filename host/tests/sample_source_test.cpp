@@ -0,0 +1,123 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/utils/sample_recorder.hpp>
+#include <uhd/utils/sample_source.hpp>
+#include <uhd/exception.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+static fs::path make_temp_path(void){
+    return fs::temp_directory_path() / fs::unique_path("sample_source_test_%%%%-%%%%.dat");
+}
+
+static std::vector<char> make_samples(const size_t nbytes){
+    std::vector<char> samples(nbytes);
+    for (size_t i = 0; i < nbytes; i++) samples[i] = char(i*7 + i/4096);
+    return samples;
+}
+
+static void write_file(const fs::path &path, const std::vector<char> &samples){
+    std::ofstream file(path.string().c_str(), std::ios::binary);
+    file.write(&samples.front(), samples.size());
+}
+
+static std::vector<char> read_all(uhd::sample_source::sptr source, const size_t max_bytes){
+    std::vector<char> played;
+    std::vector<char> buff(700);
+    while (not source->eof() and played.size() < max_bytes){
+        const size_t nbytes = source->read(&buff.front(), std::min(buff.size(), max_bytes - played.size()), 1.0);
+        played.insert(played.end(), buff.begin(), buff.begin() + nbytes);
+    }
+    return played;
+}
+
+BOOST_AUTO_TEST_CASE(test_sample_source_files){
+    std::vector<std::string> paths;
+    paths.push_back(make_temp_path().string());
+    paths.push_back(make_temp_path().string());
+    const std::vector<char> samples = make_samples(5000);
+    write_file(paths[0], std::vector<char>(samples.begin(), samples.begin() + 3000));
+    write_file(paths[1], std::vector<char>(samples.begin() + 3000, samples.end()));
+
+    //a ring smaller than the files, played one after another
+    uhd::sample_source::sptr source = uhd::sample_source::make(
+        paths, uhd::device_addr_t("buff_size=1024,num_buffs=2")
+    );
+    BOOST_CHECK_EQUAL(source->get_num_bytes(), samples.size());
+    BOOST_CHECK(read_all(source, 100000) == samples);
+    BOOST_CHECK(source->eof());
+
+    //start at an offset
+    source = uhd::sample_source::make(paths, uhd::device_addr_t("buff_size=1024,offset=2500"));
+    BOOST_CHECK(read_all(source, 100000) == std::vector<char>(samples.begin() + 2500, samples.end()));
+
+    BOOST_CHECK_THROW(uhd::sample_source::make(paths, uhd::device_addr_t("offset=6000")), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::sample_source::make(
+        std::vector<std::string>(1, make_temp_path().string())
+    ), uhd::io_error);
+    source.reset();
+    fs::remove(paths[0]);
+    fs::remove(paths[1]);
+}
+
+BOOST_AUTO_TEST_CASE(test_sample_source_loop){
+    const fs::path path = make_temp_path();
+    const std::vector<char> samples = make_samples(3000);
+    write_file(path, samples);
+
+    uhd::sample_source::sptr source = uhd::sample_source::make(
+        std::vector<std::string>(1, path.string()), uhd::device_addr_t("buff_size=1024,num_buffs=4,loop=1")
+    );
+    //the wrap point is inside a buffer, the samples continue without a gap
+    const std::vector<char> played = read_all(source, 2*samples.size() + 1234);
+    BOOST_CHECK(not source->eof());
+    BOOST_REQUIRE_EQUAL(played.size(), 2*samples.size() + 1234);
+    for (size_t i = 0; i < played.size(); i++){
+        if (played[i] != samples[i % samples.size()]){
+            BOOST_ERROR("mismatch at byte " << i);
+            break;
+        }
+    }
+    source.reset();
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(test_sample_source_striped){
+    std::vector<std::string> paths;
+    paths.push_back(make_temp_path().string());
+    paths.push_back(make_temp_path().string());
+    const std::vector<char> samples = make_samples(3*4096 + 100);
+
+    uhd::sample_recorder::sptr recorder = uhd::sample_recorder::make(
+        paths, uhd::device_addr_t("buff_size=4096,num_buffs=8")
+    );
+    BOOST_CHECK(recorder->write(&samples.front(), samples.size()));
+    recorder->close();
+
+    uhd::sample_source::sptr source = uhd::sample_source::make(
+        paths, uhd::device_addr_t("buff_size=1000,stripe_size=4096")
+    );
+    BOOST_CHECK(read_all(source, 100000) == samples);
+    source.reset();
+    fs::remove(paths[0]);
+    fs::remove(paths[1]);
+}
@@ -0,0 +1,70 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/types/sensors.hpp>
+
+using namespace uhd;
+
+static const double tolerance = 0.001;
+
+BOOST_AUTO_TEST_CASE(test_sensor_reading_bool){
+    const time_spec_t now(1.5);
+    sensor_reading_t locked("lo_locked", sensor_value_t("LO", true, "locked", "unlocked"), now);
+    BOOST_CHECK(locked.valid);
+    BOOST_CHECK(locked.bool_value);
+    BOOST_CHECK_CLOSE(locked.real_value, 1.0, tolerance);
+    BOOST_CHECK_EQUAL(locked.key, "lo_locked");
+    BOOST_CHECK_EQUAL(locked.value.unit, "locked");
+    BOOST_CHECK_CLOSE(locked.timestamp.get_real_secs(), 1.5, tolerance);
+
+    sensor_reading_t unlocked("lo_locked", sensor_value_t("LO", false, "locked", "unlocked"), now);
+    BOOST_CHECK(unlocked.valid);
+    BOOST_CHECK(not unlocked.bool_value);
+    BOOST_CHECK_CLOSE(unlocked.real_value, 0.0, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(test_sensor_reading_numbers){
+    const time_spec_t now(0.0);
+    sensor_reading_t temp("temp", sensor_value_t("Temp", 42.5, "C"), now);
+    BOOST_CHECK(temp.valid);
+    BOOST_CHECK(temp.bool_value);
+    BOOST_CHECK_CLOSE(temp.real_value, 42.5, tolerance);
+
+    sensor_reading_t count("count", sensor_value_t("Count", signed(-7), "ticks"), now);
+    BOOST_CHECK(count.valid);
+    BOOST_CHECK_CLOSE(count.real_value, -7.0, tolerance);
+
+    //a numeric sensor with a malformed value reads as invalid
+    sensor_value_t bad("RSSI", 1.0, "dB");
+    bad.value = "n/a";
+    sensor_reading_t rssi("rssi", bad, now);
+    BOOST_CHECK(not rssi.valid);
+}
+
+BOOST_AUTO_TEST_CASE(test_sensor_reading_string_and_invalid){
+    const time_spec_t now(0.0);
+    sensor_reading_t gga("gps_gpgga", sensor_value_t("GPGGA", std::string("$GPGGA"), ""), now);
+    BOOST_CHECK(gga.valid);
+    BOOST_CHECK_EQUAL(gga.value.value, "$GPGGA");
+    BOOST_CHECK_CLOSE(gga.real_value, 0.0, tolerance);
+
+    sensor_reading_t missing("ref_locked", now);
+    BOOST_CHECK(not missing.valid);
+    BOOST_CHECK_EQUAL(missing.key, "ref_locked");
+    BOOST_CHECK_EQUAL(missing.value.type, sensor_value_t::STRING);
+}
@@ -0,0 +1,90 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/transport/shared_frame_pool.hpp>
+#include <uhd/exception.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <set>
+
+using namespace uhd::transport;
+
+static const double timeout = 0.01/*secs*/;
+
+BOOST_AUTO_TEST_CASE(test_shared_frame_pool_quota){
+    shared_frame_pool::sptr pool = shared_frame_pool::make(4, 128);
+    BOOST_CHECK_EQUAL(pool->get_num_frames(), 4);
+    BOOST_CHECK_EQUAL(pool->get_frame_size(), 128);
+    shared_frame_pool::client::sptr a = pool->make_client(3);
+    shared_frame_pool::client::sptr b = pool->make_client(3);
+
+    //a client stops at its quota, the pool at its frames
+    std::set<void *> frames;
+    for (size_t i = 0; i < 3; i++) frames.insert(a->alloc(timeout));
+    BOOST_CHECK(a->alloc(timeout) == NULL);
+    BOOST_CHECK_EQUAL(a->get_num_held(), 3);
+    frames.insert(b->alloc(timeout));
+    BOOST_CHECK(b->alloc(timeout) == NULL);
+    BOOST_CHECK_EQUAL(pool->get_num_free(), 0);
+    frames.erase(NULL);
+    BOOST_CHECK_EQUAL(frames.size(), 4);
+
+    //the last freed frame is the next one out
+    void *frame = *frames.begin();
+    a->free(frame);
+    BOOST_CHECK_EQUAL(a->get_num_held(), 2);
+    BOOST_CHECK(b->alloc(0.0) == frame);
+    BOOST_CHECK_EQUAL(b->get_num_held(), 2);
+
+    BOOST_CHECK_THROW(pool->make_client(0), uhd::value_error);
+}
+
+static void free_later(shared_frame_pool::client::sptr client, void *frame){
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    client->free(frame);
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_frame_pool_wait){
+    shared_frame_pool::sptr pool = shared_frame_pool::make(1, 64);
+    shared_frame_pool::client::sptr a = pool->make_client(1);
+    shared_frame_pool::client::sptr b = pool->make_client(1);
+
+    //a client waits for a frame freed by another one
+    void *frame = a->alloc(0.0);
+    BOOST_REQUIRE(frame != NULL);
+    boost::thread t(boost::bind(&free_later, a, frame));
+    BOOST_CHECK(b->alloc(1.0) == frame);
+    t.join();
+    BOOST_CHECK_EQUAL(a->get_num_held(), 0);
+    b->free(frame);
+    BOOST_CHECK_EQUAL(pool->get_num_free(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_frame_pool_get_shared){
+    shared_frame_pool::sptr pool = shared_frame_pool::get_shared(8, 256);
+    BOOST_CHECK(shared_frame_pool::get_shared(16, 256) == pool);
+    BOOST_CHECK_EQUAL(shared_frame_pool::get_shared(16, 256)->get_num_frames(), 8);
+    BOOST_CHECK(shared_frame_pool::get_shared(8, 512) != pool);
+
+    //a pool nobody uses anymore is made again
+    shared_frame_pool::client::sptr client = pool->make_client(2);
+    pool.reset();
+    BOOST_CHECK_EQUAL(shared_frame_pool::get_shared(16, 256)->get_num_frames(), 8);
+    client.reset();
+    BOOST_CHECK_EQUAL(shared_frame_pool::get_shared(16, 256)->get_num_frames(), 16);
+}
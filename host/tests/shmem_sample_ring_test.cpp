@@ -0,0 +1,178 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/transport/shmem_sample_ring.hpp>
+#include <uhd/exception.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+
+using namespace uhd::transport;
+
+static const double SAMP_RATE = 1e6;
+static const size_t BLOCK_SIZE = 100;
+
+/***********************************************************************
+ * A dummy rx streamer: each sample holds its index in the stream,
+ * the test releases the samples with set_limit()
+ **********************************************************************/
+class dummy_rx_streamer : public uhd::rx_streamer{
+public:
+    typedef boost::shared_ptr<dummy_rx_streamer> sptr;
+
+    dummy_rx_streamer(void):
+        _limit(0), _num_samps(0)
+    {
+        /* NOP */
+    }
+
+    size_t get_num_channels(void) const{
+        return 2;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return BLOCK_SIZE;
+    }
+
+    size_t recv(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout = 0.1,
+        const bool = false
+    ){
+        metadata.reset();
+        const size_t limit = _limit.load();
+        if (_num_samps >= limit){
+            boost::this_thread::sleep(boost::posix_time::milliseconds(long(timeout*1e3)));
+            metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_TIMEOUT;
+            return 0;
+        }
+        const size_t nsamps = std::min(nsamps_per_buff, limit - _num_samps);
+        for (size_t ch = 0; ch < buffs.size(); ch++){
+            uint32_t *samps = reinterpret_cast<uint32_t *>(buffs[ch]);
+            for (size_t i = 0; i < nsamps; i++) samps[i] = uint32_t((_num_samps + i) | (ch << 24));
+        }
+        metadata.has_time_spec = true;
+        metadata.time_spec = uhd::time_spec_t::from_ticks(_num_samps, SAMP_RATE);
+        metadata.start_of_burst = _num_samps == 0;
+        _num_samps += nsamps;
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const uhd::stream_cmd_t &){
+        /* NOP */
+    }
+
+    void set_limit(const size_t limit){
+        _limit.store(limit);
+    }
+
+private:
+    boost::atomic<size_t> _limit;
+    size_t _num_samps;
+};
+
+static void wait_for_blocks(shmem_sample_publisher::sptr pub, const uint64_t num_blocks){
+    for (size_t i = 0; i < 500 and pub->get_num_blocks() < num_blocks; i++){
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+    BOOST_REQUIRE_EQUAL(pub->get_num_blocks(), num_blocks);
+}
+
+BOOST_AUTO_TEST_CASE(test_shmem_sample_ring_blocks){
+    dummy_rx_streamer::sptr rx_stream(new dummy_rx_streamer());
+    shmem_sample_publisher::sptr pub = shmem_sample_publisher::make(
+        rx_stream, uhd::stream_args_t("sc16"), uhd::device_addr_t("name=uhd_shmem_ring_test0,num_blocks=16")
+    );
+    shmem_sample_subscriber::sptr sub = shmem_sample_subscriber::make("uhd_shmem_ring_test0");
+    BOOST_CHECK_EQUAL(sub->get_num_channels(), 2U);
+    BOOST_CHECK_EQUAL(sub->get_cpu_format(), "sc16");
+    BOOST_CHECK_EQUAL(sub->get_block_size(), BLOCK_SIZE);
+    BOOST_CHECK_EQUAL(sub->get_num_blocks(), 16U);
+
+    rx_stream->set_limit(10*BLOCK_SIZE);
+    shmem_sample_subscriber::block_t block;
+    for (size_t n = 0; n < 10; n++){
+        BOOST_REQUIRE(sub->get_block(block, 1.0));
+        BOOST_CHECK_EQUAL(block.index, n);
+        BOOST_CHECK_EQUAL(block.nsamps, BLOCK_SIZE);
+        BOOST_CHECK_EQUAL(block.metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK(block.metadata.has_time_spec);
+        BOOST_CHECK_EQUAL(block.metadata.start_of_burst, n == 0);
+        BOOST_CHECK_EQUAL(block.metadata.time_spec.to_ticks(SAMP_RATE), long(n*BLOCK_SIZE));
+        BOOST_REQUIRE_EQUAL(block.buffs.size(), 2U);
+        for (size_t ch = 0; ch < 2; ch++){
+            const uint32_t *samps = reinterpret_cast<const uint32_t *>(block.buffs[ch]);
+            BOOST_CHECK_EQUAL(samps[0], (n*BLOCK_SIZE) | (ch << 24));
+            BOOST_CHECK_EQUAL(samps[BLOCK_SIZE-1], (n*BLOCK_SIZE + BLOCK_SIZE-1) | (ch << 24));
+        }
+        BOOST_CHECK(sub->is_valid(block));
+    }
+    BOOST_CHECK(not sub->get_block(block, 0.01));
+    BOOST_CHECK_EQUAL(sub->get_num_overflows(), 0U);
+
+    //a second subscriber starts at the newest block
+    shmem_sample_subscriber::sptr late_sub = shmem_sample_subscriber::make("uhd_shmem_ring_test0");
+    BOOST_CHECK(not late_sub->get_block(block, 0.01));
+
+    BOOST_CHECK(not sub->is_closed());
+    pub.reset();
+    BOOST_CHECK(sub->is_closed());
+    BOOST_CHECK(not sub->get_block(block, 1.0));
+}
+
+BOOST_AUTO_TEST_CASE(test_shmem_sample_ring_overflow){
+    dummy_rx_streamer::sptr rx_stream(new dummy_rx_streamer());
+    shmem_sample_publisher::sptr pub = shmem_sample_publisher::make(
+        rx_stream, uhd::stream_args_t("sc16"), uhd::device_addr_t("name=uhd_shmem_ring_test1,num_blocks=4")
+    );
+    shmem_sample_subscriber::sptr sub = shmem_sample_subscriber::make("uhd_shmem_ring_test1");
+
+    //the publisher laps the subscriber
+    rx_stream->set_limit(10*BLOCK_SIZE);
+    wait_for_blocks(pub, 10);
+    shmem_sample_subscriber::block_t block;
+    BOOST_REQUIRE(sub->get_block(block, 1.0));
+    BOOST_CHECK_EQUAL(block.nsamps, 0U);
+    BOOST_CHECK_EQUAL(block.metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK_EQUAL(sub->get_num_overflows(), 1U);
+    BOOST_CHECK_EQUAL(sub->get_num_dropped_blocks(), 10U);
+
+    //the cursor continues at the newest block
+    rx_stream->set_limit(11*BLOCK_SIZE);
+    BOOST_REQUIRE(sub->get_block(block, 1.0));
+    BOOST_CHECK_EQUAL(block.index, 10U);
+    BOOST_CHECK_EQUAL(reinterpret_cast<const uint32_t *>(block.buffs[0])[0], 10*BLOCK_SIZE);
+
+    //a block overwritten while it is held is no longer valid
+    BOOST_CHECK(sub->is_valid(block));
+    rx_stream->set_limit(15*BLOCK_SIZE);
+    wait_for_blocks(pub, 15);
+    BOOST_CHECK(not sub->is_valid(block));
+}
+
+BOOST_AUTO_TEST_CASE(test_shmem_sample_ring_bad_args){
+    uhd::rx_streamer::sptr rx_stream(new dummy_rx_streamer());
+    BOOST_CHECK_THROW(shmem_sample_publisher::make(
+        rx_stream, uhd::stream_args_t("sc16"), uhd::device_addr_t("")
+    ), uhd::value_error);
+    BOOST_CHECK_THROW(shmem_sample_publisher::make(
+        rx_stream, uhd::stream_args_t("sc16"), uhd::device_addr_t("name=uhd_shmem_ring_test2,num_blocks=1")
+    ), uhd::value_error);
+    BOOST_CHECK_THROW(shmem_sample_subscriber::make("uhd_shmem_ring_test_missing"), uhd::io_error);
+}
@@ -0,0 +1,168 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/utils/soft_register.hpp>
+#include <uhd/exception.hpp>
+#include <vector>
+
+using namespace uhd;
+
+/***********************************************************************
+ * A bus which records the writes and the batches
+ **********************************************************************/
+class recording_iface : public timed_wb_iface{
+public:
+    recording_iface(void): num_batches(0), num_pokes(0) {}
+
+    void poke32(const wb_addr_type addr, const uint32_t data){
+        num_pokes++;
+        writes.push_back(transaction_t(transaction_t::POKE32, addr, data));
+        times.push_back(_time);
+    }
+
+    void reset(void){
+        writes.clear();
+        times.clear();
+        num_batches = 0;
+        num_pokes = 0;
+    }
+
+    void poke16(const wb_addr_type addr, const uint16_t data){
+        writes.push_back(transaction_t(transaction_t::POKE32, addr, data));
+        times.push_back(_time);
+    }
+
+    void transact(transactions_type &transactions){
+        num_batches++;
+        for (size_t i = 0; i < transactions.size(); i++){
+            writes.push_back(transactions[i]);
+            times.push_back(_time);
+        }
+    }
+
+    time_spec_t get_time(void){ return _time; }
+    void set_time(const time_spec_t &t){ _time = t; }
+
+    transactions_type writes;
+    std::vector<time_spec_t> times;
+    size_t num_batches;
+    size_t num_pokes;
+
+private:
+    time_spec_t _time;
+};
+
+class test_regmap_t : public soft_regmap_t{
+public:
+    class reg_t : public soft_reg32_wo_t{
+    public:
+        UHD_DEFINE_SOFT_REG_FIELD(VALUE, /*width*/ 32, /*shift*/ 0);
+        reg_t(const wb_iface::wb_addr_type addr): soft_reg32_wo_t(addr, OPTIMIZED_FLUSH) {}
+    };
+
+    class reg16_t : public soft_reg16_wo_t{
+    public:
+        UHD_DEFINE_SOFT_REG_FIELD(VALUE, /*width*/ 16, /*shift*/ 0);
+        reg16_t(const wb_iface::wb_addr_type addr): soft_reg16_wo_t(addr, OPTIMIZED_FLUSH) {}
+    };
+
+    test_regmap_t(void): soft_regmap_t("test_regmap"), reg0(0x10), reg1(0x14), reg16(0x18), reg2(0x1c){
+        add_to_map(reg0, "reg0", PUBLIC);
+        add_to_map(reg1, "reg1", PUBLIC);
+        add_to_map(reg16, "reg16", PUBLIC);
+        add_to_map(reg2, "reg2", PUBLIC);
+    }
+
+    reg_t reg0, reg1;
+    reg16_t reg16;
+    reg_t reg2;
+};
+
+/***********************************************************************
+ * Test cases
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_soft_regmap_flush_all){
+    recording_iface iface;
+    test_regmap_t regmap;
+    regmap.initialize(iface);
+
+    //the registers start dirty
+    regmap.flush_all();
+    BOOST_CHECK_EQUAL(iface.writes.size(), 4);
+    iface.reset();
+
+    regmap.reg0.set(test_regmap_t::reg_t::VALUE, 1);
+    regmap.reg2.set(test_regmap_t::reg_t::VALUE, 2);
+    regmap.flush_all();
+    //the 16-bit register is flushed on its own between two batches
+    BOOST_CHECK_EQUAL(iface.num_batches, 2);
+    BOOST_CHECK_EQUAL(iface.num_pokes, 0);
+    BOOST_REQUIRE_EQUAL(iface.writes.size(), 2);
+    BOOST_CHECK_EQUAL(iface.writes[0].addr, 0x10);
+    BOOST_CHECK_EQUAL(iface.writes[0].data, 1);
+    BOOST_CHECK_EQUAL(iface.writes[1].addr, 0x1c);
+    BOOST_CHECK_EQUAL(iface.writes[1].data, 2);
+
+    //clean registers are not written again
+    regmap.flush_all();
+    BOOST_CHECK_EQUAL(iface.writes.size(), 2);
+
+    //an unbatched register splits the batch and keeps the order
+    iface.reset();
+    regmap.reg0.set(test_regmap_t::reg_t::VALUE, 3);
+    regmap.reg16.set(test_regmap_t::reg16_t::VALUE, 4);
+    regmap.reg2.set(test_regmap_t::reg_t::VALUE, 5);
+    regmap.flush_all();
+    BOOST_CHECK_EQUAL(iface.num_batches, 2);
+    BOOST_REQUIRE_EQUAL(iface.writes.size(), 3);
+    BOOST_CHECK_EQUAL(iface.writes[0].addr, 0x10);
+    BOOST_CHECK_EQUAL(iface.writes[1].addr, 0x18);
+    BOOST_CHECK_EQUAL(iface.writes[2].addr, 0x1c);
+}
+
+BOOST_AUTO_TEST_CASE(test_soft_regmap_flush_all_timed){
+    recording_iface iface;
+    test_regmap_t regmap;
+    BOOST_CHECK_THROW(regmap.flush_all(), uhd::not_implemented_error);
+    regmap.initialize(iface);
+    regmap.flush_all();
+    iface.reset();
+
+    iface.set_time(time_spec_t(1.0));
+    regmap.reg1.set(test_regmap_t::reg_t::VALUE, 7);
+    regmap.flush_all(time_spec_t(2.5));
+    BOOST_REQUIRE_EQUAL(iface.writes.size(), 1);
+    BOOST_CHECK_EQUAL(iface.times[0].get_real_secs(), 2.5);
+    BOOST_CHECK_EQUAL(iface.get_time().get_real_secs(), 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_soft_reg_handle){
+    recording_iface iface;
+    test_regmap_t regmap;
+    regmap.initialize(iface);
+
+    soft_reg_handle_t<test_regmap_t::reg_t> reg(regmap, "reg1");
+    BOOST_CHECK_EQUAL(&(*reg), &regmap.reg1);
+    reg->write(test_regmap_t::reg_t::VALUE, 9);
+    BOOST_REQUIRE_EQUAL(iface.writes.size(), 1);
+    BOOST_CHECK_EQUAL(iface.writes[0].addr, 0x14);
+    BOOST_CHECK_EQUAL(iface.writes[0].data, 9);
+
+    BOOST_CHECK_THROW(soft_reg_handle_t<test_regmap_t::reg_t>(regmap, "reg16"), uhd::type_error);
+    BOOST_CHECK_THROW(soft_reg_handle_t<test_regmap_t::reg_t>(regmap, "nope"), uhd::runtime_error);
+}
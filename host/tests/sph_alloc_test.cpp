@@ -0,0 +1,302 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "../lib/transport/super_recv_packet_handler.hpp"
+#include "../lib/transport/super_send_packet_handler.hpp"
+#include <uhd/transport/chdr.hpp>
+#include <boost/bind.hpp>
+#include <complex>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+/***********************************************************************
+ * Count the allocations of the whole program while armed
+ **********************************************************************/
+static bool alloc_count_armed = false;
+static size_t alloc_count = 0;
+
+static void *counted_malloc(std::size_t size){
+    if (alloc_count_armed) alloc_count++;
+    return std::malloc(size? size : 1);
+}
+
+void *operator new(std::size_t size){
+    void *p = counted_malloc(size);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](std::size_t size){
+    void *p = counted_malloc(size);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) throw(){
+    return counted_malloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) throw(){
+    return counted_malloc(size);
+}
+
+void operator delete(void *p) throw(){
+    std::free(p);
+}
+
+void operator delete[](void *p) throw(){
+    std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) throw(){
+    std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) throw(){
+    std::free(p);
+}
+
+//! Counts the allocations in its scope
+struct alloc_counter{
+    alloc_counter(void){
+        alloc_count = 0;
+        alloc_count_armed = true;
+    }
+    ~alloc_counter(void){
+        alloc_count_armed = false;
+    }
+    size_t count(void) const{
+        return alloc_count;
+    }
+};
+
+static const double TICK_RATE = 100e6;
+static const double SAMP_RATE = 10e6;
+static const size_t SPP = 100;
+static const size_t NUM_FRAMES = 16;
+static const size_t FRAME_SIZE = 1024;
+
+/***********************************************************************
+ * A mock managed buffer, owned by its transport and never freed
+ **********************************************************************/
+template <typename base_type> class mock_mb : public base_type{
+public:
+    mock_mb(void): num_releases(0) {}
+
+    void release(void){
+        num_releases++;
+    }
+
+    typename base_type::sptr get(void *mem, const size_t len){
+        return this->make(this, mem, len);
+    }
+
+    size_t num_releases;
+};
+
+/***********************************************************************
+ * A mock receive transport: an endless CHDR stream out of a ring of
+ * frames, with a timeout every TIMEOUT_PERIOD calls
+ **********************************************************************/
+class mock_recv_xport{
+public:
+    static const size_t TIMEOUT_PERIOD = 25;
+
+    mock_recv_xport(void):
+        _mems(NUM_FRAMES, std::vector<uint32_t>(FRAME_SIZE/sizeof(uint32_t))),
+        _mbs(NUM_FRAMES),
+        _index(0),
+        _num_calls(0),
+        _packet_count(0),
+        _tsf(0)
+    {
+        /* NOP */
+    }
+
+    uhd::transport::managed_recv_buffer::sptr get_recv_buff(double){
+        if (++_num_calls % TIMEOUT_PERIOD == 0) return uhd::transport::managed_recv_buffer::sptr();
+
+        uhd::transport::vrt::if_packet_info_t ifpi;
+        ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+        ifpi.num_payload_words32 = SPP;
+        ifpi.num_payload_bytes = SPP*sizeof(uint32_t);
+        ifpi.packet_count = _packet_count++ & 0xfff;
+        ifpi.sob = false;
+        ifpi.eob = false;
+        ifpi.has_sid = true;
+        ifpi.sid = 0;
+        ifpi.has_cid = false;
+        ifpi.has_tsi = false;
+        ifpi.has_tsf = true;
+        ifpi.tsf = _tsf;
+        ifpi.has_tlr = false;
+        _tsf += SPP*size_t(TICK_RATE/SAMP_RATE);
+
+        uint32_t *mem = &_mems[_index].front();
+        uhd::transport::vrt::chdr::if_hdr_pack_be(mem, ifpi);
+        uhd::transport::managed_recv_buffer::sptr buff = _mbs[_index].get(mem, ifpi.num_packet_words32*sizeof(uint32_t));
+        _index = (_index + 1) % NUM_FRAMES;
+        return buff;
+    }
+
+private:
+    std::vector<std::vector<uint32_t> > _mems;
+    std::vector<mock_mb<uhd::transport::managed_recv_buffer> > _mbs;
+    size_t _index;
+    size_t _num_calls;
+    size_t _packet_count;
+    uint64_t _tsf;
+};
+
+/***********************************************************************
+ * A mock send transport out of a ring of frames, with async messages
+ **********************************************************************/
+class mock_send_xport{
+public:
+    mock_send_xport(void):
+        _mems(NUM_FRAMES, std::vector<uint32_t>(FRAME_SIZE/sizeof(uint32_t))),
+        _mbs(NUM_FRAMES),
+        _index(0),
+        num_msgs(0)
+    {
+        /* NOP */
+    }
+
+    uhd::transport::managed_send_buffer::sptr get_send_buff(double){
+        uhd::transport::managed_send_buffer::sptr buff = _mbs[_index].get(&_mems[_index].front(), FRAME_SIZE);
+        _index = (_index + 1) % NUM_FRAMES;
+        return buff;
+    }
+
+    bool recv_async_msg(uhd::async_metadata_t &metadata, const double){
+        metadata.channel = 0;
+        metadata.has_time_spec = false;
+        metadata.event_code = uhd::async_metadata_t::EVENT_CODE_BURST_ACK;
+        return (num_msgs++ % 2) == 0;
+    }
+
+    size_t get_num_packets(void) const{
+        size_t num_packets = 0;
+        for (size_t i = 0; i < _mbs.size(); i++) num_packets += _mbs[i].num_releases;
+        return num_packets;
+    }
+
+private:
+    std::vector<std::vector<uint32_t> > _mems;
+    std::vector<mock_mb<uhd::transport::managed_send_buffer> > _mbs;
+    size_t _index;
+
+public:
+    size_t num_msgs;
+};
+
+struct flowctrl_counter{
+    flowctrl_counter(void): num_acks(0) {}
+    void handle(const size_t){
+        num_acks++;
+    }
+    size_t num_acks;
+};
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_no_alloc){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    mock_recv_xport xport;
+    flowctrl_counter flowctrl;
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_chdr_unpacker(uhd::ENDIANNESS_BIG);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&mock_recv_xport::get_recv_buff, &xport, _1));
+    handler.set_xport_handle_flowctrl(0, boost::bind(&flowctrl_counter::handle, &flowctrl, _1), 8);
+    handler.set_converter(id);
+
+    std::vector<std::complex<float> > buff(SPP*3 + SPP/2);
+    uhd::rx_metadata_t metadata;
+    size_t num_samps = 0, num_timeouts = 0;
+    for (size_t i = 0; i < 100; i++){
+        num_samps += handler.recv(&buff.front(), buff.size(), metadata, 0.0, false);
+    }
+
+    //the steady state: full buffers, fragments, timeouts and flow control
+    {
+        alloc_counter counter;
+        for (size_t i = 0; i < 1000; i++){
+            num_samps += handler.recv(&buff.front(), buff.size(), metadata, 0.0, i%2 == 0);
+            if (metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_TIMEOUT) num_timeouts++;
+        }
+        BOOST_CHECK_EQUAL(counter.count(), 0U);
+    }
+    BOOST_CHECK(num_samps > 0);
+    BOOST_CHECK(num_timeouts > 0);
+    BOOST_CHECK(flowctrl.num_acks > 0);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_no_alloc){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs = 1;
+
+    mock_send_xport xport;
+    uhd::transport::sph::send_packet_handler handler(1);
+    handler.set_chdr_packer(uhd::ENDIANNESS_BIG);
+    handler.set_xport_chan_sid(0, true, 0);
+    handler.set_enable_trailer(false);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&mock_send_xport::get_send_buff, &xport, _1));
+    handler.set_async_receiver(boost::bind(&mock_send_xport::recv_async_msg, &xport, _1, _2));
+    handler.set_converter(id);
+    handler.set_max_samples_per_packet(SPP);
+
+    std::vector<std::complex<float> > buff(SPP*3 + SPP/2);
+    uhd::tx_metadata_t metadata;
+    uhd::async_metadata_t async_metadata;
+    size_t num_samps = 0, num_msgs = 0;
+    for (size_t i = 0; i < 100; i++){
+        num_samps += handler.send(&buff.front(), buff.size(), metadata, 0.1);
+    }
+
+    //the steady state: bursts of several packets and async messages
+    {
+        alloc_counter counter;
+        for (size_t i = 0; i < 1000; i++){
+            metadata.start_of_burst = (i%10 == 0);
+            metadata.end_of_burst = (i%10 == 9);
+            metadata.has_time_spec = metadata.start_of_burst;
+            metadata.time_spec = uhd::time_spec_t(double(i));
+            num_samps += handler.send(&buff.front(), buff.size(), metadata, 0.1);
+            if (handler.recv_async_msg(async_metadata, 0.0)) num_msgs++;
+        }
+        BOOST_CHECK_EQUAL(counter.count(), 0U);
+    }
+    BOOST_CHECK_EQUAL(num_samps, 1100*buff.size());
+    BOOST_CHECK_EQUAL(xport.get_num_packets(), 1100*4U);
+    BOOST_CHECK_EQUAL(num_msgs, 500U);
+}
@@ -0,0 +1,317 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// Measures the super packet handlers without hardware: the receive side
+// replays a ring of prepared packets and the send side writes into fixed
+// buffers, so the numbers are the cost of the handlers and converters.
+
+#include "../lib/transport/super_recv_packet_handler.hpp"
+#include "../lib/transport/super_send_packet_handler.hpp"
+#include <uhd/utils/safe_main.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/convert.hpp>
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_array.hpp>
+#include <iostream>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace uhd::transport;
+
+static const double TICK_RATE = 100e6;
+static const double SAMP_RATE = 10e6;
+
+//! The number of packets in the replay ring, a multiple of the VRT sequence range
+static const size_t NUM_RING_PKTS = 64;
+
+/***********************************************************************
+ * A managed buffer over memory owned by the mock transport
+ **********************************************************************/
+class bench_mrb : public managed_recv_buffer{
+public:
+    void release(void){
+        //NOP
+    }
+
+    sptr get_new(char *mem, const size_t len){
+        return make(this, mem, len);
+    }
+};
+
+class bench_msb : public managed_send_buffer{
+public:
+    void release(void){
+        //NOP
+    }
+
+    sptr get_new(char *mem, const size_t len){
+        return make(this, mem, len);
+    }
+};
+
+/***********************************************************************
+ * A transport that replays a ring of prepared data packets.
+ * Only the timestamp is rewritten per packet, so the timestamps keep
+ * increasing when the ring wraps around.
+ **********************************************************************/
+class replay_recv_xport{
+public:
+    replay_recv_xport(const bool big_endian, const size_t spp, const size_t bytes_per_item):
+        _big_endian(big_endian), _index(0), _tsf(0),
+        _ticks_per_pkt(uint64_t(spp*(TICK_RATE/SAMP_RATE)))
+    {
+        vrt::if_packet_info_t ifpi;
+        ifpi.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+        ifpi.num_payload_words32 = (spp*bytes_per_item + 3)/4;
+        ifpi.sob = false;
+        ifpi.eob = false;
+        ifpi.has_sid = false;
+        ifpi.has_cid = false;
+        ifpi.has_tsi = false;
+        ifpi.has_tsf = true;
+        ifpi.tsf = 0;
+        ifpi.has_tlr = false;
+        _pkt_len = (ifpi.num_payload_words32 + vrt::max_if_hdr_words32)*sizeof(uint32_t);
+        _mem = boost::shared_array<char>(new char[_pkt_len*NUM_RING_PKTS]());
+        for (size_t i = 0; i < NUM_RING_PKTS; i++){
+            ifpi.packet_count = i;
+            uint32_t *pkt = reinterpret_cast<uint32_t *>(_mem.get() + i*_pkt_len);
+            if (big_endian) vrt::if_hdr_pack_be(pkt, ifpi);
+            else vrt::if_hdr_pack_le(pkt, ifpi);
+            _lens.push_back(ifpi.num_packet_words32*sizeof(uint32_t));
+            _mrbs.push_back(boost::shared_ptr<bench_mrb>(new bench_mrb()));
+        }
+    }
+
+    managed_recv_buffer::sptr get_recv_buff(double){
+        uint32_t *pkt = reinterpret_cast<uint32_t *>(_mem.get() + _index*_pkt_len);
+        //the TSF follows the header word, there is no SID, CID or TSI
+        pkt[1] = _big_endian? uhd::htonx(uint32_t(_tsf >> 32)) : uhd::htowx(uint32_t(_tsf >> 32));
+        pkt[2] = _big_endian? uhd::htonx(uint32_t(_tsf >> 0)) : uhd::htowx(uint32_t(_tsf >> 0));
+        _tsf += _ticks_per_pkt;
+        managed_recv_buffer::sptr mrb = _mrbs[_index]->get_new(reinterpret_cast<char *>(pkt), _lens[_index]);
+        _index = (_index + 1) % NUM_RING_PKTS;
+        return mrb;
+    }
+
+private:
+    const bool _big_endian;
+    size_t _index;
+    uint64_t _tsf;
+    const uint64_t _ticks_per_pkt;
+    size_t _pkt_len;
+    boost::shared_array<char> _mem;
+    std::vector<size_t> _lens;
+    std::vector<boost::shared_ptr<bench_mrb> > _mrbs;
+};
+
+/***********************************************************************
+ * A transport that discards the packets written into it
+ **********************************************************************/
+class discard_send_xport{
+public:
+    discard_send_xport(const size_t frame_size):
+        _frame_size(frame_size), _mem(new char[frame_size]())
+    {
+        /* NOP */
+    }
+
+    managed_send_buffer::sptr get_send_buff(double){
+        return _msb.get_new(_mem.get(), _frame_size);
+    }
+
+private:
+    const size_t _frame_size;
+    boost::shared_array<char> _mem;
+    bench_msb _msb;
+};
+
+/***********************************************************************
+ * Benchmark cases
+ **********************************************************************/
+struct bench_result_t{
+    double samps_per_sec;
+    double ns_per_pkt;
+};
+
+static uhd::convert::id_type make_id(
+    const std::string &input_format, const std::string &output_format
+){
+    uhd::convert::id_type id;
+    id.input_format = input_format;
+    id.num_inputs = 1;
+    id.output_format = output_format;
+    id.num_outputs = 1;
+    return id;
+}
+
+static bench_result_t bench_recv(
+    const size_t num_chans, const size_t spp,
+    const std::string &otw, const std::string &cpu, const double duration
+){
+    const bool big_endian = boost::ends_with(otw, "_be");
+    const size_t bpi = uhd::convert::get_bytes_per_item(otw);
+
+    std::vector<boost::shared_ptr<replay_recv_xport> > xports;
+    sph::recv_packet_handler handler(num_chans);
+    handler.set_vrt_unpacker(big_endian? &vrt::if_hdr_unpack_be : &vrt::if_hdr_unpack_le);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < num_chans; ch++){
+        xports.push_back(boost::shared_ptr<replay_recv_xport>(new replay_recv_xport(big_endian, spp, bpi)));
+        handler.set_xport_chan_get_buff(ch, boost::bind(&replay_recv_xport::get_recv_buff, xports.back(), _1));
+    }
+    handler.set_converter(make_id(otw, cpu));
+
+    std::vector<std::vector<char> > buffs(num_chans, std::vector<char>(spp*uhd::convert::get_bytes_per_item(cpu)));
+    std::vector<void *> buff_ptrs;
+    for (size_t ch = 0; ch < num_chans; ch++) buff_ptrs.push_back(&buffs[ch].front());
+
+    uhd::rx_metadata_t md;
+    size_t num_pkts = 0, num_samps = 0;
+    const uhd::time_spec_t start = uhd::time_spec_t::get_system_time();
+    uhd::time_spec_t elapsed;
+    do{
+        //check the time once per batch of packets to keep the clock out of the numbers
+        for (size_t i = 0; i < 100; i++){
+            num_samps += handler.recv(buff_ptrs, spp, md, 1.0, true);
+        }
+        num_pkts += 100;
+        elapsed = uhd::time_spec_t::get_system_time() - start;
+    } while (elapsed.get_real_secs() < duration);
+
+    if (md.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE){
+        throw uhd::runtime_error("recv benchmark: " + md.strerror());
+    }
+    bench_result_t result;
+    result.samps_per_sec = num_samps*num_chans/elapsed.get_real_secs();
+    result.ns_per_pkt = elapsed.get_real_secs()*1e9/(num_pkts*num_chans);
+    return result;
+}
+
+static bench_result_t bench_send(
+    const size_t num_chans, const size_t spp,
+    const std::string &otw, const std::string &cpu, const double duration
+){
+    const bool big_endian = boost::ends_with(otw, "_be");
+    const size_t bpi = uhd::convert::get_bytes_per_item(otw);
+    const size_t frame_size = spp*bpi + (vrt::max_if_hdr_words32 + 1)*sizeof(uint32_t);
+
+    std::vector<boost::shared_ptr<discard_send_xport> > xports;
+    sph::send_packet_handler handler(num_chans);
+    handler.set_vrt_packer(big_endian? &vrt::if_hdr_pack_be : &vrt::if_hdr_pack_le);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < num_chans; ch++){
+        xports.push_back(boost::shared_ptr<discard_send_xport>(new discard_send_xport(frame_size)));
+        handler.set_xport_chan_get_buff(ch, boost::bind(&discard_send_xport::get_send_buff, xports.back(), _1));
+    }
+    handler.set_converter(make_id(cpu, otw));
+    handler.set_max_samples_per_packet(spp);
+
+    std::vector<std::vector<char> > buffs(num_chans, std::vector<char>(spp*uhd::convert::get_bytes_per_item(cpu)));
+    std::vector<const void *> buff_ptrs;
+    for (size_t ch = 0; ch < num_chans; ch++) buff_ptrs.push_back(&buffs[ch].front());
+
+    uhd::tx_metadata_t md;
+    size_t num_pkts = 0, num_samps = 0;
+    const uhd::time_spec_t start = uhd::time_spec_t::get_system_time();
+    uhd::time_spec_t elapsed;
+    do{
+        for (size_t i = 0; i < 100; i++){
+            num_samps += handler.send(buff_ptrs, spp, md, 1.0);
+        }
+        num_pkts += 100;
+        elapsed = uhd::time_spec_t::get_system_time() - start;
+    } while (elapsed.get_real_secs() < duration);
+
+    bench_result_t result;
+    result.samps_per_sec = num_samps*num_chans/elapsed.get_real_secs();
+    result.ns_per_pkt = elapsed.get_real_secs()*1e9/(num_pkts*num_chans);
+    return result;
+}
+
+/***********************************************************************
+ * Main
+ **********************************************************************/
+template <typename T>
+static std::vector<T> parse_list(const std::string &list){
+    std::vector<std::string> strings;
+    std::vector<T> values;
+    boost::split(strings, list, boost::is_any_of(","));
+    BOOST_FOREACH(const std::string &str, strings){
+        if (not str.empty()) values.push_back(boost::lexical_cast<T>(str));
+    }
+    return values;
+}
+
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    std::string directions, channels, spps, otws, cpus;
+    double duration;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("direction", po::value<std::string>(&directions)->default_value("recv,send"), "recv, send or both")
+        ("channels", po::value<std::string>(&channels)->default_value("1,2,4"), "the channel counts to measure")
+        ("spp", po::value<std::string>(&spps)->default_value("364,2000"), "the samples per packet to measure")
+        ("otw", po::value<std::string>(&otws)->default_value("sc16_item32_be,sc16_item32_le,sc8_item32_be"), "the wire formats to measure")
+        ("cpu", po::value<std::string>(&cpus)->default_value("fc32,sc16"), "the host formats to measure")
+        ("duration", po::value<double>(&duration)->default_value(0.25), "the duration of each case in seconds")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")){
+        std::cout << boost::format("UHD Super Packet Handler Benchmark %s") % desc << std::endl;
+        std::cout <<
+        "    Measures the receive and send packet handlers with mock transports.\n"
+        "    The output has one CSV line per case. To see how the time alignment\n"
+        "    scales with the channels: --direction recv --channels 1,4,16,32,64,128 --spp 16\n"
+        << std::endl;
+        return ~0;
+    }
+
+    std::cout << "direction,channels,spp,otw,cpu,msps,ns_per_pkt" << std::endl;
+    BOOST_FOREACH(const std::string &direction, parse_list<std::string>(directions)){
+    BOOST_FOREACH(const size_t num_chans, parse_list<size_t>(channels)){
+    BOOST_FOREACH(const size_t spp, parse_list<size_t>(spps)){
+    BOOST_FOREACH(const std::string &otw, parse_list<std::string>(otws)){
+    BOOST_FOREACH(const std::string &cpu, parse_list<std::string>(cpus)){
+        bench_result_t result;
+        try{
+            result = (direction == "send")?
+                bench_send(num_chans, spp, otw, cpu, duration) :
+                bench_recv(num_chans, spp, otw, cpu, duration);
+        }
+        catch(const uhd::key_error &){
+            //no converter between these formats
+            continue;
+        }
+        std::cout << boost::format("%s,%u,%u,%s,%s,%.3f,%.1f")
+            % direction % num_chans % spp % otw % cpu
+            % (result.samps_per_sec/1e6) % result.ns_per_pkt << std::endl;
+    }}}}}
+
+    return EXIT_SUCCESS;
+}
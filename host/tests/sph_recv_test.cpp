@@ -17,8 +17,11 @@
 
 #include <boost/test/unit_test.hpp>
 #include "../lib/transport/super_recv_packet_handler.hpp"
+#include <uhd/transport/zero_copy_capture.hpp>
+#include <uhd/utils/byteswap.hpp>
 #include <boost/shared_array.hpp>
 #include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
 #include <complex>
 #include <vector>
 #include <list>
@@ -62,7 +65,7 @@ private:
  **********************************************************************/
 class dummy_recv_xport_class{
 public:
-    dummy_recv_xport_class(const std::string &end) : io_status(true) {
+    dummy_recv_xport_class(const std::string &end) : num_batch_calls(0), io_status(true) {
         _end = end;
     }
 
@@ -96,6 +99,15 @@ public:
         return mrb;
     }
 
+    size_t get_recv_buffs(uhd::transport::managed_recv_buffer::sptr *buffs, const size_t num_buffs, double timeout){
+        num_batch_calls++;
+        size_t num_got = 0;
+        while (num_got < num_buffs and (buffs[num_got] = get_recv_buff(timeout))) num_got++;
+        return num_got;
+    }
+
+    size_t num_batch_calls;
+
 private:
     std::list<boost::shared_array<char> > _mems;
     std::list<size_t> _lens;
@@ -104,6 +116,44 @@ private:
     bool io_status;
 };
 
+/***********************************************************************
+ * The dummy transport behind a zero copy interface, for capturing
+ **********************************************************************/
+class dummy_zero_copy_xport : public uhd::transport::zero_copy_if{
+public:
+    dummy_zero_copy_xport(dummy_recv_xport_class &xport) : _xport(xport) {}
+
+    uhd::transport::managed_recv_buffer::sptr get_recv_buff(double timeout){
+        return _xport.get_recv_buff(timeout);
+    }
+    size_t get_num_recv_frames(void) const { return 1; }
+    size_t get_recv_frame_size(void) const { return 1500; }
+
+    uhd::transport::managed_send_buffer::sptr get_send_buff(double){
+        return uhd::transport::managed_send_buffer::sptr();
+    }
+    size_t get_num_send_frames(void) const { return 1; }
+    size_t get_send_frame_size(void) const { return 1500; }
+
+private:
+    dummy_recv_xport_class &_xport;
+};
+
+/***********************************************************************
+ * A flow control that remembers the acknowledged packets
+ **********************************************************************/
+class dummy_recv_flowctrl : public uhd::transport::sph::recv_flowctrl_if{
+public:
+    dummy_recv_flowctrl(void) : num_calls(0), last_seq(0) {}
+
+    void handle_flowctrl(const size_t last_seq_){
+        num_calls++;
+        last_seq = last_seq_;
+    }
+
+    size_t num_calls, last_seq;
+};
+
 ////////////////////////////////////////////////////////////////////////
 BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_normal){
 ////////////////////////////////////////////////////////////////////////
@@ -147,6 +197,7 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_normal){
     handler.set_samp_rate(SAMP_RATE);
     handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
     handler.set_converter(id);
+    handler.warm_start(uhd::device_addr_t("warm_start=1,warm_start_lock=none"), 20);
 
     //check the received packets
     size_t num_accum_samps = 0;
@@ -180,7 +231,7 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_normal){
 }
 
 ////////////////////////////////////////////////////////////////////////
-BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_sequence_error){
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_histograms){
 ////////////////////////////////////////////////////////////////////////
     uhd::convert::id_type id;
     id.input_format = "sc16_item32_be";
@@ -191,7 +242,7 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_sequence_error){
     dummy_recv_xport_class dummy_recv_xport("big");
     uhd::transport::vrt::if_packet_info_t ifpi;
     ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
-    ifpi.num_payload_words32 = 0;
+    ifpi.num_payload_words32 = 10;
     ifpi.packet_count = 0;
     ifpi.sob = true;
     ifpi.eob = false;
@@ -207,17 +258,12 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_sequence_error){
     static const double SAMP_RATE = 10e6;
     static const size_t NUM_PKTS_TO_TEST = 30;
 
-    //generate a bunch of packets
     for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
-        ifpi.num_payload_words32 = 10 + i%10;
-        if (i != NUM_PKTS_TO_TEST/2){ //simulate a lost packet
-            dummy_recv_xport.push_back_packet(ifpi);
-        }
+        dummy_recv_xport.push_back_packet(ifpi);
         ifpi.packet_count++;
         ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
     }
 
-    //create the super receive packet handler
     uhd::transport::sph::recv_packet_handler handler(1);
     handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
     handler.set_tick_rate(TICK_RATE);
@@ -225,48 +271,105 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_sequence_error){
     handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
     handler.set_converter(id);
 
-    //check the received packets
-    size_t num_accum_samps = 0;
+    //nothing is recorded until the histograms are enabled
     std::vector<std::complex<float> > buff(20);
     uhd::rx_metadata_t metadata;
+    BOOST_CHECK_EQUAL(handler.recv(&buff.front(), buff.size(), metadata, 1.0, true), size_t(10));
+    BOOST_CHECK_EQUAL(handler.get_histograms()["xport_wait"].count, uint64_t(0));
+
+    handler.set_histograms_enabled(true);
+    for (size_t i = 1; i < NUM_PKTS_TO_TEST; i++){
+        BOOST_CHECK_EQUAL(handler.recv(&buff.front(), buff.size(), metadata, 1.0, true), size_t(10));
+    }
+    const uhd::histograms_t hists = handler.get_histograms();
+    const size_t num_recvd = NUM_PKTS_TO_TEST - 1;
+    BOOST_CHECK_EQUAL(hists["packets_per_call"].count, uint64_t(num_recvd));
+    BOOST_CHECK_EQUAL(hists["packets_per_call"].min, uint64_t(1));
+    BOOST_CHECK_EQUAL(hists["packets_per_call"].max, uint64_t(1));
+    BOOST_CHECK_EQUAL(hists["xport_wait"].count, uint64_t(num_recvd));
+    BOOST_CHECK_EQUAL(hists["convert"].count, uint64_t(num_recvd));
+    BOOST_CHECK_EQUAL(hists["packet_age"].count, uint64_t(num_recvd));
+    //the rate is measured from the end of the first recorded call
+    BOOST_CHECK_EQUAL(hists["sample_rate"].count, uint64_t(num_recvd - 1));
+    BOOST_CHECK_EQUAL(hists["packet_age"].unit, "ns");
+}
+
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_packet_ready){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 10;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 3;
+
     for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
-        std::cout << "data check " << i << std::endl;
-        size_t num_samps_ret = handler.recv(
-            &buff.front(), buff.size(), metadata, 1.0, true
-        );
-        if (i == NUM_PKTS_TO_TEST/2){
-            //must get the soft overflow here
-            BOOST_REQUIRE(metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
-            BOOST_REQUIRE(metadata.out_of_sequence == true);
-            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
-            num_accum_samps += 10 + i%10;
-        }
-        else{
-            BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
-            BOOST_CHECK(not metadata.more_fragments);
-            BOOST_CHECK(metadata.has_time_spec);
-            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
-            BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
-            num_accum_samps += num_samps_ret;
-        }
+        dummy_recv_xport.push_back_packet(ifpi);
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
     }
 
-    //subsequent receives should be a timeout
-    for (size_t i = 0; i < 3; i++){
-        std::cout << "timeout check " << i << std::endl;
-        handler.recv(
-            &buff.front(), buff.size(), metadata, 1.0, true
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan(0, uhd::transport::zero_copy_if::sptr(new dummy_zero_copy_xport(dummy_recv_xport)));
+    handler.set_converter(id);
+
+    //the dummy transport has no descriptor to wait on
+    std::vector<int> fds;
+    BOOST_CHECK(not handler.get_recv_fds(fds));
+    BOOST_CHECK(fds.empty());
+
+    //checking twice keeps the same packet, which recv() returns next
+    std::vector<std::complex<float> > buff(20);
+    uhd::rx_metadata_t metadata;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        BOOST_CHECK(handler.is_packet_ready());
+        BOOST_CHECK(handler.is_packet_ready());
+        const size_t num_samps_ret = handler.recv(
+            &buff.front(), buff.size(), metadata, 0.0, true
         );
-        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(i*10, SAMP_RATE));
+        BOOST_CHECK_EQUAL(num_samps_ret, 10U);
     }
 
-    //simulate the transport failing
-    dummy_recv_xport.set_io_status(false);
-    BOOST_REQUIRE_THROW(handler.recv(&buff.front(), buff.size(), metadata, 1.0, true), uhd::io_error);
+    //a fragment left in the handler is ready without the transport
+    ifpi.num_payload_words32 = 30;
+    dummy_recv_xport.push_back_packet(ifpi);
+    BOOST_CHECK(handler.is_packet_ready());
+    handler.recv(&buff.front(), buff.size(), metadata, 0.0, true);
+    BOOST_CHECK(metadata.more_fragments);
+    BOOST_CHECK(handler.is_packet_ready());
+    handler.recv(&buff.front(), buff.size(), metadata, 0.0, true);
+    BOOST_CHECK(not metadata.more_fragments);
+
+    BOOST_CHECK(not handler.is_packet_ready());
+    handler.recv(&buff.front(), buff.size(), metadata, 0.0, true);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
 }
 
 ////////////////////////////////////////////////////////////////////////
-BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_inline_message){
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_batched){
 ////////////////////////////////////////////////////////////////////////
     uhd::convert::id_type id;
     id.input_format = "sc16_item32_be";
@@ -292,21 +395,14 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_inline_message){
     static const double TICK_RATE = 100e6;
     static const double SAMP_RATE = 10e6;
     static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t BATCH_SIZE = 4;
 
     //generate a bunch of packets
     for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
-        ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
         ifpi.num_payload_words32 = 10 + i%10;
         dummy_recv_xport.push_back_packet(ifpi);
         ifpi.packet_count++;
         ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
-
-        //simulate overflow
-        if (i == NUM_PKTS_TO_TEST/2){
-            ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_CONTEXT;
-            ifpi.num_payload_words32 = 1;
-            dummy_recv_xport.push_back_packet(ifpi, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
-        }
     }
 
     //create the super receive packet handler
@@ -315,12 +411,9 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_inline_message){
     handler.set_tick_rate(TICK_RATE);
     handler.set_samp_rate(SAMP_RATE);
     handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    handler.set_xport_chan_get_buffs(0, boost::bind(&dummy_recv_xport_class::get_recv_buffs, &dummy_recv_xport, _1, _2, _3), BATCH_SIZE);
     handler.set_converter(id);
 
-    //create an overflow handler
-    overflow_handler_type overflow_handler;
-    handler.set_overflow_handler(0, boost::bind(&overflow_handler_type::handle, &overflow_handler));
-
     //check the received packets
     size_t num_accum_samps = 0;
     std::vector<std::complex<float> > buff(20);
@@ -331,30 +424,18 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_inline_message){
             &buff.front(), buff.size(), metadata, 1.0, true
         );
         BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
-        BOOST_CHECK(not metadata.more_fragments);
         BOOST_CHECK(metadata.has_time_spec);
         BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
         BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
         num_accum_samps += num_samps_ret;
-        if (i == NUM_PKTS_TO_TEST/2){
-            handler.recv(
-                &buff.front(), buff.size(), metadata, 1.0, true
-            );
-            std::cout << "metadata.error_code " << metadata.error_code << std::endl;
-            BOOST_REQUIRE(metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
-            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
-            BOOST_CHECK_EQUAL(overflow_handler.num_overflow, size_t(1));
-        }
     }
 
+    //the packets were taken in batches
+    BOOST_CHECK_EQUAL(dummy_recv_xport.num_batch_calls, (NUM_PKTS_TO_TEST + BATCH_SIZE - 1)/BATCH_SIZE);
+
     //subsequent receives should be a timeout
-    for (size_t i = 0; i < 3; i++){
-        std::cout << "timeout check " << i << std::endl;
-        handler.recv(
-            &buff.front(), buff.size(), metadata, 1.0, true
-        );
-        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
-    }
+    handler.recv(&buff.front(), buff.size(), metadata, 1.0, true);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
 
     //simulate the transport failing
     dummy_recv_xport.set_io_status(false);
@@ -362,7 +443,7 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_inline_message){
 }
 
 ////////////////////////////////////////////////////////////////////////
-BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_normal){
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_borrowed){
 ////////////////////////////////////////////////////////////////////////
     uhd::convert::id_type id;
     id.input_format = "sc16_item32_be";
@@ -370,6 +451,7 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_normal){
     id.output_format = "fc32";
     id.num_outputs = 1;
 
+    dummy_recv_xport_class dummy_recv_xport("big");
     uhd::transport::vrt::if_packet_info_t ifpi;
     ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
     ifpi.num_payload_words32 = 0;
@@ -387,71 +469,63 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_normal){
     static const double TICK_RATE = 100e6;
     static const double SAMP_RATE = 10e6;
     static const size_t NUM_PKTS_TO_TEST = 30;
-    static const size_t NUM_SAMPS_PER_BUFF = 20;
-    static const size_t NCHANNELS = 4;
-
-    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
 
     //generate a bunch of packets
     for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
         ifpi.num_payload_words32 = 10 + i%10;
-        for (size_t ch = 0; ch < NCHANNELS; ch++){
-            dummy_recv_xports[ch].push_back_packet(ifpi);
-        }
+        dummy_recv_xport.push_back_packet(ifpi);
         ifpi.packet_count++;
         ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
     }
 
     //create the super receive packet handler
-    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    uhd::transport::sph::recv_packet_handler handler(1);
     handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
     handler.set_tick_rate(TICK_RATE);
     handler.set_samp_rate(SAMP_RATE);
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
-    }
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
     handler.set_converter(id);
 
-    //check the received packets
+    //borrow the packets, every third one after a partial recv()
     size_t num_accum_samps = 0;
-    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
-    std::vector<std::complex<float> *> buffs(NCHANNELS);
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
-    }
+    std::vector<std::complex<float> > buff(20);
+    uhd::rx_streamer::borrowed_packet_t packet;
     uhd::rx_metadata_t metadata;
     for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
         std::cout << "data check " << i << std::endl;
-        size_t num_samps_ret = handler.recv(
-            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
-        );
+        size_t num_samps_expected = 10 + i%10;
+        if (i%3 == 0){
+            const size_t num_samps_ret = handler.recv(
+                &buff.front(), 5, metadata, 1.0, true
+            );
+            BOOST_CHECK_EQUAL(num_samps_ret, 5U);
+            num_accum_samps += num_samps_ret;
+            num_samps_expected -= num_samps_ret;
+        }
+        const size_t num_samps_ret = handler.recv_borrowed(packet, metadata, 1.0);
         BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
         BOOST_CHECK(not metadata.more_fragments);
-        BOOST_CHECK(metadata.has_time_spec);
         BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
-        BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
+        BOOST_CHECK_EQUAL(num_samps_ret, num_samps_expected);
+        BOOST_REQUIRE_EQUAL(packet.buffs.size(), 1U);
+        BOOST_REQUIRE_EQUAL(packet.xport_buffs.size(), 1U);
+
+        //the view ends where the packet ends
+        const char *end = packet.xport_buffs[0]->cast<const char *>() + packet.xport_buffs[0]->size();
+        BOOST_CHECK(static_cast<const char *>(packet.buffs[0]) + num_samps_ret*sizeof(uint32_t) == end);
         num_accum_samps += num_samps_ret;
     }
+    packet.release();
+    BOOST_CHECK(packet.buffs.empty());
 
     //subsequent receives should be a timeout
-    for (size_t i = 0; i < 3; i++){
-        std::cout << "timeout check " << i << std::endl;
-        handler.recv(
-            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
-        );
-        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
-    }
-
-    //simulate the transport failing
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        dummy_recv_xports[ch].set_io_status(false);
-    }
-
-    BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
+    handler.recv_borrowed(packet, metadata, 1.0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+    BOOST_CHECK(packet.buffs.empty());
 }
 
 ////////////////////////////////////////////////////////////////////////
-BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_sequence_error){
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_packets){
 ////////////////////////////////////////////////////////////////////////
     uhd::convert::id_type id;
     id.input_format = "sc16_item32_be";
@@ -459,6 +533,7 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_sequence_error){
     id.output_format = "fc32";
     id.num_outputs = 1;
 
+    dummy_recv_xport_class dummy_recv_xport("big");
     uhd::transport::vrt::if_packet_info_t ifpi;
     ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
     ifpi.num_payload_words32 = 0;
@@ -476,83 +551,61 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_sequence_error){
     static const double TICK_RATE = 100e6;
     static const double SAMP_RATE = 10e6;
     static const size_t NUM_PKTS_TO_TEST = 30;
-    static const size_t NUM_SAMPS_PER_BUFF = 20;
-    static const size_t NCHANNELS = 4;
 
-    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
-
-    //generate a bunch of packets
+    //generate a bunch of packets, the 20th ends a burst
     for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
         ifpi.num_payload_words32 = 10 + i%10;
-        for (size_t ch = 0; ch < NCHANNELS; ch++){
-            if (i == NUM_PKTS_TO_TEST/2 and ch == 2){
-                continue; //simulates a lost packet
-            }
-            dummy_recv_xports[ch].push_back_packet(ifpi);
-        }
+        ifpi.eob = (i == 19);
+        dummy_recv_xport.push_back_packet(ifpi);
         ifpi.packet_count++;
         ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
     }
 
     //create the super receive packet handler
-    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    uhd::transport::sph::recv_packet_handler handler(1);
     handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
     handler.set_tick_rate(TICK_RATE);
     handler.set_samp_rate(SAMP_RATE);
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
-    }
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
     handler.set_converter(id);
 
-    //check the received packets
-    size_t num_accum_samps = 0;
-    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
-    std::vector<std::complex<float> *> buffs(NCHANNELS);
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
-    }
-    uhd::rx_metadata_t metadata;
-    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
-        std::cout << "data check " << i << std::endl;
-        size_t num_samps_ret = handler.recv(
-            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
-        );
-        if (i == NUM_PKTS_TO_TEST/2){
-            //must get the soft overflow here
-            BOOST_REQUIRE(metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
-            BOOST_REQUIRE(metadata.out_of_sequence == true);
-            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
-            num_accum_samps += 10 + i%10;
-        }
-        else{
-            BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
-            BOOST_CHECK(not metadata.more_fragments);
-            BOOST_CHECK(metadata.has_time_spec);
-            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
-            BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
-            num_accum_samps += num_samps_ret;
+    //fill large buffers, each packet keeps its own metadata
+    size_t num_accum_samps = 0, num_packets = 0, num_bursts = 0;
+    std::vector<std::complex<float> > buff(100);
+    std::vector<uhd::rx_streamer::packet_metadata_t> packets;
+    while (num_packets < NUM_PKTS_TO_TEST){
+        const size_t num_samps_ret = handler.recv_packets(&buff.front(), buff.size(), packets, 1.0);
+        BOOST_REQUIRE(not packets.empty());
+        BOOST_REQUIRE(num_samps_ret != 0);
+        size_t offset = 0;
+        for (size_t j = 0; j < packets.size(); j++){
+            const uhd::rx_metadata_t &md = packets[j].metadata;
+            BOOST_CHECK_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+            BOOST_CHECK_EQUAL(packets[j].offset, offset);
+            BOOST_CHECK_TS_CLOSE(md.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+            if (not md.more_fragments){
+                BOOST_CHECK_EQUAL(md.fragment_offset + packets[j].nsamps, 10 + num_packets%10);
+                num_packets++;
+            }
+            if (md.end_of_burst) num_bursts++;
+            offset += packets[j].nsamps;
+            num_accum_samps += packets[j].nsamps;
         }
-    }
-
-    //subsequent receives should be a timeout
-    for (size_t i = 0; i < 3; i++){
-        std::cout << "timeout check " << i << std::endl;
-        handler.recv(
-            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
-        );
-        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
-    }
+        BOOST_CHECK_EQUAL(offset, num_samps_ret);
 
-    //simulate the transport failing
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        dummy_recv_xports[ch].set_io_status(false);
+        //the call ends at the end of the buffer or at the end of the burst
+        BOOST_CHECK(num_samps_ret == buff.size() or packets.back().metadata.end_of_burst or num_packets == NUM_PKTS_TO_TEST);
     }
+    BOOST_CHECK_EQUAL(num_bursts, 1U);
 
-    BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
+    //subsequent receives should be a timeout
+    BOOST_CHECK_EQUAL(handler.recv_packets(&buff.front(), buff.size(), packets, 1.0), 0U);
+    BOOST_REQUIRE_EQUAL(packets.size(), 1U);
+    BOOST_CHECK_EQUAL(packets[0].metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
 }
 
 ////////////////////////////////////////////////////////////////////////
-BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_time_error){
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_replay){
 ////////////////////////////////////////////////////////////////////////
     uhd::convert::id_type id;
     id.input_format = "sc16_item32_be";
@@ -560,6 +613,7 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_time_error){
     id.output_format = "fc32";
     id.num_outputs = 1;
 
+    dummy_recv_xport_class dummy_recv_xport("big");
     uhd::transport::vrt::if_packet_info_t ifpi;
     ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
     ifpi.num_payload_words32 = 0;
@@ -577,55 +631,154 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_time_error){
     static const double TICK_RATE = 100e6;
     static const double SAMP_RATE = 10e6;
     static const size_t NUM_PKTS_TO_TEST = 30;
-    static const size_t NUM_SAMPS_PER_BUFF = 20;
-    static const size_t NCHANNELS = 4;
-
-    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
 
     //generate a bunch of packets
     for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
         ifpi.num_payload_words32 = 10 + i%10;
-        for (size_t ch = 0; ch < NCHANNELS; ch++){
-            dummy_recv_xports[ch].push_back_packet(ifpi);
-        }
+        dummy_recv_xport.push_back_packet(ifpi);
         ifpi.packet_count++;
         ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
-        if (i == NUM_PKTS_TO_TEST/2){
-            ifpi.tsf = 0; //simulate the user changing the time
-        }
     }
 
+    //capture all packets of the dummy transport
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path()
+        / boost::filesystem::unique_path("sph_recv_test_%%%%-%%%%.cap");
+    {
+        uhd::transport::zero_copy_capture::sptr capture = uhd::transport::zero_copy_capture::make(
+            uhd::transport::zero_copy_if::sptr(new dummy_zero_copy_xport(dummy_recv_xport)),
+            path.string(), uhd::device_addr_t("capture_size=65536")
+        );
+        while (capture->get_recv_buff(0.0)){}
+        BOOST_CHECK_EQUAL(capture->get_num_captured_frames(), NUM_PKTS_TO_TEST);
+    }
+
+    //replay the capture twice, as fast as possible
+    uhd::transport::zero_copy_if::sptr replay = uhd::transport::zero_copy_replay::make(
+        path.string(), uhd::device_addr_t("replay_rate=0,replay_loops=2")
+    );
+    BOOST_CHECK_EQUAL(replay->get_recv_frame_size(), 1500U);
+
     //create the super receive packet handler
-    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    uhd::transport::sph::recv_packet_handler handler(1);
     handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
     handler.set_tick_rate(TICK_RATE);
     handler.set_samp_rate(SAMP_RATE);
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+    handler.set_xport_chan(0, replay);
+    boost::shared_ptr<dummy_recv_flowctrl> flowctrl(new dummy_recv_flowctrl());
+    handler.set_xport_flowctrl(0, flowctrl, 10, true);
+    handler.set_converter(id);
+
+    //check the received packets of both passes
+    std::vector<std::complex<float> > buff(20);
+    uhd::rx_metadata_t metadata;
+    for (size_t pass = 0; pass < 2; pass++){
+        size_t num_accum_samps = 0;
+        for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+            std::cout << "data check " << pass << "/" << i << std::endl;
+            size_t num_samps_ret = handler.recv(
+                &buff.front(), buff.size(), metadata, 0.1, true
+            );
+            if (pass == 1 and i == 0){
+                //the packet count starts over with the second pass
+                BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+                BOOST_CHECK(metadata.out_of_sequence);
+                num_samps_ret = handler.recv(
+                    &buff.front(), buff.size(), metadata, 0.1, true
+                );
+            }
+            BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+            BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
+            num_accum_samps += num_samps_ret;
+        }
+    }
+
+    //the replay ends after the second pass
+    handler.recv(&buff.front(), buff.size(), metadata, 0.1, true);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+    BOOST_CHECK_EQUAL(replay->get_stats().recv_packets, uint64_t(2*NUM_PKTS_TO_TEST));
+
+    //the initial ack, every tenth packet count (VRT counts wrap at 16,
+    //so counts 0 and 10 come twice per pass), the sequence error and the
+    //timeout at the end
+    BOOST_CHECK_EQUAL(flowctrl->num_calls, 11U);
+    BOOST_CHECK_EQUAL(flowctrl->last_seq, 10U);
+
+    replay.reset();
+    boost::filesystem::remove(path);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_sequence_error){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //generate a bunch of packets
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        if (i != NUM_PKTS_TO_TEST/2){ //simulate a lost packet
+            dummy_recv_xport.push_back_packet(ifpi);
+        }
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
     }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
     handler.set_converter(id);
 
     //check the received packets
     size_t num_accum_samps = 0;
-    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
-    std::vector<std::complex<float> *> buffs(NCHANNELS);
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
-    }
+    std::vector<std::complex<float> > buff(20);
     uhd::rx_metadata_t metadata;
     for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
         std::cout << "data check " << i << std::endl;
         size_t num_samps_ret = handler.recv(
-            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+            &buff.front(), buff.size(), metadata, 1.0, true
         );
-        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
-        BOOST_CHECK(not metadata.more_fragments);
-        BOOST_CHECK(metadata.has_time_spec);
-        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
-        BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
-        num_accum_samps += num_samps_ret;
         if (i == NUM_PKTS_TO_TEST/2){
-            num_accum_samps = 0; //simulate the user changing the time
+            //must get the soft overflow here
+            BOOST_REQUIRE(metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+            BOOST_REQUIRE(metadata.out_of_sequence == true);
+            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+            num_accum_samps += 10 + i%10;
+        }
+        else{
+            BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+            BOOST_CHECK(not metadata.more_fragments);
+            BOOST_CHECK(metadata.has_time_spec);
+            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+            BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
+            //the first packet after the loss reports the lost samples
+            BOOST_CHECK_EQUAL(metadata.num_dropped_samps, (i == NUM_PKTS_TO_TEST/2+1)? 10 + (i-1)%10 : 0);
+            num_accum_samps += num_samps_ret;
         }
     }
 
@@ -633,21 +786,25 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_time_error){
     for (size_t i = 0; i < 3; i++){
         std::cout << "timeout check " << i << std::endl;
         handler.recv(
-            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+            &buff.front(), buff.size(), metadata, 1.0, true
         );
         BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
     }
 
-    //simulate the transport failing
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        dummy_recv_xports[ch].set_io_status(false);
-    }
+    //the lost packet and the timeouts show up in the counters
+    const uhd::transport::stream_stats_t stats = handler.get_stats();
+    BOOST_CHECK_EQUAL(stats.packets, uint64_t(NUM_PKTS_TO_TEST-1));
+    BOOST_CHECK_EQUAL(stats.sequence_errors, 1U);
+    BOOST_CHECK_EQUAL(stats.timeouts, 3U);
+    BOOST_CHECK_EQUAL(stats.overflows, 0U);
 
-    BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
+    //simulate the transport failing
+    dummy_recv_xport.set_io_status(false);
+    BOOST_REQUIRE_THROW(handler.recv(&buff.front(), buff.size(), metadata, 1.0, true), uhd::io_error);
 }
 
 ////////////////////////////////////////////////////////////////////////
-BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_exception){
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_inline_message){
 ////////////////////////////////////////////////////////////////////////
     uhd::convert::id_type id;
     id.input_format = "sc16_item32_be";
@@ -655,6 +812,7 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_exception){
     id.output_format = "fc32";
     id.num_outputs = 1;
 
+    dummy_recv_xport_class dummy_recv_xport("big");
     uhd::transport::vrt::if_packet_info_t ifpi;
     ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
     ifpi.num_payload_words32 = 0;
@@ -672,51 +830,77 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_exception){
     static const double TICK_RATE = 100e6;
     static const double SAMP_RATE = 10e6;
     static const size_t NUM_PKTS_TO_TEST = 30;
-    static const size_t NUM_SAMPS_PER_BUFF = 20;
-    static const size_t NCHANNELS = 4;
-
-    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
 
     //generate a bunch of packets
     for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
         ifpi.num_payload_words32 = 10 + i%10;
-        for (size_t ch = 0; ch < NCHANNELS; ch++){
-            dummy_recv_xports[ch].push_back_packet(ifpi);
-        }
+        dummy_recv_xport.push_back_packet(ifpi);
         ifpi.packet_count++;
         ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+
+        //simulate overflow
         if (i == NUM_PKTS_TO_TEST/2){
-            ifpi.tsf = 0; //simulate the user changing the time
+            ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_CONTEXT;
+            ifpi.num_payload_words32 = 1;
+            dummy_recv_xport.push_back_packet(ifpi, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
         }
     }
 
     //create the super receive packet handler
-    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    uhd::transport::sph::recv_packet_handler handler(1);
     handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
     handler.set_tick_rate(TICK_RATE);
     handler.set_samp_rate(SAMP_RATE);
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
-    }
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
     handler.set_converter(id);
 
-    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
-    std::vector<std::complex<float> *> buffs(NCHANNELS);
-    for (size_t ch = 0; ch < NCHANNELS; ch++){
-        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
-    }
+    //create an overflow handler
+    overflow_handler_type overflow_handler;
+    handler.set_overflow_handler(0, boost::bind(&overflow_handler_type::handle, &overflow_handler));
 
-    // simulate a failure on a channel (the last one)
+    //check the received packets
+    size_t num_accum_samps = 0;
+    std::vector<std::complex<float> > buff(20);
     uhd::rx_metadata_t metadata;
-    dummy_recv_xports[NCHANNELS-1].set_io_status(false);
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        std::cout << "data check " << i << std::endl;
+        size_t num_samps_ret = handler.recv(
+            &buff.front(), buff.size(), metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK(not metadata.more_fragments);
+        BOOST_CHECK(metadata.has_time_spec);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+        BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
+        num_accum_samps += num_samps_ret;
+        if (i == NUM_PKTS_TO_TEST/2){
+            handler.recv(
+                &buff.front(), buff.size(), metadata, 1.0, true
+            );
+            std::cout << "metadata.error_code " << metadata.error_code << std::endl;
+            BOOST_REQUIRE(metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+            BOOST_CHECK_EQUAL(overflow_handler.num_overflow, size_t(1));
+        }
+    }
 
-    std::cout << "exception check" << std::endl;
+    //subsequent receives should be a timeout
+    for (size_t i = 0; i < 3; i++){
+        std::cout << "timeout check " << i << std::endl;
+        handler.recv(
+            &buff.front(), buff.size(), metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+    }
 
-    BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
+    //simulate the transport failing
+    dummy_recv_xport.set_io_status(false);
+    BOOST_REQUIRE_THROW(handler.recv(&buff.front(), buff.size(), metadata, 1.0, true), uhd::io_error);
 }
 
 ////////////////////////////////////////////////////////////////////////
-BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_fragment){
+BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_normal){
 ////////////////////////////////////////////////////////////////////////
     uhd::convert::id_type id;
     id.input_format = "sc16_item32_be";
@@ -741,7 +925,7 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_fragment){
     static const double TICK_RATE = 100e6;
     static const double SAMP_RATE = 10e6;
     static const size_t NUM_PKTS_TO_TEST = 30;
-    static const size_t NUM_SAMPS_PER_BUFF = 10;
+    static const size_t NUM_SAMPS_PER_BUFF = 20;
     static const size_t NCHANNELS = 4;
 
     std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
@@ -780,22 +964,10 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_fragment){
             buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
         );
         BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
-        BOOST_CHECK(metadata.has_time_spec);
-        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
-        BOOST_CHECK_EQUAL(num_samps_ret, 10UL);
-        num_accum_samps += num_samps_ret;
-
-        if (not metadata.more_fragments) continue;
-
-        num_samps_ret = handler.recv(
-            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
-        );
-        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
         BOOST_CHECK(not metadata.more_fragments);
-        BOOST_CHECK_EQUAL(metadata.fragment_offset, 10UL);
         BOOST_CHECK(metadata.has_time_spec);
         BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
-        BOOST_CHECK_EQUAL(num_samps_ret, i%10);
+        BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
         num_accum_samps += num_samps_ret;
     }
 
@@ -815,3 +987,1221 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_fragment){
 
     BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
 }
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_sequence_error){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t NUM_SAMPS_PER_BUFF = 20;
+    static const size_t NCHANNELS = 4;
+
+    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
+
+    //generate a bunch of packets
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        for (size_t ch = 0; ch < NCHANNELS; ch++){
+            if (i == NUM_PKTS_TO_TEST/2 and ch == 2){
+                continue; //simulates a lost packet
+            }
+            dummy_recv_xports[ch].push_back_packet(ifpi);
+        }
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+    }
+    handler.set_converter(id);
+
+    //check the received packets
+    size_t num_accum_samps = 0;
+    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
+    std::vector<std::complex<float> *> buffs(NCHANNELS);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
+    }
+    uhd::rx_metadata_t metadata;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        std::cout << "data check " << i << std::endl;
+        size_t num_samps_ret = handler.recv(
+            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+        );
+        if (i == NUM_PKTS_TO_TEST/2){
+            //must get the soft overflow here
+            BOOST_REQUIRE(metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+            BOOST_REQUIRE(metadata.out_of_sequence == true);
+            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+            num_accum_samps += 10 + i%10;
+        }
+        else{
+            BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+            BOOST_CHECK(not metadata.more_fragments);
+            BOOST_CHECK(metadata.has_time_spec);
+            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+            BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
+            num_accum_samps += num_samps_ret;
+        }
+    }
+
+    //subsequent receives should be a timeout
+    for (size_t i = 0; i < 3; i++){
+        std::cout << "timeout check " << i << std::endl;
+        handler.recv(
+            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+    }
+
+    //simulate the transport failing
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        dummy_recv_xports[ch].set_io_status(false);
+    }
+
+    BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_time_error){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t NUM_SAMPS_PER_BUFF = 20;
+    static const size_t NCHANNELS = 4;
+
+    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
+
+    //generate a bunch of packets
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        for (size_t ch = 0; ch < NCHANNELS; ch++){
+            dummy_recv_xports[ch].push_back_packet(ifpi);
+        }
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+        if (i == NUM_PKTS_TO_TEST/2){
+            ifpi.tsf = 0; //simulate the user changing the time
+        }
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+    }
+    handler.set_converter(id);
+
+    //check the received packets
+    size_t num_accum_samps = 0;
+    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
+    std::vector<std::complex<float> *> buffs(NCHANNELS);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
+    }
+    uhd::rx_metadata_t metadata;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        std::cout << "data check " << i << std::endl;
+        size_t num_samps_ret = handler.recv(
+            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK(not metadata.more_fragments);
+        BOOST_CHECK(metadata.has_time_spec);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+        BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
+        num_accum_samps += num_samps_ret;
+        if (i == NUM_PKTS_TO_TEST/2){
+            num_accum_samps = 0; //simulate the user changing the time
+        }
+    }
+
+    //subsequent receives should be a timeout
+    for (size_t i = 0; i < 3; i++){
+        std::cout << "timeout check " << i << std::endl;
+        handler.recv(
+            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+    }
+
+    //simulate the transport failing
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        dummy_recv_xports[ch].set_io_status(false);
+    }
+
+    BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_exception){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t NUM_SAMPS_PER_BUFF = 20;
+    static const size_t NCHANNELS = 4;
+
+    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
+
+    //generate a bunch of packets
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        for (size_t ch = 0; ch < NCHANNELS; ch++){
+            dummy_recv_xports[ch].push_back_packet(ifpi);
+        }
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+        if (i == NUM_PKTS_TO_TEST/2){
+            ifpi.tsf = 0; //simulate the user changing the time
+        }
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+    }
+    handler.set_converter(id);
+
+    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
+    std::vector<std::complex<float> *> buffs(NCHANNELS);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
+    }
+
+    // simulate a failure on a channel (the last one)
+    uhd::rx_metadata_t metadata;
+    dummy_recv_xports[NCHANNELS-1].set_io_status(false);
+
+    std::cout << "exception check" << std::endl;
+
+    BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_fragment){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t NUM_SAMPS_PER_BUFF = 10;
+    static const size_t NCHANNELS = 4;
+
+    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
+
+    //generate a bunch of packets
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        for (size_t ch = 0; ch < NCHANNELS; ch++){
+            dummy_recv_xports[ch].push_back_packet(ifpi);
+        }
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+    }
+    handler.set_converter(id);
+
+    //check the received packets
+    size_t num_accum_samps = 0;
+    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
+    std::vector<std::complex<float> *> buffs(NCHANNELS);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
+    }
+    uhd::rx_metadata_t metadata;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        std::cout << "data check " << i << std::endl;
+        size_t num_samps_ret = handler.recv(
+            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK(metadata.has_time_spec);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+        BOOST_CHECK_EQUAL(num_samps_ret, 10UL);
+        num_accum_samps += num_samps_ret;
+
+        if (not metadata.more_fragments) continue;
+
+        num_samps_ret = handler.recv(
+            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK(not metadata.more_fragments);
+        BOOST_CHECK_EQUAL(metadata.fragment_offset, 10UL);
+        BOOST_CHECK(metadata.has_time_spec);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+        BOOST_CHECK_EQUAL(num_samps_ret, i%10);
+        num_accum_samps += num_samps_ret;
+    }
+
+    //subsequent receives should be a timeout
+    for (size_t i = 0; i < 3; i++){
+        std::cout << "timeout check " << i << std::endl;
+        handler.recv(
+            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+    }
+
+    //simulate the transport failing
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        dummy_recv_xports[ch].set_io_status(false);
+    }
+
+    BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_fixed_spp){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t SPP = 16;
+    static const size_t NUM_PKTS_TO_TEST = 12;
+    static const size_t NCHANNELS = 2;
+
+    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
+
+    //full packets, a short one in the middle and a short one ending the burst
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = (i == 5 or i == NUM_PKTS_TO_TEST-1)? SPP/2 : SPP;
+        ifpi.eob = (i == NUM_PKTS_TO_TEST-1);
+        for (size_t ch = 0; ch < NCHANNELS; ch++){
+            dummy_recv_xports[ch].push_back_packet(ifpi);
+        }
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+    }
+    handler.set_converter(id);
+    handler.set_fixed_spp(SPP);
+
+    std::vector<std::complex<float> > mem(4*SPP*NCHANNELS);
+    std::vector<std::complex<float> *> buffs(NCHANNELS);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        buffs[ch] = &mem[ch*4*SPP];
+    }
+    uhd::rx_metadata_t metadata;
+
+    //packets 0-3 fill the buffer whole
+    size_t num_samps_ret = handler.recv(buffs, 4*SPP, metadata, 1.0, false);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+    BOOST_CHECK_EQUAL(num_samps_ret, 4*SPP);
+    BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t(0.0));
+    BOOST_CHECK(not metadata.more_fragments);
+
+    //packet 4, the short packet 5 and half of packet 6
+    num_samps_ret = handler.recv(buffs, 2*SPP, metadata, 1.0, false);
+    BOOST_CHECK_EQUAL(num_samps_ret, 2*SPP);
+    BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(4*SPP, SAMP_RATE));
+
+    //the rest of packet 6 is a fragment, so the general path takes it and half of packet 7
+    num_samps_ret = handler.recv(buffs, SPP, metadata, 1.0, false);
+    BOOST_CHECK_EQUAL(num_samps_ret, SPP);
+    BOOST_CHECK_EQUAL(metadata.fragment_offset, SPP/2);
+    BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(5*SPP + SPP/2 + SPP/2, SAMP_RATE));
+
+    //the rest of packet 7 with one_packet
+    num_samps_ret = handler.recv(buffs, 2*SPP, metadata, 1.0, true);
+    BOOST_CHECK_EQUAL(num_samps_ret, SPP/2);
+    BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(7*SPP, SAMP_RATE));
+
+    //packets 8-10 and the short end of burst
+    num_samps_ret = handler.recv(buffs, 4*SPP, metadata, 1.0, false);
+    BOOST_CHECK_EQUAL(num_samps_ret, 3*SPP + SPP/2);
+    BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(7*SPP + SPP/2, SAMP_RATE));
+
+    //subsequent receives should be a timeout
+    handler.recv(buffs, 4*SPP, metadata, 1.0, false);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_converter_threads){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t NUM_SAMPS_PER_BUFF = 20;
+    static const size_t NCHANNELS = 4;
+
+    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
+
+    //generate a bunch of packets, the first sample identifies the channel
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        for (size_t ch = 0; ch < NCHANNELS; ch++){
+            dummy_recv_xports[ch].push_back_packet(ifpi, uint32_t(ch+1));
+        }
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler with two converting threads
+    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+    }
+    handler.set_converter(id);
+    handler.set_converter_threads(uhd::device_addr_t("convert_threads=2"));
+
+    //check the received packets
+    size_t num_accum_samps = 0;
+    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
+    std::vector<std::complex<float> *> buffs(NCHANNELS);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
+    }
+    uhd::rx_metadata_t metadata;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        std::cout << "data check " << i << std::endl;
+        size_t num_samps_ret = handler.recv(
+            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK(not metadata.more_fragments);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+        BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
+        for (size_t ch = 0; ch < NCHANNELS; ch++){
+            BOOST_CHECK_CLOSE(buffs[ch][0].imag(), float(ch+1)/32767, 0.01);
+        }
+        num_accum_samps += num_samps_ret;
+    }
+
+    //subsequent receives should be a timeout
+    handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_mboard_threads){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t NUM_SAMPS_PER_BUFF = 20;
+    static const size_t NCHANNELS = 4;
+    static const size_t START_TICKS = 1000;
+
+    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
+
+    //the second motherboard started early, its first packet is dropped in alignment
+    ifpi.num_payload_words32 = 10;
+    ifpi.packet_count = 0;
+    ifpi.tsf = 0;
+    for (size_t ch = 2; ch < NCHANNELS; ch++){
+        dummy_recv_xports[ch].push_back_packet(ifpi, uint32_t(ch+1));
+    }
+
+    //generate a bunch of packets, the first sample identifies the channel
+    ifpi.tsf = START_TICKS;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        for (size_t ch = 0; ch < NCHANNELS; ch++){
+            ifpi.packet_count = (ch < 2)? i : i + 1;
+            dummy_recv_xports[ch].push_back_packet(ifpi, uint32_t(ch+1));
+        }
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler with two boards of two channels
+    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+        handler.set_xport_chan_mboard(ch, ch/2);
+    }
+    handler.set_converter(id);
+    handler.set_converter_threads(uhd::device_addr_t("mboard_threads=1,mboard_ring=4"));
+
+    //check the received packets
+    size_t num_accum_samps = 0;
+    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
+    std::vector<std::complex<float> *> buffs(NCHANNELS);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
+    }
+    uhd::rx_metadata_t metadata;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        std::cout << "data check " << i << std::endl;
+        size_t num_samps_ret = handler.recv(
+            buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true
+        );
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK(not metadata.more_fragments);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec,
+            uhd::time_spec_t::from_ticks(START_TICKS, TICK_RATE) + uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+        BOOST_CHECK_EQUAL(num_samps_ret, 10 + i%10);
+        for (size_t ch = 0; ch < NCHANNELS; ch++){
+            BOOST_CHECK_CLOSE(buffs[ch][0].imag(), float(ch+1)/32767, 0.01);
+        }
+        num_accum_samps += num_samps_ret;
+    }
+
+    //subsequent receives should be a timeout
+    handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 0.1, true);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_correction){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 10;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const size_t NUM_SAMPS_PER_BUFF = 20;
+    static const size_t NCHANNELS = 3;
+
+    //the first sample of every channel is (256*(ch+1), ch+1)
+    std::vector<dummy_recv_xport_class> dummy_recv_xports(NCHANNELS, dummy_recv_xport_class("big"));
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        dummy_recv_xports[ch].push_back_packet(ifpi, uint32_t(ch+1));
+    }
+
+    //create the super receive packet handler, rotate channel 1 by 90 degrees
+    uhd::transport::sph::recv_packet_handler handler(NCHANNELS);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(100e6);
+    handler.set_samp_rate(10e6);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+    }
+    uhd::device_addr_t args;
+    args["correction_offset"] = "0.25";
+    args["correction_offset1"] = "0.5";
+    args["correction_gain1"] = "0 1";
+    handler.set_converter(id, args);
+
+    std::complex<float> mem[NUM_SAMPS_PER_BUFF*NCHANNELS];
+    std::vector<std::complex<float> *> buffs(NCHANNELS);
+    for (size_t ch = 0; ch < NCHANNELS; ch++){
+        buffs[ch] = &mem[ch*NUM_SAMPS_PER_BUFF];
+    }
+    uhd::rx_metadata_t metadata;
+    const size_t num_samps_ret = handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+    BOOST_CHECK_EQUAL(num_samps_ret, 10);
+
+    BOOST_CHECK_CLOSE(buffs[0][0].real(), 256.f/32767 + 0.25f, 0.01);
+    BOOST_CHECK_CLOSE(buffs[0][0].imag(), 1.f/32767, 0.01);
+    BOOST_CHECK_CLOSE(buffs[1][0].real(), -2.f/32767 + 0.5f, 0.01);
+    BOOST_CHECK_CLOSE(buffs[1][0].imag(), 512.f/32767, 0.01);
+    BOOST_CHECK_CLOSE(buffs[2][0].real(), 768.f/32767 + 0.25f, 0.01);
+    BOOST_CHECK_CLOSE(buffs[2][0].imag(), 3.f/32767, 0.01);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_nt_threshold){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 10;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const size_t NUM_PKTS_TO_TEST = 3;
+    static const size_t NUM_SAMPS_PER_BUFF = NUM_PKTS_TO_TEST*10;
+
+    //the first sample of every packet is (256*(pkt+1), pkt+1)
+    dummy_recv_xport_class dummy_recv_xport("big");
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        dummy_recv_xport.push_back_packet(ifpi, uint32_t(i+1));
+        ifpi.sob = false;
+        ifpi.packet_count++;
+        ifpi.tsf += 10;
+    }
+
+    //create the super receive packet handler, every buffer is above the threshold
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(100e6);
+    handler.set_samp_rate(100e6);
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    handler.set_converter(id, uhd::device_addr_t("nt_threshold=1"));
+
+    std::vector<std::complex<float> > buff(NUM_SAMPS_PER_BUFF);
+    uhd::rx_metadata_t metadata;
+    const size_t num_samps_ret = handler.recv(&buff.front(), buff.size(), metadata, 1.0, false);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+    BOOST_CHECK_EQUAL(num_samps_ret, NUM_SAMPS_PER_BUFF);
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        BOOST_CHECK_CLOSE(buff[i*10].real(), 256.f*(i+1)/32767, 0.01);
+        BOOST_CHECK_CLOSE(buff[i*10].imag(), float(i+1)/32767, 0.01);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_many_channels){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 200;
+    static const size_t NUM_SAMPS_PER_PKT = 16;
+    //up to one word wide, and beyond
+    static const size_t NCHANNELS[] = {1, 4, 16, 32, 64, 128};
+
+    for (size_t n = 0; n < sizeof(NCHANNELS)/sizeof(NCHANNELS[0]); n++){
+        const size_t nchan = NCHANNELS[n];
+
+        uhd::transport::vrt::if_packet_info_t ifpi;
+        ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+        ifpi.num_payload_words32 = NUM_SAMPS_PER_PKT;
+        ifpi.packet_count = 0;
+        ifpi.sob = true;
+        ifpi.eob = false;
+        ifpi.has_sid = false;
+        ifpi.has_cid = false;
+        ifpi.has_tsi = true;
+        ifpi.has_tsf = true;
+        ifpi.tsi = 0;
+        ifpi.tsf = 0;
+        ifpi.has_tlr = false;
+
+        std::vector<dummy_recv_xport_class> dummy_recv_xports(nchan, dummy_recv_xport_class("big"));
+
+        //generate a bunch of packets
+        for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+            for (size_t ch = 0; ch < nchan; ch++){
+                dummy_recv_xports[ch].push_back_packet(ifpi);
+            }
+            ifpi.packet_count++;
+            ifpi.tsf += NUM_SAMPS_PER_PKT*size_t(TICK_RATE/SAMP_RATE);
+        }
+
+        //create the super receive packet handler
+        uhd::transport::sph::recv_packet_handler handler(nchan);
+        handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+        handler.set_tick_rate(TICK_RATE);
+        handler.set_samp_rate(SAMP_RATE);
+        for (size_t ch = 0; ch < nchan; ch++){
+            handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xports[ch], _1));
+        }
+        handler.set_converter(id);
+
+        std::vector<std::complex<float> > mem(NUM_SAMPS_PER_PKT*nchan);
+        std::vector<std::complex<float> *> buffs(nchan);
+        for (size_t ch = 0; ch < nchan; ch++){
+            buffs[ch] = &mem[ch*NUM_SAMPS_PER_PKT];
+        }
+
+        //receive all packets, aligned across all channels
+        uhd::rx_metadata_t metadata;
+        for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+            const size_t num_samps_ret = handler.recv(
+                buffs, NUM_SAMPS_PER_PKT, metadata, 1.0, true
+            );
+            BOOST_REQUIRE_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+            BOOST_REQUIRE_EQUAL(num_samps_ret, NUM_SAMPS_PER_PKT);
+        }
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(
+            (NUM_PKTS_TO_TEST-1)*NUM_SAMPS_PER_PKT, SAMP_RATE));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_resampled){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 10;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const double HOST_RATE = 8e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //generate a bunch of packets
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        dummy_recv_xport.push_back_packet(ifpi);
+        ifpi.sob = false;
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    handler.set_converter(id, uhd::device_addr_t("host_rate=8e6,resampler_taps=16"));
+
+    //4 outputs per 5 inputs, timed on the host rate from the first sample less the filter delay
+    const uhd::time_spec_t start_time = uhd::time_spec_t(0.0) - uhd::time_spec_t((16*4 - 1)/(2.0*4)/SAMP_RATE);
+    size_t num_accum_samps = 0;
+    std::vector<std::complex<float> > buff(36);
+    uhd::rx_metadata_t metadata;
+    while (num_accum_samps < NUM_PKTS_TO_TEST*10*4/5){
+        const size_t num_samps_ret = handler.recv(
+            &buff.front(), buff.size(), metadata, 1.0, false
+        );
+        BOOST_REQUIRE_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_REQUIRE(num_samps_ret <= buff.size());
+        BOOST_CHECK(metadata.has_time_spec);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, start_time + uhd::time_spec_t::from_ticks(num_accum_samps, HOST_RATE));
+        num_accum_samps += num_samps_ret;
+    }
+    BOOST_CHECK_EQUAL(num_accum_samps, NUM_PKTS_TO_TEST*10*4/5);
+
+    //subsequent receives should be a timeout
+    BOOST_CHECK_EQUAL(handler.recv(&buff.front(), buff.size(), metadata, 1.0, true), 0U);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+
+    //the resampler runs on complex floats only
+    id.output_format = "sc16";
+    BOOST_CHECK_THROW(handler.set_converter(id, uhd::device_addr_t("host_rate=8e6")), uhd::value_error);
+}
+
+////////////////////////////////////////////////////////////////////////
+//! A host block work function, sets every sample to a constant
+static void host_work_set_samps(const uint32_t item, size_t *nsamps_total, void *buff, const size_t nsamps){
+    uint32_t *items = reinterpret_cast<uint32_t *>(buff);
+    for (size_t i = 0; i < nsamps; i++) items[i] = item;
+    *nsamps_total += nsamps;
+}
+
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_host_work){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //generate a bunch of packets
+    size_t num_samps_sent = 0;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        dummy_recv_xport.push_back_packet(ifpi);
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+        num_samps_sent += ifpi.num_payload_words32;
+    }
+
+    //create the super receive packet handler with a host block
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    handler.set_converter(id);
+    size_t num_samps_worked = 0;
+    const uint32_t item = uhd::htonx<uint32_t>((uint32_t(16384) << 16) | uint16_t(-16384));
+    handler.set_host_work(0, boost::bind(&host_work_set_samps, item, &num_samps_worked, _1, _2));
+
+    //receive in fragments, every sample passes through the host block once
+    size_t num_samps_recvd = 0;
+    std::vector<std::complex<float> > buff(7);
+    uhd::rx_metadata_t metadata;
+    while (num_samps_recvd < num_samps_sent){
+        const size_t num_samps_ret = handler.recv(
+            &buff.front(), buff.size(), metadata, 1.0, true
+        );
+        BOOST_REQUIRE_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        for (size_t j = 0; j < num_samps_ret; j++){
+            BOOST_CHECK_CLOSE(buff[j].real(), 0.5f, 0.01f);
+            BOOST_CHECK_CLOSE(buff[j].imag(), -0.5f, 0.01f);
+        }
+        num_samps_recvd += num_samps_ret;
+        BOOST_CHECK_EQUAL(num_samps_worked, num_samps_recvd);
+    }
+    BOOST_CHECK_EQUAL(num_samps_recvd, num_samps_sent);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_channelized){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 100;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 40;
+    static const size_t NUM_BANDS = 4;
+    static const size_t TAPS = 8;
+
+    //generate a bunch of packets
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        dummy_recv_xport.push_back_packet(ifpi);
+        ifpi.sob = false;
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler, the samples are all DC
+    uhd::transport::sph::recv_packet_streamer streamer(100);
+    streamer.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    streamer.set_tick_rate(TICK_RATE);
+    streamer.set_samp_rate(SAMP_RATE);
+    streamer.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    streamer.set_converter(id, uhd::device_addr_t("channelize=4,channelizer_taps=8"));
+    size_t num_samps_worked = 0;
+    const uint32_t item = uhd::htonx<uint32_t>((uint32_t(16384) << 16) | uint16_t(-16384));
+    streamer.set_host_work(0, boost::bind(&host_work_set_samps, item, &num_samps_worked, _1, _2));
+    BOOST_CHECK_EQUAL(streamer.get_num_channels(), NUM_BANDS);
+
+    //a quarter of the rate per channel, timed from the first sample less the filter delay
+    const uhd::time_spec_t start_time = uhd::time_spec_t(0.0) - uhd::time_spec_t((NUM_BANDS*TAPS - 1)/2.0/SAMP_RATE);
+    size_t num_accum_samps = 0;
+    std::vector<std::complex<float> > mem(NUM_BANDS*33);
+    std::vector<std::complex<float> *> buffs(NUM_BANDS);
+    for (size_t k = 0; k < NUM_BANDS; k++) buffs[k] = &mem[k*33];
+    uhd::rx_metadata_t metadata;
+    while (num_accum_samps < NUM_PKTS_TO_TEST*100/NUM_BANDS){
+        const size_t num_samps_ret = streamer.recv(buffs, 33, metadata, 1.0, false);
+        BOOST_REQUIRE_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_REQUIRE(num_samps_ret != 0 and num_samps_ret <= 33);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, start_time + uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE/NUM_BANDS));
+
+        //past the filter, DC is all in the first channel
+        for (size_t j = 0; j < num_samps_ret; j++){
+            if (num_accum_samps + j < TAPS) continue;
+            BOOST_CHECK_SMALL(std::abs(buffs[0][j] - std::complex<float>(0.5f, -0.5f)), 1e-3f);
+            for (size_t k = 1; k < NUM_BANDS; k++) BOOST_CHECK_SMALL(std::abs(buffs[k][j]), 1e-3f);
+        }
+        num_accum_samps += num_samps_ret;
+    }
+    BOOST_CHECK_EQUAL(num_accum_samps, NUM_PKTS_TO_TEST*100/NUM_BANDS);
+
+    //the channelizer runs on complex floats only, and not with the resampler
+    id.output_format = "sc16";
+    BOOST_CHECK_THROW(streamer.set_converter(id, uhd::device_addr_t("channelize=4")), uhd::value_error);
+    id.output_format = "fc32";
+    BOOST_CHECK_THROW(streamer.set_converter(id, uhd::device_addr_t("channelize=4,host_rate=8e6")), uhd::value_error);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_psd){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 100;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 10;
+    static const size_t PSD_SIZE = 16;
+
+    //generate a bunch of packets
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        dummy_recv_xport.push_back_packet(ifpi);
+        ifpi.sob = false;
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler, the samples are all DC
+    uhd::transport::sph::recv_packet_streamer streamer(100);
+    streamer.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    streamer.set_tick_rate(TICK_RATE);
+    streamer.set_samp_rate(SAMP_RATE);
+    streamer.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    uhd::rx_streamer::psd_t psd;
+    streamer.set_converter(id);
+    BOOST_CHECK_THROW(streamer.get_psd(psd, 0, 0.0), uhd::runtime_error);
+    streamer.set_converter(id, uhd::device_addr_t("psd_size=16,psd_averages=4,psd_rate=1e9"));
+    size_t num_samps_worked = 0;
+    const uint32_t item = uhd::htonx<uint32_t>((uint32_t(16384) << 16) | uint16_t(-16384));
+    streamer.set_host_work(0, boost::bind(&host_work_set_samps, item, &num_samps_worked, _1, _2));
+
+    //no spectrum before the samples
+    BOOST_CHECK(not streamer.get_psd(psd, 0, 0.0));
+    BOOST_CHECK_THROW(streamer.get_psd(psd, 1, 0.0), uhd::index_error);
+
+    std::vector<std::complex<float> > buff(64);
+    uhd::rx_metadata_t metadata;
+    BOOST_CHECK_EQUAL(streamer.recv(&buff.front(), buff.size(), metadata, 1.0, false), buff.size());
+    BOOST_REQUIRE_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+
+    //the first spectrum averages the first four frames, at the start of the stream
+    BOOST_REQUIRE(streamer.get_psd(psd, 0, 1.0));
+    BOOST_REQUIRE_EQUAL(psd.bins.size(), PSD_SIZE);
+    BOOST_CHECK_EQUAL(psd.num_averages, 4);
+    BOOST_CHECK(psd.has_time_spec);
+    BOOST_CHECK_TS_CLOSE(psd.time_spec, uhd::time_spec_t(0.0));
+
+    //DC of magnitude 1/sqrt(2) is in the middle bin
+    for (size_t i = 0; i < PSD_SIZE; i++){
+        if (i == PSD_SIZE/2) BOOST_CHECK_CLOSE(psd.bins[i], -3.01f, 1.0);
+        else if (i + 1 == PSD_SIZE/2 or i == PSD_SIZE/2 + 1) BOOST_CHECK_CLOSE(psd.bins[i], -9.03f, 1.0);
+        else BOOST_CHECK_LT(psd.bins[i], -80.0f);
+    }
+
+    //a spectrum is returned once
+    BOOST_CHECK(not streamer.get_psd(psd, 0, 0.0));
+
+    BOOST_CHECK_THROW(streamer.set_converter(id, uhd::device_addr_t("psd_size=16,psd_input=power")), uhd::value_error);
+}
+
+////////////////////////////////////////////////////////////////////////
+//! A host block work function, samples 0 to 9 and 350 to 419 of the stream are set, the rest are zero
+static void host_work_set_bursts(const uint32_t item, size_t *nsamps_total, void *buff, const size_t nsamps){
+    uint32_t *items = reinterpret_cast<uint32_t *>(buff);
+    for (size_t i = 0; i < nsamps; i++){
+        const size_t index = *nsamps_total + i;
+        items[i] = (index < 10 or (index >= 350 and index < 420))? item : 0;
+    }
+    *nsamps_total += nsamps;
+}
+
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_triggered){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 100;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 10;
+
+    //generate a bunch of packets
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        dummy_recv_xport.push_back_packet(ifpi);
+        ifpi.sob = false;
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler, with two bursts of DC in the samples
+    uhd::transport::sph::recv_packet_streamer streamer(100);
+    streamer.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    streamer.set_tick_rate(TICK_RATE);
+    streamer.set_samp_rate(SAMP_RATE);
+    streamer.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    streamer.set_converter(id, uhd::device_addr_t("trigger_level=-20,trigger_pre=20,trigger_post=30"));
+    size_t num_samps_worked = 0;
+    const uint32_t item = uhd::htonx<uint32_t>((uint32_t(16384) << 16) | uint16_t(-16384));
+    streamer.set_host_work(0, boost::bind(&host_work_set_bursts, item, &num_samps_worked, _1, _2));
+
+    //the first burst has no pre-roll, the second is received in pieces
+    static const size_t burst_starts[] = {0, 330};
+    static const size_t burst_ends[] = {40, 450};
+    std::vector<std::complex<float> > buff(50);
+    uhd::rx_metadata_t metadata;
+    for (size_t b = 0; b < 2; b++){
+        size_t index = burst_starts[b];
+        while (index < burst_ends[b]){
+            const size_t num_samps_ret = streamer.recv(&buff.front(), buff.size(), metadata, 1.0, false);
+            BOOST_REQUIRE_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+            BOOST_REQUIRE(num_samps_ret != 0);
+            BOOST_CHECK_EQUAL(metadata.start_of_burst, index == burst_starts[b]);
+            BOOST_CHECK(metadata.has_time_spec);
+            BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(index, SAMP_RATE));
+            for (size_t j = 0; j < num_samps_ret; j++, index++){
+                const bool loud = index < 10 or (index >= 350 and index < 420);
+                const std::complex<float> expected = loud? std::complex<float>(0.5f, -0.5f) : std::complex<float>(0.0f);
+                BOOST_CHECK_SMALL(std::abs(buff[j] - expected), 1e-4f);
+            }
+            BOOST_CHECK_EQUAL(metadata.end_of_burst, index == burst_ends[b]);
+        }
+        BOOST_CHECK_EQUAL(index, burst_ends[b]);
+    }
+
+    //the rest is quiet
+    BOOST_CHECK_EQUAL(streamer.recv(&buff.front(), buff.size(), metadata, 1.0, false), 0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+    BOOST_CHECK_EQUAL(num_samps_worked, NUM_PKTS_TO_TEST*100);
+
+    //the detector needs a format it knows
+    id.output_format = "sc16";
+    BOOST_CHECK_NO_THROW(streamer.set_converter(id, uhd::device_addr_t("trigger_level=-20")));
+}
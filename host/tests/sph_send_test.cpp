@@ -104,6 +104,7 @@ BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_one_packet_mode){
     handler.set_samp_rate(SAMP_RATE);
     handler.set_xport_chan_get_buff(0, boost::bind(&dummy_send_xport_class::get_send_buff, &dummy_send_xport, _1));
     handler.set_converter(id);
+    handler.warm_start(uhd::device_addr_t("warm_start=1,warm_start_lock=none"), 20);
     handler.set_max_samples_per_packet(20);
 
     //allocate metadata and buffer
@@ -190,3 +191,297 @@ BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_full_buffer_mode){
         num_accum_samps += ifpi.num_payload_words32;
     }
 }
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_borrowed){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs = 1;
+
+    dummy_send_xport_class dummy_send_xport("big");
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //create the super send packet handler
+    uhd::transport::sph::send_packet_handler handler(1);
+    handler.set_vrt_packer(&uhd::transport::vrt::if_hdr_pack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_send_xport_class::get_send_buff, &dummy_send_xport, _1));
+    handler.set_converter(id);
+    handler.set_max_samples_per_packet(20);
+
+    //nothing was borrowed yet
+    BOOST_CHECK_THROW(handler.send_borrowed(10), uhd::runtime_error);
+
+    //only the first packet has a time spec, the header length changes
+    std::vector<void *> buffs;
+    uhd::tx_metadata_t metadata;
+    metadata.has_time_spec = true;
+    metadata.time_spec = uhd::time_spec_t(0.0);
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        metadata.start_of_burst = (i == 0);
+        metadata.end_of_burst = (i == NUM_PKTS_TO_TEST-1);
+        metadata.has_time_spec = (i == 0);
+        BOOST_CHECK_EQUAL(handler.get_borrowed_buffs(buffs, metadata, 1.0), 20U);
+        BOOST_REQUIRE_EQUAL(buffs.size(), 1U);
+        std::fill_n(static_cast<uint32_t *>(buffs[0]), 10 + i%10, uint32_t(i));
+        BOOST_CHECK_EQUAL(handler.send_borrowed(10 + i%10), 10 + i%10);
+    }
+
+    //check the sent packets
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        std::cout << "data check " << i << std::endl;
+        dummy_send_xport.pop_front_packet(ifpi);
+        BOOST_CHECK_EQUAL(ifpi.num_payload_words32, 10+i%10);
+        BOOST_CHECK_EQUAL(ifpi.has_tsf, i == 0);
+        BOOST_CHECK_EQUAL(ifpi.packet_count, i%16);
+        BOOST_CHECK_EQUAL(ifpi.sob, i == 0);
+        BOOST_CHECK_EQUAL(ifpi.eob, i == NUM_PKTS_TO_TEST-1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+//! A host block work function, counts the samples and packets
+static void host_work_count(size_t *nsamps_total, size_t *npkts_total, void *, const size_t nsamps){
+    *nsamps_total += nsamps;
+    (*npkts_total)++;
+}
+
+BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_host_work){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs = 1;
+
+    dummy_send_xport_class dummy_send_xport("big");
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //create the super send packet handler with a host block
+    uhd::transport::sph::send_packet_handler handler(1);
+    handler.set_vrt_packer(&uhd::transport::vrt::if_hdr_pack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_send_xport_class::get_send_buff, &dummy_send_xport, _1));
+    handler.set_converter(id);
+    handler.set_max_samples_per_packet(20);
+    size_t num_samps_worked = 0, num_pkts_worked = 0;
+    handler.set_host_work(0, boost::bind(&host_work_count, &num_samps_worked, &num_pkts_worked, _1, _2));
+
+    //every packet passes through the host block once
+    std::vector<std::complex<float> > buff(20);
+    uhd::tx_metadata_t metadata;
+    size_t num_accum_samps = 0;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        metadata.start_of_burst = (i == 0);
+        metadata.end_of_burst = (i == NUM_PKTS_TO_TEST-1);
+        num_accum_samps += handler.send(
+            &buff.front(), 10 + i%10, metadata, 1.0
+        );
+        BOOST_CHECK_EQUAL(num_samps_worked, num_accum_samps);
+        BOOST_CHECK_EQUAL(num_pkts_worked, i+1);
+    }
+}
+
+/***********************************************************************
+ * Flow control credits: every packet takes one until the test acks it
+ **********************************************************************/
+struct dummy_fc_credits{
+    dummy_fc_credits(dummy_send_xport_class &xport, const size_t window):
+        _xport(xport), credits(window) {}
+
+    uhd::transport::managed_send_buffer::sptr get_send_buff(double timeout){
+        if (credits == 0) return uhd::transport::managed_send_buffer::sptr();
+        credits--;
+        return _xport.get_send_buff(timeout);
+    }
+
+    size_t get_credits(void){
+        return credits;
+    }
+
+    dummy_send_xport_class &_xport;
+    size_t credits;
+};
+
+BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_prefill){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs = 1;
+
+    dummy_send_xport_class dummy_send_xport("big");
+    static const size_t WINDOW = 8;
+    dummy_fc_credits fc_credits(dummy_send_xport, WINDOW);
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+
+    //create the send packet streamer with the flow control credits
+    uhd::transport::sph::send_packet_streamer streamer(20);
+    streamer.resize(1);
+    streamer.set_vrt_packer(&uhd::transport::vrt::if_hdr_pack_be);
+    streamer.set_tick_rate(TICK_RATE);
+    streamer.set_samp_rate(SAMP_RATE);
+    streamer.set_xport_chan_get_buff(0, boost::bind(&dummy_fc_credits::get_send_buff, &fc_credits, _1));
+    streamer.set_converter(id);
+
+    uhd::tx_streamer &tx_stream = streamer;
+    BOOST_CHECK_THROW(tx_stream.get_buffer_status(0), uhd::not_implemented_error);
+    streamer.set_xport_chan_fc_credits(0, boost::bind(&dummy_fc_credits::get_credits, &fc_credits), WINDOW);
+
+    uhd::tx_streamer::buffer_status_t status = tx_stream.get_buffer_status(0);
+    BOOST_CHECK_EQUAL(status.capacity_pkts, WINDOW);
+    BOOST_CHECK_EQUAL(status.buffered_pkts, 0);
+    BOOST_CHECK_EQUAL(status.capacity_samps, WINDOW*20);
+    BOOST_CHECK_EQUAL(status.free_samps, WINDOW*20);
+
+    //the prefill sends what the device buffer takes, in a timed burst
+    std::vector<std::complex<float> > buff(500);
+    const uhd::time_spec_t start_time(1.5);
+    BOOST_CHECK_EQUAL(tx_stream.prefill(&buff.front(), buff.size(), start_time, 0.0), WINDOW*20);
+    status = tx_stream.get_buffer_status(0);
+    BOOST_CHECK_EQUAL(status.buffered_pkts, WINDOW);
+    BOOST_CHECK_EQUAL(status.buffered_samps, WINDOW*20);
+    BOOST_CHECK_EQUAL(status.free_samps, 0);
+
+    for (size_t i = 0; i < WINDOW; i++){
+        uhd::transport::vrt::if_packet_info_t ifpi;
+        dummy_send_xport.pop_front_packet(ifpi);
+        BOOST_CHECK_EQUAL(ifpi.num_payload_words32, 20);
+        if (i == 0) {
+            BOOST_CHECK(ifpi.has_tsf);
+            BOOST_CHECK_EQUAL(ifpi.tsf, start_time.to_ticks(TICK_RATE));
+        }
+        BOOST_CHECK(not ifpi.eob);
+    }
+
+    //two acked packets make room again
+    fc_credits.credits += 2;
+    status = tx_stream.get_buffer_status(0);
+    BOOST_CHECK_EQUAL(status.buffered_pkts, WINDOW-2);
+    BOOST_CHECK_EQUAL(status.free_samps, 40);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_burst_ack){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs = 1;
+
+    dummy_send_xport_class dummy_send_xport("big");
+
+    uhd::transport::sph::send_packet_streamer streamer(20);
+    streamer.resize(1);
+    streamer.set_vrt_packer(&uhd::transport::vrt::if_hdr_pack_be);
+    streamer.set_tick_rate(100e6);
+    streamer.set_samp_rate(10e6);
+    streamer.set_xport_chan_get_buff(0, boost::bind(&dummy_send_xport_class::get_send_buff, &dummy_send_xport, _1));
+    streamer.set_converter(id);
+
+    uhd::tx_streamer &tx_stream = streamer;
+    BOOST_CHECK_THROW(tx_stream.wait_for_burst_ack(0, 0.0), uhd::not_implemented_error);
+    uhd::transport::burst_ack_tracker::sptr burst_acks(new uhd::transport::burst_ack_tracker(1));
+    streamer.set_burst_ack_tracker(burst_acks);
+
+    //a fragmented burst and an empty end of burst count once each
+    std::vector<std::complex<float> > buff(50);
+    uhd::tx_metadata_t metadata;
+    metadata.start_of_burst = true;
+    metadata.end_of_burst = true;
+    BOOST_CHECK_EQUAL(tx_stream.send(&buff.front(), buff.size(), metadata, 1.0), buff.size());
+    BOOST_CHECK_EQUAL(tx_stream.get_num_bursts_sent(), 1);
+    metadata.start_of_burst = false;
+    tx_stream.send(&buff.front(), 0, metadata, 1.0);
+    BOOST_CHECK_EQUAL(tx_stream.get_num_bursts_sent(), 2);
+
+    //the acks arrive in order
+    BOOST_CHECK(not tx_stream.wait_for_burst_ack(0, 0.01));
+    burst_acks->notify_ack(0);
+    BOOST_CHECK(tx_stream.wait_for_burst_ack(0, 0.0));
+    BOOST_CHECK(not tx_stream.wait_for_burst_ack(1, 0.01));
+    boost::thread ack_thread(boost::bind(&uhd::transport::burst_ack_tracker::notify_ack, burst_acks, 0));
+    BOOST_CHECK(tx_stream.wait_for_burst_ack(1, 1.0));
+    ack_thread.join();
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_chan_threads){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs = 1;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_CHANS = 4;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //create the super send packet handler with a worker per channel
+    std::vector<boost::shared_ptr<dummy_send_xport_class> > dummy_send_xports;
+    uhd::transport::sph::send_packet_handler handler(NUM_CHANS);
+    handler.set_vrt_packer(&uhd::transport::vrt::if_hdr_pack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    for (size_t ch = 0; ch < NUM_CHANS; ch++){
+        dummy_send_xports.push_back(boost::shared_ptr<dummy_send_xport_class>(new dummy_send_xport_class("big")));
+        handler.set_xport_chan_get_buff(ch, boost::bind(&dummy_send_xport_class::get_send_buff, dummy_send_xports.back(), _1));
+    }
+    handler.set_converter(id);
+    handler.set_max_samples_per_packet(20);
+    //a short spin, so the workers also sleep between the calls
+    handler.set_converter_threads(uhd::device_addr_t("chan_threads=1,chan_spin_us=10"));
+
+    //allocate metadata and buffers
+    std::vector<std::vector<std::complex<float> > > buffs(NUM_CHANS, std::vector<std::complex<float> >(20));
+    std::vector<const void *> buff_ptrs;
+    for (size_t ch = 0; ch < NUM_CHANS; ch++) buff_ptrs.push_back(&buffs[ch].front());
+    uhd::tx_metadata_t metadata;
+    metadata.has_time_spec = true;
+    metadata.time_spec = uhd::time_spec_t(0.0);
+
+    //generate the test data
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        metadata.start_of_burst = (i == 0);
+        metadata.end_of_burst = (i == NUM_PKTS_TO_TEST-1);
+        const size_t num_sent = handler.send(buff_ptrs, 10 + i%10, metadata, 1.0);
+        BOOST_CHECK_EQUAL(num_sent, 10 + i%10);
+        metadata.time_spec += uhd::time_spec_t(0, num_sent, SAMP_RATE);
+        if (i % 10 == 0) boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    }
+
+    //every channel has the same packets
+    for (size_t ch = 0; ch < NUM_CHANS; ch++){
+        size_t num_accum_samps = 0;
+        uhd::transport::vrt::if_packet_info_t ifpi;
+        for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+            dummy_send_xports[ch]->pop_front_packet(ifpi);
+            BOOST_CHECK_EQUAL(ifpi.num_payload_words32, 10+i%10);
+            BOOST_CHECK_EQUAL(ifpi.packet_count, i%16);
+            BOOST_CHECK(ifpi.has_tsf);
+            BOOST_CHECK_EQUAL(ifpi.tsf, num_accum_samps*TICK_RATE/SAMP_RATE);
+            BOOST_CHECK_EQUAL(ifpi.sob, i == 0);
+            BOOST_CHECK_EQUAL(ifpi.eob, i == NUM_PKTS_TO_TEST-1);
+            num_accum_samps += ifpi.num_payload_words32;
+        }
+    }
+    BOOST_CHECK_EQUAL(handler.get_stats().packets, NUM_CHANS*NUM_PKTS_TO_TEST);
+}
@@ -0,0 +1,202 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/stream_reactor.hpp>
+#include <uhd/exception.hpp>
+#include <deque>
+#include <vector>
+
+static const double SAMP_RATE = 1e6;
+static const size_t SPP = 100;
+
+/***********************************************************************
+ * A dummy rx streamer: packets of SPP samples holding their index,
+ * with a burst ending at eob_samps
+ **********************************************************************/
+class dummy_rx_streamer : public uhd::rx_streamer{
+public:
+    dummy_rx_streamer(const size_t num_samps_total, const size_t eob_samps):
+        _num_samps_total(num_samps_total), _eob_samps(eob_samps), _num_samps(0)
+    {
+        /* NOP */
+    }
+
+    size_t get_num_channels(void) const{
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return SPP;
+    }
+
+    size_t recv(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double = 0.1,
+        const bool = false
+    ){
+        metadata.reset();
+        if (_num_samps == _num_samps_total){
+            metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_TIMEOUT;
+            return 0;
+        }
+        size_t nsamps = std::min(std::min(nsamps_per_buff, SPP), _num_samps_total - _num_samps);
+        if (_num_samps < _eob_samps) nsamps = std::min(nsamps, _eob_samps - _num_samps);
+        uint32_t *samps = reinterpret_cast<uint32_t *>(buffs[0]);
+        for (size_t i = 0; i < nsamps; i++) samps[i] = uint32_t(_num_samps + i);
+        metadata.has_time_spec = true;
+        metadata.time_spec = uhd::time_spec_t::from_ticks(_num_samps, SAMP_RATE);
+        _num_samps += nsamps;
+        metadata.end_of_burst = (_num_samps == _eob_samps);
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const uhd::stream_cmd_t &){
+        /* NOP */
+    }
+
+private:
+    const size_t _num_samps_total;
+    const size_t _eob_samps;
+    size_t _num_samps;
+};
+
+/***********************************************************************
+ * A dummy tx streamer: takes up to SPP samples per call
+ **********************************************************************/
+class dummy_tx_streamer : public uhd::tx_streamer{
+public:
+    size_t get_num_channels(void) const{
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return SPP;
+    }
+
+    size_t send(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const uhd::tx_metadata_t &metadata,
+        const double = 0.1
+    ){
+        const size_t nsamps = std::min(nsamps_per_buff, SPP);
+        const uint32_t *samps = reinterpret_cast<const uint32_t *>(buffs[0]);
+        for (size_t i = 0; i < nsamps; i++) samples.push_back(samps[i]);
+        calls.push_back(metadata);
+        return nsamps;
+    }
+
+    bool recv_async_msg(uhd::async_metadata_t &metadata, const double = 0.1){
+        if (msgs.empty()) return false;
+        metadata = msgs.front();
+        msgs.pop_front();
+        return true;
+    }
+
+    std::vector<uint32_t> samples;
+    std::vector<uhd::tx_metadata_t> calls;
+    std::deque<uhd::async_metadata_t> msgs;
+};
+
+BOOST_AUTO_TEST_CASE(test_stream_reactor_recv){
+    boost::shared_ptr<dummy_rx_streamer> rx_stream(new dummy_rx_streamer(850, 350));
+    uhd::stream_reactor::sptr reactor = uhd::stream_reactor::make();
+    const size_t index = reactor->add(rx_stream, uhd::stream_args_t("sc16"));
+
+    //queue every receive up front, the burst ends in the second one
+    std::vector<std::vector<uint32_t> > buffs(4, std::vector<uint32_t>(250));
+    std::vector<boost::shared_future<uhd::stream_reactor::recv_result_t> > results;
+    for (size_t i = 0; i < buffs.size(); i++){
+        results.push_back(reactor->async_recv(index, &buffs[i].front(), buffs[i].size()));
+    }
+    results.push_back(reactor->async_recv(index, &buffs[0].front(), 10, 0.01, true));
+    while (not results.back().is_ready()) reactor->run(0.1);
+
+    static const size_t expected_nsamps[] = {250, 100, 250, 250};
+    size_t num_accum_samps = 0;
+    for (size_t i = 0; i < buffs.size(); i++){
+        const uhd::stream_reactor::recv_result_t result = results[i].get();
+        BOOST_CHECK_EQUAL(result.metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK_EQUAL(result.metadata.time_spec.to_ticks(SAMP_RATE), (long long)num_accum_samps);
+        BOOST_CHECK_EQUAL(result.metadata.end_of_burst, i == 1);
+        BOOST_CHECK_EQUAL(result.nsamps, expected_nsamps[i]);
+        if (i != 0){
+            BOOST_CHECK_EQUAL(buffs[i][0], num_accum_samps);
+            BOOST_CHECK_EQUAL(buffs[i][result.nsamps-1], num_accum_samps + result.nsamps - 1);
+        }
+        num_accum_samps += result.nsamps;
+    }
+
+    //the samples ran out, so the last receive timed out
+    BOOST_CHECK_EQUAL(results.back().get().nsamps, 0U);
+    BOOST_CHECK_EQUAL(results.back().get().metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+    BOOST_CHECK_EQUAL(reactor->run(0.1), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_reactor_send){
+    boost::shared_ptr<dummy_tx_streamer> tx_stream(new dummy_tx_streamer());
+    uhd::stream_reactor::sptr reactor = uhd::stream_reactor::make();
+    const size_t index = reactor->add(tx_stream, uhd::stream_args_t("sc16"));
+
+    std::vector<uint32_t> buff(250);
+    for (size_t i = 0; i < buff.size(); i++) buff[i] = uint32_t(i);
+    uhd::tx_metadata_t metadata;
+    metadata.start_of_burst = true;
+    metadata.end_of_burst = true;
+    metadata.has_time_spec = true;
+    metadata.time_spec = uhd::time_spec_t(1.0);
+    boost::shared_future<size_t> sent = reactor->async_send(index, &buff.front(), buff.size(), metadata);
+    while (not sent.is_ready()) reactor->run(0.1);
+    BOOST_CHECK_EQUAL(sent.get(), buff.size());
+    BOOST_CHECK(tx_stream->samples == buff);
+
+    //the remainder continues the burst
+    BOOST_REQUIRE_EQUAL(tx_stream->calls.size(), 3U);
+    for (size_t i = 0; i < tx_stream->calls.size(); i++){
+        BOOST_CHECK_EQUAL(tx_stream->calls[i].start_of_burst, i == 0);
+        BOOST_CHECK_EQUAL(tx_stream->calls[i].has_time_spec, i == 0);
+        BOOST_CHECK(tx_stream->calls[i].end_of_burst);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_reactor_async_msgs){
+    boost::shared_ptr<dummy_tx_streamer> tx_stream(new dummy_tx_streamer());
+    uhd::stream_reactor::sptr reactor = uhd::stream_reactor::make();
+    reactor->add(boost::shared_ptr<dummy_rx_streamer>(new dummy_rx_streamer(0, 0)), uhd::stream_args_t("sc16"));
+    const size_t index = reactor->add(tx_stream, uhd::stream_args_t("sc16"));
+    BOOST_CHECK_THROW(reactor->async_recv_async_msg(0), uhd::index_error);
+    BOOST_CHECK_THROW(reactor->async_recv_async_msg(2), uhd::index_error);
+
+    boost::shared_future<uhd::stream_reactor::async_msg_result_t> first = reactor->async_recv_async_msg(index);
+    boost::shared_future<uhd::stream_reactor::async_msg_result_t> second = reactor->async_recv_async_msg(index, 0.05);
+    BOOST_CHECK_EQUAL(reactor->poll(), 0U);
+
+    uhd::async_metadata_t msg;
+    msg.event_code = uhd::async_metadata_t::EVENT_CODE_BURST_ACK;
+    tx_stream->msgs.push_back(msg);
+    BOOST_CHECK(reactor->run(0.1) >= 1);
+    BOOST_REQUIRE(first.is_ready());
+    BOOST_CHECK(first.get().valid);
+    BOOST_CHECK_EQUAL(first.get().metadata.event_code, uhd::async_metadata_t::EVENT_CODE_BURST_ACK);
+
+    //no other message comes
+    while (not second.is_ready()) reactor->run(0.1);
+    BOOST_CHECK(not second.get().valid);
+}
@@ -0,0 +1,164 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <uhd/utils/msg_task.hpp>
+#include <uhd/utils/thread_priority.hpp>
+#include <uhd/exception.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace uhd;
+
+static bool count_calls(boost::atomic<size_t> *calls, const size_t busy_calls){
+    //report work for the first calls, then go idle
+    return ++(*calls) <= busy_calls;
+}
+
+static bool throw_once(boost::atomic<size_t> *calls){
+    ++(*calls);
+    throw std::runtime_error("pooled task error");
+}
+
+static void sleep_ms(const long ms){
+    boost::this_thread::sleep(boost::posix_time::milliseconds(ms));
+}
+
+static boost::optional<msg_task::msg_type_t> strand_msgs(size_t *count){
+    //strand two messages each for SIDs 0..3, then idle
+    if (*count >= 8){
+        sleep_ms(10);
+        return boost::none;
+    }
+    const uint32_t sid = uint32_t(*count % 4);
+    msg_task::msg_payload_t payload(1, uint8_t((*count)++));
+    return std::make_pair(sid, payload);
+}
+
+BOOST_AUTO_TEST_CASE(test_pooled_task_busy_then_idle){
+    boost::atomic<size_t> calls(0);
+    pooled_task::sptr task = pooled_task::make(boost::bind(&count_calls, &calls, 100), 10.0);
+    sleep_ms(200);
+    //the busy calls run back to back, then the long period holds the task
+    BOOST_CHECK_EQUAL(calls.load(), size_t(101));
+    task->notify();
+    sleep_ms(100);
+    BOOST_CHECK_EQUAL(calls.load(), size_t(102));
+    task.reset();
+    sleep_ms(50);
+    BOOST_CHECK_EQUAL(calls.load(), size_t(102));
+}
+
+BOOST_AUTO_TEST_CASE(test_pooled_task_many_tasks){
+    //many more tasks than pool threads, all of them get called
+    std::vector<boost::shared_ptr<boost::atomic<size_t> > > calls;
+    std::vector<pooled_task::sptr> tasks;
+    for (size_t i = 0; i < 32; i++){
+        calls.push_back(boost::shared_ptr<boost::atomic<size_t> >(new boost::atomic<size_t>(0)));
+        tasks.push_back(pooled_task::make(boost::bind(&count_calls, calls.back().get(), 0), 0.01));
+    }
+    sleep_ms(200);
+    tasks.clear();
+    for (size_t i = 0; i < calls.size(); i++){
+        BOOST_CHECK(calls[i]->load() >= 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_pooled_task_error){
+    boost::atomic<size_t> calls(0);
+    pooled_task::sptr task = pooled_task::make(boost::bind(&throw_once, &calls), 0.001);
+    sleep_ms(100);
+    //a task that throws is not called again
+    BOOST_CHECK_EQUAL(calls.load(), size_t(1));
+}
+
+BOOST_AUTO_TEST_CASE(test_msg_task_dump_queue){
+    size_t count = 0;
+    msg_task::sptr task = msg_task::make(boost::bind(&strand_msgs, &count));
+    sleep_ms(100);
+    BOOST_CHECK(task->get_msg_from_dump_queue(4).empty());
+    //messages come back per SID in the order they were stranded
+    for (uint32_t sid = 0; sid < 4; sid++){
+        msg_task::msg_payload_t first = task->get_msg_from_dump_queue(sid);
+        msg_task::msg_payload_t second = task->get_msg_from_dump_queue(sid);
+        BOOST_REQUIRE_EQUAL(first.size(), size_t(1));
+        BOOST_REQUIRE_EQUAL(second.size(), size_t(1));
+        BOOST_CHECK_EQUAL(first[0], sid);
+        BOOST_CHECK_EQUAL(second[0], sid + 4);
+        BOOST_CHECK(task->get_msg_from_dump_queue(sid).empty());
+    }
+}
+
+static boost::mutex started_roles_mutex;
+static std::vector<std::string> started_roles;
+
+static void record_role(const std::string &role){
+    boost::mutex::scoped_lock lock(started_roles_mutex);
+    started_roles.push_back(role);
+}
+
+static void idle(void){
+    sleep_ms(10);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_config){
+    device_addr_t args;
+    args["thread_muxed_demux_cpus"] = "0:1";
+    args["thread_muxed_demux_sched"] = "FIFO";
+    args["thread_rx_convert_prio"] = "0.25";
+    args["thread_recv_offload_mmcss"] = "Pro Audio";
+    args["type"] = "x300";
+    set_thread_config(args);
+
+    const thread_config_t demux = get_thread_config("muxed_demux");
+    BOOST_REQUIRE_EQUAL(demux.cpus.size(), size_t(2));
+    BOOST_CHECK_EQUAL(demux.cpus[1], size_t(1));
+    BOOST_CHECK_EQUAL(demux.sched, THREAD_SCHED_FIFO);
+    //a priority alone selects realtime scheduling
+    const thread_config_t convert = get_thread_config("rx_convert");
+    BOOST_CHECK_EQUAL(convert.sched, THREAD_SCHED_RR);
+    BOOST_CHECK_CLOSE(convert.priority, 0.25f, 1e-3);
+    BOOST_CHECK_EQUAL(get_thread_config("recv_offload").mmcss_task, "Pro Audio");
+    BOOST_CHECK(get_thread_config("task").cpus.empty());
+    BOOST_CHECK_EQUAL(get_thread_config("task").sched, THREAD_SCHED_INHERIT);
+    BOOST_CHECK(get_thread_config("task").mmcss_task.empty());
+
+    device_addr_t bad_args;
+    bad_args["thread_task_sched"] = "batch";
+    BOOST_CHECK_THROW(set_thread_config(bad_args), uhd::value_error);
+    bad_args = device_addr_t();
+    bad_args["thread_task_prio"] = "2.0";
+    BOOST_CHECK_THROW(set_thread_config(bad_args), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_start_hook){
+    set_thread_start_hook(&record_role);
+    task::sptr task = task::make(&idle, "test_role");
+    sleep_ms(50);
+    task.reset();
+    set_thread_start_hook(thread_start_hook_t());
+
+    boost::mutex::scoped_lock lock(started_roles_mutex);
+    BOOST_REQUIRE_EQUAL(started_roles.size(), size_t(1));
+    BOOST_CHECK_EQUAL(started_roles[0], "test_role");
+}
@@ -0,0 +1,102 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/transport/tcp_zero_copy.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/exception.hpp>
+#include <boost/asio.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/cstdint.hpp>
+#include <cstring>
+#include <vector>
+
+using namespace uhd::transport;
+namespace asio = boost::asio;
+
+//! Append a little endian CHDR packet of len bytes, a data packet unless cmd
+static void add_chdr_packet(std::vector<char> &stream, const size_t len, const bool eob, const bool cmd = false){
+    boost::uint32_t word = boost::uint32_t(len) | (eob? (1 << 28) : 0) | (cmd? (2u << 30) : 0);
+    word = uhd::htowx(word);
+    const size_t offset = stream.size();
+    stream.resize(offset + len, char(len));
+    std::memcpy(&stream[offset], &word, sizeof(word));
+}
+
+BOOST_AUTO_TEST_CASE(test_tcp_zero_copy_framed){
+    asio::io_service io_service;
+    asio::ip::tcp::acceptor acceptor(io_service, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    const std::string port = boost::lexical_cast<std::string>(acceptor.local_endpoint().port());
+
+    zero_copy_if::sptr xport = tcp_zero_copy::make("127.0.0.1", port,
+        uhd::device_addr_t("tcp_framing=chdr_le,recv_frame_size=256,send_frame_size=256,tcp_recv_chunk=600"));
+    asio::ip::tcp::socket peer(io_service);
+    acceptor.accept(peer);
+
+    //packets of any length arrive whole, across the chunks of the reader
+    std::vector<char> stream;
+    std::vector<size_t> lens;
+    for (size_t i = 0; i < 20; i++){
+        lens.push_back(8 + (i*37)%240);
+        add_chdr_packet(stream, lens.back(), false);
+    }
+    asio::write(peer, asio::buffer(&stream.front(), stream.size()/3));
+    asio::write(peer, asio::buffer(&stream[stream.size()/3], stream.size() - stream.size()/3));
+    for (size_t i = 0; i < lens.size(); i++){
+        managed_recv_buffer::sptr buff = xport->get_recv_buff(1.0);
+        BOOST_REQUIRE(buff);
+        BOOST_CHECK_EQUAL(buff->size(), lens[i]);
+        BOOST_CHECK_EQUAL(buff->cast<const char *>()[buff->size()-1], char(lens[i]));
+    }
+    BOOST_CHECK(not xport->get_recv_buff(0.01));
+
+    //data packets wait for the end of the burst, and go out unpadded
+    for (size_t i = 0; i < 3; i++){
+        managed_send_buffer::sptr buff = xport->get_send_buff(1.0);
+        BOOST_REQUIRE(buff);
+        std::vector<char> packet;
+        add_chdr_packet(packet, 40, i == 2);
+        std::memcpy(buff->cast<void *>(), &packet.front(), packet.size());
+        buff->commit(packet.size());
+        buff.reset();
+        BOOST_CHECK_EQUAL(peer.available(), (i == 2)? 120 : 0);
+    }
+
+    //a command packet is not held back either
+    managed_send_buffer::sptr buff = xport->get_send_buff(1.0);
+    std::vector<char> packet;
+    add_chdr_packet(packet, 16, false, true);
+    std::memcpy(buff->cast<void *>(), &packet.front(), packet.size());
+    buff->commit(packet.size());
+    buff.reset();
+    std::vector<char> received(136);
+    asio::read(peer, asio::buffer(received));
+    BOOST_CHECK_EQUAL(received[136 - 1], char(16));
+
+    //a length which does not fit a frame means the framing is lost
+    stream.clear();
+    add_chdr_packet(stream, 300, false);
+    asio::write(peer, asio::buffer(stream));
+    BOOST_CHECK_THROW(xport->get_recv_buff(1.0), uhd::io_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_tcp_zero_copy_bad_framing){
+    asio::io_service io_service;
+    asio::ip::tcp::acceptor acceptor(io_service, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    const std::string port = boost::lexical_cast<std::string>(acceptor.local_endpoint().port());
+    BOOST_CHECK_THROW(tcp_zero_copy::make("127.0.0.1", port, uhd::device_addr_t("tcp_framing=foo")), uhd::value_error);
+}
@@ -0,0 +1,216 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/usrp/tdd_scheduler.hpp>
+#include <uhd/exception.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+#include <deque>
+#include <vector>
+
+static const double RATE = 1e6;
+
+/***********************************************************************
+ * A dummy device which runs the timed stream commands in its queue:
+ * each sample is the tick count of its time
+ **********************************************************************/
+class dummy_rx_streamer : public uhd::rx_streamer{
+public:
+    dummy_rx_streamer(void):
+        max_queue_depth(0), overflow_tick(-1), _remaining(0), _tick(0)
+    {
+        /* NOP */
+    }
+
+    size_t get_num_channels(void) const{
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return 64;
+    }
+
+    size_t recv(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double = 0.1,
+        const bool = false
+    ){
+        metadata.reset();
+        if (_remaining == 0){
+            if (_queue.empty()){
+                metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_TIMEOUT;
+                return 0;
+            }
+            _remaining = _queue.front().num_samps;
+            _tick = _queue.front().time_spec.to_ticks(RATE);
+            _queue.pop_front();
+        }
+
+        if (overflow_tick >= 0 and _tick >= overflow_tick){
+            overflow_tick = -1;
+            _remaining = 0;
+            metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_OVERFLOW;
+            metadata.has_time_spec = true;
+            metadata.time_spec = uhd::time_spec_t::from_ticks(_tick, RATE);
+            return 0;
+        }
+
+        const size_t nsamps = std::min(std::min(nsamps_per_buff, _remaining), get_max_num_samps());
+        boost::uint64_t *samps = reinterpret_cast<boost::uint64_t *>(buffs[0]);
+        metadata.has_time_spec = true;
+        metadata.time_spec = uhd::time_spec_t::from_ticks(_tick, RATE);
+        for (size_t i = 0; i < nsamps; i++) samps[i] = boost::uint64_t(_tick++);
+        _remaining -= nsamps;
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const uhd::stream_cmd_t &stream_cmd){
+        if (stream_cmd.stream_mode == uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS){
+            _queue.clear();
+            _remaining = 0;
+            return;
+        }
+        _queue.push_back(stream_cmd);
+        max_queue_depth = std::max(max_queue_depth, _queue.size());
+    }
+
+    size_t max_queue_depth;
+    long long overflow_tick;
+
+private:
+    std::deque<uhd::stream_cmd_t> _queue;
+    size_t _remaining;
+    long long _tick;
+};
+
+//! A dummy TX streamer which records the bursts
+class dummy_tx_streamer : public uhd::tx_streamer{
+public:
+    size_t get_num_channels(void) const{
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return 64;
+    }
+
+    size_t send(
+        const buffs_type &,
+        const size_t nsamps_per_buff,
+        const uhd::tx_metadata_t &metadata,
+        const double = 0.1
+    ){
+        bursts.push_back(metadata);
+        nsamps.push_back(nsamps_per_buff);
+        return nsamps_per_buff;
+    }
+
+    bool recv_async_msg(uhd::async_metadata_t &, double = 0.1){
+        return false;
+    }
+
+    std::vector<uhd::tx_metadata_t> bursts;
+    std::vector<size_t> nsamps;
+};
+
+/***********************************************************************
+ * Test cases
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_tdd_scheduler_frames){
+    boost::shared_ptr<dummy_rx_streamer> rx_stream = boost::make_shared<dummy_rx_streamer>();
+    boost::shared_ptr<dummy_tx_streamer> tx_stream = boost::make_shared<dummy_tx_streamer>();
+    const uhd::usrp::tdd_frame_t frame(100, 10, 80, 20);
+    BOOST_CHECK_EQUAL(frame.get_length(), 210);
+    uhd::usrp::tdd_scheduler::sptr scheduler = uhd::usrp::tdd_scheduler::make(
+        rx_stream, tx_stream, RATE, frame, uhd::time_spec_t::from_ticks(1000, RATE),
+        uhd::device_addr_t("frame_depth=3"));
+    BOOST_CHECK_EQUAL(scheduler->get_frame_time(2).to_ticks(RATE), 1420);
+    BOOST_CHECK_EQUAL(scheduler->get_tx_time(2).to_ticks(RATE), 1530);
+
+    std::vector<boost::uint64_t> buff(80);
+    for (size_t f = 0; f < 6; f++){
+        size_t offset = 0;
+        while (offset < frame.rx_samps){
+            uhd::rx_metadata_t md;
+            const size_t nsamps = scheduler->recv(&buff.front(), buff.size(), md, 1.0);
+            BOOST_REQUIRE_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+            BOOST_REQUIRE(nsamps > 0);
+            BOOST_CHECK_EQUAL(scheduler->get_rx_frame(), f);
+            BOOST_CHECK_EQUAL(md.start_of_burst, offset == 0);
+            BOOST_REQUIRE_EQUAL(buff[0], boost::uint64_t(1000 + f*210 + offset));
+            offset += nsamps;
+            BOOST_CHECK_EQUAL(md.end_of_burst, offset == frame.rx_samps);
+        }
+        BOOST_CHECK_EQUAL(scheduler->send(&buff.front(), 80, f + 1), 80);
+    }
+    BOOST_CHECK(rx_stream->max_queue_depth <= 3);
+    BOOST_CHECK_EQUAL(scheduler->get_num_dropped(), 0);
+
+    BOOST_REQUIRE_EQUAL(tx_stream->bursts.size(), 6);
+    for (size_t f = 0; f < 6; f++){
+        const uhd::tx_metadata_t &md = tx_stream->bursts[f];
+        BOOST_CHECK(md.start_of_burst and md.end_of_burst and md.has_time_spec);
+        BOOST_CHECK_EQUAL(md.time_spec.to_ticks(RATE), (long long)(1000 + (f + 1)*210 + 110));
+    }
+    BOOST_CHECK_THROW(scheduler->send(&buff.front(), 81, 10), uhd::value_error);
+
+    scheduler->stop();
+    uhd::rx_metadata_t md;
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 0.0), 0);
+    BOOST_CHECK_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
+BOOST_AUTO_TEST_CASE(test_tdd_scheduler_resync){
+    boost::shared_ptr<dummy_rx_streamer> rx_stream = boost::make_shared<dummy_rx_streamer>();
+    const uhd::usrp::tdd_frame_t frame(100, 0, 0, 100);
+    uhd::usrp::tdd_scheduler::sptr scheduler = uhd::usrp::tdd_scheduler::make(
+        rx_stream, uhd::tx_streamer::sptr(), RATE, frame, uhd::time_spec_t(0.0),
+        uhd::device_addr_t("frame_depth=2,resync_lead=0.0005"));
+    rx_stream->overflow_tick = 64;
+
+    //the overflow in frame 0 drops the frames up to 564 ticks
+    std::vector<boost::uint64_t> buff(100);
+    uhd::rx_metadata_t md;
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 1.0), 64);
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 1.0), 0);
+    BOOST_CHECK_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK_EQUAL(scheduler->get_rx_frame(), 0);
+    BOOST_CHECK_EQUAL(scheduler->get_num_dropped(), 3);
+
+    BOOST_CHECK_EQUAL(scheduler->recv(&buff.front(), buff.size(), md, 1.0), 64);
+    BOOST_CHECK_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+    BOOST_CHECK(md.start_of_burst);
+    BOOST_CHECK_EQUAL(scheduler->get_rx_frame(), 3);
+    BOOST_CHECK_EQUAL(buff[0], 600);
+    BOOST_CHECK_THROW(scheduler->send(&buff.front(), 0, 0), uhd::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_tdd_scheduler_bad_args){
+    boost::shared_ptr<dummy_rx_streamer> rx_stream = boost::make_shared<dummy_rx_streamer>();
+    const uhd::time_spec_t start(0.0);
+    BOOST_CHECK_THROW(uhd::usrp::tdd_scheduler::make(
+        rx_stream, uhd::tx_streamer::sptr(), RATE, uhd::usrp::tdd_frame_t(), start), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::usrp::tdd_scheduler::make(
+        rx_stream, uhd::tx_streamer::sptr(), RATE, uhd::usrp::tdd_frame_t(10, 0, 10), start), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::usrp::tdd_scheduler::make(
+        uhd::rx_streamer::sptr(), uhd::tx_streamer::sptr(), RATE, uhd::usrp::tdd_frame_t(10), start), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::usrp::tdd_scheduler::make(
+        rx_stream, uhd::tx_streamer::sptr(), 0.0, uhd::usrp::tdd_frame_t(10), start), uhd::value_error);
+}
@@ -0,0 +1,99 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/utils/trace.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread/thread.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace fs = boost::filesystem;
+
+static std::string read_trace(void){
+    const fs::path path = fs::temp_directory_path() / fs::unique_path("uhd_trace_%%%%%%.json");
+    uhd::trace::write_chrome_trace(path.string());
+    std::ifstream in(path.string().c_str());
+    std::stringstream ss;
+    ss << in.rdbuf();
+    fs::remove(path);
+    return ss.str();
+}
+
+static size_t count_of(const std::string &haystack, const std::string &needle){
+    size_t count = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)){
+        count++;
+    }
+    return count;
+}
+
+static void convert_some(void){
+    for (size_t i = 0; i < 10; i++){
+        UHD_TRACE_SCOPE(POINT_RECV_CONVERT, i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_disabled){
+    uhd::trace::set_enabled(false);
+    uhd::trace::clear();
+    UHD_TRACE_INSTANT(POINT_FC_SEND, 1);
+    {
+        UHD_TRACE_SCOPE(POINT_RECV_ALIGN, 0);
+    }
+    BOOST_CHECK_EQUAL(count_of(read_trace(), "\"name\""), size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_events){
+    uhd::trace::clear();
+    uhd::trace::set_enabled(true);
+    UHD_TRACE_INSTANT(POINT_FC_SEND, 1234);
+    {
+        UHD_TRACE_SCOPE(POINT_RECV_ALIGN, 2);
+    }
+    boost::thread worker(&convert_some);
+    worker.join();
+    uhd::trace::set_enabled(false);
+
+    const std::string trace = read_trace();
+    BOOST_CHECK_EQUAL(trace.find("{\"displayTimeUnit\""), size_t(0));
+    BOOST_CHECK_EQUAL(count_of(trace, "\"name\":\"fc_send\",\"ph\":\"i\""), size_t(1));
+    BOOST_CHECK_EQUAL(count_of(trace, "\"arg\":1234"), size_t(1));
+    BOOST_CHECK_EQUAL(count_of(trace, "\"name\":\"recv_align\",\"ph\":\"B\""), size_t(1));
+    BOOST_CHECK_EQUAL(count_of(trace, "\"name\":\"recv_align\",\"ph\":\"E\""), size_t(1));
+    BOOST_CHECK_EQUAL(count_of(trace, "\"name\":\"recv_convert\",\"ph\":\"B\""), size_t(10));
+    BOOST_CHECK_EQUAL(count_of(trace, "\"name\":\"recv_convert\",\"ph\":\"E\""), size_t(10));
+    //the worker thread has its own ring
+    BOOST_CHECK_EQUAL(count_of(trace, "\"tid\":1,"), size_t(3));
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_ring_overwrite){
+    uhd::trace::clear();
+    uhd::trace::set_enabled(true);
+    for (size_t i = 0; i < 100000; i++){
+        UHD_TRACE_INSTANT(POINT_RECV_BUFF_RELEASE, i);
+    }
+    uhd::trace::set_enabled(false);
+
+    //only the newest events are kept
+    const std::string trace = read_trace();
+    const size_t num_events = count_of(trace, "\"name\"");
+    BOOST_CHECK(num_events > 0 and num_events < 100000);
+    BOOST_CHECK_EQUAL(count_of(trace, "\"arg\":99999}"), size_t(1));
+    BOOST_CHECK_EQUAL(count_of(trace, "\"arg\":0}"), size_t(0));
+}
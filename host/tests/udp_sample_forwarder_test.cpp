@@ -0,0 +1,186 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/transport/udp_sample_forwarder.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/exception.hpp>
+#include <boost/asio.hpp>
+#include <boost/format.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstring>
+#include <vector>
+
+using uhd::transport::udp_sample_forwarder;
+namespace asio = boost::asio;
+
+static const double SAMP_RATE = 1e6;
+
+/***********************************************************************
+ * A dummy rx streamer: each sample holds its index in the stream
+ **********************************************************************/
+class dummy_rx_streamer : public uhd::rx_streamer{
+public:
+    dummy_rx_streamer(const size_t num_samps_total):
+        _num_samps_total(num_samps_total), _num_samps(0)
+    {
+        /* NOP */
+    }
+
+    size_t get_num_channels(void) const{
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const{
+        return 100;
+    }
+
+    size_t recv(
+        const buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout = 0.1,
+        const bool = false
+    ){
+        metadata.reset();
+        if (_num_samps == _num_samps_total){
+            boost::this_thread::sleep(boost::posix_time::microseconds(long(timeout*1e6)));
+            metadata.error_code = uhd::rx_metadata_t::ERROR_CODE_TIMEOUT;
+            return 0;
+        }
+        const size_t nsamps = std::min(nsamps_per_buff, _num_samps_total - _num_samps);
+        uint32_t *samps = reinterpret_cast<uint32_t *>(buffs[0]);
+        for (size_t i = 0; i < nsamps; i++) samps[i] = uint32_t(_num_samps + i);
+        metadata.has_time_spec = true;
+        metadata.time_spec = uhd::time_spec_t::from_ticks(_num_samps, SAMP_RATE);
+        _num_samps += nsamps;
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const uhd::stream_cmd_t &){
+        /* NOP */
+    }
+
+private:
+    const size_t _num_samps_total;
+    size_t _num_samps;
+};
+
+/***********************************************************************
+ * A receiving socket on the loopback interface
+ **********************************************************************/
+struct sink_t{
+    sink_t(void): socket(io_service, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0)){}
+
+    std::string dest(void) const{
+        return str(boost::format("127.0.0.1:%u") % socket.local_endpoint().port());
+    }
+
+    //! Receive a datagram, false after a second without one
+    bool recv(udp_sample_forwarder::header_t &header, std::vector<uint32_t> &samps){
+        for (size_t i = 0; i < 100 and not socket.available(); i++){
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        }
+        if (not socket.available()) return false;
+        std::vector<char> buff(65536);
+        const size_t len = socket.receive(asio::buffer(buff));
+        BOOST_REQUIRE(len >= sizeof(header));
+        std::memcpy(&header, &buff.front(), sizeof(header));
+        header.sequence = uhd::ntohx(header.sequence);
+        header.channel = uhd::ntohx(header.channel);
+        header.flags = uhd::ntohx(header.flags);
+        header.nsamps = uhd::ntohx(header.nsamps);
+        header.sample_offset = uhd::ntohx(header.sample_offset);
+        header.time_ns = int64_t(uhd::ntohx(uint64_t(header.time_ns)));
+        BOOST_REQUIRE_EQUAL(len, sizeof(header) + header.nsamps*sizeof(uint32_t));
+        samps.resize(header.nsamps);
+        if (header.nsamps) std::memcpy(&samps.front(), &buff[sizeof(header)], header.nsamps*sizeof(uint32_t));
+        return true;
+    }
+
+    asio::io_service io_service;
+    asio::ip::udp::socket socket;
+};
+
+BOOST_AUTO_TEST_CASE(test_udp_sample_forwarder_copy){
+    static const size_t NUM_SAMPS = 1050;
+    static const size_t BLOCK_SIZE = 250;
+    static const size_t PAYLOAD_SAMPS = 100;
+    sink_t sink;
+    uhd::rx_streamer::sptr rx_stream(new dummy_rx_streamer(NUM_SAMPS));
+    udp_sample_forwarder::sptr fwd = udp_sample_forwarder::make(
+        rx_stream, uhd::stream_args_t("sc16"),
+        uhd::device_addr_t(str(boost::format("dests=%s,block_size=%u,payload_size=%u")
+            % sink.dest() % BLOCK_SIZE % (PAYLOAD_SAMPS*sizeof(uint32_t))))
+    );
+
+    //the blocks are cut into full datagrams and a short one at the end
+    size_t num_samps = 0;
+    uint32_t sequence = 0;
+    udp_sample_forwarder::header_t header;
+    std::vector<uint32_t> samps;
+    while (num_samps < NUM_SAMPS){
+        BOOST_REQUIRE(sink.recv(header, samps));
+        const size_t block_start = num_samps - num_samps % BLOCK_SIZE;
+        BOOST_CHECK_EQUAL(header.sequence, sequence++);
+        BOOST_CHECK_EQUAL(header.channel, 0);
+        BOOST_CHECK(header.flags & udp_sample_forwarder::FLAG_HAS_TIME_SPEC);
+        BOOST_CHECK_EQUAL(header.sample_offset, num_samps - block_start);
+        BOOST_CHECK_EQUAL(header.time_ns, uhd::time_spec_t::from_ticks(block_start, SAMP_RATE).to_ticks(1e9));
+        BOOST_CHECK_EQUAL(header.nsamps, std::min(PAYLOAD_SAMPS, std::min(BLOCK_SIZE, NUM_SAMPS - block_start) - header.sample_offset));
+        BOOST_REQUIRE(not samps.empty());
+        BOOST_CHECK_EQUAL(samps.front(), num_samps);
+        BOOST_CHECK_EQUAL(samps.back(), num_samps + samps.size() - 1);
+        num_samps += samps.size();
+    }
+    BOOST_CHECK_EQUAL(num_samps, NUM_SAMPS);
+    BOOST_CHECK_EQUAL(fwd->get_num_datagrams(), sequence);
+    BOOST_CHECK_EQUAL(fwd->get_num_bytes(), NUM_SAMPS*sizeof(uint32_t));
+    BOOST_CHECK_EQUAL(fwd->get_num_dropped_blocks(), 0U);
+    BOOST_CHECK_EQUAL(fwd->get_num_send_errors(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(test_udp_sample_forwarder_round_robin){
+    static const size_t BLOCK_SIZE = 100;
+    sink_t sinks[2];
+    uhd::rx_streamer::sptr rx_stream(new dummy_rx_streamer(4*BLOCK_SIZE));
+    udp_sample_forwarder::sptr fwd = udp_sample_forwarder::make(
+        rx_stream, uhd::stream_args_t("sc16"),
+        uhd::device_addr_t(str(boost::format("dests=%s %s,fanout=round_robin,block_size=%u")
+            % sinks[0].dest() % sinks[1].dest() % BLOCK_SIZE))
+    );
+
+    //the blocks alternate between the destinations
+    udp_sample_forwarder::header_t header;
+    std::vector<uint32_t> samps;
+    for (size_t block = 0; block < 4; block++){
+        BOOST_REQUIRE(sinks[block % 2].recv(header, samps));
+        BOOST_CHECK_EQUAL(header.sequence, block/2);
+        BOOST_CHECK_EQUAL(header.nsamps, BLOCK_SIZE);
+        BOOST_CHECK_EQUAL(samps.front(), block*BLOCK_SIZE);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_udp_sample_forwarder_bad_args){
+    uhd::rx_streamer::sptr rx_stream(new dummy_rx_streamer(0));
+    BOOST_CHECK_THROW(udp_sample_forwarder::make(
+        rx_stream, uhd::stream_args_t("sc16"), uhd::device_addr_t("")
+    ), uhd::value_error);
+    BOOST_CHECK_THROW(udp_sample_forwarder::make(
+        rx_stream, uhd::stream_args_t("sc16"), uhd::device_addr_t("dests=127.0.0.1:5000,fanout=random")
+    ), uhd::value_error);
+}
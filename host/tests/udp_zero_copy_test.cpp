@@ -0,0 +1,91 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/transport/udp_zero_copy.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/exception.hpp>
+#include <boost/asio.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/cstdint.hpp>
+#include <cstring>
+#include <vector>
+
+using namespace uhd::transport;
+namespace asio = boost::asio;
+
+static zero_copy_xport_params make_xport_params(void){
+    zero_copy_xport_params xport_params;
+    xport_params.recv_frame_size = 1024;
+    xport_params.send_frame_size = 1024;
+    xport_params.num_recv_frames = 8;
+    xport_params.num_send_frames = 4;
+    return xport_params;
+}
+
+//! Send a big endian CHDR data packet of len bytes, each byte is seq
+static void send_chdr_packet(zero_copy_if::sptr xport, const size_t len, const bool eob, const char seq){
+    managed_send_buffer::sptr buff = xport->get_send_buff(1.0);
+    BOOST_REQUIRE(buff);
+    std::memset(buff->cast<void *>(), seq, len);
+    const boost::uint32_t word = uhd::htonx(boost::uint32_t(len) | (eob? (1 << 28) : 0));
+    std::memcpy(buff->cast<void *>(), &word, sizeof(word));
+    buff->commit(len);
+}
+
+BOOST_AUTO_TEST_CASE(test_udp_zero_copy_gso){
+    asio::io_service io_service;
+    asio::ip::udp::socket peer(io_service, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0));
+    const std::string port = boost::lexical_cast<std::string>(peer.local_endpoint().port());
+
+    //without kernel support, the offload is off and every frame goes out at once
+    udp_zero_copy::buff_params buff_params;
+    zero_copy_if::sptr xport = udp_zero_copy::make("127.0.0.1", port, make_xport_params(), buff_params,
+        uhd::device_addr_t("udp_gso=3,udp_framing=chdr_be,udp_zerocopy=1"));
+
+    //more packets than frames, the batches must not hold the frames forever
+    std::vector<size_t> lens;
+    for (size_t i = 0; i < 10; i++) lens.push_back((i == 5)? 200 : 1000);
+    lens.push_back(100);
+    for (size_t i = 0; i < lens.size(); i++){
+        send_chdr_packet(xport, lens[i], i + 1 == lens.size(), char(i));
+    }
+
+    //the datagrams arrive as they were committed
+    std::vector<char> datagram(2048);
+    for (size_t i = 0; i < lens.size(); i++){
+        const size_t len = peer.receive(asio::buffer(datagram));
+        BOOST_REQUIRE_EQUAL(len, lens[i]);
+        BOOST_CHECK_EQUAL(datagram[len-1], char(i));
+    }
+    BOOST_CHECK_EQUAL(peer.available(), 0);
+
+    const zero_copy_stats_t stats = xport->get_stats();
+    BOOST_CHECK_EQUAL(stats.send_packets, lens.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_udp_zero_copy_bad_offload){
+    asio::io_service io_service;
+    asio::ip::udp::socket peer(io_service, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0));
+    const std::string port = boost::lexical_cast<std::string>(peer.local_endpoint().port());
+
+    udp_zero_copy::buff_params buff_params;
+    BOOST_CHECK_THROW(udp_zero_copy::make("127.0.0.1", port, make_xport_params(), buff_params,
+        uhd::device_addr_t("udp_gso=8")), uhd::value_error);
+    BOOST_CHECK_THROW(udp_zero_copy::make("127.0.0.1", port, make_xport_params(), buff_params,
+        uhd::device_addr_t("udp_gso=8,udp_framing=foo")), uhd::value_error);
+}
@@ -0,0 +1,83 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "wb_shadow_iface.hpp"
+#include <boost/make_shared.hpp>
+#include <vector>
+
+using namespace uhd;
+
+//! Records the register writes and reads the value last written
+class record_wb_iface : public wb_iface{
+public:
+    void poke32(const wb_addr_type addr, const uint32_t data){
+        pokes.push_back(std::make_pair(addr, data));
+        _last = data;
+    }
+
+    uint32_t peek32(const wb_addr_type){
+        return _last;
+    }
+
+    std::vector<std::pair<wb_addr_type, uint32_t> > pokes;
+
+private:
+    uint32_t _last;
+};
+
+BOOST_AUTO_TEST_CASE(test_wb_shadow_skip){
+    boost::shared_ptr<record_wb_iface> iface = boost::make_shared<record_wb_iface>();
+    wb_shadow_iface::sptr shadow = wb_shadow_iface::make(iface);
+    shadow->shadow(0x10);
+
+    //the first write always goes out, the unchanged rewrites are dropped
+    shadow->poke32(0x10, 5);
+    shadow->poke32(0x10, 5);
+    shadow->poke32(0x10, 5);
+    BOOST_CHECK_EQUAL(iface->pokes.size(), 1);
+    BOOST_CHECK_EQUAL(shadow->get_num_skipped(), 2);
+
+    shadow->poke32(0x10, 6);
+    BOOST_CHECK_EQUAL(iface->pokes.size(), 2);
+    BOOST_CHECK_EQUAL(iface->pokes.back().second, 6);
+
+    //registers which are not shadowed are always written
+    shadow->poke32(0x14, 1);
+    shadow->poke32(0x14, 1);
+    BOOST_CHECK_EQUAL(iface->pokes.size(), 4);
+
+    //reads go through
+    BOOST_CHECK_EQUAL(shadow->peek32(0x10), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_wb_shadow_force_and_invalidate){
+    boost::shared_ptr<record_wb_iface> iface = boost::make_shared<record_wb_iface>();
+    wb_shadow_iface::sptr shadow = wb_shadow_iface::make(iface);
+    shadow->shadow(0x10);
+
+    shadow->poke32(0x10, 5);
+    shadow->force_poke32(0x10, 5);
+    BOOST_CHECK_EQUAL(iface->pokes.size(), 2);
+
+    shadow->invalidate();
+    shadow->poke32(0x10, 5);
+    BOOST_CHECK_EQUAL(iface->pokes.size(), 3);
+    shadow->poke32(0x10, 5);
+    BOOST_CHECK_EQUAL(iface->pokes.size(), 3);
+    BOOST_CHECK_EQUAL(shadow->get_num_skipped(), 1);
+}
@@ -0,0 +1,141 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/transport/zero_copy_recv_offload.hpp>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+using namespace uhd::transport;
+
+static const size_t NUM_FRAMES = 4;
+static const size_t FRAME_SIZE = 64;
+
+/***********************************************************************
+ * A transport with a few frames, which sends a sequence number in
+ * each frame and drops the frames it has no free buffer for
+ **********************************************************************/
+class seq_mrb : public managed_recv_buffer{
+public:
+    seq_mrb(boost::atomic<size_t> &num_held): _num_held(num_held), _mem(FRAME_SIZE){}
+
+    void release(void){
+        _num_held--;
+        _free = true;
+    }
+
+    sptr get_new(const boost::uint32_t seq){
+        _free = false;
+        _num_held++;
+        *reinterpret_cast<boost::uint32_t *>(&_mem.front()) = seq;
+        return make(this, &_mem.front(), sizeof(seq));
+    }
+
+    boost::atomic<bool> _free;
+
+private:
+    boost::atomic<size_t> &_num_held;
+    std::vector<char> _mem;
+};
+
+class seq_zero_copy : public zero_copy_if{
+public:
+    seq_zero_copy(const size_t num_packets):
+        num_dropped(0), _num_held(0), _seq(0), _num_packets(num_packets)
+    {
+        for (size_t i = 0; i < NUM_FRAMES; i++){
+            _mrbs.push_back(boost::make_shared<seq_mrb>(boost::ref(_num_held)));
+            _mrbs.back()->_free = true;
+        }
+    }
+
+    managed_recv_buffer::sptr get_recv_buff(double timeout){
+        if (_seq >= _num_packets){
+            boost::this_thread::sleep(boost::posix_time::microseconds(long(timeout*1e6)));
+            return managed_recv_buffer::sptr();
+        }
+        boost::this_thread::sleep(boost::posix_time::microseconds(100));
+        for (size_t i = 0; i < NUM_FRAMES; i++){
+            if (_mrbs[i]->_free) return _mrbs[i]->get_new(_seq++);
+        }
+        //a device would overflow here
+        num_dropped++;
+        _seq++;
+        return managed_recv_buffer::sptr();
+    }
+
+    size_t get_num_recv_frames(void) const{ return NUM_FRAMES; }
+    size_t get_recv_frame_size(void) const{ return FRAME_SIZE; }
+
+    managed_send_buffer::sptr get_send_buff(double){ return managed_send_buffer::sptr(); }
+    size_t get_num_send_frames(void) const{ return 1; }
+    size_t get_send_frame_size(void) const{ return FRAME_SIZE; }
+
+    bool done(void) const{ return _seq >= _num_packets; }
+
+    boost::atomic<size_t> num_dropped;
+
+private:
+    std::vector<boost::shared_ptr<seq_mrb> > _mrbs;
+    boost::atomic<size_t> _num_held;
+    boost::atomic<size_t> _seq;
+    const size_t _num_packets;
+};
+
+//a consumer which stalls until the transport has sent everything, or for stall_ms
+static size_t stall_and_drain(
+    zero_copy_recv_offload::sptr offload, boost::shared_ptr<seq_zero_copy> xport, const long stall_ms = 0
+){
+    if (stall_ms > 0) boost::this_thread::sleep(boost::posix_time::milliseconds(stall_ms));
+    else while (not xport->done()) boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    size_t num_got = 0;
+    for (boost::uint32_t expected = 0;; expected++){
+        managed_recv_buffer::sptr buff = offload->get_recv_buff(0.1);
+        if (not buff) break;
+        BOOST_CHECK_EQUAL(*buff->cast<const boost::uint32_t *>(), expected);
+        num_got++;
+    }
+    return num_got;
+}
+
+BOOST_AUTO_TEST_CASE(test_recv_offload_elastic){
+    boost::shared_ptr<seq_zero_copy> xport = boost::make_shared<seq_zero_copy>(100);
+    zero_copy_recv_offload::sptr offload = zero_copy_recv_offload::make(
+        xport, 0.01, uhd::device_addr_t("recv_elastic_bytes=8192,buff_hugepages="));
+
+    //the ring of 128 frames holds everything the consumer is late for
+    BOOST_CHECK_EQUAL(stall_and_drain(offload, xport), 100);
+    BOOST_CHECK_EQUAL(xport->num_dropped, 0);
+    const zero_copy_stats_t stats = offload->get_stats();
+    BOOST_CHECK_EQUAL(stats.recv_stalls, 0);
+    BOOST_CHECK_EQUAL(stats.recv_elastic_hwm, 100);
+}
+
+BOOST_AUTO_TEST_CASE(test_recv_offload_elastic_full){
+    boost::shared_ptr<seq_zero_copy> xport = boost::make_shared<seq_zero_copy>(100);
+    zero_copy_recv_offload::sptr offload = zero_copy_recv_offload::make(
+        xport, 0.01, uhd::device_addr_t("recv_elastic_bytes=1024,buff_hugepages="));
+
+    //a full ring of 16 frames holds the thread back until the consumer is back
+    BOOST_CHECK_EQUAL(stall_and_drain(offload, xport, 50), 100);
+    BOOST_CHECK_EQUAL(xport->num_dropped, 0);
+    BOOST_CHECK(offload->get_stats().recv_stalls >= 1);
+    BOOST_CHECK_EQUAL(offload->get_stats().recv_elastic_hwm, 16);
+}
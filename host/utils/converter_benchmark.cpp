@@ -282,8 +282,8 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
         ("out", po::value<std::string>(&out_format), "Output format (e.g. 'sc16')")
         ("samples",  po::value<size_t>(&n_samples)->default_value(1000000), "Number of samples per iteration")
         ("iterations",  po::value<size_t>(&iterations)->default_value(10000), "Number of iterations per benchmark")
-        ("priorities", po::value<std::string>(&priorities)->default_value("default"), "Converter priorities. Can be 'default', 'all', or a comma-separated list of priorities.")
-        ("max-prio", po::value<priority_type>(&max_prio)->default_value(4), "Largest available priority (advanced feature)")
+        ("priorities", po::value<std::string>(&priorities)->default_value("default"), "Converter priorities. Can be 'default', 'all', or a comma-separated list of priorities. The streaming store converters have negative priorities (e.g. -2).")
+        ("max-prio", po::value<priority_type>(&max_prio)->default_value(5), "Largest available priority (advanced feature)")
         ("n-inputs",   po::value<size_t>(&n_inputs)->default_value(1),  "Number of input vectors")
         ("n-outputs",  po::value<size_t>(&n_outputs)->default_value(1), "Number of output vectors")
         ("debug-converter", "Skip benchmark and print conversion results. Implies iterations==1 and will only run on a single converter.")
@@ -337,14 +337,13 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
             return EXIT_FAILURE;
         }
     } else if (priorities == "all") {
-        for (priority_type i = 0; i < max_prio; i++) {
-            try {
-                // get_converter() returns a factory function, execute that immediately:
-                converter::sptr conv_for_prio = get_converter(converter_id, i)(); // Can throw a uhd::key_error
-                conv_list[i] = conv_for_prio;
-            } catch (...) {
+        // This includes the streaming store converters, which have negative priorities
+        BOOST_FOREACH(const converter_info_type &info, get_converter_infos(converter_id)) {
+            if (info.prio > max_prio) {
                 continue;
             }
+            // get_converter() returns a factory function, execute that immediately:
+            conv_list[info.prio] = get_converter(converter_id, info.prio)();
         }
     } else { // Assume that priorities contains a list of prios (e.g. 0,2,3)
         std::vector<std::string> prios_in_list;
@@ -355,7 +354,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
                 boost::token_compress_on // Avoid empty results
         );
         BOOST_FOREACH(const std::string &this_prio, prios_in_list) {
-            size_t prio_index = boost::lexical_cast<size_t>(this_prio);
+            priority_type prio_index = boost::lexical_cast<priority_type>(this_prio);
             converter::sptr conv_for_prio = get_converter(converter_id, prio_index)(); // Can throw a uhd::key_error
             conv_list[prio_index] = conv_for_prio;
         }
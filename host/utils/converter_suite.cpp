@@ -0,0 +1,449 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/utils/safe_main.hpp>
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/version.hpp>
+#include <uhd/build_info.hpp>
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+#include <boost/foreach.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <stdint.h>
+
+namespace po = boost::program_options;
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Format helpers
+ **********************************************************************/
+// Convert `sc16_item32_le' -> `sc16', see converter_benchmark
+static std::string format_to_type(const std::string &format)
+{
+    return format.substr(0, format.find('_'));
+}
+
+// Host float formats, these are compared by value instead of by bytes
+static bool is_float_format(const std::string &format)
+{
+    return format == "fc64" or format == "fc32" or format == "fc16"
+        or format == "f64" or format == "f32";
+}
+
+// The wire full scale, used for the scalar of float to integer conversions
+static double full_scale(const std::string &format)
+{
+    const std::string type = format_to_type(format);
+    if (type == "sc8" or type == "s8" or type == "u8") return 127.;
+    if (type == "sc12") return 2047.;
+    return 32767.;
+}
+
+static float half_to_float(const uint16_t half)
+{
+    const int exp = (half >> 10) & 0x1f;
+    const int mant = half & 0x3ff;
+    float num;
+    if (exp == 0) num = std::ldexp(float(mant), -24);
+    else if (exp == 31) num = mant? NAN : INFINITY;
+    else num = std::ldexp(float(mant | 0x400), exp - 25);
+    return (half & 0x8000)? -num : num;
+}
+
+// The size of one real value of a host float format
+static size_t float_size(const std::string &format)
+{
+    if (format == "fc64" or format == "f64") return sizeof(double);
+    if (format == "fc32" or format == "f32") return sizeof(float);
+    return sizeof(uint16_t);
+}
+
+// Get value i of a buffer of a host float format
+static double get_float(const std::vector<char> &buf, const size_t i, const std::string &format)
+{
+    if (format == "fc64" or format == "f64") return reinterpret_cast<const double *>(&buf[0])[i];
+    if (format == "fc32" or format == "f32") return reinterpret_cast<const float *>(&buf[0])[i];
+    return half_to_float(reinterpret_cast<const uint16_t *>(&buf[0])[i]);
+}
+
+// Fill a buffer with random samples, floats are within [-1, 1)
+static void fill_buffer(std::vector<char> &buf, const std::string &format)
+{
+    if (format == "fc64" or format == "f64") {
+        double *p = reinterpret_cast<double *>(&buf[0]);
+        for (size_t i = 0; i < buf.size()/sizeof(double); i++) p[i] = std::rand()/(RAND_MAX/2.0) - 1;
+    } else if (format == "fc32" or format == "f32") {
+        float *p = reinterpret_cast<float *>(&buf[0]);
+        for (size_t i = 0; i < buf.size()/sizeof(float); i++) p[i] = float(std::rand()/(RAND_MAX/2.0) - 1);
+    } else if (format == "fc16") {
+        //halves of a magnitude below 1, with a random sign
+        uint16_t *p = reinterpret_cast<uint16_t *>(&buf[0]);
+        for (size_t i = 0; i < buf.size()/sizeof(uint16_t); i++) p[i] = uint16_t(std::rand() % 0x3c00) | uint16_t((std::rand() & 1) << 15);
+    } else {
+        for (size_t i = 0; i < buf.size(); i++) buf[i] = char(std::rand());
+    }
+}
+
+/***********************************************************************
+ * A set of buffers for one conversion
+ *  - nsamps is per buffer of the side with more buffers, so the
+ *    interleaved buffer of a planar conversion holds all samples
+ **********************************************************************/
+struct conv_buffers
+{
+    conv_buffers(const id_type &id, const size_t nsamps):
+        num_in_items(nsamps*std::max(id.num_inputs, id.num_outputs)/id.num_inputs),
+        num_out_items(nsamps*std::max(id.num_inputs, id.num_outputs)/id.num_outputs),
+        inputs(id.num_inputs, std::vector<char>(num_in_items*get_bytes_per_item(id.input_format) + 16)),
+        outputs(id.num_outputs, std::vector<char>(num_out_items*get_bytes_per_item(id.output_format) + 16))
+    {
+        BOOST_FOREACH(std::vector<char> &in, inputs) {
+            fill_buffer(in, id.input_format);
+            input_refs.push_back(&in[0]);
+        }
+        BOOST_FOREACH(std::vector<char> &out, outputs) {
+            std::fill(out.begin(), out.end(), 0);
+            output_refs.push_back(&out[0]);
+        }
+    }
+
+    const size_t num_in_items, num_out_items;
+    std::vector< std::vector<char> > inputs, outputs;
+    std::vector<const void *> input_refs;
+    std::vector<void *> output_refs;
+};
+
+/*!
+ * The scalar for a conversion. Float samples are within [-1, 1).
+ * Integer conversions between sizes scale like the lookup tables do.
+ */
+static double get_scalar(const id_type &id)
+{
+    const bool in_float = is_float_format(id.input_format);
+    const bool out_float = is_float_format(id.output_format);
+    if (in_float and not out_float) return full_scale(id.output_format);
+    if (out_float and not in_float) return 1.0/full_scale(id.input_format);
+    if (in_float and out_float) return 1.0;
+    if (full_scale(id.input_format) > full_scale(id.output_format)) return full_scale(id.output_format);
+    if (full_scale(id.input_format) < full_scale(id.output_format)) return 1.0/full_scale(id.input_format);
+    return 1.0;
+}
+
+static converter::sptr make_converter(const id_type &id, const std::string &name)
+{
+    converter::sptr conv = get_converter(id, name)();
+    conv->set_scalar(get_scalar(id));
+    return conv;
+}
+
+static bool has_converter(const id_type &id, const std::string &name)
+{
+    BOOST_FOREACH(const converter_info_type &info, get_converter_infos(id)) {
+        if (info.name == name) return true;
+    }
+    return false;
+}
+
+/*!
+ * The converter the others are checked against.
+ * The generic integer conversions between sizes do not scale, so the
+ * lookup table is the reference of the conversions without floats.
+ */
+static converter_info_type get_reference_info(const id_type &id)
+{
+    const bool use_table = not is_float_format(id.input_format)
+        and not is_float_format(id.output_format) and has_converter(id, "table");
+    BOOST_FOREACH(const converter_info_type &info, get_converter_infos(id)) {
+        if (info.name == (use_table? "table" : "generic")) return info;
+    }
+    throw uhd::key_error("No reference converter for " + id.to_string());
+}
+
+/***********************************************************************
+ * Check a converter against the reference converter
+ *
+ * Float outputs must match closely. Integer outputs of float inputs may
+ * differ by the rounding mode (the SIMD paths round, the generic code
+ * truncates), so they are converted back with the generic converter and
+ * compared within one LSB. All other outputs must match exactly.
+ **********************************************************************/
+static bool outputs_close(
+    const conv_buffers &a, const conv_buffers &b,
+    const std::string &format, const size_t num_items, const double tol
+) {
+    const size_t num_values = num_items*get_bytes_per_item(format)/float_size(format);
+    for (size_t j = 0; j < a.outputs.size(); j++) {
+        for (size_t i = 0; i < num_values; i++) {
+            const double va = get_float(a.outputs[j], i, format);
+            const double vb = get_float(b.outputs[j], i, format);
+            if (not (std::abs(va - vb) <= tol*std::max(1.0, std::abs(va)))) return false;
+        }
+    }
+    return true;
+}
+
+static std::string check_converter(const id_type &id, const converter_info_type &info, const converter_info_type &ref_info)
+{
+    //odd, so the tails of the SIMD loops get covered
+    static const size_t nsamps = 1037;
+    conv_buffers buffs(id, nsamps), expected(id, nsamps);
+    expected.inputs = buffs.inputs;
+    for (size_t i = 0; i < expected.inputs.size(); i++) expected.input_refs[i] = &expected.inputs[i][0];
+
+    make_converter(id, ref_info.name)->conv(expected.input_refs, expected.output_refs, nsamps);
+    make_converter(id, info.name)->conv(buffs.input_refs, buffs.output_refs, nsamps);
+
+    if (is_float_format(id.output_format)) {
+        return outputs_close(expected, buffs, id.output_format, buffs.num_out_items, 1e-5)? "pass" : "fail";
+    }
+
+    id_type reverse_id = id;
+    std::swap(reverse_id.input_format, reverse_id.output_format);
+    std::swap(reverse_id.num_inputs, reverse_id.num_outputs);
+    if (is_float_format(id.input_format) and has_converter(reverse_id, "generic")) {
+        conv_buffers decoded(reverse_id, nsamps), decoded_expected(reverse_id, nsamps);
+        for (size_t i = 0; i < buffs.outputs.size(); i++) {
+            decoded.input_refs[i] = &buffs.outputs[i][0];
+            decoded_expected.input_refs[i] = &expected.outputs[i][0];
+        }
+        converter::sptr rconv = make_converter(reverse_id, "generic");
+        rconv->conv(decoded.input_refs, decoded.output_refs, nsamps);
+        rconv->conv(decoded_expected.input_refs, decoded_expected.output_refs, nsamps);
+        //one LSB of the wire format, relative to values within [-1, 1)
+        const double tol = 1.5/get_scalar(id);
+        return outputs_close(decoded_expected, decoded, id.input_format, decoded.num_out_items, tol)? "pass" : "fail";
+    }
+
+    const size_t num_bytes = buffs.num_out_items*get_bytes_per_item(id.output_format);
+    for (size_t j = 0; j < buffs.outputs.size(); j++) {
+        if (std::memcmp(&buffs.outputs[j][0], &expected.outputs[j][0], num_bytes) != 0) return "fail";
+    }
+    return "pass";
+}
+
+/***********************************************************************
+ * Throughput of one converter
+ **********************************************************************/
+static double measure_msps(
+    const id_type &id, const converter_info_type &info,
+    const size_t nsamps, const double min_time, size_t &iterations
+) {
+    conv_buffers buffs(id, nsamps);
+    converter::sptr conv = make_converter(id, info.name);
+    conv->conv(buffs.input_refs, buffs.output_refs, nsamps); //warm up
+
+    //double the iterations until the run is long enough to time
+    for (iterations = 1; ; iterations *= 2) {
+        const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+        for (size_t i = 0; i < iterations; i++) {
+            conv->conv(buffs.input_refs, buffs.output_refs, nsamps);
+        }
+        const double elapsed = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()/1e6;
+        if (elapsed >= min_time) return nsamps*iterations/elapsed/1e6;
+    }
+}
+
+/***********************************************************************
+ * Host description
+ **********************************************************************/
+static std::string get_cpuinfo_value(const std::string &line)
+{
+    const size_t pos = line.find(':');
+    if (pos == std::string::npos) return "";
+    return boost::algorithm::trim_copy(line.substr(pos+1));
+}
+
+static std::string get_cpu_model(void)
+{
+    //x86 has a model name, ARM kernels name the board in "Hardware"
+    //and aarch64 ones may only give the core's part number
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line, model, hardware, part;
+    while (std::getline(cpuinfo, line)) {
+        if (model.empty() and boost::algorithm::starts_with(line, "model name")) model = get_cpuinfo_value(line);
+        if (hardware.empty() and boost::algorithm::starts_with(line, "Hardware")) hardware = get_cpuinfo_value(line);
+        if (part.empty() and boost::algorithm::starts_with(line, "CPU part")) part = "CPU part " + get_cpuinfo_value(line);
+    }
+    if (model.empty()) model = part;
+    if (model.empty()) model = hardware.empty()? "unknown" : hardware;
+    else if (not hardware.empty()) model += " (" + hardware + ")";
+    return model;
+}
+
+static std::string json_escape(const std::string &s)
+{
+    std::string out;
+    BOOST_FOREACH(const char c, s) {
+        if (c == '"' or c == '\\') out += '\\';
+        if (c == '\n') { out += "\\n"; continue; }
+        out += c;
+    }
+    return out;
+}
+
+typedef std::pair<std::string, id_type> named_id_type;
+
+static bool id_name_lt(const named_id_type &lhs, const named_id_type &rhs)
+{
+    return lhs.first < rhs.first;
+}
+
+struct result_type
+{
+    std::string conversion, name, isa, check;
+    priority_type prio;
+    size_t nsamps, iterations;
+    double msps;
+};
+
+int UHD_SAFE_MAIN(int argc, char *argv[])
+{
+    std::string sizes_str, format, filter;
+    double min_time;
+
+    /// Command line arguments
+    po::options_description desc("Converter suite options:");
+    desc.add_options()
+        ("help", "help message")
+        ("sizes", po::value<std::string>(&sizes_str)->default_value("256,8192,262144,4194304"), "Comma-separated list of samples per conversion, from L1 cache resident to DRAM sized")
+        ("min-time", po::value<double>(&min_time)->default_value(0.05), "Minimum time in seconds to measure each converter and size")
+        ("format", po::value<std::string>(&format)->default_value("csv"), "Output format: csv or json")
+        ("filter", po::value<std::string>(&filter)->default_value(""), "Only run conversions whose name contains this, e.g. 'sc16_item32_le (1) -> fc32'")
+        ("no-check", "Skip comparing the converters against the generic converters")
+        ("no-bench", "Skip the throughput measurements")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    //print the help message
+    if (vm.count("help") or (format != "csv" and format != "json")) {
+        std::cout << boost::format("UHD Converter Suite %s") % desc << std::endl;
+        std::cout << "  Runs every registered converter of every conversion, checks its\n"
+                     "  output against the generic converter and measures its throughput\n"
+                     "  in millions of samples per second. The exit code is non-zero if\n"
+                     "  a check fails.\n" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<size_t> sizes;
+    std::vector<std::string> toks;
+    boost::split(toks, sizes_str, boost::is_any_of(","), boost::token_compress_on);
+    BOOST_FOREACH(const std::string &tok, toks) {
+        if (not tok.empty()) sizes.push_back(boost::lexical_cast<size_t>(boost::algorithm::trim_copy(tok)));
+    }
+    if (vm.count("no-bench")) sizes.clear();
+
+    //sort the conversions for output which can be diffed between builds
+    std::vector<named_id_type> ids;
+    BOOST_FOREACH(const id_type &id, get_converter_ids()) {
+        if (id.to_string().find(filter) == std::string::npos) continue;
+        ids.push_back(std::make_pair(id.to_string(), id));
+    }
+    std::sort(ids.begin(), ids.end(), &id_name_lt);
+
+    /// Run the checks and the benchmarks ///////////////////////////////////
+    std::vector<result_type> results;
+    bool all_passed = true;
+    for (size_t k = 0; k < ids.size(); k++) {
+        const id_type &id = ids[k].second;
+        try {
+            get_bytes_per_item(id.input_format);
+            get_bytes_per_item(id.output_format);
+        } catch (const uhd::key_error &) {
+            std::cerr << "Skipping " << id.to_string() << ": unknown item size" << std::endl;
+            continue;
+        }
+        const converter_info_type ref_info = get_reference_info(id);
+        BOOST_FOREACH(const converter_info_type &info, get_converter_infos(id)) {
+            result_type result;
+            result.conversion = id.to_string();
+            result.name = info.name;
+            result.isa = info.isa;
+            result.prio = info.prio;
+            //only the generic converter is below the table reference
+            result.check = "skip";
+            if (info.name == ref_info.name) result.check = "ref";
+            else if (not vm.count("no-check") and not (info.prio >= 0 and info.prio < ref_info.prio)) {
+                result.check = check_converter(id, info, ref_info);
+            }
+            if (result.check == "fail") {
+                all_passed = false;
+                std::cerr << "Check failed: " << id.to_string() << ": " << info.to_string() << std::endl;
+            }
+            if (sizes.empty()) {
+                result.nsamps = result.iterations = 0;
+                result.msps = 0;
+                results.push_back(result);
+            }
+            BOOST_FOREACH(const size_t nsamps, sizes) {
+                result.nsamps = nsamps;
+                result.msps = measure_msps(id, info, nsamps, min_time, result.iterations);
+                results.push_back(result);
+            }
+        }
+    }
+
+    /// Print the report ////////////////////////////////////////////////////
+    const std::string cpu = get_cpu_model();
+    const unsigned num_cpus = boost::thread::hardware_concurrency();
+    if (format == "json") {
+        std::cout << "{" << std::endl
+                  << "  \"uhd_version\": \"" << json_escape(uhd::get_version_string()) << "\"," << std::endl
+                  << "  \"compiler\": \"" << json_escape(uhd::build_info::cxx_compiler()) << "\"," << std::endl
+                  << "  \"cxx_flags\": \"" << json_escape(uhd::build_info::cxx_flags()) << "\"," << std::endl
+                  << "  \"cpu_model\": \"" << json_escape(cpu) << "\"," << std::endl
+                  << "  \"num_cpus\": " << num_cpus << "," << std::endl
+                  << "  \"all_passed\": " << (all_passed? "true" : "false") << "," << std::endl
+                  << "  \"results\": [" << std::endl;
+        for (size_t i = 0; i < results.size(); i++) {
+            const result_type &r = results[i];
+            std::cout << boost::format(
+                "    {\"conversion\": \"%s\", \"converter\": \"%s\", \"prio\": %d, \"isa\": \"%s\", "
+                "\"check\": \"%s\", \"nsamps\": %d, \"iterations\": %d, \"msps\": %.3f}%s"
+            ) % r.conversion % r.name % r.prio % r.isa % r.check % r.nsamps % r.iterations % r.msps
+              % ((i+1 == results.size())? "" : ",") << std::endl;
+        }
+        std::cout << "  ]" << std::endl << "}" << std::endl;
+    } else {
+        std::cout << "# uhd_version: " << uhd::get_version_string() << std::endl
+                  << "# compiler: " << uhd::build_info::cxx_compiler() << std::endl
+                  << "# cxx_flags: " << uhd::build_info::cxx_flags() << std::endl
+                  << "# cpu_model: " << cpu << std::endl
+                  << "# num_cpus: " << num_cpus << std::endl
+                  << "conversion,converter,prio,isa,check,nsamps,iterations,msps" << std::endl;
+        BOOST_FOREACH(const result_type &r, results) {
+            std::cout << boost::format("\"%s\",%s,%d,%s,%s,%d,%d,%.3f")
+                % r.conversion % r.name % r.prio % r.isa % r.check % r.nsamps % r.iterations % r.msps
+                << std::endl;
+        }
+    }
+
+    return all_passed? EXIT_SUCCESS : EXIT_FAILURE;
+}
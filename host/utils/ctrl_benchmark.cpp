@@ -0,0 +1,207 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/utils/safe_main.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/device3.hpp>
+#include <uhd/rfnoc/constants.hpp>
+#include <uhd/types/histogram.hpp>
+#include <uhd/exception.hpp>
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/chrono.hpp>
+#include <boost/function.hpp>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <iostream>
+#include <fstream>
+
+namespace po = boost::program_options;
+typedef boost::chrono::high_resolution_clock bench_clock;
+
+/***********************************************************************
+ * Measurement helpers
+ **********************************************************************/
+static void record(uhd::histogram_t &hist, const uint64_t value){
+    hist.min = (hist.count == 0)? value : std::min(hist.min, value);
+    hist.max = std::max(hist.max, value);
+    hist.count++;
+    hist.sum += value;
+    hist.buckets[uhd::histogram_t::bucket_index(value)]++;
+}
+
+static uint64_t ns_since(const bench_clock::time_point &start){
+    return uint64_t(boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+        bench_clock::now() - start).count());
+}
+
+//! Time each call of an access and return the latency histogram in ns
+static uhd::histogram_t measure(
+    const std::string &name,
+    const boost::function<void(void)> &access,
+    const size_t iterations
+){
+    uhd::histogram_t hist;
+    hist.unit = "ns";
+    access(); //the first access can set up state, keep it out of the numbers
+    const bench_clock::time_point start = bench_clock::now();
+    for (size_t i = 0; i < iterations; i++){
+        const bench_clock::time_point t0 = bench_clock::now();
+        access();
+        record(hist, ns_since(t0));
+    }
+    const double total_secs = ns_since(start)/1e9;
+
+    std::cout << boost::format(
+        "%-14s %8.0f/s  mean %8.0f ns  p50 %8u  p90 %8u  p99 %8u  p99.9 %8u  max %8u"
+    ) % name % (iterations/total_secs) % hist.mean()
+      % hist.percentile(50) % hist.percentile(90) % hist.percentile(99)
+      % hist.percentile(99.9) % hist.max << std::endl;
+    return hist;
+}
+
+/***********************************************************************
+ * The accesses
+ **********************************************************************/
+static void read_time(uhd::usrp::multi_usrp::sptr usrp){
+    usrp->get_time_now();
+}
+
+static void read_sensor(uhd::usrp::multi_usrp::sptr usrp, const std::string &sensor){
+    usrp->get_mboard_sensor(sensor);
+}
+
+static void block_peek(uhd::rfnoc::block_ctrl_base::sptr block){
+    block->sr_read32(uhd::rfnoc::SR_READBACK_REG_ID);
+}
+
+static void block_poke(uhd::rfnoc::block_ctrl_base::sptr block){
+    //selects the user readback register, which nothing else depends on
+    block->sr_write(uhd::rfnoc::SR_READBACK_ADDR, 0);
+}
+
+/*!
+ * Queue timed pokes for a time in the future and report how fast the
+ * host issues them, and when the last one has executed.
+ */
+static void measure_timed(
+    uhd::usrp::multi_usrp::sptr usrp,
+    uhd::rfnoc::block_ctrl_base::sptr block,
+    const size_t iterations,
+    const double lead
+){
+    block->set_command_time(usrp->get_time_now() + uhd::time_spec_t(lead), 0);
+    const bench_clock::time_point start = bench_clock::now();
+    for (size_t i = 0; i < iterations; i++){
+        block_poke(block);
+    }
+    const double issue_secs = ns_since(start)/1e9;
+    block->clear_command_time(0);
+    //the readback is executed after all timed commands before it
+    block_peek(block);
+    const double done_secs = ns_since(start)/1e9;
+
+    std::cout << boost::format(
+        "%-14s %8.0f/s  issued in %.3f ms, executed after %.3f ms (lead %.3f ms)"
+    ) % "timed_poke" % (iterations/issue_secs) % (issue_secs*1e3)
+      % (done_secs*1e3) % (lead*1e3) << std::endl;
+}
+
+/***********************************************************************
+ * Main
+ **********************************************************************/
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    std::string args, tests, sensor, block_id, json_file;
+    size_t iterations;
+    double lead;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("args", po::value<std::string>(&args)->default_value(""), "uhd device address args")
+        ("tests", po::value<std::string>(&tests)->default_value("time,sensor,peek,poke,timed"), "the accesses to measure")
+        ("iterations", po::value<size_t>(&iterations)->default_value(10000), "the number of accesses per test")
+        ("sensor", po::value<std::string>(&sensor)->default_value("ref_locked"), "the motherboard sensor for the sensor test")
+        ("block", po::value<std::string>(&block_id)->default_value("0/Radio_0"), "the RFNoC block for the peek, poke and timed tests")
+        ("lead", po::value<double>(&lead)->default_value(0.5), "how far ahead the timed pokes are scheduled in seconds")
+        ("json_file", po::value<std::string>(&json_file), "write the latency histograms to this file as JSON")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")){
+        std::cout << boost::format("UHD Control Path Benchmark %s") % desc << std::endl;
+        std::cout <<
+        "    Measures the rate and latency of register accesses:\n"
+        "    - time:   read the device time, a 64-bit peek through the radio control core\n"
+        "    - sensor: read a motherboard sensor, like ref_locked through the X300 firmware\n"
+        "    - peek:   read the ID register of an RFNoC block\n"
+        "    - poke:   write a settings register of an RFNoC block, pokes only wait\n"
+        "              for their acknowledgement when the command window is full\n"
+        "    - timed:  queue timed pokes to an RFNoC block\n"
+        << std::endl;
+        return ~0;
+    }
+
+    std::cout << boost::format("Creating the usrp device with: %s...") % args << std::endl;
+    uhd::usrp::multi_usrp::sptr usrp = uhd::usrp::multi_usrp::make(args);
+    std::cout << boost::format("Using Device: %s") % usrp->get_pp_string() << std::endl;
+
+    uhd::rfnoc::block_ctrl_base::sptr block;
+    uhd::device3::sptr dev3 = boost::dynamic_pointer_cast<uhd::device3>(usrp->get_device());
+    if (dev3 and dev3->has_block(block_id)){
+        block = dev3->get_block_ctrl(block_id);
+    }
+
+    std::vector<std::string> test_names;
+    boost::split(test_names, tests, boost::is_any_of(","));
+    uhd::histograms_t histograms;
+    BOOST_FOREACH(const std::string &test, test_names){
+        if (test == "time"){
+            histograms["time"] = measure("time", boost::bind(&read_time, usrp), iterations);
+        }
+        else if (test == "sensor"){
+            histograms["sensor"] = measure("sensor", boost::bind(&read_sensor, usrp, sensor), iterations);
+        }
+        else if (test == "peek" or test == "poke" or test == "timed"){
+            if (not block){
+                std::cout << boost::format("%-14s skipped, no RFNoC block %s") % test % block_id << std::endl;
+            }
+            else if (test == "peek"){
+                histograms["peek"] = measure("peek", boost::bind(&block_peek, block), iterations);
+            }
+            else if (test == "poke"){
+                histograms["poke"] = measure("poke", boost::bind(&block_poke, block), iterations);
+            }
+            else{
+                measure_timed(usrp, block, iterations, lead);
+            }
+        }
+        else{
+            throw uhd::value_error("Unknown test: " + test);
+        }
+    }
+
+    if (vm.count("json_file")){
+        std::ofstream json(json_file.c_str());
+        json << uhd::to_json(histograms) << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
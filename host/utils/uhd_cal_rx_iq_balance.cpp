@@ -108,7 +108,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
     double tx_wave_ampl, tx_offset;
     double freq_start, freq_stop, freq_step;
     size_t nsamps;
-    double precision;
+    double precision, min_gain;
 
     po::options_description desc("Allowed options");
     desc.add_options()
@@ -123,6 +123,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
         ("freq_step", po::value<double>(&freq_step)->default_value(default_freq_step), "Step size for LO sweep in Hz")
         ("nsamps", po::value<size_t>(&nsamps), "Samples per data capture")
         ("precision", po::value<double>(&precision)->default_value(default_precision), "Correction precision (default=0.0001)")
+        ("min_gain", po::value<double>(&min_gain)->default_value(default_min_gain), "Stop refining a correction when a search round gains less than this in dB (0 to disable)")
     ;
 
     po::variables_map vm;
@@ -205,7 +206,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
 
         //capture initial uncorrected value
         capture_samples(usrp, rx_stream, buff, nsamps);
-        const double initial_suppression = compute_tone_dbrms(buff, bb_tone_freq/actual_rx_rate) - compute_tone_dbrms(buff, bb_imag_freq/actual_rx_rate);
+        const double initial_suppression = compute_suppression(buff, bb_tone_freq/actual_rx_rate, bb_imag_freq/actual_rx_rate);
 
         //bounds and results from searching
         double phase_corr_start = -1.0;
@@ -217,8 +218,10 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
         double best_suppression = 0;
         double best_phase_corr = 0;
         double best_ampl_corr = 0;
+        bool first_round = true;
         while (phase_corr_step >= precision or ampl_corr_step >= precision)
         {
+            const double round_start_suppression = best_suppression;
             for (double phase_corr = phase_corr_start + phase_corr_step; phase_corr <= phase_corr_stop - phase_corr_step; phase_corr += phase_corr_step)
             {
                 for (double ampl_corr = ampl_corr_start + ampl_corr_step; ampl_corr <= ampl_corr_stop - ampl_corr_step; ampl_corr += ampl_corr_step)
@@ -228,9 +231,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
 
                     //receive some samples
                     capture_samples(usrp, rx_stream, buff, nsamps);
-                    const double tone_dbrms = compute_tone_dbrms(buff, bb_tone_freq/actual_rx_rate);
-                    const double imag_dbrms = compute_tone_dbrms(buff, bb_imag_freq/actual_rx_rate);
-                    const double suppression = tone_dbrms - imag_dbrms;
+                    const double suppression = compute_suppression(buff, bb_tone_freq/actual_rx_rate, bb_imag_freq/actual_rx_rate);
 
                     if (suppression > best_suppression)
                     {
@@ -247,6 +248,11 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
             ampl_corr_start = best_ampl_corr - ampl_corr_step;
             ampl_corr_stop = best_ampl_corr + ampl_corr_step;
             ampl_corr_step = (ampl_corr_stop - ampl_corr_start)/(num_search_steps+1);
+
+            //stop refining once a round barely improves the result
+            if (not first_round and best_suppression - round_start_suppression < min_gain)
+                break;
+            first_round = false;
         }
 
         if (best_suppression > initial_suppression) //keep result
@@ -115,7 +115,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
     double tx_wave_freq, tx_wave_ampl, rx_offset;
     double freq_start, freq_stop, freq_step;
     size_t nsamps;
-    double precision;
+    double precision, min_gain;
 
     po::options_description desc("Allowed options");
     desc.add_options()
@@ -131,6 +131,7 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
         ("freq_step", po::value<double>(&freq_step)->default_value(default_freq_step), "Step size for LO sweep in Hz")
         ("nsamps", po::value<size_t>(&nsamps), "Samples per data capture")
         ("precision", po::value<double>(&precision)->default_value(default_precision), "Correction precision (default=0.0001)")
+        ("min_gain", po::value<double>(&min_gain)->default_value(default_min_gain), "Stop refining a correction when a search round gains less than this in dB (0 to disable)")
     ;
 
     po::variables_map vm;
@@ -224,8 +225,10 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
         double best_dc_dbrms = initial_dc_dbrms;
         double best_i_corr = 0;
         double best_q_corr = 0;
+        bool first_round = true;
         while (i_corr_step >= precision or q_corr_step >= precision)
         {
+            const double round_start_dc_dbrms = best_dc_dbrms;
             for (double i_corr = i_corr_start + i_corr_step; i_corr <= i_corr_stop - i_corr_step; i_corr += i_corr_step)
             {
                 for (double q_corr = q_corr_start + q_corr_step; q_corr <= q_corr_stop - q_corr_step; q_corr += q_corr_step)
@@ -252,6 +255,11 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
             q_corr_start = best_q_corr - q_corr_step;
             q_corr_stop = best_q_corr + q_corr_step;
             q_corr_step = (q_corr_stop - q_corr_start)/(num_search_steps+1);
+
+            //stop refining once a round barely improves the result
+            if (not first_round and round_start_dc_dbrms - best_dc_dbrms < min_gain)
+                break;
+            first_round = false;
         }
 
         if (best_dc_dbrms < initial_dc_dbrms)   //keep result
@@ -18,10 +18,15 @@
 #include <csignal>
 #include <cstdlib>
 #include <iostream>
+#include <vector>
 
 #include <boost/assign.hpp>
+#include <boost/foreach.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <uhd/config.hpp>
 #include <uhd/image_loader.hpp>
@@ -54,6 +59,38 @@ void sigint_handler(int){
     }
 }
 
+/*
+ * Expand a leading ~ and make an image path absolute.
+ */
+static std::string clean_path(std::string path){
+    if(path == "") return path;
+    #ifndef UHD_PLATFORM_WIN32
+    if(path.find("~") == 0){
+        path.replace(0,1,getenv("HOME"));
+    }
+    #endif /* UHD_PLATFORM_WIN32 */
+    return fs::absolute(path).string();
+}
+
+/*
+ * Load one target of a multi-target session, the result is a message.
+ */
+static void load_target(const uhd::image_loader::image_loader_args_t &image_loader_args,
+                        std::string &result,
+                        bool &success){
+    success = false;
+    try{
+        if(uhd::image_loader::load(image_loader_args)){
+            result = "successful";
+            success = true;
+        }
+        else result = "no applicable UHD device found";
+    }
+    catch(const std::exception &e){
+        result = std::string("failed: ") + e.what();
+    }
+}
+
 int UHD_SAFE_MAIN(int argc, char *argv[]){
 
     std::string fw_path = "";
@@ -62,7 +99,8 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
     po::options_description desc("Allowed options");
     desc.add_options()
         ("help", "help message")
-        ("args", po::value<std::string>()->default_value(""), "Device args, optional loader args")
+        ("args", po::value<std::vector<std::string> >()->default_value(std::vector<std::string>(1, ""), "")->composing(),
+            "Device args, optional loader args. Give it several times to load many devices at once.")
         ("fw-path", po::value<std::string>(&fw_path)->default_value(""), "Firmware path (uses default if none specified)")
         ("fpga-path", po::value<std::string>(&fpga_path)->default_value(""), "FPGA path (uses default if none specified)")
         ("no-fw", "Don't burn firmware")
@@ -83,45 +121,55 @@ int UHD_SAFE_MAIN(int argc, char *argv[]){
         return EXIT_FAILURE;
     }
 
-    // Convert user options
-    uhd::image_loader::image_loader_args_t image_loader_args;
-    image_loader_args.args          = vm["args"].as<std::string>();
-    image_loader_args.load_firmware = (vm.count("no-fw") == 0);
-    image_loader_args.load_fpga     = (vm.count("no-fpga") == 0);
-    image_loader_args.firmware_path = vm["fw-path"].as<std::string>();
-    image_loader_args.fpga_path     = vm["fpga-path"].as<std::string>();
-
-    // Force user to specify a device
-    if(not image_loader_args.args.has_key("type")){
-        throw uhd::runtime_error("You must specify a device type.");
-    }
-
-    // Clean up paths, if given
-    if(image_loader_args.firmware_path != ""){
-        #ifndef UHD_PLATFORM_WIN32
-        if(image_loader_args.firmware_path.find("~") == 0){
-            image_loader_args.firmware_path.replace(0,1,getenv("HOME"));
+    // Convert user options, one set per target
+    const std::vector<std::string> args_list = vm["args"].as<std::vector<std::string> >();
+    std::vector<uhd::image_loader::image_loader_args_t> targets;
+    BOOST_FOREACH(const std::string &args, args_list){
+        uhd::image_loader::image_loader_args_t image_loader_args;
+        image_loader_args.args          = args;
+        image_loader_args.load_firmware = (vm.count("no-fw") == 0);
+        image_loader_args.load_fpga     = (vm.count("no-fpga") == 0);
+        image_loader_args.firmware_path = clean_path(vm["fw-path"].as<std::string>());
+        image_loader_args.fpga_path     = clean_path(vm["fpga-path"].as<std::string>());
+
+        // Force user to specify a device
+        if(not image_loader_args.args.has_key("type")){
+            throw uhd::runtime_error("You must specify a device type.");
         }
-        #endif /* UHD_PLATFORM_WIN32 */
-        image_loader_args.firmware_path = fs::absolute(image_loader_args.firmware_path).string();
-    }
-    if(image_loader_args.fpga_path != ""){
-        #ifndef UHD_PLATFORM_WIN32
-        if(image_loader_args.fpga_path.find("~") == 0){
-            image_loader_args.fpga_path.replace(0,1,getenv("HOME"));
-        }
-        #endif /* UHD_PLATFORM_WIN32 */
-        image_loader_args.fpga_path = fs::absolute(image_loader_args.fpga_path).string();
+        targets.push_back(image_loader_args);
     }
 
     // Detect which type of device we're working with
-    device_type = image_loader_args.args.get("type","");
+    device_type = targets.front().args.get("type","");
 
     std::signal(SIGINT, &sigint_handler);
-    if(not uhd::image_loader::load(image_loader_args)){
-        std::cerr << "No applicable UHD devices found" << std::endl;
-        return EXIT_FAILURE;
+    if(targets.size() == 1){
+        if(not uhd::image_loader::load(targets.front())){
+            std::cerr << "No applicable UHD devices found" << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // Load all targets at once, each one in its own thread
+    std::cout << boost::format("Loading images onto %d devices at once...") % targets.size() << std::endl;
+    std::vector<std::string> results(targets.size());
+    boost::scoped_array<bool> successes(new bool[targets.size()]);
+    boost::thread_group threads;
+    for(size_t i = 0; i < targets.size(); i++){
+        threads.create_thread(boost::bind(&load_target,
+                                          boost::cref(targets[i]),
+                                          boost::ref(results[i]),
+                                          boost::ref(successes[i])));
+    }
+    threads.join_all();
+
+    bool all_successful = true;
+    std::cout << std::endl << "Summary:" << std::endl;
+    for(size_t i = 0; i < targets.size(); i++){
+        std::cout << boost::format("  %s: %s") % targets[i].args.to_string() % results[i] << std::endl;
+        all_successful = all_successful and successes[i];
     }
 
-    return EXIT_SUCCESS;
+    return all_successful ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -46,6 +46,9 @@ static const size_t num_search_steps = 5;
 static const double default_precision = 0.0001;
 static const double default_freq_step = 7.3e6;
 static const size_t default_fft_bin_size = 1000;
+static const double default_min_gain = 0.05;
+//! Renormalize the rotating phasor of a tone_meter this often to stop its magnitude drifting
+static const size_t tone_renorm_len = 1024;
 
 /***********************************************************************
  * Set standard defaults for devices
@@ -153,17 +156,69 @@ private:
 /***********************************************************************
  * Compute power of a tone
  **********************************************************************/
+/*!
+ * Shift the samples so the tone at freq is down at DC
+ * and average the samples to measure the DC component.
+ * The shift is done by rotating a phasor instead of computing a sine
+ * and a cosine for each sample.
+ */
+class tone_meter
+{
+public:
+    tone_meter(const double freq):  //freq is fractional
+        _freq(freq), _step(std::polar(1.0, -freq*tau)), _phasor(1.0), _sum(0.0), _count(0)
+    {
+        /* NOP */
+    }
+
+    inline void add(const samp_type &samp)
+    {
+        _sum += _phasor * std::complex<double>(samp);
+        _phasor *= _step;
+        if (++_count % tone_renorm_len == 0)
+            _phasor = std::polar(1.0, -_freq*tau*double(_count));
+    }
+
+    inline double dbrms(void) const
+    {
+        return 20*std::log10(std::abs(_sum/double(_count)));
+    }
+
+private:
+    const double _freq;
+    const std::complex<double> _step;
+    std::complex<double> _phasor;
+    std::complex<double> _sum;
+    size_t _count;
+};
+
 static inline double compute_tone_dbrms(
     const std::vector<samp_type> &samples,
     const double freq)  //freq is fractional
 {
-    //shift the samples so the tone at freq is down at DC
-    //and average the samples to measure the DC component
-    samp_type average = 0;
+    tone_meter tone(freq);
     for (size_t i = 0; i < samples.size(); i++)
-        average += samp_type(std::polar(1.0, -freq*tau*i)) * samples[i];
+        tone.add(samples[i]);
+    return tone.dbrms();
+}
 
-    return 20*std::log10(std::abs(average/float(samples.size())));
+/*!
+ * Compute the suppression of an image in dB, which is the power of the
+ * tone at tone_freq minus the power at imag_freq, with one pass over
+ * the samples.
+ */
+static inline double compute_suppression(
+    const std::vector<samp_type> &samples,
+    const double tone_freq, //freq is fractional
+    const double imag_freq) //freq is fractional
+{
+    tone_meter tone(tone_freq), imag(imag_freq);
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        tone.add(samples[i]);
+        imag.add(samples[i]);
+    }
+    return tone.dbrms() - imag.dbrms();
 }
 
 /***********************************************************************
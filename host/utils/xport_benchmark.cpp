@@ -0,0 +1,295 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// Streams CHDR over transports to an endpoint which sends every frame
+// back, like a UDP echo server or a device loopback, and reports the
+// throughput, loss, CPU time per byte and the get_recv_buff() waits
+// for a sweep of frame sizes and frame counts.
+
+#include "../lib/transport/xport_benchmarker.hpp"
+#include <uhd/utils/safe_main.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/transport/udp_zero_copy.hpp>
+#include <uhd/transport/usb_zero_copy.hpp>
+#include <uhd/transport/muxed_zero_copy_if.hpp>
+#include <uhd/exception.hpp>
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/asio.hpp>
+#include <boost/chrono.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <iostream>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace uhd::transport;
+
+/***********************************************************************
+ * A UDP echo server on the host, to benchmark the host side alone
+ **********************************************************************/
+static void udp_echo(const std::string &addr, const std::string &port){
+    boost::asio::io_service io_service;
+    boost::asio::ip::udp::socket socket(io_service, boost::asio::ip::udp::endpoint(
+        boost::asio::ip::address::from_string(addr), boost::lexical_cast<unsigned short>(port)
+    ));
+    std::vector<char> buff(65536);
+    boost::asio::ip::udp::endpoint sender;
+    while (not boost::this_thread::interruption_requested()){
+        if (not socket.available()){
+            boost::this_thread::sleep(boost::posix_time::microseconds(10));
+            continue;
+        }
+        const size_t len = socket.receive_from(boost::asio::buffer(buff), sender);
+        socket.send_to(boost::asio::buffer(&buff.front(), len), sender);
+    }
+}
+
+/***********************************************************************
+ * Transports
+ **********************************************************************/
+//! The stream number of a frame for the muxed transport, the low byte of the SID
+static uint32_t classify_by_sid(const bool big_endian, void *buff, size_t){
+    const uint32_t sid = reinterpret_cast<const uint32_t *>(buff)[1];
+    return (big_endian? uhd::ntohx(sid) : uhd::wtohx(sid)) & 0xff;
+}
+
+struct bench_config_t{
+    std::string type, addr, port;
+    uint16_t vid, pid;
+    int recv_interface, send_interface;
+    unsigned char recv_endpoint, send_endpoint;
+    uhd::device_addr_t hints;
+    bool muxed, big_endian;
+};
+
+static zero_copy_if::sptr make_xport(
+    const bench_config_t &config, const size_t frame_size, const size_t num_frames
+){
+    if (config.type == "udp"){
+        zero_copy_xport_params params;
+        params.recv_frame_size = frame_size;
+        params.send_frame_size = frame_size;
+        params.num_recv_frames = num_frames;
+        params.num_send_frames = num_frames;
+        udp_zero_copy::buff_params buff_params;
+        return udp_zero_copy::make(config.addr, config.port, params, buff_params, config.hints);
+    }
+    if (config.type == "usb"){
+        std::vector<usb_device_handle::sptr> handles = usb_device_handle::get_device_list(config.vid, config.pid);
+        if (handles.empty()) throw uhd::key_error("No USB device found with the given vid and pid");
+        uhd::device_addr_t hints = config.hints;
+        hints["recv_frame_size"] = boost::lexical_cast<std::string>(frame_size);
+        hints["send_frame_size"] = boost::lexical_cast<std::string>(frame_size);
+        hints["num_recv_frames"] = boost::lexical_cast<std::string>(num_frames);
+        hints["num_send_frames"] = boost::lexical_cast<std::string>(num_frames);
+        return usb_zero_copy::make(handles.front(),
+            config.recv_interface, config.recv_endpoint,
+            config.send_interface, config.send_endpoint, hints
+        );
+    }
+    throw uhd::value_error("Unknown transport type: " + config.type);
+}
+
+/*!
+ * Make the transports of one run, each sends to and receives from itself.
+ * Muxed transports share one base transport and are told apart by SID.
+ */
+static std::vector<zero_copy_if::sptr> make_xports(
+    const bench_config_t &config, const size_t num_xports,
+    const size_t frame_size, const size_t num_frames,
+    muxed_zero_copy_if::sptr &muxed
+){
+    std::vector<zero_copy_if::sptr> xports;
+    if (config.muxed){
+        muxed = muxed_zero_copy_if::make(
+            make_xport(config, frame_size, num_frames),
+            boost::bind(&classify_by_sid, config.big_endian, _1, _2),
+            num_xports
+        );
+        for (size_t i = 0; i < num_xports; i++) xports.push_back(muxed->make_stream(i));
+        return xports;
+    }
+    if (config.type == "usb" and num_xports > 1){
+        throw uhd::value_error("A USB endpoint pair carries one transport, use --muxed for more");
+    }
+    for (size_t i = 0; i < num_xports; i++){
+        xports.push_back(make_xport(config, frame_size, num_frames));
+    }
+    return xports;
+}
+
+/***********************************************************************
+ * Benchmark
+ **********************************************************************/
+static void run_one(
+    xport_benchmarker &benchmarker, zero_copy_if::sptr xport, const uint32_t sid,
+    const bench_config_t &config, const uint32_t duration_ms, const size_t frame_size,
+    xport_benchmark_results_t &results
+){
+    results = benchmarker.benchmark_chdr(xport, xport, sid, config.big_endian, duration_ms, frame_size);
+}
+
+static void run_sweep_point(
+    const bench_config_t &config, const size_t num_xports,
+    const size_t frame_size, const size_t num_frames, const uint32_t duration_ms
+){
+    muxed_zero_copy_if::sptr muxed;
+    const std::vector<zero_copy_if::sptr> xports = make_xports(config, num_xports, frame_size, num_frames, muxed);
+    std::vector<boost::shared_ptr<xport_benchmarker> > benchmarkers;
+    std::vector<xport_benchmark_results_t> results(xports.size());
+
+    typedef boost::chrono::process_cpu_clock cpu_clock;
+    const cpu_clock::time_point cpu_start = cpu_clock::now();
+    boost::thread_group threads;
+    for (size_t i = 0; i < xports.size(); i++){
+        benchmarkers.push_back(boost::shared_ptr<xport_benchmarker>(new xport_benchmarker()));
+        threads.create_thread(boost::bind(&run_one,
+            boost::ref(*benchmarkers.back()), xports[i], uint32_t(i), boost::cref(config),
+            duration_ms, frame_size, boost::ref(results[i])
+        ));
+    }
+    threads.join_all();
+    const cpu_clock::duration cpu_used = cpu_clock::now() - cpu_start;
+    const double process_cpu_s = (cpu_used.count().user + cpu_used.count().system)/1e9;
+
+    //sum up the transports of the run
+    xport_benchmark_results_t total;
+    BOOST_FOREACH(const xport_benchmark_results_t &r, results){
+        total.tx_bytes += r.tx_bytes;
+        total.rx_bytes += r.rx_bytes;
+        total.rx_packets += r.rx_packets;
+        total.lost_packets += r.lost_packets;
+        total.tx_timeouts += r.tx_timeouts;
+        total.rx_timeouts += r.rx_timeouts;
+        total.data_errors += r.data_errors;
+        total.duration_s = std::max(total.duration_s, r.duration_s);
+        total.tx_cpu_s += r.tx_cpu_s;
+        total.rx_cpu_s += r.rx_cpu_s;
+        for (size_t b = 0; b < r.recv_wait.buckets.size(); b++){
+            total.recv_wait.buckets[b] += r.recv_wait.buckets[b];
+        }
+        total.recv_wait.min = (total.recv_wait.count == 0)? r.recv_wait.min : std::min(total.recv_wait.min, r.recv_wait.min);
+        total.recv_wait.max = std::max(total.recv_wait.max, r.recv_wait.max);
+        total.recv_wait.count += r.recv_wait.count;
+        total.recv_wait.sum += r.recv_wait.sum;
+    }
+
+    const double rx_bytes = std::max<double>(total.rx_bytes, 1.0);
+    const double total_pkts = std::max<double>(total.rx_packets + total.lost_packets, 1.0);
+    std::cout << boost::format("%s,%u,%u,%u,%.2f,%.2f,%.4f,%.3f,%.3f,%u,%u,%u,%u,%u,%u")
+        % (config.muxed? "muxed_" + config.type : config.type) % num_xports % frame_size % num_frames
+        % (total.tx_bytes/total.duration_s/1e6) % (total.rx_bytes/total.duration_s/1e6)
+        % (100.0*total.lost_packets/total_pkts)
+        % ((total.tx_cpu_s + total.rx_cpu_s)*1e9/rx_bytes) % (process_cpu_s*1e9/rx_bytes)
+        % total.recv_wait.percentile(50) % total.recv_wait.percentile(99) % total.recv_wait.max
+        % total.tx_timeouts % total.rx_timeouts % total.data_errors
+    << std::endl;
+}
+
+/***********************************************************************
+ * Main
+ **********************************************************************/
+template <typename T>
+static std::vector<T> parse_list(const std::string &list){
+    std::vector<std::string> tokens;
+    boost::split(tokens, list, boost::is_any_of(","));
+    std::vector<T> values;
+    BOOST_FOREACH(const std::string &token, tokens){
+        if (not token.empty()) values.push_back(boost::lexical_cast<T>(token));
+    }
+    return values;
+}
+
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    bench_config_t config;
+    std::string hints, frame_sizes, frame_counts, xport_counts;
+    uint32_t duration_ms;
+    unsigned vid, pid, recv_endpoint, send_endpoint;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("type", po::value<std::string>(&config.type)->default_value("udp"), "the transport: udp or usb")
+        ("addr", po::value<std::string>(&config.addr)->default_value("127.0.0.1"), "the address of the UDP echo endpoint")
+        ("port", po::value<std::string>(&config.port)->default_value("49200"), "the port of the UDP echo endpoint")
+        ("echo", "run a UDP echo server at addr and port in this process")
+        ("vid", po::value<unsigned>(&vid)->default_value(0x2500), "the USB vendor ID")
+        ("pid", po::value<unsigned>(&pid)->default_value(0x0020), "the USB product ID")
+        ("recv_interface", po::value<int>(&config.recv_interface)->default_value(2), "the USB interface to receive on")
+        ("recv_endpoint", po::value<unsigned>(&recv_endpoint)->default_value(6), "the USB endpoint to receive on")
+        ("send_interface", po::value<int>(&config.send_interface)->default_value(1), "the USB interface to send on")
+        ("send_endpoint", po::value<unsigned>(&send_endpoint)->default_value(2), "the USB endpoint to send on")
+        ("hints", po::value<std::string>(&hints)->default_value(""), "transport hints, like recv_buff_size=1e6")
+        ("muxed", "share one transport between all the streams, told apart by SID")
+        ("big_endian", "pack the CHDR headers big endian (default little endian)")
+        ("frame_sizes", po::value<std::string>(&frame_sizes)->default_value("1472,4000,8000"), "the frame sizes to sweep")
+        ("num_frames", po::value<std::string>(&frame_counts)->default_value("32,128"), "the frame counts to sweep")
+        ("num_xports", po::value<std::string>(&xport_counts)->default_value("1,2"), "the numbers of concurrent transports to sweep")
+        ("duration", po::value<uint32_t>(&duration_ms)->default_value(2000), "the duration of each run in ms")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")){
+        std::cout << boost::format("UHD Transport Benchmark %s") % desc << std::endl;
+        std::cout <<
+        "    Streams CHDR over transports to an endpoint that sends every frame back,\n"
+        "    like a UDP echo server (see --echo) or a device with a loopback image.\n"
+        "    Each sweep point prints one CSV line:\n"
+        "    - tx_MBps, rx_MBps: the throughput of all the transports together\n"
+        "    - loss_pct:         the packets missing from the sequence numbers\n"
+        "    - xport_cpu_ns_per_byte: CPU time of the streaming threads per byte received\n"
+        "    - proc_cpu_ns_per_byte:  CPU time of the process per byte, with the\n"
+        "                             transport threads and the echo server\n"
+        "    - wait_p50_ns, wait_p99_ns, wait_max_ns: the time in get_recv_buff()\n"
+        << std::endl;
+        return ~0;
+    }
+
+    config.vid = uint16_t(vid);
+    config.pid = uint16_t(pid);
+    config.recv_endpoint = (unsigned char)recv_endpoint;
+    config.send_endpoint = (unsigned char)send_endpoint;
+    config.hints = uhd::device_addr_t(hints);
+    config.muxed = vm.count("muxed") != 0;
+    config.big_endian = vm.count("big_endian") != 0;
+
+    boost::thread_group echo_thread;
+    if (vm.count("echo")){
+        echo_thread.create_thread(boost::bind(&udp_echo, config.addr, config.port));
+    }
+
+    std::cout << "type,xports,frame_size,num_frames,tx_MBps,rx_MBps,loss_pct,"
+        "xport_cpu_ns_per_byte,proc_cpu_ns_per_byte,wait_p50_ns,wait_p99_ns,wait_max_ns,"
+        "tx_timeouts,rx_timeouts,data_errors" << std::endl;
+    BOOST_FOREACH(const size_t num_xports, parse_list<size_t>(xport_counts)){
+        BOOST_FOREACH(const size_t frame_size, parse_list<size_t>(frame_sizes)){
+            BOOST_FOREACH(const size_t num_frames, parse_list<size_t>(frame_counts)){
+                run_sweep_point(config, num_xports, frame_size, num_frames, duration_ms);
+            }
+        }
+    }
+
+    echo_thread.interrupt_all();
+    echo_thread.join_all();
+    return EXIT_SUCCESS;
+}
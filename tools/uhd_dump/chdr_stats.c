@@ -0,0 +1,639 @@
+//
+// Copyright 2017 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+//
+// Offline analyzer for large CHDR captures.
+//
+// chdr_log prints every packet. This one summarizes a capture per stream,
+// a stream being the packets of one SID and one CHDR packet type:
+// - sequence errors and the number of lost packets,
+// - the packet rate per time bin and a histogram of it,
+// - a histogram of the packet inter-arrival times,
+// - the flow control credit: for every data stream, the packets between
+//   its last data packet and the last flow control packet of the reverse
+//   SID, which is where gen3 sends the acks.
+// With -t, the packet rate and credit are also printed per time bin, one
+// line per stream and bin, to be plotted.
+//
+// The capture is memory mapped and parsed without libpcap. One pass
+// indexes the CHDR packets, then the index is split into one contiguous
+// slice per thread, and the per thread results are merged in order.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pcap.h>
+#include <netinet/in.h>
+#include <time.h>
+#include <unistd.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "uhd_dump.h"
+
+// pcap file format, both the microsecond and nanosecond flavors
+#define PCAP_MAGIC_US 0xa1b2c3d4
+#define PCAP_MAGIC_NS 0xa1b23c4d
+#define PCAP_FILE_HDR_SIZE 24
+#define PCAP_REC_HDR_SIZE 16
+#define LINKTYPE_ETHERNET 1
+
+#define ETH_TYPE_IP 0x0800
+#define ETH_TYPE_VLAN 0x8100
+#define IP_PROTO_UDP 17
+
+#define MAX_THREADS 64
+#define MAX_STREAMS 1024
+#define HIST_BINS 48
+
+struct pkt_ref {
+  u64 offset;  // Offset of the CHDR header in the file
+  u64 ts_ns;   // Capture time, from the first packet of the file
+  u32 size;    // Captured bytes from the CHDR header on
+};
+
+struct stream_stats {
+  int used;
+  u32 sid;
+  int type;
+  u64 packets;
+  u64 bytes;
+  u64 seq_errors;
+  u64 seq_lost;
+  int first_seq;
+  int last_seq;
+  u64 first_ns;
+  u64 last_ns;
+  u64 iat_hist[HIST_BINS];  // Inter-arrival times, bin n is [2^n,2^(n+1)) ns
+  u64 iat_min;
+  u64 iat_max;
+  double iat_sum;
+  double iat_sum2;
+  u64 bin0;          // First time bin in the arrays below
+  u64 nbins;
+  u32 *rate;         // Packets per time bin
+  int *seq_at_bin;   // Last sequence number of every time bin, -1 for none
+};
+
+struct worker {
+  pthread_t thread;
+  const u8 *file;
+  const struct pkt_ref *begin;
+  const struct pkt_ref *end;
+  u64 bin_ns;
+  struct stream_stats streams[MAX_STREAMS];
+};
+
+static const char *type_names[4] = {"data", "flow ctrl", "command", "response"};
+
+void usage()
+{
+  fprintf(stderr,"Usage: chdr_stats [-p udp_port] [-j threads] [-b bin_us] [-t] filename.pcap\n");
+  exit(2);
+}
+
+static double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec/1e9;
+}
+
+// The file is not aligned, so words are read a byte at a time.
+static u32 load_be32(const u8 *p)
+{
+  return ((u32)p[0] << 24) | ((u32)p[1] << 16) | ((u32)p[2] << 8) | (u32)p[3];
+}
+
+static u16 load_be16(const u8 *p)
+{
+  return (u16)((p[0] << 8) | p[1]);
+}
+
+static u32 load_u32(const u8 *p, int swapped)
+{
+  u32 x;
+  memcpy(&x,p,sizeof(x));
+  return swapped ? __builtin_bswap32(x) : x;
+}
+
+static int floor_log2(u64 x)
+{
+  int n = 0;
+  while (x >>= 1)
+    n++;
+  return n;
+}
+
+//
+// Index the CHDR packets of the capture
+//
+// Returns the number of packets in the index, which is allocated here.
+//
+static u64 index_capture(const u8 *file, u64 file_size, u16 udp_port, struct pkt_ref **index, u64 *total_packets)
+{
+  u32 magic;
+  int swapped, nanosec;
+  u64 offset, capacity, count;
+  u64 origin_ns = 0;
+  u64 ts_ns;
+  u32 caplen, l2, l3, ihl;
+  const u8 *pkt;
+
+  if (file_size < PCAP_FILE_HDR_SIZE) {
+    fprintf(stderr,"File is too short for a pcap file.\n");
+    exit(2);
+  }
+  memcpy(&magic,file,sizeof(magic));
+  if (magic == PCAP_MAGIC_US || magic == PCAP_MAGIC_NS)
+    swapped = FALSE;
+  else if (__builtin_bswap32(magic) == PCAP_MAGIC_US || __builtin_bswap32(magic) == PCAP_MAGIC_NS)
+    swapped = TRUE;
+  else {
+    fprintf(stderr,"Not a pcap file (pcapng is not supported, convert it with editcap -F pcap).\n");
+    exit(2);
+  }
+  nanosec = (load_u32(file,swapped) == PCAP_MAGIC_NS);
+  if (load_u32(file+20,swapped) != LINKTYPE_ETHERNET) {
+    fprintf(stderr,"Only Ethernet captures are supported.\n");
+    exit(2);
+  }
+
+  capacity = 1 << 20;
+  count = 0;
+  *index = malloc(capacity * sizeof(struct pkt_ref));
+  *total_packets = 0;
+
+  for (offset = PCAP_FILE_HDR_SIZE; offset + PCAP_REC_HDR_SIZE <= file_size; offset += PCAP_REC_HDR_SIZE + caplen) {
+    caplen = load_u32(file+offset+8,swapped);
+    if (offset + PCAP_REC_HDR_SIZE + caplen > file_size) {
+      fprintf(stderr,"Capture is truncated, the last packet is ignored.\n");
+      break;
+    }
+    ts_ns = (u64)load_u32(file+offset,swapped) * 1000000000 +
+      (u64)load_u32(file+offset+4,swapped) * (nanosec ? 1 : 1000);
+    if ((*total_packets)++ == 0)
+      origin_ns = ts_ns;
+    // The packets of a capture can be slightly out of order
+    if (ts_ns < origin_ns)
+      ts_ns = origin_ns;
+    pkt = file + offset + PCAP_REC_HDR_SIZE;
+
+    // Ethernet, with an optional VLAN tag
+    l2 = ETH_SIZE;
+    if (caplen < l2)
+      continue;
+    if (load_be16(pkt+12) == ETH_TYPE_VLAN) {
+      l2 += 4;
+      if (caplen < l2 || load_be16(pkt+16) != ETH_TYPE_IP)
+        continue;
+    } else if (load_be16(pkt+12) != ETH_TYPE_IP)
+      continue;
+
+    // IPv4, UDP, not fragmented
+    if (caplen < l2 + IP_SIZE || (pkt[l2] >> 4) != 4 || pkt[l2+9] != IP_PROTO_UDP)
+      continue;
+    if ((load_be16(pkt+l2+6) & 0x3FFF) != 0)
+      continue;
+    ihl = (pkt[l2] & 0xF) * 4;
+    l3 = l2 + ihl;
+    if (caplen < l3 + UDP_SIZE + CHDR_SIZE)
+      continue;
+    if (load_be16(pkt+l3) != udp_port && load_be16(pkt+l3+2) != udp_port)
+      continue;
+
+    if (count == capacity) {
+      capacity *= 2;
+      *index = realloc(*index,capacity * sizeof(struct pkt_ref));
+    }
+    (*index)[count].offset = offset + PCAP_REC_HDR_SIZE + l3 + UDP_SIZE;
+    (*index)[count].ts_ns = ts_ns - origin_ns;
+    (*index)[count].size = caplen - l3 - UDP_SIZE;
+    count++;
+  }
+  return count;
+}
+
+//
+// Per stream statistics
+//
+static struct stream_stats *find_stream(struct stream_stats *streams, u32 sid, int type)
+{
+  u32 x, probes;
+  x = ((sid * 2654435761u) ^ (u32)type) % MAX_STREAMS;
+  for (probes = 0; streams[x].used && (streams[x].sid != sid || streams[x].type != type); probes++) {
+    if (probes == MAX_STREAMS) {
+      fprintf(stderr,"More than %d streams in the capture, is this really CHDR?\n",MAX_STREAMS);
+      exit(2);
+    }
+    x = (x + 1) % MAX_STREAMS;
+  }
+  if (!streams[x].used) {
+    memset(&streams[x],0,sizeof(struct stream_stats));
+    streams[x].used = TRUE;
+    streams[x].sid = sid;
+    streams[x].type = type;
+    streams[x].first_seq = streams[x].last_seq = -1;
+    streams[x].iat_min = (u64)-1;
+  }
+  return &streams[x];
+}
+
+static void alloc_bins(struct stream_stats *stream, u64 bin0, u64 nbins)
+{
+  u64 x;
+  stream->bin0 = bin0;
+  stream->nbins = nbins;
+  stream->rate = calloc(nbins,sizeof(u32));
+  stream->seq_at_bin = malloc(nbins * sizeof(int));
+  for (x = 0; x < nbins; x++)
+    stream->seq_at_bin[x] = -1;
+}
+
+static void add_inter_arrival(struct stream_stats *stream, u64 iat)
+{
+  int bin = iat ? floor_log2(iat) : 0;
+  if (bin >= HIST_BINS)
+    bin = HIST_BINS - 1;
+  stream->iat_hist[bin]++;
+  if (iat < stream->iat_min)
+    stream->iat_min = iat;
+  if (iat > stream->iat_max)
+    stream->iat_max = iat;
+  stream->iat_sum += (double)iat;
+  stream->iat_sum2 += (double)iat * (double)iat;
+}
+
+// Count a packet into its sequence, the flow control acks do not count up by one.
+static void add_seq(struct stream_stats *stream, int seq)
+{
+  int lost;
+  if (stream->last_seq >= 0 && stream->type != 1) {
+    lost = (seq - stream->last_seq - 1) & 0xFFF;
+    if (lost) {
+      stream->seq_errors++;
+      stream->seq_lost += lost;
+    }
+  }
+  stream->last_seq = seq;
+}
+
+void *analyze_slice(void *arg)
+{
+  struct worker *worker = (struct worker *)arg;
+  const struct pkt_ref *ref;
+  struct stream_stats *stream;
+  const u8 *chdr;
+  u32 header, sid;
+  int type, seq;
+  u64 bin, bin0, nbins;
+
+  // The time bins of this slice
+  bin0 = (u64)-1;
+  nbins = 0;
+  for (ref = worker->begin; ref != worker->end; ref++) {
+    bin = ref->ts_ns / worker->bin_ns;
+    if (bin < bin0)
+      bin0 = bin;
+    if (bin + 1 > nbins)
+      nbins = bin + 1;
+  }
+  nbins -= bin0;
+
+  for (ref = worker->begin; ref != worker->end; ref++) {
+    chdr = worker->file + ref->offset;
+    header = load_be32(chdr);
+    sid = load_be32(chdr+4);
+    type = (header >> 30) & 0x3;
+    seq = (header >> 16) & 0xFFF;
+
+    stream = find_stream(worker->streams,sid,type);
+    if (stream->packets == 0) {
+      alloc_bins(stream,bin0,nbins);
+      stream->first_seq = seq;
+      stream->first_ns = ref->ts_ns;
+    } else
+      add_inter_arrival(stream,ref->ts_ns > stream->last_ns ? ref->ts_ns - stream->last_ns : 0);
+    add_seq(stream,seq);
+    stream->last_ns = ref->ts_ns;
+    stream->packets++;
+    stream->bytes += header & (SIZE);
+
+    bin = ref->ts_ns / worker->bin_ns - bin0;
+    stream->rate[bin]++;
+    stream->seq_at_bin[bin] = seq;
+  }
+  return NULL;
+}
+
+// Merge the streams of a slice into the ones of all the slices before it.
+static void merge_slice(struct stream_stats *total, const struct stream_stats *slice, u64 nbins)
+{
+  struct stream_stats *stream;
+  const struct stream_stats *part;
+  int x;
+  u64 y;
+
+  for (x = 0; x < MAX_STREAMS; x++) {
+    part = &slice[x];
+    if (!part->used)
+      continue;
+    stream = find_stream(total,part->sid,part->type);
+    if (stream->packets == 0) {
+      alloc_bins(stream,0,nbins);
+      stream->first_seq = part->first_seq;
+      stream->first_ns = part->first_ns;
+    } else {
+      // The packets on both sides of the slice boundary
+      add_inter_arrival(stream,part->first_ns > stream->last_ns ? part->first_ns - stream->last_ns : 0);
+      add_seq(stream,part->first_seq);
+    }
+    stream->last_seq = part->last_seq;
+    stream->last_ns = part->last_ns;
+    stream->packets += part->packets;
+    stream->bytes += part->bytes;
+    stream->seq_errors += part->seq_errors;
+    stream->seq_lost += part->seq_lost;
+    for (y = 0; y < HIST_BINS; y++)
+      stream->iat_hist[y] += part->iat_hist[y];
+    if (part->iat_min < stream->iat_min)
+      stream->iat_min = part->iat_min;
+    if (part->iat_max > stream->iat_max)
+      stream->iat_max = part->iat_max;
+    stream->iat_sum += part->iat_sum;
+    stream->iat_sum2 += part->iat_sum2;
+    for (y = 0; y < part->nbins; y++) {
+      stream->rate[part->bin0 + y] += part->rate[y];
+      if (part->seq_at_bin[y] >= 0)
+        stream->seq_at_bin[part->bin0 + y] = part->seq_at_bin[y];
+    }
+    free(part->rate);
+    free(part->seq_at_bin);
+  }
+}
+
+//
+// Reporting
+//
+static void print_stream_sid(u32 sid)
+{
+  fprintf(stdout,"%02x.%02x->%02x.%02x",(sid >> 24) & 0xFF,(sid >> 16) & 0xFF,(sid >> 8) & 0xFF,sid & 0xFF);
+}
+
+static void print_histogram(const u64 *hist, const char *unit)
+{
+  int x, first, last, bar;
+  u64 max = 0;
+  first = HIST_BINS;
+  last = -1;
+  for (x = 0; x < HIST_BINS; x++) {
+    if (hist[x] == 0)
+      continue;
+    if (first == HIST_BINS)
+      first = x;
+    last = x;
+    if (hist[x] > max)
+      max = hist[x];
+  }
+  for (x = first; x <= last; x++) {
+    bar = (int)((hist[x] * 50 + max - 1) / max);
+    fprintf(stdout,"      %12lu - %12lu %s %10lu %.*s\n",
+            (x ? 1UL << x : 0UL),(1UL << (x+1)) - 1,unit,hist[x],bar,
+            "##################################################");
+  }
+}
+
+// The flow control credit of every time bin: the packets of the data stream
+// after the last ack of the flow control stream. -1 until both were seen.
+static int *credit_timeline(const struct stream_stats *data, const struct stream_stats *fc, u64 nbins)
+{
+  int *credit;
+  int data_seq = -1, fc_seq = -1;
+  u64 x;
+  credit = malloc(nbins * sizeof(int));
+  for (x = 0; x < nbins; x++) {
+    if (data->seq_at_bin[x] >= 0)
+      data_seq = data->seq_at_bin[x];
+    if (fc->seq_at_bin[x] >= 0)
+      fc_seq = fc->seq_at_bin[x];
+    credit[x] = (data_seq < 0 || fc_seq < 0) ? -1 : (data_seq - fc_seq) & 0xFFF;
+  }
+  return credit;
+}
+
+static void print_stream(const struct stream_stats *stream, const struct stream_stats *streams, u64 nbins, u64 bin_ns, int timeline)
+{
+  const struct stream_stats *fc = NULL;
+  int *credit = NULL;
+  u64 rate_hist[HIST_BINS];
+  u64 x, peak = 0, credit_max = 0, credit_bins = 0;
+  double duration, credit_sum = 0;
+  u32 fc_sid;
+  int y;
+
+  duration = (double)(stream->last_ns - stream->first_ns) / 1e9;
+  fprintf(stdout,"\n");
+  print_stream_sid(stream->sid);
+  fprintf(stdout," %s\n",type_names[stream->type]);
+  fprintf(stdout,"    packets %lu, bytes %lu, %.3f s",stream->packets,stream->bytes,duration);
+  if (duration > 0)
+    fprintf(stdout,", %.1f packets/s, %.3f Mbit/s",(double)(stream->packets-1)/duration,(double)stream->bytes*8/duration/1e6);
+  fprintf(stdout,"\n");
+  if (stream->type != 1)
+    fprintf(stdout,"    sequence errors %lu, lost packets %lu\n",stream->seq_errors,stream->seq_lost);
+
+  if (stream->packets > 1) {
+    double mean = stream->iat_sum / (stream->packets-1);
+    double var = stream->iat_sum2 / (stream->packets-1) - mean * mean;
+    fprintf(stdout,"    inter-arrival min %.3f us, mean %.3f us, max %.3f us, jitter (std dev) %.3f us\n",
+            stream->iat_min/1e3,mean/1e3,stream->iat_max/1e3,(var > 0 ? sqrt(var) : 0)/1e3);
+    print_histogram(stream->iat_hist,"ns");
+  }
+
+  // Packets per time bin, over the bins the stream was active in
+  memset(rate_hist,0,sizeof(rate_hist));
+  for (x = stream->first_ns / bin_ns; x <= stream->last_ns / bin_ns; x++) {
+    y = stream->rate[x] ? floor_log2(stream->rate[x]) + 1 : 0;
+    rate_hist[y < HIST_BINS ? y : HIST_BINS-1]++;
+    if (stream->rate[x] > peak)
+      peak = stream->rate[x];
+  }
+  fprintf(stdout,"    packet rate peak %.1f packets/s, packets per %.0f us bin:\n",peak * 1e9 / bin_ns,bin_ns/1e3);
+  for (y = 0; y < HIST_BINS; y++) {
+    if (rate_hist[y])
+      fprintf(stdout,"      %12lu - %12lu packets %10lu bins\n",(y ? 1UL << (y-1) : 0UL),(y ? (1UL << y) - 1 : 0UL),rate_hist[y]);
+  }
+
+  // The acks of a data stream come on the reverse SID
+  if (stream->type == 0) {
+    fc_sid = (stream->sid << 16) | (stream->sid >> 16);
+    for (y = 0; y < MAX_STREAMS; y++) {
+      if (streams[y].used && streams[y].sid == fc_sid && streams[y].type == 1)
+        fc = &streams[y];
+    }
+    if (fc) {
+      credit = credit_timeline(stream,fc,nbins);
+      for (x = 0; x < nbins; x++) {
+        if (credit[x] < 0)
+          continue;
+        credit_sum += credit[x];
+        credit_bins++;
+        if ((u64)credit[x] > credit_max)
+          credit_max = credit[x];
+      }
+      if (credit_bins)
+        fprintf(stdout,"    flow control: %lu acks, packets in flight mean %.1f, max %lu\n",
+                fc->packets,credit_sum/credit_bins,credit_max);
+    } else {
+      fprintf(stdout,"    flow control: no acks on ");
+      print_stream_sid(fc_sid);
+      fprintf(stdout,"\n");
+    }
+  }
+
+  if (timeline) {
+    fprintf(stdout,"    timeline: time_s packets%s\n",credit ? " packets_in_flight" : "");
+    for (x = stream->first_ns / bin_ns; x <= stream->last_ns / bin_ns; x++) {
+      fprintf(stdout,"      %.6f %u",(double)x * bin_ns / 1e9,stream->rate[x]);
+      if (credit)
+        fprintf(stdout," %d",credit[x]);
+      fprintf(stdout,"\n");
+    }
+  }
+  free(credit);
+}
+
+int main(int argc, char *argv[])
+{
+  struct worker *workers;
+  struct stream_stats *streams;
+  struct pkt_ref *index;
+  struct stat st;
+  const u8 *file;
+  u64 num_chdr, num_total, nbins, bin_ns, max_ns, x;
+  long num_threads;
+  int fd, c, timeline, y;
+  u16 udp_port;
+  double t0, t1, t2;
+
+  udp_port = CHDR_PORT;
+  num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  bin_ns = 1000000;
+  timeline = FALSE;
+
+  while ((c = getopt(argc, argv, "p:j:b:t")) != -1) {
+    switch(c) {
+    case 'p':
+      udp_port = (u16)atoi(optarg);
+      break;
+    case 'j':
+      num_threads = atol(optarg);
+      break;
+    case 'b':
+      bin_ns = (u64)(atof(optarg) * 1000);
+      break;
+    case 't':
+      timeline = TRUE;
+      break;
+    case'?':
+    default:
+      usage();
+    }
+  }
+  if (optind != argc - 1 || bin_ns == 0)
+    usage();
+  if (num_threads < 1)
+    num_threads = 1;
+  if (num_threads > MAX_THREADS)
+    num_threads = MAX_THREADS;
+
+  // Map the capture
+  if ((fd = open(argv[optind],O_RDONLY)) < 0 || fstat(fd,&st) < 0) {
+    fprintf(stderr,"Can't open pcap file for reading: %s\n",argv[optind]);
+    exit(2);
+  }
+  file = mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+  if (file == MAP_FAILED) {
+    fprintf(stderr,"Can't map pcap file: %s\n",argv[optind]);
+    exit(2);
+  }
+  madvise((void *)file,st.st_size,MADV_SEQUENTIAL);
+
+  t0 = now_seconds();
+  num_chdr = index_capture(file,st.st_size,udp_port,&index,&num_total);
+  t1 = now_seconds();
+
+  fprintf(stdout,"\n===================================================================\n");
+  fprintf(stdout,"\n Total packet count in capture file: %lu, CHDR packets on UDP port %d: %lu\n",num_total,udp_port,num_chdr);
+  if (num_chdr == 0) {
+    fprintf(stdout,"\n===================================================================\n\n");
+    exit(0);
+  }
+  max_ns = 0;
+  for (x = 0; x < num_chdr; x++) {
+    if (index[x].ts_ns > max_ns)
+      max_ns = index[x].ts_ns;
+  }
+  fprintf(stdout," Capture duration %.3f s\n",max_ns/1e9);
+
+  // One contiguous slice of the index per thread
+  if ((u64)num_threads > num_chdr)
+    num_threads = num_chdr;
+  workers = calloc(num_threads,sizeof(struct worker));
+  for (y = 0; y < num_threads; y++) {
+    workers[y].file = file;
+    workers[y].begin = index + num_chdr * y / num_threads;
+    workers[y].end = index + num_chdr * (y+1) / num_threads;
+    workers[y].bin_ns = bin_ns;
+    if (pthread_create(&workers[y].thread,NULL,analyze_slice,&workers[y]) != 0) {
+      fprintf(stderr,"Can't create analysis thread.\n");
+      exit(2);
+    }
+  }
+
+  nbins = max_ns / bin_ns + 1;
+  streams = calloc(MAX_STREAMS,sizeof(struct stream_stats));
+  for (y = 0; y < num_threads; y++) {
+    pthread_join(workers[y].thread,NULL);
+    merge_slice(streams,workers[y].streams,nbins);
+  }
+  t2 = now_seconds();
+  fprintf(stdout," Indexed in %.3f s, analyzed in %.3f s with %ld threads\n",t1-t0,t2-t1,num_threads);
+  fprintf(stdout,"\n===================================================================\n");
+
+  for (y = 0; y < MAX_STREAMS; y++) {
+    if (streams[y].used)
+      print_stream(&streams[y],streams,nbins,bin_ns,timeline);
+  }
+  fprintf(stdout,"\n");
+
+  for (y = 0; y < MAX_STREAMS; y++) {
+    free(streams[y].rate);
+    free(streams[y].seq_at_bin);
+  }
+  free(streams);
+  free(workers);
+  free(index);
+  munmap((void *)file,st.st_size);
+  close(fd);
+  // Normal Exit
+  return(0);
+}